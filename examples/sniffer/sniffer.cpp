@@ -1,55 +1,248 @@
 //
-// Example how to print every message arriving.
+// Example how to capture the messages of a link and see their rates and losses,
+// e.g. to find out what saturates a telemetry link.
+//
+// Messages passing the filters are recorded to a tlog file which can be
+// replayed or opened with QGroundControl or MAVProxy, and a summary of the
+// rate and loss per system, component and message ID is printed periodically.
 //
 
-#include <cstdint>
-#include <future>
 #include <mavsdk/mavsdk.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
 #include <iostream>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
 #include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
 
 using namespace mavsdk;
-using namespace std::this_thread;
 using namespace std::chrono;
 
+namespace {
+
 void usage(const std::string& bin_name)
 {
-    std::cerr << "Usage : " << bin_name << " <connection_url>\n"
+    std::cerr << "Usage : " << bin_name << " <connection_url> [options]\n"
+              << '\n'
               << "Connection URL format should be :\n"
               << " For TCP : tcp://[server_host][:server_port]\n"
               << " For UDP : udp://[bind_host][:bind_port]\n"
               << " For Serial : serial:///path/to/serial/dev[:baudrate]\n"
-              << "For example, to connect to the simulator use URL: udp://:14540\n";
+              << "For example, to connect to the simulator use URL: udp://:14540\n"
+              << '\n'
+              << "Options :\n"
+              << " --tlog <path>            record the messages captured to a tlog file\n"
+              << " --msgid <id>[,<id>...]   only capture these message IDs\n"
+              << " --sysid <id>[,<id>...]   only capture messages sent by these systems\n"
+              << " --interval <seconds>     how often the summary is printed, default 1\n";
+}
+
+template<typename T> bool parse_ids(const std::string& arg, std::vector<T>& ids)
+{
+    std::stringstream stream(arg);
+    std::string id;
+    while (std::getline(stream, id, ',')) {
+        char* end = nullptr;
+        const auto value = std::strtoul(id.c_str(), &end, 10);
+        if (id.empty() || *end != '\0' || value > std::numeric_limits<T>::max()) {
+            return false;
+        }
+        ids.push_back(static_cast<T>(value));
+    }
+    return !ids.empty();
 }
 
+struct Options {
+    std::string connection_url{};
+    std::string tlog_path{};
+    TlogFilter filter{};
+    double interval_s{1.0};
+};
+
+bool parse_options(int argc, char** argv, Options& options)
+{
+    if (argc < 2) {
+        return false;
+    }
+    options.connection_url = argv[1];
+
+    for (int i = 2; i < argc; ++i) {
+        const std::string option = argv[i];
+        if (i + 1 >= argc) {
+            return false;
+        }
+        const std::string value = argv[++i];
+
+        if (option == "--tlog") {
+            options.tlog_path = value;
+        } else if (option == "--msgid") {
+            if (!parse_ids(value, options.filter.message_ids)) {
+                return false;
+            }
+        } else if (option == "--sysid") {
+            if (!parse_ids(value, options.filter.system_ids)) {
+                return false;
+            }
+        } else if (option == "--interval") {
+            options.interval_s = std::atof(value.c_str());
+            if (options.interval_s <= 0.0) {
+                return false;
+            }
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+// The same check as the one of the tlog recording, done first thing in the
+// callback, so that messages filtered out cost nothing more.
+bool passes(const TlogFilter& filter, const mavlink_message_t& message)
+{
+    if (!filter.system_ids.empty() &&
+        std::find(filter.system_ids.begin(), filter.system_ids.end(), message.sysid) ==
+            filter.system_ids.end()) {
+        return false;
+    }
+    return filter.message_ids.empty() ||
+           std::find(filter.message_ids.begin(), filter.message_ids.end(), message.msgid) !=
+               filter.message_ids.end();
+}
+
+// Counts what arrives per system, component and message ID, and the losses
+// per system and component from the gaps in their sequence numbers.
+class Capture {
+public:
+    using StreamKey = std::tuple<uint8_t, uint8_t, uint32_t>;
+    using ComponentKey = std::pair<uint8_t, uint8_t>;
+
+    struct Stream {
+        uint64_t count{0};
+        uint64_t bytes{0};
+    };
+
+    struct Component {
+        uint8_t last_sequence{0};
+        uint64_t received{0};
+        uint64_t lost{0};
+    };
+
+    void add(const mavlink_message_t& message)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        auto& stream = _streams[StreamKey{message.sysid, message.compid, message.msgid}];
+        ++stream.count;
+        stream.bytes += message.len + MAVLINK_NUM_NON_PAYLOAD_BYTES;
+
+        auto it = _components.find(ComponentKey{message.sysid, message.compid});
+        if (it == _components.end()) {
+            it = _components.emplace(ComponentKey{message.sysid, message.compid}, Component{})
+                     .first;
+        } else {
+            it->second.lost += static_cast<uint8_t>(message.seq - it->second.last_sequence - 1);
+        }
+        it->second.last_sequence = message.seq;
+        ++it->second.received;
+    }
+
+    // Prints the rates since the last call, and the losses since the start.
+    void print_summary(double interval_s, uint64_t tlog_dropped_bytes)
+    {
+        std::map<StreamKey, Stream> streams;
+        std::map<ComponentKey, Component> components;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            std::swap(streams, _streams);
+            components = _components;
+        }
+
+        std::cout << "sysid compid  msgid     rate [Hz]  bandwidth [B/s]\n";
+        for (const auto& [key, stream] : streams) {
+            std::cout << std::setw(5) << int(std::get<0>(key)) << std::setw(7)
+                      << int(std::get<1>(key)) << std::setw(7) << std::get<2>(key)
+                      << std::setw(14) << std::fixed << std::setprecision(1)
+                      << static_cast<double>(stream.count) / interval_s << std::setw(17)
+                      << static_cast<double>(stream.bytes) / interval_s << '\n';
+        }
+
+        std::cout << "sysid compid  received      lost  loss [%]\n";
+        for (const auto& [key, component] : components) {
+            const auto total = component.received + component.lost;
+            std::cout << std::setw(5) << int(key.first) << std::setw(7) << int(key.second)
+                      << std::setw(10) << component.received << std::setw(10) << component.lost
+                      << std::setw(10) << std::setprecision(2)
+                      << 100.0 * static_cast<double>(component.lost) / static_cast<double>(total)
+                      << '\n';
+        }
+
+        if (tlog_dropped_bytes > 0) {
+            std::cout << "tlog: " << tlog_dropped_bytes << " bytes dropped, disk too slow\n";
+        }
+        std::cout << std::endl;
+    }
+
+private:
+    std::mutex _mutex{};
+    std::map<StreamKey, Stream> _streams{};
+    std::map<ComponentKey, Component> _components{};
+};
+
+} // namespace
+
 int main(int argc, char** argv)
 {
-    if (argc != 2) {
+    Options options;
+    if (!parse_options(argc, argv, options)) {
         usage(argv[0]);
         return 1;
     }
 
     Mavsdk mavsdk;
-    ConnectionResult connection_result = mavsdk.add_any_connection(argv[1]);
 
-    if (connection_result != ConnectionResult::Success) {
-        std::cerr << "Connection failed: " << connection_result << '\n';
-        return 1;
-    }
-
-    auto system = mavsdk.first_autopilot(3.0);
-    if (!system) {
-        std::cerr << "Timed out waiting for system\n";
-        return 1;
+    // Only what passes the filters is serialized for the file, by a
+    // background thread which drops messages rather than blocking the link.
+    // What we send ourselves is left out, it's the link we are after.
+    if (!options.tlog_path.empty()) {
+        TlogFilter tlog_filter = options.filter;
+        tlog_filter.outgoing = false;
+        if (!mavsdk.start_tlog_recording(options.tlog_path, tlog_filter)) {
+            std::cerr << "Could not open " << options.tlog_path << '\n';
+            return 1;
+        }
     }
 
-    mavsdk.intercept_incoming_messages_async([](mavlink_message_t& message) {
-        std::cout << "Got message " << (int)message.msgid << '\n';
+    Capture capture;
+    mavsdk.intercept_incoming_messages_async([&](mavlink_message_t& message) {
+        if (passes(options.filter, message)) {
+            capture.add(message);
+        }
         return true;
     });
 
+    ConnectionResult connection_result = mavsdk.add_any_connection(options.connection_url);
+    if (connection_result != ConnectionResult::Success) {
+        std::cerr << "Connection failed: " << connection_result << '\n';
+        return 1;
+    }
+
+    const auto interval = duration_cast<steady_clock::duration>(
+        duration<double>(options.interval_s));
+    auto next_summary = steady_clock::now() + interval;
     while (true) {
-        std::this_thread::sleep_for(std::chrono::seconds(1));
+        std::this_thread::sleep_until(next_summary);
+        next_summary += interval;
+        capture.print_summary(options.interval_s, mavsdk.tlog_dropped_bytes());
     }
 
     return 0;
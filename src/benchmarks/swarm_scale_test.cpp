@@ -0,0 +1,509 @@
+//
+// Scale test of a ground station connected to a swarm of simulated vehicles.
+//
+// All vehicles run in this process, each as its own Mavsdk instance with an
+// autopilot server component providing TelemetryServer, ParamServer and
+// MissionRawServer, so no SITL is needed. For each swarm size, the vehicles
+// publish their position at a fixed rate, first without a ground station to
+// measure what they cost by themselves, and then to a ground station which
+// subscribes to the position of every vehicle.
+//
+// Reported per swarm size, as CSV:
+// - the CPU time of the ground station, as the CPU time of the process
+//   minus that of the vehicles alone, in percent of one core,
+// - the memory of the ground station, as reported by Mavsdk::memory_usage(),
+//   and how much the resident memory of the process grew with it,
+// - the latency from publishing a position to the callback of the
+//   subscription, and how many positions never arrived,
+// - how long it took to discover all vehicles, to download their params
+//   and to upload a mission to them, if asked for.
+//
+// Run with --help for the options.
+//
+
+#include "mavlink_include.h"
+#include "mavsdk.h"
+#include "plugins/mission_raw/mission_raw.h"
+#include "plugins/mission_raw_server/mission_raw_server.h"
+#include "plugins/param/param.h"
+#include "plugins/param_server/param_server.h"
+#include "plugins/telemetry/telemetry.h"
+#include "plugins/telemetry_server/telemetry_server.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/resource.h>
+#include <unistd.h>
+
+using namespace mavsdk;
+using std::chrono::steady_clock;
+
+namespace {
+
+struct Options {
+    std::vector<unsigned> swarm_sizes{1, 16, 64, 128, 255};
+    bool udp{false};
+    int udp_port{14600};
+    double rate_hz{10.0};
+    double duration_s{10.0};
+    unsigned num_params{0};
+    unsigned num_mission_items{0};
+};
+
+void print_usage(const char* bin_name)
+{
+    std::cout
+        << "Usage: " << bin_name << " [options]\n"
+        << "\n"
+        << "Options:\n"
+        << "  --vehicles <n,n,...>  Swarm sizes to test, at most 255 (default 1,16,64,128,255)\n"
+        << "  --transport <loopback|udp>  How vehicles connect (default loopback)\n"
+        << "  --udp-port <port>     Port of the ground station with udp (default 14600)\n"
+        << "  --rate <hz>           Position rate of each vehicle (default 10)\n"
+        << "  --duration <s>        Duration of each measurement (default 10)\n"
+        << "  --params <n>          Params per vehicle, downloaded by the ground station\n"
+        << "  --mission <n>         Mission items uploaded to each vehicle\n";
+}
+
+bool parse_swarm_sizes(const std::string& arg, std::vector<unsigned>& swarm_sizes)
+{
+    swarm_sizes.clear();
+    std::stringstream stream(arg);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        const int size = std::atoi(item.c_str());
+        if (size < 1 || size > 255) {
+            return false;
+        }
+        swarm_sizes.push_back(static_cast<unsigned>(size));
+    }
+    return !swarm_sizes.empty();
+}
+
+bool parse_options(int argc, char** argv, Options& options)
+{
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--help" || i + 1 >= argc) {
+            return false;
+        }
+        const std::string value = argv[++i];
+        if (arg == "--vehicles") {
+            if (!parse_swarm_sizes(value, options.swarm_sizes)) {
+                return false;
+            }
+        } else if (arg == "--transport") {
+            if (value != "loopback" && value != "udp") {
+                return false;
+            }
+            options.udp = (value == "udp");
+        } else if (arg == "--udp-port") {
+            options.udp_port = std::atoi(value.c_str());
+        } else if (arg == "--rate") {
+            options.rate_hz = std::atof(value.c_str());
+        } else if (arg == "--duration") {
+            options.duration_s = std::atof(value.c_str());
+        } else if (arg == "--params") {
+            options.num_params = static_cast<unsigned>(std::atoi(value.c_str()));
+        } else if (arg == "--mission") {
+            options.num_mission_items = static_cast<unsigned>(std::atoi(value.c_str()));
+        } else {
+            return false;
+        }
+    }
+    return options.rate_hz > 0.0 && options.duration_s > 0.0;
+}
+
+double cpu_seconds()
+{
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return static_cast<double>(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) +
+           static_cast<double>(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) * 1e-6;
+}
+
+uint64_t resident_bytes()
+{
+#if defined(__linux__)
+    std::ifstream statm("/proc/self/statm");
+    uint64_t size_pages = 0;
+    uint64_t resident_pages = 0;
+    statm >> size_pages >> resident_pages;
+    return resident_pages * static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+#else
+    return 0;
+#endif
+}
+
+int64_t now_us()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+               steady_clock::now().time_since_epoch())
+        .count();
+}
+
+// What was published by one vehicle and what of it arrived. The sequence
+// number of a position is sent as its altitude, so the ground station can
+// tell when it was published.
+struct Track {
+    static constexpr uint32_t window = 4096;
+
+    std::atomic<uint32_t> published{0};
+    std::atomic<uint32_t> received{0};
+    std::array<std::atomic<int64_t>, window> publish_time_us{};
+};
+
+struct Vehicle {
+    std::unique_ptr<Mavsdk> mavsdk{};
+    std::unique_ptr<TelemetryServer> telemetry_server{};
+    std::unique_ptr<ParamServer> param_server{};
+    std::unique_ptr<MissionRawServer> mission_raw_server{};
+};
+
+std::string connection_url(const Options& options, unsigned swarm_size, unsigned index, bool gcs)
+{
+    if (options.udp) {
+        return gcs ? "udp://:" + std::to_string(options.udp_port) :
+                     "udp://127.0.0.1:" + std::to_string(options.udp_port);
+    }
+    return "loopback://swarm-" + std::to_string(swarm_size) + "-" + std::to_string(index);
+}
+
+Vehicle make_vehicle(const Options& options, unsigned swarm_size, unsigned index)
+{
+    Vehicle vehicle;
+    vehicle.mavsdk = std::make_unique<Mavsdk>();
+    vehicle.mavsdk->set_configuration(
+        Mavsdk::Configuration{static_cast<uint8_t>(index + 1), MAV_COMP_ID_AUTOPILOT1, true});
+
+    const auto result =
+        vehicle.mavsdk->add_any_connection(connection_url(options, swarm_size, index, false));
+    if (result != ConnectionResult::Success) {
+        std::cerr << "Vehicle " << index + 1 << " could not connect: " << result << '\n';
+    }
+
+    auto server_component =
+        vehicle.mavsdk->server_component_by_type(Mavsdk::ServerComponentType::Autopilot);
+    vehicle.telemetry_server = std::make_unique<TelemetryServer>(server_component);
+    vehicle.param_server = std::make_unique<ParamServer>(server_component);
+    vehicle.mission_raw_server = std::make_unique<MissionRawServer>(server_component);
+
+    for (unsigned i = 0; i < options.num_params; ++i) {
+        vehicle.param_server->provide_param_int(
+            "SWARM_P" + std::to_string(i), static_cast<int32_t>(i));
+    }
+
+    return vehicle;
+}
+
+// Publishes the position of every vehicle at the configured rate.
+class Publisher {
+public:
+    Publisher(
+        std::vector<Vehicle>& vehicles,
+        std::vector<std::unique_ptr<Track>>& tracks,
+        double rate_hz) :
+        _vehicles(vehicles),
+        _tracks(tracks),
+        _interval(std::chrono::duration_cast<steady_clock::duration>(
+            std::chrono::duration<double>(1.0 / rate_hz)))
+    {
+        _thread = std::thread([this]() { run(); });
+    }
+
+    ~Publisher()
+    {
+        _should_exit = true;
+        _thread.join();
+    }
+
+    void set_paused(bool paused) { _paused = paused; }
+
+private:
+    void run()
+    {
+        auto next = steady_clock::now();
+        while (!_should_exit) {
+            if (!_paused) {
+                publish_all();
+            }
+            next += _interval;
+            std::this_thread::sleep_until(next);
+        }
+    }
+
+    void publish_all()
+    {
+        for (size_t i = 0; i < _vehicles.size(); ++i) {
+            auto& track = *_tracks[i];
+            const uint32_t seq = track.published.load() + 1;
+
+            TelemetryServer::Position position{};
+            position.latitude_deg = 47.3977 + 0.0001 * static_cast<double>(i);
+            position.longitude_deg = 8.5456;
+            position.absolute_altitude_m = static_cast<float>(seq);
+
+            track.publish_time_us[seq % Track::window] = now_us();
+            track.published = seq;
+            _vehicles[i].telemetry_server->publish_position(position, {}, {});
+        }
+    }
+
+    std::vector<Vehicle>& _vehicles;
+    std::vector<std::unique_ptr<Track>>& _tracks;
+    const steady_clock::duration _interval;
+    std::atomic<bool> _paused{false};
+    std::atomic<bool> _should_exit{false};
+    std::thread _thread{};
+};
+
+struct Latencies {
+    std::mutex mutex{};
+    bool collecting{false};
+    std::vector<int64_t> samples_us{};
+};
+
+int64_t percentile(const std::vector<int64_t>& sorted_samples, double fraction)
+{
+    if (sorted_samples.empty()) {
+        return 0;
+    }
+    const auto index =
+        static_cast<size_t>(fraction * static_cast<double>(sorted_samples.size() - 1));
+    return sorted_samples[index];
+}
+
+bool wait_for_systems(Mavsdk& mavsdk, unsigned swarm_size, std::chrono::seconds timeout)
+{
+    const auto deadline = steady_clock::now() + timeout;
+    while (steady_clock::now() < deadline) {
+        const auto systems = mavsdk.systems();
+        const auto connected = std::count_if(systems.begin(), systems.end(), [](const auto& s) {
+            return s->is_connected() && s->has_autopilot();
+        });
+        if (static_cast<unsigned>(connected) >= swarm_size) {
+            return true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+    return false;
+}
+
+double download_params(const std::vector<std::shared_ptr<System>>& systems, unsigned num_params)
+{
+    const auto start = steady_clock::now();
+    std::vector<std::future<size_t>> downloads;
+    for (const auto& system : systems) {
+        downloads.push_back(std::async(std::launch::async, [system]() {
+            Param param{system};
+            return param.get_all_params().int_params.size();
+        }));
+    }
+
+    unsigned incomplete = 0;
+    for (auto& download : downloads) {
+        if (download.get() < num_params) {
+            ++incomplete;
+        }
+    }
+    if (incomplete > 0) {
+        std::cerr << incomplete << " param downloads were incomplete\n";
+    }
+    return std::chrono::duration<double>(steady_clock::now() - start).count();
+}
+
+double upload_missions(const std::vector<std::shared_ptr<System>>& systems, unsigned num_items)
+{
+    std::vector<MissionRaw::MissionItem> items;
+    for (unsigned i = 0; i < num_items; ++i) {
+        MissionRaw::MissionItem item{};
+        item.seq = i;
+        item.frame = MAV_FRAME_GLOBAL_RELATIVE_ALT_INT;
+        item.command = MAV_CMD_NAV_WAYPOINT;
+        item.current = (i == 0) ? 1 : 0;
+        item.autocontinue = 1;
+        item.x = 473977000 + static_cast<int32_t>(i) * 100;
+        item.y = 85456000;
+        item.z = 10.0f;
+        item.mission_type = MAV_MISSION_TYPE_MISSION;
+        items.push_back(item);
+    }
+
+    const auto start = steady_clock::now();
+    std::vector<std::future<MissionRaw::Result>> uploads;
+    for (const auto& system : systems) {
+        uploads.push_back(std::async(std::launch::async, [system, &items]() {
+            MissionRaw mission_raw{system};
+            return mission_raw.upload_mission(items);
+        }));
+    }
+
+    unsigned failed = 0;
+    for (auto& upload : uploads) {
+        if (upload.get() != MissionRaw::Result::Success) {
+            ++failed;
+        }
+    }
+    if (failed > 0) {
+        std::cerr << failed << " mission uploads failed\n";
+    }
+    return std::chrono::duration<double>(steady_clock::now() - start).count();
+}
+
+void run(const Options& options, unsigned swarm_size)
+{
+    std::vector<Vehicle> vehicles;
+    std::vector<std::unique_ptr<Track>> tracks;
+    for (unsigned i = 0; i < swarm_size; ++i) {
+        vehicles.push_back(make_vehicle(options, swarm_size, i));
+        tracks.push_back(std::make_unique<Track>());
+    }
+
+    Publisher publisher{vehicles, tracks, options.rate_hz};
+    const auto measurement = std::chrono::duration<double>(options.duration_s);
+
+    // What the vehicles cost by themselves, without anybody listening.
+    const double vehicles_cpu_start_s = cpu_seconds();
+    std::this_thread::sleep_for(measurement);
+    const double vehicles_cpu_s = cpu_seconds() - vehicles_cpu_start_s;
+    const uint64_t rss_before_bytes = resident_bytes();
+
+    Mavsdk gcs;
+    gcs.set_configuration(Mavsdk::Configuration{Mavsdk::Configuration::UsageType::GroundStation});
+    const auto discovery_start = steady_clock::now();
+    for (unsigned i = 0; i < (options.udp ? 1 : swarm_size); ++i) {
+        const auto result = gcs.add_any_connection(connection_url(options, swarm_size, i, true));
+        if (result != ConnectionResult::Success) {
+            std::cerr << "Ground station could not connect: " << result << '\n';
+            return;
+        }
+    }
+
+    if (!wait_for_systems(gcs, swarm_size, std::chrono::seconds(30))) {
+        std::cerr << "Not all " << swarm_size << " vehicles were discovered\n";
+    }
+    const double discovery_s =
+        std::chrono::duration<double>(steady_clock::now() - discovery_start).count();
+
+    const auto systems = gcs.systems();
+    Latencies latencies;
+    std::vector<std::unique_ptr<Telemetry>> telemetries;
+    for (const auto& system : systems) {
+        const unsigned index = system->get_system_id() - 1u;
+        if (index >= swarm_size) {
+            continue;
+        }
+        auto telemetry = std::make_unique<Telemetry>(system);
+        auto& track = *tracks[index];
+        telemetry->subscribe_position([&track, &latencies](Telemetry::Position position) {
+            const auto received_us = now_us();
+            const auto seq = static_cast<uint32_t>(std::lround(position.absolute_altitude_m));
+            ++track.received;
+
+            std::lock_guard<std::mutex> lock(latencies.mutex);
+            if (latencies.collecting && seq > 0) {
+                latencies.samples_us.push_back(
+                    received_us - track.publish_time_us[seq % Track::window].load());
+            }
+        });
+        telemetries.push_back(std::move(telemetry));
+    }
+
+    // Let the subscriptions settle before measuring.
+    std::this_thread::sleep_for(std::chrono::seconds(1));
+
+    std::vector<uint32_t> published_start;
+    std::vector<uint32_t> received_start;
+    for (const auto& track : tracks) {
+        published_start.push_back(track->published);
+        received_start.push_back(track->received);
+    }
+    {
+        std::lock_guard<std::mutex> lock(latencies.mutex);
+        latencies.collecting = true;
+    }
+
+    const double total_cpu_start_s = cpu_seconds();
+    std::this_thread::sleep_for(measurement);
+    const double total_cpu_s = cpu_seconds() - total_cpu_start_s;
+
+    // What is still on its way is not dropped.
+    publisher.set_paused(true);
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+
+    uint64_t published = 0;
+    uint64_t dropped = 0;
+    for (size_t i = 0; i < tracks.size(); ++i) {
+        const uint32_t sent = tracks[i]->published - published_start[i];
+        const uint32_t arrived = tracks[i]->received - received_start[i];
+        published += sent;
+        dropped += (sent > arrived) ? sent - arrived : 0;
+    }
+
+    std::vector<int64_t> samples_us;
+    {
+        std::lock_guard<std::mutex> lock(latencies.mutex);
+        latencies.collecting = false;
+        samples_us = latencies.samples_us;
+    }
+    std::sort(samples_us.begin(), samples_us.end());
+
+    const uint64_t gcs_memory_bytes = gcs.memory_usage().total_bytes;
+    const uint64_t rss_after_bytes = resident_bytes();
+
+    const double params_s =
+        options.num_params > 0 ? download_params(systems, options.num_params) : 0.0;
+    const double mission_s =
+        options.num_mission_items > 0 ? upload_missions(systems, options.num_mission_items) : 0.0;
+
+    const double duration_s = options.duration_s;
+    std::cout << swarm_size << ',' << systems.size() << ',' << options.rate_hz << ','
+              << 100.0 * total_cpu_s / duration_s << ',' << 100.0 * vehicles_cpu_s / duration_s
+              << ',' << 100.0 * std::max(total_cpu_s - vehicles_cpu_s, 0.0) / duration_s << ','
+              << gcs_memory_bytes << ','
+              << (rss_after_bytes > rss_before_bytes ? rss_after_bytes - rss_before_bytes : 0)
+              << ',' << percentile(samples_us, 0.5) << ',' << percentile(samples_us, 0.99) << ','
+              << (samples_us.empty() ? 0 : samples_us.back()) << ',' << published << ','
+              << dropped << ',' << discovery_s << ',' << params_s << ',' << mission_s
+              << std::endl;
+
+    // The subscriptions refer to the tracks and latencies.
+    telemetries.clear();
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Options options;
+    if (!parse_options(argc, argv, options)) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    std::cout << "vehicles,discovered,rate_hz,cpu_total_percent,cpu_vehicles_percent,"
+                 "cpu_gcs_percent,gcs_memory_bytes,gcs_rss_bytes,latency_p50_us,"
+                 "latency_p99_us,latency_max_us,published,dropped,discovery_s,params_s,"
+                 "mission_s"
+              << std::endl;
+
+    for (const auto swarm_size : options.swarm_sizes) {
+        run(options, swarm_size);
+    }
+
+    return 0;
+}
@@ -78,6 +78,25 @@ if(UNIX AND NOT APPLE)
     add_definitions("-DLINUX")
 endif()
 
+# Containers can take their memory from the allocators set in the
+# configuration, for which we need std::pmr. Apple only ships it from
+# macOS 14 on. It has to be defined for everything including the internal
+# headers, e.g. the unit tests, as it changes the layout of classes.
+include(CheckCXXSourceCompiles)
+check_cxx_source_compiles("
+#include <memory_resource>
+int main()
+{
+    std::pmr::vector<int> values{std::pmr::polymorphic_allocator<int>{std::pmr::new_delete_resource()}};
+    values.push_back(1);
+    return 0;
+}" HAVE_STD_PMR)
+if(HAVE_STD_PMR)
+    add_definitions("-DMAVSDK_WITH_PMR")
+else()
+    message(STATUS "std::pmr not available, allocators set in the configuration are ignored")
+endif()
+
 if(ASAN)
     set(CMAKE_C_FLAGS "-fsanitize=address ${CMAKE_C_FLAGS}")
     set(CMAKE_CXX_FLAGS "-fsanitize=address ${CMAKE_C_FLAGS}")
@@ -0,0 +1,108 @@
+#include "awaitable.h"
+
+#ifdef MAVSDK_HAS_COROUTINES
+
+#include <gtest/gtest.h>
+#include <coroutine>
+#include <exception>
+#include <string>
+#include <vector>
+
+using namespace mavsdk;
+
+namespace {
+
+// Minimal coroutine type, starting right away and never awaited.
+struct Task {
+    struct promise_type {
+        Task get_return_object() { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+};
+
+enum class Result { Success, Timeout };
+
+using ResultCallback = std::function<void(Result)>;
+using ValueCallback = std::function<void(Result, float)>;
+
+} // namespace
+
+TEST(Awaitable, ResumesWithResult)
+{
+    ResultCallback pending;
+    bool done = false;
+    Result result = Result::Timeout;
+
+    auto coroutine = [&]() -> Task {
+        result = co_await Awaitable<ResultCallback>(
+            [&](const ResultCallback& callback) { pending = callback; });
+        done = true;
+    };
+    coroutine();
+
+    EXPECT_FALSE(done);
+    ASSERT_TRUE(pending);
+    pending(Result::Success);
+    EXPECT_TRUE(done);
+    EXPECT_EQ(result, Result::Success);
+}
+
+TEST(Awaitable, ReturnsPairForTwoArguments)
+{
+    std::pair<Result, float> value{Result::Timeout, 0.0f};
+
+    auto coroutine = [&]() -> Task {
+        value = co_await Awaitable<ValueCallback>(
+            [](const ValueCallback& callback) { callback(Result::Success, 2.5f); });
+    };
+    coroutine();
+
+    EXPECT_EQ(value.first, Result::Success);
+    EXPECT_EQ(value.second, 2.5f);
+}
+
+TEST(Awaitable, ResumesOnExecutor)
+{
+    std::vector<std::function<void()>> posted;
+    Executor executor = [&](std::function<void()> func) { posted.push_back(std::move(func)); };
+
+    ResultCallback pending;
+    bool done = false;
+
+    auto coroutine = [&]() -> Task {
+        (void)co_await Awaitable<ResultCallback>(
+            [&](const ResultCallback& callback) { pending = callback; }, executor);
+        done = true;
+    };
+    coroutine();
+
+    pending(Result::Success);
+    EXPECT_FALSE(done);
+    ASSERT_EQ(posted.size(), 1u);
+    posted[0]();
+    EXPECT_TRUE(done);
+}
+
+TEST(Awaitable, AwaitsOneAfterAnother)
+{
+    std::vector<std::string> calls;
+
+    auto coroutine = [&]() -> Task {
+        for (const auto* name : {"arm", "takeoff", "land"}) {
+            const auto result =
+                co_await Awaitable<ResultCallback>([&, name](const ResultCallback& callback) {
+                    calls.push_back(name);
+                    callback(Result::Success);
+                });
+            EXPECT_EQ(result, Result::Success);
+        }
+    };
+    coroutine();
+
+    EXPECT_EQ(calls, (std::vector<std::string>{"arm", "takeoff", "land"}));
+}
+
+#endif
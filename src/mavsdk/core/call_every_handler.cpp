@@ -1,10 +1,15 @@
 #include "call_every_handler.h"
+#include "trace.h"
 
 #include <utility>
+#include <vector>
 
 namespace mavsdk {
 
-CallEveryHandler::CallEveryHandler(Time& time) : _time(time) {}
+CallEveryHandler::CallEveryHandler(Time& time) :
+    _time(time),
+    _wheel(TimerWheel::tick_at(time.steady_time()))
+{}
 
 void CallEveryHandler::add(std::function<void()> callback, double interval_s, void** cookie)
 {
@@ -16,27 +21,41 @@ void CallEveryHandler::add(std::function<void()> callback, double interval_s, vo
     _time.shift_steady_time_by(before, -interval_s - 0.001);
     new_entry->last_time = before;
     new_entry->interval_s = interval_s;
+    new_entry->node.data = new_entry.get();
 
     void* new_cookie = static_cast<void*>(new_entry.get());
 
     {
         std::lock_guard<std::mutex> lock(_entries_mutex);
         _entries.insert(std::pair<void*, std::shared_ptr<Entry>>(new_cookie, new_entry));
+        schedule(*new_entry);
     }
 
     if (cookie != nullptr) {
         *cookie = new_cookie;
     }
+
+    notify();
 }
 
 void CallEveryHandler::change(double interval_s, const void* cookie)
 {
-    std::lock_guard<std::mutex> lock(_entries_mutex);
+    {
+        std::lock_guard<std::mutex> lock(_entries_mutex);
+
+        auto it = _entries.find(const_cast<void*>(cookie));
+        if (it == _entries.end()) {
+            return;
+        }
 
-    auto it = _entries.find(const_cast<void*>(cookie));
-    if (it != _entries.end()) {
         it->second->interval_s = interval_s;
+        // If it is currently being called, run_once() schedules it afterwards.
+        if (it->second->node.is_scheduled()) {
+            schedule(*it->second);
+        }
     }
+
+    notify();
 }
 
 void CallEveryHandler::reset(const void* cookie)
@@ -45,7 +64,10 @@ void CallEveryHandler::reset(const void* cookie)
 
     auto it = _entries.find(const_cast<void*>(cookie));
     if (it != _entries.end()) {
-        it->second->last_time = _time.steady_time();
+        it->second->last_time = _time.coarse_steady_time();
+        if (it->second->node.is_scheduled()) {
+            schedule(*it->second);
+        }
     }
 }
 
@@ -55,38 +77,87 @@ void CallEveryHandler::remove(const void* cookie)
 
     auto it = _entries.find(const_cast<void*>(cookie));
     if (it != _entries.end()) {
-        _entries.erase(const_cast<void*>(cookie));
-        _iterator_invalidated = true;
+        _wheel.cancel(it->second->node);
+        _entries.erase(it);
     }
 }
 
 void CallEveryHandler::run_once()
 {
-    _entries_mutex.lock();
+    std::unique_lock<std::mutex> lock(_entries_mutex);
+
+    _wheel.advance(TimerWheel::tick_at(_time.steady_time()));
+
+    // Entries are only put back into the wheel once we're done, so that each
+    // one is called at most once per run, even if it has fallen behind.
+    std::vector<std::shared_ptr<Entry>> called;
 
-    for (auto& entry : _entries) {
-        if (_time.elapsed_since_s(entry.second->last_time) > double(entry.second->interval_s)) {
-            _time.shift_steady_time_by(entry.second->last_time, double(entry.second->interval_s));
+    while (auto* node = _wheel.pop_expired()) {
+        auto it = _entries.find(node->data);
+        if (it == _entries.end()) {
+            continue;
+        }
+
+        auto entry = it->second;
+        _time.shift_steady_time_by(entry->last_time, double(entry->interval_s));
+        called.push_back(entry);
 
-            if (entry.second->callback) {
-                // Get a copy for the callback because we unlock.
-                std::function<void()> callback = entry.second->callback;
+        if (entry->callback) {
+            // Get a copy for the callback because we unlock.
+            std::function<void()> callback = entry->callback;
 
-                // Unlock while we call back because it might in turn want to add timeouts.
-                _entries_mutex.unlock();
+            // Unlock while we call back because it might in turn want to add timeouts.
+            lock.unlock();
+            {
+                TraceScope trace("timer", "call_every");
                 callback();
-                _entries_mutex.lock();
             }
+            lock.lock();
         }
+    }
 
-        // We leave the loop.
-        // FIXME: there should be a nicer way to do this.
-        if (_iterator_invalidated) {
-            _iterator_invalidated = false;
-            break;
+    for (auto& entry : called) {
+        // It might have been removed in the meantime.
+        if (_entries.find(entry.get()) != _entries.end()) {
+            schedule(*entry);
         }
     }
-    _entries_mutex.unlock();
+}
+
+std::optional<double> CallEveryHandler::next_run_in_s()
+{
+    std::lock_guard<std::mutex> lock(_entries_mutex);
+
+    const auto next_tick = _wheel.next_expiry_ms();
+    if (!next_tick) {
+        return {};
+    }
+
+    const auto now_tick = TimerWheel::tick_at(_time.steady_time());
+    return *next_tick > now_tick ? double(*next_tick - now_tick) * 1e-3 : 0.0;
+}
+
+void CallEveryHandler::set_notifier(std::function<void()> notifier)
+{
+    std::lock_guard<std::mutex> lock(_notifier_mutex);
+    _notifier = std::move(notifier);
+}
+
+void CallEveryHandler::schedule(Entry& entry)
+{
+    // Needs _entries_mutex
+
+    auto next_time = entry.last_time;
+    _time.shift_steady_time_by(next_time, double(entry.interval_s));
+    _wheel.schedule(entry.node, TimerWheel::tick_after(next_time));
+}
+
+void CallEveryHandler::notify()
+{
+    std::lock_guard<std::mutex> lock(_notifier_mutex);
+    if (_notifier) {
+        _notifier();
+    }
 }
 
 } // namespace mavsdk
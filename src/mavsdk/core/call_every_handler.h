@@ -3,8 +3,10 @@
 #include <mutex>
 #include <memory>
 #include <functional>
+#include <optional>
 #include <unordered_map>
 #include "mavsdk_time.h"
+#include "timer_wheel.h"
 
 namespace mavsdk {
 
@@ -26,18 +28,32 @@ public:
 
     void run_once();
 
+    // Time until the next call is due, empty if there are none.
+    std::optional<double> next_run_in_s();
+
+    // Called (without lock held) whenever an entry was added or changed, so
+    // that the thread calling run_once() can re-evaluate how long to sleep.
+    void set_notifier(std::function<void()> notifier);
+
 private:
     struct Entry {
         std::function<void()> callback{nullptr};
         SteadyTimePoint last_time{};
         double interval_s{0.0};
+        TimerWheel::Node node{};
     };
 
+    void schedule(Entry& entry);
+    void notify();
+
+    Time& _time;
+
     std::unordered_map<void*, std::shared_ptr<Entry>> _entries{};
+    TimerWheel _wheel;
     std::mutex _entries_mutex{};
-    bool _iterator_invalidated{false};
 
-    Time& _time;
+    std::function<void()> _notifier{};
+    std::mutex _notifier_mutex{};
 };
 
 } // namespace mavsdk
@@ -4,6 +4,9 @@
 #include <functional>
 #include <memory>
 #include <mutex>
+#include <optional>
+#include <tuple>
+#include <type_traits>
 #include <utility>
 #include <vector>
 #include "handle.h"
@@ -16,11 +19,27 @@ public:
     ~CallbackList();
 
     Handle<Args...> subscribe(const std::function<void(Args...)>& callback);
+    // Calls the callback at most max_rate_hz times per second, with the
+    // latest arguments, see CallbackListImpl.
+    Handle<Args...> subscribe(const std::function<void(Args...)>& callback, double max_rate_hz);
     void unsubscribe(Handle<Args...> handle);
     void operator()(Args... args);
     [[nodiscard]] bool empty();
+    // The highest rate subscribers limited themselves to, 0 if none did, or
+    // nothing without any subscriber.
+    [[nodiscard]] std::optional<double> max_rate_hz() const;
     void clear();
     void queue(Args... args, const std::function<void(const std::function<void()>&)>& queue_func);
+    // Like queue, but the arguments are only made if anybody subscribed, e.g.
+    // if they are derived from the message and not needed otherwise.
+    void queue_lazily(
+        const std::function<std::tuple<std::decay_t<Args>...>()>& make_args,
+        const std::function<void(const std::function<void()>&)>& queue_func);
+    // Like queue, but the caller binds the arguments to each callback, e.g.
+    // to share them between the calls instead of copying them.
+    void queue_calls(
+        const std::function<std::function<void()>(const std::function<void(Args...)>&)>& make_call,
+        const std::function<void(const std::function<void()>&)>& queue_func);
 
 private:
     std::unique_ptr<CallbackListImpl<Args...>> _impl;
@@ -20,6 +20,13 @@ Handle<Args...> CallbackList<Args...>::subscribe(const std::function<void(Args..
     return _impl->subscribe(callback);
 }
 
+template<typename... Args>
+Handle<Args...>
+CallbackList<Args...>::subscribe(const std::function<void(Args...)>& callback, double max_rate_hz)
+{
+    return _impl->subscribe(callback, max_rate_hz);
+}
+
 template<typename... Args> void CallbackList<Args...>::unsubscribe(Handle<Args...> handle)
 {
     _impl->unsubscribe(handle);
@@ -27,7 +34,7 @@ template<typename... Args> void CallbackList<Args...>::unsubscribe(Handle<Args..
 
 template<typename... Args> void CallbackList<Args...>::operator()(Args... args)
 {
-    _impl->exec(args...);
+    _impl->exec(std::forward<Args>(args)...);
 }
 
 template<typename... Args> bool CallbackList<Args...>::empty()
@@ -35,6 +42,11 @@ template<typename... Args> bool CallbackList<Args...>::empty()
     return _impl->empty();
 }
 
+template<typename... Args> std::optional<double> CallbackList<Args...>::max_rate_hz() const
+{
+    return _impl->max_rate_hz();
+}
+
 template<typename... Args> void CallbackList<Args...>::clear()
 {
     _impl->clear();
@@ -42,7 +54,23 @@ template<typename... Args> void CallbackList<Args...>::clear()
 
 template<typename... Args> void CallbackList<Args...>::queue(Args... args, const std::function<void(const std::function<void()>&)>& queue_func)
 {
-    _impl->queue(args..., queue_func);
+    _impl->queue(std::forward<Args>(args)..., queue_func);
+}
+
+template<typename... Args>
+void CallbackList<Args...>::queue_lazily(
+    const std::function<std::tuple<std::decay_t<Args>...>()>& make_args,
+    const std::function<void(const std::function<void()>&)>& queue_func)
+{
+    _impl->queue_lazily(make_args, queue_func);
+}
+
+template<typename... Args>
+void CallbackList<Args...>::queue_calls(
+    const std::function<std::function<void()>(const std::function<void(Args...)>&)>& make_call,
+    const std::function<void(const std::function<void()>&)>& queue_func)
+{
+    _impl->queue_calls(make_call, queue_func);
 }
 
 } // namespace mavsdk
@@ -0,0 +1,48 @@
+#include "callback_list.h"
+#include "callback_list.tpp"
+#include <benchmark/benchmark.h>
+#include <functional>
+
+namespace mavsdk {
+
+template class CallbackList<int>;
+
+} // namespace mavsdk
+
+using namespace mavsdk;
+
+static void BM_CallbackListExec(benchmark::State& state)
+{
+    CallbackList<int> callback_list;
+
+    int sum = 0;
+    for (int64_t i = 0; i < state.range(0); ++i) {
+        callback_list.subscribe([&sum](int value) { sum += value; });
+    }
+
+    for (auto _ : state) {
+        callback_list(1);
+    }
+    benchmark::DoNotOptimize(sum);
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_CallbackListExec)->Arg(1)->Arg(10);
+
+static void BM_CallbackListQueue(benchmark::State& state)
+{
+    CallbackList<int> callback_list;
+
+    int sum = 0;
+    for (int64_t i = 0; i < state.range(0); ++i) {
+        callback_list.subscribe([&sum](int value) { sum += value; });
+    }
+
+    for (auto _ : state) {
+        callback_list.queue(1, [](const std::function<void()>& func) { func(); });
+    }
+    benchmark::DoNotOptimize(sum);
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_CallbackListQueue)->Arg(1)->Arg(10);
@@ -1,9 +1,16 @@
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cstdint>
+#include <iterator>
 #include <functional>
 #include <memory>
 #include <mutex>
+#include <optional>
+#include <tuple>
+#include <type_traits>
 #include <utility>
 #include <vector>
 #include "log.h"
@@ -11,11 +18,29 @@
 
 namespace mavsdk {
 
+// Subscribers are kept in an immutable list which is replaced (copy-on-write)
+// on every subscribe or unsubscribe. Calling the subscribers just takes a
+// snapshot of the list, so it never waits for (un)subscriptions, and
+// callbacks can unsubscribe themselves or others without any special care.
+//
+// Note that a callback can therefore still be called once if it has already
+// been picked up by a call running concurrently with its unsubscription.
+//
+// Subscribers can limit how often they are called. Their calls are then
+// conflated: at most one is queued at a time, and it delivers the latest
+// arguments when it runs. Arguments arriving too early are only delivered
+// if more follow after the interval has passed.
 template<typename... Args> class CallbackListImpl {
 public:
     Handle<Args...> subscribe(const std::function<void(Args...)>& callback)
     {
-        check_removals();
+        return subscribe(callback, 0.0);
+    }
+
+    // A max_rate_hz of 0 means no limit.
+    Handle<Args...> subscribe(const std::function<void(Args...)>& callback, double max_rate_hz)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
 
         // We need to return a handle, even if the callback is nullptr to
         // unsubscribe. That's fine, the handle just won't remove anything
@@ -23,12 +48,21 @@ public:
         auto handle = Handle<Args...>(_last_id++);
 
         if (callback != nullptr) {
-            std::lock_guard<std::mutex> lock(_mutex);
-            _list.emplace_back(handle, callback);
+            std::shared_ptr<Conflation> conflation;
+            if (max_rate_hz > 0.0) {
+                conflation = std::make_shared<Conflation>();
+                conflation->min_interval =
+                    std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                        std::chrono::duration<double>(1.0 / max_rate_hz));
+            }
+
+            auto new_list = std::make_shared<List>(*snapshot());
+            new_list->push_back(Entry{handle, callback, max_rate_hz, std::move(conflation)});
+            set_list(std::move(new_list));
         } else {
             LogErr() << "Use new unsubscribe methods instead of subscribe(nullptr)\n"
                      << "See: https://mavsdk.mavlink.io/main/en/cpp/api_changes.html#unsubscribe";
-            try_clear();
+            set_list(std::make_shared<List>());
         }
 
         return handle;
@@ -42,103 +76,203 @@ public:
             return;
         }
 
-        // We want to allow unsubscribing while in a callback. This would
-        // normally lead to a deadlock. Therefore, we just try to grab the
-        // lock here, and if it's already taken, we schedule the removal
-        // for later.
-        std::unique_lock<std::mutex> lock(_mutex, std::try_to_lock);
-        if (lock.owns_lock()) {
-            _list.erase(
-                std::remove_if(
-                    _list.begin(),
-                    _list.end(),
-                    [&](auto& pair) { return pair.first._id == handle._id; }),
-                _list.end());
-        } else {
-            std::lock_guard<std::mutex> remove_later_lock(_remove_later_mutex);
-            _remove_later.push_back(handle._id);
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        auto old_list = snapshot();
+        auto new_list = std::make_shared<List>();
+        new_list->reserve(old_list->size());
+        std::copy_if(
+            old_list->begin(),
+            old_list->end(),
+            std::back_inserter(*new_list),
+            [&](const auto& entry) { return entry.handle._id != handle._id; });
+
+        if (new_list->size() != old_list->size()) {
+            set_list(std::move(new_list));
         }
     }
 
     void exec(Args... args)
     {
-        check_removals();
-
-        std::lock_guard<std::mutex> lock(_mutex);
-        for (const auto& pair : _list) {
-            pair.second(args...);
+        const auto list = snapshot();
+        for (size_t i = 0; i < list->size(); ++i) {
+            const auto& entry = (*list)[i];
+            if (entry.conflation != nullptr && !is_due(*entry.conflation)) {
+                continue;
+            }
+            // The last one can have the arguments, the others get copies.
+            if (i + 1 == list->size()) {
+                entry.callback(std::forward<Args>(args)...);
+            } else {
+                entry.callback(args...);
+            }
         }
     }
 
     void queue(Args... args, const std::function<void(const std::function<void()>&)>& queue_func)
     {
-        check_removals();
+        const auto list = snapshot();
+        if (list->empty()) {
+            return;
+        }
 
-        std::lock_guard<std::mutex> lock(_mutex);
+        queue_shared(*list, std::make_shared<Arguments>(std::forward<Args>(args)...), queue_func);
+    }
 
-        for (const auto& pair : _list) {
-            queue_func([callback = pair.second, args...]() { callback(args...); });
+    void queue_lazily(
+        const std::function<std::tuple<std::decay_t<Args>...>()>& make_args,
+        const std::function<void(const std::function<void()>&)>& queue_func)
+    {
+        const auto list = snapshot();
+        if (list->empty()) {
+            return;
         }
+
+        queue_shared(*list, std::make_shared<Arguments>(make_args()), queue_func);
     }
 
-    bool empty()
+    void queue_calls(
+        const std::function<std::function<void()>(const std::function<void(Args...)>&)>& make_call,
+        const std::function<void(const std::function<void()>&)>& queue_func)
     {
-        check_removals();
+        // The arguments are bound by the caller, so they can't be conflated
+        // and calls coming too early are dropped instead.
+        const auto list = snapshot();
+        for (const auto& entry : *list) {
+            if (entry.conflation == nullptr || is_due(*entry.conflation)) {
+                queue_func(make_call(entry.callback));
+            }
+        }
+    }
 
-        std::lock_guard<std::mutex> lock(_mutex);
-        return _list.empty();
+    bool empty() { return snapshot()->empty(); }
+
+    std::optional<double> max_rate_hz() const
+    {
+        const auto list = snapshot();
+        if (list->empty()) {
+            return std::nullopt;
+        }
+
+        double max_rate_hz = 0.0;
+        for (const auto& entry : *list) {
+            max_rate_hz = std::max(max_rate_hz, entry.max_rate_hz);
+        }
+        return max_rate_hz;
     }
 
     void clear()
     {
         std::lock_guard<std::mutex> lock(_mutex);
-        return _list.clear();
+        set_list(std::make_shared<List>());
     }
 
 private:
-    void check_removals()
+    using Arguments = std::tuple<std::decay_t<Args>...>;
+
+    struct Conflation {
+        std::chrono::steady_clock::duration min_interval{};
+
+        std::mutex mutex{};
+        // Needs mutex
+        std::optional<Arguments> latest{};
+        bool call_queued{false};
+        std::optional<std::chrono::steady_clock::time_point> last_call{};
+    };
+
+    struct Entry {
+        Handle<Args...> handle;
+        std::function<void(Args...)> callback;
+        double max_rate_hz;
+        // Only set if the subscriber limits its rate.
+        std::shared_ptr<Conflation> conflation;
+    };
+
+    using List = std::vector<Entry>;
+
+    // The arguments are shared by all the queued calls, so that copying a
+    // call into the queue does not copy them along.
+    static void queue_shared(
+        const List& list,
+        const std::shared_ptr<Arguments>& shared_args,
+        const std::function<void(const std::function<void()>&)>& queue_func)
     {
-        std::lock_guard<std::mutex> remove_later_lock(_remove_later_mutex);
-
-        // We could probably just grab the lock here but it's safer not to
-        // acquire both locks to avoid deadlocks.
-        if (_mutex.try_lock()) {
-            if (_remove_all_later) {
-                _remove_all_later = false;
-                _list.clear();
-                _remove_later.clear();
+        for (const auto& entry : list) {
+            if (entry.conflation == nullptr) {
+                queue_func([callback = entry.callback, shared_args]() {
+                    // Nobody else needs them if this is the only call left.
+                    if (shared_args.use_count() == 1) {
+                        std::apply(callback, std::move(*shared_args));
+                    } else {
+                        std::apply(callback, *shared_args);
+                    }
+                });
+            } else {
+                queue_conflated(entry, queue_func, *shared_args);
             }
+        }
+    }
 
-            for (auto& id : _remove_later) {
-                _list.erase(
-                    std::remove_if(
-                        _list.begin(),
-                        _list.end(),
-                        [&](auto& pair) { return pair.first._id == id; }),
-                    _list.end());
-            }
-            _mutex.unlock();
+    static bool is_due(Conflation& conflation)
+    {
+        std::lock_guard<std::mutex> lock(conflation.mutex);
+        return take_slot(conflation);
+    }
+
+    // Needs conflation.mutex
+    static bool take_slot(Conflation& conflation)
+    {
+        const auto now = std::chrono::steady_clock::now();
+        if (conflation.last_call && now - *conflation.last_call < conflation.min_interval) {
+            return false;
         }
+        conflation.last_call = now;
+        return true;
     }
 
-    void try_clear()
+    static void queue_conflated(
+        const Entry& entry,
+        const std::function<void(const std::function<void()>&)>& queue_func,
+        const Arguments& args)
     {
-        std::unique_lock<std::mutex> lock(_mutex, std::try_to_lock);
-        if (lock.owns_lock()) {
-            _list.clear();
-        } else {
-            std::lock_guard<std::mutex> remove_later_lock(_remove_later_mutex);
-            _remove_all_later = true;
+        {
+            std::lock_guard<std::mutex> lock(entry.conflation->mutex);
+            entry.conflation->latest = args;
+            if (entry.conflation->call_queued || !take_slot(*entry.conflation)) {
+                return;
+            }
+            entry.conflation->call_queued = true;
         }
+
+        // Outside the lock, in case the call is run right away.
+        queue_func([callback = entry.callback, conflation = entry.conflation]() {
+            std::optional<Arguments> latest;
+            {
+                std::lock_guard<std::mutex> lock(conflation->mutex);
+                latest.swap(conflation->latest);
+                conflation->call_queued = false;
+            }
+            if (latest) {
+                std::apply(callback, std::move(*latest));
+            }
+        });
     }
 
-    mutable std::mutex _mutex{};
-    uint64_t _last_id{1}; // Start at 1 because 0 is the "null handle"
-    std::vector<std::pair<Handle<Args...>, std::function<void(Args...)>>> _list{};
+    std::shared_ptr<const List> snapshot() const
+    {
+        return std::atomic_load_explicit(&_list, std::memory_order_acquire);
+    }
+
+    void set_list(std::shared_ptr<const List> list)
+    {
+        // Needs _mutex
+        std::atomic_store_explicit(&_list, std::move(list), std::memory_order_release);
+    }
 
-    mutable std::mutex _remove_later_mutex{};
-    std::vector<uint64_t> _remove_later{};
-    bool _remove_all_later{false};
+    // Only used to serialize changes to the list, not for calling.
+    std::mutex _mutex{};
+    uint64_t _last_id{1}; // Start at 1 because 0 is the "null handle"
+    std::shared_ptr<const List> _list{std::make_shared<List>()};
 };
 
 } // namespace mavsdk
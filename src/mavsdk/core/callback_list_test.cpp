@@ -2,6 +2,10 @@
 #include "callback_list.tpp"
 #include "log.h"
 #include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
 
 namespace mavsdk {
 
@@ -11,6 +15,26 @@ template class CallbackList<>;
 } // namespace mavsdk
 
 using namespace mavsdk;
+
+namespace {
+
+// Counts how often it was copied, standing in for a big struct like a mission plan.
+struct Payload {
+    Payload() = default;
+    Payload(const Payload& other) : copies(other.copies + 1) {}
+    Payload(Payload&&) = default;
+    Payload& operator=(const Payload& other)
+    {
+        copies = other.copies + 1;
+        return *this;
+    }
+    Payload& operator=(Payload&&) = default;
+
+    unsigned copies{0};
+};
+
+} // namespace
+
 TEST(CallbackList, SubscribeCallUnsubscribe)
 {
     unsigned first_called = 0;
@@ -98,3 +122,202 @@ TEST(CallbackList, UnsubscribeAllWithNullptr)
     // It should only be called once.
     EXPECT_EQ(num_called, 1);
 }
+
+TEST(CallbackList, SubscribeFromCallback)
+{
+    unsigned outer_called = 0;
+    unsigned inner_called = 0;
+
+    CallbackList<> cl;
+    cl.subscribe([&]() {
+        // Only subscribe the first time around.
+        if (outer_called++ == 0) {
+            cl.subscribe([&]() { ++inner_called; });
+        }
+    });
+
+    // The new callback is only part of the next call.
+    cl();
+    EXPECT_EQ(inner_called, 0);
+    cl();
+    EXPECT_EQ(inner_called, 1);
+}
+
+TEST(CallbackList, SubscribeWhileCalling)
+{
+    CallbackList<int, double> cl;
+    std::atomic<unsigned> num_called{0};
+    std::atomic<bool> should_exit{false};
+
+    std::thread caller([&]() {
+        while (!should_exit) {
+            cl(42, 77.7);
+        }
+    });
+
+    for (unsigned i = 0; i < 1000; ++i) {
+        auto handle = cl.subscribe([&](int, double) { ++num_called; });
+        cl.unsubscribe(handle);
+    }
+
+    should_exit = true;
+    caller.join();
+
+    EXPECT_TRUE(cl.empty());
+}
+
+TEST(CallbackList, QueuedCallsAreConflated)
+{
+    CallbackList<int, double> cl;
+    std::vector<std::function<void()>> queued;
+    const auto queue_func = [&](const std::function<void()>& func) { queued.push_back(func); };
+
+    std::vector<int> limited;
+    unsigned unlimited_called = 0;
+    cl.subscribe([&](int i, double) { limited.push_back(i); }, 1.0);
+    cl.subscribe([&](int, double) { ++unlimited_called; });
+
+    for (int i = 0; i < 10; ++i) {
+        cl.queue(i, 1.0, queue_func);
+    }
+
+    // Only one call is queued for the limited subscriber, and it gets the
+    // latest value once it runs.
+    ASSERT_EQ(queued.size(), 11);
+    for (const auto& func : queued) {
+        func();
+    }
+    EXPECT_EQ(unlimited_called, 10);
+    ASSERT_EQ(limited.size(), 1);
+    EXPECT_EQ(limited[0], 9);
+
+    // Within the interval, nothing else is queued.
+    queued.clear();
+    cl.queue(10, 1.0, queue_func);
+    EXPECT_EQ(queued.size(), 1);
+}
+
+TEST(CallbackList, QueuedCallsAreRateLimited)
+{
+    CallbackList<int, double> cl;
+    std::vector<int> limited;
+    cl.subscribe([&](int i, double) { limited.push_back(i); }, 50.0);
+
+    const auto run_now = [](const std::function<void()>& func) { func(); };
+    const auto start = std::chrono::steady_clock::now();
+    int i = 0;
+    while (std::chrono::steady_clock::now() - start < std::chrono::milliseconds(200)) {
+        cl.queue(i++, 1.0, run_now);
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+
+    // 50 Hz for 200 ms, a bit of slack for slow machines.
+    EXPECT_GE(limited.size(), 2);
+    EXPECT_LE(limited.size(), 11);
+    EXPECT_LT(limited.size(), static_cast<std::size_t>(i));
+}
+
+TEST(CallbackList, MaxRate)
+{
+    CallbackList<int> cl;
+    EXPECT_FALSE(cl.max_rate_hz());
+
+    auto unlimited = cl.subscribe([](int) {});
+    EXPECT_EQ(cl.max_rate_hz(), 0.0);
+
+    auto slow = cl.subscribe([](int) {}, 2.0);
+    auto fast = cl.subscribe([](int) {}, 10.0);
+    EXPECT_EQ(cl.max_rate_hz(), 10.0);
+
+    cl.unsubscribe(fast);
+    EXPECT_EQ(cl.max_rate_hz(), 2.0);
+
+    cl.unsubscribe(slow);
+    cl.unsubscribe(unlimited);
+    EXPECT_FALSE(cl.max_rate_hz());
+}
+
+TEST(CallbackList, ArgumentsAreMovedToTheLastSubscriber)
+{
+    CallbackList<Payload> cl;
+    std::vector<unsigned> copies;
+    cl.subscribe([&](Payload payload) { copies.push_back(payload.copies); });
+    cl.subscribe([&](Payload payload) { copies.push_back(payload.copies); });
+
+    cl(Payload{});
+
+    ASSERT_EQ(copies.size(), 2);
+    EXPECT_EQ(copies[0], 1);
+    EXPECT_EQ(copies[1], 0);
+}
+
+TEST(CallbackList, QueuedArgumentsAreNotCopiedForOneSubscriber)
+{
+    CallbackList<Payload> cl;
+    std::vector<std::function<void()>> queued;
+    const auto queue_func = [&](const std::function<void()>& func) { queued.push_back(func); };
+
+    std::vector<unsigned> copies;
+    cl.subscribe([&](Payload payload) { copies.push_back(payload.copies); });
+
+    cl.queue(Payload{}, queue_func);
+    ASSERT_EQ(queued.size(), 1);
+    queued[0]();
+
+    ASSERT_EQ(copies.size(), 1);
+    EXPECT_EQ(copies[0], 0);
+}
+
+TEST(CallbackList, QueuedArgumentsAreSharedBetweenSubscribers)
+{
+    CallbackList<Payload> cl;
+    std::vector<std::function<void()>> queued;
+    const auto queue_func = [&](const std::function<void()>& func) { queued.push_back(func); };
+
+    std::vector<unsigned> copies;
+    for (int i = 0; i < 3; ++i) {
+        cl.subscribe([&](Payload payload) { copies.push_back(payload.copies); });
+    }
+
+    cl.queue(Payload{}, queue_func);
+    ASSERT_EQ(queued.size(), 3);
+    for (const auto& func : queued) {
+        func();
+    }
+
+    // Every subscriber gets its copy, but copying the calls did not add any.
+    ASSERT_EQ(copies.size(), 3);
+    for (const auto count : copies) {
+        EXPECT_EQ(count, 1);
+    }
+}
+
+TEST(CallbackList, LazyArgumentsAreOnlyMadeForSubscribers)
+{
+    CallbackList<int, double> cl;
+    std::vector<std::function<void()>> queued;
+    const auto queue_func = [&](const std::function<void()>& func) { queued.push_back(func); };
+
+    unsigned made = 0;
+    const auto make_args = [&]() {
+        ++made;
+        return std::make_tuple(42, 1.0);
+    };
+
+    cl.queue_lazily(make_args, queue_func);
+    EXPECT_EQ(made, 0);
+    EXPECT_TRUE(queued.empty());
+
+    std::vector<int> called;
+    cl.subscribe([&](int i, double) { called.push_back(i); });
+    cl.subscribe([&](int i, double) { called.push_back(i); }, 1.0);
+
+    // Made once, however many subscribers there are.
+    cl.queue_lazily(make_args, queue_func);
+    EXPECT_EQ(made, 1);
+    ASSERT_EQ(queued.size(), 2);
+    for (const auto& func : queued) {
+        func();
+    }
+    EXPECT_EQ(called, (std::vector<int>{42, 42}));
+}
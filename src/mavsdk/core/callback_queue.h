@@ -0,0 +1,566 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+
+namespace mavsdk {
+
+// Types shared by all CallbackQueue<T>.
+class CallbackQueueBase {
+public:
+    enum class OverflowPolicy {
+        DropNewest,
+        DropOldest,
+        CoalesceByKey, // For items with a key, drop newest for the others.
+    };
+
+    struct Stats {
+        uint64_t enqueued{0};
+        uint64_t dropped{0};
+        uint64_t coalesced{0};
+        size_t max_depth{0};
+    };
+
+    enum class PushResult {
+        Enqueued,
+        Coalesced,
+        Dropped, // The item given was dropped.
+        DroppedOldest, // The item given was enqueued but an older one was dropped.
+    };
+};
+
+/*
+ * Bounded queue for many producers and a single consumer thread.
+ *
+ * Pushing and popping are lock-free. They are based on the bounded queue by
+ * Dmitry Vyukov where each slot carries a sequence number:
+ * https://www.1024cores.net/home/lock-free-algorithms/queues/bounded-mpmc-queue
+ *
+ * The only lock is used to put the consumer to sleep when the queue is empty,
+ * and producers only take it if the consumer is actually sleeping.
+ *
+ * Items pushed with a key can be coalesced: as long as an item with the same
+ * key is still queued, it is replaced by the newer one instead of taking up
+ * another slot.
+ */
+template<typename T> class CallbackQueue : public CallbackQueueBase {
+public:
+    CallbackQueue(size_t capacity, OverflowPolicy overflow_policy) :
+        _capacity(capacity > 0 ? capacity : 1),
+        _mask(round_up_to_power_of_two(_capacity) - 1),
+        _slots(new Slot[_mask + 1]),
+        _overflow_policy(overflow_policy)
+    {
+        for (size_t i = 0; i <= _mask; ++i) {
+            _slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    ~CallbackQueue()
+    {
+        for (auto& cell : _coalesce_cells) {
+            delete cell.pending.exchange(nullptr);
+        }
+    }
+
+    // delete copy and move constructors and assign operators
+    CallbackQueue(CallbackQueue const&) = delete; // Copy construct
+    CallbackQueue(CallbackQueue&&) = delete; // Move construct
+    CallbackQueue& operator=(CallbackQueue const&) = delete; // Copy assign
+    CallbackQueue& operator=(CallbackQueue&&) = delete; // Move assign
+
+    PushResult enqueue(T item, const void* key = nullptr)
+    {
+        PushResult result;
+        if (key != nullptr && _overflow_policy == OverflowPolicy::CoalesceByKey) {
+            result = enqueue_coalesced(std::move(item), key);
+        } else {
+            result = enqueue_entry(Entry{std::move(item), no_cell});
+        }
+
+        count(result);
+        if (result != PushResult::Dropped) {
+            wake_consumer();
+        }
+        return result;
+    }
+
+    // Blocks until an item is available, returns nothing once stopped.
+    std::optional<T> dequeue()
+    {
+        while (!_should_exit.load(std::memory_order_acquire)) {
+            if (auto item = try_dequeue()) {
+                return item;
+            }
+
+            std::unique_lock<std::mutex> lock(_sleep_mutex);
+            _consumer_sleeping.store(true, std::memory_order_seq_cst);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            // Check again, a producer might have pushed before it could see
+            // us sleeping.
+            if (!empty() || _should_exit.load(std::memory_order_acquire)) {
+                _consumer_sleeping.store(false, std::memory_order_relaxed);
+                continue;
+            }
+            _sleep_cv.wait(lock, [this]() {
+                return !_consumer_sleeping.load(std::memory_order_relaxed) ||
+                       _should_exit.load(std::memory_order_acquire);
+            });
+            _consumer_sleeping.store(false, std::memory_order_relaxed);
+        }
+        return std::nullopt;
+    }
+
+    std::optional<T> try_dequeue()
+    {
+        while (true) {
+            auto entry = pop_entry();
+            if (!entry) {
+                return std::nullopt;
+            }
+
+            if (entry->cell_index == no_cell) {
+                return std::move(entry->item);
+            }
+
+            // The actual item is waiting in the cell, where it might have
+            // been replaced by a newer one in the meantime.
+            std::unique_ptr<Pending> pending{
+                _coalesce_cells[entry->cell_index].pending.exchange(
+                    nullptr, std::memory_order_acq_rel)};
+            if (pending) {
+                return std::move(pending->item);
+            }
+        }
+    }
+
+    void stop()
+    {
+        // This can be used if the wait needs to be interrupted, e.g.
+        // when trying to stop a worker thread.
+        std::lock_guard<std::mutex> lock(_sleep_mutex);
+        _should_exit.store(true, std::memory_order_release);
+        _sleep_cv.notify_all();
+    }
+
+    // This is only a snapshot and can be outdated immediately.
+    size_t size() const
+    {
+        const size_t enqueue_pos = _enqueue_pos.load(std::memory_order_acquire);
+        const size_t dequeue_pos = _dequeue_pos.load(std::memory_order_acquire);
+        return enqueue_pos > dequeue_pos ? enqueue_pos - dequeue_pos : 0;
+    }
+
+    bool empty() const { return size() == 0; }
+
+    size_t capacity() const { return _capacity; }
+
+    // The slots are allocated up front, what queued items allocate
+    // themselves is not included.
+    size_t memory_usage() const { return sizeof(*this) + (_mask + 1) * sizeof(Slot); }
+
+    Stats stats() const
+    {
+        Stats stats;
+        stats.enqueued = _enqueued.load(std::memory_order_relaxed);
+        stats.dropped = _dropped.load(std::memory_order_relaxed);
+        stats.coalesced = _coalesced.load(std::memory_order_relaxed);
+        stats.max_depth = _max_depth.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+private:
+    static constexpr size_t num_coalesce_cells = 256;
+    static constexpr size_t no_cell = SIZE_MAX;
+
+    struct Entry {
+        std::optional<T> item; // Empty if the item is in a coalesce cell.
+        size_t cell_index;
+    };
+
+    struct Pending {
+        T item;
+    };
+
+    struct CoalesceCell {
+        std::atomic<const void*> key{nullptr};
+        std::atomic<Pending*> pending{nullptr};
+    };
+
+    struct Slot {
+        std::atomic<size_t> sequence{0};
+        std::optional<Entry> entry{};
+    };
+
+    static size_t round_up_to_power_of_two(size_t value)
+    {
+        size_t result = 2;
+        while (result < value) {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    static size_t cell_index_for(const void* key)
+    {
+        auto value = reinterpret_cast<uintptr_t>(key);
+        // Pointers are aligned, so the lower bits don't tell us much.
+        value ^= value >> 12;
+        value ^= value >> 4;
+        return value % num_coalesce_cells;
+    }
+
+    PushResult enqueue_coalesced(T item, const void* key)
+    {
+        const size_t cell_index = cell_index_for(key);
+        auto& cell = _coalesce_cells[cell_index];
+
+        // Cells are handed out to keys on first use and kept. Keys that
+        // end up on a cell that is already taken are simply not coalesced.
+        const void* owner = cell.key.load(std::memory_order_acquire);
+        if (owner == nullptr &&
+            cell.key.compare_exchange_strong(owner, key, std::memory_order_acq_rel)) {
+            owner = key;
+        }
+        if (owner != key) {
+            return enqueue_entry(Entry{std::move(item), no_cell});
+        }
+
+        // Whoever takes a pending item out of the cell owns it, so there is
+        // no way anyone else still looks at the one we replace.
+        auto* previous = cell.pending.exchange(
+            new Pending{std::move(item)}, std::memory_order_acq_rel);
+        if (previous != nullptr) {
+            delete previous;
+            return PushResult::Coalesced;
+        }
+
+        // The cell was empty, so it needs an entry pointing to it.
+        if (push_entry(Entry{std::nullopt, cell_index})) {
+            return PushResult::Enqueued;
+        }
+
+        // No space, so we take whatever is in the cell back out again.
+        delete cell.pending.exchange(nullptr, std::memory_order_acq_rel);
+        return PushResult::Dropped;
+    }
+
+    PushResult enqueue_entry(Entry entry)
+    {
+        if (push_entry(entry)) {
+            return PushResult::Enqueued;
+        }
+
+        if (_overflow_policy != OverflowPolicy::DropOldest) {
+            return PushResult::Dropped;
+        }
+
+        do {
+            // This is safe to do from the producer side, the queue works with
+            // several consumers as well.
+            auto oldest = pop_entry();
+            if (!oldest) {
+                continue;
+            }
+            if (oldest->cell_index != no_cell) {
+                delete _coalesce_cells[oldest->cell_index].pending.exchange(
+                    nullptr, std::memory_order_acq_rel);
+            }
+            _dropped.fetch_add(1, std::memory_order_relaxed);
+        } while (!push_entry(entry));
+
+        return PushResult::DroppedOldest;
+    }
+
+    // The entry is only moved from on success.
+    bool push_entry(Entry& entry)
+    {
+        size_t pos = _enqueue_pos.load(std::memory_order_relaxed);
+        Slot* slot;
+
+        while (true) {
+            const auto depth = static_cast<intptr_t>(
+                pos - _dequeue_pos.load(std::memory_order_acquire));
+            if (depth >= static_cast<intptr_t>(_capacity)) {
+                return false;
+            }
+
+            slot = &_slots[pos & _mask];
+            const size_t sequence = slot->sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+
+            if (diff == 0) {
+                if (_enqueue_pos.compare_exchange_weak(
+                        pos, pos + 1, std::memory_order_relaxed, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = _enqueue_pos.load(std::memory_order_relaxed);
+            }
+        }
+
+        slot->entry.emplace(std::move(entry));
+        slot->sequence.store(pos + 1, std::memory_order_release);
+
+        update_max_depth(pos + 1);
+        return true;
+    }
+
+    bool push_entry(Entry&& entry) { return push_entry(entry); }
+
+    std::optional<Entry> pop_entry()
+    {
+        size_t pos = _dequeue_pos.load(std::memory_order_relaxed);
+        Slot* slot;
+
+        while (true) {
+            slot = &_slots[pos & _mask];
+            const size_t sequence = slot->sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1);
+
+            if (diff == 0) {
+                if (_dequeue_pos.compare_exchange_weak(
+                        pos, pos + 1, std::memory_order_relaxed, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return std::nullopt;
+            } else {
+                pos = _dequeue_pos.load(std::memory_order_relaxed);
+            }
+        }
+
+        std::optional<Entry> entry{std::move(slot->entry)};
+        slot->entry.reset();
+        slot->sequence.store(pos + _mask + 1, std::memory_order_release);
+        return entry;
+    }
+
+    void update_max_depth(size_t enqueue_pos)
+    {
+        const size_t dequeue_pos = _dequeue_pos.load(std::memory_order_relaxed);
+        const size_t depth = enqueue_pos > dequeue_pos ? enqueue_pos - dequeue_pos : 0;
+
+        size_t max_depth = _max_depth.load(std::memory_order_relaxed);
+        while (depth > max_depth &&
+               !_max_depth.compare_exchange_weak(max_depth, depth, std::memory_order_relaxed)) {
+        }
+    }
+
+    void count(PushResult result)
+    {
+        switch (result) {
+            case PushResult::Enqueued:
+            case PushResult::DroppedOldest:
+                _enqueued.fetch_add(1, std::memory_order_relaxed);
+                break;
+            case PushResult::Coalesced:
+                _coalesced.fetch_add(1, std::memory_order_relaxed);
+                break;
+            case PushResult::Dropped:
+                _dropped.fetch_add(1, std::memory_order_relaxed);
+                break;
+        }
+    }
+
+    void wake_consumer()
+    {
+        // Pairs with the store in dequeue(), so that either we see the
+        // consumer sleeping, or it sees our item.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (_consumer_sleeping.exchange(false, std::memory_order_seq_cst)) {
+            std::lock_guard<std::mutex> lock(_sleep_mutex);
+            _sleep_cv.notify_one();
+        }
+    }
+
+    const size_t _capacity;
+    const size_t _mask;
+    std::unique_ptr<Slot[]> _slots;
+    const OverflowPolicy _overflow_policy;
+
+    alignas(64) std::atomic<size_t> _enqueue_pos{0};
+    alignas(64) std::atomic<size_t> _dequeue_pos{0};
+
+    std::array<CoalesceCell, num_coalesce_cells> _coalesce_cells{};
+
+    std::atomic<uint64_t> _enqueued{0};
+    std::atomic<uint64_t> _dropped{0};
+    std::atomic<uint64_t> _coalesced{0};
+    std::atomic<size_t> _max_depth{0};
+
+    std::atomic<bool> _consumer_sleeping{false};
+    std::atomic<bool> _should_exit{false};
+    std::mutex _sleep_mutex{};
+    std::condition_variable _sleep_cv{};
+};
+
+// The lanes of user callbacks, in the order they are called.
+enum class CallbackLane : uint8_t {
+    Control, // Results the user is waiting for, e.g. of commands or transfers.
+    Events, // Anything else, e.g. state changes.
+    Telemetry, // High rate updates, e.g. positions.
+};
+
+/*
+ * One CallbackQueue per CallbackLane, with one consumer thread for all of
+ * them. Items of a lane are only taken once the lanes before it are empty,
+ * so a result is never stuck behind a backlog of telemetry. Items of the
+ * same lane keep their order.
+ *
+ * Each lane has its own capacity, so that a full lane only drops its own
+ * items.
+ */
+template<typename T> class CallbackLanes : public CallbackQueueBase {
+public:
+    static constexpr size_t num_lanes = 3;
+
+    CallbackLanes(
+        const std::array<size_t, num_lanes>& capacities, OverflowPolicy overflow_policy) :
+        _lanes{
+            std::make_unique<CallbackQueue<T>>(capacities[0], overflow_policy),
+            std::make_unique<CallbackQueue<T>>(capacities[1], overflow_policy),
+            std::make_unique<CallbackQueue<T>>(capacities[2], overflow_policy)}
+    {}
+
+    ~CallbackLanes() = default;
+
+    // delete copy and move constructors and assign operators
+    CallbackLanes(CallbackLanes const&) = delete; // Copy construct
+    CallbackLanes(CallbackLanes&&) = delete; // Move construct
+    CallbackLanes& operator=(CallbackLanes const&) = delete; // Copy assign
+    CallbackLanes& operator=(CallbackLanes&&) = delete; // Move assign
+
+    PushResult enqueue(CallbackLane lane, T item, const void* key = nullptr)
+    {
+        // Nobody waits on the lane itself, so it won't wake anyone up.
+        const auto result = lane_queue(lane).enqueue(std::move(item), key);
+        if (result != PushResult::Dropped) {
+            wake_consumer();
+        }
+        return result;
+    }
+
+    // Blocks until an item is available, returns nothing once stopped.
+    std::optional<T> dequeue()
+    {
+        while (!_should_exit.load(std::memory_order_acquire)) {
+            if (auto item = try_dequeue()) {
+                return item;
+            }
+
+            // The same handshake as in CallbackQueue::dequeue().
+            std::unique_lock<std::mutex> lock(_sleep_mutex);
+            _consumer_sleeping.store(true, std::memory_order_seq_cst);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (!empty() || _should_exit.load(std::memory_order_acquire)) {
+                _consumer_sleeping.store(false, std::memory_order_relaxed);
+                continue;
+            }
+            _sleep_cv.wait(lock, [this]() {
+                return !_consumer_sleeping.load(std::memory_order_relaxed) ||
+                       _should_exit.load(std::memory_order_acquire);
+            });
+            _consumer_sleeping.store(false, std::memory_order_relaxed);
+        }
+        return std::nullopt;
+    }
+
+    std::optional<T> try_dequeue()
+    {
+        for (auto& lane : _lanes) {
+            if (auto item = lane->try_dequeue()) {
+                return item;
+            }
+        }
+        return std::nullopt;
+    }
+
+    void stop()
+    {
+        std::lock_guard<std::mutex> lock(_sleep_mutex);
+        _should_exit.store(true, std::memory_order_release);
+        _sleep_cv.notify_all();
+    }
+
+    // This is only a snapshot and can be outdated immediately.
+    size_t size() const
+    {
+        size_t result = 0;
+        for (const auto& lane : _lanes) {
+            result += lane->size();
+        }
+        return result;
+    }
+
+    bool empty() const { return size() == 0; }
+
+    size_t size(CallbackLane lane) const { return lane_queue(lane).size(); }
+
+    size_t memory_usage() const
+    {
+        size_t result = sizeof(*this);
+        for (const auto& lane : _lanes) {
+            result += lane->memory_usage();
+        }
+        return result;
+    }
+
+    // Summed up over all lanes, the max depth is the one of the deepest lane.
+    Stats stats() const
+    {
+        Stats result;
+        for (const auto& lane : _lanes) {
+            const auto stats = lane->stats();
+            result.enqueued += stats.enqueued;
+            result.dropped += stats.dropped;
+            result.coalesced += stats.coalesced;
+            result.max_depth = std::max(result.max_depth, stats.max_depth);
+        }
+        return result;
+    }
+
+    Stats stats(CallbackLane lane) const { return lane_queue(lane).stats(); }
+
+private:
+    CallbackQueue<T>& lane_queue(CallbackLane lane)
+    {
+        return *_lanes[static_cast<size_t>(lane) % num_lanes];
+    }
+
+    const CallbackQueue<T>& lane_queue(CallbackLane lane) const
+    {
+        return *_lanes[static_cast<size_t>(lane) % num_lanes];
+    }
+
+    void wake_consumer()
+    {
+        // Pairs with the store in dequeue(), so that either we see the
+        // consumer sleeping, or it sees our item.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (_consumer_sleeping.exchange(false, std::memory_order_seq_cst)) {
+            std::lock_guard<std::mutex> lock(_sleep_mutex);
+            _sleep_cv.notify_one();
+        }
+    }
+
+    // The queues have atomics, so they can't be moved into the array.
+    const std::array<std::unique_ptr<CallbackQueue<T>>, num_lanes> _lanes;
+
+    std::atomic<bool> _consumer_sleeping{false};
+    std::atomic<bool> _should_exit{false};
+    std::mutex _sleep_mutex{};
+    std::condition_variable _sleep_cv{};
+};
+
+} // namespace mavsdk
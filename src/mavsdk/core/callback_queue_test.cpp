@@ -0,0 +1,226 @@
+#include "callback_queue.h"
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+using namespace mavsdk;
+
+using Queue = CallbackQueue<int>;
+
+TEST(CallbackQueue, FillAndEmpty)
+{
+    Queue queue{10, Queue::OverflowPolicy::DropNewest};
+
+    EXPECT_EQ(queue.enqueue(1), Queue::PushResult::Enqueued);
+    EXPECT_EQ(queue.size(), 1);
+    queue.enqueue(2);
+    queue.enqueue(3);
+    ASSERT_EQ(queue.size(), 3);
+
+    EXPECT_EQ(queue.dequeue().value(), 1);
+    EXPECT_EQ(queue.size(), 2);
+    EXPECT_EQ(queue.dequeue().value(), 2);
+    EXPECT_EQ(queue.dequeue().value(), 3);
+    EXPECT_EQ(queue.size(), 0);
+    EXPECT_EQ(queue.try_dequeue(), std::nullopt);
+
+    queue.stop();
+    EXPECT_EQ(queue.dequeue(), std::nullopt);
+}
+
+TEST(CallbackQueue, DropNewest)
+{
+    Queue queue{3, Queue::OverflowPolicy::DropNewest};
+
+    for (int i = 0; i < 3; ++i) {
+        EXPECT_EQ(queue.enqueue(i), Queue::PushResult::Enqueued);
+    }
+    EXPECT_EQ(queue.enqueue(3), Queue::PushResult::Dropped);
+    EXPECT_EQ(queue.enqueue(4), Queue::PushResult::Dropped);
+
+    EXPECT_EQ(queue.try_dequeue().value(), 0);
+    EXPECT_EQ(queue.try_dequeue().value(), 1);
+    EXPECT_EQ(queue.try_dequeue().value(), 2);
+    EXPECT_EQ(queue.try_dequeue(), std::nullopt);
+
+    const auto stats = queue.stats();
+    EXPECT_EQ(stats.enqueued, 3);
+    EXPECT_EQ(stats.dropped, 2);
+    EXPECT_EQ(stats.coalesced, 0);
+    EXPECT_EQ(stats.max_depth, 3);
+}
+
+TEST(CallbackQueue, DropOldest)
+{
+    Queue queue{3, Queue::OverflowPolicy::DropOldest};
+
+    for (int i = 0; i < 3; ++i) {
+        EXPECT_EQ(queue.enqueue(i), Queue::PushResult::Enqueued);
+    }
+    EXPECT_EQ(queue.enqueue(3), Queue::PushResult::DroppedOldest);
+    EXPECT_EQ(queue.enqueue(4), Queue::PushResult::DroppedOldest);
+
+    EXPECT_EQ(queue.try_dequeue().value(), 2);
+    EXPECT_EQ(queue.try_dequeue().value(), 3);
+    EXPECT_EQ(queue.try_dequeue().value(), 4);
+    EXPECT_EQ(queue.try_dequeue(), std::nullopt);
+
+    const auto stats = queue.stats();
+    EXPECT_EQ(stats.enqueued, 5);
+    EXPECT_EQ(stats.dropped, 2);
+    EXPECT_EQ(stats.max_depth, 3);
+}
+
+TEST(CallbackQueue, CoalesceByKey)
+{
+    Queue queue{10, Queue::OverflowPolicy::CoalesceByKey};
+
+    int key_a;
+    int key_b;
+
+    EXPECT_EQ(queue.enqueue(1, &key_a), Queue::PushResult::Enqueued);
+    EXPECT_EQ(queue.enqueue(2, &key_b), Queue::PushResult::Enqueued);
+    EXPECT_EQ(queue.enqueue(3), Queue::PushResult::Enqueued);
+    EXPECT_EQ(queue.enqueue(4, &key_a), Queue::PushResult::Coalesced);
+    EXPECT_EQ(queue.enqueue(5, &key_a), Queue::PushResult::Coalesced);
+
+    // The newest one for a key keeps the place of the first one.
+    EXPECT_EQ(queue.try_dequeue().value(), 5);
+    EXPECT_EQ(queue.try_dequeue().value(), 2);
+    EXPECT_EQ(queue.try_dequeue().value(), 3);
+    EXPECT_EQ(queue.try_dequeue(), std::nullopt);
+
+    // Once taken out, the key gets queued again.
+    EXPECT_EQ(queue.enqueue(6, &key_a), Queue::PushResult::Enqueued);
+    EXPECT_EQ(queue.try_dequeue().value(), 6);
+
+    const auto stats = queue.stats();
+    EXPECT_EQ(stats.enqueued, 4);
+    EXPECT_EQ(stats.coalesced, 2);
+    EXPECT_EQ(stats.dropped, 0);
+}
+
+TEST(CallbackQueue, CoalesceWhenFull)
+{
+    Queue queue{2, Queue::OverflowPolicy::CoalesceByKey};
+
+    int key;
+
+    EXPECT_EQ(queue.enqueue(1, &key), Queue::PushResult::Enqueued);
+    EXPECT_EQ(queue.enqueue(2), Queue::PushResult::Enqueued);
+    EXPECT_EQ(queue.enqueue(3), Queue::PushResult::Dropped);
+    EXPECT_EQ(queue.enqueue(4, &key), Queue::PushResult::Coalesced);
+
+    EXPECT_EQ(queue.try_dequeue().value(), 4);
+    EXPECT_EQ(queue.try_dequeue().value(), 2);
+}
+
+TEST(CallbackQueue, ManyProducers)
+{
+    Queue queue{64, Queue::OverflowPolicy::DropNewest};
+
+    constexpr int num_producers = 4;
+    constexpr int num_per_producer = 10000;
+
+    std::vector<std::thread> producers;
+    for (int i = 0; i < num_producers; ++i) {
+        producers.emplace_back([&queue, i]() {
+            for (int j = 0; j < num_per_producer; ++j) {
+                // Spin until it fits, we want all of them in the end.
+                while (queue.enqueue(i * num_per_producer + j) == Queue::PushResult::Dropped) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    std::vector<int> last_seen(num_producers, -1);
+    int num_received = 0;
+    while (num_received < num_producers * num_per_producer) {
+        auto value = queue.dequeue();
+        ASSERT_TRUE(value);
+
+        // Order needs to be kept per producer.
+        const int producer = value.value() / num_per_producer;
+        EXPECT_GT(value.value(), last_seen[producer]);
+        last_seen[producer] = value.value();
+        ++num_received;
+    }
+
+    for (auto& producer : producers) {
+        producer.join();
+    }
+
+    EXPECT_LE(queue.stats().max_depth, 64);
+    EXPECT_EQ(queue.try_dequeue(), std::nullopt);
+}
+
+TEST(CallbackQueue, StopWhileWaiting)
+{
+    Queue queue{10, Queue::OverflowPolicy::DropNewest};
+
+    std::thread consumer([&queue]() { EXPECT_EQ(queue.dequeue(), std::nullopt); });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    queue.stop();
+    consumer.join();
+}
+
+using Lanes = CallbackLanes<int>;
+
+TEST(CallbackLanes, EarlierLanesFirst)
+{
+    Lanes lanes{{10, 10, 10}, Lanes::OverflowPolicy::DropNewest};
+
+    lanes.enqueue(CallbackLane::Telemetry, 1);
+    lanes.enqueue(CallbackLane::Telemetry, 2);
+    lanes.enqueue(CallbackLane::Events, 3);
+    lanes.enqueue(CallbackLane::Control, 4);
+    lanes.enqueue(CallbackLane::Events, 5);
+    EXPECT_EQ(lanes.size(), 5);
+    EXPECT_EQ(lanes.size(CallbackLane::Telemetry), 2);
+
+    EXPECT_EQ(lanes.try_dequeue(), 4);
+    EXPECT_EQ(lanes.try_dequeue(), 3);
+    EXPECT_EQ(lanes.try_dequeue(), 5);
+    EXPECT_EQ(lanes.try_dequeue(), 1);
+    EXPECT_EQ(lanes.try_dequeue(), 2);
+    EXPECT_EQ(lanes.try_dequeue(), std::nullopt);
+    EXPECT_TRUE(lanes.empty());
+}
+
+TEST(CallbackLanes, FullLaneOnlyDropsItsOwn)
+{
+    Lanes lanes{{2, 2, 2}, Lanes::OverflowPolicy::DropNewest};
+
+    for (int i = 0; i < 5; ++i) {
+        lanes.enqueue(CallbackLane::Telemetry, i);
+    }
+    EXPECT_EQ(
+        lanes.enqueue(CallbackLane::Control, 42), CallbackQueueBase::PushResult::Enqueued);
+
+    EXPECT_EQ(lanes.stats(CallbackLane::Telemetry).dropped, 3);
+    EXPECT_EQ(lanes.stats(CallbackLane::Control).dropped, 0);
+    EXPECT_EQ(lanes.stats().enqueued, 3);
+
+    EXPECT_EQ(lanes.try_dequeue(), 42);
+}
+
+TEST(CallbackLanes, WakesUpForAnyLane)
+{
+    Lanes lanes{{10, 10, 10}, Lanes::OverflowPolicy::DropNewest};
+
+    std::thread consumer([&lanes]() {
+        EXPECT_EQ(lanes.dequeue(), 1);
+        EXPECT_EQ(lanes.dequeue(), 2);
+        EXPECT_EQ(lanes.dequeue(), std::nullopt);
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    lanes.enqueue(CallbackLane::Telemetry, 1);
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    lanes.enqueue(CallbackLane::Control, 2);
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    lanes.stop();
+    consumer.join();
+}
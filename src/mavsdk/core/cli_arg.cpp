@@ -12,6 +12,7 @@ void CliArg::reset()
     _path.clear();
     _baudrate = 0;
     _port = 0;
+    _tlog_max_speed = false;
 }
 
 bool CliArg::parse(const std::string& uri)
@@ -23,6 +24,26 @@ bool CliArg::parse(const std::string& uri)
         return false;
     }
 
+    if (_protocol == Protocol::Tlog) {
+        // A file path can contain anything, including ':'.
+        if (rest.empty()) {
+            LogWarn() << "Path for tlog required.";
+            return false;
+        }
+        _path = rest;
+        return true;
+    }
+
+    if (_protocol == Protocol::Loopback) {
+        // Just a name, both ends use the same.
+        if (rest.empty()) {
+            LogWarn() << "Name for loopback required.";
+            return false;
+        }
+        _path = rest;
+        return true;
+    }
+
     if (!find_path(rest)) {
         return false;
     }
@@ -44,8 +65,12 @@ bool CliArg::find_protocol(std::string& rest)
 {
     const std::string udp = "udp";
     const std::string tcp = "tcp";
+    const std::string tcp_in = "tcpin";
     const std::string serial = "serial";
     const std::string serial_flowcontrol = "serial_flowcontrol";
+    const std::string tlog = "tlog";
+    const std::string tlog_maxspeed = "tlog_maxspeed";
+    const std::string loopback = "loopback";
     const std::string delimiter = "://";
 
     if (rest.find(udp + delimiter) == 0) {
@@ -56,6 +81,10 @@ bool CliArg::find_protocol(std::string& rest)
         _protocol = Protocol::Tcp;
         rest.erase(0, tcp.length() + delimiter.length());
         return true;
+    } else if (rest.find(tcp_in + delimiter) == 0) {
+        _protocol = Protocol::TcpIn;
+        rest.erase(0, tcp_in.length() + delimiter.length());
+        return true;
     } else if (rest.find(serial + delimiter) == 0) {
         _protocol = Protocol::Serial;
         _flow_control_enabled = false;
@@ -66,6 +95,20 @@ bool CliArg::find_protocol(std::string& rest)
         _flow_control_enabled = true;
         rest.erase(0, serial_flowcontrol.length() + delimiter.length());
         return true;
+    } else if (rest.find(tlog + delimiter) == 0) {
+        _protocol = Protocol::Tlog;
+        _tlog_max_speed = false;
+        rest.erase(0, tlog.length() + delimiter.length());
+        return true;
+    } else if (rest.find(tlog_maxspeed + delimiter) == 0) {
+        _protocol = Protocol::Tlog;
+        _tlog_max_speed = true;
+        rest.erase(0, tlog_maxspeed.length() + delimiter.length());
+        return true;
+    } else if (rest.find(loopback + delimiter) == 0) {
+        _protocol = Protocol::Loopback;
+        rest.erase(0, loopback.length() + delimiter.length());
+        return true;
     } else {
         LogWarn() << "Unknown protocol";
         return false;
@@ -75,7 +118,8 @@ bool CliArg::find_protocol(std::string& rest)
 bool CliArg::find_path(std::string& rest)
 {
     if (rest.length() == 0) {
-        if (_protocol == Protocol::Udp || _protocol == Protocol::Tcp) {
+        if (_protocol == Protocol::Udp || _protocol == Protocol::Tcp ||
+            _protocol == Protocol::TcpIn) {
             // We have to use the default path
             return true;
         } else {
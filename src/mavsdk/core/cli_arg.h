@@ -6,7 +6,7 @@ namespace mavsdk {
 
 class CliArg {
 public:
-    enum class Protocol { None, Udp, Tcp, Serial };
+    enum class Protocol { None, Udp, Tcp, TcpIn, Serial, Tlog, Loopback };
 
     bool parse(const std::string& uri);
 
@@ -20,6 +20,8 @@ public:
 
     [[nodiscard]] std::string get_path() const { return _path; }
 
+    [[nodiscard]] bool get_tlog_max_speed() const { return _tlog_max_speed; }
+
 private:
     void reset();
     bool find_protocol(std::string& rest);
@@ -32,6 +34,7 @@ private:
     int _port{0};
     int _baudrate{0};
     bool _flow_control_enabled{false};
+    bool _tlog_max_speed{false};
 };
 
 } // namespace mavsdk
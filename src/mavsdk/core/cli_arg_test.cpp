@@ -116,6 +116,33 @@ TEST(CliArg, TCPConnections)
     EXPECT_FALSE(ca.parse("tcp://127.0.0.1:-5"));
 }
 
+TEST(CliArg, TCPServerConnections)
+{
+    CliArg ca;
+
+    EXPECT_TRUE(ca.parse("tcpin://"));
+    EXPECT_EQ(ca.get_protocol(), CliArg::Protocol::TcpIn);
+    EXPECT_STREQ(ca.get_path().c_str(), "");
+    EXPECT_EQ(0, ca.get_port());
+
+    EXPECT_TRUE(ca.parse("tcpin://:5760"));
+    EXPECT_EQ(ca.get_protocol(), CliArg::Protocol::TcpIn);
+    EXPECT_STREQ(ca.get_path().c_str(), "");
+    EXPECT_EQ(5760, ca.get_port());
+
+    EXPECT_TRUE(ca.parse("tcpin://0.0.0.0:5761"));
+    EXPECT_EQ(ca.get_protocol(), CliArg::Protocol::TcpIn);
+    EXPECT_STREQ(ca.get_path().c_str(), "0.0.0.0");
+    EXPECT_EQ(5761, ca.get_port());
+
+    // Not to be confused with the client.
+    EXPECT_TRUE(ca.parse("tcp://127.0.0.1:5760"));
+    EXPECT_EQ(ca.get_protocol(), CliArg::Protocol::Tcp);
+
+    EXPECT_FALSE(ca.parse("tcpin:/0.0.0.0:5760"));
+    EXPECT_FALSE(ca.parse("tcpin://0.0.0.0:100000"));
+}
+
 TEST(CliArg, SerialConnections)
 {
     CliArg ca;
@@ -167,3 +194,31 @@ TEST(CliArg, SerialConnections)
     EXPECT_FALSE(ca.parse("serial://SOM3:57600"));
     EXPECT_FALSE(ca.parse("serial://COM3:-1"));
 }
+
+TEST(CliArg, TlogConnections)
+{
+    CliArg ca;
+
+    EXPECT_TRUE(ca.parse("tlog:///home/user/flight.tlog"));
+    EXPECT_EQ(ca.get_protocol(), CliArg::Protocol::Tlog);
+    EXPECT_STREQ(ca.get_path().c_str(), "/home/user/flight.tlog");
+    EXPECT_FALSE(ca.get_tlog_max_speed());
+
+    EXPECT_TRUE(ca.parse("tlog_maxspeed://C:\\logs\\flight.tlog"));
+    EXPECT_EQ(ca.get_protocol(), CliArg::Protocol::Tlog);
+    EXPECT_STREQ(ca.get_path().c_str(), "C:\\logs\\flight.tlog");
+    EXPECT_TRUE(ca.get_tlog_max_speed());
+
+    EXPECT_FALSE(ca.parse("tlog://"));
+}
+
+TEST(CliArg, LoopbackConnections)
+{
+    CliArg ca;
+
+    EXPECT_TRUE(ca.parse("loopback://hil"));
+    EXPECT_EQ(ca.get_protocol(), CliArg::Protocol::Loopback);
+    EXPECT_STREQ(ca.get_path().c_str(), "hil");
+
+    EXPECT_FALSE(ca.parse("loopback://"));
+}
@@ -0,0 +1,190 @@
+#include "connect_handshake.h"
+#include <algorithm>
+
+namespace mavsdk {
+
+void ConnectHandshake::start(SendRequest send_request, ReadyCallback ready_callback)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _running = true;
+    _sealed = false;
+    _ready = false;
+    _pending_steps.clear();
+    _pending_requests.clear();
+    _send_request = std::move(send_request);
+    _ready_callback = std::move(ready_callback);
+}
+
+void ConnectHandshake::stop()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _running = false;
+    _ready = false;
+    _pending_steps.clear();
+    _pending_requests.clear();
+    _send_request = nullptr;
+    _ready_callback = nullptr;
+}
+
+void ConnectHandshake::add_step(const std::string& name)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (!_running || _ready) {
+        return;
+    }
+
+    if (std::find(_pending_steps.begin(), _pending_steps.end(), name) == _pending_steps.end()) {
+        _pending_steps.push_back(name);
+    }
+}
+
+void ConnectHandshake::complete_step(const std::string& name)
+{
+    ReadyCallback ready_callback;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (!_running || _ready) {
+            return;
+        }
+
+        _pending_steps.erase(
+            std::remove(_pending_steps.begin(), _pending_steps.end(), name),
+            _pending_steps.end());
+        ready_callback = take_ready_callback_if_done();
+    }
+
+    if (ready_callback) {
+        ready_callback({});
+    }
+}
+
+bool ConnectHandshake::add_request(uint32_t message_id, uint8_t component_id)
+{
+    SendRequest send_request;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (!_running || _ready) {
+            return false;
+        }
+
+        const bool already_requested = std::any_of(
+            _pending_requests.begin(), _pending_requests.end(), [&](const Request& request) {
+                return request.message_id == message_id && request.component_id == component_id;
+            });
+        if (already_requested) {
+            return false;
+        }
+
+        _pending_requests.push_back(Request{message_id, component_id});
+        send_request = _send_request;
+    }
+
+    if (send_request) {
+        send_request(message_id, component_id);
+    }
+    return true;
+}
+
+void ConnectHandshake::process_message(uint32_t message_id, uint8_t component_id)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _pending_requests.erase(
+        std::remove_if(
+            _pending_requests.begin(),
+            _pending_requests.end(),
+            [&](const Request& request) {
+                return request.message_id == message_id &&
+                       (request.component_id == 0 || request.component_id == component_id);
+            }),
+        _pending_requests.end());
+}
+
+void ConnectHandshake::resend()
+{
+    SendRequest send_request;
+    std::vector<Request> requests;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (!_running || _ready) {
+            return;
+        }
+        send_request = _send_request;
+        requests = _pending_requests;
+    }
+
+    if (!send_request) {
+        return;
+    }
+
+    for (const auto& request : requests) {
+        send_request(request.message_id, request.component_id);
+    }
+}
+
+void ConnectHandshake::seal()
+{
+    ReadyCallback ready_callback;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (!_running || _ready) {
+            return;
+        }
+
+        _sealed = true;
+        ready_callback = take_ready_callback_if_done();
+    }
+
+    if (ready_callback) {
+        ready_callback({});
+    }
+}
+
+void ConnectHandshake::expire()
+{
+    ReadyCallback ready_callback;
+    std::vector<std::string> missing_steps;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (!_running || _ready) {
+            return;
+        }
+
+        // Whatever is missing is not going to hold it up any longer.
+        _sealed = true;
+        missing_steps.swap(_pending_steps);
+        ready_callback = take_ready_callback_if_done();
+    }
+
+    if (ready_callback) {
+        ready_callback(missing_steps);
+    }
+}
+
+bool ConnectHandshake::is_running() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _running;
+}
+
+bool ConnectHandshake::is_ready() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _ready;
+}
+
+ConnectHandshake::ReadyCallback ConnectHandshake::take_ready_callback_if_done()
+{
+    if (!_sealed || !_pending_steps.empty()) {
+        return nullptr;
+    }
+
+    _ready = true;
+    // Only asked for while discovering.
+    _pending_requests.clear();
+
+    ReadyCallback ready_callback;
+    ready_callback.swap(_ready_callback);
+    return ready_callback;
+}
+
+} // namespace mavsdk
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace mavsdk {
+
+// Keeps track of what is discovered about a system once it has connected,
+// e.g. its autopilot version or which gimbal protocol it speaks, to tell when
+// the system is ready.
+//
+// The steps all run at the same time and share one deadline: the system is
+// ready once all of them are done, or once the deadline has passed, with
+// whatever is missing by then.
+//
+// Messages which are only asked for, without waiting for an ack, are
+// requested again on every resend() until they arrive or the system is
+// ready, so that they don't hold up the commands to any other component.
+class ConnectHandshake {
+public:
+    using SendRequest = std::function<void(uint32_t message_id, uint8_t component_id)>;
+    using ReadyCallback = std::function<void(const std::vector<std::string>& missing_steps)>;
+
+    ConnectHandshake() = default;
+    ~ConnectHandshake() = default;
+
+    // Non-copyable
+    ConnectHandshake(const ConnectHandshake&) = delete;
+    const ConnectHandshake& operator=(const ConnectHandshake&) = delete;
+
+    // Starts over, e.g. when the system has connected again.
+    void start(SendRequest send_request, ReadyCallback ready_callback);
+
+    // Nothing happens anymore, e.g. when the system has disconnected.
+    void stop();
+
+    // Until start(), or once the system is ready, steps are not tracked.
+    void add_step(const std::string& name);
+    void complete_step(const std::string& name);
+
+    // Requests right away, unless the message is already requested.
+    // A component ID of 0 means any component can answer.
+    // Returns false if it was already requested or nothing is running.
+    bool add_request(uint32_t message_id, uint8_t component_id);
+    void process_message(uint32_t message_id, uint8_t component_id);
+    void resend();
+
+    // All steps known at connect time are added now, so that the system can
+    // be ready once they are done. Later ones can still delay it.
+    void seal();
+
+    // The deadline has passed.
+    void expire();
+
+    bool is_running() const;
+    bool is_ready() const;
+
+private:
+    struct Request {
+        uint32_t message_id;
+        uint8_t component_id;
+    };
+
+    // Needs _mutex, returns the callback to call outside of it if ready now.
+    ReadyCallback take_ready_callback_if_done();
+
+    mutable std::mutex _mutex{};
+    bool _running{false}; // Needs _mutex
+    bool _sealed{false}; // Needs _mutex
+    bool _ready{false}; // Needs _mutex
+    std::vector<std::string> _pending_steps{}; // Needs _mutex
+    std::vector<Request> _pending_requests{}; // Needs _mutex
+    SendRequest _send_request{}; // Needs _mutex
+    ReadyCallback _ready_callback{}; // Needs _mutex
+};
+
+} // namespace mavsdk
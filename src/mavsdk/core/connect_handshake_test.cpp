@@ -0,0 +1,146 @@
+#include "connect_handshake.h"
+#include <gtest/gtest.h>
+#include <optional>
+#include <utility>
+
+using namespace mavsdk;
+
+namespace {
+
+struct Recorder {
+    std::vector<std::pair<uint32_t, uint8_t>> sent{};
+    std::optional<std::vector<std::string>> missing{};
+    unsigned ready_calls{0};
+
+    void start(ConnectHandshake& handshake)
+    {
+        handshake.start(
+            [this](uint32_t message_id, uint8_t component_id) {
+                sent.emplace_back(message_id, component_id);
+            },
+            [this](const std::vector<std::string>& missing_steps) {
+                missing = missing_steps;
+                ++ready_calls;
+            });
+    }
+};
+
+} // namespace
+
+TEST(ConnectHandshake, ReadyOnceAllStepsAreDone)
+{
+    ConnectHandshake handshake;
+    Recorder recorder;
+    recorder.start(handshake);
+
+    handshake.add_step("autopilot_version");
+    handshake.add_step("flight_information");
+    handshake.seal();
+    EXPECT_FALSE(handshake.is_ready());
+
+    // In any order.
+    handshake.complete_step("flight_information");
+    EXPECT_FALSE(handshake.is_ready());
+    handshake.complete_step("autopilot_version");
+    EXPECT_TRUE(handshake.is_ready());
+    ASSERT_TRUE(recorder.missing);
+    EXPECT_TRUE(recorder.missing->empty());
+
+    // Only once.
+    handshake.expire();
+    EXPECT_EQ(recorder.ready_calls, 1u);
+}
+
+TEST(ConnectHandshake, NotReadyBeforeSealed)
+{
+    ConnectHandshake handshake;
+    Recorder recorder;
+    recorder.start(handshake);
+
+    handshake.add_step("autopilot_version");
+    // Done before the others are even added.
+    handshake.complete_step("autopilot_version");
+    EXPECT_FALSE(handshake.is_ready());
+
+    handshake.seal();
+    EXPECT_TRUE(handshake.is_ready());
+    EXPECT_EQ(recorder.ready_calls, 1u);
+}
+
+TEST(ConnectHandshake, ReadyAtDeadlineWithMissingSteps)
+{
+    ConnectHandshake handshake;
+    Recorder recorder;
+    recorder.start(handshake);
+
+    handshake.add_step("autopilot_version");
+    handshake.add_step("gimbal_protocol");
+    handshake.seal();
+    handshake.complete_step("gimbal_protocol");
+
+    handshake.expire();
+    EXPECT_TRUE(handshake.is_ready());
+    ASSERT_TRUE(recorder.missing);
+    EXPECT_EQ(*recorder.missing, std::vector<std::string>{"autopilot_version"});
+
+    // Too late now.
+    handshake.complete_step("autopilot_version");
+    EXPECT_EQ(recorder.ready_calls, 1u);
+}
+
+TEST(ConnectHandshake, RequestsAreSentAgainUntilAnswered)
+{
+    ConnectHandshake handshake;
+    Recorder recorder;
+    recorder.start(handshake);
+
+    EXPECT_TRUE(handshake.add_request(280, 0));
+    EXPECT_TRUE(handshake.add_request(148, 1));
+    // Already requested.
+    EXPECT_FALSE(handshake.add_request(280, 0));
+    EXPECT_EQ(recorder.sent.size(), 2u);
+
+    // Any component answers a broadcast.
+    handshake.process_message(280, 154);
+    handshake.resend();
+    ASSERT_EQ(recorder.sent.size(), 3u);
+    EXPECT_EQ(recorder.sent.back(), std::make_pair(148u, uint8_t{1}));
+
+    // The wrong component does not.
+    handshake.process_message(148, 100);
+    handshake.resend();
+    EXPECT_EQ(recorder.sent.size(), 4u);
+
+    // Nothing is asked for anymore once ready.
+    handshake.seal();
+    EXPECT_TRUE(handshake.is_ready());
+    handshake.resend();
+    EXPECT_EQ(recorder.sent.size(), 4u);
+    EXPECT_FALSE(handshake.add_request(148, 1));
+}
+
+TEST(ConnectHandshake, StartsOverAndStops)
+{
+    ConnectHandshake handshake;
+    Recorder recorder;
+
+    // Not running yet, nothing is tracked.
+    handshake.add_step("autopilot_version");
+    EXPECT_FALSE(handshake.add_request(148, 1));
+    EXPECT_FALSE(handshake.is_running());
+
+    recorder.start(handshake);
+    handshake.seal();
+    EXPECT_TRUE(handshake.is_ready());
+
+    recorder.start(handshake);
+    EXPECT_FALSE(handshake.is_ready());
+    handshake.add_step("autopilot_version");
+    handshake.seal();
+
+    handshake.stop();
+    EXPECT_FALSE(handshake.is_running());
+    handshake.expire();
+    EXPECT_FALSE(handshake.is_ready());
+    EXPECT_EQ(recorder.ready_calls, 1u);
+}
@@ -1,9 +1,14 @@
 #include "connection.h"
 
+#include <chrono>
 #include <memory>
 #include <utility>
+#include "log.h"
+#include "mavlink_frame.h"
 #include "mavsdk_impl.h"
-#include "mavlink_channels.h"
+#include "receive_burst.h"
+#include "trace.h"
+#include "thread_config.h"
 
 namespace mavsdk {
 
@@ -14,9 +19,6 @@ Connection::Connection(ReceiverCallback receiver_callback, ForwardingOption forw
     _mavlink_receiver(),
     _forwarding_option(forwarding_option)
 {
-    // Insert system ID 0 in all connections for broadcast.
-    _system_ids.insert(0);
-
     if (forwarding_option == ForwardingOption::ForwardingOn) {
         _forwarding_connections_count++;
     }
@@ -29,36 +31,515 @@ Connection::~Connection()
     _receiver_callback = {};
 }
 
-bool Connection::start_mavlink_receiver()
+void Connection::start_mavlink_receiver()
 {
-    uint8_t channel;
-    if (!MavlinkChannels::Instance().checkout_free_channel(channel)) {
-        return false;
+    _mavlink_receiver = std::make_unique<MavlinkReceiver>();
+    start_dispatch_thread();
+}
+
+void Connection::stop_mavlink_receiver()
+{
+    stop_dispatch_thread();
+    _mavlink_receiver.reset();
+}
+
+void Connection::set_receive_queue(
+    size_t capacity, CallbackQueueBase::OverflowPolicy overflow_policy)
+{
+    _receive_queue_capacity = capacity;
+    _receive_queue_overflow_policy = overflow_policy;
+}
+
+CallbackQueueBase::Stats Connection::receive_queue_stats() const
+{
+    if (!_receive_queue) {
+        return {};
     }
+    return _receive_queue->stats();
+}
 
-    _mavlink_receiver = std::make_unique<MavlinkReceiver>(channel);
-    return true;
+void Connection::start_dispatch_thread()
+{
+    if (_receive_queue_capacity == 0 || _dispatch_thread) {
+        return;
+    }
+
+    _receive_queue = std::make_unique<CallbackQueue<MavlinkMessageBuffer>>(
+        _receive_queue_capacity, _receive_queue_overflow_policy);
+    _dispatch_thread = std::make_unique<std::thread>(&Connection::dispatch_thread, this);
 }
 
-void Connection::stop_mavlink_receiver()
+void Connection::stop_dispatch_thread()
 {
-    if (_mavlink_receiver) {
-        uint8_t used_channel = _mavlink_receiver->get_channel();
-        // Destroy receiver before giving the channel back.
-        _mavlink_receiver.reset();
-        MavlinkChannels::Instance().checkin_used_channel(used_channel);
+    if (!_dispatch_thread) {
+        return;
+    }
+
+    // Whatever is still queued is dropped. The queue itself is kept for its
+    // stats.
+    _receive_queue->stop();
+    _dispatch_thread->join();
+    _dispatch_thread.reset();
+}
+
+void Connection::dispatch_thread()
+{
+    ThreadConfig::apply(ThreadRole::Work);
+
+    while (auto buffer = _receive_queue->dequeue()) {
+        // Nobody else has it anymore, the receiver moved on to a new buffer.
+        handle_message(buffer->mutable_message(), *buffer, this);
     }
 }
 
 void Connection::receive_message(mavlink_message_t& message, Connection* connection)
 {
-    // Register system ID when receiving a message from a new system.
-    if (_system_ids.find(message.sysid) == _system_ids.end()) {
-        _system_ids.insert(message.sysid);
+    receive_message(message, *_mavlink_receiver, connection);
+}
+
+void Connection::receive_message(
+    mavlink_message_t& message, MavlinkReceiver& receiver, Connection* connection)
+{
+    if (emulate_incoming(message)) {
+        _emulator_parse_errors += receiver.take_parse_errors();
+        return;
+    }
+
+    dispatch_message(
+        message, receiver.get_last_message_buffer(), receiver.take_parse_errors(), connection);
+}
+
+void Connection::receive_message_buffer(MavlinkMessageBuffer& buffer)
+{
+    if (emulate_incoming(*buffer)) {
+        return;
+    }
+
+    dispatch_message(buffer.mutable_message(), buffer, 0, this);
+}
+
+int64_t Connection::receive_time_now_ns()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::system_clock::now().time_since_epoch())
+        .count();
+}
+
+void Connection::dispatch_message(
+    mavlink_message_t& message,
+    const MavlinkMessageBuffer& buffer,
+    unsigned parse_errors,
+    Connection* connection)
+{
+    _link_statistics.count_received(message, parse_errors);
+
+    if (_receive_queue && _dispatch_thread) {
+        // Shares the message, it is handled on the dispatch thread.
+        _receive_queue->enqueue(buffer);
+        return;
     }
+
+    handle_message(message, buffer, connection);
+}
+
+void Connection::handle_message(
+    mavlink_message_t& message, const MavlinkMessageBuffer& buffer, Connection* connection)
+{
+    TraceScope trace("connection", "receive", message.msgid);
+
+    // Lets handlers keep the message without copying it.
+    MavlinkMessageBuffer::DispatchScope dispatch_scope(buffer);
+
     _receiver_callback(message, connection);
 }
 
+bool Connection::send_messages(const std::vector<mavlink_message_t>& messages)
+{
+    bool successful = true;
+    for (const auto& message : messages) {
+        successful = send_message(message) && successful;
+    }
+    return successful;
+}
+
+bool Connection::schedule_message(const mavlink_message_t& message)
+{
+    if (_bandwidth_limit <= 0.0 && !_link_emulation) {
+        return send_message(message);
+    }
+
+    uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
+    const uint16_t buffer_len = mavlink_msg_to_send_buffer(buffer, &message);
+    return schedule_frames(buffer, buffer_len);
+}
+
+bool Connection::schedule_messages(const std::vector<mavlink_message_t>& messages)
+{
+    if (_bandwidth_limit <= 0.0 && !_link_emulation) {
+        return send_messages(messages);
+    }
+
+    std::vector<uint8_t> frames;
+    frames.reserve(messages.size() * MAVLINK_MAX_PACKET_LEN);
+    for (const auto& message : messages) {
+        uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
+        const uint16_t buffer_len = mavlink_msg_to_send_buffer(buffer, &message);
+        frames.insert(frames.end(), buffer, buffer + buffer_len);
+    }
+    return schedule_frames(frames.data(), frames.size());
+}
+
+bool Connection::schedule_frames(const uint8_t* data, size_t len)
+{
+    if (_bandwidth_limit <= 0.0) {
+        return transmit_frames(data, len);
+    }
+
+    std::lock_guard<std::mutex> lock(_scheduler_mutex);
+
+    if (!_scheduler) {
+        return transmit_frames(data, len);
+    }
+
+    const auto now = std::chrono::steady_clock::now();
+
+    std::vector<uint8_t> send_now;
+    bool queued = false;
+    MavlinkFrame frame;
+    size_t pos = 0;
+    while (pos < len && MavlinkFrame::parse(&data[pos], len - pos, frame)) {
+        switch (_scheduler->offer(priority_for(frame.msgid), &data[pos], frame.len, now)) {
+            case OutgoingScheduler::Decision::Send:
+                send_now.insert(send_now.end(), &data[pos], &data[pos] + frame.len);
+                break;
+            case OutgoingScheduler::Decision::Queued:
+                queued = true;
+                break;
+            case OutgoingScheduler::Decision::Dropped:
+                // Only complain once until the queues have caught up again.
+                if (!_scheduler_dropping) {
+                    _scheduler_dropping = true;
+                    LogWarn() << "Bandwidth limit exceeded, dropping messages";
+                }
+                break;
+        }
+        pos += frame.len;
+    }
+
+    if (queued) {
+        _scheduler_cv.notify_one();
+    }
+
+    // Like data that is lost later, what is queued or dropped counts as sent.
+    // We send with the lock held, so nothing overtakes what is queued.
+    if (send_now.empty()) {
+        return true;
+    }
+    return transmit_frames(send_now.data(), send_now.size());
+}
+
+bool Connection::transmit_frames(const uint8_t* data, size_t len)
+{
+    if (!_link_emulation) {
+        return send_frames(data, len);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_emulator_mutex);
+        if (!_outgoing_emulator) {
+            return send_frames(data, len);
+        }
+
+        // Frames are lost one by one, as on the link.
+        const auto now = std::chrono::steady_clock::now();
+        MavlinkFrame frame;
+        size_t pos = 0;
+        while (pos < len && MavlinkFrame::parse(&data[pos], len - pos, frame)) {
+            (void)_outgoing_emulator->offer(&data[pos], frame.len, now);
+            pos += frame.len;
+        }
+    }
+    _emulator_cv.notify_one();
+
+    // Like data that is lost later, what the emulation loses counts as sent.
+    return true;
+}
+
+void Connection::start_send_scheduler()
+{
+    start_link_emulator();
+
+    if (_bandwidth_limit <= 0.0) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_scheduler_mutex);
+        _scheduler = std::make_unique<OutgoingScheduler>(
+            _bandwidth_limit, std::chrono::steady_clock::now());
+        _scheduler_should_exit = false;
+    }
+    _scheduler_thread = std::make_unique<std::thread>(&Connection::send_scheduler_thread, this);
+}
+
+void Connection::stop_send_scheduler()
+{
+    if (_scheduler_thread) {
+        {
+            std::lock_guard<std::mutex> lock(_scheduler_mutex);
+            _scheduler_should_exit = true;
+        }
+        _scheduler_cv.notify_all();
+        _scheduler_thread->join();
+        _scheduler_thread.reset();
+
+        // Whatever is still queued is lost, as it would be on the link.
+        std::lock_guard<std::mutex> lock(_scheduler_mutex);
+        _scheduler.reset();
+    }
+
+    // After the scheduler, which sends through it.
+    stop_link_emulator();
+}
+
+void Connection::send_scheduler_thread()
+{
+    ThreadConfig::apply(ThreadRole::Send);
+
+    std::vector<uint8_t> frames;
+
+    std::unique_lock<std::mutex> lock(_scheduler_mutex);
+    while (!_scheduler_should_exit) {
+        const auto next = _scheduler->next_ready_time(std::chrono::steady_clock::now());
+        if (!next) {
+            _scheduler_cv.wait(lock);
+            continue;
+        }
+
+        if (_scheduler_cv.wait_until(lock, next.value()) == std::cv_status::no_timeout) {
+            // Something else might be due now.
+            continue;
+        }
+
+        frames.clear();
+        _scheduler->take_ready(std::chrono::steady_clock::now(), frames);
+        if (_scheduler->queued_frames() == 0) {
+            _scheduler_dropping = false;
+        }
+        if (!frames.empty()) {
+            transmit_frames(frames.data(), frames.size());
+        }
+    }
+}
+
+size_t Connection::memory_usage()
+{
+    size_t bytes = 0;
+    if (_mavlink_receiver) {
+        bytes += _mavlink_receiver->memory_usage();
+    }
+    if (_emulator_receiver) {
+        bytes += _emulator_receiver->memory_usage();
+    }
+    if (_receive_queue) {
+        bytes += _receive_queue->memory_usage();
+    }
+    {
+        std::lock_guard<std::mutex> lock(_scheduler_mutex);
+        if (_scheduler) {
+            bytes += _scheduler->queued_bytes();
+        }
+    }
+    {
+        std::lock_guard<std::mutex> lock(_emulator_mutex);
+        for (const auto* emulator : {_outgoing_emulator.get(), _incoming_emulator.get()}) {
+            if (emulator != nullptr) {
+                bytes += emulator->queued_bytes();
+            }
+        }
+    }
+    return bytes;
+}
+
+void Connection::set_link_emulation(const LinkEmulation& link_emulation)
+{
+    if (LinkEmulator::is_active(link_emulation)) {
+        _link_emulation = link_emulation;
+    } else {
+        _link_emulation.reset();
+    }
+}
+
+void Connection::start_link_emulator()
+{
+    if (!_link_emulation) {
+        return;
+    }
+
+    // The directions get different randomness, otherwise they would lose
+    // the same frames.
+    auto incoming_emulation = _link_emulation.value();
+    ++incoming_emulation.seed;
+
+    {
+        std::lock_guard<std::mutex> lock(_emulator_mutex);
+        _outgoing_emulator = std::make_unique<LinkEmulator>(_link_emulation.value());
+        _incoming_emulator = std::make_unique<LinkEmulator>(incoming_emulation);
+        _emulator_should_exit = false;
+    }
+    _emulator_receiver = std::make_unique<MavlinkReceiver>();
+    _emulator_thread = std::make_unique<std::thread>(&Connection::link_emulator_thread, this);
+}
+
+void Connection::stop_link_emulator()
+{
+    if (!_emulator_thread) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_emulator_mutex);
+        _emulator_should_exit = true;
+    }
+    _emulator_cv.notify_all();
+    _emulator_thread->join();
+    _emulator_thread.reset();
+    _emulator_receiver.reset();
+
+    // Whatever is still on the way is lost.
+    std::lock_guard<std::mutex> lock(_emulator_mutex);
+    _outgoing_emulator.reset();
+    _incoming_emulator.reset();
+}
+
+void Connection::link_emulator_thread()
+{
+    ThreadConfig::apply(ThreadRole::Send);
+
+    std::vector<std::vector<uint8_t>> outgoing;
+    std::vector<std::vector<uint8_t>> incoming;
+
+    std::unique_lock<std::mutex> lock(_emulator_mutex);
+    while (!_emulator_should_exit) {
+        auto next = _outgoing_emulator->next_due_time();
+        const auto next_incoming = _incoming_emulator->next_due_time();
+        if (!next || (next_incoming && next_incoming.value() < next.value())) {
+            next = next_incoming;
+        }
+
+        if (!next) {
+            _emulator_cv.wait(lock);
+            continue;
+        }
+
+        if (_emulator_cv.wait_until(lock, next.value()) == std::cv_status::no_timeout) {
+            // Something else might be due first now.
+            continue;
+        }
+
+        const auto now = std::chrono::steady_clock::now();
+        _outgoing_emulator->take_due(now, outgoing);
+        _incoming_emulator->take_due(now, incoming);
+
+        // Sending and handling can take a while, nothing else needs to wait
+        // for that.
+        lock.unlock();
+        for (auto& frame : outgoing) {
+            send_frames(frame.data(), frame.size());
+        }
+        {
+            ReceiveBurst::Scope receive_burst;
+            for (auto& frame : incoming) {
+                deliver_emulated(frame);
+            }
+        }
+        outgoing.clear();
+        incoming.clear();
+        lock.lock();
+    }
+}
+
+bool Connection::emulate_incoming(const mavlink_message_t& message)
+{
+    if (!_link_emulation) {
+        return false;
+    }
+
+    uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
+    const uint16_t buffer_len = mavlink_msg_to_send_buffer(buffer, &message);
+    {
+        std::lock_guard<std::mutex> lock(_emulator_mutex);
+        if (!_incoming_emulator) {
+            return false;
+        }
+        (void)_incoming_emulator->offer(buffer, buffer_len, std::chrono::steady_clock::now());
+    }
+    _emulator_cv.notify_one();
+    return true;
+}
+
+void Connection::deliver_emulated(std::vector<uint8_t>& frame)
+{
+    _emulator_receiver->set_new_datagram(
+        reinterpret_cast<char*>(frame.data()), static_cast<unsigned>(frame.size()));
+    while (_emulator_receiver->parse_message()) {
+        dispatch_message(
+            _emulator_receiver->get_last_message(),
+            _emulator_receiver->get_last_message_buffer(),
+            _emulator_parse_errors.exchange(0) + _emulator_receiver->take_parse_errors(),
+            this);
+    }
+}
+
+OutgoingScheduler::Priority Connection::priority_for(uint32_t message_id)
+{
+    switch (message_id) {
+        case MAVLINK_MSG_ID_HEARTBEAT:
+        case MAVLINK_MSG_ID_TIMESYNC:
+        case MAVLINK_MSG_ID_MANUAL_CONTROL:
+        case MAVLINK_MSG_ID_RC_CHANNELS_OVERRIDE:
+        case MAVLINK_MSG_ID_SET_POSITION_TARGET_LOCAL_NED:
+        case MAVLINK_MSG_ID_SET_POSITION_TARGET_GLOBAL_INT:
+        case MAVLINK_MSG_ID_SET_ATTITUDE_TARGET:
+        case MAVLINK_MSG_ID_SET_ACTUATOR_CONTROL_TARGET:
+            return OutgoingScheduler::Priority::Control;
+
+        case MAVLINK_MSG_ID_COMMAND_LONG:
+        case MAVLINK_MSG_ID_COMMAND_INT:
+        case MAVLINK_MSG_ID_COMMAND_ACK:
+        case MAVLINK_MSG_ID_COMMAND_CANCEL:
+        case MAVLINK_MSG_ID_SET_MODE:
+        case MAVLINK_MSG_ID_PING:
+        case MAVLINK_MSG_ID_GPS_RTCM_DATA:
+            return OutgoingScheduler::Priority::Command;
+
+        case MAVLINK_MSG_ID_FILE_TRANSFER_PROTOCOL:
+        case MAVLINK_MSG_ID_LOG_REQUEST_LIST:
+        case MAVLINK_MSG_ID_LOG_REQUEST_DATA:
+        case MAVLINK_MSG_ID_LOG_ENTRY:
+        case MAVLINK_MSG_ID_LOG_DATA:
+        case MAVLINK_MSG_ID_PARAM_REQUEST_LIST:
+        case MAVLINK_MSG_ID_PARAM_REQUEST_READ:
+        case MAVLINK_MSG_ID_PARAM_SET:
+        case MAVLINK_MSG_ID_PARAM_VALUE:
+        case MAVLINK_MSG_ID_PARAM_EXT_REQUEST_LIST:
+        case MAVLINK_MSG_ID_PARAM_EXT_REQUEST_READ:
+        case MAVLINK_MSG_ID_PARAM_EXT_SET:
+        case MAVLINK_MSG_ID_PARAM_EXT_VALUE:
+        case MAVLINK_MSG_ID_PARAM_EXT_ACK:
+        case MAVLINK_MSG_ID_MISSION_REQUEST_LIST:
+        case MAVLINK_MSG_ID_MISSION_COUNT:
+        case MAVLINK_MSG_ID_MISSION_REQUEST_INT:
+        case MAVLINK_MSG_ID_MISSION_ITEM_INT:
+        case MAVLINK_MSG_ID_MISSION_ACK:
+        case MAVLINK_MSG_ID_SERIAL_CONTROL:
+            return OutgoingScheduler::Priority::Bulk;
+
+        default:
+            return OutgoingScheduler::Priority::Telemetry;
+    }
+}
+
 bool Connection::should_forward_messages() const
 {
     return _forwarding_option == ForwardingOption::ForwardingOn;
@@ -69,9 +550,4 @@ unsigned Connection::forwarding_connections_count()
     return _forwarding_connections_count;
 }
 
-bool Connection::has_system_id(uint8_t system_id)
-{
-    return _system_ids.find(system_id) != _system_ids.end();
-}
-
 } // namespace mavsdk
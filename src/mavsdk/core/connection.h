@@ -1,12 +1,23 @@
 #pragma once
 
 #include "mavsdk.h"
+#include "callback_queue.h"
+#include "link_emulator.h"
+#include "link_statistics.h"
 #include "mavlink_receiver.h"
+#include "outgoing_scheduler.h"
+#include <condition_variable>
 #include <memory>
-#include <unordered_set>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
 
 namespace mavsdk {
 
+class IoReactor;
+class IoUringReceiver;
+
 class Connection {
 public:
     using ReceiverCallback =
@@ -22,26 +33,148 @@ public:
 
     virtual bool send_message(const mavlink_message_t& message) = 0;
 
-    bool has_system_id(uint8_t system_id);
+    // Sends the messages one by one unless the connection can do better.
+    virtual bool send_messages(const std::vector<mavlink_message_t>& messages);
+
+    // Sends already serialized frames as they are, the data must only contain
+    // complete frames.
+    virtual bool send_frames(const uint8_t* data, size_t len) = 0;
+
+    // If set before start(), what is sent is kept within this many bytes per
+    // second, by priority, see OutgoingScheduler. 0 means no limit.
+    void set_bandwidth_limit(double bytes_per_s) { _bandwidth_limit = bytes_per_s; }
+
+    // If set before start(), the link is degraded in both directions as
+    // configured, see LinkEmulator, e.g. to test transfers against a radio.
+    void set_link_emulation(const LinkEmulation& link_emulation);
+
+    // Like the send functions, but with a bandwidth limit, messages might be
+    // queued or dropped.
+    bool schedule_message(const mavlink_message_t& message);
+    bool schedule_messages(const std::vector<mavlink_message_t>& messages);
+    bool schedule_frames(const uint8_t* data, size_t len);
+
+    // If set before start(), the connection receives on the reactor's
+    // thread instead of its own, if it supports it.
+    void set_io_reactor(IoReactor* io_reactor) { _io_reactor = io_reactor; }
+
+    // If set before start(), the connection receives with io_uring on the
+    // receiver's thread, if it supports it. This takes precedence over the
+    // reactor.
+    void set_io_uring_receiver(IoUringReceiver* io_uring_receiver)
+    {
+        _io_uring_receiver = io_uring_receiver;
+    }
+
+    // If set before start(), the receive thread only parses messages and
+    // queues them for a dispatch thread of the connection which handles
+    // them, so slow handlers don't hold up receiving. If the queue is full,
+    // messages are dropped according to the policy. 0 means no queue.
+    void set_receive_queue(size_t capacity, CallbackQueueBase::OverflowPolicy overflow_policy);
+
+    // Counters of the receive queue, all 0 without one.
+    CallbackQueueBase::Stats receive_queue_stats() const;
+
+    // Identifies the connection in the routing table, set before start().
+    void set_link_index(unsigned link_index) { _link_index = link_index; }
+    unsigned link_index() const { return _link_index; }
+
+    LinkStatistics& link_statistics() { return _link_statistics; }
+
+    // Bytes of the receive buffers and of the frames waiting to be sent.
+    virtual size_t memory_usage();
+
     bool should_forward_messages() const;
     static unsigned forwarding_connections_count();
 
+    // The time to give received data if the kernel didn't stamp it, in ns
+    // since the epoch, see MavlinkReceiver::set_new_datagram().
+    static int64_t receive_time_now_ns();
+
     // Non-copyable
     Connection(const Connection&) = delete;
     const Connection& operator=(const Connection&) = delete;
 
 protected:
-    bool start_mavlink_receiver();
+    void start_mavlink_receiver();
     void stop_mavlink_receiver();
     void receive_message(mavlink_message_t& message, Connection* connection);
+    // For connections parsing on several threads, each with its own receiver.
+    void receive_message(
+        mavlink_message_t& message, MavlinkReceiver& receiver, Connection* connection);
+    // For messages which were never serialized, so handlers can keep the
+    // buffer they came in.
+    void receive_message_buffer(MavlinkMessageBuffer& buffer);
+
+    // Needs to be stopped before anything send_frames() uses is torn down.
+    // This also runs the link emulation, if any.
+    void start_send_scheduler();
+    void stop_send_scheduler();
 
     ReceiverCallback _receiver_callback{};
     std::unique_ptr<MavlinkReceiver> _mavlink_receiver;
     ForwardingOption _forwarding_option;
-    std::unordered_set<uint8_t> _system_ids;
+    IoReactor* _io_reactor{nullptr};
+    IoUringReceiver* _io_uring_receiver{nullptr};
+    unsigned _link_index{0};
+    LinkStatistics _link_statistics{};
 
     static std::atomic<unsigned> _forwarding_connections_count;
 
+private:
+    void send_scheduler_thread();
+    static OutgoingScheduler::Priority priority_for(uint32_t message_id);
+
+    // What is left to send after the bandwidth limit, through the link
+    // emulation if there is one.
+    bool transmit_frames(const uint8_t* data, size_t len);
+
+    void dispatch_message(
+        mavlink_message_t& message,
+        const MavlinkMessageBuffer& buffer,
+        unsigned parse_errors,
+        Connection* connection);
+    void handle_message(
+        mavlink_message_t& message, const MavlinkMessageBuffer& buffer, Connection* connection);
+
+    void start_dispatch_thread();
+    void stop_dispatch_thread();
+    void dispatch_thread();
+
+    void start_link_emulator();
+    void stop_link_emulator();
+    void link_emulator_thread();
+    // Returns true if the message was taken by the link emulation.
+    bool emulate_incoming(const mavlink_message_t& message);
+    void deliver_emulated(std::vector<uint8_t>& frame);
+
+    double _bandwidth_limit{0.0};
+    std::mutex _scheduler_mutex{};
+    std::condition_variable _scheduler_cv{};
+    std::unique_ptr<OutgoingScheduler> _scheduler{}; // Needs _scheduler_mutex
+    bool _scheduler_should_exit{false}; // Needs _scheduler_mutex
+    bool _scheduler_dropping{false}; // Needs _scheduler_mutex
+    std::unique_ptr<std::thread> _scheduler_thread{};
+
+    std::optional<LinkEmulation> _link_emulation{};
+    std::mutex _emulator_mutex{};
+    std::condition_variable _emulator_cv{};
+    std::unique_ptr<LinkEmulator> _outgoing_emulator{}; // Needs _emulator_mutex
+    std::unique_ptr<LinkEmulator> _incoming_emulator{}; // Needs _emulator_mutex
+    bool _emulator_should_exit{false}; // Needs _emulator_mutex
+    // Parses what the incoming emulation delivers, on its thread.
+    std::unique_ptr<MavlinkReceiver> _emulator_receiver{};
+    std::atomic<unsigned> _emulator_parse_errors{0};
+    std::unique_ptr<std::thread> _emulator_thread{};
+
+    size_t _receive_queue_capacity{0};
+    CallbackQueueBase::OverflowPolicy _receive_queue_overflow_policy{
+        CallbackQueueBase::OverflowPolicy::DropNewest};
+    // Only replaced in start_mavlink_receiver(), before the receive threads
+    // are started.
+    std::unique_ptr<CallbackQueue<MavlinkMessageBuffer>> _receive_queue{};
+    std::unique_ptr<std::thread> _dispatch_thread{};
+
     // void received_mavlink_message(mavlink_message_t &);
 };
 
@@ -45,9 +45,29 @@
 
 #include "crc32.h"
 
+#include <atomic>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define MAVSDK_CRC32_X86
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define MAVSDK_CRC32_TARGET
+#else
+#include <cpuid.h>
+#define MAVSDK_CRC32_TARGET __attribute__((target("pclmul,sse4.1")))
+#endif
+#elif defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+// Only if the compiler may use the CRC32 instructions, e.g. with
+// -march=armv8-a+crc, which is always the case on Apple silicon.
+#define MAVSDK_CRC32_ARM
+#include <arm_acle.h>
+#endif
+
 namespace mavsdk {
 
-static const uint32_t crc32_tab[] = {
+static constexpr uint32_t crc32_tab[] = {
     0x00000000, 0x77073096, 0xee0e612c, 0x990951ba, 0x076dc419, 0x706af48f, 0xe963a535, 0x9e6495a3,
     0x0edb8832, 0x79dcb8a4, 0xe0d5e91e, 0x97d2d988, 0x09b64c2b, 0x7eb17cbd, 0xe7b82d07, 0x90bf1d91,
     0x1db71064, 0x6ab020f2, 0xf3b97148, 0x84be41de, 0x1adad47d, 0x6ddde4eb, 0xf4d4b551, 0x83d385c7,
@@ -81,12 +101,224 @@ static const uint32_t crc32_tab[] = {
     0xbdbdf21c, 0xcabac28a, 0x53b39330, 0x24b4a3a6, 0xbad03605, 0xcdd70693, 0x54de5729, 0x23d967bf,
     0xb3667a2e, 0xc4614ab8, 0x5d681b02, 0x2a6f2b94, 0xb40bbe37, 0xc30c8ea1, 0x5a05df1b, 0x2d02ef8d};
 
-uint32_t Crc32::add(const uint8_t* src, uint32_t len)
+namespace {
+
+// For slicing-by-8, tab[k][i] is the CRC of byte i followed by k zero
+// bytes, so that 8 bytes can be looked up independently and combined.
+struct SliceTables {
+    uint32_t tab[8][256];
+};
+
+constexpr SliceTables make_slice_tables()
+{
+    SliceTables tables{};
+    for (unsigned i = 0; i < 256; ++i) {
+        tables.tab[0][i] = crc32_tab[i];
+    }
+    for (unsigned k = 1; k < 8; ++k) {
+        for (unsigned i = 0; i < 256; ++i) {
+            const uint32_t previous = tables.tab[k - 1][i];
+            tables.tab[k][i] = crc32_tab[previous & 0xff] ^ (previous >> 8);
+        }
+    }
+    return tables;
+}
+
+constexpr SliceTables slice_tables = make_slice_tables();
+
+using UpdateFunction = uint32_t (*)(uint32_t crc, const uint8_t* src, uint32_t len);
+
+uint32_t update_bytewise(uint32_t crc, const uint8_t* src, uint32_t len)
 {
     for (uint32_t i = 0; i < len; i++) {
-        val = crc32_tab[(val ^ src[i]) & 0xff] ^ (val >> 8);
+        crc = crc32_tab[(crc ^ src[i]) & 0xff] ^ (crc >> 8);
+    }
+    return crc;
+}
+
+uint32_t update_portable(uint32_t crc, const uint8_t* src, uint32_t len)
+{
+    const auto& tab = slice_tables.tab;
+    while (len >= 8) {
+        // Assembled byte by byte so that it doesn't depend on endianness,
+        // compilers turn this into plain loads anyway.
+        const uint32_t one = crc ^ (static_cast<uint32_t>(src[0]) |
+                                    static_cast<uint32_t>(src[1]) << 8 |
+                                    static_cast<uint32_t>(src[2]) << 16 |
+                                    static_cast<uint32_t>(src[3]) << 24);
+        const uint32_t two = static_cast<uint32_t>(src[4]) | static_cast<uint32_t>(src[5]) << 8 |
+                             static_cast<uint32_t>(src[6]) << 16 |
+                             static_cast<uint32_t>(src[7]) << 24;
+        crc = tab[7][one & 0xff] ^ tab[6][(one >> 8) & 0xff] ^ tab[5][(one >> 16) & 0xff] ^
+              tab[4][one >> 24] ^ tab[3][two & 0xff] ^ tab[2][(two >> 8) & 0xff] ^
+              tab[1][(two >> 16) & 0xff] ^ tab[0][two >> 24];
+        src += 8;
+        len -= 8;
+    }
+    return update_bytewise(crc, src, len);
+}
+
+#if defined(MAVSDK_CRC32_X86)
+MAVSDK_CRC32_TARGET
+inline __m128i load(const uint8_t* src)
+{
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+}
+
+MAVSDK_CRC32_TARGET
+inline __m128i fold(__m128i value, __m128i constants, __m128i next)
+{
+    const __m128i low = _mm_clmulepi64_si128(value, constants, 0x00);
+    const __m128i high = _mm_clmulepi64_si128(value, constants, 0x11);
+    return _mm_xor_si128(_mm_xor_si128(low, high), next);
+}
+
+// Folds 16 byte blocks with carry-less multiplications and reduces the rest
+// with Barrett reduction, as described in Intel's "Fast CRC Computation for
+// Generic Polynomials Using PCLMULQDQ Instruction". The constants are the
+// ones for the bit-reflected 0x04C11DB7, as also used by Linux.
+MAVSDK_CRC32_TARGET
+uint32_t fold_x86(uint32_t crc, const uint8_t* src, uint32_t len)
+{
+    const __m128i k1k2 = _mm_set_epi64x(0x1c6e41596, 0x154442bd4);
+    const __m128i k3k4 = _mm_set_epi64x(0x0ccaa009e, 0x1751997d0);
+    const __m128i k5 = _mm_set_epi64x(0, 0x163cd6124);
+    const __m128i poly_mu = _mm_set_epi64x(0x1f7011641, 0x1db710641);
+    const __m128i mask32 = _mm_set_epi32(0, 0, 0, -1);
+
+    __m128i x1 = _mm_xor_si128(load(src), _mm_cvtsi32_si128(static_cast<int>(crc)));
+    __m128i x2 = load(src + 16);
+    __m128i x3 = load(src + 32);
+    __m128i x4 = load(src + 48);
+    src += 64;
+    len -= 64;
+
+    // Four blocks at a time, so that the multiplications can overlap.
+    while (len >= 64) {
+        x1 = fold(x1, k1k2, load(src));
+        x2 = fold(x2, k1k2, load(src + 16));
+        x3 = fold(x3, k1k2, load(src + 32));
+        x4 = fold(x4, k1k2, load(src + 48));
+        src += 64;
+        len -= 64;
+    }
+
+    x1 = fold(x1, k3k4, x2);
+    x1 = fold(x1, k3k4, x3);
+    x1 = fold(x1, k3k4, x4);
+
+    while (len >= 16) {
+        x1 = fold(x1, k3k4, load(src));
+        src += 16;
+        len -= 16;
+    }
+
+    // Down to 64 bits, which also appends 32 zero bits.
+    x1 = _mm_xor_si128(_mm_clmulepi64_si128(k3k4, x1, 0x01), _mm_srli_si128(x1, 8));
+
+    // Down to 32 bits.
+    x2 = _mm_srli_si128(x1, 4);
+    x1 = _mm_clmulepi64_si128(_mm_and_si128(x1, mask32), k5, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+
+    // Barrett reduction.
+    x2 = x1;
+    x1 = _mm_clmulepi64_si128(_mm_and_si128(x1, mask32), poly_mu, 0x10);
+    x1 = _mm_clmulepi64_si128(_mm_and_si128(x1, mask32), poly_mu, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+    return static_cast<uint32_t>(_mm_extract_epi32(x1, 1));
+}
+
+uint32_t update_x86(uint32_t crc, const uint8_t* src, uint32_t len)
+{
+    if (len >= 64) {
+        const uint32_t folded_len = len & ~uint32_t{15};
+        crc = fold_x86(crc, src, folded_len);
+        src += folded_len;
+        len -= folded_len;
+    }
+    return update_portable(crc, src, len);
+}
+
+bool cpu_supports_pclmul()
+{
+    // PCLMULQDQ is in CPUID leaf 1, ECX bit 1, SSE4.1 in ECX bit 19.
+#if defined(_MSC_VER)
+    int regs[4];
+    __cpuid(regs, 1);
+    const unsigned ecx = static_cast<unsigned>(regs[2]);
+#else
+    unsigned eax, ebx, ecx, edx;
+    if (__get_cpuid(1, &eax, &ebx, &ecx, &edx) == 0) {
+        return false;
+    }
+#endif
+    return (ecx & (1u << 1)) != 0 && (ecx & (1u << 19)) != 0;
+}
+
+UpdateFunction hardware_update_function()
+{
+    return cpu_supports_pclmul() ? update_x86 : nullptr;
+}
+
+#elif defined(MAVSDK_CRC32_ARM)
+// The instructions use the same polynomial, without the inversions, which is
+// exactly what MAVLink wants.
+uint32_t update_arm(uint32_t crc, const uint8_t* src, uint32_t len)
+{
+    while (len >= 8) {
+        uint64_t word;
+        memcpy(&word, src, sizeof(word));
+        crc = __crc32d(crc, word);
+        src += 8;
+        len -= 8;
+    }
+    for (; len > 0; --len, ++src) {
+        crc = __crc32b(crc, *src);
+    }
+    return crc;
+}
+
+UpdateFunction hardware_update_function()
+{
+    return update_arm;
+}
+
+#else
+UpdateFunction hardware_update_function()
+{
+    return nullptr;
+}
+#endif
+
+// Detected once, the hardware can still be turned off for testing.
+const UpdateFunction hardware_update = hardware_update_function();
+std::atomic<bool> hardware_enabled{true};
+
+UpdateFunction update_function()
+{
+    if (hardware_update != nullptr && hardware_enabled.load(std::memory_order_relaxed)) {
+        return hardware_update;
     }
+    return update_portable;
+}
+
+} // namespace
+
+uint32_t Crc32::add(const uint8_t* src, uint32_t len)
+{
+    val = update_function()(val, src, len);
     return val;
 }
 
-} // namespace mavsdk
\ No newline at end of file
+bool Crc32::uses_hardware()
+{
+    return update_function() != update_portable;
+}
+
+void Crc32::set_hardware_enabled(bool enabled)
+{
+    hardware_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+} // namespace mavsdk
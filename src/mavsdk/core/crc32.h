@@ -6,6 +6,10 @@ namespace mavsdk {
 
 // For more information about the CRC algorithm used, check the comment in the
 // source file.
+//
+// Blocks are folded with PCLMULQDQ on x86 CPUs, or use the ARMv8 CRC32
+// instructions, if available. Otherwise 8 bytes at a time are looked up in
+// tables (slicing-by-8).
 
 class Crc32 {
 public:
@@ -13,6 +17,11 @@ public:
 
     [[nodiscard]] uint32_t get() const { return val; }
 
+    // For testing and benchmarking, to make sure the hardware and portable
+    // implementations are equal.
+    static bool uses_hardware();
+    static void set_hardware_enabled(bool enabled);
+
 private:
     uint32_t val{0};
 };
@@ -0,0 +1,22 @@
+#include "crc32.h"
+#include <benchmark/benchmark.h>
+#include <vector>
+
+using namespace mavsdk;
+
+// The buffer size used to checksum files for MAVLink FTP.
+static void BM_Crc32FileBuffer(benchmark::State& state)
+{
+    Crc32::set_hardware_enabled(state.range(0) != 0);
+    std::vector<uint8_t> data(256 * 1024, 0x42);
+
+    for (auto _ : state) {
+        Crc32 crc32;
+        benchmark::DoNotOptimize(crc32.add(data.data(), static_cast<uint32_t>(data.size())));
+    }
+
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(data.size()));
+    state.SetLabel(Crc32::uses_hardware() ? "hardware" : "portable");
+    Crc32::set_hardware_enabled(true);
+}
+BENCHMARK(BM_Crc32FileBuffer)->Arg(0)->Arg(1);
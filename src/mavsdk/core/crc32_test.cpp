@@ -0,0 +1,81 @@
+#include "crc32.h"
+
+#include <random>
+#include <vector>
+#include <gtest/gtest.h>
+
+using namespace mavsdk;
+
+namespace {
+
+// Bit by bit, straight from the definition.
+uint32_t reference_crc32(const uint8_t* src, std::size_t len, uint32_t crc = 0)
+{
+    for (std::size_t i = 0; i < len; ++i) {
+        crc ^= src[i];
+        for (unsigned bit = 0; bit < 8; ++bit) {
+            crc = (crc >> 1) ^ ((crc & 1) ? 0xedb88320 : 0);
+        }
+    }
+    return crc;
+}
+
+std::vector<uint8_t> random_bytes(std::size_t len)
+{
+    std::mt19937 generator{42};
+    std::uniform_int_distribution<unsigned> distribution{0, 255};
+    std::vector<uint8_t> data(len);
+    for (auto& byte : data) {
+        byte = static_cast<uint8_t>(distribution(generator));
+    }
+    return data;
+}
+
+} // namespace
+
+TEST(Crc32, KnownValue)
+{
+    const std::string check{"123456789"};
+    Crc32 crc;
+    crc.add(reinterpret_cast<const uint8_t*>(check.data()), static_cast<uint32_t>(check.size()));
+    // Like CRC-32 but starting at 0 and without the final XOR.
+    EXPECT_EQ(crc.get(), 0x2dfd2d88);
+}
+
+TEST(Crc32, MatchesReferenceForAllLengthsAndAlignments)
+{
+    // Covers the tails as well as the 16 and 64 byte blocks of the fast paths.
+    const auto data = random_bytes(600);
+    for (const bool hardware : {false, true}) {
+        Crc32::set_hardware_enabled(hardware);
+        for (std::size_t offset = 0; offset < 16; ++offset) {
+            for (std::size_t len = 0; offset + len <= data.size(); len += (len < 160 ? 1 : 37)) {
+                Crc32 crc;
+                crc.add(data.data() + offset, static_cast<uint32_t>(len));
+                ASSERT_EQ(crc.get(), reference_crc32(data.data() + offset, len))
+                    << "offset " << offset << ", len " << len << ", hardware "
+                    << Crc32::uses_hardware();
+            }
+        }
+    }
+    Crc32::set_hardware_enabled(true);
+}
+
+TEST(Crc32, AddsUpInChunks)
+{
+    const auto data = random_bytes(1 << 20);
+    const auto expected = reference_crc32(data.data(), data.size());
+
+    for (const bool hardware : {false, true}) {
+        Crc32::set_hardware_enabled(hardware);
+        for (const std::size_t chunk_size : {1, 7, 64, 100, 4096, 18392}) {
+            Crc32 crc;
+            for (std::size_t offset = 0; offset < data.size(); offset += chunk_size) {
+                const auto len = std::min(chunk_size, data.size() - offset);
+                crc.add(data.data() + offset, static_cast<uint32_t>(len));
+            }
+            EXPECT_EQ(crc.get(), expected) << "chunk size " << chunk_size;
+        }
+    }
+    Crc32::set_hardware_enabled(true);
+}
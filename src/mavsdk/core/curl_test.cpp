@@ -1,4 +1,5 @@
 #include "curl_wrapper.h"
+#include <filesystem>
 #include <fstream>
 #include <iostream>
 #include <chrono>
@@ -132,3 +133,68 @@ TEST_F(CurlTest, Curl_DownloadFile_ProgressFeedback_COULDNT_RESOLVE_HOST)
     bool file_exists = check_file_exists(_local_path);
     EXPECT_EQ(file_exists, false);
 }
+
+TEST_F(CurlTest, Curl_DownloadToCallback_GetsAllChunks)
+{
+    // Big enough to arrive in several chunks.
+    const std::string expected_content(200000, 'x');
+    {
+        std::ofstream file(_local_path, std::ios::binary);
+        file << expected_content;
+    }
+    const auto url = "file://" + std::filesystem::absolute(_local_path).string();
+
+    std::string content;
+    unsigned chunks = 0;
+    auto chunk_callback = [&content, &chunks](const char* data, size_t size) {
+        content.append(data, size);
+        ++chunks;
+        return true;
+    };
+
+    int last_progress = 0;
+    Status last_status = Status::Idle;
+    auto progress = [&last_progress, &last_status](int got_progress, Status status, CURLcode) {
+        EXPECT_GE(got_progress, last_progress);
+        last_progress = got_progress;
+        last_status = status;
+        return 0;
+    };
+
+    CurlWrapper curl_wrapper;
+    bool success = curl_wrapper.download_to_callback(url, chunk_callback, progress);
+
+    EXPECT_EQ(success, true);
+    EXPECT_EQ(content, expected_content);
+    EXPECT_GT(chunks, 1u);
+    EXPECT_EQ(last_progress, 100);
+    EXPECT_EQ(last_status, Status::Finished);
+}
+
+TEST_F(CurlTest, Curl_DownloadToCallback_AbortedByCallback)
+{
+    {
+        std::ofstream file(_local_path, std::ios::binary);
+        file << std::string(200000, 'x');
+    }
+    const auto url = "file://" + std::filesystem::absolute(_local_path).string();
+
+    unsigned chunks = 0;
+    auto chunk_callback = [&chunks](const char*, size_t) {
+        ++chunks;
+        return false;
+    };
+
+    CURLcode last_curl_code = CURLcode::CURLE_OK;
+    auto progress = [&last_curl_code](int, Status, CURLcode curl_code) {
+        last_curl_code = curl_code;
+        return 0;
+    };
+
+    CurlWrapper curl_wrapper;
+    bool success = curl_wrapper.download_to_callback(url, chunk_callback, progress);
+
+    EXPECT_EQ(success, false);
+    EXPECT_EQ(chunks, 1u);
+    EXPECT_EQ(last_curl_code, CURLcode::CURLE_WRITE_ERROR);
+}
@@ -1,13 +1,126 @@
 #include "log.h"
 #include "curl_wrapper.h"
 #include "unused.h"
+#include <algorithm>
+#include <array>
+#include <cctype>
 #include <iostream>
 #include <cstdio>
 #include <fstream>
+#include <mutex>
 #include <string>
+#include <utility>
+#include <vector>
 
 namespace mavsdk {
 
+namespace {
+
+// Keeps easy handles around once a transfer is done, and shares connections,
+// DNS lookups and TLS sessions between all of them, so that transfers to the
+// same server, also from different threads, reuse a kept-alive connection
+// instead of setting up a new one each time.
+class CurlHandlePool {
+public:
+    static CurlHandlePool& instance()
+    {
+        // Never destroyed, so it can't go away at exit while a transfer
+        // still runs.
+        static auto* pool = new CurlHandlePool();
+        return *pool;
+    }
+
+    std::shared_ptr<CURL> acquire()
+    {
+        CURL* curl = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(_free_mutex);
+            if (!_free_handles.empty()) {
+                curl = _free_handles.back();
+                _free_handles.pop_back();
+            }
+        }
+        if (curl == nullptr) {
+            curl = curl_easy_init();
+            if (curl == nullptr) {
+                return nullptr;
+            }
+        }
+
+        if (_share != nullptr) {
+            curl_easy_setopt(curl, CURLOPT_SHARE, _share);
+        }
+        // Servers which can do HTTP/2 get fewer connections.
+        curl_easy_setopt(curl, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2TLS);
+        curl_easy_setopt(curl, CURLOPT_TCP_KEEPALIVE, 1L);
+
+        return std::shared_ptr<CURL>(curl, [this](CURL* handle) { release(handle); });
+    }
+
+    // Non-copyable
+    CurlHandlePool(const CurlHandlePool&) = delete;
+    const CurlHandlePool& operator=(const CurlHandlePool&) = delete;
+
+private:
+    CurlHandlePool()
+    {
+        _share = curl_share_init();
+        if (_share == nullptr) {
+            LogWarn() << "Could not share curl connections";
+            return;
+        }
+        curl_share_setopt(_share, CURLSHOPT_LOCKFUNC, lock_data);
+        curl_share_setopt(_share, CURLSHOPT_UNLOCKFUNC, unlock_data);
+        curl_share_setopt(_share, CURLSHOPT_USERDATA, this);
+        curl_share_setopt(_share, CURLSHOPT_SHARE, CURL_LOCK_DATA_CONNECT);
+        curl_share_setopt(_share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+        curl_share_setopt(_share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+    }
+
+    ~CurlHandlePool() = default;
+
+    void release(CURL* curl)
+    {
+        // Options are not carried over to the next transfer, the connections
+        // are kept in the share.
+        curl_easy_reset(curl);
+
+        {
+            std::lock_guard<std::mutex> lock(_free_mutex);
+            if (_free_handles.size() < MAX_FREE_HANDLES) {
+                _free_handles.push_back(curl);
+                return;
+            }
+        }
+        curl_easy_cleanup(curl);
+    }
+
+    static void lock_data(CURL* curl, curl_lock_data data, curl_lock_access access, void* userptr)
+    {
+        UNUSED(curl);
+        UNUSED(access);
+        auto* self = reinterpret_cast<CurlHandlePool*>(userptr);
+        self->_share_mutexes[static_cast<size_t>(data) % self->_share_mutexes.size()].lock();
+    }
+
+    static void unlock_data(CURL* curl, curl_lock_data data, void* userptr)
+    {
+        UNUSED(curl);
+        auto* self = reinterpret_cast<CurlHandlePool*>(userptr);
+        self->_share_mutexes[static_cast<size_t>(data) % self->_share_mutexes.size()].unlock();
+    }
+
+    static constexpr size_t MAX_FREE_HANDLES = 16;
+
+    CURLSH* _share{nullptr};
+    std::array<std::mutex, CURL_LOCK_DATA_LAST> _share_mutexes{};
+
+    std::mutex _free_mutex{};
+    std::vector<CURL*> _free_handles{}; // Needs _free_mutex
+};
+
+} // namespace
+
 // converts curl output to string
 // taken from
 // https://stackoverflow.com/questions/9786150/save-curl-content-result-into-a-string-in-c
@@ -19,7 +132,7 @@ static size_t write_callback(void* contents, size_t size, size_t nmemb, void* us
 
 bool CurlWrapper::download_text(const std::string& url, std::string& content)
 {
-    auto curl = std::shared_ptr<CURL>(curl_easy_init(), curl_easy_cleanup);
+    auto curl = CurlHandlePool::instance().acquire();
     std::string readBuffer;
 
     if (nullptr != curl) {
@@ -45,6 +158,85 @@ bool CurlWrapper::download_text(const std::string& url, std::string& content)
     }
 }
 
+// Picks the validators out of the response headers, one line at a time.
+static size_t validators_header_callback(char* buffer, size_t size, size_t nitems, void* userp)
+{
+    const std::string line(buffer, size * nitems);
+    const auto colon = line.find(':');
+    if (colon != std::string::npos) {
+        std::string name = line.substr(0, colon);
+        std::transform(name.begin(), name.end(), name.begin(), [](unsigned char c) {
+            return static_cast<char>(std::tolower(c));
+        });
+
+        const auto value_begin = line.find_first_not_of(" \t", colon + 1);
+        const auto value_end = line.find_last_not_of(" \t\r\n");
+        const std::string value = (value_begin == std::string::npos || value_end < value_begin) ?
+                                      std::string{} :
+                                      line.substr(value_begin, value_end - value_begin + 1);
+
+        auto* validators = reinterpret_cast<HttpValidators*>(userp);
+        if (name == "etag") {
+            validators->etag = value;
+        } else if (name == "last-modified") {
+            validators->last_modified = value;
+        }
+    }
+    return size * nitems;
+}
+
+ConditionalDownloadResult CurlWrapper::download_text_if_modified(
+    const std::string& url, HttpValidators& validators, std::string& content)
+{
+    auto curl = CurlHandlePool::instance().acquire();
+    if (nullptr == curl) {
+        LogErr() << "Error: cannot start downloading because of curl initialization error.";
+        return ConditionalDownloadResult::Failed;
+    }
+
+    curl_slist* headers = nullptr;
+    if (!validators.etag.empty()) {
+        headers = curl_slist_append(headers, ("If-None-Match: " + validators.etag).c_str());
+    }
+    if (!validators.last_modified.empty()) {
+        headers = curl_slist_append(
+            headers, ("If-Modified-Since: " + validators.last_modified).c_str());
+    }
+    const auto header_list = std::shared_ptr<curl_slist>(headers, curl_slist_free_all);
+
+    std::string read_buffer;
+    HttpValidators received_validators;
+
+    curl_easy_setopt(curl.get(), CURLOPT_CONNECTTIMEOUT, 5L);
+    curl_easy_setopt(curl.get(), CURLOPT_URL, url.c_str());
+    curl_easy_setopt(curl.get(), CURLOPT_HTTPHEADER, header_list.get());
+    curl_easy_setopt(curl.get(), CURLOPT_WRITEFUNCTION, write_callback);
+    curl_easy_setopt(curl.get(), CURLOPT_WRITEDATA, &read_buffer);
+    curl_easy_setopt(curl.get(), CURLOPT_HEADERFUNCTION, validators_header_callback);
+    curl_easy_setopt(curl.get(), CURLOPT_HEADERDATA, &received_validators);
+    const CURLcode res = curl_easy_perform(curl.get());
+
+    if (res != CURLcode::CURLE_OK) {
+        LogErr() << "Error while downloading text, curl error code: " << curl_easy_strerror(res);
+        return ConditionalDownloadResult::Failed;
+    }
+
+    long response_code = 0;
+    curl_easy_getinfo(curl.get(), CURLINFO_RESPONSE_CODE, &response_code);
+    if (response_code == 304) {
+        return ConditionalDownloadResult::NotModified;
+    }
+    // Other schemes, like file://, have no response code.
+    if (response_code >= 400) {
+        LogErr() << "Error while downloading text, HTTP response code: " << response_code;
+        return ConditionalDownloadResult::Failed;
+    }
+
+    content = std::move(read_buffer);
+    validators = received_validators;
+    return ConditionalDownloadResult::Downloaded;
+}
+
 static int
 upload_progress_update(void* p, double dltotal, double dlnow, double ultotal, double ulnow)
 {
@@ -92,7 +284,7 @@ template<typename T> std::string to_string(T value)
 bool CurlWrapper::upload_file(
     const std::string& url, const std::string& path, const ProgressCallback& progress_callback)
 {
-    auto curl = std::shared_ptr<CURL>(curl_easy_init(), curl_easy_cleanup);
+    auto curl = CurlHandlePool::instance().acquire();
     CURLcode res;
 
     if (nullptr != curl) {
@@ -178,7 +370,7 @@ download_progress_update(void* p, double dltotal, double dlnow, double ultotal,
 bool CurlWrapper::download_file_to_path(
     const std::string& url, const std::string& path, const ProgressCallback& progress_callback)
 {
-    auto curl = std::shared_ptr<CURL>(curl_easy_init(), curl_easy_cleanup);
+    auto curl = CurlHandlePool::instance().acquire();
     FILE* fp;
 
     if (nullptr != curl) {
@@ -217,4 +409,151 @@ bool CurlWrapper::download_file_to_path(
     }
 }
 
+namespace {
+
+// curl reports progress very often, so the callback is only called once the
+// percentage went up. Each transfer has its own, so nothing needs a lock.
+struct TransferProgress {
+    Status status{Status::Downloading};
+    int progress_in_percentage{0};
+    ProgressCallback progress_callback{nullptr};
+};
+
+int transfer_progress_update(
+    void* p, curl_off_t dltotal, curl_off_t dlnow, curl_off_t ultotal, curl_off_t ulnow)
+{
+    auto* progress = reinterpret_cast<TransferProgress*>(p);
+
+    const bool uploading = progress->status == Status::Uploading;
+    const curl_off_t total = uploading ? ultotal : dltotal;
+    const curl_off_t now = uploading ? ulnow : dlnow;
+    if (total <= 0) {
+        return 0;
+    }
+
+    const int percentage = static_cast<int>(now * 100 / total);
+    if (percentage <= progress->progress_in_percentage) {
+        return 0;
+    }
+    progress->progress_in_percentage = percentage;
+    return progress->progress_callback(percentage, progress->status, CURLcode::CURLE_OK);
+}
+
+void set_transfer_progress(CURL* curl, TransferProgress& progress)
+{
+    if (progress.progress_callback == nullptr) {
+        return;
+    }
+    curl_easy_setopt(curl, CURLOPT_XFERINFOFUNCTION, transfer_progress_update);
+    curl_easy_setopt(curl, CURLOPT_XFERINFODATA, &progress);
+    curl_easy_setopt(curl, CURLOPT_NOPROGRESS, 0L);
+}
+
+size_t chunk_write_callback(char* data, size_t size, size_t nmemb, void* userp)
+{
+    const auto& chunk_callback = *reinterpret_cast<const ChunkCallback*>(userp);
+    // Anything but the full size makes curl abort the transfer.
+    return chunk_callback(data, size * nmemb) ? size * nmemb : 0;
+}
+
+size_t read_callback_adapter(char* buffer, size_t size, size_t nitems, void* userp)
+{
+    const auto& read_callback = *reinterpret_cast<const ReadCallback*>(userp);
+    return read_callback(buffer, size * nitems);
+}
+
+} // namespace
+
+bool CurlWrapper::download_to_callback(
+    const std::string& url,
+    const ChunkCallback& chunk_callback,
+    const ProgressCallback& progress_callback)
+{
+    auto curl = CurlHandlePool::instance().acquire();
+    if (nullptr == curl) {
+        LogErr() << "Error: cannot start downloading because of curl initialization error.";
+        return false;
+    }
+
+    TransferProgress progress;
+    progress.status = Status::Downloading;
+    progress.progress_callback = progress_callback;
+
+    curl_easy_setopt(curl.get(), CURLOPT_CONNECTTIMEOUT, 5L);
+    curl_easy_setopt(curl.get(), CURLOPT_URL, url.c_str());
+    // Error pages are not handed over as content.
+    curl_easy_setopt(curl.get(), CURLOPT_FAILONERROR, 1L);
+    curl_easy_setopt(curl.get(), CURLOPT_WRITEFUNCTION, chunk_write_callback);
+    curl_easy_setopt(curl.get(), CURLOPT_WRITEDATA, &chunk_callback);
+    set_transfer_progress(curl.get(), progress);
+    const CURLcode res = curl_easy_perform(curl.get());
+
+    if (res != CURLcode::CURLE_OK) {
+        if (nullptr != progress_callback) {
+            progress_callback(0, Status::Error, res);
+        }
+        LogErr() << "Error while downloading, curl error code: " << curl_easy_strerror(res);
+        return false;
+    }
+
+    if (nullptr != progress_callback) {
+        progress_callback(100, Status::Finished, res);
+    }
+    return true;
+}
+
+bool CurlWrapper::upload_from_callback(
+    const std::string& url,
+    const std::string& filename,
+    size_t size,
+    const ReadCallback& read_callback,
+    const ProgressCallback& progress_callback)
+{
+    auto curl = CurlHandlePool::instance().acquire();
+    if (nullptr == curl) {
+        LogErr() << "Error: cannot start uploading because of curl initialization error.";
+        return false;
+    }
+
+    TransferProgress progress;
+    progress.status = Status::Uploading;
+    progress.progress_callback = progress_callback;
+
+    // The same headers as upload_file, see there.
+    curl_slist* headers = nullptr;
+    headers = curl_slist_append(headers, "Expect:");
+    headers = curl_slist_append(headers, "Content-Encoding: ");
+    headers = curl_slist_append(headers, ("File-Size: " + std::to_string(size)).c_str());
+    const auto header_list = std::shared_ptr<curl_slist>(headers, curl_slist_free_all);
+
+    // curl reads the part when sending it, so only one buffer is ever in memory.
+    const auto mime = std::shared_ptr<curl_mime>(curl_mime_init(curl.get()), curl_mime_free);
+    curl_mimepart* part = curl_mime_addpart(mime.get());
+    curl_mime_name(part, "file");
+    curl_mime_filename(part, filename.c_str());
+    ReadCallback reader = read_callback;
+    curl_mime_data_cb(
+        part, static_cast<curl_off_t>(size), read_callback_adapter, nullptr, nullptr, &reader);
+
+    curl_easy_setopt(curl.get(), CURLOPT_CONNECTTIMEOUT, 5L);
+    curl_easy_setopt(curl.get(), CURLOPT_URL, url.c_str());
+    curl_easy_setopt(curl.get(), CURLOPT_HTTPHEADER, header_list.get());
+    curl_easy_setopt(curl.get(), CURLOPT_MIMEPOST, mime.get());
+    set_transfer_progress(curl.get(), progress);
+    const CURLcode res = curl_easy_perform(curl.get());
+
+    if (res != CURLcode::CURLE_OK) {
+        if (nullptr != progress_callback) {
+            progress_callback(0, Status::Error, res);
+        }
+        LogErr() << "Error while uploading, curl error code: " << curl_easy_strerror(res);
+        return false;
+    }
+
+    if (nullptr != progress_callback) {
+        progress_callback(100, Status::Finished, res);
+    }
+    return true;
+}
+
 } // namespace mavsdk
@@ -17,6 +17,9 @@ public:
     ICurlWrapper() = default;
     virtual ~ICurlWrapper() = default;
     virtual bool download_text(const std::string& url, std::string& content) = 0;
+    // Validators are sent along if set, and updated from the response.
+    virtual ConditionalDownloadResult download_text_if_modified(
+        const std::string& url, HttpValidators& validators, std::string& content) = 0;
     virtual bool download_file_to_path(
         const std::string& url,
         const std::string& path,
@@ -25,6 +28,19 @@ public:
         const std::string& url,
         const std::string& path,
         const ProgressCallback& progress_callback) = 0;
+    // Hands the content over in chunks instead of keeping all of it.
+    virtual bool download_to_callback(
+        const std::string& url,
+        const ChunkCallback& chunk_callback,
+        const ProgressCallback& progress_callback) = 0;
+    // Uploads size bytes taken from read_callback as a file called filename,
+    // the same way as upload_file but without a file.
+    virtual bool upload_from_callback(
+        const std::string& url,
+        const std::string& filename,
+        size_t size,
+        const ReadCallback& read_callback,
+        const ProgressCallback& progress_callback) = 0;
 };
 
 class CurlWrapper : public ICurlWrapper {
@@ -33,6 +49,8 @@ public:
     CurlWrapper() = default;
     virtual ~CurlWrapper() = default;
     bool download_text(const std::string& url, std::string& content) override;
+    ConditionalDownloadResult download_text_if_modified(
+        const std::string& url, HttpValidators& validators, std::string& content) override;
     bool download_file_to_path(
         const std::string& url,
         const std::string& path,
@@ -41,12 +59,26 @@ public:
         const std::string& url,
         const std::string& path,
         const ProgressCallback& progress_callback) override;
+    bool download_to_callback(
+        const std::string& url,
+        const ChunkCallback& chunk_callback,
+        const ProgressCallback& progress_callback) override;
+    bool upload_from_callback(
+        const std::string& url,
+        const std::string& filename,
+        size_t size,
+        const ReadCallback& read_callback,
+        const ProgressCallback& progress_callback) override;
 };
 
 #ifdef TESTING
 class CurlWrapperMock : public ICurlWrapper {
 public:
     MOCK_METHOD2(download_text, bool(const std::string& url, std::string& content));
+    MOCK_METHOD3(
+        download_text_if_modified,
+        ConditionalDownloadResult(
+            const std::string& url, HttpValidators& validators, std::string& content));
     MOCK_METHOD3(
         download_file_to_path,
         bool(
@@ -59,6 +91,20 @@ public:
             const std::string& url,
             const std::string& path,
             const ProgressCallback& progress_callback));
+    MOCK_METHOD3(
+        download_to_callback,
+        bool(
+            const std::string& url,
+            const ChunkCallback& chunk_callback,
+            const ProgressCallback& progress_callback));
+    MOCK_METHOD5(
+        upload_from_callback,
+        bool(
+            const std::string& url,
+            const std::string& filename,
+            size_t size,
+            const ReadCallback& read_callback,
+            const ProgressCallback& progress_callback));
 };
 #endif // TESTING
 
@@ -1,6 +1,8 @@
 #pragma once
 #include "curl_include.h"
+#include <cstddef>
 #include <functional>
+#include <string>
 
 namespace mavsdk {
 
@@ -8,6 +10,22 @@ enum class Status { Idle = 0, Downloading = 1, Uploading = 2, Finished = 3, Erro
 
 using ProgressCallback = std::function<int(int progress, Status status, CURLcode curl_code)>;
 
+// Gets the next part of a download as it arrives, returns false to abort it.
+using ChunkCallback = std::function<bool(const char* data, size_t size)>;
+
+// Fills buffer with up to size bytes of an upload, returns how many it did,
+// 0 once there is nothing more.
+using ReadCallback = std::function<size_t(char* buffer, size_t size)>;
+
+// What a server told us about a resource, so that we can ask it later to
+// only send it again if it changed.
+struct HttpValidators {
+    std::string etag{};
+    std::string last_modified{};
+};
+
+enum class ConditionalDownloadResult { Downloaded, NotModified, Failed };
+
 struct UpProgress {
     int progress_in_percentage = 0;
     ProgressCallback progress_callback{nullptr};
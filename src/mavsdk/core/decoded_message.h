@@ -0,0 +1,57 @@
+#pragma once
+
+#include "mavlink_include.h"
+#include <cstdint>
+
+namespace mavsdk {
+
+// Several handlers are often registered for the same message, e.g. core,
+// Telemetry and a plugin of the user all for HEARTBEAT or ODOMETRY, and each
+// would decode it for itself. Handlers can instead get the decoded message
+// here, which is only decoded by the first one of them per dispatch.
+//
+// The result is only valid while the handler runs, and only until it decodes
+// another message of the same type, so take a copy to hold on to it.
+//
+// It is kept per thread, so no locking is needed.
+class DecodedMessage {
+public:
+    // Called before handlers are called for a message, so that the messages
+    // decoded for the previous one are not mistaken for it.
+    static void next_dispatch() { ++_dispatch_count; }
+
+    template<typename T>
+    static const T&
+    get(const mavlink_message_t& message, void (*decode)(const mavlink_message_t*, T*))
+    {
+        thread_local Slot<T> slot{};
+
+        if (slot.dispatch_count != _dispatch_count || slot.message != &message ||
+            slot.msgid != message.msgid || slot.seq != message.seq ||
+            slot.checksum != message.checksum) {
+            decode(&message, &slot.value);
+            slot.dispatch_count = _dispatch_count;
+            slot.message = &message;
+            slot.msgid = message.msgid;
+            slot.seq = message.seq;
+            slot.checksum = message.checksum;
+        }
+        return slot.value;
+    }
+
+private:
+    template<typename T>
+    struct Slot {
+        T value{};
+        // What the value was decoded from.
+        uint64_t dispatch_count{0};
+        const mavlink_message_t* message{nullptr};
+        uint32_t msgid{0};
+        uint8_t seq{0};
+        uint16_t checksum{0};
+    };
+
+    static inline thread_local uint64_t _dispatch_count{0};
+};
+
+} // namespace mavsdk
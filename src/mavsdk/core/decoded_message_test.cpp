@@ -0,0 +1,68 @@
+#include "decoded_message.h"
+#include <gtest/gtest.h>
+
+using namespace mavsdk;
+
+namespace {
+
+struct Decoded {
+    uint32_t msgid;
+};
+
+unsigned decode_count = 0;
+
+void decode(const mavlink_message_t* message, Decoded* decoded)
+{
+    ++decode_count;
+    decoded->msgid = message->msgid;
+}
+
+} // namespace
+
+TEST(DecodedMessage, DecodesOncePerDispatch)
+{
+    mavlink_message_t message{};
+    message.msgid = 42;
+    decode_count = 0;
+
+    DecodedMessage::next_dispatch();
+    EXPECT_EQ(DecodedMessage::get(message, decode).msgid, 42u);
+    EXPECT_EQ(DecodedMessage::get(message, decode).msgid, 42u);
+    EXPECT_EQ(decode_count, 1u);
+}
+
+TEST(DecodedMessage, DecodesAgainForNextDispatch)
+{
+    // The same buffer is reused for the next message.
+    mavlink_message_t message{};
+    message.msgid = 42;
+    decode_count = 0;
+
+    DecodedMessage::next_dispatch();
+    EXPECT_EQ(DecodedMessage::get(message, decode).msgid, 42u);
+
+    message.msgid = 43;
+    DecodedMessage::next_dispatch();
+    EXPECT_EQ(DecodedMessage::get(message, decode).msgid, 43u);
+    EXPECT_EQ(decode_count, 2u);
+}
+
+TEST(DecodedMessage, DecodesOtherMessageWithinDispatch)
+{
+    mavlink_message_t message{};
+    message.msgid = 42;
+    mavlink_message_t other{};
+    other.msgid = 43;
+    decode_count = 0;
+
+    DecodedMessage::next_dispatch();
+    EXPECT_EQ(DecodedMessage::get(message, decode).msgid, 42u);
+    EXPECT_EQ(DecodedMessage::get(other, decode).msgid, 43u);
+    EXPECT_EQ(decode_count, 2u);
+
+    // Or a changed one at the same place.
+    other.seq = 1;
+    other.checksum = 0x1234;
+    EXPECT_EQ(DecodedMessage::get(other, decode).msgid, 43u);
+    EXPECT_EQ(decode_count, 3u);
+}
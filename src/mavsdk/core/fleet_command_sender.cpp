@@ -0,0 +1,254 @@
+#include "fleet_command_sender.h"
+#include "log.h"
+#include <algorithm>
+#include <cmath>
+
+namespace mavsdk {
+
+FleetCommandSender::FleetCommandSender(
+    Sender& sender, TimeoutHandler& timeout_handler, TimeoutSCallback timeout_s_callback) :
+    _sender(sender),
+    _timeout_handler(timeout_handler),
+    _timeout_s_callback(std::move(timeout_s_callback))
+{}
+
+FleetCommandSender::~FleetCommandSender()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    for (const auto& work : _works) {
+        _timeout_handler.remove(work->timeout_cookie);
+    }
+}
+
+void FleetCommandSender::send_command_async(
+    const CommandLong& command, const std::vector<Target>& targets, ResultCallback callback)
+{
+    auto new_work = std::make_shared<Work>();
+    new_work->command = command;
+    new_work->callback = std::move(callback);
+    new_work->timeout_s = _timeout_s_callback();
+    for (const auto& target : targets) {
+        Recipient recipient{};
+        recipient.target = target;
+        new_work->recipients.push_back(recipient);
+    }
+
+    std::function<void()> finished;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _works.push_back(new_work);
+
+        if (send_to_remaining(*new_work)) {
+            _timeout_handler.add(
+                [this, work = new_work.get()]() { receive_timeout(work); },
+                new_work->timeout_s,
+                &new_work->timeout_cookie);
+        } else {
+            finished = finish_if_done(std::prev(_works.end()));
+        }
+    }
+
+    if (finished) {
+        finished();
+    }
+}
+
+bool FleetCommandSender::receive_command_ack(const mavlink_message_t& message)
+{
+    mavlink_command_ack_t command_ack;
+    mavlink_msg_command_ack_decode(&message, &command_ack);
+
+    if ((command_ack.target_system && command_ack.target_system != _sender.get_own_system_id()) ||
+        (command_ack.target_component &&
+         command_ack.target_component != _sender.get_own_component_id())) {
+        return false;
+    }
+
+    std::function<void()> finished;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        auto it = _works.begin();
+        Recipient* recipient = nullptr;
+        for (; it != _works.end(); ++it) {
+            auto& work = **it;
+            if (work.command.command != command_ack.command ||
+                (work.command.target_component_id != 0 &&
+                 work.command.target_component_id != message.compid)) {
+                continue;
+            }
+
+            const auto found = std::find_if(
+                work.recipients.begin(), work.recipients.end(), [&](const Recipient& other) {
+                    return other.target.system_id == message.sysid && !other.result;
+                });
+            if (found != work.recipients.end()) {
+                recipient = &(*found);
+                break;
+            }
+        }
+
+        if (recipient == nullptr) {
+            return false;
+        }
+
+        if (command_ack.result == MAV_RESULT_IN_PROGRESS) {
+            recipient->in_progress = true;
+            return true;
+        }
+
+        recipient->result = result_from_mav_result(command_ack.result);
+        finished = finish_if_done(it);
+    }
+
+    if (finished) {
+        finished();
+    }
+    return true;
+}
+
+void FleetCommandSender::receive_timeout(const Work* work)
+{
+    std::function<void()> finished;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        const auto it = std::find_if(_works.begin(), _works.end(), [&](const auto& other) {
+            return other.get() == work;
+        });
+        if (it == _works.end()) {
+            return;
+        }
+
+        auto& timed_out = **it;
+        timed_out.timeout_cookie = nullptr;
+
+        if (timed_out.retries_to_do > 0) {
+            --timed_out.retries_to_do;
+            LogWarn() << "Sending fleet command " << timed_out.command.command
+                      << " again, retries to do: " << timed_out.retries_to_do;
+
+            if (send_to_remaining(timed_out)) {
+                _timeout_handler.add(
+                    [this, work]() { receive_timeout(work); },
+                    timed_out.timeout_s,
+                    &timed_out.timeout_cookie);
+                return;
+            }
+        } else {
+            LogErr() << "Retrying fleet command " << timed_out.command.command << " failed";
+
+            for (auto& recipient : timed_out.recipients) {
+                if (!recipient.result) {
+                    recipient.result = Result::Timeout;
+                }
+            }
+        }
+
+        finished = finish_if_done(it);
+    }
+
+    if (finished) {
+        finished();
+    }
+}
+
+bool FleetCommandSender::send_to_remaining(Work& work)
+{
+    bool any_remaining = false;
+
+    for (auto& recipient : work.recipients) {
+        if (recipient.result) {
+            continue;
+        }
+
+        if (!recipient.in_progress) {
+            mavlink_message_t message = create_mavlink_message(work.command, recipient.target);
+            if (!_sender.send_message(message)) {
+                recipient.result = Result::ConnectionError;
+                continue;
+            }
+        }
+        any_remaining = true;
+    }
+
+    return any_remaining;
+}
+
+std::function<void()>
+FleetCommandSender::finish_if_done(std::vector<std::shared_ptr<Work>>::iterator it)
+{
+    auto& work = **it;
+
+    std::vector<std::pair<uint8_t, Result>> results;
+    results.reserve(work.recipients.size());
+    for (const auto& recipient : work.recipients) {
+        if (!recipient.result) {
+            return {};
+        }
+        results.emplace_back(recipient.target.system_id, recipient.result.value());
+    }
+
+    _timeout_handler.remove(work.timeout_cookie);
+    auto callback = std::move(work.callback);
+    _works.erase(it);
+
+    if (!callback) {
+        return {};
+    }
+    return [callback = std::move(callback), results = std::move(results)]() {
+        callback(results);
+    };
+}
+
+mavlink_message_t
+FleetCommandSender::create_mavlink_message(const CommandLong& command, const Target& target)
+{
+    // Reserved params are sent as 0 to ArduPilot, and as NAN otherwise.
+    const auto maybe_reserved = [&target](const std::optional<float>& maybe_param) {
+        if (maybe_param) {
+            return maybe_param.value();
+        }
+        return target.autopilot == Sender::Autopilot::ArduPilot ? 0.0f : NAN;
+    };
+
+    mavlink_message_t message;
+    mavlink_msg_command_long_pack(
+        _sender.get_own_system_id(),
+        _sender.get_own_component_id(),
+        &message,
+        target.system_id,
+        command.target_component_id,
+        command.command,
+        command.confirmation,
+        maybe_reserved(command.params.maybe_param1),
+        maybe_reserved(command.params.maybe_param2),
+        maybe_reserved(command.params.maybe_param3),
+        maybe_reserved(command.params.maybe_param4),
+        maybe_reserved(command.params.maybe_param5),
+        maybe_reserved(command.params.maybe_param6),
+        maybe_reserved(command.params.maybe_param7));
+    return message;
+}
+
+FleetCommandSender::Result FleetCommandSender::result_from_mav_result(uint8_t mav_result)
+{
+    switch (mav_result) {
+        case MAV_RESULT_ACCEPTED:
+            return Result::Success;
+        case MAV_RESULT_DENIED:
+            return Result::Denied;
+        case MAV_RESULT_UNSUPPORTED:
+            return Result::Unsupported;
+        case MAV_RESULT_TEMPORARILY_REJECTED:
+            return Result::TemporarilyRejected;
+        case MAV_RESULT_FAILED:
+            return Result::Failed;
+        case MAV_RESULT_CANCELLED:
+            return Result::Cancelled;
+        default:
+            return Result::UnknownError;
+    }
+}
+
+} // namespace mavsdk
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "mavlink_command_sender.h"
+#include "mavlink_include.h"
+#include "sender.h"
+#include "timeout_handler.h"
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace mavsdk {
+
+// Sends the same command to many systems, e.g. to arm a whole fleet, and
+// keeps track of all their acks in one place. There is one timeout for all
+// of them, after which the command is only sent again to the systems which
+// have not answered yet.
+class FleetCommandSender {
+public:
+    using Result = MavlinkCommandSender::Result;
+    using CommandLong = MavlinkCommandSender::CommandLong;
+    using TimeoutSCallback = std::function<double()>;
+
+    struct Target {
+        uint8_t system_id{0};
+        Sender::Autopilot autopilot{Sender::Autopilot::Unknown};
+    };
+
+    // The result of every target, in the order they were given.
+    using ResultCallback = std::function<void(std::vector<std::pair<uint8_t, Result>>)>;
+
+    FleetCommandSender(
+        Sender& sender, TimeoutHandler& timeout_handler, TimeoutSCallback timeout_s_callback);
+    ~FleetCommandSender();
+
+    // Non-copyable
+    FleetCommandSender(const FleetCommandSender&) = delete;
+    const FleetCommandSender& operator=(const FleetCommandSender&) = delete;
+
+    // The target system of the command is ignored, it is sent to each of
+    // the targets instead.
+    void send_command_async(
+        const CommandLong& command, const std::vector<Target>& targets, ResultCallback callback);
+
+    // Returns whether the ack was for a fleet command.
+    bool receive_command_ack(const mavlink_message_t& message);
+
+    static constexpr int RETRIES = 3;
+
+private:
+    struct Recipient {
+        Target target{};
+        std::optional<Result> result{};
+        // Arrived, so it is not sent again, but not done yet either.
+        bool in_progress{false};
+    };
+
+    struct Work {
+        CommandLong command{};
+        std::vector<Recipient> recipients{};
+        ResultCallback callback{};
+        void* timeout_cookie{nullptr};
+        double timeout_s{0.5};
+        int retries_to_do{RETRIES};
+    };
+
+    void receive_timeout(const Work* work);
+
+    // Sends to the recipients without result, returns false if none are left.
+    bool send_to_remaining(Work& work);
+
+    // Takes out the work if all recipients have a result, and returns the
+    // callback to call with them.
+    std::function<void()> finish_if_done(std::vector<std::shared_ptr<Work>>::iterator it);
+
+    mavlink_message_t create_mavlink_message(const CommandLong& command, const Target& target);
+
+    static Result result_from_mav_result(uint8_t mav_result);
+
+    Sender& _sender;
+    TimeoutHandler& _timeout_handler;
+    TimeoutSCallback _timeout_s_callback;
+
+    std::mutex _mutex{};
+    std::vector<std::shared_ptr<Work>> _works{}; // Needs _mutex
+};
+
+} // namespace mavsdk
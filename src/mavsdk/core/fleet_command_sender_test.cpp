@@ -0,0 +1,206 @@
+#include <gtest/gtest.h>
+
+#include "fleet_command_sender.h"
+#include "mocks/sender_mock.h"
+
+using namespace mavsdk;
+
+using ::testing::_;
+using ::testing::NiceMock;
+using ::testing::Return;
+using ::testing::Truly;
+using MockSender = NiceMock<mavsdk::testing::MockSender>;
+
+using Result = FleetCommandSender::Result;
+using Results = std::vector<std::pair<uint8_t, Result>>;
+
+static constexpr uint8_t own_system_id = 245;
+static constexpr uint8_t own_component_id = 190;
+static constexpr double timeout_s = 0.5;
+
+class FleetCommandSenderTest : public ::testing::Test {
+protected:
+    FleetCommandSenderTest() :
+        ::testing::Test(),
+        timeout_handler(time),
+        sender(mock_sender, timeout_handler, []() { return timeout_s; })
+    {}
+
+    void SetUp() override
+    {
+        ON_CALL(mock_sender, get_own_system_id()).WillByDefault(Return(own_system_id));
+        ON_CALL(mock_sender, get_own_component_id()).WillByDefault(Return(own_component_id));
+        ON_CALL(mock_sender, send_message(_)).WillByDefault(Return(true));
+    }
+
+    static FleetCommandSender::CommandLong make_arm_command()
+    {
+        FleetCommandSender::CommandLong command{};
+        command.command = MAV_CMD_COMPONENT_ARM_DISARM;
+        command.target_component_id = MAV_COMP_ID_AUTOPILOT1;
+        command.params.maybe_param1 = 1.0f;
+        return command;
+    }
+
+    static std::vector<FleetCommandSender::Target> make_targets(std::vector<uint8_t> system_ids)
+    {
+        std::vector<FleetCommandSender::Target> targets;
+        for (const auto system_id : system_ids) {
+            targets.push_back({system_id, Sender::Autopilot::Px4});
+        }
+        return targets;
+    }
+
+    static mavlink_message_t make_ack(uint8_t system_id, uint8_t result)
+    {
+        mavlink_message_t message;
+        mavlink_msg_command_ack_pack(
+            system_id,
+            MAV_COMP_ID_AUTOPILOT1,
+            &message,
+            MAV_CMD_COMPONENT_ARM_DISARM,
+            result,
+            0,
+            0,
+            own_system_id,
+            own_component_id);
+        return message;
+    }
+
+    void time_out()
+    {
+        time.sleep_for(std::chrono::milliseconds(static_cast<int>(timeout_s * 1000.0) + 100));
+        timeout_handler.run_once();
+    }
+
+    MockSender mock_sender;
+    FakeTime time;
+    TimeoutHandler timeout_handler;
+    FleetCommandSender sender;
+};
+
+static bool is_command_to(const mavlink_message_t& message, uint8_t system_id)
+{
+    if (message.msgid != MAVLINK_MSG_ID_COMMAND_LONG) {
+        return false;
+    }
+    mavlink_command_long_t command_long;
+    mavlink_msg_command_long_decode(&message, &command_long);
+    return command_long.target_system == system_id &&
+           command_long.command == MAV_CMD_COMPONENT_ARM_DISARM;
+}
+
+TEST_F(FleetCommandSenderTest, SendsToEveryTarget)
+{
+    EXPECT_CALL(mock_sender, send_message(Truly([](const mavlink_message_t& message) {
+                    return is_command_to(message, 1);
+                })));
+    EXPECT_CALL(mock_sender, send_message(Truly([](const mavlink_message_t& message) {
+                    return is_command_to(message, 2);
+                })));
+
+    sender.send_command_async(make_arm_command(), make_targets({1, 2}), [](Results) {});
+}
+
+TEST_F(FleetCommandSenderTest, CallsBackOnceAllAcked)
+{
+    std::optional<Results> results;
+    sender.send_command_async(
+        make_arm_command(), make_targets({1, 2}), [&](Results r) { results = std::move(r); });
+
+    EXPECT_TRUE(sender.receive_command_ack(make_ack(2, MAV_RESULT_DENIED)));
+    EXPECT_FALSE(results);
+
+    EXPECT_TRUE(sender.receive_command_ack(make_ack(1, MAV_RESULT_ACCEPTED)));
+    ASSERT_TRUE(results);
+    EXPECT_EQ(results.value(), (Results{{1, Result::Success}, {2, Result::Denied}}));
+}
+
+TEST_F(FleetCommandSenderTest, IgnoresOtherAcks)
+{
+    sender.send_command_async(make_arm_command(), make_targets({1}), [](Results) {});
+
+    // Not a target.
+    EXPECT_FALSE(sender.receive_command_ack(make_ack(3, MAV_RESULT_ACCEPTED)));
+
+    // For someone else.
+    mavlink_message_t message;
+    mavlink_msg_command_ack_pack(
+        1,
+        MAV_COMP_ID_AUTOPILOT1,
+        &message,
+        MAV_CMD_COMPONENT_ARM_DISARM,
+        MAV_RESULT_ACCEPTED,
+        0,
+        0,
+        own_system_id + 1,
+        own_component_id);
+    EXPECT_FALSE(sender.receive_command_ack(message));
+
+    // Already answered.
+    EXPECT_TRUE(sender.receive_command_ack(make_ack(1, MAV_RESULT_ACCEPTED)));
+    EXPECT_FALSE(sender.receive_command_ack(make_ack(1, MAV_RESULT_ACCEPTED)));
+}
+
+TEST_F(FleetCommandSenderTest, RetriesOnlyNonResponders)
+{
+    sender.send_command_async(make_arm_command(), make_targets({1, 2}), [](Results) {});
+    sender.receive_command_ack(make_ack(1, MAV_RESULT_ACCEPTED));
+
+    EXPECT_CALL(mock_sender, send_message(Truly([](const mavlink_message_t& message) {
+                    return is_command_to(message, 1);
+                })))
+        .Times(0);
+    EXPECT_CALL(mock_sender, send_message(Truly([](const mavlink_message_t& message) {
+                    return is_command_to(message, 2);
+                })))
+        .Times(1);
+
+    time_out();
+}
+
+TEST_F(FleetCommandSenderTest, TimesOutAfterRetries)
+{
+    std::optional<Results> results;
+    sender.send_command_async(
+        make_arm_command(), make_targets({1, 2}), [&](Results r) { results = std::move(r); });
+    sender.receive_command_ack(make_ack(1, MAV_RESULT_ACCEPTED));
+
+    for (int i = 0; i < FleetCommandSender::RETRIES; ++i) {
+        time_out();
+        EXPECT_FALSE(results);
+    }
+    time_out();
+
+    ASSERT_TRUE(results);
+    EXPECT_EQ(results.value(), (Results{{1, Result::Success}, {2, Result::Timeout}}));
+}
+
+TEST_F(FleetCommandSenderTest, DoesNotResendWhileInProgress)
+{
+    std::optional<Results> results;
+    sender.send_command_async(
+        make_arm_command(), make_targets({1}), [&](Results r) { results = std::move(r); });
+    EXPECT_TRUE(sender.receive_command_ack(make_ack(1, MAV_RESULT_IN_PROGRESS)));
+
+    EXPECT_CALL(mock_sender, send_message(_)).Times(0);
+    time_out();
+    EXPECT_FALSE(results);
+
+    EXPECT_TRUE(sender.receive_command_ack(make_ack(1, MAV_RESULT_ACCEPTED)));
+    ASSERT_TRUE(results);
+    EXPECT_EQ(results.value(), (Results{{1, Result::Success}}));
+}
+
+TEST_F(FleetCommandSenderTest, ReportsConnectionErrors)
+{
+    ON_CALL(mock_sender, send_message(_)).WillByDefault(Return(false));
+
+    std::optional<Results> results;
+    sender.send_command_async(
+        make_arm_command(), make_targets({1, 2}), [&](Results r) { results = std::move(r); });
+
+    ASSERT_TRUE(results);
+    EXPECT_EQ(
+        results.value(), (Results{{1, Result::ConnectionError}, {2, Result::ConnectionError}}));
+}
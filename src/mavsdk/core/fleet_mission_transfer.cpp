@@ -0,0 +1,125 @@
+#include "fleet_mission_transfer.h"
+
+#include <algorithm>
+#include <numeric>
+
+namespace mavsdk {
+
+void FleetMissionTransfer::start(
+    std::vector<Job> jobs,
+    size_t max_parallel,
+    ProgressCallback progress_callback,
+    ResultCallback callback)
+{
+    if (jobs.empty()) {
+        if (callback) {
+            callback({});
+        }
+        return;
+    }
+
+    auto transfer = std::make_shared<FleetMissionTransfer>(
+        std::move(jobs), max_parallel, std::move(progress_callback), std::move(callback));
+    transfer->start_more();
+}
+
+FleetMissionTransfer::FleetMissionTransfer(
+    std::vector<Job> jobs,
+    size_t max_parallel,
+    ProgressCallback progress_callback,
+    ResultCallback callback) :
+    _jobs(std::move(jobs)),
+    _max_parallel(std::max<size_t>(max_parallel, 1)),
+    _progress_callback(std::move(progress_callback)),
+    _callback(std::move(callback))
+{
+    for (const auto& job : _jobs) {
+        Outcome outcome{};
+        outcome.system_id = job.system_id;
+        _outcomes.push_back(std::move(outcome));
+    }
+    _progress.resize(_jobs.size(), 0.0f);
+    _done.resize(_jobs.size(), false);
+}
+
+void FleetMissionTransfer::start_more()
+{
+    while (true) {
+        size_t index = 0;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (_running >= _max_parallel || _next_to_start >= _jobs.size()) {
+                return;
+            }
+            index = _next_to_start++;
+            ++_running;
+        }
+
+        // Not locked, as a job could be done right away.
+        auto self = shared_from_this();
+        _jobs[index].start(
+            [self, index](float progress) { self->process_progress(index, progress); },
+            [self, index](Result result, std::vector<ItemInt> items) {
+                self->process_done(index, result, std::move(items));
+            });
+    }
+}
+
+void FleetMissionTransfer::process_progress(size_t index, float progress)
+{
+    float total = 0.0f;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_done[index]) {
+            return;
+        }
+        _progress[index] = std::clamp(progress, 0.0f, 1.0f);
+        total = std::accumulate(_progress.begin(), _progress.end(), 0.0f) /
+                static_cast<float>(_progress.size());
+    }
+
+    if (_progress_callback) {
+        _progress_callback(total);
+    }
+}
+
+void FleetMissionTransfer::process_done(size_t index, Result result, std::vector<ItemInt> items)
+{
+    float total = 0.0f;
+    bool all_done = false;
+    std::vector<Outcome> outcomes;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_done[index]) {
+            return;
+        }
+        _done[index] = true;
+        _progress[index] = 1.0f;
+        _outcomes[index].result = result;
+        _outcomes[index].items = std::move(items);
+        --_running;
+        ++_num_done;
+
+        total = std::accumulate(_progress.begin(), _progress.end(), 0.0f) /
+                static_cast<float>(_progress.size());
+        all_done = _num_done == _jobs.size();
+        if (all_done) {
+            outcomes = std::move(_outcomes);
+        }
+    }
+
+    if (_progress_callback) {
+        _progress_callback(total);
+    }
+
+    if (!all_done) {
+        start_more();
+        return;
+    }
+
+    if (_callback) {
+        _callback(std::move(outcomes));
+    }
+}
+
+} // namespace mavsdk
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "mavlink_mission_transfer.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace mavsdk {
+
+// Runs the mission transfers of many systems, e.g. to verify the missions
+// of a whole fleet before takeoff. Up to max_parallel transfers run at the
+// same time, so their requests interleave on the links instead of each
+// waiting for the previous one, but without flooding the links either.
+//
+// The progress is the one of all transfers together, and there is one
+// callback with the outcome of every system once all are done.
+class FleetMissionTransfer : public std::enable_shared_from_this<FleetMissionTransfer> {
+public:
+    using Result = MavlinkMissionTransfer::Result;
+    using ItemInt = MavlinkMissionTransfer::ItemInt;
+    using ProgressCallback = MavlinkMissionTransfer::ProgressCallback;
+
+    struct Outcome {
+        uint8_t system_id{0};
+        Result result{Result::Cancelled};
+        std::vector<ItemInt> items{};
+    };
+
+    // The outcome of every job, in the order they were given.
+    using ResultCallback = std::function<void(std::vector<Outcome>)>;
+
+    // Starts the transfer of one system, which reports its progress and
+    // calls back once done.
+    using StartTransfer = std::function<void(
+        ProgressCallback progress_callback, MavlinkMissionTransfer::ResultAndItemsCallback done)>;
+
+    struct Job {
+        uint8_t system_id{0};
+        StartTransfer start{};
+    };
+
+    static void start(
+        std::vector<Job> jobs,
+        size_t max_parallel,
+        ProgressCallback progress_callback,
+        ResultCallback callback);
+
+    // Use start() instead.
+    FleetMissionTransfer(
+        std::vector<Job> jobs,
+        size_t max_parallel,
+        ProgressCallback progress_callback,
+        ResultCallback callback);
+    ~FleetMissionTransfer() = default;
+
+    // Non-copyable
+    FleetMissionTransfer(const FleetMissionTransfer&) = delete;
+    const FleetMissionTransfer& operator=(const FleetMissionTransfer&) = delete;
+
+private:
+    // Starts jobs until max_parallel are running.
+    void start_more();
+    void process_progress(size_t index, float progress);
+    void process_done(size_t index, Result result, std::vector<ItemInt> items);
+
+    std::vector<Job> _jobs;
+    const size_t _max_parallel;
+    const ProgressCallback _progress_callback;
+    const ResultCallback _callback;
+
+    std::mutex _mutex{};
+    std::vector<Outcome> _outcomes{}; // Needs _mutex
+    std::vector<float> _progress{}; // Needs _mutex
+    std::vector<bool> _done{}; // Needs _mutex
+    size_t _next_to_start{0}; // Needs _mutex
+    size_t _running{0}; // Needs _mutex
+    size_t _num_done{0}; // Needs _mutex
+};
+
+} // namespace mavsdk
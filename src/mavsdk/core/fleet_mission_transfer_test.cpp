@@ -0,0 +1,121 @@
+#include "fleet_mission_transfer.h"
+#include <gtest/gtest.h>
+#include <map>
+#include <optional>
+
+using namespace mavsdk;
+
+using Result = FleetMissionTransfer::Result;
+using ItemInt = FleetMissionTransfer::ItemInt;
+using Outcome = FleetMissionTransfer::Outcome;
+
+namespace {
+
+// Transfers which only finish when told to.
+struct FakeTransfers {
+    struct Running {
+        FleetMissionTransfer::ProgressCallback progress;
+        MavlinkMissionTransfer::ResultAndItemsCallback done;
+    };
+    std::map<uint8_t, Running> running{};
+
+    std::vector<FleetMissionTransfer::Job> jobs(std::vector<uint8_t> system_ids)
+    {
+        std::vector<FleetMissionTransfer::Job> result;
+        for (const auto system_id : system_ids) {
+            result.push_back({system_id, [this, system_id](auto progress, auto done) {
+                                  running[system_id] = {std::move(progress), std::move(done)};
+                              }});
+        }
+        return result;
+    }
+
+    void finish(uint8_t system_id, Result result, std::vector<ItemInt> items = {})
+    {
+        auto done = running.at(system_id).done;
+        running.erase(system_id);
+        done(result, std::move(items));
+    }
+};
+
+ItemInt make_item(uint16_t seq)
+{
+    ItemInt item{};
+    item.seq = seq;
+    return item;
+}
+
+} // namespace
+
+TEST(FleetMissionTransfer, RunsUpToMaxParallel)
+{
+    FakeTransfers transfers;
+    FleetMissionTransfer::start(transfers.jobs({1, 2, 3}), 2, nullptr, nullptr);
+
+    EXPECT_EQ(transfers.running.size(), 2u);
+    EXPECT_EQ(transfers.running.count(3), 0u);
+
+    transfers.finish(1, Result::Success);
+    EXPECT_EQ(transfers.running.size(), 2u);
+    EXPECT_EQ(transfers.running.count(3), 1u);
+}
+
+TEST(FleetMissionTransfer, CallsBackWithEveryOutcome)
+{
+    FakeTransfers transfers;
+    std::optional<std::vector<Outcome>> outcomes;
+    FleetMissionTransfer::start(
+        transfers.jobs({1, 2}), 8, nullptr, [&](std::vector<Outcome> o) { outcomes = o; });
+
+    transfers.finish(2, Result::Timeout);
+    EXPECT_FALSE(outcomes);
+
+    transfers.finish(1, Result::Success, {make_item(0), make_item(1)});
+    ASSERT_TRUE(outcomes);
+    ASSERT_EQ(outcomes->size(), 2u);
+    EXPECT_EQ(outcomes->at(0).system_id, 1);
+    EXPECT_EQ(outcomes->at(0).result, Result::Success);
+    EXPECT_EQ(outcomes->at(0).items.size(), 2u);
+    EXPECT_EQ(outcomes->at(1).system_id, 2);
+    EXPECT_EQ(outcomes->at(1).result, Result::Timeout);
+}
+
+TEST(FleetMissionTransfer, ReportsProgressOfAll)
+{
+    FakeTransfers transfers;
+    std::vector<float> progress;
+    FleetMissionTransfer::start(
+        transfers.jobs({1, 2}), 8, [&](float p) { progress.push_back(p); }, nullptr);
+
+    transfers.running.at(1).progress(0.5f);
+    transfers.finish(2, Result::Success);
+    transfers.finish(1, Result::Success);
+
+    EXPECT_EQ(progress, (std::vector<float>{0.25f, 0.75f, 1.0f}));
+}
+
+TEST(FleetMissionTransfer, HandlesTransfersDoneRightAway)
+{
+    std::vector<FleetMissionTransfer::Job> jobs;
+    for (uint8_t system_id = 1; system_id <= 20; ++system_id) {
+        jobs.push_back({system_id, [](auto, auto done) { done(Result::ConnectionError, {}); }});
+    }
+
+    std::optional<std::vector<Outcome>> outcomes;
+    FleetMissionTransfer::start(
+        std::move(jobs), 2, nullptr, [&](std::vector<Outcome> o) { outcomes = o; });
+
+    ASSERT_TRUE(outcomes);
+    EXPECT_EQ(outcomes->size(), 20u);
+    EXPECT_EQ(outcomes->back().result, Result::ConnectionError);
+}
+
+TEST(FleetMissionTransfer, CallsBackWithoutJobs)
+{
+    bool called = false;
+    FleetMissionTransfer::start({}, 8, nullptr, [&](std::vector<Outcome> o) {
+        EXPECT_TRUE(o.empty());
+        called = true;
+    });
+    EXPECT_TRUE(called);
+}
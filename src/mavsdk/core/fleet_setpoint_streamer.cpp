@@ -0,0 +1,131 @@
+#include "fleet_setpoint_streamer.h"
+#include "mavsdk_math.h"
+
+namespace mavsdk {
+
+FleetSetpointStreamer::FleetSetpointStreamer(
+    Sender& sender, Time& time, SendMessages send_messages) :
+    _sender(sender),
+    _time(time),
+    _send_messages(std::move(send_messages))
+{}
+
+bool FleetSetpointStreamer::set_setpoints(std::vector<Target> targets)
+{
+    if (targets.empty()) {
+        stop();
+        return true;
+    }
+
+    auto frame = std::make_shared<const std::vector<Target>>(std::move(targets));
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        const bool was_streaming = _frame != nullptr;
+        _frame = frame;
+
+        if (!was_streaming) {
+            _setpoint_streamer.start([this]() {
+                Frame current;
+                {
+                    std::lock_guard<std::mutex> task_lock(_mutex);
+                    current = _frame;
+                }
+                if (current) {
+                    send_frame(current);
+                }
+            });
+        } else {
+            _setpoint_streamer.restart_period();
+        }
+    }
+
+    // Also send it right now to reduce latency.
+    return send_frame(frame);
+}
+
+void FleetSetpointStreamer::stop()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _frame.reset();
+    _setpoint_streamer.stop();
+}
+
+bool FleetSetpointStreamer::set_rate_hz(double rate_hz)
+{
+    return _setpoint_streamer.set_rate_hz(rate_hz);
+}
+
+double FleetSetpointStreamer::rate_hz() const
+{
+    return _setpoint_streamer.rate_hz();
+}
+
+SetpointStreamer::Statistics FleetSetpointStreamer::statistics() const
+{
+    return _setpoint_streamer.statistics();
+}
+
+bool FleetSetpointStreamer::send_frame(const Frame& frame)
+{
+    // The same timestamp for all, they are all for the same moment.
+    const auto time_boot_ms = static_cast<uint32_t>(_time.elapsed_ms());
+
+    std::vector<mavlink_message_t> messages;
+    messages.reserve(frame->size());
+    for (const auto& target : *frame) {
+        messages.push_back(create_mavlink_message(target, time_boot_ms));
+    }
+
+    return _send_messages(messages);
+}
+
+mavlink_message_t
+FleetSetpointStreamer::create_mavlink_message(const Target& target, uint32_t time_boot_ms) const
+{
+    const static uint16_t IGNORE_POSITION = (1 << 0) | (1 << 1) | (1 << 2);
+    const static uint16_t IGNORE_VELOCITY = (1 << 3) | (1 << 4) | (1 << 5);
+    const static uint16_t IGNORE_ACCELERATION = (1 << 6) | (1 << 7) | (1 << 8);
+    const static uint16_t IGNORE_YAW_RATE = (1 << 11);
+
+    const auto& setpoint = target.setpoint;
+
+    uint16_t type_mask = IGNORE_ACCELERATION | IGNORE_YAW_RATE;
+    switch (setpoint.type) {
+        case FleetSetpoint::Type::PositionNed:
+            type_mask |= IGNORE_VELOCITY;
+            break;
+        case FleetSetpoint::Type::VelocityNed:
+            type_mask |= IGNORE_POSITION;
+            break;
+        case FleetSetpoint::Type::PositionVelocityNed:
+            break;
+    }
+
+    const bool has_position = (type_mask & IGNORE_POSITION) == 0;
+    const bool has_velocity = (type_mask & IGNORE_VELOCITY) == 0;
+
+    mavlink_message_t message;
+    mavlink_msg_set_position_target_local_ned_pack(
+        _sender.get_own_system_id(),
+        _sender.get_own_component_id(),
+        &message,
+        time_boot_ms,
+        target.system_id,
+        target.component_id,
+        MAV_FRAME_LOCAL_NED,
+        type_mask,
+        has_position ? setpoint.north_m : 0.0f,
+        has_position ? setpoint.east_m : 0.0f,
+        has_position ? setpoint.down_m : 0.0f,
+        has_velocity ? setpoint.north_m_s : 0.0f,
+        has_velocity ? setpoint.east_m_s : 0.0f,
+        has_velocity ? setpoint.down_m_s : 0.0f,
+        0.0f, // afx
+        0.0f, // afy
+        0.0f, // afz
+        to_rad_from_deg(setpoint.yaw_deg), // yaw
+        0.0f); // yaw_rate
+    return message;
+}
+
+} // namespace mavsdk
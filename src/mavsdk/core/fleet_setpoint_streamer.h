@@ -0,0 +1,68 @@
+#pragma once
+
+#include "fleet_setpoint.h"
+#include "mavlink_include.h"
+#include "mavsdk_time.h"
+#include "sender.h"
+#include "setpoint_streamer.h"
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace mavsdk {
+
+// Streams the offboard setpoints of a whole formation, e.g. for formation
+// flight at 50 Hz. Instead of one thread and one send per system, all
+// setpoints of a frame are sent together on one tick, with the same
+// timestamp, so that the links get them in as few writes as possible and
+// the systems get them at the same time.
+class FleetSetpointStreamer {
+public:
+    // Sends a batch of messages, which may take out the ones it drops.
+    using SendMessages = std::function<bool(std::vector<mavlink_message_t>&)>;
+
+    struct Target {
+        uint8_t system_id{0};
+        uint8_t component_id{0};
+        FleetSetpoint setpoint{};
+    };
+
+    FleetSetpointStreamer(Sender& sender, Time& time, SendMessages send_messages);
+    ~FleetSetpointStreamer() = default;
+
+    // Non-copyable
+    FleetSetpointStreamer(const FleetSetpointStreamer&) = delete;
+    const FleetSetpointStreamer& operator=(const FleetSetpointStreamer&) = delete;
+
+    // Replaces the frame, sends it right away and keeps sending it at the
+    // rate until the next one. An empty frame stops sending.
+    bool set_setpoints(std::vector<Target> targets);
+
+    void stop();
+
+    [[nodiscard]] bool set_rate_hz(double rate_hz);
+    [[nodiscard]] double rate_hz() const;
+
+    [[nodiscard]] SetpointStreamer::Statistics statistics() const;
+
+private:
+    using Frame = std::shared_ptr<const std::vector<Target>>;
+
+    bool send_frame(const Frame& frame);
+    mavlink_message_t create_mavlink_message(const Target& target, uint32_t time_boot_ms) const;
+
+    Sender& _sender;
+    Time& _time;
+    const SendMessages _send_messages;
+
+    std::mutex _mutex{};
+    Frame _frame{}; // Needs _mutex
+
+    // Last, so that it is destroyed first and its thread doesn't call into
+    // anything destroyed already.
+    SetpointStreamer _setpoint_streamer{};
+};
+
+} // namespace mavsdk
@@ -0,0 +1,162 @@
+#include <gtest/gtest.h>
+
+#include "fleet_setpoint_streamer.h"
+#include "mocks/sender_mock.h"
+
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+using namespace mavsdk;
+
+using ::testing::NiceMock;
+using ::testing::Return;
+using MockSender = NiceMock<mavsdk::testing::MockSender>;
+
+static constexpr uint8_t own_system_id = 245;
+static constexpr uint8_t own_component_id = 190;
+
+class FleetSetpointStreamerTest : public ::testing::Test {
+protected:
+    FleetSetpointStreamerTest() :
+        ::testing::Test(),
+        streamer(mock_sender, time, [this](std::vector<mavlink_message_t>& messages) {
+            std::lock_guard<std::mutex> lock(mutex);
+            batches.push_back(messages);
+            return send_result;
+        })
+    {}
+
+    void SetUp() override
+    {
+        ON_CALL(mock_sender, get_own_system_id()).WillByDefault(Return(own_system_id));
+        ON_CALL(mock_sender, get_own_component_id()).WillByDefault(Return(own_component_id));
+    }
+
+    static std::vector<FleetSetpointStreamer::Target> make_formation(float down_m)
+    {
+        std::vector<FleetSetpointStreamer::Target> targets;
+        for (uint8_t system_id = 1; system_id <= 3; ++system_id) {
+            FleetSetpointStreamer::Target target{};
+            target.system_id = system_id;
+            target.component_id = 1;
+            target.setpoint.east_m = 5.0f * system_id;
+            target.setpoint.down_m = down_m;
+            targets.push_back(target);
+        }
+        return targets;
+    }
+
+    std::vector<std::vector<mavlink_message_t>> take_batches()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return std::move(batches);
+    }
+
+    static mavlink_set_position_target_local_ned_t decode(const mavlink_message_t& message)
+    {
+        mavlink_set_position_target_local_ned_t setpoint;
+        mavlink_msg_set_position_target_local_ned_decode(&message, &setpoint);
+        return setpoint;
+    }
+
+    MockSender mock_sender;
+    Time time;
+
+    std::mutex mutex;
+    std::vector<std::vector<mavlink_message_t>> batches; // Needs mutex
+    bool send_result{true};
+
+    // Last, so that its thread is gone before the rest.
+    FleetSetpointStreamer streamer;
+};
+
+TEST_F(FleetSetpointStreamerTest, SendsFrameInOneBatch)
+{
+    EXPECT_TRUE(streamer.set_setpoints(make_formation(-10.0f)));
+
+    const auto sent = take_batches();
+    ASSERT_EQ(sent.size(), 1);
+    ASSERT_EQ(sent[0].size(), 3);
+
+    for (size_t i = 0; i < sent[0].size(); ++i) {
+        const auto& message = sent[0][i];
+        EXPECT_EQ(message.msgid, MAVLINK_MSG_ID_SET_POSITION_TARGET_LOCAL_NED);
+        EXPECT_EQ(message.sysid, own_system_id);
+        EXPECT_EQ(message.compid, own_component_id);
+
+        const auto setpoint = decode(message);
+        EXPECT_EQ(setpoint.target_system, i + 1);
+        EXPECT_EQ(setpoint.target_component, 1);
+        EXPECT_FLOAT_EQ(setpoint.y, 5.0f * static_cast<float>(i + 1));
+        EXPECT_FLOAT_EQ(setpoint.z, -10.0f);
+        // Velocity, acceleration and yaw rate ignored.
+        EXPECT_EQ(setpoint.type_mask, 0b100111111000);
+        // All for the same moment.
+        EXPECT_EQ(setpoint.time_boot_ms, decode(sent[0][0]).time_boot_ms);
+    }
+}
+
+TEST_F(FleetSetpointStreamerTest, KeepsSendingLatestFrame)
+{
+    ASSERT_TRUE(streamer.set_rate_hz(200.0));
+    EXPECT_TRUE(streamer.set_setpoints(make_formation(-10.0f)));
+    EXPECT_TRUE(streamer.set_setpoints(make_formation(-20.0f)));
+    take_batches();
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    streamer.stop();
+
+    const auto sent = take_batches();
+    // 20 ticks, a bit of slack for slow machines.
+    EXPECT_GE(sent.size(), 5);
+    EXPECT_LE(sent.size(), 21);
+    for (const auto& batch : sent) {
+        ASSERT_EQ(batch.size(), 3);
+        EXPECT_FLOAT_EQ(decode(batch[2]).z, -20.0f);
+    }
+}
+
+TEST_F(FleetSetpointStreamerTest, EmptyFrameStops)
+{
+    ASSERT_TRUE(streamer.set_rate_hz(500.0));
+    EXPECT_TRUE(streamer.set_setpoints(make_formation(-10.0f)));
+    EXPECT_TRUE(streamer.set_setpoints({}));
+
+    // A tick might still have been running.
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    take_batches();
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_TRUE(take_batches().empty());
+}
+
+TEST_F(FleetSetpointStreamerTest, SetsTypeMask)
+{
+    auto targets = make_formation(-10.0f);
+    targets[0].setpoint.type = FleetSetpoint::Type::VelocityNed;
+    targets[0].setpoint.north_m_s = 2.0f;
+    targets[1].setpoint.type = FleetSetpoint::Type::PositionVelocityNed;
+    targets[1].setpoint.north_m_s = 3.0f;
+    EXPECT_TRUE(streamer.set_setpoints(targets));
+
+    const auto sent = take_batches();
+    ASSERT_EQ(sent.size(), 1);
+    ASSERT_EQ(sent[0].size(), 3);
+
+    const auto velocity = decode(sent[0][0]);
+    EXPECT_EQ(velocity.type_mask, 0b100111000111);
+    EXPECT_FLOAT_EQ(velocity.z, 0.0f);
+    EXPECT_FLOAT_EQ(velocity.vx, 2.0f);
+
+    const auto position_velocity = decode(sent[0][1]);
+    EXPECT_EQ(position_velocity.type_mask, 0b100111000000);
+    EXPECT_FLOAT_EQ(position_velocity.z, -10.0f);
+    EXPECT_FLOAT_EQ(position_velocity.vx, 3.0f);
+}
+
+TEST_F(FleetSetpointStreamerTest, ReportsConnectionErrors)
+{
+    send_result = false;
+    EXPECT_FALSE(streamer.set_setpoints(make_formation(-10.0f)));
+    streamer.stop();
+}
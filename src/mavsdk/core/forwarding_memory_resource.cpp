@@ -0,0 +1,95 @@
+#include "forwarding_memory_resource.h"
+
+#include <algorithm>
+#include <cstring>
+#include <new>
+#include "log.h"
+
+namespace mavsdk {
+
+bool ForwardingMemoryResource::supported()
+{
+#if defined(MAVSDK_WITH_PMR)
+    return true;
+#else
+    return false;
+#endif
+}
+
+#if defined(MAVSDK_WITH_PMR)
+
+void ForwardingMemoryResource::set_allocator(const Allocator& allocator)
+{
+    if (!allocator.allocate || !allocator.deallocate) {
+        _allocator.store(nullptr, std::memory_order_release);
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _allocators.push_back(std::make_unique<const Allocator>(allocator));
+    _allocator.store(_allocators.back().get(), std::memory_order_release);
+}
+
+std::size_t ForwardingMemoryResource::header_size(std::size_t alignment)
+{
+    // The allocator of a block is stored right before it, and the block
+    // has to stay aligned. Alignments are powers of two.
+    return std::max(alignment, sizeof(const Allocator*));
+}
+
+void* ForwardingMemoryResource::do_allocate(std::size_t bytes, std::size_t alignment)
+{
+    const auto header = header_size(alignment);
+    const Allocator* allocator = _allocator.load(std::memory_order_acquire);
+
+    void* base = nullptr;
+    if (allocator != nullptr) {
+        base = allocator->allocate(bytes + header, alignment);
+        if (base == nullptr) {
+            // We can't throw, so we rather fall back than fail.
+            allocator = nullptr;
+        }
+    }
+    if (base == nullptr) {
+        base = ::operator new(bytes + header, std::align_val_t(alignment));
+    }
+
+    auto* block = static_cast<std::byte*>(base) + header;
+    std::memcpy(block - sizeof(allocator), &allocator, sizeof(allocator));
+    return block;
+}
+
+void ForwardingMemoryResource::do_deallocate(
+    void* pointer, std::size_t bytes, std::size_t alignment)
+{
+    const auto header = header_size(alignment);
+    auto* block = static_cast<std::byte*>(pointer);
+
+    const Allocator* allocator = nullptr;
+    std::memcpy(&allocator, block - sizeof(allocator), sizeof(allocator));
+
+    void* base = block - header;
+    if (allocator != nullptr) {
+        allocator->deallocate(base, bytes + header, alignment);
+    } else {
+        ::operator delete(base, std::align_val_t(alignment));
+    }
+}
+
+bool ForwardingMemoryResource::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+{
+    return this == &other;
+}
+
+#else
+
+void ForwardingMemoryResource::set_allocator(const Allocator& allocator)
+{
+    if (allocator.allocate || allocator.deallocate) {
+        LogWarn() << "Allocators are not supported without std::pmr, ignoring it";
+    }
+}
+
+#endif
+
+} // namespace mavsdk
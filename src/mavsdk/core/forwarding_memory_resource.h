@@ -0,0 +1,72 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "mavsdk.h"
+
+#if defined(MAVSDK_WITH_PMR)
+#include <memory_resource>
+#endif
+
+namespace mavsdk {
+
+// Hands the allocations of containers to the allocator set in the
+// configuration, or to the global one if there is none.
+//
+// The allocator can be changed at any time, e.g. once the system ID is known
+// or when the configuration is set later: every block remembers where it came
+// from, so it is freed there. Allocators set once are therefore kept until
+// destruction.
+//
+// Without std::pmr the containers use the global allocator, and setting one
+// is only logged.
+class ForwardingMemoryResource
+#if defined(MAVSDK_WITH_PMR)
+    : public std::pmr::memory_resource
+#endif
+{
+public:
+    using Allocator = Mavsdk::Configuration::Allocator;
+
+    ForwardingMemoryResource() = default;
+    ~ForwardingMemoryResource() = default;
+
+    ForwardingMemoryResource(const ForwardingMemoryResource&) = delete;
+    ForwardingMemoryResource& operator=(const ForwardingMemoryResource&) = delete;
+
+    // An allocator without functions means the global allocator.
+    void set_allocator(const Allocator& allocator);
+
+    static bool supported();
+
+#if defined(MAVSDK_WITH_PMR)
+    std::pmr::polymorphic_allocator<std::byte> allocator() { return {this}; }
+#else
+    std::allocator<std::byte> allocator() { return {}; }
+#endif
+
+#if defined(MAVSDK_WITH_PMR)
+private:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+    void do_deallocate(void* pointer, std::size_t bytes, std::size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+    static std::size_t header_size(std::size_t alignment);
+
+    std::mutex _mutex{};
+    std::vector<std::unique_ptr<const Allocator>> _allocators{};
+    std::atomic<const Allocator*> _allocator{nullptr};
+#endif
+};
+
+// Vector whose memory comes from a ForwardingMemoryResource.
+#if defined(MAVSDK_WITH_PMR)
+template<typename T> using ResourceVector = std::pmr::vector<T>;
+#else
+template<typename T> using ResourceVector = std::vector<T>;
+#endif
+
+} // namespace mavsdk
@@ -0,0 +1,106 @@
+#include "forwarding_memory_resource.h"
+
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <gtest/gtest.h>
+
+using namespace mavsdk;
+
+namespace {
+
+struct CountingAllocator {
+    int allocations{0};
+    int deallocations{0};
+    bool fail{false};
+
+    Mavsdk::Configuration::Allocator allocator()
+    {
+        return {
+            [this](std::size_t bytes, std::size_t alignment) -> void* {
+                if (fail) {
+                    return nullptr;
+                }
+                ++allocations;
+                return ::operator new(bytes, std::align_val_t(alignment));
+            },
+            [this](void* pointer, std::size_t, std::size_t alignment) {
+                ++deallocations;
+                ::operator delete(pointer, std::align_val_t(alignment));
+            }};
+    }
+};
+
+} // namespace
+
+TEST(ForwardingMemoryResource, UsesAllocatorSet)
+{
+    if (!ForwardingMemoryResource::supported()) {
+        GTEST_SKIP() << "No std::pmr";
+    }
+
+    CountingAllocator counting;
+    ForwardingMemoryResource resource;
+    resource.set_allocator(counting.allocator());
+
+    {
+        ResourceVector<uint64_t> values(resource.allocator());
+        values.push_back(42);
+        EXPECT_EQ(values.front(), 42u);
+        EXPECT_EQ(counting.allocations, 1);
+    }
+    EXPECT_EQ(counting.deallocations, 1);
+}
+
+TEST(ForwardingMemoryResource, FreesWhereAllocated)
+{
+    if (!ForwardingMemoryResource::supported()) {
+        GTEST_SKIP() << "No std::pmr";
+    }
+
+    CountingAllocator first;
+    CountingAllocator second;
+    ForwardingMemoryResource resource;
+
+    auto global = std::make_unique<ResourceVector<uint64_t>>(resource.allocator());
+    global->push_back(1);
+
+    resource.set_allocator(first.allocator());
+    auto values = std::make_unique<ResourceVector<uint64_t>>(resource.allocator());
+    values->push_back(2);
+    EXPECT_EQ(first.allocations, 1);
+
+    resource.set_allocator(second.allocator());
+    values.reset();
+    global.reset();
+    EXPECT_EQ(first.deallocations, 1);
+    EXPECT_EQ(second.allocations, 0);
+    EXPECT_EQ(second.deallocations, 0);
+
+    // Back to the global allocator.
+    resource.set_allocator({});
+    ResourceVector<uint64_t> more(resource.allocator());
+    more.push_back(3);
+    EXPECT_EQ(first.allocations, 1);
+    EXPECT_EQ(second.allocations, 0);
+}
+
+TEST(ForwardingMemoryResource, FallsBackIfAllocatorFails)
+{
+    if (!ForwardingMemoryResource::supported()) {
+        GTEST_SKIP() << "No std::pmr";
+    }
+
+    CountingAllocator counting;
+    counting.fail = true;
+    ForwardingMemoryResource resource;
+    resource.set_allocator(counting.allocator());
+
+    {
+        ResourceVector<uint64_t> values(resource.allocator());
+        values.push_back(42);
+        EXPECT_EQ(values.front(), 42u);
+    }
+    EXPECT_EQ(counting.allocations, 0);
+    EXPECT_EQ(counting.deallocations, 0);
+}
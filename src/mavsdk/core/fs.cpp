@@ -22,6 +22,7 @@
 #define PATH_MAX 4096
 #endif
 
+#include <cstdlib>
 #include <random>
 
 namespace mavsdk {
@@ -151,4 +152,36 @@ std::optional<std::string> create_tmp_directory(const std::string& prefix)
     return {};
 }
 
+std::optional<std::string> get_cache_directory(const std::string& name)
+{
+    fs::path base;
+#if defined(WINDOWS)
+    if (const char* local_app_data = std::getenv("LOCALAPPDATA")) {
+        base = local_app_data;
+    }
+#elif defined(APPLE)
+    if (const char* home = std::getenv("HOME")) {
+        base = fs::path(home) / "Library" / "Caches";
+    }
+#else
+    if (const char* xdg_cache_home = std::getenv("XDG_CACHE_HOME")) {
+        base = xdg_cache_home;
+    } else if (const char* home = std::getenv("HOME")) {
+        base = fs::path(home) / ".cache";
+    }
+#endif
+    if (base.empty()) {
+        return {};
+    }
+
+    const auto path = base / name;
+    std::error_code ec;
+    fs::create_directories(path, ec);
+    if (ec) {
+        LogWarn() << "Could not create cache directory " << path.string() << ": " << ec.message();
+        return {};
+    }
+    return {path.string()};
+}
+
 } // namespace mavsdk
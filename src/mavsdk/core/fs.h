@@ -27,4 +27,8 @@ bool fs_rename(const std::string& old_name, const std::string& new_name);
 
 std::optional<std::string> create_tmp_directory(const std::string& prefix);
 
+// Creates the directory below the user's cache directory, if needed, e.g.
+// ~/.cache/<name> on Linux.
+std::optional<std::string> get_cache_directory(const std::string& name);
+
 } // namespace mavsdk
\ No newline at end of file
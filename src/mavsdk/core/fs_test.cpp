@@ -79,4 +79,20 @@ TEST(Filesystem, RelativePathDotSlash)
     ASSERT_EQ(canonical_path, mavsdk::fs_canonical(dotslash_path));
 }
 
+#if defined(LINUX)
+TEST(Filesystem, CacheDirectoryIsCreated)
+{
+    const auto maybe_tmp_dir = mavsdk::create_tmp_directory("mavsdk-fs-test");
+    ASSERT_TRUE(maybe_tmp_dir);
+    setenv("XDG_CACHE_HOME", maybe_tmp_dir.value().c_str(), 1);
+
+    const auto cache_dir = mavsdk::get_cache_directory("mavsdk/test");
+    unsetenv("XDG_CACHE_HOME");
+
+    ASSERT_TRUE(cache_dir);
+    EXPECT_EQ(cache_dir.value(), maybe_tmp_dir.value() + "/mavsdk/test");
+    EXPECT_TRUE(mavsdk::fs_exists(cache_dir.value()));
+}
+#endif
+
 #endif
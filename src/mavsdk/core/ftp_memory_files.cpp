@@ -0,0 +1,41 @@
+#include "ftp_memory_files.h"
+#include "crc32.h"
+
+namespace mavsdk {
+
+uint32_t FtpMemoryFiles::set(const std::string& path, std::vector<uint8_t> content)
+{
+    // The CRC is calculated once here instead of for every request.
+    Crc32 crc;
+    crc.add(content.data(), static_cast<uint32_t>(content.size()));
+
+    File file{std::make_shared<const std::vector<uint8_t>>(std::move(content)), crc.get()};
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _files[normalized(path)] = std::move(file);
+    return crc.get();
+}
+
+void FtpMemoryFiles::remove(const std::string& path)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _files.erase(normalized(path));
+}
+
+std::optional<FtpMemoryFiles::File> FtpMemoryFiles::get(const std::string& path) const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    const auto it = _files.find(normalized(path));
+    if (it == _files.end()) {
+        return std::nullopt;
+    }
+    return it->second;
+}
+
+std::string FtpMemoryFiles::normalized(const std::string& path)
+{
+    const auto start = path.find_first_not_of('/');
+    return start == std::string::npos ? std::string{} : path.substr(start);
+}
+
+} // namespace mavsdk
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace mavsdk {
+
+// Files which the MAVLink FTP server serves straight from memory, e.g.
+// generated component metadata, so that many clients can download them
+// without them being generated or written to disk again.
+//
+// They are the same for all systems, and read-only for clients. Sessions
+// hold on to the content they opened, so replacing a file doesn't change a
+// download already in progress.
+class FtpMemoryFiles {
+public:
+    FtpMemoryFiles() = default;
+    ~FtpMemoryFiles() = default;
+
+    // Non-copyable
+    FtpMemoryFiles(const FtpMemoryFiles&) = delete;
+    const FtpMemoryFiles& operator=(const FtpMemoryFiles&) = delete;
+
+    struct File {
+        std::shared_ptr<const std::vector<uint8_t>> content;
+        uint32_t crc32;
+    };
+
+    // Adds or replaces the file, and returns its CRC32.
+    uint32_t set(const std::string& path, std::vector<uint8_t> content);
+    void remove(const std::string& path);
+
+    std::optional<File> get(const std::string& path) const;
+
+private:
+    // Clients may ask for "/general.json" as well as "general.json".
+    static std::string normalized(const std::string& path);
+
+    mutable std::mutex _mutex{};
+    std::unordered_map<std::string, File> _files{};
+};
+
+} // namespace mavsdk
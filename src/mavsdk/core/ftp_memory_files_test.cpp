@@ -0,0 +1,42 @@
+#include "ftp_memory_files.h"
+#include "crc32.h"
+#include <gtest/gtest.h>
+
+using namespace mavsdk;
+
+TEST(FtpMemoryFiles, ServesFilesWithTheirCrc)
+{
+    FtpMemoryFiles files;
+    EXPECT_FALSE(files.get("general.json"));
+
+    const std::vector<uint8_t> content{'{', '}'};
+    const auto crc = files.set("general.json", content);
+
+    Crc32 expected_crc;
+    expected_crc.add(content.data(), static_cast<uint32_t>(content.size()));
+    EXPECT_EQ(crc, expected_crc.get());
+
+    auto maybe_file = files.get("general.json");
+    ASSERT_TRUE(maybe_file);
+    EXPECT_EQ(*maybe_file->content, content);
+    EXPECT_EQ(maybe_file->crc32, crc);
+
+    // With a leading slash, as some clients ask for it.
+    EXPECT_TRUE(files.get("/general.json"));
+
+    files.remove("/general.json");
+    EXPECT_FALSE(files.get("general.json"));
+}
+
+TEST(FtpMemoryFiles, KeepsContentOfOpenedFilesWhenReplaced)
+{
+    FtpMemoryFiles files;
+    files.set("parameter.json", {'a'});
+    const auto opened = files.get("parameter.json");
+    ASSERT_TRUE(opened);
+
+    files.set("parameter.json", {'b', 'c'});
+
+    EXPECT_EQ(*opened->content, std::vector<uint8_t>{'a'});
+    EXPECT_EQ(files.get("parameter.json")->content->size(), 2u);
+}
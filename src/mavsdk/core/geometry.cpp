@@ -1,27 +1,33 @@
 #include "geometry.h"
 #include "mavsdk_math.h"
+#include <algorithm>
 #include <cmath>
 
 namespace mavsdk::geometry {
 
-CoordinateTransformation::CoordinateTransformation(GlobalCoordinate reference) :
-    _ref_lat_rad(to_rad_from_deg(reference.latitude_deg)),
-    _ref_lon_rad(to_rad_from_deg(reference.longitude_deg))
-{}
-
-CoordinateTransformation::LocalCoordinate
-CoordinateTransformation::local_from_global(GlobalCoordinate global_coordinate) const
+namespace {
+
+// The per point work shared by the single and the batch conversions. It
+// only depends on its arguments and doesn't branch much, so that the
+// batch loops stay simple for the compiler.
+
+inline void project_local_from_global(
+    double ref_lon_rad,
+    double ref_sin_lat,
+    double ref_cos_lat,
+    double latitude_deg,
+    double longitude_deg,
+    double& north_m,
+    double& east_m,
+    double world_radius_m)
 {
-    const double lat_rad = to_rad_from_deg(global_coordinate.latitude_deg);
-    const double lon_rad = to_rad_from_deg(global_coordinate.longitude_deg);
+    const double lat_rad = to_rad_from_deg(latitude_deg);
+    const double lon_rad = to_rad_from_deg(longitude_deg);
 
     const double sin_lat = sin(lat_rad);
     const double cos_lat = cos(lat_rad);
 
-    const double cos_d_lon = cos(lon_rad - _ref_lon_rad);
-
-    const double ref_sin_lat = sin(_ref_lat_rad);
-    const double ref_cos_lat = cos(_ref_lat_rad);
+    const double cos_d_lon = cos(lon_rad - ref_lon_rad);
 
     const double arg =
         constrain(ref_sin_lat * sin_lat + ref_cos_lat * cos_lat * cos_d_lon, -1.0, 1.0);
@@ -29,41 +35,147 @@ CoordinateTransformation::local_from_global(GlobalCoordinate global_coordinate)
 
     const double k = (fabs(c) > 0) ? (c / sin(c)) : 1.0;
 
-    return LocalCoordinate{
-        k * (ref_cos_lat * sin_lat - ref_sin_lat * cos_lat * cos_d_lon) * world_radius_m,
-        k * cos_lat * sin(lon_rad - _ref_lon_rad) * world_radius_m};
+    north_m = k * (ref_cos_lat * sin_lat - ref_sin_lat * cos_lat * cos_d_lon) * world_radius_m;
+    east_m = k * cos_lat * sin(lon_rad - ref_lon_rad) * world_radius_m;
 }
 
-CoordinateTransformation::GlobalCoordinate
-CoordinateTransformation::global_from_local(LocalCoordinate local_coordinate) const
+inline void project_global_from_local(
+    double ref_lat_rad,
+    double ref_lon_rad,
+    double ref_sin_lat,
+    double ref_cos_lat,
+    double north_m,
+    double east_m,
+    double& latitude_deg,
+    double& longitude_deg,
+    double world_radius_m)
 {
-    const double x_rad = local_coordinate.north_m / world_radius_m;
-    const double y_rad = local_coordinate.east_m / world_radius_m;
+    const double x_rad = north_m / world_radius_m;
+    const double y_rad = east_m / world_radius_m;
     const double c = sqrt(x_rad * x_rad + y_rad * y_rad);
 
-    GlobalCoordinate global{};
-
     if (fabs(c) > 0) {
         const double sin_c = sin(c);
         const double cos_c = cos(c);
 
-        const double ref_sin_lat = sin(_ref_lat_rad);
-        const double ref_cos_lat = cos(_ref_lat_rad);
-
         const double lat_rad = asin(cos_c * ref_sin_lat + (x_rad * sin_c * ref_cos_lat) / c);
         const double lon_rad =
-            (_ref_lon_rad +
+            (ref_lon_rad +
              atan2(y_rad * sin_c, c * ref_cos_lat * cos_c - x_rad * ref_sin_lat * sin_c));
 
-        global.latitude_deg = to_deg_from_rad(lat_rad);
-        global.longitude_deg = to_deg_from_rad(lon_rad);
+        latitude_deg = to_deg_from_rad(lat_rad);
+        longitude_deg = to_deg_from_rad(lon_rad);
 
     } else {
-        global.latitude_deg = to_deg_from_rad(_ref_lat_rad);
-        global.longitude_deg = to_deg_from_rad(_ref_lon_rad);
+        latitude_deg = to_deg_from_rad(ref_lat_rad);
+        longitude_deg = to_deg_from_rad(ref_lon_rad);
     }
+}
+
+} // namespace
+
+CoordinateTransformation::CoordinateTransformation(GlobalCoordinate reference) :
+    _ref_lat_rad(to_rad_from_deg(reference.latitude_deg)),
+    _ref_lon_rad(to_rad_from_deg(reference.longitude_deg)),
+    _ref_sin_lat(sin(_ref_lat_rad)),
+    _ref_cos_lat(cos(_ref_lat_rad))
+{}
 
+CoordinateTransformation::LocalCoordinate
+CoordinateTransformation::local_from_global(GlobalCoordinate global_coordinate) const
+{
+    LocalCoordinate local{};
+    project_local_from_global(
+        _ref_lon_rad,
+        _ref_sin_lat,
+        _ref_cos_lat,
+        global_coordinate.latitude_deg,
+        global_coordinate.longitude_deg,
+        local.north_m,
+        local.east_m,
+        world_radius_m);
+    return local;
+}
+
+CoordinateTransformation::GlobalCoordinate
+CoordinateTransformation::global_from_local(LocalCoordinate local_coordinate) const
+{
+    GlobalCoordinate global{};
+    project_global_from_local(
+        _ref_lat_rad,
+        _ref_lon_rad,
+        _ref_sin_lat,
+        _ref_cos_lat,
+        local_coordinate.north_m,
+        local_coordinate.east_m,
+        global.latitude_deg,
+        global.longitude_deg,
+        world_radius_m);
     return global;
 }
 
+void CoordinateTransformation::local_from_global(
+    const GlobalCoordinates& global_coordinates, LocalCoordinates& local_coordinates) const
+{
+    // Superfluous values of a mismatched input are ignored.
+    const std::size_t count =
+        std::min(global_coordinates.latitude_deg.size(), global_coordinates.longitude_deg.size());
+    local_coordinates.north_m.resize(count);
+    local_coordinates.east_m.resize(count);
+
+    // Plain arrays and locals, so the compiler knows nothing aliases.
+    const double* const latitude_deg = global_coordinates.latitude_deg.data();
+    const double* const longitude_deg = global_coordinates.longitude_deg.data();
+    double* const north_m = local_coordinates.north_m.data();
+    double* const east_m = local_coordinates.east_m.data();
+    const double ref_lon_rad = _ref_lon_rad;
+    const double ref_sin_lat = _ref_sin_lat;
+    const double ref_cos_lat = _ref_cos_lat;
+
+    for (std::size_t i = 0; i < count; ++i) {
+        project_local_from_global(
+            ref_lon_rad,
+            ref_sin_lat,
+            ref_cos_lat,
+            latitude_deg[i],
+            longitude_deg[i],
+            north_m[i],
+            east_m[i],
+            world_radius_m);
+    }
+}
+
+void CoordinateTransformation::global_from_local(
+    const LocalCoordinates& local_coordinates, GlobalCoordinates& global_coordinates) const
+{
+    // Superfluous values of a mismatched input are ignored.
+    const std::size_t count =
+        std::min(local_coordinates.north_m.size(), local_coordinates.east_m.size());
+    global_coordinates.latitude_deg.resize(count);
+    global_coordinates.longitude_deg.resize(count);
+
+    // Plain arrays and locals, so the compiler knows nothing aliases.
+    const double* const north_m = local_coordinates.north_m.data();
+    const double* const east_m = local_coordinates.east_m.data();
+    double* const latitude_deg = global_coordinates.latitude_deg.data();
+    double* const longitude_deg = global_coordinates.longitude_deg.data();
+    const double ref_lat_rad = _ref_lat_rad;
+    const double ref_lon_rad = _ref_lon_rad;
+    const double ref_sin_lat = _ref_sin_lat;
+    const double ref_cos_lat = _ref_cos_lat;
+
+    for (std::size_t i = 0; i < count; ++i) {
+        project_global_from_local(
+            ref_lat_rad,
+            ref_lon_rad,
+            ref_sin_lat,
+            ref_cos_lat,
+            north_m[i],
+            east_m[i],
+            latitude_deg[i],
+            longitude_deg[i],
+            world_radius_m);
+    }
+}
+
 } // namespace mavsdk::geometry
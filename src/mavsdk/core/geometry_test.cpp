@@ -48,3 +48,58 @@ TEST(Geoemtry, LocalToGlobalAndBack)
     EXPECT_NEAR(location.north_m, location_again.north_m, 1e-8);
     EXPECT_NEAR(location.east_m, location_again.east_m, 1e-8);
 }
+
+TEST(Geometry, BatchMatchesSingleConversions)
+{
+    CoordinateTransformation ct({47.356042, 8.519031});
+
+    CoordinateTransformation::LocalCoordinates grid;
+    for (int north = -500; north <= 500; north += 50) {
+        for (int east = -500; east <= 500; east += 50) {
+            grid.north_m.push_back(north);
+            grid.east_m.push_back(east);
+        }
+    }
+
+    CoordinateTransformation::GlobalCoordinates globals;
+    ct.global_from_local(grid, globals);
+    ASSERT_EQ(globals.latitude_deg.size(), grid.north_m.size());
+    ASSERT_EQ(globals.longitude_deg.size(), grid.north_m.size());
+
+    CoordinateTransformation::LocalCoordinates grid_again;
+    ct.local_from_global(globals, grid_again);
+    ASSERT_EQ(grid_again.north_m.size(), grid.north_m.size());
+
+    for (std::size_t i = 0; i < grid.north_m.size(); ++i) {
+        const auto global = ct.global_from_local({grid.north_m[i], grid.east_m[i]});
+        EXPECT_EQ(global.latitude_deg, globals.latitude_deg[i]);
+        EXPECT_EQ(global.longitude_deg, globals.longitude_deg[i]);
+
+        const auto local = ct.local_from_global(global);
+        EXPECT_EQ(local.north_m, grid_again.north_m[i]);
+        EXPECT_EQ(local.east_m, grid_again.east_m[i]);
+
+        EXPECT_NEAR(grid.north_m[i], grid_again.north_m[i], 1e-6);
+        EXPECT_NEAR(grid.east_m[i], grid_again.east_m[i], 1e-6);
+    }
+}
+
+TEST(Geometry, BatchReusesOutput)
+{
+    CoordinateTransformation ct({-26.693518, 153.104172});
+
+    CoordinateTransformation::LocalCoordinates locals{{1.0, 2.0, 3.0}, {4.0, 5.0, 6.0}};
+    CoordinateTransformation::GlobalCoordinates globals;
+    ct.global_from_local(locals, globals);
+    EXPECT_EQ(globals.latitude_deg.size(), 3);
+
+    locals = {{1.0}, {4.0}};
+    ct.global_from_local(locals, globals);
+    EXPECT_EQ(globals.latitude_deg.size(), 1);
+    EXPECT_EQ(globals.longitude_deg.size(), 1);
+
+    // Mismatched sizes only convert the complete points.
+    locals = {{1.0, 2.0}, {4.0}};
+    ct.global_from_local(locals, globals);
+    EXPECT_EQ(globals.latitude_deg.size(), 1);
+}
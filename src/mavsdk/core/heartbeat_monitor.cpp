@@ -0,0 +1,96 @@
+#include "heartbeat_monitor.h"
+#include "trace.h"
+
+namespace mavsdk {
+
+HeartbeatMonitor::HeartbeatMonitor(Time& time) : _time(time) {}
+
+void HeartbeatMonitor::watch(uint8_t system_id, double timeout_s, Callback callback)
+{
+    const auto now = now_ms();
+    _last_seen_ms[system_id].store(now, std::memory_order_relaxed);
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto& watched = _watched[system_id];
+        watched.callback = std::move(callback);
+        watched.timeout_ms = static_cast<int64_t>(timeout_s * 1e3);
+        ++watched.generation;
+        _deadlines.push(Deadline{now + watched.timeout_ms, system_id, watched.generation});
+    }
+
+    std::lock_guard<std::mutex> lock(_notifier_mutex);
+    if (_notifier) {
+        _notifier();
+    }
+}
+
+void HeartbeatMonitor::unwatch(uint8_t system_id)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto& watched = _watched[system_id];
+    watched.callback = nullptr;
+    ++watched.generation;
+}
+
+void HeartbeatMonitor::run_once()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+
+    const auto now = now_ms();
+    while (!_deadlines.empty() && _deadlines.top().time_ms <= now) {
+        const Deadline deadline = _deadlines.top();
+        _deadlines.pop();
+
+        auto& watched = _watched[deadline.system_id];
+        if (deadline.generation != watched.generation || !watched.callback) {
+            continue;
+        }
+
+        const auto last_seen = _last_seen_ms[deadline.system_id].load(std::memory_order_relaxed);
+        if (last_seen + watched.timeout_ms > now) {
+            _deadlines.push(
+                Deadline{last_seen + watched.timeout_ms, deadline.system_id, watched.generation});
+            continue;
+        }
+
+        Callback callback = std::move(watched.callback);
+        watched.callback = nullptr;
+        ++watched.generation;
+
+        // Unlock while we call back because it might in turn want to watch again.
+        lock.unlock();
+        {
+            TraceScope trace("timer", "heartbeat timeout");
+            callback();
+        }
+        lock.lock();
+    }
+}
+
+std::optional<double> HeartbeatMonitor::next_run_in_s()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    // Deadlines which are no longer current are dropped on the way.
+    while (!_deadlines.empty() &&
+           _deadlines.top().generation != _watched[_deadlines.top().system_id].generation) {
+        _deadlines.pop();
+    }
+
+    if (_deadlines.empty()) {
+        return {};
+    }
+
+    const auto next_ms = _deadlines.top().time_ms;
+    const auto now = now_ms();
+    return next_ms > now ? double(next_ms - now) * 1e-3 : 0.0;
+}
+
+void HeartbeatMonitor::set_notifier(std::function<void()> notifier)
+{
+    std::lock_guard<std::mutex> lock(_notifier_mutex);
+    _notifier = std::move(notifier);
+}
+
+} // namespace mavsdk
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <queue>
+#include <vector>
+#include "mavsdk_time.h"
+
+namespace mavsdk {
+
+// Tells when systems stop sending heartbeats, for hundreds of them.
+//
+// A heartbeat only stores when it was received for its system ID, without
+// a lock or a lookup. The deadlines are kept in one heap which is only looked
+// at by run_once(): a system whose deadline has passed but which was heard of
+// since is put back with its new deadline, otherwise it has timed out.
+class HeartbeatMonitor {
+public:
+    using Callback = std::function<void()>;
+
+    explicit HeartbeatMonitor(Time& time);
+    ~HeartbeatMonitor() = default;
+
+    HeartbeatMonitor(const HeartbeatMonitor&) = delete;
+    HeartbeatMonitor& operator=(const HeartbeatMonitor&) = delete;
+
+    // The callback is called once if there is no heartbeat for timeout_s,
+    // after which the system isn't watched anymore.
+    void watch(uint8_t system_id, double timeout_s, Callback callback);
+    void unwatch(uint8_t system_id);
+
+    // For every heartbeat received.
+    void refresh(uint8_t system_id)
+    {
+        _last_seen_ms[system_id].store(now_ms(), std::memory_order_relaxed);
+    }
+
+    void run_once();
+
+    // Time until the next deadline, empty if no system is watched.
+    std::optional<double> next_run_in_s();
+
+    // Called (without lock held) whenever a system is watched, so that the
+    // thread calling run_once() can re-evaluate how long to sleep.
+    void set_notifier(std::function<void()> notifier);
+
+private:
+    struct Deadline {
+        int64_t time_ms;
+        uint8_t system_id;
+        uint32_t generation;
+
+        bool operator>(const Deadline& other) const { return time_ms > other.time_ms; }
+    };
+
+    struct Watched {
+        Callback callback{};
+        int64_t timeout_ms{0};
+        // Deadlines of earlier watches are ignored.
+        uint32_t generation{0};
+    };
+
+    int64_t now_ms()
+    {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+                   _time.coarse_steady_time().time_since_epoch())
+            .count();
+    }
+
+    Time& _time;
+
+    std::array<std::atomic<int64_t>, 256> _last_seen_ms{};
+
+    std::mutex _mutex{};
+    // Needs _mutex
+    std::array<Watched, 256> _watched{};
+    // Needs _mutex
+    std::priority_queue<Deadline, std::vector<Deadline>, std::greater<>> _deadlines{};
+
+    std::function<void()> _notifier{};
+    std::mutex _notifier_mutex{};
+};
+
+} // namespace mavsdk
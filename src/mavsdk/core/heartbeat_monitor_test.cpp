@@ -0,0 +1,97 @@
+#include "heartbeat_monitor.h"
+#include <gtest/gtest.h>
+#include <vector>
+
+#ifdef FAKE_TIME
+#define Time FakeTime
+#endif
+
+using namespace mavsdk;
+
+TEST(HeartbeatMonitor, TimesOutWithoutHeartbeats)
+{
+    Time time;
+    HeartbeatMonitor monitor(time);
+
+    int timeouts = 0;
+    monitor.watch(1, 0.5, [&]() { ++timeouts; });
+    ASSERT_TRUE(monitor.next_run_in_s());
+
+    time.sleep_for(std::chrono::milliseconds(250));
+    monitor.run_once();
+    EXPECT_EQ(timeouts, 0);
+
+    time.sleep_for(std::chrono::milliseconds(500));
+    monitor.run_once();
+    EXPECT_EQ(timeouts, 1);
+
+    // Not watched anymore.
+    EXPECT_FALSE(monitor.next_run_in_s());
+    time.sleep_for(std::chrono::milliseconds(1000));
+    monitor.run_once();
+    EXPECT_EQ(timeouts, 1);
+}
+
+TEST(HeartbeatMonitor, HeartbeatsKeepSystemAlive)
+{
+    Time time;
+    HeartbeatMonitor monitor(time);
+
+    int timeouts = 0;
+    monitor.watch(1, 0.5, [&]() { ++timeouts; });
+
+    for (int i = 0; i < 10; ++i) {
+        time.sleep_for(std::chrono::milliseconds(250));
+        monitor.refresh(1);
+        monitor.run_once();
+    }
+    EXPECT_EQ(timeouts, 0);
+
+    time.sleep_for(std::chrono::milliseconds(750));
+    monitor.run_once();
+    EXPECT_EQ(timeouts, 1);
+}
+
+TEST(HeartbeatMonitor, SystemsTimeOutIndependently)
+{
+    Time time;
+    HeartbeatMonitor monitor(time);
+
+    std::vector<uint8_t> timed_out;
+    for (unsigned system_id = 1; system_id <= 200; ++system_id) {
+        monitor.watch(static_cast<uint8_t>(system_id), 0.5, [&timed_out, system_id]() {
+            timed_out.push_back(static_cast<uint8_t>(system_id));
+        });
+    }
+
+    time.sleep_for(std::chrono::milliseconds(250));
+    for (unsigned system_id = 2; system_id <= 200; ++system_id) {
+        monitor.refresh(static_cast<uint8_t>(system_id));
+    }
+
+    time.sleep_for(std::chrono::milliseconds(400));
+    monitor.run_once();
+    ASSERT_EQ(timed_out.size(), 1u);
+    EXPECT_EQ(timed_out[0], 1);
+}
+
+TEST(HeartbeatMonitor, UnwatchedSystemDoesNotTimeOut)
+{
+    Time time;
+    HeartbeatMonitor monitor(time);
+
+    int timeouts = 0;
+    monitor.watch(1, 0.5, [&]() { ++timeouts; });
+    monitor.unwatch(1);
+    EXPECT_FALSE(monitor.next_run_in_s());
+
+    time.sleep_for(std::chrono::milliseconds(1000));
+    monitor.run_once();
+    EXPECT_EQ(timeouts, 0);
+
+    // Watching again starts over.
+    monitor.watch(1, 0.5, [&]() { ++timeouts; });
+    time.sleep_for(std::chrono::milliseconds(1000));
+    monitor.run_once();
+    EXPECT_EQ(timeouts, 1);
+}
@@ -1,20 +1,23 @@
 #include "http_loader.h"
 #include "curl_wrapper.h"
+#include "thread_config.h"
+
+#include <algorithm>
 
 namespace mavsdk {
 
 #ifdef TESTING
-HttpLoader::HttpLoader(const std::shared_ptr<ICurlWrapper>& curl_wrapper) :
-    _curl_wrapper(curl_wrapper)
-{
-    start();
-}
+HttpLoader::HttpLoader(
+    const std::shared_ptr<ICurlWrapper>& curl_wrapper, unsigned parallel_transfers) :
+    _curl_wrapper(curl_wrapper),
+    _parallel_transfers(std::max(parallel_transfers, 1u))
+{}
 #endif
 
-HttpLoader::HttpLoader() : _curl_wrapper(std::make_shared<CurlWrapper>())
-{
-    start();
-}
+HttpLoader::HttpLoader(unsigned parallel_transfers) :
+    _curl_wrapper(std::make_shared<CurlWrapper>()),
+    _parallel_transfers(std::max(parallel_transfers, 1u))
+{}
 
 HttpLoader::~HttpLoader()
 {
@@ -23,19 +26,26 @@ HttpLoader::~HttpLoader()
 
 void HttpLoader::start()
 {
-    _should_exit = false;
-    _work_thread = new std::thread(work_thread, this);
+    std::lock_guard<std::mutex> lock(_work_threads_mutex);
+    if (!_work_threads.empty() || _should_exit) {
+        return;
+    }
+
+    for (unsigned i = 0; i < _parallel_transfers; ++i) {
+        _work_threads.emplace_back(work_thread, this);
+    }
 }
 
 void HttpLoader::stop()
 {
     _should_exit = true;
     _work_queue.stop();
-    if (_work_thread != nullptr) {
-        _work_thread->join();
-        delete _work_thread;
-        _work_thread = nullptr;
+
+    std::lock_guard<std::mutex> lock(_work_threads_mutex);
+    for (auto& thread : _work_threads) {
+        thread.join();
     }
+    _work_threads.clear();
 }
 
 bool HttpLoader::download_sync(const std::string& url, const std::string& local_path)
@@ -52,6 +62,26 @@ void HttpLoader::download_async(
 {
     auto work_item = std::make_shared<DownloadItem>(url, local_path, progress_callback);
     _work_queue.enqueue(work_item);
+    start();
+}
+
+bool HttpLoader::download_to_callback_sync(
+    const std::string& url, const ChunkCallback& chunk_callback)
+{
+    auto work_item = std::make_shared<DownloadToCallbackItem>(url, chunk_callback, nullptr);
+    bool success = do_download_to_callback(work_item, _curl_wrapper);
+    return success;
+}
+
+void HttpLoader::download_to_callback_async(
+    const std::string& url,
+    const ChunkCallback& chunk_callback,
+    const ProgressCallback& progress_callback)
+{
+    auto work_item =
+        std::make_shared<DownloadToCallbackItem>(url, chunk_callback, progress_callback);
+    _work_queue.enqueue(work_item);
+    start();
 }
 
 bool HttpLoader::upload_sync(const std::string& target_url, const std::string& local_path)
@@ -68,10 +98,40 @@ void HttpLoader::upload_async(
 {
     auto work_item = std::make_shared<UploadItem>(target_url, local_path, progress_callback);
     _work_queue.enqueue(work_item);
+    start();
+}
+
+bool HttpLoader::upload_stream_sync(
+    const std::string& target_url,
+    const std::string& filename,
+    std::istream& stream,
+    size_t size)
+{
+    // The stream outlives the sync upload, so it isn't owned here.
+    auto unowned_stream = std::shared_ptr<std::istream>(&stream, [](std::istream*) {});
+    auto work_item =
+        std::make_shared<UploadStreamItem>(target_url, filename, unowned_stream, size, nullptr);
+    bool success = do_upload_stream(work_item, _curl_wrapper);
+    return success;
+}
+
+void HttpLoader::upload_stream_async(
+    const std::string& target_url,
+    const std::string& filename,
+    std::shared_ptr<std::istream> stream,
+    size_t size,
+    const ProgressCallback& progress_callback)
+{
+    auto work_item = std::make_shared<UploadStreamItem>(
+        target_url, filename, std::move(stream), size, progress_callback);
+    _work_queue.enqueue(work_item);
+    start();
 }
 
 void HttpLoader::work_thread(HttpLoader* self)
 {
+    ThreadConfig::apply(ThreadRole::HttpLoader);
+
     while (!self->_should_exit) {
         auto item = self->_work_queue.dequeue();
         auto curl_wrapper = self->_curl_wrapper;
@@ -96,6 +156,18 @@ void HttpLoader::do_item(
         do_upload(upload_item, curl_wrapper);
         return;
     }
+
+    auto download_to_callback_item = std::dynamic_pointer_cast<DownloadToCallbackItem>(item);
+    if (nullptr != download_to_callback_item) {
+        do_download_to_callback(download_to_callback_item, curl_wrapper);
+        return;
+    }
+
+    auto upload_stream_item = std::dynamic_pointer_cast<UploadStreamItem>(item);
+    if (nullptr != upload_stream_item) {
+        do_upload_stream(upload_stream_item, curl_wrapper);
+        return;
+    }
 }
 
 bool HttpLoader::do_download(
@@ -114,10 +186,44 @@ bool HttpLoader::do_upload(
     return success;
 }
 
+bool HttpLoader::do_download_to_callback(
+    const std::shared_ptr<DownloadToCallbackItem>& item,
+    const std::shared_ptr<ICurlWrapper>& curl_wrapper)
+{
+    bool success = curl_wrapper->download_to_callback(
+        item->get_url(), item->get_chunk_callback(), item->get_progress_callback());
+    return success;
+}
+
+bool HttpLoader::do_upload_stream(
+    const std::shared_ptr<UploadStreamItem>& item,
+    const std::shared_ptr<ICurlWrapper>& curl_wrapper)
+{
+    auto stream = item->get_stream();
+    auto read_callback = [stream](char* buffer, size_t size) -> size_t {
+        stream->read(buffer, static_cast<std::streamsize>(size));
+        return static_cast<size_t>(stream->gcount());
+    };
+
+    bool success = curl_wrapper->upload_from_callback(
+        item->get_target_url(),
+        item->get_filename(),
+        item->get_size(),
+        read_callback,
+        item->get_progress_callback());
+    return success;
+}
+
 bool HttpLoader::download_text_sync(const std::string& url, std::string& content)
 {
     bool success = _curl_wrapper->download_text(url, content);
     return success;
 }
 
+ConditionalDownloadResult HttpLoader::download_text_if_modified_sync(
+    const std::string& url, HttpValidators& validators, std::string& content)
+{
+    return _curl_wrapper->download_text_if_modified(url, validators, content);
+}
+
 } // namespace mavsdk
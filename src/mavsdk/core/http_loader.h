@@ -2,9 +2,12 @@
 
 #include <thread>
 #include <atomic>
+#include <istream>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <utility>
+#include <vector>
 #include "safe_queue.h"
 #include "curl_wrapper.h"
 
@@ -12,30 +15,63 @@ namespace mavsdk {
 
 class ICurlWrapper;
 
+// Runs downloads and uploads, the async ones on a few worker threads so that
+// several can be in progress at once. Connections are kept alive and shared
+// by all transfers, see CurlWrapper.
 class HttpLoader {
 public:
+    static constexpr unsigned DEFAULT_PARALLEL_TRANSFERS = 4;
+
 #ifdef TESTING
-    HttpLoader(const std::shared_ptr<ICurlWrapper>& curl_wrapper);
+    HttpLoader(
+        const std::shared_ptr<ICurlWrapper>& curl_wrapper,
+        unsigned parallel_transfers = DEFAULT_PARALLEL_TRANSFERS);
 #endif
 
-    explicit HttpLoader();
+    explicit HttpLoader(unsigned parallel_transfers = DEFAULT_PARALLEL_TRANSFERS);
     ~HttpLoader();
 
+    // The worker threads are only started once something async is queued,
+    // so a loader just used for sync transfers doesn't cost any threads.
     void start();
     void stop();
 
     bool download_sync(const std::string& url, const std::string& local_path);
     bool download_text_sync(const std::string& url, std::string& content);
+    // Only downloads the content if it changed since the validators were
+    // received, they are updated if it did.
+    ConditionalDownloadResult download_text_if_modified_sync(
+        const std::string& url, HttpValidators& validators, std::string& content);
     void download_async(
         const std::string& url,
         const std::string& local_path,
         const ProgressCallback& progress_callback = nullptr);
+    // Hands the content to chunk_callback as it arrives, so it never has to
+    // fit in memory at once.
+    bool download_to_callback_sync(const std::string& url, const ChunkCallback& chunk_callback);
+    void download_to_callback_async(
+        const std::string& url,
+        const ChunkCallback& chunk_callback,
+        const ProgressCallback& progress_callback = nullptr);
 
     bool upload_sync(const std::string& target_url, const std::string& local_path);
     void upload_async(
         const std::string& target_url,
         const std::string& local_path,
         const ProgressCallback& progress_callback = nullptr);
+    // Uploads size bytes read from stream as a file called filename, reading
+    // only as much at a time as curl sends.
+    bool upload_stream_sync(
+        const std::string& target_url,
+        const std::string& filename,
+        std::istream& stream,
+        size_t size);
+    void upload_stream_async(
+        const std::string& target_url,
+        const std::string& filename,
+        std::shared_ptr<std::istream> stream,
+        size_t size,
+        const ProgressCallback& progress_callback = nullptr);
 
     // Non-copyable
     HttpLoader(const HttpLoader&) = delete;
@@ -115,6 +151,70 @@ private:
         ProgressCallback _progress_callback{};
     };
 
+    class DownloadToCallbackItem : public WorkItem {
+    public:
+        DownloadToCallbackItem(
+            std::string url, ChunkCallback chunk_callback, ProgressCallback progress_callback) :
+            _url(std::move(url)),
+            _chunk_callback(std::move(chunk_callback)),
+            _progress_callback(std::move(progress_callback))
+        {}
+
+        virtual ~DownloadToCallbackItem() = default;
+
+        [[nodiscard]] std::string get_url() const { return _url; }
+
+        [[nodiscard]] const ChunkCallback& get_chunk_callback() const { return _chunk_callback; }
+
+        [[nodiscard]] ProgressCallback get_progress_callback() const { return _progress_callback; }
+
+        DownloadToCallbackItem(DownloadToCallbackItem&) = delete;
+        DownloadToCallbackItem operator=(DownloadToCallbackItem&) = delete;
+
+    private:
+        std::string _url;
+        ChunkCallback _chunk_callback{};
+        ProgressCallback _progress_callback{};
+    };
+
+    class UploadStreamItem : public WorkItem {
+    public:
+        UploadStreamItem(
+            std::string target_url,
+            std::string filename,
+            std::shared_ptr<std::istream> stream,
+            size_t size,
+            ProgressCallback progress_callback) :
+            _target_url(std::move(target_url)),
+            _filename(std::move(filename)),
+            _stream(std::move(stream)),
+            _size(size),
+            _progress_callback(std::move(progress_callback))
+        {}
+
+        virtual ~UploadStreamItem() = default;
+
+        [[nodiscard]] std::string get_target_url() const { return _target_url; }
+
+        [[nodiscard]] std::string get_filename() const { return _filename; }
+
+        [[nodiscard]] std::shared_ptr<std::istream> get_stream() const { return _stream; }
+
+        [[nodiscard]] size_t get_size() const { return _size; }
+
+        [[nodiscard]] ProgressCallback get_progress_callback() const { return _progress_callback; }
+
+        UploadStreamItem(UploadStreamItem&) = delete;
+        UploadStreamItem operator=(UploadStreamItem&) = delete;
+
+    private:
+        std::string _target_url;
+        std::string _filename;
+        std::shared_ptr<std::istream> _stream;
+        size_t _size;
+        ProgressCallback _progress_callback{};
+    };
+
     static void work_thread(HttpLoader* self);
     static void do_item(
         const std::shared_ptr<WorkItem>& item, const std::shared_ptr<ICurlWrapper>& curl_wrapper);
@@ -123,11 +223,19 @@ private:
         const std::shared_ptr<ICurlWrapper>& curl_wrapper);
     static bool do_upload(
         const std::shared_ptr<UploadItem>& item, const std::shared_ptr<ICurlWrapper>& curl_wrapper);
+    static bool do_download_to_callback(
+        const std::shared_ptr<DownloadToCallbackItem>& item,
+        const std::shared_ptr<ICurlWrapper>& curl_wrapper);
+    static bool do_upload_stream(
+        const std::shared_ptr<UploadStreamItem>& item,
+        const std::shared_ptr<ICurlWrapper>& curl_wrapper);
 
     std::shared_ptr<ICurlWrapper> _curl_wrapper;
 
     SafeQueue<std::shared_ptr<WorkItem>> _work_queue{};
-    std::thread* _work_thread = nullptr;
+    const unsigned _parallel_transfers;
+    std::mutex _work_threads_mutex{};
+    std::vector<std::thread> _work_threads{}; // Needs _work_threads_mutex
 
     std::atomic<bool> _should_exit{false};
 };
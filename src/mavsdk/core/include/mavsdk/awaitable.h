@@ -0,0 +1,134 @@
+#pragma once
+
+// The awaitable wrappers are only there when building as C++20 or later, so
+// nothing changes for C++17 users.
+#if __cplusplus >= 202002L && defined(__has_include)
+#if __has_include(<coroutine>)
+#include <coroutine>
+#define MAVSDK_HAS_COROUTINES 1
+#endif
+#endif
+
+#ifdef MAVSDK_HAS_COROUTINES
+
+#include <functional>
+#include <memory>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace mavsdk {
+
+/**
+ * @brief Runs a function, e.g. by posting it to an event loop or a thread pool.
+ */
+using Executor = std::function<void(std::function<void()>)>;
+
+template<typename Callback> class Awaitable;
+
+namespace detail {
+
+template<typename... Args> struct AwaitableValue {
+    using Type = std::tuple<Args...>;
+};
+
+template<typename Arg> struct AwaitableValue<Arg> {
+    using Type = Arg;
+};
+
+template<typename First, typename Second> struct AwaitableValue<First, Second> {
+    using Type = std::pair<First, Second>;
+};
+
+} // namespace detail
+
+/**
+ * @brief An asynchronous call that can be awaited in a C++20 coroutine.
+ *
+ * The call is started once awaited. The coroutine is resumed when the callback
+ * of the call is called, using the executor if one is given, otherwise right
+ * on the thread calling the callback.
+ *
+ * The result is what the blocking counterpart of the call returns: the single
+ * callback argument, a std::pair for two of them, or a std::tuple for more.
+ */
+template<typename... Args> class Awaitable<std::function<void(Args...)>> {
+public:
+    /**
+     * @brief Callback type of the asynchronous call.
+     */
+    using Callback = std::function<void(Args...)>;
+
+    /**
+     * @brief Type returned by co_await.
+     */
+    using Value = typename detail::AwaitableValue<std::decay_t<Args>...>::Type;
+
+    /**
+     * @brief Constructor.
+     *
+     * @param start Function starting the call with the callback given.
+     * @param executor Executor to resume on, or empty to resume on the callback thread.
+     */
+    explicit Awaitable(std::function<void(const Callback&)> start, Executor executor = {}) :
+        _start(std::move(start)),
+        _state(std::make_shared<State>())
+    {
+        _state->executor = std::move(executor);
+    }
+
+    /**
+     * @brief Always suspends, the call is only started then.
+     */
+    bool await_ready() const noexcept { return false; }
+
+    /**
+     * @brief Starts the call and resumes once it is done.
+     */
+    void await_suspend(std::coroutine_handle<> handle)
+    {
+        // The callback might be called before start returns, and the coroutine
+        // might even be done by then, so nothing of this object can be used
+        // after starting the call.
+        auto start = std::move(_start);
+        auto state = _state;
+
+        start([state, handle](Args... args) {
+            state->value.emplace(std::forward<Args>(args)...);
+            if (state->executor) {
+                state->executor([handle]() { handle.resume(); });
+            } else {
+                handle.resume();
+            }
+        });
+    }
+
+    /**
+     * @brief Returns the result of the call.
+     */
+    Value await_resume()
+    {
+        auto& value = *_state->value;
+        if constexpr (sizeof...(Args) == 1) {
+            return std::move(std::get<0>(value));
+        } else if constexpr (sizeof...(Args) == 2) {
+            return {std::move(std::get<0>(value)), std::move(std::get<1>(value))};
+        } else {
+            return std::move(value);
+        }
+    }
+
+private:
+    struct State {
+        Executor executor{};
+        std::optional<std::tuple<std::decay_t<Args>...>> value{};
+    };
+
+    std::function<void(const Callback&)> _start;
+    std::shared_ptr<State> _state;
+};
+
+} // namespace mavsdk
+
+#endif
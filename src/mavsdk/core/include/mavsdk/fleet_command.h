@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+
+namespace mavsdk {
+
+/**
+ * @brief A command (MAVLink COMMAND_LONG) to send to several systems at once.
+ *
+ * Params left at NAN are reserved, and sent the way each autopilot expects.
+ */
+struct FleetCommand {
+    uint16_t command{0}; /**< @brief Command ID (MAV_CMD). */
+    uint8_t target_component_id{1}; /**< @brief Component to send to, the autopilot by default. */
+    float param1{NAN}; /**< @brief Param 1. */
+    float param2{NAN}; /**< @brief Param 2. */
+    float param3{NAN}; /**< @brief Param 3. */
+    float param4{NAN}; /**< @brief Param 4. */
+    float param5{NAN}; /**< @brief Param 5. */
+    float param6{NAN}; /**< @brief Param 6. */
+    float param7{NAN}; /**< @brief Param 7. */
+};
+
+/**
+ * @brief How a system responded to a fleet command.
+ */
+enum class FleetCommandResult {
+    Success, /**< @brief Accepted. */
+    NoSystem, /**< @brief The system is not connected. */
+    ConnectionError, /**< @brief The command could not be sent. */
+    Denied, /**< @brief Denied. */
+    Unsupported, /**< @brief Not supported. */
+    TemporarilyRejected, /**< @brief Rejected for now, try again later. */
+    Failed, /**< @brief Accepted but failed. */
+    Cancelled, /**< @brief Cancelled. */
+    Timeout, /**< @brief No answer, even after retrying. */
+    Unknown, /**< @brief Answered with an unknown result. */
+};
+
+/**
+ * @brief The response of one system to a fleet command.
+ */
+struct FleetCommandOutcome {
+    uint8_t system_id{0}; /**< @brief ID of the system. */
+    FleetCommandResult result{FleetCommandResult::Unknown}; /**< @brief Its response. */
+};
+
+} // namespace mavsdk
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace mavsdk {
+
+/**
+ * @brief A mission item as transferred with MAVLink (MISSION_ITEM_INT).
+ */
+struct FleetMissionItem {
+    uint16_t seq{0}; /**< @brief Sequence number, starting at 0. */
+    uint8_t frame{0}; /**< @brief Coordinate frame (MAV_FRAME). */
+    uint16_t command{0}; /**< @brief Command ID (MAV_CMD). */
+    uint8_t current{0}; /**< @brief 1 for the current item. */
+    uint8_t autocontinue{0}; /**< @brief 1 to continue with the next item once done. */
+    float param1{0.0f}; /**< @brief Param 1. */
+    float param2{0.0f}; /**< @brief Param 2. */
+    float param3{0.0f}; /**< @brief Param 3. */
+    float param4{0.0f}; /**< @brief Param 4. */
+    int32_t x{0}; /**< @brief Param 5, latitude in degrees * 1e7 for global frames. */
+    int32_t y{0}; /**< @brief Param 6, longitude in degrees * 1e7 for global frames. */
+    float z{0.0f}; /**< @brief Param 7, altitude in meters for global frames. */
+    uint8_t mission_type{0}; /**< @brief Mission type (MAV_MISSION_TYPE). */
+};
+
+/**
+ * @brief Result of the mission transfer of one system.
+ */
+enum class FleetMissionResult {
+    Success, /**< @brief Transferred. */
+    NoSystem, /**< @brief The system is not connected. */
+    ConnectionError, /**< @brief The requests could not be sent. */
+    Denied, /**< @brief Denied by the system. */
+    Timeout, /**< @brief No answer, even after retrying. */
+    Unsupported, /**< @brief Not supported by the system. */
+    NoMissionAvailable, /**< @brief The system has no mission. */
+    Cancelled, /**< @brief Cancelled. */
+    ProtocolError, /**< @brief The system did not follow the protocol. */
+    Unknown, /**< @brief Another error. */
+};
+
+/**
+ * @brief The mission of one system, after transferring it.
+ */
+struct FleetMissionOutcome {
+    uint8_t system_id{0}; /**< @brief ID of the system. */
+    FleetMissionResult result{FleetMissionResult::Unknown}; /**< @brief Result of the transfer. */
+    std::vector<FleetMissionItem> items{}; /**< @brief Mission items, if downloaded. */
+};
+
+/**
+ * @brief Where one system is in its mission, as MAVLink sequence numbers.
+ */
+struct FleetMissionState {
+    uint8_t system_id{0}; /**< @brief ID of the system. */
+    int32_t current_seq{-1}; /**< @brief Current item (MISSION_CURRENT), -1 if unknown. */
+    int32_t reached_seq{-1}; /**< @brief Last reached item (MISSION_ITEM_REACHED), -1 if none. */
+};
+
+} // namespace mavsdk
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <variant>
+#include <vector>
+
+namespace mavsdk {
+
+/**
+ * @brief A parameter to set or get on several systems at once.
+ */
+struct FleetParam {
+    std::string name{}; /**< @brief Name of the parameter. */
+    /** @brief Value to set, or the type expected when getting it. */
+    std::variant<int32_t, float> value{};
+};
+
+/**
+ * @brief Result of setting or getting one parameter on one system.
+ */
+enum class FleetParamResult {
+    Success, /**< @brief Set or got. */
+    NoSystem, /**< @brief The system is not connected. */
+    Timeout, /**< @brief No answer, even after retrying. */
+    ConnectionError, /**< @brief The request could not be sent. */
+    WrongType, /**< @brief The parameter has another type. */
+    ParamNameTooLong, /**< @brief The name is longer than 16 characters. */
+    NotFound, /**< @brief The system has no such parameter. */
+    ValueUnsupported, /**< @brief The value is not supported. */
+    Failed, /**< @brief Failed. */
+    Unknown, /**< @brief Unknown error. */
+};
+
+/**
+ * @brief The parameters of one system, after setting or getting them.
+ */
+struct FleetParamOutcome {
+    uint8_t system_id{0}; /**< @brief ID of the system. */
+    /** @brief Result per parameter, in the order they were given. */
+    std::vector<FleetParamResult> results{};
+    /** @brief The parameters as set, or as got where successful. */
+    std::vector<FleetParam> params{};
+};
+
+} // namespace mavsdk
@@ -0,0 +1,38 @@
+#pragma once
+
+namespace mavsdk {
+
+/**
+ * @brief An offboard setpoint of one system in a formation, in local NED coordinates.
+ */
+struct FleetSetpoint {
+    /**
+     * @brief What the setpoint sets.
+     */
+    enum class Type {
+        PositionNed, /**< @brief Position and yaw. */
+        VelocityNed, /**< @brief Velocity and yaw. */
+        PositionVelocityNed, /**< @brief Position and yaw, with the velocity as feed-forward. */
+    };
+
+    Type type{Type::PositionNed}; /**< @brief What the setpoint sets. */
+    float north_m{0.0f}; /**< @brief Position North (in metres). */
+    float east_m{0.0f}; /**< @brief Position East (in metres). */
+    float down_m{0.0f}; /**< @brief Position Down (in metres). */
+    float north_m_s{0.0f}; /**< @brief Velocity North (in metres/second). */
+    float east_m_s{0.0f}; /**< @brief Velocity East (in metres/second). */
+    float down_m_s{0.0f}; /**< @brief Velocity Down (in metres/second). */
+    float yaw_deg{0.0f}; /**< @brief Yaw in degrees (0 North, positive is clock-wise). */
+};
+
+/**
+ * @brief Result of setting the setpoints of a formation.
+ */
+enum class FleetSetpointResult {
+    Success, /**< @brief Set, and sent. */
+    NoSystem, /**< @brief A system is not connected, nothing was set. */
+    ConnectionError, /**< @brief The setpoints could not be sent. */
+    InvalidArgument, /**< @brief A system is given twice, or the rate is out of range. */
+};
+
+} // namespace mavsdk
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <vector>
+
 namespace mavsdk::geometry {
 
 /**
@@ -29,6 +31,26 @@ public:
         double east_m; /**< @brief Position in East direction in meters. */
     };
 
+    /**
+     * @brief Type for many global coordinates, with latitudes and longitudes in separate arrays.
+     *
+     * Both arrays need to be of the same size.
+     */
+    struct GlobalCoordinates {
+        std::vector<double> latitude_deg; /**< @brief Latitudes in degrees. */
+        std::vector<double> longitude_deg; /**< @brief Longitudes in degrees. */
+    };
+
+    /**
+     * @brief Type for many local coordinates, with north and east in separate arrays.
+     *
+     * Both arrays need to be of the same size.
+     */
+    struct LocalCoordinates {
+        std::vector<double> north_m; /**< @brief Positions in North direction in meters. */
+        std::vector<double> east_m; /**< @brief Positions in East direction in meters. */
+    };
+
     /**
      * @brief Default constructor not available.
      */
@@ -55,6 +77,30 @@ public:
      */
     [[nodiscard]] GlobalCoordinate global_from_local(LocalCoordinate local_coordinate) const;
 
+    /**
+     * @brief Calculate local coordinates from many global coordinates at once.
+     *
+     * This is faster than converting one coordinate after the other, e.g. for a whole survey
+     * grid. The results are the same.
+     *
+     * @param global_coordinates The global coordinates to project from.
+     * @param local_coordinates The local coordinates, resized as needed.
+     */
+    void local_from_global(
+        const GlobalCoordinates& global_coordinates, LocalCoordinates& local_coordinates) const;
+
+    /**
+     * @brief Calculate global coordinates from many local coordinates at once.
+     *
+     * This is faster than converting one coordinate after the other, e.g. for a whole survey
+     * grid. The results are the same.
+     *
+     * @param local_coordinates The local coordinates to project from.
+     * @param global_coordinates The global coordinates, resized as needed.
+     */
+    void global_from_local(
+        const LocalCoordinates& local_coordinates, GlobalCoordinates& global_coordinates) const;
+
     /**
      * @brief Destructor.
      */
@@ -63,6 +109,8 @@ public:
 private:
     double _ref_lat_rad;
     double _ref_lon_rad;
+    double _ref_sin_lat;
+    double _ref_cos_lat;
     static constexpr double world_radius_m{6371000.0};
 };
 
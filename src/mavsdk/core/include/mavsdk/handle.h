@@ -7,6 +7,7 @@ namespace mavsdk {
 template<typename... Args> class CallbackListImpl;
 template<typename... Args> class CallbackList;
 template<typename... Args> class FakeHandle;
+class MessageInterceptors;
 
 /**
  * @brief A handle returned from subscribe which allows to unsubscribe again.
@@ -22,6 +23,7 @@ private:
 
     friend CallbackListImpl<Args...>;
     friend FakeHandle<Args...>;
+    friend MessageInterceptors;
 };
 
 } // namespace mavsdk
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstdint>
+
+namespace mavsdk {
+
+/**
+ * @brief How a link is degraded on purpose, e.g. to test transfers against
+ * the conditions of a telemetry radio.
+ *
+ * Everything is off by default.
+ */
+struct LinkEmulation {
+    double loss_ratio{0.0}; /**< @brief Share of frames lost, from 0 to 1. */
+    double latency_s{0.0}; /**< @brief Time each frame takes, in seconds. */
+    double jitter_s{0.0}; /**< @brief Random extra time each frame takes, up to this. */
+    double bandwidth_bytes_per_s{0.0}; /**< @brief Bandwidth of the link, 0 for unlimited. */
+    double reorder_ratio{0.0}; /**< @brief Share of frames overtaken by later ones, 0 to 1. */
+    uint32_t seed{0}; /**< @brief Seed of the randomness, the same seed gives the same link. */
+};
+
+} // namespace mavsdk
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace mavsdk {
+
+/**
+ * @brief Statistics of the messages received on one connection.
+ */
+struct LinkStats {
+    /**
+     * @brief Statistics of one component heard on the connection.
+     *
+     * These are based on the sequence number of the MAVLink messages.
+     */
+    struct Remote {
+        uint8_t system_id{0}; /**< @brief System ID of the sender. */
+        uint8_t component_id{0}; /**< @brief Component ID of the sender. */
+        uint64_t received_count{0}; /**< @brief Messages received, including duplicates. */
+        uint64_t lost_count{0}; /**< @brief Messages missing in the sequence. */
+        uint64_t duplicate_count{0}; /**< @brief Messages received more than once. */
+        uint64_t reordered_count{0}; /**< @brief Messages received out of order. */
+        float loss_ratio{0.0f}; /**< @brief Ratio of messages lost in the last interval. */
+    };
+
+    unsigned connection_index{0}; /**< @brief Index of the connection in the order added. */
+    uint64_t received_bytes{0}; /**< @brief Bytes of all messages received. */
+    uint64_t parse_errors{0}; /**< @brief Frames dropped, e.g. because of a bad checksum. */
+    double received_bytes_per_s{0.0}; /**< @brief Bytes received per second in the last interval. */
+    uint64_t receive_queue_dropped{0}; /**< @brief Messages dropped because the receive queue was
+                                          full, see Mavsdk::set_receive_queue. */
+    size_t receive_queue_max_depth{0}; /**< @brief Highest number of messages queued at once. */
+    std::vector<Remote> remotes{}; /**< @brief Components heard on the connection. */
+};
+
+} // namespace mavsdk
@@ -17,4 +17,11 @@ using Callback =
 extern Callback& get_callback();
 extern void subscribe(const Callback& callback);
 
+/** @brief Write the default log output from a background thread instead of
+ * the thread logging, so that logging doesn't block e.g. receiving messages.
+ * Lines may be dropped if they come in faster than they can be written.
+ * The callback set using subscribe is still called by the thread logging.
+ */
+extern void set_async(bool enabled);
+
 } // namespace mavsdk::log
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
 #include <string>
 #include <memory>
 #include <optional>
@@ -7,7 +10,17 @@
 #include <functional>
 
 #include "deprecated.h"
+#include "fleet_command.h"
+#include "fleet_mission.h"
+#include "fleet_param.h"
+#include "fleet_setpoint.h"
+#include "link_emulation.h"
 #include "handle.h"
+#include "link_stats.h"
+#include "memory_usage.h"
+#include "message_stats.h"
+#include "thread_settings.h"
+#include "tlog_filter.h"
 #include "system.h"
 #include "server_component.h"
 #include "connection_result.h"
@@ -45,17 +58,93 @@ public:
     static constexpr auto DEFAULT_TCP_REMOTE_IP = "127.0.0.1";
     /** @brief Default TCP remote port. */
     static constexpr int DEFAULT_TCP_REMOTE_PORT = 5760;
+    /** @brief Default TCP server bind IP (accepts clients on any interface). */
+    static constexpr auto DEFAULT_TCP_SERVER_BIND_IP = "0.0.0.0";
+    /** @brief Default TCP server port. */
+    static constexpr int DEFAULT_TCP_SERVER_PORT = 5760;
     /** @brief Default serial baudrate. */
     static constexpr int DEFAULT_SERIAL_BAUDRATE = 57600;
 
     /** @brief Default internal timeout in seconds. */
     static constexpr double DEFAULT_TIMEOUT_S = 0.5;
 
+    /**
+     * @brief What to do with user callbacks when the callback queue is full.
+     */
+    enum class CallbackOverflowPolicy {
+        DropNewest, /**< @brief Drop the callback that doesn't fit anymore. */
+        DropOldest, /**< @brief Drop the oldest queued callback to make space. */
+        CoalesceByKey, /**< @brief Replace a queued callback of the same subscription if
+                          possible, otherwise drop the new one. */
+    };
+
+    /**
+     * @brief What to do with received messages when the receive queue is full.
+     */
+    enum class ReceiveQueueOverflowPolicy {
+        DropNewest, /**< @brief Drop the message that doesn't fit anymore. */
+        DropOldest, /**< @brief Drop the oldest queued message to make space. */
+    };
+
+    /**
+     * @brief Options for the queue that all user callbacks go through.
+     *
+     * By default all callbacks are called from one thread. With more threads,
+     * each system and server component is assigned to one of them, so a slow
+     * callback only holds up callbacks of the same system.
+     *
+     * Results, e.g. of commands, are called before any other callbacks, and
+     * telemetry updates only once nothing else is queued, so a result never
+     * waits behind a backlog of telemetry. Each of the three has its own
+     * capacity. Callbacks of the same kind of one system are called in order.
+     */
+    struct CallbackQueueOptions {
+        size_t capacity{100}; /**< @brief Maximum number of queued callbacks per thread, other
+                                 than results and telemetry. */
+        CallbackOverflowPolicy overflow_policy{
+            CallbackOverflowPolicy::DropNewest}; /**< @brief What to do when it is full. */
+        unsigned num_threads{1}; /**< @brief Number of threads calling callbacks. */
+        size_t control_capacity{100}; /**< @brief Maximum number of queued results, e.g. of
+                                         commands, per thread. */
+        size_t telemetry_capacity{100}; /**< @brief Maximum number of queued telemetry updates
+                                           per thread. */
+    };
+
+    /**
+     * @brief Counters of the user callback queue.
+     */
+    struct CallbackQueueStats {
+        uint64_t enqueued{0}; /**< @brief Number of callbacks queued. */
+        uint64_t dropped{0}; /**< @brief Number of callbacks dropped because it was full. */
+        uint64_t coalesced{0}; /**< @brief Number of callbacks that replaced a queued one. */
+        size_t depth{0}; /**< @brief Number of callbacks queued right now. */
+        size_t max_depth{0}; /**< @brief Highest number of callbacks queued at once. */
+        DurationHistogram wait_time{}; /**< @brief Time callbacks spent queued. */
+        DurationHistogram run_time{}; /**< @brief Time callbacks took to run. */
+    };
+
+    /**
+     * @brief Counters of the user callbacks called from one place in MAVSDK.
+     */
+    struct CallbackSiteStats {
+        std::string filename{}; /**< @brief Source file calling the callbacks. */
+        int linenumber{0}; /**< @brief Line in the source file. */
+        DurationHistogram wait_time{}; /**< @brief Time callbacks spent queued. */
+        DurationHistogram run_time{}; /**< @brief Time callbacks took to run. */
+    };
+
     /**
      * @brief Constructor.
      */
     Mavsdk();
 
+    /**
+     * @brief Constructor with custom user callback queue options.
+     *
+     * @param callback_queue_options Options for the user callback queue.
+     */
+    explicit Mavsdk(const CallbackQueueOptions& callback_queue_options);
+
     /**
      * @brief Destructor.
      *
@@ -75,11 +164,17 @@ public:
     /**
      * @brief Adds Connection via URL
      *
-     * Supports connection: Serial, TCP or UDP.
+     * Supports connection: Serial, TCP or UDP, replaying a tlog file, or a loopback
+     * to another instance in the same process.
      * Connection URL format should be:
      * - UDP:    udp://[host][:bind_port]
      * - TCP:    tcp://[host][:remote_port]
+     * - TCP server: tcpin://[bind_host][:bind_port], accepts any number of
+     *   clients, e.g. ground stations (not available on Windows)
      * - Serial: serial://dev_node[:baudrate]
+     * - Tlog:   tlog://file_path (original timing) or tlog_maxspeed://file_path
+     * - Loopback: loopback://name, to another Mavsdk instance in the same
+     *   process which adds a loopback connection with the same name
      *
      * For UDP, the host can be set to either:
      *   - zero IP: 0.0.0.0 -> behave like a server and listen for heartbeats.
@@ -264,11 +359,48 @@ public:
          */
         void set_usage_type(UsageType usage_type);
 
+        /**
+         * @brief Functions to allocate and free memory with.
+         *
+         * Both are called from any thread. To use a `std::pmr::memory_resource`,
+         * forward to its `allocate` and `deallocate`; it has to outlive the
+         * Mavsdk instance.
+         */
+        struct Allocator {
+            /** @brief Allocate bytes with an alignment, or return nullptr to use the default. */
+            std::function<void*(std::size_t bytes, std::size_t alignment)> allocate{};
+            /** @brief Free what allocate returned, called with the same size and alignment. */
+            std::function<void(void* pointer, std::size_t bytes, std::size_t alignment)>
+                deallocate{};
+        };
+
+        /**
+         * @brief Returns the allocator for a system, or an empty one for the default.
+         *
+         * System ID 0 is asked for what is shared by all systems, e.g. the
+         * handlers of incoming messages. This makes it possible to use
+         * pools per system and to measure how much each of them allocates.
+         */
+        using AllocatorFactory = std::function<Allocator(uint8_t system_id)>;
+
+        /**
+         * @brief Set the allocators of the containers on the message paths.
+         *
+         * @note This needs std::pmr, without it the allocators are ignored.
+         */
+        void set_allocator_factory(AllocatorFactory allocator_factory);
+
+        /**
+         * @brief Get the allocator factory, empty by default.
+         */
+        AllocatorFactory get_allocator_factory() const;
+
     private:
         uint8_t _system_id;
         uint8_t _component_id;
         bool _always_send_heartbeats;
         UsageType _usage_type;
+        AllocatorFactory _allocator_factory{};
 
         static Mavsdk::Configuration::UsageType usage_type_for_component(uint8_t component_id);
     };
@@ -294,6 +426,462 @@ public:
      */
     void set_timeout_s(double timeout_s);
 
+    /**
+     * @brief Set how long outgoing UDP messages can be held back to be sent together.
+     *
+     * Several MAVLink messages are then sent in one datagram, which reduces
+     * the number of syscalls and packets at the cost of some latency.
+     *
+     * The default is 0, meaning every message is sent immediately.
+     * This applies to UDP connections added afterwards.
+     *
+     * @param delay_s Maximum time a message is held back in seconds.
+     */
+    void set_udp_send_coalesce_delay_s(double delay_s);
+
+    /**
+     * @brief Set on how many threads incoming UDP messages are received and parsed.
+     *
+     * This is meant for ground stations with many vehicles sending to one
+     * port, where a single thread can't keep up. Each thread gets its own
+     * socket bound to the same port with SO_REUSEPORT, and the operating
+     * system picks the socket by the address of the sender, so messages
+     * from one vehicle still arrive in order.
+     *
+     * The default is 1. This applies to UDP connections added afterwards
+     * with a port other than 0, and is only supported on Linux.
+     *
+     * @param num_threads Number of receive threads per UDP connection.
+     */
+    void set_udp_receive_threads(unsigned num_threads);
+
+    /**
+     * @brief Limit the bandwidth used to send on each connection.
+     *
+     * This is meant for links with little bandwidth such as telemetry radios.
+     * Messages are then sent by priority: setpoints and heartbeats are never
+     * held back, commands go before telemetry, and bulk transfers such as
+     * parameters, missions, logs and files get what is left. If too much is
+     * queued, messages are dropped.
+     *
+     * The default is 0, meaning there is no limit.
+     * This applies to UDP, TCP and serial connections added afterwards.
+     *
+     * @param bytes_per_s Bandwidth budget per connection in bytes per second.
+     */
+    void set_bandwidth_limit(double bytes_per_s);
+
+    /**
+     * @brief Degrade the connections on purpose, e.g. to test or benchmark
+     * transfers against the loss, latency and bandwidth of a telemetry radio.
+     *
+     * Both directions are degraded the same way but independently. Use a
+     * seed to get the same link again.
+     *
+     * The default is no emulation.
+     * This applies to UDP, TCP, serial and loopback connections added afterwards.
+     *
+     * @param link_emulation How the links are degraded.
+     */
+    void set_link_emulation(const LinkEmulation& link_emulation);
+
+    /**
+     * @brief Handle received messages on a thread of their own per connection.
+     *
+     * By default, received messages are handled on the thread receiving
+     * them, so a slow handler holds up receiving, and the operating system
+     * drops what doesn't fit into its buffer in the meantime. With a receive
+     * queue, the receive thread only parses messages and queues them, and
+     * the messages dropped because the queue was full are counted in the
+     * link stats.
+     *
+     * The default is 0, meaning there is no queue.
+     * This applies to connections added afterwards, apart from tlog replays.
+     *
+     * @param capacity Maximum number of queued messages per connection.
+     * @param overflow_policy What to do when it is full.
+     */
+    void set_receive_queue(
+        size_t capacity,
+        ReceiveQueueOverflowPolicy overflow_policy = ReceiveQueueOverflowPolicy::DropNewest);
+
+    /**
+     * @brief Receive on one shared thread for all UDP and serial connections.
+     *
+     * By default, every connection has its own receive thread. With many
+     * connections, e.g. a ground station with dozens of radios, a single
+     * thread waiting for all of them is cheaper.
+     *
+     * This is only supported on Linux and macOS, and applies to connections
+     * added afterwards. TCP connections always use their own thread.
+     *
+     * @param enabled Whether new connections use the shared receive thread.
+     */
+    void set_shared_receive_thread_enabled(bool enabled);
+
+    /**
+     * @brief Receive on UDP connections with io_uring, on one shared thread.
+     *
+     * This is meant for gateways terminating thousands of datagrams per
+     * second: the kernel receives into buffers registered up front, and
+     * whole batches of datagrams are picked up with one syscall.
+     *
+     * This needs Linux 6.0 or newer, and applies to UDP connections added
+     * afterwards. Where it isn't supported, this does nothing and the
+     * connections receive like before.
+     *
+     * @param enabled Whether new UDP connections receive with io_uring.
+     */
+    void set_io_uring_enabled(bool enabled);
+
+    /**
+     * @brief Do the background work of all systems on one shared thread.
+     *
+     * By default, every discovered system has its own thread for sending
+     * pings and retrying commands, parameter and mission transfers. When
+     * monitoring a swarm of vehicles, one thread for all of them is cheaper.
+     *
+     * This applies to systems discovered afterwards.
+     *
+     * @param enabled Whether new systems use the shared thread.
+     */
+    void set_shared_system_thread_enabled(bool enabled);
+
+    /**
+     * @brief Set the name, CPUs and real-time priority of the threads of a role.
+     *
+     * This is meant for companion computers shared with other heavy work,
+     * e.g. to keep receiving and streaming setpoints on CPUs of their own
+     * with a real-time priority, so they are not preempted.
+     *
+     * The settings are the same for all Mavsdk instances of the process, and
+     * apply to threads started afterwards. The work and user callback
+     * threads are started when the Mavsdk instance is created, so set them
+     * before.
+     *
+     * @param role The threads to set it for.
+     * @param settings How these threads run.
+     */
+    static void set_thread_settings(ThreadRole role, const ThreadSettings& settings);
+
+    /**
+     * @brief Start recording what happens on which thread.
+     *
+     * This records timers, message dispatch, reads of connections, user
+     * callbacks and the steps of mission, param and FTP transfers, to find
+     * out where latency comes from. What was recorded before is discarded.
+     *
+     * Tracing is off by default and costs next to nothing while off.
+     *
+     * @param events_per_thread How many of the latest events each thread keeps.
+     */
+    static void start_tracing(size_t events_per_thread = 65536);
+
+    /**
+     * @brief Stop recording and write what was recorded to a file.
+     *
+     * The file is in the Chrome trace event format, which chrome://tracing
+     * and https://ui.perfetto.dev open.
+     *
+     * @param path The file to write.
+     * @return true if the file was written.
+     */
+    static bool stop_tracing(const std::string& path);
+
+    /**
+     * @brief Callback type for send_fleet_command_async.
+     *
+     * Gets the outcome of every system, in the order they were given.
+     */
+    using FleetCommandCallback = std::function<void(std::vector<FleetCommandOutcome>)>;
+
+    /**
+     * @brief Send the same command to several systems, e.g. to arm a fleet.
+     *
+     * The command is sent to all of them at once, and only sent again to
+     * the ones which haven't answered in time. The callback is called once
+     * all of them have answered or timed out.
+     *
+     * @param systems Systems to send the command to.
+     * @param command Command to send.
+     * @param callback Called with the outcome of every system.
+     */
+    void send_fleet_command_async(
+        const std::vector<std::shared_ptr<System>>& systems,
+        const FleetCommand& command,
+        const FleetCommandCallback& callback);
+
+    /**
+     * @brief Callback type for set_fleet_params_async and get_fleet_params_async.
+     *
+     * Gets the outcome of every system, in the order they were given.
+     */
+    using FleetParamsCallback = std::function<void(std::vector<FleetParamOutcome>)>;
+
+    /**
+     * @brief Set the same parameters on several systems, e.g. to push a
+     * config change to a fleet.
+     *
+     * All systems are set in parallel, with several parameters in flight
+     * per system. The callback is called once all of them are done.
+     *
+     * @param systems Systems to set the parameters on.
+     * @param params Parameters to set.
+     * @param callback Called with the outcome of every system.
+     */
+    void set_fleet_params_async(
+        const std::vector<std::shared_ptr<System>>& systems,
+        const std::vector<FleetParam>& params,
+        const FleetParamsCallback& callback);
+
+    /**
+     * @brief Get the same parameters from several systems.
+     *
+     * All systems are asked in parallel, with several parameters in flight
+     * per system. The callback is called once all of them are done.
+     *
+     * @param systems Systems to get the parameters from.
+     * @param params Parameters to get, with the type they are expected to have.
+     * @param callback Called with the outcome of every system.
+     */
+    void get_fleet_params_async(
+        const std::vector<std::shared_ptr<System>>& systems,
+        const std::vector<FleetParam>& params,
+        const FleetParamsCallback& callback);
+
+    /**
+     * @brief Callback type for the progress of a fleet mission transfer.
+     *
+     * Gets the progress of all systems together, from 0 to 1.
+     */
+    using FleetMissionProgressCallback = std::function<void(float progress)>;
+
+    /**
+     * @brief Callback type for fleet mission transfers.
+     *
+     * Gets the outcome of every system, in the order they were given.
+     */
+    using FleetMissionCallback = std::function<void(std::vector<FleetMissionOutcome>)>;
+
+    /**
+     * @brief Download the missions of several systems, e.g. to verify them
+     * before takeoff.
+     *
+     * Several downloads run at the same time, so that the links are used
+     * well without flooding them.
+     *
+     * @param systems Systems to download the mission from.
+     * @param max_parallel Number of downloads running at the same time.
+     * @param progress_callback Called with the progress of all downloads together.
+     * @param callback Called with the outcome of every system once all are done.
+     */
+    void download_fleet_missions_async(
+        const std::vector<std::shared_ptr<System>>& systems,
+        unsigned max_parallel,
+        const FleetMissionProgressCallback& progress_callback,
+        const FleetMissionCallback& callback);
+
+    /**
+     * @brief Upload a mission to each of several systems.
+     *
+     * Several uploads run at the same time, so that the links are used well
+     * without flooding them.
+     *
+     * @param missions Systems with the mission to upload to each of them.
+     * @param max_parallel Number of uploads running at the same time.
+     * @param progress_callback Called with the progress of all uploads together.
+     * @param callback Called with the outcome of every system once all are done.
+     */
+    void upload_fleet_missions_async(
+        const std::vector<std::pair<std::shared_ptr<System>, std::vector<FleetMissionItem>>>&
+            missions,
+        unsigned max_parallel,
+        const FleetMissionProgressCallback& progress_callback,
+        const FleetMissionCallback& callback);
+
+    /**
+     * @brief Callback type for subscribe_fleet_mission_states.
+     */
+    using FleetMissionStatesCallback = std::function<void(std::vector<FleetMissionState>)>;
+
+    /**
+     * @brief Handle type to unsubscribe from subscribe_fleet_mission_states.
+     */
+    using FleetMissionStatesHandle = Handle<std::vector<FleetMissionState>>;
+
+    /**
+     * @brief Subscribe to where all systems are in their missions.
+     *
+     * The states of all systems are delivered together, but only once one
+     * of them changed, so it stays cheap to follow many missions at once,
+     * e.g. on a dashboard. MISSION_CURRENT is usually streamed, but only
+     * changes are reported.
+     *
+     * @param callback Callback to subscribe.
+     *
+     * @return A handle to unsubscribe again.
+     */
+    FleetMissionStatesHandle
+    subscribe_fleet_mission_states(const FleetMissionStatesCallback& callback);
+
+    /**
+     * @brief Unsubscribe from subscribe_fleet_mission_states.
+     *
+     * @param handle Handle received on subscription.
+     */
+    void unsubscribe_fleet_mission_states(FleetMissionStatesHandle handle);
+
+    /**
+     * @brief Set the offboard setpoints of a formation, e.g. for formation flight.
+     *
+     * The setpoints of all systems are sent right away, and then again at
+     * the setpoint rate until the next call, all on the same tick and in as
+     * few writes per link as possible. This replaces calling
+     * Offboard::set_position_ned() etc. on each system.
+     *
+     * Offboard mode still needs to be started on each system, e.g. with
+     * send_fleet_command_async(), once the setpoints are sent.
+     *
+     * @param setpoints Systems with the setpoint of each of them, an empty
+     * list stops sending.
+     * @return Result of request.
+     */
+    FleetSetpointResult set_fleet_setpoints(
+        const std::vector<std::pair<std::shared_ptr<System>, FleetSetpoint>>& setpoints);
+
+    /**
+     * @brief Set the rate at which the fleet setpoints are sent (20 Hz by default).
+     *
+     * @param rate_hz Rate in Hz, up to 1000 Hz.
+     * @return Result of request.
+     */
+    FleetSetpointResult set_fleet_setpoint_rate(double rate_hz);
+
+    /**
+     * @brief Stop sending the fleet setpoints.
+     */
+    void stop_fleet_setpoints();
+
+    /**
+     * @brief Record all received and sent messages to a telemetry log (tlog).
+     *
+     * The file is written by a background thread, and appended to if it
+     * exists. It can be replayed using a tlog:// connection.
+     *
+     * @param path Path of the tlog file.
+     * @return true if the file could be opened.
+     */
+    bool start_tlog_recording(const std::string& path);
+
+    /**
+     * @brief Record the received and sent messages passing a filter to a
+     * telemetry log (tlog).
+     *
+     * Like start_tlog_recording(path), but messages filtered out are skipped
+     * before they are serialized, which keeps recording cheap when only a few
+     * messages of a busy link are of interest.
+     *
+     * @param path Path of the tlog file.
+     * @param filter Which messages are recorded.
+     * @return true if the file could be opened.
+     */
+    bool start_tlog_recording(const std::string& path, const TlogFilter& filter);
+
+    /**
+     * @brief Stop recording started with start_tlog_recording.
+     */
+    void stop_tlog_recording();
+
+    /**
+     * @brief Bytes dropped by the current tlog recording.
+     *
+     * Messages are dropped rather than blocking when the disk can't keep up.
+     *
+     * @return Bytes dropped, 0 when not recording.
+     */
+    uint64_t tlog_dropped_bytes() const;
+
+    /**
+     * @brief Keep the parameters of PX4 autopilots in a directory.
+     *
+     * The parameters are stored per autopilot, identified by its UID. On the
+     * next connection, they are only downloaded again if the _HASH_CHECK
+     * reported by the autopilot changed.
+     *
+     * The version and identification reported to Info are kept there as well,
+     * so they are available right away on the next connection, until the
+     * autopilot has answered again.
+     *
+     * Everything is kept in one file, mavsdk.state, which is only written
+     * by one Mavsdk instance at a time.
+     *
+     * @param directory Existing directory for the cache, empty to disable it.
+     */
+    void set_param_cache_directory(const std::string& directory);
+
+    /**
+     * @brief Sign all sent messages and only accept signed messages.
+     *
+     * This uses MAVLink 2 message signing, see
+     * https://mavlink.io/en/guide/message_signing.html. Received messages
+     * with an invalid signature, or which have been received before, are
+     * dropped. Only RADIO_STATUS messages are accepted unsigned, as radios
+     * don't know the key. Forwarded messages are left as they are.
+     *
+     * @param secret_key The key shared by all systems.
+     */
+    void enable_message_signing(const std::array<uint8_t, 32>& secret_key);
+
+    /**
+     * @brief Stop signing, and accept all messages again.
+     */
+    void disable_message_signing();
+
+    /**
+     * @brief Get counters of the user callback queue.
+     *
+     * This can be used to check whether callbacks are dropped because they
+     * are not consumed fast enough.
+     *
+     * @return The current counters.
+     */
+    CallbackQueueStats callback_queue_stats() const;
+
+    /**
+     * @brief Get counters of the user callbacks per place they are called from.
+     *
+     * This can be used to find the subscriptions whose callbacks are slow and
+     * hold up the queue. A place in MAVSDK usually belongs to one kind of
+     * subscription, e.g. the position of telemetry.
+     *
+     * @return The counters, the places whose callbacks took longest in total first.
+     */
+    std::vector<CallbackSiteStats> callback_site_stats() const;
+
+    /**
+     * @brief Get counters of all messages received and sent.
+     *
+     * Besides the number of messages and bytes this includes how long the
+     * internal handlers took to process the received messages, and how long
+     * received messages took end to end: from the timestamp set by the
+     * sender until arriving, and from arriving until handled.
+     *
+     * The counters are always on, and cheap enough to be used in production.
+     *
+     * @return Counters per message ID, for message IDs seen at least once.
+     */
+    std::vector<MessageStats> message_stats() const;
+
+    /**
+     * @brief Get the memory held, per system, connection and queue.
+     *
+     * This can be used to find out what is behind the memory used, e.g.
+     * with many systems, and to tune the caches against a budget.
+     *
+     * @return Estimates of the bytes held.
+     */
+    MemoryUsage memory_usage() const;
+
     /**
      * @brief Set system status of this MAVLink entity.
      *
@@ -331,6 +919,36 @@ public:
      */
     void unsubscribe_on_new_system(NewSystemHandle handle);
 
+    /**
+     * @brief Callback type for link statistics.
+     */
+    using LinkStatsCallback = std::function<void(std::vector<LinkStats>)>;
+
+    /**
+     * @brief Handle type to unsubscribe from subscribe_link_stats.
+     */
+    using LinkStatsHandle = Handle<std::vector<LinkStats>>;
+
+    /**
+     * @brief Subscribe to statistics of all connections, once per second.
+     *
+     * Loss, duplicates and reordering are determined using the sequence
+     * number of the messages, per sender and connection. This can be used
+     * to judge the link quality, e.g. to adapt telemetry rates.
+     *
+     * @param callback Callback to subscribe.
+     *
+     * @return A handle to unsubscribe again.
+     */
+    LinkStatsHandle subscribe_link_stats(const LinkStatsCallback& callback);
+
+    /**
+     * @brief Unsubscribe from subscribe_link_stats.
+     *
+     * @param handle Handle received on subscription.
+     */
+    void unsubscribe_link_stats(LinkStatsHandle handle);
+
     /**
      * @brief High level type of a server component.
      */
@@ -377,6 +995,9 @@ public:
      * @note This functionality is provided primarily for testing in order to
      * simulate packet drops or actors not adhering to the MAVLink protocols.
      *
+     * @note This replaces the callback set by the previous call, it does not
+     * affect the interceptors added with add_incoming_messages_interceptor.
+     *
      * @param callback Callback to be called for each incoming message.
      *        To drop a message, return 'false' from the callback.
      */
@@ -391,11 +1012,70 @@ public:
      * @note This functionality is provided primarily for testing in order to
      * simulate packet drops or actors not adhering to the MAVLink protocols.
      *
+     * @note This replaces the callback set by the previous call, it does not
+     * affect the interceptors added with add_outgoing_messages_interceptor.
+     *
      * @param callback Callback to be called for each outgoing message.
      *        To drop a message, return 'false' from the callback.
      */
     void intercept_outgoing_messages_async(std::function<bool(mavlink_message_t&)> callback);
 
+    /**
+     * @brief Callback type for message interceptors.
+     *
+     * The message can be changed. To drop it, return 'false'.
+     */
+    using InterceptMessagesCallback = std::function<bool(mavlink_message_t&)>;
+
+    /**
+     * @brief Handle type to remove a message interceptor again.
+     */
+    using InterceptMessagesHandle = Handle<mavlink_message_t&>;
+
+    /**
+     * @brief Add an interceptor for incoming messages.
+     *
+     * Any number of interceptors can be added, e.g. to capture or count
+     * traffic. They are called in the order they were added, including the
+     * callback set by intercept_incoming_messages_async. Once one drops a
+     * message, the ones after it don't see it anymore.
+     *
+     * An interceptor is only called for the message IDs it asked for, so other
+     * traffic costs next to nothing.
+     *
+     * @param callback Callback to be called for each matching message.
+     * @param message_ids IDs of the messages to intercept, empty for all.
+     * @return Handle to remove the interceptor again.
+     */
+    InterceptMessagesHandle add_incoming_messages_interceptor(
+        const InterceptMessagesCallback& callback, const std::vector<uint32_t>& message_ids);
+
+    /**
+     * @brief Remove an interceptor for incoming messages.
+     *
+     * @param handle Handle returned when it was added.
+     */
+    void remove_incoming_messages_interceptor(InterceptMessagesHandle handle);
+
+    /**
+     * @brief Add an interceptor for outgoing messages.
+     *
+     * See add_incoming_messages_interceptor, it works the same way.
+     *
+     * @param callback Callback to be called for each matching message.
+     * @param message_ids IDs of the messages to intercept, empty for all.
+     * @return Handle to remove the interceptor again.
+     */
+    InterceptMessagesHandle add_outgoing_messages_interceptor(
+        const InterceptMessagesCallback& callback, const std::vector<uint32_t>& message_ids);
+
+    /**
+     * @brief Remove an interceptor for outgoing messages.
+     *
+     * @param handle Handle returned when it was added.
+     */
+    void remove_outgoing_messages_interceptor(InterceptMessagesHandle handle);
+
 private:
     /* @private. */
     std::shared_ptr<MavsdkImpl> _impl{};
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace mavsdk {
+
+/**
+ * @brief Memory held by the parts of a Mavsdk instance, in bytes.
+ *
+ * These are estimates from the sizes of the buffers and containers, not
+ * counting the overhead of the allocator.
+ */
+struct MemoryUsage {
+    /**
+     * @brief Memory held by a plugin beyond the plugin itself, e.g. for caches.
+     */
+    struct Plugin {
+        std::string name{}; /**< @brief Name of the plugin. */
+        uint64_t bytes{0}; /**< @brief Bytes held. */
+    };
+
+    /**
+     * @brief Memory held for one system.
+     */
+    struct System {
+        uint8_t system_id{0}; /**< @brief System ID. */
+        uint64_t param_store_bytes{0}; /**< @brief Params of the system. */
+        uint64_t mission_cache_bytes{0}; /**< @brief Mission items known to be on the system. */
+        uint64_t ftp_buffer_bytes{0}; /**< @brief Buffers of the FTP transfers. */
+        uint64_t work_queue_bytes{0}; /**< @brief Pending param and mission transfers. */
+        std::vector<Plugin> plugins{}; /**< @brief Plugins which hold memory, e.g. for caches. */
+    };
+
+    /**
+     * @brief Memory held for one connection.
+     */
+    struct Connection {
+        unsigned connection_index{0}; /**< @brief Index of the connection in the order added. */
+        uint64_t buffer_bytes{0}; /**< @brief Receive buffers and frames waiting to be sent. */
+    };
+
+    std::vector<System> systems{}; /**< @brief Per system. */
+    std::vector<Connection> connections{}; /**< @brief Per connection. */
+    uint64_t user_callback_queue_bytes{0}; /**< @brief Queues of the user callbacks. */
+    uint64_t total_bytes{0}; /**< @brief Sum of all of the above. */
+};
+
+} // namespace mavsdk
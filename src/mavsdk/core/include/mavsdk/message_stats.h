@@ -0,0 +1,46 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+namespace mavsdk {
+
+/**
+ * @brief Histogram of durations using power-of-two buckets.
+ */
+struct DurationHistogram {
+    /**
+     * @brief Number of buckets.
+     */
+    static constexpr unsigned num_buckets = 20;
+
+    /**
+     * @brief Counts per bucket.
+     *
+     * Bucket 0 counts durations below 1 us, bucket i durations from 2^(i-1) us
+     * up to 2^i us, and the last bucket everything longer than that.
+     */
+    std::array<uint64_t, num_buckets> counts{};
+    uint64_t total_count{0}; /**< @brief Number of durations recorded. */
+    uint64_t total_ns{0}; /**< @brief Sum of all durations recorded in ns. */
+    uint64_t max_ns{0}; /**< @brief Longest duration recorded in ns. */
+};
+
+/**
+ * @brief Counters for one MAVLink message ID.
+ */
+struct MessageStats {
+    uint32_t message_id{0}; /**< @brief MAVLink message ID. */
+    uint64_t received_count{0}; /**< @brief Number of messages received. */
+    uint64_t received_bytes{0}; /**< @brief Bytes received including framing. */
+    uint64_t sent_count{0}; /**< @brief Number of messages sent. */
+    uint64_t sent_bytes{0}; /**< @brief Bytes sent including framing. */
+    DurationHistogram dispatch_time{}; /**< @brief Time taken by the internal handlers. */
+    DurationHistogram processing_latency{}; /**< @brief Time from arriving, as stamped by the
+                                               kernel where possible, until handled. */
+    DurationHistogram transport_latency{}; /**< @brief Time from the timestamp of the sender until
+                                              arriving, for timestamped messages of systems
+                                              with time sync. */
+};
+
+} // namespace mavsdk
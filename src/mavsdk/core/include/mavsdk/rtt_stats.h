@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstdint>
+
+namespace mavsdk {
+
+/**
+ * @brief Round trip times of the pings to a system, over the recent pings.
+ *
+ * The times are 0 as long as no ping was answered.
+ */
+struct RttStats {
+    uint32_t sample_count{0}; /**< @brief Number of pings answered. */
+    uint32_t lost_count{0}; /**< @brief Number of pings not answered. */
+    double min_s{0.0}; /**< @brief Shortest round trip time in seconds. */
+    double mean_s{0.0}; /**< @brief Mean round trip time in seconds. */
+    double p95_s{0.0}; /**< @brief 95th percentile of the round trip time in seconds. */
+    double p99_s{0.0}; /**< @brief 99th percentile of the round trip time in seconds. */
+    double jitter_s{0.0}; /**< @brief Mean difference between consecutive round trips. */
+};
+
+} // namespace mavsdk
@@ -3,10 +3,13 @@
 #include <memory>
 #include <array>
 #include <functional>
+#include <optional>
 #include <vector>
 
 #include "deprecated.h"
 #include "handle.h"
+#include "message_stats.h"
+#include "rtt_stats.h"
 
 namespace mavsdk {
 
@@ -85,6 +88,18 @@ public:
      */
     bool is_connected() const;
 
+    /**
+     * @brief Checks if the system is ready.
+     *
+     * A system is ready once it is connected and what it supports has been
+     * discovered, e.g. its autopilot version, flight information and gimbal
+     * protocol. All of it is requested at once when it connects, and after
+     * 5 s it is ready with whatever has been discovered by then.
+     *
+     * @return `true` if the system is ready.
+     */
+    bool is_ready() const;
+
     /**
      * @brief MAVLink System ID of connected system.
      *
@@ -103,6 +118,32 @@ public:
      */
     std::vector<uint8_t> component_ids() const;
 
+    /**
+     * @brief Get counters of the messages received from and sent to this system.
+     *
+     * Broadcast messages are only counted in Mavsdk::message_stats.
+     *
+     * @return Counters per message ID, for message IDs seen at least once.
+     */
+    std::vector<MessageStats> message_stats() const;
+
+    /**
+     * @brief Get round trip time statistics of the pings to the autopilot.
+     *
+     * @return Statistics over the last 100 pings.
+     */
+    RttStats rtt_stats() const;
+
+    /**
+     * @brief Set how often the autopilot is pinged.
+     *
+     * Pinging more often gives more detailed round trip time statistics, at
+     * the cost of some bandwidth.
+     *
+     * @param interval_s Interval in seconds, 0 to go back to the default of 5 s.
+     */
+    void set_ping_interval_s(double interval_s);
+
     /**
      * @brief type for is connected callback.
      */
@@ -125,6 +166,29 @@ public:
      */
     void unsubscribe_is_connected(IsConnectedHandle handle);
 
+    /**
+     * @brief type for is ready callback.
+     */
+    using IsReadyCallback = std::function<void(bool)>;
+
+    /**
+     * @brief handle type to unsubscribe from subscribe_is_ready.
+     */
+    using IsReadyHandle = Handle<bool>;
+
+    /**
+     * @brief Subscribe to callback to be called when the system becomes ready, or is no longer
+     * ready because it disconnected.
+     *
+     * @param callback Callback which will be called.
+     */
+    IsReadyHandle subscribe_is_ready(const IsReadyCallback& callback);
+
+    /**
+     * @brief Unsubscribe from subscribe_is_ready.
+     */
+    void unsubscribe_is_ready(IsReadyHandle handle);
+
     /**
      * @brief Component Types
      */
@@ -183,6 +247,19 @@ public:
      */
     void enable_timesync();
 
+    /**
+     * @brief Convert a timestamp of the autopilot to the local system clock.
+     *
+     * This works for the autopilot timestamps of telemetry, such as the time
+     * since boot, once time synchronization is enabled and has received the
+     * first answer. The drift between the clocks is taken into account.
+     *
+     * @param autopilot_time_us Timestamp of the autopilot in microseconds.
+     * @return Microseconds since the epoch of the local system clock, or nothing
+     *         as long as the clocks are not synchronized.
+     */
+    std::optional<uint64_t> autopilot_time_to_local_us(uint64_t autopilot_time_us) const;
+
     /**
      * @brief Copy constructor (object is not copyable).
      */
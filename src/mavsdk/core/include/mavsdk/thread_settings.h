@@ -0,0 +1,45 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace mavsdk {
+
+/**
+ * @brief What a thread started by MAVSDK is for.
+ */
+enum class ThreadRole {
+    Work, /**< @brief Timeouts, heartbeats and dispatching received messages. */
+    UserCallbacks, /**< @brief Calling the callbacks of the user. */
+    Receive, /**< @brief Receiving on connections, also the shared receive threads. */
+    Send, /**< @brief Sending on connections with a bandwidth limit or send queue. */
+    System, /**< @brief The background work of systems, e.g. retries of transfers. */
+    Setpoints, /**< @brief Streaming offboard setpoints. */
+    HttpLoader, /**< @brief Downloading files over HTTP, e.g. component metadata. */
+};
+
+/**
+ * @brief How the threads of a role run.
+ *
+ * Everything is left to the operating system by default.
+ */
+struct ThreadSettings {
+    /**
+     * @brief Name of the threads, empty for the default, e.g. "mavsdk_recv".
+     *
+     * Linux only keeps the first 15 characters.
+     */
+    std::string name{};
+    /** @brief CPUs the threads may run on, empty for any (Linux only). */
+    std::vector<unsigned> cpus{};
+    /**
+     * @brief Real-time priority (SCHED_FIFO) from 1 to 99, 0 for normal
+     * scheduling (Linux and macOS only).
+     *
+     * On Linux this needs CAP_SYS_NICE or an rtprio limit, otherwise the
+     * threads keep normal scheduling and a warning is logged.
+     */
+    int realtime_priority{0};
+};
+
+} // namespace mavsdk
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace mavsdk {
+
+/**
+ * @brief Which messages are recorded to a telemetry log (tlog).
+ *
+ * Messages are filtered before they are serialized for the file, so what is
+ * filtered out costs close to nothing. Everything is recorded by default.
+ */
+struct TlogFilter {
+    std::vector<uint32_t> message_ids{}; /**< @brief Message IDs recorded, empty for all. */
+    std::vector<uint8_t> system_ids{}; /**< @brief Sender system IDs recorded, empty for all. */
+    bool incoming{true}; /**< @brief Whether received messages are recorded. */
+    bool outgoing{true}; /**< @brief Whether sent messages are recorded. */
+};
+
+} // namespace mavsdk
@@ -0,0 +1,231 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace mavsdk {
+
+/**
+ * @brief Reader for ULog files, the log format of PX4.
+ *
+ * The log can be fed in chunks of any size while it is still downloaded,
+ * e.g. from LogFilesExt::stream_log_file_async, and each message is parsed as
+ * soon as it is complete. Only a message split across two chunks is copied,
+ * logged samples are otherwise read right where they were fed.
+ *
+ * The format is described here: https://docs.px4.io/main/en/dev_log/ulog_file_format.html
+ */
+class ULogReader {
+public:
+    /**
+     * @brief Type of a field of a logged message.
+     */
+    enum class FieldType {
+        Int8,
+        UInt8,
+        Int16,
+        UInt16,
+        Int32,
+        UInt32,
+        Int64,
+        UInt64,
+        Float,
+        Double,
+        Bool,
+        Char,
+        Nested, /**< @brief Another format, named by type_name. */
+    };
+
+    /**
+     * @brief Field of a logged message.
+     */
+    struct Field {
+        std::string name{}; /**< @brief Name of the field. */
+        FieldType type{FieldType::UInt8}; /**< @brief Type of the field. */
+        std::string type_name{}; /**< @brief Type as in the log, without array size. */
+        std::size_t offset{0}; /**< @brief Offset in bytes into a sample. */
+        std::size_t size{0}; /**< @brief Size in bytes of one element. */
+        std::size_t array_size{1}; /**< @brief Number of elements, 1 if not an array. */
+    };
+
+    /**
+     * @brief Format of a logged message.
+     */
+    struct Format {
+        std::string name{}; /**< @brief Name of the format. */
+        std::vector<Field> fields{}; /**< @brief Fields in the order they are logged. */
+        std::size_t size{0}; /**< @brief Size in bytes, known once the format is used. */
+
+        /**
+         * @brief Find a field by name.
+         *
+         * @return The field, or nullptr if there is none of that name.
+         */
+        [[nodiscard]] const Field* field(const std::string& field_name) const;
+    };
+
+    /**
+     * @brief Logged topic, one instance of a format.
+     */
+    struct Topic {
+        std::string name{}; /**< @brief Name of the topic, same as of its format. */
+        uint8_t multi_id{0}; /**< @brief Instance, if there are several of the topic. */
+        const Format* format{nullptr}; /**< @brief Format of the topic. */
+    };
+
+    /**
+     * @brief One sample of a topic, only valid while it is passed to a callback.
+     */
+    struct Sample {
+        const Topic& topic; /**< @brief Topic of the sample. */
+        const uint8_t* data; /**< @brief Sample as logged. */
+        std::size_t size; /**< @brief Size of the sample in bytes. */
+
+        /**
+         * @brief Timestamp of the sample in microseconds, 0 if it has none.
+         */
+        [[nodiscard]] uint64_t timestamp_us() const;
+
+        /**
+         * @brief Value of a numeric field of the sample.
+         *
+         * @param field Field of the topic's format.
+         * @param index Element of the field, if it is an array.
+         * @return The value, or nothing if it is not numeric or not in the sample.
+         */
+        [[nodiscard]] std::optional<double> value(const Field& field, std::size_t index = 0) const;
+    };
+
+    /**
+     * @brief Callback type for samples.
+     */
+    using SampleCallback = std::function<void(const Sample& sample)>;
+
+    /**
+     * @brief Selected fields of all samples of a topic instance, one vector for each.
+     */
+    struct Columns {
+        std::vector<uint64_t> timestamps_us{}; /**< @brief Timestamp of each sample. */
+        std::map<std::string, std::vector<double>> values{}; /**< @brief Values by field. */
+    };
+
+    /**
+     * @brief Possible results of reading a log.
+     */
+    enum class Result {
+        Success, /**< @brief Read so far without problems. */
+        InvalidHeader, /**< @brief Not a ULog file. */
+        InvalidMessage, /**< @brief Broken message, nothing after it is read. */
+        FileError, /**< @brief File could not be read. */
+    };
+
+    /**
+     * @brief Default constructor.
+     */
+    ULogReader() = default;
+
+    /**
+     * @brief Copy constructor not available, samples refer to the reader's formats.
+     */
+    ULogReader(const ULogReader&) = delete;
+
+    /**
+     * @brief Copy assignment not available.
+     */
+    const ULogReader& operator=(const ULogReader&) = delete;
+
+    /**
+     * @brief Feed the next part of the log.
+     *
+     * @return Success, or the error that stopped reading, also for all later parts.
+     */
+    Result feed(const uint8_t* data, std::size_t size);
+
+    /**
+     * @brief Feed the next part of the log.
+     */
+    Result feed(const std::vector<uint8_t>& data);
+
+    /**
+     * @brief Feed a whole log file.
+     */
+    Result feed_file(const std::string& path);
+
+    /**
+     * @brief Set a callback for every sample of every topic, as soon as it is read.
+     */
+    void set_sample_callback(SampleCallback callback);
+
+    /**
+     * @brief Collect fields of a topic into columns.
+     *
+     * This should be done before the log is fed, samples read before are not
+     * collected.
+     *
+     * @param topic_name Name of the topic.
+     * @param field_names Numeric fields to collect, array fields are skipped.
+     */
+    void select_columns(const std::string& topic_name, std::vector<std::string> field_names);
+
+    /**
+     * @brief Columns collected for a topic instance.
+     *
+     * @return The columns, or nullptr if nothing was collected for it.
+     */
+    [[nodiscard]] const Columns* columns(const std::string& topic_name, uint8_t multi_id = 0) const;
+
+    /**
+     * @brief Timestamp in microseconds when logging started, as in the header.
+     */
+    [[nodiscard]] uint64_t start_timestamp_us() const { return _start_timestamp_us; }
+
+    /**
+     * @brief All formats read so far, by name.
+     */
+    [[nodiscard]] const std::map<std::string, Format>& formats() const { return _formats; }
+
+    /**
+     * @brief Value of an info message as logged, e.g. of "sys_name".
+     */
+    [[nodiscard]] std::optional<std::string> info(const std::string& key) const;
+
+private:
+    struct Subscription {
+        Topic topic{};
+        Columns* columns{nullptr};
+        std::vector<std::pair<const Field*, std::vector<double>*>> column_fields{};
+    };
+
+    bool process_message(uint8_t type, const uint8_t* payload, std::size_t size);
+    bool process_format(const uint8_t* payload, std::size_t size);
+    bool process_info(const uint8_t* payload, std::size_t size);
+    bool process_add_logged(const uint8_t* payload, std::size_t size);
+    bool process_data(const uint8_t* payload, std::size_t size);
+    bool resolve(Format& format, unsigned depth);
+    void bind_columns(Subscription& subscription);
+
+    Result _result{Result::Success};
+    bool _header_read{false};
+    uint64_t _start_timestamp_us{0};
+
+    // The start of a message that didn't fit into the last chunk.
+    std::vector<uint8_t> _partial{};
+
+    std::map<std::string, Format> _formats{};
+    std::map<std::string, std::string> _info{};
+
+    // Indexed by msg_id, which are given out in order from 0.
+    std::vector<std::optional<Subscription>> _subscriptions{};
+
+    SampleCallback _sample_callback{};
+    std::map<std::string, std::vector<std::string>> _selected_columns{};
+    std::map<std::pair<std::string, uint8_t>, Columns> _columns{};
+};
+
+} // namespace mavsdk
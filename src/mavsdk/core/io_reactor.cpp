@@ -0,0 +1,202 @@
+#include "io_reactor.h"
+#include "log.h"
+#include "thread_config.h"
+
+#if defined(LINUX)
+#include <sys/epoll.h>
+#include <unistd.h>
+#elif defined(APPLE)
+#include <sys/types.h>
+#include <sys/event.h>
+#include <sys/time.h>
+#include <unistd.h>
+#endif
+
+#include <cerrno>
+#include <cstring>
+
+namespace mavsdk {
+
+bool IoReactor::is_supported()
+{
+#if defined(LINUX) || defined(APPLE)
+    return true;
+#else
+    return false;
+#endif
+}
+
+IoReactor::IoReactor()
+{
+#if defined(LINUX) || defined(APPLE)
+#if defined(LINUX)
+    _poll_fd = epoll_create1(EPOLL_CLOEXEC);
+#else
+    _poll_fd = kqueue();
+#endif
+    if (_poll_fd < 0) {
+        LogErr() << "Could not create poll fd: " << strerror(errno);
+        return;
+    }
+
+    // The pipe is only used to wake up the thread when we want it to exit.
+    if (pipe(_wakeup_fds) != 0 || !watch(_wakeup_fds[0])) {
+        LogErr() << "Could not set up wakeup pipe: " << strerror(errno);
+        return;
+    }
+
+    _thread = std::make_unique<std::thread>(&IoReactor::run, this);
+#endif
+}
+
+IoReactor::~IoReactor()
+{
+    _should_exit = true;
+
+#if defined(LINUX) || defined(APPLE)
+    if (_wakeup_fds[1] >= 0) {
+        const char byte = 0;
+        // Nothing we can do if this fails anyway.
+        (void)!write(_wakeup_fds[1], &byte, 1);
+    }
+
+    if (_thread) {
+        _thread->join();
+        _thread.reset();
+    }
+
+    for (int fd : {_wakeup_fds[0], _wakeup_fds[1], _poll_fd}) {
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+#endif
+}
+
+bool IoReactor::add(int fd, Callback on_readable)
+{
+    if (!_thread) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    if (!watch(fd)) {
+        LogErr() << "Could not watch fd " << fd << ": " << strerror(errno);
+        return false;
+    }
+
+    _callbacks[fd] = std::make_shared<Callback>(std::move(on_readable));
+    return true;
+}
+
+void IoReactor::remove(int fd)
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+
+    if (_callbacks.erase(fd) == 0) {
+        return;
+    }
+
+    unwatch(fd);
+
+    // We can't wait for ourselves.
+    if (_thread && std::this_thread::get_id() == _thread->get_id()) {
+        return;
+    }
+
+    _dispatch_done_cv.wait(lock, [this, fd]() { return _dispatching_fd != fd; });
+}
+
+bool IoReactor::watch(int fd)
+{
+#if defined(LINUX)
+    struct epoll_event event {};
+    event.events = EPOLLIN;
+    event.data.fd = fd;
+    return epoll_ctl(_poll_fd, EPOLL_CTL_ADD, fd, &event) == 0;
+#elif defined(APPLE)
+    struct kevent event {};
+    EV_SET(&event, fd, EVFILT_READ, EV_ADD | EV_ENABLE, 0, 0, nullptr);
+    return kevent(_poll_fd, &event, 1, nullptr, 0, nullptr) == 0;
+#else
+    (void)fd;
+    return false;
+#endif
+}
+
+void IoReactor::unwatch(int fd)
+{
+    // This fails if the fd has already been closed, which is fine as it then
+    // got removed automatically.
+#if defined(LINUX)
+    epoll_ctl(_poll_fd, EPOLL_CTL_DEL, fd, nullptr);
+#elif defined(APPLE)
+    struct kevent event {};
+    EV_SET(&event, fd, EVFILT_READ, EV_DELETE, 0, 0, nullptr);
+    kevent(_poll_fd, &event, 1, nullptr, 0, nullptr);
+#else
+    (void)fd;
+#endif
+}
+
+void IoReactor::run()
+{
+    ThreadConfig::apply(ThreadRole::Receive);
+
+#if defined(LINUX) || defined(APPLE)
+    constexpr int max_events = 32;
+#if defined(LINUX)
+    struct epoll_event events[max_events];
+#else
+    struct kevent events[max_events];
+#endif
+
+    while (!_should_exit) {
+#if defined(LINUX)
+        const int num_events = epoll_wait(_poll_fd, events, max_events, -1);
+#else
+        const int num_events = kevent(_poll_fd, nullptr, 0, events, max_events, nullptr);
+#endif
+        if (num_events < 0) {
+            if (errno != EINTR) {
+                LogErr() << "Poll failed: " << strerror(errno);
+            }
+            continue;
+        }
+
+        for (int i = 0; i < num_events && !_should_exit; ++i) {
+#if defined(LINUX)
+            const int fd = events[i].data.fd;
+#else
+            const int fd = static_cast<int>(events[i].ident);
+#endif
+            if (fd == _wakeup_fds[0]) {
+                continue;
+            }
+
+            std::shared_ptr<Callback> callback;
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                auto it = _callbacks.find(fd);
+                if (it == _callbacks.end()) {
+                    // Removed after we got the event.
+                    continue;
+                }
+                callback = it->second;
+                _dispatching_fd = fd;
+            }
+
+            (*callback)();
+
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _dispatching_fd = -1;
+            }
+            _dispatch_done_cv.notify_all();
+        }
+    }
+#endif
+}
+
+} // namespace mavsdk
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+namespace mavsdk {
+
+// Waits for data on many file descriptors with one thread, using epoll on
+// Linux and kqueue on macOS. On other platforms it is not supported and
+// connections need to keep using their own receive thread.
+//
+// The callback of a file descriptor is called whenever there is data to be
+// read (level triggered), so it needs to read without blocking.
+class IoReactor {
+public:
+    using Callback = std::function<void()>;
+
+    IoReactor();
+    ~IoReactor();
+
+    // delete copy and move constructors and assign operators
+    IoReactor(IoReactor const&) = delete; // Copy construct
+    IoReactor(IoReactor&&) = delete; // Move construct
+    IoReactor& operator=(IoReactor const&) = delete; // Copy assign
+    IoReactor& operator=(IoReactor&&) = delete; // Move assign
+
+    static bool is_supported();
+
+    bool add(int fd, Callback on_readable);
+
+    // Once this returns, the callback is not called anymore, and is not
+    // running either (unless remove is called from within the callback).
+    void remove(int fd);
+
+private:
+    void run();
+    bool watch(int fd);
+    void unwatch(int fd);
+
+    int _poll_fd{-1};
+    int _wakeup_fds[2]{-1, -1};
+
+    std::mutex _mutex{};
+    std::condition_variable _dispatch_done_cv{};
+    std::unordered_map<int, std::shared_ptr<Callback>> _callbacks{};
+    int _dispatching_fd{-1};
+
+    std::atomic<bool> _should_exit{false};
+    std::unique_ptr<std::thread> _thread{};
+};
+
+} // namespace mavsdk
@@ -0,0 +1,78 @@
+#include "io_reactor.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#if defined(LINUX) || defined(APPLE)
+#include <unistd.h>
+#endif
+
+using namespace mavsdk;
+
+#if defined(LINUX) || defined(APPLE)
+
+TEST(IoReactor, CallsBackWhenReadable)
+{
+    IoReactor reactor;
+
+    int fds[2];
+    ASSERT_EQ(pipe(fds), 0);
+
+    std::atomic<int> num_bytes_read{0};
+    ASSERT_TRUE(reactor.add(fds[0], [&]() {
+        char buffer[16];
+        const auto len = read(fds[0], buffer, sizeof(buffer));
+        if (len > 0) {
+            num_bytes_read += static_cast<int>(len);
+        }
+    }));
+
+    ASSERT_EQ(write(fds[1], "abc", 3), 3);
+
+    for (int i = 0; i < 100 && num_bytes_read < 3; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_EQ(num_bytes_read, 3);
+
+    reactor.remove(fds[0]);
+
+    // Once removed, we're not called anymore.
+    ASSERT_EQ(write(fds[1], "d", 1), 1);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_EQ(num_bytes_read, 3);
+
+    close(fds[0]);
+    close(fds[1]);
+}
+
+TEST(IoReactor, RemoveWaitsForCallback)
+{
+    IoReactor reactor;
+
+    int fds[2];
+    ASSERT_EQ(pipe(fds), 0);
+
+    std::atomic<bool> in_callback{false};
+    std::atomic<bool> callback_done{false};
+    ASSERT_TRUE(reactor.add(fds[0], [&]() {
+        char buffer[16];
+        (void)!read(fds[0], buffer, sizeof(buffer));
+        in_callback = true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        callback_done = true;
+    }));
+
+    ASSERT_EQ(write(fds[1], "a", 1), 1);
+    while (!in_callback) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    reactor.remove(fds[0]);
+    EXPECT_TRUE(callback_done);
+
+    close(fds[0]);
+    close(fds[1]);
+}
+
+#endif
@@ -0,0 +1,526 @@
+#include "io_uring_receiver.h"
+#include "log.h"
+#include "thread_config.h"
+
+#if defined(MAVSDK_WITH_IO_URING)
+#include <linux/io_uring.h>
+#include <netinet/in.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <vector>
+
+namespace mavsdk {
+
+#if defined(MAVSDK_WITH_IO_URING)
+
+namespace {
+
+constexpr unsigned SQ_ENTRIES = 64;
+// Several datagrams per socket can complete before the thread gets to them.
+constexpr unsigned CQ_ENTRIES = 1024;
+constexpr uint16_t BUFFER_GROUP = 0;
+// For the completions of what is not a receive.
+constexpr uint64_t INTERNAL_ID = 0;
+
+} // namespace
+
+// The raw interface of io_uring, as liburing wraps it, which we don't
+// depend on for the few operations we need.
+struct IoUringReceiver::Ring {
+    Ring() = default;
+
+    ~Ring()
+    {
+        if (buf_ring != MAP_FAILED) {
+            munmap(buf_ring, buf_ring_len);
+        }
+        if (sqes != MAP_FAILED) {
+            munmap(sqes, sqes_len);
+        }
+        if (cq_ptr != MAP_FAILED && cq_ptr != sq_ptr) {
+            munmap(cq_ptr, cq_len);
+        }
+        if (sq_ptr != MAP_FAILED) {
+            munmap(sq_ptr, sq_len);
+        }
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+
+    // Non-copyable
+    Ring(const Ring&) = delete;
+    const Ring& operator=(const Ring&) = delete;
+
+    bool setup()
+    {
+        struct io_uring_params params {};
+        params.flags = IORING_SETUP_CQSIZE;
+        params.cq_entries = CQ_ENTRIES;
+
+        fd = static_cast<int>(syscall(__NR_io_uring_setup, SQ_ENTRIES, &params));
+        if (fd < 0) {
+            LogWarn() << "Could not set up io_uring: " << strerror(errno);
+            return false;
+        }
+
+        sq_len = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cq_len = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+        const bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (single_mmap) {
+            sq_len = cq_len = std::max(sq_len, cq_len);
+        }
+
+        sq_ptr = mmap(
+            nullptr,
+            sq_len,
+            PROT_READ | PROT_WRITE,
+            MAP_SHARED | MAP_POPULATE,
+            fd,
+            static_cast<off_t>(IORING_OFF_SQ_RING));
+        cq_ptr = single_mmap ? sq_ptr :
+                               mmap(
+                                   nullptr,
+                                   cq_len,
+                                   PROT_READ | PROT_WRITE,
+                                   MAP_SHARED | MAP_POPULATE,
+                                   fd,
+                                   static_cast<off_t>(IORING_OFF_CQ_RING));
+        sqes_len = params.sq_entries * sizeof(struct io_uring_sqe);
+        void* sqes_ptr = mmap(
+            nullptr,
+            sqes_len,
+            PROT_READ | PROT_WRITE,
+            MAP_SHARED | MAP_POPULATE,
+            fd,
+            static_cast<off_t>(IORING_OFF_SQES));
+        sqes = static_cast<struct io_uring_sqe*>(sqes_ptr);
+        if (sq_ptr == MAP_FAILED || cq_ptr == MAP_FAILED || sqes_ptr == MAP_FAILED) {
+            LogWarn() << "Could not map io_uring: " << strerror(errno);
+            return false;
+        }
+
+        auto* sq = static_cast<char*>(sq_ptr);
+        sq_head = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+        sq_tail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        sq_mask = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        sq_entries = params.sq_entries;
+        sq_array = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+
+        auto* cq = static_cast<char*>(cq_ptr);
+        cq_head = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        cq_tail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        cq_mask = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        cqes = reinterpret_cast<struct io_uring_cqe*>(cq + params.cq_off.cqes);
+
+        return setup_buffers();
+    }
+
+    // The buffers are registered once, and the kernel picks one for every
+    // datagram, so none has to be passed with each receive.
+    bool setup_buffers()
+    {
+        buf_ring_len = NUM_BUFFERS * sizeof(struct io_uring_buf);
+        buf_ring = mmap(
+            nullptr, buf_ring_len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (buf_ring == MAP_FAILED) {
+            LogWarn() << "Could not allocate io_uring buffer ring: " << strerror(errno);
+            return false;
+        }
+
+        struct io_uring_buf_reg reg {};
+        reg.ring_addr = reinterpret_cast<uintptr_t>(buf_ring);
+        reg.ring_entries = NUM_BUFFERS;
+        reg.bgid = BUFFER_GROUP;
+        if (syscall(__NR_io_uring_register, fd, IORING_REGISTER_PBUF_RING, &reg, 1) != 0) {
+            LogWarn() << "Could not register io_uring buffers: " << strerror(errno);
+            return false;
+        }
+
+        buffers.resize(NUM_BUFFERS * BUFFER_LEN);
+        for (unsigned i = 0; i < NUM_BUFFERS; ++i) {
+            return_buffer(static_cast<uint16_t>(i));
+        }
+
+        msg.msg_namelen = sizeof(struct sockaddr_in);
+        return true;
+    }
+
+    // Multishot recvmsg needs Linux 6.0, before that it is rejected as
+    // invalid, which is only found out by trying.
+    bool probe_multishot()
+    {
+        const int probe_fd = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+        if (probe_fd < 0) {
+            return false;
+        }
+
+        constexpr uint64_t probe_id = INTERNAL_ID + 1;
+        int result = -EINVAL;
+        bool pending = submit_recvmsg(probe_id, probe_fd) && submit_cancel(probe_id);
+        while (pending && wait()) {
+            reap([&](const struct io_uring_cqe& cqe) {
+                if (cqe.user_data == probe_id && (cqe.flags & IORING_CQE_F_MORE) == 0) {
+                    result = cqe.res;
+                    pending = false;
+                }
+            });
+        }
+        close(probe_fd);
+
+        if (result == -EINVAL) {
+            LogWarn() << "Multishot receive with io_uring not supported, Linux 6.0 is needed";
+            return false;
+        }
+        return true;
+    }
+
+    bool submit_recvmsg(uint64_t id, int socket_fd)
+    {
+        struct io_uring_sqe sqe {};
+        sqe.opcode = IORING_OP_RECVMSG;
+        sqe.fd = socket_fd;
+        sqe.addr = reinterpret_cast<uintptr_t>(&msg);
+        sqe.len = 1;
+        sqe.ioprio = IORING_RECV_MULTISHOT;
+        sqe.flags = IOSQE_BUFFER_SELECT;
+        sqe.buf_group = BUFFER_GROUP;
+        sqe.user_data = id;
+        return submit(sqe);
+    }
+
+    bool submit_cancel(uint64_t id)
+    {
+        struct io_uring_sqe sqe {};
+        sqe.opcode = IORING_OP_ASYNC_CANCEL;
+        sqe.fd = -1;
+        sqe.addr = id;
+        sqe.user_data = INTERNAL_ID;
+        return submit(sqe);
+    }
+
+    bool submit_nop()
+    {
+        struct io_uring_sqe sqe {};
+        sqe.opcode = IORING_OP_NOP;
+        sqe.fd = -1;
+        sqe.user_data = INTERNAL_ID;
+        return submit(sqe);
+    }
+
+    bool submit(const struct io_uring_sqe& sqe)
+    {
+        const unsigned tail = *sq_tail;
+        if (tail - __atomic_load_n(sq_head, __ATOMIC_ACQUIRE) >= sq_entries) {
+            LogErr() << "io_uring submission queue full";
+            return false;
+        }
+
+        const unsigned index = tail & sq_mask;
+        sqes[index] = sqe;
+        sq_array[index] = index;
+        __atomic_store_n(sq_tail, tail + 1, __ATOMIC_RELEASE);
+
+        long ret;
+        do {
+            ret = syscall(__NR_io_uring_enter, fd, 1, 0, 0, nullptr, 0);
+        } while (ret < 0 && errno == EINTR);
+
+        if (ret != 1) {
+            LogErr() << "io_uring submit failed: " << strerror(errno);
+            return false;
+        }
+        return true;
+    }
+
+    // Waits for at least one completion, false if interrupted.
+    bool wait()
+    {
+        if (syscall(__NR_io_uring_enter, fd, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0) < 0) {
+            if (errno != EINTR) {
+                LogErr() << "io_uring wait failed: " << strerror(errno);
+            }
+            return false;
+        }
+        return true;
+    }
+
+    template<typename Callback> void reap(const Callback& callback)
+    {
+        unsigned head = *cq_head;
+        const unsigned tail = __atomic_load_n(cq_tail, __ATOMIC_ACQUIRE);
+        for (; head != tail; ++head) {
+            callback(cqes[head & cq_mask]);
+        }
+        __atomic_store_n(cq_head, head, __ATOMIC_RELEASE);
+    }
+
+    char* buffer(uint16_t buffer_id) { return &buffers[buffer_id * BUFFER_LEN]; }
+
+    void return_buffer(uint16_t buffer_id)
+    {
+        // Not through io_uring_buf_ring::bufs, which ends up after an empty
+        // struct in C++, 8 bytes off.
+        auto* bufs = static_cast<struct io_uring_buf*>(buf_ring);
+        auto& buf = bufs[buf_ring_tail & (NUM_BUFFERS - 1)];
+        buf.addr = reinterpret_cast<uintptr_t>(buffer(buffer_id));
+        buf.len = BUFFER_LEN;
+        buf.bid = buffer_id;
+        ++buf_ring_tail;
+        auto* ring = static_cast<struct io_uring_buf_ring*>(buf_ring);
+        __atomic_store_n(&ring->tail, buf_ring_tail, __ATOMIC_RELEASE);
+    }
+
+    int fd{-1};
+
+    void* sq_ptr{MAP_FAILED};
+    size_t sq_len{0};
+    unsigned* sq_head{nullptr};
+    unsigned* sq_tail{nullptr};
+    unsigned sq_mask{0};
+    unsigned sq_entries{0};
+    unsigned* sq_array{nullptr};
+    struct io_uring_sqe* sqes{static_cast<struct io_uring_sqe*>(MAP_FAILED)};
+    size_t sqes_len{0};
+
+    void* cq_ptr{MAP_FAILED};
+    size_t cq_len{0};
+    unsigned* cq_head{nullptr};
+    unsigned* cq_tail{nullptr};
+    unsigned cq_mask{0};
+    struct io_uring_cqe* cqes{nullptr};
+
+    void* buf_ring{MAP_FAILED};
+    size_t buf_ring_len{0};
+    uint16_t buf_ring_tail{0};
+    std::vector<char> buffers{};
+
+    // The same for every receive, the kernel only reads it.
+    struct msghdr msg {};
+};
+
+bool IoUringReceiver::is_supported()
+{
+    static const bool supported = []() {
+        Ring ring;
+        return ring.setup() && ring.probe_multishot();
+    }();
+    return supported;
+}
+
+IoUringReceiver::IoUringReceiver()
+{
+    if (!is_supported()) {
+        return;
+    }
+
+    _ring = std::make_unique<Ring>();
+    if (!_ring->setup()) {
+        _ring.reset();
+        return;
+    }
+
+    _thread = std::make_unique<std::thread>(&IoUringReceiver::run, this);
+}
+
+IoUringReceiver::~IoUringReceiver()
+{
+    _should_exit = true;
+
+    if (_thread) {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            // Nothing we can do if this fails anyway.
+            (void)_ring->submit_nop();
+        }
+        _thread->join();
+        _thread.reset();
+    }
+
+    // Closing the ring cancels the receives still in flight.
+    _ring.reset();
+}
+
+bool IoUringReceiver::add(int fd, DatagramCallback on_datagram)
+{
+    if (!_thread) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    const uint64_t id = _next_id++;
+    if (!_ring->submit_recvmsg(id, fd)) {
+        return false;
+    }
+
+    Socket socket;
+    socket.fd = fd;
+    socket.callback = std::make_shared<DatagramCallback>(std::move(on_datagram));
+    socket.in_flight = true;
+    _sockets.emplace(id, std::move(socket));
+    return true;
+}
+
+void IoUringReceiver::remove(int fd)
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+
+    auto it = std::find_if(_sockets.begin(), _sockets.end(), [fd](const auto& entry) {
+        return entry.second.fd == fd && !entry.second.removed;
+    });
+    if (it == _sockets.end()) {
+        return;
+    }
+
+    const uint64_t id = it->first;
+    it->second.removed = true;
+
+    // Once cancelled, the receive completes one last time, and the thread
+    // forgets about it. If we can't cancel, we forget about it right away,
+    // and ignore whatever comes for it.
+    if (!it->second.in_flight || !_ring->submit_cancel(id)) {
+        _sockets.erase(it);
+    }
+
+    // We can't wait for ourselves.
+    if (std::this_thread::get_id() == _thread->get_id()) {
+        return;
+    }
+
+    _removed_cv.wait(lock, [this, id]() {
+        return _sockets.find(id) == _sockets.end() && _dispatching_id != id;
+    });
+}
+
+void IoUringReceiver::run()
+{
+    ThreadConfig::apply(ThreadRole::Receive);
+
+    while (!_should_exit) {
+        if (!_ring->wait()) {
+            continue;
+        }
+        _ring->reap([this](const struct io_uring_cqe& cqe) { process_completion(cqe); });
+    }
+}
+
+void IoUringReceiver::process_completion(const struct io_uring_cqe& cqe)
+{
+    if (cqe.user_data == INTERNAL_ID) {
+        return;
+    }
+
+    const uint64_t id = cqe.user_data;
+    const bool has_buffer = (cqe.flags & IORING_CQE_F_BUFFER) != 0;
+    const auto buffer_id = static_cast<uint16_t>(cqe.flags >> IORING_CQE_BUFFER_SHIFT);
+
+    std::shared_ptr<DatagramCallback> callback;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto it = _sockets.find(id);
+        if (it != _sockets.end() && !it->second.removed && cqe.res > 0 && has_buffer) {
+            callback = it->second.callback;
+            _dispatching_id = id;
+        }
+    }
+
+    if (callback) {
+        // The kernel puts the header, then the sender's address, then the
+        // payload into the buffer.
+        char* buffer = _ring->buffer(buffer_id);
+        struct io_uring_recvmsg_out out {};
+        std::memcpy(&out, buffer, sizeof(out));
+
+        const size_t payload_offset = sizeof(out) + _ring->msg.msg_namelen;
+        const auto received = static_cast<size_t>(cqe.res);
+
+        if (received >= payload_offset) {
+            struct sockaddr_in src_addr {};
+            std::memcpy(&src_addr, buffer + sizeof(out), sizeof(src_addr));
+
+            // Anything longer than the buffer is cut off.
+            const size_t len = std::min<size_t>(out.payloadlen, received - payload_offset);
+            (*callback)(buffer + payload_offset, static_cast<int>(len), src_addr);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _dispatching_id = 0;
+        }
+        _removed_cv.notify_all();
+    }
+
+    if (has_buffer) {
+        _ring->return_buffer(buffer_id);
+    }
+
+    if ((cqe.flags & IORING_CQE_F_MORE) != 0) {
+        return;
+    }
+
+    // The multishot receive has ended, because it was cancelled, because
+    // the buffers ran out, or because of an error.
+    std::unique_lock<std::mutex> lock(_mutex);
+    auto it = _sockets.find(id);
+    if (it == _sockets.end()) {
+        return;
+    }
+
+    it->second.in_flight = false;
+    if (it->second.removed) {
+        _sockets.erase(it);
+        lock.unlock();
+        _removed_cv.notify_all();
+        return;
+    }
+
+    if (cqe.res > 0 || cqe.res == -ENOBUFS) {
+        it->second.in_flight = _ring->submit_recvmsg(id, it->second.fd);
+    } else if (cqe.res < 0) {
+        LogErr() << "io_uring receive stopped: " << strerror(-cqe.res);
+    }
+}
+
+#else
+
+struct IoUringReceiver::Ring {};
+
+bool IoUringReceiver::is_supported()
+{
+    return false;
+}
+
+IoUringReceiver::IoUringReceiver() {}
+
+IoUringReceiver::~IoUringReceiver() {}
+
+bool IoUringReceiver::add(int fd, DatagramCallback on_datagram)
+{
+    (void)fd;
+    (void)on_datagram;
+    return false;
+}
+
+void IoUringReceiver::remove(int fd)
+{
+    (void)fd;
+}
+
+void IoUringReceiver::run() {}
+
+void IoUringReceiver::process_completion(const struct io_uring_cqe& cqe)
+{
+    (void)cqe;
+}
+
+#endif
+
+} // namespace mavsdk
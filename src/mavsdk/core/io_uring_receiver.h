@@ -0,0 +1,85 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+struct io_uring_cqe;
+struct sockaddr_in;
+
+namespace mavsdk {
+
+// Receives the datagrams of many UDP sockets on one thread with io_uring,
+// on Linux 6.0 or newer.
+//
+// Each socket has one multishot recvmsg in flight, which the kernel keeps
+// filling into a ring of buffers registered up front. One io_uring_enter()
+// then waits for a whole batch of datagrams, instead of a syscall to poll
+// and one to receive each time. Buffers are given back to the kernel once
+// the callback returns, so the callback must not keep the data.
+//
+// Where io_uring or multishot receive is not available, add() fails and
+// connections need to keep using the IoReactor or their own thread.
+class IoUringReceiver {
+public:
+    using DatagramCallback =
+        std::function<void(char* data, int len, const struct sockaddr_in& src_addr)>;
+
+    IoUringReceiver();
+    ~IoUringReceiver();
+
+    // delete copy and move constructors and assign operators
+    IoUringReceiver(IoUringReceiver const&) = delete; // Copy construct
+    IoUringReceiver(IoUringReceiver&&) = delete; // Move construct
+    IoUringReceiver& operator=(IoUringReceiver const&) = delete; // Copy assign
+    IoUringReceiver& operator=(IoUringReceiver&&) = delete; // Move assign
+
+    static bool is_supported();
+
+    bool add(int fd, DatagramCallback on_datagram);
+
+    // Once this returns, the callback is not called anymore, and is not
+    // running either (unless remove is called from within the callback).
+    void remove(int fd);
+
+    // The registered buffers, shared by all sockets.
+    static constexpr unsigned NUM_BUFFERS = 128;
+    // Enough for MTU 1500 bytes, the sender's address and the header the
+    // kernel puts in front.
+    static constexpr size_t BUFFER_LEN = 2048;
+
+private:
+    struct Ring;
+
+    struct Socket {
+        int fd{-1};
+        std::shared_ptr<DatagramCallback> callback{};
+        bool removed{false};
+        // Whether the multishot recvmsg is still in the kernel.
+        bool in_flight{false};
+    };
+
+    void run();
+    void process_completion(const struct io_uring_cqe& cqe);
+
+    // Also holds the buffers, and is only used with _mutex held, other than
+    // for completions, which only the thread takes.
+    std::unique_ptr<Ring> _ring{};
+
+    std::mutex _mutex{};
+    std::condition_variable _removed_cv{};
+    std::unordered_map<uint64_t, Socket> _sockets{}; // Needs _mutex
+    uint64_t _next_id{1}; // Needs _mutex
+    uint64_t _dispatching_id{0}; // Needs _mutex
+
+    std::atomic<bool> _should_exit{false};
+    std::unique_ptr<std::thread> _thread{};
+};
+
+} // namespace mavsdk
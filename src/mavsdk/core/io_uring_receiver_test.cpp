@@ -0,0 +1,148 @@
+#include "io_uring_receiver.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(LINUX)
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+using namespace mavsdk;
+
+#if defined(LINUX)
+
+namespace {
+
+// A UDP socket on a free port of localhost.
+int bind_socket(struct sockaddr_in& addr)
+{
+    const int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t addr_len = sizeof(addr);
+    if (fd < 0 || bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &addr_len) != 0) {
+        return -1;
+    }
+    return fd;
+}
+
+void send_to(int fd, const struct sockaddr_in& addr, const std::string& data)
+{
+    const auto len = sendto(
+        fd, data.data(), data.size(), 0, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr));
+    ASSERT_EQ(len, static_cast<ssize_t>(data.size()));
+}
+
+template<typename Predicate> bool wait_until(const Predicate& predicate)
+{
+    for (int i = 0; i < 100 && !predicate(); ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return predicate();
+}
+
+} // namespace
+
+TEST(IoUringReceiver, ReceivesDatagramsWithSender)
+{
+    if (!IoUringReceiver::is_supported()) {
+        GTEST_SKIP() << "io_uring not supported";
+    }
+
+    IoUringReceiver receiver;
+
+    struct sockaddr_in receive_addr;
+    const int receive_fd = bind_socket(receive_addr);
+    ASSERT_GE(receive_fd, 0);
+    struct sockaddr_in send_addr;
+    const int send_fd = bind_socket(send_addr);
+    ASSERT_GE(send_fd, 0);
+
+    std::mutex mutex;
+    std::vector<std::string> received;
+    std::vector<uint16_t> src_ports;
+    ASSERT_TRUE(receiver.add(receive_fd, [&](char* data, int len, const sockaddr_in& src_addr) {
+        std::lock_guard<std::mutex> lock(mutex);
+        received.emplace_back(data, static_cast<size_t>(len));
+        src_ports.push_back(ntohs(src_addr.sin_port));
+    }));
+
+    // More than there are buffers, which need to be given back to be reused.
+    constexpr unsigned num_datagrams = 3 * IoUringReceiver::NUM_BUFFERS;
+    for (unsigned i = 0; i < num_datagrams; ++i) {
+        send_to(send_fd, receive_addr, std::to_string(i));
+        if (i % 32 == 0) {
+            // Not faster than we can take them, so the socket doesn't drop any.
+            wait_until([&]() {
+                std::lock_guard<std::mutex> lock(mutex);
+                return received.size() == i + 1;
+            });
+        }
+    }
+
+    ASSERT_TRUE(wait_until([&]() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return received.size() == num_datagrams;
+    }));
+    for (unsigned i = 0; i < num_datagrams; ++i) {
+        EXPECT_EQ(received[i], std::to_string(i));
+        EXPECT_EQ(src_ports[i], ntohs(send_addr.sin_port));
+    }
+
+    receiver.remove(receive_fd);
+
+    // Once removed, we're not called anymore.
+    send_to(send_fd, receive_addr, "after");
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        EXPECT_EQ(received.size(), num_datagrams);
+    }
+
+    close(receive_fd);
+    close(send_fd);
+}
+
+TEST(IoUringReceiver, RemoveWaitsForCallback)
+{
+    if (!IoUringReceiver::is_supported()) {
+        GTEST_SKIP() << "io_uring not supported";
+    }
+
+    IoUringReceiver receiver;
+
+    struct sockaddr_in receive_addr;
+    const int receive_fd = bind_socket(receive_addr);
+    ASSERT_GE(receive_fd, 0);
+    struct sockaddr_in send_addr;
+    const int send_fd = bind_socket(send_addr);
+    ASSERT_GE(send_fd, 0);
+
+    std::atomic<bool> in_callback{false};
+    std::atomic<bool> callback_done{false};
+    ASSERT_TRUE(receiver.add(receive_fd, [&](char*, int, const sockaddr_in&) {
+        in_callback = true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        callback_done = true;
+    }));
+
+    send_to(send_fd, receive_addr, "a");
+    ASSERT_TRUE(wait_until([&]() { return in_callback.load(); }));
+
+    receiver.remove(receive_fd);
+    EXPECT_TRUE(callback_done);
+
+    close(receive_fd);
+    close(send_fd);
+}
+
+#endif
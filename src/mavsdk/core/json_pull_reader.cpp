@@ -0,0 +1,339 @@
+#include "json_pull_reader.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+namespace mavsdk {
+
+namespace {
+
+// Deeper nesting is not used by any file we read, and would only cost stack.
+constexpr std::size_t max_depth = 256;
+
+bool is_number_char(char c)
+{
+    return (c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E';
+}
+
+void append_utf8(std::string& out, uint32_t code_point)
+{
+    if (code_point < 0x80) {
+        out += static_cast<char>(code_point);
+    } else if (code_point < 0x800) {
+        out += static_cast<char>(0xC0 | (code_point >> 6));
+        out += static_cast<char>(0x80 | (code_point & 0x3F));
+    } else if (code_point < 0x10000) {
+        out += static_cast<char>(0xE0 | (code_point >> 12));
+        out += static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (code_point & 0x3F));
+    } else {
+        out += static_cast<char>(0xF0 | (code_point >> 18));
+        out += static_cast<char>(0x80 | ((code_point >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (code_point & 0x3F));
+    }
+}
+
+} // namespace
+
+JsonPullReader::JsonPullReader(const char* begin, const char* end) : _pos(begin), _end(end) {}
+
+JsonPullReader::Type JsonPullReader::peek()
+{
+    skip_whitespace();
+    if (_failed || _pos == _end) {
+        return Type::Invalid;
+    }
+
+    switch (*_pos) {
+        case 'n':
+            return Type::Null;
+        case 't':
+        case 'f':
+            return Type::Bool;
+        case '"':
+            return Type::String;
+        case '[':
+            return Type::Array;
+        case '{':
+            return Type::Object;
+        default:
+            return (*_pos == '-' || (*_pos >= '0' && *_pos <= '9')) ? Type::Number :
+                                                                      Type::Invalid;
+    }
+}
+
+bool JsonPullReader::enter_object()
+{
+    if (peek() != Type::Object || _first.size() >= max_depth) {
+        return fail();
+    }
+    ++_pos;
+    _first.push_back(true);
+    return true;
+}
+
+bool JsonPullReader::next_key(std::string& key)
+{
+    if (!next_in_container('}')) {
+        return false;
+    }
+
+    skip_whitespace();
+    if (!parse_string(key) || !consume(':')) {
+        return fail();
+    }
+    return true;
+}
+
+bool JsonPullReader::enter_array()
+{
+    if (peek() != Type::Array || _first.size() >= max_depth) {
+        return fail();
+    }
+    ++_pos;
+    _first.push_back(true);
+    return true;
+}
+
+bool JsonPullReader::next_element()
+{
+    return next_in_container(']');
+}
+
+std::optional<double> JsonPullReader::read_number()
+{
+    if (peek() != Type::Number) {
+        fail();
+        return {};
+    }
+
+    const char* start = _pos;
+    while (_pos != _end && is_number_char(*_pos)) {
+        ++_pos;
+    }
+
+    // strtod needs a terminated string, numbers are short.
+    const std::string text(start, _pos);
+    char* parsed_end = nullptr;
+    const double value = std::strtod(text.c_str(), &parsed_end);
+    if (parsed_end != text.c_str() + text.size()) {
+        fail();
+        return {};
+    }
+    return value;
+}
+
+std::optional<bool> JsonPullReader::read_bool()
+{
+    if (peek() != Type::Bool) {
+        fail();
+        return {};
+    }
+
+    const auto remaining = static_cast<std::size_t>(_end - _pos);
+    if (remaining >= 4 && std::memcmp(_pos, "true", 4) == 0) {
+        _pos += 4;
+        return true;
+    }
+    if (remaining >= 5 && std::memcmp(_pos, "false", 5) == 0) {
+        _pos += 5;
+        return false;
+    }
+    fail();
+    return {};
+}
+
+std::optional<std::string> JsonPullReader::read_string()
+{
+    std::string value;
+    if (peek() != Type::String || !parse_string(value)) {
+        fail();
+        return {};
+    }
+    return value;
+}
+
+bool JsonPullReader::read_null()
+{
+    if (peek() != Type::Null || static_cast<std::size_t>(_end - _pos) < 4 ||
+        std::memcmp(_pos, "null", 4) != 0) {
+        return fail();
+    }
+    _pos += 4;
+    return true;
+}
+
+bool JsonPullReader::skip_value()
+{
+    switch (peek()) {
+        case Type::Null:
+            return read_null();
+        case Type::Bool:
+            return read_bool().has_value();
+        case Type::Number:
+            return read_number().has_value();
+        case Type::String:
+            return read_string().has_value();
+        case Type::Array:
+            if (!enter_array()) {
+                return false;
+            }
+            while (next_element()) {
+                if (!skip_value()) {
+                    return false;
+                }
+            }
+            return !_failed;
+        case Type::Object: {
+            if (!enter_object()) {
+                return false;
+            }
+            std::string key;
+            while (next_key(key)) {
+                if (!skip_value()) {
+                    return false;
+                }
+            }
+            return !_failed;
+        }
+        case Type::Invalid:
+        default:
+            return fail();
+    }
+}
+
+bool JsonPullReader::at_end()
+{
+    skip_whitespace();
+    return !_failed && _first.empty() && _pos == _end;
+}
+
+const char* JsonPullReader::position()
+{
+    skip_whitespace();
+    return _pos;
+}
+
+void JsonPullReader::skip_whitespace()
+{
+    while (_pos != _end && (*_pos == ' ' || *_pos == '\n' || *_pos == '\r' || *_pos == '\t')) {
+        ++_pos;
+    }
+}
+
+bool JsonPullReader::consume(char c)
+{
+    skip_whitespace();
+    if (_pos == _end || *_pos != c) {
+        return false;
+    }
+    ++_pos;
+    return true;
+}
+
+bool JsonPullReader::next_in_container(char closing)
+{
+    if (_failed || _first.empty()) {
+        return fail();
+    }
+
+    if (consume(closing)) {
+        _first.pop_back();
+        return false;
+    }
+
+    if (!_first.back() && !consume(',')) {
+        return fail();
+    }
+    _first.back() = false;
+    return true;
+}
+
+bool JsonPullReader::parse_string(std::string& out)
+{
+    if (_pos == _end || *_pos != '"') {
+        return false;
+    }
+    ++_pos;
+
+    out.clear();
+    while (_pos != _end) {
+        const char c = *_pos++;
+        if (c == '"') {
+            return true;
+        }
+        if (c != '\\') {
+            out += c;
+            continue;
+        }
+
+        if (_pos == _end) {
+            return false;
+        }
+        switch (*_pos++) {
+            case '"':
+                out += '"';
+                break;
+            case '\\':
+                out += '\\';
+                break;
+            case '/':
+                out += '/';
+                break;
+            case 'b':
+                out += '\b';
+                break;
+            case 'f':
+                out += '\f';
+                break;
+            case 'n':
+                out += '\n';
+                break;
+            case 'r':
+                out += '\r';
+                break;
+            case 't':
+                out += '\t';
+                break;
+            case 'u': {
+                if (_end - _pos < 4) {
+                    return false;
+                }
+                char* hex_end = nullptr;
+                const std::string hex(_pos, _pos + 4);
+                auto code_point = static_cast<uint32_t>(std::strtoul(hex.c_str(), &hex_end, 16));
+                if (hex_end != hex.c_str() + 4) {
+                    return false;
+                }
+                _pos += 4;
+
+                // Characters outside the basic plane come as surrogate pairs.
+                if (code_point >= 0xD800 && code_point < 0xDC00 && _end - _pos >= 6 &&
+                    _pos[0] == '\\' && _pos[1] == 'u') {
+                    const std::string low_hex(_pos + 2, _pos + 6);
+                    const auto low =
+                        static_cast<uint32_t>(std::strtoul(low_hex.c_str(), &hex_end, 16));
+                    if (hex_end == low_hex.c_str() + 4 && low >= 0xDC00 && low < 0xE000) {
+                        code_point = 0x10000 + ((code_point - 0xD800) << 10) + (low - 0xDC00);
+                        _pos += 6;
+                    }
+                }
+                append_utf8(out, code_point);
+                break;
+            }
+            default:
+                return false;
+        }
+    }
+    return false;
+}
+
+bool JsonPullReader::fail()
+{
+    _failed = true;
+    return false;
+}
+
+} // namespace mavsdk
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace mavsdk {
+
+// Reads JSON one value at a time, without building a document, so that
+// large files can be converted straight into the final data structures.
+//
+// Containers are walked with enter_object()/next_key() and
+// enter_array()/next_element(). Once the input is found to be malformed,
+// failed() is set and all further reads fail, so loops end by themselves.
+
+class JsonPullReader {
+public:
+    enum class Type { Null, Bool, Number, String, Array, Object, Invalid };
+
+    JsonPullReader(const char* begin, const char* end);
+
+    // Type of the next value, without consuming it.
+    Type peek();
+
+    bool enter_object();
+    // Returns false once the object is closed, otherwise the value for the
+    // key has to be read or skipped next.
+    bool next_key(std::string& key);
+
+    bool enter_array();
+    // Returns false once the array is closed, otherwise the element has to
+    // be read or skipped next.
+    bool next_element();
+
+    std::optional<double> read_number();
+    std::optional<bool> read_bool();
+    std::optional<std::string> read_string();
+    bool read_null();
+    bool skip_value();
+
+    // True if only whitespace is left after the last value.
+    bool at_end();
+    // Where the next value starts, e.g. to read it again later with a new
+    // reader.
+    const char* position();
+    bool failed() const { return _failed; }
+
+private:
+    void skip_whitespace();
+    bool consume(char c);
+    bool next_in_container(char closing);
+    bool parse_string(std::string& out);
+    bool fail();
+
+    const char* _pos;
+    const char* const _end;
+    // Per open container, whether the next element is the first one.
+    std::vector<bool> _first{};
+    bool _failed{false};
+};
+
+} // namespace mavsdk
@@ -1,31 +1,52 @@
 #pragma once
 
+#include <cstdint>
+#include <map>
 #include <memory>
 #include <mutex>
+#include <optional>
 
 #include <mavsdk.h>
 
 namespace mavsdk::mavsdk_server {
 
+// Creates the plugin of a system when it is first used, one per system.
 template<typename Plugin> class LazyPlugin {
 public:
     explicit LazyPlugin(Mavsdk& mavsdk) : _mavsdk(mavsdk) {}
 
-    Plugin* maybe_plugin()
+    // System id 0 stands for the first system.
+    Plugin* maybe_plugin(uint8_t system_id = 0)
     {
         std::lock_guard<std::mutex> lock(_mutex);
-        if (_plugin == nullptr) {
-            if (_mavsdk.systems().empty()) {
-                return nullptr;
+
+        std::shared_ptr<System> system{};
+        for (auto& candidate : _mavsdk.systems()) {
+            if (system_id == 0 || candidate->get_system_id() == system_id) {
+                system = candidate;
+                break;
             }
-            _plugin = std::make_unique<Plugin>(_mavsdk.systems()[0]);
         }
-        return _plugin.get();
+        if (system == nullptr) {
+            return nullptr;
+        }
+
+        auto& plugin = _plugins[system->get_system_id()];
+        if (plugin == nullptr) {
+            plugin = std::make_unique<Plugin>(system);
+        }
+        return plugin.get();
+    }
+
+    // No system for std::nullopt, an invalid system id.
+    Plugin* maybe_plugin(std::optional<uint8_t> system_id)
+    {
+        return system_id ? maybe_plugin(system_id.value()) : nullptr;
     }
 
 private:
     Mavsdk& _mavsdk;
-    std::unique_ptr<Plugin> _plugin{};
+    std::map<uint8_t, std::unique_ptr<Plugin>> _plugins{};
     std::mutex _mutex{};
 };
 
@@ -1,7 +1,9 @@
 #pragma once
 
+#include <cstdint>
 #include <memory>
 #include <mutex>
+#include <optional>
 
 #include <mavsdk.h>
 
@@ -11,7 +13,9 @@ template<typename ServerPlugin> class LazyServerPlugin {
 public:
     explicit LazyServerPlugin(Mavsdk& mavsdk) : _mavsdk(mavsdk) {}
 
-    ServerPlugin* maybe_plugin()
+    // Server plugins are not tied to a system, the id is only there so
+    // that all services look the same.
+    ServerPlugin* maybe_plugin(uint8_t /* system_id */ = 0)
     {
         std::lock_guard<std::mutex> lock(_mutex);
         if (_server_plugin == nullptr) {
@@ -21,6 +25,8 @@ public:
         return _server_plugin.get();
     }
 
+    ServerPlugin* maybe_plugin(std::optional<uint8_t> /* system_id */) { return maybe_plugin(); }
+
 private:
     Mavsdk& _mavsdk;
     std::unique_ptr<ServerPlugin> _server_plugin{};
@@ -0,0 +1,94 @@
+#include "link_emulator.h"
+
+#include <algorithm>
+
+namespace mavsdk {
+
+LinkEmulator::LinkEmulator(const LinkEmulation& emulation) :
+    _emulation(emulation),
+    _random(emulation.seed)
+{}
+
+bool LinkEmulator::is_active(const LinkEmulation& emulation)
+{
+    return emulation.loss_ratio > 0.0 || emulation.latency_s > 0.0 || emulation.jitter_s > 0.0 ||
+           emulation.bandwidth_bytes_per_s > 0.0 || emulation.reorder_ratio > 0.0;
+}
+
+bool LinkEmulator::offer(const uint8_t* data, size_t len, TimePoint now)
+{
+    ++_statistics.offered;
+
+    if (_emulation.loss_ratio > 0.0 && random_ratio() < _emulation.loss_ratio) {
+        ++_statistics.lost;
+        return false;
+    }
+
+    auto sent = now;
+    if (_emulation.bandwidth_bytes_per_s > 0.0) {
+        const auto start = std::max(now, _link_free_at);
+        if (start - now > to_duration(max_queued_s)) {
+            ++_statistics.overflowed;
+            return false;
+        }
+        _link_free_at =
+            start + to_duration(static_cast<double>(len) / _emulation.bandwidth_bytes_per_s);
+        sent = _link_free_at;
+    }
+
+    double delay_s = _emulation.latency_s;
+    if (_emulation.jitter_s > 0.0) {
+        delay_s += _emulation.jitter_s * random_ratio();
+    }
+    auto due = sent + to_duration(delay_s);
+
+    if (_emulation.reorder_ratio > 0.0 && random_ratio() < _emulation.reorder_ratio) {
+        due += to_duration(reorder_delay_s);
+    } else {
+        due = std::max(due, _last_in_order_due);
+        _last_in_order_due = due;
+    }
+
+    _frames.emplace(std::make_pair(due, _next_sequence++), std::vector<uint8_t>(data, data + len));
+    return true;
+}
+
+void LinkEmulator::take_due(TimePoint now, std::vector<std::vector<uint8_t>>& frames)
+{
+    auto it = _frames.begin();
+    while (it != _frames.end() && it->first.first <= now) {
+        frames.push_back(std::move(it->second));
+        it = _frames.erase(it);
+        ++_statistics.delivered;
+    }
+}
+
+std::optional<LinkEmulator::TimePoint> LinkEmulator::next_due_time() const
+{
+    if (_frames.empty()) {
+        return std::nullopt;
+    }
+    return _frames.begin()->first.first;
+}
+
+size_t LinkEmulator::queued_bytes() const
+{
+    size_t bytes = 0;
+    for (const auto& [key, frame] : _frames) {
+        bytes += frame.size();
+    }
+    return bytes;
+}
+
+std::chrono::steady_clock::duration LinkEmulator::to_duration(double seconds)
+{
+    return std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(seconds));
+}
+
+double LinkEmulator::random_ratio()
+{
+    return _distribution(_random);
+}
+
+} // namespace mavsdk
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "link_emulation.h"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace mavsdk {
+
+// Emulates one direction of a link, such as a telemetry radio, on what is
+// sent over it: frames are lost, delayed, held back by limited bandwidth and
+// reordered as configured.
+//
+// Frames take the bandwidth they need one after the other, then the latency
+// and a random jitter on top. Jitter alone doesn't reorder, as on most
+// links, only frames picked for reordering are held back so that the
+// following ones overtake them.
+//
+// Time is passed in, so that it can be driven by FakeTime, and the same seed
+// gives the same losses. Not thread-safe, the caller needs to lock.
+class LinkEmulator {
+public:
+    using TimePoint = std::chrono::steady_clock::time_point;
+
+    struct Statistics {
+        uint64_t offered{0};
+        uint64_t lost{0};
+        // Dropped because too much was waiting for the bandwidth.
+        uint64_t overflowed{0};
+        uint64_t delivered{0};
+    };
+
+    // Once frames wait this long for the bandwidth, more are dropped.
+    static constexpr double max_queued_s = 2.0;
+    // How long frames picked for reordering are held back on top.
+    static constexpr double reorder_delay_s = 0.05;
+
+    explicit LinkEmulator(const LinkEmulation& emulation);
+    ~LinkEmulator() = default;
+
+    // Non-copyable
+    LinkEmulator(const LinkEmulator&) = delete;
+    const LinkEmulator& operator=(const LinkEmulator&) = delete;
+
+    // Whether the emulation does anything at all.
+    [[nodiscard]] static bool is_active(const LinkEmulation& emulation);
+
+    // Returns false if the frame is lost.
+    bool offer(const uint8_t* data, size_t len, TimePoint now);
+
+    // Appends the frames which have arrived by now, in the order they arrive.
+    void take_due(TimePoint now, std::vector<std::vector<uint8_t>>& frames);
+
+    // When the next frame arrives, if any are on the way.
+    [[nodiscard]] std::optional<TimePoint> next_due_time() const;
+
+    [[nodiscard]] size_t queued_frames() const { return _frames.size(); }
+    [[nodiscard]] size_t queued_bytes() const;
+    [[nodiscard]] Statistics statistics() const { return _statistics; }
+
+private:
+    static std::chrono::steady_clock::duration to_duration(double seconds);
+    double random_ratio();
+
+    const LinkEmulation _emulation;
+    std::mt19937 _random;
+    std::uniform_real_distribution<double> _distribution{0.0, 1.0};
+
+    // By arrival time, and by order offered for the same time.
+    std::map<std::pair<TimePoint, uint64_t>, std::vector<uint8_t>> _frames{};
+    uint64_t _next_sequence{0};
+    TimePoint _link_free_at{};
+    TimePoint _last_in_order_due{};
+
+    Statistics _statistics{};
+};
+
+} // namespace mavsdk
@@ -0,0 +1,188 @@
+#include "link_emulator.h"
+#include "mavsdk_time.h"
+#include <gtest/gtest.h>
+#include <vector>
+
+using namespace mavsdk;
+
+namespace {
+
+std::vector<uint8_t> frame(uint8_t tag, size_t len = 100)
+{
+    return std::vector<uint8_t>(len, tag);
+}
+
+bool offer(LinkEmulator& emulator, uint8_t tag, FakeTime& time, size_t len = 100)
+{
+    const auto data = frame(tag, len);
+    return emulator.offer(data.data(), data.size(), time.steady_time());
+}
+
+std::vector<uint8_t> take_tags(LinkEmulator& emulator, FakeTime& time)
+{
+    std::vector<std::vector<uint8_t>> frames;
+    emulator.take_due(time.steady_time(), frames);
+
+    std::vector<uint8_t> tags;
+    for (const auto& taken : frames) {
+        tags.push_back(taken.front());
+    }
+    return tags;
+}
+
+} // namespace
+
+TEST(LinkEmulator, IsOffByDefault)
+{
+    EXPECT_FALSE(LinkEmulator::is_active(LinkEmulation{}));
+
+    LinkEmulation emulation{};
+    emulation.latency_s = 0.1;
+    EXPECT_TRUE(LinkEmulator::is_active(emulation));
+}
+
+TEST(LinkEmulator, DelaysByLatency)
+{
+    LinkEmulation emulation{};
+    emulation.latency_s = 0.1;
+    LinkEmulator emulator(emulation);
+    FakeTime time;
+
+    EXPECT_TRUE(offer(emulator, 1, time));
+    EXPECT_TRUE(offer(emulator, 2, time));
+    EXPECT_TRUE(take_tags(emulator, time).empty());
+    ASSERT_TRUE(emulator.next_due_time());
+    EXPECT_EQ(
+        emulator.next_due_time().value(), time.steady_time() + std::chrono::milliseconds(100));
+
+    time.sleep_for(std::chrono::milliseconds(99));
+    EXPECT_TRUE(take_tags(emulator, time).empty());
+
+    time.sleep_for(std::chrono::milliseconds(1));
+    EXPECT_EQ(take_tags(emulator, time), (std::vector<uint8_t>{1, 2}));
+    EXPECT_FALSE(emulator.next_due_time());
+}
+
+TEST(LinkEmulator, LosesShareOfFrames)
+{
+    LinkEmulation emulation{};
+    emulation.loss_ratio = 0.2;
+    emulation.seed = 42;
+    LinkEmulator emulator(emulation);
+    FakeTime time;
+
+    unsigned num_lost = 0;
+    for (unsigned i = 0; i < 1000; ++i) {
+        if (!offer(emulator, 1, time)) {
+            ++num_lost;
+        }
+    }
+    EXPECT_GT(num_lost, 150u);
+    EXPECT_LT(num_lost, 250u);
+    EXPECT_EQ(emulator.statistics().lost, num_lost);
+    EXPECT_EQ(take_tags(emulator, time).size(), 1000u - num_lost);
+}
+
+TEST(LinkEmulator, SameSeedSameLink)
+{
+    LinkEmulation emulation{};
+    emulation.loss_ratio = 0.5;
+    emulation.jitter_s = 0.01;
+    emulation.seed = 7;
+    LinkEmulator first(emulation);
+    LinkEmulator second(emulation);
+    FakeTime time;
+
+    for (uint8_t tag = 0; tag < 100; ++tag) {
+        EXPECT_EQ(offer(first, tag, time), offer(second, tag, time));
+        EXPECT_EQ(first.next_due_time(), second.next_due_time());
+    }
+}
+
+TEST(LinkEmulator, LimitsBandwidth)
+{
+    // 100 bytes take 10 ms.
+    LinkEmulation emulation{};
+    emulation.bandwidth_bytes_per_s = 10000.0;
+    LinkEmulator emulator(emulation);
+    FakeTime time;
+
+    for (uint8_t tag = 1; tag <= 3; ++tag) {
+        EXPECT_TRUE(offer(emulator, tag, time));
+    }
+
+    time.sleep_for(std::chrono::milliseconds(10));
+    EXPECT_EQ(take_tags(emulator, time), (std::vector<uint8_t>{1}));
+    time.sleep_for(std::chrono::milliseconds(20));
+    EXPECT_EQ(take_tags(emulator, time), (std::vector<uint8_t>{2, 3}));
+}
+
+TEST(LinkEmulator, DropsWhenBandwidthOverflows)
+{
+    // Each frame takes 100 ms.
+    LinkEmulation emulation{};
+    emulation.bandwidth_bytes_per_s = 1000.0;
+    LinkEmulator emulator(emulation);
+    FakeTime time;
+
+    unsigned num_accepted = 0;
+    for (unsigned i = 0; i < 100; ++i) {
+        if (offer(emulator, 1, time)) {
+            ++num_accepted;
+        }
+    }
+
+    // About max_queued_s worth of frames.
+    EXPECT_GE(num_accepted, 20u);
+    EXPECT_LE(num_accepted, 22u);
+    EXPECT_EQ(emulator.statistics().overflowed, 100u - num_accepted);
+}
+
+TEST(LinkEmulator, JitterKeepsOrder)
+{
+    LinkEmulation emulation{};
+    emulation.latency_s = 0.01;
+    emulation.jitter_s = 0.05;
+    emulation.seed = 3;
+    LinkEmulator emulator(emulation);
+    FakeTime time;
+
+    for (uint8_t tag = 0; tag < 100; ++tag) {
+        EXPECT_TRUE(offer(emulator, tag, time));
+        time.sleep_for(std::chrono::milliseconds(1));
+    }
+
+    time.sleep_for(std::chrono::milliseconds(100));
+    const auto tags = take_tags(emulator, time);
+    ASSERT_EQ(tags.size(), 100u);
+    for (uint8_t tag = 0; tag < 100; ++tag) {
+        EXPECT_EQ(tags[tag], tag);
+    }
+}
+
+TEST(LinkEmulator, ReordersShareOfFrames)
+{
+    LinkEmulation emulation{};
+    emulation.latency_s = 0.01;
+    emulation.reorder_ratio = 0.5;
+    emulation.seed = 5;
+    LinkEmulator emulator(emulation);
+    FakeTime time;
+
+    for (uint8_t tag = 0; tag < 100; ++tag) {
+        EXPECT_TRUE(offer(emulator, tag, time));
+        time.sleep_for(std::chrono::milliseconds(1));
+    }
+
+    time.sleep_for(std::chrono::milliseconds(100));
+    const auto tags = take_tags(emulator, time);
+    ASSERT_EQ(tags.size(), 100u);
+
+    unsigned num_overtaken = 0;
+    for (size_t i = 1; i < tags.size(); ++i) {
+        if (tags[i] < tags[i - 1]) {
+            ++num_overtaken;
+        }
+    }
+    EXPECT_GT(num_overtaken, 10u);
+}
@@ -0,0 +1,106 @@
+#include "link_statistics.h"
+#include "message_statistics.h"
+
+namespace mavsdk {
+
+void SequenceTracker::update(uint8_t seq)
+{
+    ++_received_count;
+
+    if (!_initialized) {
+        _initialized = true;
+        _last_seq = seq;
+        _window = 1;
+        return;
+    }
+
+    const uint8_t ahead = static_cast<uint8_t>(seq - _last_seq);
+    if (ahead == 0) {
+        ++_duplicate_count;
+        return;
+    }
+
+    if (ahead < 128) {
+        _lost_count += ahead - 1;
+        _window = ahead < window_size ? (_window << ahead) | 1 : 1;
+        _last_seq = seq;
+        return;
+    }
+
+    const uint8_t behind = static_cast<uint8_t>(_last_seq - seq);
+    if (behind < window_size) {
+        const uint64_t bit = uint64_t(1) << behind;
+        if ((_window & bit) != 0) {
+            ++_duplicate_count;
+        } else {
+            // We had counted it as lost when we jumped over it.
+            _window |= bit;
+            ++_reordered_count;
+            if (_lost_count > 0) {
+                --_lost_count;
+            }
+        }
+        return;
+    }
+
+    // Way too late to be just out of order, the sender probably restarted.
+    _last_seq = seq;
+    _window = 1;
+}
+
+void LinkStatistics::count_received(const mavlink_message_t& message, unsigned parse_errors)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    _received_bytes += MessageStatistics::frame_len(message);
+    _parse_errors += parse_errors;
+
+    const uint16_t key = static_cast<uint16_t>((message.sysid << 8) | message.compid);
+    _remotes[key].tracker.update(message.seq);
+}
+
+LinkStats LinkStatistics::report(double elapsed_s)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    LinkStats stats;
+    stats.received_bytes = _received_bytes;
+    stats.parse_errors = _parse_errors;
+    if (elapsed_s > 0.0) {
+        stats.received_bytes_per_s =
+            static_cast<double>(_received_bytes - _reported_received_bytes) / elapsed_s;
+    }
+    _reported_received_bytes = _received_bytes;
+
+    for (auto& entry : _remotes) {
+        auto& remote = entry.second;
+        const auto& tracker = remote.tracker;
+
+        LinkStats::Remote remote_stats;
+        remote_stats.system_id = static_cast<uint8_t>(entry.first >> 8);
+        remote_stats.component_id = static_cast<uint8_t>(entry.first & 0xff);
+        remote_stats.received_count = tracker.received_count();
+        remote_stats.lost_count = tracker.lost_count();
+        remote_stats.duplicate_count = tracker.duplicate_count();
+        remote_stats.reordered_count = tracker.reordered_count();
+
+        const uint64_t unique_count = tracker.received_count() - tracker.duplicate_count();
+        const uint64_t unique_delta = unique_count - remote.reported_unique_count;
+        // Lost messages can turn up late, after having been reported.
+        const uint64_t lost_delta = tracker.lost_count() > remote.reported_lost_count ?
+                                        tracker.lost_count() - remote.reported_lost_count :
+                                        0;
+        if (unique_delta + lost_delta > 0) {
+            remote_stats.loss_ratio =
+                static_cast<float>(lost_delta) / static_cast<float>(unique_delta + lost_delta);
+        }
+        remote.reported_unique_count = unique_count;
+        remote.reported_lost_count = tracker.lost_count();
+
+        stats.remotes.push_back(remote_stats);
+    }
+
+    return stats;
+}
+
+} // namespace mavsdk
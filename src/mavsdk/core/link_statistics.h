@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include "link_stats.h"
+#include "mavlink_include.h"
+
+namespace mavsdk {
+
+// Keeps track of the sequence numbers of one sender.
+//
+// The last 64 sequence numbers are remembered, so that a message arriving
+// late can be told apart from a duplicate, and is not counted as lost anymore.
+class SequenceTracker {
+public:
+    void update(uint8_t seq);
+
+    uint64_t received_count() const { return _received_count; }
+    uint64_t lost_count() const { return _lost_count; }
+    uint64_t duplicate_count() const { return _duplicate_count; }
+    uint64_t reordered_count() const { return _reordered_count; }
+
+private:
+    static constexpr unsigned window_size = 64;
+
+    bool _initialized{false};
+    uint8_t _last_seq{0};
+    // Bit i is set if _last_seq - i has been received.
+    uint64_t _window{0};
+
+    uint64_t _received_count{0};
+    uint64_t _lost_count{0};
+    uint64_t _duplicate_count{0};
+    uint64_t _reordered_count{0};
+};
+
+// Statistics of one connection, counted on its receive thread and reported
+// from another one.
+class LinkStatistics {
+public:
+    LinkStatistics() = default;
+    ~LinkStatistics() = default;
+
+    LinkStatistics(const LinkStatistics&) = delete;
+    LinkStatistics& operator=(const LinkStatistics&) = delete;
+
+    void count_received(const mavlink_message_t& message, unsigned parse_errors);
+
+    // The rates are calculated over the time since the previous report.
+    LinkStats report(double elapsed_s);
+
+private:
+    struct Remote {
+        SequenceTracker tracker{};
+        // At the previous report.
+        uint64_t reported_unique_count{0};
+        uint64_t reported_lost_count{0};
+    };
+
+    std::mutex _mutex{};
+    std::map<uint16_t, Remote> _remotes{}; // Needs _mutex
+    uint64_t _received_bytes{0}; // Needs _mutex
+    uint64_t _reported_received_bytes{0}; // Needs _mutex
+    uint64_t _parse_errors{0}; // Needs _mutex
+};
+
+} // namespace mavsdk
@@ -0,0 +1,99 @@
+#include "link_statistics.h"
+#include <gtest/gtest.h>
+#include <vector>
+
+using namespace mavsdk;
+
+namespace {
+
+SequenceTracker track(const std::vector<uint8_t>& seqs)
+{
+    SequenceTracker tracker;
+    for (const auto seq : seqs) {
+        tracker.update(seq);
+    }
+    return tracker;
+}
+
+} // namespace
+
+TEST(LinkStatistics, InOrderAcrossWrap)
+{
+    const auto tracker = track({253, 254, 255, 0, 1});
+    EXPECT_EQ(tracker.received_count(), 5);
+    EXPECT_EQ(tracker.lost_count(), 0);
+    EXPECT_EQ(tracker.duplicate_count(), 0);
+    EXPECT_EQ(tracker.reordered_count(), 0);
+}
+
+TEST(LinkStatistics, Lost)
+{
+    const auto tracker = track({10, 11, 14, 15, 100, 200, 1});
+    EXPECT_EQ(tracker.lost_count(), 2 + 84 + 99 + 56);
+}
+
+TEST(LinkStatistics, Duplicates)
+{
+    const auto tracker = track({10, 10, 11, 12, 11});
+    EXPECT_EQ(tracker.received_count(), 5);
+    EXPECT_EQ(tracker.duplicate_count(), 2);
+    EXPECT_EQ(tracker.lost_count(), 0);
+}
+
+TEST(LinkStatistics, Reordered)
+{
+    const auto tracker = track({10, 12, 11, 13});
+    EXPECT_EQ(tracker.reordered_count(), 1);
+    EXPECT_EQ(tracker.lost_count(), 0);
+    EXPECT_EQ(tracker.duplicate_count(), 0);
+}
+
+TEST(LinkStatistics, SenderRestarted)
+{
+    // Jumping back further than what could still be in flight.
+    const auto tracker = track({200, 201, 100, 101});
+    EXPECT_EQ(tracker.lost_count(), 0);
+    EXPECT_EQ(tracker.reordered_count(), 0);
+}
+
+TEST(LinkStatistics, ReportPerSender)
+{
+    LinkStatistics link_statistics;
+
+    mavlink_message_t message{};
+    message.magic = MAVLINK_STX;
+    message.len = 10;
+
+    message.sysid = 1;
+    message.compid = 1;
+    for (uint8_t seq : {0, 1, 3, 4}) {
+        message.seq = seq;
+        link_statistics.count_received(message, 0);
+    }
+
+    message.sysid = 2;
+    message.compid = 100;
+    message.seq = 7;
+    link_statistics.count_received(message, 2);
+
+    auto stats = link_statistics.report(2.0);
+    EXPECT_EQ(stats.received_bytes, 5 * (MAVLINK_NUM_NON_PAYLOAD_BYTES + 10));
+    EXPECT_DOUBLE_EQ(stats.received_bytes_per_s, 5 * (MAVLINK_NUM_NON_PAYLOAD_BYTES + 10) / 2.0);
+    EXPECT_EQ(stats.parse_errors, 2);
+
+    ASSERT_EQ(stats.remotes.size(), 2);
+    EXPECT_EQ(stats.remotes[0].system_id, 1);
+    EXPECT_EQ(stats.remotes[0].component_id, 1);
+    EXPECT_EQ(stats.remotes[0].received_count, 4);
+    EXPECT_EQ(stats.remotes[0].lost_count, 1);
+    EXPECT_FLOAT_EQ(stats.remotes[0].loss_ratio, 0.2f);
+    EXPECT_EQ(stats.remotes[1].system_id, 2);
+    EXPECT_EQ(stats.remotes[1].component_id, 100);
+    EXPECT_FLOAT_EQ(stats.remotes[1].loss_ratio, 0.0f);
+
+    // Nothing new in the next interval.
+    stats = link_statistics.report(1.0);
+    EXPECT_DOUBLE_EQ(stats.received_bytes_per_s, 0.0);
+    EXPECT_FLOAT_EQ(stats.remotes[0].loss_ratio, 0.0f);
+    EXPECT_EQ(stats.remotes[0].lost_count, 1);
+}
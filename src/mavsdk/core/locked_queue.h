@@ -1,34 +1,55 @@
 #pragma once
 
+#include <atomic>
 #include <queue>
 #include <mutex>
 #include <memory>
+#include <functional>
+#include <vector>
 
 namespace mavsdk {
 
+// Work items of the protocol state machines, which are worked through with
+// a Guard held, possibly while callbacks are called.
+//
+// Items are pushed to a separate list with its own lock, so queueing new
+// work never waits for the processing. They are moved into the queue when
+// the next Guard is taken.
 template<class T> class LockedQueue {
 public:
     LockedQueue() = default;
     ~LockedQueue() = default;
 
+    // The notifier is called whenever items are added or removed, so whoever
+    // works through the queue can be woken up instead of having to poll.
+    // It must not access the queue itself.
+    void set_notifier(std::function<void()> notifier) { _notifier = std::move(notifier); }
+
     void push_back(std::shared_ptr<T> item_ptr)
     {
-        std::lock_guard<std::mutex> lock(_mutex);
-        _queue.push_back(item_ptr);
+        {
+            std::lock_guard<std::mutex> lock(_incoming_mutex);
+            _incoming.push_back(std::move(item_ptr));
+        }
+        _size.fetch_add(1, std::memory_order_relaxed);
+        notify();
     }
 
-    size_t size()
-    {
-        std::lock_guard<std::mutex> lock(_mutex);
-        return _queue.size();
-    }
+    size_t size() const { return _size.load(std::memory_order_relaxed); }
 
+    // Iterating and erasing is only allowed with a Guard held.
     using iterator = typename std::deque<std::shared_ptr<T>>::iterator;
     iterator begin() { return _queue.begin(); }
 
     iterator end() { return _queue.end(); }
 
-    iterator erase(iterator it) { return _queue.erase(it); }
+    iterator erase(iterator it)
+    {
+        auto next = _queue.erase(it);
+        _size.fetch_sub(1, std::memory_order_relaxed);
+        notify();
+        return next;
+    }
 
     // This guard serves the purpose to combine a get_front with a pop_front.
     // Thus, no one can interfere between the two steps.
@@ -37,6 +58,7 @@ public:
         explicit Guard(LockedQueue& locked_queue) : _locked_queue(locked_queue)
         {
             _locked_queue._mutex.lock();
+            _locked_queue.take_incoming();
         }
 
         ~Guard() { _locked_queue._mutex.unlock(); }
@@ -56,15 +78,47 @@ public:
             return _locked_queue._queue.front();
         }
 
-        void pop_front() { _locked_queue._queue.pop_front(); }
+        void pop_front()
+        {
+            if (_locked_queue._queue.empty()) {
+                return;
+            }
+            _locked_queue._queue.pop_front();
+            _locked_queue._size.fetch_sub(1, std::memory_order_relaxed);
+            _locked_queue.notify();
+        }
 
     private:
         LockedQueue<T>& _locked_queue;
     };
 
 private:
-    std::deque<std::shared_ptr<T>> _queue{};
+    void notify()
+    {
+        if (_notifier) {
+            _notifier();
+        }
+    }
+
+    // Needs _mutex
+    void take_incoming()
+    {
+        std::lock_guard<std::mutex> lock(_incoming_mutex);
+        for (auto& item_ptr : _incoming) {
+            _queue.push_back(std::move(item_ptr));
+        }
+        // Keeps its capacity, so pushing doesn't allocate again.
+        _incoming.clear();
+    }
+
+    std::deque<std::shared_ptr<T>> _queue{}; // Needs _mutex
     std::mutex _mutex{};
+
+    std::vector<std::shared_ptr<T>> _incoming{}; // Needs _incoming_mutex
+    std::mutex _incoming_mutex{};
+
+    std::atomic<size_t> _size{0};
+    std::function<void()> _notifier{};
 };
 
 } // namespace mavsdk
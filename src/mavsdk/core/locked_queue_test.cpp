@@ -51,6 +51,8 @@ TEST(LockedQueue, FillAndIterateAndErase)
     locked_queue.push_back(std::make_shared<int>(three));
     EXPECT_EQ(locked_queue.size(), 3);
 
+    LockedQueue<int>::Guard guard(locked_queue);
+
     unsigned counter = 0;
     for (const auto& item : locked_queue) {
         ++counter;
@@ -214,3 +216,33 @@ TEST(LockedQueue, Guard)
         // more pops shouldn't do anything
     }
 }
+
+TEST(LockedQueue, PushingDoesNotWaitForGuard)
+{
+    LockedQueue<int> locked_queue{};
+    locked_queue.push_back(std::make_shared<int>(1));
+
+    {
+        LockedQueue<int>::Guard guard(locked_queue);
+        EXPECT_EQ(*guard.get_front(), 1);
+
+        auto pushed = std::async(std::launch::async, [&locked_queue]() {
+            locked_queue.push_back(std::make_shared<int>(2));
+        });
+        EXPECT_EQ(pushed.wait_for(std::chrono::seconds(1)), std::future_status::ready);
+        EXPECT_EQ(locked_queue.size(), 2);
+
+        // Only seen by the next guard.
+        guard.pop_front();
+        EXPECT_EQ(guard.get_front(), nullptr);
+    }
+
+    {
+        LockedQueue<int>::Guard guard(locked_queue);
+        EXPECT_EQ(*guard.get_front(), 2);
+        guard.pop_front();
+        guard.pop_front();
+        EXPECT_EQ(guard.get_front(), nullptr);
+    }
+    EXPECT_EQ(locked_queue.size(), 0);
+}
@@ -1,6 +1,16 @@
 #include "log.h"
 #include "unused.h"
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
 #if defined(WINDOWS)
 #include "windows_include.h"
 #define WIN_COLOR_RED 4
@@ -32,6 +42,281 @@ void log::subscribe(const log::Callback& callback)
     callback_ = callback;
 }
 
+namespace {
+
+void print_log_line(
+    log::Level level, const std::string& message, const char* filename, int line, time_t timestamp)
+{
+#if ANDROID
+    switch (level) {
+        case log::Level::Debug:
+            __android_log_print(ANDROID_LOG_DEBUG, "Mavsdk", "%s", message.c_str());
+            break;
+        case log::Level::Info:
+            __android_log_print(ANDROID_LOG_INFO, "Mavsdk", "%s", message.c_str());
+            break;
+        case log::Level::Warn:
+            __android_log_print(ANDROID_LOG_WARN, "Mavsdk", "%s", message.c_str());
+            break;
+        case log::Level::Err:
+            __android_log_print(ANDROID_LOG_ERROR, "Mavsdk", "%s", message.c_str());
+            break;
+    }
+    // Unused:
+    (void)filename;
+    (void)line;
+    (void)timestamp;
+#else
+
+    switch (level) {
+        case log::Level::Debug:
+            set_color(Color::Green);
+            break;
+        case log::Level::Info:
+            set_color(Color::Blue);
+            break;
+        case log::Level::Warn:
+            set_color(Color::Yellow);
+            break;
+        case log::Level::Err:
+            set_color(Color::Red);
+            break;
+    }
+
+    // Time output taken from:
+    // https://stackoverflow.com/questions/16357999#answer-16358264
+    struct tm* timeinfo = localtime(&timestamp);
+    char time_buffer[10]{}; // We need 8 characters + \0
+    strftime(time_buffer, sizeof(time_buffer), "%I:%M:%S", timeinfo);
+    std::cout << "[" << time_buffer;
+
+    switch (level) {
+        case log::Level::Debug:
+            std::cout << "|Debug] ";
+            break;
+        case log::Level::Info:
+            std::cout << "|Info ] ";
+            break;
+        case log::Level::Warn:
+            std::cout << "|Warn ] ";
+            break;
+        case log::Level::Err:
+            std::cout << "|Error] ";
+            break;
+    }
+
+    set_color(Color::Reset);
+
+    std::cout << message;
+    std::cout << " (" << filename << ":" << std::dec << line << ")";
+
+    std::cout << '\n';
+#endif
+}
+
+// Log lines are put into a ring buffer of the logging thread, and written out
+// by a background thread, so logging only costs formatting the message.
+class AsyncLogWriter {
+public:
+    AsyncLogWriter() = default;
+    ~AsyncLogWriter() { stop(); }
+
+    // delete copy and move constructors and assign operators
+    AsyncLogWriter(AsyncLogWriter const&) = delete; // Copy construct
+    AsyncLogWriter(AsyncLogWriter&&) = delete; // Move construct
+    AsyncLogWriter& operator=(AsyncLogWriter const&) = delete; // Copy assign
+    AsyncLogWriter& operator=(AsyncLogWriter&&) = delete; // Move assign
+
+    static AsyncLogWriter& instance()
+    {
+        static AsyncLogWriter writer;
+        return writer;
+    }
+
+    bool enabled() const { return _enabled.load(std::memory_order_relaxed); }
+
+    void start()
+    {
+        std::lock_guard<std::mutex> lock(_thread_mutex);
+        if (_thread == nullptr) {
+            _should_exit = false;
+            _thread = std::make_unique<std::thread>(&AsyncLogWriter::run, this);
+        }
+        _enabled = true;
+    }
+
+    void stop()
+    {
+        std::lock_guard<std::mutex> lock(_thread_mutex);
+        _enabled = false;
+        if (_thread != nullptr) {
+            {
+                std::lock_guard<std::mutex> wakeup_lock(_wakeup_mutex);
+                _should_exit = true;
+            }
+            _wakeup_cv.notify_one();
+            _thread->join();
+            _thread.reset();
+        }
+        // Whatever came in in the meantime.
+        flush();
+    }
+
+    void push(log::Level level, const std::string& message, const char* filename, int line)
+    {
+        ThreadBuffer& buffer = thread_buffer();
+
+        const size_t head = buffer.head.load(std::memory_order_relaxed);
+        if (head - buffer.tail.load(std::memory_order_acquire) == buffer.records.size()) {
+            buffer.dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        Record& record = buffer.records[head % buffer.records.size()];
+        record.sequence = _next_sequence.fetch_add(1, std::memory_order_relaxed);
+        record.level = level;
+        record.message = message;
+        record.filename = filename;
+        record.line = line;
+        record.time = ::time(nullptr);
+        buffer.head.store(head + 1, std::memory_order_release);
+
+        // Anything important should show up right away.
+        if (level >= log::Level::Warn) {
+            _wakeup_cv.notify_one();
+        }
+    }
+
+private:
+    struct Record {
+        uint64_t sequence{0};
+        log::Level level{log::Level::Debug};
+        std::string message{};
+        const char* filename{nullptr};
+        int line{0};
+        time_t time{0};
+    };
+
+    // Only written by its thread, and only read by the writer thread.
+    struct ThreadBuffer {
+        std::array<Record, 1024> records{};
+        std::atomic<size_t> head{0};
+        std::atomic<size_t> tail{0};
+        std::atomic<unsigned> dropped{0};
+    };
+
+    ThreadBuffer& thread_buffer()
+    {
+        thread_local std::shared_ptr<ThreadBuffer> buffer;
+        if (buffer == nullptr) {
+            buffer = std::make_shared<ThreadBuffer>();
+            std::lock_guard<std::mutex> lock(_buffers_mutex);
+            _buffers.push_back(buffer);
+        }
+        return *buffer;
+    }
+
+    void run()
+    {
+        std::unique_lock<std::mutex> lock(_wakeup_mutex);
+        while (!_should_exit) {
+            _wakeup_cv.wait_for(lock, std::chrono::milliseconds(10));
+            lock.unlock();
+            flush();
+            lock.lock();
+        }
+    }
+
+    void flush()
+    {
+        std::lock_guard<std::mutex> flush_lock(_flush_mutex);
+
+        {
+            std::lock_guard<std::mutex> lock(_buffers_mutex);
+            for (auto it = _buffers.begin(); it != _buffers.end();) {
+                ThreadBuffer& buffer = **it;
+                const size_t head = buffer.head.load(std::memory_order_acquire);
+                size_t tail = buffer.tail.load(std::memory_order_relaxed);
+                for (; tail != head; ++tail) {
+                    _pending.push_back(std::move(buffer.records[tail % buffer.records.size()]));
+                }
+                buffer.tail.store(tail, std::memory_order_release);
+
+                _dropped += buffer.dropped.exchange(0, std::memory_order_relaxed);
+
+                // The thread is gone, and everything is written.
+                if (it->use_count() == 1) {
+                    it = _buffers.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+        }
+
+        // Each thread's lines are in order but we need to merge them.
+        std::sort(_pending.begin(), _pending.end(), [](const Record& lhs, const Record& rhs) {
+            return lhs.sequence < rhs.sequence;
+        });
+
+        for (const auto& record : _pending) {
+            print_log_line(record.level, record.message, record.filename, record.line, record.time);
+        }
+        _pending.clear();
+
+        if (_dropped > 0) {
+            print_log_line(
+                log::Level::Warn,
+                std::to_string(_dropped) + " log lines dropped",
+                FILENAME,
+                __LINE__,
+                ::time(nullptr));
+            _dropped = 0;
+        }
+
+        std::cout.flush();
+    }
+
+    std::atomic<bool> _enabled{false};
+    std::atomic<uint64_t> _next_sequence{0};
+
+    std::mutex _buffers_mutex{};
+    std::vector<std::shared_ptr<ThreadBuffer>> _buffers{};
+
+    // Only used by flush.
+    std::mutex _flush_mutex{};
+    std::vector<Record> _pending{};
+    unsigned _dropped{0};
+
+    std::mutex _thread_mutex{};
+    std::unique_ptr<std::thread> _thread{};
+    std::mutex _wakeup_mutex{};
+    std::condition_variable _wakeup_cv{};
+    bool _should_exit{false};
+};
+
+} // namespace
+
+void log::set_async(bool enabled)
+{
+    if (enabled) {
+        AsyncLogWriter::instance().start();
+    } else {
+        AsyncLogWriter::instance().stop();
+    }
+}
+
+void write_log_line(log::Level level, const std::string& message, const char* filename, int line)
+{
+    if (AsyncLogWriter::instance().enabled()) {
+        AsyncLogWriter::instance().push(level, message, filename, line);
+        return;
+    }
+
+    time_t rawtime;
+    time(&rawtime);
+    print_log_line(level, message, filename, line, rawtime);
+}
+
 void set_color(Color color)
 {
 #if defined(WINDOWS)
@@ -20,10 +20,19 @@
 
 #define call_user_callback(...) call_user_callback_located(FILENAME, __LINE__, __VA_ARGS__)
 
-#define LogDebug() LogDebugDetailed(FILENAME, __LINE__)
-#define LogInfo() LogInfoDetailed(FILENAME, __LINE__)
-#define LogWarn() LogWarnDetailed(FILENAME, __LINE__)
-#define LogErr() LogErrDetailed(FILENAME, __LINE__)
+// Log statements below this level are compiled out, e.g. with
+// -DMAVSDK_LOG_MIN_LEVEL=1 to drop all debug output.
+#if !defined(MAVSDK_LOG_MIN_LEVEL)
+#define MAVSDK_LOG_MIN_LEVEL 0
+#endif
+
+#define MAVSDK_LOG_IF(min_level, log_detailed) \
+    !((min_level) >= MAVSDK_LOG_MIN_LEVEL) ? (void)0 : LogVoidify() & log_detailed(FILENAME, __LINE__)
+
+#define LogDebug() MAVSDK_LOG_IF(0, LogDebugDetailed)
+#define LogInfo() MAVSDK_LOG_IF(1, LogInfoDetailed)
+#define LogWarn() MAVSDK_LOG_IF(2, LogWarnDetailed)
+#define LogErr() MAVSDK_LOG_IF(3, LogErrDetailed)
 
 namespace mavsdk {
 
@@ -31,6 +40,10 @@ enum class Color { Red, Green, Yellow, Blue, Gray, Reset };
 
 void set_color(Color color);
 
+// Writes to stdout (or logcat), either right away or using the background
+// thread if async logging is enabled.
+void write_log_line(log::Level level, const std::string& message, const char* filename, int line);
+
 class LogDetailed {
 public:
     LogDetailed(const char* filename, int filenumber) :
@@ -52,72 +65,7 @@ public:
             return;
         }
 
-#if ANDROID
-        switch (_log_level) {
-            case log::Level::Debug:
-                __android_log_print(ANDROID_LOG_DEBUG, "Mavsdk", "%s", _s.str().c_str());
-                break;
-            case log::Level::Info:
-                __android_log_print(ANDROID_LOG_INFO, "Mavsdk", "%s", _s.str().c_str());
-                break;
-            case log::Level::Warn:
-                __android_log_print(ANDROID_LOG_WARN, "Mavsdk", "%s", _s.str().c_str());
-                break;
-            case log::Level::Err:
-                __android_log_print(ANDROID_LOG_ERROR, "Mavsdk", "%s", _s.str().c_str());
-                break;
-        }
-        // Unused:
-        (void)_caller_filename;
-        (void)_caller_filenumber;
-#else
-
-        switch (_log_level) {
-            case log::Level::Debug:
-                set_color(Color::Green);
-                break;
-            case log::Level::Info:
-                set_color(Color::Blue);
-                break;
-            case log::Level::Warn:
-                set_color(Color::Yellow);
-                break;
-            case log::Level::Err:
-                set_color(Color::Red);
-                break;
-        }
-
-        // Time output taken from:
-        // https://stackoverflow.com/questions/16357999#answer-16358264
-        time_t rawtime;
-        time(&rawtime);
-        struct tm* timeinfo = localtime(&rawtime);
-        char time_buffer[10]{}; // We need 8 characters + \0
-        strftime(time_buffer, sizeof(time_buffer), "%I:%M:%S", timeinfo);
-        std::cout << "[" << time_buffer;
-
-        switch (_log_level) {
-            case log::Level::Debug:
-                std::cout << "|Debug] ";
-                break;
-            case log::Level::Info:
-                std::cout << "|Info ] ";
-                break;
-            case log::Level::Warn:
-                std::cout << "|Warn ] ";
-                break;
-            case log::Level::Err:
-                std::cout << "|Error] ";
-                break;
-        }
-
-        set_color(Color::Reset);
-
-        std::cout << _s.str();
-        std::cout << " (" << _caller_filename << ":" << std::dec << _caller_filenumber << ")";
-
-        std::cout << '\n';
-#endif
+        write_log_line(_log_level, _s.str(), _caller_filename, _caller_filenumber);
     }
 
     LogDetailed(const mavsdk::LogDetailed&) = delete;
@@ -164,4 +112,10 @@ public:
     }
 };
 
+// Turns the log statement into a void expression, so that it can be used in
+// the conditional of MAVSDK_LOG_IF. The & binds weaker than <<.
+struct LogVoidify {
+    void operator&(const LogDetailed&) {}
+};
+
 } // namespace mavsdk
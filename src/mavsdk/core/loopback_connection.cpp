@@ -0,0 +1,192 @@
+#include "loopback_connection.h"
+#include "log.h"
+#include "receive_burst.h"
+#include "thread_config.h"
+
+#include <algorithm>
+#include <array>
+#include <map>
+#include <mutex>
+#include <utility>
+
+namespace mavsdk {
+
+namespace {
+
+// The connections started with each name, the two ends of the loopback.
+struct Registry {
+    std::mutex mutex{};
+    std::map<std::string, std::array<LoopbackConnection*, 2>> ends{}; // Needs mutex
+};
+
+Registry& registry()
+{
+    static Registry instance;
+    return instance;
+}
+
+} // namespace
+
+LoopbackConnection::LoopbackConnection(
+    Connection::ReceiverCallback receiver_callback,
+    std::string name,
+    ForwardingOption forwarding_option) :
+    Connection(std::move(receiver_callback), forwarding_option),
+    _name(std::move(name))
+{}
+
+LoopbackConnection::~LoopbackConnection()
+{
+    // If no one explicitly called stop before, we should at least do it.
+    stop();
+}
+
+ConnectionResult LoopbackConnection::start()
+{
+    if (_name.empty()) {
+        return ConnectionResult::ConnectionUrlInvalid;
+    }
+
+    start_mavlink_receiver();
+    _queue = std::make_shared<Queue>(queue_capacity, CallbackQueueBase::OverflowPolicy::DropNewest);
+
+    {
+        auto& instance = registry();
+        std::lock_guard<std::mutex> lock(instance.mutex);
+
+        auto& ends = instance.ends[_name];
+        const auto free_end = std::find(ends.begin(), ends.end(), nullptr);
+        if (free_end == ends.end()) {
+            LogErr() << "Loopback " << _name << " already has two ends";
+            _queue.reset();
+            stop_mavlink_receiver();
+            return ConnectionResult::ConnectionsExhausted;
+        }
+        *free_end = this;
+
+        auto* other = ends[0] == this ? ends[1] : ends[0];
+        if (other != nullptr) {
+            std::atomic_store(&other->_peer_queue, _queue);
+            std::atomic_store(&_peer_queue, other->_queue);
+        }
+    }
+
+    _receive_thread = std::make_unique<std::thread>(&LoopbackConnection::receive, this);
+    start_send_scheduler();
+    _started = true;
+
+    return ConnectionResult::Success;
+}
+
+ConnectionResult LoopbackConnection::stop()
+{
+    if (!_started) {
+        return ConnectionResult::Success;
+    }
+
+    stop_send_scheduler();
+
+    {
+        auto& instance = registry();
+        std::lock_guard<std::mutex> lock(instance.mutex);
+
+        auto it = instance.ends.find(_name);
+        if (it != instance.ends.end()) {
+            for (auto& end : it->second) {
+                if (end == this) {
+                    end = nullptr;
+                } else if (end != nullptr) {
+                    std::atomic_store(&end->_peer_queue, std::shared_ptr<Queue>{});
+                }
+            }
+            if (it->second[0] == nullptr && it->second[1] == nullptr) {
+                instance.ends.erase(it);
+            }
+        }
+        std::atomic_store(&_peer_queue, std::shared_ptr<Queue>{});
+    }
+
+    // The other end might still be sending to the queue, it is only gone
+    // once it let go of it.
+    _queue->stop();
+    _receive_thread->join();
+    _receive_thread.reset();
+    _queue.reset();
+
+    // We need to stop this after stopping the receive thread, otherwise
+    // it could still be used there.
+    stop_mavlink_receiver();
+
+    _started = false;
+    return ConnectionResult::Success;
+}
+
+bool LoopbackConnection::send_message(const mavlink_message_t& message)
+{
+    Item item{};
+    item.message = _message_pool.acquire();
+    item.message.mutable_message() = message;
+    return enqueue(std::move(item));
+}
+
+size_t LoopbackConnection::memory_usage()
+{
+    // What the queued items hold is in the pool of the other end.
+    return Connection::memory_usage() + _message_pool.memory_usage() +
+           (_queue ? _queue->memory_usage() : 0);
+}
+
+bool LoopbackConnection::send_frames(const uint8_t* data, size_t len)
+{
+    // These are already serialized, e.g. forwarded, so they are parsed on
+    // the other end like from any other link.
+    Item item{};
+    item.frames.assign(data, data + len);
+    return enqueue(std::move(item));
+}
+
+bool LoopbackConnection::enqueue(Item item)
+{
+    auto peer_queue = std::atomic_load(&_peer_queue);
+    if (!peer_queue) {
+        // There is no one to send to.
+        return true;
+    }
+
+    return peer_queue->enqueue(std::move(item)) != Queue::PushResult::Dropped;
+}
+
+void LoopbackConnection::receive()
+{
+    ThreadConfig::apply(ThreadRole::Receive);
+
+    while (auto item = _queue->dequeue()) {
+        // Whatever else is queued already is handled in the same burst, like
+        // the messages of one datagram.
+        ReceiveBurst::Scope receive_burst;
+        receive_item(*item);
+        for (size_t i = 1; i < queue_capacity; ++i) {
+            auto next = _queue->try_dequeue();
+            if (!next) {
+                break;
+            }
+            receive_item(*next);
+        }
+    }
+}
+
+void LoopbackConnection::receive_item(Item& item)
+{
+    if (item.message) {
+        receive_message_buffer(item.message);
+        return;
+    }
+
+    _mavlink_receiver->set_new_datagram(
+        reinterpret_cast<char*>(item.frames.data()), static_cast<unsigned>(item.frames.size()));
+    while (_mavlink_receiver->parse_message()) {
+        receive_message(_mavlink_receiver->get_last_message(), this);
+    }
+}
+
+} // namespace mavsdk
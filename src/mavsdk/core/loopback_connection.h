@@ -0,0 +1,68 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "callback_queue.h"
+#include "connection.h"
+#include "mavlink_message_buffer.h"
+
+namespace mavsdk {
+
+// Connects two Mavsdk instances in the same process, e.g. an autopilot
+// made of server components and a ground station, without any socket.
+//
+// The two ends are the two connections started with the same name. What one
+// sends is handed to the other as the message it already is, through a
+// lock-free queue, so it is neither serialized nor parsed again, and no
+// syscall is involved.
+//
+// Messages sent while there is no other end are discarded.
+class LoopbackConnection : public Connection {
+public:
+    explicit LoopbackConnection(
+        Connection::ReceiverCallback receiver_callback,
+        std::string name,
+        ForwardingOption forwarding_option = ForwardingOption::ForwardingOff);
+    ConnectionResult start() override;
+    ConnectionResult stop() override;
+    ~LoopbackConnection() override;
+
+    bool send_message(const mavlink_message_t& message) override;
+    bool send_frames(const uint8_t* data, size_t len) override;
+    size_t memory_usage() override;
+
+    // Non-copyable
+    LoopbackConnection(const LoopbackConnection&) = delete;
+    const LoopbackConnection& operator=(const LoopbackConnection&) = delete;
+
+    static constexpr size_t queue_capacity = 1024;
+
+private:
+    // Either a message, or frames that were already serialized.
+    struct Item {
+        MavlinkMessageBuffer message{};
+        std::vector<uint8_t> frames{};
+    };
+    using Queue = CallbackQueue<Item>;
+
+    bool enqueue(Item item);
+    void receive();
+    void receive_item(Item& item);
+
+    const std::string _name;
+
+    // What the other end sends us.
+    std::shared_ptr<Queue> _queue{};
+    // Where we send to, set while there is another end, see the registry
+    // in the .cpp file.
+    std::shared_ptr<Queue> _peer_queue{};
+
+    MavlinkMessagePool _message_pool{};
+
+    std::unique_ptr<std::thread> _receive_thread{};
+    bool _started{false};
+};
+
+} // namespace mavsdk
@@ -0,0 +1,179 @@
+#include "loopback_connection.h"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace mavsdk;
+
+namespace {
+
+mavlink_message_t make_heartbeat(uint8_t sysid)
+{
+    mavlink_message_t message;
+    mavlink_msg_heartbeat_pack(
+        sysid,
+        MAV_COMP_ID_AUTOPILOT1,
+        &message,
+        MAV_TYPE_QUADROTOR,
+        MAV_AUTOPILOT_PX4,
+        0,
+        0,
+        MAV_STATE_ACTIVE);
+    return message;
+}
+
+// Collects the system IDs of what a connection receives.
+struct Received {
+    Connection::ReceiverCallback callback()
+    {
+        return [this](mavlink_message_t& message, Connection*) {
+            std::lock_guard<std::mutex> lock(mutex);
+            sysids.push_back(message.sysid);
+        };
+    }
+
+    std::vector<uint8_t> wait_for(size_t count)
+    {
+        for (unsigned i = 0; i < 100; ++i) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (sysids.size() >= count) {
+                    return sysids;
+                }
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        return sysids;
+    }
+
+    std::mutex mutex;
+    std::vector<uint8_t> sysids; // Needs mutex
+};
+
+} // namespace
+
+TEST(LoopbackConnection, DeliversBothWays)
+{
+    Received received_a;
+    Received received_b;
+    LoopbackConnection a(received_a.callback(), "both-ways");
+    LoopbackConnection b(received_b.callback(), "both-ways");
+    ASSERT_EQ(a.start(), ConnectionResult::Success);
+    ASSERT_EQ(b.start(), ConnectionResult::Success);
+
+    EXPECT_TRUE(a.send_message(make_heartbeat(1)));
+    EXPECT_TRUE(a.send_messages({make_heartbeat(2), make_heartbeat(3)}));
+    EXPECT_TRUE(b.send_message(make_heartbeat(4)));
+
+    EXPECT_EQ(received_b.wait_for(3), (std::vector<uint8_t>{1, 2, 3}));
+    EXPECT_EQ(received_a.wait_for(1), (std::vector<uint8_t>{4}));
+}
+
+TEST(LoopbackConnection, ParsesFrames)
+{
+    Received received;
+    LoopbackConnection a([](mavlink_message_t&, Connection*) {}, "frames");
+    LoopbackConnection b(received.callback(), "frames");
+    ASSERT_EQ(a.start(), ConnectionResult::Success);
+    ASSERT_EQ(b.start(), ConnectionResult::Success);
+
+    std::vector<uint8_t> frames;
+    for (uint8_t sysid = 1; sysid <= 2; ++sysid) {
+        uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
+        const auto message = make_heartbeat(sysid);
+        const auto len = mavlink_msg_to_send_buffer(buffer, &message);
+        frames.insert(frames.end(), buffer, buffer + len);
+    }
+    EXPECT_TRUE(a.send_frames(frames.data(), frames.size()));
+
+    EXPECT_EQ(received.wait_for(2), (std::vector<uint8_t>{1, 2}));
+}
+
+TEST(LoopbackConnection, HasOnlyTwoEnds)
+{
+    LoopbackConnection a([](mavlink_message_t&, Connection*) {}, "two-ends");
+    LoopbackConnection b([](mavlink_message_t&, Connection*) {}, "two-ends");
+    LoopbackConnection c([](mavlink_message_t&, Connection*) {}, "two-ends");
+    ASSERT_EQ(a.start(), ConnectionResult::Success);
+    ASSERT_EQ(b.start(), ConnectionResult::Success);
+    EXPECT_EQ(c.start(), ConnectionResult::ConnectionsExhausted);
+
+    // Once one end is gone, another one can take its place.
+    EXPECT_EQ(a.stop(), ConnectionResult::Success);
+    EXPECT_EQ(c.start(), ConnectionResult::Success);
+}
+
+TEST(LoopbackConnection, DiscardsWithoutOtherEnd)
+{
+    Received received;
+    LoopbackConnection a([](mavlink_message_t&, Connection*) {}, "other-end");
+    ASSERT_EQ(a.start(), ConnectionResult::Success);
+    EXPECT_TRUE(a.send_message(make_heartbeat(1)));
+
+    LoopbackConnection b(received.callback(), "other-end");
+    ASSERT_EQ(b.start(), ConnectionResult::Success);
+    EXPECT_TRUE(a.send_message(make_heartbeat(2)));
+
+    EXPECT_EQ(received.wait_for(1), (std::vector<uint8_t>{2}));
+
+    b.stop();
+    EXPECT_TRUE(a.send_message(make_heartbeat(3)));
+}
+
+TEST(LoopbackConnection, NeedsName)
+{
+    LoopbackConnection a([](mavlink_message_t&, Connection*) {}, "");
+    EXPECT_EQ(a.start(), ConnectionResult::ConnectionUrlInvalid);
+}
+
+TEST(LoopbackConnection, ReceivesWhileHandlerIsBusy)
+{
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool busy = false; // Needs mutex
+    bool release = false; // Needs mutex
+
+    Received received;
+    auto record = received.callback();
+    LoopbackConnection a([](mavlink_message_t&, Connection*) {}, "receive-queue");
+    LoopbackConnection b(
+        [&](mavlink_message_t& message, Connection* connection) {
+            record(message, connection);
+            std::unique_lock<std::mutex> lock(mutex);
+            busy = true;
+            cv.notify_all();
+            cv.wait(lock, [&]() { return release; });
+        },
+        "receive-queue");
+    b.set_receive_queue(2, CallbackQueueBase::OverflowPolicy::DropNewest);
+    ASSERT_EQ(a.start(), ConnectionResult::Success);
+    ASSERT_EQ(b.start(), ConnectionResult::Success);
+
+    EXPECT_TRUE(a.send_message(make_heartbeat(1)));
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        ASSERT_TRUE(cv.wait_for(lock, std::chrono::seconds(1), [&]() { return busy; }));
+    }
+
+    // The handler is stuck with the first one, the rest is still received.
+    EXPECT_TRUE(a.send_messages(
+        {make_heartbeat(2), make_heartbeat(3), make_heartbeat(4), make_heartbeat(5)}));
+    for (unsigned i = 0; i < 100 && b.receive_queue_stats().dropped < 2; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_EQ(b.receive_queue_stats().dropped, 2u);
+    EXPECT_EQ(b.receive_queue_stats().max_depth, 2u);
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        release = true;
+        cv.notify_all();
+    }
+    EXPECT_EQ(received.wait_for(3), (std::vector<uint8_t>{1, 2, 3}));
+
+    b.stop();
+}
@@ -1,6 +1,7 @@
 #include "mavlink_command_receiver.h"
 #include "mavsdk_impl.h"
 #include "log.h"
+#include <algorithm>
 #include <cmath>
 #include <future>
 #include <memory>
@@ -31,15 +32,21 @@ void MavlinkCommandReceiver::receive_command_int(const mavlink_message_t& messag
 {
     MavlinkCommandReceiver::CommandInt cmd(message);
 
-    std::lock_guard<std::mutex> lock(_mavlink_command_handler_table_mutex);
+    // We hold on to the table we got, so it stays valid even if handlers
+    // are changed while we call them.
+    const auto table = std::atomic_load_explicit(
+        &_mavlink_command_int_handler_table, std::memory_order_acquire);
+
+    const auto it = table->find(cmd.command);
+    if (it == table->end()) {
+        return;
+    }
 
-    for (auto& handler : _mavlink_command_int_handler_table) {
-        if (handler.cmd_id == cmd.command) {
-            // The client side can pack a COMMAND_ACK as a response to receiving the command.
-            auto maybe_message = handler.callback(cmd);
-            if (maybe_message) {
-                _mavsdk_impl.send_message(maybe_message.value());
-            }
+    for (const auto& handler : it->second) {
+        // The client side can pack a COMMAND_ACK as a response to receiving the command.
+        auto maybe_message = handler.callback(cmd);
+        if (maybe_message) {
+            _mavsdk_impl.send_message(maybe_message.value());
         }
     }
 }
@@ -48,15 +55,19 @@ void MavlinkCommandReceiver::receive_command_long(const mavlink_message_t& messa
 {
     MavlinkCommandReceiver::CommandLong cmd(message);
 
-    std::lock_guard<std::mutex> lock(_mavlink_command_handler_table_mutex);
+    const auto table = std::atomic_load_explicit(
+        &_mavlink_command_long_handler_table, std::memory_order_acquire);
 
-    for (auto& handler : _mavlink_command_long_handler_table) {
-        if (handler.cmd_id == cmd.command) {
-            // The client side can pack a COMMAND_ACK as a response to receiving the command.
-            auto maybe_message = handler.callback(cmd);
-            if (maybe_message) {
-                _mavsdk_impl.send_message(maybe_message.value());
-            }
+    const auto it = table->find(cmd.command);
+    if (it == table->end()) {
+        return;
+    }
+
+    for (const auto& handler : it->second) {
+        // The client side can pack a COMMAND_ACK as a response to receiving the command.
+        auto maybe_message = handler.callback(cmd);
+        if (maybe_message) {
+            _mavsdk_impl.send_message(maybe_message.value());
         }
     }
 }
@@ -66,8 +77,12 @@ void MavlinkCommandReceiver::register_mavlink_command_handler(
 {
     std::lock_guard<std::mutex> lock(_mavlink_command_handler_table_mutex);
 
-    MAVLinkCommandIntHandlerTableEntry entry = {cmd_id, callback, cookie};
-    _mavlink_command_int_handler_table.push_back(entry);
+    auto new_table = std::make_shared<CommandIntHandlerTable>(*_mavlink_command_int_handler_table);
+    (*new_table)[cmd_id].push_back(MAVLinkCommandIntHandlerTableEntry{cmd_id, callback, cookie});
+    std::atomic_store_explicit(
+        &_mavlink_command_int_handler_table,
+        std::shared_ptr<const CommandIntHandlerTable>(std::move(new_table)),
+        std::memory_order_release);
 }
 
 void MavlinkCommandReceiver::register_mavlink_command_handler(
@@ -75,8 +90,13 @@ void MavlinkCommandReceiver::register_mavlink_command_handler(
 {
     std::lock_guard<std::mutex> lock(_mavlink_command_handler_table_mutex);
 
-    MAVLinkCommandLongHandlerTableEntry entry = {cmd_id, callback, cookie};
-    _mavlink_command_long_handler_table.push_back(entry);
+    auto new_table =
+        std::make_shared<CommandLongHandlerTable>(*_mavlink_command_long_handler_table);
+    (*new_table)[cmd_id].push_back(MAVLinkCommandLongHandlerTableEntry{cmd_id, callback, cookie});
+    std::atomic_store_explicit(
+        &_mavlink_command_long_handler_table,
+        std::shared_ptr<const CommandLongHandlerTable>(std::move(new_table)),
+        std::memory_order_release);
 }
 
 void MavlinkCommandReceiver::unregister_mavlink_command_handler(uint16_t cmd_id, const void* cookie)
@@ -84,26 +104,16 @@ void MavlinkCommandReceiver::unregister_mavlink_command_handler(uint16_t cmd_id,
     std::lock_guard<std::mutex> lock(_mavlink_command_handler_table_mutex);
 
     // COMMAND_INT
-    for (auto it = _mavlink_command_int_handler_table.begin();
-         it != _mavlink_command_int_handler_table.end();
-         /* no ++it */) {
-        if (it->cmd_id == cmd_id && it->cookie == cookie) {
-            it = _mavlink_command_int_handler_table.erase(it);
-        } else {
-            ++it;
-        }
-    }
+    std::atomic_store_explicit(
+        &_mavlink_command_int_handler_table,
+        without_handlers(*_mavlink_command_int_handler_table, cmd_id, cookie),
+        std::memory_order_release);
 
     // COMMAND_LONG
-    for (auto it = _mavlink_command_long_handler_table.begin();
-         it != _mavlink_command_long_handler_table.end();
-         /* no ++it */) {
-        if (it->cmd_id == cmd_id && it->cookie == cookie) {
-            it = _mavlink_command_long_handler_table.erase(it);
-        } else {
-            ++it;
-        }
-    }
+    std::atomic_store_explicit(
+        &_mavlink_command_long_handler_table,
+        without_handlers(*_mavlink_command_long_handler_table, cmd_id, cookie),
+        std::memory_order_release);
 }
 
 void MavlinkCommandReceiver::unregister_all_mavlink_command_handlers(const void* cookie)
@@ -111,26 +121,38 @@ void MavlinkCommandReceiver::unregister_all_mavlink_command_handlers(const void*
     std::lock_guard<std::mutex> lock(_mavlink_command_handler_table_mutex);
 
     // COMMAND_INT
-    for (auto it = _mavlink_command_int_handler_table.begin();
-         it != _mavlink_command_int_handler_table.end();
-         /* no ++it */) {
-        if (it->cookie == cookie) {
-            it = _mavlink_command_int_handler_table.erase(it);
-        } else {
-            ++it;
-        }
-    }
+    std::atomic_store_explicit(
+        &_mavlink_command_int_handler_table,
+        without_handlers(*_mavlink_command_int_handler_table, {}, cookie),
+        std::memory_order_release);
 
     // COMMAND_LONG
-    for (auto it = _mavlink_command_long_handler_table.begin();
-         it != _mavlink_command_long_handler_table.end();
-         /* no ++it */) {
-        if (it->cookie == cookie) {
-            it = _mavlink_command_long_handler_table.erase(it);
-        } else {
-            ++it;
+    std::atomic_store_explicit(
+        &_mavlink_command_long_handler_table,
+        without_handlers(*_mavlink_command_long_handler_table, {}, cookie),
+        std::memory_order_release);
+}
+
+template<typename Entry>
+std::shared_ptr<const MavlinkCommandReceiver::HandlerTable<Entry>>
+MavlinkCommandReceiver::without_handlers(
+    const HandlerTable<Entry>& table, std::optional<uint16_t> maybe_cmd_id, const void* cookie)
+{
+    auto new_table = std::make_shared<HandlerTable<Entry>>();
+    for (const auto& [cmd_id, entries] : table) {
+        std::vector<Entry> new_entries;
+        std::copy_if(
+            entries.begin(),
+            entries.end(),
+            std::back_inserter(new_entries),
+            [&, cmd_id = cmd_id](const Entry& entry) {
+                return entry.cookie != cookie || (maybe_cmd_id && maybe_cmd_id.value() != cmd_id);
+            });
+        if (!new_entries.empty()) {
+            new_table->emplace(cmd_id, std::move(new_entries));
         }
     }
+    return new_table;
 }
 
 } // namespace mavsdk
@@ -6,15 +6,22 @@
 #include <cstdint>
 #include <string>
 #include <functional>
+#include <memory>
 #include <mutex>
 #include <optional>
 #include <unordered_map>
 #include <variant>
+#include <vector>
 
 namespace mavsdk {
 
 class MavsdkImpl;
 
+// Handlers are looked up by command ID in immutable tables which are replaced
+// (copy-on-write) whenever handlers are registered or unregistered, so
+// incoming commands never have to take the mutex. Like with the
+// MavlinkMessageHandler, a handler can therefore still be called once if a
+// command is dispatched concurrently with its unregistration.
 class MavlinkCommandReceiver {
 public:
     explicit MavlinkCommandReceiver(MavsdkImpl& mavsdk_impl);
@@ -134,9 +141,21 @@ private:
         const void* cookie; // This is the identification to unregister.
     };
 
+    template<typename Entry>
+    using HandlerTable = std::unordered_map<uint16_t, std::vector<Entry>>;
+    using CommandIntHandlerTable = HandlerTable<MAVLinkCommandIntHandlerTableEntry>;
+    using CommandLongHandlerTable = HandlerTable<MAVLinkCommandLongHandlerTableEntry>;
+
+    template<typename Entry>
+    static std::shared_ptr<const HandlerTable<Entry>> without_handlers(
+        const HandlerTable<Entry>& table, std::optional<uint16_t> maybe_cmd_id, const void* cookie);
+
+    // Only used to serialize changes to the tables, not for lookups.
     std::mutex _mavlink_command_handler_table_mutex{};
-    std::vector<MAVLinkCommandIntHandlerTableEntry> _mavlink_command_int_handler_table{};
-    std::vector<MAVLinkCommandLongHandlerTableEntry> _mavlink_command_long_handler_table{};
+    std::shared_ptr<const CommandIntHandlerTable> _mavlink_command_int_handler_table{
+        std::make_shared<const CommandIntHandlerTable>()};
+    std::shared_ptr<const CommandLongHandlerTable> _mavlink_command_long_handler_table{
+        std::make_shared<const CommandLongHandlerTable>()};
 };
 
 } // namespace mavsdk
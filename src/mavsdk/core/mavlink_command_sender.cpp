@@ -1,6 +1,8 @@
 #include "mavlink_command_sender.h"
+#include "sync_callback.h"
 #include "system_impl.h"
 #include "unused.h"
+#include <algorithm>
 #include <cmath>
 #include <future>
 #include <memory>
@@ -34,15 +36,17 @@ MavlinkCommandSender::send_command(const MavlinkCommandSender::CommandInt& comma
     auto prom = std::make_shared<std::promise<Result>>();
     auto res = prom->get_future();
 
-    queue_command_async(command, [prom](Result result, float progress) {
-        UNUSED(progress);
-        // We can only fulfill the promise once in C++11.
-        // Therefore, we have to ignore the IN_PROGRESS state and wait
-        // for the final result.
-        if (result != Result::InProgress) {
-            prom->set_value(result);
-        }
-    });
+    queue_command_async(
+        command,
+        make_sync_callback<CommandResultCallback>([prom](Result result, float progress) {
+            UNUSED(progress);
+            // We can only fulfill the promise once in C++11.
+            // Therefore, we have to ignore the IN_PROGRESS state and wait
+            // for the final result.
+            if (result != Result::InProgress) {
+                prom->set_value(result);
+            }
+        }));
 
     // Block now to wait for result.
     return res.get();
@@ -55,15 +59,17 @@ MavlinkCommandSender::send_command(const MavlinkCommandSender::CommandLong& comm
     auto prom = std::make_shared<std::promise<Result>>();
     auto res = prom->get_future();
 
-    queue_command_async(command, [prom](Result result, float progress) {
-        UNUSED(progress);
-        // We can only fulfill the promise once in C++11.
-        // Therefore, we have to ignore the IN_PROGRESS state and wait
-        // for the final result.
-        if (result != Result::InProgress) {
-            prom->set_value(result);
-        }
-    });
+    queue_command_async(
+        command,
+        make_sync_callback<CommandResultCallback>([prom](Result result, float progress) {
+            UNUSED(progress);
+            // We can only fulfill the promise once in C++11.
+            // Therefore, we have to ignore the IN_PROGRESS state and wait
+            // for the final result.
+            if (result != Result::InProgress) {
+                prom->set_value(result);
+            }
+        }));
 
     return res.get();
 }
@@ -78,16 +84,6 @@ void MavlinkCommandSender::queue_command_async(
 
     CommandIdentification identification = identification_from_command(command);
 
-    for (const auto& work : _work_queue) {
-        if (work->identification == identification && callback == nullptr) {
-            if (_command_debugging) {
-                LogDebug() << "Dropping command " << static_cast<int>(identification.command)
-                           << " that is already being sent";
-            }
-            return;
-        }
-    }
-
     auto new_work = std::make_shared<Work>();
     new_work->timeout_s = _system_impl.timeout_s();
     new_work->command = command;
@@ -98,30 +94,34 @@ void MavlinkCommandSender::queue_command_async(
 
 void MavlinkCommandSender::queue_command_async(
     const CommandLong& command, const CommandResultCallback& callback)
+{
+    queue_work(command, callback, false);
+}
+
+void MavlinkCommandSender::queue_streamed_command_async(
+    const CommandLong& command, const CommandResultCallback& callback)
+{
+    queue_work(command, callback, true);
+}
+
+void MavlinkCommandSender::queue_work(
+    const CommandLong& command, const CommandResultCallback& callback, bool streamed)
 {
     if (_command_debugging) {
         LogDebug() << "COMMAND_LONG " << (int)(command.command) << " to send to "
-                   << (int)(command.target_system_id) << ", " << (int)(command.target_component_id);
+                   << (int)(command.target_system_id) << ", " << (int)(command.target_component_id)
+                   << (streamed ? " (streamed)" : "");
     }
 
     CommandIdentification identification = identification_from_command(command);
 
-    for (const auto& work : _work_queue) {
-        if (work->identification == identification && callback == nullptr) {
-            if (_command_debugging) {
-                LogDebug() << "Dropping command " << static_cast<int>(identification.command)
-                           << " that is already being sent";
-            }
-            return;
-        }
-    }
-
     auto new_work = std::make_shared<Work>();
     new_work->timeout_s = _system_impl.timeout_s();
     new_work->command = command;
     new_work->identification = identification;
     new_work->callback = callback;
     new_work->time_started = _system_impl.get_time().steady_time();
+    new_work->streamed = streamed;
     _work_queue.push_back(new_work);
 }
 
@@ -144,129 +144,156 @@ void MavlinkCommandSender::receive_command_ack(mavlink_message_t message)
         return;
     }
 
-    LockedQueue<Work>::Guard work_queue_guard(_work_queue);
+    bool found_command = false;
+    CommandResultCallback temp_callback = nullptr;
+    std::vector<CommandResultCallback> temp_superseded_callbacks{};
+    std::pair<Result, float> temp_result{Result::UnknownError, NAN};
 
-    for (auto it = _work_queue.begin(); it != _work_queue.end(); ++it) {
-        auto work = *it;
+    {
+        LockedQueue<Work>::Guard work_queue_guard(_work_queue);
 
-        if (!work) {
-            LogErr() << "No work available! (should not happen #1)";
-            return;
-        }
+        for (auto it = _work_queue.begin(); it != _work_queue.end(); ++it) {
+            auto work = *it;
 
-        if (work->identification.command != command_ack.command ||
-            (work->identification.target_system_id != 0 &&
-             work->identification.target_system_id != message.sysid) ||
-            (work->identification.target_component_id != 0 &&
-             work->identification.target_component_id != message.compid)) {
-            if (_command_debugging) {
-                LogDebug() << "Command ack for " << command_ack.command
-                           << " (from: " << std::to_string(message.sysid) << "/"
-                           << std::to_string(message.compid) << ")"
-                           << " does not match command " << work->identification.command
-                           << " (to: " << std::to_string(work->identification.target_system_id)
-                           << "/" << std::to_string(work->identification.target_component_id) << ")"
-                           << " after "
-                           << _system_impl.get_time().elapsed_since_s(work->time_started) << " s";
+            if (!work) {
+                LogErr() << "No work available! (should not happen #1)";
+                return;
             }
-            continue;
-        }
-
-        if (_command_debugging) {
-            LogDebug() << "Received command ack for " << command_ack.command << " with result "
-                       << static_cast<int>(command_ack.result) << " after "
-                       << _system_impl.get_time().elapsed_since_s(work->time_started) << " s";
-        }
-
-        CommandResultCallback temp_callback = work->callback;
-        std::pair<Result, float> temp_result{Result::UnknownError, NAN};
 
-        switch (command_ack.result) {
-            case MAV_RESULT_ACCEPTED:
-                _system_impl.unregister_timeout_handler(work->timeout_cookie);
-                temp_result = {Result::Success, 1.0f};
-                _work_queue.erase(it);
-                break;
-
-            case MAV_RESULT_DENIED:
+            if (!work->already_sent || work->identification.command != command_ack.command ||
+                (work->identification.target_system_id != 0 &&
+                 work->identification.target_system_id != message.sysid) ||
+                (work->identification.target_component_id != 0 &&
+                 work->identification.target_component_id != message.compid)) {
                 if (_command_debugging) {
-                    LogDebug() << "command denied (" << work->identification.command << ").";
+                    LogDebug() << "Command ack for " << command_ack.command
+                               << " (from: " << std::to_string(message.sysid) << "/"
+                               << std::to_string(message.compid) << ")"
+                               << " does not match command " << work->identification.command
+                               << " (to: "
+                               << std::to_string(work->identification.target_system_id) << "/"
+                               << std::to_string(work->identification.target_component_id)
+                               << ")"
+                               << " after "
+                               << _system_impl.get_time().elapsed_since_s(work->time_started)
+                               << " s";
                 }
-                _system_impl.unregister_timeout_handler(work->timeout_cookie);
-                temp_result = {Result::Denied, NAN};
-                _work_queue.erase(it);
-                break;
-
-            case MAV_RESULT_UNSUPPORTED:
-                if (_command_debugging) {
-                    LogDebug() << "command unsupported (" << work->identification.command << ").";
-                }
-                _system_impl.unregister_timeout_handler(work->timeout_cookie);
-                temp_result = {Result::Unsupported, NAN};
-                _work_queue.erase(it);
-                break;
+                continue;
+            }
 
-            case MAV_RESULT_TEMPORARILY_REJECTED:
-                if (_command_debugging) {
-                    LogDebug() << "command temporarily rejected (" << work->identification.command
-                               << ").";
-                }
-                _system_impl.unregister_timeout_handler(work->timeout_cookie);
-                temp_result = {Result::TemporarilyRejected, NAN};
-                _work_queue.erase(it);
-                break;
+            if (_command_debugging) {
+                LogDebug() << "Received command ack for " << command_ack.command << " with result "
+                           << static_cast<int>(command_ack.result) << " after "
+                           << _system_impl.get_time().elapsed_since_s(work->time_started) << " s";
+            }
 
-            case MAV_RESULT_FAILED:
-                if (_command_debugging) {
-                    LogDebug() << "command failed (" << work->identification.command << ").";
-                }
-                _system_impl.unregister_timeout_handler(work->timeout_cookie);
-                temp_result = {Result::Failed, NAN};
-                _work_queue.erase(it);
-                break;
+            if (!work->rtt_sampled) {
+                work->rtt_sampled = true;
+                _system_impl.rtt_estimator().add_sample(
+                    _system_impl.get_time().elapsed_since_s(work->time_started));
+            }
 
-            case MAV_RESULT_IN_PROGRESS:
-                if (_command_debugging) {
-                    if (static_cast<int>(command_ack.progress) != 255) {
-                        LogDebug() << "progress: " << static_cast<int>(command_ack.progress)
-                                   << " % (" << work->identification.command << ").";
+            found_command = true;
+            temp_callback = work->callback;
+            temp_superseded_callbacks = work->superseded_callbacks;
+
+            switch (command_ack.result) {
+                case MAV_RESULT_ACCEPTED:
+                    _system_impl.unregister_timeout_handler(work->timeout_cookie);
+                    temp_result = {Result::Success, 1.0f};
+                    _work_queue.erase(it);
+                    break;
+
+                case MAV_RESULT_DENIED:
+                    if (_command_debugging) {
+                        LogDebug() << "command denied (" << work->identification.command << ").";
                     }
-                }
-                // If we get a progress update, we can raise the timeout
-                // to something higher because we know the initial command
-                // has arrived. A possible timeout for this case is the initial
-                // timeout * the possible retries because this should match the
-                // case where there is no progress update, and we keep trying.
-                _system_impl.unregister_timeout_handler(work->timeout_cookie);
-                _system_impl.register_timeout_handler(
-                    [this, identification = work->identification] {
-                        receive_timeout(identification);
-                    },
-                    work->retries_to_do * work->timeout_s,
-                    &work->timeout_cookie);
-
-                temp_result = {
-                    Result::InProgress, static_cast<float>(command_ack.progress) / 100.0f};
-                break;
-
-            case MAV_RESULT_CANCELLED:
-                if (_command_debugging) {
-                    LogDebug() << "command cancelled (" << work->identification.command << ").";
-                }
-                _system_impl.unregister_timeout_handler(work->timeout_cookie);
-                temp_result = {Result::Cancelled, NAN};
-                _work_queue.erase(it);
-                break;
+                    _system_impl.unregister_timeout_handler(work->timeout_cookie);
+                    temp_result = {Result::Denied, NAN};
+                    _work_queue.erase(it);
+                    break;
+
+                case MAV_RESULT_UNSUPPORTED:
+                    if (_command_debugging) {
+                        LogDebug() << "command unsupported (" << work->identification.command
+                                   << ").";
+                    }
+                    _system_impl.unregister_timeout_handler(work->timeout_cookie);
+                    temp_result = {Result::Unsupported, NAN};
+                    _work_queue.erase(it);
+                    break;
+
+                case MAV_RESULT_TEMPORARILY_REJECTED:
+                    if (_command_debugging) {
+                        LogDebug() << "command temporarily rejected ("
+                                   << work->identification.command << ").";
+                    }
+                    _system_impl.unregister_timeout_handler(work->timeout_cookie);
+                    temp_result = {Result::TemporarilyRejected, NAN};
+                    _work_queue.erase(it);
+                    break;
+
+                case MAV_RESULT_FAILED:
+                    if (_command_debugging) {
+                        LogDebug() << "command failed (" << work->identification.command << ").";
+                    }
+                    _system_impl.unregister_timeout_handler(work->timeout_cookie);
+                    temp_result = {Result::Failed, NAN};
+                    _work_queue.erase(it);
+                    break;
+
+                case MAV_RESULT_IN_PROGRESS:
+                    if (_command_debugging) {
+                        if (static_cast<int>(command_ack.progress) != 255) {
+                            LogDebug() << "progress: " << static_cast<int>(command_ack.progress)
+                                       << " % (" << work->identification.command << ").";
+                        }
+                    }
+                    // If we get a progress update, we can raise the timeout
+                    // to something higher because we know the initial command
+                    // has arrived. A possible timeout for this case is the initial
+                    // timeout * the possible retries because this should match the
+                    // case where there is no progress update, and we keep trying.
+                    _system_impl.unregister_timeout_handler(work->timeout_cookie);
+                    _system_impl.register_timeout_handler(
+                        [this, identification = work->identification] {
+                            receive_timeout(identification);
+                        },
+                        work->retries_to_do * work->timeout_s,
+                        &work->timeout_cookie);
+
+                    temp_result = {
+                        Result::InProgress, static_cast<float>(command_ack.progress) / 100.0f};
+                    break;
+
+                case MAV_RESULT_CANCELLED:
+                    if (_command_debugging) {
+                        LogDebug() << "command cancelled (" << work->identification.command << ").";
+                    }
+                    _system_impl.unregister_timeout_handler(work->timeout_cookie);
+                    temp_result = {Result::Cancelled, NAN};
+                    _work_queue.erase(it);
+                    break;
+
+                default:
+                    LogWarn() << "Received unknown ack.";
+                    break;
+            }
 
-            default:
-                LogWarn() << "Received unknown ack.";
-                break;
+            break;
         }
+    }
 
-        if (temp_callback != nullptr) {
-            call_callback(temp_callback, temp_result.first, temp_result.second);
-        }
+    // Called with the Guard released, as the callbacks might queue further commands.
+    if (found_command) {
+        call_callbacks(
+            temp_callback, temp_superseded_callbacks, temp_result.first, temp_result.second);
+        return;
+    }
 
+    // Sent to the whole fleet, which keeps track of the acks itself.
+    if (message.sysid == _system_impl.get_system_id() &&
+        _system_impl.receive_fleet_command_ack(message)) {
         return;
     }
 
@@ -285,66 +312,80 @@ void MavlinkCommandSender::receive_timeout(const CommandIdentification& identifi
 {
     bool found_command = false;
     CommandResultCallback temp_callback = nullptr;
+    std::vector<CommandResultCallback> temp_superseded_callbacks{};
     std::pair<Result, float> temp_result{Result::UnknownError, NAN};
 
-    LockedQueue<Work>::Guard work_queue_guard(_work_queue);
+    {
+        LockedQueue<Work>::Guard work_queue_guard(_work_queue);
 
-    for (auto it = _work_queue.begin(); it != _work_queue.end(); ++it) {
-        auto work = *it;
+        for (auto it = _work_queue.begin(); it != _work_queue.end(); ++it) {
+            auto work = *it;
 
-        if (!work) {
-            LogErr() << "No work available! (should not happen #2)";
-            return;
-        }
-
-        if (work->identification != identification) {
-            continue;
-        }
+            if (!work) {
+                LogErr() << "No work available! (should not happen #2)";
+                return;
+            }
 
-        found_command = true;
+            if (!work->already_sent || work->identification != identification) {
+                continue;
+            }
 
-        if (work->retries_to_do > 0) {
-            // We're not sure the command arrived, let's retransmit.
-            LogWarn() << "sending again after "
-                      << _system_impl.get_time().elapsed_since_s(work->time_started)
-                      << " s, retries to do: " << work->retries_to_do << "  ("
-                      << work->identification.command << ").";
+            found_command = true;
 
-            if (work->identification.command == MAV_CMD_REQUEST_MESSAGE) {
-                LogWarn() << "Request was for msg ID: " << work->identification.maybe_param1;
+            if (work->streamed) {
+                // A newer target is waiting, so this one would only arrive late.
+                if (auto newer_work = newer_streamed_work(it)) {
+                    _system_impl.unregister_timeout_handler(work->timeout_cookie);
+                    supersede(it, newer_work);
+                    break;
+                }
             }
 
-            mavlink_message_t message = create_mavlink_message(work->command);
-            if (!_system_impl.send_message(message)) {
-                LogErr() << "connection send error in retransmit (" << work->identification.command
-                         << ").";
+            if (work->retries_to_do > 0) {
+                // We're not sure the command arrived, let's retransmit.
+                LogWarn() << "sending again after "
+                          << _system_impl.get_time().elapsed_since_s(work->time_started)
+                          << " s, retries to do: " << work->retries_to_do << "  ("
+                          << work->identification.command << ").";
+
+                if (work->identification.command == MAV_CMD_REQUEST_MESSAGE) {
+                    LogWarn() << "Request was for msg ID: " << work->identification.maybe_param1;
+                }
+
+                mavlink_message_t message = create_mavlink_message(work->command);
+                if (!_system_impl.send_message(message)) {
+                    LogErr() << "connection send error in retransmit ("
+                             << work->identification.command << ").";
+                    temp_callback = work->callback;
+                    temp_superseded_callbacks = work->superseded_callbacks;
+                    temp_result = {Result::ConnectionError, NAN};
+                    _work_queue.erase(it);
+                    break;
+                } else {
+                    --work->retries_to_do;
+                    work->rtt_sampled = true;
+                    _system_impl.register_timeout_handler(
+                        [this, identification = work->identification] {
+                            receive_timeout(identification);
+                        },
+                        work->timeout_s,
+                        &work->timeout_cookie);
+                }
+            } else {
+                // We have tried retransmitting, giving up now.
+                LogErr() << "Retrying failed (" << work->identification.command << ")";
+
                 temp_callback = work->callback;
-                temp_result = {Result::ConnectionError, NAN};
+                temp_superseded_callbacks = work->superseded_callbacks;
+                temp_result = {Result::Timeout, NAN};
                 _work_queue.erase(it);
                 break;
-            } else {
-                --work->retries_to_do;
-                _system_impl.register_timeout_handler(
-                    [this, identification = work->identification] {
-                        receive_timeout(identification);
-                    },
-                    work->timeout_s,
-                    &work->timeout_cookie);
             }
-        } else {
-            // We have tried retransmitting, giving up now.
-            LogErr() << "Retrying failed (" << work->identification.command << ")";
-
-            temp_callback = work->callback;
-            temp_result = {Result::Timeout, NAN};
-            _work_queue.erase(it);
-            break;
         }
     }
 
-    if (temp_callback != nullptr) {
-        call_callback(temp_callback, temp_result.first, temp_result.second);
-    }
+    // Called with the Guard released, as the callbacks might queue further commands.
+    call_callbacks(temp_callback, temp_superseded_callbacks, temp_result.first, temp_result.second);
 
     if (!found_command) {
         LogWarn() << "Timeout for not-existing command: "
@@ -352,10 +393,93 @@ void MavlinkCommandSender::receive_timeout(const CommandIdentification& identifi
     }
 }
 
+void MavlinkCommandSender::drop_duplicate_work()
+{
+    // Checked here instead of when queueing, so that queueing never waits
+    // for the processing.
+    for (auto it = _work_queue.begin(); it != _work_queue.end();) {
+        const auto& work = *it;
+        const bool duplicate =
+            !work->already_sent && work->callback == nullptr &&
+            std::any_of(_work_queue.begin(), it, [&](const std::shared_ptr<Work>& other_work) {
+                return other_work->identification == work->identification;
+            });
+
+        if (!duplicate) {
+            ++it;
+            continue;
+        }
+
+        if (_command_debugging) {
+            LogDebug() << "Dropping command " << static_cast<int>(work->identification.command)
+                       << " that is already being sent";
+        }
+        it = _work_queue.erase(it);
+    }
+}
+
+void MavlinkCommandSender::supersede_streamed_work()
+{
+    for (auto it = _work_queue.begin(); it != _work_queue.end();) {
+        const auto& work = *it;
+        if (!work->streamed || work->already_sent) {
+            ++it;
+            continue;
+        }
+
+        if (auto newer_work = newer_streamed_work(it)) {
+            it = supersede(it, newer_work);
+        } else {
+            ++it;
+        }
+    }
+}
+
+std::shared_ptr<MavlinkCommandSender::Work>
+MavlinkCommandSender::newer_streamed_work(LockedQueue<Work>::iterator it)
+{
+    const auto& work = *it;
+    auto newer_it = std::find_if(
+        std::next(it), _work_queue.end(), [&](const std::shared_ptr<Work>& other_work) {
+            return other_work->streamed && !other_work->already_sent &&
+                   other_work->identification == work->identification;
+        });
+
+    return newer_it != _work_queue.end() ? *newer_it : nullptr;
+}
+
+LockedQueue<MavlinkCommandSender::Work>::iterator MavlinkCommandSender::supersede(
+    LockedQueue<Work>::iterator it, const std::shared_ptr<Work>& newer_work)
+{
+    const auto& work = *it;
+
+    if (_command_debugging) {
+        LogDebug() << "Dropping streamed command "
+                   << static_cast<int>(work->identification.command)
+                   << " replaced by a newer one";
+    }
+
+    // Kept in the order they were queued.
+    std::vector<CommandResultCallback> callbacks = std::move(work->superseded_callbacks);
+    if (work->callback) {
+        callbacks.push_back(work->callback);
+    }
+    callbacks.insert(
+        callbacks.end(),
+        newer_work->superseded_callbacks.begin(),
+        newer_work->superseded_callbacks.end());
+    newer_work->superseded_callbacks = std::move(callbacks);
+
+    return _work_queue.erase(it);
+}
+
 void MavlinkCommandSender::do_work()
 {
     LockedQueue<Work>::Guard work_queue_guard(_work_queue);
 
+    drop_duplicate_work();
+    supersede_streamed_work();
+
     for (const auto& work : _work_queue) {
         if (work->already_sent) {
             continue;
@@ -368,9 +492,12 @@ void MavlinkCommandSender::do_work()
                 continue;
             }
 
-            // Check if command with same command ID is already being sent.
+            // Acks can only be told apart by command ID and sender, so only
+            // commands to other components, or with other IDs, are sent in
+            // parallel. As the queue is in order, the ones waiting here are
+            // still sent in the order they were queued.
             if (other_work->already_sent &&
-                other_work->identification.command == work->identification.command) {
+                acks_are_ambiguous(other_work->identification, work->identification)) {
                 if (_command_debugging) {
                     LogDebug() << "Command " << static_cast<int>(work->identification.command)
                                << " is already being sent, waiting...";
@@ -409,6 +536,19 @@ void MavlinkCommandSender::do_work()
     }
 }
 
+bool MavlinkCommandSender::acks_are_ambiguous(
+    const CommandIdentification& lhs, const CommandIdentification& rhs)
+{
+    // An ID of 0 is a broadcast, so the ack could come from anyone.
+    auto ids_overlap = [](uint8_t lhs_id, uint8_t rhs_id) {
+        return lhs_id == 0 || rhs_id == 0 || lhs_id == rhs_id;
+    };
+
+    return lhs.command == rhs.command &&
+           ids_overlap(lhs.target_system_id, rhs.target_system_id) &&
+           ids_overlap(lhs.target_component_id, rhs.target_component_id);
+}
+
 void MavlinkCommandSender::call_callback(
     const CommandResultCallback& callback, Result result, float progress)
 {
@@ -416,11 +556,32 @@ void MavlinkCommandSender::call_callback(
         return;
     }
 
+    // Blocking calls waiting for this are completed right away. This is why
+    // callbacks are never called with the Guard held.
+    if (is_sync_callback(callback)) {
+        callback(result, progress);
+        return;
+    }
+
     // It seems that we need to queue the callback on the thread pool otherwise
     // we lock ourselves out when we send a command in the callback receiving a command result.
     auto temp_callback = callback;
     _system_impl.call_user_callback(
-        [temp_callback, result, progress]() { temp_callback(result, progress); });
+        [temp_callback, result, progress]() { temp_callback(result, progress); },
+        nullptr,
+        CallbackLane::Control);
+}
+
+void MavlinkCommandSender::call_callbacks(
+    const CommandResultCallback& callback,
+    const std::vector<CommandResultCallback>& superseded_callbacks,
+    Result result,
+    float progress)
+{
+    for (const auto& superseded_callback : superseded_callbacks) {
+        call_callback(superseded_callback, result, progress);
+    }
+    call_callback(callback, result, progress);
 }
 
 mavlink_message_t MavlinkCommandSender::create_mavlink_message(const Command& command)
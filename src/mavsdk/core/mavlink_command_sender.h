@@ -11,6 +11,7 @@
 #include <optional>
 #include <unordered_map>
 #include <variant>
+#include <vector>
 
 namespace mavsdk {
 
@@ -79,7 +80,18 @@ public:
     void queue_command_async(const CommandInt& command, const CommandResultCallback& callback);
     void queue_command_async(const CommandLong& command, const CommandResultCallback& callback);
 
+    // For targets which are sent at high rates, e.g. winch rates, where only
+    // the latest one matters. It replaces the one before it that is not sent
+    // yet, and the one being sent isn't sent again once a newer one waits.
+    // The callbacks of the replaced ones get the result of the latest one.
+    void queue_streamed_command_async(
+        const CommandLong& command, const CommandResultCallback& callback);
+
     void do_work();
+    void set_work_notifier(std::function<void()> notifier)
+    {
+        _work_queue.set_notifier(std::move(notifier));
+    }
 
     static const int DEFAULT_COMPONENT_ID_AUTOPILOT = MAV_COMP_ID_AUTOPILOT1;
 
@@ -118,6 +130,11 @@ private:
         double timeout_s{0.5};
         int retries_to_do{3};
         bool already_sent{false};
+        // Only the first ack of a command not sent again tells the round trip time.
+        bool rtt_sampled{false};
+        bool streamed{false};
+        // Of the streamed commands this one replaced.
+        std::vector<CommandResultCallback> superseded_callbacks{};
     };
 
     template<typename CommandType>
@@ -126,7 +143,13 @@ private:
         CommandIdentification identification{};
 
         identification.command = command.command;
-        if (command.command == MAV_CMD_REQUEST_MESSAGE ||
+        if (command.command == MAV_CMD_DO_WINCH || command.command == MAV_CMD_DO_GRIPPER) {
+            // The instance, so that streamed targets only replace their own.
+            if (command.params.maybe_param1) {
+                identification.maybe_param1 =
+                    static_cast<uint32_t>(std::lround(command.params.maybe_param1.value()));
+            }
+        } else if (command.command == MAV_CMD_REQUEST_MESSAGE ||
             command.command == MAV_CMD_SET_MESSAGE_INTERVAL) {
             if (command.params.maybe_param1) {
                 const uint32_t param1 =
@@ -146,10 +169,38 @@ private:
         return identification;
     }
 
+    void queue_work(const CommandLong& command, const CommandResultCallback& callback, bool streamed);
+
     void receive_command_ack(mavlink_message_t message);
     void receive_timeout(const CommandIdentification& identification);
 
+    // Commands without callback which are already queued are sent only once.
+    // Needs a Guard of _work_queue.
+    void drop_duplicate_work();
+
+    // Streamed commands not sent yet are replaced by newer ones.
+    // Needs a Guard of _work_queue.
+    void supersede_streamed_work();
+
+    // The streamed command queued after this one to replace it, if any.
+    // Needs a Guard of _work_queue.
+    std::shared_ptr<Work> newer_streamed_work(LockedQueue<Work>::iterator it);
+
+    // Passes the callbacks of it on to the newer one and drops it.
+    // Needs a Guard of _work_queue.
+    LockedQueue<Work>::iterator
+    supersede(LockedQueue<Work>::iterator it, const std::shared_ptr<Work>& newer_work);
+
+    // Whether an ack could be meant for either of the two commands.
+    static bool
+    acks_are_ambiguous(const CommandIdentification& lhs, const CommandIdentification& rhs);
+
     void call_callback(const CommandResultCallback& callback, Result result, float progress);
+    void call_callbacks(
+        const CommandResultCallback& callback,
+        const std::vector<CommandResultCallback>& superseded_callbacks,
+        Result result,
+        float progress);
 
     mavlink_message_t create_mavlink_message(const Command& command);
 
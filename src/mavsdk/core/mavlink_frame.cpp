@@ -0,0 +1,47 @@
+#include "mavlink_frame.h"
+
+namespace mavsdk {
+
+bool MavlinkFrame::parse(const uint8_t* data, size_t len, MavlinkFrame& frame)
+{
+    if (len == 0) {
+        return false;
+    }
+
+    if (data[0] == STX_V1) {
+        if (len < HEADER_LEN_V1) {
+            return false;
+        }
+        frame.payload_len = data[1];
+        frame.payload_offset = HEADER_LEN_V1;
+        frame.len = HEADER_LEN_V1 + frame.payload_len + CHECKSUM_LEN;
+        frame.sysid = data[3];
+        frame.compid = data[4];
+        frame.msgid = data[5];
+
+    } else if (data[0] == STX_V2) {
+        if (len < HEADER_LEN_V2) {
+            return false;
+        }
+        const uint8_t incompat_flags = data[2];
+        // We can't know how long a frame with flags we don't know about is.
+        if ((incompat_flags & ~INCOMPAT_FLAG_SIGNED) != 0) {
+            return false;
+        }
+        frame.payload_len = data[1];
+        frame.payload_offset = HEADER_LEN_V2;
+        frame.len = HEADER_LEN_V2 + frame.payload_len + CHECKSUM_LEN +
+                    ((incompat_flags & INCOMPAT_FLAG_SIGNED) != 0 ? SIGNATURE_LEN : 0);
+        frame.sysid = data[5];
+        frame.compid = data[6];
+        frame.msgid = static_cast<uint32_t>(data[7]) | (static_cast<uint32_t>(data[8]) << 8) |
+                      (static_cast<uint32_t>(data[9]) << 16);
+
+    } else {
+        return false;
+    }
+
+    return frame.len <= len;
+}
+
+} // namespace mavsdk
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace mavsdk {
+
+// What the header of a serialized MAVLink 1 or 2 frame says, e.g. to pass on
+// frames from elsewhere without decoding and packing them again.
+//
+// Only the header is looked at, the checksum is not verified.
+struct MavlinkFrame {
+    // The whole frame, including checksum and signature.
+    size_t len{0};
+    size_t payload_offset{0};
+    uint8_t payload_len{0};
+    uint8_t sysid{0};
+    uint8_t compid{0};
+    uint32_t msgid{0};
+
+    // Parses the frame at the start of the data. Returns false if the data
+    // doesn't start with a complete frame.
+    static bool parse(const uint8_t* data, size_t len, MavlinkFrame& frame);
+
+    static constexpr uint8_t STX_V1 = 0xFE;
+    static constexpr uint8_t STX_V2 = 0xFD;
+    static constexpr size_t HEADER_LEN_V1 = 6;
+    static constexpr size_t HEADER_LEN_V2 = 10;
+    static constexpr size_t CHECKSUM_LEN = 2;
+    static constexpr size_t SIGNATURE_LEN = 13;
+    static constexpr uint8_t INCOMPAT_FLAG_SIGNED = 0x01;
+};
+
+} // namespace mavsdk
@@ -0,0 +1,103 @@
+#include "mavlink_frame.h"
+#include <gtest/gtest.h>
+#include <vector>
+
+using namespace mavsdk;
+
+namespace {
+
+std::vector<uint8_t> make_v2_frame(uint8_t payload_len, uint32_t msgid, bool is_signed)
+{
+    std::vector<uint8_t> frame{
+        MavlinkFrame::STX_V2,
+        payload_len,
+        static_cast<uint8_t>(is_signed ? MavlinkFrame::INCOMPAT_FLAG_SIGNED : 0),
+        0, // compat flags
+        7, // seq
+        42, // sysid
+        190, // compid
+        static_cast<uint8_t>(msgid & 0xff),
+        static_cast<uint8_t>((msgid >> 8) & 0xff),
+        static_cast<uint8_t>((msgid >> 16) & 0xff)};
+    frame.resize(
+        frame.size() + payload_len + MavlinkFrame::CHECKSUM_LEN +
+        (is_signed ? MavlinkFrame::SIGNATURE_LEN : 0));
+    return frame;
+}
+
+} // namespace
+
+TEST(MavlinkFrame, ParsesV1)
+{
+    // Heartbeat
+    std::vector<uint8_t> data{MavlinkFrame::STX_V1, 9, 3, 1, 1, 0};
+    data.resize(data.size() + 9 + MavlinkFrame::CHECKSUM_LEN);
+
+    MavlinkFrame frame;
+    ASSERT_TRUE(MavlinkFrame::parse(data.data(), data.size(), frame));
+    EXPECT_EQ(frame.len, 17u);
+    EXPECT_EQ(frame.payload_offset, 6u);
+    EXPECT_EQ(frame.payload_len, 9);
+    EXPECT_EQ(frame.sysid, 1);
+    EXPECT_EQ(frame.compid, 1);
+    EXPECT_EQ(frame.msgid, 0u);
+}
+
+TEST(MavlinkFrame, ParsesV2)
+{
+    const auto data = make_v2_frame(20, 0x012345, false);
+
+    MavlinkFrame frame;
+    ASSERT_TRUE(MavlinkFrame::parse(data.data(), data.size(), frame));
+    EXPECT_EQ(frame.len, 32u);
+    EXPECT_EQ(frame.payload_offset, 10u);
+    EXPECT_EQ(frame.payload_len, 20);
+    EXPECT_EQ(frame.sysid, 42);
+    EXPECT_EQ(frame.compid, 190);
+    EXPECT_EQ(frame.msgid, 0x012345u);
+}
+
+TEST(MavlinkFrame, IncludesSignature)
+{
+    const auto data = make_v2_frame(20, 33, true);
+
+    MavlinkFrame frame;
+    ASSERT_TRUE(MavlinkFrame::parse(data.data(), data.size(), frame));
+    EXPECT_EQ(frame.len, 45u);
+}
+
+TEST(MavlinkFrame, FindsFrameInLongerData)
+{
+    auto data = make_v2_frame(4, 1, false);
+    const auto second = make_v2_frame(8, 2, false);
+    data.insert(data.end(), second.begin(), second.end());
+
+    MavlinkFrame frame;
+    ASSERT_TRUE(MavlinkFrame::parse(data.data(), data.size(), frame));
+    EXPECT_EQ(frame.len, 16u);
+    ASSERT_TRUE(MavlinkFrame::parse(&data[frame.len], data.size() - frame.len, frame));
+    EXPECT_EQ(frame.msgid, 2u);
+}
+
+TEST(MavlinkFrame, RejectsIncomplete)
+{
+    const auto data = make_v2_frame(20, 33, false);
+
+    MavlinkFrame frame;
+    EXPECT_FALSE(MavlinkFrame::parse(data.data(), data.size() - 1, frame));
+    EXPECT_FALSE(MavlinkFrame::parse(data.data(), 5, frame));
+    EXPECT_FALSE(MavlinkFrame::parse(data.data(), 0, frame));
+}
+
+TEST(MavlinkFrame, RejectsUnknown)
+{
+    auto data = make_v2_frame(20, 33, false);
+
+    MavlinkFrame frame;
+    data[2] = 0x02; // unknown incompat flag
+    EXPECT_FALSE(MavlinkFrame::parse(data.data(), data.size(), frame));
+
+    data[2] = 0;
+    data[0] = 0x55;
+    EXPECT_FALSE(MavlinkFrame::parse(data.data(), data.size(), frame));
+}
@@ -1,5 +1,6 @@
 #include "mavlink_ftp.h"
 #include "system_impl.h"
+#include "trace.h"
 #include <fstream>
 
 #if defined(WINDOWS)
@@ -18,7 +19,11 @@
 
 #include "crc32.h"
 #include "fs.h"
+#include "xz_compression.h"
 #include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <memory>
 
 namespace mavsdk {
 
@@ -29,7 +34,10 @@ bool seq_lt(uint16_t a, uint16_t b)
            (a > b && (a - b) > (std::numeric_limits<uint16_t>::max() / 2));
 }
 
-MavlinkFtp::MavlinkFtp(SystemImpl& system_impl) : _system_impl(system_impl)
+MavlinkFtp::MavlinkFtp(SystemImpl& system_impl, Mode mode, uint16_t first_seq_number) :
+    _system_impl(system_impl),
+    _mode(mode),
+    _seq_number(first_seq_number)
 {
     _system_impl.register_mavlink_message_handler(
         MAVLINK_MSG_ID_FILE_TRANSFER_PROTOCOL,
@@ -54,6 +62,21 @@ void MavlinkFtp::process_mavlink_ftp_message(const mavlink_message_t& msg)
 
     PayloadHeader* payload = reinterpret_cast<PayloadHeader*>(&ftp_req.payload[0]);
 
+    const bool is_response = payload->opcode == RSP_ACK || payload->opcode == RSP_NAK;
+    if (is_response ? !_is_our_response(*payload) : _mode == Mode::ClientOnly) {
+        return;
+    }
+
+    if (is_response) {
+        _sample_rtt(*payload);
+    }
+
+    // Requests to us, the server, which also streams from another thread.
+    std::unique_lock<std::mutex> server_lock(_server_mutex, std::defer_lock);
+    if (!is_response) {
+        server_lock.lock();
+    }
+
     ServerResult error_code = ServerResult::SUCCESS;
 
     // basic sanity checks; must validate length before use
@@ -101,6 +124,11 @@ void MavlinkFtp::process_mavlink_ftp_message(const mavlink_message_t& msg)
                 error_code = _work_open(payload, O_RDONLY);
                 break;
 
+            case CMD_OPEN_FILE_RO_XZ:
+                LogInfo() << "OPC:CMD_OPEN_FILE_RO_XZ";
+                error_code = _work_open_xz(payload);
+                break;
+
             case CMD_CREATE_FILE:
                 LogInfo() << "OPC:CMD_CREATE_FILE";
                 error_code = _work_open(payload, O_CREAT | O_TRUNC | O_WRONLY);
@@ -112,18 +140,18 @@ void MavlinkFtp::process_mavlink_ftp_message(const mavlink_message_t& msg)
                 break;
 
             case CMD_READ_FILE:
-                LogInfo() << "OPC:CMD_READ_FILE";
+                LogDebug() << "OPC:CMD_READ_FILE";
                 error_code = _work_read(payload);
                 break;
 
             case CMD_BURST_READ_FILE:
-                LogInfo() << "OPC:CMD_BURST_READ_FILE";
+                LogDebug() << "OPC:CMD_BURST_READ_FILE";
                 error_code = _work_burst(payload);
                 stream_send = true;
                 break;
 
             case CMD_WRITE_FILE:
-                LogInfo() << "OPC:CMD_WRITE_FILE";
+                LogDebug() << "OPC:CMD_WRITE_FILE";
                 error_code = _work_write(payload);
                 break;
 
@@ -216,10 +244,50 @@ void MavlinkFtp::process_mavlink_ftp_message(const mavlink_message_t& msg)
 
 MavlinkFtp::~MavlinkFtp() {}
 
+bool MavlinkFtp::_is_our_response(const PayloadHeader& payload)
+{
+    std::lock_guard<std::mutex> lock(_curr_op_mutex);
+
+    if (_curr_op == CMD_NONE || payload.req_opcode != _curr_op) {
+        return false;
+    }
+
+    switch (_curr_op) {
+        case CMD_READ_FILE:
+        case CMD_BURST_READ_FILE:
+        case CMD_WRITE_FILE:
+        case CMD_TERMINATE_SESSION:
+            // Burst packets come with the server's sequence numbers.
+            return payload.session == _session;
+        case CMD_LIST_DIRECTORY:
+            return std::any_of(
+                _pending_lists.begin(), _pending_lists.end(), [&](const auto& pending) {
+                    return static_cast<uint16_t>(pending.seq_number + 1) == payload.seq_number;
+                });
+        default:
+            // The server answers with our sequence number plus one.
+            return payload.seq_number == _seq_number;
+    }
+}
+
 void MavlinkFtp::_process_ack(PayloadHeader* payload)
 {
+    Trace::instant("ftp", "ack", payload->req_opcode);
+
     std::lock_guard<std::mutex> lock(_curr_op_mutex);
 
+    if (_curr_op == CMD_WRITE_FILE && payload->req_opcode == CMD_WRITE_FILE) {
+        // With several writes in flight, acks of earlier ones are expected.
+        _process_write_ack(payload);
+        return;
+    }
+
+    if (_curr_op == CMD_LIST_DIRECTORY && payload->req_opcode == CMD_LIST_DIRECTORY) {
+        // Replies to the requests in flight come in any order.
+        _process_list_ack(payload);
+        return;
+    }
+
     if (seq_lt(payload->seq_number, _seq_number)) {
         // (payload->seq_number < _seq_number) with wrap around
         // received an ack for a previous seq that we already considered done
@@ -237,18 +305,61 @@ void MavlinkFtp::_process_ack(PayloadHeader* payload)
             break;
 
         case CMD_OPEN_FILE_RO:
-            _curr_op = CMD_NONE;
+        case CMD_OPEN_FILE_RO_XZ:
             _session_valid = true;
             _session = payload->session;
-            _bytes_transferred = 0;
             _file_size = *(reinterpret_cast<uint32_t*>(payload->data));
+            if (_curr_op == CMD_OPEN_FILE_RO_XZ) {
+                _compressed_download = true;
+                _uncompressed_size = *(reinterpret_cast<uint32_t*>(payload->data + 4));
+            }
+            _curr_op = CMD_NONE;
+            _bytes_transferred = _resume_download_offset();
+            _burst_offset = _bytes_transferred;
+            _missing_ranges.clear();
             _call_op_progress_callback(_bytes_transferred, _file_size);
-            _read();
+            if (_burst_read_enabled && _burst_read_supported) {
+                _burst_data_received = false;
+                _burst_read();
+            } else {
+                _read();
+            }
+            break;
+
+        case CMD_BURST_READ_FILE:
+            _process_burst_ack(payload);
             break;
 
         case CMD_READ_FILE:
-            _ofstream.stream.write(reinterpret_cast<const char*>(payload->data), payload->size);
-            if (!_ofstream.stream) {
+            if (!_missing_ranges.empty()) {
+                // This is the answer to a re-request of a chunk lost during a burst.
+                auto& range = _missing_ranges.front();
+                if (payload->offset != range.offset) {
+                    LogWarn() << "Received chunk not matching missing range";
+                    return;
+                }
+                if (payload->size == 0) {
+                    _session_result = ServerResult::ERR_FAIL;
+                    _end_read_session();
+                    return;
+                }
+                const uint32_t size = std::min(static_cast<uint32_t>(payload->size), range.size);
+                if (!_write_download_data(payload->offset, payload->data, size)) {
+                    _session_result = ServerResult::ERR_FILE_IO_ERROR;
+                    _end_read_session();
+                    return;
+                }
+                range.offset += size;
+                range.size -= size;
+                if (range.size == 0) {
+                    _missing_ranges.erase(_missing_ranges.begin());
+                }
+                _bytes_transferred += size;
+                _call_op_progress_callback(_bytes_transferred, _file_size);
+                _read_missing();
+                break;
+            }
+            if (!_write_download_data(payload->offset, payload->data, payload->size)) {
                 _session_result = ServerResult::ERR_FILE_IO_ERROR;
                 _end_read_session();
                 return;
@@ -263,11 +374,8 @@ void MavlinkFtp::_process_ack(PayloadHeader* payload)
             _session_valid = true;
             _session = payload->session;
             _bytes_transferred = 0;
-            _call_op_progress_callback(_bytes_transferred, _file_size);
-            _write();
-            break;
-
-        case CMD_WRITE_FILE:
+            _write_offset = 0;
+            _pending_writes.clear();
             _call_op_progress_callback(_bytes_transferred, _file_size);
             _write();
             break;
@@ -286,31 +394,6 @@ void MavlinkFtp::_process_ack(PayloadHeader* payload)
             _call_op_result_callback(_session_result);
             break;
 
-        case CMD_LIST_DIRECTORY: {
-            bool added = false;
-            uint8_t start = 0;
-            for (uint8_t i = 0; i < payload->size; i++) {
-                if (payload->data[i] == 0) {
-                    std::string entry = std::string(reinterpret_cast<char*>(&payload->data[start]));
-                    if (entry.length() > 0) {
-                        added = true;
-                        _curr_directory_list.emplace_back(entry);
-                    }
-                    start = i + 1;
-                }
-            }
-            if (added) {
-                // Ask for next batch of file names
-                _list_directory(_curr_directory_list.size());
-            } else {
-                // We came to end - report entire list
-                _curr_op = CMD_NONE;
-                _stop_timer();
-                _call_dir_items_result_callback(ServerResult::SUCCESS, _curr_directory_list);
-            }
-            break;
-        }
-
         case CMD_CALC_FILE_CRC32: {
             _curr_op = CMD_NONE;
             uint32_t checksum = *reinterpret_cast<uint32_t*>(payload->data);
@@ -330,11 +413,46 @@ void MavlinkFtp::_process_ack(PayloadHeader* payload)
 void MavlinkFtp::_process_nak(PayloadHeader* payload)
 {
     if (payload != nullptr) {
+        Trace::instant("ftp", "nak", payload->req_opcode);
+        {
+            std::lock_guard<std::mutex> lock(_curr_op_mutex);
+            if (payload->req_opcode == CMD_BURST_READ_FILE && _curr_op != CMD_BURST_READ_FILE) {
+                // A burst can still trail off after we have moved on.
+                return;
+            }
+            if (payload->req_opcode == CMD_WRITE_FILE && _curr_op == CMD_WRITE_FILE) {
+                // Send just the refused write again, unless it keeps failing.
+                auto it = std::find_if(
+                    _pending_writes.begin(), _pending_writes.end(), [&](const auto& pending) {
+                        return static_cast<uint16_t>(pending.seq_number + 1) ==
+                               payload->seq_number;
+                    });
+                if (it == _pending_writes.end()) {
+                    // Refers to a write we have already sent again.
+                    return;
+                }
+                if (it->retries < _max_last_command_retries) {
+                    ++it->retries;
+                    LogWarn() << "Write at " << it->offset << " refused, retry: " << it->retries;
+                    if (_pack_write(*it)) {
+                        _system_impl.send_message(_last_command);
+                    }
+                    return;
+                }
+            }
+        }
         ServerResult sr = static_cast<ServerResult>(payload->data[0]);
         // PX4 Mavlink FTP returns "File doesn't exist" this way
         if (sr == ServerResult::ERR_FAIL_ERRNO && payload->data[1] == ENOENT) {
             sr = ServerResult::ERR_FAIL_FILE_DOES_NOT_EXIST;
         }
+        if (payload->req_opcode == CMD_LIST_DIRECTORY) {
+            std::lock_guard<std::mutex> lock(_curr_op_mutex);
+            if (_curr_op == CMD_LIST_DIRECTORY) {
+                _process_list_nak(*payload, sr);
+                return;
+            }
+        }
         _process_nak(sr);
     }
 }
@@ -342,18 +460,52 @@ void MavlinkFtp::_process_nak(PayloadHeader* payload)
 void MavlinkFtp::_process_nak(ServerResult result)
 {
     std::lock_guard<std::mutex> lock(_curr_op_mutex);
+
+    if (_curr_op == CMD_OPEN_FILE_RO_XZ && result != ServerResult::ERR_TIMEOUT) {
+        // Other servers don't know the command, and any other error, e.g. a
+        // missing file, is reported by the plain open.
+        if (result == ServerResult::ERR_UNKOWN_COMMAND) {
+            LogDebug() << "Compressed downloads not supported, falling back";
+            _compression_supported = false;
+        }
+        _curr_op = CMD_NONE;
+        _generic_command_async(CMD_OPEN_FILE_RO, 0, _remote_path, _curr_op_result_callback);
+        return;
+    }
+
     switch (_curr_op) {
         case CMD_NONE:
             LogWarn() << "Received NAK without active operation";
             break;
 
+        case CMD_BURST_READ_FILE:
+            if (result == ServerResult::ERR_EOF) {
+                // The server signals that the burst went past the end of the file.
+                _finish_burst_read();
+                return;
+            }
+            if (result == ServerResult::ERR_UNKOWN_COMMAND && !_burst_data_received) {
+                LogWarn() << "Burst read not supported, falling back to single reads";
+                _burst_read_supported = false;
+                _read();
+                return;
+            }
+            [[fallthrough]];
         case CMD_OPEN_FILE_RO:
+        case CMD_OPEN_FILE_RO_XZ:
         case CMD_READ_FILE:
             _session_result = result;
             if (_session_valid) {
                 const bool delete_file = (result == ServerResult::ERR_FAIL_FILE_DOES_NOT_EXIST);
                 _end_read_session(delete_file);
             } else {
+                if (_ofstream.stream.is_open()) {
+                    // Timed out, keep what we have for the next try.
+                    if (_curr_op != CMD_OPEN_FILE_RO && _curr_op != CMD_OPEN_FILE_RO_XZ) {
+                        _save_resume_info();
+                    }
+                    _ofstream.stream.close();
+                }
                 _stop_timer();
                 _call_op_result_callback(_session_result);
             }
@@ -365,6 +517,10 @@ void MavlinkFtp::_process_nak(ServerResult result)
             if (_session_valid) {
                 _end_write_session();
             } else {
+                if (_ifstream.is_open()) {
+                    _ifstream.close();
+                }
+                _pending_writes.clear();
                 _stop_timer();
                 _call_op_result_callback(_session_result);
             }
@@ -377,12 +533,7 @@ void MavlinkFtp::_process_nak(ServerResult result)
             break;
 
         case CMD_LIST_DIRECTORY:
-            _stop_timer();
-            if (!_curr_directory_list.empty()) {
-                _call_dir_items_result_callback(ServerResult::SUCCESS, _curr_directory_list);
-            } else {
-                _call_dir_items_result_callback(result, _curr_directory_list);
-            }
+            _finish_list(result);
             break;
 
         case CMD_CALC_FILE_CRC32:
@@ -416,6 +567,10 @@ void MavlinkFtp::_call_op_progress_callback(uint32_t bytes_read, uint32_t total_
         if (_last_progress_percentage != percentage) {
             _last_progress_percentage = percentage;
 
+            if (_ofstream.stream.is_open() && _curr_op != CMD_OPEN_FILE_RO) {
+                _save_resume_info();
+            }
+
             const auto temp_callback = _curr_op_progress_callback;
             _system_impl.call_user_callback([temp_callback, bytes_read, total_bytes]() {
                 ProgressData progress;
@@ -427,12 +582,14 @@ void MavlinkFtp::_call_op_progress_callback(uint32_t bytes_read, uint32_t total_
     }
 }
 
-void MavlinkFtp::_call_dir_items_result_callback(ServerResult result, std::vector<std::string> list)
+void MavlinkFtp::_call_dir_items_result_callback(
+    ServerResult result, std::vector<std::string> list, bool next)
 {
     if (_curr_dir_items_result_callback) {
         const auto temp_callback = _curr_dir_items_result_callback;
-        _system_impl.call_user_callback(
-            [temp_callback, result, list]() { temp_callback(_translate(result), list); });
+        _system_impl.call_user_callback([temp_callback, result, list, next]() {
+            temp_callback(next ? ClientResult::Next : _translate(result), list);
+        });
     }
 }
 
@@ -462,6 +619,8 @@ MavlinkFtp::ClientResult MavlinkFtp::_translate(ServerResult result)
             return ClientResult::Unsupported;
         case ServerResult::ERR_FAIL_FILE_DOES_NOT_EXIST:
             return ClientResult::FileDoesNotExist;
+        case ServerResult::ERR_NO_SESSIONS_AVAILABLE:
+            return ClientResult::NoSessionsAvailable;
         default:
             return ClientResult::ProtocolError;
     }
@@ -497,8 +656,23 @@ void MavlinkFtp::download_async(
 
     std::string local_path = local_folder + path_separator + fs_filename(remote_path);
 
-    _ofstream.stream.open(local_path, std::fstream::trunc | std::fstream::binary);
+    if (_ofstream.stream.is_open()) {
+        _ofstream.stream.close();
+    }
+    _download_to_memory = false;
+    _compressed_download = false;
+
+    // A partial download of the same file is continued once we know the size.
+    _resume = TransferResume::load(local_path);
+    if (_resume && _resume->source == remote_path) {
+        _ofstream.stream.open(local_path, std::fstream::in | std::fstream::binary);
+    }
+    if (!_ofstream.stream.is_open()) {
+        _resume.reset();
+        _ofstream.stream.open(local_path, std::fstream::trunc | std::fstream::binary);
+    }
     _ofstream.path = local_path;
+    _remote_path = remote_path;
     if (!_ofstream.stream) {
         _end_read_session();
         ProgressData empty{};
@@ -514,22 +688,205 @@ void MavlinkFtp::download_async(
         callback(result, empty);
     };
 
-    _generic_command_async(CMD_OPEN_FILE_RO, 0, remote_path, result_callback);
+    _generic_command_async(_open_read_opcode(), 0, remote_path, result_callback);
+}
+
+void MavlinkFtp::download_to_memory_async(
+    const std::string& remote_path, DownloadToMemoryCallback callback)
+{
+    std::lock_guard<std::mutex> lock(_curr_op_mutex);
+    if (_curr_op != CMD_NONE) {
+        ProgressData empty{};
+        callback(ClientResult::Busy, empty, {});
+        return;
+    }
+
+    if (_ofstream.stream.is_open()) {
+        _ofstream.stream.close();
+    }
+    _resume.reset();
+    _download_to_memory = true;
+    _compressed_download = false;
+    _download_buffer.clear();
+    _remote_path = remote_path;
+
+    _curr_download_to_memory_callback = callback;
+    _curr_op_progress_callback = [callback](ClientResult result, ProgressData progress) {
+        callback(result, progress, {});
+    };
+    _last_progress_percentage = -1;
+
+    const auto result_callback = [callback](ClientResult result) {
+        ProgressData empty{};
+        callback(result, empty, {});
+    };
+
+    _generic_command_async(_open_read_opcode(), 0, remote_path, result_callback);
+}
+
+bool MavlinkFtp::set_compression_enabled(bool enabled)
+{
+    if (enabled && !xz_supported()) {
+        return false;
+    }
+    _compression_enabled = enabled;
+    return true;
+}
+
+MavlinkFtp::Opcode MavlinkFtp::_open_read_opcode() const
+{
+    return (_compression_enabled && _compression_supported) ? CMD_OPEN_FILE_RO_XZ :
+                                                              CMD_OPEN_FILE_RO;
+}
+
+bool MavlinkFtp::_write_download_data(uint32_t offset, const uint8_t* data, uint32_t size)
+{
+    if (!_download_to_memory && !_compressed_download) {
+        _ofstream.stream.seekp(offset);
+        _ofstream.stream.write(reinterpret_cast<const char*>(data), size);
+        return static_cast<bool>(_ofstream.stream);
+    }
+
+    if (offset + size > _download_buffer.size()) {
+        // Only if the server sends more than it announced.
+        _download_buffer.resize(offset + size);
+    }
+    std::memcpy(_download_buffer.data() + offset, data, size);
+    return true;
 }
 
 void MavlinkFtp::_end_read_session(bool delete_file)
 {
     _curr_op = CMD_NONE;
+    if (_compressed_download && _session_result == ServerResult::SUCCESS) {
+        _session_result = _decompress_download();
+    }
+    if (_download_to_memory) {
+        _download_to_memory = false;
+        // The content is handed over once the session is terminated.
+        auto content = std::make_shared<std::vector<uint8_t>>(std::move(_download_buffer));
+        _download_buffer = {};
+        const auto callback = _curr_download_to_memory_callback;
+        const uint32_t file_size = _file_size;
+        _curr_op_result_callback = [callback, content, file_size](ClientResult result) {
+            ProgressData progress{};
+            if (result == ClientResult::Success) {
+                progress.bytes_transferred = file_size;
+                progress.total_bytes = file_size;
+                callback(result, progress, std::move(*content));
+            } else {
+                callback(result, progress, {});
+            }
+        };
+    }
     if (_ofstream.stream.is_open()) {
         _ofstream.stream.close();
 
+        if (delete_file || _session_result == ServerResult::SUCCESS) {
+            TransferResume::remove(_ofstream.path);
+        } else {
+            // Whatever arrived is kept, for the next try.
+            _save_resume_info();
+        }
+
         if (delete_file) {
             fs_remove(_ofstream.path);
         }
     }
+    if (_compressed_download) {
+        _compressed_download = false;
+        _download_buffer = {};
+    }
     _terminate_session();
 }
 
+MavlinkFtp::ServerResult MavlinkFtp::_decompress_download()
+{
+    auto maybe_content = xz_decompress(_download_buffer);
+    _download_buffer = {};
+    if (!maybe_content || maybe_content->size() != _uncompressed_size) {
+        LogErr() << "Could not decompress download of " << _remote_path;
+        return ServerResult::ERR_FAIL;
+    }
+    _file_size = _uncompressed_size;
+
+    if (_download_to_memory) {
+        _download_buffer = std::move(maybe_content.value());
+        return ServerResult::SUCCESS;
+    }
+
+    // Whatever a previous, uncompressed try left in the file is replaced.
+    _ofstream.stream.close();
+    _ofstream.stream.open(_ofstream.path, std::fstream::trunc | std::fstream::binary);
+    _ofstream.stream.write(
+        reinterpret_cast<const char*>(maybe_content->data()), maybe_content->size());
+    return _ofstream.stream ? ServerResult::SUCCESS : ServerResult::ERR_FILE_IO_ERROR;
+}
+
+uint32_t MavlinkFtp::_resume_download_offset()
+{
+    if (_compressed_download) {
+        // The compressed content can't be continued where a previous try
+        // stopped, so it always starts over, in memory.
+        _resume.reset();
+        _download_buffer.assign(_file_size, 0);
+        return 0;
+    }
+
+    if (_download_to_memory) {
+        _download_buffer.assign(_file_size, 0);
+        return 0;
+    }
+
+    uint32_t offset = 0;
+    if (_resume && _resume->total_bytes == _file_size) {
+        offset = static_cast<uint32_t>(
+            TransferResume::resume_offset(_ofstream.path, _remote_path, _file_size));
+    }
+
+    if (offset == 0 && _resume) {
+        // The file changed since, so we start over.
+        _ofstream.stream.close();
+        _ofstream.stream.open(_ofstream.path, std::fstream::trunc | std::fstream::binary);
+    } else if (offset > 0) {
+        LogDebug() << "Resuming download of " << _remote_path << " at " << offset << " bytes";
+        _ofstream.stream.seekp(offset);
+    }
+    _resume.reset();
+
+    _save_resume_info(offset);
+    return offset;
+}
+
+void MavlinkFtp::_save_resume_info()
+{
+    // Everything before the first gap is on disk.
+    uint32_t received = std::max(_burst_offset, _bytes_transferred);
+    if (!_missing_ranges.empty()) {
+        received = _missing_ranges.front().offset;
+    }
+    _save_resume_info(std::min(received, _file_size));
+}
+
+void MavlinkFtp::_save_resume_info(uint32_t received_bytes)
+{
+    if (_download_to_memory || _compressed_download) {
+        return;
+    }
+
+    if (_ofstream.stream.is_open()) {
+        _ofstream.stream.flush();
+    }
+
+    TransferResume resume;
+    resume.source = _remote_path;
+    resume.total_bytes = _file_size;
+    resume.received_bytes = received_bytes;
+    if (!resume.save(_ofstream.path)) {
+        LogWarn() << "Could not save resume info for " << _ofstream.path;
+    }
+}
+
 void MavlinkFtp::_read()
 {
     if (_bytes_transferred >= _file_size) {
@@ -548,6 +905,86 @@ void MavlinkFtp::_read()
     _send_mavlink_ftp_message(payload);
 }
 
+void MavlinkFtp::_burst_read()
+{
+    if (_burst_offset >= _file_size) {
+        _finish_burst_read();
+        return;
+    }
+
+    auto payload = PayloadHeader{};
+    payload.seq_number = _seq_number++;
+    payload.session = _session;
+    payload.opcode = _curr_op = CMD_BURST_READ_FILE;
+    payload.offset = _burst_offset;
+    payload.size = 0;
+    _send_mavlink_ftp_message(payload);
+}
+
+void MavlinkFtp::_process_burst_ack(PayloadHeader* payload)
+{
+    _burst_data_received = true;
+
+    // Burst packets come with consecutive sequence numbers, so we need to
+    // keep up in order to accept the next ones.
+    _seq_number = payload->seq_number + 1;
+
+    if (payload->offset > _burst_offset) {
+        // We lost packets in between, these get re-requested at the end.
+        _missing_ranges.push_back(MissingRange{_burst_offset, payload->offset - _burst_offset});
+    }
+
+    if (payload->offset >= _burst_offset && payload->size > 0) {
+        if (!_write_download_data(payload->offset, payload->data, payload->size)) {
+            _session_result = ServerResult::ERR_FILE_IO_ERROR;
+            _end_read_session();
+            return;
+        }
+        _burst_offset = payload->offset + payload->size;
+        _bytes_transferred += payload->size;
+        _call_op_progress_callback(_bytes_transferred, _file_size);
+    }
+
+    _reset_timer();
+
+    if (_burst_offset >= _file_size) {
+        _finish_burst_read();
+    } else if (payload->burst_complete) {
+        // The server might limit the burst size, so we ask for the rest.
+        _burst_read();
+    }
+}
+
+void MavlinkFtp::_finish_burst_read()
+{
+    if (_burst_offset < _file_size) {
+        // The burst ended early, so the remaining part is missing too.
+        _missing_ranges.push_back(MissingRange{_burst_offset, _file_size - _burst_offset});
+        _burst_offset = _file_size;
+    }
+
+    _read_missing();
+}
+
+void MavlinkFtp::_read_missing()
+{
+    if (_missing_ranges.empty()) {
+        _session_result = ServerResult::SUCCESS;
+        _end_read_session();
+        return;
+    }
+
+    const auto& range = _missing_ranges.front();
+
+    auto payload = PayloadHeader{};
+    payload.seq_number = _seq_number++;
+    payload.session = _session;
+    payload.opcode = _curr_op = CMD_READ_FILE;
+    payload.offset = range.offset;
+    payload.size = std::min(static_cast<uint32_t>(max_data_length), range.size);
+    _send_mavlink_ftp_message(payload);
+}
+
 void MavlinkFtp::upload_async(
     const std::string& local_file_path, const std::string& remote_folder, UploadCallback callback)
 {
@@ -590,6 +1027,7 @@ void MavlinkFtp::upload_async(
 void MavlinkFtp::_end_write_session()
 {
     _curr_op = CMD_NONE;
+    _pending_writes.clear();
     if (_ifstream) {
         _ifstream.close();
     }
@@ -604,20 +1042,75 @@ void MavlinkFtp::_write()
         return;
     }
 
+    // Top up the window, the server writes each chunk at its offset, so
+    // the order in which they arrive doesn't matter.
+    while (_pending_writes.size() < _write_window && _write_offset < _file_size) {
+        PendingWrite pending_write{};
+        pending_write.offset = _write_offset;
+        pending_write.size = static_cast<uint8_t>(
+            std::min(static_cast<uint32_t>(max_data_length), _file_size - _write_offset));
+        pending_write.retries = 0;
+        if (!_pack_write(pending_write)) {
+            _end_write_session();
+            _call_op_result_callback(ServerResult::ERR_FILE_IO_ERROR);
+            return;
+        }
+        _write_offset += pending_write.size;
+        _pending_writes.push_back(pending_write);
+        _send_last_command();
+    }
+}
+
+bool MavlinkFtp::_pack_write(PendingWrite& pending_write)
+{
     auto payload = PayloadHeader{};
     payload.seq_number = _seq_number++;
     payload.session = _session;
     payload.opcode = _curr_op = CMD_WRITE_FILE;
-    payload.offset = _bytes_transferred;
-    int bytes_read = _ifstream.readsome(reinterpret_cast<char*>(payload.data), max_data_length);
-    if (!_ifstream) {
-        _end_write_session();
-        _call_op_result_callback(ServerResult::ERR_FILE_IO_ERROR);
+    payload.offset = pending_write.offset;
+    payload.size = pending_write.size;
+
+    _ifstream.seekg(pending_write.offset);
+    _ifstream.read(reinterpret_cast<char*>(payload.data), pending_write.size);
+    if (!_ifstream || _ifstream.gcount() != pending_write.size) {
+        return false;
+    }
+
+    pending_write.seq_number = payload.seq_number;
+    _pack_mavlink_ftp_message(payload);
+    return true;
+}
+
+void MavlinkFtp::_process_write_ack(PayloadHeader* payload)
+{
+    // The server answers with the sequence number of the write plus one.
+    auto it =
+        std::find_if(_pending_writes.begin(), _pending_writes.end(), [&](const auto& pending) {
+            return static_cast<uint16_t>(pending.seq_number + 1) == payload->seq_number;
+        });
+    if (it == _pending_writes.end()) {
+        // Duplicate ack of a write we sent again.
         return;
     }
-    payload.size = bytes_read;
-    _bytes_transferred += bytes_read;
-    _send_mavlink_ftp_message(payload);
+
+    _bytes_transferred += it->size;
+    _pending_writes.erase(it);
+    _call_op_progress_callback(_bytes_transferred, _file_size);
+    _write();
+}
+
+void MavlinkFtp::_prepare_write_retry()
+{
+    // Nothing has been acked for a while, so everything in flight is sent
+    // again. The last one is left packed for the caller to send.
+    for (std::size_t i = 0; i < _pending_writes.size(); ++i) {
+        if (!_pack_write(_pending_writes[i])) {
+            return;
+        }
+        if (i + 1 < _pending_writes.size()) {
+            _system_impl.send_message(_last_command);
+        }
+    }
 }
 
 void MavlinkFtp::_terminate_session()
@@ -650,9 +1143,21 @@ MavlinkFtp::list_directory(const std::string& path)
 
 void MavlinkFtp::list_directory_async(
     const std::string& path, ListDirectoryCallback callback, uint32_t offset)
+{
+    _start_list(path, offset, false, std::move(callback));
+}
+
+void MavlinkFtp::list_directory_streaming_async(
+    const std::string& path, ListDirectoryCallback callback)
+{
+    _start_list(path, 0, true, std::move(callback));
+}
+
+void MavlinkFtp::_start_list(
+    const std::string& path, uint32_t offset, bool streaming, ListDirectoryCallback callback)
 {
     std::lock_guard<std::mutex> lock(_curr_op_mutex);
-    if (_curr_op != CMD_NONE && offset == 0) {
+    if (_curr_op != CMD_NONE) {
         callback(ClientResult::Busy, std::vector<std::string>());
         return;
     }
@@ -662,25 +1167,206 @@ void MavlinkFtp::list_directory_async(
     }
 
     _last_path = path;
-    // TODOTODO
-    _curr_dir_items_result_callback = callback;
-    _list_directory(offset);
+    _curr_dir_items_result_callback = std::move(callback);
+    _curr_directory_list.clear();
+    _pending_lists.clear();
+    _list_entries.clear();
+    _list_start = offset;
+    _list_received = offset;
+    _list_next_offset = offset;
+    _list_entries_per_reply = 0;
+    _list_end.reset();
+    _list_streaming = streaming;
+
+    _curr_op = CMD_LIST_DIRECTORY;
+    _continue_list();
+}
+
+void MavlinkFtp::_send_list(uint32_t offset)
+{
+    PendingList pending_list{};
+    pending_list.offset = offset;
+    _pack_list(pending_list);
+    _pending_lists.push_back(pending_list);
+    _send_last_command();
 }
 
-void MavlinkFtp::_list_directory(uint32_t offset)
+void MavlinkFtp::_pack_list(PendingList& pending_list)
 {
     auto payload = PayloadHeader{};
     payload.seq_number = _seq_number++;
     payload.session = 0;
     payload.opcode = _curr_op = CMD_LIST_DIRECTORY;
-    payload.offset = offset;
+    payload.offset = pending_list.offset;
     strncpy(reinterpret_cast<char*>(payload.data), _last_path.c_str(), max_data_length - 1);
     payload.size = _last_path.length() + 1;
 
-    if (offset == 0) {
-        _curr_directory_list.clear();
+    pending_list.seq_number = payload.seq_number;
+    _pack_mavlink_ftp_message(payload);
+}
+
+bool MavlinkFtp::_is_list_requested(uint32_t from_offset, uint32_t to_offset) const
+{
+    return std::any_of(_pending_lists.begin(), _pending_lists.end(), [&](const auto& pending) {
+        return pending.offset >= from_offset && pending.offset <= to_offset;
+    });
+}
+
+void MavlinkFtp::_process_list_ack(PayloadHeader* payload)
+{
+    // The server answers with the sequence number of the request plus one.
+    auto it =
+        std::find_if(_pending_lists.begin(), _pending_lists.end(), [&](const auto& pending) {
+            return static_cast<uint16_t>(pending.seq_number + 1) == payload->seq_number;
+        });
+    if (it == _pending_lists.end()) {
+        // Duplicate reply to a request we sent again.
+        return;
+    }
+    const uint32_t offset = it->offset;
+    _pending_lists.erase(it);
+
+    uint32_t count = 0;
+    uint8_t start = 0;
+    for (uint8_t i = 0; i < payload->size; i++) {
+        if (payload->data[i] == 0) {
+            if (i > start) {
+                const uint32_t index = offset + count;
+                if (index >= _list_received) {
+                    _list_entries.emplace(
+                        index,
+                        std::string(reinterpret_cast<char*>(&payload->data[start]), i - start));
+                }
+                ++count;
+            }
+            start = i + 1;
+        }
+    }
+
+    if (count == 0) {
+        // Nothing at this offset, so the directory ends here.
+        _list_end = std::min(_list_end.value_or(offset), offset);
+    } else {
+        _list_entries_per_reply =
+            (_list_entries_per_reply == 0) ? count : std::min(_list_entries_per_reply, count);
+
+        // Unless a request in flight is expected to cover it, the rest
+        // after this reply is asked for right away.
+        const uint32_t next = offset + count;
+        const bool covered = next < _list_received || _list_entries.count(next) > 0 ||
+                             _is_list_requested(offset + 1, next) ||
+                             (_list_end && next >= _list_end.value());
+        if (!covered) {
+            _send_list(next);
+        }
+        _list_next_offset =
+            std::max(_list_next_offset, covered ? next : next + _list_entries_per_reply);
+    }
+
+    _reset_timer();
+    _pass_on_list_entries();
+    _continue_list();
+}
+
+void MavlinkFtp::_process_list_nak(const PayloadHeader& payload, ServerResult result)
+{
+    auto it =
+        std::find_if(_pending_lists.begin(), _pending_lists.end(), [&](const auto& pending) {
+            return static_cast<uint16_t>(pending.seq_number + 1) == payload.seq_number;
+        });
+    if (it == _pending_lists.end()) {
+        return;
+    }
+    const uint32_t offset = it->offset;
+    _pending_lists.erase(it);
+
+    if (result != ServerResult::ERR_EOF) {
+        _finish_list(result);
+        return;
+    }
+
+    // Requests past the end are expected, we can't know where it is.
+    _list_end = std::min(_list_end.value_or(offset), offset);
+    _continue_list();
+}
+
+void MavlinkFtp::_continue_list()
+{
+    if (_list_end && _list_received >= _list_end.value()) {
+        _finish_list(ServerResult::SUCCESS);
+        return;
+    }
+
+    // Until the end is known, the window is kept full with guesses.
+    const uint32_t step =
+        (_list_entries_per_reply == 0) ? _list_entries_guess : _list_entries_per_reply;
+    while (!_list_end && _pending_lists.size() < _list_window) {
+        if (!_is_list_requested(_list_next_offset, _list_next_offset)) {
+            _send_list(_list_next_offset);
+        }
+        _list_next_offset += step;
+    }
+
+    if (_pending_lists.empty()) {
+        // Only if the directory changed while we list it.
+        _send_list(_list_received);
+    }
+}
+
+void MavlinkFtp::_pass_on_list_entries()
+{
+    std::vector<std::string> entries;
+    while (!_list_entries.empty() && _list_entries.begin()->first <= _list_received) {
+        auto first = _list_entries.begin();
+        if (first->first == _list_received) {
+            entries.push_back(std::move(first->second));
+            ++_list_received;
+        }
+        _list_entries.erase(first);
+    }
+
+    if (entries.empty()) {
+        return;
+    }
+    if (_list_streaming) {
+        _call_dir_items_result_callback(ServerResult::SUCCESS, std::move(entries), true);
+    } else {
+        _curr_directory_list.insert(
+            _curr_directory_list.end(),
+            std::make_move_iterator(entries.begin()),
+            std::make_move_iterator(entries.end()));
+    }
+}
+
+void MavlinkFtp::_finish_list(ServerResult result)
+{
+    _curr_op = CMD_NONE;
+    _pending_lists.clear();
+    _list_entries.clear();
+    _stop_timer();
+
+    // An empty directory ends with EOF right away.
+    if (_list_received > _list_start || result == ServerResult::ERR_EOF) {
+        result = ServerResult::SUCCESS;
+    }
+    if (_list_streaming) {
+        _call_dir_items_result_callback(result, {});
+    } else {
+        _call_dir_items_result_callback(result, std::move(_curr_directory_list));
+        _curr_directory_list = {};
+    }
+}
+
+void MavlinkFtp::_prepare_list_retry()
+{
+    // Everything in flight is asked for again, the last one is left packed
+    // for the caller to send.
+    for (std::size_t i = 0; i < _pending_lists.size(); ++i) {
+        _pack_list(_pending_lists[i]);
+        if (i + 1 < _pending_lists.size()) {
+            _system_impl.send_message(_last_command);
+        }
     }
-    _send_mavlink_ftp_message(payload);
 }
 
 void MavlinkFtp::_generic_command_async(
@@ -866,7 +1552,7 @@ void MavlinkFtp::_calc_file_crc32_async(const std::string& path, file_crc32_Resu
     _send_mavlink_ftp_message(payload);
 }
 
-void MavlinkFtp::_send_mavlink_ftp_message(const PayloadHeader& payload)
+void MavlinkFtp::_pack_mavlink_ftp_message(const PayloadHeader& payload)
 {
     mavlink_msg_file_transfer_protocol_pack(
         _system_impl.get_own_system_id(),
@@ -876,21 +1562,57 @@ void MavlinkFtp::_send_mavlink_ftp_message(const PayloadHeader& payload)
         _system_impl.get_system_id(),
         _get_target_component_id(),
         reinterpret_cast<const uint8_t*>(&payload));
+}
+
+void MavlinkFtp::_send_mavlink_ftp_message(const PayloadHeader& payload)
+{
+    Trace::instant("ftp", "send", payload.opcode);
+    _pack_mavlink_ftp_message(payload);
+    _send_last_command();
+}
+
+void MavlinkFtp::_send_last_command()
+{
     _system_impl.send_message(_last_command);
 
     _reset_timer();
     std::lock_guard<std::mutex> lock(_timer_mutex);
+    _last_command_sent = _system_impl.get_time().steady_time();
+    _last_command_rtt_pending = true;
     if (!_last_command_timer_running) {
         _last_command_timer_running = true;
         _system_impl.register_timeout_handler(
-            [this]() { _command_timeout(); },
-            static_cast<double>(_last_command_timeout) / 1000.0,
-            &_last_command_timeout_cookie);
+            [this]() { _command_timeout(); }, _command_timeout_s(), &_last_command_timeout_cookie);
+    }
+}
+
+double MavlinkFtp::_command_timeout_s()
+{
+    return _system_impl.rtt_estimator().timeout_s(
+        static_cast<double>(_last_command_timeout) / 1000.0);
+}
+
+void MavlinkFtp::_sample_rtt(const PayloadHeader& payload)
+{
+    // Only the reply to the last command sent tells when it was sent, which
+    // leaves out bursts and all but the newest of several writes in flight.
+    if (payload.seq_number != _seq_number) {
+        return;
     }
+
+    std::lock_guard<std::mutex> lock(_timer_mutex);
+    if (!_last_command_rtt_pending) {
+        return;
+    }
+    _last_command_rtt_pending = false;
+    _system_impl.rtt_estimator().add_sample(
+        _system_impl.get_time().elapsed_since_s(_last_command_sent));
 }
 
 void MavlinkFtp::_command_timeout()
 {
+    Trace::instant("ftp", "timeout", _last_command_retries);
+
     if (_last_command_retries >= _max_last_command_retries) {
         LogErr() << "Response timeout " << _curr_op;
         {
@@ -903,14 +1625,52 @@ void MavlinkFtp::_command_timeout()
     } else {
         _last_command_retries++;
         LogWarn() << "Response timeout. Retry: " << _last_command_retries;
+        {
+            // A reply can't be matched to one of the transmissions anymore.
+            std::lock_guard<std::mutex> lock(_timer_mutex);
+            _last_command_rtt_pending = false;
+        }
+        {
+            std::lock_guard<std::mutex> lock(_curr_op_mutex);
+            if (_curr_op == CMD_BURST_READ_FILE) {
+                _prepare_burst_retry();
+            } else if (_curr_op == CMD_WRITE_FILE) {
+                _prepare_write_retry();
+            } else if (_curr_op == CMD_LIST_DIRECTORY) {
+                _prepare_list_retry();
+            }
+        }
         _system_impl.send_message(_last_command);
         _system_impl.register_timeout_handler(
-            [this]() { _command_timeout(); },
-            static_cast<double>(_last_command_timeout) / 1000.0,
-            &_last_command_timeout_cookie);
+            [this]() { _command_timeout(); }, _command_timeout_s(), &_last_command_timeout_cookie);
     }
 }
 
+void MavlinkFtp::_prepare_burst_retry()
+{
+    // Instead of repeating the original burst request, we continue from
+    // where we are. If nothing ever arrived, the server presumably doesn't
+    // do bursts, so we go back to single reads.
+    auto payload = PayloadHeader{};
+    payload.seq_number = _seq_number++;
+    payload.session = _session;
+
+    if (!_burst_data_received && _last_command_retries >= 2) {
+        LogWarn() << "No burst data received, falling back to single reads";
+        _burst_read_supported = false;
+        payload.opcode = _curr_op = CMD_READ_FILE;
+        payload.offset = _bytes_transferred;
+        payload.size =
+            std::min(static_cast<uint32_t>(max_data_length), _file_size - _bytes_transferred);
+    } else {
+        payload.opcode = CMD_BURST_READ_FILE;
+        payload.offset = _burst_offset;
+        payload.size = 0;
+    }
+
+    _pack_mavlink_ftp_message(payload);
+}
+
 void MavlinkFtp::_reset_timer()
 {
     _system_impl.refresh_timeout_handler(_last_command_timeout_cookie);
@@ -1033,10 +1793,18 @@ MavlinkFtp::ServerResult MavlinkFtp::_work_list(PayloadHeader* payload, bool lis
 
 MavlinkFtp::ServerResult MavlinkFtp::_work_open(PayloadHeader* payload, int oflag)
 {
-    if (_session_info.fd >= 0) {
+    if (_session_info.is_open()) {
         return ServerResult::ERR_NO_SESSIONS_AVAILABLE;
     }
 
+    if (auto maybe_file = _system_impl.ftp_memory_files().get(_data_as_string(payload))) {
+        // Files in memory are only there to be read.
+        if ((oflag & O_ACCMODE) != O_RDONLY) {
+            return ServerResult::ERR_FAIL;
+        }
+        return _work_open_memory_file(payload, maybe_file.value());
+    }
+
     std::string path = [payload, this]() {
         std::lock_guard<std::mutex> lock(_tmp_files_mutex);
         const auto it = _tmp_files.find(_data_as_string(payload));
@@ -1077,6 +1845,7 @@ MavlinkFtp::ServerResult MavlinkFtp::_work_open(PayloadHeader* payload, int ofla
     _session_info.fd = fd;
     _session_info.file_size = file_size;
     _session_info.stream_download = false;
+    _reset_read_buffer();
 
     payload->session = 0;
     payload->size = sizeof(uint32_t);
@@ -1085,9 +1854,75 @@ MavlinkFtp::ServerResult MavlinkFtp::_work_open(PayloadHeader* payload, int ofla
     return ServerResult::SUCCESS;
 }
 
+MavlinkFtp::ServerResult
+MavlinkFtp::_work_open_memory_file(PayloadHeader* payload, const FtpMemoryFiles::File& file)
+{
+    const auto file_size = static_cast<uint32_t>(file.content->size());
+
+    _session_info.memory_file = file.content;
+    _session_info.file_size = file_size;
+    _session_info.stream_download = false;
+    _reset_read_buffer();
+
+    payload->session = 0;
+    payload->size = sizeof(uint32_t);
+    memcpy(payload->data, &file_size, payload->size);
+
+    return ServerResult::SUCCESS;
+}
+
+MavlinkFtp::ServerResult MavlinkFtp::_work_open_xz(PayloadHeader* payload)
+{
+    if (!xz_supported()) {
+        return ServerResult::ERR_UNKOWN_COMMAND;
+    }
+
+    const auto result = _work_open(payload, O_RDONLY);
+    if (result != ServerResult::SUCCESS) {
+        return result;
+    }
+
+    const uint32_t file_size = _session_info.file_size;
+    if (file_size > max_compressed_file_size) {
+        _close_session();
+        return ServerResult::ERR_FAIL;
+    }
+
+    std::vector<uint8_t> content(file_size);
+    uint32_t offset = 0;
+    while (offset < file_size) {
+        const int bytes_read =
+            _read_session_data(offset, content.data() + offset, file_size - offset);
+        if (bytes_read <= 0) {
+            _close_session();
+            return ServerResult::ERR_FAIL;
+        }
+        offset += static_cast<uint32_t>(bytes_read);
+    }
+    _close_session();
+
+    auto maybe_compressed = xz_compress(content.data(), content.size(), compression_preset);
+    if (!maybe_compressed) {
+        return ServerResult::ERR_FAIL;
+    }
+
+    // From here on, the session is served like a file in memory.
+    const auto compressed_size = static_cast<uint32_t>(maybe_compressed->size());
+    _session_info.memory_file =
+        std::make_shared<const std::vector<uint8_t>>(std::move(maybe_compressed.value()));
+    _session_info.file_size = compressed_size;
+
+    payload->session = 0;
+    payload->size = 2 * sizeof(uint32_t);
+    memcpy(payload->data, &compressed_size, sizeof(uint32_t));
+    memcpy(payload->data + sizeof(uint32_t), &file_size, sizeof(uint32_t));
+
+    return ServerResult::SUCCESS;
+}
+
 MavlinkFtp::ServerResult MavlinkFtp::_work_read(PayloadHeader* payload)
 {
-    if (payload->session != 0 || _session_info.fd < 0) {
+    if (payload->session != 0 || !_session_info.is_open()) {
         return ServerResult::ERR_INVALID_SESSION;
     }
 
@@ -1096,11 +1931,7 @@ MavlinkFtp::ServerResult MavlinkFtp::_work_read(PayloadHeader* payload)
         return ServerResult::ERR_EOF;
     }
 
-    if (lseek(_session_info.fd, payload->offset, SEEK_SET) < 0) {
-        return ServerResult::ERR_FAIL;
-    }
-
-    auto bytes_read = ::read(_session_info.fd, &payload->data[0], max_data_length);
+    auto bytes_read = _read_session_data(payload->offset, &payload->data[0], max_data_length);
 
     if (bytes_read < 0) {
         // Negative return indicates error other than eof
@@ -1112,12 +1943,59 @@ MavlinkFtp::ServerResult MavlinkFtp::_work_read(PayloadHeader* payload)
     return ServerResult::SUCCESS;
 }
 
+int MavlinkFtp::_read_session_data(uint32_t offset, uint8_t* data, uint32_t max_length)
+{
+    auto& info = _session_info;
+
+    if (info.memory_file) {
+        if (offset >= info.memory_file->size()) {
+            return 0;
+        }
+        const uint32_t length = std::min(
+            max_length, static_cast<uint32_t>(info.memory_file->size()) - offset);
+        memcpy(data, info.memory_file->data() + offset, length);
+        return static_cast<int>(length);
+    }
+
+    const bool buffered = offset >= info.read_buffer_offset &&
+                          offset < info.read_buffer_offset + info.read_buffer.size();
+    if (!buffered) {
+        if (lseek(info.fd, offset, SEEK_SET) < 0) {
+            return -1;
+        }
+        info.read_buffer.resize(read_ahead_size);
+        const auto bytes_read = ::read(info.fd, info.read_buffer.data(), read_ahead_size);
+        if (bytes_read < 0) {
+            _reset_read_buffer();
+            return -1;
+        }
+        info.read_buffer.resize(bytes_read);
+        info.read_buffer_offset = offset;
+    }
+
+    const uint32_t start = offset - info.read_buffer_offset;
+    const uint32_t length =
+        std::min(max_length, static_cast<uint32_t>(info.read_buffer.size()) - start);
+    memcpy(data, info.read_buffer.data() + start, length);
+    return static_cast<int>(length);
+}
+
+void MavlinkFtp::_reset_read_buffer()
+{
+    _session_info.read_buffer.clear();
+    _session_info.read_buffer_offset = 0;
+}
+
 MavlinkFtp::ServerResult MavlinkFtp::_work_burst(PayloadHeader* payload)
 {
-    if (payload->session != 0 && _session_info.fd < 0) {
+    if (payload->session != 0 && !_session_info.is_open()) {
         return ServerResult::ERR_INVALID_SESSION;
     }
 
+    if (payload->offset >= _session_info.file_size) {
+        return ServerResult::ERR_EOF;
+    }
+
     // Setup for streaming sends
     _session_info.stream_download = true;
     _session_info.stream_offset = payload->offset;
@@ -1125,15 +2003,23 @@ MavlinkFtp::ServerResult MavlinkFtp::_work_burst(PayloadHeader* payload)
     _session_info.stream_seq_number = payload->seq_number + 1;
     _session_info.stream_target_system_id = _system_impl.get_system_id();
 
+    if (_work_notifier) {
+        _work_notifier();
+    }
+
     return ServerResult::SUCCESS;
 }
 
 MavlinkFtp::ServerResult MavlinkFtp::_work_write(PayloadHeader* payload)
 {
-    if (payload->session != 0 && _session_info.fd < 0) {
+    if (payload->session != 0 && !_session_info.is_open()) {
         return ServerResult::ERR_INVALID_SESSION;
     }
 
+    if (_session_info.memory_file) {
+        return ServerResult::ERR_FAIL;
+    }
+
     if (lseek(_session_info.fd, payload->offset, SEEK_SET) < 0) {
         // Unable to see to the specified location
         return ServerResult::ERR_FAIL;
@@ -1154,13 +2040,11 @@ MavlinkFtp::ServerResult MavlinkFtp::_work_write(PayloadHeader* payload)
 
 MavlinkFtp::ServerResult MavlinkFtp::_work_terminate(PayloadHeader* payload)
 {
-    if (payload->session != 0 || _session_info.fd < 0) {
+    if (payload->session != 0 || !_session_info.is_open()) {
         return ServerResult::ERR_INVALID_SESSION;
     }
 
-    close(_session_info.fd);
-    _session_info.fd = -1;
-    _session_info.stream_download = false;
+    _close_session();
 
     payload->size = 0;
 
@@ -1169,10 +2053,8 @@ MavlinkFtp::ServerResult MavlinkFtp::_work_terminate(PayloadHeader* payload)
 
 MavlinkFtp::ServerResult MavlinkFtp::_work_reset(PayloadHeader* payload)
 {
-    if (_session_info.fd != -1) {
-        close(_session_info.fd);
-        _session_info.fd = -1;
-        _session_info.stream_download = false;
+    if (_session_info.is_open()) {
+        _close_session();
     }
 
     payload->size = 0;
@@ -1180,6 +2062,17 @@ MavlinkFtp::ServerResult MavlinkFtp::_work_reset(PayloadHeader* payload)
     return ServerResult::SUCCESS;
 }
 
+void MavlinkFtp::_close_session()
+{
+    if (_session_info.fd >= 0) {
+        close(_session_info.fd);
+        _session_info.fd = -1;
+    }
+    _session_info.memory_file.reset();
+    _session_info.stream_download = false;
+    _reset_read_buffer();
+}
+
 MavlinkFtp::ServerResult MavlinkFtp::_work_remove_directory(PayloadHeader* payload)
 {
     std::string path = _get_path(payload);
@@ -1272,12 +2165,13 @@ MavlinkFtp::ClientResult MavlinkFtp::_calc_local_file_crc32(const std::string& p
         return ClientResult::FileIoError;
     }
 
-    // Read whole file in buffer size chunks
+    // Read whole file in buffer size chunks, large ones as the checksum
+    // itself is fast.
     Crc32 checksum;
-    char buffer[18392];
+    std::vector<char> buffer(256 * 1024);
     ssize_t bytes_read;
     do {
-        bytes_read = ::read(fd, buffer, sizeof(buffer));
+        bytes_read = ::read(fd, buffer.data(), buffer.size());
 
         if (bytes_read < 0) {
             int r_errno = errno;
@@ -1286,8 +2180,8 @@ MavlinkFtp::ClientResult MavlinkFtp::_calc_local_file_crc32(const std::string& p
             return ClientResult::FileIoError;
         }
 
-        checksum.add((uint8_t*)buffer, bytes_read);
-    } while (bytes_read == sizeof(buffer));
+        checksum.add((uint8_t*)buffer.data(), bytes_read);
+    } while (bytes_read > 0);
 
     close(fd);
 
@@ -1298,6 +2192,12 @@ MavlinkFtp::ClientResult MavlinkFtp::_calc_local_file_crc32(const std::string& p
 
 MavlinkFtp::ServerResult MavlinkFtp::_work_calc_file_CRC32(PayloadHeader* payload)
 {
+    if (auto maybe_file = _system_impl.ftp_memory_files().get(_data_as_string(payload))) {
+        payload->size = sizeof(uint32_t);
+        *reinterpret_cast<uint32_t*>(payload->data) = maybe_file->crc32;
+        return ServerResult::SUCCESS;
+    }
+
     std::string path = _get_path(payload);
     if (path.rfind(_root_dir, 0) != 0) {
         LogWarn() << "FTP: invalid path " << path;
@@ -1321,10 +2221,63 @@ MavlinkFtp::ServerResult MavlinkFtp::_work_calc_file_CRC32(PayloadHeader* payloa
 
 void MavlinkFtp::send()
 {
-    // Anything to stream?
-    if (!_session_info.stream_download) {
-        return;
+    std::lock_guard<std::mutex> lock(_server_mutex);
+
+    for (unsigned i = 0; i < stream_chunks_per_send; ++i) {
+        // Anything to stream?
+        if (!_session_info.stream_download) {
+            return;
+        }
+        _send_burst_chunk();
+    }
+}
+
+bool MavlinkFtp::is_streaming()
+{
+    std::lock_guard<std::mutex> lock(_server_mutex);
+    return _session_info.stream_download;
+}
+
+void MavlinkFtp::_send_burst_chunk()
+{
+    auto& info = _session_info;
+
+    auto payload = PayloadHeader{};
+    payload.seq_number = info.stream_seq_number++;
+    payload.session = 0;
+    payload.req_opcode = CMD_BURST_READ_FILE;
+    payload.offset = info.stream_offset;
+
+    const auto bytes_read = _read_session_data(info.stream_offset, payload.data, max_data_length);
+    if (bytes_read <= 0) {
+        payload.opcode = RSP_NAK;
+        payload.size = 1;
+        payload.data[0] = static_cast<uint8_t>(
+            bytes_read < 0 ? ServerResult::ERR_FILE_IO_ERROR : ServerResult::ERR_EOF);
+        info.stream_download = false;
+    } else {
+        payload.opcode = RSP_ACK;
+        payload.size = static_cast<uint8_t>(bytes_read);
+        info.stream_offset += bytes_read;
+        ++info.stream_chunk_transmitted;
+
+        if (info.stream_offset >= info.file_size ||
+            info.stream_chunk_transmitted >= stream_chunks_per_burst) {
+            payload.burst_complete = 1;
+            info.stream_download = false;
+        }
     }
+
+    mavlink_message_t message;
+    mavlink_msg_file_transfer_protocol_pack(
+        _system_impl.get_own_system_id(),
+        _system_impl.get_own_component_id(),
+        &message,
+        _network_id,
+        info.stream_target_system_id,
+        _get_target_component_id(),
+        reinterpret_cast<const uint8_t*>(&payload));
+    _system_impl.send_message(message);
 }
 
 uint8_t MavlinkFtp::get_our_compid()
@@ -1344,6 +2297,20 @@ MavlinkFtp::ClientResult MavlinkFtp::set_target_compid(uint8_t component_id)
     return ClientResult::Success;
 }
 
+size_t MavlinkFtp::memory_usage()
+{
+    std::lock_guard<std::mutex> lock(_curr_op_mutex);
+    size_t bytes = sizeof(MavlinkFtp) + _download_buffer.capacity() +
+                   _missing_ranges.capacity() * sizeof(MissingRange) +
+                   _pending_writes.capacity() * sizeof(PendingWrite) +
+                   _pending_lists.capacity() * sizeof(PendingList) +
+                   _curr_directory_list.capacity() * sizeof(std::string);
+    for (const auto& entry : _curr_directory_list) {
+        bytes += entry.capacity();
+    }
+    return bytes;
+}
+
 std::optional<std::string>
 MavlinkFtp::write_tmp_file(const std::string& path, const std::string& content)
 {
@@ -1423,6 +2390,8 @@ std::ostream& operator<<(std::ostream& str, MavlinkFtp::ClientResult const& resu
             return str << "ProtocolError";
         case MavlinkFtp::ClientResult::NoSystem:
             return str << "NoSystem";
+        case MavlinkFtp::ClientResult::NoSessionsAvailable:
+            return str << "NoSessionsAvailable";
     }
 }
 
@@ -1,8 +1,11 @@
 #pragma once
 
+#include <atomic>
 #include <cinttypes>
 #include <functional>
 #include <fstream>
+#include <map>
+#include <memory>
 #include <unordered_map>
 #include <mutex>
 #include <optional>
@@ -10,7 +13,10 @@
 #include <utility>
 #include <vector>
 
+#include "ftp_memory_files.h"
 #include "mavlink_include.h"
+#include "mavsdk_time.h"
+#include "transfer_resume.h"
 
 // As found in
 // https://stackoverflow.com/questions/1537964#answer-3312896
@@ -26,7 +32,16 @@ class SystemImpl;
 
 class MavlinkFtp {
 public:
-    explicit MavlinkFtp(SystemImpl& system_impl);
+    // Additional clients, e.g. of MavlinkFtpPool, leave answering requests to
+    // the main instance.
+    enum class Mode { ClientAndServer, ClientOnly };
+
+    // Clients sharing a link need to start at different sequence numbers, so
+    // that they can tell their responses apart.
+    explicit MavlinkFtp(
+        SystemImpl& system_impl,
+        Mode mode = Mode::ClientAndServer,
+        uint16_t first_seq_number = 0);
     ~MavlinkFtp();
 
     /**
@@ -46,6 +61,7 @@ public:
         Unsupported, /**< @brief Unsupported command. */
         ProtocolError, /**< @brief General protocol error. */
         NoSystem, /**< @brief No system connected. */
+        NoSessionsAvailable, /**< @brief The server has no session left for us. */
     };
 
     friend std::ostream& operator<<(std::ostream& str, ClientResult const& result);
@@ -58,10 +74,17 @@ public:
     using ResultCallback = std::function<void(ClientResult)>;
     using UploadCallback = std::function<void(ClientResult, ProgressData)>;
     using DownloadCallback = std::function<void(ClientResult, ProgressData)>;
+    // The content is only set with ClientResult::Success.
+    using DownloadToMemoryCallback =
+        std::function<void(ClientResult, ProgressData, std::vector<uint8_t>)>;
     using ListDirectoryCallback = std::function<void(ClientResult, std::vector<std::string>)>;
     using AreFilesIdenticalCallback = std::function<void(ClientResult, bool)>;
 
+    // Streams burst reads served by us, to be called regularly while
+    // streaming.
     void send();
+    bool is_streaming();
+    void set_work_notifier(std::function<void()> notifier) { _work_notifier = std::move(notifier); }
 
     std::pair<ClientResult, std::vector<std::string>> list_directory(const std::string& path);
     ClientResult create_directory(const std::string& path);
@@ -76,12 +99,19 @@ public:
         const std::string& remote_file_path,
         const std::string& local_folder,
         DownloadCallback callback);
+    // Downloads into memory, e.g. for small files that are parsed right away.
+    void download_to_memory_async(
+        const std::string& remote_file_path, DownloadToMemoryCallback callback);
     void upload_async(
         const std::string& local_file_path,
         const std::string& remote_folder,
         UploadCallback callback);
     void list_directory_async(
         const std::string& path, ListDirectoryCallback callback, uint32_t offset = 0);
+    // Like list_directory_async(), but the entries are passed on as they
+    // arrive, in order and with ClientResult::Next. The result comes last,
+    // without entries.
+    void list_directory_streaming_async(const std::string& path, ListDirectoryCallback callback);
     void create_directory_async(const std::string& path, ResultCallback callback);
     void remove_directory_async(const std::string& path, ResultCallback callback);
     void remove_file_async(const std::string& path, ResultCallback callback);
@@ -93,12 +123,22 @@ public:
         AreFilesIdenticalCallback callback);
 
     void set_retries(uint32_t retries) { _max_last_command_retries = retries; }
+    // Burst reads are used for downloads by default and we fall back to
+    // single reads if the server doesn't support them.
+    void set_burst_read_enabled(bool enabled) { _burst_read_enabled = enabled; }
+    // Downloads are transferred xz compressed if the server is MAVSDK as
+    // well, see CMD_OPEN_FILE_RO_XZ. Returns false if we are built without
+    // liblzma.
+    bool set_compression_enabled(bool enabled);
     ClientResult set_root_directory(const std::string& root_dir);
     uint8_t get_our_compid();
     ClientResult set_target_compid(uint8_t component_id);
 
     std::optional<std::string> write_tmp_file(const std::string& path, const std::string& content);
 
+    // Bytes held by the client, mostly for the transfer in progress.
+    size_t memory_usage();
+
 private:
     SystemImpl& _system_impl;
 
@@ -140,6 +180,11 @@ private:
         CMD_CALC_FILE_CRC32, ///< Calculate CRC32 for file at <path>
         CMD_BURST_READ_FILE, ///< Burst download session file
 
+        // MAVSDK extension, like CMD_OPEN_FILE_RO, but the session reads the
+        // file xz compressed. The ack has the compressed size, followed by
+        // the uncompressed size. Other servers nak it as unknown command.
+        CMD_OPEN_FILE_RO_XZ = 100,
+
         RSP_ACK = 128, ///< Ack response
         RSP_NAK ///< Nak response
     };
@@ -176,21 +221,43 @@ private:
 
     struct SessionInfo {
         int fd{-1};
+        // Instead of the fd, for files served from memory.
+        std::shared_ptr<const std::vector<uint8_t>> memory_file{};
         uint32_t file_size{0};
         bool stream_download{false};
         uint32_t stream_offset{0};
         uint16_t stream_seq_number{0};
         uint8_t stream_target_system_id{0};
         unsigned stream_chunk_transmitted{0};
+        // Read ahead, so that the file is not read a chunk at a time.
+        std::vector<uint8_t> read_buffer{};
+        uint32_t read_buffer_offset{0};
+
+        [[nodiscard]] bool is_open() const { return fd >= 0 || memory_file != nullptr; }
     };
 
+    static constexpr uint32_t read_ahead_size{64 * 1024};
+    // Files are compressed in memory when opened, so larger ones are
+    // refused, and the client opens them uncompressed instead.
+    static constexpr uint32_t max_compressed_file_size{8 * 1024 * 1024};
+    // Fast, as it runs while the client waits for the ack.
+    static constexpr uint32_t compression_preset{1};
+    // Bursts are sent a few chunks at a time, and end after a while so that
+    // the client asks for more once it got them, which paces us to the link.
+    static constexpr unsigned stream_chunks_per_send{8};
+    static constexpr unsigned stream_chunks_per_burst{256};
+
     struct OfstreamWithPath {
         std::ofstream stream;
         std::string path;
     };
 
-    struct SessionInfo _session_info {}; ///< Session info, fd=-1 for no active session
+    std::mutex _server_mutex{};
+    // Needs _server_mutex
+    struct SessionInfo _session_info {}; ///< Session info, see is_open() for an active session
+    std::function<void()> _work_notifier{};
 
+    const Mode _mode;
     uint8_t _network_id = 0;
     uint8_t _target_component_id = 0;
     bool _target_component_id_set{false};
@@ -200,13 +267,22 @@ private:
     void* _last_command_timeout_cookie = nullptr;
     bool _last_command_timer_running{false};
     std::mutex _timer_mutex{};
+    // Until the round trip time is known.
     static constexpr uint32_t _last_command_timeout{200};
+    // Needs _timer_mutex
+    SteadyTimePoint _last_command_sent{};
+    bool _last_command_rtt_pending{false};
     uint32_t _max_last_command_retries{5};
     uint32_t _last_command_retries = 0;
     std::string _last_path{};
     uint16_t _seq_number = 0;
     std::ifstream _ifstream{};
     OfstreamWithPath _ofstream{};
+    bool _download_to_memory{false};
+    std::vector<uint8_t> _download_buffer{};
+    DownloadToMemoryCallback _curr_download_to_memory_callback{};
+    std::string _remote_path{};
+    std::optional<TransferResume> _resume{};
     bool _session_valid = false;
     uint8_t _session = 0;
     ServerResult _session_result = ServerResult::SUCCESS;
@@ -214,6 +290,60 @@ private:
     uint32_t _file_size = 0;
     std::vector<std::string> _curr_directory_list{};
 
+    // Listings keep a few requests in flight. The server decides how many
+    // entries fit into a reply, so the offsets after the first are guessed
+    // from the replies so far, and a gap is asked for once a reply shows
+    // where it ended.
+    struct PendingList {
+        uint32_t offset;
+        uint16_t seq_number;
+    };
+
+    static constexpr unsigned _list_window{4};
+    static constexpr uint32_t _list_entries_guess{6};
+    std::vector<PendingList> _pending_lists{};
+    // Entries by their index, until all before them have arrived.
+    std::map<uint32_t, std::string> _list_entries{};
+    uint32_t _list_start{0};
+    // Entries before this index have been passed on.
+    uint32_t _list_received{0};
+    uint32_t _list_next_offset{0};
+    // The fewest entries in a reply so far, 0 until there is one.
+    uint32_t _list_entries_per_reply{0};
+    std::optional<uint32_t> _list_end{};
+    bool _list_streaming{false};
+
+    struct MissingRange {
+        uint32_t offset;
+        uint32_t size;
+    };
+
+    bool _burst_read_enabled{true};
+    bool _burst_read_supported{true};
+    bool _burst_data_received{false};
+    uint32_t _burst_offset{0};
+    std::vector<MissingRange> _missing_ranges{};
+
+    std::atomic<bool> _compression_enabled{false};
+    bool _compression_supported{true};
+    // The download is received into _download_buffer and decompressed at
+    // the end, also if it goes to a file.
+    bool _compressed_download{false};
+    uint32_t _uncompressed_size{0};
+
+    // Uploads keep a few writes in flight, so that they are not bound by the
+    // round trip time. Only the writes which are not acked are sent again.
+    struct PendingWrite {
+        uint32_t offset;
+        uint8_t size;
+        uint16_t seq_number;
+        uint32_t retries;
+    };
+
+    static constexpr unsigned _write_window{8};
+    uint32_t _write_offset{0};
+    std::vector<PendingWrite> _pending_writes{};
+
     ResultCallback _curr_op_result_callback{};
     // _curr_op_progress_callback is used for download_callback_t as well as upload_callback_t
     static_assert(
@@ -228,27 +358,60 @@ private:
     void _calc_file_crc32_async(const std::string& path, file_crc32_ResultCallback callback);
     ClientResult _calc_local_file_crc32(const std::string& path, uint32_t& csum);
 
+    bool _is_our_response(const PayloadHeader& payload);
     void _process_ack(PayloadHeader* payload);
     void _process_nak(PayloadHeader* payload);
     void _process_nak(ServerResult result);
     static ClientResult _translate(ServerResult result);
     void _call_op_result_callback(ServerResult result);
     void _call_op_progress_callback(uint32_t bytes_written, uint32_t total_bytes);
-    void _call_dir_items_result_callback(ServerResult result, std::vector<std::string> list);
+    void _call_dir_items_result_callback(
+        ServerResult result, std::vector<std::string> list, bool next = false);
     void _call_crc32_result_callback(ServerResult result, uint32_t crc32);
     void _generic_command_async(
         Opcode opcode, uint32_t offset, const std::string& path, ResultCallback callback);
     void _read();
+    void _burst_read();
+    void _process_burst_ack(PayloadHeader* payload);
+    void _finish_burst_read();
+    void _read_missing();
     void _write();
+    bool _pack_write(PendingWrite& pending_write);
+    void _process_write_ack(PayloadHeader* payload);
+    void _prepare_write_retry();
+    bool _write_download_data(uint32_t offset, const uint8_t* data, uint32_t size);
+    Opcode _open_read_opcode() const;
+    ServerResult _decompress_download();
     void _end_read_session(bool delete_file = false);
+    uint32_t _resume_download_offset();
+    void _save_resume_info();
+    void _save_resume_info(uint32_t received_bytes);
     void _end_write_session();
     void _terminate_session();
+    void _pack_mavlink_ftp_message(const PayloadHeader& payload);
     void _send_mavlink_ftp_message(const PayloadHeader& payload);
+    void _send_last_command();
 
     void _command_timeout();
+    double _command_timeout_s();
+    void _sample_rtt(const PayloadHeader& payload);
+    void _prepare_burst_retry();
     void _reset_timer();
     void _stop_timer();
-    void _list_directory(uint32_t offset);
+    void _start_list(
+        const std::string& path,
+        uint32_t offset,
+        bool streaming,
+        ListDirectoryCallback callback);
+    void _send_list(uint32_t offset);
+    void _pack_list(PendingList& pending_list);
+    bool _is_list_requested(uint32_t from_offset, uint32_t to_offset) const;
+    void _process_list_ack(PayloadHeader* payload);
+    void _process_list_nak(const PayloadHeader& payload, ServerResult result);
+    void _continue_list();
+    void _pass_on_list_entries();
+    void _finish_list(ServerResult result);
+    void _prepare_list_retry();
     uint8_t _get_target_component_id();
 
     // prepend a root directory to each file/dir access to avoid enumerating the full FS tree
@@ -267,8 +430,14 @@ private:
 
     ServerResult _work_list(PayloadHeader* payload, bool list_hidden = false);
     ServerResult _work_open(PayloadHeader* payload, int oflag);
+    ServerResult _work_open_memory_file(PayloadHeader* payload, const FtpMemoryFiles::File& file);
+    ServerResult _work_open_xz(PayloadHeader* payload);
+    void _close_session();
     ServerResult _work_read(PayloadHeader* payload);
     ServerResult _work_burst(PayloadHeader* payload);
+    void _send_burst_chunk();
+    int _read_session_data(uint32_t offset, uint8_t* data, uint32_t max_length);
+    void _reset_read_buffer();
     ServerResult _work_write(PayloadHeader* payload);
     ServerResult _work_terminate(PayloadHeader* payload);
     ServerResult _work_reset(PayloadHeader* payload);
@@ -0,0 +1,260 @@
+#include "mavlink_ftp_pool.h"
+#include "log.h"
+#include "system_impl.h"
+
+#include <algorithm>
+
+namespace mavsdk {
+
+MavlinkFtpPool::MavlinkFtpPool(SystemImpl& system_impl) : _system_impl(system_impl) {}
+
+bool MavlinkFtpPool::set_max_sessions(unsigned max_sessions)
+{
+    if (max_sessions == 0 || max_sessions > max_clients) {
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _max_sessions = max_sessions;
+    }
+    schedule();
+    return true;
+}
+
+unsigned MavlinkFtpPool::max_sessions() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _max_sessions;
+}
+
+void MavlinkFtpPool::download_async(
+    const std::string& remote_file_path,
+    const std::string& local_folder,
+    MavlinkFtp::DownloadCallback callback)
+{
+    queue([remote_file_path, local_folder, callback](MavlinkFtp& client, const Done& done) {
+        client.download_async(
+            remote_file_path,
+            local_folder,
+            [callback, done](MavlinkFtp::ClientResult result, MavlinkFtp::ProgressData progress) {
+                if (result != MavlinkFtp::ClientResult::Next &&
+                    done(result == MavlinkFtp::ClientResult::NoSessionsAvailable)) {
+                    return;
+                }
+                callback(result, progress);
+            });
+    });
+}
+
+void MavlinkFtpPool::upload_async(
+    const std::string& local_file_path,
+    const std::string& remote_folder,
+    MavlinkFtp::UploadCallback callback)
+{
+    queue([local_file_path, remote_folder, callback](MavlinkFtp& client, const Done& done) {
+        client.upload_async(
+            local_file_path,
+            remote_folder,
+            [callback, done](MavlinkFtp::ClientResult result, MavlinkFtp::ProgressData progress) {
+                if (result != MavlinkFtp::ClientResult::Next &&
+                    done(result == MavlinkFtp::ClientResult::NoSessionsAvailable)) {
+                    return;
+                }
+                callback(result, progress);
+            });
+    });
+}
+
+void MavlinkFtpPool::list_directory_async(
+    const std::string& path, MavlinkFtp::ListDirectoryCallback callback, uint32_t offset)
+{
+    queue([path, callback, offset](MavlinkFtp& client, const Done& done) {
+        client.list_directory_async(
+            path,
+            [callback, done](MavlinkFtp::ClientResult result, std::vector<std::string> list) {
+                done(false);
+                callback(result, list);
+            },
+            offset);
+    });
+}
+
+void MavlinkFtpPool::list_directory_streaming_async(
+    const std::string& path, MavlinkFtp::ListDirectoryCallback callback)
+{
+    queue([path, callback](MavlinkFtp& client, const Done& done) {
+        client.list_directory_streaming_async(
+            path,
+            [callback, done](MavlinkFtp::ClientResult result, std::vector<std::string> list) {
+                if (result != MavlinkFtp::ClientResult::Next) {
+                    done(false);
+                }
+                callback(result, list);
+            });
+    });
+}
+
+void MavlinkFtpPool::create_directory_async(
+    const std::string& path, MavlinkFtp::ResultCallback callback)
+{
+    queue([path, callback](MavlinkFtp& client, const Done& done) {
+        client.create_directory_async(path, [callback, done](MavlinkFtp::ClientResult result) {
+            done(false);
+            callback(result);
+        });
+    });
+}
+
+void MavlinkFtpPool::are_files_identical_async(
+    const std::string& local_path,
+    const std::string& remote_path,
+    MavlinkFtp::AreFilesIdenticalCallback callback)
+{
+    queue([local_path, remote_path, callback](MavlinkFtp& client, const Done& done) {
+        client.are_files_identical_async(
+            local_path, remote_path, [callback, done](MavlinkFtp::ClientResult result, bool same) {
+                done(false);
+                callback(result, same);
+            });
+    });
+}
+
+void MavlinkFtpPool::set_retries(uint32_t retries)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _retries = retries;
+    for (auto& client : _clients) {
+        client.ftp->set_retries(retries);
+    }
+}
+
+void MavlinkFtpPool::set_target_compid(uint8_t component_id)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _target_compid = component_id;
+    for (auto& client : _clients) {
+        client.ftp->set_target_compid(component_id);
+    }
+}
+
+bool MavlinkFtpPool::set_compression_enabled(bool enabled)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    for (auto& client : _clients) {
+        if (!client.ftp->set_compression_enabled(enabled)) {
+            return false;
+        }
+    }
+    _compression_enabled = enabled;
+    return true;
+}
+
+size_t MavlinkFtpPool::memory_usage()
+{
+    // Clients are only ever added, and they take their own lock, which they
+    // may hold while calling back into us.
+    std::vector<MavlinkFtp*> clients;
+    size_t bytes = 0;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        for (auto& client : _clients) {
+            clients.push_back(client.ftp.get());
+        }
+        bytes += _queue.size() * sizeof(Operation);
+    }
+
+    for (auto* client : clients) {
+        bytes += client->memory_usage();
+    }
+    return bytes;
+}
+
+void MavlinkFtpPool::queue(Operation operation)
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _queue.push_back(std::move(operation));
+    }
+    schedule();
+}
+
+void MavlinkFtpPool::schedule()
+{
+    std::vector<std::pair<std::size_t, Operation>> to_start;
+    std::vector<MavlinkFtp*> started_clients;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        while (!_queue.empty()) {
+            std::size_t index = 0;
+            while (index < _clients.size() && index < _max_sessions && _clients[index].busy) {
+                ++index;
+            }
+            if (index >= _max_sessions) {
+                break;
+            }
+
+            if (index == _clients.size()) {
+                // Each client gets its own range of sequence numbers.
+                Client client;
+                client.ftp = std::make_unique<MavlinkFtp>(
+                    _system_impl,
+                    MavlinkFtp::Mode::ClientOnly,
+                    static_cast<uint16_t>((index + 1) * 0x2000));
+                if (_retries) {
+                    client.ftp->set_retries(_retries.value());
+                }
+                if (_target_compid) {
+                    client.ftp->set_target_compid(_target_compid.value());
+                }
+                if (_compression_enabled) {
+                    client.ftp->set_compression_enabled(true);
+                }
+                _clients.push_back(std::move(client));
+            }
+
+            _clients[index].busy = true;
+            to_start.emplace_back(index, std::move(_queue.front()));
+            started_clients.push_back(_clients[index].ftp.get());
+            _queue.pop_front();
+        }
+    }
+
+    // Outside of the lock, as clients can call back right away, e.g. if busy.
+    for (std::size_t i = 0; i < to_start.size(); ++i) {
+        const auto index = to_start[i].first;
+        const auto operation = to_start[i].second;
+        operation(*started_clients[i], [this, index, operation](bool out_of_sessions) {
+            return done(index, operation, out_of_sessions);
+        });
+    }
+}
+
+bool MavlinkFtpPool::done(std::size_t index, const Operation& operation, bool out_of_sessions)
+{
+    bool queued_again = false;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _clients[index].busy = false;
+
+        const auto num_busy = static_cast<unsigned>(std::count_if(
+            _clients.begin(), _clients.end(), [](const Client& client) { return client.busy; }));
+
+        // If nothing else of ours is running, it's someone else using the
+        // sessions and there is no point in waiting for ourselves.
+        if (out_of_sessions && num_busy > 0) {
+            LogWarn() << "FTP server has no more sessions, using " << num_busy;
+            _max_sessions = num_busy;
+            _queue.push_front(operation);
+            queued_again = true;
+        }
+    }
+
+    // Not from within the callback of the client, which might still be busy
+    // cleaning up.
+    _system_impl.call_user_callback([this]() { schedule(); });
+    return queued_again;
+}
+
+} // namespace mavsdk
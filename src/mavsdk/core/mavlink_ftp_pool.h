@@ -0,0 +1,92 @@
+#pragma once
+
+#include "mavlink_ftp.h"
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace mavsdk {
+
+class SystemImpl;
+
+// Runs FTP operations in parallel, each on its own MavlinkFtp client with its
+// own session, sequence numbers and timers. Operations are queued until a
+// client is free.
+//
+// Servers often only have a few sessions, PX4 for instance just one. If the
+// server runs out, the operation is queued again and the number of clients is
+// lowered to what the server managed, so that we don't keep asking.
+class MavlinkFtpPool {
+public:
+    explicit MavlinkFtpPool(SystemImpl& system_impl);
+    ~MavlinkFtpPool() = default;
+
+    // Non-copyable
+    MavlinkFtpPool(const MavlinkFtpPool&) = delete;
+    const MavlinkFtpPool& operator=(const MavlinkFtpPool&) = delete;
+
+    static constexpr unsigned max_clients = 7;
+
+    bool set_max_sessions(unsigned max_sessions);
+    unsigned max_sessions() const;
+
+    void download_async(
+        const std::string& remote_file_path,
+        const std::string& local_folder,
+        MavlinkFtp::DownloadCallback callback);
+    void upload_async(
+        const std::string& local_file_path,
+        const std::string& remote_folder,
+        MavlinkFtp::UploadCallback callback);
+    void list_directory_async(
+        const std::string& path, MavlinkFtp::ListDirectoryCallback callback, uint32_t offset = 0);
+    void list_directory_streaming_async(
+        const std::string& path, MavlinkFtp::ListDirectoryCallback callback);
+    void create_directory_async(const std::string& path, MavlinkFtp::ResultCallback callback);
+    void are_files_identical_async(
+        const std::string& local_path,
+        const std::string& remote_path,
+        MavlinkFtp::AreFilesIdenticalCallback callback);
+
+    void set_retries(uint32_t retries);
+    void set_target_compid(uint8_t component_id);
+    // See MavlinkFtp::set_compression_enabled().
+    bool set_compression_enabled(bool enabled);
+
+    // Bytes held by the clients and the operations queued.
+    size_t memory_usage();
+
+private:
+    // Given a client and a function to call once it is done with it. That
+    // function returns true if the operation was queued again because the
+    // server was out of sessions, in which case the result is not reported.
+    using Done = std::function<bool(bool out_of_sessions)>;
+    using Operation = std::function<void(MavlinkFtp& client, const Done& done)>;
+
+    struct Client {
+        std::unique_ptr<MavlinkFtp> ftp{};
+        bool busy{false};
+    };
+
+    void queue(Operation operation);
+    void schedule();
+    bool done(std::size_t index, const Operation& operation, bool out_of_sessions);
+
+    SystemImpl& _system_impl;
+
+    mutable std::mutex _mutex{};
+    // Needs _mutex
+    std::vector<Client> _clients{};
+    std::deque<Operation> _queue{};
+    unsigned _max_sessions{4};
+    std::optional<uint32_t> _retries{};
+    std::optional<uint8_t> _target_compid{};
+    bool _compression_enabled{false};
+};
+
+} // namespace mavsdk
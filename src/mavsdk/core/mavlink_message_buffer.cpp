@@ -0,0 +1,218 @@
+#include "mavlink_message_buffer.h"
+
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace mavsdk {
+
+struct MavlinkMessageBuffer::Slot {
+    mavlink_message_t message{};
+    int64_t receive_time_ns{0};
+    std::atomic<unsigned> ref_count{1};
+    // nullptr if not from a pool.
+    MavlinkMessagePool::State* pool_state{nullptr};
+};
+
+struct MavlinkMessagePool::State {
+    std::mutex mutex{};
+    std::vector<MavlinkMessageBuffer::Slot*> free_slots{};
+    size_t max_free_slots{0};
+    size_t slots_in_use{0};
+    bool pool_destroyed{false};
+};
+
+namespace {
+thread_local const MavlinkMessageBuffer* dispatching_buffer{nullptr};
+} // namespace
+
+MavlinkMessageBuffer::~MavlinkMessageBuffer()
+{
+    release();
+}
+
+MavlinkMessageBuffer::MavlinkMessageBuffer(const MavlinkMessageBuffer& other) : _slot(other._slot)
+{
+    if (_slot != nullptr) {
+        _slot->ref_count.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+MavlinkMessageBuffer::MavlinkMessageBuffer(MavlinkMessageBuffer&& other) noexcept :
+    _slot(std::exchange(other._slot, nullptr))
+{}
+
+MavlinkMessageBuffer& MavlinkMessageBuffer::operator=(const MavlinkMessageBuffer& other)
+{
+    if (this != &other) {
+        MavlinkMessageBuffer copy(other);
+        std::swap(_slot, copy._slot);
+    }
+    return *this;
+}
+
+MavlinkMessageBuffer& MavlinkMessageBuffer::operator=(MavlinkMessageBuffer&& other) noexcept
+{
+    if (this != &other) {
+        release();
+        _slot = std::exchange(other._slot, nullptr);
+    }
+    return *this;
+}
+
+const mavlink_message_t& MavlinkMessageBuffer::operator*() const
+{
+    return _slot->message;
+}
+
+const mavlink_message_t* MavlinkMessageBuffer::operator->() const
+{
+    return &_slot->message;
+}
+
+mavlink_message_t& MavlinkMessageBuffer::mutable_message()
+{
+    return _slot->message;
+}
+
+bool MavlinkMessageBuffer::unique() const
+{
+    return _slot != nullptr && _slot->ref_count.load(std::memory_order_acquire) == 1;
+}
+
+int64_t MavlinkMessageBuffer::receive_time_ns() const
+{
+    return _slot->receive_time_ns;
+}
+
+void MavlinkMessageBuffer::set_receive_time_ns(int64_t receive_time_ns)
+{
+    _slot->receive_time_ns = receive_time_ns;
+}
+
+void MavlinkMessageBuffer::release()
+{
+    if (_slot == nullptr) {
+        return;
+    }
+
+    if (_slot->ref_count.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        MavlinkMessagePool::release(_slot);
+    }
+    _slot = nullptr;
+}
+
+MavlinkMessageBuffer MavlinkMessageBuffer::retain(const mavlink_message_t& message)
+{
+    if (dispatching_buffer != nullptr && &**dispatching_buffer == &message) {
+        return *dispatching_buffer;
+    }
+
+    auto* slot = new Slot();
+    slot->message = message;
+    return MavlinkMessageBuffer(slot);
+}
+
+int64_t MavlinkMessageBuffer::dispatched_receive_time_ns(const mavlink_message_t& message)
+{
+    if (dispatching_buffer != nullptr && &**dispatching_buffer == &message) {
+        return dispatching_buffer->receive_time_ns();
+    }
+    return 0;
+}
+
+MavlinkMessageBuffer::DispatchScope::DispatchScope(const MavlinkMessageBuffer& buffer) :
+    _previous(dispatching_buffer)
+{
+    dispatching_buffer = &buffer;
+}
+
+MavlinkMessageBuffer::DispatchScope::~DispatchScope()
+{
+    dispatching_buffer = _previous;
+}
+
+MavlinkMessagePool::MavlinkMessagePool(size_t max_free_buffers) : _state(new State())
+{
+    _state->max_free_slots = max_free_buffers;
+}
+
+MavlinkMessagePool::~MavlinkMessagePool()
+{
+    std::vector<MavlinkMessageBuffer::Slot*> free_slots;
+    bool delete_state;
+    {
+        std::lock_guard<std::mutex> lock(_state->mutex);
+        _state->pool_destroyed = true;
+        std::swap(free_slots, _state->free_slots);
+        // Otherwise the last buffer released deletes it.
+        delete_state = (_state->slots_in_use == 0);
+    }
+
+    for (auto* slot : free_slots) {
+        delete slot;
+    }
+
+    if (delete_state) {
+        delete _state;
+    }
+}
+
+size_t MavlinkMessagePool::memory_usage() const
+{
+    std::lock_guard<std::mutex> lock(_state->mutex);
+    return (_state->slots_in_use + _state->free_slots.size()) * sizeof(MavlinkMessageBuffer::Slot) +
+           _state->free_slots.capacity() * sizeof(MavlinkMessageBuffer::Slot*);
+}
+
+MavlinkMessageBuffer MavlinkMessagePool::acquire()
+{
+    MavlinkMessageBuffer::Slot* slot = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(_state->mutex);
+        ++_state->slots_in_use;
+        if (!_state->free_slots.empty()) {
+            slot = _state->free_slots.back();
+            _state->free_slots.pop_back();
+        }
+    }
+
+    if (slot == nullptr) {
+        slot = new MavlinkMessageBuffer::Slot();
+        slot->pool_state = _state;
+    } else {
+        slot->ref_count.store(1, std::memory_order_relaxed);
+        slot->receive_time_ns = 0;
+    }
+
+    return MavlinkMessageBuffer(slot);
+}
+
+void MavlinkMessagePool::release(MavlinkMessageBuffer::Slot* slot)
+{
+    State* state = slot->pool_state;
+    if (state == nullptr) {
+        delete slot;
+        return;
+    }
+
+    bool delete_state = false;
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        --state->slots_in_use;
+        if (!state->pool_destroyed && state->free_slots.size() < state->max_free_slots) {
+            state->free_slots.push_back(slot);
+            slot = nullptr;
+        } else {
+            delete_state = state->pool_destroyed && state->slots_in_use == 0;
+        }
+    }
+
+    delete slot;
+
+    if (delete_state) {
+        delete state;
+    }
+}
+
+} // namespace mavsdk
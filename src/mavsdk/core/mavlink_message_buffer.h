@@ -0,0 +1,102 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include "mavlink_include.h"
+
+namespace mavsdk {
+
+class MavlinkMessagePool;
+
+// A reference-counted handle to a received message. Copying the handle shares
+// the message instead of copying its ~290 bytes, and once the last handle is
+// gone, the buffer goes back to the pool it came from.
+//
+// The message must not be changed while it is shared.
+class MavlinkMessageBuffer {
+public:
+    MavlinkMessageBuffer() = default;
+    ~MavlinkMessageBuffer();
+
+    MavlinkMessageBuffer(const MavlinkMessageBuffer& other);
+    MavlinkMessageBuffer(MavlinkMessageBuffer&& other) noexcept;
+    MavlinkMessageBuffer& operator=(const MavlinkMessageBuffer& other);
+    MavlinkMessageBuffer& operator=(MavlinkMessageBuffer&& other) noexcept;
+
+    explicit operator bool() const { return _slot != nullptr; }
+
+    const mavlink_message_t& operator*() const;
+    const mavlink_message_t* operator->() const;
+
+    // Only to be used for filling in the message while nobody else has it.
+    mavlink_message_t& mutable_message();
+
+    [[nodiscard]] bool unique() const;
+
+    // When the message was received, in ns since the epoch, ideally as
+    // stamped by the kernel. 0 if unknown.
+    int64_t receive_time_ns() const;
+    void set_receive_time_ns(int64_t receive_time_ns);
+
+    // The receive time of the message if it is the one currently being
+    // dispatched on this thread (see DispatchScope), otherwise 0.
+    static int64_t dispatched_receive_time_ns(const mavlink_message_t& message);
+
+    // Returns a buffer sharing the message if it is the one currently being
+    // dispatched on this thread (see DispatchScope), otherwise a copy of it.
+    // This is what handlers should use to keep a message for later.
+    static MavlinkMessageBuffer retain(const mavlink_message_t& message);
+
+    // Marks the buffer as being dispatched on this thread for its lifetime.
+    class DispatchScope {
+    public:
+        explicit DispatchScope(const MavlinkMessageBuffer& buffer);
+        ~DispatchScope();
+
+        DispatchScope(const DispatchScope&) = delete;
+        DispatchScope& operator=(const DispatchScope&) = delete;
+
+    private:
+        const MavlinkMessageBuffer* _previous;
+    };
+
+private:
+    friend class MavlinkMessagePool;
+    struct Slot;
+
+    explicit MavlinkMessageBuffer(Slot* slot) : _slot(slot) {}
+    void release();
+
+    Slot* _slot{nullptr};
+};
+
+// Keeps released buffers around to reuse them, so receiving doesn't need to
+// allocate. The pool can be destroyed while buffers are still in use, they
+// are then freed once released.
+class MavlinkMessagePool {
+public:
+    explicit MavlinkMessagePool(size_t max_free_buffers = 64);
+    ~MavlinkMessagePool();
+
+    // delete copy and move constructors and assign operators
+    MavlinkMessagePool(MavlinkMessagePool const&) = delete; // Copy construct
+    MavlinkMessagePool(MavlinkMessagePool&&) = delete; // Move construct
+    MavlinkMessagePool& operator=(MavlinkMessagePool const&) = delete; // Copy assign
+    MavlinkMessagePool& operator=(MavlinkMessagePool&&) = delete; // Move assign
+
+    MavlinkMessageBuffer acquire();
+
+    // Bytes of the buffers in use and kept for reuse.
+    size_t memory_usage() const;
+
+private:
+    friend class MavlinkMessageBuffer;
+    struct State;
+
+    static void release(MavlinkMessageBuffer::Slot* slot);
+
+    State* _state;
+};
+
+} // namespace mavsdk
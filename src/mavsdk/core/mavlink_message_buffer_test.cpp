@@ -0,0 +1,98 @@
+#include "mavlink_message_buffer.h"
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+using namespace mavsdk;
+
+TEST(MavlinkMessageBuffer, SharesMessage)
+{
+    MavlinkMessagePool pool;
+
+    auto buffer = pool.acquire();
+    ASSERT_TRUE(buffer);
+    EXPECT_TRUE(buffer.unique());
+    buffer.mutable_message().sysid = 42;
+
+    auto copy = buffer;
+    EXPECT_FALSE(buffer.unique());
+    EXPECT_EQ(&*copy, &*buffer);
+    EXPECT_EQ(copy->sysid, 42);
+
+    copy = MavlinkMessageBuffer{};
+    EXPECT_TRUE(buffer.unique());
+}
+
+TEST(MavlinkMessageBuffer, ReusesReleasedBuffers)
+{
+    MavlinkMessagePool pool;
+
+    const mavlink_message_t* first_message = nullptr;
+    {
+        auto buffer = pool.acquire();
+        first_message = &*buffer;
+    }
+
+    auto buffer = pool.acquire();
+    EXPECT_EQ(&*buffer, first_message);
+    EXPECT_TRUE(buffer.unique());
+}
+
+TEST(MavlinkMessageBuffer, OutlivesPool)
+{
+    MavlinkMessageBuffer buffer;
+    {
+        MavlinkMessagePool pool;
+        auto unused = pool.acquire();
+        buffer = pool.acquire();
+        buffer.mutable_message().msgid = 1;
+    }
+
+    EXPECT_EQ(buffer->msgid, 1u);
+}
+
+TEST(MavlinkMessageBuffer, RetainSharesDispatchedMessage)
+{
+    MavlinkMessagePool pool;
+    auto buffer = pool.acquire();
+
+    MavlinkMessageBuffer retained;
+    {
+        MavlinkMessageBuffer::DispatchScope dispatch_scope(buffer);
+        retained = MavlinkMessageBuffer::retain(*buffer);
+    }
+
+    EXPECT_EQ(&*retained, &*buffer);
+    EXPECT_FALSE(buffer.unique());
+}
+
+TEST(MavlinkMessageBuffer, RetainCopiesOtherMessages)
+{
+    mavlink_message_t message{};
+    message.compid = 7;
+
+    auto retained = MavlinkMessageBuffer::retain(message);
+    EXPECT_NE(&*retained, &message);
+    EXPECT_EQ(retained->compid, 7);
+    EXPECT_TRUE(retained.unique());
+}
+
+TEST(MavlinkMessageBuffer, ReleasesFromOtherThreads)
+{
+    MavlinkMessagePool pool;
+
+    std::vector<std::thread> threads;
+    for (unsigned i = 0; i < 4; ++i) {
+        std::vector<MavlinkMessageBuffer> buffers;
+        for (unsigned j = 0; j < 100; ++j) {
+            buffers.push_back(pool.acquire());
+        }
+        threads.emplace_back([buffers = std::move(buffers)]() mutable { buffers.clear(); });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_TRUE(pool.acquire().unique());
+}
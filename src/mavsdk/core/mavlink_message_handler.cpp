@@ -1,15 +1,76 @@
+#include <algorithm>
 #include <mutex>
 #include "mavlink_message_handler.h"
+#include "decoded_message.h"
+#include "trace.h"
 
 namespace mavsdk {
 
+namespace {
+
+// The dispatches running on this thread, innermost first, so that
+// unregistering can tell whether it was called from one of its own.
+struct DispatchScope {
+    const MavlinkMessageHandler* handler;
+    const DispatchScope* outer;
+};
+
+thread_local const DispatchScope* innermost_dispatch{nullptr};
+
+} // namespace
+
+MavlinkMessageHandler::~MavlinkMessageHandler()
+{
+    for (auto& page : _pages) {
+        delete page.load();
+    }
+}
+
+std::shared_ptr<const MavlinkMessageHandler::Entries>
+MavlinkMessageHandler::entries_for(uint16_t msg_id) const
+{
+    const Page* page = _pages[msg_id / num_slots_per_page].load(std::memory_order_acquire);
+    if (page == nullptr) {
+        return nullptr;
+    }
+    return std::atomic_load_explicit(
+        &page->slots[msg_id % num_slots_per_page], std::memory_order_acquire);
+}
+
+std::shared_ptr<MavlinkMessageHandler::Entries>
+MavlinkMessageHandler::new_entries(const Entries* old_entries)
+{
+    if (old_entries != nullptr) {
+        return std::allocate_shared<Entries>(_memory_resource.allocator(), *old_entries);
+    }
+    return std::allocate_shared<Entries>(_memory_resource.allocator());
+}
+
+void MavlinkMessageHandler::set_entries(uint16_t msg_id, std::shared_ptr<const Entries> entries)
+{
+    // Needs _mutex
+
+    auto& page_ptr = _pages[msg_id / num_slots_per_page];
+    Page* page = page_ptr.load(std::memory_order_relaxed);
+    if (page == nullptr) {
+        // Pages are only ever added and stay until destruction, so lookups
+        // never need to worry about them going away.
+        page = new Page();
+        page_ptr.store(page, std::memory_order_release);
+    }
+
+    if (entries != nullptr && entries->empty()) {
+        entries = nullptr;
+    }
+
+    std::atomic_store_explicit(
+        &page->slots[msg_id % num_slots_per_page], std::move(entries), std::memory_order_release);
+}
+
 void MavlinkMessageHandler::register_one(
     uint16_t msg_id, const Callback& callback, const void* cookie)
 {
-    std::lock_guard<std::mutex> lock(_mutex);
-
-    Entry entry = {msg_id, {}, callback, cookie};
-    _table.push_back(entry);
+    register_one(msg_id, {}, callback, cookie);
 }
 
 void MavlinkMessageHandler::register_one(
@@ -20,54 +81,143 @@ void MavlinkMessageHandler::register_one(
 {
     std::lock_guard<std::mutex> lock(_mutex);
 
-    Entry entry = {msg_id, component_id, callback, cookie};
-    _table.push_back(entry);
+    auto entries = new_entries(entries_for(msg_id).get());
+    entries->push_back(Entry{msg_id, component_id, callback, cookie});
+    set_entries(msg_id, std::move(entries));
 }
 
 void MavlinkMessageHandler::unregister_one(uint16_t msg_id, const void* cookie)
 {
-    std::lock_guard<std::mutex> lock(_mutex);
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
 
-    for (auto it = _table.begin(); it != _table.end();
-         /* no ++it */) {
-        if (it->msg_id == msg_id && it->cookie == cookie) {
-            it = _table.erase(it);
-        } else {
-            ++it;
+        auto old_entries = entries_for(msg_id);
+        if (old_entries == nullptr) {
+            return;
         }
+
+        auto entries = new_entries();
+        std::copy_if(
+            old_entries->begin(),
+            old_entries->end(),
+            std::back_inserter(*entries),
+            [&](const Entry& entry) { return entry.cookie != cookie; });
+
+        if (entries->size() == old_entries->size()) {
+            return;
+        }
+        set_entries(msg_id, std::move(entries));
     }
+
+    wait_for_dispatches();
 }
 
 void MavlinkMessageHandler::unregister_all(const void* cookie)
 {
-    std::lock_guard<std::mutex> lock(_mutex);
+    std::unique_lock<std::mutex> lock(_mutex);
+
+    bool changed = false;
+    for (unsigned page_index = 0; page_index < num_pages; ++page_index) {
+        if (_pages[page_index].load(std::memory_order_relaxed) == nullptr) {
+            continue;
+        }
+
+        for (unsigned slot_index = 0; slot_index < num_slots_per_page; ++slot_index) {
+            const auto msg_id = static_cast<uint16_t>(page_index * num_slots_per_page + slot_index);
+
+            auto old_entries = entries_for(msg_id);
+            if (old_entries == nullptr) {
+                continue;
+            }
+
+            if (std::none_of(old_entries->begin(), old_entries->end(), [&](const Entry& entry) {
+                    return entry.cookie == cookie;
+                })) {
+                continue;
+            }
+
+            auto entries = new_entries();
+            std::copy_if(
+                old_entries->begin(),
+                old_entries->end(),
+                std::back_inserter(*entries),
+                [&](const Entry& entry) { return entry.cookie != cookie; });
+            set_entries(msg_id, std::move(entries));
+            changed = true;
+        }
+    }
+
+    lock.unlock();
+    if (changed) {
+        wait_for_dispatches();
+    }
+}
 
-    for (auto it = _table.begin(); it != _table.end();
-         /* no ++it */) {
-        if (it->cookie == cookie) {
-            it = _table.erase(it);
-        } else {
-            ++it;
+void MavlinkMessageHandler::wait_for_dispatches()
+{
+    for (auto* scope = innermost_dispatch; scope != nullptr; scope = scope->outer) {
+        if (scope->handler == this) {
+            // Called from one of our handlers, which we would wait for forever.
+            return;
         }
     }
+
+    // Orders the lists just set before the counters read below, matching the
+    // fence in process_message(). A dispatch we don't see counted here
+    // therefore gets the new lists.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    // Both counters are drained, as a dispatch which read the epoch just
+    // before it changed still counts itself in the previous one. Moving on
+    // first means new dispatches go to the other counter, so this ends.
+    std::lock_guard<std::mutex> lock(_wait_mutex);
+    _waiting.store(true);
+    for (unsigned i = 0; i < _dispatches.size(); ++i) {
+        const auto previous_epoch = _epoch.fetch_add(1);
+        const auto& dispatches = _dispatches[previous_epoch % _dispatches.size()];
+        std::unique_lock<std::mutex> drained_lock(_drained_mutex);
+        _drained_cv.wait(drained_lock, [&]() { return dispatches.load() == 0; });
+    }
+    _waiting.store(false);
 }
 
 void MavlinkMessageHandler::process_message(const mavlink_message_t& message)
 {
-    std::lock_guard<std::mutex> lock(_mutex);
+    // We only support registering 16 bit message IDs.
+    if (message.msgid > UINT16_MAX) {
+        return;
+    }
+
+    // Counted before the list is picked up, so unregistering can wait for us.
+    auto& dispatches = _dispatches[_epoch.load() % _dispatches.size()];
+    dispatches.fetch_add(1);
+    const DispatchScope scope{this, innermost_dispatch};
+    innermost_dispatch = &scope;
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    // We hold on to the list we got, so it stays valid even if handlers
+    // are changed while we call them.
+    const auto entries = entries_for(static_cast<uint16_t>(message.msgid));
+
+    TraceScope trace("handler", "dispatch", message.msgid);
+
+    if (entries != nullptr) {
+        DecodedMessage::next_dispatch();
+    }
 
 #if MESSAGE_DEBUGGING == 1
     bool forwarded = false;
 #endif
-    for (auto& entry : _table) {
-        if (entry.msg_id == message.msgid &&
-            (!entry.cmp_id.has_value() || entry.cmp_id == message.compid)) {
+    if (entries != nullptr) {
+        for (const auto& entry : *entries) {
+            if (!entry.cmp_id.has_value() || entry.cmp_id == message.compid) {
 #if MESSAGE_DEBUGGING == 1
-            LogDebug() << "Forwarding msg " << int(message.msgid) << " to "
-                       << size_t(entry->cookie);
-            forwarded = true;
+                LogDebug() << "Forwarding msg " << int(message.msgid) << " to "
+                           << size_t(entry.cookie);
+                forwarded = true;
 #endif
-            entry.callback(message);
+                entry.callback(message);
+            }
         }
     }
 
@@ -76,6 +226,17 @@ void MavlinkMessageHandler::process_message(const mavlink_message_t& message)
         LogDebug() << "Ignoring msg " << int(message.msgid);
     }
 #endif
+
+    innermost_dispatch = scope.outer;
+    // The last dispatch of an epoch wakes up unregistering, if it waits. As
+    // both _waiting and the counter are sequentially consistent, either it
+    // sees us waiting, or the wait sees the counter drained.
+    if (dispatches.fetch_sub(1) == 1 && _waiting.load()) {
+        {
+            std::lock_guard<std::mutex> lock(_drained_mutex);
+        }
+        _drained_cv.notify_all();
+    }
 }
 
 void MavlinkMessageHandler::update_component_id(
@@ -83,11 +244,23 @@ void MavlinkMessageHandler::update_component_id(
 {
     std::lock_guard<std::mutex> lock(_mutex);
 
-    for (auto& entry : _table) {
-        if (entry.msg_id == msg_id && entry.cookie == cookie) {
+    auto old_entries = entries_for(msg_id);
+    if (old_entries == nullptr) {
+        return;
+    }
+
+    auto entries = new_entries(old_entries.get());
+    for (auto& entry : *entries) {
+        if (entry.cookie == cookie) {
             entry.cmp_id = component_id;
         }
     }
+    set_entries(msg_id, std::move(entries));
+}
+
+void MavlinkMessageHandler::set_allocator(const ForwardingMemoryResource::Allocator& allocator)
+{
+    _memory_resource.set_allocator(allocator);
 }
 
 } // namespace mavsdk
@@ -1,14 +1,29 @@
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <condition_variable>
 #include <cstdint>
 #include <functional>
+#include <memory>
 #include <mutex>
 #include <vector>
 #include <optional>
+#include "forwarding_memory_resource.h"
 #include "mavlink_include.h"
 
 namespace mavsdk {
 
+// Handlers are looked up by message ID in a two-level table. Each slot holds
+// an immutable list of handlers which is replaced (copy-on-write) whenever
+// handlers are registered or unregistered. This way the receive path never has
+// to take the mutex and registering never waits for a dispatch to finish.
+//
+// Unregistering waits for dispatches still running with the old list, so a
+// handler is never called once unregister has returned and its owner can be
+// destroyed. The exception is unregistering from within a handler of the
+// same instance, which doesn't wait, as the dispatch it runs in could never
+// finish.
 class MavlinkMessageHandler {
 public:
     using Callback = std::function<void(const mavlink_message_t&)>;
@@ -20,6 +35,12 @@ public:
         const void* cookie; // This is the identification to unregister.
     };
 
+    MavlinkMessageHandler() = default;
+    ~MavlinkMessageHandler();
+
+    MavlinkMessageHandler(const MavlinkMessageHandler&) = delete;
+    MavlinkMessageHandler& operator=(const MavlinkMessageHandler&) = delete;
+
     void register_one(uint16_t msg_id, const Callback& callback, const void* cookie);
     void register_one(
         uint16_t msg_id,
@@ -31,9 +52,41 @@ public:
     void process_message(const mavlink_message_t& message);
     void update_component_id(uint16_t msg_id, uint8_t cmp_id, const void* cookie);
 
+    // The lists of handlers are allocated with it from now on.
+    void set_allocator(const ForwardingMemoryResource::Allocator& allocator);
+
 private:
+    using Entries = ResourceVector<Entry>;
+
+    static constexpr unsigned num_slots_per_page = 256;
+    static constexpr unsigned num_pages = 256;
+
+    struct Page {
+        std::array<std::shared_ptr<const Entries>, num_slots_per_page> slots{};
+    };
+
+    std::shared_ptr<const Entries> entries_for(uint16_t msg_id) const;
+    std::shared_ptr<Entries> new_entries(const Entries* old_entries = nullptr);
+    void set_entries(uint16_t msg_id, std::shared_ptr<const Entries> entries);
+    void wait_for_dispatches();
+
+    // Only used to serialize changes to the table, not for lookups.
     std::mutex _mutex{};
-    std::vector<Entry> _table{};
+    // Has to outlive the pages.
+    ForwardingMemoryResource _memory_resource{};
+    std::array<std::atomic<Page*>, num_pages> _pages{};
+
+    // Dispatches count themselves in the counter of the epoch they started
+    // in. Unregistering moves on to the next epoch and waits for the counter
+    // of the previous one to drain, see wait_for_dispatches().
+    std::atomic<uint64_t> _epoch{0};
+    std::array<std::atomic<unsigned>, 2> _dispatches{};
+    // Serializes the waiting, so that an epoch is only reused once drained.
+    std::mutex _wait_mutex{};
+    // Signaled by the last dispatch of an epoch while _waiting is set.
+    std::atomic<bool> _waiting{false};
+    std::mutex _drained_mutex{};
+    std::condition_variable _drained_cv{};
 };
 
 } // namespace mavsdk
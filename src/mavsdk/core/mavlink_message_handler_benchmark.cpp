@@ -0,0 +1,33 @@
+#include "mavlink_message_handler.h"
+#include <benchmark/benchmark.h>
+
+using namespace mavsdk;
+
+static void BM_MavlinkMessageHandlerProcessMessage(benchmark::State& state)
+{
+    MavlinkMessageHandler handler;
+
+    // Handlers for other messages, as there would be with many plugins.
+    const int cookie = 0;
+    for (uint16_t msg_id = 0; msg_id < 200; ++msg_id) {
+        handler.register_one(msg_id, [](const mavlink_message_t&) {}, &cookie);
+    }
+
+    unsigned num_called = 0;
+    const auto num_handlers = static_cast<unsigned>(state.range(0));
+    for (unsigned i = 0; i < num_handlers; ++i) {
+        handler.register_one(
+            MAVLINK_MSG_ID_ATTITUDE, [&](const mavlink_message_t&) { ++num_called; }, &cookie);
+    }
+
+    mavlink_message_t message{};
+    message.msgid = MAVLINK_MSG_ID_ATTITUDE;
+
+    for (auto _ : state) {
+        handler.process_message(message);
+    }
+    benchmark::DoNotOptimize(num_called);
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_MavlinkMessageHandlerProcessMessage)->Arg(1)->Arg(4);
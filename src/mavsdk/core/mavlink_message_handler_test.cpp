@@ -0,0 +1,244 @@
+#include "mavlink_message_handler.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <new>
+#include <thread>
+
+using namespace mavsdk;
+
+static mavlink_message_t make_message(uint32_t msg_id, uint8_t component_id)
+{
+    mavlink_message_t message{};
+    message.msgid = msg_id;
+    message.compid = component_id;
+    return message;
+}
+
+TEST(MavlinkMessageHandler, DispatchesByMessageId)
+{
+    MavlinkMessageHandler handler;
+
+    int heartbeats = 0;
+    int statustexts = 0;
+    int cookie;
+
+    handler.register_one(
+        MAVLINK_MSG_ID_HEARTBEAT, [&](const mavlink_message_t&) { ++heartbeats; }, &cookie);
+    handler.register_one(
+        MAVLINK_MSG_ID_STATUSTEXT, [&](const mavlink_message_t&) { ++statustexts; }, &cookie);
+
+    handler.process_message(make_message(MAVLINK_MSG_ID_HEARTBEAT, 1));
+    EXPECT_EQ(heartbeats, 1);
+    EXPECT_EQ(statustexts, 0);
+
+    handler.process_message(make_message(MAVLINK_MSG_ID_STATUSTEXT, 1));
+    EXPECT_EQ(heartbeats, 1);
+    EXPECT_EQ(statustexts, 1);
+
+    // Not registered at all.
+    handler.process_message(make_message(MAVLINK_MSG_ID_ATTITUDE, 1));
+}
+
+TEST(MavlinkMessageHandler, FiltersByComponentId)
+{
+    MavlinkMessageHandler handler;
+
+    int any = 0;
+    int camera = 0;
+    int cookie1;
+    int cookie2;
+
+    handler.register_one(
+        MAVLINK_MSG_ID_HEARTBEAT, [&](const mavlink_message_t&) { ++any; }, &cookie1);
+    handler.register_one(
+        MAVLINK_MSG_ID_HEARTBEAT,
+        MAV_COMP_ID_CAMERA,
+        [&](const mavlink_message_t&) { ++camera; },
+        &cookie2);
+
+    handler.process_message(make_message(MAVLINK_MSG_ID_HEARTBEAT, MAV_COMP_ID_AUTOPILOT1));
+    EXPECT_EQ(any, 1);
+    EXPECT_EQ(camera, 0);
+
+    handler.process_message(make_message(MAVLINK_MSG_ID_HEARTBEAT, MAV_COMP_ID_CAMERA));
+    EXPECT_EQ(any, 2);
+    EXPECT_EQ(camera, 1);
+
+    handler.update_component_id(MAVLINK_MSG_ID_HEARTBEAT, MAV_COMP_ID_AUTOPILOT1, &cookie2);
+    handler.process_message(make_message(MAVLINK_MSG_ID_HEARTBEAT, MAV_COMP_ID_AUTOPILOT1));
+    EXPECT_EQ(any, 3);
+    EXPECT_EQ(camera, 2);
+}
+
+TEST(MavlinkMessageHandler, Unregister)
+{
+    MavlinkMessageHandler handler;
+
+    int first = 0;
+    int second = 0;
+    int cookie1;
+    int cookie2;
+
+    handler.register_one(
+        MAVLINK_MSG_ID_HEARTBEAT, [&](const mavlink_message_t&) { ++first; }, &cookie1);
+    handler.register_one(
+        MAVLINK_MSG_ID_ATTITUDE, [&](const mavlink_message_t&) { ++first; }, &cookie1);
+    handler.register_one(
+        MAVLINK_MSG_ID_HEARTBEAT, [&](const mavlink_message_t&) { ++second; }, &cookie2);
+
+    handler.unregister_one(MAVLINK_MSG_ID_HEARTBEAT, &cookie1);
+    handler.process_message(make_message(MAVLINK_MSG_ID_HEARTBEAT, 1));
+    handler.process_message(make_message(MAVLINK_MSG_ID_ATTITUDE, 1));
+    EXPECT_EQ(first, 1);
+    EXPECT_EQ(second, 1);
+
+    handler.unregister_all(&cookie1);
+    handler.process_message(make_message(MAVLINK_MSG_ID_ATTITUDE, 1));
+    EXPECT_EQ(first, 1);
+
+    handler.unregister_all(&cookie2);
+    handler.process_message(make_message(MAVLINK_MSG_ID_HEARTBEAT, 1));
+    EXPECT_EQ(second, 1);
+}
+
+TEST(MavlinkMessageHandler, UnregisterDuringCallback)
+{
+    MavlinkMessageHandler handler;
+
+    int called = 0;
+    int cookie;
+
+    handler.register_one(
+        MAVLINK_MSG_ID_HEARTBEAT,
+        [&](const mavlink_message_t&) {
+            ++called;
+            // This used to deadlock, now the running dispatch keeps going with
+            // the list it has already picked up.
+            handler.unregister_all(&cookie);
+        },
+        &cookie);
+
+    handler.process_message(make_message(MAVLINK_MSG_ID_HEARTBEAT, 1));
+    handler.process_message(make_message(MAVLINK_MSG_ID_HEARTBEAT, 1));
+    EXPECT_EQ(called, 1);
+}
+
+TEST(MavlinkMessageHandler, UnregisterWaitsForRunningHandler)
+{
+    MavlinkMessageHandler handler;
+
+    std::promise<void> entered;
+    std::promise<void> release;
+    auto release_future = release.get_future();
+    int cookie;
+
+    handler.register_one(
+        MAVLINK_MSG_ID_HEARTBEAT,
+        [&](const mavlink_message_t&) {
+            entered.set_value();
+            release_future.wait();
+        },
+        &cookie);
+
+    std::thread dispatch(
+        [&]() { handler.process_message(make_message(MAVLINK_MSG_ID_HEARTBEAT, 1)); });
+    entered.get_future().wait();
+
+    std::atomic<bool> unregistered{false};
+    std::thread unregister([&]() {
+        handler.unregister_all(&cookie);
+        unregistered = true;
+    });
+
+    // The owner of the handler could be destroyed once unregister returns.
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_FALSE(unregistered);
+
+    release.set_value();
+    unregister.join();
+    dispatch.join();
+    EXPECT_TRUE(unregistered);
+}
+
+TEST(MavlinkMessageHandler, UnregisterFromOtherHandlerWaitsForRunningHandler)
+{
+    MavlinkMessageHandler handler;
+    MavlinkMessageHandler other_handler;
+
+    std::promise<void> entered;
+    std::promise<void> release;
+    auto release_future = release.get_future();
+    int cookie;
+    int other_cookie;
+
+    handler.register_one(
+        MAVLINK_MSG_ID_HEARTBEAT,
+        [&](const mavlink_message_t&) {
+            entered.set_value();
+            release_future.wait();
+        },
+        &cookie);
+
+    std::atomic<bool> unregistered{false};
+    other_handler.register_one(
+        MAVLINK_MSG_ID_HEARTBEAT,
+        [&](const mavlink_message_t&) {
+            // Only a dispatch of the same instance skips the waiting.
+            handler.unregister_all(&cookie);
+            unregistered = true;
+        },
+        &other_cookie);
+
+    std::thread dispatch(
+        [&]() { handler.process_message(make_message(MAVLINK_MSG_ID_HEARTBEAT, 1)); });
+    entered.get_future().wait();
+
+    std::thread other_dispatch(
+        [&]() { other_handler.process_message(make_message(MAVLINK_MSG_ID_HEARTBEAT, 1)); });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_FALSE(unregistered);
+
+    release.set_value();
+    other_dispatch.join();
+    dispatch.join();
+    EXPECT_TRUE(unregistered);
+}
+
+TEST(MavlinkMessageHandler, AllocatesListsWithAllocatorSet)
+{
+    if (!ForwardingMemoryResource::supported()) {
+        GTEST_SKIP() << "No std::pmr";
+    }
+
+    int allocations = 0;
+    int deallocations = 0;
+
+    {
+        MavlinkMessageHandler handler;
+        handler.set_allocator(
+            {[&](std::size_t bytes, std::size_t alignment) {
+                 ++allocations;
+                 return ::operator new(bytes, std::align_val_t(alignment));
+             },
+             [&](void* pointer, std::size_t, std::size_t alignment) {
+                 ++deallocations;
+                 ::operator delete(pointer, std::align_val_t(alignment));
+             }});
+
+        int called = 0;
+        int cookie;
+        handler.register_one(
+            MAVLINK_MSG_ID_HEARTBEAT, [&](const mavlink_message_t&) { ++called; }, &cookie);
+        EXPECT_GT(allocations, 0);
+
+        handler.process_message(make_message(MAVLINK_MSG_ID_HEARTBEAT, 1));
+        EXPECT_EQ(called, 1);
+
+        handler.unregister_all(&cookie);
+    }
+
+    EXPECT_EQ(allocations, deallocations);
+}
@@ -0,0 +1,77 @@
+#include "mavlink_include.h"
+#include "mavlink_message_subset_ids.h"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <iterator>
+
+// With MAVLINK_MESSAGE_SUBSET, this lookup replaces the one of the MAVLink
+// helpers, which is used by the parser for every message received. Only the
+// messages used by core and the enabled plugins are in the table, which are
+// picked out of the full one of the dialect at compile time, so that the
+// table of all messages doesn't end up in the binary.
+//
+// Messages not in the table fail the CRC check, as for any unknown message,
+// so they can't be received, nor forwarded.
+
+namespace {
+
+constexpr mavlink_msg_entry_t all_entries[] = MAVLINK_MESSAGE_CRCS;
+constexpr uint32_t subset_ids[] = {MAVLINK_MESSAGE_SUBSET_IDS};
+
+constexpr bool is_in_subset(uint32_t msgid)
+{
+    for (const auto id : subset_ids) {
+        if (id == msgid) {
+            return true;
+        }
+    }
+    return false;
+}
+
+constexpr size_t subset_size()
+{
+    size_t size = 0;
+    for (const auto& entry : all_entries) {
+        if (is_in_subset(entry.msgid)) {
+            ++size;
+        }
+    }
+    return size;
+}
+
+// The full table is sorted by msgid, so the subset is as well.
+constexpr std::array<mavlink_msg_entry_t, subset_size()> make_subset()
+{
+    std::array<mavlink_msg_entry_t, subset_size()> entries{};
+    size_t i = 0;
+    for (const auto& entry : all_entries) {
+        if (is_in_subset(entry.msgid)) {
+            entries[i++] = entry;
+        }
+    }
+    return entries;
+}
+
+constexpr auto subset_entries = make_subset();
+
+static_assert(
+    subset_entries.size() == std::size(subset_ids),
+    "Message IDs used which are not in the dialect");
+
+} // namespace
+
+const mavlink_msg_entry_t* mavlink_get_msg_entry(uint32_t msgid)
+{
+    const auto it = std::lower_bound(
+        subset_entries.begin(),
+        subset_entries.end(),
+        msgid,
+        [](const mavlink_msg_entry_t& entry, uint32_t id) { return entry.msgid < id; });
+
+    if (it == subset_entries.end() || it->msgid != msgid) {
+        return nullptr;
+    }
+    return &*it;
+}
@@ -0,0 +1,19 @@
+#include "mavlink_include.h"
+#include <gtest/gtest.h>
+
+TEST(MavlinkMessageSubset, KnowsMessagesUsed)
+{
+    const auto* heartbeat = mavlink_get_msg_entry(MAVLINK_MSG_ID_HEARTBEAT);
+    ASSERT_NE(heartbeat, nullptr);
+    EXPECT_EQ(heartbeat->msgid, MAVLINK_MSG_ID_HEARTBEAT);
+    EXPECT_EQ(heartbeat->crc_extra, MAVLINK_MSG_ID_HEARTBEAT_CRC);
+
+    const auto* command_long = mavlink_get_msg_entry(MAVLINK_MSG_ID_COMMAND_LONG);
+    ASSERT_NE(command_long, nullptr);
+    EXPECT_EQ(command_long->crc_extra, MAVLINK_MSG_ID_COMMAND_LONG_CRC);
+}
+
+TEST(MavlinkMessageSubset, DoesNotKnowUnknownMessages)
+{
+    EXPECT_EQ(mavlink_get_msg_entry(0xffffff), nullptr);
+}
@@ -0,0 +1,75 @@
+#include "mavlink_message_template.h"
+
+#include <algorithm>
+#include <cstring>
+#include "log.h"
+
+namespace mavsdk {
+
+MavlinkMessageTemplate::MavlinkMessageTemplate(uint32_t msg_id) : _msg_id(msg_id)
+{
+    const mavlink_msg_entry_t* entry = mavlink_get_msg_entry(msg_id);
+    if (entry == nullptr) {
+        // Receivers drop what we pack as the checksum is off.
+        LogErr() << "Unknown message " << msg_id << " to pack";
+        return;
+    }
+
+    _max_len = entry->max_msg_len;
+    _crc_extra = entry->crc_extra;
+}
+
+void MavlinkMessageTemplate::pack_payload(
+    uint8_t system_id,
+    uint8_t component_id,
+    const void* payload,
+    size_t payload_len,
+    mavlink_message_t& message) const
+{
+    auto* out = reinterpret_cast<uint8_t*>(_MAV_PAYLOAD_NON_CONST(&message));
+    const size_t len = std::min(payload_len, static_cast<size_t>(_max_len));
+    memcpy(out, payload, len);
+    if (len < _max_len) {
+        memset(&out[len], 0, _max_len - len);
+    }
+
+    // Trailing zeros are left out, as in MAVLink 2 packing.
+    uint8_t trimmed_len = _max_len;
+    while (trimmed_len > 1 && out[trimmed_len - 1] == 0) {
+        --trimmed_len;
+    }
+
+    mavlink_status_t* status = mavlink_get_channel_status(MAVLINK_COMM_0);
+
+    message.magic = MAVLINK_STX;
+    message.len = trimmed_len;
+    message.incompat_flags = 0;
+    message.compat_flags = 0;
+    message.seq = status->current_tx_seq++;
+    message.sysid = system_id;
+    message.compid = component_id;
+    message.msgid = _msg_id;
+
+    const uint8_t header[MAVLINK_CORE_HEADER_LEN] = {
+        message.len,
+        message.incompat_flags,
+        message.compat_flags,
+        message.seq,
+        message.sysid,
+        message.compid,
+        static_cast<uint8_t>(_msg_id & 0xFF),
+        static_cast<uint8_t>((_msg_id >> 8) & 0xFF),
+        static_cast<uint8_t>((_msg_id >> 16) & 0xFF)};
+
+    uint16_t checksum = crc_calculate(header, MAVLINK_CORE_HEADER_LEN);
+    crc_accumulate_buffer(&checksum, reinterpret_cast<const char*>(out), message.len);
+    crc_accumulate(_crc_extra, &checksum);
+
+    message.checksum = checksum;
+    message.ck[0] = static_cast<uint8_t>(checksum & 0xFF);
+    message.ck[1] = static_cast<uint8_t>(checksum >> 8);
+    out[message.len] = message.ck[0];
+    out[message.len + 1] = message.ck[1];
+}
+
+} // namespace mavsdk
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "mavlink_include.h"
+
+namespace mavsdk {
+
+// Packs messages of one kind, for streams published at a high rate, e.g.
+// positions coming from a simulator.
+//
+// Instead of going through mavlink_msg_*_pack and the generic finalizing with
+// its channel lookups, the payload is copied in from the message struct as a
+// whole and only the header fields which change are set. What the checksum
+// needs from the message definition is looked up once.
+//
+// The sequence numbers are shared with packed messages, so both can be mixed.
+// Only MAVLink 2 is packed, like everywhere else in MAVSDK.
+class MavlinkMessageTemplate {
+public:
+    explicit MavlinkMessageTemplate(uint32_t msg_id);
+
+    // Payload is the struct of the message, e.g. mavlink_global_position_int_t.
+    template<typename Payload>
+    void pack(
+        uint8_t system_id,
+        uint8_t component_id,
+        const Payload& payload,
+        mavlink_message_t& message) const
+    {
+        pack_payload(system_id, component_id, &payload, sizeof(payload), message);
+    }
+
+private:
+    void pack_payload(
+        uint8_t system_id,
+        uint8_t component_id,
+        const void* payload,
+        size_t payload_len,
+        mavlink_message_t& message) const;
+
+    uint32_t _msg_id;
+    uint8_t _max_len{0};
+    uint8_t _crc_extra{0};
+};
+
+} // namespace mavsdk
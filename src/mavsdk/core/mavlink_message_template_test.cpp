@@ -0,0 +1,52 @@
+#include "mavlink_message_template.h"
+#include <cstring>
+#include <gtest/gtest.h>
+
+using namespace mavsdk;
+
+TEST(MavlinkMessageTemplate, PacksLikeGeneratedCode)
+{
+    MavlinkMessageTemplate position_template{MAVLINK_MSG_ID_GLOBAL_POSITION_INT};
+
+    mavlink_global_position_int_t position{};
+    position.time_boot_ms = 1234;
+    position.lat = 473977420;
+    position.lon = 85455940;
+    position.alt = 488000;
+    position.relative_alt = 10500;
+    position.vx = 100;
+    position.vy = -50;
+    position.vz = 3;
+    // Trailing zeros are trimmed.
+    position.hdg = 0;
+
+    mavlink_status_t* status = mavlink_get_channel_status(MAVLINK_COMM_0);
+    const uint8_t seq = status->current_tx_seq;
+
+    mavlink_message_t message{};
+    position_template.pack(42, 1, position, message);
+    EXPECT_EQ(status->current_tx_seq, static_cast<uint8_t>(seq + 1));
+
+    status->current_tx_seq = seq;
+    mavlink_message_t expected{};
+    mavlink_msg_global_position_int_encode(42, 1, &expected, &position);
+
+    EXPECT_EQ(message.seq, expected.seq);
+    EXPECT_EQ(message.sysid, expected.sysid);
+    EXPECT_EQ(message.compid, expected.compid);
+    EXPECT_EQ(message.msgid, expected.msgid);
+    ASSERT_EQ(message.len, expected.len);
+    EXPECT_LT(message.len, MAVLINK_MSG_ID_GLOBAL_POSITION_INT_LEN);
+    EXPECT_EQ(message.checksum, expected.checksum);
+
+    uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
+    uint8_t expected_buffer[MAVLINK_MAX_PACKET_LEN];
+    const auto len = mavlink_msg_to_send_buffer(buffer, &message);
+    ASSERT_EQ(len, mavlink_msg_to_send_buffer(expected_buffer, &expected));
+    EXPECT_EQ(memcmp(buffer, expected_buffer, len), 0);
+
+    mavlink_global_position_int_t decoded{};
+    mavlink_msg_global_position_int_decode(&message, &decoded);
+    EXPECT_EQ(decoded.lat, position.lat);
+    EXPECT_EQ(decoded.vy, position.vy);
+}
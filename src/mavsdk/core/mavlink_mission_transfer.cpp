@@ -1,10 +1,49 @@
 #include <algorithm>
 #include "mavlink_mission_transfer.h"
 #include "log.h"
+#include "mission_file.h"
+#include "trace.h"
 #include "unused.h"
 
+#include <cstring>
+
 namespace mavsdk {
 
+namespace {
+
+// NAN is commonly used for unset params, and needs to compare as equal.
+bool is_same_float(float lhs, float rhs)
+{
+    return std::memcmp(&lhs, &rhs, sizeof(float)) == 0;
+}
+
+bool is_same_item(
+    const MavlinkMissionTransfer::ItemInt& lhs, const MavlinkMissionTransfer::ItemInt& rhs)
+{
+    return lhs.frame == rhs.frame && lhs.command == rhs.command && lhs.current == rhs.current &&
+           lhs.autocontinue == rhs.autocontinue && is_same_float(lhs.param1, rhs.param1) &&
+           is_same_float(lhs.param2, rhs.param2) && is_same_float(lhs.param3, rhs.param3) &&
+           is_same_float(lhs.param4, rhs.param4) && lhs.x == rhs.x && lhs.y == rhs.y &&
+           is_same_float(lhs.z, rhs.z) && lhs.mission_type == rhs.mission_type;
+}
+
+// The MAVLink revision we build against predates opaque_id, so we read the
+// extension field ourselves. Trailing zeros are truncated in MAVLink 2.
+constexpr unsigned mission_count_opaque_id_offset = 5;
+constexpr unsigned mission_ack_opaque_id_offset = 4;
+
+uint32_t opaque_id_of(const mavlink_message_t& message, unsigned offset)
+{
+    const auto* payload = reinterpret_cast<const uint8_t*>(_MAV_PAYLOAD(&message));
+    uint32_t opaque_id = 0;
+    for (unsigned i = 0; i < 4 && offset + i < message.len; ++i) {
+        opaque_id |= uint32_t(payload[offset + i]) << (8 * i);
+    }
+    return opaque_id;
+}
+
+} // namespace
+
 MavlinkMissionTransfer::MavlinkMissionTransfer(
     Sender& sender,
     MavlinkMessageHandler& message_handler,
@@ -25,7 +64,7 @@ MavlinkMissionTransfer::MavlinkMissionTransfer(
 
 std::weak_ptr<MavlinkMissionTransfer::WorkItem> MavlinkMissionTransfer::upload_items_async(
     uint8_t type,
-    const std::vector<ItemInt>& items,
+    std::vector<ItemInt> items,
     const ResultCallback& callback,
     const ProgressCallback& progress_callback)
 {
@@ -41,12 +80,14 @@ std::weak_ptr<MavlinkMissionTransfer::WorkItem> MavlinkMissionTransfer::upload_i
         _sender,
         _message_handler,
         _timeout_handler,
+        _known_items,
         type,
-        items,
+        std::move(items),
         _timeout_s_callback(),
         callback,
         progress_callback,
-        _debugging);
+        _debugging,
+        file_transfer_for(type));
 
     _work_queue.push_back(ptr);
 
@@ -68,11 +109,13 @@ std::weak_ptr<MavlinkMissionTransfer::WorkItem> MavlinkMissionTransfer::download
         _sender,
         _message_handler,
         _timeout_handler,
+        _known_items,
         type,
         _timeout_s_callback(),
         callback,
         progress_callback,
-        _debugging);
+        _debugging,
+        file_transfer_for(type));
 
     _work_queue.push_back(ptr);
 
@@ -109,6 +152,8 @@ MavlinkMissionTransfer::receive_incoming_items_async(
 
 void MavlinkMissionTransfer::clear_items_async(uint8_t type, ResultCallback callback)
 {
+    _known_items.forget(type);
+
     auto ptr = std::make_shared<ClearWorkItem>(
         _sender,
         _message_handler,
@@ -191,16 +236,20 @@ MavlinkMissionTransfer::UploadWorkItem::UploadWorkItem(
     Sender& sender,
     MavlinkMessageHandler& message_handler,
     TimeoutHandler& timeout_handler,
+    KnownItems& known_items,
     uint8_t type,
-    const std::vector<ItemInt>& items,
+    std::vector<ItemInt> items,
     double timeout_s,
     ResultCallback callback,
     ProgressCallback progress_callback,
-    bool debugging) :
+    bool debugging,
+    FileTransfer file_transfer) :
     WorkItem(sender, message_handler, timeout_handler, type, timeout_s, debugging),
-    _items(items),
+    _items(std::move(items)),
     _callback(callback),
-    _progress_callback(progress_callback)
+    _progress_callback(progress_callback),
+    _file_transfer(std::move(file_transfer)),
+    _known_items(known_items)
 {
     std::lock_guard<std::mutex> lock(_mutex);
 
@@ -229,7 +278,7 @@ MavlinkMissionTransfer::UploadWorkItem::~UploadWorkItem()
 
 void MavlinkMissionTransfer::UploadWorkItem::start()
 {
-    std::lock_guard<std::mutex> lock(_mutex);
+    std::unique_lock<std::mutex> lock(_mutex);
 
     _started = true;
     if (_items.size() == 0) {
@@ -237,6 +286,61 @@ void MavlinkMissionTransfer::UploadWorkItem::start()
         return;
     }
 
+    const Result result = check_items();
+    if (result != Result::Success) {
+        callback_and_reset(result);
+        return;
+    }
+
+    update_progress(0.0f);
+
+    if (const auto known = _known_items.get(_type);
+        known && _known_items.partial_writes_supported(_type)) {
+        _partial_ranges = changed_ranges(known->items, _items);
+    }
+    // Until we're done, we don't know what is on the vehicle.
+    _known_items.forget(_type);
+
+    if (!_partial_ranges.empty()) {
+        _partial = true;
+        _partial_range_index = 0;
+        _retries_done = 0;
+        _step = Step::SendPartialList;
+        Trace::instant("mission", "upload: send partial list");
+        _timeout_handler.add([this]() { process_timeout(); }, _timeout_s, &_cookie);
+        send_partial_list();
+        return;
+    }
+
+    if (!_file_transfer.upload) {
+        start_mission_protocol();
+        return;
+    }
+
+    _step = Step::TransferFile;
+    Trace::instant("mission", "upload: transfer file");
+    const auto path = mission_file_path(_type);
+    const auto data = encode_mission_file(_type, _items);
+    auto upload = _file_transfer.upload;
+    auto progress_callback = _progress_callback;
+    std::weak_ptr<WorkItem> weak_self = weak_from_this();
+
+    // The callback might come right away, so we must not hold the lock.
+    lock.unlock();
+    upload(
+        path,
+        data,
+        [weak_self](bool success) {
+            if (auto self = weak_self.lock()) {
+                std::static_pointer_cast<UploadWorkItem>(self)->process_file_upload_result(
+                    success);
+            }
+        },
+        progress_callback);
+}
+
+MavlinkMissionTransfer::Result MavlinkMissionTransfer::UploadWorkItem::check_items() const
+{
     // Mission items for ArduPilot are off by one because the home position is
     // item 0, and the sequence starts counting at 0 from 1.
     // This is only for missions, rally points, and geofence items are normal.
@@ -247,16 +351,14 @@ void MavlinkMissionTransfer::UploadWorkItem::start()
         for (unsigned i = 1; i < _items.size(); ++i) {
             if (_items[i].seq != i - 1) {
                 LogWarn() << "Invalid sequence for ArduPilot items";
-                callback_and_reset(Result::InvalidSequence);
-                return;
+                return Result::InvalidSequence;
             }
         }
     } else {
         for (unsigned i = 0; i < _items.size(); ++i) {
             if (_items[i].seq != i - 0) {
                 LogWarn() << "Invalid sequence";
-                callback_and_reset(Result::InvalidSequence);
-                return;
+                return Result::InvalidSequence;
             }
         }
     }
@@ -266,21 +368,24 @@ void MavlinkMissionTransfer::UploadWorkItem::start()
         num_currents += item.current;
     });
     if (num_currents != 1) {
-        callback_and_reset(Result::CurrentInvalid);
-        return;
+        return Result::CurrentInvalid;
     }
 
     if (std::any_of(_items.cbegin(), _items.cend(), [this](const ItemInt& item) {
             return item.mission_type != _type;
         })) {
-        callback_and_reset(Result::MissionTypeNotConsistent);
-        return;
+        return Result::MissionTypeNotConsistent;
     }
 
-    update_progress(0.0f);
+    return Result::Success;
+}
 
+void MavlinkMissionTransfer::UploadWorkItem::start_mission_protocol()
+{
+    _partial = false;
     _retries_done = 0;
     _step = Step::SendCount;
+    Trace::instant("mission", "upload: send count");
     _timeout_handler.add([this]() { process_timeout(); }, _timeout_s, &_cookie);
 
     _next_sequence = 0;
@@ -288,14 +393,97 @@ void MavlinkMissionTransfer::UploadWorkItem::start()
     send_count();
 }
 
+void MavlinkMissionTransfer::UploadWorkItem::process_file_upload_result(bool success)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    if (_cancelled) {
+        callback_and_reset(Result::Cancelled);
+        return;
+    }
+
+    if (success) {
+        update_progress(1.0f);
+        callback_and_reset(Result::Success);
+        return;
+    }
+
+    LogWarn() << "Mission file upload failed, falling back to mission protocol";
+    update_progress(0.0f);
+    start_mission_protocol();
+}
+
 void MavlinkMissionTransfer::UploadWorkItem::cancel()
 {
     std::lock_guard<std::mutex> lock(_mutex);
 
+    if (_step == Step::TransferFile) {
+        // We're done once the file transfer has finished.
+        _cancelled = true;
+        return;
+    }
+
     _timeout_handler.remove(_cookie);
     send_cancel_and_finish();
 }
 
+void MavlinkMissionTransfer::UploadWorkItem::send_partial_list()
+{
+    const auto& range = _partial_ranges[_partial_range_index];
+    _next_sequence = range.first;
+
+    mavlink_message_t message;
+    mavlink_msg_mission_write_partial_list_pack(
+        _sender.get_own_system_id(),
+        _sender.get_own_component_id(),
+        &message,
+        _sender.get_system_id(),
+        MAV_COMP_ID_AUTOPILOT1,
+        static_cast<int16_t>(range.first),
+        static_cast<int16_t>(range.second),
+        _type);
+
+    if (!_sender.send_message(message)) {
+        _timeout_handler.remove(_cookie);
+        callback_and_reset(Result::ConnectionError);
+        return;
+    }
+
+    if (_debugging) {
+        LogDebug() << "Sending write_partial_list, start: " << range.first
+                   << ", end: " << range.second << ", retries: " << _retries_done;
+    }
+
+    ++_retries_done;
+}
+
+void MavlinkMissionTransfer::UploadWorkItem::process_partial_ack(uint8_t type)
+{
+    const auto& range = _partial_ranges[_partial_range_index];
+    if (type != MAV_MISSION_ACCEPTED || _next_sequence != range.second + 1u) {
+        if (type == MAV_MISSION_UNSUPPORTED) {
+            _known_items.set_partial_writes_unsupported(_type);
+        }
+        // Whatever was written already is overwritten by the full upload.
+        LogWarn() << "Partial mission upload failed, falling back to full upload";
+        start_mission_protocol();
+        return;
+    }
+
+    ++_partial_range_index;
+    if (_partial_range_index == _partial_ranges.size()) {
+        update_progress(1.0f);
+        callback_and_reset(Result::Success);
+        return;
+    }
+
+    _retries_done = 0;
+    _step = Step::SendPartialList;
+    Trace::instant("mission", "upload: send partial list");
+    _timeout_handler.add([this]() { process_timeout(); }, _timeout_s, &_cookie);
+    send_partial_list();
+}
+
 void MavlinkMissionTransfer::UploadWorkItem::send_count()
 {
     mavlink_message_t message;
@@ -366,6 +554,10 @@ void MavlinkMissionTransfer::UploadWorkItem::process_mission_request(
     } else {
         std::lock_guard<std::mutex> lock(_mutex);
 
+        if (_step == Step::TransferFile) {
+            return;
+        }
+
         // We only support int, so we nack this and thus tell the autopilot to use int.
         UNUSED(request_message);
 
@@ -393,9 +585,16 @@ void MavlinkMissionTransfer::UploadWorkItem::process_mission_request_int(
 {
     std::lock_guard<std::mutex> lock(_mutex);
 
+    if (_step == Step::TransferFile) {
+        return;
+    }
+
     mavlink_mission_request_int_t request_int;
     mavlink_msg_mission_request_int_decode(&message, &request_int);
 
+    if (_step != Step::SendItems) {
+        Trace::instant("mission", "upload: send items");
+    }
     _step = Step::SendItems;
 
     if (_debugging) {
@@ -481,6 +680,10 @@ void MavlinkMissionTransfer::UploadWorkItem::process_mission_ack(const mavlink_m
 {
     std::lock_guard<std::mutex> lock(_mutex);
 
+    if (_step == Step::TransferFile) {
+        return;
+    }
+
     mavlink_mission_ack_t mission_ack;
     mavlink_msg_mission_ack_decode(&message, &mission_ack);
 
@@ -489,6 +692,12 @@ void MavlinkMissionTransfer::UploadWorkItem::process_mission_ack(const mavlink_m
     }
 
     _timeout_handler.remove(_cookie);
+    _opaque_id = opaque_id_of(message, mission_ack_opaque_id_offset);
+
+    if (_partial) {
+        process_partial_ack(mission_ack.type);
+        return;
+    }
 
     switch (mission_ack.type) {
         case MAV_MISSION_ERROR:
@@ -542,6 +751,7 @@ void MavlinkMissionTransfer::UploadWorkItem::process_mission_ack(const mavlink_m
 void MavlinkMissionTransfer::UploadWorkItem::process_timeout()
 {
     std::lock_guard<std::mutex> lock(_mutex);
+    Trace::instant("mission", "upload: timeout", _retries_done);
 
     if (_debugging) {
         LogDebug() << "Timeout triggered, retries: " << _retries_done;
@@ -554,6 +764,16 @@ void MavlinkMissionTransfer::UploadWorkItem::process_timeout()
     }
 
     switch (_step) {
+        case Step::TransferFile:
+            break;
+
+        case Step::SendPartialList:
+            // Autopilots without support for partial writes might not reply at all.
+            LogWarn() << "Partial mission upload timed out, falling back to full upload";
+            _known_items.set_partial_writes_unsupported(_type);
+            start_mission_protocol();
+            break;
+
         case Step::SendCount:
             _timeout_handler.add([this]() { process_timeout(); }, _timeout_s, &_cookie);
             send_count();
@@ -570,6 +790,14 @@ void MavlinkMissionTransfer::UploadWorkItem::process_timeout()
 
 void MavlinkMissionTransfer::UploadWorkItem::callback_and_reset(Result result)
 {
+    Trace::instant("mission", "upload: done", static_cast<int64_t>(result));
+
+    if (result == Result::Success) {
+        // Not sent anymore, late requests are out of bounds.
+        _known_items.remember(_type, std::move(_items), _opaque_id);
+        _items.clear();
+    }
+
     if (_callback) {
         _callback(result);
     }
@@ -588,14 +816,18 @@ MavlinkMissionTransfer::DownloadWorkItem::DownloadWorkItem(
     Sender& sender,
     MavlinkMessageHandler& message_handler,
     TimeoutHandler& timeout_handler,
+    KnownItems& known_items,
     uint8_t type,
     double timeout_s,
     ResultAndItemsCallback callback,
     ProgressCallback progress_callback,
-    bool debugging) :
+    bool debugging,
+    FileTransfer file_transfer) :
     WorkItem(sender, message_handler, timeout_handler, type, timeout_s, debugging),
     _callback(callback),
-    _progress_callback(progress_callback)
+    _progress_callback(progress_callback),
+    _file_transfer(std::move(file_transfer)),
+    _known_items(known_items)
 {
     std::lock_guard<std::mutex> lock(_mutex);
 
@@ -622,19 +854,80 @@ void MavlinkMissionTransfer::DownloadWorkItem::start()
 {
     update_progress(0.0f);
 
-    std::lock_guard<std::mutex> lock(_mutex);
+    std::unique_lock<std::mutex> lock(_mutex);
 
     _items.clear();
     _started = true;
+
+    if (!_file_transfer.download) {
+        start_mission_protocol();
+        return;
+    }
+
+    _step = Step::TransferFile;
+    Trace::instant("mission", "download: transfer file");
+    const auto path = mission_file_path(_type);
+    auto download = _file_transfer.download;
+    auto progress_callback = _progress_callback;
+    std::weak_ptr<WorkItem> weak_self = weak_from_this();
+
+    // The callback might come right away, so we must not hold the lock.
+    lock.unlock();
+    download(
+        path,
+        [weak_self](std::optional<std::vector<uint8_t>> data) {
+            if (auto self = weak_self.lock()) {
+                std::static_pointer_cast<DownloadWorkItem>(self)->process_file_download_result(
+                    std::move(data));
+            }
+        },
+        progress_callback);
+}
+
+void MavlinkMissionTransfer::DownloadWorkItem::start_mission_protocol()
+{
+    _step = Step::RequestList;
+    Trace::instant("mission", "download: request list");
     _retries_done = 0;
     _timeout_handler.add([this]() { process_timeout(); }, _timeout_s, &_cookie);
     request_list();
 }
 
+void MavlinkMissionTransfer::DownloadWorkItem::process_file_download_result(
+    std::optional<std::vector<uint8_t>> data)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    if (_cancelled) {
+        callback_and_reset(Result::Cancelled);
+        return;
+    }
+
+    if (data) {
+        if (auto items = decode_mission_file(_type, data.value())) {
+            _items = std::move(items.value());
+            update_progress(1.0f);
+            callback_and_reset(Result::Success);
+            return;
+        }
+        LogWarn() << "Invalid mission file";
+    }
+
+    LogWarn() << "Mission file download failed, falling back to mission protocol";
+    update_progress(0.0f);
+    start_mission_protocol();
+}
+
 void MavlinkMissionTransfer::DownloadWorkItem::cancel()
 {
     std::lock_guard<std::mutex> lock(_mutex);
 
+    if (_step == Step::TransferFile) {
+        // We're done once the file transfer has finished.
+        _cancelled = true;
+        return;
+    }
+
     _timeout_handler.remove(_cookie);
     send_cancel_and_finish();
 }
@@ -727,18 +1020,40 @@ void MavlinkMissionTransfer::DownloadWorkItem::process_mission_count(
 {
     std::lock_guard<std::mutex> lock(_mutex);
 
+    if (_step == Step::TransferFile) {
+        return;
+    }
+
     mavlink_mission_count_t count;
     mavlink_msg_mission_count_decode(&message, &count);
 
+    _opaque_id = opaque_id_of(message, mission_count_opaque_id_offset);
+
     if (count.count == 0) {
         send_ack_and_finish();
         _timeout_handler.remove(_cookie);
         return;
     }
 
+    // Without changes on the vehicle, we already have all items.
+    if (_opaque_id != 0) {
+        const auto known = _known_items.get(_type);
+        if (known && known->opaque_id == _opaque_id && known->items.size() == count.count) {
+            if (_debugging) {
+                LogDebug() << "Mission with opaque_id " << _opaque_id << " is known already";
+            }
+            _items = known->items;
+            _timeout_handler.remove(_cookie);
+            update_progress(1.0f);
+            send_ack_and_finish();
+            return;
+        }
+    }
+
     _timeout_handler.refresh(_cookie);
     _next_sequence = 0;
     _step = Step::RequestItem;
+    Trace::instant("mission", "download: request items", count.count);
     _retries_done = 0;
     _expected_count = count.count;
     request_item();
@@ -749,6 +1064,10 @@ void MavlinkMissionTransfer::DownloadWorkItem::process_mission_item_int(
 {
     std::lock_guard<std::mutex> lock(_mutex);
 
+    if (_step == Step::TransferFile) {
+        return;
+    }
+
     _timeout_handler.refresh(_cookie);
 
     mavlink_mission_item_int_t item_int;
@@ -789,6 +1108,7 @@ void MavlinkMissionTransfer::DownloadWorkItem::process_mission_item_int(
 void MavlinkMissionTransfer::DownloadWorkItem::process_timeout()
 {
     std::lock_guard<std::mutex> lock(_mutex);
+    Trace::instant("mission", "download: timeout", _retries_done);
 
     if (_retries_done >= retries) {
         callback_and_reset(Result::Timeout);
@@ -796,6 +1116,9 @@ void MavlinkMissionTransfer::DownloadWorkItem::process_timeout()
     }
 
     switch (_step) {
+        case Step::TransferFile:
+            break;
+
         case Step::RequestList:
             _timeout_handler.add([this]() { process_timeout(); }, _timeout_s, &_cookie);
             request_list();
@@ -810,6 +1133,12 @@ void MavlinkMissionTransfer::DownloadWorkItem::process_timeout()
 
 void MavlinkMissionTransfer::DownloadWorkItem::callback_and_reset(Result result)
 {
+    Trace::instant("mission", "download: done", static_cast<int64_t>(result));
+
+    if (result == Result::Success) {
+        _known_items.remember(_type, _items, _opaque_id);
+    }
+
     if (_callback) {
         _callback(result, _items);
     }
@@ -947,8 +1276,11 @@ void MavlinkMissionTransfer::ReceiveIncomingMission::process_mission_count()
     _timeout_handler.refresh(_cookie);
     _next_sequence = 0;
     _step = Step::RequestItem;
+    Trace::instant("mission", "incoming: request items", _mission_count);
     _retries_done = 0;
     _expected_count = _mission_count;
+    // Allocated once, large missions would otherwise reallocate many times.
+    _items.reserve(_mission_count);
     request_item();
 }
 
@@ -961,6 +1293,12 @@ void MavlinkMissionTransfer::ReceiveIncomingMission::process_mission_item_int(
     mavlink_mission_item_int_t item_int;
     mavlink_msg_mission_item_int_decode(&message, &item_int);
 
+    // Items are only requested one after the other, anything else is a
+    // duplicate, e.g. the answer to a request which was repeated.
+    if (item_int.seq != _next_sequence || _done) {
+        return;
+    }
+
     _items.push_back(ItemInt{
         item_int.seq,
         item_int.frame,
@@ -990,6 +1328,7 @@ void MavlinkMissionTransfer::ReceiveIncomingMission::process_mission_item_int(
 void MavlinkMissionTransfer::ReceiveIncomingMission::process_timeout()
 {
     std::lock_guard<std::mutex> lock(_mutex);
+    Trace::instant("mission", "incoming: timeout", _retries_done);
 
     if (_retries_done >= retries) {
         callback_and_reset(Result::Timeout);
@@ -1002,8 +1341,10 @@ void MavlinkMissionTransfer::ReceiveIncomingMission::process_timeout()
 
 void MavlinkMissionTransfer::ReceiveIncomingMission::callback_and_reset(Result result)
 {
+    Trace::instant("mission", "incoming: done", static_cast<int64_t>(result));
+
     if (_callback) {
-        _callback(result, _items);
+        _callback(result, std::move(_items));
     }
     _callback = nullptr;
     _done = true;
@@ -1077,6 +1418,7 @@ void MavlinkMissionTransfer::ClearWorkItem::send_clear()
 void MavlinkMissionTransfer::ClearWorkItem::process_timeout()
 {
     std::lock_guard<std::mutex> lock(_mutex);
+    Trace::instant("mission", "clear: timeout", _retries_done);
 
     if (_retries_done >= retries) {
         callback_and_reset(Result::Timeout);
@@ -1143,6 +1485,8 @@ void MavlinkMissionTransfer::ClearWorkItem::process_mission_ack(const mavlink_me
 
 void MavlinkMissionTransfer::ClearWorkItem::callback_and_reset(Result result)
 {
+    Trace::instant("mission", "clear: done", static_cast<int64_t>(result));
+
     if (_callback) {
         _callback(result);
     }
@@ -1150,6 +1494,112 @@ void MavlinkMissionTransfer::ClearWorkItem::callback_and_reset(Result result)
     _done = true;
 }
 
+void MavlinkMissionTransfer::set_file_transfer(FileTransfer file_transfer)
+{
+    std::lock_guard<std::mutex> lock(_file_transfer_mutex);
+    _file_transfer = std::move(file_transfer);
+}
+
+MavlinkMissionTransfer::FileTransfer MavlinkMissionTransfer::file_transfer_for(uint8_t type)
+{
+    if (mission_file_path(type).empty()) {
+        return {};
+    }
+
+    std::lock_guard<std::mutex> lock(_file_transfer_mutex);
+    return _file_transfer;
+}
+
+std::vector<MavlinkMissionTransfer::ItemRange> MavlinkMissionTransfer::changed_ranges(
+    const std::vector<ItemInt>& before, const std::vector<ItemInt>& after)
+{
+    // Partial writes can't change the number of items.
+    if (before.size() != after.size() || after.size() > INT16_MAX) {
+        return {};
+    }
+
+    std::vector<ItemRange> ranges;
+    for (uint16_t i = 0; i < after.size(); ++i) {
+        if (is_same_item(before[i], after[i])) {
+            continue;
+        }
+        // Another range costs a partial list and an ack, which is as much as
+        // sending one unchanged item along.
+        if (!ranges.empty() && ranges.back().second + 2 >= i) {
+            ranges.back().second = i;
+        } else {
+            ranges.emplace_back(i, i);
+        }
+    }
+
+    std::size_t cost = 0;
+    for (const auto& range : ranges) {
+        cost += range.second - range.first + 1u + 1u;
+    }
+    // A full upload costs a count on top of the items.
+    if (ranges.empty() || cost >= after.size() + 1u) {
+        return {};
+    }
+
+    return ranges;
+}
+
+void MavlinkMissionTransfer::KnownItems::remember(
+    uint8_t type, std::vector<ItemInt> items, uint32_t opaque_id)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _entries[type] = Entry{std::move(items), opaque_id};
+}
+
+void MavlinkMissionTransfer::KnownItems::forget(uint8_t type)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _entries.erase(type);
+}
+
+std::optional<MavlinkMissionTransfer::KnownItems::Entry>
+MavlinkMissionTransfer::KnownItems::get(uint8_t type)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    const auto it = _entries.find(type);
+    if (it == _entries.end()) {
+        return {};
+    }
+    return it->second;
+}
+
+void MavlinkMissionTransfer::KnownItems::set_partial_writes_unsupported(uint8_t type)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _partial_writes_unsupported.insert(type);
+}
+
+bool MavlinkMissionTransfer::KnownItems::partial_writes_supported(uint8_t type)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _partial_writes_unsupported.count(type) == 0;
+}
+
+size_t MavlinkMissionTransfer::KnownItems::memory_usage()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    size_t bytes = 0;
+    for (const auto& [type, entry] : _entries) {
+        bytes += sizeof(Entry) + entry.items.capacity() * sizeof(ItemInt);
+    }
+    return bytes;
+}
+
+size_t MavlinkMissionTransfer::known_items_memory_usage()
+{
+    return _known_items.memory_usage();
+}
+
+size_t MavlinkMissionTransfer::work_queue_memory_usage()
+{
+    return _work_queue.size() * sizeof(WorkItem);
+}
+
 void MavlinkMissionTransfer::set_int_messages_supported(bool supported)
 {
     _int_messages_supported = supported;
@@ -1252,6 +1702,7 @@ void MavlinkMissionTransfer::SetCurrentWorkItem::process_mission_current(
 void MavlinkMissionTransfer::SetCurrentWorkItem::process_timeout()
 {
     std::lock_guard<std::mutex> lock(_mutex);
+    Trace::instant("mission", "set current: timeout", _retries_done);
 
     if (_retries_done >= retries) {
         callback_and_reset(Result::Timeout);
@@ -1264,6 +1715,8 @@ void MavlinkMissionTransfer::SetCurrentWorkItem::process_timeout()
 
 void MavlinkMissionTransfer::SetCurrentWorkItem::callback_and_reset(Result result)
 {
+    Trace::instant("mission", "set current: done", static_cast<int64_t>(result));
+
     if (_callback) {
         _callback(result);
     }
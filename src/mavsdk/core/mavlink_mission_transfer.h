@@ -3,8 +3,13 @@
 #include <chrono>
 #include <cstdint>
 #include <functional>
+#include <map>
 #include <memory>
 #include <mutex>
+#include <optional>
+#include <set>
+#include <string>
+#include <utility>
 #include <vector>
 #include "mavlink_address.h"
 #include "mavlink_include.h"
@@ -66,7 +71,59 @@ public:
     using ResultAndItemsCallback = std::function<void(Result result, std::vector<ItemInt> items)>;
     using ProgressCallback = std::function<void(float progress)>;
 
-    class WorkItem {
+    // First and last index of a range of items, as in MISSION_WRITE_PARTIAL_LIST.
+    using ItemRange = std::pair<uint16_t, uint16_t>;
+
+    // Transfers a whole file, e.g. over MAVLink FTP. If set, items are
+    // transferred as a file, and with the mission protocol if that fails.
+    // No default member initializers, so that it can be a default argument
+    // within this class.
+    struct FileTransfer {
+        using UploadCallback = std::function<void(bool success)>;
+        using DownloadCallback = std::function<void(std::optional<std::vector<uint8_t>> data)>;
+
+        std::function<void(
+            const std::string& path,
+            const std::vector<uint8_t>& data,
+            const UploadCallback& callback,
+            const ProgressCallback& progress_callback)>
+            upload;
+        std::function<void(
+            const std::string& path,
+            const DownloadCallback& callback,
+            const ProgressCallback& progress_callback)>
+            download;
+    };
+
+    // The items last uploaded or downloaded per mission type, which is what
+    // we assume is on the vehicle, with the opaque_id the autopilot reported
+    // for them, or 0.
+    class KnownItems {
+    public:
+        struct Entry {
+            std::vector<ItemInt> items{};
+            uint32_t opaque_id{0};
+        };
+
+        void remember(uint8_t type, std::vector<ItemInt> items, uint32_t opaque_id);
+        void forget(uint8_t type);
+        std::optional<Entry> get(uint8_t type);
+
+        // Once a partial write was refused or ignored, we don't try again, so
+        // that frequent updates, e.g. of a fence, don't wait for a timeout
+        // every time.
+        void set_partial_writes_unsupported(uint8_t type);
+        bool partial_writes_supported(uint8_t type);
+
+        size_t memory_usage();
+
+    private:
+        std::mutex _mutex{};
+        std::map<uint8_t, Entry> _entries{}; // Needs _mutex
+        std::set<uint8_t> _partial_writes_unsupported{}; // Needs _mutex
+    };
+
+    class WorkItem : public std::enable_shared_from_this<WorkItem> {
     public:
         explicit WorkItem(
             Sender& sender,
@@ -104,12 +161,14 @@ public:
             Sender& sender,
             MavlinkMessageHandler& message_handler,
             TimeoutHandler& timeout_handler,
+            KnownItems& known_items,
             uint8_t type,
-            const std::vector<ItemInt>& items,
+            std::vector<ItemInt> items,
             double timeout_s,
             ResultCallback callback,
             ProgressCallback progress_callback,
-            bool debugging);
+            bool debugging,
+            FileTransfer file_transfer = {});
 
         ~UploadWorkItem() override;
         void start() override;
@@ -121,6 +180,12 @@ public:
         UploadWorkItem& operator=(UploadWorkItem&&) = delete;
 
     private:
+        Result check_items() const;
+        void start_mission_protocol();
+        void process_file_upload_result(bool success);
+        void send_partial_list();
+        void process_partial_ack(uint8_t type);
+
         void send_count();
         void send_mission_item();
         void send_cancel_and_finish();
@@ -134,6 +199,8 @@ public:
         void update_progress(float progress);
 
         enum class Step {
+            TransferFile,
+            SendPartialList,
             SendCount,
             SendItems,
         } _step{Step::SendCount};
@@ -144,6 +211,13 @@ public:
         std::size_t _next_sequence{0};
         void* _cookie{nullptr};
         unsigned _retries_done{0};
+        FileTransfer _file_transfer{};
+        bool _cancelled{false};
+        KnownItems& _known_items;
+        uint32_t _opaque_id{0};
+        std::vector<ItemRange> _partial_ranges{};
+        std::size_t _partial_range_index{0};
+        bool _partial{false};
     };
 
     class ReceiveIncomingMission : public WorkItem {
@@ -198,11 +272,13 @@ public:
             Sender& sender,
             MavlinkMessageHandler& message_handler,
             TimeoutHandler& timeout_handler,
+            KnownItems& known_items,
             uint8_t type,
             double timeout_s,
             ResultAndItemsCallback callback,
             ProgressCallback progress_callback,
-            bool debugging);
+            bool debugging,
+            FileTransfer file_transfer = {});
 
         ~DownloadWorkItem() override;
         void start() override;
@@ -214,6 +290,9 @@ public:
         DownloadWorkItem& operator=(DownloadWorkItem&&) = delete;
 
     private:
+        void start_mission_protocol();
+        void process_file_download_result(std::optional<std::vector<uint8_t>> data);
+
         void request_list();
         void request_item();
         void send_ack_and_finish();
@@ -226,6 +305,7 @@ public:
         void update_progress(float progress);
 
         enum class Step {
+            TransferFile,
             RequestList,
             RequestItem,
         } _step{Step::RequestList};
@@ -237,6 +317,10 @@ public:
         std::size_t _next_sequence{0};
         std::size_t _expected_count{0};
         unsigned _retries_done{0};
+        FileTransfer _file_transfer{};
+        bool _cancelled{false};
+        KnownItems& _known_items;
+        uint32_t _opaque_id{0};
     };
 
     class ClearWorkItem : public WorkItem {
@@ -313,9 +397,11 @@ public:
 
     ~MavlinkMissionTransfer() = default;
 
+    // Items are moved along to where they are sent, and remembered for the
+    // next partial write once uploaded, so pass them as rvalue if possible.
     std::weak_ptr<WorkItem> upload_items_async(
         uint8_t type,
-        const std::vector<ItemInt>& items,
+        std::vector<ItemInt> items,
         const ResultCallback& callback,
         const ProgressCallback& progress_callback = nullptr);
 
@@ -338,8 +424,26 @@ public:
     void do_work();
     bool is_idle();
 
+    // Bytes held by the items known to be on the vehicle, and by the
+    // transfers not done yet.
+    size_t known_items_memory_usage();
+    size_t work_queue_memory_usage();
+    void set_work_notifier(std::function<void()> notifier)
+    {
+        _work_queue.set_notifier(std::move(notifier));
+    }
+
     void set_int_messages_supported(bool supported);
 
+    // Only used for the mission types that can be transferred as files.
+    void set_file_transfer(FileTransfer file_transfer);
+
+    // The ranges to write with MISSION_WRITE_PARTIAL_LIST to get from the
+    // items before to the ones after. Empty if a full upload is needed, or
+    // not more expensive.
+    static std::vector<ItemRange>
+    changed_ranges(const std::vector<ItemInt>& before, const std::vector<ItemInt>& after);
+
     // Non-copyable
     MavlinkMissionTransfer(const MavlinkMissionTransfer&) = delete;
     const MavlinkMissionTransfer& operator=(const MavlinkMissionTransfer&) = delete;
@@ -352,6 +456,13 @@ private:
 
     LockedQueue<WorkItem> _work_queue{};
 
+    FileTransfer file_transfer_for(uint8_t type);
+
+    std::mutex _file_transfer_mutex{};
+    FileTransfer _file_transfer{}; // Needs _file_transfer_mutex
+
+    KnownItems _known_items{};
+
     bool _int_messages_supported{true};
     bool _debugging{false};
 };
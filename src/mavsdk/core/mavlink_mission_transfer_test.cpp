@@ -963,6 +963,209 @@ TEST_F(MavlinkMissionTransferTest, DownloadMissionSendsRequestList)
     mmt.do_work();
 }
 
+TEST(MavlinkMissionTransfer, ChangedRangesAreMerged)
+{
+    std::vector<ItemInt> before;
+    for (uint16_t i = 0; i < 20; ++i) {
+        before.push_back(make_item(MAV_MISSION_TYPE_MISSION, i));
+        before.back().param4 = NAN;
+    }
+
+    EXPECT_TRUE(MavlinkMissionTransfer::changed_ranges(before, before).empty());
+
+    auto after = before;
+    after[3].x = 100;
+    after[5].y = 100;
+    after[12].z = 100.0f;
+    const auto ranges = MavlinkMissionTransfer::changed_ranges(before, after);
+    ASSERT_EQ(ranges.size(), 2);
+    EXPECT_EQ(ranges[0], MavlinkMissionTransfer::ItemRange(3, 5));
+    EXPECT_EQ(ranges[1], MavlinkMissionTransfer::ItemRange(12, 12));
+
+    // Partial writes can't add or remove items.
+    after.push_back(make_item(MAV_MISSION_TYPE_MISSION, 20));
+    EXPECT_TRUE(MavlinkMissionTransfer::changed_ranges(before, after).empty());
+
+    // No point if almost everything changed.
+    after = before;
+    for (auto& item : after) {
+        item.param1 = 10.0f;
+    }
+    EXPECT_TRUE(MavlinkMissionTransfer::changed_ranges(before, after).empty());
+}
+
+bool is_correct_mission_write_partial_list(
+    uint8_t type, int16_t start, int16_t end, const mavlink_message_t& message)
+{
+    if (message.msgid != MAVLINK_MSG_ID_MISSION_WRITE_PARTIAL_LIST) {
+        return false;
+    }
+
+    mavlink_mission_write_partial_list_t partial_list;
+    mavlink_msg_mission_write_partial_list_decode(&message, &partial_list);
+    return (
+        message.sysid == own_address.system_id && message.compid == own_address.component_id &&
+        partial_list.target_system == target_address.system_id &&
+        partial_list.target_component == target_address.component_id &&
+        partial_list.start_index == start && partial_list.end_index == end &&
+        partial_list.mission_type == type);
+}
+
+class MavlinkMissionTransferPartialTest : public MavlinkMissionTransferTest {
+protected:
+    void SetUp() override
+    {
+        MavlinkMissionTransferTest::SetUp();
+        ON_CALL(mock_sender, send_message(_)).WillByDefault(Return(true));
+
+        for (uint16_t i = 0; i < 10; ++i) {
+            items.push_back(make_item(MAV_MISSION_TYPE_MISSION, i));
+        }
+
+        // The first upload is a full one.
+        std::promise<void> prom;
+        auto fut = prom.get_future();
+        mmt.upload_items_async(MAV_MISSION_TYPE_MISSION, items, [&prom](Result result) {
+            EXPECT_EQ(result, Result::Success);
+            prom.set_value();
+        });
+        mmt.do_work();
+        for (int i = 0; i < 10; ++i) {
+            message_handler.process_message(make_mission_request_int(MAV_MISSION_TYPE_MISSION, i));
+        }
+        message_handler.process_message(
+            make_mission_ack(MAV_MISSION_TYPE_MISSION, MAV_MISSION_ACCEPTED));
+        EXPECT_EQ(fut.wait_for(std::chrono::seconds(1)), std::future_status::ready);
+        mmt.do_work();
+    }
+
+    std::vector<ItemInt> items;
+};
+
+TEST_F(MavlinkMissionTransferPartialTest, UploadMissionWritesOnlyChangedItems)
+{
+    items[7].x = 42;
+
+    EXPECT_CALL(mock_sender, send_message(Truly([](const mavlink_message_t& message) {
+                    return is_correct_mission_write_partial_list(
+                        MAV_MISSION_TYPE_MISSION, 7, 7, message);
+                })));
+
+    std::promise<void> prom;
+    auto fut = prom.get_future();
+    mmt.upload_items_async(MAV_MISSION_TYPE_MISSION, items, [&prom](Result result) {
+        EXPECT_EQ(result, Result::Success);
+        ONCE_ONLY;
+        prom.set_value();
+    });
+    mmt.do_work();
+
+    EXPECT_CALL(mock_sender, send_message(Truly([this](const mavlink_message_t& message) {
+                    return is_the_same_mission_item_int(items[7], message);
+                })));
+    message_handler.process_message(make_mission_request_int(MAV_MISSION_TYPE_MISSION, 7));
+
+    message_handler.process_message(
+        make_mission_ack(MAV_MISSION_TYPE_MISSION, MAV_MISSION_ACCEPTED));
+
+    EXPECT_EQ(fut.wait_for(std::chrono::seconds(1)), std::future_status::ready);
+
+    mmt.do_work();
+    EXPECT_TRUE(mmt.is_idle());
+}
+
+TEST_F(MavlinkMissionTransferPartialTest, UploadMissionFallsBackToFullUploadIfPartialIsRejected)
+{
+    items[2].y = 42;
+
+    std::promise<void> prom;
+    auto fut = prom.get_future();
+    mmt.upload_items_async(MAV_MISSION_TYPE_MISSION, items, [&prom](Result result) {
+        EXPECT_EQ(result, Result::Success);
+        ONCE_ONLY;
+        prom.set_value();
+    });
+    mmt.do_work();
+
+    EXPECT_CALL(mock_sender, send_message(Truly([this](const mavlink_message_t& message) {
+                    return is_correct_mission_send_count(
+                        MAV_MISSION_TYPE_MISSION, items.size(), message);
+                })));
+    message_handler.process_message(
+        make_mission_ack(MAV_MISSION_TYPE_MISSION, MAV_MISSION_UNSUPPORTED));
+
+    for (int i = 0; i < 10; ++i) {
+        message_handler.process_message(make_mission_request_int(MAV_MISSION_TYPE_MISSION, i));
+    }
+    message_handler.process_message(
+        make_mission_ack(MAV_MISSION_TYPE_MISSION, MAV_MISSION_ACCEPTED));
+
+    EXPECT_EQ(fut.wait_for(std::chrono::seconds(1)), std::future_status::ready);
+
+    mmt.do_work();
+    EXPECT_TRUE(mmt.is_idle());
+}
+
+TEST_F(MavlinkMissionTransferPartialTest, UploadMissionFallsBackToFullUploadIfPartialIsIgnored)
+{
+    items[2].y = 42;
+
+    mmt.upload_items_async(MAV_MISSION_TYPE_MISSION, items, [](Result result) {
+        UNUSED(result);
+        EXPECT_TRUE(false);
+    });
+    mmt.do_work();
+
+    EXPECT_CALL(mock_sender, send_message(Truly([this](const mavlink_message_t& message) {
+                    return is_correct_mission_send_count(
+                        MAV_MISSION_TYPE_MISSION, items.size(), message);
+                })));
+
+    time.sleep_for(std::chrono::milliseconds(static_cast<int>(timeout_s * 1.1 * 1000.)));
+    timeout_handler.run_once();
+}
+
+TEST_F(MavlinkMissionTransferPartialTest, UploadMissionDoesNotRetryPartialOnceUnsupported)
+{
+    items[2].y = 42;
+
+    std::promise<void> prom;
+    auto fut = prom.get_future();
+    mmt.upload_items_async(MAV_MISSION_TYPE_MISSION, items, [&prom](Result result) {
+        EXPECT_EQ(result, Result::Success);
+        ONCE_ONLY;
+        prom.set_value();
+    });
+    mmt.do_work();
+
+    message_handler.process_message(
+        make_mission_ack(MAV_MISSION_TYPE_MISSION, MAV_MISSION_UNSUPPORTED));
+    for (int i = 0; i < 10; ++i) {
+        message_handler.process_message(make_mission_request_int(MAV_MISSION_TYPE_MISSION, i));
+    }
+    message_handler.process_message(
+        make_mission_ack(MAV_MISSION_TYPE_MISSION, MAV_MISSION_ACCEPTED));
+    EXPECT_EQ(fut.wait_for(std::chrono::seconds(1)), std::future_status::ready);
+    mmt.do_work();
+
+    items[3].y = 42;
+
+    EXPECT_CALL(mock_sender, send_message(Truly([](const mavlink_message_t& message) {
+                    return message.msgid == MAVLINK_MSG_ID_MISSION_WRITE_PARTIAL_LIST;
+                })))
+        .Times(0);
+    EXPECT_CALL(mock_sender, send_message(Truly([this](const mavlink_message_t& message) {
+                    return is_correct_mission_send_count(
+                        MAV_MISSION_TYPE_MISSION, items.size(), message);
+                })));
+
+    mmt.upload_items_async(MAV_MISSION_TYPE_MISSION, items, [](Result result) {
+        UNUSED(result);
+        EXPECT_TRUE(false);
+    });
+    mmt.do_work();
+}
+
 bool is_correct_mission_request_list(uint8_t type, const mavlink_message_t& message)
 {
     if (message.msgid != MAVLINK_MSG_ID_MISSION_REQUEST_LIST) {
@@ -1288,6 +1491,85 @@ TEST_F(MavlinkMissionTransferTest, DownloadMissionSendsAllMissionRequestsAndAck)
     EXPECT_TRUE(mmt.is_idle());
 }
 
+mavlink_message_t make_mission_count_with_opaque_id(unsigned count, uint32_t opaque_id)
+{
+    // The extension is not in the MAVLink revision we build against.
+    auto message = make_mission_count(count);
+    auto* payload = reinterpret_cast<uint8_t*>(_MAV_PAYLOAD_NON_CONST(&message));
+    for (unsigned i = 0; i < 4; ++i) {
+        payload[5 + i] = static_cast<uint8_t>(opaque_id >> (8 * i));
+    }
+    message.len = 9;
+    return message;
+}
+
+TEST_F(MavlinkMissionTransferTest, DownloadMissionIsSkippedIfOpaqueIdIsKnown)
+{
+    ON_CALL(mock_sender, send_message(_)).WillByDefault(Return(true));
+
+    std::vector<ItemInt> real_items;
+    real_items.push_back(make_item(MAV_MISSION_TYPE_MISSION, 0));
+    real_items.push_back(make_item(MAV_MISSION_TYPE_MISSION, 1));
+
+    {
+        std::promise<void> prom;
+        auto fut = prom.get_future();
+        mmt.download_items_async(
+            MAV_MISSION_TYPE_MISSION,
+            [&prom, &real_items](Result result, const std::vector<ItemInt>& items) {
+                EXPECT_EQ(result, Result::Success);
+                EXPECT_EQ(items, real_items);
+                prom.set_value();
+            });
+        mmt.do_work();
+
+        message_handler.process_message(
+            make_mission_count_with_opaque_id(real_items.size(), 0x12345678));
+        message_handler.process_message(make_mission_item(real_items, 0));
+        message_handler.process_message(make_mission_item(real_items, 1));
+        EXPECT_EQ(fut.wait_for(std::chrono::seconds(1)), std::future_status::ready);
+        mmt.do_work();
+    }
+
+    {
+        std::promise<void> prom;
+        auto fut = prom.get_future();
+        mmt.download_items_async(
+            MAV_MISSION_TYPE_MISSION,
+            [&prom, &real_items](Result result, const std::vector<ItemInt>& items) {
+                EXPECT_EQ(result, Result::Success);
+                EXPECT_EQ(items, real_items);
+                prom.set_value();
+            });
+        mmt.do_work();
+
+        // The same opaque_id again, so no items are requested.
+        EXPECT_CALL(mock_sender, send_message(Truly([](const mavlink_message_t& message) {
+                        return is_correct_mission_ack(
+                            MAV_MISSION_TYPE_MISSION, MAV_MISSION_ACCEPTED, message);
+                    })));
+        message_handler.process_message(
+            make_mission_count_with_opaque_id(real_items.size(), 0x12345678));
+        EXPECT_EQ(fut.wait_for(std::chrono::seconds(1)), std::future_status::ready);
+        mmt.do_work();
+    }
+
+    mmt.download_items_async(
+        MAV_MISSION_TYPE_MISSION, [](Result result, const std::vector<ItemInt>& items) {
+            UNUSED(result);
+            UNUSED(items);
+            EXPECT_TRUE(false);
+        });
+    mmt.do_work();
+
+    // Once the mission changed, it is downloaded again.
+    EXPECT_CALL(mock_sender, send_message(Truly([](const mavlink_message_t& message) {
+                    return is_correct_mission_request_int(MAV_MISSION_TYPE_MISSION, 0, message);
+                })));
+    message_handler.process_message(
+        make_mission_count_with_opaque_id(real_items.size(), 0x12345679));
+}
+
 TEST_F(MavlinkMissionTransferTest, ReceiveIncomingMissionSendsAllMissionRequestsAndAck)
 {
     ON_CALL(mock_sender, send_message(_)).WillByDefault(Return(true));
@@ -1346,6 +1628,68 @@ TEST_F(MavlinkMissionTransferTest, ReceiveIncomingMissionSendsAllMissionRequests
     EXPECT_TRUE(mmt.is_idle());
 }
 
+TEST_F(MavlinkMissionTransferTest, ReceiveIncomingMissionDoesntHaveDuplicates)
+{
+    ON_CALL(mock_sender, send_message(_)).WillByDefault(Return(true));
+
+    std::vector<ItemInt> real_items;
+    real_items.push_back(make_item(MAV_MISSION_TYPE_MISSION, 0));
+    real_items.push_back(make_item(MAV_MISSION_TYPE_MISSION, 1));
+    real_items.push_back(make_item(MAV_MISSION_TYPE_MISSION, 2));
+
+    std::promise<void> prom;
+    auto fut = prom.get_future();
+    mmt.receive_incoming_items_async(
+        MAV_MISSION_TYPE_MISSION,
+        real_items.size(),
+        target_address.component_id,
+        [&prom, &real_items](Result result, const std::vector<ItemInt>& items) {
+            EXPECT_EQ(result, Result::Success);
+            EXPECT_EQ(items, real_items);
+            prom.set_value();
+        });
+
+    EXPECT_CALL(mock_sender, send_message(Truly([](const mavlink_message_t& message) {
+                    return is_correct_autopilot_mission_request_int(
+                        MAV_MISSION_TYPE_MISSION, 0, target_address.component_id, message);
+                })));
+
+    mmt.do_work();
+
+    EXPECT_CALL(mock_sender, send_message(Truly([](const mavlink_message_t& message) {
+                    return is_correct_autopilot_mission_request_int(
+                        MAV_MISSION_TYPE_MISSION, 1, target_address.component_id, message);
+                })));
+
+    message_handler.process_message(make_mission_item(real_items, 0));
+
+    EXPECT_CALL(mock_sender, send_message(Truly([](const mavlink_message_t& message) {
+                    return is_correct_autopilot_mission_request_int(
+                        MAV_MISSION_TYPE_MISSION, 2, target_address.component_id, message);
+                })));
+
+    // Send a message 3 times, it should just get ignored.
+    message_handler.process_message(make_mission_item(real_items, 1));
+
+    EXPECT_CALL(mock_sender, send_message(Truly([](const mavlink_message_t& message) {
+                    return is_correct_autopilot_mission_ack(
+                        MAV_MISSION_TYPE_MISSION,
+                        MAV_MISSION_ACCEPTED,
+                        target_address.component_id,
+                        message);
+                })));
+
+    message_handler.process_message(make_mission_item(real_items, 1));
+    message_handler.process_message(make_mission_item(real_items, 1));
+
+    message_handler.process_message(make_mission_item(real_items, 2));
+
+    EXPECT_EQ(fut.wait_for(std::chrono::seconds(1)), std::future_status::ready);
+
+    mmt.do_work();
+    EXPECT_TRUE(mmt.is_idle());
+}
+
 TEST_F(MavlinkMissionTransferTest, DownloadMissionResendsRequestItemAgainForSecondItem)
 {
     ON_CALL(mock_sender, send_message(_)).WillByDefault(Return(true));
@@ -1,10 +1,15 @@
 #include "mavlink_parameters.h"
 #include "mavlink_message_handler.h"
+#include "param_cache.h"
+#include "param_pck.h"
+#include "param_store.h"
 #include "timeout_handler.h"
+#include "trace.h"
 #include "system_impl.h"
 #include <algorithm>
 #include <cstring>
 #include <future>
+#include <limits>
 
 namespace mavsdk {
 
@@ -18,6 +23,7 @@ MAVLinkParameters::MAVLinkParameters(
     _message_handler(message_handler),
     _timeout_handler(timeout_handler),
     _timeout_s_callback(timeout_s_callback),
+    _all_params(std::make_unique<ParamStore>()),
     _is_server(is_server)
 {
     if (const char* env_p = std::getenv("MAVSDK_PARAMETER_DEBUGGING")) {
@@ -76,6 +82,18 @@ MAVLinkParameters::MAVLinkParameters(
 MAVLinkParameters::~MAVLinkParameters()
 {
     _message_handler.unregister_all(this);
+
+    {
+        std::lock_guard<std::mutex> lock(_params_sets_mutex);
+        for (auto& params_set : _params_sets) {
+            _timeout_handler.remove(params_set->timeout_cookie);
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(_params_gets_mutex);
+    for (auto& params_get : _params_gets) {
+        _timeout_handler.remove(params_get->timeout_cookie);
+    }
 }
 
 MAVLinkParameters::Result
@@ -88,7 +106,8 @@ MAVLinkParameters::provide_server_param_float(const std::string& name, float val
 
     ParamValue param_value;
     param_value.set(value);
-    _all_params.insert_or_assign(name, param_value);
+    std::lock_guard<std::mutex> lock(_all_params_mutex);
+    _all_params->set(name, param_value);
     return Result::Success;
 }
 
@@ -102,7 +121,8 @@ MAVLinkParameters::provide_server_param_int(const std::string& name, int value)
 
     ParamValue param_value;
     param_value.set(value);
-    _all_params.insert_or_assign(name, param_value);
+    std::lock_guard<std::mutex> lock(_all_params_mutex);
+    _all_params->set(name, param_value);
     return Result::Success;
 }
 
@@ -121,7 +141,29 @@ MAVLinkParameters::provide_server_param_custom(const std::string& name, const st
 
     ParamValue param_value;
     param_value.set(value);
-    _all_params.insert_or_assign(name, param_value);
+    std::lock_guard<std::mutex> lock(_all_params_mutex);
+    _all_params->set(name, param_value);
+    return Result::Success;
+}
+
+MAVLinkParameters::Result MAVLinkParameters::provide_server_params(
+    const std::vector<std::pair<std::string, ParamValue>>& params)
+{
+    for (const auto& [name, value] : params) {
+        if (name.size() > PARAM_ID_LEN) {
+            LogErr() << "Error: param name too long";
+            return Result::ParamNameTooLong;
+        }
+
+        if (value.is<std::string>() &&
+            value.get<std::string>().size() > sizeof(mavlink_param_ext_set_t::param_value)) {
+            LogErr() << "Error: param value too long";
+            return Result::ParamValueTooLong;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(_all_params_mutex);
+    _all_params->set_all(params);
     return Result::Success;
 }
 
@@ -212,7 +254,7 @@ void MAVLinkParameters::set_param_int_async(
     };
 
     // We need to know the exact int type first.
-    if (exact_int_type_known || _all_params.find(name) != _all_params.end()) {
+    if (exact_int_type_known || _all_params->contains(name)) {
         // We are sure about the type, or we have it cached, we'll be able to use it.
         set_step();
     } else {
@@ -468,19 +510,485 @@ void MAVLinkParameters::set_param_custom_async(
     _work_queue.push_back(new_work);
 }
 
+std::vector<MAVLinkParameters::Result> MAVLinkParameters::set_params(
+    const std::vector<std::pair<std::string, ParamValue>>& params,
+    std::optional<uint8_t> maybe_component_id,
+    size_t max_in_flight)
+{
+    std::promise<std::vector<Result>> prom;
+    auto res = prom.get_future();
+
+    set_params_async(
+        params,
+        [&prom](std::vector<Result> results) { prom.set_value(std::move(results)); },
+        maybe_component_id,
+        max_in_flight);
+
+    return res.get();
+}
+
+void MAVLinkParameters::set_params_async(
+    const std::vector<std::pair<std::string, ParamValue>>& params,
+    const SetParamsCallback& callback,
+    std::optional<uint8_t> maybe_component_id,
+    size_t max_in_flight)
+{
+    set_params_async(
+        std::make_shared<const std::vector<std::pair<std::string, ParamValue>>>(params),
+        callback,
+        maybe_component_id,
+        max_in_flight);
+}
+
+void MAVLinkParameters::set_params_async(
+    SharedParams params,
+    const SetParamsCallback& callback,
+    std::optional<uint8_t> maybe_component_id,
+    size_t max_in_flight)
+{
+    auto params_set = std::make_shared<ParamsSet>();
+    params_set->results.resize(params->size());
+    params_set->params = std::move(params);
+    params_set->callback = callback;
+    params_set->component_id =
+        maybe_component_id.value_or(static_cast<uint8_t>(MAV_COMP_ID_AUTOPILOT1));
+    params_set->max_in_flight = std::max<size_t>(max_in_flight, 1);
+
+    for (size_t i = 0; i < params_set->params->size(); ++i) {
+        if ((*params_set->params)[i].first.size() > PARAM_ID_LEN) {
+            LogErr() << "Error: param name too long";
+            params_set->results[i] = Result::ParamNameTooLong;
+            ++params_set->num_done;
+        }
+    }
+
+    std::vector<std::shared_ptr<ParamsSet>> finished;
+    {
+        std::lock_guard<std::mutex> lock(_params_sets_mutex);
+        _params_sets.push_back(params_set);
+        send_params(*params_set);
+        finished = take_finished_params_sets();
+    }
+    call_params_set_callbacks(finished);
+}
+
+void MAVLinkParameters::send_params(ParamsSet& params_set)
+{
+    bool sent = false;
+    while (params_set.in_flight.size() < params_set.max_in_flight &&
+           params_set.next_to_send < params_set.params->size()) {
+        const size_t index = params_set.next_to_send++;
+        if (params_set.results[index]) {
+            continue;
+        }
+
+        const auto& param = (*params_set.params)[index];
+        char param_id[PARAM_ID_LEN + 1] = {};
+        strncpy(param_id, param.first.c_str(), sizeof(param_id) - 1);
+
+        mavlink_message_t message;
+        pack_param_set(message, param_id, param.second, params_set.component_id);
+        if (!_sender.send_message(message)) {
+            LogErr() << "Error: Send message failed";
+            params_set.results[index] = Result::ConnectionError;
+            ++params_set.num_done;
+            continue;
+        }
+
+        params_set.in_flight.push_back({index, 3});
+        Trace::instant("params", "set: send", index);
+        sent = true;
+    }
+
+    if (sent) {
+        refresh_params_set_timeout(params_set);
+    }
+}
+
+void MAVLinkParameters::refresh_params_set_timeout(ParamsSet& params_set)
+{
+    _timeout_handler.remove(params_set.timeout_cookie);
+    const ParamsSet* params_set_ptr = &params_set;
+    _timeout_handler.add(
+        [this, params_set_ptr] { params_set_timeout(params_set_ptr); },
+        _timeout_s_callback(),
+        &params_set.timeout_cookie);
+}
+
+std::vector<std::shared_ptr<MAVLinkParameters::ParamsSet>>
+MAVLinkParameters::take_finished_params_sets()
+{
+    std::vector<std::shared_ptr<ParamsSet>> finished;
+    for (auto it = _params_sets.begin(); it != _params_sets.end(); /* manual incrementation */) {
+        if ((*it)->num_done == (*it)->params.size()) {
+            _timeout_handler.remove((*it)->timeout_cookie);
+            finished.push_back(*it);
+            it = _params_sets.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    return finished;
+}
+
+void MAVLinkParameters::process_params_set_echo(const std::string& param_id)
+{
+    std::vector<std::shared_ptr<ParamsSet>> finished;
+    {
+        std::lock_guard<std::mutex> lock(_params_sets_mutex);
+        for (auto& params_set : _params_sets) {
+            auto& in_flight = params_set->in_flight;
+            const auto it =
+                std::find_if(in_flight.begin(), in_flight.end(), [&](const auto& entry) {
+                    return (*params_set->params)[entry.index].first == param_id;
+                });
+            if (it == in_flight.end()) {
+                continue;
+            }
+
+            params_set->results[it->index] = Result::Success;
+            ++params_set->num_done;
+            in_flight.erase(it);
+
+            refresh_params_set_timeout(*params_set);
+            send_params(*params_set);
+        }
+        finished = take_finished_params_sets();
+    }
+    call_params_set_callbacks(finished);
+}
+
+void MAVLinkParameters::params_set_timeout(const ParamsSet* params_set_ptr)
+{
+    Trace::instant("params", "set: timeout");
+
+    std::vector<std::shared_ptr<ParamsSet>> finished;
+    {
+        std::lock_guard<std::mutex> lock(_params_sets_mutex);
+        const auto found = std::find_if(
+            _params_sets.begin(), _params_sets.end(), [&](const auto& params_set) {
+                return params_set.get() == params_set_ptr;
+            });
+        if (found == _params_sets.end()) {
+            return;
+        }
+        auto& params_set = **found;
+
+        // Either the sets or the echos got lost, so we send everything in
+        // flight again.
+        for (auto it = params_set.in_flight.begin(); it != params_set.in_flight.end();
+             /* manual incrementation */) {
+            if (it->retries_left-- == 0) {
+                params_set.results[it->index] = Result::Timeout;
+                ++params_set.num_done;
+                it = params_set.in_flight.erase(it);
+                continue;
+            }
+
+            const auto& param = (*params_set.params)[it->index];
+            char param_id[PARAM_ID_LEN + 1] = {};
+            strncpy(param_id, param.first.c_str(), sizeof(param_id) - 1);
+
+            mavlink_message_t message;
+            pack_param_set(message, param_id, param.second, params_set.component_id);
+            _sender.send_message(message);
+            ++it;
+        }
+
+        if (!params_set.in_flight.empty()) {
+            refresh_params_set_timeout(params_set);
+        }
+        send_params(params_set);
+        finished = take_finished_params_sets();
+    }
+    call_params_set_callbacks(finished);
+}
+
+void MAVLinkParameters::call_params_set_callbacks(
+    const std::vector<std::shared_ptr<ParamsSet>>& finished)
+{
+    for (const auto& params_set : finished) {
+        if (!params_set->callback) {
+            continue;
+        }
+
+        std::vector<Result> results;
+        results.reserve(params_set->results.size());
+        for (const auto& result : params_set->results) {
+            results.push_back(result.value_or(Result::UnknownError));
+        }
+        params_set->callback(std::move(results));
+    }
+}
+
+void MAVLinkParameters::get_params_async(
+    const std::vector<std::pair<std::string, ParamValue>>& params,
+    const GetParamsCallback& callback,
+    std::optional<uint8_t> maybe_component_id,
+    bool extended,
+    size_t max_in_flight)
+{
+    get_params_async(
+        std::make_shared<const std::vector<std::pair<std::string, ParamValue>>>(params),
+        callback,
+        maybe_component_id,
+        extended, max_in_flight);
+}
+
+void MAVLinkParameters::get_params_async(
+    SharedParams params,
+    const GetParamsCallback& callback,
+    std::optional<uint8_t> maybe_component_id,
+    bool extended,
+    size_t max_in_flight)
+{
+    auto params_get = std::make_shared<ParamsGet>();
+    params_get->results.resize(params->size());
+    params_get->params = std::move(params);
+    params_get->callback = callback;
+    params_get->component_id =
+        maybe_component_id.value_or(static_cast<uint8_t>(MAV_COMP_ID_AUTOPILOT1));
+    params_get->extended = extended;
+    params_get->max_in_flight = std::max<size_t>(max_in_flight, 1);
+
+    for (size_t i = 0; i < params_get->params->size(); ++i) {
+        if ((*params_get->params)[i].first.size() > PARAM_ID_LEN) {
+            LogErr() << "Error: param name too long";
+            params_get->results[i] = std::make_pair(Result::ParamNameTooLong, ParamValue{});
+            ++params_get->num_done;
+        }
+    }
+
+    std::vector<std::shared_ptr<ParamsGet>> finished;
+    {
+        std::lock_guard<std::mutex> lock(_params_gets_mutex);
+        _params_gets.push_back(params_get);
+        send_param_requests(*params_get);
+        finished = take_finished_params_gets();
+    }
+    call_params_get_callbacks(finished);
+}
+
+void MAVLinkParameters::send_param_requests(ParamsGet& params_get)
+{
+    bool sent = false;
+    while (params_get.in_flight.size() < params_get.max_in_flight &&
+           params_get.next_to_send < params_get.params->size()) {
+        const size_t index = params_get.next_to_send++;
+        if (params_get.results[index]) {
+            continue;
+        }
+
+        char param_id[PARAM_ID_LEN + 1] = {};
+        strncpy(param_id, (*params_get.params)[index].first.c_str(), sizeof(param_id) - 1);
+
+        mavlink_message_t message;
+        pack_param_request_read(message, param_id, params_get.component_id, params_get.extended);
+        if (!_sender.send_message(message)) {
+            LogErr() << "Error: Send message failed";
+            params_get.results[index] = std::make_pair(Result::ConnectionError, ParamValue{});
+            ++params_get.num_done;
+            continue;
+        }
+
+        params_get.in_flight.push_back({index, 3});
+        Trace::instant("params", "get: send", index);
+        sent = true;
+    }
+
+    if (sent) {
+        refresh_params_get_timeout(params_get);
+    }
+}
+
+void MAVLinkParameters::refresh_params_get_timeout(ParamsGet& params_get)
+{
+    _timeout_handler.remove(params_get.timeout_cookie);
+    const ParamsGet* params_get_ptr = &params_get;
+    _timeout_handler.add(
+        [this, params_get_ptr] { params_get_timeout(params_get_ptr); },
+        _timeout_s_callback(),
+        &params_get.timeout_cookie);
+}
+
+std::vector<std::shared_ptr<MAVLinkParameters::ParamsGet>>
+MAVLinkParameters::take_finished_params_gets()
+{
+    std::vector<std::shared_ptr<ParamsGet>> finished;
+    for (auto it = _params_gets.begin(); it != _params_gets.end(); /* manual incrementation */) {
+        if ((*it)->num_done == (*it)->params.size()) {
+            _timeout_handler.remove((*it)->timeout_cookie);
+            finished.push_back(*it);
+            it = _params_gets.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    return finished;
+}
+
+void MAVLinkParameters::process_params_get_value(
+    const std::string& param_id, const ParamValue& value, uint8_t component_id, bool extended)
+{
+    std::vector<std::shared_ptr<ParamsGet>> finished;
+    {
+        std::lock_guard<std::mutex> lock(_params_gets_mutex);
+        for (auto& params_get : _params_gets) {
+            if (params_get->extended != extended || params_get->component_id != component_id) {
+                continue;
+            }
+
+            auto& in_flight = params_get->in_flight;
+            const auto it =
+                std::find_if(in_flight.begin(), in_flight.end(), [&](const auto& entry) {
+                    return (*params_get->params)[entry.index].first == param_id;
+                });
+            if (it == in_flight.end()) {
+                continue;
+            }
+
+            if (value.is_same_type((*params_get->params)[it->index].second)) {
+                params_get->results[it->index] = std::make_pair(Result::Success, value);
+            } else {
+                LogErr() << "Param types don't match for " << param_id;
+                params_get->results[it->index] = std::make_pair(Result::WrongType, ParamValue{});
+            }
+            ++params_get->num_done;
+            in_flight.erase(it);
+
+            refresh_params_get_timeout(*params_get);
+            send_param_requests(*params_get);
+        }
+        finished = take_finished_params_gets();
+    }
+    call_params_get_callbacks(finished);
+}
+
+void MAVLinkParameters::params_get_timeout(const ParamsGet* params_get_ptr)
+{
+    Trace::instant("params", "get: timeout");
+
+    std::vector<std::shared_ptr<ParamsGet>> finished;
+    {
+        std::lock_guard<std::mutex> lock(_params_gets_mutex);
+        const auto found = std::find_if(
+            _params_gets.begin(), _params_gets.end(), [&](const auto& params_get) {
+                return params_get.get() == params_get_ptr;
+            });
+        if (found == _params_gets.end()) {
+            return;
+        }
+        auto& params_get = **found;
+
+        // Either the requests or the values got lost, so we request
+        // everything in flight again.
+        for (auto it = params_get.in_flight.begin(); it != params_get.in_flight.end();
+             /* manual incrementation */) {
+            if (it->retries_left-- == 0) {
+                params_get.results[it->index] = std::make_pair(Result::Timeout, ParamValue{});
+                ++params_get.num_done;
+                it = params_get.in_flight.erase(it);
+                continue;
+            }
+
+            const auto& param = (*params_get.params)[it->index];
+            char param_id[PARAM_ID_LEN + 1] = {};
+            strncpy(param_id, param.first.c_str(), sizeof(param_id) - 1);
+
+            mavlink_message_t message;
+            pack_param_request_read(
+                message, param_id, params_get.component_id, params_get.extended);
+            _sender.send_message(message);
+            ++it;
+        }
+
+        if (!params_get.in_flight.empty()) {
+            refresh_params_get_timeout(params_get);
+        }
+        send_param_requests(params_get);
+        finished = take_finished_params_gets();
+    }
+    call_params_get_callbacks(finished);
+}
+
+void MAVLinkParameters::call_params_get_callbacks(
+    const std::vector<std::shared_ptr<ParamsGet>>& finished)
+{
+    for (const auto& params_get : finished) {
+        if (!params_get->callback) {
+            continue;
+        }
+
+        std::vector<std::pair<Result, ParamValue>> results;
+        results.reserve(params_get->results.size());
+        for (const auto& result : params_get->results) {
+            results.push_back(result.value_or(std::make_pair(Result::UnknownError, ParamValue{})));
+        }
+        params_get->callback(std::move(results));
+    }
+}
+
+void MAVLinkParameters::pack_param_request_read(
+    mavlink_message_t& message, const char* param_id, uint8_t component_id, bool extended)
+{
+    if (extended) {
+        mavlink_msg_param_ext_request_read_pack(
+            _sender.get_own_system_id(),
+            _sender.get_own_component_id(),
+            &message,
+            _sender.get_system_id(),
+            component_id,
+            param_id,
+            -1);
+    } else {
+        mavlink_msg_param_request_read_pack(
+            _sender.get_own_system_id(),
+            _sender.get_own_component_id(),
+            &message,
+            _sender.get_system_id(),
+            component_id,
+            param_id,
+            -1);
+    }
+}
+
+void MAVLinkParameters::pack_param_set(
+    mavlink_message_t& message, const char* param_id, const ParamValue& value, uint8_t component_id)
+{
+    float value_set = (_sender.autopilot() == SystemImpl::Autopilot::ArduPilot) ?
+                          value.get_4_float_bytes_cast() :
+                          value.get_4_float_bytes_bytewise();
+
+    mavlink_msg_param_set_pack(
+        _sender.get_own_system_id(),
+        _sender.get_own_component_id(),
+        &message,
+        _sender.get_system_id(),
+        component_id,
+        param_id,
+        value_set,
+        value.get_mav_param_type());
+}
+
 std::map<std::string, MAVLinkParameters::ParamValue> MAVLinkParameters::retrieve_all_server_params()
 {
     std::lock_guard<std::mutex> lock(_all_params_mutex);
-    return _all_params;
+    return _all_params->to_map();
+}
+
+void MAVLinkParameters::for_each_server_param(
+    const std::function<void(const std::string&, const ParamValue&)>& visitor)
+{
+    std::lock_guard<std::mutex> lock(_all_params_mutex);
+    _all_params->for_each(visitor);
 }
 
 std::pair<MAVLinkParameters::Result, MAVLinkParameters::ParamValue>
 MAVLinkParameters::retrieve_server_param(const std::string& name, ParamValue value_type)
 {
-    if (_all_params.find(name) != _all_params.end()) {
-        auto value = _all_params.at(name);
-        if (value.is_same_type(value_type))
-            return {MAVLinkParameters::Result::Success, value};
+    if (const auto value = _all_params->get(name)) {
+        if (value->is_same_type(value_type))
+            return {MAVLinkParameters::Result::Success, value.value()};
         else
             return {MAVLinkParameters::Result::WrongType, {}};
     }
@@ -490,8 +998,8 @@ MAVLinkParameters::retrieve_server_param(const std::string& name, ParamValue val
 std::pair<MAVLinkParameters::Result, float>
 MAVLinkParameters::retrieve_server_param_float(const std::string& name)
 {
-    if (_all_params.find(name) != _all_params.end()) {
-        const auto maybe_value = _all_params.at(name).get_float();
+    if (const auto value = _all_params->get(name)) {
+        const auto maybe_value = value->get_float();
         if (maybe_value)
             return {MAVLinkParameters::Result::Success, maybe_value.value()};
         else
@@ -503,8 +1011,8 @@ MAVLinkParameters::retrieve_server_param_float(const std::string& name)
 std::pair<MAVLinkParameters::Result, std::string>
 MAVLinkParameters::retrieve_server_param_custom(const std::string& name)
 {
-    if (_all_params.find(name) != _all_params.end()) {
-        const auto maybe_value = _all_params.at(name).get_custom();
+    if (const auto value = _all_params->get(name)) {
+        const auto maybe_value = value->get_custom();
         if (maybe_value)
             return {MAVLinkParameters::Result::Success, maybe_value.value()};
         else
@@ -516,8 +1024,8 @@ MAVLinkParameters::retrieve_server_param_custom(const std::string& name)
 std::pair<MAVLinkParameters::Result, int>
 MAVLinkParameters::retrieve_server_param_int(const std::string& name)
 {
-    if (_all_params.find(name) != _all_params.end()) {
-        const auto maybe_value = _all_params.at(name).get_int();
+    if (const auto value = _all_params->get(name)) {
+        const auto maybe_value = value->get_int();
         if (maybe_value)
             return {MAVLinkParameters::Result::Success, maybe_value.value()};
         else
@@ -593,10 +1101,115 @@ MAVLinkParameters::get_param_custom(const std::string& name)
 }
 
 void MAVLinkParameters::get_all_params_async(const GetAllParamsCallback& callback)
+{
+    StateStoreKey cache;
+    {
+        std::lock_guard<std::mutex> lock(_all_params_mutex);
+        cache = _cache;
+    }
+
+    // Only PX4 provides _HASH_CHECK.
+    if (!cache.store || _sender.autopilot() != SystemImpl::Autopilot::Px4) {
+        download_all_params(callback, {}, {});
+        return;
+    }
+
+    // The hash is requested before the list, so a param changed during the
+    // download makes the cache outdated instead of wrong.
+    get_param_int_async(
+        "_HASH_CHECK",
+        [this, callback, cache](Result result, int32_t value) {
+            if (result != Result::Success) {
+                LogWarn() << "Could not get _HASH_CHECK, not using param cache";
+                download_all_params(callback, {}, {});
+                return;
+            }
+
+            const auto hash = static_cast<uint32_t>(value);
+            if (auto cached_params = ParamCache::load(cache, hash)) {
+                LogDebug() << "Params loaded from cache " << cache.key;
+                Trace::instant("params", "get all: from cache");
+                std::lock_guard<std::mutex> lock(_all_params_mutex);
+                _all_params->assign(cached_params.value());
+                callback(cached_params.value());
+                return;
+            }
+
+            download_all_params(callback, cache, hash);
+        },
+        this,
+        MAV_COMP_ID_AUTOPILOT1,
+        false);
+}
+
+void MAVLinkParameters::set_cache(StateStoreKey cache)
+{
+    std::lock_guard<std::mutex> lock(_all_params_mutex);
+    _cache = std::move(cache);
+}
+
+void MAVLinkParameters::set_bulk_download_function(BulkDownloadFunction bulk_download_function)
 {
     std::lock_guard<std::mutex> lock(_all_params_mutex);
+    _bulk_download_function = std::move(bulk_download_function);
+}
 
+void MAVLinkParameters::download_all_params(
+    const GetAllParamsCallback& callback,
+    const StateStoreKey& cache,
+    std::optional<uint32_t> hash)
+{
+    BulkDownloadFunction bulk_download_function;
+    {
+        std::lock_guard<std::mutex> lock(_all_params_mutex);
+        if (!_bulk_download_function) {
+            request_all_params(callback, cache, hash);
+            return;
+        }
+        bulk_download_function = _bulk_download_function;
+    }
+
+    Trace::instant("params", "get all: bulk download");
+
+    // Not called with the lock held, the result might be reported right away.
+    bulk_download_function(
+        [this, callback, cache, hash](std::optional<std::vector<uint8_t>> data) {
+            auto params = data ? parse_param_pck(data.value()) : std::nullopt;
+
+            std::lock_guard<std::mutex> lock(_all_params_mutex);
+            if (!params) {
+                LogWarn() << "Could not download params at once, requesting list";
+                request_all_params(callback, cache, hash);
+                return;
+            }
+
+            if (hash) {
+                ParamCache::save(cache, hash.value(), params.value());
+            }
+            _all_params->assign(params.value());
+            callback(params.value());
+        });
+}
+
+void MAVLinkParameters::request_all_params(
+    const GetAllParamsCallback& callback,
+    const StateStoreKey& cache,
+    std::optional<uint32_t> hash)
+{
     _all_params_callback = callback;
+    _all_params_cache = cache;
+    _all_params_hash = hash;
+    _all_params_received.clear();
+    _all_params_num_received = 0;
+    _all_params_outstanding.clear();
+    _all_params_next_missing = 0;
+    _all_params_retries_left = MAX_ALL_PARAMS_RETRIES;
+    Trace::instant("params", "get all: request list");
+
+    // Old params must not end up in the cache.
+    if (hash) {
+        _all_params->clear();
+    }
 
     mavlink_message_t msg;
 
@@ -616,6 +1229,67 @@ void MAVLinkParameters::get_all_params_async(const GetAllParamsCallback& callbac
         [this] { receive_timeout(); }, _timeout_s_callback(), &_all_params_timeout_cookie);
 }
 
+void MAVLinkParameters::mark_param_received(uint16_t param_index, uint16_t param_count)
+{
+    if (_all_params_received.empty()) {
+        _all_params_received.resize(param_count, false);
+    }
+
+    // E.g. _HASH_CHECK has no index.
+    if (param_index >= _all_params_received.size()) {
+        return;
+    }
+
+    const auto outstanding = std::find(
+        _all_params_outstanding.begin(), _all_params_outstanding.end(), param_index);
+    if (outstanding != _all_params_outstanding.end()) {
+        _all_params_outstanding.erase(outstanding);
+    }
+
+    if (!_all_params_received[param_index]) {
+        _all_params_received[param_index] = true;
+        ++_all_params_num_received;
+        _all_params_retries_left = MAX_ALL_PARAMS_RETRIES;
+    }
+}
+
+void MAVLinkParameters::request_missing_params()
+{
+    // Only a few requests are in flight at a time, the next one is sent when
+    // a response arrives. That way, we don't send faster than the link can
+    // take, and don't need to time out each request.
+    while (_all_params_outstanding.size() < MAX_OUTSTANDING_PARAM_REQUESTS &&
+           _all_params_next_missing < _all_params_received.size()) {
+        const auto param_index = static_cast<uint16_t>(_all_params_next_missing++);
+        if (_all_params_received[param_index]) {
+            continue;
+        }
+
+        if (_parameter_debugging) {
+            LogDebug() << "Requesting missing param " << param_index;
+        }
+
+        // An empty ID means the index is used.
+        char param_id[PARAM_ID_LEN] = {};
+        mavlink_message_t msg;
+        mavlink_msg_param_request_read_pack(
+            _sender.get_own_system_id(),
+            _sender.get_own_component_id(),
+            &msg,
+            _sender.get_system_id(),
+            MAV_COMP_ID_AUTOPILOT1,
+            param_id,
+            static_cast<int16_t>(param_index));
+
+        if (!_sender.send_message(msg)) {
+            LogErr() << "Failed to send param request!";
+            return;
+        }
+        _all_params_outstanding.push_back(param_index);
+        Trace::instant("params", "get all: request missing", param_index);
+    }
+}
+
 std::map<std::string, MAVLinkParameters::ParamValue> MAVLinkParameters::get_all_params()
 {
     std::promise<std::map<std::string, ParamValue>> prom;
@@ -629,6 +1303,17 @@ std::map<std::string, MAVLinkParameters::ParamValue> MAVLinkParameters::get_all_
     return res.get();
 }
 
+size_t MAVLinkParameters::param_store_memory_usage()
+{
+    std::lock_guard<std::mutex> lock(_all_params_mutex);
+    return sizeof(ParamStore) + _all_params->memory_usage();
+}
+
+size_t MAVLinkParameters::work_queue_memory_usage()
+{
+    return _work_queue.size() * sizeof(WorkItem);
+}
+
 void MAVLinkParameters::cancel_all_param(const void* cookie)
 {
     LockedQueue<WorkItem>::Guard work_queue_guard(_work_queue);
@@ -647,29 +1332,12 @@ void MAVLinkParameters::subscribe_param_float_changed(
     const MAVLinkParameters::ParamFloatChangedCallback& callback,
     const void* cookie)
 {
-    std::lock_guard<std::mutex> lock(_param_changed_subscriptions_mutex);
-
     if (callback != nullptr) {
-        ParamChangedSubscription subscription{};
-        subscription.param_name = name;
-        subscription.callback = callback;
-        subscription.cookie = cookie;
-        subscription.any_type = false;
         ParamValue value_type;
         value_type.set_float(NAN);
-        subscription.value_type = value_type;
-        _param_changed_subscriptions.push_back(subscription);
-
+        add_param_changed_subscription(name, callback, value_type, cookie);
     } else {
-        for (auto it = _param_changed_subscriptions.begin();
-             it != _param_changed_subscriptions.end();
-             /* ++it */) {
-            if (it->param_name == name && it->cookie == cookie) {
-                it = _param_changed_subscriptions.erase(it);
-            } else {
-                ++it;
-            }
-        }
+        remove_param_changed_subscription(name, cookie);
     }
 }
 
@@ -678,29 +1346,12 @@ void MAVLinkParameters::subscribe_param_int_changed(
     const MAVLinkParameters::ParamIntChangedCallback& callback,
     const void* cookie)
 {
-    std::lock_guard<std::mutex> lock(_param_changed_subscriptions_mutex);
-
     if (callback != nullptr) {
-        ParamChangedSubscription subscription{};
-        subscription.param_name = name;
-        subscription.callback = callback;
-        subscription.cookie = cookie;
-        subscription.any_type = false;
         ParamValue value_type;
         value_type.set_int(0);
-        subscription.value_type = value_type;
-        _param_changed_subscriptions.push_back(subscription);
-
+        add_param_changed_subscription(name, callback, value_type, cookie);
     } else {
-        for (auto it = _param_changed_subscriptions.begin();
-             it != _param_changed_subscriptions.end();
-             /* ++it */) {
-            if (it->param_name == name && it->cookie == cookie) {
-                it = _param_changed_subscriptions.erase(it);
-            } else {
-                ++it;
-            }
-        }
+        remove_param_changed_subscription(name, cookie);
     }
 }
 
@@ -709,34 +1360,80 @@ void MAVLinkParameters::subscribe_param_custom_changed(
     const MAVLinkParameters::ParamCustomChangedCallback& callback,
     const void* cookie)
 {
-    std::lock_guard<std::mutex> lock(_param_changed_subscriptions_mutex);
-
     if (callback != nullptr) {
-        ParamChangedSubscription subscription{};
-        subscription.param_name = name;
-        subscription.callback = callback;
-        subscription.cookie = cookie;
-        subscription.any_type = false;
         ParamValue value_type;
         value_type.set_custom("");
-        subscription.value_type = value_type;
-        _param_changed_subscriptions.push_back(subscription);
-
+        add_param_changed_subscription(name, callback, value_type, cookie);
     } else {
-        for (auto it = _param_changed_subscriptions.begin();
-             it != _param_changed_subscriptions.end();
-             /* ++it */) {
-            if (it->param_name == name && it->cookie == cookie) {
-                it = _param_changed_subscriptions.erase(it);
-            } else {
-                ++it;
-            }
-        }
+        remove_param_changed_subscription(name, cookie);
+    }
+}
+
+MAVLinkParameters::ParamName
+MAVLinkParameters::param_name_from(const char* param_id, size_t max_len)
+{
+    ParamName param_name{};
+    for (size_t i = 0; i < std::min(max_len, param_name.size()) && param_id[i] != '\0'; ++i) {
+        param_name[i] = param_id[i];
+    }
+    return param_name;
+}
+
+void MAVLinkParameters::add_param_changed_subscription(
+    const std::string& name,
+    const ParamChangedCallbacks& callback,
+    const ParamValue& value_type,
+    const void* cookie)
+{
+    if (name.size() > std::tuple_size<ParamName>::value) {
+        LogWarn() << "Param name too long to subscribe to: " << name;
+        return;
+    }
+
+    ParamChangedSubscription subscription{};
+    subscription.param_name = name;
+    subscription.callback = callback;
+    subscription.cookie = cookie;
+    subscription.any_type = false;
+    subscription.value_type = value_type;
+
+    std::lock_guard<std::mutex> lock(_param_changed_subscriptions_mutex);
+    _param_changed_subscriptions[param_name_from(name.c_str(), name.size())].push_back(
+        std::move(subscription));
+}
+
+void MAVLinkParameters::remove_param_changed_subscription(
+    const std::string& name, const void* cookie)
+{
+    std::lock_guard<std::mutex> lock(_param_changed_subscriptions_mutex);
+
+    auto it = _param_changed_subscriptions.find(param_name_from(name.c_str(), name.size()));
+    if (it == _param_changed_subscriptions.end()) {
+        return;
+    }
+
+    auto& subscriptions = it->second;
+    subscriptions.erase(
+        std::remove_if(
+            subscriptions.begin(),
+            subscriptions.end(),
+            [&](const ParamChangedSubscription& subscription) {
+                return subscription.param_name == name && subscription.cookie == cookie;
+            }),
+        subscriptions.end());
+
+    // Unsubscribed params shouldn't cost anything anymore.
+    if (subscriptions.empty()) {
+        _param_changed_subscriptions.erase(it);
     }
 }
 
 void MAVLinkParameters::do_work()
 {
+    if (_is_server) {
+        stream_param_list();
+    }
+
     LockedQueue<WorkItem>::Guard work_queue_guard(_work_queue);
     auto work = work_queue_guard.get_front();
 
@@ -767,8 +1464,8 @@ void MAVLinkParameters::do_work()
         case WorkItem::Type::Set: {
             if (!work->exact_type_known) {
                 std::lock_guard<std::mutex> lock(_all_params_mutex);
-                const auto it = _all_params.find(work->param_name);
-                if (it == _all_params.end()) {
+                const auto known_value = _all_params->get(work->param_name);
+                if (!known_value) {
                     LogErr() << "Don't know the type of param_set";
                     if (std::get_if<SetParamCallback>(&work->callback)) {
                         const auto& callback = std::get<SetParamCallback>(work->callback);
@@ -786,7 +1483,7 @@ void MAVLinkParameters::do_work()
                     LogErr() << "Error: this should definitely be an int";
                 } else {
                     // First we copy over the type
-                    work->param_value = it->second;
+                    work->param_value = known_value.value();
                     // And then fill in the value.
                     work->param_value.set_int(maybe_temp_int.value());
                 }
@@ -806,19 +1503,7 @@ void MAVLinkParameters::do_work()
                     param_value_buf.data(),
                     work->param_value.get_mav_param_ext_type());
             } else {
-                float value_set = (_sender.autopilot() == SystemImpl::Autopilot::ArduPilot) ?
-                                      work->param_value.get_4_float_bytes_cast() :
-                                      work->param_value.get_4_float_bytes_bytewise();
-
-                mavlink_msg_param_set_pack(
-                    _sender.get_own_system_id(),
-                    _sender.get_own_component_id(),
-                    &work->mavlink_message,
-                    _sender.get_system_id(),
-                    component_id,
-                    param_id,
-                    value_set,
-                    work->param_value.get_mav_param_type());
+                pack_param_set(work->mavlink_message, param_id, work->param_value, component_id);
             }
 
             if (!_sender.send_message(work->mavlink_message)) {
@@ -843,33 +1528,7 @@ void MAVLinkParameters::do_work()
 
         case WorkItem::Type::Get: {
             // LogDebug() << "now getting: " << work->param_name;
-            if (work->extended) {
-                mavlink_msg_param_ext_request_read_pack(
-                    _sender.get_own_system_id(),
-                    _sender.get_own_component_id(),
-                    &work->mavlink_message,
-                    _sender.get_system_id(),
-                    component_id,
-                    param_id,
-                    -1);
-
-            } else {
-                // LogDebug() << "request read: "
-                //    << (int)_sender.get_own_system_id() << ":"
-                //    << (int)_sender.get_own_component_id() <<
-                //    " to "
-                //    << (int)_sender.get_system_id() << ":"
-                //    << (int)_sender.get_autopilot_id();
-
-                mavlink_msg_param_request_read_pack(
-                    _sender.get_own_system_id(),
-                    _sender.get_own_component_id(),
-                    &work->mavlink_message,
-                    _sender.get_system_id(),
-                    component_id,
-                    param_id,
-                    -1);
-            }
+            pack_param_request_read(work->mavlink_message, param_id, component_id, work->extended);
 
             if (!_sender.send_message(work->mavlink_message)) {
                 LogErr() << "Error: Send message failed";
@@ -913,19 +1572,10 @@ void MAVLinkParameters::do_work()
                     work->param_count,
                     work->param_index);
             } else {
-                float param_value;
-                if (_sender.autopilot() == SystemImpl::Autopilot::ArduPilot) {
-                    param_value = work->param_value.get_4_float_bytes_cast();
-                } else {
-                    param_value = work->param_value.get_4_float_bytes_bytewise();
-                }
-                mavlink_msg_param_value_pack(
-                    _sender.get_own_system_id(),
-                    _sender.get_own_component_id(),
-                    &work->mavlink_message,
+                pack_param_value(
+                    work->mavlink_message,
                     param_id,
-                    param_value,
-                    work->param_value.get_mav_param_type(),
+                    work->param_value,
                     work->param_count,
                     work->param_index);
             }
@@ -983,25 +1633,41 @@ void MAVLinkParameters::process_param_value(const mavlink_message_t& message)
 
     std::string param_id = extract_safe_param_id(param_value.param_id);
 
+    process_params_set_echo(param_id);
+    process_params_get_value(param_id, received_value, message.compid, false);
+
     {
         std::lock_guard<std::mutex> lock(_all_params_mutex);
-        _all_params[param_id] = received_value;
+        _all_params->set(param_id, received_value);
 
         // check if we are looking for param list
         if (_all_params_callback) {
-            if (param_value.param_index + 1 == param_value.param_count) {
-                _timeout_handler.remove(_all_params_timeout_cookie);
-                _all_params_callback(_all_params);
+            _timeout_handler.remove(_all_params_timeout_cookie);
+            mark_param_received(param_value.param_index, param_value.param_count);
+
+            if (_all_params_num_received == _all_params_received.size()) {
+                const auto all_params = _all_params->to_map();
+                if (_all_params_hash) {
+                    ParamCache::save(_all_params_cache, _all_params_hash.value(), all_params);
+                }
+                _all_params_hash.reset();
+                Trace::instant("params", "get all: done", all_params.size());
+                _all_params_callback(all_params);
                 _all_params_callback = nullptr;
-            } else {
-                _timeout_handler.remove(_all_params_timeout_cookie);
+                return;
+            }
 
-                _timeout_handler.add(
-                    [this] { receive_timeout(); },
-                    _timeout_s_callback(),
-                    &_all_params_timeout_cookie);
+            // Once the list has been sent, whatever is still missing is
+            // requested.
+            if (param_value.param_index + 1 == param_value.param_count ||
+                _all_params_next_missing > 0) {
+                request_missing_params();
             }
 
+            _timeout_handler.add(
+                [this] { receive_timeout(); },
+                _timeout_s_callback(),
+                &_all_params_timeout_cookie);
             return;
         }
     }
@@ -1091,19 +1757,39 @@ void MAVLinkParameters::notify_param_subscriptions(const mavlink_param_value_t&
 {
     std::lock_guard<std::mutex> lock(_param_changed_subscriptions_mutex);
 
-    for (const auto& subscription : _param_changed_subscriptions) {
-        if (subscription.param_name != extract_safe_param_id(param_value.param_id)) {
-            continue;
-        }
+    // Most params of a full download have no subscribers.
+    const auto it = _param_changed_subscriptions.find(
+        param_name_from(param_value.param_id, sizeof(param_value.param_id)));
+    if (it == _param_changed_subscriptions.end()) {
+        return;
+    }
 
-        ParamValue value;
+    ParamValue value;
+    if (_sender.autopilot() == SystemImpl::Autopilot::ArduPilot) {
+        value.set_from_mavlink_param_value_cast(param_value);
+    } else {
+        value.set_from_mavlink_param_value_bytewise(param_value);
+    }
 
-        if (_sender.autopilot() == SystemImpl::Autopilot::ArduPilot) {
-            value.set_from_mavlink_param_value_cast(param_value);
-        } else {
-            value.set_from_mavlink_param_value_bytewise(param_value);
-        }
+    call_param_changed_callbacks(it->second, value);
+}
+
+void MAVLinkParameters::notify_param_subscriptions(const std::string& name, const ParamValue& value)
+{
+    std::lock_guard<std::mutex> lock(_param_changed_subscriptions_mutex);
+
+    const auto it = _param_changed_subscriptions.find(param_name_from(name.c_str(), name.size()));
+    if (it == _param_changed_subscriptions.end()) {
+        return;
+    }
+
+    call_param_changed_callbacks(it->second, value);
+}
 
+void MAVLinkParameters::call_param_changed_callbacks(
+    const std::vector<ParamChangedSubscription>& subscriptions, const ParamValue& value)
+{
+    for (const auto& subscription : subscriptions) {
         if (!subscription.any_type && !subscription.value_type.is_same_type(value)) {
             LogErr() << "Received wrong param type in subscription for " << subscription.param_name;
             continue;
@@ -1122,6 +1808,13 @@ void MAVLinkParameters::process_param_ext_value(const mavlink_message_t& message
     mavlink_param_ext_value_t param_ext_value{};
     mavlink_msg_param_ext_value_decode(&message, &param_ext_value);
 
+    {
+        ParamValue value;
+        value.set_from_mavlink_param_ext_value(param_ext_value);
+        process_params_get_value(
+            extract_safe_param_id(param_ext_value.param_id), value, message.compid, true);
+    }
+
     LockedQueue<WorkItem>::Guard work_queue_guard(_work_queue);
     auto work = work_queue_guard.get_front();
 
@@ -1312,31 +2005,16 @@ void MAVLinkParameters::process_param_ext_set(const mavlink_message_t& message)
                 LogWarn() << "Invalid Param Ext Set Request: " << safe_param_id;
                 return;
             }
-            _all_params[safe_param_id] = value;
+            _all_params->set(safe_param_id, value);
         }
 
         auto new_work = std::make_shared<WorkItem>(_timeout_s_callback());
         new_work->type = WorkItem::Type::Ack;
         new_work->param_name = safe_param_id;
-        new_work->param_value = _all_params[safe_param_id];
+        new_work->param_value = _all_params->get(safe_param_id).value_or(ParamValue{});
         new_work->extended = true;
         _work_queue.push_back(new_work);
-        std::lock_guard<std::mutex> lock(_param_changed_subscriptions_mutex);
-
-        for (const auto& subscription : _param_changed_subscriptions) {
-            if (subscription.param_name != safe_param_id) {
-                continue;
-            }
-
-            if (!subscription.any_type &&
-                !subscription.value_type.is_same_type(new_work->param_value)) {
-                LogErr() << "Received wrong param type in subscription for "
-                         << subscription.param_name;
-                continue;
-            }
-
-            call_param_changed_callback(subscription.callback, new_work->param_value);
-        }
+        notify_param_subscriptions(safe_param_id, new_work->param_value);
     } else {
         LogWarn() << "Invalid Param Ext Set ID Request: " << safe_param_id;
     }
@@ -1348,7 +2026,28 @@ void MAVLinkParameters::receive_timeout()
         std::lock_guard<std::mutex> lock(_all_params_mutex);
         // first check if we are waiting for param list response
         if (_all_params_callback) {
-            _all_params_callback({});
+            // Nothing received at all, or no progress for a while.
+            if (_all_params_received.empty() || _all_params_retries_left == 0) {
+                LogWarn() << "Could not get all params";
+                Trace::instant("params", "get all: failed");
+                _all_params_hash.reset();
+                _all_params_callback({});
+                _all_params_callback = nullptr;
+                return;
+            }
+
+            // The outstanding requests or their responses got lost, so we
+            // start again from the first param missing.
+            --_all_params_retries_left;
+            Trace::instant("params", "get all: timeout", _all_params_retries_left);
+            _all_params_outstanding.clear();
+            _all_params_next_missing = 0;
+            request_missing_params();
+
+            _timeout_handler.add(
+                [this] { receive_timeout(); },
+                _timeout_s_callback(),
+                &_all_params_timeout_cookie);
             return;
         }
     }
@@ -1479,35 +2178,23 @@ void MAVLinkParameters::process_param_set(const mavlink_message_t& message)
                    << *(int32_t*)(&set_request.param_value);
 
         // Use the ID
-        if (_all_params.find(safe_param_id) != _all_params.end()) {
+        if (const auto old_value = _all_params->get(safe_param_id)) {
             ParamValue value{};
             if (!value.set_from_mavlink_param_set_bytewise(set_request)) {
                 LogWarn() << "Invalid Param Set Request: " << safe_param_id;
                 return;
             }
 
-            LogDebug() << "Changing param from " << _all_params[safe_param_id] << " to " << value;
-            _all_params[safe_param_id] = value;
+            LogDebug() << "Changing param from " << old_value.value() << " to " << value;
+            _all_params->set(safe_param_id, value);
 
             auto new_work = std::make_shared<WorkItem>(_timeout_s_callback());
             new_work->type = WorkItem::Type::Value;
             new_work->param_name = safe_param_id;
-            new_work->param_value = _all_params.at(safe_param_id);
+            new_work->param_value = value;
             new_work->extended = false;
             _work_queue.push_back(new_work);
-            std::lock_guard<std::mutex> lock(_param_changed_subscriptions_mutex);
-            for (const auto& subscription : _param_changed_subscriptions) {
-                if (subscription.param_name != safe_param_id) {
-                    continue;
-                }
-                if (!subscription.any_type && !subscription.value_type.is_same_type(value)) {
-                    LogErr() << "Received wrong param type in subscription for "
-                             << subscription.param_name;
-                    continue;
-                }
-
-                call_param_changed_callback(subscription.callback, value);
-            }
+            notify_param_subscriptions(safe_param_id, value);
         } else {
             LogDebug() << "Missing Param: " << safe_param_id << "(this: " << this << ")";
         }
@@ -1544,13 +2231,23 @@ void MAVLinkParameters::process_param_request_read(const mavlink_message_t& mess
         LogDebug() << "Request Param " << safe_param_id;
 
         // Use the ID
-        if (_all_params.find(safe_param_id) != _all_params.end()) {
+        if (const auto value = _all_params->get(safe_param_id)) {
             auto new_work = std::make_shared<WorkItem>(_timeout_s_callback());
             new_work->type = WorkItem::Type::Value;
             new_work->param_name = safe_param_id;
-            new_work->param_value = _all_params.at(safe_param_id);
+            new_work->param_value = value.value();
             new_work->extended = false;
             _work_queue.push_back(new_work);
+        } else if (safe_param_id == "_HASH_CHECK") {
+            std::lock_guard<std::mutex> lock(_all_params_mutex);
+            auto new_work = std::make_shared<WorkItem>(_timeout_s_callback());
+            new_work->type = WorkItem::Type::Value;
+            new_work->param_name = safe_param_id;
+            new_work->param_value.set(static_cast<int32_t>(_all_params->hash()));
+            new_work->extended = false;
+            new_work->param_count = static_cast<int>(_all_params->size());
+            new_work->param_index = std::numeric_limits<uint16_t>::max();
+            _work_queue.push_back(new_work);
         } else {
             LogDebug() << "Missing Param " << safe_param_id;
         }
@@ -1562,17 +2259,118 @@ void MAVLinkParameters::process_param_request_list(const mavlink_message_t& mess
     mavlink_param_request_list_t list_request{};
     mavlink_msg_param_request_list_decode(&message, &list_request);
 
-    auto idx = 0;
-    for (const auto& pair : _all_params) {
-        auto new_work = std::make_shared<WorkItem>(_timeout_s_callback());
-        new_work->type = WorkItem::Type::Value;
-        new_work->param_name = pair.first;
-        new_work->param_value = pair.second;
-        new_work->extended = false;
-        new_work->param_count = static_cast<int>(_all_params.size());
-        new_work->param_index = idx++;
-        _work_queue.push_back(new_work);
+    {
+        // Another request starts over.
+        std::lock_guard<std::mutex> lock(_list_stream_mutex);
+        _list_stream_next = 0;
+        _list_stream_budget_bytes = 0.0;
+        _list_stream_last_time = std::chrono::steady_clock::now() -
+                                 std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                     std::chrono::duration<double>(MAX_LIST_STREAM_BURST_S));
     }
+
+    // The first burst goes out right away, the rest on do_work.
+    stream_param_list();
+}
+
+void MAVLinkParameters::set_list_stream_rate(uint32_t bytes_per_s)
+{
+    std::lock_guard<std::mutex> lock(_list_stream_mutex);
+    _list_stream_bytes_per_s = bytes_per_s;
+}
+
+bool MAVLinkParameters::is_streaming_list()
+{
+    std::lock_guard<std::mutex> lock(_list_stream_mutex);
+    return _list_stream_next.has_value();
+}
+
+void MAVLinkParameters::stream_param_list()
+{
+    std::lock_guard<std::mutex> lock(_list_stream_mutex);
+
+    if (!_list_stream_next) {
+        return;
+    }
+
+    // Signing or trimming change it a bit, but this is close enough.
+    constexpr double frame_len = MAVLINK_MSG_ID_PARAM_VALUE_LEN + MAVLINK_NUM_NON_PAYLOAD_BYTES;
+
+    const bool paced = _list_stream_bytes_per_s > 0;
+    if (paced) {
+        const auto now = std::chrono::steady_clock::now();
+        const auto bytes_per_s = static_cast<double>(_list_stream_bytes_per_s);
+        const double elapsed_s =
+            std::chrono::duration<double>(now - _list_stream_last_time).count();
+        _list_stream_last_time = now;
+        _list_stream_budget_bytes = std::min(
+            _list_stream_budget_bytes + bytes_per_s * elapsed_s,
+            std::max(bytes_per_s * MAX_LIST_STREAM_BURST_S, frame_len));
+    }
+
+    std::lock_guard<std::mutex> params_lock(_all_params_mutex);
+
+    // Params added in the meantime are sent as well, as the count is the
+    // current one.
+    const auto param_count = static_cast<int>(_all_params->size());
+
+    size_t& next = _list_stream_next.value();
+    while (next <= _all_params->size()) {
+        if (paced && _list_stream_budget_bytes < frame_len) {
+            return;
+        }
+        _list_stream_budget_bytes -= frame_len;
+
+        mavlink_message_t message;
+        if (next < _all_params->size()) {
+            char param_id[PARAM_ID_LEN + 1] = {};
+            strncpy(param_id, _all_params->name_at(next).c_str(), sizeof(param_id) - 1);
+            pack_param_value(
+                message,
+                param_id,
+                _all_params->value_at(next),
+                param_count,
+                static_cast<int>(next));
+        } else {
+            // Like PX4, the hash comes last, so the list can be cached by it.
+            ParamValue hash;
+            hash.set(static_cast<int32_t>(_all_params->hash()));
+            char param_id[PARAM_ID_LEN + 1] = "_HASH_CHECK";
+            pack_param_value(
+                message, param_id, hash, param_count, std::numeric_limits<uint16_t>::max());
+        }
+
+        if (!_sender.send_message(message)) {
+            LogErr() << "Error: Send message failed";
+        }
+        ++next;
+    }
+
+    _list_stream_next.reset();
+}
+
+void MAVLinkParameters::pack_param_value(
+    mavlink_message_t& message,
+    const char* param_id,
+    const ParamValue& value,
+    int param_count,
+    int param_index)
+{
+    float param_value;
+    if (_sender.autopilot() == SystemImpl::Autopilot::ArduPilot) {
+        param_value = value.get_4_float_bytes_cast();
+    } else {
+        param_value = value.get_4_float_bytes_bytewise();
+    }
+    mavlink_msg_param_value_pack(
+        _sender.get_own_system_id(),
+        _sender.get_own_component_id(),
+        &message,
+        param_id,
+        param_value,
+        value.get_mav_param_type(),
+        param_count,
+        param_index);
 }
 
 void MAVLinkParameters::process_param_ext_request_read(const mavlink_message_t& message)
@@ -1586,11 +2384,11 @@ void MAVLinkParameters::process_param_ext_request_read(const mavlink_message_t&
         auto safe_param_id = extract_safe_param_id(read_request.param_id);
         LogDebug() << "Request Param " << safe_param_id;
         // Use the ID
-        if (_all_params.find(safe_param_id) != _all_params.end()) {
+        if (const auto value = _all_params->get(safe_param_id)) {
             auto new_work = std::make_shared<WorkItem>(_timeout_s_callback());
             new_work->type = WorkItem::Type::Value;
             new_work->param_name = safe_param_id;
-            new_work->param_value = _all_params.at(safe_param_id);
+            new_work->param_value = value.value();
             new_work->extended = true;
             _work_queue.push_back(new_work);
         } else {
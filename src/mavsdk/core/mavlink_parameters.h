@@ -4,6 +4,8 @@
 #include "mavlink_include.h"
 #include "timeout_s_callback.h"
 #include "locked_queue.h"
+#include "mavsdk_time.h"
+#include "state_store.h"
 #include <array>
 #include <cstddef>
 #include <cstdint>
@@ -12,7 +14,12 @@
 #include <cassert>
 #include <vector>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <optional>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
 #include <variant>
 
 namespace mavsdk {
@@ -20,6 +27,7 @@ namespace mavsdk {
 class Sender;
 class MavlinkMessageHandler;
 class TimeoutHandler;
+class ParamStore;
 
 // std::to_string doesn't work for std::string, so we need this workaround.
 template<typename T> std::string to_string(T&& value)
@@ -198,11 +206,67 @@ public:
         const SetParamCallback& callback,
         const void* cookie = nullptr);
 
+    // Sets several params, keeping up to max_in_flight PARAM_SETs outstanding
+    // instead of waiting for each echo before sending the next one. The
+    // results are in the same order as the params.
+    using SetParamsCallback = std::function<void(std::vector<Result> results)>;
+    static constexpr size_t DEFAULT_SET_PARAMS_IN_FLIGHT = 8;
+
+    std::vector<Result> set_params(
+        const std::vector<std::pair<std::string, ParamValue>>& params,
+        std::optional<uint8_t> maybe_component_id,
+        size_t max_in_flight = DEFAULT_SET_PARAMS_IN_FLIGHT);
+
+    void set_params_async(
+        const std::vector<std::pair<std::string, ParamValue>>& params,
+        const SetParamsCallback& callback,
+        std::optional<uint8_t> maybe_component_id,
+        size_t max_in_flight = DEFAULT_SET_PARAMS_IN_FLIGHT);
+
+    // The same params can be shared, e.g. by all systems of a fleet, instead
+    // of being copied for each of them.
+    using SharedParams = std::shared_ptr<const std::vector<std::pair<std::string, ParamValue>>>;
+
+    void set_params_async(
+        SharedParams params,
+        const SetParamsCallback& callback,
+        std::optional<uint8_t> maybe_component_id,
+        size_t max_in_flight = DEFAULT_SET_PARAMS_IN_FLIGHT);
+
+    // Gets several params, keeping up to max_in_flight requests outstanding
+    // instead of waiting for each value before requesting the next one. The
+    // params are given with their expected type, and the results are in the
+    // same order.
+    using GetParamsCallback =
+        std::function<void(std::vector<std::pair<Result, ParamValue>> results)>;
+    static constexpr size_t DEFAULT_GET_PARAMS_IN_FLIGHT = 8;
+
+    void get_params_async(
+        const std::vector<std::pair<std::string, ParamValue>>& params,
+        const GetParamsCallback& callback,
+        std::optional<uint8_t> maybe_component_id,
+        bool extended = false,
+        size_t max_in_flight = DEFAULT_GET_PARAMS_IN_FLIGHT);
+
+    void get_params_async(
+        SharedParams params,
+        const GetParamsCallback& callback,
+        std::optional<uint8_t> maybe_component_id,
+        bool extended = false,
+        size_t max_in_flight = DEFAULT_GET_PARAMS_IN_FLIGHT);
+
     // Result provide_server_param(const std::string& name, const ParamValue& value);
     Result provide_server_param_float(const std::string& name, float value);
     Result provide_server_param_int(const std::string& name, int value);
     Result provide_server_param_custom(const std::string& name, const std::string& value);
+    // All at once, e.g. at startup, which only sorts them once. Nothing is
+    // provided if any of them is too long.
+    Result
+    provide_server_params(const std::vector<std::pair<std::string, ParamValue>>& params);
     std::map<std::string, MAVLinkParameters::ParamValue> retrieve_all_server_params();
+    // Without copying them first. The visitor must not call back into this.
+    void for_each_server_param(
+        const std::function<void(const std::string&, const ParamValue&)>& visitor);
 
     std::pair<Result, ParamValue>
     retrieve_server_param(const std::string& name, ParamValue value_type);
@@ -259,6 +323,21 @@ public:
         std::function<void(std::map<std::string, MAVLinkParameters::ParamValue>)>;
     void get_all_params_async(const GetAllParamsCallback& callback);
 
+    // If set, all params of a PX4 autopilot are stored in this entry, and
+    // only downloaded again if its _HASH_CHECK changed. No store disables it.
+    void set_cache(StateStoreKey cache);
+
+    // If set, all params are downloaded at once as param.pck instead, e.g.
+    // over MAVLink FTP. PARAM_REQUEST_LIST is used if that fails, in which
+    // case nothing is passed to the callback.
+    using BulkDownloadCallback = std::function<void(std::optional<std::vector<uint8_t>> data)>;
+    using BulkDownloadFunction = std::function<void(const BulkDownloadCallback& callback)>;
+    void set_bulk_download_function(BulkDownloadFunction bulk_download_function);
+
+    // Server only: how fast the param list is streamed when requested, in
+    // bytes per second. 0 sends the whole list at once.
+    void set_list_stream_rate(uint32_t bytes_per_s);
+
     using ParamFloatChangedCallback = std::function<void(float value)>;
     void subscribe_param_float_changed(
         const std::string& name, const ParamFloatChangedCallback& callback, const void* cookie);
@@ -273,7 +352,17 @@ public:
 
     void cancel_all_param(const void* cookie);
 
+    // Bytes held by the params received, and by the transfers not done yet.
+    [[nodiscard]] size_t param_store_memory_usage();
+    [[nodiscard]] size_t work_queue_memory_usage();
+
     void do_work();
+    // Server only: whether a requested list is still being sent.
+    [[nodiscard]] bool is_streaming_list();
+    void set_work_notifier(std::function<void()> notifier)
+    {
+        _work_queue.set_notifier(std::move(notifier));
+    }
 
     friend std::ostream& operator<<(std::ostream&, const ParamValue&);
 
@@ -294,7 +383,83 @@ private:
     void process_param_ext_ack(const mavlink_message_t& message);
     void receive_timeout();
 
+    // The cache is only saved if a hash is given.
+    void download_all_params(
+        const GetAllParamsCallback& callback,
+        const StateStoreKey& cache,
+        std::optional<uint32_t> hash);
+
+    // Needs _all_params_mutex.
+    void mark_param_received(uint16_t param_index, uint16_t param_count);
+    void request_missing_params();
+
+    // Needs _all_params_mutex.
+    void request_all_params(
+        const GetAllParamsCallback& callback,
+        const StateStoreKey& cache,
+        std::optional<uint32_t> hash);
+
     void notify_param_subscriptions(const mavlink_param_value_t& param_value);
+    void notify_param_subscriptions(const std::string& name, const ParamValue& value);
+
+    void pack_param_set(
+        mavlink_message_t& message,
+        const char* param_id,
+        const ParamValue& value,
+        uint8_t component_id);
+
+    // Sent, but not answered yet.
+    struct InFlight {
+        size_t index;
+        int retries_left;
+    };
+
+    struct ParamsSet {
+        SharedParams params{};
+        std::vector<std::optional<Result>> results{};
+        SetParamsCallback callback{};
+        uint8_t component_id{MAV_COMP_ID_AUTOPILOT1};
+        size_t max_in_flight{1};
+        size_t next_to_send{0};
+        size_t num_done{0};
+        std::vector<InFlight> in_flight{};
+        void* timeout_cookie{nullptr};
+    };
+
+    // Need _params_sets_mutex.
+    void send_params(ParamsSet& params_set);
+    void refresh_params_set_timeout(ParamsSet& params_set);
+    std::vector<std::shared_ptr<ParamsSet>> take_finished_params_sets();
+
+    void process_params_set_echo(const std::string& param_id);
+    void params_set_timeout(const ParamsSet* params_set);
+    static void call_params_set_callbacks(const std::vector<std::shared_ptr<ParamsSet>>& finished);
+
+    struct ParamsGet {
+        SharedParams params{};
+        std::vector<std::optional<std::pair<Result, ParamValue>>> results{};
+        GetParamsCallback callback{};
+        uint8_t component_id{MAV_COMP_ID_AUTOPILOT1};
+        bool extended{false};
+        size_t max_in_flight{1};
+        size_t next_to_send{0};
+        size_t num_done{0};
+        std::vector<InFlight> in_flight{};
+        void* timeout_cookie{nullptr};
+    };
+
+    // Need _params_gets_mutex.
+    void send_param_requests(ParamsGet& params_get);
+    void refresh_params_get_timeout(ParamsGet& params_get);
+    std::vector<std::shared_ptr<ParamsGet>> take_finished_params_gets();
+
+    void process_params_get_value(
+        const std::string& param_id, const ParamValue& value, uint8_t component_id, bool extended);
+    void params_get_timeout(const ParamsGet* params_get);
+    static void call_params_get_callbacks(const std::vector<std::shared_ptr<ParamsGet>>& finished);
+
+    void pack_param_request_read(
+        mavlink_message_t& message, const char* param_id, uint8_t component_id, bool extended);
 
     static std::string extract_safe_param_id(const char param_id[]);
 
@@ -345,13 +510,58 @@ private:
         const void* cookie{nullptr};
     };
 
+    // Names as they are sent, zero padded, so the subscriptions of a param
+    // can be looked up straight from the message, without making a string.
+    using ParamName = std::array<char, 16>;
+    struct ParamNameHash {
+        size_t operator()(const ParamName& name) const
+        {
+            return std::hash<std::string_view>{}(std::string_view(name.data(), name.size()));
+        }
+    };
+    static ParamName param_name_from(const char* param_id, size_t max_len);
+
+    void add_param_changed_subscription(
+        const std::string& name,
+        const ParamChangedCallbacks& callback,
+        const ParamValue& value_type,
+        const void* cookie);
+    void remove_param_changed_subscription(const std::string& name, const void* cookie);
+
+    // Needs _param_changed_subscriptions_mutex.
+    void call_param_changed_callbacks(
+        const std::vector<ParamChangedSubscription>& subscriptions, const ParamValue& value);
+
+    std::mutex _params_sets_mutex{};
+    std::vector<std::shared_ptr<ParamsSet>> _params_sets{}; // Needs _params_sets_mutex
+
+    std::mutex _params_gets_mutex{};
+    std::vector<std::shared_ptr<ParamsGet>> _params_gets{}; // Needs _params_gets_mutex
+
     std::mutex _param_changed_subscriptions_mutex{};
-    std::vector<ParamChangedSubscription> _param_changed_subscriptions{};
+    // Needs _param_changed_subscriptions_mutex
+    std::unordered_map<ParamName, std::vector<ParamChangedSubscription>, ParamNameHash>
+        _param_changed_subscriptions{};
 
     std::mutex _all_params_mutex{};
     GetAllParamsCallback _all_params_callback;
     void* _all_params_timeout_cookie{nullptr};
-    std::map<std::string, ParamValue> _all_params{};
+    std::unique_ptr<ParamStore> _all_params;
+    StateStoreKey _cache{}; // Needs _all_params_mutex
+    StateStoreKey _all_params_cache{}; // Needs _all_params_mutex
+    std::optional<uint32_t> _all_params_hash{}; // Needs _all_params_mutex
+    BulkDownloadFunction _bulk_download_function{}; // Needs _all_params_mutex
+
+    // Which params of the list have been received so far, by index.
+    std::vector<bool> _all_params_received{}; // Needs _all_params_mutex
+    size_t _all_params_num_received{0}; // Needs _all_params_mutex
+    // Missing params requested, and where to continue looking for more.
+    std::vector<uint16_t> _all_params_outstanding{}; // Needs _all_params_mutex
+    size_t _all_params_next_missing{0}; // Needs _all_params_mutex
+    // Timeouts without receiving any new param, until we give up.
+    unsigned _all_params_retries_left{0}; // Needs _all_params_mutex
+    static constexpr unsigned MAX_ALL_PARAMS_RETRIES = 3;
+    static constexpr size_t MAX_OUTSTANDING_PARAM_REQUESTS = 8;
 
     bool _is_server;
 
@@ -359,6 +569,26 @@ private:
     void process_param_ext_request_read(const mavlink_message_t& message);
     void process_param_request_list(const mavlink_message_t& message);
 
+    void pack_param_value(
+        mavlink_message_t& message,
+        const char* param_id,
+        const ParamValue& value,
+        int param_count,
+        int param_index);
+
+    // Server side, a requested list is sent from a cursor on every do_work,
+    // as far as the budget of bytes allows.
+    void stream_param_list();
+
+    std::mutex _list_stream_mutex{};
+    std::optional<size_t> _list_stream_next{}; // Needs _list_stream_mutex
+    uint32_t _list_stream_bytes_per_s{DEFAULT_LIST_STREAM_BYTES_PER_S}; // Needs _list_stream_mutex
+    double _list_stream_budget_bytes{0.0}; // Needs _list_stream_mutex
+    SteadyTimePoint _list_stream_last_time{}; // Needs _list_stream_mutex
+    static constexpr uint32_t DEFAULT_LIST_STREAM_BYTES_PER_S = 10000;
+    // Budget not used is kept for at most this long, to keep bursts short.
+    static constexpr double MAX_LIST_STREAM_BURST_S = 0.05;
+
     bool _parameter_debugging{false};
 };
 
@@ -1,10 +1,11 @@
 #include "mavlink_receiver.h"
 #include "log.h"
+#include <cstring>
 #include <iomanip>
 
 namespace mavsdk {
 
-MavlinkReceiver::MavlinkReceiver(uint8_t channel) : _channel(channel)
+MavlinkReceiver::MavlinkReceiver()
 {
     if (const char* env_p = std::getenv("MAVSDK_DROP_DEBUGGING")) {
         if (std::string(env_p) == "1") {
@@ -14,10 +15,12 @@ MavlinkReceiver::MavlinkReceiver(uint8_t channel) : _channel(channel)
     }
 }
 
-void MavlinkReceiver::set_new_datagram(char* datagram, unsigned datagram_len)
+void MavlinkReceiver::set_new_datagram(
+    char* datagram, unsigned datagram_len, int64_t receive_time_ns)
 {
     _datagram = datagram;
     _datagram_len = datagram_len;
+    _receive_time_ns = receive_time_ns;
 
     if (_drop_debugging_on) {
         _drop_stats.bytes_received += _datagram_len;
@@ -26,19 +29,38 @@ void MavlinkReceiver::set_new_datagram(char* datagram, unsigned datagram_len)
 
 bool MavlinkReceiver::parse_message()
 {
+    // If the last message is still used somewhere, we need a new buffer.
+    if (!_last_message.unique()) {
+        _last_message = _message_pool.acquire();
+    }
+
     // Note that one datagram can contain multiple mavlink messages.
     for (unsigned i = 0; i < _datagram_len; ++i) {
-        if (mavlink_parse_char(_channel, _datagram[i], &_last_message, &_status) == 1) {
-            // Move the pointer to the datagram forward by the amount parsed.
-            _datagram += (i + 1);
-            // And decrease the length, so we don't overshoot in the next round.
-            _datagram_len -= (i + 1);
-
-            if (_drop_debugging_on) {
-                debug_drop_rate();
+        const uint8_t c = static_cast<uint8_t>(_datagram[i]);
+
+        if (parser_idle()) {
+            // In between frames everything but a start marker is ignored
+            // anyway, so we don't need to feed it to the parser.
+            if (c != MAVLINK_STX && c != MAVLINK_STX_MAVLINK1) {
+                continue;
             }
 
-            // We have parsed one message, let's return, so it can be handled.
+            // If the whole frame is in the datagram, we can parse it in one go.
+            const unsigned frame_len = parse_complete_frame(
+                reinterpret_cast<const uint8_t*>(&_datagram[i]), _datagram_len - i);
+            if (frame_len > 0) {
+                consume_and_handle(i + frame_len);
+                return true;
+            }
+        }
+
+        // Otherwise, e.g. if a frame is split between reads, is signed, or
+        // is broken, we go byte by byte.
+        const bool parsed = parse_char(c) == MAVLINK_FRAMING_OK;
+        // The parser only reports the errors of the current byte.
+        _parse_errors += _status.packet_rx_drop_count;
+        if (parsed) {
+            consume_and_handle(i + 1);
             return true;
         }
     }
@@ -49,15 +71,161 @@ bool MavlinkReceiver::parse_message()
     return false;
 }
 
+void MavlinkReceiver::consume_and_handle(unsigned len)
+{
+    // Move the pointer to the datagram forward by the amount parsed.
+    _datagram += len;
+    // And decrease the length, so we don't overshoot in the next round.
+    _datagram_len -= len;
+
+    // A message split between reads is only received with the last one.
+    _last_message.set_receive_time_ns(_receive_time_ns);
+
+    if (_drop_debugging_on) {
+        debug_drop_rate();
+    }
+}
+
+uint8_t MavlinkReceiver::parse_char(uint8_t c)
+{
+    // This is what mavlink_parse_char does, except that it uses the parser
+    // state of a global channel instead of ours.
+    const uint8_t msg_received = mavlink_frame_char_buffer(
+        &_rx_buffer, &_rx_status, c, &_last_message.mutable_message(), &_status);
+
+    if (msg_received == MAVLINK_FRAMING_BAD_CRC || msg_received == MAVLINK_FRAMING_BAD_SIGNATURE) {
+        // Treat it as a parse error, and start over.
+        _rx_status.parse_error++;
+        _rx_status.msg_received = MAVLINK_FRAMING_INCOMPLETE;
+        _rx_status.parse_state = MAVLINK_PARSE_STATE_IDLE;
+        if (c == MAVLINK_STX) {
+            _rx_status.parse_state = MAVLINK_PARSE_STATE_GOT_STX;
+            _rx_buffer.len = 0;
+            mavlink_start_checksum(&_rx_buffer);
+        }
+        return MAVLINK_FRAMING_INCOMPLETE;
+    }
+
+    return msg_received;
+}
+
+bool MavlinkReceiver::parser_idle() const
+{
+    const auto parse_state = _rx_status.parse_state;
+    return parse_state == MAVLINK_PARSE_STATE_UNINIT || parse_state == MAVLINK_PARSE_STATE_IDLE;
+}
+
+unsigned MavlinkReceiver::parse_complete_frame(const uint8_t* data, unsigned len)
+{
+    const bool is_v1 = (data[0] == MAVLINK_STX_MAVLINK1);
+    const unsigned header_len =
+        is_v1 ? MAVLINK_CORE_HEADER_MAVLINK1_LEN + 1 : MAVLINK_CORE_HEADER_LEN + 1;
+
+    if (len < header_len) {
+        return 0;
+    }
+
+    const uint8_t payload_len = data[1];
+    const uint8_t incompat_flags = is_v1 ? 0 : data[2];
+    const uint8_t compat_flags = is_v1 ? 0 : data[3];
+
+    // Unknown flags take the slow path. Signatures are only copied, they are
+    // verified later, if signing is enabled.
+    if ((incompat_flags & ~MAVLINK_IFLAG_SIGNED) != 0) {
+        return 0;
+    }
+    const unsigned signature_len =
+        (incompat_flags & MAVLINK_IFLAG_SIGNED) != 0 ? MAVLINK_SIGNATURE_BLOCK_LEN : 0;
+
+    const unsigned frame_len =
+        header_len + payload_len + MAVLINK_NUM_CHECKSUM_BYTES + signature_len;
+    if (len < frame_len) {
+        return 0;
+    }
+
+    const uint8_t seq = is_v1 ? data[2] : data[4];
+    const uint8_t sysid = is_v1 ? data[3] : data[5];
+    const uint8_t compid = is_v1 ? data[4] : data[6];
+    const uint32_t msgid =
+        is_v1 ? data[5] :
+                (uint32_t(data[7]) | (uint32_t(data[8]) << 8) | (uint32_t(data[9]) << 16));
+
+    // Without knowing the message, we can't check the CRC extra, so we let
+    // the byte parser decide what to do with it.
+    const mavlink_msg_entry_t* entry = mavlink_get_msg_entry(msgid);
+    if (entry == nullptr) {
+        return 0;
+    }
+
+    // The checksum covers everything but the start marker.
+    uint16_t checksum = crc_calculate(&data[1], header_len - 1 + payload_len);
+    crc_accumulate(entry->crc_extra, &checksum);
+
+    const uint8_t* ck = &data[header_len + payload_len];
+    if (ck[0] != (checksum & 0xFF) || ck[1] != (checksum >> 8)) {
+        // Let the byte parser deal with the broken frame, so the error
+        // counters stay correct.
+        return 0;
+    }
+
+    mavlink_message_t& message = _last_message.mutable_message();
+    message.magic = data[0];
+    message.len = payload_len;
+    message.incompat_flags = incompat_flags;
+    message.compat_flags = compat_flags;
+    message.seq = seq;
+    message.sysid = sysid;
+    message.compid = compid;
+    message.msgid = msgid;
+    message.checksum = checksum;
+    message.ck[0] = ck[0];
+    message.ck[1] = ck[1];
+    if (signature_len > 0) {
+        memcpy(message.signature, &ck[MAVLINK_NUM_CHECKSUM_BYTES], signature_len);
+    }
+
+    auto* payload = reinterpret_cast<uint8_t*>(_MAV_PAYLOAD_NON_CONST(&message));
+    memcpy(payload, &data[header_len], payload_len);
+    if (payload_len < entry->max_msg_len) {
+        // Zero-fill the payload to cope with truncated messages.
+        memset(&payload[payload_len], 0, entry->max_msg_len - payload_len);
+    }
+
+    // Keep the parser status like the byte parser would.
+    if (is_v1) {
+        _rx_status.flags |= MAVLINK_STATUS_FLAG_IN_MAVLINK1;
+    } else {
+        _rx_status.flags &= ~MAVLINK_STATUS_FLAG_IN_MAVLINK1;
+    }
+    _rx_status.msg_received = MAVLINK_FRAMING_OK;
+    _rx_status.parse_state = MAVLINK_PARSE_STATE_IDLE;
+    _rx_status.packet_idx = 0;
+    _rx_status.current_rx_seq = seq;
+    if (_rx_status.packet_rx_success_count == 0) {
+        _rx_status.packet_rx_drop_count = 0;
+    }
+    _rx_status.packet_rx_success_count++;
+
+    _status.parse_state = _rx_status.parse_state;
+    _status.packet_idx = _rx_status.packet_idx;
+    _status.current_rx_seq = _rx_status.current_rx_seq + 1;
+    _status.packet_rx_success_count = _rx_status.packet_rx_success_count;
+    _status.packet_rx_drop_count = _rx_status.parse_error;
+    _status.flags = _rx_status.flags;
+    _rx_status.parse_error = 0;
+
+    return frame_len;
+}
+
 void MavlinkReceiver::debug_drop_rate()
 {
-    if (_last_message.msgid == MAVLINK_MSG_ID_SYS_STATUS) {
-        const unsigned msg_len = (_last_message.len + MAVLINK_NUM_NON_PAYLOAD_BYTES);
+    if (_last_message->msgid == MAVLINK_MSG_ID_SYS_STATUS) {
+        const unsigned msg_len = (_last_message->len + MAVLINK_NUM_NON_PAYLOAD_BYTES);
 
         _drop_stats.bytes_received -= msg_len;
 
         mavlink_sys_status_t sys_status;
-        mavlink_msg_sys_status_decode(&_last_message, &sys_status);
+        mavlink_msg_sys_status_decode(&*_last_message, &sys_status);
 
         if (!_drop_stats.first) {
             LogDebug() << "-------------------------------------------------------------------"
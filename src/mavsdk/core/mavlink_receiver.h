@@ -1,6 +1,7 @@
 #pragma once
 
 #include "mavlink_include.h"
+#include "mavlink_message_buffer.h"
 #include "mavsdk_time.h"
 #include <cstdint>
 
@@ -8,18 +9,37 @@ namespace mavsdk {
 
 class MavlinkReceiver {
 public:
-    explicit MavlinkReceiver(uint8_t channel);
+    // The parser state is kept here rather than in one of the global MAVLink
+    // channels, so there is no limit on the number of receivers.
+    MavlinkReceiver();
 
-    [[nodiscard]] uint8_t get_channel() const { return _channel; }
+    mavlink_message_t& get_last_message() { return _last_message.mutable_message(); }
 
-    mavlink_message_t& get_last_message() { return _last_message; }
+    // The buffer holding the last message, it is only reused for the next
+    // message if it is not held anywhere else.
+    const MavlinkMessageBuffer& get_last_message_buffer() const { return _last_message; }
 
     mavlink_status_t& get_status() { return _status; }
 
-    void set_new_datagram(char* datagram, unsigned datagram_len);
+    size_t memory_usage() const { return sizeof(*this) + _message_pool.memory_usage(); }
 
+    // The receive time in ns since the epoch is given to the messages
+    // completed by the datagram, 0 if unknown.
+    void set_new_datagram(char* datagram, unsigned datagram_len, int64_t receive_time_ns = 0);
+
+    // Frames which are completely inside the datagram are parsed in one go,
+    // everything else is fed byte by byte to the MAVLink parser.
     bool parse_message();
 
+    // Returns the number of parse errors, e.g. bad checksums, since the
+    // previous call.
+    unsigned take_parse_errors()
+    {
+        const unsigned parse_errors = _parse_errors;
+        _parse_errors = 0;
+        return parse_errors;
+    }
+
     void debug_drop_rate();
     void print_line(
         const char* index,
@@ -29,11 +49,24 @@ public:
         uint64_t overall_bytes_total);
 
 private:
-    uint8_t _channel;
-    mavlink_message_t _last_message = {};
+    uint8_t parse_char(uint8_t c);
+    bool parser_idle() const;
+    // Returns the length of the frame parsed, or 0 if it needs to go the
+    // slow way.
+    unsigned parse_complete_frame(const uint8_t* data, unsigned len);
+    void consume_and_handle(unsigned len);
+
+    // State of the byte parser.
+    mavlink_message_t _rx_buffer = {};
+    mavlink_status_t _rx_status = {};
+
+    MavlinkMessagePool _message_pool{};
+    MavlinkMessageBuffer _last_message{};
     mavlink_status_t _status = {};
     char* _datagram = nullptr;
     unsigned _datagram_len = 0;
+    int64_t _receive_time_ns = 0;
+    unsigned _parse_errors = 0;
 
     Time _time{};
 
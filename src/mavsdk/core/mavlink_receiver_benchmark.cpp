@@ -0,0 +1,41 @@
+#include "mavlink_receiver.h"
+#include <benchmark/benchmark.h>
+#include <vector>
+
+using namespace mavsdk;
+
+namespace {
+
+std::vector<char> make_datagram(unsigned num_messages)
+{
+    std::vector<char> datagram;
+    for (unsigned i = 0; i < num_messages; ++i) {
+        mavlink_message_t message;
+        mavlink_msg_attitude_pack(1, 1, &message, i, 0.1f, 0.2f, 0.3f, 0.01f, 0.02f, 0.03f);
+
+        uint8_t bytes[MAVLINK_MAX_PACKET_LEN];
+        const auto len = mavlink_msg_to_send_buffer(bytes, &message);
+        datagram.insert(datagram.end(), bytes, bytes + len);
+    }
+    return datagram;
+}
+
+} // namespace
+
+static void BM_MavlinkReceiverParseMessage(benchmark::State& state)
+{
+    const auto num_messages = static_cast<unsigned>(state.range(0));
+    auto datagram = make_datagram(num_messages);
+    MavlinkReceiver receiver;
+
+    for (auto _ : state) {
+        receiver.set_new_datagram(datagram.data(), static_cast<unsigned>(datagram.size()));
+        while (receiver.parse_message()) {
+            benchmark::DoNotOptimize(receiver.get_last_message());
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * num_messages);
+    state.SetBytesProcessed(state.iterations() * datagram.size());
+}
+BENCHMARK(BM_MavlinkReceiverParseMessage)->Arg(1)->Arg(10)->Arg(30);
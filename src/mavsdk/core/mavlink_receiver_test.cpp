@@ -0,0 +1,146 @@
+#include "mavlink_receiver.h"
+#include <gtest/gtest.h>
+#include <vector>
+
+using namespace mavsdk;
+
+namespace {
+
+void append_heartbeat(std::vector<char>& buffer, uint8_t sysid, uint8_t base_mode)
+{
+    mavlink_message_t message;
+    mavlink_msg_heartbeat_pack(
+        sysid,
+        MAV_COMP_ID_AUTOPILOT1,
+        &message,
+        MAV_TYPE_QUADROTOR,
+        MAV_AUTOPILOT_PX4,
+        base_mode,
+        0,
+        MAV_STATE_ACTIVE);
+
+    uint8_t bytes[MAVLINK_MAX_PACKET_LEN];
+    const auto len = mavlink_msg_to_send_buffer(bytes, &message);
+    buffer.insert(buffer.end(), bytes, bytes + len);
+}
+
+std::vector<uint8_t> parse_all(MavlinkReceiver& receiver, std::vector<char>& buffer)
+{
+    std::vector<uint8_t> sysids;
+    receiver.set_new_datagram(buffer.data(), static_cast<unsigned>(buffer.size()));
+    while (receiver.parse_message()) {
+        EXPECT_EQ(receiver.get_last_message().msgid, MAVLINK_MSG_ID_HEARTBEAT);
+        sysids.push_back(receiver.get_last_message().sysid);
+    }
+    return sysids;
+}
+
+} // namespace
+
+TEST(MavlinkReceiver, ParsesSeveralFramesInOneDatagram)
+{
+    MavlinkReceiver receiver;
+
+    std::vector<char> buffer;
+    append_heartbeat(buffer, 1, MAV_MODE_FLAG_SAFETY_ARMED);
+    buffer.push_back(42); // Some garbage in between.
+    append_heartbeat(buffer, 2, 0);
+    append_heartbeat(buffer, 3, 0);
+
+    EXPECT_EQ(parse_all(receiver, buffer), (std::vector<uint8_t>{1, 2, 3}));
+}
+
+TEST(MavlinkReceiver, DecodesPayload)
+{
+    MavlinkReceiver receiver;
+
+    std::vector<char> buffer;
+    append_heartbeat(buffer, 1, MAV_MODE_FLAG_SAFETY_ARMED);
+
+    receiver.set_new_datagram(buffer.data(), static_cast<unsigned>(buffer.size()));
+    ASSERT_TRUE(receiver.parse_message());
+
+    mavlink_heartbeat_t heartbeat;
+    mavlink_msg_heartbeat_decode(&receiver.get_last_message(), &heartbeat);
+    EXPECT_EQ(heartbeat.type, MAV_TYPE_QUADROTOR);
+    EXPECT_EQ(heartbeat.autopilot, MAV_AUTOPILOT_PX4);
+    EXPECT_EQ(heartbeat.base_mode, MAV_MODE_FLAG_SAFETY_ARMED);
+    EXPECT_EQ(heartbeat.system_status, MAV_STATE_ACTIVE);
+
+    EXPECT_FALSE(receiver.parse_message());
+}
+
+TEST(MavlinkReceiver, ParsesFrameSplitBetweenDatagrams)
+{
+    MavlinkReceiver receiver;
+
+    std::vector<char> buffer;
+    append_heartbeat(buffer, 1, 0);
+    append_heartbeat(buffer, 2, 0);
+    append_heartbeat(buffer, 3, 0);
+
+    // Cut in the middle of the second frame.
+    const auto split = buffer.size() / 2;
+    std::vector<char> first(buffer.begin(), buffer.begin() + split);
+    std::vector<char> second(buffer.begin() + split, buffer.end());
+
+    EXPECT_EQ(parse_all(receiver, first), (std::vector<uint8_t>{1}));
+    EXPECT_EQ(parse_all(receiver, second), (std::vector<uint8_t>{2, 3}));
+}
+
+TEST(MavlinkReceiver, StampsMessagesWithReceiveTimeOfLastPart)
+{
+    MavlinkReceiver receiver;
+
+    std::vector<char> buffer;
+    append_heartbeat(buffer, 1, 0);
+    append_heartbeat(buffer, 2, 0);
+
+    const auto split = buffer.size() * 3 / 4;
+    std::vector<char> first(buffer.begin(), buffer.begin() + split);
+    std::vector<char> second(buffer.begin() + split, buffer.end());
+
+    receiver.set_new_datagram(first.data(), static_cast<unsigned>(first.size()), 1000);
+    ASSERT_TRUE(receiver.parse_message());
+    EXPECT_EQ(receiver.get_last_message_buffer().receive_time_ns(), 1000);
+    ASSERT_FALSE(receiver.parse_message());
+
+    receiver.set_new_datagram(second.data(), static_cast<unsigned>(second.size()), 2000);
+    ASSERT_TRUE(receiver.parse_message());
+    EXPECT_EQ(receiver.get_last_message().sysid, 2);
+    EXPECT_EQ(receiver.get_last_message_buffer().receive_time_ns(), 2000);
+}
+
+TEST(MavlinkReceiver, SkipsFrameWithBadChecksum)
+{
+    MavlinkReceiver receiver;
+
+    std::vector<char> buffer;
+    append_heartbeat(buffer, 1, 0);
+    // Break the checksum of the first frame.
+    buffer.back() = static_cast<char>(buffer.back() ^ 0xFF);
+    append_heartbeat(buffer, 2, 0);
+
+    EXPECT_EQ(parse_all(receiver, buffer), (std::vector<uint8_t>{2}));
+}
+
+TEST(MavlinkReceiver, ManyReceiversKeepTheirOwnParserState)
+{
+    // More receivers than there are MAVLink channels, all in the middle of
+    // a frame at the same time.
+    std::vector<MavlinkReceiver> receivers(300);
+
+    std::vector<char> buffer;
+    append_heartbeat(buffer, 1, 0);
+
+    const auto split = buffer.size() / 2;
+    std::vector<char> first(buffer.begin(), buffer.begin() + split);
+    std::vector<char> second(buffer.begin() + split, buffer.end());
+
+    for (auto& receiver : receivers) {
+        EXPECT_TRUE(parse_all(receiver, first).empty());
+    }
+    for (auto& receiver : receivers) {
+        EXPECT_EQ(parse_all(receiver, second), (std::vector<uint8_t>{1}));
+    }
+}
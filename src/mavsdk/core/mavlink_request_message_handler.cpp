@@ -3,6 +3,7 @@
 #include "server_component_impl.h"
 #include "mavlink_command_receiver.h"
 #include "log.h"
+#include <cmath>
 
 namespace mavsdk {
 
@@ -32,14 +33,14 @@ bool MavlinkRequestMessageHandler::register_handler(
 {
     std::lock_guard<std::mutex> lock(_table_mutex);
 
-    if (std::find_if(_table.begin(), _table.end(), [message_id](const Entry& entry) {
-            return entry.message_id == message_id;
-        }) != _table.end()) {
+    if (_table->count(message_id) != 0) {
         LogErr() << "message id " << message_id << " already registered, registration ignored";
         return false;
     }
 
-    _table.emplace_back(Entry{message_id, callback, cookie});
+    auto new_table = std::make_shared<Table>(*_table);
+    new_table->emplace(message_id, Entry{message_id, callback, cookie});
+    set_table(std::move(new_table));
     return true;
 }
 
@@ -47,85 +48,94 @@ void MavlinkRequestMessageHandler::unregister_handler(uint32_t message_id, const
 {
     std::lock_guard<std::mutex> lock(_table_mutex);
 
-    _table.erase(
-        std::remove_if(
-            _table.begin(),
-            _table.end(),
-            [&message_id, &cookie](const Entry& entry) {
-                return entry.message_id == message_id && entry.cookie == cookie;
-            }),
-        _table.end());
+    const auto it = _table->find(message_id);
+    if (it == _table->end() || it->second.cookie != cookie) {
+        return;
+    }
+
+    auto new_table = std::make_shared<Table>(*_table);
+    new_table->erase(message_id);
+    set_table(std::move(new_table));
 }
 
 void MavlinkRequestMessageHandler::unregister_all_handlers(const void* cookie)
 {
     std::lock_guard<std::mutex> lock(_table_mutex);
 
-    _table.erase(
-        std::remove_if(
-            _table.begin(),
-            _table.end(),
-            [&cookie](const Entry& entry) { return entry.cookie == cookie; }),
-        _table.end());
+    auto new_table = std::make_shared<Table>();
+    for (const auto& [message_id, entry] : *_table) {
+        if (entry.cookie != cookie) {
+            new_table->emplace(message_id, entry);
+        }
+    }
+    set_table(std::move(new_table));
 }
 
-std::optional<mavlink_message_t> MavlinkRequestMessageHandler::handle_command_long(
-    const MavlinkCommandReceiver::CommandLong& command)
+void MavlinkRequestMessageHandler::set_table(std::shared_ptr<const Table> table)
 {
-    std::lock_guard<std::mutex> lock(_table_mutex);
+    // Needs _table_mutex
+    std::atomic_store_explicit(&_table, std::move(table), std::memory_order_release);
+}
 
-    for (auto& entry : _table) {
-        if (entry.message_id == static_cast<uint32_t>(std::round(command.params.param1))) {
-            if (entry.callback != nullptr) {
-                const auto result = entry.callback(
-                    command.origin_system_id,
-                    command.origin_component_id,
-                    {command.params.param2,
-                     command.params.param3,
-                     command.params.param4,
-                     command.params.param5,
-                     command.params.param6});
-
-                if (result.has_value()) {
-                    return _server_component_impl.make_command_ack_message(command, result.value());
-                }
-            }
-            return {};
-        }
+std::optional<mavlink_message_t> MavlinkRequestMessageHandler::handle_request(
+    uint32_t message_id,
+    uint8_t origin_system_id,
+    uint8_t origin_component_id,
+    const Params& params,
+    const std::function<mavlink_message_t(MAV_RESULT)>& make_ack)
+{
+    // We hold on to the table we got, so the entry stays valid even if
+    // handlers are changed while we call it.
+    const auto table = std::atomic_load_explicit(&_table, std::memory_order_acquire);
+
+    const auto it = table->find(message_id);
+    if (it == table->end()) {
+        // We could respond with MAV_RESULT_UNSUPPORTED here, however, it's not clear if maybe
+        // someone else might be answering the command.
+        return {};
     }
 
-    // We could respond with MAV_RESULT_UNSUPPORTED here, however, it's not clear if maybe someone
-    // else might be answering the command.
-
+    if (it->second.callback != nullptr) {
+        const auto result = it->second.callback(origin_system_id, origin_component_id, params);
+        if (result.has_value()) {
+            return make_ack(result.value());
+        }
+    }
     return {};
 }
 
+std::optional<mavlink_message_t> MavlinkRequestMessageHandler::handle_command_long(
+    const MavlinkCommandReceiver::CommandLong& command)
+{
+    return handle_request(
+        static_cast<uint32_t>(std::round(command.params.param1)),
+        command.origin_system_id,
+        command.origin_component_id,
+        {command.params.param2,
+         command.params.param3,
+         command.params.param4,
+         command.params.param5,
+         command.params.param6},
+        [this, &command](MAV_RESULT result) {
+            return _server_component_impl.make_command_ack_message(command, result);
+        });
+}
+
 std::optional<mavlink_message_t>
 MavlinkRequestMessageHandler::handle_command_int(const MavlinkCommandReceiver::CommandInt& command)
 {
-    std::lock_guard<std::mutex> lock(_table_mutex);
-
-    for (auto& entry : _table) {
-        if (entry.message_id == static_cast<uint32_t>(std::round(command.params.param1))) {
-            if (entry.callback != nullptr) {
-                const auto result = entry.callback(
-                    command.origin_system_id,
-                    command.origin_component_id,
-                    {command.params.param2,
-                     command.params.param3,
-                     command.params.param4,
-                     static_cast<float>(command.params.x),
-                     static_cast<float>(command.params.y)});
-
-                if (result.has_value()) {
-                    return _server_component_impl.make_command_ack_message(command, result.value());
-                }
-            }
-            return {};
-        }
-    }
-
-    return {};
+    return handle_request(
+        static_cast<uint32_t>(std::round(command.params.param1)),
+        command.origin_system_id,
+        command.origin_component_id,
+        {command.params.param2,
+         command.params.param3,
+         command.params.param4,
+         static_cast<float>(command.params.x),
+         static_cast<float>(command.params.y)},
+        [this, &command](MAV_RESULT result) {
+            return _server_component_impl.make_command_ack_message(command, result);
+        });
 }
 
 } // namespace mavsdk
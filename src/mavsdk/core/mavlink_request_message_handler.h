@@ -2,9 +2,10 @@
 
 #include <array>
 #include <functional>
+#include <memory>
 #include <mutex>
 #include <optional>
-#include <vector>
+#include <unordered_map>
 #include "mavlink_include.h"
 #include "mavlink_command_receiver.h"
 
@@ -14,6 +15,8 @@ class MavsdkImpl;
 class ServerComponentImpl;
 class MavlinkCommandReceiver;
 
+// Like the MavlinkCommandReceiver, the table is copied on changes, so
+// incoming requests can look up their handler without taking the mutex.
 class MavlinkRequestMessageHandler {
 public:
     MavlinkRequestMessageHandler() = delete;
@@ -43,8 +46,19 @@ private:
         const void* cookie;
     };
 
+    using Table = std::unordered_map<uint32_t, Entry>;
+
+    std::optional<mavlink_message_t> handle_request(
+        uint32_t message_id,
+        uint8_t origin_system_id,
+        uint8_t origin_component_id,
+        const Params& params,
+        const std::function<mavlink_message_t(MAV_RESULT)>& make_ack);
+    void set_table(std::shared_ptr<const Table> table);
+
+    // Only used to serialize changes to the table, not for lookups.
     std::mutex _table_mutex{};
-    std::vector<Entry> _table{};
+    std::shared_ptr<const Table> _table{std::make_shared<const Table>()};
 
     MavsdkImpl& _mavsdk_impl;
     ServerComponentImpl& _server_component_impl;
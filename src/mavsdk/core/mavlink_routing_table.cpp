@@ -0,0 +1,63 @@
+#include "mavlink_routing_table.h"
+
+namespace mavsdk {
+
+MavlinkRoutingTable::~MavlinkRoutingTable()
+{
+    for (auto& page : _component_pages) {
+        delete page.load();
+    }
+}
+
+void MavlinkRoutingTable::learn(uint8_t system_id, uint8_t component_id, unsigned link_index)
+{
+    const LinkMask mask = mask_of(link_index);
+    if (mask == 0) {
+        return;
+    }
+
+    // Avoid writing (and invalidating the cache line) in the common case
+    // where we already know about it.
+    auto& system_links = _systems[system_id];
+    if ((system_links.load(std::memory_order_relaxed) & mask) == 0) {
+        system_links.fetch_or(mask, std::memory_order_relaxed);
+    }
+
+    auto& page_ptr = _component_pages[system_id];
+    ComponentPage* page = page_ptr.load(std::memory_order_acquire);
+    if (page == nullptr) {
+        auto* new_page = new ComponentPage();
+        if (page_ptr.compare_exchange_strong(
+                page, new_page, std::memory_order_acq_rel, std::memory_order_acquire)) {
+            page = new_page;
+        } else {
+            // Someone else was faster.
+            delete new_page;
+        }
+    }
+
+    auto& component_links = page->components[component_id];
+    if ((component_links.load(std::memory_order_relaxed) & mask) == 0) {
+        component_links.fetch_or(mask, std::memory_order_relaxed);
+    }
+}
+
+MavlinkRoutingTable::LinkMask
+MavlinkRoutingTable::links_for(uint8_t target_system_id, uint8_t target_component_id) const
+{
+    if (target_component_id != 0) {
+        const ComponentPage* page =
+            _component_pages[target_system_id].load(std::memory_order_acquire);
+        if (page != nullptr) {
+            const LinkMask links =
+                page->components[target_component_id].load(std::memory_order_relaxed);
+            if (links != 0) {
+                return links;
+            }
+        }
+    }
+
+    return _systems[target_system_id].load(std::memory_order_relaxed);
+}
+
+} // namespace mavsdk
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace mavsdk {
+
+// Remembers on which links (connections) a system and component has been
+// seen, so that messages targeted at it only need to be sent there.
+//
+// Links are identified by an index and a set of links is a bitmask, so
+// lookups are just a few loads. Components are kept in pages per system which
+// are only allocated once a system is seen, and stay until destruction. All
+// operations are lock-free and can be called from any thread.
+class MavlinkRoutingTable {
+public:
+    using LinkMask = uint64_t;
+    static constexpr unsigned MAX_LINKS = 64;
+
+    MavlinkRoutingTable() = default;
+    ~MavlinkRoutingTable();
+
+    // delete copy and move constructors and assign operators
+    MavlinkRoutingTable(MavlinkRoutingTable const&) = delete; // Copy construct
+    MavlinkRoutingTable(MavlinkRoutingTable&&) = delete; // Move construct
+    MavlinkRoutingTable& operator=(MavlinkRoutingTable const&) = delete; // Copy assign
+    MavlinkRoutingTable& operator=(MavlinkRoutingTable&&) = delete; // Move assign
+
+    static LinkMask mask_of(unsigned link_index)
+    {
+        return link_index < MAX_LINKS ? (LinkMask(1) << link_index) : 0;
+    }
+
+    // Called for every received message with its source address. Links
+    // beyond MAX_LINKS are not learned.
+    void learn(uint8_t system_id, uint8_t component_id, unsigned link_index);
+
+    // Returns the links on which the target component has been seen, or, if
+    // the component is 0 or has not been seen, the links of the system.
+    // Returns 0 if the system is unknown.
+    LinkMask links_for(uint8_t target_system_id, uint8_t target_component_id) const;
+
+private:
+    struct ComponentPage {
+        std::array<std::atomic<LinkMask>, 256> components{};
+    };
+
+    std::array<std::atomic<LinkMask>, 256> _systems{};
+    std::array<std::atomic<ComponentPage*>, 256> _component_pages{};
+};
+
+} // namespace mavsdk
@@ -0,0 +1,67 @@
+#include "mavlink_routing_table.h"
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+using namespace mavsdk;
+
+TEST(MavlinkRoutingTable, UnknownSystemHasNoLinks)
+{
+    MavlinkRoutingTable table;
+    EXPECT_EQ(table.links_for(1, 0), 0u);
+    EXPECT_EQ(table.links_for(1, 1), 0u);
+}
+
+TEST(MavlinkRoutingTable, LearnsSystemsAndComponents)
+{
+    MavlinkRoutingTable table;
+    table.learn(1, 1, 0);
+    table.learn(1, 100, 2);
+    table.learn(2, 1, 1);
+
+    EXPECT_EQ(
+        table.links_for(1, 0),
+        MavlinkRoutingTable::mask_of(0) | MavlinkRoutingTable::mask_of(2));
+    EXPECT_EQ(table.links_for(1, 1), MavlinkRoutingTable::mask_of(0));
+    EXPECT_EQ(table.links_for(1, 100), MavlinkRoutingTable::mask_of(2));
+    EXPECT_EQ(table.links_for(2, 1), MavlinkRoutingTable::mask_of(1));
+    EXPECT_EQ(table.links_for(3, 1), 0u);
+}
+
+TEST(MavlinkRoutingTable, UnknownComponentFallsBackToSystem)
+{
+    MavlinkRoutingTable table;
+    table.learn(1, 1, 3);
+
+    EXPECT_EQ(table.links_for(1, 42), MavlinkRoutingTable::mask_of(3));
+}
+
+TEST(MavlinkRoutingTable, IgnoresLinksBeyondMax)
+{
+    MavlinkRoutingTable table;
+    table.learn(1, 1, MavlinkRoutingTable::MAX_LINKS);
+
+    EXPECT_EQ(table.links_for(1, 1), 0u);
+}
+
+TEST(MavlinkRoutingTable, LearnsConcurrently)
+{
+    MavlinkRoutingTable table;
+
+    std::vector<std::thread> threads;
+    for (unsigned link = 0; link < 4; ++link) {
+        threads.emplace_back([&table, link]() {
+            for (unsigned i = 0; i < 1000; ++i) {
+                table.learn(uint8_t(i % 256), uint8_t(i % 7), link);
+            }
+        });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    for (unsigned sysid = 0; sysid < 256; ++sysid) {
+        EXPECT_EQ(table.links_for(uint8_t(sysid), 0), 0xFu);
+    }
+}
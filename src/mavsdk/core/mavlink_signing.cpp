@@ -0,0 +1,200 @@
+#include "mavlink_signing.h"
+#include "sha256.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+namespace mavsdk {
+
+namespace {
+
+// If another thread was quicker, we use its page instead.
+template<typename Page> Page& page_of(std::atomic<Page*>& entry)
+{
+    Page* page = entry.load(std::memory_order_acquire);
+    if (page == nullptr) {
+        auto* new_page = new Page{};
+        if (entry.compare_exchange_strong(
+                page, new_page, std::memory_order_acq_rel, std::memory_order_acquire)) {
+            page = new_page;
+        } else {
+            delete new_page;
+        }
+    }
+    return *page;
+}
+
+} // namespace
+
+MavlinkSigning::MavlinkSigning(const SecretKey& secret_key, uint8_t link_id) :
+    _secret_key(secret_key),
+    _link_id(link_id),
+    _timestamp(timestamp_now())
+{}
+
+MavlinkSigning::~MavlinkSigning()
+{
+    for (auto& component_page : _streams) {
+        if (auto* page = component_page.load()) {
+            for (auto& stream_page : *page) {
+                delete stream_page.load();
+            }
+            delete page;
+        }
+    }
+}
+
+void MavlinkSigning::sign(mavlink_message_t& message)
+{
+    if (message.magic != MAVLINK_STX || (message.incompat_flags & MAVLINK_IFLAG_SIGNED) != 0) {
+        return;
+    }
+
+    // Without the CRC extra, we can't fix the checksum.
+    const mavlink_msg_entry_t* entry = mavlink_get_msg_entry(message.msgid);
+    if (entry == nullptr) {
+        return;
+    }
+
+    message.incompat_flags |= MAVLINK_IFLAG_SIGNED;
+
+    const uint8_t header[MAVLINK_CORE_HEADER_LEN] = {
+        message.len,
+        message.incompat_flags,
+        message.compat_flags,
+        message.seq,
+        message.sysid,
+        message.compid,
+        static_cast<uint8_t>(message.msgid & 0xFF),
+        static_cast<uint8_t>((message.msgid >> 8) & 0xFF),
+        static_cast<uint8_t>((message.msgid >> 16) & 0xFF)};
+
+    auto* payload = reinterpret_cast<uint8_t*>(_MAV_PAYLOAD_NON_CONST(&message));
+    uint16_t checksum = crc_calculate(header, MAVLINK_CORE_HEADER_LEN);
+    crc_accumulate_buffer(&checksum, reinterpret_cast<const char*>(payload), message.len);
+    crc_accumulate(entry->crc_extra, &checksum);
+
+    message.checksum = checksum;
+    message.ck[0] = static_cast<uint8_t>(checksum & 0xFF);
+    message.ck[1] = static_cast<uint8_t>(checksum >> 8);
+    payload[message.len] = message.ck[0];
+    payload[message.len + 1] = message.ck[1];
+
+    const uint64_t timestamp = next_timestamp();
+    message.signature[0] = _link_id;
+    for (unsigned i = 0; i < 6; ++i) {
+        message.signature[1 + i] = static_cast<uint8_t>(timestamp >> (8 * i));
+    }
+
+    const Signature signature = signature_of(message);
+    memcpy(&message.signature[7], signature.data(), signature.size());
+}
+
+bool MavlinkSigning::verify(const mavlink_message_t& message)
+{
+    if ((message.incompat_flags & MAVLINK_IFLAG_SIGNED) == 0) {
+        return message.msgid == MAVLINK_MSG_ID_RADIO_STATUS;
+    }
+
+    // The signature is checked first, so the replay state can't be changed
+    // by anyone not knowing the key.
+    const Signature signature = signature_of(message);
+    if (memcmp(signature.data(), &message.signature[7], signature.size()) != 0) {
+        return false;
+    }
+
+    uint64_t timestamp = 0;
+    for (unsigned i = 0; i < 6; ++i) {
+        timestamp |= uint64_t(message.signature[1 + i]) << (8 * i);
+    }
+
+    auto& last_timestamp = last_timestamp_of(message.sysid, message.compid, message.signature[0]);
+    uint64_t last = last_timestamp.load(std::memory_order_acquire);
+    if (last == 0 && timestamp + MAX_NEW_STREAM_AGE < _timestamp.load(std::memory_order_relaxed)) {
+        return false;
+    }
+
+    // Every timestamp is only accepted once per stream.
+    do {
+        if (timestamp <= last) {
+            return false;
+        }
+    } while (!last_timestamp.compare_exchange_weak(
+        last, timestamp, std::memory_order_acq_rel, std::memory_order_acquire));
+
+    bump_timestamp(timestamp);
+    return true;
+}
+
+uint64_t MavlinkSigning::timestamp_now()
+{
+    // 1st January 2015 GMT as Unix time.
+    constexpr std::chrono::seconds signing_epoch{1420070400};
+
+    const auto since_epoch = std::chrono::system_clock::now().time_since_epoch() - signing_epoch;
+    const auto count =
+        std::chrono::duration_cast<std::chrono::microseconds>(since_epoch).count() / 10;
+    return count > 0 ? static_cast<uint64_t>(count) : 0;
+}
+
+MavlinkSigning::Signature MavlinkSigning::signature_of(const mavlink_message_t& message) const
+{
+    const uint8_t header[MAVLINK_NUM_HEADER_BYTES] = {
+        message.magic,
+        message.len,
+        message.incompat_flags,
+        message.compat_flags,
+        message.seq,
+        message.sysid,
+        message.compid,
+        static_cast<uint8_t>(message.msgid & 0xFF),
+        static_cast<uint8_t>((message.msgid >> 8) & 0xFF),
+        static_cast<uint8_t>((message.msgid >> 16) & 0xFF)};
+    const uint8_t ck[2] = {
+        static_cast<uint8_t>(message.checksum & 0xFF), static_cast<uint8_t>(message.checksum >> 8)};
+
+    Sha256 sha256;
+    sha256.add(_secret_key.data(), _secret_key.size());
+    sha256.add(header, sizeof(header));
+    sha256.add(reinterpret_cast<const uint8_t*>(_MAV_PAYLOAD(&message)), message.len);
+    sha256.add(ck, sizeof(ck));
+    // Link ID and timestamp.
+    sha256.add(message.signature, 7);
+    const Sha256::Digest digest = sha256.finish();
+
+    Signature signature;
+    std::copy_n(digest.begin(), signature.size(), signature.begin());
+    return signature;
+}
+
+uint64_t MavlinkSigning::next_timestamp()
+{
+    // Strictly increasing, even if the clock jumps back, or messages are
+    // sent faster than every 10 microseconds.
+    const uint64_t now = timestamp_now();
+    uint64_t current = _timestamp.load(std::memory_order_relaxed);
+    uint64_t next;
+    do {
+        next = std::max(now, current + 1);
+    } while (!_timestamp.compare_exchange_weak(current, next, std::memory_order_relaxed));
+    return next;
+}
+
+void MavlinkSigning::bump_timestamp(uint64_t timestamp)
+{
+    uint64_t current = _timestamp.load(std::memory_order_relaxed);
+    while (timestamp > current &&
+           !_timestamp.compare_exchange_weak(current, timestamp, std::memory_order_relaxed)) {
+    }
+}
+
+std::atomic<uint64_t>&
+MavlinkSigning::last_timestamp_of(uint8_t sysid, uint8_t compid, uint8_t link_id)
+{
+    ComponentPage& component_page = page_of(_streams[sysid]);
+    StreamPage& stream_page = page_of(component_page[compid]);
+    return stream_page[link_id];
+}
+
+} // namespace mavsdk
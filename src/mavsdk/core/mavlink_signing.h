@@ -0,0 +1,66 @@
+#pragma once
+
+#include "mavlink_include.h"
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace mavsdk {
+
+// Signs outgoing and verifies incoming MAVLink 2 messages, see
+// https://mavlink.io/en/guide/message_signing.html
+//
+// The state to detect replayed messages is kept per stream, which is a
+// sender and link ID. It can be checked without locking, so several
+// connections can verify messages in parallel.
+
+class MavlinkSigning {
+public:
+    using SecretKey = std::array<uint8_t, 32>;
+
+    MavlinkSigning(const SecretKey& secret_key, uint8_t link_id);
+    ~MavlinkSigning();
+
+    // Copy construct
+    MavlinkSigning(const MavlinkSigning&) = delete;
+    // Copy assignment
+    const MavlinkSigning& operator=(const MavlinkSigning&) = delete;
+
+    // The checksum is updated as the signed flag is covered by it. MAVLink 1
+    // messages can't be signed and are left as they are.
+    void sign(mavlink_message_t& message);
+
+    // Unsigned messages are only accepted if they are RADIO_STATUS, because
+    // radios don't know the key.
+    bool verify(const mavlink_message_t& message);
+
+    // In units of 10 microseconds since 1st January 2015 GMT.
+    static uint64_t timestamp_now();
+
+private:
+    using Signature = std::array<uint8_t, 6>;
+    Signature signature_of(const mavlink_message_t& message) const;
+
+    uint64_t next_timestamp();
+    void bump_timestamp(uint64_t timestamp);
+
+    // Streams are looked up by system ID, component ID, and link ID. The
+    // pages are allocated on first use.
+    static constexpr unsigned num_entries = 256;
+    using StreamPage = std::array<std::atomic<uint64_t>, num_entries>;
+    using ComponentPage = std::array<std::atomic<StreamPage*>, num_entries>;
+    std::atomic<uint64_t>& last_timestamp_of(uint8_t sysid, uint8_t compid, uint8_t link_id);
+
+    // New streams are only accepted if they are not older than this.
+    static constexpr uint64_t MAX_NEW_STREAM_AGE = 60 * 100000;
+
+    const SecretKey _secret_key;
+    const uint8_t _link_id;
+
+    // The highest timestamp used or seen so far.
+    std::atomic<uint64_t> _timestamp{0};
+
+    std::array<std::atomic<ComponentPage*>, num_entries> _streams{};
+};
+
+} // namespace mavsdk
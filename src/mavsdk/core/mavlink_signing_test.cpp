@@ -0,0 +1,136 @@
+#include "mavlink_signing.h"
+#include "mavlink_receiver.h"
+#include <gtest/gtest.h>
+#include <cstring>
+#include <vector>
+
+using namespace mavsdk;
+
+namespace {
+
+MavlinkSigning::SecretKey make_key(uint8_t seed)
+{
+    MavlinkSigning::SecretKey key;
+    for (unsigned i = 0; i < key.size(); ++i) {
+        key[i] = static_cast<uint8_t>(seed + i);
+    }
+    return key;
+}
+
+const MavlinkSigning::SecretKey secret_key = make_key(1);
+
+mavlink_message_t heartbeat(uint8_t sysid = 1)
+{
+    mavlink_message_t message;
+    mavlink_msg_heartbeat_pack(
+        sysid,
+        MAV_COMP_ID_AUTOPILOT1,
+        &message,
+        MAV_TYPE_QUADROTOR,
+        MAV_AUTOPILOT_PX4,
+        0,
+        0,
+        MAV_STATE_ACTIVE);
+    return message;
+}
+
+} // namespace
+
+TEST(MavlinkSigning, SignedMessageIsAccepted)
+{
+    MavlinkSigning sender{secret_key, 7};
+    MavlinkSigning receiver{secret_key, 0};
+
+    auto message = heartbeat();
+    sender.sign(message);
+
+    EXPECT_TRUE(message.incompat_flags & MAVLINK_IFLAG_SIGNED);
+    EXPECT_EQ(message.signature[0], 7);
+    EXPECT_TRUE(receiver.verify(message));
+}
+
+TEST(MavlinkSigning, SignatureMatchesMavlinkImplementation)
+{
+    MavlinkSigning sender{secret_key, 3};
+
+    auto message = heartbeat();
+    sender.sign(message);
+
+    mavlink_signing_t signing{};
+    memcpy(signing.secret_key, secret_key.data(), secret_key.size());
+    mavlink_signing_streams_t signing_streams{};
+    EXPECT_TRUE(mavlink_signature_check(&signing, &signing_streams, &message));
+}
+
+TEST(MavlinkSigning, ReplayedMessageIsRejected)
+{
+    MavlinkSigning sender{secret_key, 0};
+    MavlinkSigning receiver{secret_key, 0};
+
+    auto first = heartbeat();
+    sender.sign(first);
+    auto second = heartbeat();
+    sender.sign(second);
+
+    EXPECT_TRUE(receiver.verify(first));
+    EXPECT_TRUE(receiver.verify(second));
+    EXPECT_FALSE(receiver.verify(first));
+    EXPECT_FALSE(receiver.verify(second));
+
+    // Other senders are separate streams.
+    auto other = heartbeat(2);
+    sender.sign(other);
+    EXPECT_TRUE(receiver.verify(other));
+}
+
+TEST(MavlinkSigning, TamperedOrWronglySignedMessageIsRejected)
+{
+    MavlinkSigning sender{secret_key, 0};
+    MavlinkSigning receiver{make_key(2), 0};
+
+    auto message = heartbeat();
+    sender.sign(message);
+    EXPECT_FALSE(receiver.verify(message));
+
+    MavlinkSigning same_key_receiver{secret_key, 0};
+    auto tampered = message;
+    tampered.sysid = 2;
+    EXPECT_FALSE(same_key_receiver.verify(tampered));
+    EXPECT_TRUE(same_key_receiver.verify(message));
+}
+
+TEST(MavlinkSigning, OnlyUnsignedRadioStatusIsAccepted)
+{
+    MavlinkSigning receiver{secret_key, 0};
+
+    EXPECT_FALSE(receiver.verify(heartbeat()));
+
+    mavlink_message_t radio_status;
+    mavlink_msg_radio_status_pack(
+        1, MAV_COMP_ID_TELEMETRY_RADIO, &radio_status, 200, 190, 100, 10, 20, 0, 0);
+    EXPECT_TRUE(receiver.verify(radio_status));
+}
+
+TEST(MavlinkSigning, SignedFramesAreParsed)
+{
+    MavlinkSigning sender{secret_key, 0};
+    MavlinkSigning verifier{secret_key, 0};
+
+    std::vector<char> buffer;
+    for (uint8_t sysid = 1; sysid <= 3; ++sysid) {
+        auto message = heartbeat(sysid);
+        sender.sign(message);
+        uint8_t bytes[MAVLINK_MAX_PACKET_LEN];
+        const auto len = mavlink_msg_to_send_buffer(bytes, &message);
+        buffer.insert(buffer.end(), bytes, bytes + len);
+    }
+
+    MavlinkReceiver receiver;
+    receiver.set_new_datagram(buffer.data(), static_cast<unsigned>(buffer.size()));
+    unsigned num_verified = 0;
+    while (receiver.parse_message()) {
+        EXPECT_TRUE(verifier.verify(receiver.get_last_message()));
+        ++num_verified;
+    }
+    EXPECT_EQ(num_verified, 3);
+}
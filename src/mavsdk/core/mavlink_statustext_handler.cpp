@@ -1,40 +1,79 @@
 #include "mavlink_statustext_handler.h"
 #include "log.h"
+#include <algorithm>
+#include <cstring>
 
 namespace mavsdk {
 
 std::optional<MavlinkStatustextHandler::Statustext>
 MavlinkStatustextHandler::process(const mavlink_statustext_t& statustext)
 {
-    char text_with_null[sizeof(statustext.text) + 1]{};
-    strncpy(text_with_null, statustext.text, sizeof(text_with_null) - 1);
+    // The text is only zero terminated if shorter than the field.
+    const std::string_view text(statustext.text, strnlen(statustext.text, chunk_len));
     auto severity = static_cast<MAV_SEVERITY>(statustext.severity);
 
     if (statustext.id > 0) {
-        if (statustext.id != _last_id) {
-            _temp_multi_str = "";
-            _last_chunk_seq = 0;
-            _last_id = statustext.id;
-        }
+        Assembly& assembly = assembly_for(statustext.id);
 
         // We can recover from missing chunks in-between but not if the first or last one is lost.
-        if (_last_chunk_seq + 1 < statustext.chunk_seq) {
-            _temp_multi_str += "[ missing ... ]";
+        if (assembly.last_chunk_seq + 1 < statustext.chunk_seq) {
+            append(assembly, "[ missing ... ]");
         }
 
-        _last_chunk_seq = statustext.chunk_seq;
+        assembly.last_chunk_seq = statustext.chunk_seq;
 
-        _temp_multi_str += text_with_null;
+        append(assembly, text);
 
-        if (strlen(text_with_null) == sizeof(statustext.text)) {
+        if (text.size() == chunk_len) {
             // No zero termination yet, keep going.
             return std::nullopt;
-        } else {
-            return Statustext{_temp_multi_str, severity};
+        }
+
+        // Done, the buffer stays valid until it is used for the next one.
+        assembly.id = 0;
+        return Statustext{std::string_view(assembly.text.data(), assembly.len), severity};
+    }
+
+    std::copy(text.begin(), text.end(), _single_text.begin());
+    return Statustext{std::string_view(_single_text.data(), text.size()), severity};
+}
+
+MavlinkStatustextHandler::Assembly& MavlinkStatustextHandler::assembly_for(uint16_t id)
+{
+    ++_use_counter;
+
+    for (auto& assembly : _assemblies) {
+        if (assembly.id == id) {
+            assembly.last_used = _use_counter;
+            return assembly;
+        }
+    }
+
+    // Otherwise we start a new one, dropping the one unused for the longest
+    // time if we have to, its last chunk has probably been lost.
+    auto* oldest = &_assemblies.front();
+    for (auto& assembly : _assemblies) {
+        if (assembly.id == 0) {
+            oldest = &assembly;
+            break;
+        }
+        if (assembly.last_used < oldest->last_used) {
+            oldest = &assembly;
         }
     }
 
-    return Statustext{text_with_null, severity};
+    oldest->len = 0;
+    oldest->id = id;
+    oldest->last_chunk_seq = 0;
+    oldest->last_used = _use_counter;
+    return *oldest;
+}
+
+void MavlinkStatustextHandler::append(Assembly& assembly, std::string_view text)
+{
+    const std::size_t len = std::min(text.size(), assembly.text.size() - assembly.len);
+    std::copy_n(text.begin(), len, assembly.text.begin() + assembly.len);
+    assembly.len += len;
 }
 
 std::string MavlinkStatustextHandler::severity_str(MAV_SEVERITY severity)
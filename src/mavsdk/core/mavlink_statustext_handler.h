@@ -1,18 +1,32 @@
 #pragma once
 
 #include "mavlink_include.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <optional>
 
 namespace mavsdk {
 
+// Reassembles statustexts sent in several chunks, in fixed buffers so that
+// the bursts of statustexts at boot don't allocate.
+//
+// The text of a result points into these buffers and is only valid until
+// the next call to process().
 class MavlinkStatustextHandler {
 public:
     MavlinkStatustextHandler() = default;
     ~MavlinkStatustextHandler() = default;
 
+    // Longer texts are cut off.
+    static constexpr std::size_t max_text_len = 1024;
+    // Statustexts in chunks with different IDs can arrive interleaved.
+    static constexpr std::size_t num_assemblies = 4;
+
     struct Statustext {
-        std::string text;
+        std::string_view text;
         MAV_SEVERITY severity;
     };
 
@@ -21,9 +35,22 @@ public:
     static std::string severity_str(MAV_SEVERITY severity);
 
 private:
-    std::string _temp_multi_str{};
-    uint16_t _last_id{0};
-    uint8_t _last_chunk_seq{0};
+    static constexpr std::size_t chunk_len = sizeof(mavlink_statustext_t::text);
+
+    struct Assembly {
+        std::array<char, max_text_len> text{};
+        std::size_t len{0};
+        uint16_t id{0};
+        uint8_t last_chunk_seq{0};
+        uint64_t last_used{0};
+    };
+
+    Assembly& assembly_for(uint16_t id);
+    static void append(Assembly& assembly, std::string_view text);
+
+    std::array<char, chunk_len> _single_text{};
+    std::array<Assembly, num_assemblies> _assemblies{};
+    uint64_t _use_counter{0};
 };
 
 } // namespace mavsdk
@@ -260,6 +260,58 @@ TEST(MavlinkStatustextHandler, MultiStatustextConsecutive)
     }
 }
 
+TEST(MavlinkStatustextHandler, MultiStatustextInterleaved)
+{
+    const std::string str1 = "First one which is longer than a single chunk and t"
+                             "hus split.";
+    const std::string str2 = "Second one which is also longer than a single chunk"
+                             " interleaved.";
+
+    constexpr std::size_t chunk_len = sizeof(mavlink_statustext_t::text);
+
+    MavlinkStatustextHandler handler;
+
+    const auto chunk = [&](const std::string& str, uint16_t id, uint8_t chunk_seq) {
+        const auto part = str.substr(chunk_seq * chunk_len, chunk_len);
+        mavlink_statustext_t statustext{};
+        strncpy(statustext.text, part.c_str(), sizeof(statustext.text));
+        statustext.id = id;
+        statustext.chunk_seq = chunk_seq;
+        return statustext;
+    };
+
+    EXPECT_FALSE(handler.process(chunk(str1, 1, 0)));
+    EXPECT_FALSE(handler.process(chunk(str2, 2, 0)));
+
+    auto result = handler.process(chunk(str1, 1, 1));
+    ASSERT_TRUE(result);
+    EXPECT_EQ(result.value().text, str1);
+
+    result = handler.process(chunk(str2, 2, 1));
+    ASSERT_TRUE(result);
+    EXPECT_EQ(result.value().text, str2);
+}
+
+TEST(MavlinkStatustextHandler, MultiStatustextTooLong)
+{
+    MavlinkStatustextHandler handler;
+
+    mavlink_statustext_t statustext{};
+    std::fill(std::begin(statustext.text), std::end(statustext.text), 'x');
+    statustext.id = 7;
+
+    for (uint8_t chunk_seq = 0; chunk_seq < 30; ++chunk_seq) {
+        statustext.chunk_seq = chunk_seq;
+        EXPECT_FALSE(handler.process(statustext));
+    }
+
+    statustext.text[0] = '\0';
+    statustext.chunk_seq = 30;
+    const auto result = handler.process(statustext);
+    ASSERT_TRUE(result);
+    EXPECT_EQ(result.value().text.size(), MavlinkStatustextHandler::max_text_len);
+}
+
 #if defined(__GNUC__)
 #pragma GCC diagnostic pop
 #endif // defined(__GNUC__)
@@ -1,12 +1,16 @@
 #include "mavsdk.h"
 
 #include "mavsdk_impl.h"
+#include "thread_config.h"
+#include "trace.h"
 
 namespace mavsdk {
 
-Mavsdk::Mavsdk()
+Mavsdk::Mavsdk() : Mavsdk(CallbackQueueOptions{}) {}
+
+Mavsdk::Mavsdk(const CallbackQueueOptions& callback_queue_options)
 {
-    _impl = std::make_shared<MavsdkImpl>();
+    _impl = std::make_shared<MavsdkImpl>(callback_queue_options);
 }
 
 Mavsdk::~Mavsdk() = default;
@@ -74,6 +78,175 @@ void Mavsdk::set_timeout_s(double timeout_s)
     _impl->set_timeout_s(timeout_s);
 }
 
+void Mavsdk::set_udp_send_coalesce_delay_s(double delay_s)
+{
+    _impl->set_udp_send_coalesce_delay_s(delay_s);
+}
+
+void Mavsdk::set_udp_receive_threads(unsigned num_threads)
+{
+    _impl->set_udp_receive_threads(num_threads);
+}
+
+void Mavsdk::set_bandwidth_limit(double bytes_per_s)
+{
+    _impl->set_bandwidth_limit(bytes_per_s);
+}
+
+void Mavsdk::set_link_emulation(const LinkEmulation& link_emulation)
+{
+    _impl->set_link_emulation(link_emulation);
+}
+
+void Mavsdk::set_receive_queue(size_t capacity, ReceiveQueueOverflowPolicy overflow_policy)
+{
+    _impl->set_receive_queue(capacity, overflow_policy);
+}
+
+void Mavsdk::set_shared_receive_thread_enabled(bool enabled)
+{
+    _impl->set_shared_receive_thread_enabled(enabled);
+}
+
+void Mavsdk::set_io_uring_enabled(bool enabled)
+{
+    _impl->set_io_uring_enabled(enabled);
+}
+
+void Mavsdk::set_shared_system_thread_enabled(bool enabled)
+{
+    _impl->set_shared_system_thread_enabled(enabled);
+}
+
+void Mavsdk::set_thread_settings(ThreadRole role, const ThreadSettings& settings)
+{
+    ThreadConfig::set(role, settings);
+}
+
+void Mavsdk::start_tracing(size_t events_per_thread)
+{
+    Trace::start(events_per_thread);
+}
+
+bool Mavsdk::stop_tracing(const std::string& path)
+{
+    Trace::stop();
+    return Trace::write_chrome_json(path);
+}
+
+void Mavsdk::send_fleet_command_async(
+    const std::vector<std::shared_ptr<System>>& systems,
+    const FleetCommand& command,
+    const FleetCommandCallback& callback)
+{
+    _impl->send_fleet_command_async(systems, command, callback);
+}
+
+void Mavsdk::set_fleet_params_async(
+    const std::vector<std::shared_ptr<System>>& systems,
+    const std::vector<FleetParam>& params,
+    const FleetParamsCallback& callback)
+{
+    _impl->set_fleet_params_async(systems, params, callback);
+}
+
+void Mavsdk::get_fleet_params_async(
+    const std::vector<std::shared_ptr<System>>& systems,
+    const std::vector<FleetParam>& params,
+    const FleetParamsCallback& callback)
+{
+    _impl->get_fleet_params_async(systems, params, callback);
+}
+
+void Mavsdk::download_fleet_missions_async(
+    const std::vector<std::shared_ptr<System>>& systems,
+    unsigned max_parallel,
+    const FleetMissionProgressCallback& progress_callback,
+    const FleetMissionCallback& callback)
+{
+    _impl->download_fleet_missions_async(systems, max_parallel, progress_callback, callback);
+}
+
+void Mavsdk::upload_fleet_missions_async(
+    const std::vector<std::pair<std::shared_ptr<System>, std::vector<FleetMissionItem>>>& missions,
+    unsigned max_parallel,
+    const FleetMissionProgressCallback& progress_callback,
+    const FleetMissionCallback& callback)
+{
+    _impl->upload_fleet_missions_async(missions, max_parallel, progress_callback, callback);
+}
+
+FleetSetpointResult Mavsdk::set_fleet_setpoints(
+    const std::vector<std::pair<std::shared_ptr<System>, FleetSetpoint>>& setpoints)
+{
+    return _impl->set_fleet_setpoints(setpoints);
+}
+
+FleetSetpointResult Mavsdk::set_fleet_setpoint_rate(double rate_hz)
+{
+    return _impl->set_fleet_setpoint_rate(rate_hz);
+}
+
+void Mavsdk::stop_fleet_setpoints()
+{
+    _impl->stop_fleet_setpoints();
+}
+
+bool Mavsdk::start_tlog_recording(const std::string& path)
+{
+    return _impl->start_tlog_recording(path, TlogFilter{});
+}
+
+bool Mavsdk::start_tlog_recording(const std::string& path, const TlogFilter& filter)
+{
+    return _impl->start_tlog_recording(path, filter);
+}
+
+void Mavsdk::stop_tlog_recording()
+{
+    _impl->stop_tlog_recording();
+}
+
+uint64_t Mavsdk::tlog_dropped_bytes() const
+{
+    return _impl->tlog_dropped_bytes();
+}
+
+void Mavsdk::set_param_cache_directory(const std::string& directory)
+{
+    _impl->set_param_cache_directory(directory);
+}
+
+void Mavsdk::enable_message_signing(const std::array<uint8_t, 32>& secret_key)
+{
+    _impl->enable_message_signing(secret_key);
+}
+
+void Mavsdk::disable_message_signing()
+{
+    _impl->disable_message_signing();
+}
+
+Mavsdk::CallbackQueueStats Mavsdk::callback_queue_stats() const
+{
+    return _impl->callback_queue_stats();
+}
+
+std::vector<Mavsdk::CallbackSiteStats> Mavsdk::callback_site_stats() const
+{
+    return _impl->callback_site_stats();
+}
+
+std::vector<MessageStats> Mavsdk::message_stats() const
+{
+    return _impl->message_stats();
+}
+
+MemoryUsage Mavsdk::memory_usage() const
+{
+    return _impl->memory_usage();
+}
+
 Mavsdk::NewSystemHandle Mavsdk::subscribe_on_new_system(const NewSystemCallback& callback)
 {
     return _impl->subscribe_on_new_system(callback);
@@ -84,6 +257,27 @@ void Mavsdk::unsubscribe_on_new_system(NewSystemHandle handle)
     _impl->unsubscribe_on_new_system(handle);
 }
 
+Mavsdk::LinkStatsHandle Mavsdk::subscribe_link_stats(const LinkStatsCallback& callback)
+{
+    return _impl->subscribe_link_stats(callback);
+}
+
+void Mavsdk::unsubscribe_link_stats(LinkStatsHandle handle)
+{
+    _impl->unsubscribe_link_stats(handle);
+}
+
+Mavsdk::FleetMissionStatesHandle
+Mavsdk::subscribe_fleet_mission_states(const FleetMissionStatesCallback& callback)
+{
+    return _impl->subscribe_fleet_mission_states(callback);
+}
+
+void Mavsdk::unsubscribe_fleet_mission_states(FleetMissionStatesHandle handle)
+{
+    _impl->unsubscribe_fleet_mission_states(handle);
+}
+
 std::shared_ptr<ServerComponent>
 Mavsdk::server_component_by_type(ServerComponentType server_component_type, unsigned instance)
 {
@@ -193,6 +387,16 @@ void Mavsdk::Configuration::set_usage_type(Mavsdk::Configuration::UsageType usag
     _usage_type = usage_type;
 }
 
+void Mavsdk::Configuration::set_allocator_factory(AllocatorFactory allocator_factory)
+{
+    _allocator_factory = std::move(allocator_factory);
+}
+
+Mavsdk::Configuration::AllocatorFactory Mavsdk::Configuration::get_allocator_factory() const
+{
+    return _allocator_factory;
+}
+
 void Mavsdk::intercept_incoming_messages_async(std::function<bool(mavlink_message_t&)> callback)
 {
     _impl->intercept_incoming_messages_async(callback);
@@ -203,4 +407,26 @@ void Mavsdk::intercept_outgoing_messages_async(std::function<bool(mavlink_messag
     _impl->intercept_outgoing_messages_async(callback);
 }
 
+Mavsdk::InterceptMessagesHandle Mavsdk::add_incoming_messages_interceptor(
+    const InterceptMessagesCallback& callback, const std::vector<uint32_t>& message_ids)
+{
+    return _impl->add_incoming_messages_interceptor(callback, message_ids);
+}
+
+void Mavsdk::remove_incoming_messages_interceptor(InterceptMessagesHandle handle)
+{
+    _impl->remove_incoming_messages_interceptor(handle);
+}
+
+Mavsdk::InterceptMessagesHandle Mavsdk::add_outgoing_messages_interceptor(
+    const InterceptMessagesCallback& callback, const std::vector<uint32_t>& message_ids)
+{
+    return _impl->add_outgoing_messages_interceptor(callback, message_ids);
+}
+
+void Mavsdk::remove_outgoing_messages_interceptor(InterceptMessagesHandle handle)
+{
+    _impl->remove_outgoing_messages_interceptor(handle);
+}
+
 } // namespace mavsdk
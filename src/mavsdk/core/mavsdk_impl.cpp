@@ -1,14 +1,24 @@
 #include "mavsdk_impl.h"
 
 #include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <map>
 #include <mutex>
 
 #include "connection.h"
+#include "fs.h"
+#include "mavlink_frame.h"
 #include "tcp_connection.h"
+#include "tcp_server_connection.h"
+#include "thread_config.h"
+#include "trace.h"
 #include "udp_connection.h"
 #include "system.h"
 #include "system_impl.h"
 #include "serial_connection.h"
+#include "tlog_replay_connection.h"
+#include "loopback_connection.h"
 #include "cli_arg.h"
 #include "version.h"
 #include "unused.h"
@@ -18,8 +28,177 @@
 namespace mavsdk {
 
 template class CallbackList<>;
+template class CallbackList<std::vector<LinkStats>>;
+template class CallbackList<std::vector<FleetMissionState>>;
 
-MavsdkImpl::MavsdkImpl() : timeout_handler(_time), call_every_handler(_time)
+namespace {
+
+CallbackQueueBase::OverflowPolicy
+to_overflow_policy(Mavsdk::CallbackOverflowPolicy overflow_policy)
+{
+    switch (overflow_policy) {
+        case Mavsdk::CallbackOverflowPolicy::DropOldest:
+            return CallbackQueueBase::OverflowPolicy::DropOldest;
+        case Mavsdk::CallbackOverflowPolicy::CoalesceByKey:
+            return CallbackQueueBase::OverflowPolicy::CoalesceByKey;
+        case Mavsdk::CallbackOverflowPolicy::DropNewest:
+        default:
+            return CallbackQueueBase::OverflowPolicy::DropNewest;
+    }
+}
+
+// Broadcasts go everywhere, targeted messages only where the target has been
+// seen. Links we couldn't learn about get everything.
+bool is_routed_to(
+    const Connection& connection, uint8_t target_system_id, MavlinkRoutingTable::LinkMask links)
+{
+    if (target_system_id == 0 || connection.link_index() >= MavlinkRoutingTable::MAX_LINKS) {
+        return true;
+    }
+    return (links & MavlinkRoutingTable::mask_of(connection.link_index())) != 0;
+}
+
+FleetCommandResult to_fleet_command_result(MavlinkCommandSender::Result result)
+{
+    switch (result) {
+        case MavlinkCommandSender::Result::Success:
+            return FleetCommandResult::Success;
+        case MavlinkCommandSender::Result::NoSystem:
+            return FleetCommandResult::NoSystem;
+        case MavlinkCommandSender::Result::ConnectionError:
+            return FleetCommandResult::ConnectionError;
+        case MavlinkCommandSender::Result::Denied:
+            return FleetCommandResult::Denied;
+        case MavlinkCommandSender::Result::Unsupported:
+            return FleetCommandResult::Unsupported;
+        case MavlinkCommandSender::Result::TemporarilyRejected:
+            return FleetCommandResult::TemporarilyRejected;
+        case MavlinkCommandSender::Result::Failed:
+            return FleetCommandResult::Failed;
+        case MavlinkCommandSender::Result::Cancelled:
+            return FleetCommandResult::Cancelled;
+        case MavlinkCommandSender::Result::Timeout:
+            return FleetCommandResult::Timeout;
+        default:
+            return FleetCommandResult::Unknown;
+    }
+}
+
+std::optional<float> maybe_param(float param)
+{
+    if (std::isnan(param)) {
+        return std::nullopt;
+    }
+    return param;
+}
+
+FleetParamResult to_fleet_param_result(MAVLinkParameters::Result result)
+{
+    switch (result) {
+        case MAVLinkParameters::Result::Success:
+            return FleetParamResult::Success;
+        case MAVLinkParameters::Result::Timeout:
+            return FleetParamResult::Timeout;
+        case MAVLinkParameters::Result::ConnectionError:
+            return FleetParamResult::ConnectionError;
+        case MAVLinkParameters::Result::WrongType:
+            return FleetParamResult::WrongType;
+        case MAVLinkParameters::Result::ParamNameTooLong:
+            return FleetParamResult::ParamNameTooLong;
+        case MAVLinkParameters::Result::NotFound:
+            return FleetParamResult::NotFound;
+        case MAVLinkParameters::Result::ValueUnsupported:
+            return FleetParamResult::ValueUnsupported;
+        case MAVLinkParameters::Result::Failed:
+            return FleetParamResult::Failed;
+        default:
+            return FleetParamResult::Unknown;
+    }
+}
+
+FleetMissionResult to_fleet_mission_result(MavlinkMissionTransfer::Result result)
+{
+    switch (result) {
+        case MavlinkMissionTransfer::Result::Success:
+            return FleetMissionResult::Success;
+        case MavlinkMissionTransfer::Result::ConnectionError:
+            return FleetMissionResult::ConnectionError;
+        case MavlinkMissionTransfer::Result::Denied:
+            return FleetMissionResult::Denied;
+        case MavlinkMissionTransfer::Result::Timeout:
+            return FleetMissionResult::Timeout;
+        case MavlinkMissionTransfer::Result::Unsupported:
+            return FleetMissionResult::Unsupported;
+        case MavlinkMissionTransfer::Result::NoMissionAvailable:
+            return FleetMissionResult::NoMissionAvailable;
+        case MavlinkMissionTransfer::Result::Cancelled:
+            return FleetMissionResult::Cancelled;
+        case MavlinkMissionTransfer::Result::ProtocolError:
+            return FleetMissionResult::ProtocolError;
+        default:
+            return FleetMissionResult::Unknown;
+    }
+}
+
+FleetMissionItem to_fleet_mission_item(const MavlinkMissionTransfer::ItemInt& item)
+{
+    return FleetMissionItem{
+        item.seq,
+        item.frame,
+        item.command,
+        item.current,
+        item.autocontinue,
+        item.param1,
+        item.param2,
+        item.param3,
+        item.param4,
+        item.x,
+        item.y,
+        item.z,
+        item.mission_type};
+}
+
+MavlinkMissionTransfer::ItemInt to_item_int(const FleetMissionItem& item)
+{
+    return MavlinkMissionTransfer::ItemInt{
+        item.seq,
+        item.frame,
+        item.command,
+        item.current,
+        item.autocontinue,
+        item.param1,
+        item.param2,
+        item.param3,
+        item.param4,
+        item.x,
+        item.y,
+        item.z,
+        item.mission_type};
+}
+
+MAVLinkParameters::SharedParams to_shared_params(const std::vector<FleetParam>& params)
+{
+    auto shared =
+        std::make_shared<std::vector<std::pair<std::string, MAVLinkParameters::ParamValue>>>();
+    shared->reserve(params.size());
+    for (const auto& param : params) {
+        MAVLinkParameters::ParamValue value;
+        if (const auto* int_value = std::get_if<int32_t>(&param.value)) {
+            value.set(*int_value);
+        } else {
+            value.set(std::get<float>(param.value));
+        }
+        shared->emplace_back(param.name, value);
+    }
+    return shared;
+}
+
+} // namespace
+
+MavsdkImpl::MavsdkImpl(const Mavsdk::CallbackQueueOptions& callback_queue_options) :
+    timeout_handler(_time),
+    call_every_handler(_time),
+    heartbeat_monitor(_time)
 {
     LogInfo() << "MAVSDK version: " << mavsdk_version;
 
@@ -37,23 +216,56 @@ MavsdkImpl::MavsdkImpl() : timeout_handler(_time), call_every_handler(_time)
         }
     }
 
+    timeout_handler.set_notifier([this]() { notify_work_thread(); });
+    call_every_handler.set_notifier([this]() { notify_work_thread(); });
+    heartbeat_monitor.set_notifier([this]() { notify_work_thread(); });
+
     _work_thread = new std::thread(&MavsdkImpl::work_thread, this);
 
-    _process_user_callbacks_thread =
-        new std::thread(&MavsdkImpl::process_user_callbacks_thread, this);
+    const unsigned num_executors = std::max(callback_queue_options.num_threads, 1u);
+    for (unsigned i = 0; i < num_executors; ++i) {
+        // In the order of the lanes.
+        _user_callback_executors.push_back(std::make_unique<UserCallbackExecutor>(
+            std::array<size_t, CallbackLanes<UserCallback>::num_lanes>{
+                callback_queue_options.control_capacity,
+                callback_queue_options.capacity,
+                callback_queue_options.telemetry_capacity},
+            to_overflow_policy(callback_queue_options.overflow_policy)));
+    }
+
+    for (auto& executor : _user_callback_executors) {
+        executor->thread = new std::thread(
+            &MavsdkImpl::process_user_callbacks_thread, this, std::ref(*executor));
+    }
+
+    _link_stats_last_time = _time.steady_time();
+    call_every_handler.add(
+        [this]() { report_link_stats(); }, LINK_STATS_INTERVAL_S, &_link_stats_cookie);
+
+    call_every_handler.add(
+        [this]() { check_user_callbacks(); },
+        CALLBACK_WATCHDOG_INTERVAL_S,
+        &_callback_watchdog_cookie);
 }
 
 MavsdkImpl::~MavsdkImpl()
 {
     call_every_handler.remove(_heartbeat_send_cookie);
+    call_every_handler.remove(_link_stats_cookie);
+    call_every_handler.remove(_callback_watchdog_cookie);
 
-    _should_exit = true;
+    _fleet_setpoint_streamer.stop();
 
-    if (_process_user_callbacks_thread != nullptr) {
-        _user_callback_queue.stop();
-        _process_user_callbacks_thread->join();
-        delete _process_user_callbacks_thread;
-        _process_user_callbacks_thread = nullptr;
+    _should_exit = true;
+    notify_work_thread();
+
+    for (auto& executor : _user_callback_executors) {
+        if (executor->thread != nullptr) {
+            executor->queue.stop();
+            executor->thread->join();
+            delete executor->thread;
+            executor->thread = nullptr;
+        }
     }
 
     if (_work_thread != nullptr) {
@@ -62,14 +274,20 @@ MavsdkImpl::~MavsdkImpl()
         _work_thread = nullptr;
     }
 
+    // The connections go first, so no more messages are dispatched to the
+    // systems, as this happens without holding the systems lock.
+    {
+        std::lock_guard<std::mutex> lock(_connections_mutex);
+        _connections.clear();
+    }
+
     {
         std::lock_guard<std::recursive_mutex> lock(_systems_mutex);
         _systems.clear();
     }
 
-    {
-        std::lock_guard<std::mutex> lock(_connections_mutex);
-        _connections.clear();
+    for (auto& stats : _system_message_stats) {
+        delete stats.load();
     }
 }
 
@@ -265,8 +483,11 @@ void MavsdkImpl::forward_message(mavlink_message_t& message, Connection* connect
         (message.msgid != MAVLINK_MSG_ID_HEARTBEAT || forward_heartbeats_enabled);
 
     if (!targeted_only_at_us && heartbeat_check_ok) {
+        const auto links = _routing_table.links_for(target_system_id, target_component_id);
+
         std::lock_guard<std::mutex> lock(_connections_mutex);
 
+        unsigned attempted_emissions = 0;
         unsigned successful_emissions = 0;
         for (auto& _connection : _connections) {
             // Check whether the connection is not the one from which we received the message.
@@ -274,11 +495,15 @@ void MavsdkImpl::forward_message(mavlink_message_t& message, Connection* connect
             if (_connection.get() == connection || !(*_connection).should_forward_messages()) {
                 continue;
             }
-            if ((*_connection).send_message(message)) {
+            if (!is_routed_to(*_connection, target_system_id, links)) {
+                continue;
+            }
+            attempted_emissions++;
+            if ((*_connection).schedule_message(message)) {
                 successful_emissions++;
             }
         }
-        if (successful_emissions == 0) {
+        if (attempted_emissions > 0 && successful_emissions == 0) {
             LogErr() << "Message forwarding failed";
         }
     }
@@ -291,16 +516,36 @@ void MavsdkImpl::receive_message(mavlink_message_t& message, Connection* connect
                    << static_cast<int>(message.sysid) << "/" << static_cast<int>(message.compid);
     }
 
+    if (auto* signing = _signing.load(std::memory_order_acquire)) {
+        if (!signing->verify(message)) {
+            if (_message_logging_on) {
+                LogDebug() << "Dropped message with invalid signature: " << message.msgid;
+            }
+            return;
+        }
+    }
+
     // This is a low level interface where incoming messages can be tampered
     // with or even dropped.
-    if (_intercept_incoming_messages_callback != nullptr) {
-        bool keep = _intercept_incoming_messages_callback(message);
-        if (!keep) {
-            LogDebug() << "Dropped incoming message: " << int(message.msgid);
-            return;
+    if (!_incoming_interceptors.process(message)) {
+        LogDebug() << "Dropped incoming message: " << int(message.msgid);
+        return;
+    }
+
+    if (auto tlog_writer = std::atomic_load(&_tlog_writer)) {
+        if (tlog_writer->accepts(message.msgid, message.sysid, true)) {
+            tlog_writer->write(message);
         }
     }
 
+    _message_stats.count_received(message);
+
+    // Remember where the sender can be reached.
+    if (message.sysid != 0) {
+        _routing_table.learn(message.sysid, message.compid, connection->link_index());
+        system_message_stats(message.sysid).count_received(message);
+    }
+
     /** @note: Forward message if option is enabled and multiple interfaces are connected.
      *  Performs message forwarding checks for every messages if message forwarding
      *  is enabled on at least one connection, and in case of a single forwarding connection,
@@ -346,7 +591,139 @@ void MavsdkImpl::receive_message(mavlink_message_t& message, Connection* connect
         return;
     }
 
-    std::lock_guard<std::recursive_mutex> lock(_systems_mutex);
+    // Most messages come from components we already know, which we can look
+    // up without taking the systems lock.
+    if (!_known_components[message.sysid].contains(message.compid)) {
+        std::lock_guard<std::recursive_mutex> lock(_systems_mutex);
+        if (!add_component_of_message(message)) {
+            return;
+        }
+    }
+
+    if (_should_exit) {
+        // Don't try to call at() if systems have already been destroyed
+        // in destructor.
+        return;
+    }
+
+    const auto dispatch_start = std::chrono::steady_clock::now();
+    mavlink_message_handler.process_message(message);
+    const auto dispatch_time = std::chrono::steady_clock::now() - dispatch_start;
+
+    _message_stats.record_dispatch_time(message.msgid, dispatch_time);
+    system_message_stats(message.sysid).record_dispatch_time(message.msgid, dispatch_time);
+
+    const int64_t receive_time_ns = MavlinkMessageBuffer::dispatched_receive_time_ns(message);
+    if (receive_time_ns != 0) {
+        record_latencies(message, receive_time_ns);
+    }
+}
+
+void MavsdkImpl::record_latencies(const mavlink_message_t& message, int64_t receive_time_ns)
+{
+    auto& system_stats = system_message_stats(message.sysid);
+
+    const auto processing_latency =
+        std::chrono::nanoseconds(Connection::receive_time_now_ns() - receive_time_ns);
+    _message_stats.record_processing_latency(message.msgid, processing_latency);
+    system_stats.record_processing_latency(message.msgid, processing_latency);
+
+    // The timestamp of the sender is only comparable once we know its clock.
+    const auto sent_time_us = MessageStatistics::sent_time_us(message);
+    if (!sent_time_us) {
+        return;
+    }
+    auto* system_impl = _system_impls_by_id[message.sysid].load(std::memory_order_acquire);
+    if (system_impl == nullptr) {
+        return;
+    }
+    const auto sent_local_time_us = system_impl->autopilot_time_to_local_us(*sent_time_us);
+    if (!sent_local_time_us) {
+        return;
+    }
+
+    // Timestamps in another clock, e.g. GPS time, are way off and left out.
+    const auto transport_latency = std::chrono::nanoseconds(
+        receive_time_ns - static_cast<int64_t>(*sent_local_time_us) * 1000);
+    if (transport_latency < std::chrono::nanoseconds(0) ||
+        transport_latency > MAX_TRANSPORT_LATENCY) {
+        return;
+    }
+    _message_stats.record_transport_latency(message.msgid, transport_latency);
+    system_stats.record_transport_latency(message.msgid, transport_latency);
+}
+
+MessageStatistics& MavsdkImpl::system_message_stats(uint8_t system_id)
+{
+    MessageStatistics* stats = _system_message_stats[system_id].load(std::memory_order_acquire);
+    if (stats == nullptr) {
+        // If another thread was quicker, we use its instance instead.
+        auto* new_stats = new MessageStatistics{};
+        if (_system_message_stats[system_id].compare_exchange_strong(
+                stats, new_stats, std::memory_order_acq_rel, std::memory_order_acquire)) {
+            stats = new_stats;
+        } else {
+            delete new_stats;
+        }
+    }
+    return *stats;
+}
+
+std::vector<MessageStats> MavsdkImpl::message_stats() const
+{
+    return _message_stats.get();
+}
+
+std::vector<MessageStats> MavsdkImpl::message_stats_of_system(uint8_t system_id) const
+{
+    const MessageStatistics* stats =
+        _system_message_stats[system_id].load(std::memory_order_acquire);
+    return stats != nullptr ? stats->get() : std::vector<MessageStats>{};
+}
+
+MemoryUsage MavsdkImpl::memory_usage()
+{
+    MemoryUsage usage;
+
+    {
+        std::lock_guard<std::recursive_mutex> lock(_systems_mutex);
+        for (auto& system : _systems) {
+            usage.systems.push_back(system.second->system_impl()->memory_usage());
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_connections_mutex);
+        for (auto& connection : _connections) {
+            MemoryUsage::Connection connection_usage;
+            connection_usage.connection_index = connection->link_index();
+            connection_usage.buffer_bytes = connection->memory_usage();
+            usage.connections.push_back(connection_usage);
+        }
+    }
+
+    for (const auto& executor : _user_callback_executors) {
+        usage.user_callback_queue_bytes += executor->queue.memory_usage();
+    }
+
+    for (const auto& system : usage.systems) {
+        usage.total_bytes += system.param_store_bytes + system.mission_cache_bytes +
+                             system.ftp_buffer_bytes + system.work_queue_bytes;
+        for (const auto& plugin : system.plugins) {
+            usage.total_bytes += plugin.bytes;
+        }
+    }
+    for (const auto& connection : usage.connections) {
+        usage.total_bytes += connection.buffer_bytes;
+    }
+    usage.total_bytes += usage.user_callback_queue_bytes;
+
+    return usage;
+}
+
+bool MavsdkImpl::add_component_of_message(const mavlink_message_t& message)
+{
+    // Needs _systems_lock
 
     // The only situation where we create a system with sysid 0 is when we initialize the connection
     // to the remote.
@@ -374,7 +751,7 @@ void MavsdkImpl::receive_message(mavlink_message_t& message, Connection* connect
         if (_message_logging_on) {
             LogDebug() << "Don't create new system just for telemetry radio";
         }
-        return;
+        return false;
     }
 
     if (!found_system) {
@@ -382,38 +759,27 @@ void MavsdkImpl::receive_message(mavlink_message_t& message, Connection* connect
     }
 
     if (_should_exit) {
-        // Don't try to call at() if systems have already been destroyed
-        // in destructor.
-        return;
+        return false;
     }
 
     for (auto& system : _systems) {
         if (system.first == message.sysid) {
-            // system.second->system_impl()->process_mavlink_message(message);
-            mavlink_message_handler.process_message(message);
-            break;
+            _system_impls_by_id[message.sysid].store(
+                system.second->system_impl().get(), std::memory_order_release);
         }
     }
+
+    _known_components[message.sysid].insert(message.compid);
+    return true;
 }
 
 bool MavsdkImpl::send_message(mavlink_message_t& message)
 {
-    if (_message_logging_on) {
-        LogDebug() << "Sending message " << message.msgid << " from "
-                   << static_cast<int>(message.sysid) << "/" << static_cast<int>(message.compid);
-    }
-
-    // This is a low level interface where outgoing messages can be tampered
-    // with or even dropped.
-    if (_intercept_outgoing_messages_callback != nullptr) {
-        const bool keep = _intercept_outgoing_messages_callback(message);
-        if (!keep) {
-            // We fake that everything was sent as instructed because
-            // a potential loss would happen later, and we would not be informed
-            // about it.
-            LogDebug() << "Dropped outgoing message: " << int(message.msgid);
-            return true;
-        }
+    if (!prepare_outgoing_message(message)) {
+        // We fake that everything was sent as instructed because
+        // a potential loss would happen later, and we would not be informed
+        // about it.
+        return true;
     }
 
     std::lock_guard<std::mutex> lock(_connections_mutex);
@@ -424,15 +790,16 @@ bool MavsdkImpl::send_message(mavlink_message_t& message)
         return true;
     }
 
+    const uint8_t target_system_id = get_target_system_id(message);
+    const auto links = _routing_table.links_for(target_system_id, get_target_component_id(message));
+
     uint8_t successful_emissions = 0;
     for (auto& _connection : _connections) {
-        const uint8_t target_system_id = get_target_system_id(message);
-
-        if (target_system_id != 0 && !(*_connection).has_system_id(target_system_id)) {
+        if (!is_routed_to(*_connection, target_system_id, links)) {
             continue;
         }
 
-        if ((*_connection).send_message(message)) {
+        if ((*_connection).schedule_message(message)) {
             successful_emissions++;
         }
     }
@@ -442,104 +809,370 @@ bool MavsdkImpl::send_message(mavlink_message_t& message)
         return false;
     }
 
+    count_sent(message);
+
     return true;
 }
 
-ConnectionResult MavsdkImpl::add_any_connection(
-    const std::string& connection_url, ForwardingOption forwarding_option)
+bool MavsdkImpl::send_messages(std::vector<mavlink_message_t>& messages)
 {
-    CliArg cli_arg;
-    if (!cli_arg.parse(connection_url)) {
-        return ConnectionResult::ConnectionUrlInvalid;
+    // Messages dropped on the way out are removed from the batch.
+    size_t kept = 0;
+    for (size_t i = 0; i < messages.size(); ++i) {
+        if (prepare_outgoing_message(messages[i])) {
+            if (kept != i) {
+                messages[kept] = messages[i];
+            }
+            ++kept;
+        }
     }
+    messages.resize(kept);
+    const auto& outgoing = messages;
 
-    switch (cli_arg.get_protocol()) {
-        case CliArg::Protocol::Udp: {
-            int port = cli_arg.get_port() ? cli_arg.get_port() : Mavsdk::DEFAULT_UDP_PORT;
+    std::lock_guard<std::mutex> lock(_connections_mutex);
 
-            if (cli_arg.get_path().empty() || cli_arg.get_path() == Mavsdk::DEFAULT_UDP_BIND_IP) {
-                std::string path = Mavsdk::DEFAULT_UDP_BIND_IP;
-                return add_udp_connection(path, port, forwarding_option);
-            } else {
-                std::string path = cli_arg.get_path();
-                return setup_udp_remote(path, port, forwarding_option);
+    if (_connections.empty() || outgoing.empty()) {
+        return true;
+    }
+
+    std::vector<MavlinkRoutingTable::LinkMask> links;
+    links.reserve(outgoing.size());
+    for (const auto& message : outgoing) {
+        links.push_back(_routing_table.links_for(
+            get_target_system_id(message), get_target_component_id(message)));
+    }
+
+    // Usually all of them go everywhere, otherwise each connection gets the
+    // ones routed to it, still in one go.
+    std::vector<bool> sent(outgoing.size(), false);
+    std::vector<mavlink_message_t> routed;
+    std::vector<size_t> indices;
+    for (auto& connection : _connections) {
+        routed.clear();
+        indices.clear();
+        for (size_t i = 0; i < outgoing.size(); ++i) {
+            if (is_routed_to(*connection, get_target_system_id(outgoing[i]), links[i])) {
+                indices.push_back(i);
             }
         }
+        if (indices.empty()) {
+            continue;
+        }
 
-        case CliArg::Protocol::Tcp: {
-            std::string path = Mavsdk::DEFAULT_TCP_REMOTE_IP;
-            int port = Mavsdk::DEFAULT_TCP_REMOTE_PORT;
-            if (!cli_arg.get_path().empty()) {
-                path = cli_arg.get_path();
-            }
-            if (cli_arg.get_port()) {
-                port = cli_arg.get_port();
+        bool successful = false;
+        if (indices.size() == outgoing.size()) {
+            successful = connection->schedule_messages(outgoing);
+        } else {
+            for (const auto index : indices) {
+                routed.push_back(outgoing[index]);
             }
-            return add_tcp_connection(path, port, forwarding_option);
+            successful = connection->schedule_messages(routed);
         }
 
-        case CliArg::Protocol::Serial: {
-            int baudrate = Mavsdk::DEFAULT_SERIAL_BAUDRATE;
-            if (cli_arg.get_baudrate()) {
-                baudrate = cli_arg.get_baudrate();
+        if (successful) {
+            for (const auto index : indices) {
+                sent[index] = true;
             }
-            bool flow_control = cli_arg.get_flow_control();
-            return add_serial_connection(
-                cli_arg.get_path(), baudrate, flow_control, forwarding_option);
         }
-
-        default:
-            return ConnectionResult::ConnectionError;
     }
-}
 
-ConnectionResult MavsdkImpl::add_udp_connection(
-    const std::string& local_ip, const int local_port, ForwardingOption forwarding_option)
-{
-    auto new_conn = std::make_shared<UdpConnection>(
-        [this](mavlink_message_t& message, Connection* connection) {
-            receive_message(message, connection);
-        },
-        local_ip,
-        local_port,
-        forwarding_option);
-    if (!new_conn) {
-        return ConnectionResult::ConnectionError;
+    bool all_sent = true;
+    for (size_t i = 0; i < outgoing.size(); ++i) {
+        if (sent[i]) {
+            count_sent(outgoing[i]);
+        } else {
+            all_sent = false;
+        }
     }
-    ConnectionResult ret = new_conn->start();
-    if (ret == ConnectionResult::Success) {
-        add_connection(new_conn);
+
+    if (!all_sent) {
+        LogErr() << "Sending messages failed";
     }
-    return ret;
+    return all_sent;
 }
 
-ConnectionResult MavsdkImpl::setup_udp_remote(
-    const std::string& remote_ip, int remote_port, ForwardingOption forwarding_option)
+bool MavsdkImpl::send_frames(const uint8_t* data, size_t len)
 {
-    auto new_conn = std::make_shared<UdpConnection>(
-        [this](mavlink_message_t& message, Connection* connection) {
-            receive_message(message, connection);
-        },
-        "0.0.0.0",
-        0,
-        forwarding_option);
-    if (!new_conn) {
-        return ConnectionResult::ConnectionError;
+    struct Frame {
+        size_t offset;
+        size_t len;
+        uint32_t msg_id;
+        uint8_t system_id;
+        uint8_t target_system_id;
+        uint8_t target_component_id;
+        MavlinkRoutingTable::LinkMask links;
+    };
+
+    std::vector<Frame> frames;
+    MavlinkFrame frame;
+    for (size_t pos = 0; pos < len; pos += frame.len) {
+        if (!MavlinkFrame::parse(&data[pos], len - pos, frame)) {
+            LogErr() << "Not sending invalid MAVLink frames";
+            return false;
+        }
+        if (changes_outgoing(frame.msgid)) {
+            LogErr() << "Not sending frames which would need to be signed or intercepted";
+            return false;
+        }
+        const uint8_t* payload = &data[pos + frame.payload_offset];
+        frames.push_back(Frame{
+            pos,
+            frame.len,
+            frame.msgid,
+            frame.sysid,
+            get_target_system_id(frame.msgid, payload, frame.payload_len),
+            get_target_component_id(frame.msgid, payload, frame.payload_len),
+            0});
+        if (_message_logging_on) {
+            LogDebug() << "Sending frame " << frame.msgid << " from "
+                       << static_cast<int>(frame.sysid) << "/" << static_cast<int>(frame.compid);
+        }
     }
-    ConnectionResult ret = new_conn->start();
-    if (ret == ConnectionResult::Success) {
-        new_conn->add_remote(remote_ip, remote_port);
-        add_connection(new_conn);
-        std::lock_guard<std::recursive_mutex> lock(_systems_mutex);
-        make_system_with_component(0, 0, true);
+
+    if (auto tlog_writer = std::atomic_load(&_tlog_writer)) {
+        for (const auto& entry : frames) {
+            if (tlog_writer->accepts(entry.msg_id, entry.system_id, false)) {
+                tlog_writer->write_frame(&data[entry.offset], entry.len);
+            }
+        }
     }
-    return ret;
-}
 
-ConnectionResult MavsdkImpl::add_tcp_connection(
-    const std::string& remote_ip, int remote_port, ForwardingOption forwarding_option)
-{
-    auto new_conn = std::make_shared<TcpConnection>(
+    std::lock_guard<std::mutex> lock(_connections_mutex);
+
+    if (_connections.empty() || frames.empty()) {
+        return true;
+    }
+
+    for (auto& entry : frames) {
+        entry.links = _routing_table.links_for(entry.target_system_id, entry.target_component_id);
+    }
+
+    // Usually all of them go everywhere, otherwise each connection gets the
+    // ones routed to it, still in one go.
+    std::vector<bool> sent(frames.size(), false);
+    std::vector<uint8_t> routed;
+    std::vector<size_t> indices;
+    for (auto& connection : _connections) {
+        routed.clear();
+        indices.clear();
+        for (size_t i = 0; i < frames.size(); ++i) {
+            if (is_routed_to(*connection, frames[i].target_system_id, frames[i].links)) {
+                indices.push_back(i);
+            }
+        }
+        if (indices.empty()) {
+            continue;
+        }
+
+        bool successful = false;
+        if (indices.size() == frames.size()) {
+            successful = connection->schedule_frames(data, len);
+        } else {
+            for (const auto index : indices) {
+                const auto* begin = &data[frames[index].offset];
+                routed.insert(routed.end(), begin, begin + frames[index].len);
+            }
+            successful = connection->schedule_frames(routed.data(), routed.size());
+        }
+
+        if (successful) {
+            for (const auto index : indices) {
+                sent[index] = true;
+            }
+        }
+    }
+
+    bool all_sent = true;
+    for (size_t i = 0; i < frames.size(); ++i) {
+        if (sent[i]) {
+            const auto frame_len = static_cast<unsigned>(frames[i].len);
+            _message_stats.count_sent(frames[i].msg_id, frame_len);
+            if (frames[i].target_system_id != 0) {
+                system_message_stats(frames[i].target_system_id)
+                    .count_sent(frames[i].msg_id, frame_len);
+            }
+        } else {
+            all_sent = false;
+        }
+    }
+
+    if (!all_sent) {
+        LogErr() << "Sending frames failed";
+    }
+    return all_sent;
+}
+
+bool MavsdkImpl::changes_outgoing(uint32_t message_id) const
+{
+    return _signing.load(std::memory_order_acquire) != nullptr ||
+           _outgoing_interceptors.matches(message_id);
+}
+
+bool MavsdkImpl::prepare_outgoing_message(mavlink_message_t& message)
+{
+    if (_message_logging_on) {
+        LogDebug() << "Sending message " << message.msgid << " from "
+                   << static_cast<int>(message.sysid) << "/" << static_cast<int>(message.compid);
+    }
+
+    // This is a low level interface where outgoing messages can be tampered
+    // with or even dropped.
+    if (!_outgoing_interceptors.process(message)) {
+        LogDebug() << "Dropped outgoing message: " << int(message.msgid);
+        return false;
+    }
+
+    if (auto* signing = _signing.load(std::memory_order_acquire)) {
+        signing->sign(message);
+    }
+
+    if (auto tlog_writer = std::atomic_load(&_tlog_writer)) {
+        if (tlog_writer->accepts(message.msgid, message.sysid, false)) {
+            tlog_writer->write(message);
+        }
+    }
+
+    return true;
+}
+
+void MavsdkImpl::count_sent(const mavlink_message_t& message)
+{
+    _message_stats.count_sent(message);
+    const uint8_t target_system_id = get_target_system_id(message);
+    if (target_system_id != 0) {
+        system_message_stats(target_system_id).count_sent(message);
+    }
+}
+
+ConnectionResult MavsdkImpl::add_any_connection(
+    const std::string& connection_url, ForwardingOption forwarding_option)
+{
+    CliArg cli_arg;
+    if (!cli_arg.parse(connection_url)) {
+        return ConnectionResult::ConnectionUrlInvalid;
+    }
+
+    switch (cli_arg.get_protocol()) {
+        case CliArg::Protocol::Udp: {
+            int port = cli_arg.get_port() ? cli_arg.get_port() : Mavsdk::DEFAULT_UDP_PORT;
+
+            if (cli_arg.get_path().empty() || cli_arg.get_path() == Mavsdk::DEFAULT_UDP_BIND_IP) {
+                std::string path = Mavsdk::DEFAULT_UDP_BIND_IP;
+                return add_udp_connection(path, port, forwarding_option);
+            } else {
+                std::string path = cli_arg.get_path();
+                return setup_udp_remote(path, port, forwarding_option);
+            }
+        }
+
+        case CliArg::Protocol::Tcp: {
+            std::string path = Mavsdk::DEFAULT_TCP_REMOTE_IP;
+            int port = Mavsdk::DEFAULT_TCP_REMOTE_PORT;
+            if (!cli_arg.get_path().empty()) {
+                path = cli_arg.get_path();
+            }
+            if (cli_arg.get_port()) {
+                port = cli_arg.get_port();
+            }
+            return add_tcp_connection(path, port, forwarding_option);
+        }
+
+        case CliArg::Protocol::TcpIn: {
+            std::string path = Mavsdk::DEFAULT_TCP_SERVER_BIND_IP;
+            int port = Mavsdk::DEFAULT_TCP_SERVER_PORT;
+            if (!cli_arg.get_path().empty()) {
+                path = cli_arg.get_path();
+            }
+            if (cli_arg.get_port()) {
+                port = cli_arg.get_port();
+            }
+            return add_tcp_server_connection(path, port, forwarding_option);
+        }
+
+        case CliArg::Protocol::Serial: {
+            int baudrate = Mavsdk::DEFAULT_SERIAL_BAUDRATE;
+            if (cli_arg.get_baudrate()) {
+                baudrate = cli_arg.get_baudrate();
+            }
+            bool flow_control = cli_arg.get_flow_control();
+            return add_serial_connection(
+                cli_arg.get_path(), baudrate, flow_control, forwarding_option);
+        }
+
+        case CliArg::Protocol::Tlog:
+            return add_tlog_replay_connection(
+                cli_arg.get_path(), cli_arg.get_tlog_max_speed(), forwarding_option);
+
+        case CliArg::Protocol::Loopback:
+            return add_loopback_connection(cli_arg.get_path(), forwarding_option);
+
+        default:
+            return ConnectionResult::ConnectionError;
+    }
+}
+
+ConnectionResult MavsdkImpl::add_udp_connection(
+    const std::string& local_ip, const int local_port, ForwardingOption forwarding_option)
+{
+    auto new_conn = std::make_shared<UdpConnection>(
+        [this](mavlink_message_t& message, Connection* connection) {
+            receive_message(message, connection);
+        },
+        local_ip,
+        local_port,
+        forwarding_option);
+    if (!new_conn) {
+        return ConnectionResult::ConnectionError;
+    }
+    new_conn->set_send_coalesce_delay_s(_udp_send_coalesce_delay_s);
+    new_conn->set_receive_threads(_udp_receive_threads);
+    new_conn->set_io_reactor(io_reactor_for_new_connection());
+    new_conn->set_io_uring_receiver(io_uring_receiver_for_new_connection());
+    new_conn->set_bandwidth_limit(_bandwidth_limit);
+    new_conn->set_link_emulation(link_emulation());
+    new_conn->set_receive_queue(_receive_queue_capacity, _receive_queue_overflow_policy);
+    new_conn->set_link_index(_next_link_index++);
+    ConnectionResult ret = new_conn->start();
+    if (ret == ConnectionResult::Success) {
+        add_connection(new_conn);
+    }
+    return ret;
+}
+
+ConnectionResult MavsdkImpl::setup_udp_remote(
+    const std::string& remote_ip, int remote_port, ForwardingOption forwarding_option)
+{
+    auto new_conn = std::make_shared<UdpConnection>(
+        [this](mavlink_message_t& message, Connection* connection) {
+            receive_message(message, connection);
+        },
+        "0.0.0.0",
+        0,
+        forwarding_option);
+    if (!new_conn) {
+        return ConnectionResult::ConnectionError;
+    }
+    new_conn->set_send_coalesce_delay_s(_udp_send_coalesce_delay_s);
+    new_conn->set_io_reactor(io_reactor_for_new_connection());
+    new_conn->set_io_uring_receiver(io_uring_receiver_for_new_connection());
+    new_conn->set_bandwidth_limit(_bandwidth_limit);
+    new_conn->set_link_emulation(link_emulation());
+    new_conn->set_receive_queue(_receive_queue_capacity, _receive_queue_overflow_policy);
+    new_conn->set_link_index(_next_link_index++);
+    ConnectionResult ret = new_conn->start();
+    if (ret == ConnectionResult::Success) {
+        new_conn->add_remote(remote_ip, remote_port);
+        add_connection(new_conn);
+        std::lock_guard<std::recursive_mutex> lock(_systems_mutex);
+        make_system_with_component(0, 0, true);
+    }
+    return ret;
+}
+
+ConnectionResult MavsdkImpl::add_tcp_connection(
+    const std::string& remote_ip, int remote_port, ForwardingOption forwarding_option)
+{
+    auto new_conn = std::make_shared<TcpConnection>(
         [this](mavlink_message_t& message, Connection* connection) {
             receive_message(message, connection);
         },
@@ -549,6 +1182,35 @@ ConnectionResult MavsdkImpl::add_tcp_connection(
     if (!new_conn) {
         return ConnectionResult::ConnectionError;
     }
+    new_conn->set_bandwidth_limit(_bandwidth_limit);
+    new_conn->set_link_emulation(link_emulation());
+    new_conn->set_receive_queue(_receive_queue_capacity, _receive_queue_overflow_policy);
+    new_conn->set_link_index(_next_link_index++);
+    ConnectionResult ret = new_conn->start();
+    if (ret == ConnectionResult::Success) {
+        add_connection(new_conn);
+    }
+    return ret;
+}
+
+ConnectionResult MavsdkImpl::add_tcp_server_connection(
+    const std::string& local_ip, int local_port, ForwardingOption forwarding_option)
+{
+    auto new_conn = std::make_shared<TcpServerConnection>(
+        [this](mavlink_message_t& message, Connection* connection) {
+            receive_message(message, connection);
+        },
+        local_ip,
+        local_port,
+        forwarding_option);
+    if (!new_conn) {
+        return ConnectionResult::ConnectionError;
+    }
+    new_conn->set_io_reactor(io_reactor_for_new_connection());
+    new_conn->set_bandwidth_limit(_bandwidth_limit);
+    new_conn->set_link_emulation(link_emulation());
+    new_conn->set_receive_queue(_receive_queue_capacity, _receive_queue_overflow_policy);
+    new_conn->set_link_index(_next_link_index++);
     ConnectionResult ret = new_conn->start();
     if (ret == ConnectionResult::Success) {
         add_connection(new_conn);
@@ -573,6 +1235,11 @@ ConnectionResult MavsdkImpl::add_serial_connection(
     if (!new_conn) {
         return ConnectionResult::ConnectionError;
     }
+    new_conn->set_io_reactor(io_reactor_for_new_connection());
+    new_conn->set_bandwidth_limit(_bandwidth_limit);
+    new_conn->set_link_emulation(link_emulation());
+    new_conn->set_receive_queue(_receive_queue_capacity, _receive_queue_overflow_policy);
+    new_conn->set_link_index(_next_link_index++);
     ConnectionResult ret = new_conn->start();
     if (ret == ConnectionResult::Success) {
         add_connection(new_conn);
@@ -589,12 +1256,516 @@ ConnectionResult MavsdkImpl::add_serial_connection(
     return ret;
 }
 
+ConnectionResult MavsdkImpl::add_tlog_replay_connection(
+    const std::string& path, bool max_speed, ForwardingOption forwarding_option)
+{
+    auto new_conn = std::make_shared<TlogReplayConnection>(
+        [this](mavlink_message_t& message, Connection* connection) {
+            receive_message(message, connection);
+        },
+        path,
+        max_speed,
+        forwarding_option);
+    if (!new_conn) {
+        return ConnectionResult::ConnectionError;
+    }
+    new_conn->set_link_index(_next_link_index++);
+    ConnectionResult ret = new_conn->start();
+    if (ret == ConnectionResult::Success) {
+        add_connection(new_conn);
+    }
+    return ret;
+}
+
+void MavsdkImpl::set_link_emulation(const LinkEmulation& link_emulation)
+{
+    std::lock_guard<std::mutex> lock(_link_emulation_mutex);
+    _link_emulation = link_emulation;
+}
+
+LinkEmulation MavsdkImpl::link_emulation() const
+{
+    std::lock_guard<std::mutex> lock(_link_emulation_mutex);
+    return _link_emulation;
+}
+
+void MavsdkImpl::set_receive_queue(
+    size_t capacity, Mavsdk::ReceiveQueueOverflowPolicy overflow_policy)
+{
+    _receive_queue_capacity = capacity;
+    _receive_queue_overflow_policy =
+        overflow_policy == Mavsdk::ReceiveQueueOverflowPolicy::DropOldest ?
+            CallbackQueueBase::OverflowPolicy::DropOldest :
+            CallbackQueueBase::OverflowPolicy::DropNewest;
+}
+
+ConnectionResult MavsdkImpl::add_loopback_connection(
+    const std::string& name, ForwardingOption forwarding_option)
+{
+    auto new_conn = std::make_shared<LoopbackConnection>(
+        [this](mavlink_message_t& message, Connection* connection) {
+            receive_message(message, connection);
+        },
+        name,
+        forwarding_option);
+    if (!new_conn) {
+        return ConnectionResult::ConnectionError;
+    }
+    new_conn->set_bandwidth_limit(_bandwidth_limit);
+    new_conn->set_link_emulation(link_emulation());
+    new_conn->set_receive_queue(_receive_queue_capacity, _receive_queue_overflow_policy);
+    new_conn->set_link_index(_next_link_index++);
+    ConnectionResult ret = new_conn->start();
+    if (ret == ConnectionResult::Success) {
+        add_connection(new_conn);
+    }
+    return ret;
+}
+
+bool MavsdkImpl::start_tlog_recording(const std::string& path, const TlogFilter& filter)
+{
+    auto tlog_writer = std::make_shared<TlogWriter>();
+    tlog_writer->set_filter(filter);
+    if (!tlog_writer->open(path)) {
+        return false;
+    }
+
+    // The previous one, if any, is closed once the last message being
+    // written to it is done.
+    std::atomic_store(&_tlog_writer, tlog_writer);
+    return true;
+}
+
+void MavsdkImpl::stop_tlog_recording()
+{
+    std::atomic_store(&_tlog_writer, std::shared_ptr<TlogWriter>{});
+}
+
+uint64_t MavsdkImpl::tlog_dropped_bytes() const
+{
+    auto tlog_writer = std::atomic_load(&_tlog_writer);
+    return tlog_writer ? tlog_writer->dropped_bytes() : 0;
+}
+
+void MavsdkImpl::set_param_cache_directory(const std::string& directory)
+{
+    std::lock_guard<std::mutex> lock(_param_cache_directory_mutex);
+    if (directory == _param_cache_directory) {
+        return;
+    }
+    _param_cache_directory = directory;
+
+    // Whoever still uses the old store keeps it open until done.
+    _state_store = directory.empty() ?
+                       nullptr :
+                       std::make_shared<StateStore>(directory + path_separator + "mavsdk.state");
+}
+
+std::shared_ptr<StateStore> MavsdkImpl::state_store() const
+{
+    std::lock_guard<std::mutex> lock(_param_cache_directory_mutex);
+    return _state_store;
+}
+
+void MavsdkImpl::enable_message_signing(const MavlinkSigning::SecretKey& secret_key)
+{
+    std::lock_guard<std::mutex> lock(_signing_mutex);
+    _signing_states.push_back(std::make_unique<MavlinkSigning>(secret_key, 0));
+    _signing.store(_signing_states.back().get(), std::memory_order_release);
+}
+
+void MavsdkImpl::disable_message_signing()
+{
+    _signing.store(nullptr, std::memory_order_release);
+}
+
 void MavsdkImpl::add_connection(const std::shared_ptr<Connection>& new_connection)
 {
     std::lock_guard<std::mutex> lock(_connections_mutex);
     _connections.push_back(new_connection);
 }
 
+void MavsdkImpl::set_shared_receive_thread_enabled(bool enabled)
+{
+    if (enabled && !IoReactor::is_supported()) {
+        LogWarn() << "Shared receive thread not supported on this platform";
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(_connections_mutex);
+    _shared_receive_thread_enabled = enabled;
+}
+
+IoReactor* MavsdkImpl::io_reactor_for_new_connection()
+{
+    std::lock_guard<std::mutex> lock(_connections_mutex);
+
+    if (!_shared_receive_thread_enabled) {
+        return nullptr;
+    }
+
+    // Once created, we keep it around for the connections already using it.
+    if (!_io_reactor) {
+        _io_reactor = std::make_unique<IoReactor>();
+    }
+    return _io_reactor.get();
+}
+
+void MavsdkImpl::set_io_uring_enabled(bool enabled)
+{
+    if (enabled && !IoUringReceiver::is_supported()) {
+        LogWarn() << "Receiving with io_uring not supported on this system";
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(_connections_mutex);
+    _io_uring_enabled = enabled;
+}
+
+IoUringReceiver* MavsdkImpl::io_uring_receiver_for_new_connection()
+{
+    std::lock_guard<std::mutex> lock(_connections_mutex);
+
+    if (!_io_uring_enabled) {
+        return nullptr;
+    }
+
+    // Once created, we keep it around for the connections already using it.
+    if (!_io_uring_receiver) {
+        _io_uring_receiver = std::make_unique<IoUringReceiver>();
+    }
+    return _io_uring_receiver.get();
+}
+
+void MavsdkImpl::set_shared_system_thread_enabled(bool enabled)
+{
+    std::lock_guard<std::recursive_mutex> lock(_systems_mutex);
+    _shared_system_thread_enabled = enabled;
+}
+
+SystemWorker* MavsdkImpl::system_worker_for_new_system()
+{
+    std::lock_guard<std::recursive_mutex> lock(_systems_mutex);
+
+    if (!_shared_system_thread_enabled) {
+        return nullptr;
+    }
+
+    // Once created, we keep it around for the systems already using it.
+    if (!_system_worker) {
+        _system_worker = std::make_unique<SystemWorker>();
+    }
+    return _system_worker.get();
+}
+
+void MavsdkImpl::send_fleet_command_async(
+    const std::vector<std::shared_ptr<System>>& systems,
+    const FleetCommand& command,
+    const Mavsdk::FleetCommandCallback& callback)
+{
+    FleetCommandSender::CommandLong command_long{};
+    command_long.command = command.command;
+    command_long.target_component_id = command.target_component_id;
+    command_long.params.maybe_param1 = maybe_param(command.param1);
+    command_long.params.maybe_param2 = maybe_param(command.param2);
+    command_long.params.maybe_param3 = maybe_param(command.param3);
+    command_long.params.maybe_param4 = maybe_param(command.param4);
+    command_long.params.maybe_param5 = maybe_param(command.param5);
+    command_long.params.maybe_param6 = maybe_param(command.param6);
+    command_long.params.maybe_param7 = maybe_param(command.param7);
+
+    // Systems which aren't connected don't get the command, but still get
+    // their place in the outcome.
+    std::vector<FleetCommandOutcome> outcomes;
+    std::vector<FleetCommandSender::Target> targets;
+    for (const auto& system : systems) {
+        auto system_impl = system->system_impl();
+        FleetCommandOutcome outcome{};
+        outcome.system_id = system_impl->get_system_id();
+        if (system_impl->is_connected()) {
+            targets.push_back({outcome.system_id, system_impl->autopilot()});
+        } else {
+            outcome.result = FleetCommandResult::NoSystem;
+        }
+        outcomes.push_back(outcome);
+    }
+
+    _fleet_command_sender.send_command_async(
+        command_long,
+        targets,
+        [this, callback, outcomes = std::move(outcomes)](
+            std::vector<std::pair<uint8_t, FleetCommandSender::Result>> results) mutable {
+            auto result = results.begin();
+            for (auto& outcome : outcomes) {
+                if (outcome.result != FleetCommandResult::NoSystem && result != results.end()) {
+                    outcome.result = to_fleet_command_result(result->second);
+                    ++result;
+                }
+            }
+            if (callback) {
+                call_user_callback([callback, outcomes]() { callback(outcomes); });
+            }
+        });
+}
+
+bool MavsdkImpl::receive_fleet_command_ack(const mavlink_message_t& message)
+{
+    return _fleet_command_sender.receive_command_ack(message);
+}
+
+void MavsdkImpl::set_fleet_params_async(
+    const std::vector<std::shared_ptr<System>>& systems,
+    const std::vector<FleetParam>& params,
+    const Mavsdk::FleetParamsCallback& callback)
+{
+    auto call = std::make_shared<FleetParamsCall>();
+    call->callback = callback;
+    const auto targets = start_fleet_params_call(*call, systems, params);
+
+    // One list for all systems, instead of one copy each.
+    const auto shared_params = to_shared_params(params);
+    for (const auto& [index, system_impl] : targets) {
+        system_impl->set_params_async(
+            shared_params,
+            [this, call, index = index](std::vector<MAVLinkParameters::Result> results) {
+                {
+                    std::lock_guard<std::mutex> lock(call->mutex);
+                    auto& outcome = call->outcomes[index];
+                    for (size_t i = 0; i < results.size() && i < outcome.results.size(); ++i) {
+                        outcome.results[i] = to_fleet_param_result(results[i]);
+                    }
+                }
+                finish_fleet_params_call(call);
+            });
+    }
+    finish_fleet_params_call(call);
+}
+
+void MavsdkImpl::get_fleet_params_async(
+    const std::vector<std::shared_ptr<System>>& systems,
+    const std::vector<FleetParam>& params,
+    const Mavsdk::FleetParamsCallback& callback)
+{
+    auto call = std::make_shared<FleetParamsCall>();
+    call->callback = callback;
+    const auto targets = start_fleet_params_call(*call, systems, params);
+
+    const auto shared_params = to_shared_params(params);
+    for (const auto& [index, system_impl] : targets) {
+        system_impl->get_params_async(
+            shared_params,
+            [this, call, index = index](
+                std::vector<std::pair<MAVLinkParameters::Result, MAVLinkParameters::ParamValue>>
+                    results) {
+                {
+                    std::lock_guard<std::mutex> lock(call->mutex);
+                    auto& outcome = call->outcomes[index];
+                    for (size_t i = 0; i < results.size() && i < outcome.results.size(); ++i) {
+                        const auto& [result, value] = results[i];
+                        outcome.results[i] = to_fleet_param_result(result);
+                        if (result != MAVLinkParameters::Result::Success) {
+                            continue;
+                        }
+                        if (value.is<float>()) {
+                            outcome.params[i].value = value.get<float>();
+                        } else if (const auto int_value = value.get_int()) {
+                            outcome.params[i].value = static_cast<int32_t>(int_value.value());
+                        }
+                    }
+                }
+                finish_fleet_params_call(call);
+            });
+    }
+    finish_fleet_params_call(call);
+}
+
+std::vector<std::pair<size_t, std::shared_ptr<SystemImpl>>> MavsdkImpl::start_fleet_params_call(
+    FleetParamsCall& call,
+    const std::vector<std::shared_ptr<System>>& systems,
+    const std::vector<FleetParam>& params)
+{
+    std::vector<std::pair<size_t, std::shared_ptr<SystemImpl>>> targets;
+
+    std::lock_guard<std::mutex> lock(call.mutex);
+    for (size_t i = 0; i < systems.size(); ++i) {
+        auto system_impl = systems[i]->system_impl();
+
+        FleetParamOutcome outcome{};
+        outcome.system_id = system_impl->get_system_id();
+        outcome.results.assign(params.size(), FleetParamResult::NoSystem);
+        outcome.params = params;
+        call.outcomes.push_back(std::move(outcome));
+
+        if (system_impl->is_connected()) {
+            targets.emplace_back(i, std::move(system_impl));
+        }
+    }
+
+    // One more for ourselves once all are asked, so that the call also
+    // finishes if none of the systems is connected.
+    call.remaining = targets.size() + 1;
+    return targets;
+}
+
+void MavsdkImpl::finish_fleet_params_call(const std::shared_ptr<FleetParamsCall>& call)
+{
+    {
+        std::lock_guard<std::mutex> lock(call->mutex);
+        if (--call->remaining > 0) {
+            return;
+        }
+    }
+
+    if (call->callback) {
+        call_user_callback([call]() { call->callback(call->outcomes); });
+    }
+}
+
+void MavsdkImpl::download_fleet_missions_async(
+    const std::vector<std::shared_ptr<System>>& systems,
+    unsigned max_parallel,
+    const Mavsdk::FleetMissionProgressCallback& progress_callback,
+    const Mavsdk::FleetMissionCallback& callback)
+{
+    std::vector<std::shared_ptr<SystemImpl>> system_impls;
+    std::vector<FleetMissionTransfer::StartTransfer> starts;
+    for (const auto& system : systems) {
+        auto system_impl = system->system_impl();
+        starts.emplace_back([system_impl](auto transfer_progress_callback, auto done) {
+            system_impl->mission_transfer().download_items_async(
+                MAV_MISSION_TYPE_MISSION, std::move(done), std::move(transfer_progress_callback));
+        });
+        system_impls.push_back(std::move(system_impl));
+    }
+
+    start_fleet_mission_transfer(
+        system_impls, std::move(starts), max_parallel, progress_callback, callback);
+}
+
+void MavsdkImpl::upload_fleet_missions_async(
+    const std::vector<std::pair<std::shared_ptr<System>, std::vector<FleetMissionItem>>>& missions,
+    unsigned max_parallel,
+    const Mavsdk::FleetMissionProgressCallback& progress_callback,
+    const Mavsdk::FleetMissionCallback& callback)
+{
+    std::vector<std::shared_ptr<SystemImpl>> system_impls;
+    std::vector<FleetMissionTransfer::StartTransfer> starts;
+    for (const auto& [system, items] : missions) {
+        std::vector<MavlinkMissionTransfer::ItemInt> items_int;
+        std::transform(items.begin(), items.end(), std::back_inserter(items_int), to_item_int);
+
+        auto system_impl = system->system_impl();
+        starts.emplace_back([system_impl, items_int = std::move(items_int)](
+                                auto transfer_progress_callback, auto done) {
+            system_impl->mission_transfer().upload_items_async(
+                MAV_MISSION_TYPE_MISSION,
+                items_int,
+                [done](MavlinkMissionTransfer::Result result) { done(result, {}); },
+                transfer_progress_callback);
+        });
+        system_impls.push_back(std::move(system_impl));
+    }
+
+    start_fleet_mission_transfer(
+        system_impls, std::move(starts), max_parallel, progress_callback, callback);
+}
+
+void MavsdkImpl::start_fleet_mission_transfer(
+    const std::vector<std::shared_ptr<SystemImpl>>& system_impls,
+    std::vector<FleetMissionTransfer::StartTransfer> starts,
+    unsigned max_parallel,
+    const Mavsdk::FleetMissionProgressCallback& progress_callback,
+    const Mavsdk::FleetMissionCallback& callback)
+{
+    std::vector<FleetMissionOutcome> outcomes;
+    std::vector<FleetMissionTransfer::Job> jobs;
+    for (size_t i = 0; i < system_impls.size(); ++i) {
+        FleetMissionOutcome outcome{};
+        outcome.system_id = system_impls[i]->get_system_id();
+        if (system_impls[i]->is_connected()) {
+            jobs.push_back({outcome.system_id, std::move(starts[i])});
+        } else {
+            outcome.result = FleetMissionResult::NoSystem;
+        }
+        outcomes.push_back(std::move(outcome));
+    }
+
+    // Only the latest progress is of interest if they queue up.
+    auto progress_key = std::make_shared<char>();
+
+    FleetMissionTransfer::start(
+        std::move(jobs),
+        max_parallel,
+        [this, progress_callback, progress_key](float progress) {
+            if (progress_callback) {
+                call_user_callback(
+                    [progress_callback, progress]() { progress_callback(progress); },
+                    progress_key.get());
+            }
+        },
+        [this, callback, outcomes = std::move(outcomes)](
+            std::vector<FleetMissionTransfer::Outcome> transfer_outcomes) mutable {
+            auto transfer_outcome = transfer_outcomes.begin();
+            for (auto& outcome : outcomes) {
+                if (outcome.result == FleetMissionResult::NoSystem ||
+                    transfer_outcome == transfer_outcomes.end()) {
+                    continue;
+                }
+                outcome.result = to_fleet_mission_result(transfer_outcome->result);
+                std::transform(
+                    transfer_outcome->items.begin(),
+                    transfer_outcome->items.end(),
+                    std::back_inserter(outcome.items),
+                    to_fleet_mission_item);
+                ++transfer_outcome;
+            }
+            if (callback) {
+                call_user_callback([callback, outcomes]() { callback(outcomes); });
+            }
+        });
+}
+
+FleetSetpointResult MavsdkImpl::set_fleet_setpoints(
+    const std::vector<std::pair<std::shared_ptr<System>, FleetSetpoint>>& setpoints)
+{
+    // All or nothing, a formation with a vehicle missing is another one.
+    std::vector<FleetSetpointStreamer::Target> targets;
+    targets.reserve(setpoints.size());
+    for (const auto& [system, setpoint] : setpoints) {
+        auto system_impl = system->system_impl();
+        if (!system_impl->is_connected()) {
+            return FleetSetpointResult::NoSystem;
+        }
+
+        FleetSetpointStreamer::Target target{};
+        target.system_id = system_impl->get_system_id();
+        target.component_id = system_impl->get_autopilot_id();
+        target.setpoint = setpoint;
+
+        if (std::any_of(targets.begin(), targets.end(), [&](const auto& other) {
+                return other.system_id == target.system_id;
+            })) {
+            return FleetSetpointResult::InvalidArgument;
+        }
+        targets.push_back(target);
+    }
+
+    return _fleet_setpoint_streamer.set_setpoints(std::move(targets)) ?
+               FleetSetpointResult::Success :
+               FleetSetpointResult::ConnectionError;
+}
+
+FleetSetpointResult MavsdkImpl::set_fleet_setpoint_rate(double rate_hz)
+{
+    return _fleet_setpoint_streamer.set_rate_hz(rate_hz) ? FleetSetpointResult::Success :
+                                                           FleetSetpointResult::InvalidArgument;
+}
+
+void MavsdkImpl::stop_fleet_setpoints()
+{
+    _fleet_setpoint_streamer.stop();
+}
+
 Mavsdk::Configuration MavsdkImpl::get_configuration() const
 {
     return _configuration;
@@ -617,6 +1788,25 @@ void MavsdkImpl::set_configuration(Mavsdk::Configuration new_configuration)
     }
 
     _configuration = new_configuration;
+
+    // Blocks are freed by the allocator they came from, so this can change
+    // at any time.
+    mavlink_message_handler.set_allocator(allocator_for_system(0));
+    {
+        std::lock_guard<std::recursive_mutex> lock(_systems_mutex);
+        for (auto& system : _systems) {
+            system.second->system_impl()->set_allocator(allocator_for_system(system.first));
+        }
+    }
+}
+
+Mavsdk::Configuration::Allocator MavsdkImpl::allocator_for_system(uint8_t system_id) const
+{
+    const auto allocator_factory = _configuration.get_allocator_factory();
+    if (!allocator_factory) {
+        return {};
+    }
+    return allocator_factory(system_id);
 }
 
 uint8_t MavsdkImpl::get_own_system_id() const
@@ -707,6 +1897,73 @@ void MavsdkImpl::unsubscribe_on_new_system(Mavsdk::NewSystemHandle handle)
     _new_system_callbacks.unsubscribe(handle);
 }
 
+Mavsdk::LinkStatsHandle
+MavsdkImpl::subscribe_link_stats(const Mavsdk::LinkStatsCallback& callback)
+{
+    return _link_stats_callbacks.subscribe(callback);
+}
+
+void MavsdkImpl::unsubscribe_link_stats(Mavsdk::LinkStatsHandle handle)
+{
+    _link_stats_callbacks.unsubscribe(handle);
+}
+
+Mavsdk::FleetMissionStatesHandle
+MavsdkImpl::subscribe_fleet_mission_states(const Mavsdk::FleetMissionStatesCallback& callback)
+{
+    return _fleet_mission_states_callbacks.subscribe(callback);
+}
+
+void MavsdkImpl::unsubscribe_fleet_mission_states(Mavsdk::FleetMissionStatesHandle handle)
+{
+    _fleet_mission_states_callbacks.unsubscribe(handle);
+}
+
+void MavsdkImpl::report_fleet_mission_states()
+{
+    if (_fleet_mission_states_callbacks.empty()) {
+        return;
+    }
+
+    std::vector<FleetMissionState> states;
+    {
+        std::lock_guard<std::recursive_mutex> lock(_systems_mutex);
+        states.reserve(_systems.size());
+        for (const auto& [system_id, system] : _systems) {
+            const auto system_impl = system->system_impl();
+            states.push_back(FleetMissionState{
+                system_id, system_impl->mission_current_seq(), system_impl->mission_reached_seq()});
+        }
+    }
+
+    _fleet_mission_states_callbacks.queue(
+        states, [this](const auto& func) { call_user_callback(func); });
+}
+
+void MavsdkImpl::report_link_stats()
+{
+    // Reported even without subscribers, so the rates are always over one interval.
+    const double elapsed_s = _time.elapsed_since_s(_link_stats_last_time);
+    _link_stats_last_time = _time.steady_time();
+
+    std::vector<LinkStats> link_stats;
+    {
+        std::lock_guard<std::mutex> lock(_connections_mutex);
+        for (auto& connection : _connections) {
+            link_stats.push_back(connection->link_statistics().report(elapsed_s));
+            link_stats.back().connection_index = connection->link_index();
+            const auto queue_stats = connection->receive_queue_stats();
+            link_stats.back().receive_queue_dropped = queue_stats.dropped;
+            link_stats.back().receive_queue_max_depth = queue_stats.max_depth;
+        }
+    }
+
+    if (!_link_stats_callbacks.empty()) {
+        _link_stats_callbacks.queue(
+            link_stats, [this](const auto& func) { call_user_callback(func); });
+    }
+}
+
 bool MavsdkImpl::is_any_system_connected() const
 {
     std::vector<std::shared_ptr<System>> connected_systems = systems();
@@ -717,78 +1974,213 @@ bool MavsdkImpl::is_any_system_connected() const
 
 void MavsdkImpl::work_thread()
 {
+    ThreadConfig::apply(ThreadRole::Work);
+
     while (!_should_exit) {
         timeout_handler.run_once();
         call_every_handler.run_once();
+        heartbeat_monitor.run_once();
 
-        {
-            std::lock_guard<std::mutex> lock(_server_components_mutex);
-            for (auto& it : _server_components) {
-                if (it.second != nullptr) {
-                    it.second->_impl->do_work();
-                }
-            }
+        // Sleep until the next timer is due, or until someone adds a new one.
+        // Server components do their work on their own threads.
+        double wait_s = IDLE_WORK_INTERVAL_S;
+        if (auto next_timeout_s = timeout_handler.next_run_in_s()) {
+            wait_s = std::min(wait_s, *next_timeout_s);
+        }
+        if (auto next_call_every_s = call_every_handler.next_run_in_s()) {
+            wait_s = std::min(wait_s, *next_call_every_s);
+        }
+        if (auto next_heartbeat_s = heartbeat_monitor.next_run_in_s()) {
+            wait_s = std::min(wait_s, *next_heartbeat_s);
         }
 
-        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        std::unique_lock<std::mutex> lock(_work_thread_mutex);
+        if (wait_s > 0.0) {
+            _work_thread_cv.wait_for(lock, std::chrono::duration<double>(wait_s), [this]() {
+                return _work_thread_work_pending || _should_exit;
+            });
+        }
+        _work_thread_work_pending = false;
+    }
+}
+
+void MavsdkImpl::notify_work_thread()
+{
+    {
+        std::lock_guard<std::mutex> lock(_work_thread_mutex);
+        _work_thread_work_pending = true;
     }
+    _work_thread_cv.notify_one();
 }
 
 void MavsdkImpl::call_user_callback_located(
-    const std::string& filename, const int linenumber, const std::function<void()>& func)
+    const char* filename,
+    const int linenumber,
+    std::function<void()> func,
+    const void* coalesce_key,
+    unsigned executor,
+    CallbackLane lane)
 {
-    auto callback_size = _user_callback_queue.size();
-    if (callback_size == 10) {
+    UserCallback user_callback{std::move(func), filename, linenumber};
+    user_callback.enqueued_at = std::chrono::steady_clock::now();
+
+    auto& queue = _user_callback_executors[executor % _user_callback_executors.size()]->queue;
+    const auto result = queue.enqueue(lane, std::move(user_callback), coalesce_key);
+
+    if (result == CallbackQueueBase::PushResult::Dropped ||
+        result == CallbackQueueBase::PushResult::DroppedOldest) {
+        // Only complain once until the queue has caught up again.
+        if (!_user_callback_queue_overflown.exchange(true)) {
+            LogErr()
+                << "User callback queue overflown\n"
+                   "See: https://mavsdk.mavlink.io/main/en/cpp/troubleshooting.html#user_callbacks";
+        }
+
+    } else if (result == CallbackQueueBase::PushResult::Enqueued && queue.size() == 10) {
         LogWarn()
             << "User callback queue too slow.\n"
                "See: https://mavsdk.mavlink.io/main/en/cpp/troubleshooting.html#user_callbacks";
+    }
+}
 
-    } else if (callback_size == 99) {
-        LogErr()
-            << "User callback queue overflown\n"
-               "See: https://mavsdk.mavlink.io/main/en/cpp/troubleshooting.html#user_callbacks";
+unsigned MavsdkImpl::new_user_callback_executor()
+{
+    return _next_user_callback_executor++ % _user_callback_executors.size();
+}
 
-    } else if (callback_size == 100) {
-        return;
+std::vector<Mavsdk::CallbackSiteStats> MavsdkImpl::callback_site_stats() const
+{
+    // The same file can be behind several pointers, e.g. for code in headers.
+    std::map<std::pair<std::string, int>, Mavsdk::CallbackSiteStats> by_site;
+    for (const auto& executor : _user_callback_executors) {
+        std::lock_guard<std::mutex> lock(executor->site_counters_mutex);
+        for (const auto& [site, counters] : executor->site_counters) {
+            auto& stats = by_site[{site.filename, site.linenumber}];
+            stats.filename = site.filename;
+            stats.linenumber = site.linenumber;
+            DurationHistogramCounter::add(stats.wait_time, counters->wait_time.get());
+            DurationHistogramCounter::add(stats.run_time, counters->run_time.get());
+        }
     }
 
-    // We only need to keep track of filename and linenumber if we're actually debugging this.
-    UserCallback user_callback =
-        _callback_debugging ? UserCallback{func, filename, linenumber} : UserCallback{func};
+    std::vector<Mavsdk::CallbackSiteStats> result;
+    result.reserve(by_site.size());
+    for (auto& entry : by_site) {
+        result.push_back(std::move(entry.second));
+    }
 
-    _user_callback_queue.enqueue(user_callback);
+    // The ones holding up the queue the most first.
+    std::sort(result.begin(), result.end(), [](const auto& lhs, const auto& rhs) {
+        return lhs.run_time.total_ns > rhs.run_time.total_ns;
+    });
+    return result;
+}
+
+Mavsdk::CallbackQueueStats MavsdkImpl::callback_queue_stats() const
+{
+    Mavsdk::CallbackQueueStats result;
+    for (const auto& executor : _user_callback_executors) {
+        const auto stats = executor->queue.stats();
+        result.enqueued += stats.enqueued;
+        result.dropped += stats.dropped;
+        result.coalesced += stats.coalesced;
+        result.depth += executor->queue.size();
+        result.max_depth = std::max(result.max_depth, stats.max_depth);
+        DurationHistogramCounter::add(result.wait_time, executor->wait_time.get());
+        DurationHistogramCounter::add(result.run_time, executor->run_time.get());
+    }
+    return result;
 }
 
-void MavsdkImpl::process_user_callbacks_thread()
+void MavsdkImpl::process_user_callbacks_thread(UserCallbackExecutor& executor)
 {
+    ThreadConfig::apply(ThreadRole::UserCallbacks);
+
+    auto& queue = executor.queue;
+
     while (!_should_exit) {
-        auto callback = _user_callback_queue.dequeue();
+        auto callback = queue.dequeue();
         if (!callback) {
             continue;
         }
 
-        void* cookie{nullptr};
-
-        const double timeout_s = 1.0;
-        timeout_handler.add(
-            [&]() {
-                if (_callback_debugging) {
-                    LogWarn() << "Callback called from " << callback.value().filename << ":"
-                              << callback.value().linenumber << " took more than " << timeout_s
-                              << " second to run.";
-                    fflush(stdout);
-                    fflush(stderr);
-                    abort();
-                } else {
-                    LogWarn()
-                        << "Callback took more than " << timeout_s << " second to run.\n"
-                        << "See: https://mavsdk.mavlink.io/main/en/cpp/troubleshooting.html#user_callbacks";
-                }
-            },
-            timeout_s,
-            &cookie);
-        callback.value().func();
-        timeout_handler.remove(cookie);
+        const auto run_start = std::chrono::steady_clock::now();
+        executor.wait_time.record(run_start - callback.value().enqueued_at);
+        Trace::complete("callback", "wait", callback.value().enqueued_at, run_start);
+
+        if (queue.empty()) {
+            _user_callback_queue_overflown = false;
+        }
+
+        auto& site_counters = call_site_counters(
+            executor, CallSite{callback.value().filename, callback.value().linenumber});
+        site_counters.wait_time.record(run_start - callback.value().enqueued_at);
+
+        executor.running_filename.store(callback.value().filename, std::memory_order_relaxed);
+        executor.running_linenumber.store(callback.value().linenumber, std::memory_order_relaxed);
+        executor.num_runs.fetch_add(1, std::memory_order_relaxed);
+        executor.running_since_ns.store(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(run_start.time_since_epoch())
+                .count(),
+            std::memory_order_release);
+        {
+            TraceScope trace("callback", "run");
+            callback.value().func();
+        }
+        executor.running_since_ns.store(0, std::memory_order_relaxed);
+
+        const auto run_time = std::chrono::steady_clock::now() - run_start;
+        executor.run_time.record(run_time);
+        site_counters.run_time.record(run_time);
+    }
+}
+
+MavsdkImpl::CallSiteCounters&
+MavsdkImpl::call_site_counters(UserCallbackExecutor& executor, const CallSite& site)
+{
+    std::lock_guard<std::mutex> lock(executor.site_counters_mutex);
+    auto& counters = executor.site_counters[site];
+    if (!counters) {
+        counters = std::make_unique<CallSiteCounters>();
+    }
+    return *counters;
+}
+
+void MavsdkImpl::check_user_callbacks()
+{
+    const auto now_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                            std::chrono::steady_clock::now().time_since_epoch())
+                            .count();
+
+    for (auto& executor : _user_callback_executors) {
+        const auto running_since_ns = executor->running_since_ns.load(std::memory_order_acquire);
+        if (running_since_ns == 0 ||
+            static_cast<double>(now_ns - running_since_ns) / 1e9 < CALLBACK_TIMEOUT_S) {
+            continue;
+        }
+
+        const auto run = executor->num_runs.load(std::memory_order_relaxed);
+        if (run == executor->last_reported_run) {
+            continue;
+        }
+        executor->last_reported_run = run;
+
+        if (_callback_debugging) {
+            LogWarn() << "Callback called from "
+                      << executor->running_filename.load(std::memory_order_relaxed) << ":"
+                      << executor->running_linenumber.load(std::memory_order_relaxed)
+                      << " took more than " << CALLBACK_TIMEOUT_S << " second to run.";
+            fflush(stdout);
+            fflush(stderr);
+            abort();
+        } else {
+            LogWarn()
+                << "Callback called from "
+                << executor->running_filename.load(std::memory_order_relaxed) << ":"
+                << executor->running_linenumber.load(std::memory_order_relaxed)
+                << " took more than " << CALLBACK_TIMEOUT_S << " second to run.\n"
+                << "See: https://mavsdk.mavlink.io/main/en/cpp/troubleshooting.html#user_callbacks";
+        }
     }
 }
 
@@ -827,18 +2219,59 @@ void MavsdkImpl::send_heartbeat()
 
 void MavsdkImpl::intercept_incoming_messages_async(std::function<bool(mavlink_message_t&)> callback)
 {
-    _intercept_incoming_messages_callback = callback;
+    std::lock_guard<std::mutex> lock(_intercept_mutex);
+    _incoming_interceptors.remove(_intercept_incoming_handle);
+    _intercept_incoming_handle = callback ? _incoming_interceptors.add(callback, {}) :
+                                            MessageInterceptors::InterceptHandle{};
 }
 
 void MavsdkImpl::intercept_outgoing_messages_async(std::function<bool(mavlink_message_t&)> callback)
 {
-    _intercept_outgoing_messages_callback = callback;
+    std::lock_guard<std::mutex> lock(_intercept_mutex);
+    _outgoing_interceptors.remove(_intercept_outgoing_handle);
+    _intercept_outgoing_handle = callback ? _outgoing_interceptors.add(callback, {}) :
+                                            MessageInterceptors::InterceptHandle{};
+}
+
+MessageInterceptors::InterceptHandle MavsdkImpl::add_incoming_messages_interceptor(
+    const MessageInterceptors::Callback& callback, const std::vector<uint32_t>& message_ids)
+{
+    return _incoming_interceptors.add(callback, message_ids);
+}
+
+void MavsdkImpl::remove_incoming_messages_interceptor(MessageInterceptors::InterceptHandle handle)
+{
+    _incoming_interceptors.remove(handle);
+}
+
+MessageInterceptors::InterceptHandle MavsdkImpl::add_outgoing_messages_interceptor(
+    const MessageInterceptors::Callback& callback, const std::vector<uint32_t>& message_ids)
+{
+    return _outgoing_interceptors.add(callback, message_ids);
+}
+
+void MavsdkImpl::remove_outgoing_messages_interceptor(MessageInterceptors::InterceptHandle handle)
+{
+    _outgoing_interceptors.remove(handle);
 }
 
 uint8_t MavsdkImpl::get_target_system_id(const mavlink_message_t& message)
+{
+    return get_target_system_id(
+        message.msgid, reinterpret_cast<const uint8_t*>(_MAV_PAYLOAD(&message)), message.len);
+}
+
+uint8_t MavsdkImpl::get_target_component_id(const mavlink_message_t& message)
+{
+    return get_target_component_id(
+        message.msgid, reinterpret_cast<const uint8_t*>(_MAV_PAYLOAD(&message)), message.len);
+}
+
+uint8_t
+MavsdkImpl::get_target_system_id(uint32_t msg_id, const uint8_t* payload, uint8_t payload_len)
 {
     // Checks whether connection knows target system ID by extracting target system if set.
-    const mavlink_msg_entry_t* meta = mavlink_get_msg_entry(message.msgid);
+    const mavlink_msg_entry_t* meta = mavlink_get_msg_entry(msg_id);
 
     if (meta == nullptr || !(meta->flags & MAV_MSG_ENTRY_FLAG_HAVE_TARGET_SYSTEM)) {
         return 0;
@@ -846,17 +2279,18 @@ uint8_t MavsdkImpl::get_target_system_id(const mavlink_message_t& message)
 
     // Don't look at the target system offset if it is outside the payload length.
     // This can happen if the fields are trimmed.
-    if (meta->target_system_ofs >= message.len) {
+    if (meta->target_system_ofs >= payload_len) {
         return 0;
     }
 
-    return (_MAV_PAYLOAD(&message))[meta->target_system_ofs];
+    return payload[meta->target_system_ofs];
 }
 
-uint8_t MavsdkImpl::get_target_component_id(const mavlink_message_t& message)
+uint8_t
+MavsdkImpl::get_target_component_id(uint32_t msg_id, const uint8_t* payload, uint8_t payload_len)
 {
     // Checks whether connection knows target system ID by extracting target system if set.
-    const mavlink_msg_entry_t* meta = mavlink_get_msg_entry(message.msgid);
+    const mavlink_msg_entry_t* meta = mavlink_get_msg_entry(msg_id);
 
     if (meta == nullptr || !(meta->flags & MAV_MSG_ENTRY_FLAG_HAVE_TARGET_COMPONENT)) {
         return 0;
@@ -864,11 +2298,11 @@ uint8_t MavsdkImpl::get_target_component_id(const mavlink_message_t& message)
 
     // Don't look at the target component offset if it is outside the payload length.
     // This can happen if the fields are trimmed.
-    if (meta->target_component_ofs >= message.len) {
+    if (meta->target_component_ofs >= payload_len) {
         return 0;
     }
 
-    return (_MAV_PAYLOAD(&message))[meta->target_system_ofs];
+    return payload[meta->target_component_ofs];
 }
 
 } // namespace mavsdk
@@ -1,22 +1,40 @@
 #pragma once
 
+#include <array>
+#include <chrono>
 #include <mutex>
 #include <utility>
 #include <vector>
 #include <atomic>
+#include <condition_variable>
 #include <thread>
+#include <unordered_map>
 
 #include "call_every_handler.h"
+#include "callback_queue.h"
 #include "connection.h"
+#include "fleet_command_sender.h"
+#include "fleet_mission_transfer.h"
+#include "fleet_setpoint_streamer.h"
+#include "ftp_memory_files.h"
+#include "heartbeat_monitor.h"
+#include "io_reactor.h"
+#include "io_uring_receiver.h"
 #include "mavsdk.h"
 #include "mavlink_include.h"
 #include "mavlink_address.h"
 #include "mavlink_message_handler.h"
+#include "mavlink_routing_table.h"
 #include "mavlink_command_receiver.h"
-#include "safe_queue.h"
+#include "mavlink_signing.h"
+#include "message_interceptors.h"
+#include "message_statistics.h"
 #include "server_component.h"
+#include "state_store.h"
 #include "system.h"
+#include "system_worker.h"
 #include "timeout_handler.h"
+#include "tlog_writer.h"
 #include "callback_list.h"
 
 namespace mavsdk {
@@ -40,7 +58,7 @@ public:
     /** @brief Default Component ID for Camera configuration type. */
     static constexpr int DEFAULT_COMPONENT_ID_CAMERA = MAV_COMP_ID_CAMERA;
 
-    MavsdkImpl();
+    explicit MavsdkImpl(const Mavsdk::CallbackQueueOptions& callback_queue_options);
     ~MavsdkImpl();
     MavsdkImpl(const MavsdkImpl&) = delete;
     void operator=(const MavsdkImpl&) = delete;
@@ -50,6 +68,15 @@ public:
     void forward_message(mavlink_message_t& message, Connection* connection);
     void receive_message(mavlink_message_t& message, Connection* connection);
     bool send_message(mavlink_message_t& message);
+    // Sends the messages together, e.g. in as few datagrams as possible.
+    // Messages dropped by the outgoing message interception are removed.
+    bool send_messages(std::vector<mavlink_message_t>& messages);
+    // Sends already serialized frames as they are. Returns false if the data
+    // is not only complete frames, or if one of them would need to be changed.
+    bool send_frames(const uint8_t* data, size_t len);
+    // Whether messages with this ID are changed before they are sent, i.e.
+    // signed or given to an outgoing interceptor.
+    bool changes_outgoing(uint32_t message_id) const;
 
     ConnectionResult
     add_any_connection(const std::string& connection_url, ForwardingOption forwarding_option);
@@ -57,11 +84,17 @@ public:
         const std::string& local_ip, int local_port_number, ForwardingOption forwarding_option);
     ConnectionResult add_tcp_connection(
         const std::string& remote_ip, int remote_port, ForwardingOption forwarding_option);
+    ConnectionResult add_tcp_server_connection(
+        const std::string& local_ip, int local_port, ForwardingOption forwarding_option);
     ConnectionResult add_serial_connection(
         const std::string& dev_path,
         int baudrate,
         bool flow_control,
         ForwardingOption forwarding_option);
+    ConnectionResult add_tlog_replay_connection(
+        const std::string& path, bool max_speed, ForwardingOption forwarding_option);
+    ConnectionResult
+    add_loopback_connection(const std::string& name, ForwardingOption forwarding_option);
     ConnectionResult setup_udp_remote(
         const std::string& remote_ip, int remote_port, ForwardingOption forwarding_option);
 
@@ -79,6 +112,15 @@ public:
     Mavsdk::NewSystemHandle subscribe_on_new_system(const Mavsdk::NewSystemCallback& callback);
     void unsubscribe_on_new_system(Mavsdk::NewSystemHandle handle);
 
+    Mavsdk::LinkStatsHandle subscribe_link_stats(const Mavsdk::LinkStatsCallback& callback);
+    void unsubscribe_link_stats(Mavsdk::LinkStatsHandle handle);
+
+    Mavsdk::FleetMissionStatesHandle
+    subscribe_fleet_mission_states(const Mavsdk::FleetMissionStatesCallback& callback);
+    void unsubscribe_fleet_mission_states(Mavsdk::FleetMissionStatesHandle handle);
+    // Called by a system once its mission state changed.
+    void report_fleet_mission_states();
+
     void notify_on_discover();
     void notify_on_timeout();
 
@@ -88,48 +130,206 @@ public:
     void intercept_incoming_messages_async(std::function<bool(mavlink_message_t&)> callback);
     void intercept_outgoing_messages_async(std::function<bool(mavlink_message_t&)> callback);
 
+    MessageInterceptors::InterceptHandle add_incoming_messages_interceptor(
+        const MessageInterceptors::Callback& callback, const std::vector<uint32_t>& message_ids);
+    void remove_incoming_messages_interceptor(MessageInterceptors::InterceptHandle handle);
+    MessageInterceptors::InterceptHandle add_outgoing_messages_interceptor(
+        const MessageInterceptors::Callback& callback, const std::vector<uint32_t>& message_ids);
+    void remove_outgoing_messages_interceptor(MessageInterceptors::InterceptHandle handle);
+
     std::shared_ptr<ServerComponent> server_component_by_type(
         Mavsdk::ServerComponentType server_component_type, unsigned instance = 0);
     std::shared_ptr<ServerComponent> server_component_by_id(uint8_t component_id);
 
     TimeoutHandler timeout_handler;
     CallEveryHandler call_every_handler;
-
+    HeartbeatMonitor heartbeat_monitor;
+
+    // Callbacks with the same coalesce_key can replace each other while
+    // queued, if the queue is configured to do so.
+    //
+    // Callbacks with the same executor are called on the same thread, in
+    // order per lane, earlier lanes first. Callbacks of different executors
+    // can run in parallel.
     void call_user_callback_located(
-        const std::string& filename, int linenumber, const std::function<void()>& func);
+        const char* filename,
+        int linenumber,
+        std::function<void()> func,
+        const void* coalesce_key = nullptr,
+        unsigned executor = 0,
+        CallbackLane lane = CallbackLane::Events);
+
+    // Hands out the executors round-robin, e.g. one per system.
+    unsigned new_user_callback_executor();
+
+    Mavsdk::CallbackQueueStats callback_queue_stats() const;
+    std::vector<Mavsdk::CallbackSiteStats> callback_site_stats() const;
+
+    std::vector<MessageStats> message_stats() const;
+    // Messages received from and sent to the given system.
+    std::vector<MessageStats> message_stats_of_system(uint8_t system_id) const;
+
+    MemoryUsage memory_usage();
+
+    // From the allocator factory of the configuration, 0 is for what is shared.
+    Mavsdk::Configuration::Allocator allocator_for_system(uint8_t system_id) const;
 
     void set_timeout_s(double timeout_s) { _timeout_s = timeout_s; }
 
     double timeout_s() const { return _timeout_s; };
 
+    void set_udp_send_coalesce_delay_s(double delay_s) { _udp_send_coalesce_delay_s = delay_s; }
+
+    void set_udp_receive_threads(unsigned num_threads) { _udp_receive_threads = num_threads; }
+
+    void set_bandwidth_limit(double bytes_per_s) { _bandwidth_limit = bytes_per_s; }
+
+    void set_link_emulation(const LinkEmulation& link_emulation);
+    LinkEmulation link_emulation() const;
+
+    void set_receive_queue(size_t capacity, Mavsdk::ReceiveQueueOverflowPolicy overflow_policy);
+
+    void set_shared_receive_thread_enabled(bool enabled);
+
+    void set_io_uring_enabled(bool enabled);
+
+    void set_shared_system_thread_enabled(bool enabled);
+    SystemWorker* system_worker_for_new_system();
+
+    void send_fleet_command_async(
+        const std::vector<std::shared_ptr<System>>& systems,
+        const FleetCommand& command,
+        const Mavsdk::FleetCommandCallback& callback);
+    // Returns whether the ack was for a fleet command.
+    bool receive_fleet_command_ack(const mavlink_message_t& message);
+
+    void set_fleet_params_async(
+        const std::vector<std::shared_ptr<System>>& systems,
+        const std::vector<FleetParam>& params,
+        const Mavsdk::FleetParamsCallback& callback);
+    void get_fleet_params_async(
+        const std::vector<std::shared_ptr<System>>& systems,
+        const std::vector<FleetParam>& params,
+        const Mavsdk::FleetParamsCallback& callback);
+
+    void download_fleet_missions_async(
+        const std::vector<std::shared_ptr<System>>& systems,
+        unsigned max_parallel,
+        const Mavsdk::FleetMissionProgressCallback& progress_callback,
+        const Mavsdk::FleetMissionCallback& callback);
+    void upload_fleet_missions_async(
+        const std::vector<std::pair<std::shared_ptr<System>, std::vector<FleetMissionItem>>>&
+            missions,
+        unsigned max_parallel,
+        const Mavsdk::FleetMissionProgressCallback& progress_callback,
+        const Mavsdk::FleetMissionCallback& callback);
+
+    FleetSetpointResult set_fleet_setpoints(
+        const std::vector<std::pair<std::shared_ptr<System>, FleetSetpoint>>& setpoints);
+    FleetSetpointResult set_fleet_setpoint_rate(double rate_hz);
+    void stop_fleet_setpoints();
+
+    bool start_tlog_recording(const std::string& path, const TlogFilter& filter);
+    void stop_tlog_recording();
+    uint64_t tlog_dropped_bytes() const;
+
+    void set_param_cache_directory(const std::string& directory);
+    // What is kept about vehicles across restarts, nothing without a cache
+    // directory.
+    std::shared_ptr<StateStore> state_store() const;
+
+    void enable_message_signing(const MavlinkSigning::SecretKey& secret_key);
+    void disable_message_signing();
+
     MavlinkMessageHandler mavlink_message_handler{};
     Time time{};
+    FtpMemoryFiles ftp_memory_files{};
 
 private:
     void add_connection(const std::shared_ptr<Connection>&);
+    IoReactor* io_reactor_for_new_connection();
+    IoUringReceiver* io_uring_receiver_for_new_connection();
     void make_system_with_component(
         uint8_t system_id, uint8_t component_id, bool always_connected = false);
+    bool add_component_of_message(const mavlink_message_t& message);
 
     void work_thread();
-    void process_user_callbacks_thread();
+    void notify_work_thread();
+    struct UserCallbackExecutor;
+    void process_user_callbacks_thread(UserCallbackExecutor& executor);
 
     void send_heartbeat();
+    void report_link_stats();
     bool is_any_system_connected() const;
 
     static uint8_t get_target_system_id(const mavlink_message_t& message);
     static uint8_t get_target_component_id(const mavlink_message_t& message);
+    static uint8_t
+    get_target_system_id(uint32_t msg_id, const uint8_t* payload, uint8_t payload_len);
+    static uint8_t
+    get_target_component_id(uint32_t msg_id, const uint8_t* payload, uint8_t payload_len);
 
     std::mutex _connections_mutex{};
+    // Needs to outlive all connections using it.
+    std::unique_ptr<IoReactor> _io_reactor{};
+    bool _shared_receive_thread_enabled{false};
+    // Same as the reactor.
+    std::unique_ptr<IoUringReceiver> _io_uring_receiver{};
+    bool _io_uring_enabled{false};
     std::vector<std::shared_ptr<Connection>> _connections{};
+    std::atomic<unsigned> _next_link_index{0};
+    MavlinkRoutingTable _routing_table{};
 
     mutable std::recursive_mutex _systems_mutex{};
+    // Needs to outlive all systems using it.
+    std::unique_ptr<SystemWorker> _system_worker{};
+    bool _shared_system_thread_enabled{false};
     std::vector<std::pair<uint8_t, std::shared_ptr<System>>> _systems{};
 
+    // Components which have already been added to their system, indexed by
+    // system ID, so they can be checked without locking. Systems are never
+    // removed before destruction, so entries are never cleared.
+    class KnownComponents {
+    public:
+        bool contains(uint8_t component_id) const
+        {
+            return (_bits[component_id / 64].load(std::memory_order_acquire) &
+                    (uint64_t(1) << (component_id % 64))) != 0;
+        }
+
+        void insert(uint8_t component_id)
+        {
+            _bits[component_id / 64].fetch_or(
+                uint64_t(1) << (component_id % 64), std::memory_order_release);
+        }
+
+    private:
+        std::array<std::atomic<uint64_t>, 4> _bits{};
+    };
+    std::array<KnownComponents, 256> _known_components{};
+    // Set along with _known_components, so they can be used without locking.
+    std::array<std::atomic<SystemImpl*>, 256> _system_impls_by_id{};
+
+    MessageStatistics _message_stats{};
+    // Allocated on first use, per system ID.
+    std::array<std::atomic<MessageStatistics*>, 256> _system_message_stats{};
+    MessageStatistics& system_message_stats(uint8_t system_id);
+
+    void record_latencies(const mavlink_message_t& message, int64_t receive_time_ns);
+    static constexpr std::chrono::seconds MAX_TRANSPORT_LATENCY{10};
+
+    // Logs, intercepts, signs and records an outgoing message. Returns false
+    // if it was dropped by the interception.
+    bool prepare_outgoing_message(mavlink_message_t& message);
+    void count_sent(const mavlink_message_t& message);
+
     mutable std::mutex _server_components_mutex{};
     std::vector<std::pair<uint8_t, std::shared_ptr<ServerComponent>>> _server_components{};
     std::shared_ptr<ServerComponent> _default_server_component{nullptr};
 
     CallbackList<> _new_system_callbacks{};
+    CallbackList<std::vector<LinkStats>> _link_stats_callbacks{};
+    CallbackList<std::vector<FleetMissionState>> _fleet_mission_states_callbacks{};
 
     Time _time{};
 
@@ -137,33 +337,188 @@ private:
 
     struct UserCallback {
         UserCallback() = default;
-        explicit UserCallback(std::function<void()> func_) : func(std::move(func_)) {}
-        UserCallback(std::function<void()> func_, std::string filename_, const int linenumber_) :
+        UserCallback(std::function<void()> func_, const char* filename_, const int linenumber_) :
             func(std::move(func_)),
-            filename(std::move(filename_)),
+            filename(filename_),
             linenumber(linenumber_)
         {}
 
         std::function<void()> func{};
-        std::string filename{};
+        // A string literal, so it is cheap to keep for every callback.
+        const char* filename{""};
         int linenumber{};
+        std::chrono::steady_clock::time_point enqueued_at{};
     };
 
     std::thread* _work_thread{nullptr};
-    std::thread* _process_user_callbacks_thread{nullptr};
-    SafeQueue<UserCallback> _user_callback_queue{};
+    std::mutex _work_thread_mutex{};
+    std::condition_variable _work_thread_cv{};
+    bool _work_thread_work_pending{false};
+
+    // Timers tell us when they are added, we only wake up to be sure.
+    static constexpr double IDLE_WORK_INTERVAL_S = 0.5;
+
+    struct CallSite {
+        const char* filename;
+        int linenumber;
+
+        bool operator==(const CallSite& other) const
+        {
+            return filename == other.filename && linenumber == other.linenumber;
+        }
+    };
+
+    struct CallSiteHash {
+        size_t operator()(const CallSite& site) const
+        {
+            return std::hash<const void*>()(site.filename) ^
+                   (std::hash<int>()(site.linenumber) << 1);
+        }
+    };
+
+    struct CallSiteCounters {
+        DurationHistogramCounter wait_time{};
+        DurationHistogramCounter run_time{};
+    };
+
+    struct UserCallbackExecutor {
+        UserCallbackExecutor(
+            const std::array<size_t, CallbackLanes<UserCallback>::num_lanes>& capacities,
+            CallbackQueueBase::OverflowPolicy overflow_policy) :
+            queue(capacities, overflow_policy)
+        {}
+
+        CallbackLanes<UserCallback> queue;
+        std::thread* thread{nullptr};
+        DurationHistogramCounter wait_time{};
+        DurationHistogramCounter run_time{};
+
+        // Only added to by the executor thread, the counters are recorded to
+        // without the lock.
+        mutable std::mutex site_counters_mutex{};
+        std::unordered_map<CallSite, std::unique_ptr<CallSiteCounters>, CallSiteHash>
+            site_counters{}; // Needs site_counters_mutex
+
+        // What is running right now, for the watchdog. A start of 0 means
+        // nothing is running, and each run is only reported once.
+        std::atomic<int64_t> running_since_ns{0};
+        std::atomic<const char*> running_filename{""};
+        std::atomic<int> running_linenumber{0};
+        std::atomic<uint64_t> num_runs{0};
+        uint64_t last_reported_run{0}; // Only used by the watchdog
+    };
+
+    CallSiteCounters& call_site_counters(UserCallbackExecutor& executor, const CallSite& site);
+    void check_user_callbacks();
+
+    std::vector<std::unique_ptr<UserCallbackExecutor>> _user_callback_executors{};
+    std::atomic<unsigned> _next_user_callback_executor{0};
+    std::atomic<bool> _user_callback_queue_overflown{false};
 
     bool _message_logging_on{false};
     bool _callback_debugging{false};
 
-    std::function<bool(mavlink_message_t&)> _intercept_incoming_messages_callback{nullptr};
-    std::function<bool(mavlink_message_t&)> _intercept_outgoing_messages_callback{nullptr};
+    MessageInterceptors _incoming_interceptors{};
+    MessageInterceptors _outgoing_interceptors{};
+
+    // The ones set by intercept_*_messages_async, which replace each other.
+    std::mutex _intercept_mutex{};
+    MessageInterceptors::InterceptHandle _intercept_incoming_handle{}; // Needs _intercept_mutex
+    MessageInterceptors::InterceptHandle _intercept_outgoing_handle{}; // Needs _intercept_mutex
+
+    // Loaded for every message, so it is replaced atomically.
+    std::shared_ptr<TlogWriter> _tlog_writer{};
+
+    // Loaded for every message as well, so it must not need a lock. Replaced
+    // signing states could still be in use, so they are kept until the end.
+    std::atomic<MavlinkSigning*> _signing{nullptr};
+    std::mutex _signing_mutex{};
+    std::vector<std::unique_ptr<MavlinkSigning>> _signing_states{}; // Needs _signing_mutex
+
+    mutable std::mutex _param_cache_directory_mutex{};
+    std::string _param_cache_directory{}; // Needs _param_cache_directory_mutex
+    std::shared_ptr<StateStore> _state_store{}; // Needs _param_cache_directory_mutex
 
     std::atomic<double> _timeout_s{Mavsdk::DEFAULT_TIMEOUT_S};
+    std::atomic<double> _udp_send_coalesce_delay_s{0.0};
+    std::atomic<unsigned> _udp_receive_threads{1};
+    std::atomic<double> _bandwidth_limit{0.0};
+
+    mutable std::mutex _link_emulation_mutex{};
+    LinkEmulation _link_emulation{}; // Needs _link_emulation_mutex
+
+    std::atomic<size_t> _receive_queue_capacity{0};
+    std::atomic<CallbackQueueBase::OverflowPolicy> _receive_queue_overflow_policy{
+        CallbackQueueBase::OverflowPolicy::DropNewest};
 
     static constexpr double HEARTBEAT_SEND_INTERVAL_S = 1.0;
     void* _heartbeat_send_cookie{nullptr};
 
+    static constexpr double LINK_STATS_INTERVAL_S = 1.0;
+    void* _link_stats_cookie{nullptr};
+    SteadyTimePoint _link_stats_last_time{};
+
+    // Instead of a timeout per callback, the running callbacks are checked
+    // this often.
+    static constexpr double CALLBACK_WATCHDOG_INTERVAL_S = 0.25;
+    static constexpr double CALLBACK_TIMEOUT_S = 1.0;
+    void* _callback_watchdog_cookie{nullptr};
+
+    // Fleet commands are sent by us, to any system.
+    class FleetSender : public Sender {
+    public:
+        explicit FleetSender(MavsdkImpl& mavsdk_impl) : _mavsdk_impl(mavsdk_impl) {}
+        bool send_message(mavlink_message_t& message) override
+        {
+            return _mavsdk_impl.send_message(message);
+        }
+        [[nodiscard]] uint8_t get_own_system_id() const override
+        {
+            return _mavsdk_impl.get_own_system_id();
+        }
+        [[nodiscard]] uint8_t get_own_component_id() const override
+        {
+            return _mavsdk_impl.get_own_component_id();
+        }
+        [[nodiscard]] uint8_t get_system_id() const override { return 0; }
+        [[nodiscard]] Autopilot autopilot() const override { return Autopilot::Unknown; }
+
+    private:
+        MavsdkImpl& _mavsdk_impl;
+    };
+
+    // Collects the outcome of every system of a fleet params call.
+    struct FleetParamsCall {
+        std::mutex mutex{};
+        std::vector<FleetParamOutcome> outcomes{}; // Needs mutex
+        size_t remaining{0}; // Needs mutex
+        Mavsdk::FleetParamsCallback callback{};
+    };
+
+    // Returns the connected systems to ask, by index into the outcomes.
+    std::vector<std::pair<size_t, std::shared_ptr<SystemImpl>>> start_fleet_params_call(
+        FleetParamsCall& call,
+        const std::vector<std::shared_ptr<System>>& systems,
+        const std::vector<FleetParam>& params);
+    void finish_fleet_params_call(const std::shared_ptr<FleetParamsCall>& call);
+
+    // Transfers the missions of the connected systems, the others are
+    // reported as NoSystem.
+    void start_fleet_mission_transfer(
+        const std::vector<std::shared_ptr<SystemImpl>>& system_impls,
+        std::vector<FleetMissionTransfer::StartTransfer> starts,
+        unsigned max_parallel,
+        const Mavsdk::FleetMissionProgressCallback& progress_callback,
+        const Mavsdk::FleetMissionCallback& callback);
+
+    FleetSender _fleet_sender{*this};
+    FleetCommandSender _fleet_command_sender{
+        _fleet_sender, timeout_handler, [this]() { return timeout_s(); }};
+    FleetSetpointStreamer _fleet_setpoint_streamer{
+        _fleet_sender, time, [this](std::vector<mavlink_message_t>& messages) {
+            return send_messages(messages);
+        }};
+
     std::atomic<bool> _should_exit = {false};
 };
 
@@ -0,0 +1,36 @@
+#include "mavsdk_impl.h"
+#include <benchmark/benchmark.h>
+
+using namespace mavsdk;
+
+static void BM_MavsdkImplSendMessage(benchmark::State& state)
+{
+    MavsdkImpl mavsdk_impl(Mavsdk::CallbackQueueOptions{});
+
+    // Nobody is listening, which doesn't matter for UDP.
+    if (mavsdk_impl.setup_udp_remote("127.0.0.1", 14599, ForwardingOption::ForwardingOff) !=
+        ConnectionResult::Success) {
+        state.SkipWithError("Could not set up UDP connection");
+        return;
+    }
+
+    mavlink_message_t message;
+    mavlink_msg_attitude_pack(
+        mavsdk_impl.get_own_system_id(),
+        mavsdk_impl.get_own_component_id(),
+        &message,
+        0,
+        0.1f,
+        0.2f,
+        0.3f,
+        0.01f,
+        0.02f,
+        0.03f);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(mavsdk_impl.send_message(message));
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_MavsdkImplSendMessage);
@@ -0,0 +1,201 @@
+#include "mavsdk_math.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MAVSDK_MATH_SSE2
+#include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define MAVSDK_MATH_NEON
+#include <arm_neon.h>
+#endif
+
+namespace mavsdk {
+
+namespace {
+
+// The same operations on one float, or on 4 of them at once, so that the
+// conversion below is only written once.
+struct ScalarOps {
+    using V = float;
+    using Mask = bool;
+
+    static V set(float value) { return value; }
+    static V add(V a, V b) { return a + b; }
+    static V sub(V a, V b) { return a - b; }
+    static V mul(V a, V b) { return a * b; }
+    static V div(V a, V b) { return a / b; }
+    static V min(V a, V b) { return std::min(a, b); }
+    static V max(V a, V b) { return std::max(a, b); }
+    static V abs(V a) { return std::abs(a); }
+    static V sqrt(V a) { return std::sqrt(a); }
+    static Mask greater(V a, V b) { return a > b; }
+    static V select(Mask mask, V a, V b) { return mask ? a : b; }
+    static V copysign(V magnitude, V sign) { return std::copysign(magnitude, sign); }
+};
+
+#if defined(MAVSDK_MATH_SSE2)
+struct SimdOps {
+    using V = __m128;
+    using Mask = __m128;
+
+    static V set(float value) { return _mm_set1_ps(value); }
+    static V add(V a, V b) { return _mm_add_ps(a, b); }
+    static V sub(V a, V b) { return _mm_sub_ps(a, b); }
+    static V mul(V a, V b) { return _mm_mul_ps(a, b); }
+    static V div(V a, V b) { return _mm_div_ps(a, b); }
+    static V min(V a, V b) { return _mm_min_ps(a, b); }
+    static V max(V a, V b) { return _mm_max_ps(a, b); }
+    static V abs(V a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+    static V sqrt(V a) { return _mm_sqrt_ps(a); }
+    static Mask greater(V a, V b) { return _mm_cmpgt_ps(a, b); }
+    static V select(Mask mask, V a, V b)
+    {
+        return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+    }
+    static V copysign(V magnitude, V sign)
+    {
+        const V sign_bit = _mm_set1_ps(-0.0f);
+        return _mm_or_ps(_mm_andnot_ps(sign_bit, magnitude), _mm_and_ps(sign_bit, sign));
+    }
+};
+#elif defined(MAVSDK_MATH_NEON)
+struct SimdOps {
+    using V = float32x4_t;
+    using Mask = uint32x4_t;
+
+    static V set(float value) { return vdupq_n_f32(value); }
+    static V add(V a, V b) { return vaddq_f32(a, b); }
+    static V sub(V a, V b) { return vsubq_f32(a, b); }
+    static V mul(V a, V b) { return vmulq_f32(a, b); }
+    static V div(V a, V b) { return vdivq_f32(a, b); }
+    static V min(V a, V b) { return vminq_f32(a, b); }
+    static V max(V a, V b) { return vmaxq_f32(a, b); }
+    static V abs(V a) { return vabsq_f32(a); }
+    static V sqrt(V a) { return vsqrtq_f32(a); }
+    static Mask greater(V a, V b) { return vcgtq_f32(a, b); }
+    static V select(Mask mask, V a, V b) { return vbslq_f32(mask, a, b); }
+    static V copysign(V magnitude, V sign)
+    {
+        return vbslq_f32(vdupq_n_u32(0x80000000), sign, magnitude);
+    }
+};
+#endif
+
+constexpr float pi_f = static_cast<float>(PI);
+
+// Polynomial for atan on [0, 1], accurate to about 1e-5 rad.
+template<typename Ops> typename Ops::V atan2_approx(typename Ops::V y, typename Ops::V x)
+{
+    using V = typename Ops::V;
+
+    const V abs_x = Ops::abs(x);
+    const V abs_y = Ops::abs(y);
+
+    // Without anything to divide by, the result is 0 anyway.
+    const V ratio =
+        Ops::div(Ops::min(abs_x, abs_y), Ops::max(Ops::max(abs_x, abs_y), Ops::set(1e-30f)));
+    const V ratio_2 = Ops::mul(ratio, ratio);
+
+    V atan = Ops::set(-0.01172120f);
+    atan = Ops::add(Ops::mul(atan, ratio_2), Ops::set(0.05265332f));
+    atan = Ops::add(Ops::mul(atan, ratio_2), Ops::set(-0.11643287f));
+    atan = Ops::add(Ops::mul(atan, ratio_2), Ops::set(0.19354346f));
+    atan = Ops::add(Ops::mul(atan, ratio_2), Ops::set(-0.33262347f));
+    atan = Ops::add(Ops::mul(atan, ratio_2), Ops::set(0.99997726f));
+    atan = Ops::mul(atan, ratio);
+
+    // Back to the octant and quadrant it came from.
+    atan = Ops::select(Ops::greater(abs_y, abs_x), Ops::sub(Ops::set(pi_f / 2.0f), atan), atan);
+    atan = Ops::select(Ops::greater(Ops::set(0.0f), x), Ops::sub(Ops::set(pi_f), atan), atan);
+    return Ops::copysign(atan, y);
+}
+
+template<typename Ops>
+void to_euler_angles_deg(
+    typename Ops::V w,
+    typename Ops::V x,
+    typename Ops::V y,
+    typename Ops::V z,
+    typename Ops::V& roll_deg,
+    typename Ops::V& pitch_deg,
+    typename Ops::V& yaw_deg)
+{
+    using V = typename Ops::V;
+
+    const V one = Ops::set(1.0f);
+    const V two = Ops::set(2.0f);
+    const V to_deg = Ops::set(static_cast<float>(180.0 / PI));
+
+    const V roll = atan2_approx<Ops>(
+        Ops::mul(two, Ops::add(Ops::mul(w, x), Ops::mul(y, z))),
+        Ops::sub(one, Ops::mul(two, Ops::add(Ops::mul(x, x), Ops::mul(y, y)))));
+
+    // asin(s) is atan2(s, sqrt(1 - s^2)).
+    const V sin_pitch = Ops::max(
+        Ops::set(-1.0f),
+        Ops::min(one, Ops::mul(two, Ops::sub(Ops::mul(w, y), Ops::mul(z, x)))));
+    const V pitch =
+        atan2_approx<Ops>(sin_pitch, Ops::sqrt(Ops::sub(one, Ops::mul(sin_pitch, sin_pitch))));
+
+    const V yaw = atan2_approx<Ops>(
+        Ops::mul(two, Ops::add(Ops::mul(w, z), Ops::mul(x, y))),
+        Ops::sub(one, Ops::mul(two, Ops::add(Ops::mul(y, y), Ops::mul(z, z)))));
+
+    roll_deg = Ops::mul(roll, to_deg);
+    pitch_deg = Ops::mul(pitch, to_deg);
+    yaw_deg = Ops::mul(yaw, to_deg);
+}
+
+} // namespace
+
+void to_euler_angles_deg_from_quaternions(
+    const float* quaternions, float* euler_angles_deg, std::size_t count)
+{
+    std::size_t i = 0;
+
+#if defined(MAVSDK_MATH_SSE2)
+    for (; i + 4 <= count; i += 4) {
+        __m128 w = _mm_loadu_ps(quaternions + 4 * i);
+        __m128 x = _mm_loadu_ps(quaternions + 4 * i + 4);
+        __m128 y = _mm_loadu_ps(quaternions + 4 * i + 8);
+        __m128 z = _mm_loadu_ps(quaternions + 4 * i + 12);
+        _MM_TRANSPOSE4_PS(w, x, y, z);
+
+        __m128 roll;
+        __m128 pitch;
+        __m128 yaw;
+        to_euler_angles_deg<SimdOps>(w, x, y, z, roll, pitch, yaw);
+
+        float rolls[4];
+        float pitches[4];
+        float yaws[4];
+        _mm_storeu_ps(rolls, roll);
+        _mm_storeu_ps(pitches, pitch);
+        _mm_storeu_ps(yaws, yaw);
+        for (std::size_t lane = 0; lane < 4; ++lane) {
+            euler_angles_deg[3 * (i + lane)] = rolls[lane];
+            euler_angles_deg[3 * (i + lane) + 1] = pitches[lane];
+            euler_angles_deg[3 * (i + lane) + 2] = yaws[lane];
+        }
+    }
+#elif defined(MAVSDK_MATH_NEON)
+    for (; i + 4 <= count; i += 4) {
+        const float32x4x4_t q = vld4q_f32(quaternions + 4 * i);
+
+        float32x4x3_t euler;
+        to_euler_angles_deg<SimdOps>(
+            q.val[0], q.val[1], q.val[2], q.val[3], euler.val[0], euler.val[1], euler.val[2]);
+        vst3q_f32(euler_angles_deg + 3 * i, euler);
+    }
+#endif
+
+    for (; i < count; ++i) {
+        const float* q = quaternions + 4 * i;
+        float* euler = euler_angles_deg + 3 * i;
+        to_euler_angles_deg<ScalarOps>(q[0], q[1], q[2], q[3], euler[0], euler[1], euler[2]);
+    }
+}
+
+} // namespace mavsdk
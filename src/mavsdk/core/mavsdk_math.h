@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstddef>
+
 namespace mavsdk {
 
 // Instead of using the constant from math.h or cmath we define it ourselves. This way
@@ -22,4 +24,14 @@ template<typename T> constexpr T constrain(T input, T min, T max)
     return (input > max) ? max : (input < min) ? min : input;
 }
 
+// Converts many quaternions to Euler angles at once, e.g. for a history or a
+// replayed log, with SSE2 or NEON if available.
+//
+// The quaternions are given as w, x, y, z each, the angles are returned as
+// roll, pitch, yaw in degrees each. The angles are within 0.001 degrees of
+// the exact ones, and the pitch is kept within -90 to 90 degrees for
+// quaternions which are slightly off.
+void to_euler_angles_deg_from_quaternions(
+    const float* quaternions, float* euler_angles_deg, std::size_t count);
+
 } // namespace mavsdk
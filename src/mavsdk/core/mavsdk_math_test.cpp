@@ -1,6 +1,8 @@
 #include "mavsdk_math.h"
 #include <gtest/gtest.h>
 #include <cmath>
+#include <random>
+#include <vector>
 
 using namespace mavsdk;
 
@@ -41,4 +43,72 @@ TEST(Math, RadDegFloat)
     ASSERT_FLOAT_EQ(180.0f, to_deg_from_rad(M_PI_F));
     ASSERT_FLOAT_EQ(-180.0f, to_deg_from_rad(-M_PI_F));
     ASSERT_FLOAT_EQ(360.0f, to_deg_from_rad(2.0f * M_PI_F));
-}
\ No newline at end of file
+}
+namespace {
+
+// Difference of two angles in degrees, for angles that could wrap around.
+double angle_difference_deg(double lhs, double rhs)
+{
+    return std::abs(std::remainder(lhs - rhs, 360.0));
+}
+
+} // namespace
+
+TEST(Math, BatchEulerAnglesMatchExactOnes)
+{
+    std::mt19937 prng(42);
+    std::normal_distribution<float> distribution;
+
+    // Not a multiple of 4, so the remainder is converted as well.
+    const std::size_t count = 1003;
+    std::vector<float> quaternions(4 * count);
+    for (std::size_t i = 0; i < count; ++i) {
+        float* q = &quaternions[4 * i];
+        float norm = 0.0f;
+        for (unsigned j = 0; j < 4; ++j) {
+            q[j] = distribution(prng);
+            norm += q[j] * q[j];
+        }
+        for (unsigned j = 0; j < 4; ++j) {
+            q[j] /= std::sqrt(norm);
+        }
+    }
+
+    std::vector<float> euler_angles(3 * count);
+    to_euler_angles_deg_from_quaternions(quaternions.data(), euler_angles.data(), count);
+
+    for (std::size_t i = 0; i < count; ++i) {
+        const double w = quaternions[4 * i];
+        const double x = quaternions[4 * i + 1];
+        const double y = quaternions[4 * i + 2];
+        const double z = quaternions[4 * i + 3];
+
+        const double roll =
+            to_deg_from_rad(std::atan2(2.0 * (w * x + y * z), 1.0 - 2.0 * (x * x + y * y)));
+        const double pitch =
+            to_deg_from_rad(std::asin(constrain(2.0 * (w * y - z * x), -1.0, 1.0)));
+        const double yaw =
+            to_deg_from_rad(std::atan2(2.0 * (w * z + x * y), 1.0 - 2.0 * (y * y + z * z)));
+
+        EXPECT_LT(angle_difference_deg(double(euler_angles[3 * i]), roll), 0.001) << i;
+        EXPECT_LT(std::abs(double(euler_angles[3 * i + 1]) - pitch), 0.001) << i;
+        EXPECT_LT(angle_difference_deg(double(euler_angles[3 * i + 2]), yaw), 0.001) << i;
+    }
+}
+
+TEST(Math, BatchEulerAnglesAtGimbalLock)
+{
+    // Pitched up by 90 degrees, and a bit more than normalized.
+    const float half_sqrt_2 = std::sqrt(0.5f) * 1.001f;
+    const std::vector<float> quaternions{
+        half_sqrt_2, 0.0f, half_sqrt_2, 0.0f, half_sqrt_2, 0.0f, -half_sqrt_2, 0.0f};
+
+    std::vector<float> euler_angles(6);
+    to_euler_angles_deg_from_quaternions(quaternions.data(), euler_angles.data(), 2);
+
+    EXPECT_FLOAT_EQ(euler_angles[1], 90.0f);
+    EXPECT_FLOAT_EQ(euler_angles[4], -90.0f);
+    for (const auto angle : euler_angles) {
+        EXPECT_FALSE(std::isnan(angle));
+    }
+}
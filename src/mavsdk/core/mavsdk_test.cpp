@@ -8,3 +8,16 @@ TEST(Mavsdk, version)
     Mavsdk mavsdk;
     ASSERT_GT(mavsdk.version().size(), 5);
 }
+
+TEST(Mavsdk, ReportsMemoryUsage)
+{
+    Mavsdk mavsdk;
+    ASSERT_EQ(mavsdk.add_any_connection("loopback://memory-usage"), ConnectionResult::Success);
+
+    const auto usage = mavsdk.memory_usage();
+    ASSERT_EQ(usage.connections.size(), 1u);
+    EXPECT_GT(usage.connections[0].buffer_bytes, 0u);
+    EXPECT_GT(usage.user_callback_queue_bytes, 0u);
+    EXPECT_GE(
+        usage.total_bytes, usage.connections[0].buffer_bytes + usage.user_callback_queue_bytes);
+}
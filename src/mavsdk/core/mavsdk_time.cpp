@@ -5,6 +5,10 @@
 #include <chrono>
 #include <thread>
 
+#if defined(LINUX)
+#include <time.h>
+#endif
+
 namespace mavsdk {
 
 using std::chrono::steady_clock;
@@ -20,6 +24,31 @@ SystemTimePoint Time::system_time()
     return system_clock::now();
 }
 
+SteadyTimePoint Time::coarse_steady_time()
+{
+#if defined(LINUX)
+    // The coarse clock is steady_clock as of the last tick. With a kernel
+    // ticking too slowly for it to be useful, we stay with the precise one.
+    static const bool coarse_usable = []() {
+        struct timespec resolution {};
+        return clock_getres(CLOCK_MONOTONIC_COARSE, &resolution) == 0 &&
+               resolution.tv_sec == 0 && resolution.tv_nsec <= 10'000'000;
+    }();
+
+    struct timespec now {};
+    if (_coarse_from_clock && coarse_usable && clock_gettime(CLOCK_MONOTONIC_COARSE, &now) == 0) {
+        return SteadyTimePoint(std::chrono::duration_cast<steady_clock::duration>(
+            std::chrono::seconds(now.tv_sec) + std::chrono::nanoseconds(now.tv_nsec)));
+    }
+#endif
+    return steady_time();
+}
+
+SteadyTimePoint Time::coarse_steady_time_in_future(double duration_s)
+{
+    return coarse_steady_time() + std::chrono::milliseconds(int64_t(duration_s * 1e3));
+}
+
 double Time::elapsed_s()
 {
     auto now = steady_time().time_since_epoch();
@@ -91,6 +120,7 @@ void Time::sleep_for(std::chrono::nanoseconds ns)
 
 FakeTime::FakeTime() : Time()
 {
+    _coarse_from_clock = false;
     // Start with current time so we don't start from 0.
     _current = steady_clock::now();
 }
@@ -148,9 +178,7 @@ SystemTimePoint AutopilotTime::system_time()
 
 AutopilotTimePoint AutopilotTime::now()
 {
-    std::lock_guard<std::mutex> lock(_autopilot_system_time_offset_mutex);
-    return AutopilotTimePoint(std::chrono::duration_cast<std::chrono::microseconds>(
-        system_time().time_since_epoch() + _autopilot_time_offset));
+    return time_in(system_time());
 }
 
 void AutopilotTime::shift_time_by(std::chrono::nanoseconds offset)
@@ -159,11 +187,49 @@ void AutopilotTime::shift_time_by(std::chrono::nanoseconds offset)
     _autopilot_time_offset += offset;
 };
 
+void AutopilotTime::set_offset(
+    std::chrono::nanoseconds offset, SystemTimePoint reference, double skew)
+{
+    std::lock_guard<std::mutex> lock(_autopilot_system_time_offset_mutex);
+    _autopilot_time_offset = offset;
+    _autopilot_time_reference = reference;
+    _autopilot_time_skew = skew;
+}
+
 AutopilotTimePoint AutopilotTime::time_in(SystemTimePoint local_system_time_point)
 {
     std::lock_guard<std::mutex> lock(_autopilot_system_time_offset_mutex);
     return AutopilotTimePoint(std::chrono::duration_cast<std::chrono::microseconds>(
-        local_system_time_point.time_since_epoch() + _autopilot_time_offset));
+        local_system_time_point.time_since_epoch() + offset_at(local_system_time_point)));
 };
 
+SystemTimePoint AutopilotTime::local_time_of(AutopilotTimePoint autopilot_time_point)
+{
+    std::lock_guard<std::mutex> lock(_autopilot_system_time_offset_mutex);
+    const auto without_offset = autopilot_time_point - _autopilot_time_offset;
+    if (_autopilot_time_skew == 0.0) {
+        return SystemTimePoint(std::chrono::duration_cast<std::chrono::microseconds>(
+            without_offset.time_since_epoch()));
+    }
+    // Solving time_in() for the local time, relative to the reference to keep the precision.
+    const auto since_reference = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        without_offset - _autopilot_time_reference);
+    return _autopilot_time_reference +
+           std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::nanoseconds(static_cast<int64_t>(
+                   static_cast<double>(since_reference.count()) / (1.0 + _autopilot_time_skew))));
+}
+
+std::chrono::nanoseconds AutopilotTime::offset_at(SystemTimePoint local_system_time_point) const
+{
+    if (_autopilot_time_skew == 0.0) {
+        return _autopilot_time_offset;
+    }
+    const auto since_reference = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        local_system_time_point - _autopilot_time_reference);
+    return _autopilot_time_offset +
+           std::chrono::nanoseconds(static_cast<int64_t>(
+               _autopilot_time_skew * static_cast<double>(since_reference.count())));
+}
+
 } // namespace mavsdk
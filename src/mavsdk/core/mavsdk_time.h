@@ -16,6 +16,13 @@ public:
 
     virtual SteadyTimePoint steady_time();
     virtual SystemTimePoint system_time();
+
+    // The time as of the last tick of the kernel, so a few milliseconds
+    // behind at most, but much cheaper than steady_time() and not a virtual
+    // call. Meant for timestamps and timers on hot paths which don't need
+    // to be more precise, e.g. refreshing heartbeat timeouts.
+    SteadyTimePoint coarse_steady_time();
+    SteadyTimePoint coarse_steady_time_in_future(double duration_s);
     double elapsed_s();
     double elapsed_since_s(const SteadyTimePoint& since);
     uint64_t elapsed_ms() const;
@@ -29,6 +36,11 @@ public:
     virtual void sleep_for(std::chrono::milliseconds ms);
     virtual void sleep_for(std::chrono::microseconds us);
     virtual void sleep_for(std::chrono::nanoseconds ns);
+
+protected:
+    // Whether the coarse time comes from the clock, or has to be the same as
+    // steady_time(), e.g. for time which is simulated.
+    bool _coarse_from_clock{true};
 };
 
 class FakeTime : public Time {
@@ -57,11 +69,21 @@ public:
 
     void shift_time_by(std::chrono::nanoseconds offset);
 
+    // The autopilot is ahead by offset at the reference time, and its clock
+    // runs faster by skew, e.g. 1e-5 for 10 ppm.
+    void set_offset(std::chrono::nanoseconds offset, SystemTimePoint reference, double skew);
+
     AutopilotTimePoint time_in(SystemTimePoint local_system_time_point);
 
+    SystemTimePoint local_time_of(AutopilotTimePoint autopilot_time_point);
+
 private:
+    std::chrono::nanoseconds offset_at(SystemTimePoint local_system_time_point) const;
+
     mutable std::mutex _autopilot_system_time_offset_mutex{};
     std::chrono::nanoseconds _autopilot_time_offset{};
+    SystemTimePoint _autopilot_time_reference{};
+    double _autopilot_time_skew{0.0};
 
     virtual SystemTimePoint system_time();
 };
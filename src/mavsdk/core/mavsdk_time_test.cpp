@@ -50,3 +50,44 @@ TEST(Time, ElapsedIncreasing)
     double now = time.elapsed_s();
     ASSERT_GT(now, before);
 }
+
+TEST(Time, CoarseSteadyTimeCloseToSteadyTime)
+{
+    Time time{};
+    for (int i = 0; i < 100; ++i) {
+        const SteadyTimePoint before = time.steady_time();
+        const SteadyTimePoint coarse = time.coarse_steady_time();
+        const SteadyTimePoint after = time.steady_time();
+
+        // Never ahead, and only behind by a tick of the kernel.
+        EXPECT_LE(coarse, after);
+        EXPECT_GT(coarse, before - std::chrono::milliseconds(20));
+    }
+}
+
+TEST(Time, CoarseSteadyTimeOfFakeTime)
+{
+    FakeTime time{};
+    EXPECT_EQ(time.coarse_steady_time(), time.steady_time());
+    time.sleep_for(std::chrono::seconds(10));
+    EXPECT_EQ(time.coarse_steady_time(), time.steady_time());
+}
+
+TEST(AutopilotTime, ConvertsBothWays)
+{
+    AutopilotTime autopilot_time{};
+    const SystemTimePoint reference(std::chrono::seconds(1000));
+    // 100 ppm fast to make the skew visible.
+    autopilot_time.set_offset(std::chrono::seconds(-900), reference, 1e-4);
+
+    const SystemTimePoint local(std::chrono::seconds(1100));
+    const AutopilotTimePoint autopilot = autopilot_time.time_in(local);
+    EXPECT_EQ(
+        std::chrono::duration_cast<std::chrono::microseconds>(autopilot.time_since_epoch()),
+        std::chrono::microseconds(200'010'000));
+
+    EXPECT_EQ(
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            autopilot_time.local_time_of(autopilot) - local),
+        std::chrono::microseconds(0));
+}
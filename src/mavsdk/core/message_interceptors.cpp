@@ -0,0 +1,105 @@
+#include "message_interceptors.h"
+#include <algorithm>
+
+namespace mavsdk {
+
+MessageInterceptors::Mask::Mask(const std::vector<uint32_t>& message_ids) :
+    _all(message_ids.empty())
+{
+    for (const auto message_id : message_ids) {
+        const auto word = message_id / 64;
+        if (word >= _words.size()) {
+            _words.resize(word + 1, 0);
+        }
+        _words[word] |= uint64_t{1} << (message_id % 64);
+    }
+}
+
+void MessageInterceptors::Mask::merge(const Mask& other)
+{
+    _all = _all || other._all;
+    if (other._words.size() > _words.size()) {
+        _words.resize(other._words.size(), 0);
+    }
+    for (size_t i = 0; i < other._words.size(); ++i) {
+        _words[i] |= other._words[i];
+    }
+}
+
+MessageInterceptors::InterceptHandle
+MessageInterceptors::add(const Callback& callback, const std::vector<uint32_t>& message_ids)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    const auto* chain = _chain.load(std::memory_order_relaxed);
+    auto interceptors = chain ? chain->interceptors : std::vector<Interceptor>{};
+
+    const auto id = _next_id++;
+    interceptors.push_back(Interceptor{id, callback, Mask{message_ids}});
+    publish(std::move(interceptors));
+
+    return InterceptHandle{id};
+}
+
+void MessageInterceptors::remove(InterceptHandle handle)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    const auto* chain = _chain.load(std::memory_order_relaxed);
+    if (!chain) {
+        return;
+    }
+
+    auto interceptors = chain->interceptors;
+    const auto it = std::remove_if(
+        interceptors.begin(), interceptors.end(), [&](const Interceptor& interceptor) {
+            return interceptor.id == handle._id;
+        });
+    if (it == interceptors.end()) {
+        return;
+    }
+    interceptors.erase(it, interceptors.end());
+    publish(std::move(interceptors));
+}
+
+void MessageInterceptors::publish(std::vector<Interceptor> interceptors)
+{
+    if (interceptors.empty()) {
+        // Nothing to look at for any message.
+        _chain.store(nullptr, std::memory_order_release);
+        return;
+    }
+
+    auto chain = std::make_unique<Chain>();
+    for (const auto& interceptor : interceptors) {
+        chain->mask.merge(interceptor.mask);
+    }
+    chain->interceptors = std::move(interceptors);
+
+    // The old chain might still be processing a message, so it is kept.
+    _chains.push_back(std::move(chain));
+    _chain.store(_chains.back().get(), std::memory_order_release);
+}
+
+bool MessageInterceptors::process(mavlink_message_t& message) const
+{
+    const auto* chain = _chain.load(std::memory_order_acquire);
+    if (!chain || !chain->mask.matches(message.msgid)) {
+        return true;
+    }
+
+    for (const auto& interceptor : chain->interceptors) {
+        if (interceptor.mask.matches(message.msgid) && !interceptor.callback(message)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool MessageInterceptors::matches(uint32_t message_id) const
+{
+    const auto* chain = _chain.load(std::memory_order_acquire);
+    return chain && chain->mask.matches(message_id);
+}
+
+} // namespace mavsdk
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "handle.h"
+#include "mavlink_include.h"
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace mavsdk {
+
+// A chain of interceptors which can change or drop messages, e.g. to capture
+// traffic, count it, or simulate packet loss.
+//
+// Each interceptor only sees the message IDs it asked for, so traffic that
+// none of them matches only costs a pointer load and a bit lookup. The
+// chain is replaced as a whole on every change, and the old ones are kept
+// until destruction, so messages are processed without taking a lock.
+class MessageInterceptors {
+public:
+    using Callback = std::function<bool(mavlink_message_t&)>;
+    using InterceptHandle = Handle<mavlink_message_t&>;
+
+    MessageInterceptors() = default;
+    ~MessageInterceptors() = default;
+
+    // Non-copyable
+    MessageInterceptors(const MessageInterceptors&) = delete;
+    const MessageInterceptors& operator=(const MessageInterceptors&) = delete;
+
+    // Interceptors are called in the order they were added. No message IDs
+    // means all of them.
+    InterceptHandle add(const Callback& callback, const std::vector<uint32_t>& message_ids);
+    void remove(InterceptHandle handle);
+
+    // Returns false if an interceptor dropped the message, the ones after it
+    // don't see it then.
+    bool process(mavlink_message_t& message) const;
+
+    // Whether any interceptor sees messages with this ID.
+    bool matches(uint32_t message_id) const;
+
+private:
+    class Mask {
+    public:
+        explicit Mask(const std::vector<uint32_t>& message_ids);
+        Mask() = default;
+
+        bool matches(uint32_t message_id) const
+        {
+            if (_all) {
+                return true;
+            }
+            const auto word = message_id / 64;
+            return word < _words.size() && ((_words[word] >> (message_id % 64)) & 1) != 0;
+        }
+
+        void merge(const Mask& other);
+
+    private:
+        bool _all{false};
+        std::vector<uint64_t> _words{};
+    };
+
+    struct Interceptor {
+        uint64_t id;
+        Callback callback;
+        Mask mask;
+    };
+
+    struct Chain {
+        std::vector<Interceptor> interceptors{};
+        // What any of them matches.
+        Mask mask{};
+    };
+
+    // Needs _mutex
+    void publish(std::vector<Interceptor> interceptors);
+
+    std::atomic<const Chain*> _chain{nullptr};
+
+    std::mutex _mutex{};
+    std::vector<std::unique_ptr<Chain>> _chains{}; // Needs _mutex
+    uint64_t _next_id{1}; // Needs _mutex
+};
+
+} // namespace mavsdk
@@ -0,0 +1,114 @@
+#include "message_interceptors.h"
+#include <gtest/gtest.h>
+
+using namespace mavsdk;
+
+namespace {
+
+mavlink_message_t message_with_id(uint32_t message_id)
+{
+    mavlink_message_t message{};
+    message.msgid = message_id;
+    return message;
+}
+
+} // namespace
+
+TEST(MessageInterceptors, NothingIsDroppedWithoutInterceptors)
+{
+    MessageInterceptors interceptors;
+    auto message = message_with_id(0);
+    EXPECT_TRUE(interceptors.process(message));
+}
+
+TEST(MessageInterceptors, OnlyMatchingMessagesAreSeen)
+{
+    MessageInterceptors interceptors;
+
+    unsigned num_seen = 0;
+    interceptors.add(
+        [&](mavlink_message_t&) {
+            ++num_seen;
+            return true;
+        },
+        {30, 331});
+
+    for (const uint32_t message_id : {0u, 30u, 31u, 94u, 331u, 12900u}) {
+        auto message = message_with_id(message_id);
+        EXPECT_TRUE(interceptors.process(message));
+    }
+    EXPECT_EQ(num_seen, 2);
+}
+
+TEST(MessageInterceptors, AllAreCalledInOrderUntilOneDrops)
+{
+    MessageInterceptors interceptors;
+
+    std::vector<int> calls;
+    interceptors.add(
+        [&](mavlink_message_t&) {
+            calls.push_back(1);
+            return true;
+        },
+        {});
+    const auto dropping = interceptors.add(
+        [&](mavlink_message_t& message) {
+            calls.push_back(2);
+            return message.msgid != 30;
+        },
+        {30, 31});
+    interceptors.add(
+        [&](mavlink_message_t&) {
+            calls.push_back(3);
+            return true;
+        },
+        {});
+
+    auto message = message_with_id(30);
+    EXPECT_FALSE(interceptors.process(message));
+    EXPECT_EQ(calls, (std::vector<int>{1, 2}));
+
+    calls.clear();
+    message = message_with_id(31);
+    EXPECT_TRUE(interceptors.process(message));
+    EXPECT_EQ(calls, (std::vector<int>{1, 2, 3}));
+
+    calls.clear();
+    interceptors.remove(dropping);
+    message = message_with_id(30);
+    EXPECT_TRUE(interceptors.process(message));
+    EXPECT_EQ(calls, (std::vector<int>{1, 3}));
+}
+
+TEST(MessageInterceptors, MessagesCanBeChanged)
+{
+    MessageInterceptors interceptors;
+    const auto handle = interceptors.add(
+        [](mavlink_message_t& message) {
+            message.sysid = 42;
+            return true;
+        },
+        {0});
+
+    auto message = message_with_id(0);
+    EXPECT_TRUE(interceptors.process(message));
+    EXPECT_EQ(message.sysid, 42);
+
+    interceptors.remove(handle);
+    message = message_with_id(0);
+    EXPECT_TRUE(interceptors.process(message));
+    EXPECT_EQ(message.sysid, 0);
+}
+
+TEST(MessageInterceptors, MatchesWhatAnyInterceptorSees)
+{
+    MessageInterceptors interceptors;
+    EXPECT_FALSE(interceptors.matches(30));
+
+    const auto handle = interceptors.add([](mavlink_message_t&) { return true; }, {30});
+    EXPECT_TRUE(interceptors.matches(30));
+    EXPECT_FALSE(interceptors.matches(31));
+
+    interceptors.remove(handle);
+    EXPECT_FALSE(interceptors.matches(30));
+}
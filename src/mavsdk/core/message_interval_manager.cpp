@@ -0,0 +1,138 @@
+#include "message_interval_manager.h"
+
+#include <algorithm>
+
+namespace mavsdk {
+
+MessageIntervalManager::MessageIntervalManager(SendFunction send_function) :
+    _send_function(std::move(send_function))
+{}
+
+bool MessageIntervalManager::request(
+    uint16_t message_id,
+    double rate_hz,
+    uint8_t component_id,
+    const void* consumer,
+    const MavlinkCommandSender::CommandResultCallback& callback)
+{
+    std::optional<Sending> sending;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        const Key key{component_id, message_id};
+        Entry& entry = _entries[key];
+
+        auto it = std::find_if(entry.rates.begin(), entry.rates.end(), [&](const auto& rate) {
+            return rate.first == consumer;
+        });
+        if (rate_hz == 0.0) {
+            if (it != entry.rates.end()) {
+                entry.rates.erase(it);
+            }
+        } else if (it != entry.rates.end()) {
+            it->second = rate_hz;
+        } else {
+            entry.rates.emplace_back(consumer, rate_hz);
+        }
+
+        sending = update(key, entry, callback);
+    }
+
+    if (!sending) {
+        return false;
+    }
+    send(sending.value());
+    return true;
+}
+
+void MessageIntervalManager::release_all(const void* consumer)
+{
+    std::vector<Sending> sendings;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        for (auto& [key, entry] : _entries) {
+            const auto previous_size = entry.rates.size();
+            entry.rates.erase(
+                std::remove_if(
+                    entry.rates.begin(),
+                    entry.rates.end(),
+                    [&](const auto& rate) { return rate.first == consumer; }),
+                entry.rates.end());
+
+            if (entry.rates.size() != previous_size) {
+                if (auto sending = update(key, entry, nullptr)) {
+                    sendings.push_back(sending.value());
+                }
+            }
+        }
+    }
+
+    for (const auto& sending : sendings) {
+        send(sending);
+    }
+}
+
+void MessageIntervalManager::forget_sent_rates()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    for (auto& [key, entry] : _entries) {
+        entry.sent_rate_hz.reset();
+    }
+}
+
+double
+MessageIntervalManager::effective_rate_hz(const std::vector<std::pair<const void*, double>>& rates)
+{
+    // Without any consumer left, the default rate is restored. The message
+    // is only stopped if every consumer asked for that.
+    if (rates.empty()) {
+        return 0.0;
+    }
+
+    double max_rate_hz = -1.0;
+    for (const auto& rate : rates) {
+        max_rate_hz = std::max(max_rate_hz, rate.second);
+    }
+    return max_rate_hz;
+}
+
+std::optional<MessageIntervalManager::Sending> MessageIntervalManager::update(
+    const Key& key, Entry& entry, const MavlinkCommandSender::CommandResultCallback& callback)
+{
+    const double rate_hz = effective_rate_hz(entry.rates);
+    if (entry.sent_rate_hz && entry.sent_rate_hz.value() == rate_hz) {
+        return std::nullopt;
+    }
+
+    entry.sent_rate_hz = rate_hz;
+    return Sending{key, rate_hz, callback};
+}
+
+void MessageIntervalManager::send(const Sending& sending)
+{
+    _send_function(
+        sending.key.second,
+        sending.rate_hz,
+        sending.key.first,
+        [this, key = sending.key, rate_hz = sending.rate_hz, callback = sending.callback](
+            MavlinkCommandSender::Result result, float progress) {
+            if (result != MavlinkCommandSender::Result::Success &&
+                result != MavlinkCommandSender::Result::InProgress) {
+                // Try again on the next request, unless something else was
+                // sent in the meantime.
+                std::lock_guard<std::mutex> lock(_mutex);
+                auto& sent_rate_hz = _entries[key].sent_rate_hz;
+                if (sent_rate_hz && sent_rate_hz.value() == rate_hz) {
+                    sent_rate_hz.reset();
+                }
+            }
+
+            if (callback) {
+                callback(result, progress);
+            }
+        });
+}
+
+} // namespace mavsdk
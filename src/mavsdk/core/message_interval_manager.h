@@ -0,0 +1,83 @@
+#pragma once
+
+#include "mavlink_command_sender.h"
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace mavsdk {
+
+// Merges the message rates requested by several consumers, e.g. plugins, into
+// one MAV_CMD_SET_MESSAGE_INTERVAL per message and component.
+//
+// The highest rate requested wins. The command is only sent if the resulting
+// rate changes, and the default rate is restored once no consumer needs the
+// message anymore.
+
+class MessageIntervalManager {
+public:
+    using SendFunction = std::function<void(
+        uint16_t message_id,
+        double rate_hz,
+        uint8_t component_id,
+        const MavlinkCommandSender::CommandResultCallback& callback)>;
+
+    explicit MessageIntervalManager(SendFunction send_function);
+
+    // A rate of 0 means the consumer is fine with the default rate, and -1
+    // that it doesn't need the message at all. Messages are only stopped if
+    // no other consumer needs them.
+    //
+    // Returns false if nothing was sent because the rate would not change,
+    // in which case the callback is not called.
+    bool request(
+        uint16_t message_id,
+        double rate_hz,
+        uint8_t component_id,
+        const void* consumer,
+        const MavlinkCommandSender::CommandResultCallback& callback);
+
+    // Drops all requests of the consumer, e.g. when a plugin is destroyed.
+    void release_all(const void* consumer);
+
+    // The rates set before are unknown after a reconnect, so everything is
+    // sent again on the next request.
+    void forget_sent_rates();
+
+    static double effective_rate_hz(const std::vector<std::pair<const void*, double>>& rates);
+
+private:
+    struct Entry {
+        std::vector<std::pair<const void*, double>> rates{};
+        // Unknown after a failure or reconnect.
+        std::optional<double> sent_rate_hz{0.0};
+    };
+
+    using Key = std::pair<uint8_t, uint16_t>;
+
+    struct Sending {
+        Key key;
+        double rate_hz;
+        MavlinkCommandSender::CommandResultCallback callback;
+    };
+
+    // Needs _mutex, returns what needs to be sent, if anything.
+    std::optional<Sending> update(
+        const Key& key,
+        Entry& entry,
+        const MavlinkCommandSender::CommandResultCallback& callback);
+
+    // The lock must not be held, as the callback might be called right away.
+    void send(const Sending& sending);
+
+    const SendFunction _send_function;
+
+    std::mutex _mutex{};
+    std::map<Key, Entry> _entries{};
+};
+
+} // namespace mavsdk
@@ -0,0 +1,128 @@
+#include "message_interval_manager.h"
+#include <gtest/gtest.h>
+#include <vector>
+
+using namespace mavsdk;
+
+namespace {
+
+struct Sent {
+    uint16_t message_id;
+    double rate_hz;
+    uint8_t component_id;
+    MavlinkCommandSender::CommandResultCallback callback;
+};
+
+MessageIntervalManager::SendFunction record_to(std::vector<Sent>& sent)
+{
+    return [&sent](
+               uint16_t message_id,
+               double rate_hz,
+               uint8_t component_id,
+               const MavlinkCommandSender::CommandResultCallback& callback) {
+        sent.push_back(Sent{message_id, rate_hz, component_id, callback});
+    };
+}
+
+const int consumer_a = 0;
+const int consumer_b = 0;
+
+} // namespace
+
+TEST(MessageIntervalManager, HighestRateWins)
+{
+    std::vector<Sent> sent;
+    MessageIntervalManager manager{record_to(sent)};
+
+    EXPECT_TRUE(manager.request(33, 5.0, 1, &consumer_a, nullptr));
+    EXPECT_TRUE(manager.request(33, 10.0, 1, &consumer_b, nullptr));
+    EXPECT_FALSE(manager.request(33, 2.0, 1, &consumer_a, nullptr));
+
+    ASSERT_EQ(sent.size(), 2);
+    EXPECT_EQ(sent[0].message_id, 33);
+    EXPECT_EQ(sent[0].rate_hz, 5.0);
+    EXPECT_EQ(sent[0].component_id, 1);
+    EXPECT_EQ(sent[1].rate_hz, 10.0);
+
+    // Once the fastest is gone, the next one is used.
+    EXPECT_TRUE(manager.request(33, 0.0, 1, &consumer_b, nullptr));
+    ASSERT_EQ(sent.size(), 3);
+    EXPECT_EQ(sent[2].rate_hz, 2.0);
+}
+
+TEST(MessageIntervalManager, DuplicatesAreNotSent)
+{
+    std::vector<Sent> sent;
+    MessageIntervalManager manager{record_to(sent)};
+
+    EXPECT_TRUE(manager.request(33, 5.0, 1, &consumer_a, nullptr));
+    EXPECT_FALSE(manager.request(33, 5.0, 1, &consumer_a, nullptr));
+    EXPECT_FALSE(manager.request(33, 5.0, 1, &consumer_b, nullptr));
+
+    // Other messages and components are separate.
+    EXPECT_TRUE(manager.request(30, 5.0, 1, &consumer_a, nullptr));
+    EXPECT_TRUE(manager.request(33, 5.0, 100, &consumer_a, nullptr));
+    EXPECT_EQ(sent.size(), 3);
+
+    // The default doesn't need to be requested.
+    EXPECT_FALSE(manager.request(31, 0.0, 1, &consumer_a, nullptr));
+    EXPECT_EQ(sent.size(), 3);
+}
+
+TEST(MessageIntervalManager, DefaultIsRestoredWhenLastConsumerIsReleased)
+{
+    std::vector<Sent> sent;
+    MessageIntervalManager manager{record_to(sent)};
+
+    manager.request(33, 5.0, 1, &consumer_a, nullptr);
+    manager.request(33, 5.0, 1, &consumer_b, nullptr);
+    manager.request(30, 1.0, 1, &consumer_a, nullptr);
+    EXPECT_EQ(sent.size(), 2);
+
+    manager.release_all(&consumer_a);
+    ASSERT_EQ(sent.size(), 3);
+    EXPECT_EQ(sent[2].message_id, 30);
+    EXPECT_EQ(sent[2].rate_hz, 0.0);
+
+    manager.release_all(&consumer_b);
+    ASSERT_EQ(sent.size(), 4);
+    EXPECT_EQ(sent[3].message_id, 33);
+    EXPECT_EQ(sent[3].rate_hz, 0.0);
+}
+
+TEST(MessageIntervalManager, OnlyStoppedIfNobodyNeedsIt)
+{
+    std::vector<Sent> sent;
+    MessageIntervalManager manager{record_to(sent)};
+
+    manager.request(33, 5.0, 1, &consumer_a, nullptr);
+    EXPECT_FALSE(manager.request(33, -1.0, 1, &consumer_b, nullptr));
+
+    EXPECT_TRUE(manager.request(33, 0.0, 1, &consumer_a, nullptr));
+    ASSERT_EQ(sent.size(), 2);
+    EXPECT_EQ(sent[1].rate_hz, -1.0);
+}
+
+TEST(MessageIntervalManager, ResentAfterFailureOrReconnect)
+{
+    std::vector<Sent> sent;
+    MessageIntervalManager manager{record_to(sent)};
+
+    bool called = false;
+    manager.request(33, 5.0, 1, &consumer_a, [&](MavlinkCommandSender::Result result, float) {
+        EXPECT_EQ(result, MavlinkCommandSender::Result::Timeout);
+        called = true;
+    });
+    ASSERT_EQ(sent.size(), 1);
+    sent[0].callback(MavlinkCommandSender::Result::Timeout, 0.0f);
+    EXPECT_TRUE(called);
+
+    EXPECT_TRUE(manager.request(33, 5.0, 1, &consumer_a, nullptr));
+    ASSERT_EQ(sent.size(), 2);
+    sent[1].callback(MavlinkCommandSender::Result::Success, 0.0f);
+    EXPECT_FALSE(manager.request(33, 5.0, 1, &consumer_a, nullptr));
+
+    manager.forget_sent_rates();
+    EXPECT_TRUE(manager.request(33, 5.0, 1, &consumer_a, nullptr));
+    EXPECT_EQ(sent.size(), 3);
+}
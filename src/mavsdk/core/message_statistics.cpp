@@ -0,0 +1,216 @@
+#include "message_statistics.h"
+
+#include <algorithm>
+
+namespace mavsdk {
+
+void DurationHistogramCounter::record(std::chrono::nanoseconds duration)
+{
+    const uint64_t duration_ns = duration.count() > 0 ? static_cast<uint64_t>(duration.count()) : 0;
+
+    _counts[bucket_for(duration_ns)].fetch_add(1, std::memory_order_relaxed);
+    _total_ns.fetch_add(duration_ns, std::memory_order_relaxed);
+
+    uint64_t max_ns = _max_ns.load(std::memory_order_relaxed);
+    while (duration_ns > max_ns &&
+           !_max_ns.compare_exchange_weak(max_ns, duration_ns, std::memory_order_relaxed)) {
+    }
+}
+
+DurationHistogram DurationHistogramCounter::get() const
+{
+    DurationHistogram histogram;
+    for (unsigned i = 0; i < DurationHistogram::num_buckets; ++i) {
+        histogram.counts[i] = _counts[i].load(std::memory_order_relaxed);
+        histogram.total_count += histogram.counts[i];
+    }
+    histogram.total_ns = _total_ns.load(std::memory_order_relaxed);
+    histogram.max_ns = _max_ns.load(std::memory_order_relaxed);
+    return histogram;
+}
+
+unsigned DurationHistogramCounter::bucket_for(uint64_t duration_ns)
+{
+    // The bucket is the number of bits needed for the duration in us.
+    uint64_t duration_us = duration_ns / 1000;
+    unsigned bucket = 0;
+    while (duration_us != 0 && bucket < DurationHistogram::num_buckets - 1) {
+        duration_us >>= 1;
+        ++bucket;
+    }
+    return bucket;
+}
+
+void DurationHistogramCounter::add(DurationHistogram& total, const DurationHistogram& histogram)
+{
+    for (unsigned i = 0; i < DurationHistogram::num_buckets; ++i) {
+        total.counts[i] += histogram.counts[i];
+    }
+    total.total_count += histogram.total_count;
+    total.total_ns += histogram.total_ns;
+    total.max_ns = std::max(total.max_ns, histogram.max_ns);
+}
+
+MessageStatistics::~MessageStatistics()
+{
+    for (auto& page : _pages) {
+        delete page.load();
+    }
+}
+
+void MessageStatistics::count_received(const mavlink_message_t& message)
+{
+    if (auto* counters = counters_for(message.msgid)) {
+        counters->received_count.fetch_add(1, std::memory_order_relaxed);
+        counters->received_bytes.fetch_add(frame_len(message), std::memory_order_relaxed);
+    }
+}
+
+void MessageStatistics::count_sent(const mavlink_message_t& message)
+{
+    count_sent(message.msgid, frame_len(message));
+}
+
+void MessageStatistics::count_sent(uint32_t msg_id, unsigned len)
+{
+    if (auto* counters = counters_for(msg_id)) {
+        counters->sent_count.fetch_add(1, std::memory_order_relaxed);
+        counters->sent_bytes.fetch_add(len, std::memory_order_relaxed);
+    }
+}
+
+void MessageStatistics::record_dispatch_time(uint32_t msg_id, std::chrono::nanoseconds duration)
+{
+    if (auto* counters = counters_for(msg_id)) {
+        counters->dispatch_time.record(duration);
+    }
+}
+
+void MessageStatistics::record_processing_latency(
+    uint32_t msg_id, std::chrono::nanoseconds duration)
+{
+    if (auto* counters = counters_for(msg_id)) {
+        counters->processing_latency.record(duration);
+    }
+}
+
+void MessageStatistics::record_transport_latency(uint32_t msg_id, std::chrono::nanoseconds duration)
+{
+    if (auto* counters = counters_for(msg_id)) {
+        counters->transport_latency.record(duration);
+    }
+}
+
+std::vector<MessageStats> MessageStatistics::get() const
+{
+    std::vector<MessageStats> result;
+    for (unsigned page_index = 0; page_index < num_pages; ++page_index) {
+        const Page* page = _pages[page_index].load(std::memory_order_acquire);
+        if (page == nullptr) {
+            continue;
+        }
+
+        for (unsigned slot = 0; slot < num_slots_per_page; ++slot) {
+            const Counters& counters = page->slots[slot];
+
+            MessageStats stats;
+            stats.message_id = page_index * num_slots_per_page + slot;
+            stats.received_count = counters.received_count.load(std::memory_order_relaxed);
+            stats.received_bytes = counters.received_bytes.load(std::memory_order_relaxed);
+            stats.sent_count = counters.sent_count.load(std::memory_order_relaxed);
+            stats.sent_bytes = counters.sent_bytes.load(std::memory_order_relaxed);
+            stats.dispatch_time = counters.dispatch_time.get();
+            stats.processing_latency = counters.processing_latency.get();
+            stats.transport_latency = counters.transport_latency.get();
+
+            if (stats.received_count != 0 || stats.sent_count != 0 ||
+                stats.dispatch_time.total_count != 0) {
+                result.push_back(stats);
+            }
+        }
+    }
+    return result;
+}
+
+unsigned MessageStatistics::frame_len(const mavlink_message_t& message)
+{
+    if (message.magic == MAVLINK_STX_MAVLINK1) {
+        return MAVLINK_CORE_HEADER_MAVLINK1_LEN + 1 + message.len + MAVLINK_NUM_CHECKSUM_BYTES;
+    }
+
+    unsigned len = MAVLINK_NUM_NON_PAYLOAD_BYTES + message.len;
+    if ((message.incompat_flags & MAVLINK_IFLAG_SIGNED) != 0) {
+        len += MAVLINK_SIGNATURE_BLOCK_LEN;
+    }
+    return len;
+}
+
+MessageStatistics::Counters* MessageStatistics::counters_for(uint32_t msg_id)
+{
+    const uint32_t page_index = msg_id / num_slots_per_page;
+    if (page_index >= num_pages) {
+        // Same as for the message handlers, IDs above 16 bits are not supported.
+        return nullptr;
+    }
+
+    Page* page = _pages[page_index].load(std::memory_order_acquire);
+    if (page == nullptr) {
+        // If another thread was quicker, we use its page instead.
+        auto* new_page = new Page{};
+        if (_pages[page_index].compare_exchange_strong(
+                page, new_page, std::memory_order_acq_rel, std::memory_order_acquire)) {
+            page = new_page;
+        } else {
+            delete new_page;
+        }
+    }
+    return &page->slots[msg_id % num_slots_per_page];
+}
+
+std::optional<uint64_t> MessageStatistics::sent_time_us(const mavlink_message_t& message)
+{
+    switch (message.msgid) {
+        case MAVLINK_MSG_ID_ATTITUDE:
+            return mavlink_msg_attitude_get_time_boot_ms(&message) * uint64_t(1000);
+        case MAVLINK_MSG_ID_ATTITUDE_QUATERNION:
+            return mavlink_msg_attitude_quaternion_get_time_boot_ms(&message) * uint64_t(1000);
+        case MAVLINK_MSG_ID_ATTITUDE_TARGET:
+            return mavlink_msg_attitude_target_get_time_boot_ms(&message) * uint64_t(1000);
+        case MAVLINK_MSG_ID_LOCAL_POSITION_NED:
+            return mavlink_msg_local_position_ned_get_time_boot_ms(&message) * uint64_t(1000);
+        case MAVLINK_MSG_ID_GLOBAL_POSITION_INT:
+            return mavlink_msg_global_position_int_get_time_boot_ms(&message) * uint64_t(1000);
+        case MAVLINK_MSG_ID_POSITION_TARGET_LOCAL_NED:
+            return mavlink_msg_position_target_local_ned_get_time_boot_ms(&message) *
+                   uint64_t(1000);
+        case MAVLINK_MSG_ID_POSITION_TARGET_GLOBAL_INT:
+            return mavlink_msg_position_target_global_int_get_time_boot_ms(&message) *
+                   uint64_t(1000);
+        case MAVLINK_MSG_ID_SCALED_IMU:
+            return mavlink_msg_scaled_imu_get_time_boot_ms(&message) * uint64_t(1000);
+        case MAVLINK_MSG_ID_RC_CHANNELS:
+            return mavlink_msg_rc_channels_get_time_boot_ms(&message) * uint64_t(1000);
+        case MAVLINK_MSG_ID_DISTANCE_SENSOR:
+            return mavlink_msg_distance_sensor_get_time_boot_ms(&message) * uint64_t(1000);
+        case MAVLINK_MSG_ID_HIGHRES_IMU:
+            return mavlink_msg_highres_imu_get_time_usec(&message);
+        case MAVLINK_MSG_ID_ODOMETRY:
+            return mavlink_msg_odometry_get_time_usec(&message);
+        case MAVLINK_MSG_ID_ALTITUDE:
+            return mavlink_msg_altitude_get_time_usec(&message);
+        case MAVLINK_MSG_ID_GPS_RAW_INT:
+            return mavlink_msg_gps_raw_int_get_time_usec(&message);
+        case MAVLINK_MSG_ID_SERVO_OUTPUT_RAW:
+            return mavlink_msg_servo_output_raw_get_time_usec(&message);
+        case MAVLINK_MSG_ID_ACTUATOR_OUTPUT_STATUS:
+            return mavlink_msg_actuator_output_status_get_time_usec(&message);
+        case MAVLINK_MSG_ID_ESTIMATOR_STATUS:
+            return mavlink_msg_estimator_status_get_time_usec(&message);
+        case MAVLINK_MSG_ID_VIBRATION:
+            return mavlink_msg_vibration_get_time_usec(&message);
+        default:
+            return std::nullopt;
+    }
+}
+
+} // namespace mavsdk
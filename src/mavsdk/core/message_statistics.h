@@ -0,0 +1,85 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <vector>
+#include "mavlink_include.h"
+#include "message_stats.h"
+
+namespace mavsdk {
+
+// Histogram which can be recorded to from several threads at once.
+class DurationHistogramCounter {
+public:
+    DurationHistogramCounter() = default;
+    ~DurationHistogramCounter() = default;
+
+    DurationHistogramCounter(const DurationHistogramCounter&) = delete;
+    DurationHistogramCounter& operator=(const DurationHistogramCounter&) = delete;
+
+    void record(std::chrono::nanoseconds duration);
+    DurationHistogram get() const;
+
+    static unsigned bucket_for(uint64_t duration_ns);
+    static void add(DurationHistogram& total, const DurationHistogram& histogram);
+
+private:
+    std::array<std::atomic<uint64_t>, DurationHistogram::num_buckets> _counts{};
+    std::atomic<uint64_t> _total_ns{0};
+    std::atomic<uint64_t> _max_ns{0};
+};
+
+// Counters per message ID, in pages which are allocated the first time a
+// message ID of them is seen, so no lock is needed to count. The counters are
+// relaxed atomics and therefore cheap enough to always be on.
+class MessageStatistics {
+public:
+    MessageStatistics() = default;
+    ~MessageStatistics();
+
+    MessageStatistics(const MessageStatistics&) = delete;
+    MessageStatistics& operator=(const MessageStatistics&) = delete;
+
+    void count_received(const mavlink_message_t& message);
+    void count_sent(const mavlink_message_t& message);
+    void count_sent(uint32_t msg_id, unsigned len);
+    void record_dispatch_time(uint32_t msg_id, std::chrono::nanoseconds duration);
+    void record_processing_latency(uint32_t msg_id, std::chrono::nanoseconds duration);
+    void record_transport_latency(uint32_t msg_id, std::chrono::nanoseconds duration);
+
+    // Only message IDs for which something was counted, sorted by ID.
+    std::vector<MessageStats> get() const;
+
+    static unsigned frame_len(const mavlink_message_t& message);
+
+    // The time_boot_ms or time_usec of common timestamped messages in us,
+    // i.e. in the clock of the sender.
+    static std::optional<uint64_t> sent_time_us(const mavlink_message_t& message);
+
+private:
+    struct Counters {
+        std::atomic<uint64_t> received_count{0};
+        std::atomic<uint64_t> received_bytes{0};
+        std::atomic<uint64_t> sent_count{0};
+        std::atomic<uint64_t> sent_bytes{0};
+        DurationHistogramCounter dispatch_time{};
+        DurationHistogramCounter processing_latency{};
+        DurationHistogramCounter transport_latency{};
+    };
+
+    static constexpr unsigned num_slots_per_page = 256;
+    static constexpr unsigned num_pages = 256;
+
+    struct Page {
+        std::array<Counters, num_slots_per_page> slots{};
+    };
+
+    Counters* counters_for(uint32_t msg_id);
+
+    std::array<std::atomic<Page*>, num_pages> _pages{};
+};
+
+} // namespace mavsdk
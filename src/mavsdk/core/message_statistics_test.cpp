@@ -0,0 +1,136 @@
+#include "message_statistics.h"
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+using namespace mavsdk;
+
+TEST(MessageStatistics, BucketForDuration)
+{
+    EXPECT_EQ(DurationHistogramCounter::bucket_for(0), 0);
+    EXPECT_EQ(DurationHistogramCounter::bucket_for(999), 0);
+    EXPECT_EQ(DurationHistogramCounter::bucket_for(1000), 1);
+    EXPECT_EQ(DurationHistogramCounter::bucket_for(1999), 1);
+    EXPECT_EQ(DurationHistogramCounter::bucket_for(2000), 2);
+    EXPECT_EQ(DurationHistogramCounter::bucket_for(3999), 2);
+    EXPECT_EQ(DurationHistogramCounter::bucket_for(4000), 3);
+    EXPECT_EQ(
+        DurationHistogramCounter::bucket_for(UINT64_MAX), DurationHistogram::num_buckets - 1);
+}
+
+TEST(MessageStatistics, RecordsHistogram)
+{
+    DurationHistogramCounter counter;
+    counter.record(std::chrono::nanoseconds(500));
+    counter.record(std::chrono::microseconds(3));
+    counter.record(std::chrono::seconds(10));
+
+    const auto histogram = counter.get();
+    EXPECT_EQ(histogram.total_count, 3);
+    EXPECT_EQ(histogram.counts[0], 1);
+    EXPECT_EQ(histogram.counts[2], 1);
+    EXPECT_EQ(histogram.counts[DurationHistogram::num_buckets - 1], 1);
+    EXPECT_EQ(histogram.total_ns, 500 + 3000 + 10000000000ull);
+    EXPECT_EQ(histogram.max_ns, 10000000000ull);
+}
+
+TEST(MessageStatistics, CountsPerMessageId)
+{
+    MessageStatistics stats;
+
+    mavlink_message_t heartbeat{};
+    heartbeat.magic = MAVLINK_STX;
+    heartbeat.msgid = 0;
+    heartbeat.len = 9;
+
+    mavlink_message_t high_id{};
+    high_id.magic = MAVLINK_STX;
+    high_id.msgid = 12900;
+    high_id.len = 20;
+    high_id.incompat_flags = MAVLINK_IFLAG_SIGNED;
+
+    stats.count_received(heartbeat);
+    stats.count_received(heartbeat);
+    stats.count_sent(heartbeat);
+    stats.count_sent(high_id);
+    stats.record_dispatch_time(0, std::chrono::microseconds(5));
+
+    const auto result = stats.get();
+    ASSERT_EQ(result.size(), 2);
+
+    EXPECT_EQ(result[0].message_id, 0);
+    EXPECT_EQ(result[0].received_count, 2);
+    EXPECT_EQ(result[0].received_bytes, 2 * (MAVLINK_NUM_NON_PAYLOAD_BYTES + 9));
+    EXPECT_EQ(result[0].sent_count, 1);
+    EXPECT_EQ(result[0].dispatch_time.total_count, 1);
+
+    EXPECT_EQ(result[1].message_id, 12900);
+    EXPECT_EQ(result[1].received_count, 0);
+    EXPECT_EQ(result[1].sent_count, 1);
+    EXPECT_EQ(
+        result[1].sent_bytes, MAVLINK_NUM_NON_PAYLOAD_BYTES + 20 + MAVLINK_SIGNATURE_BLOCK_LEN);
+}
+
+TEST(MessageStatistics, CountsFromSeveralThreads)
+{
+    MessageStatistics stats;
+
+    mavlink_message_t message{};
+    message.magic = MAVLINK_STX;
+    message.msgid = 300;
+
+    std::vector<std::thread> threads;
+    for (unsigned i = 0; i < 4; ++i) {
+        threads.emplace_back([&]() {
+            for (unsigned j = 0; j < 1000; ++j) {
+                stats.count_received(message);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    const auto result = stats.get();
+    ASSERT_EQ(result.size(), 1);
+    EXPECT_EQ(result[0].received_count, 4000);
+}
+
+TEST(MessageStatistics, RecordsLatencies)
+{
+    MessageStatistics stats;
+
+    mavlink_message_t attitude{};
+    attitude.magic = MAVLINK_STX;
+    attitude.msgid = MAVLINK_MSG_ID_ATTITUDE;
+    attitude.len = 28;
+
+    stats.count_received(attitude);
+    stats.record_processing_latency(MAVLINK_MSG_ID_ATTITUDE, std::chrono::microseconds(50));
+    stats.record_transport_latency(MAVLINK_MSG_ID_ATTITUDE, std::chrono::milliseconds(3));
+
+    const auto result = stats.get();
+    ASSERT_EQ(result.size(), 1);
+    EXPECT_EQ(result[0].processing_latency.total_count, 1);
+    EXPECT_EQ(result[0].processing_latency.max_ns, 50000);
+    EXPECT_EQ(result[0].transport_latency.total_count, 1);
+    EXPECT_EQ(result[0].transport_latency.max_ns, 3000000);
+}
+
+TEST(MessageStatistics, SentTimeOfTimestampedMessages)
+{
+    mavlink_message_t message;
+    mavlink_msg_attitude_pack(1, MAV_COMP_ID_AUTOPILOT1, &message, 1234, 0, 0, 0, 0, 0, 0);
+    EXPECT_EQ(MessageStatistics::sent_time_us(message), std::optional<uint64_t>{1234000});
+
+    mavlink_msg_heartbeat_pack(
+        1,
+        MAV_COMP_ID_AUTOPILOT1,
+        &message,
+        MAV_TYPE_QUADROTOR,
+        MAV_AUTOPILOT_PX4,
+        0,
+        0,
+        MAV_STATE_ACTIVE);
+    EXPECT_EQ(MessageStatistics::sent_time_us(message), std::nullopt);
+}
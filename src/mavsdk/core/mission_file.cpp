@@ -0,0 +1,186 @@
+#include "mission_file.h"
+#include "log.h"
+
+#include <cstring>
+
+namespace mavsdk {
+
+namespace {
+
+constexpr uint16_t mission_file_magic = 0x763d;
+constexpr size_t header_len = 10;
+// MISSION_ITEM_INT without mission_type, which is in the header instead.
+constexpr size_t item_len = 37;
+
+void put_uint8(std::vector<uint8_t>& data, uint8_t value)
+{
+    data.push_back(value);
+}
+
+void put_uint16(std::vector<uint8_t>& data, uint16_t value)
+{
+    data.push_back(static_cast<uint8_t>(value & 0xFF));
+    data.push_back(static_cast<uint8_t>(value >> 8));
+}
+
+void put_uint32(std::vector<uint8_t>& data, uint32_t value)
+{
+    for (unsigned i = 0; i < 4; ++i) {
+        data.push_back(static_cast<uint8_t>(value >> (8 * i)));
+    }
+}
+
+void put_int32(std::vector<uint8_t>& data, int32_t value)
+{
+    put_uint32(data, static_cast<uint32_t>(value));
+}
+
+void put_float(std::vector<uint8_t>& data, float value)
+{
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    put_uint32(data, bits);
+}
+
+class Reader {
+public:
+    explicit Reader(const uint8_t* data) : _data(data) {}
+
+    uint8_t uint8() { return *_data++; }
+
+    uint16_t uint16()
+    {
+        const auto value = static_cast<uint16_t>(_data[0] | (_data[1] << 8));
+        _data += 2;
+        return value;
+    }
+
+    uint32_t uint32()
+    {
+        uint32_t value = 0;
+        for (unsigned i = 0; i < 4; ++i) {
+            value |= uint32_t(_data[i]) << (8 * i);
+        }
+        _data += 4;
+        return value;
+    }
+
+    int32_t int32() { return static_cast<int32_t>(uint32()); }
+
+    float float32()
+    {
+        const uint32_t bits = uint32();
+        float value;
+        memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+private:
+    const uint8_t* _data;
+};
+
+} // namespace
+
+std::string mission_file_path(uint8_t type)
+{
+    switch (type) {
+        case MAV_MISSION_TYPE_MISSION:
+            return "@MISSION/mission.dat";
+        case MAV_MISSION_TYPE_FENCE:
+            return "@MISSION/fence.dat";
+        case MAV_MISSION_TYPE_RALLY:
+            return "@MISSION/rally.dat";
+        default:
+            return {};
+    }
+}
+
+std::vector<uint8_t>
+encode_mission_file(uint8_t type, const std::vector<MavlinkMissionTransfer::ItemInt>& items)
+{
+    std::vector<uint8_t> data;
+    data.reserve(header_len + items.size() * item_len);
+
+    put_uint16(data, mission_file_magic);
+    put_uint16(data, type);
+    put_uint16(data, 0); // options
+    put_uint16(data, 0); // start
+    put_uint16(data, static_cast<uint16_t>(items.size()));
+
+    // In the order of the MAVLink message, the targets are not used.
+    for (size_t i = 0; i < items.size(); ++i) {
+        const auto& item = items[i];
+        put_float(data, item.param1);
+        put_float(data, item.param2);
+        put_float(data, item.param3);
+        put_float(data, item.param4);
+        put_int32(data, item.x);
+        put_int32(data, item.y);
+        put_float(data, item.z);
+        // ArduPilot missions are off by one, so the position is used.
+        put_uint16(data, static_cast<uint16_t>(i));
+        put_uint16(data, item.command);
+        put_uint8(data, 0); // target_system
+        put_uint8(data, 0); // target_component
+        put_uint8(data, item.frame);
+        put_uint8(data, item.current);
+        put_uint8(data, item.autocontinue);
+    }
+
+    return data;
+}
+
+std::optional<std::vector<MavlinkMissionTransfer::ItemInt>>
+decode_mission_file(uint8_t type, const std::vector<uint8_t>& data)
+{
+    if (data.size() < header_len) {
+        LogWarn() << "Mission file too short";
+        return {};
+    }
+
+    Reader header(data.data());
+    const uint16_t magic = header.uint16();
+    const uint16_t data_type = header.uint16();
+    header.uint16(); // options
+    const uint16_t start = header.uint16();
+    const uint16_t num_items = header.uint16();
+
+    if (magic != mission_file_magic || data_type != type) {
+        LogWarn() << "Mission file has wrong magic or type";
+        return {};
+    }
+
+    if (data.size() != header_len + num_items * item_len) {
+        LogWarn() << "Mission file has wrong size";
+        return {};
+    }
+
+    std::vector<MavlinkMissionTransfer::ItemInt> items;
+    items.reserve(num_items);
+
+    Reader reader(data.data() + header_len);
+    for (unsigned i = 0; i < num_items; ++i) {
+        MavlinkMissionTransfer::ItemInt item{};
+        item.param1 = reader.float32();
+        item.param2 = reader.float32();
+        item.param3 = reader.float32();
+        item.param4 = reader.float32();
+        item.x = reader.int32();
+        item.y = reader.int32();
+        item.z = reader.float32();
+        reader.uint16(); // seq, which is given by the position
+        item.command = reader.uint16();
+        reader.uint8(); // target_system
+        reader.uint8(); // target_component
+        item.frame = reader.uint8();
+        item.current = reader.uint8();
+        item.autocontinue = reader.uint8();
+        item.seq = static_cast<uint16_t>(start + i);
+        item.mission_type = type;
+        items.push_back(item);
+    }
+
+    return items;
+}
+
+} // namespace mavsdk
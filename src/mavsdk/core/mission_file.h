@@ -0,0 +1,28 @@
+#pragma once
+
+#include "mavlink_mission_transfer.h"
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace mavsdk {
+
+// Missions, geofences and rally points as files, the way ArduPilot serves
+// them over MAVLink FTP, see libraries/AP_Filesystem/AP_Filesystem_Mission.cpp
+// in ArduPilot.
+//
+// A 10 byte header (magic, mission type, options, first seq, count) is
+// followed by the items, each being MISSION_ITEM_INT up to mission_type.
+
+// Empty if there is no file for this mission type.
+std::string mission_file_path(uint8_t type);
+
+std::vector<uint8_t>
+encode_mission_file(uint8_t type, const std::vector<MavlinkMissionTransfer::ItemInt>& items);
+
+// Returns nothing if the file is broken or of another type.
+std::optional<std::vector<MavlinkMissionTransfer::ItemInt>>
+decode_mission_file(uint8_t type, const std::vector<uint8_t>& data);
+
+} // namespace mavsdk
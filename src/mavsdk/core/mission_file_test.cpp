@@ -0,0 +1,83 @@
+#include "mission_file.h"
+#include <gtest/gtest.h>
+#include <cmath>
+
+using namespace mavsdk;
+
+namespace {
+
+std::vector<MavlinkMissionTransfer::ItemInt> make_items(uint8_t type, unsigned num_items)
+{
+    std::vector<MavlinkMissionTransfer::ItemInt> items;
+    for (unsigned i = 0; i < num_items; ++i) {
+        items.push_back(MavlinkMissionTransfer::ItemInt{
+            static_cast<uint16_t>(i),
+            MAV_FRAME_GLOBAL_RELATIVE_ALT_INT,
+            MAV_CMD_NAV_WAYPOINT,
+            static_cast<uint8_t>(i == 0 ? 1 : 0),
+            1,
+            0.5f * static_cast<float>(i),
+            1.0f,
+            -2.0f,
+            NAN,
+            473977418 + static_cast<int32_t>(i),
+            -85455939,
+            10.5f,
+            type});
+    }
+    return items;
+}
+
+} // namespace
+
+TEST(MissionFile, EncodedItemsAreDecoded)
+{
+    const auto items = make_items(MAV_MISSION_TYPE_MISSION, 5);
+    const auto data = encode_mission_file(MAV_MISSION_TYPE_MISSION, items);
+    EXPECT_EQ(data.size(), 10 + 5 * 37);
+
+    const auto decoded = decode_mission_file(MAV_MISSION_TYPE_MISSION, data);
+    ASSERT_TRUE(decoded);
+    ASSERT_EQ(decoded->size(), items.size());
+    for (size_t i = 0; i < items.size(); ++i) {
+        EXPECT_EQ(decoded->at(i).seq, items[i].seq);
+        EXPECT_EQ(decoded->at(i).command, items[i].command);
+        EXPECT_EQ(decoded->at(i).current, items[i].current);
+        EXPECT_EQ(decoded->at(i).param1, items[i].param1);
+        EXPECT_TRUE(std::isnan(decoded->at(i).param4));
+        EXPECT_EQ(decoded->at(i).x, items[i].x);
+        EXPECT_EQ(decoded->at(i).y, items[i].y);
+        EXPECT_EQ(decoded->at(i).z, items[i].z);
+        EXPECT_EQ(decoded->at(i).mission_type, MAV_MISSION_TYPE_MISSION);
+    }
+}
+
+TEST(MissionFile, OnlyMissionsFencesAndRallyPointsHaveFiles)
+{
+    EXPECT_EQ(mission_file_path(MAV_MISSION_TYPE_MISSION), "@MISSION/mission.dat");
+    EXPECT_EQ(mission_file_path(MAV_MISSION_TYPE_FENCE), "@MISSION/fence.dat");
+    EXPECT_EQ(mission_file_path(MAV_MISSION_TYPE_RALLY), "@MISSION/rally.dat");
+    EXPECT_TRUE(mission_file_path(MAV_MISSION_TYPE_ALL).empty());
+}
+
+TEST(MissionFile, BrokenFilesAreRejected)
+{
+    const auto data =
+        encode_mission_file(MAV_MISSION_TYPE_FENCE, make_items(MAV_MISSION_TYPE_FENCE, 3));
+    EXPECT_FALSE(decode_mission_file(MAV_MISSION_TYPE_RALLY, data));
+
+    auto wrong_magic = data;
+    wrong_magic[0] ^= 0xFF;
+    EXPECT_FALSE(decode_mission_file(MAV_MISSION_TYPE_FENCE, wrong_magic));
+
+    auto truncated = data;
+    truncated.pop_back();
+    EXPECT_FALSE(decode_mission_file(MAV_MISSION_TYPE_FENCE, truncated));
+    EXPECT_FALSE(decode_mission_file(MAV_MISSION_TYPE_FENCE, {}));
+
+    // No items is a valid, empty file.
+    const auto empty = decode_mission_file(
+        MAV_MISSION_TYPE_FENCE, encode_mission_file(MAV_MISSION_TYPE_FENCE, {}));
+    ASSERT_TRUE(empty);
+    EXPECT_TRUE(empty->empty());
+}
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <cstdint>
+#include <optional>
+
 namespace mavsdk {
 namespace mavsdk_server {
 namespace testing {
@@ -7,6 +10,14 @@ namespace testing {
 template<typename Plugin> class MockLazyPlugin {
 public:
     MOCK_CONST_METHOD0(maybe_plugin, Plugin*()){};
+
+    // The system is not of interest in the tests.
+    Plugin* maybe_plugin(uint8_t /* system_id */) const { return maybe_plugin(); }
+
+    Plugin* maybe_plugin(std::optional<uint8_t> system_id) const
+    {
+        return system_id ? maybe_plugin() : nullptr;
+    }
 };
 
 } // namespace testing
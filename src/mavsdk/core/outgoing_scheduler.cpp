@@ -0,0 +1,116 @@
+#include "outgoing_scheduler.h"
+
+#include <algorithm>
+
+namespace mavsdk {
+
+OutgoingScheduler::OutgoingScheduler(double bytes_per_s, TimePoint now) :
+    _bytes_per_s(bytes_per_s),
+    _capacity(std::max(bytes_per_s * burst_s, static_cast<double>(min_burst_bytes))),
+    _tokens(_capacity),
+    _last_refill(now)
+{}
+
+OutgoingScheduler::Decision
+OutgoingScheduler::offer(Priority priority, const uint8_t* frame, size_t len, TimePoint now)
+{
+    refill(now);
+
+    const auto index = static_cast<size_t>(priority);
+    const auto frame_len = static_cast<double>(len);
+
+    if (priority == Priority::Control) {
+        _tokens -= frame_len;
+        return Decision::Send;
+    }
+
+    bool waiting = false;
+    for (size_t i = 0; i <= index; ++i) {
+        if (!_queues[i].frames.empty()) {
+            waiting = true;
+            break;
+        }
+    }
+
+    if (!waiting && _tokens >= frame_len) {
+        _tokens -= frame_len;
+        return Decision::Send;
+    }
+
+    auto& queue = _queues[index];
+    if (static_cast<double>(queue.bytes + len) > _bytes_per_s * max_queued_s) {
+        ++_dropped_frames;
+        return Decision::Dropped;
+    }
+
+    queue.frames.emplace_back(frame, frame + len);
+    queue.bytes += len;
+    return Decision::Queued;
+}
+
+void OutgoingScheduler::take_ready(TimePoint now, std::vector<uint8_t>& frames)
+{
+    refill(now);
+
+    for (auto& queue : _queues) {
+        while (!queue.frames.empty()) {
+            const auto& frame = queue.frames.front();
+            if (_tokens < static_cast<double>(frame.size())) {
+                // Nothing of a lower priority gets ahead of it.
+                return;
+            }
+            _tokens -= static_cast<double>(frame.size());
+            frames.insert(frames.end(), frame.begin(), frame.end());
+            queue.bytes -= frame.size();
+            queue.frames.pop_front();
+        }
+    }
+}
+
+std::optional<OutgoingScheduler::TimePoint> OutgoingScheduler::next_ready_time(TimePoint now)
+{
+    refill(now);
+
+    for (const auto& queue : _queues) {
+        if (queue.frames.empty()) {
+            continue;
+        }
+        const double missing = static_cast<double>(queue.frames.front().size()) - _tokens;
+        if (missing <= 0.0) {
+            return now;
+        }
+        return now + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                         std::chrono::duration<double>(missing / _bytes_per_s));
+    }
+    return std::nullopt;
+}
+
+size_t OutgoingScheduler::queued_frames() const
+{
+    size_t count = 0;
+    for (const auto& queue : _queues) {
+        count += queue.frames.size();
+    }
+    return count;
+}
+
+size_t OutgoingScheduler::queued_bytes() const
+{
+    size_t bytes = 0;
+    for (const auto& queue : _queues) {
+        bytes += queue.bytes;
+    }
+    return bytes;
+}
+
+void OutgoingScheduler::refill(TimePoint now)
+{
+    if (now <= _last_refill) {
+        return;
+    }
+    const double elapsed_s = std::chrono::duration<double>(now - _last_refill).count();
+    _tokens = std::min(_capacity, _tokens + elapsed_s * _bytes_per_s);
+    _last_refill = now;
+}
+
+} // namespace mavsdk
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <vector>
+
+namespace mavsdk {
+
+// Keeps what is sent over a connection within a bandwidth budget, using a
+// token bucket, and decides what goes first once there is more to send than
+// the budget allows.
+//
+// Control messages, such as heartbeats and setpoints, are always sent right
+// away, they only use up budget the others then have to wait for. Any other
+// message is sent right away as long as there is budget and nothing of the
+// same or a higher priority is waiting, otherwise it is queued. Queues are
+// served strictly by priority, so bulk transfers only get what is left over.
+//
+// Not thread-safe, the caller needs to lock.
+class OutgoingScheduler {
+public:
+    using TimePoint = std::chrono::steady_clock::time_point;
+
+    enum class Priority { Control, Command, Telemetry, Bulk };
+    static constexpr size_t num_priorities = 4;
+
+    enum class Decision { Send, Queued, Dropped };
+
+    // Budget that can be used at once, at least one MAVLink frame of maximal length.
+    static constexpr double burst_s = 0.1;
+    static constexpr size_t min_burst_bytes = 280;
+    // Once this much is queued for a priority, more of it is dropped.
+    static constexpr double max_queued_s = 2.0;
+
+    OutgoingScheduler(double bytes_per_s, TimePoint now);
+    ~OutgoingScheduler() = default;
+
+    // Non-copyable
+    OutgoingScheduler(const OutgoingScheduler&) = delete;
+    const OutgoingScheduler& operator=(const OutgoingScheduler&) = delete;
+
+    // If the frame is to be sent now, the budget for it is used up already.
+    [[nodiscard]] Decision
+    offer(Priority priority, const uint8_t* frame, size_t len, TimePoint now);
+
+    // Appends the queued frames the budget allows now, by priority.
+    void take_ready(TimePoint now, std::vector<uint8_t>& frames);
+
+    // When the next queued frame can be sent, if anything is queued.
+    [[nodiscard]] std::optional<TimePoint> next_ready_time(TimePoint now);
+
+    [[nodiscard]] size_t queued_frames() const;
+    [[nodiscard]] size_t queued_bytes() const;
+    [[nodiscard]] uint64_t dropped_frames() const { return _dropped_frames; }
+
+private:
+    void refill(TimePoint now);
+
+    struct Queue {
+        std::deque<std::vector<uint8_t>> frames{};
+        size_t bytes{0};
+    };
+
+    const double _bytes_per_s;
+    const double _capacity;
+    double _tokens;
+    TimePoint _last_refill;
+
+    std::array<Queue, num_priorities> _queues{};
+    uint64_t _dropped_frames{0};
+};
+
+} // namespace mavsdk
@@ -0,0 +1,153 @@
+#include "outgoing_scheduler.h"
+#include <gtest/gtest.h>
+#include <vector>
+
+using namespace mavsdk;
+
+namespace {
+
+using Priority = OutgoingScheduler::Priority;
+using Decision = OutgoingScheduler::Decision;
+
+OutgoingScheduler::TimePoint at_ms(int ms)
+{
+    return OutgoingScheduler::TimePoint{} + std::chrono::hours(1) + std::chrono::milliseconds(ms);
+}
+
+std::vector<uint8_t> frame(uint8_t tag, size_t len = 100)
+{
+    return std::vector<uint8_t>(len, tag);
+}
+
+} // namespace
+
+TEST(OutgoingScheduler, SendsRightAwayWithinBudget)
+{
+    // 10 kB/s which allows bursts of 1 kB.
+    OutgoingScheduler scheduler(10000.0, at_ms(0));
+
+    for (int i = 0; i < 10; ++i) {
+        const auto data = frame(1);
+        EXPECT_EQ(
+            scheduler.offer(Priority::Telemetry, data.data(), data.size(), at_ms(0)),
+            Decision::Send);
+    }
+
+    const auto data = frame(1);
+    EXPECT_EQ(
+        scheduler.offer(Priority::Telemetry, data.data(), data.size(), at_ms(0)), Decision::Queued);
+    EXPECT_EQ(scheduler.queued_frames(), 1u);
+}
+
+TEST(OutgoingScheduler, SendsQueuedOnceBudgetRefills)
+{
+    OutgoingScheduler scheduler(10000.0, at_ms(0));
+
+    for (int i = 0; i < 11; ++i) {
+        const auto data = frame(1);
+        (void)scheduler.offer(Priority::Bulk, data.data(), data.size(), at_ms(0));
+    }
+    ASSERT_EQ(scheduler.queued_frames(), 1u);
+
+    // 100 bytes take 10 ms.
+    const auto ready = scheduler.next_ready_time(at_ms(0));
+    ASSERT_TRUE(ready);
+    EXPECT_EQ(ready.value(), at_ms(10));
+
+    std::vector<uint8_t> frames;
+    scheduler.take_ready(at_ms(5), frames);
+    EXPECT_TRUE(frames.empty());
+    scheduler.take_ready(at_ms(10), frames);
+    EXPECT_EQ(frames.size(), 100u);
+    EXPECT_EQ(scheduler.queued_frames(), 0u);
+    EXPECT_FALSE(scheduler.next_ready_time(at_ms(10)));
+}
+
+TEST(OutgoingScheduler, ControlIsNeverHeldBack)
+{
+    OutgoingScheduler scheduler(1000.0, at_ms(0));
+
+    for (int i = 0; i < 20; ++i) {
+        const auto data = frame(1);
+        EXPECT_EQ(
+            scheduler.offer(Priority::Control, data.data(), data.size(), at_ms(0)), Decision::Send);
+    }
+
+    // But it uses up the budget of the others.
+    const auto data = frame(2);
+    EXPECT_EQ(
+        scheduler.offer(Priority::Command, data.data(), data.size(), at_ms(0)), Decision::Queued);
+}
+
+TEST(OutgoingScheduler, ServesByPriority)
+{
+    OutgoingScheduler scheduler(10000.0, at_ms(0));
+
+    // Use up the burst.
+    for (int i = 0; i < 10; ++i) {
+        const auto data = frame(0);
+        (void)scheduler.offer(Priority::Control, data.data(), data.size(), at_ms(0));
+    }
+
+    const auto bulk = frame(3);
+    const auto telemetry = frame(2);
+    const auto command = frame(1);
+    EXPECT_EQ(
+        scheduler.offer(Priority::Bulk, bulk.data(), bulk.size(), at_ms(0)), Decision::Queued);
+    EXPECT_EQ(
+        scheduler.offer(Priority::Telemetry, telemetry.data(), telemetry.size(), at_ms(0)),
+        Decision::Queued);
+    EXPECT_EQ(
+        scheduler.offer(Priority::Command, command.data(), command.size(), at_ms(0)),
+        Decision::Queued);
+
+    std::vector<uint8_t> frames;
+    scheduler.take_ready(at_ms(10), frames);
+    ASSERT_EQ(frames.size(), 100u);
+    EXPECT_EQ(frames[0], 1);
+
+    scheduler.take_ready(at_ms(20), frames);
+    ASSERT_EQ(frames.size(), 200u);
+    EXPECT_EQ(frames[100], 2);
+
+    scheduler.take_ready(at_ms(30), frames);
+    ASSERT_EQ(frames.size(), 300u);
+    EXPECT_EQ(frames[200], 3);
+}
+
+TEST(OutgoingScheduler, DoesNotOvertakeQueued)
+{
+    OutgoingScheduler scheduler(10000.0, at_ms(0));
+
+    for (int i = 0; i < 11; ++i) {
+        const auto data = frame(1);
+        (void)scheduler.offer(Priority::Telemetry, data.data(), data.size(), at_ms(0));
+    }
+
+    // There would be budget for a small one, but it has to wait its turn.
+    const auto small = frame(2, 10);
+    EXPECT_EQ(
+        scheduler.offer(Priority::Bulk, small.data(), small.size(), at_ms(9)), Decision::Queued);
+    EXPECT_EQ(
+        scheduler.offer(Priority::Telemetry, small.data(), small.size(), at_ms(9)),
+        Decision::Queued);
+}
+
+TEST(OutgoingScheduler, DropsWhenTooMuchIsQueued)
+{
+    OutgoingScheduler scheduler(1000.0, at_ms(0));
+
+    size_t dropped = 0;
+    for (int i = 0; i < 40; ++i) {
+        const auto data = frame(3);
+        if (scheduler.offer(Priority::Bulk, data.data(), data.size(), at_ms(0)) ==
+            Decision::Dropped) {
+            ++dropped;
+        }
+    }
+
+    // 280 bytes of burst, and 2 s worth queued.
+    EXPECT_EQ(scheduler.queued_frames(), 20u);
+    EXPECT_EQ(dropped, 18u);
+    EXPECT_EQ(scheduler.dropped_frames(), 18u);
+}
@@ -0,0 +1,115 @@
+#include "param_cache.h"
+#include "log.h"
+
+#include <cstring>
+#include <sstream>
+
+namespace mavsdk {
+
+namespace {
+
+constexpr const char* header = "mavsdk-param-cache 1";
+
+template<typename T>
+bool raw_bits_of(const MAVLinkParameters::ParamValue& value, uint32_t& bits)
+{
+    if (!value.is<T>()) {
+        return false;
+    }
+    const T raw = value.get<T>();
+    bits = 0;
+    memcpy(&bits, &raw, sizeof(raw));
+    return true;
+}
+
+// The bytes as they are sent in PARAM_VALUE by PX4, if the type fits.
+std::optional<uint32_t> raw_bits_of(const MAVLinkParameters::ParamValue& value)
+{
+    uint32_t bits;
+    if (raw_bits_of<uint8_t>(value, bits) || raw_bits_of<int8_t>(value, bits) ||
+        raw_bits_of<uint16_t>(value, bits) || raw_bits_of<int16_t>(value, bits) ||
+        raw_bits_of<uint32_t>(value, bits) || raw_bits_of<int32_t>(value, bits) ||
+        raw_bits_of<float>(value, bits)) {
+        return bits;
+    }
+    return {};
+}
+
+} // namespace
+
+bool ParamCache::save(const StateStoreKey& cache, uint32_t hash, const Params& params)
+{
+    if (!cache.store) {
+        return false;
+    }
+
+    std::ostringstream content;
+    content << header << '\n' << "hash " << hash << '\n';
+
+    for (const auto& [name, value] : params) {
+        const auto bits = raw_bits_of(value);
+        if (!bits) {
+            LogWarn() << "Param " << name << " can't be cached";
+            return false;
+        }
+
+        content << name << ' ' << static_cast<int>(value.get_mav_param_type()) << ' '
+                << bits.value() << '\n';
+    }
+
+    if (!cache.store->put(cache.key, content.str())) {
+        LogWarn() << "Could not store param cache " << cache.key;
+        return false;
+    }
+    return true;
+}
+
+std::optional<ParamCache::Params> ParamCache::load(const StateStoreKey& cache, uint32_t hash)
+{
+    const auto content = cache.store ? cache.store->get(cache.key) : std::nullopt;
+    if (!content) {
+        return {};
+    }
+
+    std::istringstream lines(content.value());
+
+    std::string line;
+    if (!std::getline(lines, line) || line != header) {
+        return {};
+    }
+
+    std::string hash_key;
+    uint32_t stored_hash = 0;
+    if (!std::getline(lines, line) || !(std::istringstream(line) >> hash_key >> stored_hash) ||
+        hash_key != "hash" || stored_hash != hash) {
+        return {};
+    }
+
+    Params params;
+    while (std::getline(lines, line)) {
+        std::istringstream fields(line);
+        std::string name;
+        int type = 0;
+        uint32_t bits = 0;
+        if (!(fields >> name >> type >> bits) || name.size() > 16) {
+            LogWarn() << "Broken param cache " << cache.key;
+            return {};
+        }
+
+        mavlink_param_value_t param_value{};
+        memcpy(param_value.param_id, name.data(), name.size());
+        param_value.param_type = static_cast<uint8_t>(type);
+        memcpy(&param_value.param_value, &bits, sizeof(bits));
+
+        MAVLinkParameters::ParamValue value;
+        if (!value.set_from_mavlink_param_value_bytewise(param_value)) {
+            LogWarn() << "Broken param cache " << cache.key;
+            return {};
+        }
+        params[name] = value;
+    }
+
+    return params;
+}
+
+} // namespace mavsdk
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "mavlink_parameters.h"
+#include "state_store.h"
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <string>
+
+namespace mavsdk {
+
+// Stores all parameters of an autopilot in the state store, together with
+// the _HASH_CHECK it reported, so they don't need to be downloaded again on
+// the next connection as long as the hash is still the same.
+//
+// Values are stored as the raw bytes sent over MAVLink, so they are restored
+// exactly.
+
+class ParamCache {
+public:
+    using Params = std::map<std::string, MAVLinkParameters::ParamValue>;
+
+    // Returns false if a parameter doesn't fit into PARAM_VALUE.
+    static bool save(const StateStoreKey& cache, uint32_t hash, const Params& params);
+
+    // Returns nothing if there is no cache, it is broken, or it was stored
+    // for another hash.
+    static std::optional<Params> load(const StateStoreKey& cache, uint32_t hash);
+};
+
+} // namespace mavsdk
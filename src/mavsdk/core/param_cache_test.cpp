@@ -0,0 +1,84 @@
+#include "param_cache.h"
+#include "fs.h"
+#include <gtest/gtest.h>
+
+using namespace mavsdk;
+
+namespace {
+
+StateStoreKey tmp_cache(const std::string& name)
+{
+    auto tmp_dir = create_tmp_directory("mavsdk-param-cache-test");
+    EXPECT_TRUE(tmp_dir);
+    const auto path = tmp_dir.value_or(".") + "/" + name;
+    fs_remove(path);
+    return StateStoreKey{std::make_shared<StateStore>(path), "params/0123"};
+}
+
+ParamCache::Params some_params()
+{
+    ParamCache::Params params;
+    params["MIS_TAKEOFF_ALT"].set(2.5f);
+    params["MPC_XY_VEL_MAX"].set(-0.1f);
+    params["SYS_AUTOSTART"].set(int32_t{4001});
+    params["CAL_ACC0_ID"].set(uint32_t{4294967295});
+    params["COM_RC_IN_MODE"].set(int16_t{-2});
+    params["SDLOG_PROFILE"].set(uint8_t{3});
+    params["SIXTEEN_CHARS_ID"].set(int8_t{-7});
+    return params;
+}
+
+} // namespace
+
+TEST(ParamCache, RoundTrip)
+{
+    const auto cache = tmp_cache("round_trip.cache");
+    const auto params = some_params();
+
+    ASSERT_TRUE(ParamCache::save(cache, 0xdeadbeef, params));
+    const auto loaded = ParamCache::load(cache, 0xdeadbeef);
+    ASSERT_TRUE(loaded);
+
+    ASSERT_EQ(loaded->size(), params.size());
+    for (const auto& [name, value] : params) {
+        ASSERT_EQ(loaded->count(name), 1) << name;
+        EXPECT_TRUE(loaded->at(name) == value) << name;
+    }
+}
+
+TEST(ParamCache, OtherHashIsNotLoaded)
+{
+    const auto cache = tmp_cache("other_hash.cache");
+
+    ASSERT_TRUE(ParamCache::save(cache, 1, some_params()));
+    EXPECT_FALSE(ParamCache::load(cache, 2));
+
+    // Saving again replaces the old cache.
+    ASSERT_TRUE(ParamCache::save(cache, 2, some_params()));
+    EXPECT_TRUE(ParamCache::load(cache, 2));
+    EXPECT_FALSE(ParamCache::load(cache, 1));
+}
+
+TEST(ParamCache, MissingOrBrokenCacheIsNotLoaded)
+{
+    const auto cache = tmp_cache("broken.cache");
+    EXPECT_FALSE(ParamCache::load(cache, 1));
+
+    ASSERT_TRUE(ParamCache::save(cache, 1, some_params()));
+    cache.store->put(cache.key, cache.store->get(cache.key).value() + "TRUNCATED_PAR");
+    EXPECT_FALSE(ParamCache::load(cache, 1));
+
+    // Without a store, nothing is cached.
+    EXPECT_FALSE(ParamCache::save(StateStoreKey{}, 1, some_params()));
+    EXPECT_FALSE(ParamCache::load(StateStoreKey{}, 1));
+}
+
+TEST(ParamCache, ParamsNotFittingIntoParamValueAreNotSaved)
+{
+    const auto cache = tmp_cache("custom.cache");
+
+    auto params = some_params();
+    params["CUSTOM"].set(std::string{"not a number"});
+    EXPECT_FALSE(ParamCache::save(cache, 1, params));
+    EXPECT_FALSE(cache.store->get(cache.key));
+}
@@ -0,0 +1,136 @@
+#include "param_pck.h"
+#include "log.h"
+
+#include <cstring>
+#include <type_traits>
+
+namespace mavsdk {
+
+namespace {
+
+constexpr uint16_t magic_without_defaults = 0x671B;
+constexpr uint16_t magic_with_defaults = 0x671C;
+
+// Types as used by AP_Param.
+enum class PckType : uint8_t { Int8 = 1, Int16 = 2, Int32 = 3, Float = 4 };
+
+constexpr uint8_t flag_has_default = 1;
+
+uint16_t read_uint16(const uint8_t* data)
+{
+    return static_cast<uint16_t>(data[0] | (data[1] << 8));
+}
+
+template<typename T> T read_value(const uint8_t* data)
+{
+    // Little endian, as the autopilot sends it.
+    uint32_t bits = 0;
+    for (unsigned i = 0; i < sizeof(T); ++i) {
+        bits |= uint32_t(data[i]) << (8 * i);
+    }
+    if constexpr (std::is_same_v<T, float>) {
+        T value;
+        memcpy(&value, &bits, sizeof(value));
+        return value;
+    } else {
+        return static_cast<T>(bits);
+    }
+}
+
+size_t size_of(PckType type)
+{
+    switch (type) {
+        case PckType::Int8:
+            return 1;
+        case PckType::Int16:
+            return 2;
+        case PckType::Int32:
+        case PckType::Float:
+            return 4;
+    }
+    return 0;
+}
+
+} // namespace
+
+std::optional<std::map<std::string, MAVLinkParameters::ParamValue>>
+parse_param_pck(const std::vector<uint8_t>& data)
+{
+    constexpr size_t header_len = 6;
+    if (data.size() < header_len) {
+        LogWarn() << "param.pck too short";
+        return {};
+    }
+
+    const uint16_t magic = read_uint16(&data[0]);
+    if (magic != magic_without_defaults && magic != magic_with_defaults) {
+        LogWarn() << "param.pck has unknown magic " << magic;
+        return {};
+    }
+    const uint16_t num_params = read_uint16(&data[2]);
+
+    std::map<std::string, MAVLinkParameters::ParamValue> params;
+    std::string name;
+    size_t pos = header_len;
+
+    while (pos < data.size()) {
+        // Blocks are padded with zeros.
+        if (data[pos] == 0) {
+            ++pos;
+            continue;
+        }
+
+        if (pos + 2 > data.size()) {
+            LogWarn() << "param.pck truncated";
+            return {};
+        }
+
+        const auto type = static_cast<PckType>(data[pos] & 0x0F);
+        const uint8_t flags = data[pos] >> 4;
+        // Names are stored without the part in common with the previous one.
+        const size_t common_len = data[pos + 1] & 0x0F;
+        const size_t name_len = (data[pos + 1] >> 4) + 1U;
+        pos += 2;
+
+        const size_t value_len = size_of(type);
+        const size_t default_len = (flags & flag_has_default) ? value_len : 0;
+        if (value_len == 0 || common_len > name.size() ||
+            pos + name_len + value_len + default_len > data.size()) {
+            LogWarn() << "param.pck broken";
+            return {};
+        }
+
+        name.resize(common_len);
+        name.append(reinterpret_cast<const char*>(&data[pos]), name_len);
+        pos += name_len;
+
+        MAVLinkParameters::ParamValue value;
+        switch (type) {
+            case PckType::Int8:
+                value.set(read_value<int8_t>(&data[pos]));
+                break;
+            case PckType::Int16:
+                value.set(read_value<int16_t>(&data[pos]));
+                break;
+            case PckType::Int32:
+                value.set(read_value<int32_t>(&data[pos]));
+                break;
+            case PckType::Float:
+                value.set(read_value<float>(&data[pos]));
+                break;
+        }
+        pos += value_len + default_len;
+
+        params[name] = value;
+    }
+
+    if (params.size() != num_params) {
+        LogWarn() << "param.pck contains " << params.size() << " instead of " << num_params
+                  << " params";
+        return {};
+    }
+
+    return params;
+}
+
+} // namespace mavsdk
@@ -0,0 +1,20 @@
+#pragma once
+
+#include "mavlink_parameters.h"
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace mavsdk {
+
+// Path of the file containing all params, as served over MAVLink FTP by
+// ArduPilot, see libraries/AP_Filesystem/README.md in ArduPilot.
+constexpr const char* PARAM_PCK_PATH = "@PARAM/param.pck";
+
+// Returns nothing if the file is broken or doesn't contain all params.
+std::optional<std::map<std::string, MAVLinkParameters::ParamValue>>
+parse_param_pck(const std::vector<uint8_t>& data);
+
+} // namespace mavsdk
@@ -0,0 +1,88 @@
+#include "param_pck.h"
+#include <gtest/gtest.h>
+
+using namespace mavsdk;
+
+namespace {
+
+void append_uint16(std::vector<uint8_t>& data, uint16_t value)
+{
+    data.push_back(static_cast<uint8_t>(value & 0xFF));
+    data.push_back(static_cast<uint8_t>(value >> 8));
+}
+
+// Entries as written by ArduPilot's AP_Filesystem_Param.
+void append_param(
+    std::vector<uint8_t>& data,
+    uint8_t type,
+    uint8_t flags,
+    uint8_t common_len,
+    const std::string& name_suffix,
+    const std::vector<uint8_t>& value)
+{
+    data.push_back(static_cast<uint8_t>(type | (flags << 4)));
+    data.push_back(static_cast<uint8_t>(common_len | ((name_suffix.size() - 1) << 4)));
+    data.insert(data.end(), name_suffix.begin(), name_suffix.end());
+    data.insert(data.end(), value.begin(), value.end());
+}
+
+std::vector<uint8_t> some_pck(uint16_t magic, uint16_t num_params)
+{
+    std::vector<uint8_t> data;
+    append_uint16(data, magic);
+    append_uint16(data, num_params);
+    append_uint16(data, num_params);
+
+    // 1.5f
+    append_param(data, 4, 0, 0, "ACRO_BAL_PITCH", {0x00, 0x00, 0xc0, 0x3f});
+    // Shares "ACRO_BAL_" with the previous one.
+    append_param(data, 4, 0, 9, "ROLL", {0x00, 0x00, 0x80, 0xbf});
+    append_param(data, 1, 0, 0, "ARMING_RUDDER", {0xfe});
+    data.push_back(0); // padding
+    data.push_back(0);
+    append_param(data, 2, 0, 7, "CHECK", {0x34, 0x12});
+    append_param(data, 3, 0, 0, "BRD_SERIAL_NUM", {0xff, 0xff, 0xff, 0xff});
+    return data;
+}
+
+} // namespace
+
+TEST(ParamPck, ParsesAllTypes)
+{
+    const auto params = parse_param_pck(some_pck(0x671B, 5));
+    ASSERT_TRUE(params);
+    ASSERT_EQ(params->size(), 5);
+
+    EXPECT_EQ(params->at("ACRO_BAL_PITCH").get<float>(), 1.5f);
+    EXPECT_EQ(params->at("ACRO_BAL_ROLL").get<float>(), -1.0f);
+    EXPECT_EQ(params->at("ARMING_RUDDER").get<int8_t>(), -2);
+    EXPECT_EQ(params->at("ARMING_CHECK").get<int16_t>(), 0x1234);
+    EXPECT_EQ(params->at("BRD_SERIAL_NUM").get<int32_t>(), -1);
+}
+
+TEST(ParamPck, SkipsDefaults)
+{
+    auto data = some_pck(0x671C, 6);
+    append_param(data, 2, 1, 0, "COMPASS_USE", {0x01, 0x00, 0x02, 0x00});
+
+    const auto params = parse_param_pck(data);
+    ASSERT_TRUE(params);
+    EXPECT_EQ(params->at("COMPASS_USE").get<int16_t>(), 1);
+}
+
+TEST(ParamPck, RejectsBrokenFiles)
+{
+    EXPECT_FALSE(parse_param_pck({}));
+    EXPECT_FALSE(parse_param_pck(some_pck(0x1234, 5)));
+
+    // Params missing.
+    EXPECT_FALSE(parse_param_pck(some_pck(0x671B, 6)));
+
+    auto truncated = some_pck(0x671B, 5);
+    truncated.pop_back();
+    EXPECT_FALSE(parse_param_pck(truncated));
+
+    auto unknown_type = some_pck(0x671B, 6);
+    append_param(unknown_type, 7, 0, 0, "X", {0x00});
+    EXPECT_FALSE(parse_param_pck(unknown_type));
+}
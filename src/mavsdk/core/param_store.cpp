@@ -0,0 +1,303 @@
+#include "param_store.h"
+#include "crc32.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace mavsdk {
+
+namespace {
+
+template<typename T> bool pack_as(const ParamStore::ParamValue& value, uint64_t& bits)
+{
+    if (!value.is<T>()) {
+        return false;
+    }
+    const T raw = value.get<T>();
+    bits = 0;
+    memcpy(&bits, &raw, sizeof(raw));
+    return true;
+}
+
+template<typename T> ParamStore::ParamValue unpack_as(uint64_t bits)
+{
+    T raw;
+    memcpy(&raw, &bits, sizeof(raw));
+    ParamStore::ParamValue value;
+    value.set(raw);
+    return value;
+}
+
+} // namespace
+
+bool ParamStore::set(const std::string& name, const ParamValue& value)
+{
+    const auto fixed_name = name_of(name);
+    if (!fixed_name) {
+        return false;
+    }
+
+    // Lists are usually sent sorted, so this mostly appends.
+    const size_t position = lower_bound(fixed_name.value());
+    if (position < _names.size() && _names[position] == fixed_name.value()) {
+        _values[position] = pack(value, &_values[position]);
+        return true;
+    }
+
+    _names.insert(_names.begin() + static_cast<std::ptrdiff_t>(position), fixed_name.value());
+    _values.insert(_values.begin() + static_cast<std::ptrdiff_t>(position), pack(value, nullptr));
+    return true;
+}
+
+bool ParamStore::set_all(const std::vector<std::pair<std::string, ParamValue>>& params)
+{
+    struct NewParam {
+        Name name;
+        const ParamValue* value;
+    };
+
+    std::vector<NewParam> new_params;
+    new_params.reserve(params.size());
+    for (const auto& [name, value] : params) {
+        const auto fixed_name = name_of(name);
+        if (!fixed_name) {
+            return false;
+        }
+        new_params.push_back(NewParam{fixed_name.value(), &value});
+    }
+
+    const auto less = [](const NewParam& lhs, const NewParam& rhs) {
+        return memcmp(lhs.name.data(), rhs.name.data(), NAME_LEN) < 0;
+    };
+    std::stable_sort(new_params.begin(), new_params.end(), less);
+
+    std::vector<Name> names;
+    std::vector<Value> values;
+    names.reserve(_names.size() + new_params.size());
+    values.reserve(_values.size() + new_params.size());
+
+    size_t old_position = 0;
+    for (size_t i = 0; i < new_params.size(); ++i) {
+        // Of the same names, only the last one counts.
+        if (i + 1 < new_params.size() && !less(new_params[i], new_params[i + 1])) {
+            continue;
+        }
+        const auto& new_param = new_params[i];
+
+        while (old_position < _names.size() &&
+               memcmp(_names[old_position].data(), new_param.name.data(), NAME_LEN) < 0) {
+            names.push_back(_names[old_position]);
+            values.push_back(_values[old_position]);
+            ++old_position;
+        }
+
+        const Value* old_value = nullptr;
+        if (old_position < _names.size() && _names[old_position] == new_param.name) {
+            old_value = &_values[old_position];
+            ++old_position;
+        }
+        names.push_back(new_param.name);
+        values.push_back(pack(*new_param.value, old_value));
+    }
+
+    names.insert(
+        names.end(), _names.begin() + static_cast<std::ptrdiff_t>(old_position), _names.end());
+    values.insert(
+        values.end(), _values.begin() + static_cast<std::ptrdiff_t>(old_position), _values.end());
+
+    _names = std::move(names);
+    _values = std::move(values);
+    return true;
+}
+
+std::optional<ParamStore::ParamValue> ParamStore::get(const std::string& name) const
+{
+    const auto fixed_name = name_of(name);
+    if (!fixed_name) {
+        return {};
+    }
+
+    const size_t position = lower_bound(fixed_name.value());
+    if (position == _names.size() || _names[position] != fixed_name.value()) {
+        return {};
+    }
+    return unpack(_values[position]);
+}
+
+bool ParamStore::contains(const std::string& name) const
+{
+    const auto fixed_name = name_of(name);
+    if (!fixed_name) {
+        return false;
+    }
+
+    const size_t position = lower_bound(fixed_name.value());
+    return position < _names.size() && _names[position] == fixed_name.value();
+}
+
+std::string ParamStore::name_at(size_t position) const
+{
+    const Name& name = _names[position];
+    return std::string(name.data(), strnlen(name.data(), name.size()));
+}
+
+ParamStore::ParamValue ParamStore::value_at(size_t position) const
+{
+    return unpack(_values[position]);
+}
+
+void ParamStore::for_each(
+    const std::function<void(const std::string&, const ParamValue&)>& visitor) const
+{
+    for (size_t i = 0; i < _names.size(); ++i) {
+        visitor(name_at(i), unpack(_values[i]));
+    }
+}
+
+void ParamStore::clear()
+{
+    _names.clear();
+    _values.clear();
+    _custom_values.clear();
+}
+
+size_t ParamStore::memory_usage() const
+{
+    size_t bytes = _names.capacity() * sizeof(Name) + _values.capacity() * sizeof(Value) +
+                   _custom_values.capacity() * sizeof(std::string);
+    for (const auto& custom_value : _custom_values) {
+        bytes += custom_value.capacity();
+    }
+    return bytes;
+}
+
+void ParamStore::assign(const std::map<std::string, ParamValue>& params)
+{
+    clear();
+    _names.reserve(params.size());
+    _values.reserve(params.size());
+    for (const auto& [name, value] : params) {
+        set(name, value);
+    }
+}
+
+std::map<std::string, ParamStore::ParamValue> ParamStore::to_map() const
+{
+    std::map<std::string, ParamValue> params;
+    for (size_t i = 0; i < _names.size(); ++i) {
+        params.emplace_hint(params.end(), name_at(i), unpack(_values[i]));
+    }
+    return params;
+}
+
+uint32_t ParamStore::hash() const
+{
+    Crc32 crc32;
+    for (size_t i = 0; i < _names.size(); ++i) {
+        if (_values[i].type == Type::Custom) {
+            continue;
+        }
+
+        // The value as it goes into PARAM_VALUE, i.e. its first 4 bytes.
+        uint8_t value_bytes[4];
+        memcpy(value_bytes, &_values[i].bits, sizeof(value_bytes));
+
+        const auto name_end = std::find(_names[i].begin(), _names[i].end(), '\0');
+        crc32.add(
+            reinterpret_cast<const uint8_t*>(_names[i].data()),
+            static_cast<uint32_t>(name_end - _names[i].begin()));
+        crc32.add(value_bytes, sizeof(value_bytes));
+    }
+    return crc32.get();
+}
+
+std::optional<ParamStore::Name> ParamStore::name_of(const std::string& name)
+{
+    if (name.size() > NAME_LEN) {
+        return {};
+    }
+    Name fixed_name{};
+    memcpy(fixed_name.data(), name.data(), name.size());
+    return fixed_name;
+}
+
+size_t ParamStore::lower_bound(const Name& name) const
+{
+    // Zero padded, so this sorts like std::string.
+    const auto it = std::lower_bound(
+        _names.begin(), _names.end(), name, [](const Name& lhs, const Name& rhs) {
+            return memcmp(lhs.data(), rhs.data(), NAME_LEN) < 0;
+        });
+    return static_cast<size_t>(it - _names.begin());
+}
+
+ParamStore::Value ParamStore::pack(const ParamValue& value, const Value* old_value)
+{
+    Value packed;
+    if (pack_as<uint8_t>(value, packed.bits)) {
+        packed.type = Type::Uint8;
+    } else if (pack_as<int8_t>(value, packed.bits)) {
+        packed.type = Type::Int8;
+    } else if (pack_as<uint16_t>(value, packed.bits)) {
+        packed.type = Type::Uint16;
+    } else if (pack_as<int16_t>(value, packed.bits)) {
+        packed.type = Type::Int16;
+    } else if (pack_as<uint32_t>(value, packed.bits)) {
+        packed.type = Type::Uint32;
+    } else if (pack_as<int32_t>(value, packed.bits)) {
+        packed.type = Type::Int32;
+    } else if (pack_as<uint64_t>(value, packed.bits)) {
+        packed.type = Type::Uint64;
+    } else if (pack_as<int64_t>(value, packed.bits)) {
+        packed.type = Type::Int64;
+    } else if (pack_as<float>(value, packed.bits)) {
+        packed.type = Type::Float;
+    } else if (pack_as<double>(value, packed.bits)) {
+        packed.type = Type::Double;
+    } else {
+        // A custom param replacing another one reuses its string.
+        packed.type = Type::Custom;
+        if (old_value != nullptr && old_value->type == Type::Custom) {
+            packed.bits = old_value->bits;
+            _custom_values[packed.bits] = value.get<std::string>();
+        } else {
+            packed.bits = _custom_values.size();
+            _custom_values.push_back(value.get<std::string>());
+        }
+    }
+    return packed;
+}
+
+ParamStore::ParamValue ParamStore::unpack(const Value& value) const
+{
+    switch (value.type) {
+        case Type::Uint8:
+            return unpack_as<uint8_t>(value.bits);
+        case Type::Int8:
+            return unpack_as<int8_t>(value.bits);
+        case Type::Uint16:
+            return unpack_as<uint16_t>(value.bits);
+        case Type::Int16:
+            return unpack_as<int16_t>(value.bits);
+        case Type::Uint32:
+            return unpack_as<uint32_t>(value.bits);
+        case Type::Int32:
+            return unpack_as<int32_t>(value.bits);
+        case Type::Uint64:
+            return unpack_as<uint64_t>(value.bits);
+        case Type::Int64:
+            return unpack_as<int64_t>(value.bits);
+        case Type::Float:
+            return unpack_as<float>(value.bits);
+        case Type::Double:
+            return unpack_as<double>(value.bits);
+        case Type::Custom:
+            break;
+    }
+
+    ParamValue custom;
+    custom.set(_custom_values[value.bits]);
+    return custom;
+}
+
+} // namespace mavsdk
@@ -0,0 +1,99 @@
+#pragma once
+
+#include "mavlink_parameters.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace mavsdk {
+
+// All params of a component, stored compactly: the names are fixed size and
+// kept sorted in one flat array, so they can be found with a binary search,
+// and the values are plain data in a parallel array. Only custom params need
+// memory of their own.
+//
+// The position of a param is its index when sending the list, as names are
+// sorted the same way as in a std::map.
+
+class ParamStore {
+public:
+    using ParamValue = MAVLinkParameters::ParamValue;
+
+    // Params can be up to 16 chars without 0-termination.
+    static constexpr size_t NAME_LEN = 16;
+
+    // Returns false if the name is too long.
+    bool set(const std::string& name, const ParamValue& value);
+
+    // Sorts them once and merges them in, rather than inserting one by one,
+    // e.g. when a component provides all its params at startup. If a name is
+    // given twice, the later value wins. Returns false, without changing
+    // anything, if a name is too long.
+    bool set_all(const std::vector<std::pair<std::string, ParamValue>>& params);
+
+    [[nodiscard]] std::optional<ParamValue> get(const std::string& name) const;
+    [[nodiscard]] bool contains(const std::string& name) const;
+
+    [[nodiscard]] size_t size() const { return _names.size(); }
+    [[nodiscard]] std::string name_at(size_t position) const;
+    [[nodiscard]] ParamValue value_at(size_t position) const;
+
+    // Calls the visitor for every param in list order, without copying all
+    // of them first.
+    void for_each(const std::function<void(const std::string&, const ParamValue&)>& visitor) const;
+
+    void clear();
+
+    // Bytes allocated for the params.
+    [[nodiscard]] size_t memory_usage() const;
+
+    // Hash over all names and values in list order, like PX4's _HASH_CHECK.
+    // Custom params are left out as they are not part of the list.
+    [[nodiscard]] uint32_t hash() const;
+
+    // Heap allocating, for the API.
+    void assign(const std::map<std::string, ParamValue>& params);
+    [[nodiscard]] std::map<std::string, ParamValue> to_map() const;
+
+private:
+    using Name = std::array<char, NAME_LEN>;
+
+    enum class Type : uint8_t {
+        Uint8,
+        Int8,
+        Uint16,
+        Int16,
+        Uint32,
+        Int32,
+        Uint64,
+        Int64,
+        Float,
+        Double,
+        Custom,
+    };
+
+    // For custom params, the bits are the position in _custom_values.
+    struct Value {
+        uint64_t bits{0};
+        Type type{Type::Uint8};
+    };
+
+    static std::optional<Name> name_of(const std::string& name);
+    // Position of the name, or where it would need to be inserted.
+    [[nodiscard]] size_t lower_bound(const Name& name) const;
+
+    [[nodiscard]] Value pack(const ParamValue& value, const Value* old_value);
+    [[nodiscard]] ParamValue unpack(const Value& value) const;
+
+    std::vector<Name> _names{};
+    std::vector<Value> _values{};
+    std::vector<std::string> _custom_values{};
+};
+
+} // namespace mavsdk
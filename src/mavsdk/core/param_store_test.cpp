@@ -0,0 +1,200 @@
+#include "param_store.h"
+#include "crc32.h"
+#include <gtest/gtest.h>
+
+using namespace mavsdk;
+
+namespace {
+
+ParamStore::ParamValue value_of(float value)
+{
+    ParamStore::ParamValue param_value;
+    param_value.set(value);
+    return param_value;
+}
+
+} // namespace
+
+TEST(ParamStore, KeepsAllTypes)
+{
+    ParamStore store;
+    ParamStore::ParamValue value;
+
+    value.set(uint8_t{200});
+    EXPECT_TRUE(store.set("U8", value));
+    value.set(int16_t{-300});
+    EXPECT_TRUE(store.set("I16", value));
+    value.set(uint32_t{4000000000});
+    EXPECT_TRUE(store.set("U32", value));
+    value.set(int64_t{-5000000000});
+    EXPECT_TRUE(store.set("I64", value));
+    value.set(0.25);
+    EXPECT_TRUE(store.set("DOUBLE", value));
+    value.set(std::string{"some text"});
+    EXPECT_TRUE(store.set("CUSTOM", value));
+
+    EXPECT_EQ(store.size(), 6);
+    EXPECT_EQ(store.get("U8")->get<uint8_t>(), 200);
+    EXPECT_EQ(store.get("I16")->get<int16_t>(), -300);
+    EXPECT_EQ(store.get("U32")->get<uint32_t>(), 4000000000);
+    EXPECT_EQ(store.get("I64")->get<int64_t>(), -5000000000);
+    EXPECT_EQ(store.get("DOUBLE")->get<double>(), 0.25);
+    EXPECT_EQ(store.get("CUSTOM")->get<std::string>(), "some text");
+    EXPECT_FALSE(store.get("MISSING"));
+}
+
+TEST(ParamStore, SortedLikeMap)
+{
+    ParamStore store;
+    std::map<std::string, ParamStore::ParamValue> expected;
+    for (const std::string name : {"MPC_XY_P", "MPC_X", "A", "SIXTEEN_CHARS_ID", "MPC_XY", "B"}) {
+        store.set(name, value_of(1.0f));
+        expected[name] = value_of(1.0f);
+    }
+
+    ASSERT_EQ(store.size(), expected.size());
+    size_t position = 0;
+    for (const auto& [name, value] : expected) {
+        EXPECT_EQ(store.name_at(position), name);
+        EXPECT_TRUE(store.value_at(position) == value);
+        ++position;
+    }
+    EXPECT_EQ(store.to_map().size(), expected.size());
+}
+
+TEST(ParamStore, ReplacesValues)
+{
+    ParamStore store;
+    store.set("MIS_TAKEOFF_ALT", value_of(2.5f));
+    store.set("MIS_TAKEOFF_ALT", value_of(10.0f));
+    EXPECT_EQ(store.size(), 1);
+    EXPECT_EQ(store.get("MIS_TAKEOFF_ALT")->get<float>(), 10.0f);
+
+    ParamStore::ParamValue custom;
+    custom.set(std::string{"first"});
+    store.set("CUSTOM", custom);
+    custom.set(std::string{"second"});
+    store.set("CUSTOM", custom);
+    EXPECT_EQ(store.get("CUSTOM")->get<std::string>(), "second");
+}
+
+TEST(ParamStore, RejectsLongNames)
+{
+    ParamStore store;
+    EXPECT_FALSE(store.set("SEVENTEEN_CHARS_X", value_of(1.0f)));
+    EXPECT_FALSE(store.contains("SEVENTEEN_CHARS_X"));
+    EXPECT_EQ(store.size(), 0);
+}
+
+TEST(ParamStore, AssignReplacesEverything)
+{
+    ParamStore store;
+    store.set("OLD", value_of(1.0f));
+
+    std::map<std::string, ParamStore::ParamValue> params;
+    params["NEW_1"] = value_of(1.0f);
+    params["NEW_2"] = value_of(2.0f);
+    store.assign(params);
+
+    EXPECT_EQ(store.size(), 2);
+    EXPECT_FALSE(store.contains("OLD"));
+    EXPECT_TRUE(store.contains("NEW_2"));
+
+    store.clear();
+    EXPECT_EQ(store.size(), 0);
+}
+
+TEST(ParamStore, SetAllMergesIntoExistingParams)
+{
+    ParamStore store;
+    store.set("B_KEPT", value_of(1.0f));
+    store.set("D_REPLACED", value_of(2.0f));
+
+    ParamStore::ParamValue custom;
+    custom.set(std::string{"text"});
+
+    std::vector<std::pair<std::string, ParamStore::ParamValue>> params{
+        {"E_NEW", value_of(5.0f)},
+        {"D_REPLACED", value_of(3.0f)},
+        {"A_NEW", value_of(4.0f)},
+        {"C_CUSTOM", custom},
+        {"E_NEW", value_of(6.0f)},
+    };
+    EXPECT_TRUE(store.set_all(params));
+
+    std::vector<std::string> names;
+    store.for_each([&](const std::string& name, const ParamStore::ParamValue&) {
+        names.push_back(name);
+    });
+    EXPECT_EQ(
+        names,
+        (std::vector<std::string>{"A_NEW", "B_KEPT", "C_CUSTOM", "D_REPLACED", "E_NEW"}));
+
+    EXPECT_EQ(store.get("B_KEPT")->get<float>(), 1.0f);
+    EXPECT_EQ(store.get("D_REPLACED")->get<float>(), 3.0f);
+    EXPECT_EQ(store.get("C_CUSTOM")->get<std::string>(), "text");
+    // The later one wins.
+    EXPECT_EQ(store.get("E_NEW")->get<float>(), 6.0f);
+
+    // Same as one by one.
+    ParamStore one_by_one;
+    one_by_one.set("B_KEPT", value_of(1.0f));
+    for (const auto& [name, value] : params) {
+        one_by_one.set(name, value);
+    }
+    EXPECT_EQ(store.hash(), one_by_one.hash());
+}
+
+TEST(ParamStore, SetAllRejectsLongNames)
+{
+    ParamStore store;
+    store.set("KEPT", value_of(1.0f));
+
+    EXPECT_FALSE(store.set_all(
+        {{"FINE", value_of(2.0f)}, {"SEVENTEEN_CHARS_X", value_of(3.0f)}}));
+    EXPECT_EQ(store.size(), 1);
+    EXPECT_FALSE(store.contains("FINE"));
+}
+
+TEST(ParamStore, HashFollowsNamesAndValues)
+{
+    ParamStore store;
+    EXPECT_EQ(store.hash(), 0);
+
+    store.set("A", value_of(1.0f));
+    store.set("B", value_of(2.0f));
+    const auto hash = store.hash();
+    EXPECT_NE(hash, 0);
+
+    // This is what a client computes from the received list.
+    Crc32 crc32;
+    const float a = 1.0f;
+    const float b = 2.0f;
+    crc32.add(reinterpret_cast<const uint8_t*>("A"), 1);
+    crc32.add(reinterpret_cast<const uint8_t*>(&a), sizeof(a));
+    crc32.add(reinterpret_cast<const uint8_t*>("B"), 1);
+    crc32.add(reinterpret_cast<const uint8_t*>(&b), sizeof(b));
+    EXPECT_EQ(hash, crc32.get());
+
+    store.set("B", value_of(3.0f));
+    EXPECT_NE(store.hash(), hash);
+
+    store.set("B", value_of(2.0f));
+    EXPECT_EQ(store.hash(), hash);
+
+    ParamStore::ParamValue custom;
+    custom.set(std::string{"ignored"});
+    store.set("C", custom);
+    EXPECT_EQ(store.hash(), hash);
+}
+
+TEST(ParamStore, MemoryUsageGrowsWithParams)
+{
+    ParamStore store;
+    EXPECT_EQ(store.memory_usage(), 0u);
+
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_TRUE(store.set("PARAM_" + std::to_string(i), value_of(1.0f)));
+    }
+    EXPECT_GE(store.memory_usage(), 100 * ParamStore::NAME_LEN);
+}
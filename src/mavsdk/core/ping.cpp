@@ -19,6 +19,17 @@ Ping::~Ping()
 
 void Ping::run_once()
 {
+    uint32_t sequence;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        // A reply later than the next ping counts as lost.
+        if (_awaiting_reply) {
+            _rtt_statistics.add_lost();
+        }
+        _awaiting_reply = true;
+        sequence = ++_ping_sequence;
+    }
+
     mavlink_message_t message;
 
     mavlink_msg_ping_pack(
@@ -26,7 +37,7 @@ void Ping::run_once()
         _system_impl.get_own_component_id(),
         &message,
         _system_impl.get_time().elapsed_us(),
-        _ping_sequence,
+        sequence,
         0,
         0); // to all
 
@@ -54,18 +65,32 @@ void Ping::process_ping(const mavlink_message_t& message)
 
     } else {
         // Answer from ping request.
-        if (ping.seq != _ping_sequence) {
-            LogWarn() << "Ignoring unknown ping sequence";
-            return;
-        }
-
         if (message.compid != MAV_COMP_ID_AUTOPILOT1) {
             // We're currently only interested in the ping of the autopilot.
             return;
         }
 
-        _last_ping_time_us = _system_impl.get_time().elapsed_us() - ping.time_usec;
+        const uint64_t ping_time_us = _system_impl.get_time().elapsed_us() - ping.time_usec;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (ping.seq != _ping_sequence || !_awaiting_reply) {
+                // Already counted as lost.
+                LogDebug() << "Ignoring late or unknown ping sequence";
+                return;
+            }
+            _awaiting_reply = false;
+            _rtt_statistics.add_sample(static_cast<double>(ping_time_us) * 1e-6);
+        }
+
+        _last_ping_time_us = ping_time_us;
+        _system_impl.rtt_estimator().add_sample(static_cast<double>(ping_time_us) * 1e-6);
     }
 }
 
+RttStats Ping::rtt_stats() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _rtt_statistics.stats();
+}
+
 } // namespace mavsdk
@@ -1,7 +1,9 @@
 #pragma once
 
 #include "mavlink_include.h"
+#include "rtt_statistics.h"
 #include <atomic>
+#include <mutex>
 
 namespace mavsdk {
 
@@ -18,12 +20,18 @@ public:
         return static_cast<double>(_last_ping_time_us) * 1e-6;
     }
 
+    [[nodiscard]] RttStats rtt_stats() const;
+
 private:
     void process_ping(const mavlink_message_t& message);
 
     SystemImpl& _system_impl;
-    uint32_t _ping_sequence{0};
     std::atomic<uint64_t> _last_ping_time_us{0};
+
+    mutable std::mutex _mutex{};
+    uint32_t _ping_sequence{0}; // Needs _mutex
+    bool _awaiting_reply{false}; // Needs _mutex
+    RttStatistics _rtt_statistics{}; // Needs _mutex
 };
 
 } // namespace mavsdk
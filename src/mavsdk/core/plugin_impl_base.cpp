@@ -7,4 +7,71 @@ PluginImplBase::PluginImplBase(System& system) : _system_impl(system.system_impl
 PluginImplBase::PluginImplBase(std::shared_ptr<System> system) : _system_impl(system->system_impl())
 {}
 
+void PluginImplBase::register_on_demand_handler(
+    uint16_t msg_id, const SystemImpl::MavlinkMessageHandler& callback)
+{
+    std::lock_guard<std::mutex> lock(_on_demand_handlers_mutex);
+    auto& handler = _on_demand_handlers[msg_id];
+    if (handler.registered) {
+        _system_impl->unregister_mavlink_message_handler(msg_id, &_on_demand_handlers);
+        handler.registered = false;
+    }
+    handler.callback = callback;
+    update_on_demand_handler(msg_id, handler);
+}
+
+void PluginImplBase::set_handler_needed(uint16_t msg_id, bool needed)
+{
+    std::lock_guard<std::mutex> lock(_on_demand_handlers_mutex);
+    auto it = _on_demand_handlers.find(msg_id);
+    if (it == _on_demand_handlers.end()) {
+        return;
+    }
+    it->second.needed = needed;
+    update_on_demand_handler(msg_id, it->second);
+}
+
+void PluginImplBase::keep_handler(uint16_t msg_id)
+{
+    std::lock_guard<std::mutex> lock(_on_demand_handlers_mutex);
+    auto it = _on_demand_handlers.find(msg_id);
+    if (it == _on_demand_handlers.end() || it->second.kept) {
+        return;
+    }
+    it->second.kept = true;
+    update_on_demand_handler(msg_id, it->second);
+}
+
+void PluginImplBase::set_handlers_on_demand(bool enabled)
+{
+    std::lock_guard<std::mutex> lock(_on_demand_handlers_mutex);
+    _handlers_on_demand = enabled;
+    for (auto& [msg_id, handler] : _on_demand_handlers) {
+        update_on_demand_handler(msg_id, handler);
+    }
+}
+
+void PluginImplBase::unregister_on_demand_handlers()
+{
+    std::lock_guard<std::mutex> lock(_on_demand_handlers_mutex);
+    _system_impl->unregister_all_mavlink_message_handlers(&_on_demand_handlers);
+    _on_demand_handlers.clear();
+}
+
+void PluginImplBase::update_on_demand_handler(uint16_t msg_id, OnDemandHandler& handler)
+{
+    const bool active = !_handlers_on_demand || handler.needed || handler.kept;
+    if (active == handler.registered) {
+        return;
+    }
+
+    if (active) {
+        _system_impl->register_mavlink_message_handler(
+            msg_id, handler.callback, &_on_demand_handlers);
+    } else {
+        _system_impl->unregister_mavlink_message_handler(msg_id, &_on_demand_handlers);
+    }
+    handler.registered = active;
+}
+
 } // namespace mavsdk
@@ -1,6 +1,12 @@
 #pragma once
+#include "memory_usage.h"
+#include "state_change.h"
 #include "system_impl.h"
+#include <cstdint>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <optional>
 
 namespace mavsdk {
 
@@ -54,12 +60,57 @@ public:
      */
     virtual void disable() = 0;
 
+    /*
+     * The method `memory_usage()` is called for Mavsdk::memory_usage().
+     *
+     * Plugins holding memory which grows, e.g. for caches, report it here
+     * under their name. By default, nothing is reported.
+     */
+    virtual std::optional<MemoryUsage::Plugin> memory_usage() { return std::nullopt; }
+
     // Non-copyable
     PluginImplBase(const PluginImplBase&) = delete;
     const PluginImplBase& operator=(const PluginImplBase&) = delete;
 
 protected:
+    /*
+     * Handlers registered on demand are only registered with the system while
+     * their message is needed, e.g. by a subscription, so messages nobody
+     * needs are not decoded. Until `set_handlers_on_demand(true)`, they are
+     * always registered, just like with `register_mavlink_message_handler()`.
+     *
+     * A message is needed while `set_handler_needed()` says so, or from the
+     * moment `keep_handler()` is called for it, e.g. because its value was
+     * polled.
+     */
+    void register_on_demand_handler(
+        uint16_t msg_id, const SystemImpl::MavlinkMessageHandler& callback);
+    void set_handler_needed(uint16_t msg_id, bool needed);
+    void keep_handler(uint16_t msg_id);
+    void set_handlers_on_demand(bool enabled);
+    // To be called in deinit().
+    void unregister_on_demand_handlers();
+
     std::shared_ptr<SystemImpl> _system_impl;
+
+    // For API calls which need to wait until the plugin is ready, e.g. until
+    // a param or the protocol version is known. Whatever changes that state
+    // calls `_state_change.notify()`. Mutable so that const getters can wait.
+    mutable StateChange _state_change{};
+
+private:
+    struct OnDemandHandler {
+        SystemImpl::MavlinkMessageHandler callback;
+        bool needed{false};
+        bool kept{false};
+        bool registered{false};
+    };
+
+    void update_on_demand_handler(uint16_t msg_id, OnDemandHandler& handler);
+
+    std::mutex _on_demand_handlers_mutex{};
+    std::map<uint16_t, OnDemandHandler> _on_demand_handlers{};
+    bool _handlers_on_demand{false};
 };
 
 } // namespace mavsdk
@@ -0,0 +1,455 @@
+#include "mavlink_address.h"
+#include "mavlink_mission_transfer.h"
+#include "mavlink_parameters.h"
+#include "mavsdk_time.h"
+#include "timeout_handler.h"
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <map>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+// How long transfers take over links of limited bandwidth and latency,
+// against a peer scripted to answer right away. Time is simulated with
+// FakeTime, so the results don't depend on the machine: the simulated
+// seconds are reported as the counter "simulated_s", and the iteration time
+// is what the protocol code itself costs.
+
+using namespace mavsdk;
+
+namespace {
+
+struct Link {
+    const char* name;
+    double bytes_per_s;
+    double latency_s;
+};
+
+// Indexed by the second benchmark argument.
+constexpr std::array<Link, 3> links{{
+    {"radio 57600 baud", 5760.0, 0.01},
+    {"radio 921600 baud", 92160.0, 0.005},
+    {"wifi", 1.0e6, 0.002},
+}};
+
+constexpr MAVLinkAddress gcs_address{245, MAV_COMP_ID_MISSIONPLANNER};
+constexpr MAVLinkAddress vehicle_address{1, MAV_COMP_ID_AUTOPILOT1};
+
+// Generous, nothing is lost on the link, and a transfer which times out is
+// reported as an error.
+constexpr double timeout_s = 5.0;
+
+// Both directions of a link, each one with the full bandwidth. Messages
+// take the bandwidth they need one after the other, then the latency.
+class SimulatedLink {
+public:
+    enum class Side { Gcs = 0, Vehicle = 1 };
+    using Receiver = std::function<void(const mavlink_message_t&)>;
+
+    SimulatedLink(FakeTime& time, const Link& link) : _time(time), _link(link) {}
+    ~SimulatedLink() = default;
+
+    // Non-copyable
+    SimulatedLink(const SimulatedLink&) = delete;
+    const SimulatedLink& operator=(const SimulatedLink&) = delete;
+
+    void set_receiver(Side side, Receiver receiver)
+    {
+        _receivers[index(side)] = std::move(receiver);
+    }
+
+    void transmit(Side from, const mavlink_message_t& message)
+    {
+        const auto len = static_cast<double>(MAVLINK_NUM_NON_PAYLOAD_BYTES + message.len);
+
+        auto& free_at = _free_at[index(from)];
+        free_at = std::max(_time.steady_time(), free_at) + to_duration(len / _link.bytes_per_s);
+        _in_flight.emplace(
+            std::make_pair(free_at + to_duration(_link.latency_s), _next_sequence++),
+            std::make_pair(from == Side::Gcs ? Side::Vehicle : Side::Gcs, message));
+    }
+
+    // Delivers messages and fires timeouts in the order they are due, until
+    // done is set. Returns the simulated seconds it took, or nothing if
+    // nothing was left to happen before done was set.
+    std::optional<double> run(
+        TimeoutHandler& timeout_handler, const std::function<void()>& do_work, const bool& done)
+    {
+        const auto start = _time.steady_time();
+
+        while (true) {
+            do_work();
+            timeout_handler.run_once();
+            if (done) {
+                return std::chrono::duration<double>(_time.steady_time() - start).count();
+            }
+
+            const auto next_timeout_s = timeout_handler.next_run_in_s();
+            if (_in_flight.empty() && !next_timeout_s) {
+                return std::nullopt;
+            }
+
+            const auto now = _time.steady_time();
+            if (!_in_flight.empty() &&
+                (!next_timeout_s ||
+                 _in_flight.begin()->first.first <= now + to_duration(next_timeout_s.value()))) {
+                auto it = _in_flight.begin();
+                sleep_until(it->first.first);
+                const auto [to, message] = it->second;
+                _in_flight.erase(it);
+                _receivers[index(to)](message);
+            } else {
+                sleep_until(now + to_duration(next_timeout_s.value()));
+            }
+        }
+    }
+
+private:
+    using TimePoint = SteadyTimePoint;
+
+    static size_t index(Side side) { return static_cast<size_t>(side); }
+
+    static std::chrono::steady_clock::duration to_duration(double seconds)
+    {
+        return std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double>(seconds));
+    }
+
+    void sleep_until(TimePoint time_point)
+    {
+        const auto now = _time.steady_time();
+        if (time_point > now) {
+            _time.sleep_for(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(time_point - now));
+        }
+    }
+
+    FakeTime& _time;
+    const Link _link;
+
+    std::array<TimePoint, 2> _free_at{};
+    std::array<Receiver, 2> _receivers{};
+    // By arrival time, and by order sent for the same time.
+    std::map<std::pair<TimePoint, uint64_t>, std::pair<Side, mavlink_message_t>> _in_flight{};
+    uint64_t _next_sequence{0};
+};
+
+// The ground station end, as seen by the protocol implementations.
+class GcsSender : public Sender {
+public:
+    explicit GcsSender(SimulatedLink& link) : _link(link) {}
+
+    bool send_message(mavlink_message_t& message) override
+    {
+        _link.transmit(SimulatedLink::Side::Gcs, message);
+        return true;
+    }
+    [[nodiscard]] uint8_t get_own_system_id() const override { return gcs_address.system_id; }
+    [[nodiscard]] uint8_t get_own_component_id() const override
+    {
+        return gcs_address.component_id;
+    }
+    [[nodiscard]] uint8_t get_system_id() const override { return vehicle_address.system_id; }
+    [[nodiscard]] Autopilot autopilot() const override { return Autopilot::Px4; }
+
+private:
+    SimulatedLink& _link;
+};
+
+MavlinkMissionTransfer::ItemInt make_item(uint16_t sequence)
+{
+    MavlinkMissionTransfer::ItemInt item{};
+    item.seq = sequence;
+    item.frame = MAV_FRAME_GLOBAL_RELATIVE_ALT_INT;
+    item.command = MAV_CMD_NAV_WAYPOINT;
+    item.current = uint8_t(sequence == 0 ? 1 : 0);
+    item.autocontinue = 1;
+    item.x = 473977418 + sequence;
+    item.y = 85455939;
+    item.z = 10.0f;
+    item.mission_type = MAV_MISSION_TYPE_MISSION;
+    return item;
+}
+
+// A vehicle which requests every item uploaded and sends every item
+// requested, without delay.
+class MissionPeer {
+public:
+    MissionPeer(SimulatedLink& link, uint16_t num_items) : _link(link), _num_items(num_items) {}
+
+    void process(const mavlink_message_t& message)
+    {
+        mavlink_message_t answer;
+        switch (message.msgid) {
+            case MAVLINK_MSG_ID_MISSION_COUNT:
+                _num_items = mavlink_msg_mission_count_get_count(&message);
+                pack_request(answer, 0);
+                break;
+            case MAVLINK_MSG_ID_MISSION_ITEM_INT: {
+                const auto seq = mavlink_msg_mission_item_int_get_seq(&message);
+                if (seq + 1 < _num_items) {
+                    pack_request(answer, static_cast<uint16_t>(seq + 1));
+                } else {
+                    mavlink_msg_mission_ack_pack(
+                        vehicle_address.system_id,
+                        vehicle_address.component_id,
+                        &answer,
+                        gcs_address.system_id,
+                        gcs_address.component_id,
+                        MAV_MISSION_ACCEPTED,
+                        MAV_MISSION_TYPE_MISSION);
+                }
+            } break;
+            case MAVLINK_MSG_ID_MISSION_REQUEST_LIST:
+                mavlink_msg_mission_count_pack(
+                    vehicle_address.system_id,
+                    vehicle_address.component_id,
+                    &answer,
+                    gcs_address.system_id,
+                    gcs_address.component_id,
+                    _num_items,
+                    MAV_MISSION_TYPE_MISSION);
+                break;
+            case MAVLINK_MSG_ID_MISSION_REQUEST_INT: {
+                const auto item = make_item(mavlink_msg_mission_request_int_get_seq(&message));
+                mavlink_msg_mission_item_int_pack(
+                    vehicle_address.system_id,
+                    vehicle_address.component_id,
+                    &answer,
+                    gcs_address.system_id,
+                    gcs_address.component_id,
+                    item.seq,
+                    item.frame,
+                    item.command,
+                    item.current,
+                    item.autocontinue,
+                    item.param1,
+                    item.param2,
+                    item.param3,
+                    item.param4,
+                    item.x,
+                    item.y,
+                    item.z,
+                    item.mission_type);
+            } break;
+            default:
+                // E.g. the ack at the end of a download.
+                return;
+        }
+        _link.transmit(SimulatedLink::Side::Vehicle, answer);
+    }
+
+private:
+    void pack_request(mavlink_message_t& answer, uint16_t seq)
+    {
+        mavlink_msg_mission_request_int_pack(
+            vehicle_address.system_id,
+            vehicle_address.component_id,
+            &answer,
+            gcs_address.system_id,
+            gcs_address.component_id,
+            seq,
+            MAV_MISSION_TYPE_MISSION);
+    }
+
+    SimulatedLink& _link;
+    uint16_t _num_items;
+};
+
+// A vehicle which sends all of its params at once when asked for the list.
+class ParamsPeer {
+public:
+    ParamsPeer(SimulatedLink& link, uint16_t num_params) : _link(link), _num_params(num_params)
+    {}
+
+    void process(const mavlink_message_t& message)
+    {
+        if (message.msgid != MAVLINK_MSG_ID_PARAM_REQUEST_LIST) {
+            return;
+        }
+
+        for (uint16_t i = 0; i < _num_params; ++i) {
+            char param_id[MAVLINK_MSG_PARAM_VALUE_FIELD_PARAM_ID_LEN + 1]{};
+            std::snprintf(param_id, sizeof(param_id), "BENCH_%05u", unsigned(i));
+
+            mavlink_message_t answer;
+            mavlink_msg_param_value_pack(
+                vehicle_address.system_id,
+                vehicle_address.component_id,
+                &answer,
+                param_id,
+                static_cast<float>(i),
+                MAV_PARAM_TYPE_REAL32,
+                _num_params,
+                i);
+            _link.transmit(SimulatedLink::Side::Vehicle, answer);
+        }
+    }
+
+private:
+    SimulatedLink& _link;
+    const uint16_t _num_params;
+};
+
+// Arguments: number of items or params, index into links.
+void transfer_arguments(benchmark::internal::Benchmark* benchmark)
+{
+    for (int num_items : {1000, 10000}) {
+        for (size_t link = 0; link < links.size(); ++link) {
+            benchmark->Args({num_items, static_cast<int64_t>(link)});
+        }
+    }
+}
+
+} // namespace
+
+static void BM_MissionUploadSimulatedLink(benchmark::State& state)
+{
+    const auto num_items = static_cast<uint16_t>(state.range(0));
+    const auto& link_config = links[static_cast<size_t>(state.range(1))];
+
+    std::vector<MavlinkMissionTransfer::ItemInt> items;
+    for (uint16_t i = 0; i < num_items; ++i) {
+        items.push_back(make_item(i));
+    }
+
+    double simulated_s = 0.0;
+    for (auto _ : state) {
+        FakeTime time;
+        TimeoutHandler timeout_handler(time);
+        MavlinkMessageHandler message_handler;
+        SimulatedLink link(time, link_config);
+        GcsSender sender(link);
+        MissionPeer peer(link, num_items);
+        MavlinkMissionTransfer mmt(
+            sender, message_handler, timeout_handler, []() { return timeout_s; });
+
+        link.set_receiver(SimulatedLink::Side::Vehicle, [&](const mavlink_message_t& message) {
+            peer.process(message);
+        });
+        link.set_receiver(SimulatedLink::Side::Gcs, [&](const mavlink_message_t& message) {
+            message_handler.process_message(message);
+        });
+
+        bool done = false;
+        MavlinkMissionTransfer::Result result{};
+        mmt.upload_items_async(
+            MAV_MISSION_TYPE_MISSION, items, [&](MavlinkMissionTransfer::Result mmt_result) {
+                result = mmt_result;
+                done = true;
+            });
+
+        const auto elapsed_s = link.run(timeout_handler, [&]() { mmt.do_work(); }, done);
+        if (!elapsed_s || result != MavlinkMissionTransfer::Result::Success) {
+            state.SkipWithError("Upload failed");
+            return;
+        }
+        simulated_s = elapsed_s.value();
+    }
+
+    state.SetLabel(link_config.name);
+    state.counters["simulated_s"] = simulated_s;
+    state.SetItemsProcessed(state.iterations() * num_items);
+}
+BENCHMARK(BM_MissionUploadSimulatedLink)->Apply(transfer_arguments);
+
+static void BM_MissionDownloadSimulatedLink(benchmark::State& state)
+{
+    const auto num_items = static_cast<uint16_t>(state.range(0));
+    const auto& link_config = links[static_cast<size_t>(state.range(1))];
+
+    double simulated_s = 0.0;
+    for (auto _ : state) {
+        FakeTime time;
+        TimeoutHandler timeout_handler(time);
+        MavlinkMessageHandler message_handler;
+        SimulatedLink link(time, link_config);
+        GcsSender sender(link);
+        MissionPeer peer(link, num_items);
+        MavlinkMissionTransfer mmt(
+            sender, message_handler, timeout_handler, []() { return timeout_s; });
+
+        link.set_receiver(SimulatedLink::Side::Vehicle, [&](const mavlink_message_t& message) {
+            peer.process(message);
+        });
+        link.set_receiver(SimulatedLink::Side::Gcs, [&](const mavlink_message_t& message) {
+            message_handler.process_message(message);
+        });
+
+        bool done = false;
+        MavlinkMissionTransfer::Result result{};
+        size_t num_downloaded = 0;
+        mmt.download_items_async(
+            MAV_MISSION_TYPE_MISSION,
+            [&](MavlinkMissionTransfer::Result mmt_result,
+                std::vector<MavlinkMissionTransfer::ItemInt> downloaded) {
+                result = mmt_result;
+                num_downloaded = downloaded.size();
+                done = true;
+            });
+
+        const auto elapsed_s = link.run(timeout_handler, [&]() { mmt.do_work(); }, done);
+        if (!elapsed_s || result != MavlinkMissionTransfer::Result::Success ||
+            num_downloaded != num_items) {
+            state.SkipWithError("Download failed");
+            return;
+        }
+        simulated_s = elapsed_s.value();
+    }
+
+    state.SetLabel(link_config.name);
+    state.counters["simulated_s"] = simulated_s;
+    state.SetItemsProcessed(state.iterations() * num_items);
+}
+BENCHMARK(BM_MissionDownloadSimulatedLink)->Apply(transfer_arguments);
+
+static void BM_GetAllParamsSimulatedLink(benchmark::State& state)
+{
+    const auto num_params = static_cast<uint16_t>(state.range(0));
+    const auto& link_config = links[static_cast<size_t>(state.range(1))];
+
+    double simulated_s = 0.0;
+    for (auto _ : state) {
+        FakeTime time;
+        TimeoutHandler timeout_handler(time);
+        MavlinkMessageHandler message_handler;
+        SimulatedLink link(time, link_config);
+        GcsSender sender(link);
+        ParamsPeer peer(link, num_params);
+        MAVLinkParameters parameters(
+            sender, message_handler, timeout_handler, []() { return timeout_s; }, false);
+
+        link.set_receiver(SimulatedLink::Side::Vehicle, [&](const mavlink_message_t& message) {
+            peer.process(message);
+        });
+        link.set_receiver(SimulatedLink::Side::Gcs, [&](const mavlink_message_t& message) {
+            message_handler.process_message(message);
+        });
+
+        bool done = false;
+        size_t num_received = 0;
+        parameters.get_all_params_async(
+            [&](std::map<std::string, MAVLinkParameters::ParamValue> params) {
+                num_received = params.size();
+                done = true;
+            });
+
+        const auto elapsed_s = link.run(timeout_handler, [&]() { parameters.do_work(); }, done);
+        if (!elapsed_s || num_received != num_params) {
+            state.SkipWithError("Getting all params failed");
+            return;
+        }
+        simulated_s = elapsed_s.value();
+    }
+
+    state.SetLabel(link_config.name);
+    state.counters["simulated_s"] = simulated_s;
+    state.SetItemsProcessed(state.iterations() * num_params);
+}
+BENCHMARK(BM_GetAllParamsSimulatedLink)->Apply(transfer_arguments);
@@ -0,0 +1,64 @@
+#include "receive_burst.h"
+
+#include <utility>
+
+namespace mavsdk {
+
+namespace {
+
+struct Collected {
+    const void* key;
+    ReceiveBurst::Handler handler;
+    std::vector<MavlinkMessageBuffer> messages;
+};
+
+struct BurstState {
+    unsigned depth{0};
+    // Usually there are only a few handlers, so a search is quickest.
+    std::vector<Collected> collected{};
+};
+
+thread_local BurstState burst_state{};
+
+} // namespace
+
+void ReceiveBurst::collect(
+    const void* key, const mavlink_message_t& message, const Handler& handler)
+{
+    if (burst_state.depth == 0) {
+        std::vector<MavlinkMessageBuffer> messages{MavlinkMessageBuffer::retain(message)};
+        handler(messages);
+        return;
+    }
+
+    for (auto& collected : burst_state.collected) {
+        if (collected.key == key) {
+            collected.messages.push_back(MavlinkMessageBuffer::retain(message));
+            return;
+        }
+    }
+
+    burst_state.collected.push_back(
+        Collected{key, handler, {MavlinkMessageBuffer::retain(message)}});
+}
+
+ReceiveBurst::Scope::Scope()
+{
+    ++burst_state.depth;
+}
+
+ReceiveBurst::Scope::~Scope()
+{
+    if (--burst_state.depth > 0) {
+        return;
+    }
+
+    // A handler can start a burst of its own, e.g. by receiving from a
+    // connection in-process, so we don't hold on to the state while calling.
+    auto collected = std::exchange(burst_state.collected, {});
+    for (auto& entry : collected) {
+        entry.handler(entry.messages);
+    }
+}
+
+} // namespace mavsdk
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <functional>
+#include <vector>
+#include "mavlink_message_buffer.h"
+#include "trace.h"
+
+namespace mavsdk {
+
+// Collects messages for handlers while a connection goes through what it
+// received in one read, e.g. all messages of a UDP datagram, so that they can
+// be handled in one go at the end of it instead of one by one.
+//
+// What is collected is kept per thread, so connections receiving on
+// different threads don't mix their bursts.
+class ReceiveBurst {
+public:
+    using Handler = std::function<void(std::vector<MavlinkMessageBuffer>& messages)>;
+
+    // Adds the message to what the handler of the key gets at the end of the
+    // current burst. Without a burst, the handler is called right away with
+    // just this message.
+    //
+    // The handler given with the first message of a burst is the one used.
+    static void collect(const void* key, const mavlink_message_t& message, const Handler& handler);
+
+    // Marks a burst on this thread for its lifetime. Scopes can be nested, the
+    // handlers are called when the outermost one ends.
+    class Scope {
+    public:
+        Scope();
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        // All of one read, including parsing it.
+        TraceScope _trace{"connection", "read"};
+    };
+};
+
+} // namespace mavsdk
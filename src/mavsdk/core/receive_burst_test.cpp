@@ -0,0 +1,118 @@
+#include "receive_burst.h"
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+using namespace mavsdk;
+
+TEST(ReceiveBurst, CallsRightAwayWithoutBurst)
+{
+    mavlink_message_t message{};
+    message.msgid = 1;
+
+    int num_calls = 0;
+    ReceiveBurst::collect(this, message, [&](std::vector<MavlinkMessageBuffer>& messages) {
+        ++num_calls;
+        ASSERT_EQ(messages.size(), 1u);
+        EXPECT_EQ(messages[0]->msgid, 1u);
+    });
+
+    EXPECT_EQ(num_calls, 1);
+}
+
+TEST(ReceiveBurst, CollectsUntilEndOfBurst)
+{
+    std::vector<uint32_t> received;
+    int num_calls = 0;
+    const auto handler = [&](std::vector<MavlinkMessageBuffer>& messages) {
+        ++num_calls;
+        for (const auto& message : messages) {
+            received.push_back(message->msgid);
+        }
+    };
+
+    {
+        ReceiveBurst::Scope receive_burst;
+        for (uint32_t msgid = 1; msgid <= 3; ++msgid) {
+            mavlink_message_t message{};
+            message.msgid = msgid;
+            ReceiveBurst::collect(this, message, handler);
+        }
+        EXPECT_EQ(num_calls, 0);
+    }
+
+    EXPECT_EQ(num_calls, 1);
+    EXPECT_EQ(received, (std::vector<uint32_t>{1, 2, 3}));
+}
+
+TEST(ReceiveBurst, KeepsKeysApart)
+{
+    int first_key = 0;
+    int second_key = 0;
+    size_t num_first = 0;
+    size_t num_second = 0;
+
+    {
+        ReceiveBurst::Scope receive_burst;
+        mavlink_message_t message{};
+        for (int i = 0; i < 3; ++i) {
+            ReceiveBurst::collect(&first_key, message, [&](auto& messages) {
+                num_first += messages.size();
+            });
+        }
+        ReceiveBurst::collect(&second_key, message, [&](auto& messages) {
+            num_second += messages.size();
+        });
+    }
+
+    EXPECT_EQ(num_first, 3u);
+    EXPECT_EQ(num_second, 1u);
+}
+
+TEST(ReceiveBurst, EndsWithOutermostScope)
+{
+    int num_calls = 0;
+    {
+        ReceiveBurst::Scope outer;
+        {
+            ReceiveBurst::Scope inner;
+            mavlink_message_t message{};
+            ReceiveBurst::collect(this, message, [&](auto&) { ++num_calls; });
+        }
+        EXPECT_EQ(num_calls, 0);
+    }
+    EXPECT_EQ(num_calls, 1);
+}
+
+TEST(ReceiveBurst, SharesDispatchedMessage)
+{
+    MavlinkMessagePool pool;
+    auto buffer = pool.acquire();
+    buffer.mutable_message().msgid = 42;
+
+    const mavlink_message_t* received = nullptr;
+    {
+        ReceiveBurst::Scope receive_burst;
+        MavlinkMessageBuffer::DispatchScope dispatch_scope(buffer);
+        ReceiveBurst::collect(this, *buffer, [&](std::vector<MavlinkMessageBuffer>& messages) {
+            received = &*messages[0];
+        });
+    }
+
+    EXPECT_EQ(received, &*buffer);
+}
+
+TEST(ReceiveBurst, KeepsThreadsApart)
+{
+    int num_calls = 0;
+    ReceiveBurst::Scope receive_burst;
+
+    // Another thread without a burst gets its message right away.
+    std::thread other([&]() {
+        mavlink_message_t message{};
+        ReceiveBurst::collect(this, message, [&](auto&) { ++num_calls; });
+    });
+    other.join();
+
+    EXPECT_EQ(num_calls, 1);
+}
@@ -2,6 +2,7 @@
 #include "log.h"
 #include "request_message.h"
 #include "system_impl.h"
+#include <algorithm>
 
 namespace mavsdk {
 
@@ -9,15 +10,22 @@ RequestMessage::RequestMessage(
     SystemImpl& system_impl,
     MavlinkCommandSender& command_sender,
     MavlinkMessageHandler& message_handler,
-    TimeoutHandler& timeout_handler) :
+    TimeoutHandler& timeout_handler,
+    ForwardingMemoryResource& memory_resource) :
     _system_impl(system_impl),
     _command_sender(command_sender),
     _message_handler(message_handler),
-    _timeout_handler(timeout_handler)
+    _timeout_handler(timeout_handler),
+    _work_items(memory_resource.allocator()),
+    _cached_messages(memory_resource.allocator())
 {}
 
 void RequestMessage::request(
-    uint32_t message_id, uint8_t target_component, RequestMessageCallback callback, uint32_t param2)
+    uint32_t message_id,
+    uint8_t target_component,
+    RequestMessageCallback callback,
+    uint32_t param2,
+    double max_age_s)
 {
     if (!callback) {
         LogWarn() << "Can't request message without callback";
@@ -31,17 +39,28 @@ void RequestMessage::request(
     }
     _deferred_message_cleanup.clear();
 
-    // Respond with 'Busy' if already in progress.
-    for (auto& item : _work_items) {
-        if (item.message_id == message_id && item.param2 == param2) {
-            lock.unlock();
-            callback(MavlinkCommandSender::Result::Busy, {});
-            return;
+    // Use what we received recently if that is good enough.
+    if (max_age_s > 0.0 && param2 == 0) {
+        for (const auto& cached : _cached_messages) {
+            if (cached.message.msgid == message_id && cached.message.compid == target_component &&
+                _system_impl.get_time().elapsed_since_s(cached.received) <= max_age_s) {
+                const auto message = cached.message;
+                lock.unlock();
+                callback(MavlinkCommandSender::Result::Success, message);
+                return;
+            }
         }
     }
 
+    // Wait for the same answer if already in progress.
+    auto it = find_work_item(message_id, target_component, param2);
+    if (it != _work_items.end()) {
+        it->callbacks.push_back(std::move(callback));
+        return;
+    }
+
     // Otherwise, schedule it.
-    _work_items.emplace_back(WorkItem{message_id, target_component, callback, param2});
+    _work_items.emplace_back(WorkItem{message_id, target_component, param2, {std::move(callback)}});
 
     // Register for message
     _message_handler.register_one(
@@ -50,20 +69,34 @@ void RequestMessage::request(
         this);
 
     // And send off command
-    send_request(message_id, target_component);
+    send_request(message_id, target_component, param2);
 }
 
-void RequestMessage::send_request(uint32_t message_id, uint8_t target_component)
+ResourceVector<RequestMessage::WorkItem>::iterator
+RequestMessage::find_work_item(uint32_t message_id, uint8_t target_component, uint32_t param2)
+{
+    return std::find_if(_work_items.begin(), _work_items.end(), [&](const WorkItem& item) {
+        return item.message_id == message_id && item.target_component == target_component &&
+               item.param2 == param2;
+    });
+}
+
+void RequestMessage::send_request(
+    uint32_t message_id, uint8_t target_component, uint32_t param2)
 {
     MavlinkCommandSender::CommandLong command_request_message{};
     command_request_message.command = MAV_CMD_REQUEST_MESSAGE;
     command_request_message.target_system_id = _system_impl.get_system_id();
     command_request_message.target_component_id = target_component;
     command_request_message.params.maybe_param1 = {static_cast<float>(message_id)};
+    if (param2 != 0) {
+        command_request_message.params.maybe_param2 = {static_cast<float>(param2)};
+    }
     _command_sender.queue_command_async(
-        command_request_message, [this, message_id](MavlinkCommandSender::Result result, float) {
+        command_request_message,
+        [this, message_id, target_component, param2](MavlinkCommandSender::Result result, float) {
             if (result != MavlinkCommandSender::Result::InProgress) {
-                handle_command_result(message_id, result);
+                handle_command_result(message_id, target_component, param2, result);
             }
         });
 }
@@ -75,44 +108,62 @@ void RequestMessage::handle_any_message(const mavlink_message_t& message)
     for (auto it = _work_items.begin(); it != _work_items.end(); ++it) {
         // Check if we're waiting for this message.
         // TODO: check if params are correct.
-        if (it->message_id != message.msgid) {
+        if (it->message_id != message.msgid ||
+            (it->target_component != MAV_COMP_ID_ALL && it->target_component != message.compid)) {
             continue;
         }
 
+        if (it->param2 == 0) {
+            auto cached = std::find_if(
+                _cached_messages.begin(),
+                _cached_messages.end(),
+                [&message](const CachedMessage& entry) {
+                    return entry.message.msgid == message.msgid &&
+                           entry.message.compid == message.compid;
+                });
+            if (cached == _cached_messages.end()) {
+                _cached_messages.push_back(
+                    CachedMessage{message, _system_impl.get_time().coarse_steady_time()});
+            } else {
+                *cached = CachedMessage{message, _system_impl.get_time().coarse_steady_time()};
+            }
+        }
+
         _timeout_handler.remove(it->timeout_cookie);
         // We have at least the message which is what we care about most, so we
         // tell the user about it and call it a day. If we receive the result
         // of the command later, we ignore it, and we fake the result to be successful
         // anyway.
-        auto temp_callback = it->callback;
+        auto temp_callbacks = std::move(it->callbacks);
         // We can now get rid of the entry now.
         _work_items.erase(it);
         // We have to clean up later outside this callback, otherwise we lock ourselves out.
         _deferred_message_cleanup.push_back(message.msgid);
         lock.unlock();
 
-        temp_callback(MavlinkCommandSender::Result::Success, message);
+        call_all(temp_callbacks, MavlinkCommandSender::Result::Success, message);
         return;
     }
 }
 
-void RequestMessage::handle_command_result(uint32_t message_id, MavlinkCommandSender::Result result)
+void RequestMessage::handle_command_result(
+    uint32_t message_id,
+    uint8_t target_component,
+    uint32_t param2,
+    MavlinkCommandSender::Result result)
 {
     std::unique_lock<std::mutex> lock(_mutex);
 
-    for (auto it = _work_items.begin(); it != _work_items.end(); ++it) {
-        // Check if we're waiting for this result
-        if (it->message_id != message_id) {
-            continue;
-        }
-
+    // Check if we're waiting for this result
+    auto it = find_work_item(message_id, target_component, param2);
+    if (it != _work_items.end()) {
         switch (result) {
             case MavlinkCommandSender::Result::Success:
                 // This is promising, let's hope the message will actually arrive.
                 // We'll set a timeout in case we need to retry.
                 _timeout_handler.add(
-                    [this, message_id, target_component = it->target_component]() {
-                        handle_timeout(message_id, target_component);
+                    [this, message_id, target_component, param2]() {
+                        handle_timeout(message_id, target_component, param2);
                     },
                     1.0,
                     &it->timeout_cookie);
@@ -139,11 +190,11 @@ void RequestMessage::handle_command_result(uint32_t message_id, MavlinkCommandSe
             case MavlinkCommandSender::Result::UnknownError: {
                 // It looks like this did not work, and we can report the error
                 // No need to try again.
-                auto temp_callback = it->callback;
+                auto temp_callbacks = std::move(it->callbacks);
                 _message_handler.unregister_one(it->message_id, this);
                 _work_items.erase(it);
                 lock.unlock();
-                temp_callback(result, {});
+                call_all(temp_callbacks, result, {});
                 return;
             }
 
@@ -154,29 +205,38 @@ void RequestMessage::handle_command_result(uint32_t message_id, MavlinkCommandSe
     }
 }
 
-void RequestMessage::handle_timeout(uint32_t message_id, uint8_t target_component)
+void RequestMessage::handle_timeout(
+    uint32_t message_id, uint8_t target_component, uint32_t param2)
 {
     std::unique_lock<std::mutex> lock(_mutex);
 
-    for (auto it = _work_items.begin(); it != _work_items.end(); ++it) {
-        // Check if we're waiting for this result
-        if (it->message_id != message_id) {
-            continue;
-        }
+    // Check if we're waiting for this result
+    auto it = find_work_item(message_id, target_component, param2);
+    if (it == _work_items.end()) {
+        return;
+    }
 
-        if (it->retries > 2) {
-            // We have already retried, let's give up.
-            auto temp_callback = it->callback;
-            _message_handler.unregister_one(it->message_id, this);
-            _work_items.erase(it);
-            lock.unlock();
-            temp_callback(MavlinkCommandSender::Result::Timeout, {});
-            return;
-        } else {
-            send_request(message_id, target_component);
-            LogWarn() << "Requesting message again (retries: " << it->retries << ")";
-            it->retries += 1;
-        }
+    if (it->retries > 2) {
+        // We have already retried, let's give up.
+        auto temp_callbacks = std::move(it->callbacks);
+        _message_handler.unregister_one(it->message_id, this);
+        _work_items.erase(it);
+        lock.unlock();
+        call_all(temp_callbacks, MavlinkCommandSender::Result::Timeout, {});
+    } else {
+        send_request(message_id, target_component, param2);
+        LogWarn() << "Requesting message again (retries: " << it->retries << ")";
+        it->retries += 1;
+    }
+}
+
+void RequestMessage::call_all(
+    const std::vector<RequestMessageCallback>& callbacks,
+    MavlinkCommandSender::Result result,
+    const mavlink_message_t& message)
+{
+    for (const auto& callback : callbacks) {
+        callback(result, message);
     }
 }
 
@@ -1,7 +1,9 @@
 #pragma once
 
+#include "forwarding_memory_resource.h"
 #include "mavlink_command_sender.h"
 #include "mavlink_message_handler.h"
+#include "mavsdk_time.h"
 #include "timeout_handler.h"
 #include "mavlink_include.h"
 #include <functional>
@@ -19,33 +21,54 @@ public:
         SystemImpl& system_impl,
         MavlinkCommandSender& command_sender,
         MavlinkMessageHandler& message_handler,
-        TimeoutHandler& timeout_handler);
+        TimeoutHandler& timeout_handler,
+        ForwardingMemoryResource& memory_resource);
     RequestMessage() = delete;
 
     using RequestMessageCallback =
         std::function<void(MavlinkCommandSender::Result, const mavlink_message_t&)>;
 
+    // Requests for the same message from the same component while one is in
+    // progress share it, and every callback gets the same answer.
+    //
+    // With max_age_s, a message received that recently for an earlier request
+    // is used instead of requesting it again.
     void request(
         uint32_t message_id,
         uint8_t target_component,
         RequestMessageCallback callback,
-        uint32_t param2 = 0);
+        uint32_t param2 = 0,
+        double max_age_s = 0.0);
 
 private:
     struct WorkItem {
         uint32_t message_id{0};
         uint8_t target_component{0};
-        RequestMessageCallback callback{};
         uint32_t param2{0};
+        std::vector<RequestMessageCallback> callbacks{};
         std::size_t retries{0};
         void* timeout_cookie{nullptr};
-        std::optional<MavlinkCommandSender::Result> maybe_result{};
     };
 
-    void send_request(uint32_t message_id, uint8_t target_component);
+    struct CachedMessage {
+        mavlink_message_t message;
+        SteadyTimePoint received;
+    };
+
+    ResourceVector<WorkItem>::iterator
+    find_work_item(uint32_t message_id, uint8_t target_component, uint32_t param2);
+    void send_request(uint32_t message_id, uint8_t target_component, uint32_t param2);
     void handle_any_message(const mavlink_message_t& message);
-    void handle_command_result(uint32_t message_id, MavlinkCommandSender::Result result);
-    void handle_timeout(uint32_t message_id, uint8_t target_component);
+    void handle_command_result(
+        uint32_t message_id,
+        uint8_t target_component,
+        uint32_t param2,
+        MavlinkCommandSender::Result result);
+    void handle_timeout(uint32_t message_id, uint8_t target_component, uint32_t param2);
+    static void call_all(
+        const std::vector<RequestMessageCallback>& callbacks,
+        MavlinkCommandSender::Result result,
+        const mavlink_message_t& message);
 
     SystemImpl& _system_impl;
     MavlinkCommandSender& _command_sender;
@@ -53,8 +76,10 @@ private:
     TimeoutHandler& _timeout_handler;
 
     std::mutex _mutex{};
-    std::vector<WorkItem> _work_items{};
+    ResourceVector<WorkItem> _work_items;
     std::vector<int> _deferred_message_cleanup{};
+    // Answers to requests without param2, at most one per message and component.
+    ResourceVector<CachedMessage> _cached_messages;
 };
 
 } // namespace mavsdk
@@ -9,8 +9,10 @@
 
 namespace mavsdk {
 
-template<typename T, std::size_t N> class RingbufferIterator;
-template<typename T, std::size_t N> class ConstRingbufferIterator;
+// The iterators work with any buffer which has operator[] with index 0 as
+// the oldest value, e.g. SpscRingbuffer as well.
+template<typename Buffer, typename T> class RingbufferIterator;
+template<typename Buffer, typename T> class ConstRingbufferIterator;
 
 template<typename T, std::size_t N> class Ringbuffer {
 public:
@@ -27,12 +29,13 @@ public:
         _storage[_index] = value;
     }
 
-    T& operator[](int index) { return _storage[(_index + index + 1) % N]; }
+    // Index 0 is the oldest value.
+    T& operator[](int index) { return _storage[storage_index(index)]; }
 
-    const T& operator[](int index) const { return _storage[(_index + index + 1) % N]; }
+    const T& operator[](int index) const { return _storage[storage_index(index)]; }
 
-    using iterator = RingbufferIterator<T, N>;
-    using const_iterator = ConstRingbufferIterator<T, N>;
+    using iterator = RingbufferIterator<Ringbuffer, T>;
+    using const_iterator = ConstRingbufferIterator<Ringbuffer, T>;
     iterator begin() { return iterator(*this, 0); }
     iterator end() { return iterator(*this, _size); }
     const_iterator begin() const { return const_iterator(*this, 0); }
@@ -43,14 +46,20 @@ public:
     std::size_t size() const { return _size; }
 
 private:
+    std::size_t storage_index(int index) const
+    {
+        // Until the buffer is full, the oldest value is not right after the newest.
+        return (_index + N - _size + 1 + static_cast<std::size_t>(index)) % N;
+    }
+
     std::array<T, N> _storage{};
     std::size_t _index{0};
     std::size_t _size{0};
 };
 
-template<typename T, std::size_t N> class RingbufferIterator {
+template<typename Buffer, typename T> class RingbufferIterator {
 public:
-    RingbufferIterator(Ringbuffer<T, N>& buf, std::size_t off) : _buf(buf), _off(off) {}
+    RingbufferIterator(Buffer& buf, std::size_t off) : _buf(buf), _off(off) {}
 
     bool operator==(const RingbufferIterator& i) { return &i._buf == &_buf && i._off == _off; }
     bool operator!=(const RingbufferIterator& i) { return !(*this == i); }
@@ -98,13 +107,13 @@ public:
     T& operator*() const { return _buf[_off]; }
 
 private:
-    Ringbuffer<T, N>& _buf;
+    Buffer& _buf;
     std::size_t _off;
 };
 
-template<typename T, std::size_t N> class ConstRingbufferIterator {
+template<typename Buffer, typename T> class ConstRingbufferIterator {
 public:
-    ConstRingbufferIterator(const Ringbuffer<T, N>& buf, std::size_t off) : _buf(buf), _off(off) {}
+    ConstRingbufferIterator(const Buffer& buf, std::size_t off) : _buf(buf), _off(off) {}
 
     bool operator==(const ConstRingbufferIterator& i) { return &i._buf == &_buf && i._off == _off; }
     bool operator!=(const ConstRingbufferIterator& i) { return !(*this == i); }
@@ -152,7 +161,7 @@ public:
     const T& operator*() const { return _buf[_off]; }
 
 private:
-    const Ringbuffer<T, N>& _buf;
+    const Buffer& _buf;
     std::size_t _off;
 };
 
@@ -82,3 +82,22 @@ TEST(Ringbuffer, PushAndMutate)
         EXPECT_EQ(buf, expected[i++]);
     }
 }
+
+TEST(Ringbuffer, PushPartiallyAndRead)
+{
+    auto buffer = Ringbuffer<int, 5>{};
+
+    buffer.push(4);
+    buffer.push(5);
+
+    ASSERT_EQ(buffer.size(), 2);
+    EXPECT_EQ(buffer[0], 4);
+    EXPECT_EQ(buffer[1], 5);
+
+    std::vector<int> expected{4, 5};
+    unsigned i = 0;
+    for (const auto& buf : buffer) {
+        EXPECT_EQ(buf, expected[i++]);
+    }
+    EXPECT_EQ(i, 2);
+}
@@ -0,0 +1,59 @@
+#include "rtt_estimator.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace mavsdk {
+
+void RttEstimator::add_sample(double rtt_s)
+{
+    // Anything this long is rather a slow reply than the link, and would
+    // only make the timeouts useless.
+    if (!std::isfinite(rtt_s) || rtt_s < 0.0 || rtt_s > MAX_TIMEOUT_S) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    if (!_has_samples) {
+        _srtt_s = rtt_s;
+        _rttvar_s = rtt_s / 2.0;
+        _has_samples = true;
+        return;
+    }
+
+    _rttvar_s = (1.0 - BETA) * _rttvar_s + BETA * std::abs(_srtt_s - rtt_s);
+    _srtt_s = (1.0 - ALPHA) * _srtt_s + ALPHA * rtt_s;
+}
+
+double RttEstimator::timeout_s(double fallback_s) const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    if (!_has_samples) {
+        return fallback_s;
+    }
+
+    return std::clamp(
+        _srtt_s + std::max(K * _rttvar_s, MIN_MARGIN_S), MIN_TIMEOUT_S, MAX_TIMEOUT_S);
+}
+
+std::optional<double> RttEstimator::smoothed_rtt_s() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    if (!_has_samples) {
+        return std::nullopt;
+    }
+    return _srtt_s;
+}
+
+void RttEstimator::reset()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _has_samples = false;
+    _srtt_s = 0.0;
+    _rttvar_s = 0.0;
+}
+
+} // namespace mavsdk
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <mutex>
+#include <optional>
+
+namespace mavsdk {
+
+// Estimates the round trip time to a system the way TCP does (RFC 6298),
+// from samples of the protocols talking to it, and gives a retransmission
+// timeout based on it, so the protocols don't have to use fixed timeouts
+// which are either too short for slow links or too long for fast ones.
+//
+// Samples must only be taken for requests that were not sent again, as an
+// answer can't be matched to one of several transmissions.
+//
+// Samples come in on the receive thread and the timeout is read from
+// others, so it is thread-safe.
+class RttEstimator {
+public:
+    static constexpr double MIN_TIMEOUT_S = 0.1;
+    static constexpr double MAX_TIMEOUT_S = 5.0;
+
+    RttEstimator() = default;
+    ~RttEstimator() = default;
+
+    // Non-copyable
+    RttEstimator(const RttEstimator&) = delete;
+    const RttEstimator& operator=(const RttEstimator&) = delete;
+
+    void add_sample(double rtt_s);
+
+    // The timeout to use, or the fallback as long as there are no samples.
+    [[nodiscard]] double timeout_s(double fallback_s) const;
+
+    [[nodiscard]] std::optional<double> smoothed_rtt_s() const;
+
+    void reset();
+
+private:
+    static constexpr double ALPHA = 1.0 / 8.0;
+    static constexpr double BETA = 1.0 / 4.0;
+    static constexpr double K = 4.0;
+    // Margin on top of the round trip time even on a link without jitter,
+    // about what the timeout handler resolves.
+    static constexpr double MIN_MARGIN_S = 0.02;
+
+    mutable std::mutex _mutex{};
+    bool _has_samples{false}; // Needs _mutex
+    double _srtt_s{0.0}; // Needs _mutex
+    double _rttvar_s{0.0}; // Needs _mutex
+};
+
+} // namespace mavsdk
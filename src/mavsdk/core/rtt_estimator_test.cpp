@@ -0,0 +1,70 @@
+#include "rtt_estimator.h"
+#include <gtest/gtest.h>
+
+using namespace mavsdk;
+
+TEST(RttEstimator, UsesFallbackWithoutSamples)
+{
+    RttEstimator estimator;
+    EXPECT_DOUBLE_EQ(estimator.timeout_s(0.5), 0.5);
+    EXPECT_FALSE(estimator.smoothed_rtt_s());
+}
+
+TEST(RttEstimator, StartsWithFirstSample)
+{
+    RttEstimator estimator;
+    estimator.add_sample(0.2);
+
+    ASSERT_TRUE(estimator.smoothed_rtt_s());
+    EXPECT_DOUBLE_EQ(estimator.smoothed_rtt_s().value(), 0.2);
+    // SRTT + 4 * SRTT / 2
+    EXPECT_DOUBLE_EQ(estimator.timeout_s(0.5), 0.6);
+}
+
+TEST(RttEstimator, SettlesOnSteadyLink)
+{
+    RttEstimator estimator;
+    for (int i = 0; i < 100; ++i) {
+        estimator.add_sample(0.3);
+    }
+
+    EXPECT_NEAR(estimator.smoothed_rtt_s().value(), 0.3, 1e-6);
+    // Still some margin.
+    EXPECT_NEAR(estimator.timeout_s(0.5), 0.32, 1e-3);
+}
+
+TEST(RttEstimator, AdaptsToSlowerLink)
+{
+    RttEstimator estimator;
+    for (int i = 0; i < 50; ++i) {
+        estimator.add_sample(0.02);
+    }
+    const double fast_timeout_s = estimator.timeout_s(0.5);
+
+    for (int i = 0; i < 50; ++i) {
+        estimator.add_sample(1.2);
+    }
+    EXPECT_GT(estimator.timeout_s(0.5), 1.2);
+    EXPECT_GT(estimator.timeout_s(0.5), fast_timeout_s);
+}
+
+TEST(RttEstimator, ClampsTimeout)
+{
+    RttEstimator estimator;
+    for (int i = 0; i < 100; ++i) {
+        estimator.add_sample(0.001);
+    }
+    EXPECT_DOUBLE_EQ(estimator.timeout_s(0.5), RttEstimator::MIN_TIMEOUT_S);
+
+    estimator.reset();
+    estimator.add_sample(4.0);
+    EXPECT_DOUBLE_EQ(estimator.timeout_s(0.5), RttEstimator::MAX_TIMEOUT_S);
+}
+
+TEST(RttEstimator, IgnoresImplausibleSamples)
+{
+    RttEstimator estimator;
+    estimator.add_sample(-1.0);
+    estimator.add_sample(RttEstimator::MAX_TIMEOUT_S + 1.0);
+    EXPECT_FALSE(estimator.smoothed_rtt_s());
+}
@@ -0,0 +1,74 @@
+#include "rtt_statistics.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace mavsdk {
+
+void RttStatistics::add_sample(double rtt_s)
+{
+    add(rtt_s);
+}
+
+void RttStatistics::add_lost()
+{
+    add(std::nullopt);
+}
+
+void RttStatistics::add(std::optional<double> outcome)
+{
+    _outcomes.push_back(outcome);
+    if (_outcomes.size() > window_size) {
+        _outcomes.pop_front();
+    }
+}
+
+RttStats RttStatistics::stats() const
+{
+    RttStats stats{};
+
+    std::vector<double> samples;
+    samples.reserve(_outcomes.size());
+
+    double sum_s = 0.0;
+    double sum_jitter_s = 0.0;
+    std::optional<double> previous{};
+    for (const auto& outcome : _outcomes) {
+        if (!outcome) {
+            ++stats.lost_count;
+            continue;
+        }
+        samples.push_back(outcome.value());
+        sum_s += outcome.value();
+        if (previous) {
+            sum_jitter_s += std::abs(outcome.value() - previous.value());
+        }
+        previous = outcome;
+    }
+
+    if (samples.empty()) {
+        return stats;
+    }
+
+    stats.sample_count = static_cast<uint32_t>(samples.size());
+    stats.mean_s = sum_s / static_cast<double>(samples.size());
+    if (samples.size() > 1) {
+        stats.jitter_s = sum_jitter_s / static_cast<double>(samples.size() - 1);
+    }
+
+    std::sort(samples.begin(), samples.end());
+    stats.min_s = samples.front();
+
+    // Nearest rank.
+    const auto percentile = [&samples](double p) {
+        const auto rank = static_cast<size_t>(std::ceil(p * static_cast<double>(samples.size())));
+        return samples[std::max<size_t>(rank, 1) - 1];
+    };
+    stats.p95_s = percentile(0.95);
+    stats.p99_s = percentile(0.99);
+
+    return stats;
+}
+
+} // namespace mavsdk
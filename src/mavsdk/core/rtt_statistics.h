@@ -0,0 +1,37 @@
+#pragma once
+
+#include "rtt_stats.h"
+#include <cstddef>
+#include <deque>
+#include <optional>
+
+namespace mavsdk {
+
+// Keeps the outcome of the recent pings, answered or lost, and summarizes
+// them as RttStats.
+//
+// Not thread-safe, the caller needs to lock.
+class RttStatistics {
+public:
+    static constexpr size_t window_size = 100;
+
+    RttStatistics() = default;
+    ~RttStatistics() = default;
+
+    // Non-copyable
+    RttStatistics(const RttStatistics&) = delete;
+    const RttStatistics& operator=(const RttStatistics&) = delete;
+
+    void add_sample(double rtt_s);
+    void add_lost();
+
+    [[nodiscard]] RttStats stats() const;
+
+private:
+    void add(std::optional<double> outcome);
+
+    // Round trip time, or nothing if lost, oldest first.
+    std::deque<std::optional<double>> _outcomes{};
+};
+
+} // namespace mavsdk
@@ -0,0 +1,65 @@
+#include "rtt_statistics.h"
+#include <gtest/gtest.h>
+
+using namespace mavsdk;
+
+TEST(RttStatistics, EmptyWithoutPings)
+{
+    RttStatistics statistics;
+    const auto stats = statistics.stats();
+    EXPECT_EQ(stats.sample_count, 0u);
+    EXPECT_EQ(stats.lost_count, 0u);
+    EXPECT_DOUBLE_EQ(stats.mean_s, 0.0);
+}
+
+TEST(RttStatistics, SummarizesSamples)
+{
+    RttStatistics statistics;
+    // 1 ms to 100 ms, shuffled a bit.
+    for (int i = 100; i >= 1; i -= 2) {
+        statistics.add_sample(static_cast<double>(i) * 1e-3);
+    }
+    for (int i = 1; i <= 100; i += 2) {
+        statistics.add_sample(static_cast<double>(i) * 1e-3);
+    }
+
+    const auto stats = statistics.stats();
+    EXPECT_EQ(stats.sample_count, 100u);
+    EXPECT_EQ(stats.lost_count, 0u);
+    EXPECT_DOUBLE_EQ(stats.min_s, 0.001);
+    EXPECT_NEAR(stats.mean_s, 0.0505, 1e-9);
+    EXPECT_DOUBLE_EQ(stats.p95_s, 0.095);
+    EXPECT_DOUBLE_EQ(stats.p99_s, 0.099);
+    // Steps of 2 ms, except for the one from 2 ms to 1 ms.
+    EXPECT_NEAR(stats.jitter_s, (98 * 0.002 + 0.001) / 99.0, 1e-9);
+}
+
+TEST(RttStatistics, CountsLost)
+{
+    RttStatistics statistics;
+    statistics.add_sample(0.01);
+    statistics.add_lost();
+    statistics.add_sample(0.03);
+
+    const auto stats = statistics.stats();
+    EXPECT_EQ(stats.sample_count, 2u);
+    EXPECT_EQ(stats.lost_count, 1u);
+    EXPECT_DOUBLE_EQ(stats.mean_s, 0.02);
+    // A lost ping doesn't count as a step.
+    EXPECT_DOUBLE_EQ(stats.jitter_s, 0.02);
+    EXPECT_DOUBLE_EQ(stats.p99_s, 0.03);
+}
+
+TEST(RttStatistics, OnlyKeepsWindow)
+{
+    RttStatistics statistics;
+    statistics.add_lost();
+    for (size_t i = 0; i < RttStatistics::window_size; ++i) {
+        statistics.add_sample(0.02);
+    }
+
+    const auto stats = statistics.stats();
+    EXPECT_EQ(stats.sample_count, RttStatistics::window_size);
+    EXPECT_EQ(stats.lost_count, 0u);
+    EXPECT_DOUBLE_EQ(stats.jitter_s, 0.0);
+}
@@ -0,0 +1,18 @@
+#include "safe_queue.h"
+#include <benchmark/benchmark.h>
+#include <functional>
+
+using namespace mavsdk;
+
+static void BM_SafeQueueEnqueueDequeue(benchmark::State& state)
+{
+    SafeQueue<std::function<void()>> queue;
+
+    for (auto _ : state) {
+        queue.enqueue([]() {});
+        benchmark::DoNotOptimize(queue.dequeue());
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SafeQueueEnqueueDequeue);
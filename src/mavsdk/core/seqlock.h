@@ -0,0 +1,112 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+
+namespace mavsdk {
+
+// Holds the latest value of a small, trivially copyable struct, e.g. a
+// telemetry sample, so that it can be read without taking a lock.
+//
+// Readers never block the writer: they copy the value and retry if it was
+// written meanwhile. Writers are serialized with a mutex, which is only
+// contended if several threads write the same value.
+//
+// The value is kept in atomic words, so that the copy of a concurrent
+// reader is not a data race, even if it has to be thrown away.
+
+template<typename T> class Seqlock {
+public:
+    Seqlock() : Seqlock(T{}) {}
+    explicit Seqlock(const T& value)
+    {
+        // Checked here rather than in the class, so that T can be a struct
+        // nested in the class holding the seqlock, which is only complete
+        // once that class is.
+        static_assert(std::is_trivially_copyable_v<T>, "Seqlock needs a trivially copyable type");
+        static_assert(
+            std::is_default_constructible_v<T>, "Seqlock needs a default constructible type");
+        write(value);
+    }
+    ~Seqlock() = default;
+
+    // Non-copyable
+    Seqlock(const Seqlock&) = delete;
+    const Seqlock& operator=(const Seqlock&) = delete;
+
+    void store(const T& value)
+    {
+        std::lock_guard<std::mutex> lock(_write_mutex);
+        write(value);
+    }
+
+    // Changes the value in place, e.g. to set a single field. Function must
+    // not access the seqlock itself.
+    template<typename Function> void update(Function&& function)
+    {
+        std::lock_guard<std::mutex> lock(_write_mutex);
+        T value = read();
+        function(value);
+        write(value);
+    }
+
+    T load() const { return read(); }
+
+private:
+    static constexpr std::size_t num_words = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    // Needs _write_mutex, or to be called from the constructor.
+    void write(const T& value)
+    {
+        std::array<uint64_t, num_words> words{};
+        std::memcpy(words.data(), &value, sizeof(T));
+
+        const auto sequence = _sequence.load(std::memory_order_relaxed);
+        // Odd while writing.
+        _sequence.store(sequence + 1, std::memory_order_relaxed);
+
+        // Release, so that a reader seeing any new word also sees the odd
+        // sequence afterwards. Plain stores on x86.
+        for (std::size_t i = 0; i < num_words; ++i) {
+            _words[i].store(words[i], std::memory_order_release);
+        }
+
+        _sequence.store(sequence + 2, std::memory_order_release);
+    }
+
+    T read() const
+    {
+        std::array<uint64_t, num_words> words{};
+        while (true) {
+            const auto before = _sequence.load(std::memory_order_acquire);
+            if (before % 2 != 0) {
+                // The writer only needs a few stores, no need to sleep.
+                std::this_thread::yield();
+                continue;
+            }
+
+            for (std::size_t i = 0; i < num_words; ++i) {
+                words[i] = _words[i].load(std::memory_order_acquire);
+            }
+
+            if (_sequence.load(std::memory_order_relaxed) == before) {
+                break;
+            }
+        }
+
+        T value;
+        std::memcpy(static_cast<void*>(&value), words.data(), sizeof(T));
+        return value;
+    }
+
+    std::mutex _write_mutex{};
+    std::atomic<uint64_t> _sequence{0};
+    std::array<std::atomic<uint64_t>, num_words> _words{};
+};
+
+} // namespace mavsdk
@@ -0,0 +1,82 @@
+#include "seqlock.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+
+using namespace mavsdk;
+
+namespace {
+
+struct Sample {
+    double first{1.0};
+    float second{2.0f};
+    uint8_t third{3};
+    uint64_t timestamp_us{0};
+};
+
+} // namespace
+
+TEST(Seqlock, StoreAndLoad)
+{
+    Seqlock<Sample> seqlock{};
+    EXPECT_EQ(seqlock.load().first, 1.0);
+    EXPECT_EQ(seqlock.load().second, 2.0f);
+    EXPECT_EQ(seqlock.load().third, 3);
+
+    Sample sample{};
+    sample.first = 42.0;
+    sample.timestamp_us = 1234;
+    seqlock.store(sample);
+
+    EXPECT_EQ(seqlock.load().first, 42.0);
+    EXPECT_EQ(seqlock.load().timestamp_us, 1234);
+}
+
+TEST(Seqlock, Update)
+{
+    Seqlock<Sample> seqlock{};
+    seqlock.update([](Sample& sample) { sample.third = 7; });
+
+    const auto sample = seqlock.load();
+    EXPECT_EQ(sample.first, 1.0);
+    EXPECT_EQ(sample.third, 7);
+}
+
+TEST(Seqlock, ReadersNeverSeeTornValues)
+{
+    Seqlock<Sample> seqlock{};
+    std::atomic<bool> done{false};
+    std::atomic<unsigned> torn{0};
+
+    std::vector<std::thread> readers;
+    for (unsigned i = 0; i < 3; ++i) {
+        readers.emplace_back([&]() {
+            while (!done) {
+                const auto sample = seqlock.load();
+                // All fields are written together from the same counter.
+                if (sample.timestamp_us != 0 &&
+                    (sample.first != static_cast<double>(sample.timestamp_us) ||
+                     sample.third != static_cast<uint8_t>(sample.timestamp_us))) {
+                    ++torn;
+                }
+            }
+        });
+    }
+
+    for (uint64_t i = 1; i <= 200000; ++i) {
+        Sample sample{};
+        sample.first = static_cast<double>(i);
+        sample.third = static_cast<uint8_t>(i);
+        sample.timestamp_us = i;
+        seqlock.store(sample);
+    }
+    done = true;
+
+    for (auto& reader : readers) {
+        reader.join();
+    }
+    EXPECT_EQ(torn, 0);
+    EXPECT_EQ(seqlock.load().timestamp_us, 200000);
+}
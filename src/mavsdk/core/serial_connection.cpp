@@ -1,5 +1,8 @@
 #include "serial_connection.h"
+#include "io_reactor.h"
 #include "log.h"
+#include "receive_burst.h"
+#include "thread_config.h"
 
 #if defined(APPLE) || defined(LINUX)
 #include <unistd.h>
@@ -10,6 +13,11 @@
 #include <utility>
 #endif
 
+#if defined(LINUX)
+#include <linux/serial.h>
+#include <sys/ioctl.h>
+#endif
+
 namespace mavsdk {
 
 #ifndef WINDOWS
@@ -65,15 +73,23 @@ SerialConnection::~SerialConnection()
 
 ConnectionResult SerialConnection::start()
 {
-    if (!start_mavlink_receiver()) {
-        return ConnectionResult::ConnectionsExhausted;
-    }
+    start_mavlink_receiver();
 
     ConnectionResult ret = setup_port();
     if (ret != ConnectionResult::Success) {
         return ret;
     }
 
+    start_send_thread();
+    start_send_scheduler();
+
+#if defined(LINUX) || defined(APPLE)
+    if (_io_reactor != nullptr && _io_reactor->add(_fd, [this]() { read_available(); })) {
+        _uses_io_reactor = true;
+        return ConnectionResult::Success;
+    }
+#endif
+
     start_recv_thread();
 
     return ConnectionResult::Success;
@@ -131,8 +147,10 @@ ConnectionResult SerialConnection::setup_port()
     tc.c_cflag &= ~(CSIZE | PARENB | CRTSCTS);
     tc.c_cflag |= CS8;
 
-    tc.c_cc[VMIN] = 0; // We are ok with 0 bytes.
-    tc.c_cc[VTIME] = 10; // Timeout after 1 second.
+    // We only read after poll says there is something, and then want
+    // whatever is there right away, without waiting for more.
+    tc.c_cc[VMIN] = 0;
+    tc.c_cc[VTIME] = 0;
 
     if (_flow_control) {
         tc.c_cflag |= CRTSCTS;
@@ -171,6 +189,10 @@ ConnectionResult SerialConnection::setup_port()
     }
 #endif
 
+#if defined(LINUX)
+    set_low_latency();
+#endif
+
 #if defined(WINDOWS)
     DCB dcb;
     SecureZeroMemory(&dcb, sizeof(DCB));
@@ -222,14 +244,55 @@ ConnectionResult SerialConnection::setup_port()
     return ConnectionResult::Success;
 }
 
+#if defined(LINUX)
+void SerialConnection::set_low_latency()
+{
+    // Without this, e.g. FTDI adapters hold received bytes back for up to
+    // 16 ms. Not all drivers support it, which is fine.
+    struct serial_struct serial {};
+    if (ioctl(_fd, TIOCGSERIAL, &serial) != 0) {
+        LogDebug() << "Low latency mode not supported: " << GET_ERROR();
+        return;
+    }
+
+    serial.flags |= ASYNC_LOW_LATENCY;
+    if (ioctl(_fd, TIOCSSERIAL, &serial) != 0) {
+        LogDebug() << "Could not set low latency mode: " << GET_ERROR();
+    }
+}
+#endif
+
 void SerialConnection::start_recv_thread()
 {
     _recv_thread = std::make_unique<std::thread>(&SerialConnection::receive, this);
 }
 
+void SerialConnection::start_send_thread()
+{
+    _send_thread = std::make_unique<std::thread>(&SerialConnection::send_thread, this);
+}
+
 ConnectionResult SerialConnection::stop()
 {
-    _should_exit = true;
+    stop_send_scheduler();
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _should_exit = true;
+    }
+    _send_cv.notify_all();
+
+    if (_send_thread) {
+        _send_thread->join();
+        _send_thread.reset();
+    }
+
+#if defined(LINUX) || defined(APPLE)
+    if (_uses_io_reactor) {
+        _io_reactor->remove(_fd);
+        _uses_io_reactor = false;
+    }
+#endif
 
     if (_recv_thread) {
         _recv_thread->join();
@@ -250,6 +313,20 @@ ConnectionResult SerialConnection::stop()
 }
 
 bool SerialConnection::send_message(const mavlink_message_t& message)
+{
+    uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
+    const uint16_t buffer_len = mavlink_msg_to_send_buffer(buffer, &message);
+
+    return send_frames(buffer, buffer_len);
+}
+
+size_t SerialConnection::memory_usage()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return Connection::memory_usage() + _send_buffer.capacity();
+}
+
+bool SerialConnection::send_frames(const uint8_t* data, size_t len)
 {
     if (_serial_node.empty()) {
         LogErr() << "Dev Path unknown";
@@ -261,31 +338,77 @@ bool SerialConnection::send_message(const mavlink_message_t& message)
         return false;
     }
 
-    uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
-    uint16_t buffer_len = mavlink_msg_to_send_buffer(buffer, &message);
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
 
-    int send_len;
-#if defined(LINUX) || defined(APPLE)
-    send_len = static_cast<int>(write(_fd, buffer, buffer_len));
-#else
-    if (!WriteFile(_handle, buffer, buffer_len, LPDWORD(&send_len), NULL)) {
-        LogErr() << "WriteFile failure: " << GET_ERROR();
-        return false;
-    }
-#endif
+        if (_send_buffer.size() + len > MAX_SEND_BUFFER_LEN) {
+            // Only complain once until the device has caught up again.
+            if (!_send_buffer_overflown) {
+                LogWarn() << "Serial send buffer full, dropping messages";
+                _send_buffer_overflown = true;
+            }
+            return false;
+        }
 
-    if (send_len != buffer_len) {
-        LogErr() << "write failure: " << GET_ERROR();
-        return false;
+        _send_buffer.insert(_send_buffer.end(), data, data + len);
     }
+    _send_cv.notify_one();
 
     return true;
 }
 
+void SerialConnection::send_thread()
+{
+    ThreadConfig::apply(ThreadRole::Send);
+
+    std::vector<uint8_t> pending;
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _send_cv.wait(lock, [this]() { return _should_exit || !_send_buffer.empty(); });
+            if (_should_exit) {
+                return;
+            }
+            std::swap(pending, _send_buffer);
+            _send_buffer_overflown = false;
+        }
+
+        write_all(pending.data(), pending.size());
+        pending.clear();
+    }
+}
+
+void SerialConnection::write_all(const uint8_t* data, size_t len)
+{
+    size_t written = 0;
+    while (written < len && !_should_exit) {
+#if defined(LINUX) || defined(APPLE)
+        const auto write_len = write(_fd, data + written, len - written);
+        if (write_len < 0) {
+            if (errno == EINTR || errno == EAGAIN) {
+                continue;
+            }
+            LogErr() << "write failure: " << GET_ERROR();
+            return;
+        }
+#else
+        DWORD write_len = 0;
+        if (!WriteFile(_handle, data + written, DWORD(len - written), &write_len, NULL)) {
+            LogErr() << "WriteFile failure: " << GET_ERROR();
+            return;
+        }
+#endif
+        written += static_cast<size_t>(write_len);
+    }
+}
+
 void SerialConnection::receive()
 {
-    // Enough for MTU 1500 bytes.
-    char buffer[2048];
+    ThreadConfig::apply(ThreadRole::Receive);
+
+    // Enough for a few ms at high baudrates, so we keep up in one read.
+    char buffer[8192];
 
 #if defined(LINUX) || defined(APPLE)
     struct pollfd fds[1];
@@ -316,7 +439,8 @@ void SerialConnection::receive()
         if (recv_len > static_cast<int>(sizeof(buffer)) || recv_len == 0) {
             continue;
         }
-        _mavlink_receiver->set_new_datagram(buffer, recv_len);
+        _mavlink_receiver->set_new_datagram(buffer, recv_len, receive_time_now_ns());
+        ReceiveBurst::Scope receive_burst;
         // Parse all mavlink messages in one data packet. Once exhausted, we'll exit while.
         while (_mavlink_receiver->parse_message()) {
             receive_message(_mavlink_receiver->get_last_message(), this);
@@ -324,6 +448,31 @@ void SerialConnection::receive()
     }
 }
 
+#if defined(LINUX) || defined(APPLE)
+void SerialConnection::read_available()
+{
+    // Enough for a few ms at high baudrates, so we keep up in one read.
+    char buffer[8192];
+
+    // We only get called when there is something to read, so this won't block.
+    const int recv_len = static_cast<int>(read(_fd, buffer, sizeof(buffer)));
+    if (recv_len < 0) {
+        LogErr() << "read failure: " << GET_ERROR();
+        return;
+    }
+    if (recv_len == 0) {
+        return;
+    }
+
+    _mavlink_receiver->set_new_datagram(buffer, recv_len, receive_time_now_ns());
+    ReceiveBurst::Scope receive_burst;
+    // Parse all mavlink messages in one data packet. Once exhausted, we'll exit while.
+    while (_mavlink_receiver->parse_message()) {
+        receive_message(_mavlink_receiver->get_last_message(), this);
+    }
+}
+#endif
+
 #if defined(LINUX)
 int SerialConnection::define_from_baudrate(int baudrate)
 {
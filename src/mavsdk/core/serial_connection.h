@@ -1,9 +1,11 @@
 #pragma once
 
+#include <condition_variable>
 #include <mutex>
 #include <memory>
 #include <atomic>
 #include <thread>
+#include <vector>
 #include "connection.h"
 
 #if defined(WINDOWS)
@@ -25,6 +27,8 @@ public:
     ~SerialConnection() override;
 
     bool send_message(const mavlink_message_t& message) override;
+    bool send_frames(const uint8_t* data, size_t len) override;
+    size_t memory_usage() override;
 
     // Non-copyable
     SerialConnection(const SerialConnection&) = delete;
@@ -34,16 +38,32 @@ private:
     ConnectionResult setup_port();
     void start_recv_thread();
     void receive();
+    void start_send_thread();
+    void send_thread();
+    void write_all(const uint8_t* data, size_t len);
+
+#if defined(LINUX) || defined(APPLE)
+    void read_available();
+#endif
 
 #if defined(LINUX)
     static int define_from_baudrate(int baudrate);
+    void set_low_latency();
 #endif
 
     const std::string _serial_node;
     const int _baudrate;
     const bool _flow_control;
 
+    // Frames are written by the send thread, so callers never block on the
+    // device. Everything queued is written at once.
+    static constexpr size_t MAX_SEND_BUFFER_LEN = 64 * 1024;
     std::mutex _mutex = {};
+    std::condition_variable _send_cv{};
+    std::vector<uint8_t> _send_buffer{}; // Needs _mutex
+    bool _send_buffer_overflown{false}; // Needs _mutex
+    std::unique_ptr<std::thread> _send_thread{};
+
 #if !defined(WINDOWS)
     int _fd = -1;
 #else
@@ -51,6 +71,7 @@ private:
 #endif
 
     std::unique_ptr<std::thread> _recv_thread{};
+    bool _uses_io_reactor{false};
     std::atomic_bool _should_exit{false};
 };
 
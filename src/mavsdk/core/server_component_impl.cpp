@@ -1,6 +1,8 @@
 #include "server_component_impl.h"
 #include "server_plugin_impl_base.h"
 #include "mavsdk_impl.h"
+#include "thread_config.h"
+#include <algorithm>
 
 namespace mavsdk {
 
@@ -22,6 +24,11 @@ ServerComponentImpl::ServerComponentImpl(MavsdkImpl& mavsdk_impl, uint8_t compon
         true),
     _mavlink_request_message_handler(mavsdk_impl, *this, _mavlink_command_receiver)
 {
+    _user_callback_executor = _mavsdk_impl.new_user_callback_executor();
+
+    _mavlink_parameters.set_work_notifier([this]() { notify_work_thread(); });
+    _mission_transfer.set_work_notifier([this]() { notify_work_thread(); });
+
     register_mavlink_command_handler(
         MAV_CMD_REQUEST_AUTOPILOT_CAPABILITIES,
         [this](const MavlinkCommandReceiver::CommandLong& command) {
@@ -45,10 +52,20 @@ ServerComponentImpl::ServerComponentImpl(MavsdkImpl& mavsdk_impl, uint8_t compon
             return MAV_RESULT_ACCEPTED;
         },
         this);
+
+    _work_thread = new std::thread(&ServerComponentImpl::work_thread, this);
 }
 
 ServerComponentImpl::~ServerComponentImpl()
 {
+    _should_exit = true;
+    notify_work_thread();
+    if (_work_thread != nullptr) {
+        _work_thread->join();
+        delete _work_thread;
+        _work_thread = nullptr;
+    }
+
     unregister_all_mavlink_command_handlers(this);
     _mavlink_request_message_handler.unregister_all_handlers(this);
 }
@@ -113,10 +130,73 @@ void ServerComponentImpl::unregister_all_mavlink_message_handlers(const void* co
     _mavsdk_impl.mavlink_message_handler.unregister_all(cookie);
 }
 
-void ServerComponentImpl::do_work()
+void ServerComponentImpl::queue_work(std::function<void()> work, const void* cookie)
+{
+    {
+        std::lock_guard<std::mutex> lock(_queued_work_mutex);
+        _queued_work.push_back(QueuedWork{std::move(work), cookie});
+    }
+    notify_work_thread();
+}
+
+void ServerComponentImpl::remove_queued_work(const void* cookie)
+{
+    std::lock_guard<std::mutex> running_lock(_running_work_mutex);
+    std::lock_guard<std::mutex> lock(_queued_work_mutex);
+    _queued_work.erase(
+        std::remove_if(
+            _queued_work.begin(),
+            _queued_work.end(),
+            [cookie](const QueuedWork& queued) { return queued.cookie == cookie; }),
+        _queued_work.end());
+}
+
+void ServerComponentImpl::work_thread()
+{
+    ThreadConfig::apply(ThreadRole::Work);
+
+    while (!_should_exit) {
+        {
+            std::lock_guard<std::mutex> running_lock(_running_work_mutex);
+            std::vector<QueuedWork> queued_work;
+            {
+                // Work may queue more work, which then runs next time.
+                std::lock_guard<std::mutex> lock(_queued_work_mutex);
+                queued_work.swap(_queued_work);
+            }
+            for (auto& queued : queued_work) {
+                queued.work();
+            }
+        }
+
+        _mavlink_parameters.do_work();
+        _mission_transfer.do_work();
+
+        // Instead of polling, we sleep until work is queued, or until work
+        // in progress needs to continue.
+        double wait_s = IDLE_WORK_INTERVAL_S;
+        if (!_mission_transfer.is_idle()) {
+            wait_s = std::min(wait_s, MISSION_TRANSFER_CHECK_INTERVAL_S);
+        }
+        if (_mavlink_parameters.is_streaming_list()) {
+            wait_s = std::min(wait_s, PARAM_LIST_STREAM_INTERVAL_S);
+        }
+
+        std::unique_lock<std::mutex> lock(_work_thread_mutex);
+        _work_thread_cv.wait_for(lock, std::chrono::duration<double>(wait_s), [this]() {
+            return _work_thread_work_pending || _should_exit;
+        });
+        _work_thread_work_pending = false;
+    }
+}
+
+void ServerComponentImpl::notify_work_thread()
 {
-    _mavlink_parameters.do_work();
-    _mission_transfer.do_work();
+    {
+        std::lock_guard<std::mutex> lock(_work_thread_mutex);
+        _work_thread_work_pending = true;
+    }
+    _work_thread_cv.notify_one();
 }
 
 uint8_t ServerComponentImpl::get_own_system_id() const
@@ -138,11 +218,21 @@ Time& ServerComponentImpl::get_time()
     return _mavsdk_impl.time;
 }
 
+FtpMemoryFiles& ServerComponentImpl::ftp_memory_files()
+{
+    return _mavsdk_impl.ftp_memory_files;
+}
+
 bool ServerComponentImpl::send_message(mavlink_message_t& message)
 {
     return _mavsdk_impl.send_message(message);
 }
 
+bool ServerComponentImpl::send_messages(std::vector<mavlink_message_t>& messages)
+{
+    return _mavsdk_impl.send_messages(messages);
+}
+
 void ServerComponentImpl::add_call_every(
     std::function<void()> callback, float interval_s, void** cookie)
 {
@@ -252,9 +342,14 @@ uint32_t ServerComponentImpl::get_custom_mode() const
 }
 
 void ServerComponentImpl::call_user_callback_located(
-    const std::string& filename, const int linenumber, const std::function<void()>& func)
-{
-    _mavsdk_impl.call_user_callback_located(filename, linenumber, func);
+    const char* filename,
+    const int linenumber,
+    std::function<void()> func,
+    const void* coalesce_key,
+    CallbackLane lane)
+{
+    _mavsdk_impl.call_user_callback_located(
+        filename, linenumber, std::move(func), coalesce_key, _user_callback_executor, lane);
 }
 
 void ServerComponentImpl::register_timeout_handler(
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "callback_queue.h"
 #include "mavlink_include.h"
 #include "mavlink_command_receiver.h"
 #include "mavlink_mission_transfer.h"
@@ -7,11 +8,16 @@
 #include "mavlink_request_message_handler.h"
 #include "mavsdk_time.h"
 #include "flight_mode.h"
+#include "ftp_memory_files.h"
 #include "log.h"
 
 #include <atomic>
+#include <condition_variable>
+#include <functional>
 #include <mutex>
 #include <cstdint>
+#include <thread>
+#include <vector>
 
 namespace mavsdk {
 
@@ -98,7 +104,11 @@ public:
 
     Time& get_time();
 
+    // Files to serve to clients over MAVLink FTP, straight from memory.
+    FtpMemoryFiles& ftp_memory_files();
+
     bool send_message(mavlink_message_t& message);
+    bool send_messages(std::vector<mavlink_message_t>& messages);
 
     void add_call_every(std::function<void()> callback, float interval_s, void** cookie);
     void change_call_every(float interval_s, const void* cookie);
@@ -120,7 +130,11 @@ public:
     [[nodiscard]] uint32_t get_custom_mode() const;
 
     void call_user_callback_located(
-        const std::string& filename, const int linenumber, const std::function<void()>& func);
+        const char* filename,
+        int linenumber,
+        std::function<void()> func,
+        const void* coalesce_key = nullptr,
+        CallbackLane lane = CallbackLane::Events);
 
     // Autopilot version data
     void add_capabilities(uint64_t capabilities);
@@ -140,10 +154,20 @@ public:
         return _mavlink_request_message_handler;
     }
 
-    void do_work();
+    // Runs the work on the work thread of this component as soon as
+    // possible, e.g. for what can't be done from within a message handler.
+    void queue_work(std::function<void()> work, const void* cookie);
+    // Once this returns, none of the work queued with this cookie runs anymore.
+    void remove_queued_work(const void* cookie);
 
 private:
+    // Each server component does its work on its own thread, so a slow one
+    // does not hold up the others.
+    void work_thread();
+    void notify_work_thread();
+
     MavsdkImpl& _mavsdk_impl;
+    unsigned _user_callback_executor{0};
     uint8_t _own_component_id{MAV_COMP_ID_AUTOPILOT1};
 
     std::atomic<MAV_STATE> _system_status{MAV_STATE_UNINIT};
@@ -158,6 +182,26 @@ private:
     MavlinkMissionTransfer _mission_transfer;
     MAVLinkParameters _mavlink_parameters;
     MavlinkRequestMessageHandler _mavlink_request_message_handler;
+
+    struct QueuedWork {
+        std::function<void()> work;
+        const void* cookie;
+    };
+    std::mutex _queued_work_mutex{};
+    std::vector<QueuedWork> _queued_work{}; // Needs _queued_work_mutex
+    // Held while queued work runs, so it can't be removed in the meantime.
+    std::mutex _running_work_mutex{};
+
+    std::thread* _work_thread{nullptr};
+    std::atomic<bool> _should_exit{false};
+    std::mutex _work_thread_mutex{};
+    std::condition_variable _work_thread_cv{};
+    bool _work_thread_work_pending{false};
+
+    static constexpr double MISSION_TRANSFER_CHECK_INTERVAL_S = 0.01;
+    static constexpr double PARAM_LIST_STREAM_INTERVAL_S = 0.01;
+    // Nothing is due, we only wake up to be sure.
+    static constexpr double IDLE_WORK_INTERVAL_S = 0.5;
 };
 
 } // namespace mavsdk
@@ -0,0 +1,160 @@
+#include "setpoint_streamer.h"
+#include "log.h"
+#include "thread_config.h"
+
+#include <algorithm>
+
+#if defined(LINUX) || defined(APPLE)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace mavsdk {
+
+SetpointStreamer::SetpointStreamer()
+{
+    // The rate the setpoints were always sent with.
+    (void)set_rate_hz(20.0);
+    _thread = std::make_unique<std::thread>(&SetpointStreamer::run, this);
+}
+
+SetpointStreamer::~SetpointStreamer()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _should_exit = true;
+    }
+    _cv.notify_all();
+    _thread->join();
+}
+
+void SetpointStreamer::start(Task task)
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _task = std::make_shared<const Task>(std::move(task));
+        _next_call = std::chrono::steady_clock::now() + _period;
+        _rescheduled = true;
+    }
+    _cv.notify_all();
+}
+
+void SetpointStreamer::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _task.reset();
+        _rescheduled = true;
+    }
+    _cv.notify_all();
+}
+
+void SetpointStreamer::restart_period()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _next_call = std::chrono::steady_clock::now() + _period;
+        _rescheduled = true;
+    }
+    _cv.notify_all();
+}
+
+bool SetpointStreamer::set_rate_hz(double rate_hz)
+{
+    if (!(rate_hz > 0.0 && rate_hz <= max_rate_hz)) {
+        LogErr() << "Invalid setpoint rate: " << rate_hz << " Hz";
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        const auto period = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double>(1.0 / rate_hz));
+        _next_call += period - _period;
+        _period = period;
+        _rescheduled = true;
+
+        // Jitter at the old rate doesn't say much about the new one.
+        _statistics = {};
+        _total_jitter_us = 0.0;
+    }
+    _cv.notify_all();
+    return true;
+}
+
+double SetpointStreamer::rate_hz() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return 1.0 / std::chrono::duration<double>(_period).count();
+}
+
+bool SetpointStreamer::set_realtime_priority(bool enabled)
+{
+#if defined(LINUX) || defined(APPLE)
+    sched_param param{};
+    const int policy = enabled ? SCHED_FIFO : SCHED_OTHER;
+    // Just above normal real-time threads, not above the kernel's own.
+    param.sched_priority = enabled ? sched_get_priority_min(SCHED_FIFO) + 1 : 0;
+
+    const int result = pthread_setschedparam(_thread->native_handle(), policy, &param);
+    if (result != 0) {
+        LogWarn() << "Could not change setpoint thread priority (error " << result << ")";
+        return false;
+    }
+    return true;
+#else
+    if (enabled) {
+        LogWarn() << "Real-time priority not supported on this platform";
+    }
+    return !enabled;
+#endif
+}
+
+SetpointStreamer::Statistics SetpointStreamer::statistics() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _statistics;
+}
+
+void SetpointStreamer::run()
+{
+    ThreadConfig::apply(ThreadRole::Setpoints);
+
+    std::unique_lock<std::mutex> lock(_mutex);
+
+    while (!_should_exit) {
+        if (_task == nullptr) {
+            _cv.wait(lock, [this]() { return _should_exit || _task != nullptr; });
+            continue;
+        }
+
+        _rescheduled = false;
+        const auto next_call = _next_call;
+        if (_cv.wait_until(lock, next_call, [this]() { return _should_exit || _rescheduled; })) {
+            // Woken up early, the schedule or the task changed.
+            continue;
+        }
+
+        const auto now = std::chrono::steady_clock::now();
+        const double jitter_us = std::chrono::duration<double, std::micro>(now - next_call).count();
+        ++_statistics.num_calls;
+        _total_jitter_us += jitter_us;
+        _statistics.mean_jitter_us = _total_jitter_us / static_cast<double>(_statistics.num_calls);
+        _statistics.max_jitter_us = std::max(_statistics.max_jitter_us, jitter_us);
+
+        // Keep the schedule, but skip calls that were missed completely.
+        _next_call += _period;
+        if (_next_call <= now) {
+            _next_call = now + _period;
+        }
+
+        // Not called under the lock, so that the task can stop or restart
+        // the streamer, and stop() never has to wait for the task.
+        const auto task = _task;
+        lock.unlock();
+        (*task)();
+        lock.lock();
+    }
+}
+
+} // namespace mavsdk
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace mavsdk {
+
+// Calls a task, e.g. sending the latest setpoint, at a steady rate on its own
+// thread.
+//
+// Unlike add_call_every, which is polled on the system thread every 10 ms,
+// the thread sleeps until the exact time of the next call, and the calls are
+// scheduled at absolute times, so that they don't drift. If a call is late,
+// e.g. because the task was slow, the following ones stay on the original
+// schedule, and calls that were missed entirely are skipped rather than
+// made up for in a burst.
+//
+// How late each call is, is tracked as jitter.
+class SetpointStreamer {
+public:
+    using Task = std::function<void()>;
+
+    struct Statistics {
+        uint64_t num_calls{0};
+        double mean_jitter_us{0.0};
+        double max_jitter_us{0.0};
+    };
+
+    SetpointStreamer();
+    ~SetpointStreamer();
+
+    // Non-copyable
+    SetpointStreamer(const SetpointStreamer&) = delete;
+    const SetpointStreamer& operator=(const SetpointStreamer&) = delete;
+
+    // Replaces the current task, the first call is one period from now.
+    void start(Task task);
+
+    // A call that is already running is not waited for, so this can be
+    // called while holding a lock the task needs.
+    void stop();
+
+    // Moves the next call to one period from now, e.g. because the task was
+    // just run directly.
+    void restart_period();
+
+    [[nodiscard]] bool set_rate_hz(double rate_hz);
+    [[nodiscard]] double rate_hz() const;
+
+    // Asks the OS to schedule the thread with real-time priority. This needs
+    // privileges which are usually missing, in which case false is returned.
+    [[nodiscard]] bool set_realtime_priority(bool enabled);
+
+    [[nodiscard]] Statistics statistics() const;
+
+    static constexpr double max_rate_hz = 1000.0;
+
+private:
+    void run();
+
+    mutable std::mutex _mutex{};
+    std::condition_variable _cv{};
+    // Needs _mutex
+    std::shared_ptr<const Task> _task{};
+    std::chrono::steady_clock::duration _period{};
+    std::chrono::steady_clock::time_point _next_call{};
+    bool _rescheduled{false};
+    bool _should_exit{false};
+    Statistics _statistics{};
+    double _total_jitter_us{0.0};
+
+    std::unique_ptr<std::thread> _thread{};
+};
+
+} // namespace mavsdk
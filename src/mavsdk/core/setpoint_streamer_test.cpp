@@ -0,0 +1,85 @@
+#include "setpoint_streamer.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <gtest/gtest.h>
+
+using namespace mavsdk;
+
+TEST(SetpointStreamer, CallsAtRate)
+{
+    SetpointStreamer streamer;
+    ASSERT_TRUE(streamer.set_rate_hz(200.0));
+    EXPECT_DOUBLE_EQ(streamer.rate_hz(), 200.0);
+
+    std::atomic<unsigned> num_calls{0};
+    streamer.start([&]() { ++num_calls; });
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    streamer.stop();
+
+    // 60 calls, a bit of slack for slow machines.
+    EXPECT_GE(num_calls, 30);
+    EXPECT_LE(num_calls, 61);
+
+    const auto statistics = streamer.statistics();
+    EXPECT_EQ(statistics.num_calls, num_calls);
+    EXPECT_GE(statistics.mean_jitter_us, 0.0);
+    EXPECT_GE(statistics.max_jitter_us, statistics.mean_jitter_us);
+}
+
+TEST(SetpointStreamer, NoCallsAfterStop)
+{
+    SetpointStreamer streamer;
+    ASSERT_TRUE(streamer.set_rate_hz(500.0));
+
+    std::atomic<unsigned> num_calls{0};
+    streamer.start([&]() { ++num_calls; });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    streamer.stop();
+
+    // A call might still have been running.
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    const unsigned num_calls_stopped = num_calls;
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_EQ(num_calls, num_calls_stopped);
+}
+
+TEST(SetpointStreamer, RestartPeriodPostponesCall)
+{
+    SetpointStreamer streamer;
+    ASSERT_TRUE(streamer.set_rate_hz(10.0));
+
+    std::atomic<unsigned> num_calls{0};
+    streamer.start([&]() { ++num_calls; });
+
+    // Keep postponing, so the call never happens.
+    for (unsigned i = 0; i < 10; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(30));
+        streamer.restart_period();
+    }
+    EXPECT_EQ(num_calls, 0);
+}
+
+TEST(SetpointStreamer, TaskCanStopStreamer)
+{
+    SetpointStreamer streamer;
+    ASSERT_TRUE(streamer.set_rate_hz(500.0));
+
+    std::atomic<unsigned> num_calls{0};
+    streamer.start([&]() {
+        ++num_calls;
+        streamer.stop();
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_EQ(num_calls, 1);
+}
+
+TEST(SetpointStreamer, RejectsInvalidRates)
+{
+    SetpointStreamer streamer;
+    EXPECT_FALSE(streamer.set_rate_hz(0.0));
+    EXPECT_FALSE(streamer.set_rate_hz(-1.0));
+    EXPECT_FALSE(streamer.set_rate_hz(SetpointStreamer::max_rate_hz * 2.0));
+    EXPECT_DOUBLE_EQ(streamer.rate_hz(), 20.0);
+}
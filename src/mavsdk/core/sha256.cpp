@@ -0,0 +1,315 @@
+#include "sha256.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+// The hardware implementations follow the public domain code by Jeffrey
+// Walton, see https://github.com/noloader/SHA-Intrinsics.
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define MAVSDK_SHA256_X86
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define MAVSDK_SHA256_TARGET
+#else
+#include <cpuid.h>
+#define MAVSDK_SHA256_TARGET __attribute__((target("sha,sse4.1")))
+#endif
+#elif defined(__aarch64__) && (defined(__ARM_FEATURE_SHA2) || defined(__ARM_FEATURE_CRYPTO))
+// Only if the compiler may use the crypto extensions, e.g. with
+// -march=armv8-a+crypto, which is always the case on Apple silicon.
+#define MAVSDK_SHA256_ARM
+#include <arm_neon.h>
+#endif
+
+namespace mavsdk {
+
+namespace {
+
+alignas(16) constexpr uint32_t K[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4,
+    0xab1c5ed5, 0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe,
+    0x9bdc06a7, 0xc19bf174, 0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f,
+    0x4a7484aa, 0x5cb0a9dc, 0x76f988da, 0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7,
+    0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967, 0x27b70a85, 0x2e1b2138, 0x4d2c6dfc,
+    0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85, 0xa2bfe8a1, 0xa81a664b,
+    0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070, 0x19a4c116,
+    0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7,
+    0xc67178f2};
+
+using CompressFunction = void (*)(uint32_t* state, const uint8_t* blocks, size_t num_blocks);
+
+inline uint32_t rotr(uint32_t x, unsigned n)
+{
+    return (x >> n) | (x << (32 - n));
+}
+
+void compress_portable(uint32_t* state, const uint8_t* blocks, size_t num_blocks)
+{
+    for (; num_blocks > 0; --num_blocks, blocks += 64) {
+        uint32_t w[64];
+        for (unsigned i = 0; i < 16; ++i) {
+            w[i] = (uint32_t(blocks[i * 4]) << 24) | (uint32_t(blocks[i * 4 + 1]) << 16) |
+                   (uint32_t(blocks[i * 4 + 2]) << 8) | uint32_t(blocks[i * 4 + 3]);
+        }
+        for (unsigned i = 16; i < 64; ++i) {
+            const uint32_t s0 = rotr(w[i - 15], 7) ^ rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+            const uint32_t s1 = rotr(w[i - 2], 17) ^ rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+            w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+        }
+
+        uint32_t a = state[0];
+        uint32_t b = state[1];
+        uint32_t c = state[2];
+        uint32_t d = state[3];
+        uint32_t e = state[4];
+        uint32_t f = state[5];
+        uint32_t g = state[6];
+        uint32_t h = state[7];
+
+        for (unsigned i = 0; i < 64; ++i) {
+            const uint32_t s1 = rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25);
+            const uint32_t ch = (e & f) ^ (~e & g);
+            const uint32_t temp1 = h + s1 + ch + K[i] + w[i];
+            const uint32_t s0 = rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22);
+            const uint32_t maj = (a & b) ^ (a & c) ^ (b & c);
+            const uint32_t temp2 = s0 + maj;
+
+            h = g;
+            g = f;
+            f = e;
+            e = d + temp1;
+            d = c;
+            c = b;
+            b = a;
+            a = temp1 + temp2;
+        }
+
+        state[0] += a;
+        state[1] += b;
+        state[2] += c;
+        state[3] += d;
+        state[4] += e;
+        state[5] += f;
+        state[6] += g;
+        state[7] += h;
+    }
+}
+
+#if defined(MAVSDK_SHA256_X86)
+MAVSDK_SHA256_TARGET
+void compress_x86(uint32_t* state, const uint8_t* blocks, size_t num_blocks)
+{
+    const __m128i byte_swap = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+
+    // The instructions work on the state ordered as ABEF and CDGH.
+    __m128i tmp = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&state[0]));
+    __m128i state1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&state[4]));
+    tmp = _mm_shuffle_epi32(tmp, 0xB1);
+    state1 = _mm_shuffle_epi32(state1, 0x1B);
+    __m128i state0 = _mm_alignr_epi8(tmp, state1, 8);
+    state1 = _mm_blend_epi16(state1, tmp, 0xF0);
+
+    for (; num_blocks > 0; --num_blocks, blocks += 64) {
+        const __m128i abef_save = state0;
+        const __m128i cdgh_save = state1;
+
+        // Each iteration does 4 rounds, the message schedule is calculated
+        // along the way.
+        __m128i msgs[4];
+        for (unsigned i = 0; i < 16; ++i) {
+            if (i < 4) {
+                msgs[i] = _mm_shuffle_epi8(
+                    _mm_loadu_si128(reinterpret_cast<const __m128i*>(&blocks[i * 16])),
+                    byte_swap);
+            }
+            __m128i msg = _mm_add_epi32(
+                msgs[i % 4], _mm_load_si128(reinterpret_cast<const __m128i*>(&K[i * 4])));
+            state1 = _mm_sha256rnds2_epu32(state1, state0, msg);
+            if (i >= 3 && i < 15) {
+                auto& next = msgs[(i + 1) % 4];
+                next = _mm_add_epi32(next, _mm_alignr_epi8(msgs[i % 4], msgs[(i + 3) % 4], 4));
+                next = _mm_sha256msg2_epu32(next, msgs[i % 4]);
+            }
+            msg = _mm_shuffle_epi32(msg, 0x0E);
+            state0 = _mm_sha256rnds2_epu32(state0, state1, msg);
+            if (i >= 1 && i < 13) {
+                auto& previous = msgs[(i + 3) % 4];
+                previous = _mm_sha256msg1_epu32(previous, msgs[i % 4]);
+            }
+        }
+
+        state0 = _mm_add_epi32(state0, abef_save);
+        state1 = _mm_add_epi32(state1, cdgh_save);
+    }
+
+    tmp = _mm_shuffle_epi32(state0, 0x1B);
+    state1 = _mm_shuffle_epi32(state1, 0xB1);
+    state0 = _mm_blend_epi16(tmp, state1, 0xF0);
+    state1 = _mm_alignr_epi8(state1, tmp, 8);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&state[0]), state0);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&state[4]), state1);
+}
+
+bool cpu_supports_sha()
+{
+    // SHA is in CPUID leaf 7, EBX bit 29, SSE4.1 in leaf 1, ECX bit 19.
+#if defined(_MSC_VER)
+    int regs[4];
+    __cpuid(regs, 0);
+    if (regs[0] < 7) {
+        return false;
+    }
+    __cpuid(regs, 1);
+    const bool has_sse41 = (regs[2] & (1 << 19)) != 0;
+    __cpuidex(regs, 7, 0);
+    const bool has_sha = (regs[1] & (1 << 29)) != 0;
+#else
+    unsigned eax, ebx, ecx, edx;
+    if (__get_cpuid(1, &eax, &ebx, &ecx, &edx) == 0) {
+        return false;
+    }
+    const bool has_sse41 = (ecx & (1u << 19)) != 0;
+    if (__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx) == 0) {
+        return false;
+    }
+    const bool has_sha = (ebx & (1u << 29)) != 0;
+#endif
+    return has_sse41 && has_sha;
+}
+
+CompressFunction hardware_compress_function()
+{
+    return cpu_supports_sha() ? compress_x86 : nullptr;
+}
+
+#elif defined(MAVSDK_SHA256_ARM)
+void compress_arm(uint32_t* state, const uint8_t* blocks, size_t num_blocks)
+{
+    uint32x4_t state0 = vld1q_u32(&state[0]);
+    uint32x4_t state1 = vld1q_u32(&state[4]);
+
+    for (; num_blocks > 0; --num_blocks, blocks += 64) {
+        const uint32x4_t abcd_save = state0;
+        const uint32x4_t efgh_save = state1;
+
+        uint32x4_t msgs[4];
+        for (unsigned i = 0; i < 4; ++i) {
+            msgs[i] = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(&blocks[i * 16])));
+        }
+
+        // Each iteration does 4 rounds, and replaces the message words used
+        // by the ones needed 4 iterations later.
+        for (unsigned i = 0; i < 16; ++i) {
+            const uint32x4_t msg = vaddq_u32(msgs[i % 4], vld1q_u32(&K[i * 4]));
+            if (i < 12) {
+                msgs[i % 4] = vsha256su1q_u32(
+                    vsha256su0q_u32(msgs[i % 4], msgs[(i + 1) % 4]),
+                    msgs[(i + 2) % 4],
+                    msgs[(i + 3) % 4]);
+            }
+            const uint32x4_t abcd = state0;
+            state0 = vsha256hq_u32(state0, state1, msg);
+            state1 = vsha256h2q_u32(state1, abcd, msg);
+        }
+
+        state0 = vaddq_u32(state0, abcd_save);
+        state1 = vaddq_u32(state1, efgh_save);
+    }
+
+    vst1q_u32(&state[0], state0);
+    vst1q_u32(&state[4], state1);
+}
+
+CompressFunction hardware_compress_function()
+{
+    return compress_arm;
+}
+
+#else
+CompressFunction hardware_compress_function()
+{
+    return nullptr;
+}
+#endif
+
+// Detected once, the hardware can still be turned off for testing.
+const CompressFunction hardware_compress = hardware_compress_function();
+std::atomic<bool> hardware_enabled{true};
+
+CompressFunction compress_function()
+{
+    if (hardware_compress != nullptr && hardware_enabled.load(std::memory_order_relaxed)) {
+        return hardware_compress;
+    }
+    return compress_portable;
+}
+
+} // namespace
+
+void Sha256::add(const uint8_t* src, size_t len)
+{
+    const CompressFunction compress = compress_function();
+    _total_len += len;
+
+    if (_block_len > 0) {
+        const size_t missing = std::min(_block.size() - _block_len, len);
+        memcpy(&_block[_block_len], src, missing);
+        _block_len += missing;
+        src += missing;
+        len -= missing;
+        if (_block_len < _block.size()) {
+            return;
+        }
+        compress(_state.data(), _block.data(), 1);
+        _block_len = 0;
+    }
+
+    // Full blocks are hashed straight from the source.
+    const size_t num_blocks = len / 64;
+    if (num_blocks > 0) {
+        compress(_state.data(), src, num_blocks);
+        src += num_blocks * 64;
+        len -= num_blocks * 64;
+    }
+
+    memcpy(_block.data(), src, len);
+    _block_len = len;
+}
+
+Sha256::Digest Sha256::finish()
+{
+    const uint64_t total_bits = _total_len * 8;
+
+    // Pad with 0x80 and zeros, so the length fits at the end of the block.
+    uint8_t padding[64 + 8] = {0x80};
+    const size_t padding_len = (_block_len < 56) ? (56 - _block_len) : (120 - _block_len);
+    for (unsigned i = 0; i < 8; ++i) {
+        padding[padding_len + i] = static_cast<uint8_t>(total_bits >> (56 - i * 8));
+    }
+    add(padding, padding_len + 8);
+
+    Digest digest;
+    for (unsigned i = 0; i < 8; ++i) {
+        digest[i * 4] = static_cast<uint8_t>(_state[i] >> 24);
+        digest[i * 4 + 1] = static_cast<uint8_t>(_state[i] >> 16);
+        digest[i * 4 + 2] = static_cast<uint8_t>(_state[i] >> 8);
+        digest[i * 4 + 3] = static_cast<uint8_t>(_state[i]);
+    }
+    return digest;
+}
+
+bool Sha256::uses_hardware()
+{
+    return compress_function() != compress_portable;
+}
+
+void Sha256::set_hardware_enabled(bool enabled)
+{
+    hardware_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+} // namespace mavsdk
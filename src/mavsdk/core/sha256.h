@@ -0,0 +1,44 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace mavsdk {
+
+// SHA-256 as used for MAVLink 2 message signing.
+//
+// The blocks are hashed using the SHA extensions of x86 CPUs, or the ARMv8
+// crypto extensions, if available. Otherwise a portable implementation is
+// used.
+
+class Sha256 {
+public:
+    using Digest = std::array<uint8_t, 32>;
+
+    void add(const uint8_t* src, size_t len);
+
+    // Only call this once, after everything was added.
+    Digest finish();
+
+    // For testing and benchmarking, to make sure the hardware and portable
+    // implementations are equal.
+    static bool uses_hardware();
+    static void set_hardware_enabled(bool enabled);
+
+private:
+    std::array<uint32_t, 8> _state{
+        0x6a09e667,
+        0xbb67ae85,
+        0x3c6ef372,
+        0xa54ff53a,
+        0x510e527f,
+        0x9b05688c,
+        0x1f83d9ab,
+        0x5be0cd19};
+    std::array<uint8_t, 64> _block{};
+    size_t _block_len{0};
+    uint64_t _total_len{0};
+};
+
+} // namespace mavsdk
@@ -0,0 +1,23 @@
+#include "sha256.h"
+#include <benchmark/benchmark.h>
+#include <vector>
+
+using namespace mavsdk;
+
+// The size of a signed frame with the largest payload, plus the key.
+static void BM_Sha256SignedFrame(benchmark::State& state)
+{
+    Sha256::set_hardware_enabled(state.range(0) != 0);
+    std::vector<uint8_t> data(32 + 10 + 255 + 2 + 7, 0x42);
+
+    for (auto _ : state) {
+        Sha256 sha256;
+        sha256.add(data.data(), data.size());
+        benchmark::DoNotOptimize(sha256.finish());
+    }
+
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(data.size()));
+    state.SetLabel(Sha256::uses_hardware() ? "hardware" : "portable");
+    Sha256::set_hardware_enabled(true);
+}
+BENCHMARK(BM_Sha256SignedFrame)->Arg(0)->Arg(1);
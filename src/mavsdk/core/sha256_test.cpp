@@ -0,0 +1,65 @@
+#include "sha256.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace mavsdk;
+
+static std::string to_hex(const Sha256::Digest& digest)
+{
+    std::string hex;
+    for (const auto byte : digest) {
+        char buf[3];
+        snprintf(buf, sizeof(buf), "%02x", byte);
+        hex += buf;
+    }
+    return hex;
+}
+
+static std::string hash_of(const std::string& text)
+{
+    Sha256 sha256;
+    sha256.add(reinterpret_cast<const uint8_t*>(text.data()), text.size());
+    return to_hex(sha256.finish());
+}
+
+TEST(Sha256, KnownDigests)
+{
+    EXPECT_EQ(hash_of(""), "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+    EXPECT_EQ(hash_of("abc"), "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+    EXPECT_EQ(
+        hash_of("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq"),
+        "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1");
+    EXPECT_EQ(
+        hash_of(std::string(1000, 'a')),
+        "41edece42d63e8d9bf515a9ba6932e1c20cbc9f5a5d134645adb5db1b9737ea3");
+}
+
+TEST(Sha256, HardwareAndPortableAgree)
+{
+    std::vector<uint8_t> data(1000);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<uint8_t>(i * 7 + 3);
+    }
+
+    auto hash_in_pieces = [&](size_t len, size_t piece_len) {
+        Sha256 sha256;
+        for (size_t offset = 0; offset < len; offset += piece_len) {
+            sha256.add(&data[offset], std::min(piece_len, len - offset));
+        }
+        return sha256.finish();
+    };
+
+    for (size_t len = 0; len < data.size(); len += 37) {
+        const auto digest = hash_in_pieces(len, len + 1);
+
+        Sha256::set_hardware_enabled(false);
+        EXPECT_FALSE(Sha256::uses_hardware());
+        EXPECT_EQ(hash_in_pieces(len, 13), digest) << "len " << len;
+        Sha256::set_hardware_enabled(true);
+
+        EXPECT_EQ(hash_in_pieces(len, 64), digest) << "len " << len;
+    }
+}
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include "ringbuffer.h"
+
+namespace mavsdk {
+
+// Like Ringbuffer, but for handing values from one thread to another: one
+// producer thread pushes, one consumer thread reads and pops, and neither
+// ever waits for the other.
+//
+// Unlike Ringbuffer, a push doesn't overwrite the oldest value when full,
+// since the consumer might be reading it, it fails instead. The values the
+// consumer sees stay where they are until it pops them, so it can iterate
+// over them while the producer pushes more.
+//
+// The indices are on cache lines of their own, so the two threads don't
+// keep invalidating each other's, and each side caches the index of the
+// other side, which it only loads again if that seems to be in the way.
+template<typename T, std::size_t N> class SpscRingbuffer {
+public:
+    static_assert(N > 0, "SpscRingbuffer needs room for at least one value");
+
+    SpscRingbuffer() = default;
+    ~SpscRingbuffer() = default;
+
+    // Non-copyable
+    SpscRingbuffer(const SpscRingbuffer&) = delete;
+    const SpscRingbuffer& operator=(const SpscRingbuffer&) = delete;
+
+    // Producer only. Returns false if full.
+    bool push(const T& value)
+    {
+        const auto head = _head.load(std::memory_order_relaxed);
+        if (head - _cached_tail == N) {
+            _cached_tail = _tail.load(std::memory_order_acquire);
+            if (head - _cached_tail == N) {
+                return false;
+            }
+        }
+
+        _storage[head % N] = value;
+        _head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer only. Returns false if empty.
+    bool pop(T& value)
+    {
+        const auto tail = _tail.load(std::memory_order_relaxed);
+        if (tail == _cached_head) {
+            _cached_head = _head.load(std::memory_order_acquire);
+            if (tail == _cached_head) {
+                return false;
+            }
+        }
+
+        value = std::move(_storage[tail % N]);
+        _tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer only, pops the oldest count values at once, e.g. after
+    // iterating over them.
+    void pop_front(std::size_t count)
+    {
+        const auto tail = _tail.load(std::memory_order_relaxed);
+        _tail.store(tail + std::min(count, size()), std::memory_order_release);
+    }
+
+    // The rest is for the consumer only as well.
+
+    // Index 0 is the oldest value, valid below what size() returned before.
+    T& operator[](int index)
+    {
+        return _storage[(_tail.load(std::memory_order_relaxed) + index) % N];
+    }
+
+    const T& operator[](int index) const
+    {
+        return _storage[(_tail.load(std::memory_order_relaxed) + index) % N];
+    }
+
+    using iterator = RingbufferIterator<SpscRingbuffer, T>;
+    using const_iterator = ConstRingbufferIterator<SpscRingbuffer, T>;
+    // What was pushed after end() was taken is not iterated over.
+    iterator begin() { return iterator(*this, 0); }
+    iterator end() { return iterator(*this, size()); }
+    const_iterator begin() const { return const_iterator(*this, 0); }
+    const_iterator end() const { return const_iterator(*this, size()); }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+
+    std::size_t size() const
+    {
+        return _head.load(std::memory_order_acquire) - _tail.load(std::memory_order_relaxed);
+    }
+
+    bool empty() const { return size() == 0; }
+
+private:
+    static constexpr std::size_t cache_line_size = 64;
+
+    // Written by the producer.
+    alignas(cache_line_size) std::atomic<std::size_t> _head{0};
+    std::size_t _cached_tail{0};
+
+    // Written by the consumer.
+    alignas(cache_line_size) std::atomic<std::size_t> _tail{0};
+    std::size_t _cached_head{0};
+
+    alignas(cache_line_size) std::array<T, N> _storage{};
+};
+
+} // namespace mavsdk
@@ -0,0 +1,102 @@
+#include "spsc_ringbuffer.h"
+#include <cstdint>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+
+using namespace mavsdk;
+
+TEST(SpscRingbuffer, PushAndPop)
+{
+    auto buffer = SpscRingbuffer<int, 3>{};
+    EXPECT_TRUE(buffer.empty());
+
+    EXPECT_TRUE(buffer.push(4));
+    EXPECT_TRUE(buffer.push(5));
+    EXPECT_EQ(buffer.size(), 2);
+
+    int value = 0;
+    EXPECT_TRUE(buffer.pop(value));
+    EXPECT_EQ(value, 4);
+    EXPECT_TRUE(buffer.pop(value));
+    EXPECT_EQ(value, 5);
+    EXPECT_FALSE(buffer.pop(value));
+    EXPECT_TRUE(buffer.empty());
+}
+
+TEST(SpscRingbuffer, PushFailsWhenFull)
+{
+    auto buffer = SpscRingbuffer<int, 2>{};
+
+    EXPECT_TRUE(buffer.push(4));
+    EXPECT_TRUE(buffer.push(5));
+    EXPECT_FALSE(buffer.push(6));
+    ASSERT_EQ(buffer.size(), 2);
+
+    // The oldest is kept, unlike with Ringbuffer.
+    EXPECT_EQ(buffer[0], 4);
+    EXPECT_EQ(buffer[1], 5);
+
+    int value = 0;
+    EXPECT_TRUE(buffer.pop(value));
+    EXPECT_TRUE(buffer.push(6));
+    EXPECT_EQ(buffer[1], 6);
+}
+
+TEST(SpscRingbuffer, IterateAndPopFront)
+{
+    auto buffer = SpscRingbuffer<int, 3>{};
+
+    // Wrap around once.
+    buffer.push(1);
+    buffer.push(2);
+    buffer.pop_front(2);
+    buffer.push(4);
+    buffer.push(5);
+    buffer.push(6);
+
+    std::vector<int> expected{4, 5, 6};
+    unsigned i = 0;
+    for (const auto& value : buffer) {
+        EXPECT_EQ(value, expected[i++]);
+    }
+    EXPECT_EQ(i, 3);
+
+    for (auto& value : buffer) {
+        value += 10;
+    }
+    EXPECT_EQ(buffer[0], 14);
+
+    buffer.pop_front(10);
+    EXPECT_TRUE(buffer.empty());
+}
+
+TEST(SpscRingbuffer, HandsOverBetweenThreads)
+{
+    constexpr uint32_t num_values = 200000;
+    auto buffer = std::make_unique<SpscRingbuffer<uint32_t, 64>>();
+
+    std::thread producer([&]() {
+        for (uint32_t i = 0; i < num_values;) {
+            if (buffer->push(i)) {
+                ++i;
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    uint32_t expected = 0;
+    while (expected < num_values) {
+        uint32_t value = 0;
+        if (buffer->pop(value)) {
+            ASSERT_EQ(value, expected);
+            ++expected;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+
+    producer.join();
+    EXPECT_TRUE(buffer->empty());
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
+namespace mavsdk {
+
+// Lets threads wait for state which is changed elsewhere, e.g. by a message
+// handler, instead of polling it with sleeps. The state itself stays where
+// it is, typically in atomics, and notify() is called after every change.
+//
+// Because notify() takes the mutex the waiters check the state under, a
+// change can't slip between a check and the wait.
+class StateChange {
+public:
+    StateChange() = default;
+    ~StateChange() = default;
+
+    // Non-copyable
+    StateChange(const StateChange&) = delete;
+    const StateChange& operator=(const StateChange&) = delete;
+
+    void notify()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+        }
+        _cv.notify_all();
+    }
+
+    // For state which isn't atomic, e.g. a pointer the predicate checks, the
+    // change itself is made under the mutex.
+    template<typename Change> void notify(Change change)
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            change();
+        }
+        _cv.notify_all();
+    }
+
+    template<typename Predicate> void wait(Predicate predicate)
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _cv.wait(lock, predicate);
+    }
+
+    // Returns whether the predicate was met before the timeout.
+    template<typename Predicate, typename Rep, typename Period>
+    bool wait_for(Predicate predicate, std::chrono::duration<Rep, Period> timeout)
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        return _cv.wait_for(lock, timeout, predicate);
+    }
+
+private:
+    std::mutex _mutex{};
+    std::condition_variable _cv{};
+};
+
+} // namespace mavsdk
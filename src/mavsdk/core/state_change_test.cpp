@@ -0,0 +1,63 @@
+#include "state_change.h"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <gtest/gtest.h>
+
+using namespace mavsdk;
+
+TEST(StateChange, WaitReturnsRightAwayIfMet)
+{
+    StateChange state_change;
+    state_change.wait([]() { return true; });
+    EXPECT_TRUE(state_change.wait_for([]() { return true; }, std::chrono::milliseconds(0)));
+}
+
+TEST(StateChange, WakesWaiterOnChange)
+{
+    StateChange state_change;
+    std::atomic<bool> ready{false};
+
+    const auto before = std::chrono::steady_clock::now();
+    std::thread thread([&]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        ready = true;
+        state_change.notify();
+    });
+
+    EXPECT_TRUE(state_change.wait_for([&]() { return ready.load(); }, std::chrono::seconds(5)));
+    EXPECT_LT(std::chrono::steady_clock::now() - before, std::chrono::seconds(5));
+    thread.join();
+}
+
+TEST(StateChange, TimesOutIfNotMet)
+{
+    StateChange state_change;
+    std::atomic<bool> ready{false};
+
+    std::thread thread([&]() {
+        // Notified, but still not ready.
+        state_change.notify();
+    });
+
+    EXPECT_FALSE(
+        state_change.wait_for([&]() { return ready.load(); }, std::chrono::milliseconds(50)));
+    thread.join();
+}
+
+TEST(StateChange, WakesWaiterOnChangeMadeUnderLock)
+{
+    StateChange state_change;
+    std::unique_ptr<int> value{};
+
+    std::thread thread([&]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        state_change.notify([&]() { value = std::make_unique<int>(42); });
+    });
+
+    EXPECT_TRUE(state_change.wait_for([&]() { return value != nullptr; }, std::chrono::seconds(5)));
+    thread.join();
+    EXPECT_EQ(*value, 42);
+}
@@ -0,0 +1,263 @@
+#include "state_store.h"
+#include "crc32.h"
+#include "fs.h"
+#include "log.h"
+
+#include <utility>
+
+namespace mavsdk {
+
+namespace {
+
+constexpr char header[] = "mavsdk-state 1\n";
+constexpr size_t header_size = sizeof(header) - 1;
+
+// Each record starts with the CRC of the rest of it, then the sizes,
+// little-endian, then key and value. A removed key has no value.
+constexpr size_t record_header_size = 3 * sizeof(uint32_t);
+constexpr uint32_t removed = 0xffffffff;
+
+void append_u32(std::string& out, uint32_t value)
+{
+    for (unsigned i = 0; i < sizeof(value); ++i) {
+        out.push_back(static_cast<char>((value >> (8 * i)) & 0xff));
+    }
+}
+
+uint32_t read_u32(const std::string& in, size_t offset)
+{
+    uint32_t value = 0;
+    for (unsigned i = 0; i < sizeof(value); ++i) {
+        value |= uint32_t{static_cast<uint8_t>(in[offset + i])} << (8 * i);
+    }
+    return value;
+}
+
+uint32_t crc_of(const std::string& in, size_t offset, size_t len)
+{
+    Crc32 crc;
+    crc.add(reinterpret_cast<const uint8_t*>(in.data() + offset), static_cast<uint32_t>(len));
+    return crc.get();
+}
+
+std::string record_for(const std::string& key, const std::optional<std::string>& value)
+{
+    std::string record(sizeof(uint32_t), '\0');
+    append_u32(record, static_cast<uint32_t>(key.size()));
+    append_u32(record, value ? static_cast<uint32_t>(value->size()) : removed);
+    record += key;
+    if (value) {
+        record += value.value();
+    }
+
+    std::string crc;
+    append_u32(crc, crc_of(record, sizeof(uint32_t), record.size() - sizeof(uint32_t)));
+    record.replace(0, sizeof(uint32_t), crc);
+    return record;
+}
+
+uint64_t record_size(const std::string& key, const std::string& value)
+{
+    return record_header_size + key.size() + value.size();
+}
+
+} // namespace
+
+StateStore::StateStore(std::string path) : _path(std::move(path))
+{
+    {
+        std::lock_guard<std::mutex> lock(_file_mutex);
+        if (!load()) {
+            // Whatever was there is replaced by what we could make of it.
+            compact_locked();
+        }
+        if (!_log.is_open()) {
+            _log.open(_path, std::ios::binary | std::ios::app);
+        }
+    }
+
+    _compaction_thread = std::thread([this]() { compaction_loop(); });
+}
+
+StateStore::~StateStore()
+{
+    {
+        std::lock_guard<std::mutex> lock(_file_mutex);
+        _should_exit = true;
+    }
+    _compaction_cv.notify_all();
+    _compaction_thread.join();
+}
+
+bool StateStore::load()
+{
+    std::ifstream file(_path, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+
+    std::string content(fs_file_size(_path), '\0');
+    file.read(content.data(), static_cast<std::streamsize>(content.size()));
+    if (!file || content.compare(0, header_size, header) != 0) {
+        LogWarn() << "Ignoring broken state store " << _path;
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(_entries_mutex);
+
+    size_t offset = header_size;
+    while (offset + record_header_size <= content.size()) {
+        const auto key_size = read_u32(content, offset + sizeof(uint32_t));
+        const auto value_size = read_u32(content, offset + 2 * sizeof(uint32_t));
+        const uint64_t size =
+            uint64_t{record_header_size} + key_size + (value_size == removed ? 0 : value_size);
+        if (offset + size > content.size() ||
+            read_u32(content, offset) !=
+                crc_of(content, offset + sizeof(uint32_t), size - sizeof(uint32_t))) {
+            break;
+        }
+
+        auto key = content.substr(offset + record_header_size, key_size);
+        if (value_size == removed) {
+            _entries.erase(key);
+        } else {
+            _entries[std::move(key)] =
+                content.substr(offset + record_header_size + key_size, value_size);
+        }
+        offset += size;
+    }
+
+    _log_size = offset;
+    _live_size = header_size;
+    for (const auto& [key, value] : _entries) {
+        _live_size += record_size(key, value);
+    }
+
+    if (offset != content.size()) {
+        // Most likely cut off by a crash while it was written.
+        LogWarn() << "Ignoring broken end of state store " << _path;
+        return false;
+    }
+    return true;
+}
+
+std::optional<std::string> StateStore::get(const std::string& key) const
+{
+    std::lock_guard<std::mutex> lock(_entries_mutex);
+    const auto it = _entries.find(key);
+    if (it == _entries.end()) {
+        return {};
+    }
+    return it->second;
+}
+
+bool StateStore::put(const std::string& key, const std::string& value)
+{
+    return append(key, value);
+}
+
+bool StateStore::remove(const std::string& key)
+{
+    return append(key, std::nullopt);
+}
+
+bool StateStore::append(const std::string& key, const std::optional<std::string>& value)
+{
+    std::lock_guard<std::mutex> lock(_file_mutex);
+
+    const auto record = record_for(key, value);
+    const bool written = _log.is_open() &&
+                         _log.write(record.data(), static_cast<std::streamsize>(record.size())) &&
+                         _log.flush();
+    if (written) {
+        _log_size += record.size();
+    } else {
+        LogWarn() << "Could not write state store " << _path;
+        _log.clear();
+    }
+
+    {
+        std::lock_guard<std::mutex> entries_lock(_entries_mutex);
+        const auto it = _entries.find(key);
+        if (it != _entries.end()) {
+            _live_size -= record_size(it->first, it->second);
+        }
+        if (value) {
+            _live_size += record_size(key, value.value());
+            _entries[key] = value.value();
+        } else if (it != _entries.end()) {
+            _entries.erase(it);
+        }
+    }
+
+    // Compacted once more than half of the log is outdated.
+    if (_log_size >= min_compaction_size && _log_size > 2 * _live_size) {
+        _compaction_requested = true;
+        _compaction_cv.notify_all();
+    }
+    return written;
+}
+
+bool StateStore::compact()
+{
+    std::lock_guard<std::mutex> lock(_file_mutex);
+    return compact_locked();
+}
+
+bool StateStore::compact_locked()
+{
+    std::string content(header, header_size);
+    {
+        std::lock_guard<std::mutex> lock(_entries_mutex);
+        for (const auto& [key, value] : _entries) {
+            content += record_for(key, value);
+        }
+    }
+
+    // Written next to it first, so that a crash leaves either log intact.
+    const auto tmp_path = _path + ".tmp";
+    {
+        std::ofstream file(tmp_path, std::ios::binary | std::ios::trunc);
+        if (!file || !file.write(content.data(), static_cast<std::streamsize>(content.size())) ||
+            !file.flush()) {
+            LogWarn() << "Could not write state store " << tmp_path;
+            file.close();
+            fs_remove(tmp_path);
+            return false;
+        }
+    }
+
+    _log.close();
+    const bool renamed = fs_rename(tmp_path, _path);
+    if (!renamed) {
+        LogWarn() << "Could not replace state store " << _path;
+        fs_remove(tmp_path);
+    } else {
+        _log_size = content.size();
+        _live_size = content.size();
+    }
+    _log.clear();
+    _log.open(_path, std::ios::binary | std::ios::app);
+    return renamed;
+}
+
+void StateStore::compaction_loop()
+{
+    std::unique_lock<std::mutex> lock(_file_mutex);
+    while (true) {
+        _compaction_cv.wait(lock, [this]() { return _compaction_requested || _should_exit; });
+        if (_should_exit) {
+            return;
+        }
+        _compaction_requested = false;
+        compact_locked();
+    }
+}
+
+uint64_t StateStore::log_size() const
+{
+    std::lock_guard<std::mutex> lock(_file_mutex);
+    return _log_size;
+}
+
+} // namespace mavsdk
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+
+namespace mavsdk {
+
+// A key-value store on disk for what is kept about vehicles across
+// restarts, e.g. their params or identification, so that not every part of
+// MAVSDK needs its own files for it.
+//
+// Changes are appended to a log, and each record is checked by a CRC, so a
+// crash can at most lose the record it interrupted. The log is read once
+// when the store is opened, after that everything is served from memory.
+// Once most of the log is outdated, it is compacted on a background thread
+// by writing a new one next to it, which then replaces the old one at once.
+class StateStore {
+public:
+    explicit StateStore(std::string path);
+    ~StateStore();
+
+    // Non-copyable
+    StateStore(const StateStore&) = delete;
+    const StateStore& operator=(const StateStore&) = delete;
+
+    std::optional<std::string> get(const std::string& key) const;
+
+    // Returns false if the change could not be written, it is still seen by
+    // get until the store is closed then.
+    bool put(const std::string& key, const std::string& value);
+    bool remove(const std::string& key);
+
+    // Compacts the log right away instead of waiting for the background.
+    bool compact();
+
+    // What the log takes on disk, for testing.
+    uint64_t log_size() const;
+
+    // Below this, compacting isn't worth it.
+    static constexpr uint64_t min_compaction_size = 64 * 1024;
+
+private:
+    bool load();
+    bool append(const std::string& key, const std::optional<std::string>& value);
+    bool compact_locked();
+    void compaction_loop();
+
+    const std::string _path;
+
+    // Changes to the file are done in order, and the entries only change
+    // after that, so get never waits for the disk.
+    mutable std::mutex _file_mutex{};
+    std::ofstream _log{}; // Needs _file_mutex
+    uint64_t _log_size{0}; // Needs _file_mutex
+    uint64_t _live_size{0}; // Needs _file_mutex
+
+    mutable std::mutex _entries_mutex{};
+    std::map<std::string, std::string> _entries{}; // Needs _entries_mutex
+
+    std::condition_variable _compaction_cv{};
+    bool _compaction_requested{false}; // Needs _file_mutex
+    bool _should_exit{false}; // Needs _file_mutex
+    std::thread _compaction_thread{};
+};
+
+// One entry of a store, for code that only keeps a single thing in it. No
+// store means nothing is kept.
+struct StateStoreKey {
+    std::shared_ptr<StateStore> store{};
+    std::string key{};
+};
+
+} // namespace mavsdk
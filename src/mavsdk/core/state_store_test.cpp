@@ -0,0 +1,115 @@
+#include "state_store.h"
+#include "fs.h"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <fstream>
+
+using namespace mavsdk;
+
+namespace {
+
+std::string tmp_path(const std::string& name)
+{
+    auto tmp_dir = create_tmp_directory("mavsdk-state-store-test");
+    EXPECT_TRUE(tmp_dir);
+    const auto path = tmp_dir.value_or(".") + "/" + name;
+    fs_remove(path);
+    return path;
+}
+
+} // namespace
+
+TEST(StateStore, KeepsValuesAcrossRestarts)
+{
+    const auto path = tmp_path("restart.state");
+    const std::string binary("\0binary\xff", 8);
+    {
+        StateStore store(path);
+        EXPECT_FALSE(store.get("params/0123"));
+        EXPECT_TRUE(store.put("params/0123", "some params"));
+        EXPECT_TRUE(store.put("info/system-1", binary));
+        EXPECT_TRUE(store.put("to_be_removed", "value"));
+        EXPECT_TRUE(store.put("params/0123", "other params"));
+        EXPECT_TRUE(store.remove("to_be_removed"));
+        EXPECT_EQ(store.get("params/0123"), std::optional<std::string>("other params"));
+    }
+
+    StateStore store(path);
+    EXPECT_EQ(store.get("params/0123"), std::optional<std::string>("other params"));
+    EXPECT_EQ(store.get("info/system-1"), std::optional<std::string>(binary));
+    EXPECT_FALSE(store.get("to_be_removed"));
+}
+
+TEST(StateStore, BrokenEndIsIgnored)
+{
+    const auto path = tmp_path("broken.state");
+    {
+        StateStore store(path);
+        EXPECT_TRUE(store.put("kept", "value"));
+        EXPECT_TRUE(store.put("cut_off", "value"));
+    }
+
+    // As if the last record was cut off by a crash.
+    const auto size = fs_file_size(path);
+    std::string content(size, '\0');
+    {
+        std::ifstream file(path, std::ios::binary);
+        file.read(content.data(), static_cast<std::streamsize>(content.size()));
+    }
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file.write(content.data(), static_cast<std::streamsize>(content.size() - 3));
+    }
+
+    {
+        StateStore store(path);
+        EXPECT_EQ(store.get("kept"), std::optional<std::string>("value"));
+        EXPECT_FALSE(store.get("cut_off"));
+
+        // The broken end is gone, so new records can be read again.
+        EXPECT_TRUE(store.put("new", "value"));
+    }
+
+    StateStore store(path);
+    EXPECT_EQ(store.get("kept"), std::optional<std::string>("value"));
+    EXPECT_EQ(store.get("new"), std::optional<std::string>("value"));
+}
+
+TEST(StateStore, NotAStoreIsReplaced)
+{
+    const auto path = tmp_path("not_a_store.state");
+    {
+        std::ofstream file(path, std::ios::trunc);
+        file << "something else";
+    }
+
+    {
+        StateStore store(path);
+        EXPECT_FALSE(store.get("something"));
+        EXPECT_TRUE(store.put("key", "value"));
+    }
+
+    StateStore store(path);
+    EXPECT_EQ(store.get("key"), std::optional<std::string>("value"));
+}
+
+TEST(StateStore, OutdatedRecordsAreCompacted)
+{
+    const auto path = tmp_path("compaction.state");
+
+    StateStore store(path);
+    const std::string value(1000, 'x');
+    for (unsigned i = 0; i < 200; ++i) {
+        EXPECT_TRUE(store.put("same_key", value + std::to_string(i)));
+    }
+
+    // Done in the background.
+    for (unsigned i = 0; i < 100 && store.log_size() > StateStore::min_compaction_size; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_LT(store.log_size(), StateStore::min_compaction_size);
+
+    EXPECT_TRUE(store.compact());
+    EXPECT_LT(store.log_size(), 2 * value.size());
+    EXPECT_EQ(store.get("same_key"), std::optional<std::string>(value + "199"));
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <functional>
+#include <utility>
+
+namespace mavsdk {
+
+// Blocking calls are built on top of the asynchronous ones, with a callback
+// that only fulfils a promise. Such a callback doesn't run any user code and
+// returns right away, so instead of going through the user callback queue,
+// which might be busy, it can be called right on the internal thread.
+//
+// Callbacks made with make_sync_callback are recognised by is_sync_callback
+// for as long as they are passed on as the same std::function type.
+template<typename... Args> class SyncCallback {
+public:
+    template<typename F> explicit SyncCallback(F&& func) : _func(std::forward<F>(func)) {}
+
+    void operator()(Args... args) const { _func(std::forward<Args>(args)...); }
+
+private:
+    std::function<void(Args...)> _func;
+};
+
+template<typename Callback> struct SyncCallbackFor;
+
+template<typename... Args> struct SyncCallbackFor<std::function<void(Args...)>> {
+    using Type = SyncCallback<Args...>;
+};
+
+template<typename Callback, typename F> Callback make_sync_callback(F&& func)
+{
+    return Callback{typename SyncCallbackFor<Callback>::Type{std::forward<F>(func)}};
+}
+
+template<typename... Args> bool is_sync_callback(const std::function<void(Args...)>& callback)
+{
+    return callback.template target<SyncCallback<Args...>>() != nullptr;
+}
+
+// For internal callbacks forwarding to another one: the internal callback is
+// only called directly if the one it forwards to would be as well.
+template<typename Callback, typename Outer, typename F>
+Callback make_callback_like(const Outer& outer, F&& func)
+{
+    if (is_sync_callback(outer)) {
+        return make_sync_callback<Callback>(std::forward<F>(func));
+    }
+    return Callback{std::forward<F>(func)};
+}
+
+} // namespace mavsdk
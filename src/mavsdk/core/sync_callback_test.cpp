@@ -0,0 +1,52 @@
+#include "sync_callback.h"
+#include <gtest/gtest.h>
+#include <string>
+
+using namespace mavsdk;
+
+using ResultCallback = std::function<void(int)>;
+using ValueCallback = std::function<void(int, const std::string&)>;
+
+TEST(SyncCallback, IsRecognised)
+{
+    int value = 0;
+    const auto callback = make_sync_callback<ResultCallback>([&value](int v) { value = v; });
+
+    EXPECT_TRUE(is_sync_callback(callback));
+    callback(42);
+    EXPECT_EQ(value, 42);
+}
+
+TEST(SyncCallback, StaysRecognisedWhenCopied)
+{
+    const auto callback = make_sync_callback<ValueCallback>([](int, const std::string&) {});
+
+    const ValueCallback copy = callback;
+    EXPECT_TRUE(is_sync_callback(copy));
+}
+
+TEST(SyncCallback, OthersAreNotRecognised)
+{
+    EXPECT_FALSE(is_sync_callback(ResultCallback{[](int) {}}));
+    EXPECT_FALSE(is_sync_callback(ResultCallback{}));
+
+    // Wrapping it in another callback loses it, which is safe.
+    const auto callback = make_sync_callback<ResultCallback>([](int) {});
+    EXPECT_FALSE(is_sync_callback(ResultCallback{[callback](int v) { callback(v); }}));
+}
+
+TEST(SyncCallback, MakesCallbackLikeOuter)
+{
+    const auto sync = make_sync_callback<ResultCallback>([](int) {});
+    const auto other = ResultCallback{[](int) {}};
+
+    std::string received;
+    auto inner = make_callback_like<ValueCallback>(
+        sync, [&received](int, const std::string& str) { received = str; });
+    EXPECT_TRUE(is_sync_callback(inner));
+    inner(0, "done");
+    EXPECT_EQ(received, "done");
+
+    EXPECT_FALSE(
+        is_sync_callback(make_callback_like<ValueCallback>(other, [](int, const std::string&) {})));
+}
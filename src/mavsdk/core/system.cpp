@@ -45,6 +45,11 @@ bool System::is_connected() const
     return _system_impl->is_connected();
 }
 
+bool System::is_ready() const
+{
+    return _system_impl->is_ready();
+}
+
 uint8_t System::get_system_id() const
 {
     return _system_impl->get_system_id();
@@ -55,6 +60,21 @@ std::vector<uint8_t> System::component_ids() const
     return _system_impl->component_ids();
 }
 
+std::vector<MessageStats> System::message_stats() const
+{
+    return _system_impl->message_stats();
+}
+
+RttStats System::rtt_stats() const
+{
+    return _system_impl->rtt_stats();
+}
+
+void System::set_ping_interval_s(double interval_s)
+{
+    _system_impl->set_ping_interval_s(interval_s);
+}
+
 System::IsConnectedHandle System::subscribe_is_connected(const IsConnectedCallback& callback)
 {
     return _system_impl->subscribe_is_connected(callback);
@@ -65,6 +85,16 @@ void System::unsubscribe_is_connected(IsConnectedHandle handle)
     _system_impl->unsubscribe_is_connected(handle);
 }
 
+System::IsReadyHandle System::subscribe_is_ready(const IsReadyCallback& callback)
+{
+    return _system_impl->subscribe_is_ready(callback);
+}
+
+void System::unsubscribe_is_ready(IsReadyHandle handle)
+{
+    _system_impl->unsubscribe_is_ready(handle);
+}
+
 System::ComponentDiscoveredHandle
 System::subscribe_component_discovered(const ComponentDiscoveredCallback& callback)
 {
@@ -92,4 +122,9 @@ void System::enable_timesync()
     _system_impl->enable_timesync();
 }
 
+std::optional<uint64_t> System::autopilot_time_to_local_us(uint64_t autopilot_time_us) const
+{
+    return _system_impl->autopilot_time_to_local_us(autopilot_time_us);
+}
+
 } // namespace mavsdk
@@ -1,15 +1,24 @@
 #include "system.h"
 #include "mavsdk_impl.h"
+#include "decoded_message.h"
 #include "mavlink_include.h"
 #include "system_impl.h"
+#include "thread_config.h"
 #include "plugin_impl_base.h"
 #include "px4_custom_mode.h"
 #include "ardupilot_custom_mode.h"
 #include "request_message.h"
 #include "callback_list.tpp"
+#include "fs.h"
+#include "param_pck.h"
+#include <algorithm>
 #include <cstdlib>
+#include <fstream>
 #include <functional>
 #include <future>
+#include <iomanip>
+#include <iterator>
+#include <sstream>
 #include <utility>
 
 namespace mavsdk {
@@ -36,20 +45,48 @@ SystemImpl::SystemImpl(MavsdkImpl& parent) :
         _mavsdk_impl.timeout_handler,
         [this]() { return timeout_s(); }),
     _request_message(
-        *this, _command_sender, _mavsdk_impl.mavlink_message_handler, _mavsdk_impl.timeout_handler),
-    _mavlink_ftp(*this)
-{
-    _system_thread = new std::thread(&SystemImpl::system_thread, this);
+        *this,
+        _command_sender,
+        _mavsdk_impl.mavlink_message_handler,
+        _mavsdk_impl.timeout_handler,
+        _memory_resource),
+    _message_intervals([this](
+                           uint16_t message_id,
+                           double rate_hz,
+                           uint8_t component_id,
+                           const CommandResultCallback& callback) {
+        send_command_async(make_command_msg_rate(message_id, rate_hz, component_id), callback);
+    }),
+    _mavlink_ftp_pool(*this)
+{
+    _params.set_work_notifier([this]() { notify_system_thread(); });
+    _command_sender.set_work_notifier([this]() { notify_system_thread(); });
+    _mission_transfer.set_work_notifier([this]() { notify_system_thread(); });
+
+    _user_callback_executor = _mavsdk_impl.new_user_callback_executor();
+
+    _system_worker = _mavsdk_impl.system_worker_for_new_system();
+    if (_system_worker != nullptr) {
+        _system_worker->add(this, [this]() { return do_system_work(); });
+    } else {
+        _system_thread = new std::thread(&SystemImpl::system_thread, this);
+    }
 }
 
 SystemImpl::~SystemImpl()
 {
+    if (_system_worker != nullptr) {
+        _system_worker->remove(this);
+    }
+
     _should_exit = true;
+    notify_system_thread();
     _mavsdk_impl.mavlink_message_handler.unregister_all(this);
 
     if (!_always_connected) {
-        unregister_timeout_handler(_heartbeat_timeout_cookie);
+        _mavsdk_impl.heartbeat_monitor.unwatch(get_system_id());
     }
+    stop_connect_handshake();
 
     if (_system_thread != nullptr) {
         _system_thread->join();
@@ -61,6 +98,7 @@ SystemImpl::~SystemImpl()
 void SystemImpl::init(uint8_t system_id, uint8_t comp_id, bool connected)
 {
     _target_address.system_id = system_id;
+    set_allocator(_mavsdk_impl.allocator_for_system(system_id));
     // FIXME: for now use this as a default.
     _target_address.component_id = MAV_COMP_ID_AUTOPILOT1;
 
@@ -84,6 +122,16 @@ void SystemImpl::init(uint8_t system_id, uint8_t comp_id, bool connected)
         [this](const mavlink_message_t& message) { process_autopilot_version(message); },
         this);
 
+    _mavsdk_impl.mavlink_message_handler.register_one(
+        MAVLINK_MSG_ID_MISSION_CURRENT,
+        [this](const mavlink_message_t& message) { process_mission_current(message); },
+        this);
+
+    _mavsdk_impl.mavlink_message_handler.register_one(
+        MAVLINK_MSG_ID_MISSION_ITEM_REACHED,
+        [this](const mavlink_message_t& message) { process_mission_item_reached(message); },
+        this);
+
     // register_mavlink_command_handler(
     //    MAV_CMD_REQUEST_AUTOPILOT_CAPABILITIES,
     //    [this](const MavlinkCommandReceiver::CommandLong& command) {
@@ -153,7 +201,30 @@ void SystemImpl::unregister_timeout_handler(const void* cookie)
 
 double SystemImpl::timeout_s() const
 {
-    return _mavsdk_impl.timeout_s();
+    return _rtt_estimator.timeout_s(_mavsdk_impl.timeout_s());
+}
+
+MemoryUsage::System SystemImpl::memory_usage()
+{
+    MemoryUsage::System usage;
+    usage.system_id = get_system_id();
+    usage.param_store_bytes = _params.param_store_memory_usage();
+    usage.mission_cache_bytes = _mission_transfer.known_items_memory_usage();
+    usage.work_queue_bytes =
+        _params.work_queue_memory_usage() + _mission_transfer.work_queue_memory_usage();
+
+    usage.ftp_buffer_bytes = _mavlink_ftp_pool.memory_usage();
+    if (auto* ftp = _mavlink_ftp.load(std::memory_order_acquire)) {
+        usage.ftp_buffer_bytes += ftp->memory_usage();
+    }
+
+    std::lock_guard<std::mutex> lock(_plugin_impls_mutex);
+    for (auto* plugin_impl : _plugin_impls) {
+        if (auto plugin = plugin_impl->memory_usage()) {
+            usage.plugins.push_back(std::move(plugin.value()));
+        }
+    }
+    return usage;
 }
 
 void SystemImpl::enable_timesync()
@@ -161,6 +232,25 @@ void SystemImpl::enable_timesync()
     _timesync.enable();
 }
 
+void SystemImpl::set_ping_interval_s(double interval_s)
+{
+    _ping_interval_s = (interval_s > 0.0) ? interval_s : DEFAULT_PING_INTERVAL_S;
+    // So a shorter interval applies right away.
+    notify_system_thread();
+}
+
+std::optional<uint64_t> SystemImpl::autopilot_time_to_local_us(uint64_t autopilot_time_us)
+{
+    if (!_timesync.is_synced()) {
+        return std::nullopt;
+    }
+
+    const auto local = _autopilot_time.local_time_of(
+        AutopilotTimePoint(std::chrono::microseconds(autopilot_time_us)));
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(local.time_since_epoch()).count());
+}
+
 System::IsConnectedHandle
 SystemImpl::subscribe_is_connected(const System::IsConnectedCallback& callback)
 {
@@ -173,6 +263,57 @@ void SystemImpl::unsubscribe_is_connected(System::IsConnectedHandle handle)
     _is_connected_callbacks.unsubscribe(handle);
 }
 
+bool SystemImpl::is_ready() const
+{
+    return _connect_handshake.is_ready();
+}
+
+System::IsReadyHandle SystemImpl::subscribe_is_ready(const System::IsReadyCallback& callback)
+{
+    std::lock_guard<std::mutex> lock(_connection_mutex);
+    return _is_ready_callbacks.subscribe(callback);
+}
+
+void SystemImpl::unsubscribe_is_ready(System::IsReadyHandle handle)
+{
+    _is_ready_callbacks.unsubscribe(handle);
+}
+
+void SystemImpl::add_connect_step(const std::string& name)
+{
+    _connect_handshake.add_step(name);
+}
+
+void SystemImpl::complete_connect_step(const std::string& name)
+{
+    _connect_handshake.complete_step(name);
+}
+
+void SystemImpl::add_connect_request(uint32_t message_id, uint8_t component_id)
+{
+    if (!_connect_handshake.is_running() || _connect_handshake.is_ready()) {
+        // Too late to take part, nothing else is held up by a command now.
+        MavlinkCommandSender::CommandLong command{};
+        command.command = MAV_CMD_REQUEST_MESSAGE;
+        command.params.maybe_param1 = static_cast<float>(message_id);
+        command.target_component_id = component_id;
+        send_command_async(command, nullptr);
+        return;
+    }
+
+    if (!_connect_handshake.add_request(message_id, component_id)) {
+        return;
+    }
+
+    // Kept until disconnected, it does nothing anymore once ready.
+    _mavsdk_impl.mavlink_message_handler.register_one(
+        static_cast<uint16_t>(message_id),
+        [this](const mavlink_message_t& message) {
+            _connect_handshake.process_message(message.msgid, message.compid);
+        },
+        &_connect_handshake);
+}
+
 void SystemImpl::add_call_every(std::function<void()> callback, float interval_s, void** cookie)
 {
     _mavsdk_impl.call_every_handler.add(
@@ -212,8 +353,7 @@ void SystemImpl::unregister_statustext_handler(void* cookie)
 
 void SystemImpl::process_heartbeat(const mavlink_message_t& message)
 {
-    mavlink_heartbeat_t heartbeat;
-    mavlink_msg_heartbeat_decode(&message, &heartbeat);
+    const auto& heartbeat = DecodedMessage::get(message, mavlink_msg_heartbeat_decode);
 
     if (heartbeat.autopilot == MAV_AUTOPILOT_PX4) {
         _autopilot = Autopilot::Px4;
@@ -267,6 +407,34 @@ void SystemImpl::process_statustext(const mavlink_message_t& message)
     }
 }
 
+void SystemImpl::process_mission_current(const mavlink_message_t& message)
+{
+    // Handlers see the messages of all systems.
+    if (message.sysid != get_system_id()) {
+        return;
+    }
+
+    // Streamed at 1 Hz or more, but hardly ever different.
+    const auto& mission_current =
+        DecodedMessage::get(message, mavlink_msg_mission_current_decode);
+    if (_mission_current_seq.exchange(mission_current.seq) != mission_current.seq) {
+        _mavsdk_impl.report_fleet_mission_states();
+    }
+}
+
+void SystemImpl::process_mission_item_reached(const mavlink_message_t& message)
+{
+    if (message.sysid != get_system_id()) {
+        return;
+    }
+
+    const auto& mission_item_reached =
+        DecodedMessage::get(message, mavlink_msg_mission_item_reached_decode);
+    if (_mission_reached_seq.exchange(mission_item_reached.seq) != mission_item_reached.seq) {
+        _mavsdk_impl.report_fleet_mission_states();
+    }
+}
+
 void SystemImpl::process_autopilot_version(const mavlink_message_t& message)
 {
     mavlink_autopilot_version_t autopilot_version;
@@ -274,6 +442,209 @@ void SystemImpl::process_autopilot_version(const mavlink_message_t& message)
 
     _mission_transfer.set_int_messages_supported(
         autopilot_version.capabilities & MAV_PROTOCOL_CAPABILITY_MISSION_INT);
+
+    // Params are only requested from the autopilot.
+    if (message.compid == MAV_COMP_ID_AUTOPILOT1) {
+        _params.set_cache(param_cache_key(autopilot_version));
+
+        _autopilot_supports_ftp =
+            (autopilot_version.capabilities & MAV_PROTOCOL_CAPABILITY_FTP) != 0;
+
+        // Only ArduPilot serves param.pck.
+        if (autopilot() == Autopilot::ArduPilot &&
+            (autopilot_version.capabilities & MAV_PROTOCOL_CAPABILITY_FTP)) {
+            _params.set_bulk_download_function(
+                [this](const MAVLinkParameters::BulkDownloadCallback& callback) {
+                    download_param_pck(callback);
+                });
+        } else {
+            _params.set_bulk_download_function(nullptr);
+        }
+
+        // Only ArduPilot serves missions as files.
+        if (autopilot() == Autopilot::ArduPilot &&
+            (autopilot_version.capabilities & MAV_PROTOCOL_CAPABILITY_FTP)) {
+            using FileTransfer = MavlinkMissionTransfer::FileTransfer;
+            FileTransfer file_transfer;
+            file_transfer.upload = [this](
+                                       const std::string& path,
+                                       const std::vector<uint8_t>& data,
+                                       const FileTransfer::UploadCallback& callback,
+                                       const MavlinkMissionTransfer::ProgressCallback& progress) {
+                upload_mission_file(path, data, callback, progress);
+            };
+            file_transfer.download = [this](
+                                         const std::string& path,
+                                         const FileTransfer::DownloadCallback& callback,
+                                         const MavlinkMissionTransfer::ProgressCallback& progress) {
+                download_mission_file(path, callback, progress);
+            };
+            _mission_transfer.set_file_transfer(file_transfer);
+        } else {
+            _mission_transfer.set_file_transfer({});
+        }
+
+        complete_connect_step("autopilot_version");
+    }
+}
+
+void SystemImpl::download_param_pck(const MAVLinkParameters::BulkDownloadCallback& callback)
+{
+    const auto tmp_dir = create_tmp_directory("mavsdk-param-pck");
+    if (!tmp_dir) {
+        callback({});
+        return;
+    }
+
+    const auto local_folder = tmp_dir.value();
+    const auto local_path = local_folder + path_separator + fs_filename(PARAM_PCK_PATH);
+    mavlink_ftp().download_async(
+        PARAM_PCK_PATH,
+        local_folder,
+        [callback, local_folder, local_path](
+            MavlinkFtp::ClientResult result, MavlinkFtp::ProgressData) {
+            if (result == MavlinkFtp::ClientResult::Next) {
+                return;
+            }
+
+            std::optional<std::vector<uint8_t>> data;
+            if (result == MavlinkFtp::ClientResult::Success) {
+                std::ifstream file(local_path, std::ios::binary);
+                data = std::vector<uint8_t>(
+                    std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+            } else {
+                LogWarn() << "Could not download " << PARAM_PCK_PATH << ": " << result;
+            }
+            fs_remove(local_path);
+            fs_remove(local_folder);
+            callback(data);
+        });
+}
+
+void SystemImpl::upload_mission_file(
+    const std::string& path,
+    const std::vector<uint8_t>& data,
+    const MavlinkMissionTransfer::FileTransfer::UploadCallback& callback,
+    const MavlinkMissionTransfer::ProgressCallback& progress_callback)
+{
+    const auto tmp_dir = create_tmp_directory("mavsdk-mission-file");
+    if (!tmp_dir) {
+        callback(false);
+        return;
+    }
+
+    const auto local_folder = tmp_dir.value();
+    const auto local_path = local_folder + path_separator + fs_filename(path);
+    {
+        std::ofstream file(local_path, std::ios::binary);
+        file.write(
+            reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+        if (!file) {
+            fs_remove(local_path);
+            fs_remove(local_folder);
+            callback(false);
+            return;
+        }
+    }
+
+    mavlink_ftp().upload_async(
+        local_path,
+        path.substr(0, path.find_last_of('/')),
+        [callback, progress_callback, local_folder, local_path, path](
+            MavlinkFtp::ClientResult result, MavlinkFtp::ProgressData progress) {
+            if (result == MavlinkFtp::ClientResult::Next) {
+                if (progress_callback && progress.total_bytes > 0) {
+                    progress_callback(
+                        static_cast<float>(progress.bytes_transferred) /
+                        static_cast<float>(progress.total_bytes));
+                }
+                return;
+            }
+
+            if (result != MavlinkFtp::ClientResult::Success) {
+                LogWarn() << "Could not upload " << path << ": " << result;
+            }
+            fs_remove(local_path);
+            fs_remove(local_folder);
+            callback(result == MavlinkFtp::ClientResult::Success);
+        });
+}
+
+void SystemImpl::download_mission_file(
+    const std::string& path,
+    const MavlinkMissionTransfer::FileTransfer::DownloadCallback& callback,
+    const MavlinkMissionTransfer::ProgressCallback& progress_callback)
+{
+    const auto tmp_dir = create_tmp_directory("mavsdk-mission-file");
+    if (!tmp_dir) {
+        callback({});
+        return;
+    }
+
+    const auto local_folder = tmp_dir.value();
+    const auto local_path = local_folder + path_separator + fs_filename(path);
+    mavlink_ftp().download_async(
+        path,
+        local_folder,
+        [callback, progress_callback, local_folder, local_path, path](
+            MavlinkFtp::ClientResult result, MavlinkFtp::ProgressData progress) {
+            if (result == MavlinkFtp::ClientResult::Next) {
+                if (progress_callback && progress.total_bytes > 0) {
+                    progress_callback(
+                        static_cast<float>(progress.bytes_transferred) /
+                        static_cast<float>(progress.total_bytes));
+                }
+                return;
+            }
+
+            std::optional<std::vector<uint8_t>> data;
+            if (result == MavlinkFtp::ClientResult::Success) {
+                std::ifstream file(local_path, std::ios::binary);
+                data = std::vector<uint8_t>(
+                    std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+            } else {
+                LogWarn() << "Could not download " << path << ": " << result;
+            }
+            fs_remove(local_path);
+            fs_remove(local_folder);
+            callback(data);
+        });
+}
+
+std::shared_ptr<StateStore> SystemImpl::state_store() const
+{
+    return _mavsdk_impl.state_store();
+}
+
+FtpMemoryFiles& SystemImpl::ftp_memory_files()
+{
+    return _mavsdk_impl.ftp_memory_files;
+}
+
+StateStoreKey SystemImpl::param_cache_key(const mavlink_autopilot_version_t& autopilot_version)
+{
+    auto store = state_store();
+    if (!store) {
+        return {};
+    }
+
+    // Newer autopilots might only provide uid2.
+    std::ostringstream uid;
+    uid << std::hex << std::setfill('0');
+    if (autopilot_version.uid != 0) {
+        uid << std::setw(16) << autopilot_version.uid;
+    } else {
+        for (const auto byte : autopilot_version.uid2) {
+            uid << std::setw(2) << static_cast<unsigned>(byte);
+        }
+    }
+
+    if (uid.str().find_first_not_of('0') == std::string::npos) {
+        LogWarn() << "Autopilot has no UID, not caching params";
+        return {};
+    }
+
+    return StateStoreKey{std::move(store), "params/" + uid.str()};
 }
 
 void SystemImpl::heartbeats_timed_out()
@@ -284,29 +655,82 @@ void SystemImpl::heartbeats_timed_out()
 
 void SystemImpl::system_thread()
 {
-    SteadyTimePoint last_ping_time{};
+    ThreadConfig::apply(ThreadRole::System);
 
     while (!_should_exit) {
-        _params.do_work();
-        _command_sender.do_work();
-        _timesync.do_work();
-        _mission_transfer.do_work();
-
-        if (_mavsdk_impl.time.elapsed_since_s(last_ping_time) >= SystemImpl::_ping_interval_s) {
-            if (_connected) {
-                _ping.run_once();
-            }
-            last_ping_time = _mavsdk_impl.time.steady_time();
+        const double wait_s = do_system_work();
+
+        std::unique_lock<std::mutex> lock(_system_thread_mutex);
+        if (wait_s > 0.0) {
+            _system_thread_cv.wait_for(lock, std::chrono::duration<double>(wait_s), [this]() {
+                return _system_thread_work_pending || _should_exit;
+            });
         }
+        _system_thread_work_pending = false;
+    }
+}
+
+double SystemImpl::do_system_work()
+{
+    _params.do_work();
+    _command_sender.do_work();
+    _timesync.do_work();
+    _mission_transfer.do_work();
+
+    auto* ftp = _mavlink_ftp.load(std::memory_order_acquire);
+    if (ftp != nullptr) {
+        ftp->send();
+    }
 
+    if (_mavsdk_impl.time.elapsed_since_s(_last_ping_time) >= _ping_interval_s) {
         if (_connected) {
-            // Work fairly fast if we're connected.
-            std::this_thread::sleep_for(std::chrono::milliseconds(10));
-        } else {
-            // Be less aggressive when unconnected.
-            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            _ping.run_once();
         }
+        _last_ping_time = _mavsdk_impl.time.steady_time();
     }
+
+    // Instead of polling, we sleep until work is queued, or until the next
+    // periodic ping or timesync is due.
+    double wait_s = std::min(
+        _ping_interval_s - _mavsdk_impl.time.elapsed_since_s(_last_ping_time),
+        _timesync.next_work_in_s());
+    if (!_mission_transfer.is_idle()) {
+        wait_s = std::min(wait_s, MISSION_TRANSFER_CHECK_INTERVAL_S);
+    }
+    if (ftp != nullptr && ftp->is_streaming()) {
+        wait_s = std::min(wait_s, FTP_STREAM_INTERVAL_S);
+    }
+    return wait_s;
+}
+
+void SystemImpl::notify_system_thread()
+{
+    if (_system_worker != nullptr) {
+        _system_worker->notify(this);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_system_thread_mutex);
+        _system_thread_work_pending = true;
+    }
+    _system_thread_cv.notify_one();
+}
+
+bool SystemImpl::receive_fleet_command_ack(const mavlink_message_t& message)
+{
+    return _mavsdk_impl.receive_fleet_command_ack(message);
+}
+
+MavlinkFtp& SystemImpl::mavlink_ftp()
+{
+    // Most systems never use FTP, so we only set it up when asked for.
+    std::call_once(_mavlink_ftp_once, [this]() {
+        _mavlink_ftp_storage = std::make_unique<MavlinkFtp>(*this);
+        _mavlink_ftp_storage->set_work_notifier([this]() { notify_system_thread(); });
+        _mavlink_ftp.store(_mavlink_ftp_storage.get(), std::memory_order_release);
+    });
+    return *_mavlink_ftp_storage;
 }
 
 // std::optional<mavlink_message_t>
@@ -482,6 +906,21 @@ bool SystemImpl::send_message(mavlink_message_t& message)
     return _mavsdk_impl.send_message(message);
 }
 
+bool SystemImpl::send_messages(std::vector<mavlink_message_t>& messages)
+{
+    return _mavsdk_impl.send_messages(messages);
+}
+
+bool SystemImpl::send_frames(const uint8_t* data, size_t len)
+{
+    return _mavsdk_impl.send_frames(data, len);
+}
+
+bool SystemImpl::changes_outgoing(uint32_t message_id) const
+{
+    return _mavsdk_impl.changes_outgoing(message_id);
+}
+
 void SystemImpl::send_autopilot_version_request()
 {
     auto prom = std::promise<MavlinkCommandSender::Result>();
@@ -489,12 +928,7 @@ void SystemImpl::send_autopilot_version_request()
 
     send_autopilot_version_request_async(
         [&prom](MavlinkCommandSender::Result result, float) { prom.set_value(result); });
-
-    if (fut.get() == MavlinkCommandSender::Result::Unsupported) {
-        _old_message_520_supported = false;
-        LogWarn() << "Trying alternative command (512).";
-        send_autopilot_version_request();
-    }
+    fut.get();
 }
 
 void SystemImpl::send_autopilot_version_request_async(
@@ -503,7 +937,8 @@ void SystemImpl::send_autopilot_version_request_async(
     MavlinkCommandSender::CommandLong command{};
     command.target_component_id = get_autopilot_id();
 
-    if (_old_message_520_supported) {
+    const bool old_message_supported = _old_message_520_supported;
+    if (old_message_supported) {
         // Note: This MAVLINK message is deprecated and would be removed from MAVSDK in a future
         // release.
         command.command = MAV_CMD_REQUEST_AUTOPILOT_CAPABILITIES;
@@ -513,7 +948,20 @@ void SystemImpl::send_autopilot_version_request_async(
         command.params.maybe_param1 = {static_cast<float>(MAVLINK_MSG_ID_AUTOPILOT_VERSION)};
     }
 
-    send_command_async(command, callback);
+    send_command_async(
+        command,
+        [this, callback, old_message_supported](
+            MavlinkCommandSender::Result result, float progress) {
+            if (result == MavlinkCommandSender::Result::Unsupported && old_message_supported) {
+                _old_message_520_supported = false;
+                LogWarn() << "Trying alternative command (512).";
+                send_autopilot_version_request_async(callback);
+                return;
+            }
+            if (callback) {
+                callback(result, progress);
+            }
+        });
 }
 
 void SystemImpl::send_flight_information_request()
@@ -521,10 +969,19 @@ void SystemImpl::send_flight_information_request()
     auto prom = std::promise<MavlinkCommandSender::Result>();
     auto fut = prom.get_future();
 
+    send_flight_information_request_async(
+        [&prom](MavlinkCommandSender::Result result, float) { prom.set_value(result); });
+    fut.get();
+}
+
+void SystemImpl::send_flight_information_request_async(
+    const MavlinkCommandSender::CommandResultCallback& callback)
+{
     MavlinkCommandSender::CommandLong command{};
     command.target_component_id = get_autopilot_id();
 
-    if (_old_message_528_supported) {
+    const bool old_message_supported = _old_message_528_supported;
+    if (old_message_supported) {
         // Note: This MAVLINK message is deprecated and would be removed from MAVSDK in a future
         // release.
         command.command = MAV_CMD_REQUEST_FLIGHT_INFORMATION;
@@ -535,16 +992,29 @@ void SystemImpl::send_flight_information_request()
     }
 
     send_command_async(
-        command, [&prom](MavlinkCommandSender::Result result, float) { prom.set_value(result); });
-    if (fut.get() == MavlinkCommandSender::Result::Unsupported) {
-        _old_message_528_supported = false;
-        LogWarn() << "Trying alternative command (512)..";
-        send_flight_information_request();
-    }
+        command,
+        [this, callback, old_message_supported](
+            MavlinkCommandSender::Result result, float progress) {
+            if (result == MavlinkCommandSender::Result::Unsupported && old_message_supported) {
+                _old_message_528_supported = false;
+                LogWarn() << "Trying alternative command (512)..";
+                send_flight_information_request_async(callback);
+                return;
+            }
+            if (callback) {
+                callback(result, progress);
+            }
+        });
 }
 
 void SystemImpl::set_connected()
 {
+    // Most heartbeats only keep the system alive, which needs no lock.
+    if (_connected && !_always_connected) {
+        _mavsdk_impl.heartbeat_monitor.refresh(get_system_id());
+        return;
+    }
+
     bool enable_needed = false;
     {
         std::lock_guard<std::mutex> lock(_connection_mutex);
@@ -569,51 +1039,126 @@ void SystemImpl::set_connected()
             });
 
             if (!_always_connected) {
-                register_timeout_handler(
-                    [this] { heartbeats_timed_out(); },
-                    HEARTBEAT_TIMEOUT_S,
-                    &_heartbeat_timeout_cookie);
+                _mavsdk_impl.heartbeat_monitor.watch(
+                    get_system_id(), HEARTBEAT_TIMEOUT_S, [this] { heartbeats_timed_out(); });
             }
             enable_needed = true;
 
             _is_connected_callbacks.queue(
-                true, [this](const auto& func) { _mavsdk_impl.call_user_callback(func); });
-
-        } else if (_connected && !_always_connected) {
-            refresh_timeout_handler(_heartbeat_timeout_cookie);
+                true, [this](const auto& func) { call_user_callback(func); });
         }
-        // If not yet connected there is nothing to do/
     }
     if (enable_needed) {
+        // Everything is requested right away rather than one after another,
+        // the plugins add their steps while they are enabled.
+        start_connect_handshake();
+
         if (has_autopilot()) {
+            add_connect_step("autopilot_version");
             send_autopilot_version_request_async(nullptr);
         }
 
-        std::lock_guard<std::mutex> lock(_plugin_impls_mutex);
-        for (auto plugin_impl : _plugin_impls) {
-            plugin_impl->enable();
+        {
+            std::lock_guard<std::mutex> lock(_plugin_impls_mutex);
+            for (auto plugin_impl : _plugin_impls) {
+                plugin_impl->enable();
+            }
         }
+
+        _connect_handshake.seal();
     }
 }
 
+void SystemImpl::start_connect_handshake()
+{
+    _connect_handshake.start(
+        [this](uint32_t message_id, uint8_t component_id) {
+            send_request_message_unacked(message_id, component_id);
+        },
+        [this](const std::vector<std::string>& missing_steps) {
+            connect_handshake_ready(missing_steps);
+        });
+
+    register_timeout_handler(
+        [this]() { _connect_handshake.expire(); }, CONNECT_DEADLINE_S, &_connect_deadline_cookie);
+    add_call_every(
+        [this]() { _connect_handshake.resend(); },
+        CONNECT_RESEND_INTERVAL_S,
+        &_connect_resend_cookie);
+}
+
+void SystemImpl::stop_connect_handshake()
+{
+    _connect_handshake.stop();
+    unregister_timeout_handler(_connect_deadline_cookie);
+    remove_call_every(_connect_resend_cookie);
+    _mavsdk_impl.mavlink_message_handler.unregister_all(&_connect_handshake);
+}
+
+void SystemImpl::connect_handshake_ready(const std::vector<std::string>& missing_steps)
+{
+    unregister_timeout_handler(_connect_deadline_cookie);
+    remove_call_every(_connect_resend_cookie);
+
+    if (missing_steps.empty()) {
+        LogDebug() << "System " << static_cast<int>(get_system_id()) << " ready";
+    } else {
+        std::string missing;
+        for (const auto& step : missing_steps) {
+            missing += (missing.empty() ? "" : ", ") + step;
+        }
+        LogWarn() << "System " << static_cast<int>(get_system_id())
+                  << " ready, but still missing: " << missing;
+    }
+
+    _is_ready_callbacks.queue(true, [this](const auto& func) { call_user_callback(func); });
+}
+
+void SystemImpl::send_request_message_unacked(uint32_t message_id, uint8_t component_id)
+{
+    mavlink_message_t message;
+    mavlink_msg_command_long_pack(
+        get_own_system_id(),
+        get_own_component_id(),
+        &message,
+        get_system_id(),
+        component_id,
+        MAV_CMD_REQUEST_MESSAGE,
+        0,
+        static_cast<float>(message_id),
+        0.0f,
+        0.0f,
+        0.0f,
+        0.0f,
+        0.0f,
+        0.0f);
+    send_message(message);
+}
+
 void SystemImpl::set_disconnected()
 {
     {
         std::lock_guard<std::mutex> lock(_connection_mutex);
 
-        // This might not be needed because this is probably called from the triggered
-        // timeout anyway, but it should also do no harm.
-        // unregister_timeout_handler(_heartbeat_timeout_cookie);
-        //_heartbeat_timeout_cookie = nullptr;
-
         _connected = false;
+        // The system might come back over another link.
+        _rtt_estimator.reset();
         _mavsdk_impl.notify_on_timeout();
         _is_connected_callbacks.queue(
-            false, [this](const auto& func) { _mavsdk_impl.call_user_callback(func); });
+            false, [this](const auto& func) { call_user_callback(func); });
     }
 
     _mavsdk_impl.stop_sending_heartbeats();
 
+    const bool was_ready = _connect_handshake.is_ready();
+    stop_connect_handshake();
+    if (was_ready) {
+        _is_ready_callbacks.queue(false, [this](const auto& func) { call_user_callback(func); });
+    }
+
+    // The system might have been restarted by the time it is back.
+    _message_intervals.forget_sent_rates();
+
     {
         std::lock_guard<std::mutex> lock(_plugin_impls_mutex);
         for (auto plugin_impl : _plugin_impls) {
@@ -632,6 +1177,11 @@ std::vector<uint8_t> SystemImpl::component_ids() const
     return std::vector<uint8_t>{_components.begin(), _components.end()};
 }
 
+std::vector<MessageStats> SystemImpl::message_stats() const
+{
+    return _mavsdk_impl.message_stats_of_system(get_system_id());
+}
+
 void SystemImpl::set_system_id(uint8_t system_id)
 {
     _target_address.system_id = system_id;
@@ -703,6 +1253,45 @@ void SystemImpl::set_param_async(
     _params.set_param_async(name, value, callback, cookie, maybe_component_id, extended);
 }
 
+void SystemImpl::set_params_async(
+    const std::vector<std::pair<std::string, MAVLinkParameters::ParamValue>>& params,
+    const MAVLinkParameters::SetParamsCallback& callback,
+    std::optional<uint8_t> maybe_component_id,
+    size_t max_in_flight)
+{
+    _params.set_params_async(params, callback, maybe_component_id, max_in_flight);
+}
+
+void SystemImpl::get_params_async(
+    const std::vector<std::pair<std::string, MAVLinkParameters::ParamValue>>& params,
+    const MAVLinkParameters::GetParamsCallback& callback,
+    std::optional<uint8_t> maybe_component_id,
+    bool extended,
+    size_t max_in_flight)
+{
+    _params.get_params_async(params, callback, maybe_component_id, extended, max_in_flight);
+}
+
+void SystemImpl::set_params_async(
+    MAVLinkParameters::SharedParams params,
+    const MAVLinkParameters::SetParamsCallback& callback,
+    std::optional<uint8_t> maybe_component_id,
+    size_t max_in_flight)
+{
+    _params.set_params_async(std::move(params), callback, maybe_component_id, max_in_flight);
+}
+
+void SystemImpl::get_params_async(
+    MAVLinkParameters::SharedParams params,
+    const MAVLinkParameters::GetParamsCallback& callback,
+    std::optional<uint8_t> maybe_component_id,
+    bool extended,
+    size_t max_in_flight)
+{
+    _params.get_params_async(
+        std::move(params), callback, maybe_component_id, extended, max_in_flight);
+}
+
 void SystemImpl::set_param_float_async(
     const std::string& name,
     float value,
@@ -1162,23 +1751,55 @@ void SystemImpl::send_command_async(
     _command_sender.queue_command_async(command, callback);
 }
 
-MavlinkCommandSender::Result
-SystemImpl::set_msg_rate(uint16_t message_id, double rate_hz, uint8_t component_id)
+void SystemImpl::send_streamed_command_async(
+    MavlinkCommandSender::CommandLong command, const CommandResultCallback& callback)
 {
-    MavlinkCommandSender::CommandLong command =
-        make_command_msg_rate(message_id, rate_hz, component_id);
-    return send_command(command);
+    if (_target_address.system_id == 0 && _components.empty()) {
+        if (callback) {
+            callback(MavlinkCommandSender::Result::NoSystem, NAN);
+        }
+        return;
+    }
+    command.target_system_id = get_system_id();
+
+    _command_sender.queue_streamed_command_async(command, callback);
+}
+
+MavlinkCommandSender::Result SystemImpl::set_msg_rate(
+    uint16_t message_id, double rate_hz, uint8_t component_id, const void* consumer)
+{
+    auto prom = std::make_shared<std::promise<MavlinkCommandSender::Result>>();
+    auto fut = prom->get_future();
+
+    if (!_message_intervals.request(
+            message_id,
+            rate_hz,
+            component_id,
+            consumer,
+            [prom](MavlinkCommandSender::Result result, float) {
+                if (result != MavlinkCommandSender::Result::InProgress) {
+                    prom->set_value(result);
+                }
+            })) {
+        // Nothing to do, the rate is already set.
+        return MavlinkCommandSender::Result::Success;
+    }
+
+    return fut.get();
 }
 
 void SystemImpl::set_msg_rate_async(
     uint16_t message_id,
     double rate_hz,
     const CommandResultCallback& callback,
-    uint8_t component_id)
+    uint8_t component_id,
+    const void* consumer)
 {
-    MavlinkCommandSender::CommandLong command =
-        make_command_msg_rate(message_id, rate_hz, component_id);
-    send_command_async(command, callback);
+    if (!_message_intervals.request(message_id, rate_hz, component_id, consumer, callback) &&
+        callback) {
+        call_user_callback(
+            [callback]() { callback(MavlinkCommandSender::Result::Success, NAN); });
+    }
 }
 
 MavlinkCommandSender::CommandLong
@@ -1228,6 +1849,8 @@ void SystemImpl::unregister_plugin(PluginImplBase* plugin_impl)
     plugin_impl->disable();
     plugin_impl->deinit();
 
+    _message_intervals.release_all(plugin_impl);
+
     // Remove first, so it won't get enabled/disabled anymore.
     {
         std::lock_guard<std::mutex> lock(_plugin_impls_mutex);
@@ -1239,9 +1862,14 @@ void SystemImpl::unregister_plugin(PluginImplBase* plugin_impl)
 }
 
 void SystemImpl::call_user_callback_located(
-    const std::string& filename, const int linenumber, const std::function<void()>& func)
-{
-    _mavsdk_impl.call_user_callback_located(filename, linenumber, func);
+    const char* filename,
+    const int linenumber,
+    std::function<void()> func,
+    const void* coalesce_key,
+    CallbackLane lane)
+{
+    _mavsdk_impl.call_user_callback_located(
+        filename, linenumber, std::move(func), coalesce_key, _user_callback_executor, lane);
 }
 
 void SystemImpl::param_changed(const std::string& name)
@@ -1,31 +1,44 @@
 #pragma once
 
 #include "callback_list.h"
+#include "callback_queue.h"
+#include "connect_handshake.h"
 #include "flight_mode.h"
+#include "forwarding_memory_resource.h"
+#include "ftp_memory_files.h"
 #include "mavlink_address.h"
 #include "mavlink_include.h"
 #include "mavlink_parameters.h"
 #include "mavlink_command_sender.h"
 #include "mavlink_ftp.h"
+#include "mavlink_ftp_pool.h"
 #include "mavlink_message_handler.h"
 #include "mavlink_mission_transfer.h"
 #include "mavlink_request_message_handler.h"
 #include "mavlink_statustext_handler.h"
+#include "memory_usage.h"
+#include "message_interval_manager.h"
 #include "request_message.h"
+#include "rtt_estimator.h"
+#include "state_store.h"
 #include "ardupilot_custom_mode.h"
 #include "ping.h"
 #include "timeout_handler.h"
 #include "safe_queue.h"
 #include "timesync.h"
 #include "system.h"
+#include "system_worker.h"
 #include <cstdint>
 #include <functional>
+#include <string>
 #include <atomic>
 #include <vector>
 #include <unordered_set>
 #include <unordered_map>
 #include <thread>
+#include <memory>
 #include <mutex>
+#include <condition_variable>
 #include <future>
 
 namespace mavsdk {
@@ -43,10 +56,23 @@ public:
     void init(uint8_t system_id, uint8_t comp_id, bool connected);
 
     void enable_timesync();
+    std::optional<uint64_t> autopilot_time_to_local_us(uint64_t autopilot_time_us);
 
     System::IsConnectedHandle subscribe_is_connected(const System::IsConnectedCallback& callback);
     void unsubscribe_is_connected(System::IsConnectedHandle handle);
 
+    bool is_ready() const;
+    System::IsReadyHandle subscribe_is_ready(const System::IsReadyCallback& callback);
+    void unsubscribe_is_ready(System::IsReadyHandle handle);
+
+    // Plugins take part in the discovery after connecting from enable(), the
+    // system is ready once all steps are done, see ConnectHandshake.
+    void add_connect_step(const std::string& name);
+    void complete_connect_step(const std::string& name);
+    // Asks for the message until it arrives, without an ack holding up the
+    // other commands. Once ready, it is a command like any other.
+    void add_connect_request(uint32_t message_id, uint8_t component_id);
+
     // void process_mavlink_message(mavlink_message_t& message);
 
     using MavlinkMessageHandler = std::function<void(const mavlink_message_t&)>;
@@ -76,6 +102,9 @@ public:
     void unregister_statustext_handler(void* cookie);
 
     bool send_message(mavlink_message_t& message) override;
+    bool send_messages(std::vector<mavlink_message_t>& messages);
+    bool send_frames(const uint8_t* data, size_t len);
+    bool changes_outgoing(uint32_t message_id) const;
 
     Autopilot autopilot() const override { return _autopilot; };
 
@@ -88,15 +117,26 @@ public:
         MavlinkCommandSender::CommandLong command, const CommandResultCallback& callback);
     void send_command_async(
         MavlinkCommandSender::CommandInt command, const CommandResultCallback& callback);
+    // Replaces the previous target of the same command and instance if it is
+    // not acknowledged yet, see MavlinkCommandSender::queue_streamed_command_async.
+    void send_streamed_command_async(
+        MavlinkCommandSender::CommandLong command, const CommandResultCallback& callback);
 
+    // Requests of different consumers, e.g. plugins, are merged, so the
+    // highest rate requested is used. The requests of a plugin are dropped
+    // when it is unregistered.
     MavlinkCommandSender::Result set_msg_rate(
-        uint16_t message_id, double rate_hz, uint8_t maybe_component_id = MAV_COMP_ID_AUTOPILOT1);
+        uint16_t message_id,
+        double rate_hz,
+        uint8_t maybe_component_id = MAV_COMP_ID_AUTOPILOT1,
+        const void* consumer = nullptr);
 
     void set_msg_rate_async(
         uint16_t message_id,
         double rate_hz,
         const CommandResultCallback& callback,
-        uint8_t maybe_component_id = MAV_COMP_ID_AUTOPILOT1);
+        uint8_t maybe_component_id = MAV_COMP_ID_AUTOPILOT1,
+        const void* consumer = nullptr);
 
     // Adds unique component ids
     void add_new_component(uint8_t component_id);
@@ -122,6 +162,13 @@ public:
     uint8_t get_system_id() const override;
     std::vector<uint8_t> component_ids() const;
 
+    // The latest MISSION_CURRENT and MISSION_ITEM_REACHED sequence of the
+    // system, -1 until received.
+    int32_t mission_current_seq() const { return _mission_current_seq; }
+    int32_t mission_reached_seq() const { return _mission_reached_seq; }
+
+    std::vector<MessageStats> message_stats() const;
+
     void set_system_id(uint8_t system_id);
 
     uint8_t get_own_system_id() const override;
@@ -233,6 +280,33 @@ public:
         std::optional<uint8_t> maybe_component_id = {},
         bool extended = false);
 
+    void set_params_async(
+        const std::vector<std::pair<std::string, MAVLinkParameters::ParamValue>>& params,
+        const MAVLinkParameters::SetParamsCallback& callback,
+        std::optional<uint8_t> maybe_component_id = {},
+        size_t max_in_flight = MAVLinkParameters::DEFAULT_SET_PARAMS_IN_FLIGHT);
+
+    void get_params_async(
+        const std::vector<std::pair<std::string, MAVLinkParameters::ParamValue>>& params,
+        const MAVLinkParameters::GetParamsCallback& callback,
+        std::optional<uint8_t> maybe_component_id = {},
+        bool extended = false,
+        size_t max_in_flight = MAVLinkParameters::DEFAULT_GET_PARAMS_IN_FLIGHT);
+
+    // For the same params sent to several systems.
+    void set_params_async(
+        MAVLinkParameters::SharedParams params,
+        const MAVLinkParameters::SetParamsCallback& callback,
+        std::optional<uint8_t> maybe_component_id = {},
+        size_t max_in_flight = MAVLinkParameters::DEFAULT_SET_PARAMS_IN_FLIGHT);
+
+    void get_params_async(
+        MAVLinkParameters::SharedParams params,
+        const MAVLinkParameters::GetParamsCallback& callback,
+        std::optional<uint8_t> maybe_component_id = {},
+        bool extended = false,
+        size_t max_in_flight = MAVLinkParameters::DEFAULT_GET_PARAMS_IN_FLIGHT);
+
     void subscribe_param_float(
         const std::string& name,
         const MAVLinkParameters::ParamFloatChangedCallback& callback,
@@ -262,21 +336,40 @@ public:
     AutopilotTime& get_autopilot_time() { return _autopilot_time; };
 
     double get_ping_time_s() const { return _ping.last_ping_time_s(); }
+    RttStats rtt_stats() const { return _ping.rtt_stats(); }
+    void set_ping_interval_s(double interval_s);
 
     void register_plugin(PluginImplBase* plugin_impl);
     void unregister_plugin(PluginImplBase* plugin_impl);
 
+    // Where plugins can keep what they know about a system for the next
+    // connection, nothing if nothing is to be kept.
+    std::shared_ptr<StateStore> state_store() const;
+
+    // Served by the FTP server of every system, see FtpMemoryFiles.
+    FtpMemoryFiles& ftp_memory_files();
+
     void call_user_callback_located(
-        const std::string& filename, int linenumber, const std::function<void()>& func);
+        const char* filename,
+        int linenumber,
+        std::function<void()> func,
+        const void* coalesce_key = nullptr,
+        CallbackLane lane = CallbackLane::Events);
 
     void send_autopilot_version_request();
     void send_autopilot_version_request_async(
         const MavlinkCommandSender::CommandResultCallback& callback);
     void send_flight_information_request();
+    void send_flight_information_request_async(
+        const MavlinkCommandSender::CommandResultCallback& callback);
 
     MavlinkMissionTransfer& mission_transfer() { return _mission_transfer; };
 
-    MavlinkFtp& mavlink_ftp() { return _mavlink_ftp; };
+    MavlinkFtp& mavlink_ftp();
+    // Clients only, for transfers which can run in parallel.
+    MavlinkFtpPool& mavlink_ftp_pool() { return _mavlink_ftp_pool; };
+    // Whether the autopilot announced MAVLink FTP in AUTOPILOT_VERSION.
+    bool autopilot_supports_ftp() const { return _autopilot_supports_ftp; }
 
     RequestMessage& request_message() { return _request_message; };
 
@@ -284,15 +377,44 @@ public:
     SystemImpl(const SystemImpl&) = delete;
     const SystemImpl& operator=(const SystemImpl&) = delete;
 
+    // Adapts to the round trip time once it is known, and falls back to the
+    // timeout set on Mavsdk until then.
     double timeout_s() const;
 
+    // Protocols waiting for replies feed it with round trip times.
+    RttEstimator& rtt_estimator() { return _rtt_estimator; }
+
+    MemoryUsage::System memory_usage();
+
+    // For the containers of this system, e.g. the pending message requests.
+    void set_allocator(const ForwardingMemoryResource::Allocator& allocator)
+    {
+        _memory_resource.set_allocator(allocator);
+    }
+
+    // Acks from this system which none of its own commands were waiting for.
+    bool receive_fleet_command_ack(const mavlink_message_t& message);
+
 private:
     static bool is_autopilot(uint8_t comp_id);
     static bool is_camera(uint8_t comp_id);
 
     void process_heartbeat(const mavlink_message_t& message);
     void process_autopilot_version(const mavlink_message_t& message);
+    StateStoreKey param_cache_key(const mavlink_autopilot_version_t& autopilot_version);
+    void download_param_pck(const MAVLinkParameters::BulkDownloadCallback& callback);
+    void upload_mission_file(
+        const std::string& path,
+        const std::vector<uint8_t>& data,
+        const MavlinkMissionTransfer::FileTransfer::UploadCallback& callback,
+        const MavlinkMissionTransfer::ProgressCallback& progress_callback);
+    void download_mission_file(
+        const std::string& path,
+        const MavlinkMissionTransfer::FileTransfer::DownloadCallback& callback,
+        const MavlinkMissionTransfer::ProgressCallback& progress_callback);
     void process_statustext(const mavlink_message_t& message);
+    void process_mission_current(const mavlink_message_t& message);
+    void process_mission_item_reached(const mavlink_message_t& message);
     void heartbeats_timed_out();
     void set_connected();
     void set_disconnected();
@@ -304,6 +426,9 @@ private:
     static System::ComponentType component_type(uint8_t component_id);
 
     void system_thread();
+    // Returns in how many seconds there is work again.
+    double do_system_work();
+    void notify_system_thread();
 
     std::pair<MavlinkCommandSender::Result, MavlinkCommandSender::CommandLong>
     make_command_flight_mode(FlightMode mode, uint8_t component_id);
@@ -355,20 +480,52 @@ private:
     std::atomic<Autopilot> _autopilot{Autopilot::Unknown};
 
     MavsdkImpl& _mavsdk_impl;
+    unsigned _user_callback_executor{0};
 
+    // Has to outlive the members using it.
+    ForwardingMemoryResource _memory_resource{};
+
+    // Either our own thread, or the one shared with other systems.
     std::thread* _system_thread{nullptr};
+    SystemWorker* _system_worker{nullptr};
     std::atomic<bool> _should_exit{false};
+    SteadyTimePoint _last_ping_time{};
+
+    std::mutex _system_thread_mutex{};
+    std::condition_variable _system_thread_cv{};
+    bool _system_thread_work_pending{false};
+
+    // Mission transfer items finish on message reception without touching
+    // the queue, so we need to check back regularly while one is ongoing.
+    static constexpr double MISSION_TRANSFER_CHECK_INTERVAL_S = 0.01;
+    static constexpr double FTP_STREAM_INTERVAL_S = 0.005;
 
     static constexpr double HEARTBEAT_TIMEOUT_S = 3.0;
 
+    void start_connect_handshake();
+    void stop_connect_handshake();
+    void connect_handshake_ready(const std::vector<std::string>& missing_steps);
+    void send_request_message_unacked(uint32_t message_id, uint8_t component_id);
+
+    // All discovery after connecting shares this deadline.
+    static constexpr double CONNECT_DEADLINE_S = 5.0;
+    static constexpr float CONNECT_RESEND_INTERVAL_S = 0.5f;
+    ConnectHandshake _connect_handshake{};
+    CallbackList<bool> _is_ready_callbacks{};
+    void* _connect_deadline_cookie{nullptr};
+    void* _connect_resend_cookie{nullptr};
+
     std::mutex _connection_mutex{};
     std::atomic<bool> _connected{false};
     CallbackList<bool> _is_connected_callbacks{};
-    void* _heartbeat_timeout_cookie = nullptr;
 
     std::atomic<bool> _autopilot_version_pending{false};
+    std::atomic<bool> _autopilot_supports_ftp{false};
+
+    static constexpr double DEFAULT_PING_INTERVAL_S = 5.0;
+    std::atomic<double> _ping_interval_s{DEFAULT_PING_INTERVAL_S};
 
-    static constexpr double _ping_interval_s = 5.0;
+    RttEstimator _rtt_estimator{};
 
     MAVLinkParameters _params;
     MavlinkCommandSender _command_sender;
@@ -378,7 +535,12 @@ private:
 
     MavlinkMissionTransfer _mission_transfer;
     RequestMessage _request_message;
-    MavlinkFtp _mavlink_ftp;
+    MessageIntervalManager _message_intervals;
+    std::once_flag _mavlink_ftp_once{};
+    std::unique_ptr<MavlinkFtp> _mavlink_ftp_storage{};
+    // Set once created, for the system thread to skip it until then.
+    std::atomic<MavlinkFtp*> _mavlink_ftp{nullptr};
+    MavlinkFtpPool _mavlink_ftp_pool;
 
     std::mutex _plugin_impls_mutex{};
     std::vector<PluginImplBase*> _plugin_impls{};
@@ -396,8 +558,11 @@ private:
     std::mutex _mavlink_ftp_files_mutex{};
     std::unordered_map<std::string, std::string> _mavlink_ftp_files{};
 
-    bool _old_message_520_supported{true};
-    bool _old_message_528_supported{true};
+    std::atomic<int32_t> _mission_current_seq{-1};
+    std::atomic<int32_t> _mission_reached_seq{-1};
+
+    std::atomic<bool> _old_message_520_supported{true};
+    std::atomic<bool> _old_message_528_supported{true};
 };
 
 } // namespace mavsdk
@@ -0,0 +1,121 @@
+#include "system_worker.h"
+#include "thread_config.h"
+
+#include <algorithm>
+
+namespace mavsdk {
+
+SystemWorker::SystemWorker() : _thread(&SystemWorker::run, this) {}
+
+SystemWorker::~SystemWorker()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _should_exit = true;
+    }
+    _cv.notify_all();
+    _thread.join();
+}
+
+void SystemWorker::add(const void* cookie, Work work)
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _clients.push_back(std::make_unique<Client>(Client{cookie, std::move(work), {}, true}));
+    }
+    _cv.notify_all();
+}
+
+void SystemWorker::remove(const void* cookie)
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+
+    const auto it = std::find_if(_clients.begin(), _clients.end(), [&](const auto& client) {
+        return client->cookie == cookie;
+    });
+    if (it == _clients.end()) {
+        return;
+    }
+
+    // Taken out first, so that it isn't run again while we wait.
+    auto client = std::move(*it);
+    _clients.erase(it);
+
+    if (_running != client.get()) {
+        return;
+    }
+
+    if (std::this_thread::get_id() == _thread.get_id()) {
+        // Removed from its own work, which we can't wait for, so it is
+        // dropped once done instead.
+        _running_removed = std::move(client);
+    } else {
+        _cv.wait(lock, [&]() { return _running != client.get(); });
+    }
+}
+
+void SystemWorker::notify(const void* cookie)
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        for (auto& client : _clients) {
+            if (client->cookie == cookie) {
+                client->pending = true;
+            }
+        }
+    }
+    _cv.notify_all();
+}
+
+void SystemWorker::run()
+{
+    ThreadConfig::apply(ThreadRole::System);
+
+    std::unique_lock<std::mutex> lock(_mutex);
+
+    while (!_should_exit) {
+        const auto now = Clock::now();
+
+        Client* due = nullptr;
+        auto earliest = Clock::time_point::max();
+        for (size_t i = 0; i < _clients.size(); ++i) {
+            const size_t index = (_next_index + i) % _clients.size();
+            auto& client = *_clients[index];
+            if (client.pending || client.next_due <= now) {
+                due = &client;
+                _next_index = index + 1;
+                break;
+            }
+            earliest = std::min(earliest, client.next_due);
+        }
+
+        if (due == nullptr) {
+            if (earliest == Clock::time_point::max()) {
+                _cv.wait(lock);
+            } else {
+                _cv.wait_until(lock, earliest);
+            }
+            continue;
+        }
+
+        // Notified while it runs means it has to run again.
+        due->pending = false;
+        _running = due;
+        lock.unlock();
+
+        const double wait_s = due->work();
+
+        lock.lock();
+        if (_running_removed) {
+            _running_removed.reset();
+        } else {
+            due->next_due = Clock::now() + std::chrono::duration_cast<Clock::duration>(
+                                               std::chrono::duration<double>(
+                                                   std::clamp(wait_s, 0.0, max_wait_s)));
+        }
+        _running = nullptr;
+        _cv.notify_all();
+    }
+}
+
+} // namespace mavsdk
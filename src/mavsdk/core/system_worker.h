@@ -0,0 +1,63 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace mavsdk {
+
+// Runs the periodic work of many systems on one thread, instead of one
+// thread per system, e.g. to monitor a swarm.
+//
+// The work of a system returns in how many seconds it has something to do
+// again, and is run then, or earlier when notified.
+class SystemWorker {
+public:
+    using Work = std::function<double()>;
+
+    SystemWorker();
+    ~SystemWorker();
+
+    // Non-copyable
+    SystemWorker(const SystemWorker&) = delete;
+    const SystemWorker& operator=(const SystemWorker&) = delete;
+
+    void add(const void* cookie, Work work);
+
+    // Once it returns, the work is not running and won't be run again.
+    void remove(const void* cookie);
+
+    void notify(const void* cookie);
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    // Longest a work is not run for, which also keeps the conversion to the
+    // clock from overflowing.
+    static constexpr double max_wait_s = 60.0;
+
+    struct Client {
+        const void* cookie;
+        Work work;
+        Clock::time_point next_due;
+        bool pending;
+    };
+
+    void run();
+
+    std::mutex _mutex{};
+    std::condition_variable _cv{};
+    // Served in turns, so a busy one doesn't starve the others.
+    std::vector<std::unique_ptr<Client>> _clients{}; // Needs _mutex
+    const Client* _running{nullptr}; // Needs _mutex
+    std::unique_ptr<Client> _running_removed{}; // Needs _mutex
+    size_t _next_index{0}; // Needs _mutex
+    bool _should_exit{false}; // Needs _mutex
+    std::thread _thread;
+};
+
+} // namespace mavsdk
@@ -0,0 +1,119 @@
+#include "system_worker.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <future>
+
+using namespace mavsdk;
+
+TEST(SystemWorker, RunsWorkWhenAdded)
+{
+    SystemWorker worker;
+    std::promise<void> prom;
+    auto fut = prom.get_future();
+
+    int a;
+    std::atomic<bool> done{false};
+    worker.add(&a, [&]() {
+        if (!done.exchange(true)) {
+            prom.set_value();
+        }
+        return 10.0;
+    });
+
+    EXPECT_EQ(fut.wait_for(std::chrono::seconds(1)), std::future_status::ready);
+    worker.remove(&a);
+}
+
+TEST(SystemWorker, RunsWorkAgainWhenDue)
+{
+    SystemWorker worker;
+    int a;
+    std::atomic<int> runs{0};
+    worker.add(&a, [&]() {
+        ++runs;
+        return 0.01;
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    worker.remove(&a);
+    EXPECT_GT(runs, 3);
+}
+
+TEST(SystemWorker, RunsWorkWhenNotified)
+{
+    SystemWorker worker;
+    int a;
+    std::atomic<int> runs{0};
+    worker.add(&a, [&]() {
+        ++runs;
+        return 10.0;
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_EQ(runs, 1);
+
+    worker.notify(&a);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_EQ(runs, 2);
+
+    worker.remove(&a);
+}
+
+TEST(SystemWorker, ServesEveryClient)
+{
+    SystemWorker worker;
+    int a;
+    int b;
+    std::atomic<int> runs_a{0};
+    std::atomic<int> runs_b{0};
+    // A is always due again, but must not keep B from running.
+    worker.add(&a, [&]() {
+        ++runs_a;
+        return 0.0;
+    });
+    worker.add(&b, [&]() {
+        ++runs_b;
+        return 0.0;
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    worker.remove(&a);
+    worker.remove(&b);
+    EXPECT_GT(runs_a, 0);
+    EXPECT_GT(runs_b, 0);
+}
+
+TEST(SystemWorker, RemoveWaitsForRunningWork)
+{
+    SystemWorker worker;
+    int a;
+    std::atomic<bool> running{false};
+    std::atomic<bool> finished{false};
+    worker.add(&a, [&]() {
+        running = true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        finished = true;
+        return 10.0;
+    });
+
+    while (!running) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    worker.remove(&a);
+    EXPECT_TRUE(finished);
+}
+
+TEST(SystemWorker, CanBeRemovedFromOwnWork)
+{
+    SystemWorker worker;
+    int a;
+    std::atomic<int> runs{0};
+    worker.add(&a, [&]() {
+        ++runs;
+        worker.remove(&a);
+        return 0.0;
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_EQ(runs, 1);
+}
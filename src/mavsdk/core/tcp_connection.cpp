@@ -1,5 +1,7 @@
 #include "tcp_connection.h"
 #include "log.h"
+#include "receive_burst.h"
+#include "thread_config.h"
 
 #ifdef WINDOWS
 #ifndef MINGW
@@ -7,13 +9,18 @@
 #endif
 #else
 #include <netinet/in.h>
+#include <netinet/tcp.h>
 #include <sys/socket.h>
 #include <arpa/inet.h>
 #include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
 #include <unistd.h> // for close()
 #endif
 
-#include <cassert>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
 #include <utility>
 
 #ifndef WINDOWS
@@ -24,6 +31,48 @@
 
 namespace mavsdk {
 
+namespace {
+
+bool set_non_blocking(int fd)
+{
+#ifdef WINDOWS
+    u_long mode = 1;
+    return ioctlsocket(fd, FIONBIO, &mode) == 0;
+#else
+    const int flags = fcntl(fd, F_GETFL, 0);
+    return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+#endif
+}
+
+bool last_error_would_block()
+{
+#ifdef WINDOWS
+    return WSAGetLastError() == WSAEWOULDBLOCK;
+#else
+    return errno == EAGAIN || errno == EWOULDBLOCK;
+#endif
+}
+
+bool last_error_in_progress()
+{
+#ifdef WINDOWS
+    return WSAGetLastError() == WSAEWOULDBLOCK;
+#else
+    return errno == EINPROGRESS;
+#endif
+}
+
+int poll_fds(pollfd* fds, unsigned num_fds, int timeout_ms)
+{
+#ifdef WINDOWS
+    return WSAPoll(fds, num_fds, timeout_ms);
+#else
+    return poll(fds, num_fds, timeout_ms);
+#endif
+}
+
+} // namespace
+
 /* change to remote_ip and remote_port */
 TcpConnection::TcpConnection(
     Connection::ReceiverCallback receiver_callback,
@@ -44,15 +93,29 @@ TcpConnection::~TcpConnection()
 
 ConnectionResult TcpConnection::start()
 {
-    if (!start_mavlink_receiver()) {
-        return ConnectionResult::ConnectionsExhausted;
+    start_mavlink_receiver();
+
+#ifdef WINDOWS
+    WSADATA wsa;
+    if (WSAStartup(MAKEWORD(2, 2), &wsa) != 0) {
+        LogErr() << "Error: Winsock failed, error: %d", WSAGetLastError();
+        return ConnectionResult::SocketError;
     }
+#else
+    if (pipe(_wakeup_fds) != 0 || !set_non_blocking(_wakeup_fds[0]) ||
+        !set_non_blocking(_wakeup_fds[1])) {
+        LogErr() << "Could not set up wakeup pipe: " << GET_ERROR(errno);
+        return ConnectionResult::SocketError;
+    }
+#endif
 
     ConnectionResult ret = setup_port();
     if (ret != ConnectionResult::Success) {
         return ret;
     }
 
+    start_send_scheduler();
+
     start_recv_thread();
 
     return ConnectionResult::Success;
@@ -60,19 +123,36 @@ ConnectionResult TcpConnection::start()
 
 ConnectionResult TcpConnection::setup_port()
 {
-#ifdef WINDOWS
-    WSADATA wsa;
-    if (WSAStartup(MAKEWORD(2, 2), &wsa) != 0) {
-        LogErr() << "Error: Winsock failed, error: %d", WSAGetLastError();
+    const int socket_fd = static_cast<int>(socket(AF_INET, SOCK_STREAM, 0));
+
+    if (socket_fd < 0) {
+        LogErr() << "socket error" << GET_ERROR(errno);
         _is_ok = false;
         return ConnectionResult::SocketError;
     }
-#endif
 
-    _socket_fd = socket(AF_INET, SOCK_STREAM, 0);
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        close_socket();
+        _socket_fd = socket_fd;
+        // A partially sent frame would only confuse the other side.
+        _write_buffer.clear();
+        _write_pending = false;
+    }
 
-    if (_socket_fd < 0) {
-        LogErr() << "socket error" << GET_ERROR(errno);
+    // Small messages such as setpoints should go out right away.
+    int one = 1;
+    if (setsockopt(
+            _socket_fd,
+            IPPROTO_TCP,
+            TCP_NODELAY,
+            reinterpret_cast<const char*>(&one),
+            sizeof(one)) != 0) {
+        LogWarn() << "Could not set TCP_NODELAY: " << GET_ERROR(errno);
+    }
+
+    if (!set_non_blocking(_socket_fd)) {
+        LogErr() << "Could not set socket non-blocking: " << GET_ERROR(errno);
         _is_ok = false;
         return ConnectionResult::SocketError;
     }
@@ -84,43 +164,85 @@ ConnectionResult TcpConnection::setup_port()
 
     if (connect(_socket_fd, reinterpret_cast<sockaddr*>(&remote_addr), sizeof(struct sockaddr_in)) <
         0) {
-        LogErr() << "connect error: " << GET_ERROR(errno);
-        _is_ok = false;
-        return ConnectionResult::SocketConnectionError;
+        if (!last_error_in_progress()) {
+            LogErr() << "connect error: " << GET_ERROR(errno);
+            _is_ok = false;
+            return ConnectionResult::SocketConnectionError;
+        }
+
+        if (!wait_for(POLLOUT, CONNECT_TIMEOUT_MS)) {
+            LogErr() << "connect error: timeout";
+            _is_ok = false;
+            return ConnectionResult::SocketConnectionError;
+        }
+
+        int error = 0;
+        socklen_t error_len = sizeof(error);
+        if (getsockopt(
+                _socket_fd, SOL_SOCKET, SO_ERROR, reinterpret_cast<char*>(&error), &error_len) !=
+                0 ||
+            error != 0) {
+            LogErr() << "connect error: " << GET_ERROR(error);
+            _is_ok = false;
+            return ConnectionResult::SocketConnectionError;
+        }
     }
 
     _is_ok = true;
     return ConnectionResult::Success;
 }
 
-void TcpConnection::start_recv_thread()
+void TcpConnection::close_socket()
 {
-    _recv_thread = std::make_unique<std::thread>(&TcpConnection::receive, this);
-}
+    // Needs _mutex
 
-ConnectionResult TcpConnection::stop()
-{
-    _should_exit = true;
+    if (_socket_fd < 0) {
+        return;
+    }
 
 #ifndef WINDOWS
-    // This should interrupt a recv/recvfrom call.
     shutdown(_socket_fd, SHUT_RDWR);
-
-    // But on Mac, closing is also needed to stop blocking recv/recvfrom.
     close(_socket_fd);
 #else
     shutdown(_socket_fd, SD_BOTH);
-
     closesocket(_socket_fd);
-
-    WSACleanup();
 #endif
+    _socket_fd = -1;
+}
+
+void TcpConnection::start_recv_thread()
+{
+    _recv_thread = std::make_unique<std::thread>(&TcpConnection::receive, this);
+}
+
+ConnectionResult TcpConnection::stop()
+{
+    stop_send_scheduler();
+
+    _should_exit = true;
+    wake_up();
 
     if (_recv_thread) {
         _recv_thread->join();
         _recv_thread.reset();
     }
 
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        close_socket();
+    }
+
+#ifndef WINDOWS
+    for (auto& fd : _wakeup_fds) {
+        if (fd >= 0) {
+            close(fd);
+            fd = -1;
+        }
+    }
+#else
+    WSACleanup();
+#endif
+
     // We need to stop this after stopping the receive thread, otherwise
     // it can happen that we interfere with the parsing of a message.
     stop_mavlink_receiver();
@@ -129,6 +251,20 @@ ConnectionResult TcpConnection::stop()
 }
 
 bool TcpConnection::send_message(const mavlink_message_t& message)
+{
+    uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
+    const uint16_t buffer_len = mavlink_msg_to_send_buffer(buffer, &message);
+
+    return send_frames(buffer, buffer_len);
+}
+
+size_t TcpConnection::memory_usage()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return Connection::memory_usage() + _write_buffer.capacity();
+}
+
+bool TcpConnection::send_frames(const uint8_t* data, size_t len)
 {
     if (!_is_ok) {
         return false;
@@ -144,18 +280,33 @@ bool TcpConnection::send_message(const mavlink_message_t& message)
         return false;
     }
 
-    struct sockaddr_in dest_addr {};
-    dest_addr.sin_family = AF_INET;
+    std::lock_guard<std::mutex> lock(_mutex);
 
-    inet_pton(AF_INET, _remote_ip.c_str(), &dest_addr.sin_addr.s_addr);
+    if (_write_buffer.size() + len > MAX_WRITE_BUFFER_LEN) {
+        LogWarn() << "TCP write buffer full, dropping message";
+        return false;
+    }
 
-    dest_addr.sin_port = htons(_remote_port_number);
+    // Most of the time nothing is queued and it can go out right away,
+    // otherwise it needs to wait its turn.
+    _write_buffer.insert(_write_buffer.end(), data, data + len);
+    if (_write_buffer.size() == len && flush_write_buffer()) {
+        return true;
+    }
 
-    uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
-    uint16_t buffer_len = mavlink_msg_to_send_buffer(buffer, &message);
+    if (!_is_ok) {
+        return false;
+    }
+
+    if (!_write_pending.exchange(true)) {
+        wake_up();
+    }
+    return true;
+}
 
-    // TODO: remove this assert again
-    assert(buffer_len <= MAVLINK_MAX_PACKET_LEN);
+bool TcpConnection::flush_write_buffer()
+{
+    // Needs _mutex
 
 #if !defined(MSG_NOSIGNAL)
     auto flags = 0;
@@ -163,54 +314,162 @@ bool TcpConnection::send_message(const mavlink_message_t& message)
     auto flags = MSG_NOSIGNAL;
 #endif
 
-    const auto send_len = sendto(
-        _socket_fd,
-        reinterpret_cast<char*>(buffer),
-        buffer_len,
-        flags,
-        reinterpret_cast<const sockaddr*>(&dest_addr),
-        sizeof(dest_addr));
+    size_t sent = 0;
+    while (sent < _write_buffer.size()) {
+        const auto send_len = send(
+            _socket_fd,
+            reinterpret_cast<const char*>(_write_buffer.data() + sent),
+            static_cast<int>(_write_buffer.size() - sent),
+            flags);
+
+        if (send_len < 0) {
+            if (!last_error_would_block()) {
+                LogErr() << "send failure: " << GET_ERROR(errno);
+                _is_ok = false;
+                wake_up();
+            }
+            break;
+        }
+        sent += static_cast<size_t>(send_len);
+    }
+
+    _write_buffer.erase(_write_buffer.begin(), _write_buffer.begin() + sent);
+    return _write_buffer.empty();
+}
+
+void TcpConnection::wake_up()
+{
+#ifndef WINDOWS
+    if (_wakeup_fds[1] >= 0) {
+        const char byte = 0;
+        // If the pipe is full, the thread is woken up anyway.
+        (void)!write(_wakeup_fds[1], &byte, 1);
+    }
+#endif
+}
+
+bool TcpConnection::wait_for(short events, int timeout_ms)
+{
+    pollfd fds[2]{};
+    fds[0].fd = _socket_fd;
+    fds[0].events = events;
+    unsigned num_fds = 1;
+
+#ifndef WINDOWS
+    fds[1].fd = _wakeup_fds[0];
+    fds[1].events = POLLIN;
+    num_fds = 2;
+#else
+    // Without a wakeup pipe we need to check back regularly.
+    timeout_ms = std::min(timeout_ms, 10);
+#endif
+
+    if (poll_fds(fds, num_fds, timeout_ms) <= 0) {
+        return false;
+    }
+
+#ifndef WINDOWS
+    if ((fds[1].revents & POLLIN) != 0) {
+        char drain[64];
+        while (read(_wakeup_fds[0], drain, sizeof(drain)) > 0) {
+        }
+    }
+#endif
 
-    if (send_len != buffer_len) {
-        LogErr() << "sendto failure: " << GET_ERROR(errno);
+    if ((fds[0].revents & (POLLERR | POLLHUP | POLLNVAL)) != 0 &&
+        (fds[0].revents & POLLIN) == 0) {
         _is_ok = false;
         return false;
     }
-    return true;
+
+    return (fds[0].revents & events) != 0;
+}
+
+void TcpConnection::reconnect()
+{
+    LogErr() << "TCP receive error, trying to reconnect in " << _reconnect_delay_s << " s...";
+
+    // The wait is cut short when we are stopped.
+    const auto delay_ms = static_cast<int>(_reconnect_delay_s * 1000.0);
+    const auto wait_until = std::chrono::steady_clock::now() + std::chrono::milliseconds(delay_ms);
+    while (!_should_exit && std::chrono::steady_clock::now() < wait_until) {
+#ifndef WINDOWS
+        pollfd wakeup_fd{};
+        wakeup_fd.fd = _wakeup_fds[0];
+        wakeup_fd.events = POLLIN;
+        poll(&wakeup_fd, 1, delay_ms);
+        char drain[64];
+        while (read(_wakeup_fds[0], drain, sizeof(drain)) > 0) {
+        }
+#else
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+#endif
+    }
+
+    if (_should_exit) {
+        return;
+    }
+
+    if (setup_port() == ConnectionResult::Success) {
+        LogInfo() << "TCP reconnected";
+        _reconnect_delay_s = RECONNECT_DELAY_MIN_S;
+    } else {
+        _reconnect_delay_s = std::min(_reconnect_delay_s * 2.0, RECONNECT_DELAY_MAX_S);
+    }
 }
 
 void TcpConnection::receive()
 {
-    // Enough for MTU 1500 bytes.
-    char buffer[2048];
+    ThreadConfig::apply(ThreadRole::Receive);
 
     while (!_should_exit) {
         if (!_is_ok) {
-            LogErr() << "TCP receive error, trying to reconnect...";
-            std::this_thread::sleep_for(std::chrono::seconds(1));
-            setup_port();
+            reconnect();
+            continue;
+        }
+
+        const short events = POLLIN | (_write_pending ? POLLOUT : 0);
+        if (!wait_for(events, 1000)) {
+            continue;
+        }
+
+        receive_available();
+
+        if (_write_pending) {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (flush_write_buffer()) {
+                _write_pending = false;
+            }
         }
+    }
+}
+
+void TcpConnection::receive_available()
+{
+    // Enough for MTU 1500 bytes, a few times over.
+    char buffer[8192];
 
+    while (!_should_exit) {
         const auto recv_len = recv(_socket_fd, buffer, sizeof(buffer), 0);
 
         if (recv_len == 0) {
-            // This can happen when shutdown is called on the socket,
-            // therefore we check _should_exit again.
+            // The other side has closed the connection.
             _is_ok = false;
-            continue;
+            return;
         }
 
         if (recv_len < 0) {
-            // This happens on desctruction when close(_socket_fd) is called,
-            // therefore be quiet.
-            // LogErr() << "recvfrom error: " << GET_ERROR(errno);
-            // Something went wrong, we should try to re-connect in next iteration.
-            _is_ok = false;
-            continue;
+            if (!last_error_would_block()) {
+                // Something went wrong, we should try to re-connect in next iteration.
+                _is_ok = false;
+            }
+            return;
         }
 
-        _mavlink_receiver->set_new_datagram(buffer, static_cast<int>(recv_len));
+        _mavlink_receiver->set_new_datagram(
+            buffer, static_cast<int>(recv_len), receive_time_now_ns());
 
+        ReceiveBurst::Scope receive_burst;
         // Parse all mavlink messages in one data packet. Once exhausted, we'll exit while.
         while (_mavlink_receiver->parse_message()) {
             receive_message(_mavlink_receiver->get_last_message(), this);
@@ -4,6 +4,7 @@
 #include <mutex>
 #include <memory>
 #include <thread>
+#include <vector>
 #include "connection.h"
 #include <sys/types.h>
 #ifndef WINDOWS
@@ -29,6 +30,8 @@ public:
     ConnectionResult stop() override;
 
     bool send_message(const mavlink_message_t& message) override;
+    bool send_frames(const uint8_t* data, size_t len) override;
+    size_t memory_usage() override;
 
     // Non-copyable
     TcpConnection(const TcpConnection&) = delete;
@@ -36,15 +39,38 @@ public:
 
 private:
     ConnectionResult setup_port();
+    void close_socket();
     void start_recv_thread();
     void receive();
+    void reconnect();
+    void receive_available();
+    bool flush_write_buffer();
+
+    // Waits until the socket has the events or we are woken up.
+    bool wait_for(short events, int timeout_ms);
+    void wake_up();
 
     std::string _remote_ip = {};
     int _remote_port_number;
 
+    // Serializes writing, and replacing the socket.
     std::mutex _mutex = {};
     int _socket_fd = -1;
 
+    // Whatever could not be sent right away, sent by the receive thread once
+    // the socket is writable again.
+    static constexpr size_t MAX_WRITE_BUFFER_LEN = 256 * 1024;
+    std::vector<uint8_t> _write_buffer{}; // Needs _mutex
+    std::atomic_bool _write_pending{false};
+
+    // Only used to wake up the receive thread, not available on Windows.
+    int _wakeup_fds[2]{-1, -1};
+
+    static constexpr int CONNECT_TIMEOUT_MS = 5000;
+    static constexpr double RECONNECT_DELAY_MIN_S = 0.01;
+    static constexpr double RECONNECT_DELAY_MAX_S = 5.0;
+    double _reconnect_delay_s{RECONNECT_DELAY_MIN_S};
+
     std::unique_ptr<std::thread> _recv_thread{};
     std::atomic_bool _should_exit;
     std::atomic_bool _is_ok{false};
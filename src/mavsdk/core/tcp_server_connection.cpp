@@ -0,0 +1,476 @@
+#include "tcp_server_connection.h"
+#include "io_reactor.h"
+#include "log.h"
+#include "mavlink_frame.h"
+#include "receive_burst.h"
+
+#ifdef WINDOWS
+#ifndef MINGW
+#pragma comment(lib, "Ws2_32.lib") // Without this, Ws2_32.lib is not included in static library.
+#endif
+#include <winsock2.h>
+#include <Ws2tcpip.h>
+#undef SOCKET_ERROR
+#else
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h> // for close()
+#endif
+
+#include <cstring>
+#include <utility>
+
+#ifndef WINDOWS
+#define GET_ERROR(_x) strerror(_x)
+#else
+#define GET_ERROR(_x) WSAGetLastError()
+#endif
+
+namespace mavsdk {
+
+namespace {
+
+bool set_non_blocking(int fd)
+{
+#ifdef WINDOWS
+    u_long mode = 1;
+    return ioctlsocket(fd, FIONBIO, &mode) == 0;
+#else
+    const int flags = fcntl(fd, F_GETFL, 0);
+    return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+#endif
+}
+
+bool last_error_would_block()
+{
+#ifdef WINDOWS
+    return WSAGetLastError() == WSAEWOULDBLOCK;
+#else
+    return errno == EAGAIN || errno == EWOULDBLOCK;
+#endif
+}
+
+void close_fd(int fd)
+{
+#ifndef WINDOWS
+    shutdown(fd, SHUT_RDWR);
+    close(fd);
+#else
+    shutdown(fd, SD_BOTH);
+    closesocket(fd);
+#endif
+}
+
+} // namespace
+
+TcpServerConnection::TcpServerConnection(
+    Connection::ReceiverCallback receiver_callback,
+    std::string local_ip,
+    int local_port,
+    ForwardingOption forwarding_option) :
+    Connection(std::move(receiver_callback), forwarding_option),
+    _local_ip(std::move(local_ip)),
+    _local_port_number(local_port)
+{}
+
+TcpServerConnection::~TcpServerConnection()
+{
+    // If no one explicitly called stop before, we should at least do it.
+    stop();
+}
+
+ConnectionResult TcpServerConnection::start()
+{
+    if (!IoReactor::is_supported()) {
+        LogErr() << "TCP server connections are not supported on this platform";
+        return ConnectionResult::ConnectionError;
+    }
+
+    start_mavlink_receiver();
+
+    ConnectionResult ret = setup_port();
+    if (ret != ConnectionResult::Success) {
+        return ret;
+    }
+
+    _should_exit = false;
+
+    // The clients are served wherever the listening socket is, so they don't
+    // need a thread each, even without a shared reactor.
+    _reactor = _io_reactor;
+    if (_reactor == nullptr) {
+        _own_io_reactor = std::make_unique<IoReactor>();
+        _reactor = _own_io_reactor.get();
+    }
+
+    if (!_reactor->add(_listen_fd, [this]() { accept_clients(); })) {
+        LogErr() << "Could not watch TCP server socket";
+        stop();
+        return ConnectionResult::ConnectionError;
+    }
+
+    start_send_scheduler();
+
+    return ConnectionResult::Success;
+}
+
+ConnectionResult TcpServerConnection::setup_port()
+{
+#ifdef WINDOWS
+    WSADATA wsa;
+    if (WSAStartup(MAKEWORD(2, 2), &wsa) != 0) {
+        LogErr() << "Error: Winsock failed, error: %d", WSAGetLastError();
+        return ConnectionResult::SocketError;
+    }
+#endif
+
+    _listen_fd = static_cast<int>(socket(AF_INET, SOCK_STREAM, 0));
+    if (_listen_fd < 0) {
+        LogErr() << "socket error: " << GET_ERROR(errno);
+        return ConnectionResult::SocketError;
+    }
+
+    // So we can listen again right away after a restart, even while the
+    // connections of before are still in TIME_WAIT.
+    int one = 1;
+    if (setsockopt(
+            _listen_fd,
+            SOL_SOCKET,
+            SO_REUSEADDR,
+            reinterpret_cast<const char*>(&one),
+            sizeof(one)) != 0) {
+        LogWarn() << "Could not set SO_REUSEADDR: " << GET_ERROR(errno);
+    }
+
+    struct sockaddr_in addr {};
+    addr.sin_family = AF_INET;
+    if (inet_pton(AF_INET, _local_ip.c_str(), &addr.sin_addr) != 1) {
+        LogErr() << "Invalid local IP: " << _local_ip;
+        close_fd(_listen_fd);
+        _listen_fd = -1;
+        return ConnectionResult::BindError;
+    }
+    addr.sin_port = htons(_local_port_number);
+
+    if (bind(_listen_fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        listen(_listen_fd, SOMAXCONN) != 0) {
+        LogErr() << "bind error: " << GET_ERROR(errno);
+        close_fd(_listen_fd);
+        _listen_fd = -1;
+        return ConnectionResult::BindError;
+    }
+
+    socklen_t addr_len = sizeof(addr);
+    if (getsockname(_listen_fd, reinterpret_cast<sockaddr*>(&addr), &addr_len) == 0) {
+        _local_port_number = ntohs(addr.sin_port);
+    }
+
+    if (!set_non_blocking(_listen_fd)) {
+        LogErr() << "Could not set socket non-blocking: " << GET_ERROR(errno);
+        close_fd(_listen_fd);
+        _listen_fd = -1;
+        return ConnectionResult::SocketError;
+    }
+
+    return ConnectionResult::Success;
+}
+
+ConnectionResult TcpServerConnection::stop()
+{
+    _should_exit = true;
+
+    stop_send_scheduler();
+
+    if (_reactor != nullptr && _listen_fd >= 0) {
+        _reactor->remove(_listen_fd);
+    }
+    if (_listen_fd >= 0) {
+        close_fd(_listen_fd);
+        _listen_fd = -1;
+    }
+
+    // Taken out first, the callbacks need the mutex, so we can't wait for
+    // them with it held.
+    std::unordered_map<int, std::shared_ptr<Client>> clients;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        clients.swap(_clients);
+    }
+    for (auto& [fd, client] : clients) {
+        _reactor->remove(fd);
+        close_fd(fd);
+    }
+
+    _own_io_reactor.reset();
+    _reactor = nullptr;
+
+#ifdef WINDOWS
+    WSACleanup();
+#endif
+
+    // We need to stop this after stopping the receive callbacks, otherwise
+    // it can happen that we interfere with the parsing of a message.
+    stop_mavlink_receiver();
+
+    return ConnectionResult::Success;
+}
+
+size_t TcpServerConnection::num_clients()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _clients.size();
+}
+
+void TcpServerConnection::accept_clients()
+{
+    while (!_should_exit) {
+        struct sockaddr_in client_addr {};
+        socklen_t client_addr_len = sizeof(client_addr);
+        const int fd = static_cast<int>(
+            accept(_listen_fd, reinterpret_cast<sockaddr*>(&client_addr), &client_addr_len));
+
+        if (fd < 0) {
+            if (!last_error_would_block()) {
+                LogErr() << "accept error: " << GET_ERROR(errno);
+            }
+            return;
+        }
+
+        if (!set_non_blocking(fd)) {
+            LogErr() << "Could not set client socket non-blocking: " << GET_ERROR(errno);
+            close_fd(fd);
+            continue;
+        }
+
+        // Small messages such as setpoints should go out right away.
+        int one = 1;
+        if (setsockopt(
+                fd, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&one), sizeof(one)) !=
+            0) {
+            LogWarn() << "Could not set TCP_NODELAY: " << GET_ERROR(errno);
+        }
+
+        auto client = std::make_shared<Client>();
+        client->fd = fd;
+        char ip[INET_ADDRSTRLEN]{};
+        inet_ntop(AF_INET, &client_addr.sin_addr, ip, sizeof(ip));
+        client->ip = ip;
+        client->port = ntohs(client_addr.sin_port);
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _clients.emplace(fd, client);
+        }
+
+        if (!_reactor->add(fd, [this, client]() { receive_available(client); })) {
+            LogErr() << "Could not watch TCP client socket";
+            std::lock_guard<std::mutex> lock(_mutex);
+            _clients.erase(fd);
+            close_fd(fd);
+            continue;
+        }
+
+        LogInfo() << "TCP client connected: " << client->ip << ":" << client->port;
+    }
+}
+
+void TcpServerConnection::receive_available(const std::shared_ptr<Client>& client)
+{
+    // Enough for MTU 1500 bytes, a few times over.
+    char buffer[8192];
+
+    while (!_should_exit) {
+        const auto recv_len = recv(client->fd, buffer, sizeof(buffer), 0);
+
+        if (recv_len == 0 || (recv_len < 0 && !last_error_would_block())) {
+            // The client has gone, or we gave up on it when sending.
+            remove_client(client);
+            return;
+        }
+
+        if (recv_len < 0) {
+            break;
+        }
+
+        client->receiver.set_new_datagram(buffer, static_cast<unsigned>(recv_len));
+
+        ReceiveBurst::Scope receive_burst;
+        // Parse all mavlink messages in one data packet. Once exhausted, we'll exit while.
+        while (client->receiver.parse_message()) {
+            auto& message = client->receiver.get_last_message();
+            learn_system_id(*client, message.sysid);
+            receive_message(message, client->receiver, this);
+        }
+    }
+
+    // Whatever is left for the client might fit now.
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (!client->write_buffer.empty()) {
+        flush_write_buffer(*client);
+    }
+}
+
+void TcpServerConnection::remove_client(const std::shared_ptr<Client>& client)
+{
+    // Called on the reactor thread from the client's callback.
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        // Unless stop() has taken it already, in which case it waits for us
+        // to return and closes it.
+        if (_clients.erase(client->fd) == 0) {
+            return;
+        }
+    }
+
+    _reactor->remove(client->fd);
+    LogInfo() << "TCP client disconnected: " << client->ip << ":" << client->port;
+    close_fd(client->fd);
+}
+
+void TcpServerConnection::learn_system_id(Client& client, uint8_t system_id)
+{
+    // Only written here, on the reactor thread, so we can look without the
+    // mutex, and only need it for the rare new system.
+    if (system_id == 0 || client.system_ids.test(system_id)) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    client.system_ids.set(system_id);
+}
+
+bool TcpServerConnection::send_message(const mavlink_message_t& message)
+{
+    uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
+    const uint16_t buffer_len = mavlink_msg_to_send_buffer(buffer, &message);
+
+    return send_frames(buffer, buffer_len);
+}
+
+bool TcpServerConnection::send_frames(const uint8_t* data, size_t len)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    if (_clients.empty()) {
+        return false;
+    }
+
+    // Frame by frame, as they might be targeted at different systems.
+    MavlinkFrame frame;
+    size_t pos = 0;
+    while (pos < len && MavlinkFrame::parse(&data[pos], len - pos, frame)) {
+        const uint8_t target = target_system_id(&data[pos], frame);
+
+        bool target_known = false;
+        if (target != 0) {
+            for (const auto& [fd, client] : _clients) {
+                if (client->system_ids.test(target)) {
+                    target_known = true;
+                    break;
+                }
+            }
+        }
+
+        for (auto& [fd, client] : _clients) {
+            if (!target_known || client->system_ids.test(target)) {
+                send_to_client(*client, &data[pos], frame.len);
+            }
+        }
+        pos += frame.len;
+    }
+
+    return pos == len;
+}
+
+void TcpServerConnection::send_to_client(Client& client, const uint8_t* data, size_t len)
+{
+    // Needs _mutex
+
+    if (client.failed) {
+        return;
+    }
+
+    if (client.write_buffer.size() + len > MAX_WRITE_BUFFER_LEN) {
+        LogWarn() << "TCP write buffer of " << client.ip << ":" << client.port
+                  << " full, dropping message";
+        return;
+    }
+
+    // Most of the time nothing is queued and it can go out right away,
+    // otherwise it needs to wait its turn.
+    client.write_buffer.insert(client.write_buffer.end(), data, data + len);
+    flush_write_buffer(client);
+}
+
+void TcpServerConnection::flush_write_buffer(Client& client)
+{
+    // Needs _mutex
+
+#if !defined(MSG_NOSIGNAL)
+    auto flags = 0;
+#else
+    auto flags = MSG_NOSIGNAL;
+#endif
+
+    size_t sent = 0;
+    while (sent < client.write_buffer.size()) {
+        const auto send_len = send(
+            client.fd,
+            reinterpret_cast<const char*>(client.write_buffer.data() + sent),
+            static_cast<int>(client.write_buffer.size() - sent),
+            flags);
+
+        if (send_len < 0) {
+            if (!last_error_would_block()) {
+                LogErr() << "send failure: " << GET_ERROR(errno);
+                // The reactor thread sees the socket as readable then and
+                // removes the client.
+                client.failed = true;
+                client.write_buffer.clear();
+#ifndef WINDOWS
+                shutdown(client.fd, SHUT_RDWR);
+#else
+                shutdown(client.fd, SD_BOTH);
+#endif
+                return;
+            }
+            break;
+        }
+        sent += static_cast<size_t>(send_len);
+    }
+
+    client.write_buffer.erase(client.write_buffer.begin(), client.write_buffer.begin() + sent);
+}
+
+uint8_t TcpServerConnection::target_system_id(const uint8_t* frame, const MavlinkFrame& header)
+{
+    const mavlink_msg_entry_t* meta = mavlink_get_msg_entry(header.msgid);
+    if (meta == nullptr || !(meta->flags & MAV_MSG_ENTRY_FLAG_HAVE_TARGET_SYSTEM)) {
+        return 0;
+    }
+
+    // The fields might be trimmed.
+    if (meta->target_system_ofs >= header.payload_len) {
+        return 0;
+    }
+
+    return frame[header.payload_offset + meta->target_system_ofs];
+}
+
+size_t TcpServerConnection::memory_usage()
+{
+    size_t bytes = Connection::memory_usage();
+    std::lock_guard<std::mutex> lock(_mutex);
+    for (const auto& [fd, client] : _clients) {
+        // The receiver is part of the client.
+        bytes += sizeof(Client) - sizeof(MavlinkReceiver) + client->receiver.memory_usage() +
+                 client->write_buffer.capacity();
+    }
+    return bytes;
+}
+
+} // namespace mavsdk
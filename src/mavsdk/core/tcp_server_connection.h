@@ -0,0 +1,93 @@
+#pragma once
+
+#include <atomic>
+#include <bitset>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "connection.h"
+
+namespace mavsdk {
+
+class IoReactor;
+struct MavlinkFrame;
+
+// Listens on a TCP port and accepts any number of clients, e.g. to offer a
+// feed to several ground stations without a router in between.
+//
+// Every client has its own parser and remembers which systems it has seen,
+// so messages targeted at a system only go to the clients it is behind,
+// everything else goes to all of them. All clients are served by one
+// IoReactor thread, the shared one if set, otherwise one of our own, which
+// is why this is not available where the reactor is not supported.
+class TcpServerConnection : public Connection {
+public:
+    explicit TcpServerConnection(
+        Connection::ReceiverCallback receiver_callback,
+        std::string local_ip,
+        int local_port,
+        ForwardingOption forwarding_option = ForwardingOption::ForwardingOff);
+    ~TcpServerConnection() override;
+    ConnectionResult start() override;
+    ConnectionResult stop() override;
+
+    bool send_message(const mavlink_message_t& message) override;
+    bool send_frames(const uint8_t* data, size_t len) override;
+    size_t memory_usage() override;
+
+    // The port listened on, useful if started with port 0.
+    int local_port() const { return _local_port_number; }
+
+    size_t num_clients();
+
+    // Non-copyable
+    TcpServerConnection(const TcpServerConnection&) = delete;
+    const TcpServerConnection& operator=(const TcpServerConnection&) = delete;
+
+    // Per client, so a client that doesn't keep up only loses its own
+    // messages.
+    static constexpr size_t MAX_WRITE_BUFFER_LEN = 256 * 1024;
+
+private:
+    struct Client {
+        int fd{-1};
+        std::string ip{};
+        int port{0};
+        // Only used on the reactor thread.
+        MavlinkReceiver receiver{};
+        // Only changed on the reactor thread, with _mutex held, so that
+        // thread can read it without.
+        std::bitset<256> system_ids{}; // Needs _mutex
+        // Whatever could not be sent right away, sent with the next frames
+        // or once the client sends something.
+        std::vector<uint8_t> write_buffer{}; // Needs _mutex
+        bool failed{false}; // Needs _mutex
+    };
+
+    ConnectionResult setup_port();
+    void accept_clients();
+    void receive_available(const std::shared_ptr<Client>& client);
+    void remove_client(const std::shared_ptr<Client>& client);
+    void learn_system_id(Client& client, uint8_t system_id);
+
+    void send_to_client(Client& client, const uint8_t* data, size_t len);
+    void flush_write_buffer(Client& client);
+
+    static uint8_t target_system_id(const uint8_t* frame, const MavlinkFrame& header);
+
+    std::string _local_ip;
+    int _local_port_number;
+    int _listen_fd{-1};
+
+    IoReactor* _reactor{nullptr};
+    std::unique_ptr<IoReactor> _own_io_reactor{};
+
+    std::mutex _mutex{};
+    std::unordered_map<int, std::shared_ptr<Client>> _clients{}; // Needs _mutex
+
+    std::atomic_bool _should_exit{false};
+};
+
+} // namespace mavsdk
@@ -0,0 +1,195 @@
+#include "tcp_server_connection.h"
+#include "io_reactor.h"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#if defined(LINUX) || defined(APPLE)
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+using namespace mavsdk;
+
+#if defined(LINUX) || defined(APPLE)
+
+namespace {
+
+mavlink_message_t make_heartbeat(uint8_t sysid)
+{
+    mavlink_message_t message;
+    mavlink_msg_heartbeat_pack(
+        sysid,
+        MAV_COMP_ID_AUTOPILOT1,
+        &message,
+        MAV_TYPE_GCS,
+        MAV_AUTOPILOT_INVALID,
+        0,
+        0,
+        MAV_STATE_ACTIVE);
+    return message;
+}
+
+mavlink_message_t make_command_for(uint8_t target_sysid)
+{
+    mavlink_message_t message;
+    mavlink_msg_command_long_pack(
+        1,
+        MAV_COMP_ID_AUTOPILOT1,
+        &message,
+        target_sysid,
+        0,
+        MAV_CMD_REQUEST_MESSAGE,
+        0,
+        0.f,
+        0.f,
+        0.f,
+        0.f,
+        0.f,
+        0.f,
+        0.f);
+    return message;
+}
+
+template<typename Predicate> bool wait_until(const Predicate& predicate)
+{
+    for (int i = 0; i < 100 && !predicate(); ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return predicate();
+}
+
+// A client of the server, like a ground station would be.
+struct Client {
+    explicit Client(int port)
+    {
+        fd = socket(AF_INET, SOCK_STREAM, 0);
+        struct sockaddr_in addr {};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = htons(port);
+        connected = connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0;
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+    }
+
+    ~Client() { close(fd); }
+
+    void send_message(const mavlink_message_t& message) const
+    {
+        uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
+        const auto len = mavlink_msg_to_send_buffer(buffer, &message);
+        ASSERT_EQ(send(fd, buffer, len, 0), static_cast<ssize_t>(len));
+    }
+
+    // The message IDs of everything received within a short while.
+    std::vector<uint32_t> receive_msgids()
+    {
+        std::vector<uint32_t> msgids;
+        for (int i = 0; i < 20; ++i) {
+            char buffer[1024];
+            const auto len = recv(fd, buffer, sizeof(buffer), 0);
+            if (len <= 0) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(5));
+                continue;
+            }
+            receiver.set_new_datagram(buffer, static_cast<unsigned>(len));
+            while (receiver.parse_message()) {
+                msgids.push_back(receiver.get_last_message().msgid);
+            }
+        }
+        return msgids;
+    }
+
+    int fd{-1};
+    bool connected{false};
+    MavlinkReceiver receiver{};
+};
+
+// Collects the system IDs of what the server receives.
+struct Received {
+    Connection::ReceiverCallback callback()
+    {
+        return [this](mavlink_message_t& message, Connection*) {
+            std::lock_guard<std::mutex> lock(mutex);
+            sysids.push_back(message.sysid);
+        };
+    }
+
+    size_t count()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return sysids.size();
+    }
+
+    std::mutex mutex;
+    std::vector<uint8_t> sysids; // Needs mutex
+};
+
+} // namespace
+
+TEST(TcpServerConnection, ServesSeveralClients)
+{
+    Received received;
+    TcpServerConnection server(received.callback(), "127.0.0.1", 0);
+    ASSERT_EQ(server.start(), ConnectionResult::Success);
+    ASSERT_NE(server.local_port(), 0);
+
+    Client client_2(server.local_port());
+    Client client_3(server.local_port());
+    ASSERT_TRUE(client_2.connected);
+    ASSERT_TRUE(client_3.connected);
+    ASSERT_TRUE(wait_until([&]() { return server.num_clients() == 2; }));
+
+    client_2.send_message(make_heartbeat(2));
+    client_3.send_message(make_heartbeat(3));
+    ASSERT_TRUE(wait_until([&]() { return received.count() == 2; }));
+
+    // Without a target, everyone gets it, otherwise only the client the
+    // target is behind.
+    EXPECT_TRUE(server.send_message(make_heartbeat(1)));
+    EXPECT_TRUE(server.send_message(make_command_for(3)));
+
+    EXPECT_EQ(client_2.receive_msgids(), (std::vector<uint32_t>{MAVLINK_MSG_ID_HEARTBEAT}));
+    EXPECT_EQ(
+        client_3.receive_msgids(),
+        (std::vector<uint32_t>{MAVLINK_MSG_ID_HEARTBEAT, MAVLINK_MSG_ID_COMMAND_LONG}));
+
+    // Nobody has seen system 4, so it goes to all.
+    EXPECT_TRUE(server.send_message(make_command_for(4)));
+    EXPECT_EQ(client_2.receive_msgids(), (std::vector<uint32_t>{MAVLINK_MSG_ID_COMMAND_LONG}));
+    EXPECT_EQ(client_3.receive_msgids(), (std::vector<uint32_t>{MAVLINK_MSG_ID_COMMAND_LONG}));
+
+    EXPECT_EQ(server.stop(), ConnectionResult::Success);
+}
+
+TEST(TcpServerConnection, RemovesDisconnectedClients)
+{
+    Received received;
+    IoReactor io_reactor;
+    TcpServerConnection server(received.callback(), "127.0.0.1", 0);
+    server.set_io_reactor(&io_reactor);
+    ASSERT_EQ(server.start(), ConnectionResult::Success);
+
+    {
+        Client client(server.local_port());
+        ASSERT_TRUE(client.connected);
+        ASSERT_TRUE(wait_until([&]() { return server.num_clients() == 1; }));
+    }
+    EXPECT_TRUE(wait_until([&]() { return server.num_clients() == 0; }));
+
+    // Once no one is there anymore, there is no one to send to.
+    EXPECT_FALSE(server.send_message(make_heartbeat(1)));
+
+    // Even with clients still connected, stopping leaves no callbacks behind.
+    Client client(server.local_port());
+    ASSERT_TRUE(wait_until([&]() { return server.num_clients() == 1; }));
+    EXPECT_EQ(server.stop(), ConnectionResult::Success);
+    EXPECT_EQ(server.num_clients(), 0u);
+}
+
+#endif
@@ -0,0 +1,137 @@
+#include "thread_config.h"
+#include "log.h"
+
+#if defined(LINUX) || defined(APPLE)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include <array>
+#include <cstring>
+#include <mutex>
+
+namespace mavsdk {
+
+namespace {
+
+constexpr size_t num_roles = static_cast<size_t>(ThreadRole::HttpLoader) + 1;
+
+std::mutex settings_mutex{};
+std::array<ThreadSettings, num_roles> settings_by_role{}; // Needs settings_mutex
+
+} // namespace
+
+void ThreadConfig::set(ThreadRole role, const ThreadSettings& settings)
+{
+    std::lock_guard<std::mutex> lock(settings_mutex);
+    settings_by_role[static_cast<size_t>(role)] = settings;
+}
+
+ThreadSettings ThreadConfig::get(ThreadRole role)
+{
+    std::lock_guard<std::mutex> lock(settings_mutex);
+    return settings_by_role[static_cast<size_t>(role)];
+}
+
+bool ThreadConfig::apply(ThreadRole role)
+{
+    const auto settings = get(role);
+
+    bool success = set_name(settings.name.empty() ? default_name(role) : settings.name);
+
+    if (!settings.cpus.empty()) {
+        success = set_cpus(settings.cpus) && success;
+    }
+
+    if (settings.realtime_priority != 0) {
+        success = set_realtime_priority(settings.realtime_priority) && success;
+    }
+
+    return success;
+}
+
+const char* ThreadConfig::default_name(ThreadRole role)
+{
+    switch (role) {
+        case ThreadRole::Work:
+            return "mavsdk_work";
+        case ThreadRole::UserCallbacks:
+            return "mavsdk_callback";
+        case ThreadRole::Receive:
+            return "mavsdk_recv";
+        case ThreadRole::Send:
+            return "mavsdk_send";
+        case ThreadRole::System:
+            return "mavsdk_system";
+        case ThreadRole::Setpoints:
+            return "mavsdk_setpoint";
+        case ThreadRole::HttpLoader:
+            return "mavsdk_http";
+    }
+    return "mavsdk";
+}
+
+bool ThreadConfig::set_name(const std::string& name)
+{
+#if defined(LINUX)
+    // Anything longer is refused rather than cut.
+    const auto result = pthread_setname_np(pthread_self(), name.substr(0, 15).c_str());
+#elif defined(APPLE)
+    const auto result = pthread_setname_np(name.c_str());
+#else
+    // Just a nicety, nothing to warn about.
+    const auto result = 0;
+    (void)name;
+#endif
+    if (result != 0) {
+        LogWarn() << "Could not set thread name " << name << ": " << strerror(result);
+        return false;
+    }
+    return true;
+}
+
+bool ThreadConfig::set_cpus(const std::vector<unsigned>& cpus)
+{
+#if defined(LINUX)
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    for (const auto cpu : cpus) {
+        if (cpu >= CPU_SETSIZE) {
+            LogWarn() << "CPU " << cpu << " out of range";
+            return false;
+        }
+        CPU_SET(cpu, &cpu_set);
+    }
+
+    const auto result = pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set);
+    if (result != 0) {
+        LogWarn() << "Could not set thread CPU affinity: " << strerror(result);
+        return false;
+    }
+    return true;
+#else
+    (void)cpus;
+    LogWarn() << "Thread CPU affinity not supported on this platform";
+    return false;
+#endif
+}
+
+bool ThreadConfig::set_realtime_priority(int priority)
+{
+#if defined(LINUX) || defined(APPLE)
+    struct sched_param param {};
+    param.sched_priority = priority;
+    const auto result = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+    if (result != 0) {
+        LogWarn() << "Could not set real-time priority " << priority << ": " << strerror(result);
+        return false;
+    }
+    return true;
+#else
+    (void)priority;
+    LogWarn() << "Thread real-time priority not supported on this platform";
+    return false;
+#endif
+}
+
+} // namespace mavsdk
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "thread_settings.h"
+
+namespace mavsdk {
+
+// The settings of the threads MAVSDK starts, by role.
+//
+// They are the same for the whole process, as the threads are started deep
+// down in connections and systems which don't know the Mavsdk instance, and
+// CPUs and priorities are shared by all instances anyway. Every thread
+// applies the settings of its role first thing, so changes only take effect
+// for threads started afterwards.
+class ThreadConfig {
+public:
+    static void set(ThreadRole role, const ThreadSettings& settings);
+    static ThreadSettings get(ThreadRole role);
+
+    // Names the calling thread and applies the settings of the role to it.
+    // Returns false if something could not be applied, which is logged.
+    static bool apply(ThreadRole role);
+
+    static const char* default_name(ThreadRole role);
+
+private:
+    static bool set_name(const std::string& name);
+    static bool set_cpus(const std::vector<unsigned>& cpus);
+    static bool set_realtime_priority(int priority);
+};
+
+} // namespace mavsdk
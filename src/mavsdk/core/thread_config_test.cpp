@@ -0,0 +1,109 @@
+#include "thread_config.h"
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+
+#if defined(LINUX)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+using namespace mavsdk;
+
+TEST(ThreadConfig, KeepsSettingsPerRole)
+{
+    ThreadSettings settings;
+    settings.name = "recv_test";
+    settings.cpus = {0};
+    settings.realtime_priority = 10;
+    ThreadConfig::set(ThreadRole::Receive, settings);
+
+    EXPECT_EQ(ThreadConfig::get(ThreadRole::Receive).name, "recv_test");
+    EXPECT_EQ(ThreadConfig::get(ThreadRole::Receive).cpus, std::vector<unsigned>{0});
+    EXPECT_EQ(ThreadConfig::get(ThreadRole::Receive).realtime_priority, 10);
+    EXPECT_TRUE(ThreadConfig::get(ThreadRole::Work).name.empty());
+
+    ThreadConfig::set(ThreadRole::Receive, {});
+    EXPECT_TRUE(ThreadConfig::get(ThreadRole::Receive).name.empty());
+}
+
+#if defined(LINUX)
+
+namespace {
+
+std::string thread_name()
+{
+    char name[16]{};
+    pthread_getname_np(pthread_self(), name, sizeof(name));
+    return name;
+}
+
+} // namespace
+
+TEST(ThreadConfig, NamesThreadsByRole)
+{
+    std::string name;
+    std::thread([&]() {
+        EXPECT_TRUE(ThreadConfig::apply(ThreadRole::System));
+        name = thread_name();
+    }).join();
+    EXPECT_EQ(name, ThreadConfig::default_name(ThreadRole::System));
+
+    ThreadSettings settings;
+    settings.name = "a_name_which_is_too_long";
+    ThreadConfig::set(ThreadRole::System, settings);
+    std::thread([&]() {
+        EXPECT_TRUE(ThreadConfig::apply(ThreadRole::System));
+        name = thread_name();
+    }).join();
+    // Cut rather than refused.
+    EXPECT_EQ(name, "a_name_which_is");
+
+    ThreadConfig::set(ThreadRole::System, {});
+}
+
+TEST(ThreadConfig, PinsThreadsToCpus)
+{
+    ThreadSettings settings;
+    settings.cpus = {0};
+    ThreadConfig::set(ThreadRole::Send, settings);
+
+    bool pinned = false;
+    std::thread([&]() {
+        EXPECT_TRUE(ThreadConfig::apply(ThreadRole::Send));
+        cpu_set_t cpu_set;
+        CPU_ZERO(&cpu_set);
+        pthread_getaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set);
+        pinned = CPU_COUNT(&cpu_set) == 1 && CPU_ISSET(0, &cpu_set);
+    }).join();
+    EXPECT_TRUE(pinned);
+
+    // Out of range, so nothing changes.
+    settings.cpus = {CPU_SETSIZE};
+    ThreadConfig::set(ThreadRole::Send, settings);
+    std::thread([&]() { EXPECT_FALSE(ThreadConfig::apply(ThreadRole::Send)); }).join();
+
+    ThreadConfig::set(ThreadRole::Send, {});
+}
+
+TEST(ThreadConfig, SetsRealtimePriorityIfAllowed)
+{
+    ThreadSettings settings;
+    settings.realtime_priority = 1;
+    ThreadConfig::set(ThreadRole::Setpoints, settings);
+
+    std::thread([&]() {
+        // Without the permission, this fails and the thread just keeps going.
+        if (ThreadConfig::apply(ThreadRole::Setpoints)) {
+            int policy = 0;
+            struct sched_param param {};
+            pthread_getschedparam(pthread_self(), &policy, &param);
+            EXPECT_EQ(policy, SCHED_FIFO);
+            EXPECT_EQ(param.sched_priority, 1);
+        }
+    }).join();
+
+    ThreadConfig::set(ThreadRole::Setpoints, {});
+}
+
+#endif
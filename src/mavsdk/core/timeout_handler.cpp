@@ -1,8 +1,12 @@
 #include "timeout_handler.h"
+#include "trace.h"
 
 namespace mavsdk {
 
-TimeoutHandler::TimeoutHandler(Time& time) : _time(time) {}
+TimeoutHandler::TimeoutHandler(Time& time) :
+    _time(time),
+    _wheel(TimerWheel::tick_at(time.steady_time()))
+{}
 
 void TimeoutHandler::add(std::function<void()> callback, double duration_s, void** cookie)
 {
@@ -10,17 +14,21 @@ void TimeoutHandler::add(std::function<void()> callback, double duration_s, void
     new_timeout->callback = callback;
     new_timeout->time = _time.steady_time_in_future(duration_s);
     new_timeout->duration_s = duration_s;
+    new_timeout->node.data = new_timeout.get();
 
     void* new_cookie = static_cast<void*>(new_timeout.get());
 
     {
         std::lock_guard<std::mutex> lock(_timeouts_mutex);
         _timeouts.insert(std::pair<void*, std::shared_ptr<Timeout>>(new_cookie, new_timeout));
+        _wheel.schedule(new_timeout->node, TimerWheel::tick_after(new_timeout->time));
     }
 
     if (cookie != nullptr) {
         *cookie = new_cookie;
     }
+
+    notify();
 }
 
 void TimeoutHandler::refresh(const void* cookie)
@@ -33,8 +41,11 @@ void TimeoutHandler::refresh(const void* cookie)
 
     auto it = _timeouts.find(const_cast<void*>(cookie));
     if (it != _timeouts.end()) {
-        auto future_time = _time.steady_time_in_future(it->second->duration_s);
+        // This happens for every heartbeat, and is not precise to the
+        // millisecond anyway.
+        auto future_time = _time.coarse_steady_time_in_future(it->second->duration_s);
         it->second->time = future_time;
+        _wheel.schedule(it->second->node, TimerWheel::tick_after(future_time));
     }
 }
 
@@ -48,44 +59,68 @@ void TimeoutHandler::remove(const void* cookie)
 
     auto it = _timeouts.find(const_cast<void*>(cookie));
     if (it != _timeouts.end()) {
-        _timeouts.erase(const_cast<void*>(cookie));
-        _iterator_invalidated = true;
+        _wheel.cancel(it->second->node);
+        _timeouts.erase(it);
     }
 }
 
 void TimeoutHandler::run_once()
 {
-    _timeouts_mutex.lock();
+    std::unique_lock<std::mutex> lock(_timeouts_mutex);
+
+    _wheel.advance(TimerWheel::tick_at(_time.steady_time()));
 
-    auto now = _time.steady_time();
+    // We take the expired ones off one by one, so that anything removed or
+    // refreshed while we were calling back is not called anymore.
+    while (auto* node = _wheel.pop_expired()) {
+        auto it = _timeouts.find(node->data);
+        if (it == _timeouts.end()) {
+            continue;
+        }
 
-    for (auto it = _timeouts.begin(); it != _timeouts.end(); /* no ++it */) {
-        // If time is passed, call timeout callback.
-        if (it->second->time < now) {
-            if (it->second->callback) {
-                // Get a copy for the callback because we will remove it.
-                std::function<void()> callback = it->second->callback;
+        // Get a copy for the callback because we will remove it.
+        std::function<void()> callback = it->second->callback;
 
-                // Self-destruct before calling to avoid locking issues.
-                _timeouts.erase(it++);
+        // Self-destruct before calling to avoid locking issues.
+        _timeouts.erase(it);
 
-                // Unlock while we callback because it might in turn want to add timeouts.
-                _timeouts_mutex.unlock();
+        if (callback) {
+            // Unlock while we callback because it might in turn want to add timeouts.
+            lock.unlock();
+            {
+                TraceScope trace("timer", "timeout");
                 callback();
-                _timeouts_mutex.lock();
             }
-
-        } else {
-            ++it;
+            lock.lock();
         }
+    }
+}
 
-        // We start over if anyone has messed with this while we called the callback.
-        if (_iterator_invalidated) {
-            _iterator_invalidated = false;
-            it = _timeouts.begin();
-        }
+std::optional<double> TimeoutHandler::next_run_in_s()
+{
+    std::lock_guard<std::mutex> lock(_timeouts_mutex);
+
+    const auto next_tick = _wheel.next_expiry_ms();
+    if (!next_tick) {
+        return {};
+    }
+
+    const auto now_tick = TimerWheel::tick_at(_time.steady_time());
+    return *next_tick > now_tick ? double(*next_tick - now_tick) * 1e-3 : 0.0;
+}
+
+void TimeoutHandler::set_notifier(std::function<void()> notifier)
+{
+    std::lock_guard<std::mutex> lock(_notifier_mutex);
+    _notifier = std::move(notifier);
+}
+
+void TimeoutHandler::notify()
+{
+    std::lock_guard<std::mutex> lock(_notifier_mutex);
+    if (_notifier) {
+        _notifier();
     }
-    _timeouts_mutex.unlock();
 }
 
 } // namespace mavsdk
@@ -3,8 +3,10 @@
 #include <mutex>
 #include <memory>
 #include <functional>
+#include <optional>
 #include <unordered_map>
 #include "mavsdk_time.h"
+#include "timer_wheel.h"
 
 namespace mavsdk {
 
@@ -25,18 +27,31 @@ public:
 
     void run_once();
 
+    // Time until the next timeout is due, empty if there are none.
+    std::optional<double> next_run_in_s();
+
+    // Called (without lock held) whenever a timeout was added, so that the
+    // thread calling run_once() can re-evaluate how long to sleep.
+    void set_notifier(std::function<void()> notifier);
+
 private:
     struct Timeout {
         std::function<void()> callback{};
         SteadyTimePoint time{};
         double duration_s{0.0};
+        TimerWheel::Node node{};
     };
 
+    void notify();
+
+    Time& _time;
+
     std::unordered_map<void*, std::shared_ptr<Timeout>> _timeouts{};
+    TimerWheel _wheel;
     std::mutex _timeouts_mutex{};
-    bool _iterator_invalidated{false};
 
-    Time& _time;
+    std::function<void()> _notifier{};
+    std::mutex _notifier_mutex{};
 };
 
 } // namespace mavsdk
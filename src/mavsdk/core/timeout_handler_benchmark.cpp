@@ -0,0 +1,51 @@
+#include "timeout_handler.h"
+#include <benchmark/benchmark.h>
+#include <vector>
+
+using namespace mavsdk;
+
+static void BM_TimeoutHandlerRunOnce(benchmark::State& state)
+{
+    Time time;
+    TimeoutHandler timeout_handler(time);
+
+    // Pending timeouts, none of them due, as is the case most of the time.
+    std::vector<void*> cookies(static_cast<size_t>(state.range(0)));
+    for (auto& cookie : cookies) {
+        timeout_handler.add([]() {}, 100.0, &cookie);
+    }
+
+    for (auto _ : state) {
+        timeout_handler.run_once();
+    }
+
+    for (auto* cookie : cookies) {
+        timeout_handler.remove(cookie);
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_TimeoutHandlerRunOnce)->Arg(10)->Arg(1000);
+
+static void BM_TimeoutHandlerRefresh(benchmark::State& state)
+{
+    Time time;
+    TimeoutHandler timeout_handler(time);
+
+    std::vector<void*> cookies(static_cast<size_t>(state.range(0)));
+    for (auto& cookie : cookies) {
+        timeout_handler.add([]() {}, 100.0, &cookie);
+    }
+
+    size_t i = 0;
+    for (auto _ : state) {
+        timeout_handler.refresh(cookies[i++ % cookies.size()]);
+    }
+
+    for (auto* cookie : cookies) {
+        timeout_handler.remove(cookie);
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_TimeoutHandlerRefresh)->Arg(10)->Arg(1000);
@@ -0,0 +1,161 @@
+#include "timer_wheel.h"
+
+#include <algorithm>
+
+namespace mavsdk {
+
+TimerWheel::TimerWheel(uint64_t now_ms) : _now_ms(now_ms) {}
+
+void TimerWheel::schedule(Node& node, uint64_t expiry_ms)
+{
+    if (node.is_scheduled()) {
+        unlink(node);
+    } else {
+        ++_num_nodes;
+    }
+
+    node.expiry_ms = expiry_ms;
+    place(node);
+}
+
+void TimerWheel::cancel(Node& node)
+{
+    if (!node.is_scheduled()) {
+        return;
+    }
+
+    unlink(node);
+    --_num_nodes;
+}
+
+void TimerWheel::advance(uint64_t now_ms)
+{
+    if (_num_nodes == 0) {
+        // Nothing to move around, so we can just skip ahead.
+        _now_ms = std::max(_now_ms, now_ms);
+        return;
+    }
+
+    while (_now_ms < now_ms) {
+        ++_now_ms;
+
+        // Whenever a lower level wraps around, the next slot of the level
+        // above needs to be distributed. We start at the highest level so
+        // that nodes can trickle all the way down in one go.
+        unsigned level = 0;
+        while (level + 1 < num_levels &&
+               (_now_ms & ((uint64_t(1) << (bits_per_level * (level + 1))) - 1)) == 0) {
+            ++level;
+        }
+        for (; level > 0; --level) {
+            cascade(level);
+        }
+
+        auto& slot = _levels[0][_now_ms & slot_mask];
+        while (!slot.empty()) {
+            Node& node = *slot.head.next;
+            unlink(node);
+            link(_expired, node);
+        }
+    }
+}
+
+TimerWheel::Node* TimerWheel::pop_expired()
+{
+    if (_expired.empty()) {
+        return nullptr;
+    }
+
+    Node* node = _expired.head.next;
+    unlink(*node);
+    --_num_nodes;
+    return node;
+}
+
+std::optional<uint64_t> TimerWheel::next_expiry_ms() const
+{
+    if (_num_nodes == 0) {
+        return {};
+    }
+
+    if (!_expired.empty()) {
+        return _now_ms;
+    }
+
+    std::optional<uint64_t> earliest{};
+
+    for (unsigned level = 0; level < num_levels; ++level) {
+        const unsigned shift = bits_per_level * level;
+        const uint64_t current_block = _now_ms >> shift;
+
+        // Slots further ahead only contain later nodes, so the first one
+        // that is not empty has the earliest nodes of this level.
+        for (uint64_t offset = 1; offset <= slots_per_level; ++offset) {
+            const auto& slot = _levels[level][(current_block + offset) & slot_mask];
+            if (slot.empty()) {
+                continue;
+            }
+
+            for (const Node* node = slot.head.next; node != &slot.head; node = node->next) {
+                if (!earliest || node->expiry_ms < *earliest) {
+                    earliest = node->expiry_ms;
+                }
+            }
+            break;
+        }
+    }
+
+    return earliest;
+}
+
+void TimerWheel::link(List& list, Node& node)
+{
+    node.prev = list.head.prev;
+    node.next = &list.head;
+    list.head.prev->next = &node;
+    list.head.prev = &node;
+}
+
+void TimerWheel::unlink(Node& node)
+{
+    node.prev->next = node.next;
+    node.next->prev = node.prev;
+    node.prev = nullptr;
+    node.next = nullptr;
+}
+
+void TimerWheel::place(Node& node)
+{
+    if (node.expiry_ms <= _now_ms) {
+        link(_expired, node);
+        return;
+    }
+
+    const uint64_t delta = node.expiry_ms - _now_ms;
+
+    for (unsigned level = 0; level < num_levels; ++level) {
+        const unsigned shift = bits_per_level * level;
+        if ((delta >> (shift + bits_per_level)) == 0) {
+            link(_levels[level][(node.expiry_ms >> shift) & slot_mask], node);
+            return;
+        }
+    }
+
+    // Too far out for the wheel. We park it in the last slot of the highest
+    // level from where it gets placed again once that slot comes up.
+    const unsigned shift = bits_per_level * (num_levels - 1);
+    const uint64_t max_delta = (uint64_t(1) << (bits_per_level * num_levels)) - 1;
+    link(_levels[num_levels - 1][((_now_ms + max_delta) >> shift) & slot_mask], node);
+}
+
+void TimerWheel::cascade(unsigned level)
+{
+    auto& slot = _levels[level][(_now_ms >> (bits_per_level * level)) & slot_mask];
+    while (!slot.empty()) {
+        Node& node = *slot.head.next;
+        unlink(node);
+        place(node);
+    }
+}
+
+} // namespace mavsdk
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include "mavsdk_time.h"
+
+namespace mavsdk {
+
+// Hierarchical timing wheel with millisecond ticks.
+//
+// Adding, moving and removing a timer is O(1). Advancing the wheel only
+// touches the slots for the ticks that have passed, and cascades timers of
+// the coarser levels down as their time gets closer.
+//
+// The wheel does not own the nodes and is not thread-safe, the owner needs
+// to take care of both.
+class TimerWheel {
+public:
+    struct Node {
+        uint64_t expiry_ms{0};
+        void* data{nullptr};
+
+        bool is_scheduled() const { return next != nullptr; }
+
+    private:
+        friend class TimerWheel;
+        Node* prev{nullptr};
+        Node* next{nullptr};
+    };
+
+    explicit TimerWheel(uint64_t now_ms);
+    ~TimerWheel() = default;
+
+    TimerWheel(const TimerWheel&) = delete;
+    TimerWheel(TimerWheel&&) = delete;
+    TimerWheel& operator=(const TimerWheel&) = delete;
+    TimerWheel& operator=(TimerWheel&&) = delete;
+
+    // Schedules the node, or re-schedules it if it is already scheduled.
+    void schedule(Node& node, uint64_t expiry_ms);
+    void cancel(Node& node);
+
+    // Moves all nodes that are due by now_ms to the expired list.
+    void advance(uint64_t now_ms);
+
+    // Takes the next node off the expired list, or returns nullptr.
+    Node* pop_expired();
+
+    // Earliest time at which a node can become due. This is exact for
+    // timers less than 64 ms away and a lower bound for timers further out.
+    std::optional<uint64_t> next_expiry_ms() const;
+
+    bool empty() const { return _num_nodes == 0; }
+
+    // The tick a time point falls into, and the first tick that is
+    // completely after it, which is when a timer for it should fire.
+    static uint64_t tick_at(const SteadyTimePoint& time)
+    {
+        return static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::milliseconds>(time.time_since_epoch())
+                .count());
+    }
+    static uint64_t tick_after(const SteadyTimePoint& time) { return tick_at(time) + 1; }
+
+private:
+    static constexpr unsigned bits_per_level = 6;
+    static constexpr unsigned slots_per_level = 1 << bits_per_level;
+    static constexpr unsigned slot_mask = slots_per_level - 1;
+    static constexpr unsigned num_levels = 4;
+
+    struct List {
+        List() { head.prev = head.next = &head; }
+        List(const List&) = delete;
+        List& operator=(const List&) = delete;
+
+        bool empty() const { return head.next == &head; }
+
+        Node head{};
+    };
+
+    static void link(List& list, Node& node);
+    static void unlink(Node& node);
+
+    void place(Node& node);
+    void cascade(unsigned level);
+
+    std::array<std::array<List, slots_per_level>, num_levels> _levels{};
+    List _expired{};
+    uint64_t _now_ms;
+    unsigned _num_nodes{0};
+};
+
+} // namespace mavsdk
@@ -0,0 +1,125 @@
+#include "timer_wheel.h"
+#include <gtest/gtest.h>
+#include <vector>
+
+using namespace mavsdk;
+
+namespace {
+
+std::vector<TimerWheel::Node*> pop_all(TimerWheel& wheel)
+{
+    std::vector<TimerWheel::Node*> nodes;
+    while (auto* node = wheel.pop_expired()) {
+        nodes.push_back(node);
+    }
+    return nodes;
+}
+
+} // namespace
+
+TEST(TimerWheel, ExpiresOnTick)
+{
+    TimerWheel wheel(1000);
+
+    TimerWheel::Node node;
+    wheel.schedule(node, 1010);
+    EXPECT_TRUE(node.is_scheduled());
+
+    wheel.advance(1009);
+    EXPECT_EQ(wheel.pop_expired(), nullptr);
+
+    wheel.advance(1010);
+    EXPECT_EQ(wheel.pop_expired(), &node);
+    EXPECT_FALSE(node.is_scheduled());
+    EXPECT_TRUE(wheel.empty());
+}
+
+TEST(TimerWheel, PastIsExpiredStraightaway)
+{
+    TimerWheel wheel(1000);
+
+    TimerWheel::Node node;
+    wheel.schedule(node, 900);
+    EXPECT_EQ(wheel.next_expiry_ms(), 1000u);
+    EXPECT_EQ(wheel.pop_expired(), &node);
+}
+
+TEST(TimerWheel, Cancel)
+{
+    TimerWheel wheel(0);
+
+    TimerWheel::Node node;
+    wheel.schedule(node, 5);
+    wheel.cancel(node);
+    EXPECT_FALSE(node.is_scheduled());
+    EXPECT_TRUE(wheel.empty());
+
+    wheel.advance(10);
+    EXPECT_EQ(wheel.pop_expired(), nullptr);
+
+    // Cancelling twice is fine.
+    wheel.cancel(node);
+}
+
+TEST(TimerWheel, Reschedule)
+{
+    TimerWheel wheel(0);
+
+    TimerWheel::Node node;
+    wheel.schedule(node, 5);
+    wheel.schedule(node, 500);
+
+    wheel.advance(499);
+    EXPECT_EQ(wheel.pop_expired(), nullptr);
+    wheel.advance(500);
+    EXPECT_EQ(wheel.pop_expired(), &node);
+}
+
+TEST(TimerWheel, CascadesFromAllLevels)
+{
+    const uint64_t start = 12345;
+    TimerWheel wheel(start);
+
+    // Spread over all levels, including beyond what the wheel covers.
+    const std::vector<uint64_t> delays{1, 63, 64, 65, 100, 4095, 4096, 4097, 300000, 20000000};
+    std::vector<TimerWheel::Node> nodes(delays.size());
+    for (size_t i = 0; i < delays.size(); ++i) {
+        wheel.schedule(nodes[i], start + delays[i]);
+    }
+
+    for (size_t i = 0; i < delays.size(); ++i) {
+        EXPECT_EQ(wheel.next_expiry_ms(), start + delays[i]);
+
+        wheel.advance(start + delays[i] - 1);
+        EXPECT_TRUE(pop_all(wheel).empty());
+
+        wheel.advance(start + delays[i]);
+        auto expired = pop_all(wheel);
+        ASSERT_EQ(expired.size(), 1u);
+        EXPECT_EQ(expired[0], &nodes[i]);
+    }
+
+    EXPECT_TRUE(wheel.empty());
+    EXPECT_FALSE(wheel.next_expiry_ms().has_value());
+}
+
+TEST(TimerWheel, AdvanceInBigSteps)
+{
+    TimerWheel wheel(0);
+
+    std::vector<TimerWheel::Node> nodes(200);
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        wheel.schedule(nodes[i], 10 * (i + 1));
+    }
+
+    size_t num_expired = 0;
+    for (uint64_t now = 0; now <= 2000; now += 250) {
+        wheel.advance(now);
+        for (auto* node : pop_all(wheel)) {
+            EXPECT_LE(node->expiry_ms, now);
+            ++num_expired;
+        }
+    }
+
+    EXPECT_EQ(num_expired, nodes.size());
+}
@@ -28,36 +28,54 @@ void Timesync::do_work()
         return;
     }
 
-    if (_system_impl.get_time().elapsed_since_s(_last_time) >= TIMESYNC_SEND_INTERVAL_S) {
+    if (_system_impl.get_time().elapsed_since_s(_last_time) >= send_interval_s()) {
         if (_system_impl.is_connected()) {
-            uint64_t now_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
-                                  _system_impl.get_autopilot_time().now().time_since_epoch())
-                                  .count();
-            send_timesync(0, now_ns);
+            send_timesync(0, static_cast<uint64_t>(local_time_ns()));
         } else {
+            std::lock_guard<std::mutex> lock(_mutex);
             _autopilot_timesync_acquired = false;
+            _filter.reset();
         }
         _last_time = _system_impl.get_time().steady_time();
     }
 }
 
+double Timesync::next_work_in_s()
+{
+    if (!_is_enabled) {
+        return TIMESYNC_SEND_INTERVAL_S;
+    }
+
+    return send_interval_s() - _system_impl.get_time().elapsed_since_s(_last_time);
+}
+
+bool Timesync::is_synced() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _autopilot_timesync_acquired;
+}
+
+double Timesync::send_interval_s() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _filter.is_converged() ? TIMESYNC_SEND_INTERVAL_S : FAST_SEND_INTERVAL_S;
+}
+
 void Timesync::process_timesync(const mavlink_message_t& message)
 {
     mavlink_timesync_t timesync{};
 
     mavlink_msg_timesync_decode(&message, &timesync);
 
-    int64_t now_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
-                         _system_impl.get_autopilot_time().now().time_since_epoch())
-                         .count();
-
-    if (timesync.tc1 == 0 && _autopilot_timesync_acquired) {
+    if (timesync.tc1 == 0 && is_synced()) {
         // Send synced time to remote system
+        int64_t now_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                             _system_impl.get_autopilot_time().now().time_since_epoch())
+                             .count();
         send_timesync(now_ns, timesync.ts1);
     } else if (timesync.tc1 > 0) {
-        // Time offset between this system and the remote system is calculated assuming RTT for
-        // the timesync packet is roughly equal both ways.
-        set_timesync_offset((timesync.tc1 * 2 - (timesync.ts1 + now_ns)) / 2, timesync.ts1);
+        // Answer to our request which we sent with our local time.
+        add_sample(timesync.ts1, timesync.tc1);
     }
 }
 
@@ -76,20 +94,19 @@ void Timesync::send_timesync(uint64_t tc1, uint64_t ts1)
     _system_impl.send_message(message);
 }
 
-void Timesync::set_timesync_offset(int64_t offset_ns, uint64_t start_transfer_local_time_ns)
+void Timesync::add_sample(int64_t local_sent_ns, int64_t remote_ns)
 {
-    uint64_t now_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
-                          _system_impl.get_autopilot_time().now().time_since_epoch())
-                          .count();
+    const int64_t now_ns = local_time_ns();
 
-    // Calculate the round trip time (RTT) it took the timesync packet to bounce back to us from
-    // remote system
-    uint64_t rtt_ns = now_ns - start_transfer_local_time_ns;
-
-    if (rtt_ns < MAX_RTT_SAMPLE_MS * 1000000ULL) { // Only use samples with low RTT
+    std::lock_guard<std::mutex> lock(_mutex);
 
+    if (_filter.add_sample(local_sent_ns, remote_ns, now_ns)) {
         // Save time offset for other components to use
-        _system_impl.get_autopilot_time().shift_time_by(std::chrono::nanoseconds(offset_ns));
+        const auto reference_ns = std::chrono::nanoseconds(_filter.reference_ns());
+        _system_impl.get_autopilot_time().set_offset(
+            std::chrono::nanoseconds(_filter.offset_ns(reference_ns.count()).value()),
+            SystemTimePoint(std::chrono::duration_cast<SystemTimePoint::duration>(reference_ns)),
+            _filter.skew());
         _autopilot_timesync_acquired = true;
 
         // Reset high RTT count after filter update
@@ -100,8 +117,8 @@ void Timesync::set_timesync_offset(int64_t offset_ns, uint64_t start_transfer_lo
 
         if (_high_rtt_count > MAX_CONS_HIGH_RTT) {
             // Issue a warning to the user if the RTT is constantly high
-            LogWarn() << "RTT too high for timesync: " << static_cast<double>(rtt_ns) / 1000000.0
-                      << " ms.";
+            LogWarn() << "RTT too high for timesync: "
+                      << static_cast<double>(now_ns - local_sent_ns) / 1000000.0 << " ms.";
 
             // Reset counter
             _high_rtt_count = 0;
@@ -109,4 +126,11 @@ void Timesync::set_timesync_offset(int64_t offset_ns, uint64_t start_transfer_lo
     }
 }
 
+int64_t Timesync::local_time_ns()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               _system_impl.get_time().system_time().time_since_epoch())
+        .count();
+}
+
 } // namespace mavsdk
@@ -2,6 +2,8 @@
 
 #include "mavsdk_time.h"
 #include "mavlink_include.h"
+#include "timesync_filter.h"
+#include <mutex>
 
 namespace mavsdk {
 
@@ -15,6 +17,12 @@ public:
     void enable();
     void do_work();
 
+    // Seconds until do_work() has something to do again.
+    double next_work_in_s();
+
+    // Whether the autopilot time is known, see SystemImpl::get_autopilot_time().
+    bool is_synced() const;
+
     Timesync(const Timesync&) = delete;
     Timesync& operator=(const Timesync&) = delete;
 
@@ -23,15 +31,21 @@ private:
 
     void process_timesync(const mavlink_message_t& message);
     void send_timesync(uint64_t tc1, uint64_t ts1);
-    void set_timesync_offset(int64_t offset_ns, uint64_t start_transfer_local_time_ns);
+    void add_sample(int64_t local_sent_ns, int64_t remote_ns);
+    double send_interval_s() const;
+    int64_t local_time_ns();
 
-    static constexpr double TIMESYNC_SEND_INTERVAL_S = 5.0;
+    // Fast until the estimate has converged, then only to follow the drift.
+    static constexpr double FAST_SEND_INTERVAL_S = 0.5;
+    static constexpr double TIMESYNC_SEND_INTERVAL_S = 10.0;
     SteadyTimePoint _last_time{};
 
     static constexpr uint64_t MAX_CONS_HIGH_RTT = 5;
-    static constexpr uint64_t MAX_RTT_SAMPLE_MS = 10;
-    uint64_t _high_rtt_count{};
-    bool _autopilot_timesync_acquired{false};
+
+    mutable std::mutex _mutex{};
+    TimesyncFilter _filter{}; // Needs _mutex
+    uint64_t _high_rtt_count{}; // Needs _mutex
+    bool _autopilot_timesync_acquired{false}; // Needs _mutex
     bool _is_enabled{false};
 };
 } // namespace mavsdk
@@ -0,0 +1,112 @@
+#include "timesync_filter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+namespace mavsdk {
+
+bool TimesyncFilter::add_sample(
+    int64_t local_sent_ns, int64_t remote_ns, int64_t local_received_ns)
+{
+    const int64_t rtt_ns = local_received_ns - local_sent_ns;
+    if (rtt_ns < 0 || rtt_ns > max_rtt_ns) {
+        // Not an answer to one of our requests.
+        ++_rejected_samples;
+        return false;
+    }
+
+    _recent_rtts_ns.push_back(rtt_ns);
+    if (_recent_rtts_ns.size() > window_size) {
+        _recent_rtts_ns.pop_front();
+    }
+
+    if (!rtt_acceptable(rtt_ns)) {
+        ++_rejected_samples;
+        return false;
+    }
+
+    // Assuming it took as long both ways.
+    const int64_t local_ns = local_sent_ns + rtt_ns / 2;
+    const int64_t offset_ns = remote_ns - local_ns;
+
+    if (is_converged()) {
+        const int64_t predicted_ns = this->offset_ns(local_ns).value();
+        if (std::llabs(offset_ns - predicted_ns) > rtt_ns / 2 + rtt_tolerance_min_ns) {
+            if (++_inconsistent_samples < max_inconsistent_samples) {
+                ++_rejected_samples;
+                return false;
+            }
+            reset();
+            _recent_rtts_ns.push_back(rtt_ns);
+        }
+    }
+    _inconsistent_samples = 0;
+
+    _samples.push_back(Sample{local_ns, offset_ns});
+    if (_samples.size() > window_size) {
+        _samples.pop_front();
+    }
+    fit();
+    return true;
+}
+
+std::optional<int64_t> TimesyncFilter::offset_ns(int64_t local_ns) const
+{
+    if (_samples.empty()) {
+        return std::nullopt;
+    }
+    return _reference_offset_ns +
+           std::llround(_skew * static_cast<double>(local_ns - _reference_ns));
+}
+
+void TimesyncFilter::reset()
+{
+    _recent_rtts_ns.clear();
+    _samples.clear();
+    _reference_ns = 0;
+    _reference_offset_ns = 0;
+    _skew = 0.0;
+    _inconsistent_samples = 0;
+}
+
+bool TimesyncFilter::rtt_acceptable(int64_t rtt_ns) const
+{
+    const int64_t min_rtt_ns = *std::min_element(_recent_rtts_ns.begin(), _recent_rtts_ns.end());
+    const int64_t threshold_ns = std::max(
+        static_cast<int64_t>(static_cast<double>(min_rtt_ns) * rtt_tolerance_factor),
+        min_rtt_ns + rtt_tolerance_min_ns);
+    return rtt_ns <= threshold_ns;
+}
+
+void TimesyncFilter::fit()
+{
+    // Relative to the newest sample to keep the numbers small.
+    const Sample& newest = _samples.back();
+    _reference_ns = newest.local_ns;
+
+    const double n = static_cast<double>(_samples.size());
+    double mean_x_s = 0.0;
+    double mean_y_ns = 0.0;
+    for (const auto& sample : _samples) {
+        mean_x_s += static_cast<double>(sample.local_ns - newest.local_ns) * 1e-9;
+        mean_y_ns += static_cast<double>(sample.offset_ns - newest.offset_ns);
+    }
+    mean_x_s /= n;
+    mean_y_ns /= n;
+
+    double sxx = 0.0;
+    double sxy = 0.0;
+    for (const auto& sample : _samples) {
+        const double dx = static_cast<double>(sample.local_ns - newest.local_ns) * 1e-9 - mean_x_s;
+        const double dy = static_cast<double>(sample.offset_ns - newest.offset_ns) - mean_y_ns;
+        sxx += dx * dx;
+        sxy += dx * dy;
+    }
+
+    // The slope is in ns per s.
+    _skew = (sxx > 0.0) ? std::clamp(sxy / sxx * 1e-9, -max_skew, max_skew) : 0.0;
+    _reference_offset_ns = newest.offset_ns + std::llround(mean_y_ns - _skew * 1e9 * mean_x_s);
+}
+
+} // namespace mavsdk
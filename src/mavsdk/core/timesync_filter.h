@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <optional>
+
+namespace mavsdk {
+
+// Estimates the offset and the drift (skew) of a remote clock relative to
+// ours from TIMESYNC round trips.
+//
+// A round trip only bounds the offset to within half its round trip time,
+// and on busy links some round trips are much slower than others, mostly in
+// one direction. So only samples close to the fastest recent round trip are
+// used. The offset is then fitted over a window of these samples, which
+// gives the skew, so the offset can be predicted between samples, and the
+// samples can be taken less often once the estimate has converged.
+//
+// All times are in nanoseconds.
+//
+// Not thread-safe, the caller needs to lock.
+class TimesyncFilter {
+public:
+    static constexpr size_t window_size = 16;
+    static constexpr size_t converged_samples = 6;
+    // Samples whose round trip is this much slower than the fastest recent
+    // one are rejected.
+    static constexpr double rtt_tolerance_factor = 1.5;
+    static constexpr int64_t rtt_tolerance_min_ns = 1'000'000;
+    static constexpr int64_t max_rtt_ns = 2'000'000'000;
+    // Clocks of real systems drift much less than this.
+    static constexpr double max_skew = 1e-3;
+    // After this many samples that don't fit the estimate at all, the remote
+    // clock must have jumped, e.g. after a reboot, and we start over.
+    static constexpr size_t max_inconsistent_samples = 3;
+
+    TimesyncFilter() = default;
+    ~TimesyncFilter() = default;
+
+    // Non-copyable
+    TimesyncFilter(const TimesyncFilter&) = delete;
+    const TimesyncFilter& operator=(const TimesyncFilter&) = delete;
+
+    // Returns whether the sample was used.
+    bool add_sample(int64_t local_sent_ns, int64_t remote_ns, int64_t local_received_ns);
+
+    [[nodiscard]] bool has_estimate() const { return !_samples.empty(); }
+    [[nodiscard]] bool is_converged() const { return _samples.size() >= converged_samples; }
+
+    // Remote time minus local time at the given local time.
+    [[nodiscard]] std::optional<int64_t> offset_ns(int64_t local_ns) const;
+
+    // How much faster the remote clock runs than ours, e.g. 1e-5 for 10 ppm.
+    [[nodiscard]] double skew() const { return _skew; }
+
+    // Local time the estimate is anchored to, the offset at it is offset_ns().
+    [[nodiscard]] int64_t reference_ns() const { return _reference_ns; }
+
+    [[nodiscard]] uint64_t rejected_samples() const { return _rejected_samples; }
+
+    void reset();
+
+private:
+    struct Sample {
+        int64_t local_ns;
+        int64_t offset_ns;
+    };
+
+    [[nodiscard]] bool rtt_acceptable(int64_t rtt_ns) const;
+    void fit();
+
+    std::deque<int64_t> _recent_rtts_ns{};
+    std::deque<Sample> _samples{};
+
+    // Result of the fit: offset at the reference time, and skew.
+    int64_t _reference_ns{0};
+    int64_t _reference_offset_ns{0};
+    double _skew{0.0};
+
+    size_t _inconsistent_samples{0};
+    uint64_t _rejected_samples{0};
+};
+
+} // namespace mavsdk
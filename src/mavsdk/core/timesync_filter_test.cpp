@@ -0,0 +1,131 @@
+#include "timesync_filter.h"
+#include <gtest/gtest.h>
+
+using namespace mavsdk;
+
+namespace {
+
+constexpr int64_t ms = 1'000'000;
+constexpr int64_t s = 1'000'000'000;
+
+// Remote clock which is ahead by offset_ns and runs faster by skew.
+struct RemoteClock {
+    int64_t offset_ns;
+    double skew;
+
+    int64_t at(int64_t local_ns) const
+    {
+        return local_ns + offset_ns +
+               static_cast<int64_t>(skew * static_cast<double>(local_ns));
+    }
+};
+
+// A round trip sent at local_ns which takes up_ns there and down_ns back.
+bool round_trip(
+    TimesyncFilter& filter,
+    const RemoteClock& remote,
+    int64_t local_ns,
+    int64_t up_ns = 1 * ms,
+    int64_t down_ns = 1 * ms)
+{
+    return filter.add_sample(local_ns, remote.at(local_ns + up_ns), local_ns + up_ns + down_ns);
+}
+
+} // namespace
+
+TEST(TimesyncFilter, HasNoEstimateInitially)
+{
+    TimesyncFilter filter;
+    EXPECT_FALSE(filter.has_estimate());
+    EXPECT_FALSE(filter.is_converged());
+    EXPECT_FALSE(filter.offset_ns(0));
+}
+
+TEST(TimesyncFilter, EstimatesOffset)
+{
+    TimesyncFilter filter;
+    const RemoteClock remote{42 * s, 0.0};
+
+    EXPECT_TRUE(round_trip(filter, remote, 100 * s));
+    ASSERT_TRUE(filter.has_estimate());
+    EXPECT_EQ(filter.offset_ns(100 * s).value(), 42 * s);
+}
+
+TEST(TimesyncFilter, ConvergesAfterSomeSamples)
+{
+    TimesyncFilter filter;
+    const RemoteClock remote{42 * s, 0.0};
+
+    for (size_t i = 0; i < TimesyncFilter::converged_samples; ++i) {
+        EXPECT_FALSE(filter.is_converged());
+        EXPECT_TRUE(round_trip(filter, remote, static_cast<int64_t>(i) * s));
+    }
+    EXPECT_TRUE(filter.is_converged());
+}
+
+TEST(TimesyncFilter, RejectsSlowRoundTrips)
+{
+    TimesyncFilter filter;
+    const RemoteClock remote{42 * s, 0.0};
+
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_TRUE(round_trip(filter, remote, i * s));
+    }
+
+    // Stuck in a queue on the way back, which would be off by 15 ms.
+    EXPECT_FALSE(round_trip(filter, remote, 4 * s, 1 * ms, 31 * ms));
+    EXPECT_EQ(filter.rejected_samples(), 1u);
+    EXPECT_EQ(filter.offset_ns(4 * s).value(), 42 * s);
+
+    // A bit of jitter is fine.
+    EXPECT_TRUE(round_trip(filter, remote, 5 * s, 1 * ms, 2 * ms));
+}
+
+TEST(TimesyncFilter, EstimatesSkew)
+{
+    TimesyncFilter filter;
+    // 20 ppm
+    const RemoteClock remote{42 * s, 20e-6};
+
+    for (int i = 0; i < 10; ++i) {
+        EXPECT_TRUE(round_trip(filter, remote, 1000 * s + i * 10 * s));
+    }
+
+    EXPECT_NEAR(filter.skew(), 20e-6, 1e-8);
+
+    // A minute after the last sample we are still well within a millisecond.
+    const int64_t later_ns = 1150 * s;
+    EXPECT_NEAR(
+        static_cast<double>(filter.offset_ns(later_ns).value()),
+        static_cast<double>(remote.at(later_ns) - later_ns),
+        1e4);
+}
+
+TEST(TimesyncFilter, StartsOverWhenRemoteClockJumps)
+{
+    TimesyncFilter filter;
+    const RemoteClock remote{42 * s, 0.0};
+
+    for (int i = 0; i < 8; ++i) {
+        EXPECT_TRUE(round_trip(filter, remote, i * s));
+    }
+    ASSERT_TRUE(filter.is_converged());
+
+    // Rebooted.
+    const RemoteClock rebooted{-5 * s, 0.0};
+    for (size_t i = 1; i < TimesyncFilter::max_inconsistent_samples; ++i) {
+        EXPECT_FALSE(round_trip(filter, rebooted, static_cast<int64_t>(8 + i) * s));
+    }
+    EXPECT_TRUE(round_trip(filter, rebooted, 20 * s));
+    EXPECT_FALSE(filter.is_converged());
+    EXPECT_EQ(filter.offset_ns(20 * s).value(), -5 * s);
+}
+
+TEST(TimesyncFilter, RejectsAnswersToOthers)
+{
+    TimesyncFilter filter;
+    EXPECT_FALSE(filter.add_sample(10 * s, 42 * s, 5 * s));
+    EXPECT_FALSE(filter.add_sample(10 * s, 42 * s, 20 * s));
+    EXPECT_FALSE(filter.has_estimate());
+    EXPECT_EQ(filter.rejected_samples(), 2u);
+}
@@ -0,0 +1,225 @@
+#include "tlog_replay_connection.h"
+#include "tlog_writer.h"
+#include "log.h"
+#include "receive_burst.h"
+#include "thread_config.h"
+#include "unused.h"
+
+#if defined(LINUX) || defined(APPLE)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <fstream>
+#include <iterator>
+#endif
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <utility>
+
+namespace mavsdk {
+
+TlogReplayConnection::TlogReplayConnection(
+    Connection::ReceiverCallback receiver_callback,
+    std::string path,
+    bool max_speed,
+    ForwardingOption forwarding_option) :
+    Connection(std::move(receiver_callback), forwarding_option),
+    _path(std::move(path)),
+    _max_speed(max_speed)
+{}
+
+TlogReplayConnection::~TlogReplayConnection()
+{
+    // If no one explicitly called stop before, we should at least do it.
+    stop();
+}
+
+ConnectionResult TlogReplayConnection::start()
+{
+    start_mavlink_receiver();
+
+    if (!map_file()) {
+        return ConnectionResult::ConnectionError;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _should_exit = false;
+    }
+    _replay_thread = std::make_unique<std::thread>(&TlogReplayConnection::replay, this);
+
+    return ConnectionResult::Success;
+}
+
+ConnectionResult TlogReplayConnection::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _should_exit = true;
+    }
+    _cv.notify_all();
+
+    if (_replay_thread) {
+        _replay_thread->join();
+        _replay_thread.reset();
+    }
+
+    unmap_file();
+
+    // We need to stop this after stopping the replay thread, otherwise
+    // it could still be used there.
+    stop_mavlink_receiver();
+
+    return ConnectionResult::Success;
+}
+
+bool TlogReplayConnection::send_message(const mavlink_message_t& message)
+{
+    // There is no one to send to.
+    UNUSED(message);
+    return true;
+}
+
+bool TlogReplayConnection::send_frames(const uint8_t* data, size_t len)
+{
+    UNUSED(data);
+    UNUSED(len);
+    return true;
+}
+
+bool TlogReplayConnection::map_file()
+{
+#if defined(LINUX) || defined(APPLE)
+    const int fd = open(_path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        LogErr() << "Could not open tlog " << _path << ": " << strerror(errno);
+        return false;
+    }
+
+    struct stat file_stat {};
+    if (fstat(fd, &file_stat) != 0 || file_stat.st_size == 0) {
+        LogErr() << "Could not get size of tlog " << _path;
+        close(fd);
+        return false;
+    }
+    _data_len = static_cast<size_t>(file_stat.st_size);
+
+    // Private and writable, so the parser may use the data as its buffer,
+    // without anything ending up in the file.
+    void* data = mmap(nullptr, _data_len, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+
+    if (data == MAP_FAILED) {
+        LogErr() << "Could not map tlog " << _path << ": " << strerror(errno);
+        _data_len = 0;
+        return false;
+    }
+    _data = static_cast<char*>(data);
+#else
+    std::ifstream file(_path, std::ios::binary);
+    if (!file) {
+        LogErr() << "Could not open tlog " << _path;
+        return false;
+    }
+    _file_contents.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    _data = _file_contents.data();
+    _data_len = _file_contents.size();
+#endif
+    return true;
+}
+
+void TlogReplayConnection::unmap_file()
+{
+#if defined(LINUX) || defined(APPLE)
+    if (_data != nullptr) {
+        munmap(_data, _data_len);
+    }
+#else
+    _file_contents.clear();
+#endif
+    _data = nullptr;
+    _data_len = 0;
+}
+
+size_t TlogReplayConnection::frame_len(const uint8_t* data, size_t len)
+{
+    if (len < 2) {
+        return 0;
+    }
+
+    if (data[0] == MAVLINK_STX) {
+        if (len < 3) {
+            return 0;
+        }
+        const bool is_signed = (data[2] & MAVLINK_IFLAG_SIGNED) != 0;
+        return MAVLINK_CORE_HEADER_LEN + 1 + data[1] + MAVLINK_NUM_CHECKSUM_BYTES +
+               (is_signed ? MAVLINK_SIGNATURE_BLOCK_LEN : 0);
+    }
+
+    if (data[0] == MAVLINK_STX_MAVLINK1) {
+        return MAVLINK_CORE_HEADER_MAVLINK1_LEN + 1 + data[1] + MAVLINK_NUM_CHECKSUM_BYTES;
+    }
+
+    return 0;
+}
+
+void TlogReplayConnection::replay()
+{
+    ThreadConfig::apply(ThreadRole::Receive);
+
+    const auto* data = reinterpret_cast<const uint8_t*>(_data);
+    size_t pos = 0;
+
+    bool first = true;
+    uint64_t first_timestamp_us = 0;
+    const auto start_time = std::chrono::steady_clock::now();
+
+    while (pos + TlogWriter::TIMESTAMP_LEN < _data_len) {
+        uint64_t timestamp_us = 0;
+        for (size_t i = 0; i < TlogWriter::TIMESTAMP_LEN; ++i) {
+            timestamp_us = (timestamp_us << 8) | data[pos + i];
+        }
+        pos += TlogWriter::TIMESTAMP_LEN;
+
+        const size_t len = frame_len(&data[pos], _data_len - pos);
+        if (len == 0 || pos + len > _data_len) {
+            LogWarn() << "Tlog " << _path << " is truncated or corrupt at byte " << pos;
+            break;
+        }
+
+        if (first) {
+            first_timestamp_us = timestamp_us;
+            first = false;
+        }
+
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            if (!_max_speed && timestamp_us > first_timestamp_us) {
+                _cv.wait_until(
+                    lock,
+                    start_time + std::chrono::microseconds(timestamp_us - first_timestamp_us),
+                    [this]() { return _should_exit; });
+            }
+            if (_should_exit) {
+                return;
+            }
+        }
+
+        _mavlink_receiver->set_new_datagram(&_data[pos], static_cast<unsigned>(len));
+        ReceiveBurst::Scope receive_burst;
+        while (_mavlink_receiver->parse_message()) {
+            receive_message(_mavlink_receiver->get_last_message(), this);
+        }
+
+        pos += len;
+    }
+
+    LogDebug() << "Finished replaying tlog " << _path;
+    _done = true;
+}
+
+} // namespace mavsdk
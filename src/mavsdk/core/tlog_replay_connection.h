@@ -0,0 +1,62 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "connection.h"
+
+namespace mavsdk {
+
+// Plays back a telemetry log (tlog) as if the messages were received on a
+// link, either with the original timing or as fast as possible.
+//
+// Messages sent to this connection are discarded.
+class TlogReplayConnection : public Connection {
+public:
+    explicit TlogReplayConnection(
+        Connection::ReceiverCallback receiver_callback,
+        std::string path,
+        bool max_speed,
+        ForwardingOption forwarding_option = ForwardingOption::ForwardingOff);
+    ConnectionResult start() override;
+    ConnectionResult stop() override;
+    ~TlogReplayConnection() override;
+
+    bool send_message(const mavlink_message_t& message) override;
+    bool send_frames(const uint8_t* data, size_t len) override;
+
+    // Whether all messages of the log have been replayed.
+    bool is_done() const { return _done; }
+
+    // Non-copyable
+    TlogReplayConnection(const TlogReplayConnection&) = delete;
+    const TlogReplayConnection& operator=(const TlogReplayConnection&) = delete;
+
+private:
+    bool map_file();
+    void unmap_file();
+    void replay();
+
+    static size_t frame_len(const uint8_t* data, size_t len);
+
+    const std::string _path;
+    const bool _max_speed;
+
+    char* _data{nullptr};
+    size_t _data_len{0};
+#if !defined(LINUX) && !defined(APPLE)
+    std::vector<char> _file_contents{};
+#endif
+
+    std::unique_ptr<std::thread> _replay_thread{};
+    std::mutex _mutex{};
+    std::condition_variable _cv{};
+    bool _should_exit{false};
+    std::atomic<bool> _done{false};
+};
+
+} // namespace mavsdk
@@ -0,0 +1,163 @@
+#include "tlog_writer.h"
+#include "log.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+
+namespace mavsdk {
+
+TlogWriter::~TlogWriter()
+{
+    close();
+}
+
+bool TlogWriter::open(const std::string& path)
+{
+    close();
+
+    _file = fopen(path.c_str(), "ab");
+    if (_file == nullptr) {
+        LogErr() << "Could not open tlog " << path << ": " << strerror(errno);
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _should_exit = false;
+    }
+    _thread = std::make_unique<std::thread>(&TlogWriter::run, this);
+    return true;
+}
+
+void TlogWriter::close()
+{
+    if (_thread != nullptr) {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _should_exit = true;
+        }
+        _cv.notify_one();
+        _thread->join();
+        _thread.reset();
+    }
+
+    if (_file != nullptr) {
+        fclose(_file);
+        _file = nullptr;
+    }
+}
+
+void TlogWriter::set_filter(const TlogFilter& filter)
+{
+    _message_ids = filter.message_ids;
+    std::sort(_message_ids.begin(), _message_ids.end());
+
+    _system_ids.reset();
+    for (const auto system_id : filter.system_ids) {
+        _system_ids.set(system_id);
+    }
+    _all_system_ids = filter.system_ids.empty();
+
+    _incoming = filter.incoming;
+    _outgoing = filter.outgoing;
+}
+
+bool TlogWriter::accepts(uint32_t message_id, uint8_t system_id, bool incoming) const
+{
+    if (!(incoming ? _incoming : _outgoing)) {
+        return false;
+    }
+    if (!_all_system_ids && !_system_ids.test(system_id)) {
+        return false;
+    }
+    return _message_ids.empty() ||
+           std::binary_search(_message_ids.begin(), _message_ids.end(), message_id);
+}
+
+void TlogWriter::write(const mavlink_message_t& message)
+{
+    const auto now = std::chrono::system_clock::now().time_since_epoch();
+    write(
+        message,
+        static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(now).count()));
+}
+
+void TlogWriter::write(const mavlink_message_t& message, uint64_t timestamp_us)
+{
+    uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
+    const uint16_t len = mavlink_msg_to_send_buffer(buffer, &message);
+
+    write_frame(buffer, len, timestamp_us);
+}
+
+void TlogWriter::write_frame(const uint8_t* frame, size_t len)
+{
+    const auto now = std::chrono::system_clock::now().time_since_epoch();
+    write_frame(
+        frame,
+        len,
+        static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(now).count()));
+}
+
+void TlogWriter::write_frame(const uint8_t* frame, size_t len, uint64_t timestamp_us)
+{
+    uint8_t timestamp[TIMESTAMP_LEN];
+    for (size_t i = 0; i < TIMESTAMP_LEN; ++i) {
+        timestamp[i] = static_cast<uint8_t>(timestamp_us >> (8 * (TIMESTAMP_LEN - 1 - i)));
+    }
+
+    bool was_empty;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_pending.size() + TIMESTAMP_LEN + len > MAX_PENDING_BYTES) {
+            _dropped_bytes += TIMESTAMP_LEN + len;
+            return;
+        }
+        was_empty = _pending.empty();
+        _pending.insert(_pending.end(), timestamp, timestamp + TIMESTAMP_LEN);
+        _pending.insert(_pending.end(), frame, frame + len);
+    }
+
+    // The writer thread only sleeps when there is nothing to write anyway.
+    if (was_empty) {
+        _cv.notify_one();
+    }
+}
+
+uint64_t TlogWriter::dropped_bytes() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _dropped_bytes;
+}
+
+void TlogWriter::run()
+{
+    std::vector<uint8_t> writing;
+
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (true) {
+        _cv.wait(lock, [this]() { return _should_exit || !_pending.empty(); });
+
+        if (_pending.empty() && _should_exit) {
+            break;
+        }
+
+        // Swap the buffers, so callers can keep appending while we write.
+        std::swap(writing, _pending);
+        lock.unlock();
+
+        if (fwrite(writing.data(), 1, writing.size(), _file) != writing.size()) {
+            LogErr() << "Could not write tlog: " << strerror(errno);
+        }
+        writing.clear();
+
+        lock.lock();
+    }
+    lock.unlock();
+
+    fflush(_file);
+}
+
+} // namespace mavsdk
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <bitset>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "mavlink_include.h"
+#include "tlog_filter.h"
+
+namespace mavsdk {
+
+// Writes messages to a telemetry log (tlog) file, the format used by
+// QGroundControl and MAVProxy: every message is prefixed with a big-endian
+// 64-bit timestamp in microseconds since the Unix epoch.
+//
+// Messages are serialized into a buffer by the caller and written to the file
+// by a background thread, so that writing never blocks the caller on I/O.
+//
+// The filter is set before opening and checked by the caller with accepts(),
+// so that messages filtered out are not even serialized.
+class TlogWriter {
+public:
+    TlogWriter() = default;
+    ~TlogWriter();
+
+    // delete copy and move constructors and assign operators
+    TlogWriter(TlogWriter const&) = delete; // Copy construct
+    TlogWriter(TlogWriter&&) = delete; // Move construct
+    TlogWriter& operator=(TlogWriter const&) = delete; // Copy assign
+    TlogWriter& operator=(TlogWriter&&) = delete; // Move assign
+
+    static constexpr size_t TIMESTAMP_LEN = 8;
+
+    // Appends to the file if it already exists.
+    bool open(const std::string& path);
+    void close();
+
+    void set_filter(const TlogFilter& filter);
+    [[nodiscard]] bool accepts(uint32_t message_id, uint8_t system_id, bool incoming) const;
+
+    void write(const mavlink_message_t& message);
+    void write(const mavlink_message_t& message, uint64_t timestamp_us);
+    // For a frame that is already serialized.
+    void write_frame(const uint8_t* frame, size_t len);
+
+    uint64_t dropped_bytes() const;
+
+private:
+    void write_frame(const uint8_t* frame, size_t len, uint64_t timestamp_us);
+    void run();
+
+    // Messages are dropped if the disk can't keep up.
+    static constexpr size_t MAX_PENDING_BYTES = 4 * 1024 * 1024;
+
+    // Sorted, for the lookup of every message.
+    std::vector<uint32_t> _message_ids{};
+    std::bitset<256> _system_ids{};
+    bool _all_system_ids{true};
+    bool _incoming{true};
+    bool _outgoing{true};
+
+    mutable std::mutex _mutex{};
+    std::condition_variable _cv{};
+    std::vector<uint8_t> _pending{};
+    uint64_t _dropped_bytes{0};
+    bool _should_exit{false};
+
+    FILE* _file{nullptr};
+    std::unique_ptr<std::thread> _thread{};
+};
+
+} // namespace mavsdk
@@ -0,0 +1,122 @@
+#include "tlog_writer.h"
+#include "tlog_replay_connection.h"
+#include "fs.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iterator>
+#include <thread>
+#include <vector>
+
+using namespace mavsdk;
+
+namespace {
+
+mavlink_message_t make_heartbeat(uint8_t sysid)
+{
+    mavlink_message_t message;
+    mavlink_msg_heartbeat_pack(
+        sysid,
+        MAV_COMP_ID_AUTOPILOT1,
+        &message,
+        MAV_TYPE_QUADROTOR,
+        MAV_AUTOPILOT_PX4,
+        0,
+        0,
+        MAV_STATE_ACTIVE);
+    return message;
+}
+
+std::string tmp_tlog_path(const std::string& name)
+{
+    auto tmp_dir = create_tmp_directory("mavsdk-tlog-test");
+    EXPECT_TRUE(tmp_dir);
+    const auto path = tmp_dir.value_or(".") + "/" + name;
+    fs_remove(path);
+    return path;
+}
+
+} // namespace
+
+TEST(TlogWriter, WritesTimestampAndMessage)
+{
+    const auto path = tmp_tlog_path("writer.tlog");
+
+    const auto message = make_heartbeat(1);
+    {
+        TlogWriter writer;
+        ASSERT_TRUE(writer.open(path));
+        writer.write(message, 0x0102030405060708);
+    }
+
+    std::ifstream file(path, std::ios::binary);
+    const std::vector<uint8_t> contents(
+        (std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    uint8_t expected[MAVLINK_MAX_PACKET_LEN];
+    const auto len = mavlink_msg_to_send_buffer(expected, &message);
+
+    ASSERT_EQ(contents.size(), TlogWriter::TIMESTAMP_LEN + len);
+    for (uint8_t i = 0; i < TlogWriter::TIMESTAMP_LEN; ++i) {
+        EXPECT_EQ(contents[i], i + 1);
+    }
+    EXPECT_TRUE(std::equal(expected, expected + len, &contents[TlogWriter::TIMESTAMP_LEN]));
+
+    fs_remove(path);
+}
+
+TEST(TlogWriter, AcceptsAllByDefault)
+{
+    TlogWriter writer;
+    EXPECT_TRUE(writer.accepts(0, 1, true));
+    EXPECT_TRUE(writer.accepts(12345, 255, false));
+}
+
+TEST(TlogWriter, AcceptsWhatPassesFilter)
+{
+    TlogFilter filter;
+    filter.message_ids = {33, 0, 30};
+    filter.system_ids = {1, 2};
+    filter.outgoing = false;
+
+    TlogWriter writer;
+    writer.set_filter(filter);
+    EXPECT_TRUE(writer.accepts(0, 1, true));
+    EXPECT_TRUE(writer.accepts(33, 2, true));
+    EXPECT_FALSE(writer.accepts(31, 1, true));
+    EXPECT_FALSE(writer.accepts(30, 3, true));
+    EXPECT_FALSE(writer.accepts(30, 1, false));
+}
+
+TEST(TlogReplayConnection, ReplaysRecordedMessages)
+{
+    const auto path = tmp_tlog_path("replay.tlog");
+
+    {
+        TlogWriter writer;
+        ASSERT_TRUE(writer.open(path));
+        for (uint8_t sysid = 1; sysid <= 100; ++sysid) {
+            writer.write(make_heartbeat(sysid), sysid * 1000);
+        }
+    }
+
+    std::vector<uint8_t> received_sysids;
+    TlogReplayConnection connection(
+        [&](mavlink_message_t& message, Connection*) { received_sysids.push_back(message.sysid); },
+        path,
+        true);
+    ASSERT_EQ(connection.start(), ConnectionResult::Success);
+
+    for (unsigned i = 0; i < 100 && !connection.is_done(); ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    connection.stop();
+
+    ASSERT_EQ(received_sysids.size(), 100u);
+    for (uint8_t sysid = 1; sysid <= 100; ++sysid) {
+        EXPECT_EQ(received_sysids[sysid - 1], sysid);
+    }
+
+    fs_remove(path);
+}
@@ -0,0 +1,265 @@
+#include "trace.h"
+#include "log.h"
+
+#if defined(LINUX) || defined(APPLE)
+#include <pthread.h>
+#endif
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+namespace mavsdk {
+
+std::atomic<bool> Trace::_enabled{false};
+
+struct Trace::ThreadBuffer {
+    unsigned tid{0};
+    std::string thread_name{};
+    // Only resized while nothing is recorded.
+    std::vector<Event> events{};
+    // How many events were ever recorded, the latest ones are kept.
+    std::atomic<size_t> head{0};
+    // Set while the thread records, so stop() can wait for it.
+    std::atomic<bool> recording{false};
+};
+
+// Dead threads' buffers are kept until the next start, so their events can
+// still be written out.
+struct Trace::Registry {
+    std::mutex mutex{};
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers{}; // Needs mutex
+    size_t events_per_thread{DEFAULT_EVENTS_PER_THREAD}; // Needs mutex
+    unsigned next_tid{1}; // Needs mutex
+    Clock::time_point start{}; // Needs mutex
+};
+
+namespace {
+
+std::string current_thread_name()
+{
+#if defined(LINUX) || defined(APPLE)
+    char name[64]{};
+    if (pthread_getname_np(pthread_self(), name, sizeof(name)) == 0) {
+        return name;
+    }
+#endif
+    return {};
+}
+
+void append_json_string(std::ostringstream& out, const std::string& str)
+{
+    out << '"';
+    for (const char c : str) {
+        if (c == '"' || c == '\\') {
+            out << '\\' << c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            char escaped[8];
+            snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+            out << escaped;
+        } else {
+            out << c;
+        }
+    }
+    out << '"';
+}
+
+// Chrome traces are in microseconds.
+double to_us(Trace::Clock::duration duration)
+{
+    return std::chrono::duration<double, std::micro>(duration).count();
+}
+
+} // namespace
+
+Trace::Registry& Trace::registry()
+{
+    static Registry registry;
+    return registry;
+}
+
+void Trace::start(size_t new_events_per_thread)
+{
+    stop();
+
+    auto& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+
+    // Only the registry still has the buffers of threads which have ended.
+    reg.buffers.erase(
+        std::remove_if(
+            reg.buffers.begin(),
+            reg.buffers.end(),
+            [](const std::shared_ptr<ThreadBuffer>& buffer) { return buffer.use_count() == 1; }),
+        reg.buffers.end());
+
+    reg.events_per_thread = std::max<size_t>(new_events_per_thread, 1);
+    for (auto& buffer : reg.buffers) {
+        buffer->events.assign(reg.events_per_thread, Event{});
+        buffer->head = 0;
+    }
+
+    reg.start = Clock::now();
+    _enabled = true;
+}
+
+void Trace::stop()
+{
+    _enabled = false;
+
+    // Whoever saw it enabled before has announced itself by now.
+    auto& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    for (const auto& buffer : reg.buffers) {
+        while (buffer->recording) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+Trace::ThreadBuffer& Trace::thread_buffer()
+{
+    thread_local std::shared_ptr<ThreadBuffer> buffer = []() {
+        auto new_buffer = std::make_shared<ThreadBuffer>();
+        new_buffer->thread_name = current_thread_name();
+
+        auto& reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        new_buffer->tid = reg.next_tid++;
+        new_buffer->events.assign(reg.events_per_thread, Event{});
+        reg.buffers.push_back(new_buffer);
+        return new_buffer;
+    }();
+    return *buffer;
+}
+
+void Trace::record(const Event& event)
+{
+    auto& buffer = thread_buffer();
+
+    // Paired with stop(): either it sees us recording and waits, or we see
+    // it has stopped.
+    buffer.recording = true;
+    if (!_enabled) {
+        buffer.recording = false;
+        return;
+    }
+
+    const size_t head = buffer.head.load(std::memory_order_relaxed);
+    buffer.events[head % buffer.events.size()] = event;
+    buffer.head.store(head + 1, std::memory_order_release);
+
+    buffer.recording.store(false, std::memory_order_release);
+}
+
+void Trace::instant(const char* category, const char* name, int64_t value)
+{
+    if (!is_enabled()) {
+        return;
+    }
+
+    Event event;
+    event.category = category;
+    event.name = name;
+    event.start = Clock::now();
+    event.value = value;
+    record(event);
+}
+
+void Trace::complete(
+    const char* category,
+    const char* name,
+    Clock::time_point start,
+    Clock::time_point end,
+    int64_t value)
+{
+    if (!is_enabled()) {
+        return;
+    }
+
+    Event event;
+    event.category = category;
+    event.name = name;
+    event.start = start;
+    event.duration = end - start;
+    event.value = value;
+    record(event);
+}
+
+std::string Trace::to_chrome_json()
+{
+    auto& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+
+    std::ostringstream out;
+    out.precision(3);
+    out << std::fixed;
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+    bool first = true;
+    auto separate = [&]() {
+        if (!first) {
+            out << ",\n";
+        }
+        first = false;
+    };
+
+    for (const auto& buffer : reg.buffers) {
+        separate();
+        out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->tid
+            << ",\"args\":{\"name\":";
+        append_json_string(
+            out,
+            buffer->thread_name.empty() ? "thread " + std::to_string(buffer->tid) :
+                                          buffer->thread_name);
+        out << "}}";
+
+        const size_t head = buffer->head.load(std::memory_order_acquire);
+        const size_t size = buffer->events.size();
+        for (size_t i = head > size ? head - size : 0; i < head; ++i) {
+            const auto& event = buffer->events[i % size];
+            // Spans which began before the start, e.g. a callback waiting in
+            // the queue, would be out of view.
+            if (event.start < reg.start) {
+                continue;
+            }
+
+            separate();
+            out << "{\"cat\":\"" << event.category << "\",\"name\":\"" << event.name
+                << "\",\"pid\":1,\"tid\":" << buffer->tid
+                << ",\"ts\":" << to_us(event.start - reg.start);
+            if (event.duration == Clock::duration::min()) {
+                out << ",\"ph\":\"i\",\"s\":\"t\"";
+            } else {
+                out << ",\"ph\":\"X\",\"dur\":" << to_us(event.duration);
+            }
+            out << ",\"args\":{\"value\":" << event.value << "}}";
+        }
+    }
+
+    out << "]}\n";
+    return out.str();
+}
+
+bool Trace::write_chrome_json(const std::string& path)
+{
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        LogErr() << "Could not open trace file " << path;
+        return false;
+    }
+
+    file << to_chrome_json();
+    if (!file) {
+        LogErr() << "Could not write trace file " << path;
+        return false;
+    }
+    return true;
+}
+
+} // namespace mavsdk
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace mavsdk {
+
+// Opt-in tracing of what happens on which thread, to find out where latency
+// comes from.
+//
+// Events go into a buffer of the thread recording them, without any lock, and
+// are written out as Chrome trace JSON, which chrome://tracing and the
+// Perfetto UI open. While tracing is off, recording an event is just one
+// relaxed atomic load.
+//
+// Only the pointers of category and name are kept, so they need to be string
+// literals.
+class Trace {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // Discards what was recorded before. Each thread keeps its latest
+    // events_per_thread events.
+    static void start(size_t events_per_thread = DEFAULT_EVENTS_PER_THREAD);
+
+    // Once this returns, nothing is recorded anymore, and what was recorded
+    // can be written out.
+    static void stop();
+
+    static bool is_enabled() { return _enabled.load(std::memory_order_relaxed); }
+
+    static void instant(const char* category, const char* name, int64_t value = 0);
+    static void complete(
+        const char* category,
+        const char* name,
+        Clock::time_point start,
+        Clock::time_point end,
+        int64_t value = 0);
+
+    // What was recorded until stop().
+    static std::string to_chrome_json();
+    static bool write_chrome_json(const std::string& path);
+
+    static constexpr size_t DEFAULT_EVENTS_PER_THREAD = 65536;
+
+private:
+    struct Event {
+        const char* category{nullptr};
+        const char* name{nullptr};
+        Clock::time_point start{};
+        // Instant events have none.
+        Clock::duration duration{Clock::duration::min()};
+        int64_t value{0};
+    };
+    struct ThreadBuffer;
+    struct Registry;
+
+    static void record(const Event& event);
+    static ThreadBuffer& thread_buffer();
+    static Registry& registry();
+
+    static std::atomic<bool> _enabled;
+};
+
+// Records the time from construction to destruction as one span.
+class TraceScope {
+public:
+    TraceScope(const char* category, const char* name, int64_t value = 0) :
+        _category(category),
+        _name(name),
+        _value(value),
+        _active(Trace::is_enabled())
+    {
+        if (_active) {
+            _start = Trace::Clock::now();
+        }
+    }
+
+    ~TraceScope()
+    {
+        if (_active) {
+            Trace::complete(_category, _name, _start, Trace::Clock::now(), _value);
+        }
+    }
+
+    // Non-copyable
+    TraceScope(const TraceScope&) = delete;
+    const TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    const char* _category;
+    const char* _name;
+    int64_t _value;
+    bool _active;
+    Trace::Clock::time_point _start{};
+};
+
+} // namespace mavsdk
@@ -0,0 +1,109 @@
+#include "trace.h"
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+
+using namespace mavsdk;
+
+namespace {
+
+size_t count_of(const std::string& haystack, const std::string& needle)
+{
+    size_t count = 0;
+    for (auto pos = haystack.find(needle); pos != std::string::npos;
+         pos = haystack.find(needle, pos + needle.size())) {
+        ++count;
+    }
+    return count;
+}
+
+} // namespace
+
+TEST(Trace, RecordsNothingWhenOff)
+{
+    Trace::start();
+    Trace::stop();
+
+    Trace::instant("test", "off_instant");
+    {
+        TraceScope scope("test", "off_scope");
+    }
+
+    const auto json = Trace::to_chrome_json();
+    EXPECT_EQ(count_of(json, "off_instant"), 0u);
+    EXPECT_EQ(count_of(json, "off_scope"), 0u);
+}
+
+TEST(Trace, RecordsEventsOfAllThreads)
+{
+    Trace::start();
+
+    Trace::instant("test", "main_instant", 42);
+    std::thread([]() {
+        TraceScope scope("test", "other_scope", 7);
+    }).join();
+
+    const auto start = Trace::Clock::now();
+    Trace::complete("test", "main_complete", start, start + std::chrono::milliseconds(2));
+
+    Trace::stop();
+    // Not recorded anymore.
+    Trace::instant("test", "main_instant", 42);
+
+    const auto json = Trace::to_chrome_json();
+
+    EXPECT_EQ(json.find("{\"displayTimeUnit\":\"ms\",\"traceEvents\":["), 0u);
+    EXPECT_EQ(count_of(json, "\"name\":\"main_instant\""), 1u);
+    EXPECT_EQ(count_of(json, "\"ph\":\"i\""), 1u);
+    EXPECT_EQ(count_of(json, "\"value\":42"), 1u);
+    EXPECT_EQ(count_of(json, "\"name\":\"other_scope\""), 1u);
+    EXPECT_EQ(count_of(json, "\"value\":7"), 1u);
+    EXPECT_EQ(count_of(json, "\"name\":\"main_complete\""), 1u);
+    EXPECT_EQ(count_of(json, "\"dur\":2000.000"), 1u);
+    EXPECT_EQ(count_of(json, "\"ph\":\"X\""), 2u);
+
+    // Every thread has its name, even the one which has ended.
+    EXPECT_GE(count_of(json, "\"name\":\"thread_name\""), 2u);
+}
+
+TEST(Trace, KeepsLatestEventsPerThread)
+{
+    Trace::start(4);
+    for (int i = 0; i < 10; ++i) {
+        Trace::instant("test", "ring", i);
+    }
+    Trace::stop();
+
+    const auto json = Trace::to_chrome_json();
+    EXPECT_EQ(count_of(json, "\"name\":\"ring\""), 4u);
+    EXPECT_EQ(count_of(json, "\"value\":5}"), 0u);
+    EXPECT_EQ(count_of(json, "\"value\":6}"), 1u);
+    EXPECT_EQ(count_of(json, "\"value\":9}"), 1u);
+
+    // Starting again discards what was there.
+    Trace::start();
+    Trace::stop();
+    EXPECT_EQ(count_of(Trace::to_chrome_json(), "\"name\":\"ring\""), 0u);
+}
+
+TEST(Trace, StopWaitsForRecordingThreads)
+{
+    Trace::start(1024);
+
+    std::atomic<bool> should_exit{false};
+    std::thread thread([&]() {
+        while (!should_exit) {
+            TraceScope scope("test", "busy");
+        }
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    Trace::stop();
+    // Nothing changes anymore while we read.
+    const auto json = Trace::to_chrome_json();
+    EXPECT_EQ(json, Trace::to_chrome_json());
+    EXPECT_EQ(count_of(json, "\"name\":\"busy\""), 1024u);
+
+    should_exit = true;
+    thread.join();
+}
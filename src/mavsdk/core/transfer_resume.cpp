@@ -0,0 +1,72 @@
+#include "transfer_resume.h"
+#include "fs.h"
+
+#include <fstream>
+
+namespace mavsdk {
+
+namespace {
+
+constexpr const char* header = "mavsdk-resume 1";
+
+} // namespace
+
+std::string TransferResume::sidecar_path(const std::string& path)
+{
+    return path + ".resume";
+}
+
+std::optional<TransferResume> TransferResume::load(const std::string& path)
+{
+    std::ifstream file(sidecar_path(path));
+    if (!file) {
+        return {};
+    }
+
+    std::string line;
+    if (!std::getline(file, line) || line != header) {
+        return {};
+    }
+
+    TransferResume resume;
+    if (!std::getline(file, resume.source) || !(file >> resume.total_bytes) ||
+        !(file >> resume.received_bytes)) {
+        return {};
+    }
+
+    return resume;
+}
+
+bool TransferResume::save(const std::string& path) const
+{
+    // Written to a temporary file first, so that an interruption can't leave
+    // a sidecar behind that claims more than was written.
+    const auto tmp_path = sidecar_path(path) + ".tmp";
+    {
+        std::ofstream file(tmp_path, std::ios::trunc);
+        file << header << '\n' << source << '\n' << total_bytes << '\n' << received_bytes << '\n';
+        if (!file) {
+            return false;
+        }
+    }
+    return fs_rename(tmp_path, sidecar_path(path));
+}
+
+void TransferResume::remove(const std::string& path)
+{
+    fs_remove(sidecar_path(path));
+}
+
+uint64_t TransferResume::resume_offset(
+    const std::string& path, const std::string& source, uint64_t total_bytes)
+{
+    const auto resume = load(path);
+    if (!resume || resume->source != source || resume->total_bytes != total_bytes ||
+        !fs_exists(path) || fs_file_size(path) < resume->received_bytes ||
+        resume->received_bytes > total_bytes) {
+        return 0;
+    }
+    return resume->received_bytes;
+}
+
+} // namespace mavsdk
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+
+namespace mavsdk {
+
+// Keeps track of a partially downloaded file in a small sidecar file next to
+// it, so that an interrupted download can continue where it stopped.
+//
+// The source identifies what is downloaded, e.g. the remote path, and the
+// total size is checked before resuming, so that a partial file is never
+// continued with data from a different file.
+struct TransferResume {
+    std::string source{};
+    uint64_t total_bytes{0};
+    // Bytes from the start of the file that are known to be on disk.
+    uint64_t received_bytes{0};
+
+    static std::string sidecar_path(const std::string& path);
+
+    static std::optional<TransferResume> load(const std::string& path);
+    bool save(const std::string& path) const;
+    static void remove(const std::string& path);
+
+    // Where to continue downloading source with total_bytes into path, or 0.
+    static uint64_t resume_offset(
+        const std::string& path, const std::string& source, uint64_t total_bytes);
+};
+
+} // namespace mavsdk
@@ -0,0 +1,75 @@
+#include "transfer_resume.h"
+#include "fs.h"
+
+#include <fstream>
+#include <gtest/gtest.h>
+
+using namespace mavsdk;
+
+namespace {
+
+std::string partial_file(unsigned size_bytes)
+{
+    const auto tmp_dir = create_tmp_directory("mavsdk-transfer-resume-test");
+    EXPECT_TRUE(tmp_dir);
+
+    const auto path = tmp_dir.value() + path_separator + "partial.ulg";
+    std::ofstream file(path, std::ios::binary);
+    file << std::string(size_bytes, 'x');
+    return path;
+}
+
+void remove_partial_file(const std::string& path)
+{
+    TransferResume::remove(path);
+    fs_remove(path);
+    fs_remove(path.substr(0, path.rfind(path_separator)));
+}
+
+} // namespace
+
+TEST(TransferResume, SaveAndLoad)
+{
+    const auto path = partial_file(100);
+
+    EXPECT_FALSE(TransferResume::load(path));
+
+    TransferResume resume;
+    resume.source = "/fs/microsd/log/2018-08-31/20_50_42.ulg";
+    resume.total_bytes = 1000;
+    resume.received_bytes = 100;
+    EXPECT_TRUE(resume.save(path));
+
+    const auto loaded = TransferResume::load(path);
+    ASSERT_TRUE(loaded);
+    EXPECT_EQ(loaded->source, resume.source);
+    EXPECT_EQ(loaded->total_bytes, 1000);
+    EXPECT_EQ(loaded->received_bytes, 100);
+
+    TransferResume::remove(path);
+    EXPECT_FALSE(TransferResume::load(path));
+    remove_partial_file(path);
+}
+
+TEST(TransferResume, OnlyResumesTheSameFile)
+{
+    const auto path = partial_file(100);
+
+    TransferResume resume;
+    resume.source = "log 3";
+    resume.total_bytes = 1000;
+    resume.received_bytes = 90;
+    ASSERT_TRUE(resume.save(path));
+
+    EXPECT_EQ(TransferResume::resume_offset(path, "log 3", 1000), 90);
+    EXPECT_EQ(TransferResume::resume_offset(path, "log 4", 1000), 0);
+    // Same name, but the file changed.
+    EXPECT_EQ(TransferResume::resume_offset(path, "log 3", 2000), 0);
+
+    // The sidecar can't claim more than what is on disk.
+    resume.received_bytes = 200;
+    ASSERT_TRUE(resume.save(path));
+    EXPECT_EQ(TransferResume::resume_offset(path, "log 3", 1000), 0);
+
+    remove_partial_file(path);
+}
@@ -1,5 +1,10 @@
 #include "udp_connection.h"
+#include "io_reactor.h"
+#include "io_uring_receiver.h"
 #include "log.h"
+#include "mavlink_frame.h"
+#include "receive_burst.h"
+#include "thread_config.h"
 
 #ifdef WINDOWS
 #include <winsock2.h>
@@ -17,6 +22,8 @@
 #endif
 
 #include <algorithm>
+#include <cstring>
+#include <functional>
 #include <utility>
 
 #ifdef WINDOWS
@@ -27,6 +34,64 @@
 
 namespace mavsdk {
 
+struct UdpConnection::RecvBuffers {
+#if defined(LINUX)
+    // We fetch several datagrams per syscall, which makes a difference when
+    // a lot of small datagrams come in, e.g. telemetry from many vehicles.
+    struct Datagram {
+        // Enough for MTU 1500 bytes.
+        char buffer[2048];
+        struct sockaddr_in src_addr;
+        // For the receive timestamp of the kernel.
+        char control[CMSG_SPACE(sizeof(struct timespec))];
+    };
+
+    RecvBuffers() : datagrams(RECV_BATCH_SIZE), iovecs(RECV_BATCH_SIZE), msgs(RECV_BATCH_SIZE)
+    {
+        for (unsigned i = 0; i < RECV_BATCH_SIZE; ++i) {
+            iovecs[i].iov_base = datagrams[i].buffer;
+            iovecs[i].iov_len = sizeof(datagrams[i].buffer);
+        }
+    }
+
+    std::vector<Datagram> datagrams;
+    std::vector<struct iovec> iovecs;
+    std::vector<struct mmsghdr> msgs;
+#else
+    // Enough for MTU 1500 bytes.
+    char buffer[2048];
+#endif
+};
+
+#if defined(LINUX)
+namespace {
+
+// Falls back to now if the kernel didn't stamp it.
+int64_t kernel_receive_time_ns(struct msghdr& header)
+{
+    for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(&header); cmsg != nullptr;
+         cmsg = CMSG_NXTHDR(&header, cmsg)) {
+        if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_TIMESTAMPNS) {
+            struct timespec timestamp {};
+            std::memcpy(&timestamp, CMSG_DATA(cmsg), sizeof(timestamp));
+            return static_cast<int64_t>(timestamp.tv_sec) * 1000000000 + timestamp.tv_nsec;
+        }
+    }
+    return Connection::receive_time_now_ns();
+}
+
+} // namespace
+#endif
+
+struct UdpConnection::ReceiveShard {
+    int socket_fd{-1};
+    RecvBuffers buffers{};
+    // The first shard uses the receiver of the connection.
+    MavlinkReceiver* receiver{nullptr};
+    std::unique_ptr<MavlinkReceiver> own_receiver{};
+    std::unique_ptr<std::thread> thread{};
+};
+
 UdpConnection::UdpConnection(
     Connection::ReceiverCallback receiver_callback,
     std::string local_ip,
@@ -45,16 +110,37 @@ UdpConnection::~UdpConnection()
 
 ConnectionResult UdpConnection::start()
 {
-    if (!start_mavlink_receiver()) {
-        return ConnectionResult::ConnectionsExhausted;
-    }
+    start_mavlink_receiver();
 
     ConnectionResult ret = setup_port();
     if (ret != ConnectionResult::Success) {
         return ret;
     }
 
-    start_recv_thread();
+    // With several sockets, the one thread of the reactor or of io_uring
+    // would be the bottleneck again.
+    if (_receive_shards.size() == 1 && _io_uring_receiver != nullptr &&
+        _io_uring_receiver->add(
+            _socket_fd, [this](char* data, int len, const struct sockaddr_in& src_addr) {
+                process_datagram(
+                    *_receive_shards.front(), data, len, src_addr, receive_time_now_ns());
+            })) {
+        _uses_io_uring = true;
+    } else if (
+        _receive_shards.size() == 1 && _io_reactor != nullptr &&
+        _io_reactor->add(
+            _socket_fd, [this]() { receive_datagrams(*_receive_shards.front(), false); })) {
+        _uses_io_reactor = true;
+    } else {
+        start_recv_threads();
+    }
+
+    // Without a delay, everything is sent straightaway and we don't need the thread.
+    if (_send_coalesce_delay_s > 0.0) {
+        start_send_thread();
+    }
+
+    start_send_scheduler();
 
     return ConnectionResult::Success;
 }
@@ -69,19 +155,83 @@ ConnectionResult UdpConnection::setup_port()
     }
 #endif
 
-    _socket_fd = socket(AF_INET, SOCK_DGRAM, 0);
+    // With port 0, every socket would get a port of its own.
+    unsigned num_shards = 1;
+#if defined(LINUX) && defined(SO_REUSEPORT)
+    if (_local_port_number != 0) {
+        num_shards = std::max(1u, _num_receive_threads);
+    }
+#else
+    if (_num_receive_threads > 1) {
+        LogWarn() << "Receiving on several threads is not supported, using one";
+    }
+#endif
+
+    for (unsigned i = 0; i < num_shards; ++i) {
+        auto shard = std::make_unique<ReceiveShard>();
+        if (i == 0) {
+            shard->receiver = _mavlink_receiver.get();
+        } else {
+            shard->own_receiver = std::make_unique<MavlinkReceiver>();
+            shard->receiver = shard->own_receiver.get();
+        }
 
-    if (_socket_fd < 0) {
+        // Added first, so that stop() closes it if anything goes wrong.
+        _receive_shards.push_back(std::move(shard));
+        ConnectionResult ret = open_socket(*_receive_shards.back(), num_shards > 1);
+        if (i == 0) {
+            _socket_fd = _receive_shards.front()->socket_fd;
+        }
+        if (ret != ConnectionResult::Success) {
+            return ret;
+        }
+    }
+
+    return ConnectionResult::Success;
+}
+
+ConnectionResult UdpConnection::open_socket(ReceiveShard& shard, bool reuse_port)
+{
+    shard.socket_fd = socket(AF_INET, SOCK_DGRAM, 0);
+
+    if (shard.socket_fd < 0) {
         LogErr() << "socket error" << GET_ERROR(errno);
         return ConnectionResult::SocketError;
     }
 
+#if defined(LINUX) && defined(SO_REUSEPORT)
+    // Only sockets of the same user can share the port this way.
+    if (reuse_port) {
+        const int enable = 1;
+        if (setsockopt(shard.socket_fd, SOL_SOCKET, SO_REUSEPORT, &enable, sizeof(enable)) !=
+            0) {
+            LogErr() << "setsockopt error: " << GET_ERROR(errno);
+            return ConnectionResult::SocketError;
+        }
+    }
+#else
+    (void)reuse_port;
+#endif
+
+#if defined(LINUX)
+    // So we know how long messages took to be handled since they arrived.
+    const int enable_timestamps = 1;
+    if (setsockopt(
+            shard.socket_fd,
+            SOL_SOCKET,
+            SO_TIMESTAMPNS,
+            &enable_timestamps,
+            sizeof(enable_timestamps)) != 0) {
+        LogWarn() << "Receive timestamps not available: " << GET_ERROR(errno);
+    }
+#endif
+
     struct sockaddr_in addr {};
     addr.sin_family = AF_INET;
     inet_pton(AF_INET, _local_ip.c_str(), &(addr.sin_addr));
     addr.sin_port = htons(_local_port_number);
 
-    if (bind(_socket_fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+    if (bind(shard.socket_fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
         LogErr() << "bind error: " << GET_ERROR(errno);
         return ConnectionResult::BindError;
     }
@@ -89,33 +239,77 @@ ConnectionResult UdpConnection::setup_port()
     return ConnectionResult::Success;
 }
 
-void UdpConnection::start_recv_thread()
+void UdpConnection::set_receive_threads(unsigned num_threads)
+{
+    _num_receive_threads = num_threads;
+}
+
+void UdpConnection::start_recv_threads()
 {
-    _recv_thread = std::make_unique<std::thread>(&UdpConnection::receive, this);
+    for (auto& shard : _receive_shards) {
+        shard->thread =
+            std::make_unique<std::thread>(&UdpConnection::receive, this, std::ref(*shard));
+    }
+}
+
+void UdpConnection::start_send_thread()
+{
+    _send_thread = std::make_unique<std::thread>(&UdpConnection::send_thread, this);
 }
 
 ConnectionResult UdpConnection::stop()
 {
+    stop_send_scheduler();
+
     _should_exit = true;
 
+    // Send whatever is still queued before we tear down the socket.
+    if (_send_thread) {
+        {
+            std::lock_guard<std::mutex> lock(_send_mutex);
+            _send_cv.notify_all();
+        }
+        _send_thread->join();
+        _send_thread.reset();
+    }
+
+    if (_uses_io_uring) {
+        _io_uring_receiver->remove(_socket_fd);
+        _uses_io_uring = false;
+    }
+
+    if (_uses_io_reactor) {
+        _io_reactor->remove(_socket_fd);
+        _uses_io_reactor = false;
+    }
+
+    for (auto& shard : _receive_shards) {
+        if (shard->socket_fd < 0) {
+            continue;
+        }
 #ifndef WINDOWS
-    // This should interrupt a recv/recvfrom call.
-    shutdown(_socket_fd, SHUT_RDWR);
+        // This should interrupt a recv/recvfrom call.
+        shutdown(shard->socket_fd, SHUT_RDWR);
 
-    // But on Mac, closing is also needed to stop blocking recv/recvfrom.
-    close(_socket_fd);
+        // But on Mac, closing is also needed to stop blocking recv/recvfrom.
+        close(shard->socket_fd);
 #else
-    shutdown(_socket_fd, SD_BOTH);
+        shutdown(shard->socket_fd, SD_BOTH);
 
-    closesocket(_socket_fd);
+        closesocket(shard->socket_fd);
+#endif
+    }
 
+#ifdef WINDOWS
     WSACleanup();
 #endif
 
-    if (_recv_thread) {
-        _recv_thread->join();
-        _recv_thread.reset();
+    for (auto& shard : _receive_shards) {
+        if (shard->thread) {
+            shard->thread->join();
+        }
     }
+    _receive_shards.clear();
 
     // We need to stop this after stopping the receive thread, otherwise
     // it can happen that we interfere with the parsing of a message.
@@ -126,47 +320,215 @@ ConnectionResult UdpConnection::stop()
 
 bool UdpConnection::send_message(const mavlink_message_t& message)
 {
-    std::lock_guard<std::mutex> lock(_remote_mutex);
+    uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
+    const uint16_t buffer_len = mavlink_msg_to_send_buffer(buffer, &message);
 
-    if (_remotes.size() == 0) {
-        LogErr() << "No known remotes";
-        return false;
+    return send_frames(buffer, buffer_len);
+}
+
+bool UdpConnection::send_frames(const uint8_t* data, size_t len)
+{
+    {
+        std::lock_guard<std::mutex> lock(_remote_mutex);
+        if (_remotes.size() == 0) {
+            LogErr() << "No known remotes";
+            return false;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(_send_mutex);
+
+    const bool was_empty = _send_buffer.empty();
+    bool send_successful = true;
+
+    // Frame by frame, so that frames are not split across datagrams.
+    MavlinkFrame frame;
+    size_t pos = 0;
+    while (pos < len && MavlinkFrame::parse(&data[pos], len - pos, frame)) {
+        send_successful = append_to_send_buffer(&data[pos], frame.len) && send_successful;
+        pos += frame.len;
+    }
+
+    if (_send_coalesce_delay_s <= 0.0 || !_send_thread) {
+        send_successful = flush_send_buffer() && send_successful;
+    } else if (was_empty && !_send_buffer.empty()) {
+        // The deadline is set by the first frame, so adding frames can never
+        // delay a frame for longer than configured.
+        _send_deadline = std::chrono::steady_clock::now() +
+                         std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                             std::chrono::duration<double>(_send_coalesce_delay_s));
+        _send_cv.notify_one();
+    }
+
+    return send_successful;
+}
+
+bool UdpConnection::send_messages(const std::vector<mavlink_message_t>& messages)
+{
+    {
+        std::lock_guard<std::mutex> lock(_remote_mutex);
+        if (_remotes.size() == 0) {
+            LogErr() << "No known remotes";
+            return false;
+        }
     }
 
-    // Send the message to all the remotes. A remote is a UDP endpoint
+    std::lock_guard<std::mutex> lock(_send_mutex);
+
+    const bool was_empty = _send_buffer.empty();
+    bool send_successful = true;
+    for (const auto& message : messages) {
+        uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
+        const uint16_t buffer_len = mavlink_msg_to_send_buffer(buffer, &message);
+        send_successful = append_to_send_buffer(buffer, buffer_len) && send_successful;
+    }
+
+    // The batch is complete, so there is nothing to wait for, unless
+    // coalescing across calls is configured.
+    if (_send_coalesce_delay_s <= 0.0 || !_send_thread) {
+        send_successful = flush_send_buffer() && send_successful;
+    } else if (was_empty && !_send_buffer.empty()) {
+        _send_deadline = std::chrono::steady_clock::now() +
+                         std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                             std::chrono::duration<double>(_send_coalesce_delay_s));
+        _send_cv.notify_one();
+    }
+
+    return send_successful;
+}
+
+bool UdpConnection::append_to_send_buffer(const uint8_t* frame, size_t frame_len)
+{
+    // Needs _send_mutex
+
+    bool send_successful = true;
+
+    // Frames that don't fit anymore go into the next datagram.
+    if (_send_buffer.size() + frame_len > MAX_SEND_DATAGRAM_LEN) {
+        send_successful = flush_send_buffer();
+    }
+
+    _send_buffer.insert(_send_buffer.end(), frame, frame + frame_len);
+    return send_successful;
+}
+
+void UdpConnection::set_send_coalesce_delay_s(double delay_s)
+{
+    std::lock_guard<std::mutex> lock(_send_mutex);
+    _send_coalesce_delay_s = delay_s;
+}
+
+bool UdpConnection::flush_send_buffer()
+{
+    // Needs _send_mutex
+
+    if (_send_buffer.empty()) {
+        return true;
+    }
+
+    // Send the datagram to all the remotes. A remote is a UDP endpoint
     // identified by its <ip, port>. This means that if we have two
     // systems on two different endpoints, then messages directed towards
     // only one system will be sent to both remotes. The systems are
     // then expected to ignore messages that are not directed to them.
-    bool send_successful = true;
-    for (auto& remote : _remotes) {
-        struct sockaddr_in dest_addr {};
-        dest_addr.sin_family = AF_INET;
+    std::vector<struct sockaddr_in> dest_addrs;
+    {
+        std::lock_guard<std::mutex> lock(_remote_mutex);
+        dest_addrs.reserve(_remotes.size());
+        for (auto& remote : _remotes) {
+            struct sockaddr_in dest_addr {};
+            dest_addr.sin_family = AF_INET;
+
+            inet_pton(AF_INET, remote.ip.c_str(), &dest_addr.sin_addr.s_addr);
+            dest_addr.sin_port = htons(remote.port_number);
+            dest_addrs.push_back(dest_addr);
+        }
+    }
 
-        inet_pton(AF_INET, remote.ip.c_str(), &dest_addr.sin_addr.s_addr);
-        dest_addr.sin_port = htons(remote.port_number);
+    bool send_successful = true;
 
-        uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
-        uint16_t buffer_len = mavlink_msg_to_send_buffer(buffer, &message);
+#if defined(LINUX)
+    // The same datagram goes to all remotes with one syscall.
+    struct iovec iov {};
+    iov.iov_base = _send_buffer.data();
+    iov.iov_len = _send_buffer.size();
+
+    std::vector<struct mmsghdr> msgs(dest_addrs.size());
+    for (size_t i = 0; i < dest_addrs.size(); ++i) {
+        msgs[i].msg_hdr.msg_name = &dest_addrs[i];
+        msgs[i].msg_hdr.msg_namelen = sizeof(dest_addrs[i]);
+        msgs[i].msg_hdr.msg_iov = &iov;
+        msgs[i].msg_hdr.msg_iovlen = 1;
+    }
 
+    size_t num_sent = 0;
+    while (num_sent < msgs.size()) {
+        const int ret = sendmmsg(
+            _socket_fd, msgs.data() + num_sent, static_cast<unsigned>(msgs.size() - num_sent), 0);
+        if (ret <= 0) {
+            LogErr() << "sendmmsg failure: " << GET_ERROR(errno);
+            send_successful = false;
+            // Skip the one that failed, and try the others.
+            ++num_sent;
+            continue;
+        }
+        for (size_t i = num_sent; i < num_sent + static_cast<size_t>(ret); ++i) {
+            if (msgs[i].msg_len != _send_buffer.size()) {
+                LogErr() << "sendmmsg failure: only " << msgs[i].msg_len << " of "
+                         << _send_buffer.size() << " bytes sent";
+                send_successful = false;
+            }
+        }
+        num_sent += static_cast<size_t>(ret);
+    }
+#else
+    for (auto& dest_addr : dest_addrs) {
         const auto send_len = sendto(
             _socket_fd,
-            reinterpret_cast<char*>(buffer),
-            buffer_len,
+            reinterpret_cast<char*>(_send_buffer.data()),
+            static_cast<int>(_send_buffer.size()),
             0,
             reinterpret_cast<const sockaddr*>(&dest_addr),
             sizeof(dest_addr));
 
-        if (send_len != buffer_len) {
+        if (send_len != static_cast<decltype(send_len)>(_send_buffer.size())) {
             LogErr() << "sendto failure: " << GET_ERROR(errno);
             send_successful = false;
             continue;
         }
     }
+#endif
 
+    _send_buffer.clear();
     return send_successful;
 }
 
+void UdpConnection::send_thread()
+{
+    ThreadConfig::apply(ThreadRole::Send);
+
+    std::unique_lock<std::mutex> lock(_send_mutex);
+
+    while (!_should_exit) {
+        if (_send_buffer.empty()) {
+            _send_cv.wait(lock, [this]() { return !_send_buffer.empty() || _should_exit; });
+            continue;
+        }
+
+        // Frames can get flushed by send_message in the meantime, which
+        // moves the deadline, so we check again after every wake up.
+        if (std::chrono::steady_clock::now() < _send_deadline) {
+            _send_cv.wait_until(lock, _send_deadline);
+            continue;
+        }
+
+        flush_send_buffer();
+    }
+
+    // Don't lose anything still waiting.
+    flush_send_buffer();
+}
+
 void UdpConnection::add_remote(const std::string& remote_ip, const int remote_port)
 {
     add_remote_with_remote_sysid(remote_ip, remote_port, 0);
@@ -196,48 +558,135 @@ void UdpConnection::add_remote_with_remote_sysid(
     }
 }
 
-void UdpConnection::receive()
+size_t UdpConnection::memory_usage()
 {
-    // Enough for MTU 1500 bytes.
-    char buffer[2048];
+    size_t bytes = Connection::memory_usage();
+    {
+        std::lock_guard<std::mutex> lock(_send_mutex);
+        bytes += _send_buffer.capacity();
+    }
+    for (const auto& shard : _receive_shards) {
+        bytes += sizeof(ReceiveShard);
+#if defined(LINUX)
+        bytes += RECV_BATCH_SIZE * (sizeof(RecvBuffers::Datagram) + sizeof(struct iovec) +
+                                    sizeof(struct mmsghdr));
+#endif
+        if (shard->own_receiver) {
+            bytes += shard->own_receiver->memory_usage();
+        }
+    }
+    return bytes;
+}
+
+void UdpConnection::receive(ReceiveShard& shard)
+{
+    ThreadConfig::apply(ThreadRole::Receive);
 
     while (!_should_exit) {
-        struct sockaddr_in src_addr = {};
-        socklen_t src_addr_len = sizeof(src_addr);
-        const auto recv_len = recvfrom(
-            _socket_fd,
-            buffer,
-            sizeof(buffer),
-            0,
-            reinterpret_cast<struct sockaddr*>(&src_addr),
-            &src_addr_len);
+        receive_datagrams(shard, true);
+    }
+}
 
-        if (recv_len == 0) {
-            // This can happen when shutdown is called on the socket,
-            // therefore we check _should_exit again.
-            continue;
-        }
+void UdpConnection::receive_datagrams(ReceiveShard& shard, bool blocking)
+{
+    auto& buffers = shard.buffers;
+
+#if defined(LINUX)
+    for (unsigned i = 0; i < RECV_BATCH_SIZE; ++i) {
+        buffers.msgs[i] = {};
+        buffers.msgs[i].msg_hdr.msg_iov = &buffers.iovecs[i];
+        buffers.msgs[i].msg_hdr.msg_iovlen = 1;
+        buffers.msgs[i].msg_hdr.msg_name = &buffers.datagrams[i].src_addr;
+        buffers.msgs[i].msg_hdr.msg_namelen = sizeof(buffers.datagrams[i].src_addr);
+        buffers.msgs[i].msg_hdr.msg_control = buffers.datagrams[i].control;
+        buffers.msgs[i].msg_hdr.msg_controllen = sizeof(buffers.datagrams[i].control);
+    }
 
-        if (recv_len < 0) {
-            // This happens on destruction when close(_socket_fd) is called,
-            // therefore be quiet.
-            // LogErr() << "recvfrom error: " << GET_ERROR(errno);
+    // When blocking, we wait until there is at least one datagram, then
+    // take whatever else is already waiting.
+    const int num_received = recvmmsg(
+        shard.socket_fd,
+        buffers.msgs.data(),
+        RECV_BATCH_SIZE,
+        blocking ? MSG_WAITFORONE : MSG_DONTWAIT,
+        nullptr);
+
+    if (num_received <= 0) {
+        // This happens on destruction when close(_socket_fd) is called,
+        // therefore be quiet.
+        return;
+    }
+
+    for (int i = 0; i < num_received; ++i) {
+        if (buffers.msgs[i].msg_len == 0) {
             continue;
         }
+        process_datagram(
+            shard,
+            buffers.datagrams[i].buffer,
+            static_cast<int>(buffers.msgs[i].msg_len),
+            buffers.datagrams[i].src_addr,
+            kernel_receive_time_ns(buffers.msgs[i].msg_hdr));
+    }
+#else
+#if defined(MSG_DONTWAIT)
+    const int flags = blocking ? 0 : MSG_DONTWAIT;
+#else
+    const int flags = 0;
+    (void)blocking;
+#endif
 
-        _mavlink_receiver->set_new_datagram(buffer, static_cast<int>(recv_len));
+    struct sockaddr_in src_addr = {};
+    socklen_t src_addr_len = sizeof(src_addr);
+    const auto recv_len = recvfrom(
+        shard.socket_fd,
+        buffers.buffer,
+        sizeof(buffers.buffer),
+        flags,
+        reinterpret_cast<struct sockaddr*>(&src_addr),
+        &src_addr_len);
+
+    if (recv_len == 0) {
+        // This can happen when shutdown is called on the socket,
+        // therefore we check _should_exit again.
+        return;
+    }
 
-        // Parse all mavlink messages in one datagram. Once exhausted, we'll exit while.
-        while (_mavlink_receiver->parse_message()) {
-            const uint8_t sysid = _mavlink_receiver->get_last_message().sysid;
+    if (recv_len < 0) {
+        // This happens on destruction when close(_socket_fd) is called,
+        // therefore be quiet.
+        // LogErr() << "recvfrom error: " << GET_ERROR(errno);
+        return;
+    }
 
-            if (sysid != 0) {
-                add_remote_with_remote_sysid(
-                    inet_ntoa(src_addr.sin_addr), ntohs(src_addr.sin_port), sysid);
-            }
+    process_datagram(
+        shard, buffers.buffer, static_cast<int>(recv_len), src_addr, receive_time_now_ns());
+#endif
+}
 
-            receive_message(_mavlink_receiver->get_last_message(), this);
+void UdpConnection::process_datagram(
+    ReceiveShard& shard,
+    char* buffer,
+    int buffer_len,
+    const struct sockaddr_in& src_addr,
+    int64_t receive_time_ns)
+{
+    auto& receiver = *shard.receiver;
+    receiver.set_new_datagram(buffer, buffer_len, receive_time_ns);
+
+    ReceiveBurst::Scope receive_burst;
+    // Parse all mavlink messages in one datagram. Once exhausted, we'll exit while.
+    while (receiver.parse_message()) {
+        const uint8_t sysid = receiver.get_last_message().sysid;
+
+        if (sysid != 0) {
+            // Not inet_ntoa(), its buffer would be shared by the shards.
+            char src_ip[INET_ADDRSTRLEN]{};
+            inet_ntop(AF_INET, &src_addr.sin_addr, src_ip, sizeof(src_ip));
+            add_remote_with_remote_sysid(src_ip, ntohs(src_addr.sin_port), sysid);
         }
+
+        receive_message(receiver.get_last_message(), receiver, this);
     }
 }
 
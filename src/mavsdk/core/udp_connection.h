@@ -5,10 +5,14 @@
 #include <mutex>
 #include <thread>
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <vector>
 #include <cstdint>
 #include "connection.h"
 
+struct sockaddr_in;
+
 namespace mavsdk {
 
 class UdpConnection : public Connection {
@@ -23,18 +27,49 @@ public:
     ConnectionResult stop() override;
 
     bool send_message(const mavlink_message_t& message) override;
+    bool send_frames(const uint8_t* data, size_t len) override;
+    size_t memory_usage() override;
+    // Packs the messages into as few datagrams as possible.
+    bool send_messages(const std::vector<mavlink_message_t>& messages) override;
 
     void add_remote(const std::string& remote_ip, int remote_port);
 
+    // Outgoing frames are collected into one datagram for up to this long
+    // before they are sent. By default, they are sent immediately.
+    // This needs to be set before start().
+    void set_send_coalesce_delay_s(double delay_s);
+
+    // Receives and parses on this many threads, each with its own socket
+    // bound to the same port with SO_REUSEPORT. The kernel picks the socket
+    // by the sender's address, so what one sender sends is still received
+    // in order. This needs to be set before start(), and is only supported
+    // on Linux, elsewhere and for port 0, one thread is used.
+    void set_receive_threads(unsigned num_threads);
+
     // Non-copyable
     UdpConnection(const UdpConnection&) = delete;
     const UdpConnection& operator=(const UdpConnection&) = delete;
 
 private:
+    struct RecvBuffers;
+    struct ReceiveShard;
+
     ConnectionResult setup_port();
-    void start_recv_thread();
+    ConnectionResult open_socket(ReceiveShard& shard, bool reuse_port);
+    void start_recv_threads();
+    void start_send_thread();
 
-    void receive();
+    void receive(ReceiveShard& shard);
+    void receive_datagrams(ReceiveShard& shard, bool blocking);
+    void send_thread();
+    bool flush_send_buffer();
+    bool append_to_send_buffer(const uint8_t* frame, size_t frame_len);
+    void process_datagram(
+        ReceiveShard& shard,
+        char* buffer,
+        int buffer_len,
+        const struct sockaddr_in& src_addr,
+        int64_t receive_time_ns);
 
     void add_remote_with_remote_sysid(
         const std::string& remote_ip, int remote_port, uint8_t remote_sysid);
@@ -54,8 +89,25 @@ private:
     };
     std::vector<Remote> _remotes{};
 
+    // Keeps datagrams within an Ethernet MTU of 1500 bytes (minus IP and UDP headers).
+    static constexpr size_t MAX_SEND_DATAGRAM_LEN = 1472;
+
+    std::mutex _send_mutex{};
+    std::condition_variable _send_cv{};
+    std::vector<uint8_t> _send_buffer{};
+    std::chrono::steady_clock::time_point _send_deadline{};
+    double _send_coalesce_delay_s{0.0};
+    std::unique_ptr<std::thread> _send_thread{};
+
+    // Maximum number of datagrams fetched per syscall where supported.
+    static constexpr unsigned RECV_BATCH_SIZE = 16;
+
+    // Of the first shard, which is also used to send.
     int _socket_fd{-1};
-    std::unique_ptr<std::thread> _recv_thread{};
+    unsigned _num_receive_threads{1};
+    std::vector<std::unique_ptr<ReceiveShard>> _receive_shards{};
+    bool _uses_io_reactor{false};
+    bool _uses_io_uring{false};
     std::atomic_bool _should_exit{false};
 };
 
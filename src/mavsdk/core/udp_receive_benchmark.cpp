@@ -0,0 +1,139 @@
+#include "mavlink_include.h"
+#include <benchmark/benchmark.h>
+#include <array>
+#include <vector>
+
+#if defined(LINUX)
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+// Receiving datagrams one by one with recvfrom() against batches of 16 with
+// recvmmsg(), as UdpConnection does. Only the system calls are measured, the
+// datagrams are sent to a loopback socket beforehand.
+
+namespace {
+
+// As many as fit into the receive buffer, a multiple of the batch size.
+constexpr unsigned datagrams_per_iteration = 256;
+constexpr unsigned batch_size = 16;
+
+class LoopbackSockets {
+public:
+    LoopbackSockets()
+    {
+        receive_fd = socket(AF_INET, SOCK_DGRAM, 0);
+        send_fd = socket(AF_INET, SOCK_DGRAM, 0);
+
+        const int buffer_size = 4 * 1024 * 1024;
+        setsockopt(receive_fd, SOL_SOCKET, SO_RCVBUF, &buffer_size, sizeof(buffer_size));
+
+        struct sockaddr_in addr {};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = 0;
+        bind(receive_fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+        socklen_t addr_len = sizeof(addr);
+        getsockname(receive_fd, reinterpret_cast<sockaddr*>(&addr), &addr_len);
+        connect(send_fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+
+        // One attitude message per datagram, like most autopilots send them.
+        mavlink_message_t message;
+        mavlink_msg_attitude_pack(1, 1, &message, 0, 0.1f, 0.2f, 0.3f, 0.01f, 0.02f, 0.03f);
+        datagram.resize(MAVLINK_MAX_PACKET_LEN);
+        datagram.resize(mavlink_msg_to_send_buffer(
+            reinterpret_cast<uint8_t*>(datagram.data()), &message));
+    }
+
+    ~LoopbackSockets()
+    {
+        close(send_fd);
+        close(receive_fd);
+    }
+
+    void send_datagrams()
+    {
+        for (unsigned i = 0; i < datagrams_per_iteration; ++i) {
+            send(send_fd, datagram.data(), datagram.size(), 0);
+        }
+    }
+
+    int receive_fd{-1};
+    int send_fd{-1};
+    std::vector<char> datagram{};
+};
+
+} // namespace
+
+static void BM_UdpReceiveRecvfrom(benchmark::State& state)
+{
+    LoopbackSockets sockets;
+    char buffer[2048];
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        sockets.send_datagrams();
+        state.ResumeTiming();
+
+        for (unsigned i = 0; i < datagrams_per_iteration; ++i) {
+            struct sockaddr_in src_addr {};
+            socklen_t src_addr_len = sizeof(src_addr);
+            benchmark::DoNotOptimize(recvfrom(
+                sockets.receive_fd,
+                buffer,
+                sizeof(buffer),
+                MSG_DONTWAIT,
+                reinterpret_cast<sockaddr*>(&src_addr),
+                &src_addr_len));
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * datagrams_per_iteration);
+}
+BENCHMARK(BM_UdpReceiveRecvfrom);
+
+static void BM_UdpReceiveRecvmmsg(benchmark::State& state)
+{
+    LoopbackSockets sockets;
+
+    struct Datagram {
+        char buffer[2048];
+        struct sockaddr_in src_addr;
+    };
+    std::array<Datagram, batch_size> datagrams{};
+    std::array<struct iovec, batch_size> iovecs{};
+    std::array<struct mmsghdr, batch_size> msgs{};
+    for (unsigned i = 0; i < batch_size; ++i) {
+        iovecs[i].iov_base = datagrams[i].buffer;
+        iovecs[i].iov_len = sizeof(datagrams[i].buffer);
+    }
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        sockets.send_datagrams();
+        state.ResumeTiming();
+
+        unsigned received = 0;
+        while (received < datagrams_per_iteration) {
+            for (unsigned i = 0; i < batch_size; ++i) {
+                msgs[i] = {};
+                msgs[i].msg_hdr.msg_iov = &iovecs[i];
+                msgs[i].msg_hdr.msg_iovlen = 1;
+                msgs[i].msg_hdr.msg_name = &datagrams[i].src_addr;
+                msgs[i].msg_hdr.msg_namelen = sizeof(datagrams[i].src_addr);
+            }
+            const int num_received =
+                recvmmsg(sockets.receive_fd, msgs.data(), batch_size, MSG_DONTWAIT, nullptr);
+            if (num_received <= 0) {
+                break;
+            }
+            received += static_cast<unsigned>(num_received);
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * datagrams_per_iteration);
+}
+BENCHMARK(BM_UdpReceiveRecvmmsg);
+
+#endif
@@ -0,0 +1,459 @@
+#include "ulog_reader.h"
+#include "log.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <string_view>
+
+namespace mavsdk {
+
+namespace {
+
+constexpr uint8_t magic[] = {'U', 'L', 'o', 'g', 0x01, 0x12, 0x35};
+constexpr std::size_t file_header_size = sizeof(magic) + 1 + sizeof(uint64_t);
+
+// Size and type before every message.
+constexpr std::size_t message_header_size = sizeof(uint16_t) + sizeof(uint8_t);
+
+// Nested formats referring to themselves would never end.
+constexpr unsigned max_nesting_depth = 16;
+
+// Everything in the log is little-endian, as is everything we run on.
+template<typename T> T read_as(const uint8_t* data)
+{
+    T value;
+    std::memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+uint16_t read_u16(const uint8_t* data)
+{
+    return static_cast<uint16_t>(data[0] | (data[1] << 8));
+}
+
+struct BasicType {
+    std::string_view name;
+    ULogReader::FieldType type;
+    std::size_t size;
+};
+
+constexpr BasicType basic_types[] = {
+    {"int8_t", ULogReader::FieldType::Int8, 1},
+    {"uint8_t", ULogReader::FieldType::UInt8, 1},
+    {"int16_t", ULogReader::FieldType::Int16, 2},
+    {"uint16_t", ULogReader::FieldType::UInt16, 2},
+    {"int32_t", ULogReader::FieldType::Int32, 4},
+    {"uint32_t", ULogReader::FieldType::UInt32, 4},
+    {"int64_t", ULogReader::FieldType::Int64, 8},
+    {"uint64_t", ULogReader::FieldType::UInt64, 8},
+    {"float", ULogReader::FieldType::Float, 4},
+    {"double", ULogReader::FieldType::Double, 8},
+    {"bool", ULogReader::FieldType::Bool, 1},
+    {"char", ULogReader::FieldType::Char, 1},
+};
+
+// Parses e.g. "float[3] q" into the field, without offset yet.
+bool parse_field(std::string_view text, ULogReader::Field& field)
+{
+    const auto space = text.find(' ');
+    if (space == std::string_view::npos || space == 0 || space + 1 == text.size()) {
+        return false;
+    }
+    auto type = text.substr(0, space);
+    field.name = std::string(text.substr(space + 1));
+
+    field.array_size = 1;
+    const auto bracket = type.find('[');
+    if (bracket != std::string_view::npos) {
+        if (type.back() != ']' || bracket + 2 >= type.size()) {
+            return false;
+        }
+        std::size_t array_size = 0;
+        for (auto c : type.substr(bracket + 1, type.size() - bracket - 2)) {
+            if (c < '0' || c > '9') {
+                return false;
+            }
+            array_size = array_size * 10 + static_cast<std::size_t>(c - '0');
+        }
+        field.array_size = array_size;
+        type = type.substr(0, bracket);
+    }
+    field.type_name = std::string(type);
+
+    field.type = ULogReader::FieldType::Nested;
+    field.size = 0;
+    for (const auto& basic_type : basic_types) {
+        if (basic_type.name == type) {
+            field.type = basic_type.type;
+            field.size = basic_type.size;
+            break;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+const ULogReader::Field* ULogReader::Format::field(const std::string& field_name) const
+{
+    const auto it = std::find_if(fields.begin(), fields.end(), [&](const Field& field) {
+        return field.name == field_name;
+    });
+    return it != fields.end() ? &(*it) : nullptr;
+}
+
+uint64_t ULogReader::Sample::timestamp_us() const
+{
+    // Always logged first, so it is not looked up by name.
+    if (topic.format == nullptr || topic.format->fields.empty() ||
+        topic.format->fields.front().name != "timestamp" ||
+        topic.format->fields.front().type != FieldType::UInt64 ||
+        size < sizeof(uint64_t)) {
+        return 0;
+    }
+    return read_as<uint64_t>(data);
+}
+
+std::optional<double> ULogReader::Sample::value(const Field& field, std::size_t index) const
+{
+    const auto offset = field.offset + index * field.size;
+    if (index >= field.array_size || offset + field.size > size) {
+        return {};
+    }
+
+    const uint8_t* element = data + offset;
+    switch (field.type) {
+        case FieldType::Int8:
+            return read_as<int8_t>(element);
+        case FieldType::UInt8:
+            return read_as<uint8_t>(element);
+        case FieldType::Int16:
+            return read_as<int16_t>(element);
+        case FieldType::UInt16:
+            return read_as<uint16_t>(element);
+        case FieldType::Int32:
+            return read_as<int32_t>(element);
+        case FieldType::UInt32:
+            return read_as<uint32_t>(element);
+        case FieldType::Int64:
+            return static_cast<double>(read_as<int64_t>(element));
+        case FieldType::UInt64:
+            return static_cast<double>(read_as<uint64_t>(element));
+        case FieldType::Float:
+            return double(read_as<float>(element));
+        case FieldType::Double:
+            return read_as<double>(element);
+        case FieldType::Bool:
+            return element[0] != 0 ? 1.0 : 0.0;
+        case FieldType::Char:
+        case FieldType::Nested:
+            return {};
+    }
+    return {};
+}
+
+ULogReader::Result ULogReader::feed(const std::vector<uint8_t>& data)
+{
+    return feed(data.data(), data.size());
+}
+
+ULogReader::Result ULogReader::feed(const uint8_t* data, std::size_t size)
+{
+    while (_result == Result::Success && size > 0) {
+        if (!_header_read) {
+            const auto missing = file_header_size - _partial.size();
+            const auto taken = std::min(missing, size);
+            _partial.insert(_partial.end(), data, data + taken);
+            data += taken;
+            size -= taken;
+            if (_partial.size() < file_header_size) {
+                break;
+            }
+            if (std::memcmp(_partial.data(), magic, sizeof(magic)) != 0) {
+                LogWarn() << "Not a ULog file";
+                _result = Result::InvalidHeader;
+                break;
+            }
+            _start_timestamp_us = read_as<uint64_t>(_partial.data() + sizeof(magic) + 1);
+            _partial.clear();
+            _header_read = true;
+            continue;
+        }
+
+        if (!_partial.empty()) {
+            // Only the rest of the split message is copied, not the whole chunk.
+            auto missing = message_header_size - std::min(message_header_size, _partial.size());
+            if (missing == 0) {
+                missing = message_header_size + read_u16(_partial.data()) - _partial.size();
+            }
+            const auto taken = std::min(missing, size);
+            _partial.insert(_partial.end(), data, data + taken);
+            data += taken;
+            size -= taken;
+
+            if (_partial.size() < message_header_size ||
+                _partial.size() < message_header_size + read_u16(_partial.data())) {
+                continue;
+            }
+            if (!process_message(
+                    _partial[2],
+                    _partial.data() + message_header_size,
+                    _partial.size() - message_header_size)) {
+                _result = Result::InvalidMessage;
+            }
+            _partial.clear();
+            continue;
+        }
+
+        while (size >= message_header_size) {
+            const std::size_t message_size = message_header_size + read_u16(data);
+            if (size < message_size) {
+                break;
+            }
+            if (!process_message(
+                    data[2], data + message_header_size, message_size - message_header_size)) {
+                _result = Result::InvalidMessage;
+                return _result;
+            }
+            data += message_size;
+            size -= message_size;
+        }
+        _partial.assign(data, data + size);
+        size = 0;
+    }
+
+    return _result;
+}
+
+ULogReader::Result ULogReader::feed_file(const std::string& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        LogWarn() << "Could not open ULog file " << path;
+        return Result::FileError;
+    }
+
+    // Large chunks, so that hardly any message is split across two.
+    std::vector<uint8_t> chunk(1024 * 1024);
+    while (file) {
+        file.read(
+            reinterpret_cast<char*>(chunk.data()), static_cast<std::streamsize>(chunk.size()));
+        const auto read_size = static_cast<std::size_t>(file.gcount());
+        if (feed(chunk.data(), read_size) != Result::Success) {
+            break;
+        }
+    }
+
+    if (file.bad()) {
+        LogWarn() << "Could not read ULog file " << path;
+        return Result::FileError;
+    }
+    return _result;
+}
+
+bool ULogReader::process_message(uint8_t type, const uint8_t* payload, std::size_t size)
+{
+    switch (type) {
+        case 'F':
+            return process_format(payload, size);
+        case 'I':
+            return process_info(payload, size);
+        case 'A':
+            return process_add_logged(payload, size);
+        case 'D':
+            return process_data(payload, size);
+        case 'R':
+            if (size < sizeof(uint16_t)) {
+                return false;
+            }
+            if (const auto msg_id = read_u16(payload); msg_id < _subscriptions.size()) {
+                _subscriptions[msg_id].reset();
+            }
+            return true;
+        default:
+            // Flags, params, logged strings, sync and dropouts are of no use here.
+            return true;
+    }
+}
+
+bool ULogReader::process_format(const uint8_t* payload, std::size_t size)
+{
+    const std::string_view text(reinterpret_cast<const char*>(payload), size);
+    const auto colon = text.find(':');
+    if (colon == std::string_view::npos || colon == 0) {
+        LogWarn() << "Invalid ULog format";
+        return false;
+    }
+
+    Format format;
+    format.name = std::string(text.substr(0, colon));
+
+    auto fields = text.substr(colon + 1);
+    while (!fields.empty()) {
+        const auto end = std::min(fields.find(';'), fields.size());
+        if (end > 0) {
+            Field field;
+            if (!parse_field(fields.substr(0, end), field)) {
+                LogWarn() << "Invalid ULog field in format " << format.name;
+                return false;
+            }
+            format.fields.push_back(std::move(field));
+        }
+        fields.remove_prefix(std::min(end + 1, fields.size()));
+    }
+
+    // Topics already point to the first one.
+    _formats.emplace(format.name, std::move(format));
+    return true;
+}
+
+bool ULogReader::process_info(const uint8_t* payload, std::size_t size)
+{
+    if (size < 1 || size < 1u + payload[0]) {
+        return false;
+    }
+
+    // The key is the type and name of the value, e.g. "char[9] sys_name".
+    const std::string_view key(reinterpret_cast<const char*>(payload + 1), payload[0]);
+    const auto space = key.rfind(' ');
+    const auto name = space == std::string_view::npos ? key : key.substr(space + 1);
+    _info[std::string(name)] =
+        std::string(reinterpret_cast<const char*>(payload + 1 + payload[0]), size - 1 - payload[0]);
+    return true;
+}
+
+bool ULogReader::process_add_logged(const uint8_t* payload, std::size_t size)
+{
+    if (size < sizeof(uint8_t) + sizeof(uint16_t)) {
+        return false;
+    }
+
+    const auto msg_id = read_u16(payload + 1);
+    const std::string name(reinterpret_cast<const char*>(payload + 3), size - 3);
+
+    const auto it = _formats.find(name);
+    if (it == _formats.end() || !resolve(it->second, 0)) {
+        LogWarn() << "Unknown ULog format " << name;
+        return false;
+    }
+
+    if (msg_id >= _subscriptions.size()) {
+        _subscriptions.resize(msg_id + 1u);
+    }
+    auto& subscription = _subscriptions[msg_id].emplace();
+    subscription.topic = Topic{name, payload[0], &it->second};
+    bind_columns(subscription);
+    return true;
+}
+
+bool ULogReader::process_data(const uint8_t* payload, std::size_t size)
+{
+    if (size < sizeof(uint16_t)) {
+        return false;
+    }
+
+    const auto msg_id = read_u16(payload);
+    if (msg_id >= _subscriptions.size() || !_subscriptions[msg_id]) {
+        // Can happen after a dropout, the rest of the log is still fine.
+        return true;
+    }
+    auto& subscription = _subscriptions[msg_id].value();
+
+    const Sample sample{subscription.topic, payload + sizeof(uint16_t), size - sizeof(uint16_t)};
+
+    if (subscription.columns != nullptr) {
+        subscription.columns->timestamps_us.push_back(sample.timestamp_us());
+        for (auto& [field, column] : subscription.column_fields) {
+            column->push_back(sample.value(*field).value_or(NAN));
+        }
+    }
+
+    if (_sample_callback) {
+        _sample_callback(sample);
+    }
+    return true;
+}
+
+bool ULogReader::resolve(Format& format, unsigned depth)
+{
+    if (format.size > 0 || format.fields.empty()) {
+        return true;
+    }
+    if (depth > max_nesting_depth) {
+        return false;
+    }
+
+    // Offsets are only known once the formats nested in it are.
+    std::size_t offset = 0;
+    for (auto& field : format.fields) {
+        if (field.type == FieldType::Nested) {
+            const auto it = _formats.find(field.type_name);
+            if (it == _formats.end() || !resolve(it->second, depth + 1)) {
+                return false;
+            }
+            field.size = it->second.size;
+        }
+        field.offset = offset;
+        offset += field.size * field.array_size;
+    }
+    format.size = offset;
+    return true;
+}
+
+void ULogReader::set_sample_callback(SampleCallback callback)
+{
+    _sample_callback = std::move(callback);
+}
+
+void ULogReader::select_columns(const std::string& topic_name, std::vector<std::string> field_names)
+{
+    _selected_columns[topic_name] = std::move(field_names);
+
+    for (auto& subscription : _subscriptions) {
+        if (subscription && subscription->topic.name == topic_name) {
+            bind_columns(subscription.value());
+        }
+    }
+}
+
+void ULogReader::bind_columns(Subscription& subscription)
+{
+    const auto selected = _selected_columns.find(subscription.topic.name);
+    if (selected == _selected_columns.end()) {
+        return;
+    }
+
+    // Looked up once here, so that samples are only copied into place.
+    auto& columns = _columns[{subscription.topic.name, subscription.topic.multi_id}];
+    subscription.columns = &columns;
+    subscription.column_fields.clear();
+    for (const auto& field_name : selected->second) {
+        const auto* field = subscription.topic.format->field(field_name);
+        if (field == nullptr || field->array_size != 1 || field->type == FieldType::Char ||
+            field->type == FieldType::Nested) {
+            LogWarn() << "Cannot collect " << subscription.topic.name << "." << field_name;
+            continue;
+        }
+        subscription.column_fields.emplace_back(field, &columns.values[field_name]);
+    }
+}
+
+const ULogReader::Columns*
+ULogReader::columns(const std::string& topic_name, uint8_t multi_id) const
+{
+    const auto it = _columns.find({topic_name, multi_id});
+    return it != _columns.end() ? &it->second : nullptr;
+}
+
+std::optional<std::string> ULogReader::info(const std::string& key) const
+{
+    const auto it = _info.find(key);
+    if (it == _info.end()) {
+        return {};
+    }
+    return it->second;
+}
+
+} // namespace mavsdk
@@ -0,0 +1,286 @@
+#include "ulog_reader.h"
+#include "fs.h"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+
+using namespace mavsdk;
+
+namespace {
+
+// Writes logs as PX4 does, just enough of it for the reader.
+class ULogWriter {
+public:
+    explicit ULogWriter(uint64_t start_timestamp_us) :
+        bytes{'U', 'L', 'o', 'g', 0x01, 0x12, 0x35, 0x01}
+    {
+        append(start_timestamp_us);
+
+        // Flag bits, which are ignored.
+        message('B', std::vector<uint8_t>(40, 0));
+    }
+
+    void format(const std::string& format) { message('F', to_bytes(format)); }
+
+    void info(const std::string& key, const std::string& value)
+    {
+        auto payload = std::vector<uint8_t>{static_cast<uint8_t>(key.size())};
+        const auto key_bytes = to_bytes(key + value);
+        payload.insert(payload.end(), key_bytes.begin(), key_bytes.end());
+        message('I', payload);
+    }
+
+    void add_logged(uint8_t multi_id, uint16_t msg_id, const std::string& name)
+    {
+        auto payload = std::vector<uint8_t>{multi_id};
+        add(payload, msg_id);
+        const auto name_bytes = to_bytes(name);
+        payload.insert(payload.end(), name_bytes.begin(), name_bytes.end());
+        message('A', payload);
+    }
+
+    template<typename... Values> void data(uint16_t msg_id, Values... values)
+    {
+        std::vector<uint8_t> payload;
+        add(payload, msg_id);
+        (add(payload, values), ...);
+        message('D', payload);
+    }
+
+    std::vector<uint8_t> bytes{};
+
+private:
+    static std::vector<uint8_t> to_bytes(const std::string& text)
+    {
+        return {text.begin(), text.end()};
+    }
+
+    template<typename T> static void add(std::vector<uint8_t>& out, T value)
+    {
+        uint8_t value_bytes[sizeof(T)];
+        std::memcpy(value_bytes, &value, sizeof(T));
+        out.insert(out.end(), std::begin(value_bytes), std::end(value_bytes));
+    }
+
+    template<typename T> void append(T value) { add(bytes, value); }
+
+    void message(char type, const std::vector<uint8_t>& payload)
+    {
+        append(static_cast<uint16_t>(payload.size()));
+        append(static_cast<uint8_t>(type));
+        bytes.insert(bytes.end(), payload.begin(), payload.end());
+    }
+};
+
+ULogWriter attitude_log()
+{
+    ULogWriter writer(1234);
+    writer.info("char[4] sys_name", "PX4!");
+    writer.format("vehicle_attitude:uint64_t timestamp;float[4] q;uint8_t reset_counter;"
+                  "uint8_t[3] _padding0;");
+    writer.add_logged(0, 0, "vehicle_attitude");
+    writer.add_logged(1, 1, "vehicle_attitude");
+    for (uint64_t i = 0; i < 10; ++i) {
+        writer.data(
+            0,
+            uint64_t{1000 * i},
+            float(i),
+            0.0f,
+            0.0f,
+            0.0f,
+            static_cast<uint8_t>(i),
+            uint8_t{0},
+            uint8_t{0},
+            uint8_t{0});
+        writer.data(
+            1,
+            uint64_t{1000 * i + 1},
+            -float(i),
+            0.0f,
+            0.0f,
+            0.0f,
+            uint8_t{42},
+            uint8_t{0},
+            uint8_t{0},
+            uint8_t{0});
+    }
+    return writer;
+}
+
+} // namespace
+
+TEST(ULogReader, ReadsHeaderFormatsAndInfo)
+{
+    const auto log = attitude_log();
+
+    ULogReader reader;
+    EXPECT_EQ(reader.feed(log.bytes), ULogReader::Result::Success);
+    EXPECT_EQ(reader.start_timestamp_us(), 1234);
+    EXPECT_EQ(reader.info("sys_name"), std::optional<std::string>("PX4!"));
+
+    ASSERT_EQ(reader.formats().count("vehicle_attitude"), 1);
+    const auto& format = reader.formats().at("vehicle_attitude");
+    EXPECT_EQ(format.size, 28);
+
+    const auto* q = format.field("q");
+    ASSERT_NE(q, nullptr);
+    EXPECT_EQ(q->type, ULogReader::FieldType::Float);
+    EXPECT_EQ(q->offset, 8);
+    EXPECT_EQ(q->array_size, 4);
+
+    const auto* reset_counter = format.field("reset_counter");
+    ASSERT_NE(reset_counter, nullptr);
+    EXPECT_EQ(reset_counter->offset, 24);
+}
+
+TEST(ULogReader, SamplesAreReadWhereTheyWereFed)
+{
+    const auto log = attitude_log();
+
+    ULogReader reader;
+    unsigned num_samples = 0;
+    reader.set_sample_callback([&](const ULogReader::Sample& sample) {
+        EXPECT_GE(sample.data, log.bytes.data());
+        EXPECT_LE(sample.data + sample.size, log.bytes.data() + log.bytes.size());
+
+        const auto* q = sample.topic.format->field("q");
+        ASSERT_NE(q, nullptr);
+        const auto expected = double(num_samples / 2) * (sample.topic.multi_id == 0 ? 1 : -1);
+        EXPECT_EQ(sample.value(*q), std::optional<double>(expected));
+        EXPECT_EQ(sample.value(*q, 3), std::optional<double>(0.0));
+        EXPECT_FALSE(sample.value(*q, 4));
+        EXPECT_EQ(sample.timestamp_us(), 1000 * (num_samples / 2) + sample.topic.multi_id);
+        ++num_samples;
+    });
+
+    EXPECT_EQ(reader.feed(log.bytes), ULogReader::Result::Success);
+    EXPECT_EQ(num_samples, 20);
+}
+
+TEST(ULogReader, ChunksCanSplitMessages)
+{
+    const auto log = attitude_log();
+
+    ULogReader whole;
+    whole.select_columns("vehicle_attitude", {"timestamp", "reset_counter"});
+    EXPECT_EQ(whole.feed(log.bytes), ULogReader::Result::Success);
+
+    for (const std::size_t chunk_size : {1u, 2u, 3u, 7u, 100u}) {
+        ULogReader chunked;
+        chunked.select_columns("vehicle_attitude", {"timestamp", "reset_counter"});
+        for (std::size_t offset = 0; offset < log.bytes.size(); offset += chunk_size) {
+            EXPECT_EQ(
+                chunked.feed(
+                    log.bytes.data() + offset, std::min(chunk_size, log.bytes.size() - offset)),
+                ULogReader::Result::Success);
+        }
+
+        for (const uint8_t multi_id : {0, 1}) {
+            ASSERT_NE(chunked.columns("vehicle_attitude", multi_id), nullptr);
+            EXPECT_EQ(
+                chunked.columns("vehicle_attitude", multi_id)->timestamps_us,
+                whole.columns("vehicle_attitude", multi_id)->timestamps_us);
+            EXPECT_EQ(
+                chunked.columns("vehicle_attitude", multi_id)->values,
+                whole.columns("vehicle_attitude", multi_id)->values);
+        }
+    }
+}
+
+TEST(ULogReader, SelectedFieldsAreCollectedIntoColumns)
+{
+    const auto log = attitude_log();
+
+    ULogReader reader;
+    reader.select_columns("vehicle_attitude", {"reset_counter", "q", "unknown"});
+    EXPECT_EQ(reader.feed(log.bytes), ULogReader::Result::Success);
+    EXPECT_EQ(reader.columns("other_topic"), nullptr);
+
+    const auto* first = reader.columns("vehicle_attitude", 0);
+    ASSERT_NE(first, nullptr);
+    EXPECT_EQ(first->timestamps_us.size(), 10);
+    EXPECT_EQ(first->timestamps_us.back(), 9000);
+
+    // Arrays and unknown fields can't be collected.
+    EXPECT_EQ(first->values.size(), 1);
+    ASSERT_EQ(first->values.count("reset_counter"), 1);
+    EXPECT_EQ(first->values.at("reset_counter").at(3), 3.0);
+
+    const auto* second = reader.columns("vehicle_attitude", 1);
+    ASSERT_NE(second, nullptr);
+    EXPECT_EQ(second->values.at("reset_counter"), std::vector<double>(10, 42.0));
+}
+
+TEST(ULogReader, NestedFormatsAreResolvedWhenUsed)
+{
+    ULogWriter writer(0);
+    // The nested format only comes after the one using it.
+    writer.format("outer:uint64_t timestamp;inner[2] inners;int16_t last;");
+    writer.format("inner:uint8_t a;double b;");
+    writer.add_logged(0, 3, "outer");
+    writer.data(3, uint64_t{5}, uint8_t{1}, 1.5, uint8_t{2}, 2.5, int16_t{-7});
+
+    ULogReader reader;
+    reader.select_columns("outer", {"last"});
+    EXPECT_EQ(reader.feed(writer.bytes), ULogReader::Result::Success);
+
+    const auto& outer = reader.formats().at("outer");
+    EXPECT_EQ(outer.size, 8 + 2 * 9 + 2);
+    ASSERT_NE(outer.field("last"), nullptr);
+    EXPECT_EQ(outer.field("last")->offset, 26);
+
+    ASSERT_NE(reader.columns("outer"), nullptr);
+    EXPECT_EQ(reader.columns("outer")->values.at("last"), std::vector<double>{-7.0});
+}
+
+TEST(ULogReader, TruncatedSamplesHaveNoValue)
+{
+    ULogWriter writer(0);
+    writer.format("topic:uint64_t timestamp;float x;float y;");
+    writer.add_logged(0, 0, "topic");
+    writer.data(0, uint64_t{1}, 1.0f);
+
+    ULogReader reader;
+    reader.select_columns("topic", {"x", "y"});
+    EXPECT_EQ(reader.feed(writer.bytes), ULogReader::Result::Success);
+    EXPECT_EQ(reader.columns("topic")->values.at("x"), std::vector<double>{1.0});
+    ASSERT_EQ(reader.columns("topic")->values.at("y").size(), 1);
+    EXPECT_TRUE(std::isnan(reader.columns("topic")->values.at("y").front()));
+}
+
+TEST(ULogReader, ErrorsStopReading)
+{
+    const std::vector<uint8_t> not_ulog(100, 'x');
+    ULogReader reader;
+    EXPECT_EQ(reader.feed(not_ulog), ULogReader::Result::InvalidHeader);
+    EXPECT_EQ(reader.feed(attitude_log().bytes), ULogReader::Result::InvalidHeader);
+
+    ULogWriter writer(0);
+    writer.add_logged(0, 0, "unknown_format");
+    ULogReader broken;
+    EXPECT_EQ(broken.feed(writer.bytes), ULogReader::Result::InvalidMessage);
+}
+
+TEST(ULogReader, ReadsFiles)
+{
+    auto tmp_dir = create_tmp_directory("mavsdk-ulog-reader-test");
+    ASSERT_TRUE(tmp_dir);
+    const auto path = tmp_dir.value() + "/attitude.ulg";
+    {
+        const auto log = attitude_log();
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file.write(
+            reinterpret_cast<const char*>(log.bytes.data()),
+            static_cast<std::streamsize>(log.bytes.size()));
+    }
+
+    ULogReader reader;
+    reader.select_columns("vehicle_attitude", {"reset_counter"});
+    EXPECT_EQ(reader.feed_file(path), ULogReader::Result::Success);
+    ASSERT_NE(reader.columns("vehicle_attitude"), nullptr);
+    EXPECT_EQ(reader.columns("vehicle_attitude")->timestamps_us.size(), 10);
+
+    ULogReader missing;
+    EXPECT_EQ(missing.feed_file(path + ".missing"), ULogReader::Result::FileError);
+}
@@ -0,0 +1,102 @@
+#include "xz_compression.h"
+#include "log.h"
+#include "unused.h"
+
+#include <algorithm>
+#include <array>
+
+#if defined(MAVSDK_WITH_LZMA)
+#include <lzma.h>
+#endif
+
+namespace mavsdk {
+
+bool xz_supported()
+{
+#if defined(MAVSDK_WITH_LZMA)
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool is_xz_compressed(const std::vector<uint8_t>& content)
+{
+    static constexpr std::array<uint8_t, 6> magic{0xfd, '7', 'z', 'X', 'Z', 0x00};
+    return content.size() >= magic.size() &&
+           std::equal(magic.begin(), magic.end(), content.begin());
+}
+
+std::optional<std::vector<uint8_t>>
+xz_compress(const uint8_t* data, std::size_t size, uint32_t preset)
+{
+#if defined(MAVSDK_WITH_LZMA)
+    // Single threaded, and with a CRC32 check which all decoders support.
+    std::vector<uint8_t> result(lzma_stream_buffer_bound(size));
+    size_t result_size = 0;
+
+    const auto ret = lzma_easy_buffer_encode(
+        preset,
+        LZMA_CHECK_CRC32,
+        nullptr,
+        data,
+        size,
+        result.data(),
+        &result_size,
+        result.size());
+
+    if (ret != LZMA_OK) {
+        LogErr() << "Could not compress with xz: " << static_cast<int>(ret);
+        return {};
+    }
+
+    result.resize(result_size);
+    return {std::move(result)};
+#else
+    UNUSED(data);
+    UNUSED(size);
+    UNUSED(preset);
+    return {};
+#endif
+}
+
+std::optional<std::vector<uint8_t>> xz_decompress(const std::vector<uint8_t>& content)
+{
+#if defined(MAVSDK_WITH_LZMA)
+    // Way more than the parameter metadata of PX4, just to stop broken input.
+    static constexpr uint64_t max_memory = 256 * 1024 * 1024;
+
+    lzma_stream stream = LZMA_STREAM_INIT;
+    if (lzma_stream_decoder(&stream, max_memory, LZMA_CONCATENATED) != LZMA_OK) {
+        LogErr() << "Could not create xz decoder";
+        return {};
+    }
+
+    // Decoded a chunk at a time, so there is no need to know the size upfront.
+    std::vector<uint8_t> result;
+    std::array<uint8_t, 64 * 1024> chunk;
+    stream.next_in = content.data();
+    stream.avail_in = content.size();
+
+    lzma_ret ret = LZMA_OK;
+    while (ret == LZMA_OK) {
+        stream.next_out = chunk.data();
+        stream.avail_out = chunk.size();
+        ret = lzma_code(&stream, LZMA_FINISH);
+        result.insert(result.end(), chunk.data(), stream.next_out);
+    }
+    lzma_end(&stream);
+
+    if (ret != LZMA_STREAM_END) {
+        LogErr() << "Could not decompress xz: " << static_cast<int>(ret);
+        return {};
+    }
+    return {std::move(result)};
+#else
+    UNUSED(content);
+    LogErr() << "Built without liblzma, can't decompress xz";
+    return {};
+#endif
+}
+
+} // namespace mavsdk
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace mavsdk {
+
+// xz (liblzma) compression, as used for component metadata and compressed
+// FTP downloads. Without liblzma, compressing and decompressing always fail,
+// see xz_supported().
+
+bool xz_supported();
+
+// Recognized by the magic bytes at the start.
+bool is_xz_compressed(const std::vector<uint8_t>& content);
+
+// The preset goes from 0 (fastest) to 9 (smallest). The output only depends
+// on the content and the preset.
+std::optional<std::vector<uint8_t>>
+xz_compress(const uint8_t* data, std::size_t size, uint32_t preset = 6);
+
+// Returns nothing if the content is corrupt, or if we are built without
+// liblzma.
+std::optional<std::vector<uint8_t>> xz_decompress(const std::vector<uint8_t>& content);
+
+} // namespace mavsdk
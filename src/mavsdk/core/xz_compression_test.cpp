@@ -0,0 +1,67 @@
+#include "xz_compression.h"
+
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+
+using namespace mavsdk;
+
+namespace {
+
+std::vector<uint8_t> to_bytes(const std::string& str)
+{
+    return {str.begin(), str.end()};
+}
+
+// {"version": 1, "parameters": []}, compressed with xz.
+const std::vector<uint8_t> xz_content{
+    0xfd, 0x37, 0x7a, 0x58, 0x5a, 0x00, 0x00, 0x01, 0x69, 0x22, 0xde, 0x36, 0x02, 0x00,
+    0x21, 0x01, 0x16, 0x00, 0x00, 0x00, 0x74, 0x2f, 0xe5, 0xa3, 0x01, 0x00, 0x1f, 0x7b,
+    0x22, 0x76, 0x65, 0x72, 0x73, 0x69, 0x6f, 0x6e, 0x22, 0x3a, 0x20, 0x31, 0x2c, 0x20,
+    0x22, 0x70, 0x61, 0x72, 0x61, 0x6d, 0x65, 0x74, 0x65, 0x72, 0x73, 0x22, 0x3a, 0x20,
+    0x5b, 0x5d, 0x7d, 0x00, 0x32, 0x73, 0xd8, 0x34, 0x00, 0x01, 0x34, 0x20, 0x14, 0x66,
+    0xc2, 0xa0, 0x90, 0x42, 0x99, 0x0d, 0x01, 0x00, 0x00, 0x00, 0x00, 0x01, 0x59, 0x5a};
+
+} // namespace
+
+TEST(XzCompression, RecognizesXz)
+{
+    EXPECT_TRUE(is_xz_compressed(xz_content));
+    EXPECT_FALSE(is_xz_compressed(to_bytes("{\"version\": 1}")));
+    EXPECT_FALSE(is_xz_compressed({}));
+}
+
+TEST(XzCompression, Decompresses)
+{
+    if (!xz_supported()) {
+        GTEST_SKIP() << "Built without liblzma";
+    }
+
+    const auto result = xz_decompress(xz_content);
+    ASSERT_TRUE(result);
+    EXPECT_EQ(result.value(), to_bytes("{\"version\": 1, \"parameters\": []}"));
+
+    auto corrupt = xz_content;
+    corrupt[40] ^= 0xff;
+    EXPECT_FALSE(xz_decompress(corrupt));
+}
+
+TEST(XzCompression, RoundTrip)
+{
+    if (!xz_supported()) {
+        GTEST_SKIP() << "Built without liblzma";
+    }
+
+    std::string csv;
+    for (int i = 0; i < 1000; ++i) {
+        csv += std::to_string(i) + ",47.397742,8.545594,488.0\n";
+    }
+    const auto content = to_bytes(csv);
+
+    const auto compressed = xz_compress(content.data(), content.size(), 1);
+    ASSERT_TRUE(compressed);
+    EXPECT_TRUE(is_xz_compressed(compressed.value()));
+    EXPECT_LT(compressed->size(), content.size() / 5);
+
+    EXPECT_EQ(xz_decompress(compressed.value()), content);
+}
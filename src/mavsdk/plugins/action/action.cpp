@@ -18,7 +18,7 @@ Action::Action(std::shared_ptr<System> system) :
 
 Action::~Action() {}
 
-void Action::arm_async(const ResultCallback callback)
+void Action::arm_async(const ResultCallback& callback)
 {
     _impl->arm_async(callback);
 }
@@ -28,7 +28,7 @@ Action::Result Action::arm() const
     return _impl->arm();
 }
 
-void Action::disarm_async(const ResultCallback callback)
+void Action::disarm_async(const ResultCallback& callback)
 {
     _impl->disarm_async(callback);
 }
@@ -38,7 +38,7 @@ Action::Result Action::disarm() const
     return _impl->disarm();
 }
 
-void Action::takeoff_async(const ResultCallback callback)
+void Action::takeoff_async(const ResultCallback& callback)
 {
     _impl->takeoff_async(callback);
 }
@@ -48,7 +48,7 @@ Action::Result Action::takeoff() const
     return _impl->takeoff();
 }
 
-void Action::land_async(const ResultCallback callback)
+void Action::land_async(const ResultCallback& callback)
 {
     _impl->land_async(callback);
 }
@@ -58,7 +58,7 @@ Action::Result Action::land() const
     return _impl->land();
 }
 
-void Action::reboot_async(const ResultCallback callback)
+void Action::reboot_async(const ResultCallback& callback)
 {
     _impl->reboot_async(callback);
 }
@@ -68,7 +68,7 @@ Action::Result Action::reboot() const
     return _impl->reboot();
 }
 
-void Action::shutdown_async(const ResultCallback callback)
+void Action::shutdown_async(const ResultCallback& callback)
 {
     _impl->shutdown_async(callback);
 }
@@ -78,7 +78,7 @@ Action::Result Action::shutdown() const
     return _impl->shutdown();
 }
 
-void Action::terminate_async(const ResultCallback callback)
+void Action::terminate_async(const ResultCallback& callback)
 {
     _impl->terminate_async(callback);
 }
@@ -88,7 +88,7 @@ Action::Result Action::terminate() const
     return _impl->terminate();
 }
 
-void Action::kill_async(const ResultCallback callback)
+void Action::kill_async(const ResultCallback& callback)
 {
     _impl->kill_async(callback);
 }
@@ -98,7 +98,7 @@ Action::Result Action::kill() const
     return _impl->kill();
 }
 
-void Action::return_to_launch_async(const ResultCallback callback)
+void Action::return_to_launch_async(const ResultCallback& callback)
 {
     _impl->return_to_launch_async(callback);
 }
@@ -113,7 +113,7 @@ void Action::goto_location_async(
     double longitude_deg,
     float absolute_altitude_m,
     float yaw_deg,
-    const ResultCallback callback)
+    const ResultCallback& callback)
 {
     _impl->goto_location_async(latitude_deg, longitude_deg, absolute_altitude_m, yaw_deg, callback);
 }
@@ -131,7 +131,7 @@ void Action::do_orbit_async(
     double latitude_deg,
     double longitude_deg,
     double absolute_altitude_m,
-    const ResultCallback callback)
+    const ResultCallback& callback)
 {
     _impl->do_orbit_async(
         radius_m,
@@ -155,7 +155,7 @@ Action::Result Action::do_orbit(
         radius_m, velocity_ms, yaw_behavior, latitude_deg, longitude_deg, absolute_altitude_m);
 }
 
-void Action::hold_async(const ResultCallback callback)
+void Action::hold_async(const ResultCallback& callback)
 {
     _impl->hold_async(callback);
 }
@@ -165,7 +165,7 @@ Action::Result Action::hold() const
     return _impl->hold();
 }
 
-void Action::set_actuator_async(int32_t index, float value, const ResultCallback callback)
+void Action::set_actuator_async(int32_t index, float value, const ResultCallback& callback)
 {
     _impl->set_actuator_async(index, value, callback);
 }
@@ -175,7 +175,7 @@ Action::Result Action::set_actuator(int32_t index, float value) const
     return _impl->set_actuator(index, value);
 }
 
-void Action::transition_to_fixedwing_async(const ResultCallback callback)
+void Action::transition_to_fixedwing_async(const ResultCallback& callback)
 {
     _impl->transition_to_fixedwing_async(callback);
 }
@@ -185,7 +185,7 @@ Action::Result Action::transition_to_fixedwing() const
     return _impl->transition_to_fixedwing();
 }
 
-void Action::transition_to_multicopter_async(const ResultCallback callback)
+void Action::transition_to_multicopter_async(const ResultCallback& callback)
 {
     _impl->transition_to_multicopter_async(callback);
 }
@@ -195,7 +195,7 @@ Action::Result Action::transition_to_multicopter() const
     return _impl->transition_to_multicopter();
 }
 
-void Action::get_takeoff_altitude_async(const GetTakeoffAltitudeCallback callback)
+void Action::get_takeoff_altitude_async(const GetTakeoffAltitudeCallback& callback)
 {
     _impl->get_takeoff_altitude_async(callback);
 }
@@ -205,7 +205,7 @@ std::pair<Action::Result, float> Action::get_takeoff_altitude() const
     return _impl->get_takeoff_altitude();
 }
 
-void Action::set_takeoff_altitude_async(float altitude, const ResultCallback callback)
+void Action::set_takeoff_altitude_async(float altitude, const ResultCallback& callback)
 {
     _impl->set_takeoff_altitude_async(altitude, callback);
 }
@@ -215,7 +215,7 @@ Action::Result Action::set_takeoff_altitude(float altitude) const
     return _impl->set_takeoff_altitude(altitude);
 }
 
-void Action::get_maximum_speed_async(const GetMaximumSpeedCallback callback)
+void Action::get_maximum_speed_async(const GetMaximumSpeedCallback& callback)
 {
     _impl->get_maximum_speed_async(callback);
 }
@@ -225,7 +225,7 @@ std::pair<Action::Result, float> Action::get_maximum_speed() const
     return _impl->get_maximum_speed();
 }
 
-void Action::set_maximum_speed_async(float speed, const ResultCallback callback)
+void Action::set_maximum_speed_async(float speed, const ResultCallback& callback)
 {
     _impl->set_maximum_speed_async(speed, callback);
 }
@@ -235,7 +235,7 @@ Action::Result Action::set_maximum_speed(float speed) const
     return _impl->set_maximum_speed(speed);
 }
 
-void Action::get_return_to_launch_altitude_async(const GetReturnToLaunchAltitudeCallback callback)
+void Action::get_return_to_launch_altitude_async(const GetReturnToLaunchAltitudeCallback& callback)
 {
     _impl->get_return_to_launch_altitude_async(callback);
 }
@@ -246,7 +246,7 @@ std::pair<Action::Result, float> Action::get_return_to_launch_altitude() const
 }
 
 void Action::set_return_to_launch_altitude_async(
-    float relative_altitude_m, const ResultCallback callback)
+    float relative_altitude_m, const ResultCallback& callback)
 {
     _impl->set_return_to_launch_altitude_async(relative_altitude_m, callback);
 }
@@ -256,7 +256,7 @@ Action::Result Action::set_return_to_launch_altitude(float relative_altitude_m)
     return _impl->set_return_to_launch_altitude(relative_altitude_m);
 }
 
-void Action::set_current_speed_async(float speed_m_s, const ResultCallback callback)
+void Action::set_current_speed_async(float speed_m_s, const ResultCallback& callback)
 {
     _impl->set_current_speed_async(speed_m_s, callback);
 }
@@ -1,8 +1,10 @@
 #include "action_impl.h"
 #include "mavsdk_impl.h"
+#include "decoded_message.h"
 #include "mavsdk_math.h"
 #include "flight_mode.h"
 #include "px4_custom_mode.h"
+#include "sync_callback.h"
 #include <cmath>
 #include <future>
 
@@ -47,7 +49,8 @@ void ActionImpl::enable()
         MAVLINK_MSG_ID_EXTENDED_SYS_STATE,
         1.0,
         nullptr,
-        MavlinkCommandSender::DEFAULT_COMPONENT_ID_AUTOPILOT);
+        MavlinkCommandSender::DEFAULT_COMPONENT_ID_AUTOPILOT,
+        this);
 }
 
 void ActionImpl::disable() {}
@@ -57,7 +60,8 @@ Action::Result ActionImpl::arm() const
     auto prom = std::promise<Action::Result>();
     auto fut = prom.get_future();
 
-    arm_async([&prom](Action::Result result) { prom.set_value(result); });
+    arm_async(make_sync_callback<Action::ResultCallback>(
+        [&prom](Action::Result result) { prom.set_value(result); }));
 
     return fut.get();
 }
@@ -67,7 +71,8 @@ Action::Result ActionImpl::disarm() const
     auto prom = std::promise<Action::Result>();
     auto fut = prom.get_future();
 
-    disarm_async([&prom](Action::Result result) { prom.set_value(result); });
+    disarm_async(make_sync_callback<Action::ResultCallback>(
+        [&prom](Action::Result result) { prom.set_value(result); }));
 
     return fut.get();
 }
@@ -77,7 +82,8 @@ Action::Result ActionImpl::terminate() const
     auto prom = std::promise<Action::Result>();
     auto fut = prom.get_future();
 
-    terminate_async([&prom](Action::Result result) { prom.set_value(result); });
+    terminate_async(make_sync_callback<Action::ResultCallback>(
+        [&prom](Action::Result result) { prom.set_value(result); }));
 
     return fut.get();
 }
@@ -87,7 +93,8 @@ Action::Result ActionImpl::kill() const
     auto prom = std::promise<Action::Result>();
     auto fut = prom.get_future();
 
-    kill_async([&prom](Action::Result result) { prom.set_value(result); });
+    kill_async(make_sync_callback<Action::ResultCallback>(
+        [&prom](Action::Result result) { prom.set_value(result); }));
 
     return fut.get();
 }
@@ -97,7 +104,8 @@ Action::Result ActionImpl::reboot() const
     auto prom = std::promise<Action::Result>();
     auto fut = prom.get_future();
 
-    reboot_async([&prom](Action::Result result) { prom.set_value(result); });
+    reboot_async(make_sync_callback<Action::ResultCallback>(
+        [&prom](Action::Result result) { prom.set_value(result); }));
 
     return fut.get();
 }
@@ -107,7 +115,8 @@ Action::Result ActionImpl::shutdown() const
     auto prom = std::promise<Action::Result>();
     auto fut = prom.get_future();
 
-    shutdown_async([&prom](Action::Result result) { prom.set_value(result); });
+    shutdown_async(make_sync_callback<Action::ResultCallback>(
+        [&prom](Action::Result result) { prom.set_value(result); }));
 
     return fut.get();
 }
@@ -117,7 +126,8 @@ Action::Result ActionImpl::takeoff() const
     auto prom = std::promise<Action::Result>();
     auto fut = prom.get_future();
 
-    takeoff_async([&prom](Action::Result result) { prom.set_value(result); });
+    takeoff_async(make_sync_callback<Action::ResultCallback>(
+        [&prom](Action::Result result) { prom.set_value(result); }));
 
     return fut.get();
 }
@@ -127,7 +137,8 @@ Action::Result ActionImpl::land() const
     auto prom = std::promise<Action::Result>();
     auto fut = prom.get_future();
 
-    land_async([&prom](Action::Result result) { prom.set_value(result); });
+    land_async(make_sync_callback<Action::ResultCallback>(
+        [&prom](Action::Result result) { prom.set_value(result); }));
 
     return fut.get();
 }
@@ -137,7 +148,8 @@ Action::Result ActionImpl::return_to_launch() const
     auto prom = std::promise<Action::Result>();
     auto fut = prom.get_future();
 
-    return_to_launch_async([&prom](Action::Result result) { prom.set_value(result); });
+    return_to_launch_async(make_sync_callback<Action::ResultCallback>(
+        [&prom](Action::Result result) { prom.set_value(result); }));
 
     return fut.get();
 }
@@ -152,9 +164,12 @@ Action::Result ActionImpl::goto_location(
     auto fut = prom.get_future();
 
     goto_location_async(
-        latitude_deg, longitude_deg, altitude_amsl_m, yaw_deg, [&prom](Action::Result result) {
-            prom.set_value(result);
-        });
+        latitude_deg,
+        longitude_deg,
+        altitude_amsl_m,
+        yaw_deg,
+        make_sync_callback<Action::ResultCallback>(
+            [&prom](Action::Result result) { prom.set_value(result); }));
 
     return fut.get();
 }
@@ -177,7 +192,8 @@ Action::Result ActionImpl::do_orbit(
         latitude_deg,
         longitude_deg,
         absolute_altitude_m,
-        [&prom](Action::Result result) { prom.set_value(result); });
+        make_sync_callback<Action::ResultCallback>(
+            [&prom](Action::Result result) { prom.set_value(result); }));
 
     return fut.get();
 }
@@ -187,7 +203,8 @@ Action::Result ActionImpl::hold() const
     auto prom = std::promise<Action::Result>();
     auto fut = prom.get_future();
 
-    hold_async([&prom](Action::Result result) { prom.set_value(result); });
+    hold_async(make_sync_callback<Action::ResultCallback>(
+        [&prom](Action::Result result) { prom.set_value(result); }));
 
     return fut.get();
 }
@@ -197,7 +214,11 @@ Action::Result ActionImpl::set_actuator(const int index, const float value)
     auto prom = std::promise<Action::Result>();
     auto fut = prom.get_future();
 
-    set_actuator_async(index, value, [&prom](Action::Result result) { prom.set_value(result); });
+    set_actuator_async(
+        index,
+        value,
+        make_sync_callback<Action::ResultCallback>(
+            [&prom](Action::Result result) { prom.set_value(result); }));
 
     return fut.get();
 }
@@ -207,7 +228,8 @@ Action::Result ActionImpl::transition_to_fixedwing() const
     auto prom = std::promise<Action::Result>();
     auto fut = prom.get_future();
 
-    transition_to_fixedwing_async([&prom](Action::Result result) { prom.set_value(result); });
+    transition_to_fixedwing_async(make_sync_callback<Action::ResultCallback>(
+        [&prom](Action::Result result) { prom.set_value(result); }));
 
     return fut.get();
 }
@@ -217,7 +239,8 @@ Action::Result ActionImpl::transition_to_multicopter() const
     auto prom = std::promise<Action::Result>();
     auto fut = prom.get_future();
 
-    transition_to_multicopter_async([&prom](Action::Result result) { prom.set_value(result); });
+    transition_to_multicopter_async(make_sync_callback<Action::ResultCallback>(
+        [&prom](Action::Result result) { prom.set_value(result); }));
 
     return fut.get();
 }
@@ -231,24 +254,24 @@ void ActionImpl::arm_async(const Action::ResultCallback& callback) const
         command.params.maybe_param1 = 1.0f; // arm
         command.target_component_id = _system_impl->get_autopilot_id();
 
-        _system_impl->send_command_async(
-            command, [this, callback](MavlinkCommandSender::Result result, float) {
-                command_result_callback(result, callback);
-            });
+        _system_impl->send_command_async(command, command_callback(callback));
     };
 
     if (need_hold_before_arm()) {
         _system_impl->set_flight_mode_async(
             FlightMode::Hold,
-            [callback, send_arm_command](MavlinkCommandSender::Result result, float) {
-                Action::Result action_result = action_result_from_command_result(result);
-                if (action_result != Action::Result::Success) {
-                    if (callback) {
-                        callback(action_result);
+            make_callback_like<MavlinkCommandSender::CommandResultCallback>(
+                callback,
+                [callback, send_arm_command](MavlinkCommandSender::Result result, float) {
+                    Action::Result action_result = action_result_from_command_result(result);
+                    if (action_result != Action::Result::Success) {
+                        if (callback) {
+                            callback(action_result);
+                        }
+                        return;
                     }
-                }
-                send_arm_command();
-            });
+                    send_arm_command();
+                }));
         return;
     } else {
         send_arm_command();
@@ -293,10 +316,7 @@ void ActionImpl::disarm_async(const Action::ResultCallback& callback) const
     command.params.maybe_param1 = 0.0f; // disarm
     command.target_component_id = _system_impl->get_autopilot_id();
 
-    _system_impl->send_command_async(
-        command, [this, callback](MavlinkCommandSender::Result result, float) {
-            command_result_callback(result, callback);
-        });
+    _system_impl->send_command_async(command, command_callback(callback));
 }
 
 void ActionImpl::terminate_async(const Action::ResultCallback& callback) const
@@ -307,10 +327,7 @@ void ActionImpl::terminate_async(const Action::ResultCallback& callback) const
     command.params.maybe_param1 = 1.0f;
     command.target_component_id = _system_impl->get_autopilot_id();
 
-    _system_impl->send_command_async(
-        command, [this, callback](MavlinkCommandSender::Result result, float) {
-            command_result_callback(result, callback);
-        });
+    _system_impl->send_command_async(command, command_callback(callback));
 }
 
 void ActionImpl::kill_async(const Action::ResultCallback& callback) const
@@ -322,10 +339,7 @@ void ActionImpl::kill_async(const Action::ResultCallback& callback) const
     command.params.maybe_param2 = 21196.f; // magic number to enforce in-air
     command.target_component_id = _system_impl->get_autopilot_id();
 
-    _system_impl->send_command_async(
-        command, [this, callback](MavlinkCommandSender::Result result, float) {
-            command_result_callback(result, callback);
-        });
+    _system_impl->send_command_async(command, command_callback(callback));
 }
 
 void ActionImpl::reboot_async(const Action::ResultCallback& callback) const
@@ -339,10 +353,7 @@ void ActionImpl::reboot_async(const Action::ResultCallback& callback) const
     command.params.maybe_param4 = 1.0f; // reboot gimbal
     command.target_component_id = _system_impl->get_autopilot_id();
 
-    _system_impl->send_command_async(
-        command, [this, callback](MavlinkCommandSender::Result result, float) {
-            command_result_callback(result, callback);
-        });
+    _system_impl->send_command_async(command, command_callback(callback));
 }
 
 void ActionImpl::shutdown_async(const Action::ResultCallback& callback) const
@@ -356,10 +367,7 @@ void ActionImpl::shutdown_async(const Action::ResultCallback& callback) const
     command.params.maybe_param4 = 2.0f; // shutdown gimbal
     command.target_component_id = _system_impl->get_autopilot_id();
 
-    _system_impl->send_command_async(
-        command, [this, callback](MavlinkCommandSender::Result result, float) {
-            command_result_callback(result, callback);
-        });
+    _system_impl->send_command_async(command, command_callback(callback));
 }
 
 void ActionImpl::takeoff_async(const Action::ResultCallback& callback) const
@@ -378,10 +386,7 @@ void ActionImpl::takeoff_async_px4(const Action::ResultCallback& callback) const
     command.command = MAV_CMD_NAV_TAKEOFF;
     command.target_component_id = _system_impl->get_autopilot_id();
 
-    _system_impl->send_command_async(
-        command, [this, callback](MavlinkCommandSender::Result result, float) {
-            command_result_callback(result, callback);
-        });
+    _system_impl->send_command_async(command, command_callback(callback));
 }
 
 void ActionImpl::takeoff_async_apm(const Action::ResultCallback& callback) const
@@ -393,23 +398,23 @@ void ActionImpl::takeoff_async_apm(const Action::ResultCallback& callback) const
         command.target_component_id = _system_impl->get_autopilot_id();
         command.params.maybe_param7 = get_takeoff_altitude().second;
 
-        _system_impl->send_command_async(
-            command, [this, callback](MavlinkCommandSender::Result result, float) {
-                command_result_callback(result, callback);
-            });
+        _system_impl->send_command_async(command, command_callback(callback));
     };
     if (_system_impl->get_flight_mode() != FlightMode::Offboard) {
         _system_impl->set_flight_mode_async(
             FlightMode::Offboard,
-            [callback, send_takeoff_command](MavlinkCommandSender::Result result, float) {
-                Action::Result action_result = action_result_from_command_result(result);
-                if (action_result != Action::Result::Success) {
-                    if (callback) {
-                        callback(action_result);
+            make_callback_like<MavlinkCommandSender::CommandResultCallback>(
+                callback,
+                [callback, send_takeoff_command](MavlinkCommandSender::Result result, float) {
+                    Action::Result action_result = action_result_from_command_result(result);
+                    if (action_result != Action::Result::Success) {
+                        if (callback) {
+                            callback(action_result);
+                        }
+                        return;
                     }
-                }
-                send_takeoff_command();
-            });
+                    send_takeoff_command();
+                }));
     } else {
         send_takeoff_command();
     }
@@ -423,18 +428,12 @@ void ActionImpl::land_async(const Action::ResultCallback& callback) const
     command.params.maybe_param4 = NAN; // Don't change yaw.
     command.target_component_id = _system_impl->get_autopilot_id();
 
-    _system_impl->send_command_async(
-        command, [this, callback](MavlinkCommandSender::Result result, float) {
-            command_result_callback(result, callback);
-        });
+    _system_impl->send_command_async(command, command_callback(callback));
 }
 
 void ActionImpl::return_to_launch_async(const Action::ResultCallback& callback) const
 {
-    _system_impl->set_flight_mode_async(
-        FlightMode::ReturnToLaunch, [this, callback](MavlinkCommandSender::Result result, float) {
-            command_result_callback(result, callback);
-        });
+    _system_impl->set_flight_mode_async(FlightMode::ReturnToLaunch, command_callback(callback));
 }
 
 void ActionImpl::goto_location_async(
@@ -455,24 +454,23 @@ void ActionImpl::goto_location_async(
             command.params.y = int32_t(std::round(longitude_deg * 1e7));
             command.params.maybe_z = altitude_amsl_m;
 
-            _system_impl->send_command_async(
-                command, [this, callback](MavlinkCommandSender::Result result, float) {
-                    command_result_callback(result, callback);
-                });
+            _system_impl->send_command_async(command, command_callback(callback));
         };
 
     // Change to Hold mode first
     if (_system_impl->get_flight_mode() != FlightMode::Hold) {
         _system_impl->set_flight_mode_async(
             FlightMode::Hold,
-            [this, callback, send_do_reposition](MavlinkCommandSender::Result result, float) {
-                Action::Result action_result = action_result_from_command_result(result);
-                if (action_result != Action::Result::Success) {
-                    command_result_callback(result, callback);
-                    return;
-                }
-                send_do_reposition();
-            });
+            make_callback_like<MavlinkCommandSender::CommandResultCallback>(
+                callback,
+                [this, callback, send_do_reposition](MavlinkCommandSender::Result result, float) {
+                    Action::Result action_result = action_result_from_command_result(result);
+                    if (action_result != Action::Result::Success) {
+                        command_result_callback(result, callback);
+                        return;
+                    }
+                    send_do_reposition();
+                }));
         return;
     }
 
@@ -499,18 +497,12 @@ void ActionImpl::do_orbit_async(
     command.params.y = int32_t(std::round(longitude_deg * 1e7));
     command.params.maybe_z = static_cast<float>(absolute_altitude_m);
 
-    _system_impl->send_command_async(
-        command, [this, callback](MavlinkCommandSender::Result result, float) {
-            command_result_callback(result, callback);
-        });
+    _system_impl->send_command_async(command, command_callback(callback));
 }
 
 void ActionImpl::hold_async(const Action::ResultCallback& callback) const
 {
-    _system_impl->set_flight_mode_async(
-        FlightMode::Hold, [this, callback](MavlinkCommandSender::Result result, float) {
-            command_result_callback(result, callback);
-        });
+    _system_impl->set_flight_mode_async(FlightMode::Hold, command_callback(callback));
 }
 
 void ActionImpl::set_actuator_async(
@@ -543,10 +535,7 @@ void ActionImpl::set_actuator_async(
     }
     command.params.maybe_param7 = static_cast<float>(index) / 6.0f;
 
-    _system_impl->send_command_async(
-        command, [this, callback](MavlinkCommandSender::Result result, float) {
-            command_result_callback(result, callback);
-        });
+    _system_impl->send_command_async(command, command_callback(callback));
 }
 
 void ActionImpl::transition_to_fixedwing_async(const Action::ResultCallback& callback) const
@@ -571,10 +560,7 @@ void ActionImpl::transition_to_fixedwing_async(const Action::ResultCallback& cal
     command.params.maybe_param1 = static_cast<float>(MAV_VTOL_STATE_FW);
     command.target_component_id = _system_impl->get_autopilot_id();
 
-    _system_impl->send_command_async(
-        command, [this, callback](MavlinkCommandSender::Result result, float) {
-            command_result_callback(result, callback);
-        });
+    _system_impl->send_command_async(command, command_callback(callback));
 }
 
 void ActionImpl::transition_to_multicopter_async(const Action::ResultCallback& callback) const
@@ -598,16 +584,13 @@ void ActionImpl::transition_to_multicopter_async(const Action::ResultCallback& c
     command.params.maybe_param1 = static_cast<float>(MAV_VTOL_STATE_MC);
     command.target_component_id = _system_impl->get_autopilot_id();
 
-    _system_impl->send_command_async(
-        command, [this, callback](MavlinkCommandSender::Result result, float) {
-            command_result_callback(result, callback);
-        });
+    _system_impl->send_command_async(command, command_callback(callback));
 }
 
 void ActionImpl::process_extended_sys_state(const mavlink_message_t& message)
 {
-    mavlink_extended_sys_state_t extended_sys_state;
-    mavlink_msg_extended_sys_state_decode(&message, &extended_sys_state);
+    const auto& extended_sys_state =
+        DecodedMessage::get(message, mavlink_msg_extended_sys_state_decode);
 
     if (extended_sys_state.vtol_state != MAV_VTOL_STATE_UNDEFINED) {
         _vtol_transition_possible = true;
@@ -738,10 +721,7 @@ void ActionImpl::set_current_speed_async(float speed_m_s, const Action::ResultCa
     command.params.maybe_param4 = 0.0f; // reserved
     command.target_component_id = _system_impl->get_autopilot_id();
 
-    _system_impl->send_command_async(
-        command, [this, callback](MavlinkCommandSender::Result result, float) {
-            command_result_callback(result, callback);
-        });
+    _system_impl->send_command_async(command, command_callback(callback));
 }
 
 Action::Result ActionImpl::set_current_speed(float speed_m_s)
@@ -749,7 +729,10 @@ Action::Result ActionImpl::set_current_speed(float speed_m_s)
     auto prom = std::promise<Action::Result>();
     auto fut = prom.get_future();
 
-    set_current_speed_async(speed_m_s, [&prom](Action::Result result) { prom.set_value(result); });
+    set_current_speed_async(
+        speed_m_s,
+        make_sync_callback<Action::ResultCallback>(
+            [&prom](Action::Result result) { prom.set_value(result); }));
 
     return fut.get();
 }
@@ -780,15 +763,31 @@ Action::Result ActionImpl::action_result_from_command_result(MavlinkCommandSende
     }
 }
 
+MavlinkCommandSender::CommandResultCallback
+ActionImpl::command_callback(const Action::ResultCallback& callback) const
+{
+    return make_callback_like<MavlinkCommandSender::CommandResultCallback>(
+        callback, [this, callback](MavlinkCommandSender::Result result, float) {
+            command_result_callback(result, callback);
+        });
+}
+
 void ActionImpl::command_result_callback(
     MavlinkCommandSender::Result command_result, const Action::ResultCallback& callback) const
 {
     Action::Result action_result = action_result_from_command_result(command_result);
 
+    if (is_sync_callback(callback)) {
+        callback(action_result);
+        return;
+    }
+
     if (callback) {
         auto temp_callback = callback;
         _system_impl->call_user_callback(
-            [temp_callback, action_result]() { temp_callback(action_result); });
+            [temp_callback, action_result]() { temp_callback(action_result); },
+            nullptr,
+            CallbackLane::Control);
     }
 }
 
@@ -107,6 +107,8 @@ private:
 
     void command_result_callback(
         MavlinkCommandSender::Result command_result, const Action::ResultCallback& callback) const;
+    MavlinkCommandSender::CommandResultCallback
+    command_callback(const Action::ResultCallback& callback) const;
 
     bool need_hold_before_arm() const;
     bool need_hold_before_arm_px4() const;
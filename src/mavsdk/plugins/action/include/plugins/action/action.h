@@ -15,6 +15,7 @@
 
 #include "plugin_base.h"
 
+#include "awaitable.h"
 #include "handle.h"
 
 namespace mavsdk {
@@ -119,7 +120,24 @@ public:
      *
      * This function is non-blocking. See 'arm' for the blocking counterpart.
      */
-    void arm_async(const ResultCallback callback);
+    void arm_async(const ResultCallback& callback);
+
+#ifdef MAVSDK_HAS_COROUTINES
+    /**
+     * @brief Awaitable version of 'arm_async' for C++20 coroutines.
+     *
+     * The coroutine is resumed using the executor if one is given, otherwise on the callback
+     * thread.
+     */
+    Awaitable<ResultCallback> arm_awaitable(Executor executor = {})
+    {
+        return Awaitable<ResultCallback>(
+            [=, this](const ResultCallback& callback) {
+                arm_async(callback);
+            },
+            std::move(executor));
+    }
+#endif
 
     /**
      * @brief Send command to arm the drone.
@@ -141,7 +159,24 @@ public:
      *
      * This function is non-blocking. See 'disarm' for the blocking counterpart.
      */
-    void disarm_async(const ResultCallback callback);
+    void disarm_async(const ResultCallback& callback);
+
+#ifdef MAVSDK_HAS_COROUTINES
+    /**
+     * @brief Awaitable version of 'disarm_async' for C++20 coroutines.
+     *
+     * The coroutine is resumed using the executor if one is given, otherwise on the callback
+     * thread.
+     */
+    Awaitable<ResultCallback> disarm_awaitable(Executor executor = {})
+    {
+        return Awaitable<ResultCallback>(
+            [=, this](const ResultCallback& callback) {
+                disarm_async(callback);
+            },
+            std::move(executor));
+    }
+#endif
 
     /**
      * @brief Send command to disarm the drone.
@@ -165,7 +200,24 @@ public:
      *
      * This function is non-blocking. See 'takeoff' for the blocking counterpart.
      */
-    void takeoff_async(const ResultCallback callback);
+    void takeoff_async(const ResultCallback& callback);
+
+#ifdef MAVSDK_HAS_COROUTINES
+    /**
+     * @brief Awaitable version of 'takeoff_async' for C++20 coroutines.
+     *
+     * The coroutine is resumed using the executor if one is given, otherwise on the callback
+     * thread.
+     */
+    Awaitable<ResultCallback> takeoff_awaitable(Executor executor = {})
+    {
+        return Awaitable<ResultCallback>(
+            [=, this](const ResultCallback& callback) {
+                takeoff_async(callback);
+            },
+            std::move(executor));
+    }
+#endif
 
     /**
      * @brief Send command to take off and hover.
@@ -188,7 +240,24 @@ public:
      *
      * This function is non-blocking. See 'land' for the blocking counterpart.
      */
-    void land_async(const ResultCallback callback);
+    void land_async(const ResultCallback& callback);
+
+#ifdef MAVSDK_HAS_COROUTINES
+    /**
+     * @brief Awaitable version of 'land_async' for C++20 coroutines.
+     *
+     * The coroutine is resumed using the executor if one is given, otherwise on the callback
+     * thread.
+     */
+    Awaitable<ResultCallback> land_awaitable(Executor executor = {})
+    {
+        return Awaitable<ResultCallback>(
+            [=, this](const ResultCallback& callback) {
+                land_async(callback);
+            },
+            std::move(executor));
+    }
+#endif
 
     /**
      * @brief Send command to land at the current position.
@@ -208,7 +277,24 @@ public:
      *
      * This function is non-blocking. See 'reboot' for the blocking counterpart.
      */
-    void reboot_async(const ResultCallback callback);
+    void reboot_async(const ResultCallback& callback);
+
+#ifdef MAVSDK_HAS_COROUTINES
+    /**
+     * @brief Awaitable version of 'reboot_async' for C++20 coroutines.
+     *
+     * The coroutine is resumed using the executor if one is given, otherwise on the callback
+     * thread.
+     */
+    Awaitable<ResultCallback> reboot_awaitable(Executor executor = {})
+    {
+        return Awaitable<ResultCallback>(
+            [=, this](const ResultCallback& callback) {
+                reboot_async(callback);
+            },
+            std::move(executor));
+    }
+#endif
 
     /**
      * @brief Send command to reboot the drone components.
@@ -230,7 +316,24 @@ public:
      *
      * This function is non-blocking. See 'shutdown' for the blocking counterpart.
      */
-    void shutdown_async(const ResultCallback callback);
+    void shutdown_async(const ResultCallback& callback);
+
+#ifdef MAVSDK_HAS_COROUTINES
+    /**
+     * @brief Awaitable version of 'shutdown_async' for C++20 coroutines.
+     *
+     * The coroutine is resumed using the executor if one is given, otherwise on the callback
+     * thread.
+     */
+    Awaitable<ResultCallback> shutdown_awaitable(Executor executor = {})
+    {
+        return Awaitable<ResultCallback>(
+            [=, this](const ResultCallback& callback) {
+                shutdown_async(callback);
+            },
+            std::move(executor));
+    }
+#endif
 
     /**
      * @brief Send command to shut down the drone components.
@@ -253,7 +356,24 @@ public:
      *
      * This function is non-blocking. See 'terminate' for the blocking counterpart.
      */
-    void terminate_async(const ResultCallback callback);
+    void terminate_async(const ResultCallback& callback);
+
+#ifdef MAVSDK_HAS_COROUTINES
+    /**
+     * @brief Awaitable version of 'terminate_async' for C++20 coroutines.
+     *
+     * The coroutine is resumed using the executor if one is given, otherwise on the callback
+     * thread.
+     */
+    Awaitable<ResultCallback> terminate_awaitable(Executor executor = {})
+    {
+        return Awaitable<ResultCallback>(
+            [=, this](const ResultCallback& callback) {
+                terminate_async(callback);
+            },
+            std::move(executor));
+    }
+#endif
 
     /**
      * @brief Send command to terminate the drone.
@@ -275,7 +395,24 @@ public:
      *
      * This function is non-blocking. See 'kill' for the blocking counterpart.
      */
-    void kill_async(const ResultCallback callback);
+    void kill_async(const ResultCallback& callback);
+
+#ifdef MAVSDK_HAS_COROUTINES
+    /**
+     * @brief Awaitable version of 'kill_async' for C++20 coroutines.
+     *
+     * The coroutine is resumed using the executor if one is given, otherwise on the callback
+     * thread.
+     */
+    Awaitable<ResultCallback> kill_awaitable(Executor executor = {})
+    {
+        return Awaitable<ResultCallback>(
+            [=, this](const ResultCallback& callback) {
+                kill_async(callback);
+            },
+            std::move(executor));
+    }
+#endif
 
     /**
      * @brief Send command to kill the drone.
@@ -299,7 +436,24 @@ public:
      *
      * This function is non-blocking. See 'return_to_launch' for the blocking counterpart.
      */
-    void return_to_launch_async(const ResultCallback callback);
+    void return_to_launch_async(const ResultCallback& callback);
+
+#ifdef MAVSDK_HAS_COROUTINES
+    /**
+     * @brief Awaitable version of 'return_to_launch_async' for C++20 coroutines.
+     *
+     * The coroutine is resumed using the executor if one is given, otherwise on the callback
+     * thread.
+     */
+    Awaitable<ResultCallback> return_to_launch_awaitable(Executor executor = {})
+    {
+        return Awaitable<ResultCallback>(
+            [=, this](const ResultCallback& callback) {
+                return_to_launch_async(callback);
+            },
+            std::move(executor));
+    }
+#endif
 
     /**
      * @brief Send command to return to the launch (takeoff) position and land.
@@ -330,7 +484,30 @@ public:
         double longitude_deg,
         float absolute_altitude_m,
         float yaw_deg,
-        const ResultCallback callback);
+        const ResultCallback& callback);
+
+#ifdef MAVSDK_HAS_COROUTINES
+    /**
+     * @brief Awaitable version of 'goto_location_async' for C++20 coroutines.
+     *
+     * The coroutine is resumed using the executor if one is given, otherwise on the callback
+     * thread.
+     */
+    Awaitable<ResultCallback> goto_location_awaitable(
+        double latitude_deg,
+        double longitude_deg,
+        float absolute_altitude_m,
+        float yaw_deg,
+        Executor executor = {})
+    {
+        return Awaitable<ResultCallback>(
+            [=, this](const ResultCallback& callback) {
+                goto_location_async(
+                    latitude_deg, longitude_deg, absolute_altitude_m, yaw_deg, callback);
+            },
+            std::move(executor));
+    }
+#endif
 
     /**
      * @brief Send command to move the vehicle to a specific global position.
@@ -361,7 +538,38 @@ public:
         double latitude_deg,
         double longitude_deg,
         double absolute_altitude_m,
-        const ResultCallback callback);
+        const ResultCallback& callback);
+
+#ifdef MAVSDK_HAS_COROUTINES
+    /**
+     * @brief Awaitable version of 'do_orbit_async' for C++20 coroutines.
+     *
+     * The coroutine is resumed using the executor if one is given, otherwise on the callback
+     * thread.
+     */
+    Awaitable<ResultCallback> do_orbit_awaitable(
+        float radius_m,
+        float velocity_ms,
+        OrbitYawBehavior yaw_behavior,
+        double latitude_deg,
+        double longitude_deg,
+        double absolute_altitude_m,
+        Executor executor = {})
+    {
+        return Awaitable<ResultCallback>(
+            [=, this](const ResultCallback& callback) {
+                do_orbit_async(
+                    radius_m,
+                    velocity_ms,
+                    yaw_behavior,
+                    latitude_deg,
+                    longitude_deg,
+                    absolute_altitude_m,
+                    callback);
+            },
+            std::move(executor));
+    }
+#endif
 
     /**
      * @brief Send command do orbit to the drone.
@@ -391,7 +599,24 @@ public:
      *
      * This function is non-blocking. See 'hold' for the blocking counterpart.
      */
-    void hold_async(const ResultCallback callback);
+    void hold_async(const ResultCallback& callback);
+
+#ifdef MAVSDK_HAS_COROUTINES
+    /**
+     * @brief Awaitable version of 'hold_async' for C++20 coroutines.
+     *
+     * The coroutine is resumed using the executor if one is given, otherwise on the callback
+     * thread.
+     */
+    Awaitable<ResultCallback> hold_awaitable(Executor executor = {})
+    {
+        return Awaitable<ResultCallback>(
+            [=, this](const ResultCallback& callback) {
+                hold_async(callback);
+            },
+            std::move(executor));
+    }
+#endif
 
     /**
      * @brief Send command to hold position (a.k.a. "Loiter").
@@ -413,7 +638,25 @@ public:
      *
      * This function is non-blocking. See 'set_actuator' for the blocking counterpart.
      */
-    void set_actuator_async(int32_t index, float value, const ResultCallback callback);
+    void set_actuator_async(int32_t index, float value, const ResultCallback& callback);
+
+#ifdef MAVSDK_HAS_COROUTINES
+    /**
+     * @brief Awaitable version of 'set_actuator_async' for C++20 coroutines.
+     *
+     * The coroutine is resumed using the executor if one is given, otherwise on the callback
+     * thread.
+     */
+    Awaitable<ResultCallback> set_actuator_awaitable(
+        int32_t index, float value, Executor executor = {})
+    {
+        return Awaitable<ResultCallback>(
+            [=, this](const ResultCallback& callback) {
+                set_actuator_async(index, value, callback);
+            },
+            std::move(executor));
+    }
+#endif
 
     /**
      * @brief Send command to set the value of an actuator.
@@ -433,7 +676,24 @@ public:
      *
      * This function is non-blocking. See 'transition_to_fixedwing' for the blocking counterpart.
      */
-    void transition_to_fixedwing_async(const ResultCallback callback);
+    void transition_to_fixedwing_async(const ResultCallback& callback);
+
+#ifdef MAVSDK_HAS_COROUTINES
+    /**
+     * @brief Awaitable version of 'transition_to_fixedwing_async' for C++20 coroutines.
+     *
+     * The coroutine is resumed using the executor if one is given, otherwise on the callback
+     * thread.
+     */
+    Awaitable<ResultCallback> transition_to_fixedwing_awaitable(Executor executor = {})
+    {
+        return Awaitable<ResultCallback>(
+            [=, this](const ResultCallback& callback) {
+                transition_to_fixedwing_async(callback);
+            },
+            std::move(executor));
+    }
+#endif
 
     /**
      * @brief Send command to transition the drone to fixedwing.
@@ -458,7 +718,24 @@ public:
      *
      * This function is non-blocking. See 'transition_to_multicopter' for the blocking counterpart.
      */
-    void transition_to_multicopter_async(const ResultCallback callback);
+    void transition_to_multicopter_async(const ResultCallback& callback);
+
+#ifdef MAVSDK_HAS_COROUTINES
+    /**
+     * @brief Awaitable version of 'transition_to_multicopter_async' for C++20 coroutines.
+     *
+     * The coroutine is resumed using the executor if one is given, otherwise on the callback
+     * thread.
+     */
+    Awaitable<ResultCallback> transition_to_multicopter_awaitable(Executor executor = {})
+    {
+        return Awaitable<ResultCallback>(
+            [=, this](const ResultCallback& callback) {
+                transition_to_multicopter_async(callback);
+            },
+            std::move(executor));
+    }
+#endif
 
     /**
      * @brief Send command to transition the drone to multicopter.
@@ -484,7 +761,24 @@ public:
      *
      * This function is non-blocking. See 'get_takeoff_altitude' for the blocking counterpart.
      */
-    void get_takeoff_altitude_async(const GetTakeoffAltitudeCallback callback);
+    void get_takeoff_altitude_async(const GetTakeoffAltitudeCallback& callback);
+
+#ifdef MAVSDK_HAS_COROUTINES
+    /**
+     * @brief Awaitable version of 'get_takeoff_altitude_async' for C++20 coroutines.
+     *
+     * The coroutine is resumed using the executor if one is given, otherwise on the callback
+     * thread.
+     */
+    Awaitable<GetTakeoffAltitudeCallback> get_takeoff_altitude_awaitable(Executor executor = {})
+    {
+        return Awaitable<GetTakeoffAltitudeCallback>(
+            [=, this](const GetTakeoffAltitudeCallback& callback) {
+                get_takeoff_altitude_async(callback);
+            },
+            std::move(executor));
+    }
+#endif
 
     /**
      * @brief Get the takeoff altitude (in meters above ground).
@@ -500,7 +794,24 @@ public:
      *
      * This function is non-blocking. See 'set_takeoff_altitude' for the blocking counterpart.
      */
-    void set_takeoff_altitude_async(float altitude, const ResultCallback callback);
+    void set_takeoff_altitude_async(float altitude, const ResultCallback& callback);
+
+#ifdef MAVSDK_HAS_COROUTINES
+    /**
+     * @brief Awaitable version of 'set_takeoff_altitude_async' for C++20 coroutines.
+     *
+     * The coroutine is resumed using the executor if one is given, otherwise on the callback
+     * thread.
+     */
+    Awaitable<ResultCallback> set_takeoff_altitude_awaitable(float altitude, Executor executor = {})
+    {
+        return Awaitable<ResultCallback>(
+            [=, this](const ResultCallback& callback) {
+                set_takeoff_altitude_async(altitude, callback);
+            },
+            std::move(executor));
+    }
+#endif
 
     /**
      * @brief Set takeoff altitude (in meters above ground).
@@ -521,7 +832,24 @@ public:
      *
      * This function is non-blocking. See 'get_maximum_speed' for the blocking counterpart.
      */
-    void get_maximum_speed_async(const GetMaximumSpeedCallback callback);
+    void get_maximum_speed_async(const GetMaximumSpeedCallback& callback);
+
+#ifdef MAVSDK_HAS_COROUTINES
+    /**
+     * @brief Awaitable version of 'get_maximum_speed_async' for C++20 coroutines.
+     *
+     * The coroutine is resumed using the executor if one is given, otherwise on the callback
+     * thread.
+     */
+    Awaitable<GetMaximumSpeedCallback> get_maximum_speed_awaitable(Executor executor = {})
+    {
+        return Awaitable<GetMaximumSpeedCallback>(
+            [=, this](const GetMaximumSpeedCallback& callback) {
+                get_maximum_speed_async(callback);
+            },
+            std::move(executor));
+    }
+#endif
 
     /**
      * @brief Get the vehicle maximum speed (in metres/second).
@@ -537,7 +865,24 @@ public:
      *
      * This function is non-blocking. See 'set_maximum_speed' for the blocking counterpart.
      */
-    void set_maximum_speed_async(float speed, const ResultCallback callback);
+    void set_maximum_speed_async(float speed, const ResultCallback& callback);
+
+#ifdef MAVSDK_HAS_COROUTINES
+    /**
+     * @brief Awaitable version of 'set_maximum_speed_async' for C++20 coroutines.
+     *
+     * The coroutine is resumed using the executor if one is given, otherwise on the callback
+     * thread.
+     */
+    Awaitable<ResultCallback> set_maximum_speed_awaitable(float speed, Executor executor = {})
+    {
+        return Awaitable<ResultCallback>(
+            [=, this](const ResultCallback& callback) {
+                set_maximum_speed_async(speed, callback);
+            },
+            std::move(executor));
+    }
+#endif
 
     /**
      * @brief Set vehicle maximum speed (in metres/second).
@@ -559,7 +904,25 @@ public:
      * This function is non-blocking. See 'get_return_to_launch_altitude' for the blocking
      * counterpart.
      */
-    void get_return_to_launch_altitude_async(const GetReturnToLaunchAltitudeCallback callback);
+    void get_return_to_launch_altitude_async(const GetReturnToLaunchAltitudeCallback& callback);
+
+#ifdef MAVSDK_HAS_COROUTINES
+    /**
+     * @brief Awaitable version of 'get_return_to_launch_altitude_async' for C++20 coroutines.
+     *
+     * The coroutine is resumed using the executor if one is given, otherwise on the callback
+     * thread.
+     */
+    Awaitable<GetReturnToLaunchAltitudeCallback> get_return_to_launch_altitude_awaitable(
+        Executor executor = {})
+    {
+        return Awaitable<GetReturnToLaunchAltitudeCallback>(
+            [=, this](const GetReturnToLaunchAltitudeCallback& callback) {
+                get_return_to_launch_altitude_async(callback);
+            },
+            std::move(executor));
+    }
+#endif
 
     /**
      * @brief Get the return to launch minimum return altitude (in meters).
@@ -577,8 +940,26 @@ public:
      * This function is non-blocking. See 'set_return_to_launch_altitude' for the blocking
      * counterpart.
      */
-    void
-    set_return_to_launch_altitude_async(float relative_altitude_m, const ResultCallback callback);
+    void set_return_to_launch_altitude_async(
+        float relative_altitude_m, const ResultCallback& callback);
+
+#ifdef MAVSDK_HAS_COROUTINES
+    /**
+     * @brief Awaitable version of 'set_return_to_launch_altitude_async' for C++20 coroutines.
+     *
+     * The coroutine is resumed using the executor if one is given, otherwise on the callback
+     * thread.
+     */
+    Awaitable<ResultCallback> set_return_to_launch_altitude_awaitable(
+        float relative_altitude_m, Executor executor = {})
+    {
+        return Awaitable<ResultCallback>(
+            [=, this](const ResultCallback& callback) {
+                set_return_to_launch_altitude_async(relative_altitude_m, callback);
+            },
+            std::move(executor));
+    }
+#endif
 
     /**
      * @brief Set the return to launch minimum return altitude (in meters).
@@ -598,7 +979,24 @@ public:
      *
      * This function is non-blocking. See 'set_current_speed' for the blocking counterpart.
      */
-    void set_current_speed_async(float speed_m_s, const ResultCallback callback);
+    void set_current_speed_async(float speed_m_s, const ResultCallback& callback);
+
+#ifdef MAVSDK_HAS_COROUTINES
+    /**
+     * @brief Awaitable version of 'set_current_speed_async' for C++20 coroutines.
+     *
+     * The coroutine is resumed using the executor if one is given, otherwise on the callback
+     * thread.
+     */
+    Awaitable<ResultCallback> set_current_speed_awaitable(float speed_m_s, Executor executor = {})
+    {
+        return Awaitable<ResultCallback>(
+            [=, this](const ResultCallback& callback) {
+                set_current_speed_async(speed_m_s, callback);
+            },
+            std::move(executor));
+    }
+#endif
 
     /**
      * @brief Set current speed.
@@ -625,6 +1023,9 @@ public:
 private:
     /** @private Underlying implementation, set at instantiation */
     std::unique_ptr<ActionImpl> _impl;
+
+    /** @private Hand-written additions in action_ext.h, if any */
+    friend class ActionExt;
 };
 
 } // namespace mavsdk
\ No newline at end of file
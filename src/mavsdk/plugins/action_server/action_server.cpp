@@ -106,8 +106,8 @@ ActionServer::Result ActionServer::set_disarmable(bool disarmable, bool force_di
     return _impl->set_disarmable(disarmable, force_disarmable);
 }
 
-ActionServer::Result
-ActionServer::set_allowable_flight_modes(AllowableFlightModes flight_modes) const
+ActionServer::Result ActionServer::set_allowable_flight_modes(
+    const AllowableFlightModes& flight_modes) const
 {
     return _impl->set_allowable_flight_modes(flight_modes);
 }
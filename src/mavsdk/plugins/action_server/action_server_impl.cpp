@@ -62,7 +62,7 @@ void ActionServerImpl::init()
     // Arming / Disarm / Kill
     _server_component_impl->register_mavlink_command_handler(
         MAV_CMD_COMPONENT_ARM_DISARM,
-        [this](const MavlinkCommandReceiver::CommandLong& command) {
+        answered_once([this](const MavlinkCommandReceiver::CommandLong& command) {
             ActionServer::ArmDisarm armDisarm{
                 command.params.param1 == 1, command.params.param2 == 21196};
 
@@ -92,12 +92,12 @@ void ActionServerImpl::init()
             });
 
             return _server_component_impl->make_command_ack_message(command, request_ack);
-        },
+        }),
         this);
 
     _server_component_impl->register_mavlink_command_handler(
         MAV_CMD_NAV_TAKEOFF,
-        [this](const MavlinkCommandReceiver::CommandLong& command) {
+        answered_once([this](const MavlinkCommandReceiver::CommandLong& command) {
             if (_allow_takeoff) {
                 _takeoff_callbacks.queue(
                     ActionServer::Result::Success, true, [this](const auto& func) {
@@ -115,13 +115,13 @@ void ActionServerImpl::init()
                 return _server_component_impl->make_command_ack_message(
                     command, MAV_RESULT::MAV_RESULT_UNSUPPORTED);
             }
-        },
+        }),
         this);
 
     // Flight mode
     _server_component_impl->register_mavlink_command_handler(
         MAV_CMD_DO_SET_MODE,
-        [this](const MavlinkCommandReceiver::CommandLong& command) {
+        answered_once([this](const MavlinkCommandReceiver::CommandLong& command) {
             auto base_mode = static_cast<uint8_t>(command.params.param1);
             auto is_custom = (base_mode & MAV_MODE_FLAG_CUSTOM_MODE_ENABLED) ==
                              MAV_MODE_FLAG_CUSTOM_MODE_ENABLED;
@@ -186,7 +186,7 @@ void ActionServerImpl::init()
             return _server_component_impl->make_command_ack_message(
                 command,
                 allow_mode ? MAV_RESULT::MAV_RESULT_ACCEPTED : MAV_RESULT_TEMPORARILY_REJECTED);
-        },
+        }),
         this);
 }
 
@@ -294,6 +294,7 @@ void ActionServerImpl::unsubscribe_terminate(ActionServer::TerminateHandle handl
 ActionServer::Result ActionServerImpl::set_allow_takeoff(bool allow_takeoff)
 {
     _allow_takeoff = allow_takeoff;
+    _command_ack_cache.clear();
     return ActionServer::Result::Success;
 }
 
@@ -302,6 +303,7 @@ ActionServer::Result ActionServerImpl::set_armable(bool armable, bool force_arma
     std::lock_guard<std::mutex> lock(_flight_mode_mutex);
     _armable = armable;
     _force_armable = force_armable;
+    _command_ack_cache.clear();
     return ActionServer::Result::Success;
 }
 
@@ -310,6 +312,7 @@ ActionServer::Result ActionServerImpl::set_disarmable(bool disarmable, bool forc
     std::lock_guard<std::mutex> lock(_flight_mode_mutex);
     _disarmable = disarmable;
     _force_disarmable = force_disarmable;
+    _command_ack_cache.clear();
     return ActionServer::Result::Success;
 }
 
@@ -318,6 +321,7 @@ ActionServerImpl::set_allowable_flight_modes(ActionServer::AllowableFlightModes
 {
     std::lock_guard<std::mutex> lock(_flight_mode_mutex);
     _allowed_flight_modes = flight_modes;
+    _command_ack_cache.clear();
     return ActionServer::Result::Success;
 }
 
@@ -327,6 +331,24 @@ ActionServer::AllowableFlightModes ActionServerImpl::get_allowable_flight_modes(
     return _allowed_flight_modes;
 }
 
+MavlinkCommandReceiver::MavlinkCommandLongHandler
+ActionServerImpl::answered_once(const MavlinkCommandReceiver::MavlinkCommandLongHandler& handler)
+{
+    return [this, handler](const MavlinkCommandReceiver::CommandLong& command) {
+        const auto now = _server_component_impl->get_time().steady_time();
+
+        if (auto maybe_ack = _command_ack_cache.find(command, now)) {
+            return maybe_ack;
+        }
+
+        auto maybe_ack = handler(command);
+        if (maybe_ack) {
+            _command_ack_cache.insert(command, maybe_ack.value(), now);
+        }
+        return maybe_ack;
+    };
+}
+
 void ActionServerImpl::set_base_mode(uint8_t base_mode)
 {
     _server_component_impl->set_base_mode(base_mode);
@@ -5,6 +5,7 @@
 #include "plugins/action_server/action_server.h"
 #include "server_plugin_impl_base.h"
 #include "callback_list.h"
+#include "command_ack_cache.h"
 
 namespace mavsdk {
 
@@ -60,6 +61,11 @@ private:
 
     void set_server_armed(bool armed);
 
+    // Retransmissions of a command already answered get the same ack again,
+    // without handling the command, or calling subscribers, once more.
+    MavlinkCommandReceiver::MavlinkCommandLongHandler
+    answered_once(const MavlinkCommandReceiver::MavlinkCommandLongHandler& handler);
+
     std::mutex _callback_mutex;
     CallbackList<ActionServer::Result, ActionServer::ArmDisarm> _arm_disarm_callbacks{};
     CallbackList<ActionServer::Result, ActionServer::FlightMode> _flight_mode_change_callbacks{};
@@ -75,6 +81,8 @@ private:
     std::atomic<bool> _force_disarmable = false;
     std::atomic<bool> _allow_takeoff = false;
 
+    CommandAckCache _command_ack_cache{};
+
     union px4_custom_mode {
         struct {
             uint16_t reserved;
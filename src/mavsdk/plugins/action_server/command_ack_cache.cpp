@@ -0,0 +1,53 @@
+#include "command_ack_cache.h"
+
+#include <chrono>
+#include <cstring>
+
+namespace mavsdk {
+
+std::optional<mavlink_message_t>
+CommandAckCache::find(const MavlinkCommandReceiver::CommandLong& command, SteadyTimePoint now)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    auto it = _entries.find(key_from_command(command));
+    if (it == _entries.end()) {
+        return std::nullopt;
+    }
+
+    auto& entry = it->second;
+    const double since_answered_s =
+        std::chrono::duration<double>(now - entry.answered).count();
+
+    // Compared bitwise, so that NAN params, as in reserved ones, match too.
+    if (since_answered_s > _window_s || command.confirmation < entry.confirmation ||
+        std::memcmp(&command.params, &entry.params, sizeof(entry.params)) != 0) {
+        return std::nullopt;
+    }
+
+    // The window is not extended, so a stream of them is handled again eventually.
+    entry.confirmation = command.confirmation;
+    return entry.ack;
+}
+
+void CommandAckCache::insert(
+    const MavlinkCommandReceiver::CommandLong& command,
+    const mavlink_message_t& ack,
+    SteadyTimePoint now)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    auto& entry = _entries[key_from_command(command)];
+    entry.params = command.params;
+    entry.confirmation = command.confirmation;
+    entry.ack = ack;
+    entry.answered = now;
+}
+
+void CommandAckCache::clear()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _entries.clear();
+}
+
+} // namespace mavsdk
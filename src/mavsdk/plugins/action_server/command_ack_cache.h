@@ -0,0 +1,64 @@
+#pragma once
+
+#include "mavlink_command_receiver.h"
+#include "mavlink_include.h"
+#include "mavsdk_time.h"
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+
+namespace mavsdk {
+
+// Remembers the ack sent for the last command of each sender and command ID,
+// so that retransmissions of it are answered with the same ack instead of
+// being handled, and reported to subscribers, again.
+//
+// A command counts as retransmitted if it has the same params, arrives within
+// the window after it was answered, and its confirmation did not go down.
+// Senders count the confirmation up for each retransmission, or leave it at 0.
+class CommandAckCache {
+public:
+    // Long enough for the retransmissions of the common ground stations.
+    static constexpr double default_window_s = 3.0;
+
+    explicit CommandAckCache(double window_s = default_window_s) : _window_s(window_s) {}
+    ~CommandAckCache() = default;
+
+    // Non-copyable
+    CommandAckCache(const CommandAckCache&) = delete;
+    const CommandAckCache& operator=(const CommandAckCache&) = delete;
+
+    // The ack to send again, if the command was already answered.
+    std::optional<mavlink_message_t>
+    find(const MavlinkCommandReceiver::CommandLong& command, SteadyTimePoint now);
+
+    void insert(
+        const MavlinkCommandReceiver::CommandLong& command,
+        const mavlink_message_t& ack,
+        SteadyTimePoint now);
+
+    // For when the answers would change, e.g. the vehicle became armable.
+    void clear();
+
+private:
+    struct Entry {
+        MavlinkCommandReceiver::CommandLong::Params params{};
+        uint8_t confirmation{0};
+        mavlink_message_t ack{};
+        SteadyTimePoint answered{};
+    };
+
+    static uint32_t key_from_command(const MavlinkCommandReceiver::CommandLong& command)
+    {
+        return (static_cast<uint32_t>(command.origin_system_id) << 24) |
+               (static_cast<uint32_t>(command.origin_component_id) << 16) | command.command;
+    }
+
+    const double _window_s;
+
+    std::mutex _mutex{};
+    std::unordered_map<uint32_t, Entry> _entries{};
+};
+
+} // namespace mavsdk
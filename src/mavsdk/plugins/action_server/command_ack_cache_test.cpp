@@ -0,0 +1,77 @@
+#include "command_ack_cache.h"
+#include <gtest/gtest.h>
+
+using namespace mavsdk;
+
+namespace {
+
+MavlinkCommandReceiver::CommandLong make_arm_command(uint8_t confirmation = 0)
+{
+    MavlinkCommandReceiver::CommandLong command{};
+    command.origin_system_id = 255;
+    command.origin_component_id = 190;
+    command.command = MAV_CMD_COMPONENT_ARM_DISARM;
+    command.confirmation = confirmation;
+    command.params.param1 = 1.0f;
+    return command;
+}
+
+mavlink_message_t make_ack(uint8_t seq)
+{
+    mavlink_message_t ack{};
+    ack.seq = seq;
+    return ack;
+}
+
+} // namespace
+
+TEST(CommandAckCache, AnswersRetransmissionsWithSameAck)
+{
+    CommandAckCache cache;
+    const SteadyTimePoint now{};
+
+    EXPECT_FALSE(cache.find(make_arm_command(), now));
+
+    cache.insert(make_arm_command(), make_ack(42), now);
+
+    auto maybe_ack = cache.find(make_arm_command(), now + std::chrono::milliseconds(500));
+    ASSERT_TRUE(maybe_ack);
+    EXPECT_EQ(maybe_ack->seq, 42);
+
+    maybe_ack = cache.find(make_arm_command(1), now + std::chrono::milliseconds(1000));
+    ASSERT_TRUE(maybe_ack);
+    EXPECT_EQ(maybe_ack->seq, 42);
+}
+
+TEST(CommandAckCache, HandlesOtherCommandsAgain)
+{
+    CommandAckCache cache;
+    const SteadyTimePoint now{};
+    cache.insert(make_arm_command(), make_ack(42), now);
+
+    auto disarm = make_arm_command();
+    disarm.params.param1 = 0.0f;
+    EXPECT_FALSE(cache.find(disarm, now));
+
+    auto other_sender = make_arm_command();
+    other_sender.origin_system_id = 254;
+    EXPECT_FALSE(cache.find(other_sender, now));
+}
+
+TEST(CommandAckCache, HandlesNewAttemptsAgain)
+{
+    CommandAckCache cache;
+    const SteadyTimePoint now{};
+
+    cache.insert(make_arm_command(2), make_ack(42), now);
+    EXPECT_FALSE(cache.find(make_arm_command(0), now));
+
+    EXPECT_FALSE(cache.find(
+        make_arm_command(2),
+        now + std::chrono::milliseconds(
+                  static_cast<int>(CommandAckCache::default_window_s * 1000) + 1)));
+
+    cache.insert(make_arm_command(), make_ack(43), now);
+    cache.clear();
+    EXPECT_FALSE(cache.find(make_arm_command(), now));
+}
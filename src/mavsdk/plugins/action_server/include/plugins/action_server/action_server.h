@@ -15,6 +15,7 @@
 
 #include "server_plugin_base.h"
 
+#include "awaitable.h"
 #include "handle.h"
 
 namespace mavsdk {
@@ -331,7 +332,7 @@ public:
      *
      * @return Result of request.
      */
-    Result set_allowable_flight_modes(AllowableFlightModes flight_modes) const;
+    Result set_allowable_flight_modes(const AllowableFlightModes& flight_modes) const;
 
     /**
      * @brief Get which modes the vehicle can transition to (Manual always allowed)
@@ -355,6 +356,9 @@ public:
 private:
     /** @private Underlying implementation, set at instantiation */
     std::unique_ptr<ActionServerImpl> _impl;
+
+    /** @private Hand-written additions in action_server_ext.h, if any */
+    friend class ActionServerExt;
 };
 
 } // namespace mavsdk
\ No newline at end of file
@@ -314,6 +314,7 @@ void CalibrationImpl::command_result_callback(
             call_callback(_calibration_callback, timeout_result, Calibration::ProgressData());
             _calibration_callback = nullptr;
             _state = State::None;
+            _last_progress = NAN;
             break;
         }
 
@@ -362,6 +363,11 @@ CalibrationImpl::calibration_result_from_command_result(MavlinkCommandSender::Re
 
 void CalibrationImpl::receive_statustext(const MavlinkStatustextHandler::Statustext& statustext)
 {
+    // Other statustexts don't need to wait for a calibration that is running.
+    if (!CalibrationStatustextParser::is_relevant(statustext.text)) {
+        return;
+    }
+
     std::lock_guard<std::mutex> lock(_calibration_mutex);
     if (_state == State::None) {
         return;
@@ -436,6 +442,7 @@ void CalibrationImpl::receive_statustext(const MavlinkStatustextHandler::Statust
         case CalibrationStatustextParser::Status::Cancelled:
             _calibration_callback = nullptr;
             _state = State::None;
+            _last_progress = NAN;
             break;
         default:
             break;
@@ -469,10 +476,24 @@ void CalibrationImpl::report_cancelled()
 
 void CalibrationImpl::report_progress(float progress)
 {
+    // PX4 repeats the progress, e.g. for every side, which is not new to anyone.
+    if (progress == _last_progress) {
+        return;
+    }
+    _last_progress = progress;
+
     Calibration::ProgressData progress_data;
     progress_data.has_progress = true;
     progress_data.progress = progress;
-    call_callback(_calibration_callback, Calibration::Result::Next, progress_data);
+
+    // Only the latest progress matters, so one that is still queued is
+    // replaced instead of piling up behind a slow callback.
+    if (_calibration_callback) {
+        const auto callback = _calibration_callback;
+        _system_impl->call_user_callback(
+            [callback, progress_data]() { callback(Calibration::Result::Next, progress_data); },
+            &_last_progress);
+    }
 }
 
 void CalibrationImpl::report_instruction(const std::string& instruction)
@@ -54,6 +54,7 @@ private:
     void report_instruction(const std::string& instruction);
 
     CalibrationStatustextParser _parser{};
+    float _last_progress{NAN}; // Needs _calibration_mutex
 
     mutable std::mutex _calibration_mutex{};
 
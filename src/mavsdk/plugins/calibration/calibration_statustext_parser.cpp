@@ -1,30 +1,92 @@
 #include "calibration_statustext_parser.h"
-#include "calibration_messages.h"
 #include "log.h"
 
+#include <cctype>
+#include <optional>
+#include <sstream>
+
 namespace mavsdk {
 
+namespace {
+
+// Removes the prefix if the text starts with it.
+bool consume(std::string_view& text, std::string_view prefix)
+{
+    if (text.compare(0, prefix.size(), prefix) != 0) {
+        return false;
+    }
+    text.remove_prefix(prefix.size());
+    return true;
+}
+
+void skip_whitespace(std::string_view& text)
+{
+    while (!text.empty() && std::isspace(static_cast<unsigned char>(text.front()))) {
+        text.remove_prefix(1);
+    }
+}
+
+std::optional<int> consume_number(std::string_view& text)
+{
+    if (text.empty() || !std::isdigit(static_cast<unsigned char>(text.front()))) {
+        return std::nullopt;
+    }
+
+    int number = 0;
+    while (!text.empty() && std::isdigit(static_cast<unsigned char>(text.front()))) {
+        number = number * 10 + (text.front() - '0');
+        if (number > 1000000) {
+            return std::nullopt;
+        }
+        text.remove_prefix(1);
+    }
+    return number;
+}
+
+// The rest of the line, without leading whitespace.
+std::string_view rest_of_line(std::string_view text)
+{
+    skip_whitespace(text);
+    return text.substr(0, text.find('\n'));
+}
+
+} // namespace
+
 CalibrationStatustextParser::CalibrationStatustextParser() {}
 
 CalibrationStatustextParser::~CalibrationStatustextParser() {}
 
-bool CalibrationStatustextParser::parse(const std::string& statustext)
+bool CalibrationStatustextParser::parse(std::string_view statustext)
 {
     // We do a quick check before doing more in-depth parsing.
     if (!is_relevant(statustext)) {
         return false;
     }
 
-    // We start with the most likely messages in order to reduce parsing efforts.
-    // As soon as one check is successful, the condition is true and we can stop.
-    if (check_progress(statustext) || check_started(statustext) || check_done(statustext) ||
-        check_failed(statustext) || check_cancelled(statustext)) {
-        return true;
+    // The known messages are told apart by their first characters, so each
+    // statustext is only matched against the one it could be, instead of
+    // trying them all.
+    //
+    // See calibration_messages.h for what PX4 sends.
+    const auto text = statustext.substr(6);
+    bool matched = false;
+    switch (text.empty() ? '\0' : text.front()) {
+        case 'p':
+            matched = check_progress(text);
+            break;
+        case 'c':
+            matched = check_calibration(text);
+            break;
+        default:
+            matched = check_side_progress(text);
+            break;
     }
 
     // Whatever doesn't fit into the first checks will end up as a generic
     // instruction and caught at the end.
-    check_instruction(statustext);
+    if (!matched) {
+        set_instruction(text);
+    }
     return true;
 }
 
@@ -36,109 +98,118 @@ void CalibrationStatustextParser::reset()
     _instruction_message.clear();
 }
 
-bool CalibrationStatustextParser::is_relevant(const std::string& statustext)
+bool CalibrationStatustextParser::is_relevant(std::string_view statustext)
 {
     // This should be a quick check, so pre-processing without looking at the whole string.
     static constexpr char CALIBRATION_PREFIX[] = "[cal] ";
     return (statustext.compare(0, 6, CALIBRATION_PREFIX) == 0);
 }
 
-bool CalibrationStatustextParser::check_started(const std::string& statustext)
+bool CalibrationStatustextParser::check_calibration(std::string_view text)
 {
-    static constexpr char CUSTOM_CAL_QGC_STARTED_MSG[] = "[cal] calibration started: %i %s";
-
-    int version_stamp;
-    const int ret =
-        sscanf(statustext.c_str(), CUSTOM_CAL_QGC_STARTED_MSG, &version_stamp, _tmp_str);
+    if (!consume(text, "calibration ")) {
+        return false;
+    }
 
-    if (ret == 2) {
-        if (version_stamp == 2) {
-            _status = Status::Started;
-        } else {
+    switch (text.empty() ? '\0' : text.front()) {
+        case 's':
+            return check_started(text);
+
+        case 'd':
+            if (consume(text, "done: ") && !rest_of_line(text).empty()) {
+                _status = Status::Done;
+                return true;
+            }
+            return false;
+
+        case 'f': {
+            if (!consume(text, "failed: ")) {
+                return false;
+            }
+            const auto failed_message = rest_of_line(text);
+            if (failed_message.empty()) {
+                return false;
+            }
             _status = Status::Failed;
-
-            std::stringstream error_stream{};
-            error_stream << "Unknown calibration version stamp: " << version_stamp;
-            _failed_message = error_stream.str();
-            LogErr() << _failed_message;
+            _failed_message = failed_message;
+            return true;
         }
-        return true;
-    }
 
-    return false;
-}
+        case 'c':
+            if (text == "cancelled") {
+                _status = Status::Cancelled;
+                return true;
+            }
+            return false;
 
-bool CalibrationStatustextParser::check_done(const std::string& statustext)
-{
-    const int ret = sscanf(statustext.c_str(), CAL_QGC_DONE_MSG, _tmp_str);
-
-    if (ret == 1) {
-        _status = Status::Done;
-        return true;
+        default:
+            return false;
     }
-    return false;
 }
 
-bool CalibrationStatustextParser::check_failed(const std::string& statustext)
+bool CalibrationStatustextParser::check_started(std::string_view text)
 {
-    static constexpr char CUSTOM_CAL_QGC_FAILED_MSG[] = "[cal] calibration failed: %63[^\n]";
+    // "started: <version stamp> <sensor>"
+    if (!consume(text, "started: ")) {
+        return false;
+    }
 
-    const int ret = sscanf(statustext.c_str(), CUSTOM_CAL_QGC_FAILED_MSG, _tmp_str);
+    const auto version_stamp = consume_number(text);
+    if (!version_stamp || rest_of_line(text).empty()) {
+        return false;
+    }
 
-    if (ret == 1) {
+    if (version_stamp.value() == 2) {
+        _status = Status::Started;
+    } else {
         _status = Status::Failed;
-        _failed_message = _tmp_str;
-        return true;
-    }
-    return false;
-}
 
-bool CalibrationStatustextParser::check_cancelled(const std::string& statustext)
-{
-    if (statustext.compare(CAL_QGC_CANCELLED_MSG) == 0) {
-        _status = Status::Cancelled;
-        return true;
+        std::stringstream error_stream{};
+        error_stream << "Unknown calibration version stamp: " << version_stamp.value();
+        _failed_message = error_stream.str();
+        LogErr() << _failed_message;
     }
-    return false;
+    return true;
 }
 
-bool CalibrationStatustextParser::check_progress(const std::string& statustext)
+bool CalibrationStatustextParser::check_progress(std::string_view text)
 {
-    int progress_int;
-    int ret = sscanf(statustext.c_str(), CAL_QGC_PROGRESS_MSG, &progress_int);
-
-    if (ret == 1 && progress_int >= 0 && progress_int <= 100) {
-        _progress = float(progress_int) / 100;
-        _status = Status::Progress;
-        return true;
+    if (!consume(text, "progress <")) {
+        return false;
     }
 
-    static constexpr char SPECIAL_MAG_CAL_QGC_PROGRESS_MSG[] =
-        "[cal] %s side calibration: progress <%u>";
-
-    ret = sscanf(statustext.c_str(), SPECIAL_MAG_CAL_QGC_PROGRESS_MSG, _tmp_str, &progress_int);
-
-    if (ret == 2 && progress_int >= 0 && progress_int <= 100) {
-        _progress = float(progress_int) / 100;
-        _status = Status::Progress;
-        return true;
+    const auto progress_int = consume_number(text);
+    if (!progress_int || progress_int.value() > 100) {
+        return false;
     }
 
-    return false;
+    _progress = float(progress_int.value()) / 100;
+    _status = Status::Progress;
+    return true;
 }
 
-bool CalibrationStatustextParser::check_instruction(const std::string& statustext)
+bool CalibrationStatustextParser::check_side_progress(std::string_view text)
 {
-    static constexpr char CATCHALL[] = "[cal] %63[^\n]";
+    // "<side> side calibration: progress <percent>"
+    const auto space = text.find(' ');
+    if (space == 0 || space == std::string_view::npos) {
+        return false;
+    }
 
-    const int ret = sscanf(statustext.c_str(), CATCHALL, _tmp_str);
+    text.remove_prefix(space);
+    if (!consume(text, " side calibration: ")) {
+        return false;
+    }
+    return check_progress(text);
+}
 
-    if (ret == 1) {
+void CalibrationStatustextParser::set_instruction(std::string_view text)
+{
+    const auto instruction = rest_of_line(text);
+    if (!instruction.empty()) {
         _status = Status::Instruction;
-        _instruction_message = _tmp_str;
-        return true;
+        _instruction_message = instruction;
     }
-    return false;
 }
 
 } // namespace mavsdk
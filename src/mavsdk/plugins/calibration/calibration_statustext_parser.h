@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <cmath>
 
 namespace mavsdk {
@@ -18,28 +19,28 @@ public:
 
     enum class Status { None, Started, Done, Failed, Cancelled, Progress, Instruction };
 
+    // Quick check whether a statustext is about calibration at all.
+    static bool is_relevant(std::string_view statustext);
+
     void reset();
-    bool parse(const std::string& statustext);
+    bool parse(std::string_view statustext);
     Status get_status() const { return _status; }
     float get_progress() const { return _progress; }
     const std::string& get_failed_message() const { return _failed_message; }
     const std::string& get_instruction() const { return _instruction_message; }
 
 private:
-    bool is_relevant(const std::string& statustext);
-    bool check_started(const std::string& statustext);
-    bool check_done(const std::string& statustext);
-    bool check_failed(const std::string& statustext);
-    bool check_cancelled(const std::string& statustext);
-    bool check_progress(const std::string& statustext);
-    bool check_instruction(const std::string& statustext);
+    // These get the text after the "[cal] " prefix.
+    bool check_calibration(std::string_view text);
+    bool check_started(std::string_view text);
+    bool check_progress(std::string_view text);
+    bool check_side_progress(std::string_view text);
+    void set_instruction(std::string_view text);
 
     Status _status{Status::None};
     float _progress{NAN};
     std::string _failed_message{};
     std::string _instruction_message{};
-
-    char _tmp_str[64];
 };
 
 } // namespace mavsdk
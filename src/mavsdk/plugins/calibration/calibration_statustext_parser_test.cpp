@@ -118,3 +118,46 @@ TEST(CalibrationStatustextParser, Instructions)
     EXPECT_EQ(parser.get_status(), CalibrationStatustextParser::Status::Instruction);
     EXPECT_STREQ(parser.get_instruction().c_str(), "down side result: [  0.0089  -0.4756 -10.43 ]");
 }
+
+TEST(CalibrationStatustextParser, Done)
+{
+    CalibrationStatustextParser parser;
+
+    EXPECT_TRUE(parser.parse("[cal] calibration done: gyro"));
+    EXPECT_EQ(parser.get_status(), CalibrationStatustextParser::Status::Done);
+}
+
+TEST(CalibrationStatustextParser, UnknownVersionStampFails)
+{
+    CalibrationStatustextParser parser;
+
+    EXPECT_TRUE(parser.parse("[cal] calibration started: 1 mag"));
+    EXPECT_EQ(parser.get_status(), CalibrationStatustextParser::Status::Failed);
+    EXPECT_STREQ(parser.get_failed_message().c_str(), "Unknown calibration version stamp: 1");
+}
+
+TEST(CalibrationStatustextParser, AlmostKnownMessagesAreInstructions)
+{
+    CalibrationStatustextParser parser;
+
+    EXPECT_TRUE(parser.parse("[cal] progress <101>"));
+    EXPECT_EQ(parser.get_status(), CalibrationStatustextParser::Status::Instruction);
+    EXPECT_STREQ(parser.get_instruction().c_str(), "progress <101>");
+
+    parser.reset();
+    EXPECT_TRUE(parser.parse("[cal] calibration warning: sensor noisy"));
+    EXPECT_EQ(parser.get_status(), CalibrationStatustextParser::Status::Instruction);
+    EXPECT_STREQ(parser.get_instruction().c_str(), "calibration warning: sensor noisy");
+
+    parser.reset();
+    EXPECT_TRUE(parser.parse("[cal] calibration cancelled now"));
+    EXPECT_EQ(parser.get_status(), CalibrationStatustextParser::Status::Instruction);
+
+    parser.reset();
+    EXPECT_TRUE(parser.parse("[cal] left side calibration: done"));
+    EXPECT_EQ(parser.get_status(), CalibrationStatustextParser::Status::Instruction);
+
+    parser.reset();
+    EXPECT_FALSE(parser.parse("[cal]progress <10>"));
+    EXPECT_EQ(parser.get_status(), CalibrationStatustextParser::Status::None);
+}
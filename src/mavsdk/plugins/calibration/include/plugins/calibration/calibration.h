@@ -15,6 +15,7 @@
 
 #include "plugin_base.h"
 
+#include "awaitable.h"
 #include "handle.h"
 
 namespace mavsdk {
@@ -191,6 +192,9 @@ public:
 private:
     /** @private Underlying implementation, set at instantiation */
     std::unique_ptr<CalibrationImpl> _impl;
+
+    /** @private Hand-written additions in calibration_ext.h, if any */
+    friend class CalibrationExt;
 };
 
 } // namespace mavsdk
\ No newline at end of file
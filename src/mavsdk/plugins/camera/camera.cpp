@@ -30,7 +30,7 @@ Camera::Camera(std::shared_ptr<System> system) :
 
 Camera::~Camera() {}
 
-void Camera::prepare_async(const ResultCallback callback)
+void Camera::prepare_async(const ResultCallback& callback)
 {
     _impl->prepare_async(callback);
 }
@@ -40,7 +40,7 @@ Camera::Result Camera::prepare() const
     return _impl->prepare();
 }
 
-void Camera::take_photo_async(const ResultCallback callback)
+void Camera::take_photo_async(const ResultCallback& callback)
 {
     _impl->take_photo_async(callback);
 }
@@ -50,7 +50,7 @@ Camera::Result Camera::take_photo() const
     return _impl->take_photo();
 }
 
-void Camera::start_photo_interval_async(float interval_s, const ResultCallback callback)
+void Camera::start_photo_interval_async(float interval_s, const ResultCallback& callback)
 {
     _impl->start_photo_interval_async(interval_s, callback);
 }
@@ -60,7 +60,7 @@ Camera::Result Camera::start_photo_interval(float interval_s) const
     return _impl->start_photo_interval(interval_s);
 }
 
-void Camera::stop_photo_interval_async(const ResultCallback callback)
+void Camera::stop_photo_interval_async(const ResultCallback& callback)
 {
     _impl->stop_photo_interval_async(callback);
 }
@@ -70,7 +70,7 @@ Camera::Result Camera::stop_photo_interval() const
     return _impl->stop_photo_interval();
 }
 
-void Camera::start_video_async(const ResultCallback callback)
+void Camera::start_video_async(const ResultCallback& callback)
 {
     _impl->start_video_async(callback);
 }
@@ -80,7 +80,7 @@ Camera::Result Camera::start_video() const
     return _impl->start_video();
 }
 
-void Camera::stop_video_async(const ResultCallback callback)
+void Camera::stop_video_async(const ResultCallback& callback)
 {
     _impl->stop_video_async(callback);
 }
@@ -100,7 +100,7 @@ Camera::Result Camera::stop_video_streaming() const
     return _impl->stop_video_streaming();
 }
 
-void Camera::set_mode_async(Mode mode, const ResultCallback callback)
+void Camera::set_mode_async(Mode mode, const ResultCallback& callback)
 {
     _impl->set_mode_async(mode, callback);
 }
@@ -110,7 +110,7 @@ Camera::Result Camera::set_mode(Mode mode) const
     return _impl->set_mode(mode);
 }
 
-void Camera::list_photos_async(PhotosRange photos_range, const ListPhotosCallback callback)
+void Camera::list_photos_async(PhotosRange photos_range, const ListPhotosCallback& callback)
 {
     _impl->list_photos_async(photos_range, callback);
 }
@@ -219,27 +219,27 @@ std::vector<Camera::SettingOptions> Camera::possible_setting_options() const
     return _impl->possible_setting_options();
 }
 
-void Camera::set_setting_async(Setting setting, const ResultCallback callback)
+void Camera::set_setting_async(const Setting& setting, const ResultCallback& callback)
 {
     _impl->set_setting_async(setting, callback);
 }
 
-Camera::Result Camera::set_setting(Setting setting) const
+Camera::Result Camera::set_setting(const Setting& setting) const
 {
     return _impl->set_setting(setting);
 }
 
-void Camera::get_setting_async(Setting setting, const GetSettingCallback callback)
+void Camera::get_setting_async(const Setting& setting, const GetSettingCallback& callback)
 {
     _impl->get_setting_async(setting, callback);
 }
 
-std::pair<Camera::Result, Camera::Setting> Camera::get_setting(Setting setting) const
+std::pair<Camera::Result, Camera::Setting> Camera::get_setting(const Setting& setting) const
 {
     return _impl->get_setting(setting);
 }
 
-void Camera::format_storage_async(const ResultCallback callback)
+void Camera::format_storage_async(const ResultCallback& callback)
 {
     _impl->format_storage_async(callback);
 }
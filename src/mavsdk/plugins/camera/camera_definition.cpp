@@ -1,84 +1,153 @@
 #include "log.h"
 #include "camera_definition.h"
 
+#include <fstream>
+#include <map>
+#include <sstream>
+
 namespace mavsdk {
 
-CameraDefinition::CameraDefinition() {}
+CameraDefinition::CameraDefinition() : _parsed(std::make_shared<const ParsedDefinition>()) {}
 
 CameraDefinition::~CameraDefinition() {}
 
 bool CameraDefinition::load_file(const std::string& filepath)
 {
-    tinyxml2::XMLError xml_error = _doc.LoadFile(filepath.c_str());
-    if (xml_error != tinyxml2::XML_SUCCESS) {
-        LogErr() << "tinyxml2::LoadFile failed: " << _doc.ErrorStr();
+    std::ifstream file_stream(filepath);
+    if (!file_stream.is_open()) {
+        LogErr() << "Could not open " << filepath;
         return false;
     }
 
-    return parse_xml();
+    std::stringstream content;
+    content << file_stream.rdbuf();
+    return load_parsed_definition(shared_parsed_definition(content.str()));
 }
 
 bool CameraDefinition::load_string(const std::string& content)
 {
-    tinyxml2::XMLError xml_error = _doc.Parse(content.c_str());
-    if (xml_error != tinyxml2::XML_SUCCESS) {
-        LogErr() << "tinyxml2::Parse failed: " << _doc.ErrorStr();
+    return load_parsed_definition(shared_parsed_definition(content));
+}
+
+bool CameraDefinition::load_parsed_definition(std::shared_ptr<const ParsedDefinition> parsed)
+{
+    if (!parsed) {
         return false;
     }
 
-    return parse_xml();
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    _parsed = std::move(parsed);
+    _possible_settings_valid = false;
+    _current_settings.clear();
+    for (const auto& parameter : _parsed->parameter_map) {
+        InternalCurrentSetting empty_setting{};
+        empty_setting.needs_updating = true;
+        _current_settings[parameter.first] = empty_setting;
+    }
+
+    return true;
+}
+
+std::shared_ptr<const CameraDefinition::ParsedDefinition>
+CameraDefinition::shared_parsed_definition(const std::string& content)
+{
+    // By content rather than URI, so a camera announcing a changed file
+    // doesn't get the old one.
+    static std::mutex mutex;
+    static std::map<std::string, std::weak_ptr<const ParsedDefinition>> parsed_by_content;
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto it = parsed_by_content.find(content);
+    if (it != parsed_by_content.end()) {
+        if (auto parsed = it->second.lock()) {
+            return parsed;
+        }
+    }
+
+    tinyxml2::XMLDocument doc;
+    tinyxml2::XMLError xml_error = doc.Parse(content.c_str());
+    if (xml_error != tinyxml2::XML_SUCCESS) {
+        LogErr() << "tinyxml2::Parse failed: " << doc.ErrorStr();
+        return nullptr;
+    }
+
+    auto parsed = parse_xml(doc);
+    if (!parsed) {
+        return nullptr;
+    }
+
+    // Forget the ones no camera uses anymore.
+    for (auto entry = parsed_by_content.begin(); entry != parsed_by_content.end();) {
+        if (entry->second.expired()) {
+            entry = parsed_by_content.erase(entry);
+        } else {
+            ++entry;
+        }
+    }
+    parsed_by_content[content] = parsed;
+
+    return parsed;
 }
 
 std::string CameraDefinition::get_model() const
 {
     std::lock_guard<std::mutex> lock(_mutex);
 
-    return _model;
+    return _parsed->model;
 }
 
 std::string CameraDefinition::get_vendor() const
 {
     std::lock_guard<std::mutex> lock(_mutex);
 
-    return _vendor;
+    return _parsed->vendor;
 }
 
-bool CameraDefinition::parse_xml()
+const CameraDefinition::Parameter* CameraDefinition::find_parameter(const std::string& name) const
 {
-    std::lock_guard<std::mutex> lock(_mutex);
+    const auto it = _parsed->parameter_map.find(name);
+    return it != _parsed->parameter_map.end() ? it->second.get() : nullptr;
+}
+
+std::shared_ptr<const CameraDefinition::ParsedDefinition>
+CameraDefinition::parse_xml(const tinyxml2::XMLDocument& doc)
+{
+    auto parsed = std::make_shared<ParsedDefinition>();
 
-    auto e_mavlinkcamera = _doc.FirstChildElement("mavlinkcamera");
+    auto e_mavlinkcamera = doc.FirstChildElement("mavlinkcamera");
     if (!e_mavlinkcamera) {
         LogErr() << "Tag mavlinkcamera not found";
-        return false;
+        return nullptr;
     }
 
     auto e_definition = e_mavlinkcamera->FirstChildElement("definition");
     if (!e_definition) {
         LogErr() << "definition not found";
-        return false;
+        return nullptr;
     }
 
     auto e_model = e_definition->FirstChildElement("model");
     if (!e_model) {
         LogErr() << "model not found";
-        return false;
+        return nullptr;
     }
 
-    _model = e_model->GetText();
+    parsed->model = e_model->GetText();
 
     auto e_vendor = e_definition->FirstChildElement("vendor");
     if (!e_vendor) {
         LogErr() << "vendor not found";
-        return false;
+        return nullptr;
     }
 
-    _vendor = e_vendor->GetText();
+    parsed->vendor = e_vendor->GetText();
 
     auto e_parameters = e_mavlinkcamera->FirstChildElement("parameters");
     if (!e_parameters) {
         LogErr() << "Tag parameters not found";
-        return false;
+        return nullptr;
     }
 
     std::unordered_map<std::string, std::string> type_map{};
@@ -88,13 +157,13 @@ bool CameraDefinition::parse_xml()
         const char* param_name = e_parameter->Attribute("name");
         if (!param_name) {
             LogErr() << "name attribute missing";
-            return false;
+            return nullptr;
         }
 
         const char* type_str = e_parameter->Attribute("type");
         if (!type_str) {
             LogErr() << "type attribute missing";
-            return false;
+            return nullptr;
         }
 
         type_map[param_name] = type_str;
@@ -107,13 +176,13 @@ bool CameraDefinition::parse_xml()
         const char* param_name = e_parameter->Attribute("name");
         if (!param_name) {
             LogErr() << "name attribute missing";
-            return false;
+            return nullptr;
         }
 
         const char* type_str = e_parameter->Attribute("type");
         if (!type_str) {
             LogErr() << "type attribute missing for " << param_name;
-            return false;
+            return nullptr;
         }
 
         if (strcmp(type_str, "string") == 0) {
@@ -128,7 +197,7 @@ bool CameraDefinition::parse_xml()
 
         if (!new_parameter->type.set_empty_type_from_xml(type_str)) {
             LogErr() << "Unknown type attribute: " << type_str;
-            return false;
+            return nullptr;
         }
 
         // By default control is on.
@@ -158,7 +227,7 @@ bool CameraDefinition::parse_xml()
 
         if (new_parameter->is_readonly && new_parameter->is_writeonly) {
             LogErr() << "parameter can't be readonly and writeonly";
-            return false;
+            return nullptr;
         }
 
         // Be definition custom types do not have control.
@@ -169,7 +238,7 @@ bool CameraDefinition::parse_xml()
         auto e_description = e_parameter->FirstChildElement("description");
         if (!e_description) {
             LogErr() << "Description missing";
-            return false;
+            return nullptr;
         }
 
         new_parameter->description = e_description->GetText();
@@ -208,7 +277,7 @@ bool CameraDefinition::parse_xml()
 
             if (!maybe_default.first) {
                 LogWarn() << "Default not found for " << param_name;
-                return false;
+                return nullptr;
             }
 
             new_parameter->default_option = maybe_default.second;
@@ -225,14 +294,10 @@ bool CameraDefinition::parse_xml()
             new_parameter->default_option = std::get<2>(maybe_range_options);
         }
 
-        _parameter_map[param_name] = new_parameter;
-
-        InternalCurrentSetting empty_setting{};
-        empty_setting.needs_updating = true;
-        _current_settings[param_name] = empty_setting;
+        parsed->parameter_map[param_name] = new_parameter;
     }
 
-    return true;
+    return parsed;
 }
 
 std::pair<bool, std::vector<std::shared_ptr<CameraDefinition::Option>>>
@@ -430,8 +495,9 @@ void CameraDefinition::assume_default_settings()
     std::lock_guard<std::mutex> lock(_mutex);
 
     _current_settings.clear();
+    _possible_settings_valid = false;
 
-    for (const auto& parameter : _parameter_map) {
+    for (const auto& parameter : _parsed->parameter_map) {
         // if (parameter.second->is_range) {
 
         InternalCurrentSetting new_setting;
@@ -483,13 +549,18 @@ bool CameraDefinition::get_possible_settings(
 bool CameraDefinition::get_possible_settings_locked(
     std::unordered_map<std::string, MAVLinkParameters::ParamValue>& settings)
 {
+    if (_possible_settings_valid) {
+        settings = _possible_settings;
+        return (settings.size() > 0);
+    }
+
     settings.clear();
 
     // Find all exclusions
     // TODO: use set instead of vector
     std::vector<std::string> exclusions{};
 
-    for (const auto& parameter : _parameter_map) {
+    for (const auto& parameter : _parsed->parameter_map) {
         for (const auto& option : parameter.second->options) {
             if (_current_settings[parameter.first].value == option->value) {
                 for (const auto& exclusion : option->exclusions) {
@@ -508,7 +579,8 @@ bool CameraDefinition::get_possible_settings_locked(
                 excluded = true;
             }
         }
-        if (!_parameter_map[setting.first]->is_control) {
+        const auto* parameter = find_parameter(setting.first);
+        if (parameter == nullptr || !parameter->is_control) {
             continue;
         }
 
@@ -518,28 +590,59 @@ bool CameraDefinition::get_possible_settings_locked(
         settings[setting.first] = setting.second.value;
     }
 
+    _possible_settings = settings;
+    _possible_settings_valid = true;
+
     return (settings.size() > 0);
 }
 
+void CameraDefinition::update_possible_settings_locked(
+    const std::string& name, const MAVLinkParameters::ParamValue& value)
+{
+    if (!_possible_settings_valid) {
+        return;
+    }
+
+    const auto* parameter = find_parameter(name);
+    if (parameter == nullptr) {
+        return;
+    }
+
+    // Only settings with exclusions change which other settings are possible,
+    // for all others the cached result can just be patched.
+    for (const auto& option : parameter->options) {
+        if (!option->exclusions.empty()) {
+            _possible_settings_valid = false;
+            return;
+        }
+    }
+
+    auto it = _possible_settings.find(name);
+    if (it != _possible_settings.end()) {
+        it->second = value;
+    }
+}
+
 bool CameraDefinition::set_setting(
     const std::string& name, const MAVLinkParameters::ParamValue& value)
 {
     std::lock_guard<std::mutex> lock(_mutex);
 
-    if (_parameter_map.find(name) == _parameter_map.end()) {
+    const auto* parameter = find_parameter(name);
+    if (parameter == nullptr) {
         LogErr() << "Unknown setting to set: " << name;
         return false;
     }
 
     // For range params, we need to verify the range.
-    if (_parameter_map[name]->is_range) {
+    if (parameter->is_range) {
         // Check against the minimum
-        if (value < _parameter_map[name]->options[0]->value) {
+        if (value < parameter->options[0]->value) {
             LogErr() << "Chosen value smaller than minimum";
             return false;
         }
 
-        if (value > _parameter_map[name]->options[1]->value) {
+        if (value > parameter->options[1]->value) {
             LogErr() << "Chosen value bigger than maximum";
             return false;
         }
@@ -547,13 +650,17 @@ bool CameraDefinition::set_setting(
         // TODO: Check step as well, until now we have only seen steps of 1 in the wild though.
     }
 
+    if (!(_current_settings[name].value == value)) {
+        update_possible_settings_locked(name, value);
+    }
+
     _current_settings[name].value = value;
     _current_settings[name].needs_updating = false;
 
     // Some param changes cause other params to change, so they need to be updated.
     // The camera definition just keeps track of these params but the actual param fetching
     // needs to happen outside of this class.
-    for (const auto& update : _parameter_map[name]->updates) {
+    for (const auto& update : parameter->updates) {
         if (_current_settings.find(update) == _current_settings.end()) {
             // LogDebug() << "Update to '" << update << "' not understood.";
             continue;
@@ -588,12 +695,13 @@ bool CameraDefinition::get_option_value(
 {
     std::lock_guard<std::mutex> lock(_mutex);
 
-    if (_parameter_map.find(param_name) == _parameter_map.end()) {
+    const auto* parameter = find_parameter(param_name);
+    if (parameter == nullptr) {
         LogErr() << "Unknown parameter to get option: " << param_name;
         return false;
     }
 
-    for (const auto& option : _parameter_map[param_name]->options) {
+    for (const auto& option : parameter->options) {
         if (option->value == option_value) {
             value = option->value;
             return true;
@@ -610,12 +718,13 @@ bool CameraDefinition::get_all_options(
 
     values.clear();
 
-    if (_parameter_map.find(name) == _parameter_map.end()) {
+    const auto* parameter = find_parameter(name);
+    if (parameter == nullptr) {
         LogErr() << "Unknown parameter to get all options";
         return false;
     }
 
-    for (const auto& option : _parameter_map[name]->options) {
+    for (const auto& option : parameter->options) {
         values.push_back(option->value);
     }
 
@@ -629,7 +738,8 @@ bool CameraDefinition::get_possible_options(
 
     values.clear();
 
-    if (_parameter_map.find(name) == _parameter_map.end()) {
+    const auto* found_parameter = find_parameter(name);
+    if (found_parameter == nullptr) {
         LogErr() << "Unknown parameter to get possible options";
         return false;
     }
@@ -648,7 +758,7 @@ bool CameraDefinition::get_possible_options(
     // TODO: use set instead of vector
     std::vector<std::string> exclusions{};
 
-    for (const auto& parameter : _parameter_map) {
+    for (const auto& parameter : _parsed->parameter_map) {
         for (const auto& option : parameter.second->options) {
             if (_current_settings[parameter.first].needs_updating) {
                 // LogWarn() << parameter.first << " needs updating";
@@ -668,7 +778,7 @@ bool CameraDefinition::get_possible_options(
     std::vector<MAVLinkParameters::ParamValue> allowed_ranges{};
 
     // Check allowed ranges.
-    for (const auto& parameter : _parameter_map) {
+    for (const auto& parameter : _parsed->parameter_map) {
         if (!parameter.second->is_control) {
             continue;
         }
@@ -692,8 +802,9 @@ bool CameraDefinition::get_possible_options(
             if (_current_settings[parameter.first].value == option->value) {
                 // Go through parameter ranges but only concerning the parameter that
                 // we're interested in..
-                if (option->parameter_ranges.find(name) != option->parameter_ranges.end()) {
-                    for (const auto& range : option->parameter_ranges[name]) {
+                const auto ranges = option->parameter_ranges.find(name);
+                if (ranges != option->parameter_ranges.end()) {
+                    for (const auto& range : ranges->second) {
                         allowed_ranges.push_back(range.second);
                     }
                 }
@@ -702,7 +813,7 @@ bool CameraDefinition::get_possible_options(
     }
 
     // Intersect
-    for (const auto& option : _parameter_map[name]->options) {
+    for (const auto& option : found_parameter->options) {
         bool option_allowed = false;
         for (const auto& allowed_range : allowed_ranges) {
             if (option->value == allowed_range) {
@@ -724,7 +835,7 @@ void CameraDefinition::get_unknown_params(
 
     params.clear();
 
-    for (const auto& parameter : _parameter_map) {
+    for (const auto& parameter : _parsed->parameter_map) {
         if (_current_settings[parameter.first].needs_updating) {
             params.push_back(std::make_pair<>(parameter.first, parameter.second->type));
         }
@@ -735,7 +846,7 @@ void CameraDefinition::set_all_params_unknown()
 {
     std::lock_guard<std::mutex> lock(_mutex);
 
-    for (auto& parameter : _parameter_map) {
+    for (auto& parameter : _parsed->parameter_map) {
         _current_settings[parameter.first].needs_updating = true;
     }
 }
@@ -744,12 +855,13 @@ bool CameraDefinition::is_setting_range(const std::string& name)
 {
     std::lock_guard<std::mutex> lock(_mutex);
 
-    if (_parameter_map.find(name) == _parameter_map.end()) {
+    const auto* parameter = find_parameter(name);
+    if (parameter == nullptr) {
         LogWarn() << "Setting " << name << " not found.";
         return false;
     }
 
-    return _parameter_map[name]->is_range;
+    return parameter->is_range;
 }
 
 bool CameraDefinition::get_setting_str(const std::string& name, std::string& description)
@@ -758,12 +870,13 @@ bool CameraDefinition::get_setting_str(const std::string& name, std::string& des
 
     description.clear();
 
-    if (_parameter_map.find(name) == _parameter_map.end()) {
+    const auto* parameter = find_parameter(name);
+    if (parameter == nullptr) {
         LogWarn() << "Setting " << name << " not found.";
         return false;
     }
 
-    description = _parameter_map[name]->description;
+    description = parameter->description;
     return true;
 }
 
@@ -774,12 +887,13 @@ bool CameraDefinition::get_option_str(
 
     description.clear();
 
-    if (_parameter_map.find(setting_name) == _parameter_map.end()) {
+    const auto* parameter = find_parameter(setting_name);
+    if (parameter == nullptr) {
         LogWarn() << "Setting " << setting_name << " not found.";
         return false;
     }
 
-    for (const auto& option : _parameter_map[setting_name]->options) {
+    for (const auto& option : parameter->options) {
         std::stringstream value_ss{};
         value_ss << option->value;
         if (option->value == option_name) {
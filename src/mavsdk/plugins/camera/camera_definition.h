@@ -60,9 +60,6 @@ public:
     const CameraDefinition& operator=(const CameraDefinition&) = delete;
 
 private:
-    bool get_possible_settings_locked(
-        std::unordered_map<std::string, MAVLinkParameters::ParamValue>& settings);
-
     using ParameterRange = std::unordered_map<std::string, MAVLinkParameters::ParamValue>;
 
     struct Option {
@@ -84,26 +81,44 @@ private:
         bool is_range{false};
     };
 
-    bool parse_xml();
+    // What the file describes, which never changes once parsed. Cameras
+    // with the same file share it, only their current settings are their own.
+    struct ParsedDefinition {
+        std::string model{};
+        std::string vendor{};
+        std::unordered_map<std::string, std::shared_ptr<const Parameter>> parameter_map{};
+    };
+
+    // Parses the content, unless a camera still uses the same content.
+    static std::shared_ptr<const ParsedDefinition> shared_parsed_definition(
+        const std::string& content);
+    bool load_parsed_definition(std::shared_ptr<const ParsedDefinition> parsed);
+
+    static std::shared_ptr<const ParsedDefinition> parse_xml(const tinyxml2::XMLDocument& doc);
 
     // Until we have std::optional we need to use std::pair to return something that might be
     // nothing.
-    std::pair<bool, std::vector<std::shared_ptr<Option>>> parse_options(
+    static std::pair<bool, std::vector<std::shared_ptr<Option>>> parse_options(
         const tinyxml2::XMLElement* options_handle,
         const std::string& param_name,
         std::unordered_map<std::string, std::string>& type_map);
-    std::tuple<bool, std::vector<std::shared_ptr<Option>>, Option> parse_range_options(
+    static std::tuple<bool, std::vector<std::shared_ptr<Option>>, Option> parse_range_options(
         const tinyxml2::XMLElement* param_handle,
         const std::string& param_name,
         std::unordered_map<std::string, std::string>& type_map);
-    std::pair<bool, Option> find_default(
+    static std::pair<bool, Option> find_default(
         const std::vector<std::shared_ptr<Option>>& options, const std::string& default_str);
 
-    mutable std::mutex _mutex{};
+    const Parameter* find_parameter(const std::string& name) const;
 
-    tinyxml2::XMLDocument _doc{};
+    bool get_possible_settings_locked(
+        std::unordered_map<std::string, MAVLinkParameters::ParamValue>& settings);
+    void update_possible_settings_locked(
+        const std::string& name, const MAVLinkParameters::ParamValue& value);
+
+    mutable std::mutex _mutex{};
 
-    std::unordered_map<std::string, std::shared_ptr<Parameter>> _parameter_map{};
+    std::shared_ptr<const ParsedDefinition> _parsed;
 
     struct InternalCurrentSetting {
         MAVLinkParameters::ParamValue value{};
@@ -112,8 +127,10 @@ private:
 
     std::unordered_map<std::string, InternalCurrentSetting> _current_settings{};
 
-    std::string _model{};
-    std::string _vendor{};
+    // Needs _mutex, the result of get_possible_settings until a setting with
+    // exclusions changes.
+    std::unordered_map<std::string, MAVLinkParameters::ParamValue> _possible_settings{};
+    bool _possible_settings_valid{false};
 };
 
 } // namespace mavsdk
@@ -0,0 +1,126 @@
+#include "camera_definition_cache.h"
+#include "fs.h"
+#include "log.h"
+#include "sha256.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <sstream>
+#include <utility>
+
+namespace mavsdk {
+
+namespace {
+
+// First line of a cache file, so that files of another format are ignored.
+const std::string file_magic{"mavsdk-camera-definition 1"};
+
+} // namespace
+
+CameraDefinitionCache::CameraDefinitionCache(std::optional<std::string> directory) :
+    _directory(std::move(directory))
+{}
+
+CameraDefinitionCache& CameraDefinitionCache::instance()
+{
+    static CameraDefinitionCache cache{get_cache_directory("mavsdk/camera_definitions")};
+    return cache;
+}
+
+std::optional<CameraDefinitionCache::Entry> CameraDefinitionCache::get(const std::string& uri)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto it = _entries.find(uri);
+    if (it != _entries.end()) {
+        return it->second;
+    }
+
+    auto maybe_entry = load(uri);
+    if (maybe_entry) {
+        _entries[uri] = maybe_entry.value();
+    }
+    return maybe_entry;
+}
+
+void CameraDefinitionCache::put(const std::string& uri, const Entry& entry)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _entries[uri] = entry;
+    store(uri, entry);
+}
+
+std::string CameraDefinitionCache::path_for(const std::string& uri) const
+{
+    // URIs can't be used as file names, their hash can.
+    Sha256 sha256;
+    sha256.add(reinterpret_cast<const uint8_t*>(uri.data()), uri.size());
+    const auto digest = sha256.finish();
+
+    std::stringstream ss;
+    ss << std::hex << std::setfill('0');
+    for (std::size_t i = 0; i < 16; ++i) {
+        ss << std::setw(2) << static_cast<unsigned>(digest[i]);
+    }
+    return _directory.value() + path_separator + ss.str() + ".xml";
+}
+
+std::optional<CameraDefinitionCache::Entry>
+CameraDefinitionCache::load(const std::string& uri) const
+{
+    if (!_directory) {
+        return {};
+    }
+
+    std::ifstream file(path_for(uri), std::ios::binary);
+    if (!file) {
+        return {};
+    }
+
+    std::string magic;
+    std::string stored_uri;
+    std::string version;
+    Entry entry;
+    if (!std::getline(file, magic) || magic != file_magic || !std::getline(file, stored_uri) ||
+        stored_uri != uri || !std::getline(file, version) ||
+        !std::getline(file, entry.validators.etag) ||
+        !std::getline(file, entry.validators.last_modified)) {
+        return {};
+    }
+
+    entry.version = static_cast<uint32_t>(std::strtoul(version.c_str(), nullptr, 10));
+    entry.content.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    return {std::move(entry)};
+}
+
+void CameraDefinitionCache::store(const std::string& uri, const Entry& entry) const
+{
+    if (!_directory) {
+        return;
+    }
+
+    // Written next to it first, so that nobody loads a partial file.
+    const auto path = path_for(uri);
+    const auto tmp_path = path + ".part";
+    {
+        std::ofstream file(tmp_path, std::ios::binary | std::ios::trunc);
+        file << file_magic << '\n'
+             << uri << '\n'
+             << entry.version << '\n'
+             << entry.validators.etag << '\n'
+             << entry.validators.last_modified << '\n'
+             << entry.content;
+        if (!file) {
+            LogWarn() << "Could not write camera definition cache file " << tmp_path;
+            file.close();
+            fs_remove(tmp_path);
+            return;
+        }
+    }
+    if (!fs_rename(tmp_path, path)) {
+        LogWarn() << "Could not write camera definition cache file " << path;
+    }
+}
+
+} // namespace mavsdk
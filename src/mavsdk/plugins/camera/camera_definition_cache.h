@@ -0,0 +1,53 @@
+#pragma once
+
+#include "curl_wrapper_types.h"
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+
+namespace mavsdk {
+
+// Camera definition files by URI, shared by all cameras, and kept on disk
+// so that they survive restarts.
+//
+// If a camera announces the version we have, the file is used without
+// asking the server at all. Otherwise the validators are used to only
+// download it if it changed.
+class CameraDefinitionCache {
+public:
+    struct Entry {
+        uint32_t version{0};
+        HttpValidators validators{};
+        std::string content{};
+    };
+
+    // Without a directory, entries are only kept in memory.
+    explicit CameraDefinitionCache(std::optional<std::string> directory);
+    ~CameraDefinitionCache() = default;
+
+    // Non-copyable
+    CameraDefinitionCache(const CameraDefinitionCache&) = delete;
+    const CameraDefinitionCache& operator=(const CameraDefinitionCache&) = delete;
+
+    // The cache of this process, below the user's cache directory.
+    static CameraDefinitionCache& instance();
+
+    std::optional<Entry> get(const std::string& uri);
+    void put(const std::string& uri, const Entry& entry);
+
+private:
+    std::string path_for(const std::string& uri) const;
+    std::optional<Entry> load(const std::string& uri) const;
+    void store(const std::string& uri, const Entry& entry) const;
+
+    const std::optional<std::string> _directory;
+
+    std::mutex _mutex{};
+    // Needs _mutex
+    std::map<std::string, Entry> _entries{};
+};
+
+} // namespace mavsdk
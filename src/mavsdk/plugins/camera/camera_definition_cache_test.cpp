@@ -0,0 +1,56 @@
+#include "camera_definition_cache.h"
+#include "fs.h"
+
+#include <gtest/gtest.h>
+
+using namespace mavsdk;
+
+namespace {
+
+CameraDefinitionCache::Entry make_entry(uint32_t version, const std::string& content)
+{
+    CameraDefinitionCache::Entry entry;
+    entry.version = version;
+    entry.validators.etag = "\"abc123\"";
+    entry.validators.last_modified = "Wed, 21 Oct 2015 07:28:00 GMT";
+    entry.content = content;
+    return entry;
+}
+
+} // namespace
+
+TEST(CameraDefinitionCache, KeepsEntriesInMemory)
+{
+    CameraDefinitionCache cache{std::nullopt};
+    EXPECT_FALSE(cache.get("http://camera/definition.xml"));
+
+    cache.put("http://camera/definition.xml", make_entry(3, "<mavlinkcamera/>"));
+
+    const auto entry = cache.get("http://camera/definition.xml");
+    ASSERT_TRUE(entry);
+    EXPECT_EQ(entry->version, 3);
+    EXPECT_EQ(entry->content, "<mavlinkcamera/>");
+    EXPECT_FALSE(cache.get("http://other/definition.xml"));
+}
+
+TEST(CameraDefinitionCache, KeepsEntriesOnDisk)
+{
+    const auto directory = create_tmp_directory("mavsdk-camera-definition-cache-test");
+    ASSERT_TRUE(directory);
+
+    const std::string content =
+        "<mavlinkcamera>\n  <definition version=\"3\"/>\n</mavlinkcamera>\n";
+    {
+        CameraDefinitionCache cache{directory};
+        cache.put("http://camera/definition.xml", make_entry(3, content));
+    }
+
+    CameraDefinitionCache cache{directory};
+    const auto entry = cache.get("http://camera/definition.xml");
+    ASSERT_TRUE(entry);
+    EXPECT_EQ(entry->version, 3);
+    EXPECT_EQ(entry->validators.etag, "\"abc123\"");
+    EXPECT_EQ(entry->validators.last_modified, "Wed, 21 Oct 2015 07:28:00 GMT");
+    EXPECT_EQ(entry->content, content);
+    EXPECT_FALSE(cache.get("http://other/definition.xml"));
+}
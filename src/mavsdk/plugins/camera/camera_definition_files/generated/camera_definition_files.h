@@ -1,6 +1,5 @@
 /* Automatic generated file. DO NOT EDIT.
-   The file was generated by cpp_rsc program
-   https://github.com/orex/cpp_rsc
+   The file was generated by tools/generate_camera_definitions.py
    This is a header file*/
 
 
@@ -8,26 +7,26 @@
 #define CAMERA_DEFINITION_FILES_H
   extern const char cgoetxml[];
   
-  const int cgoetxml_size = 16097; 
+  const int cgoetxml_size = 11154; 
 
   extern const char e10txml[];
   
-  const int e10txml_size = 13781; 
+  const int e10txml_size = 6557; 
 
   extern const char e30zxml[];
   
-  const int e30zxml_size = 20658; 
+  const int e30zxml_size = 13778; 
 
   extern const char e50xml[];
   
-  const int e50xml_size = 30430; 
+  const int e50xml_size = 19143; 
 
   extern const char e90xml[];
   
-  const int e90xml_size = 63539; 
+  const int e90xml_size = 38773; 
 
   extern const char ILCE7RM4xml[];
   
-  const int ILCE7RM4xml_size = 16816; 
+  const int ILCE7RM4xml_size = 10238; 
 
 #endif /*CAMERA_DEFINITION_FILES_H */
@@ -484,6 +484,33 @@ TEST(CameraDefinition, E90OptionHumanReadable)
     EXPECT_STREQ(description.c_str(), "");
 }
 
+TEST(CameraDefinition, E90SharedDefinitionKeepsSettingsPerCamera)
+{
+    // Both are parsed once and share the definition.
+    CameraDefinition first;
+    ASSERT_TRUE(first.load_file(e90_unit_test_file));
+    CameraDefinition second;
+    ASSERT_TRUE(second.load_file(e90_unit_test_file));
+
+    first.assume_default_settings();
+    second.assume_default_settings();
+
+    MAVLinkParameters::ParamValue value;
+    value.set<uint32_t>(1);
+    EXPECT_TRUE(first.set_setting("CAM_WBMODE", value));
+
+    ASSERT_TRUE(first.get_setting("CAM_WBMODE", value));
+    EXPECT_EQ(value.get<uint32_t>(), 1);
+    ASSERT_TRUE(second.get_setting("CAM_WBMODE", value));
+    EXPECT_EQ(value.get<uint32_t>(), 0);
+
+    // A camera loaded later still starts with unknown settings.
+    CameraDefinition third;
+    ASSERT_TRUE(third.load_file(e90_unit_test_file));
+    EXPECT_FALSE(third.get_setting("CAM_WBMODE", value));
+    EXPECT_STREQ(third.get_model().c_str(), "E90");
+}
+
 static const std::string uvc_unit_test_file = "src/mavsdk/plugins/camera/uvc_unit_test.xml";
 
 TEST(CameraDefinition, UVCLoadInfoFile)
@@ -603,6 +630,30 @@ TEST(CameraDefinition, UVCSetRangeSetting)
     }
 }
 
+TEST(CameraDefinition, UVCPossibleSettingsFollowChanges)
+{
+    // Run this from root.
+    CameraDefinition cd;
+    ASSERT_TRUE(cd.load_file(uvc_unit_test_file));
+
+    cd.assume_default_settings();
+
+    std::unordered_map<std::string, MAVLinkParameters::ParamValue> settings{};
+    EXPECT_TRUE(cd.get_possible_settings(settings));
+    EXPECT_EQ(settings["brightness"].get<int32_t>(), 128);
+    const auto num_settings = settings.size();
+
+    {
+        MAVLinkParameters::ParamValue value;
+        value.set<int32_t>(200);
+        EXPECT_TRUE(cd.set_setting("brightness", value));
+    }
+
+    EXPECT_TRUE(cd.get_possible_settings(settings));
+    EXPECT_EQ(settings.size(), num_settings);
+    EXPECT_EQ(settings["brightness"].get<int32_t>(), 200);
+}
+
 TEST(CameraDefinition, UVCCheckSettingHumanReadable)
 {
     // Run this from root.
@@ -3,10 +3,13 @@
 #include "system.h"
 #include "mavsdk_math.h"
 #include "http_loader.h"
+#include "camera_definition_cache.h"
 #include "camera_definition_files.h"
+#include "camera_manager.h"
 #include "unused.h"
 #include "callback_list.tpp"
 
+#include <algorithm>
 #include <functional>
 #include <cmath>
 #include <sstream>
@@ -37,72 +40,18 @@ CameraImpl::~CameraImpl()
 
 void CameraImpl::init()
 {
-    _system_impl->register_mavlink_message_handler(
-        MAVLINK_MSG_ID_CAMERA_CAPTURE_STATUS,
-        _camera_id + MAV_COMP_ID_CAMERA,
-        [this](const mavlink_message_t& message) { process_camera_capture_status(message); },
-        this);
-
-    _system_impl->register_mavlink_message_handler(
-        MAVLINK_MSG_ID_STORAGE_INFORMATION,
-        _camera_id + MAV_COMP_ID_CAMERA,
-        [this](const mavlink_message_t& message) { process_storage_information(message); },
-        this);
-
-    _system_impl->register_mavlink_message_handler(
-        MAVLINK_MSG_ID_CAMERA_IMAGE_CAPTURED,
-        _camera_id + MAV_COMP_ID_CAMERA,
-        [this](const mavlink_message_t& message) { process_camera_image_captured(message); },
-        this);
-
-    _system_impl->register_mavlink_message_handler(
-        MAVLINK_MSG_ID_CAMERA_SETTINGS,
-        _camera_id + MAV_COMP_ID_CAMERA,
-        [this](const mavlink_message_t& message) { process_camera_settings(message); },
-        this);
-
-    _system_impl->register_mavlink_message_handler(
-        MAVLINK_MSG_ID_CAMERA_INFORMATION,
-        _camera_id + MAV_COMP_ID_CAMERA,
-        [this](const mavlink_message_t& message) { process_camera_information(message); },
-        this);
-
-    _system_impl->register_mavlink_message_handler(
-        MAVLINK_MSG_ID_VIDEO_STREAM_INFORMATION,
-        _camera_id + MAV_COMP_ID_CAMERA,
-        [this](const mavlink_message_t& message) { process_video_information(message); },
-        this);
-
-    _system_impl->register_mavlink_message_handler(
-        MAVLINK_MSG_ID_VIDEO_STREAM_STATUS,
-        _camera_id + MAV_COMP_ID_CAMERA,
-        [this](const mavlink_message_t& message) { process_video_stream_status(message); },
-        this);
-
-    if (_system_impl->has_autopilot()) {
-        _system_impl->register_mavlink_message_handler(
-            MAVLINK_MSG_ID_FLIGHT_INFORMATION,
-            [this](const mavlink_message_t& message) { process_flight_information(message); },
-            this);
-    }
-
-    _system_impl->add_call_every(
-        [this]() { check_connection_status(); }, 0.5, &_check_connection_status_call_every_cookie);
-
-    _system_impl->add_call_every(
-        [this]() { request_missing_capture_info(); }, 0.5, &_request_missing_capture_info_cookie);
+    _camera_manager = CameraManager::instance(_system_impl);
+    _camera_manager->add_camera(*this, static_cast<uint8_t>(_camera_id + MAV_COMP_ID_CAMERA));
 }
 
 void CameraImpl::deinit()
 {
-    _system_impl->remove_call_every(_request_missing_capture_info_cookie);
-    _system_impl->remove_call_every(_check_connection_status_call_every_cookie);
+    _camera_manager->remove_camera(*this);
+    _camera_manager.reset();
+
     _system_impl->remove_call_every(_status.call_every_cookie);
-    _system_impl->remove_call_every(_camera_information_call_every_cookie);
-    _system_impl->remove_call_every(_flight_information_call_every_cookie);
     _system_impl->remove_call_every(_mode.call_every_cookie);
     _system_impl->remove_call_every(_video_stream_info.call_every_cookie);
-    _system_impl->unregister_all_mavlink_message_handlers(this);
     _system_impl->cancel_all_param(this);
 
     {
@@ -207,18 +156,12 @@ void CameraImpl::manual_enable()
     request_status();
     request_camera_information();
 
-    _system_impl->add_call_every(
-        [this]() { request_camera_information(); }, 10.0, &_camera_information_call_every_cookie);
-
     // for backwards compatibility with Yuneec drones
     if (_system_impl->has_autopilot()) {
         request_flight_information();
-
-        _system_impl->add_call_every(
-            [this]() { request_flight_information(); },
-            10.0,
-            &_flight_information_call_every_cookie);
     }
+
+    // The camera manager repeats the requests while the camera is found.
 }
 
 void CameraImpl::disable()
@@ -228,40 +171,63 @@ void CameraImpl::disable()
     // but only the camera.
 }
 
-void CameraImpl::manual_disable()
+std::optional<MemoryUsage::Plugin> CameraImpl::memory_usage()
 {
-    invalidate_params();
-    _system_impl->remove_call_every(_camera_information_call_every_cookie);
-
-    if (_flight_information_call_every_cookie) {
-        _system_impl->remove_call_every(_flight_information_call_every_cookie);
+    MemoryUsage::Plugin usage;
+    usage.name = "camera";
+    {
+        std::lock_guard<std::mutex> lock(_status.mutex);
+        for (const auto& [index, capture_info] : _status.photo_list) {
+            usage.bytes +=
+                sizeof(std::pair<int, Camera::CaptureInfo>) + capture_info.file_url.capacity();
+        }
     }
+    {
+        std::lock_guard<std::mutex> lock(_capture_info.mutex);
+        usage.bytes += _capture_info.missing_image_retries.size() * sizeof(std::pair<int, int>);
+    }
+    return usage;
+}
 
+void CameraImpl::manual_disable()
+{
+    invalidate_params();
     _camera_found = false;
 }
 
 void CameraImpl::update_component()
 {
-    uint8_t cmp_id = _camera_id + MAV_COMP_ID_CAMERA;
-    _system_impl->update_componentid_messages_handler(
-        MAVLINK_MSG_ID_CAMERA_CAPTURE_STATUS, cmp_id, this);
-
-    _system_impl->update_componentid_messages_handler(
-        MAVLINK_MSG_ID_STORAGE_INFORMATION, cmp_id, this);
-
-    _system_impl->update_componentid_messages_handler(
-        MAVLINK_MSG_ID_CAMERA_IMAGE_CAPTURED, cmp_id, this);
-
-    _system_impl->update_componentid_messages_handler(MAVLINK_MSG_ID_CAMERA_SETTINGS, cmp_id, this);
-
-    _system_impl->update_componentid_messages_handler(
-        MAVLINK_MSG_ID_CAMERA_INFORMATION, cmp_id, this);
-
-    _system_impl->update_componentid_messages_handler(
-        MAVLINK_MSG_ID_VIDEO_STREAM_INFORMATION, cmp_id, this);
-
-    _system_impl->update_componentid_messages_handler(
-        MAVLINK_MSG_ID_VIDEO_STREAM_STATUS, cmp_id, this);
+    _camera_manager->change_component_id(
+        *this, static_cast<uint8_t>(_camera_id + MAV_COMP_ID_CAMERA));
+}
+
+void CameraImpl::process_camera_message(const mavlink_message_t& message)
+{
+    switch (message.msgid) {
+        case MAVLINK_MSG_ID_CAMERA_CAPTURE_STATUS:
+            process_camera_capture_status(message);
+            break;
+        case MAVLINK_MSG_ID_STORAGE_INFORMATION:
+            process_storage_information(message);
+            break;
+        case MAVLINK_MSG_ID_CAMERA_IMAGE_CAPTURED:
+            process_camera_image_captured(message);
+            break;
+        case MAVLINK_MSG_ID_CAMERA_SETTINGS:
+            process_camera_settings(message);
+            break;
+        case MAVLINK_MSG_ID_CAMERA_INFORMATION:
+            process_camera_information(message);
+            break;
+        case MAVLINK_MSG_ID_VIDEO_STREAM_INFORMATION:
+            process_video_information(message);
+            break;
+        case MAVLINK_MSG_ID_VIDEO_STREAM_STATUS:
+            process_video_stream_status(message);
+            break;
+        default:
+            break;
+    }
 }
 
 Camera::Result CameraImpl::select_camera(const size_t id)
@@ -388,18 +354,35 @@ MavlinkCommandSender::CommandLong CameraImpl::make_command_request_camera_captur
     return cmd_req_camera_cap_stat;
 }
 
-MavlinkCommandSender::CommandLong
-CameraImpl::make_command_request_camera_image_captured(const size_t photo_id)
+mavlink_message_t CameraImpl::make_request_camera_image_captured_message(const int index)
 {
-    MavlinkCommandSender::CommandLong cmd_req_camera_image_captured{};
-
-    cmd_req_camera_image_captured.command = MAV_CMD_REQUEST_MESSAGE;
-    cmd_req_camera_image_captured.params.maybe_param1 =
-        static_cast<float>(MAVLINK_MSG_ID_CAMERA_IMAGE_CAPTURED);
-    cmd_req_camera_image_captured.params.maybe_param2 = static_cast<float>(photo_id);
-    cmd_req_camera_image_captured.target_component_id = _camera_id + MAV_COMP_ID_CAMERA;
+    mavlink_message_t message;
+    mavlink_msg_command_long_pack(
+        _system_impl->get_own_system_id(),
+        _system_impl->get_own_component_id(),
+        &message,
+        _system_impl->get_system_id(),
+        static_cast<uint8_t>(_camera_id + MAV_COMP_ID_CAMERA),
+        MAV_CMD_REQUEST_MESSAGE,
+        0,
+        static_cast<float>(MAVLINK_MSG_ID_CAMERA_IMAGE_CAPTURED),
+        static_cast<float>(index),
+        0.0f,
+        0.0f,
+        0.0f,
+        0.0f,
+        0.0f);
+    return message;
+}
 
-    return cmd_req_camera_image_captured;
+void CameraImpl::request_camera_images_captured(const std::vector<int>& indices)
+{
+    std::vector<mavlink_message_t> messages;
+    messages.reserve(indices.size());
+    for (const auto index : indices) {
+        messages.push_back(make_request_camera_image_captured_message(index));
+    }
+    _system_impl->send_messages(messages);
 }
 
 MavlinkCommandSender::CommandLong CameraImpl::make_command_request_storage_info()
@@ -1032,7 +1015,10 @@ void CameraImpl::process_camera_image_captured(const mavlink_message_t& message)
         capture_info.is_success = (image_captured.capture_result == 1);
         capture_info.index = image_captured.image_index;
 
-        _status.photo_list.insert(std::make_pair(image_captured.image_index, capture_info));
+        {
+            std::lock_guard<std::mutex> status_lock(_status.mutex);
+            _status.photo_list.insert(std::make_pair(image_captured.image_index, capture_info));
+        }
 
         _captured_request_cv.notify_all();
 
@@ -1069,25 +1055,39 @@ void CameraImpl::process_camera_image_captured(const mavlink_message_t& message)
 
 void CameraImpl::request_missing_capture_info()
 {
-    std::lock_guard<std::mutex> lock(_capture_info.mutex);
+    std::vector<int> indices;
+    {
+        std::lock_guard<std::mutex> lock(_capture_info.mutex);
 
-    for (auto it = _capture_info.missing_image_retries.begin();
-         it != _capture_info.missing_image_retries.end();
-         /* ++it */) {
-        if (it->second > 3) {
-            it = _capture_info.missing_image_retries.erase(it);
-        } else {
-            ++it;
+        std::vector<std::map<int, int>::iterator> candidates;
+        for (auto it = _capture_info.missing_image_retries.begin();
+             it != _capture_info.missing_image_retries.end();
+             /* ++it */) {
+            if (it->second > max_missing_capture_info_retries) {
+                it = _capture_info.missing_image_retries.erase(it);
+            } else {
+                candidates.push_back(it);
+                ++it;
+            }
+        }
+
+        // The ones asked for least often first, otherwise in order.
+        std::stable_sort(
+            candidates.begin(), candidates.end(), [](const auto& lhs, const auto& rhs) {
+                return lhs->second < rhs->second;
+            });
+        if (candidates.size() > missing_capture_info_window) {
+            candidates.resize(missing_capture_info_window);
+        }
+
+        for (auto& it : candidates) {
+            indices.push_back(it->first);
+            it->second += 1;
         }
     }
 
-    if (!_capture_info.missing_image_retries.empty()) {
-        auto it_lowest_retries = std::min_element(
-            _capture_info.missing_image_retries.begin(), _capture_info.missing_image_retries.end());
-        _system_impl->send_command_async(
-            CameraImpl::make_command_request_camera_image_captured(it_lowest_retries->first),
-            nullptr);
-        it_lowest_retries->second += 1;
+    if (!indices.empty()) {
+        request_camera_images_captured(indices);
     }
 }
 
@@ -1202,8 +1202,10 @@ bool CameraImpl::should_fetch_camera_definition(const std::string& uri) const
 bool CameraImpl::fetch_camera_definition(
     const mavlink_camera_information_t& camera_information, std::string& camera_definition_out)
 {
-    auto download_succeeded =
-        download_definition_file(camera_information.cam_definition_uri, camera_definition_out);
+    auto download_succeeded = download_definition_file(
+        camera_information.cam_definition_uri,
+        camera_information.cam_definition_version,
+        camera_definition_out);
 
     if (download_succeeded) {
         return true;
@@ -1213,16 +1215,39 @@ bool CameraImpl::fetch_camera_definition(
 }
 
 bool CameraImpl::download_definition_file(
-    const std::string& uri, std::string& camera_definition_out)
+    const std::string& uri, uint32_t version, std::string& camera_definition_out)
 {
+    auto& cache = CameraDefinitionCache::instance();
+    auto maybe_cached = cache.get(uri);
+
+    // A camera is supposed to bump the version whenever the file changes.
+    if (maybe_cached && version != 0 && maybe_cached->version == version) {
+        LogInfo() << "Using cached camera definition for: " << uri;
+        camera_definition_out = std::move(maybe_cached->content);
+        return true;
+    }
+
+    auto entry = maybe_cached.value_or(CameraDefinitionCache::Entry{});
     HttpLoader http_loader;
     LogInfo() << "Downloading camera definition from: " << uri;
-    if (!http_loader.download_text_sync(uri, camera_definition_out)) {
-        LogErr() << "Failed to download camera definition.";
-        return false;
-    }
+    switch (http_loader.download_text_if_modified_sync(uri, entry.validators, entry.content)) {
+        case ConditionalDownloadResult::Downloaded:
+        case ConditionalDownloadResult::NotModified:
+            entry.version = version;
+            cache.put(uri, entry);
+            camera_definition_out = std::move(entry.content);
+            return true;
 
-    return true;
+        case ConditionalDownloadResult::Failed:
+        default:
+            if (maybe_cached) {
+                LogWarn() << "Failed to download camera definition, using cached one.";
+                camera_definition_out = std::move(entry.content);
+                return true;
+            }
+            LogErr() << "Failed to download camera definition.";
+            return false;
+    }
 }
 
 bool CameraImpl::load_stored_definition(
@@ -1791,12 +1816,13 @@ void CameraImpl::notify_current_settings()
                     setting.option.option_id,
                     setting.option.option_description);
             }
-            current_settings.push_back(setting);
+            current_settings.push_back(std::move(setting));
         }
     }
 
     _subscribe_current_settings.callbacks.queue(
-        current_settings, [this](const auto& func) { _system_impl->call_user_callback(func); });
+        std::move(current_settings),
+        [this](const auto& func) { _system_impl->call_user_callback(func); });
 }
 
 void CameraImpl::notify_possible_setting_options()
@@ -1818,7 +1844,8 @@ void CameraImpl::notify_possible_setting_options()
     }
 
     _subscribe_possible_setting_options.callbacks.queue(
-        setting_options, [this](const auto& func) { _system_impl->call_user_callback(func); });
+        std::move(setting_options),
+        [this](const auto& func) { _system_impl->call_user_callback(func); });
 }
 
 std::vector<Camera::SettingOptions> CameraImpl::possible_setting_options()
@@ -1860,38 +1887,27 @@ void CameraImpl::refresh_params()
         return;
     }
 
-    unsigned count = 0;
-    for (const auto& param : params) {
-        const std::string& param_name = param.first;
-        const MAVLinkParameters::ParamValue& param_value_type = param.second;
-        const bool is_last = (count == params.size() - 1);
-        _system_impl->get_param_async(
-            param_name,
-            param_value_type,
-            [param_name, is_last, this](
-                MAVLinkParameters::Result result, MAVLinkParameters::ParamValue value) {
-                if (result != MAVLinkParameters::Result::Success) {
-                    return;
-                }
-                // We need to check again by the time this callback runs
-                if (!this->_camera_definition) {
-                    return;
-                }
+    // All settings are requested at once, with a few requests in flight.
+    _system_impl->get_params_async(
+        params,
+        [params, this](const auto& results) {
+            // We need to check again by the time this callback runs
+            if (!this->_camera_definition) {
+                return;
+            }
 
-                if (!this->_camera_definition->set_setting(param_name, value)) {
-                    return;
+            for (size_t i = 0; i < results.size(); ++i) {
+                if (results[i].first != MAVLinkParameters::Result::Success) {
+                    continue;
                 }
+                this->_camera_definition->set_setting(params[i].first, results[i].second);
+            }
 
-                if (is_last) {
-                    notify_current_settings();
-                    notify_possible_setting_options();
-                }
-            },
-            this,
-            static_cast<uint8_t>(_camera_id + MAV_COMP_ID_CAMERA),
-            true);
-        ++count;
-    }
+            notify_current_settings();
+            notify_possible_setting_options();
+        },
+        static_cast<uint8_t>(_camera_id + MAV_COMP_ID_CAMERA),
+        true);
 }
 
 void CameraImpl::invalidate_params()
@@ -2047,47 +2063,47 @@ void CameraImpl::list_photos_async(
     std::thread([this, start_index, callback]() {
         std::unique_lock<std::mutex> capture_request_lock(_captured_request_mutex);
 
-        for (int i = start_index; i < _status.image_count; i++) {
-            // In case the vehicle sends capture info, but not those we are asking, we do not
-            // want to loop infinitely. The safety_count is here to abort if this happens.
-            auto safety_count = 0;
-            const auto safety_count_boundary = 10;
-
-            while (_status.photo_list.find(i) == _status.photo_list.end() &&
-                   safety_count < safety_count_boundary) {
-                safety_count++;
-
-                auto request_try_number = 0;
-                const auto request_try_limit =
-                    10; // Timeout if the request times out that many times
-                auto cv_status = std::cv_status::timeout;
-
-                while (cv_status == std::cv_status::timeout) {
-                    request_try_number++;
-                    if (request_try_number >= request_try_limit) {
-                        std::lock_guard<std::mutex> status_lock(_status.mutex);
-                        _status.is_fetching_photos = false;
-                        _system_impl->call_user_callback([callback]() {
-                            callback(Camera::Result::Timeout, std::vector<Camera::CaptureInfo>{});
-                        });
-                        return;
-                    }
-
-                    _system_impl->send_command_async(
-                        make_command_request_camera_image_captured(i), nullptr);
-                    cv_status = _captured_request_cv.wait_for(
-                        capture_request_lock, std::chrono::seconds(1));
+        const auto missing_indices = [this, start_index]() {
+            std::lock_guard<std::mutex> status_lock(_status.mutex);
+            std::vector<int> indices;
+            for (int i = start_index;
+                 i < _status.image_count && indices.size() < missing_capture_info_window;
+                 ++i) {
+                if (_status.photo_list.find(i) == _status.photo_list.end()) {
+                    indices.push_back(i);
                 }
             }
+            return indices;
+        };
+
+        // Timeout if nothing we asked for arrives that many times.
+        const auto request_try_limit = 10;
+        auto request_try_number = 0;
 
-            if (safety_count == safety_count_boundary) {
+        for (auto indices = missing_indices(); !indices.empty();) {
+            if (request_try_number >= request_try_limit) {
                 std::lock_guard<std::mutex> status_lock(_status.mutex);
                 _status.is_fetching_photos = false;
                 _system_impl->call_user_callback([callback]() {
-                    callback(Camera::Result::Error, std::vector<Camera::CaptureInfo>{});
+                    callback(Camera::Result::Timeout, std::vector<Camera::CaptureInfo>{});
                 });
                 return;
             }
+
+            request_camera_images_captured(indices);
+
+            // Until the whole window has arrived, or for a second.
+            _captured_request_cv.wait_for(capture_request_lock, std::chrono::seconds(1), [&]() {
+                std::lock_guard<std::mutex> status_lock(_status.mutex);
+                return std::all_of(indices.begin(), indices.end(), [this](int index) {
+                    return _status.photo_list.count(index) != 0;
+                });
+            });
+
+            // Only a try without any progress counts.
+            auto still_missing = missing_indices();
+            request_try_number = (still_missing == indices) ? request_try_number + 1 : 0;
+            indices = std::move(still_missing);
         }
 
         std::vector<Camera::CaptureInfo> photo_list;
@@ -11,6 +11,8 @@
 
 namespace mavsdk {
 
+class CameraManager;
+
 class CameraImpl : public PluginImplBase {
 public:
     explicit CameraImpl(System& system);
@@ -23,6 +25,8 @@ public:
     void enable() override;
     void disable() override;
 
+    std::optional<MemoryUsage::Plugin> memory_usage() override;
+
     Camera::Result prepare();
     Camera::Result select_camera(size_t id);
 
@@ -98,6 +102,9 @@ public:
     CameraImpl& operator=(const CameraImpl&) = delete;
 
 private:
+    // Dispatches the messages and runs the periodic checks and requests.
+    friend class CameraManager;
+
     bool get_possible_setting_options(std::vector<std::string>& settings);
     bool get_possible_options(const std::string& setting_id, std::vector<Camera::Option>& options);
 
@@ -119,6 +126,7 @@ private:
     void manual_enable();
     void manual_disable();
     void update_component();
+    void process_camera_message(const mavlink_message_t& message);
 
     void receive_set_mode_command_result(
         const MavlinkCommandSender::Result command_result,
@@ -157,7 +165,8 @@ private:
     bool should_fetch_camera_definition(const std::string& uri) const;
     bool fetch_camera_definition(
         const mavlink_camera_information_t& camera_information, std::string& camera_definition_out);
-    bool download_definition_file(const std::string& uri, std::string& camera_definition_out);
+    bool download_definition_file(
+        const std::string& uri, uint32_t version, std::string& camera_definition_out);
     bool
     load_stored_definition(const mavlink_camera_information_t&, std::string& camera_definition_out);
 
@@ -168,11 +177,6 @@ private:
     float to_mavlink_camera_mode(const Camera::Mode mode) const;
     Camera::Mode to_camera_mode(const uint8_t mavlink_camera_mode) const;
 
-    void* _camera_information_call_every_cookie{nullptr};
-    void* _flight_information_call_every_cookie{nullptr};
-    void* _check_connection_status_call_every_cookie{nullptr};
-    void* _request_missing_capture_info_cookie{nullptr};
-
     void request_camera_settings();
     void request_camera_information();
     void request_video_stream_info();
@@ -188,7 +192,9 @@ private:
     MavlinkCommandSender::CommandLong make_command_set_camera_mode(float mavlink_mode);
     MavlinkCommandSender::CommandLong make_command_request_camera_settings();
     MavlinkCommandSender::CommandLong make_command_request_camera_capture_status();
-    MavlinkCommandSender::CommandLong make_command_request_camera_image_captured(size_t photo_id);
+    // Sent without waiting for an ack, the message asked for is the answer.
+    mavlink_message_t make_request_camera_image_captured_message(int index);
+    void request_camera_images_captured(const std::vector<int>& indices);
     MavlinkCommandSender::CommandLong make_command_request_storage_info();
 
     MavlinkCommandSender::CommandLong make_command_start_video(float capture_status_rate_hz);
@@ -209,6 +215,8 @@ private:
     using CameraDefinitionCallback = std::function<void(bool)>;
     CameraDefinitionCallback _camera_definition_callback{};
 
+    std::shared_ptr<CameraManager> _camera_manager{};
+
     std::atomic<size_t> _camera_id{0};
     std::atomic<bool> _camera_found{false};
 
@@ -247,6 +255,11 @@ private:
         std::map<int, int> missing_image_retries{};
     } _capture_info{};
 
+    // Missing captures are asked for this many at a time, rather than one by
+    // one, as it is the round trip that takes time.
+    static constexpr size_t missing_capture_info_window = 16;
+    static constexpr int max_missing_capture_info_retries = 3;
+
     struct {
         std::mutex mutex{};
         Camera::VideoStreamInfo data{};
@@ -0,0 +1,140 @@
+#include "camera_manager.h"
+#include "camera_impl.h"
+#include "system_impl.h"
+
+#include <map>
+
+namespace mavsdk {
+
+CameraManager::CameraManager(std::shared_ptr<SystemImpl> system_impl) :
+    _system_impl(std::move(system_impl))
+{
+    for (const auto msg_id :
+         {MAVLINK_MSG_ID_CAMERA_CAPTURE_STATUS,
+          MAVLINK_MSG_ID_STORAGE_INFORMATION,
+          MAVLINK_MSG_ID_CAMERA_IMAGE_CAPTURED,
+          MAVLINK_MSG_ID_CAMERA_SETTINGS,
+          MAVLINK_MSG_ID_CAMERA_INFORMATION,
+          MAVLINK_MSG_ID_VIDEO_STREAM_INFORMATION,
+          MAVLINK_MSG_ID_VIDEO_STREAM_STATUS}) {
+        _system_impl->register_mavlink_message_handler(
+            static_cast<uint16_t>(msg_id),
+            [this](const mavlink_message_t& message) { process_camera_message(message); },
+            this);
+    }
+
+    if (_system_impl->has_autopilot()) {
+        _system_impl->register_mavlink_message_handler(
+            MAVLINK_MSG_ID_FLIGHT_INFORMATION,
+            [this](const mavlink_message_t& message) { process_flight_information(message); },
+            this);
+    }
+
+    _system_impl->add_call_every(
+        [this]() { check_cameras(); }, 0.5, &_check_cameras_call_every_cookie);
+
+    _system_impl->add_call_every(
+        [this]() { request_information(); }, 10.0, &_request_information_call_every_cookie);
+}
+
+CameraManager::~CameraManager()
+{
+    _system_impl->remove_call_every(_request_information_call_every_cookie);
+    _system_impl->remove_call_every(_check_cameras_call_every_cookie);
+    _system_impl->unregister_all_mavlink_message_handlers(this);
+}
+
+std::shared_ptr<CameraManager>
+CameraManager::instance(const std::shared_ptr<SystemImpl>& system_impl)
+{
+    static std::mutex mutex;
+    static std::map<const SystemImpl*, std::weak_ptr<CameraManager>> instances;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = instances.find(system_impl.get());
+    if (it != instances.end()) {
+        if (auto existing = it->second.lock()) {
+            return existing;
+        }
+    }
+
+    auto manager = std::make_shared<CameraManager>(system_impl);
+    instances[system_impl.get()] = manager;
+    return manager;
+}
+
+void CameraManager::add_camera(CameraImpl& camera, uint8_t component_id)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _cameras.emplace(component_id, &camera);
+}
+
+void CameraManager::change_component_id(CameraImpl& camera, uint8_t component_id)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    for (auto it = _cameras.begin(); it != _cameras.end(); ++it) {
+        if (it->second == &camera) {
+            _cameras.erase(it);
+            break;
+        }
+    }
+    _cameras.emplace(component_id, &camera);
+}
+
+void CameraManager::remove_camera(CameraImpl& camera)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    for (auto it = _cameras.begin(); it != _cameras.end(); ++it) {
+        if (it->second == &camera) {
+            _cameras.erase(it);
+            return;
+        }
+    }
+}
+
+void CameraManager::process_camera_message(const mavlink_message_t& message)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    const auto range = _cameras.equal_range(message.compid);
+    for (auto it = range.first; it != range.second; ++it) {
+        it->second->process_camera_message(message);
+    }
+}
+
+void CameraManager::process_flight_information(const mavlink_message_t& message)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    for (auto& camera : _cameras) {
+        camera.second->process_flight_information(message);
+    }
+}
+
+void CameraManager::check_cameras()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    for (auto& camera : _cameras) {
+        camera.second->check_connection_status();
+        camera.second->request_missing_capture_info();
+    }
+}
+
+void CameraManager::request_information()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    CameraImpl* connected_camera = nullptr;
+    for (auto& camera : _cameras) {
+        if (camera.second->_camera_found) {
+            camera.second->request_camera_information();
+            connected_camera = camera.second;
+        }
+    }
+
+    // The flight information comes from the autopilot, one request is
+    // enough for all cameras. For backwards compatibility with Yuneec drones.
+    if (connected_camera != nullptr && _system_impl->has_autopilot()) {
+        connected_camera->request_flight_information();
+    }
+}
+
+} // namespace mavsdk
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "mavlink_include.h"
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace mavsdk {
+
+class CameraImpl;
+class SystemImpl;
+
+// Shared by all cameras of a system, so that the camera messages are handled
+// once and dispatched by component id, and the periodic requests run from a
+// couple of timers instead of a set of timers per camera.
+//
+// Dispatching happens with the lock held, so once remove_camera returns, the
+// camera is no longer called.
+class CameraManager {
+public:
+    explicit CameraManager(std::shared_ptr<SystemImpl> system_impl);
+    ~CameraManager();
+
+    static std::shared_ptr<CameraManager> instance(const std::shared_ptr<SystemImpl>& system_impl);
+
+    void add_camera(CameraImpl& camera, uint8_t component_id);
+    void change_component_id(CameraImpl& camera, uint8_t component_id);
+    void remove_camera(CameraImpl& camera);
+
+    // Non-copyable
+    CameraManager(const CameraManager&) = delete;
+    const CameraManager& operator=(const CameraManager&) = delete;
+
+private:
+    void process_camera_message(const mavlink_message_t& message);
+    void process_flight_information(const mavlink_message_t& message);
+    void check_cameras();
+    void request_information();
+
+    std::shared_ptr<SystemImpl> _system_impl;
+
+    std::mutex _mutex{};
+    std::unordered_multimap<uint8_t, CameraImpl*> _cameras{};
+
+    void* _check_cameras_call_every_cookie{nullptr};
+    void* _request_information_call_every_cookie{nullptr};
+};
+
+} // namespace mavsdk
@@ -15,6 +15,7 @@
 
 #include "plugin_base.h"
 
+#include "awaitable.h"
 #include "handle.h"
 
 namespace mavsdk {
@@ -501,7 +502,24 @@ public:
      *
      * This function is non-blocking. See 'prepare' for the blocking counterpart.
      */
-    void prepare_async(const ResultCallback callback);
+    void prepare_async(const ResultCallback& callback);
+
+#ifdef MAVSDK_HAS_COROUTINES
+    /**
+     * @brief Awaitable version of 'prepare_async' for C++20 coroutines.
+     *
+     * The coroutine is resumed using the executor if one is given, otherwise on the callback
+     * thread.
+     */
+    Awaitable<ResultCallback> prepare_awaitable(Executor executor = {})
+    {
+        return Awaitable<ResultCallback>(
+            [=, this](const ResultCallback& callback) {
+                prepare_async(callback);
+            },
+            std::move(executor));
+    }
+#endif
 
     /**
      * @brief Prepare the camera plugin (e.g. download the camera definition, etc).
@@ -517,7 +535,24 @@ public:
      *
      * This function is non-blocking. See 'take_photo' for the blocking counterpart.
      */
-    void take_photo_async(const ResultCallback callback);
+    void take_photo_async(const ResultCallback& callback);
+
+#ifdef MAVSDK_HAS_COROUTINES
+    /**
+     * @brief Awaitable version of 'take_photo_async' for C++20 coroutines.
+     *
+     * The coroutine is resumed using the executor if one is given, otherwise on the callback
+     * thread.
+     */
+    Awaitable<ResultCallback> take_photo_awaitable(Executor executor = {})
+    {
+        return Awaitable<ResultCallback>(
+            [=, this](const ResultCallback& callback) {
+                take_photo_async(callback);
+            },
+            std::move(executor));
+    }
+#endif
 
     /**
      * @brief Take one photo.
@@ -533,7 +568,25 @@ public:
      *
      * This function is non-blocking. See 'start_photo_interval' for the blocking counterpart.
      */
-    void start_photo_interval_async(float interval_s, const ResultCallback callback);
+    void start_photo_interval_async(float interval_s, const ResultCallback& callback);
+
+#ifdef MAVSDK_HAS_COROUTINES
+    /**
+     * @brief Awaitable version of 'start_photo_interval_async' for C++20 coroutines.
+     *
+     * The coroutine is resumed using the executor if one is given, otherwise on the callback
+     * thread.
+     */
+    Awaitable<ResultCallback> start_photo_interval_awaitable(
+        float interval_s, Executor executor = {})
+    {
+        return Awaitable<ResultCallback>(
+            [=, this](const ResultCallback& callback) {
+                start_photo_interval_async(interval_s, callback);
+            },
+            std::move(executor));
+    }
+#endif
 
     /**
      * @brief Start photo timelapse with a given interval.
@@ -549,7 +602,24 @@ public:
      *
      * This function is non-blocking. See 'stop_photo_interval' for the blocking counterpart.
      */
-    void stop_photo_interval_async(const ResultCallback callback);
+    void stop_photo_interval_async(const ResultCallback& callback);
+
+#ifdef MAVSDK_HAS_COROUTINES
+    /**
+     * @brief Awaitable version of 'stop_photo_interval_async' for C++20 coroutines.
+     *
+     * The coroutine is resumed using the executor if one is given, otherwise on the callback
+     * thread.
+     */
+    Awaitable<ResultCallback> stop_photo_interval_awaitable(Executor executor = {})
+    {
+        return Awaitable<ResultCallback>(
+            [=, this](const ResultCallback& callback) {
+                stop_photo_interval_async(callback);
+            },
+            std::move(executor));
+    }
+#endif
 
     /**
      * @brief Stop a running photo timelapse.
@@ -565,7 +635,24 @@ public:
      *
      * This function is non-blocking. See 'start_video' for the blocking counterpart.
      */
-    void start_video_async(const ResultCallback callback);
+    void start_video_async(const ResultCallback& callback);
+
+#ifdef MAVSDK_HAS_COROUTINES
+    /**
+     * @brief Awaitable version of 'start_video_async' for C++20 coroutines.
+     *
+     * The coroutine is resumed using the executor if one is given, otherwise on the callback
+     * thread.
+     */
+    Awaitable<ResultCallback> start_video_awaitable(Executor executor = {})
+    {
+        return Awaitable<ResultCallback>(
+            [=, this](const ResultCallback& callback) {
+                start_video_async(callback);
+            },
+            std::move(executor));
+    }
+#endif
 
     /**
      * @brief Start a video recording.
@@ -581,7 +668,24 @@ public:
      *
      * This function is non-blocking. See 'stop_video' for the blocking counterpart.
      */
-    void stop_video_async(const ResultCallback callback);
+    void stop_video_async(const ResultCallback& callback);
+
+#ifdef MAVSDK_HAS_COROUTINES
+    /**
+     * @brief Awaitable version of 'stop_video_async' for C++20 coroutines.
+     *
+     * The coroutine is resumed using the executor if one is given, otherwise on the callback
+     * thread.
+     */
+    Awaitable<ResultCallback> stop_video_awaitable(Executor executor = {})
+    {
+        return Awaitable<ResultCallback>(
+            [=, this](const ResultCallback& callback) {
+                stop_video_async(callback);
+            },
+            std::move(executor));
+    }
+#endif
 
     /**
      * @brief Stop a running video recording.
@@ -615,7 +719,24 @@ public:
      *
      * This function is non-blocking. See 'set_mode' for the blocking counterpart.
      */
-    void set_mode_async(Mode mode, const ResultCallback callback);
+    void set_mode_async(Mode mode, const ResultCallback& callback);
+
+#ifdef MAVSDK_HAS_COROUTINES
+    /**
+     * @brief Awaitable version of 'set_mode_async' for C++20 coroutines.
+     *
+     * The coroutine is resumed using the executor if one is given, otherwise on the callback
+     * thread.
+     */
+    Awaitable<ResultCallback> set_mode_awaitable(Mode mode, Executor executor = {})
+    {
+        return Awaitable<ResultCallback>(
+            [=, this](const ResultCallback& callback) {
+                set_mode_async(mode, callback);
+            },
+            std::move(executor));
+    }
+#endif
 
     /**
      * @brief Set camera mode.
@@ -636,7 +757,25 @@ public:
      *
      * This function is non-blocking. See 'list_photos' for the blocking counterpart.
      */
-    void list_photos_async(PhotosRange photos_range, const ListPhotosCallback callback);
+    void list_photos_async(PhotosRange photos_range, const ListPhotosCallback& callback);
+
+#ifdef MAVSDK_HAS_COROUTINES
+    /**
+     * @brief Awaitable version of 'list_photos_async' for C++20 coroutines.
+     *
+     * The coroutine is resumed using the executor if one is given, otherwise on the callback
+     * thread.
+     */
+    Awaitable<ListPhotosCallback> list_photos_awaitable(
+        PhotosRange photos_range, Executor executor = {})
+    {
+        return Awaitable<ListPhotosCallback>(
+            [=, this](const ListPhotosCallback& callback) {
+                list_photos_async(photos_range, callback);
+            },
+            std::move(executor));
+    }
+#endif
 
     /**
      * @brief List photos available on the camera.
@@ -830,7 +969,24 @@ public:
      *
      * This function is non-blocking. See 'set_setting' for the blocking counterpart.
      */
-    void set_setting_async(Setting setting, const ResultCallback callback);
+    void set_setting_async(const Setting& setting, const ResultCallback& callback);
+
+#ifdef MAVSDK_HAS_COROUTINES
+    /**
+     * @brief Awaitable version of 'set_setting_async' for C++20 coroutines.
+     *
+     * The coroutine is resumed using the executor if one is given, otherwise on the callback
+     * thread.
+     */
+    Awaitable<ResultCallback> set_setting_awaitable(const Setting& setting, Executor executor = {})
+    {
+        return Awaitable<ResultCallback>(
+            [=, this](const ResultCallback& callback) {
+                set_setting_async(setting, callback);
+            },
+            std::move(executor));
+    }
+#endif
 
     /**
      * @brief Set a setting to some value.
@@ -841,7 +997,7 @@ public:
      *
      * @return Result of request.
      */
-    Result set_setting(Setting setting) const;
+    Result set_setting(const Setting& setting) const;
 
     /**
      * @brief Callback type for get_setting_async.
@@ -855,7 +1011,25 @@ public:
      *
      * This function is non-blocking. See 'get_setting' for the blocking counterpart.
      */
-    void get_setting_async(Setting setting, const GetSettingCallback callback);
+    void get_setting_async(const Setting& setting, const GetSettingCallback& callback);
+
+#ifdef MAVSDK_HAS_COROUTINES
+    /**
+     * @brief Awaitable version of 'get_setting_async' for C++20 coroutines.
+     *
+     * The coroutine is resumed using the executor if one is given, otherwise on the callback
+     * thread.
+     */
+    Awaitable<GetSettingCallback> get_setting_awaitable(
+        const Setting& setting, Executor executor = {})
+    {
+        return Awaitable<GetSettingCallback>(
+            [=, this](const GetSettingCallback& callback) {
+                get_setting_async(setting, callback);
+            },
+            std::move(executor));
+    }
+#endif
 
     /**
      * @brief Get a setting.
@@ -866,7 +1040,7 @@ public:
      *
      * @return Result of request.
      */
-    std::pair<Result, Camera::Setting> get_setting(Setting setting) const;
+    std::pair<Result, Camera::Setting> get_setting(const Setting& setting) const;
 
     /**
      * @brief Format storage (e.g. SD card) in camera.
@@ -875,7 +1049,24 @@ public:
      *
      * This function is non-blocking. See 'format_storage' for the blocking counterpart.
      */
-    void format_storage_async(const ResultCallback callback);
+    void format_storage_async(const ResultCallback& callback);
+
+#ifdef MAVSDK_HAS_COROUTINES
+    /**
+     * @brief Awaitable version of 'format_storage_async' for C++20 coroutines.
+     *
+     * The coroutine is resumed using the executor if one is given, otherwise on the callback
+     * thread.
+     */
+    Awaitable<ResultCallback> format_storage_awaitable(Executor executor = {})
+    {
+        return Awaitable<ResultCallback>(
+            [=, this](const ResultCallback& callback) {
+                format_storage_async(callback);
+            },
+            std::move(executor));
+    }
+#endif
 
     /**
      * @brief Format storage (e.g. SD card) in camera.
@@ -912,6 +1103,9 @@ public:
 private:
     /** @private Underlying implementation, set at instantiation */
     std::unique_ptr<CameraImpl> _impl;
+
+    /** @private Hand-written additions in camera_ext.h, if any */
+    friend class CameraExt;
 };
 
 } // namespace mavsdk
\ No newline at end of file
@@ -22,7 +22,7 @@ CameraServer::CameraServer(std::shared_ptr<ServerComponent> server_component) :
 
 CameraServer::~CameraServer() {}
 
-CameraServer::Result CameraServer::set_information(Information information) const
+CameraServer::Result CameraServer::set_information(const Information& information) const
 {
     return _impl->set_information(information);
 }
@@ -43,7 +43,7 @@ void CameraServer::unsubscribe_take_photo(TakePhotoHandle handle)
 }
 
 CameraServer::Result CameraServer::respond_take_photo(
-    TakePhotoFeedback take_photo_feedback, CaptureInfo capture_info) const
+    TakePhotoFeedback take_photo_feedback, const CaptureInfo& capture_info) const
 {
     return _impl->respond_take_photo(take_photo_feedback, capture_info);
 }
@@ -1,6 +1,8 @@
 #include "camera_server_impl.h"
 #include "callback_list.tpp"
 
+#include <cmath>
+#include <iterator>
 #include <thread> // FIXME: remove me
 
 namespace mavsdk {
@@ -98,6 +100,12 @@ void CameraServerImpl::init()
             return process_camera_image_capture_request(command);
         },
         this);
+    _server_component_impl->mavlink_request_message_handler().register_handler(
+        MAVLINK_MSG_ID_CAMERA_IMAGE_CAPTURED,
+        [this](uint8_t, uint8_t, const MavlinkRequestMessageHandler::Params& params) {
+            return process_image_captured_request(static_cast<int32_t>(std::round(params[0])));
+        },
+        this);
     _server_component_impl->register_mavlink_command_handler(
         MAV_CMD_VIDEO_START_CAPTURE,
         [this](const MavlinkCommandReceiver::CommandLong& command) {
@@ -140,6 +148,7 @@ void CameraServerImpl::deinit()
 {
     stop_image_capture_interval();
     _server_component_impl->unregister_all_mavlink_command_handlers(this);
+    _server_component_impl->mavlink_request_message_handler().unregister_all_handlers(this);
 }
 
 bool CameraServerImpl::parse_version_string(const std::string& version_str)
@@ -249,9 +258,31 @@ CameraServer::Result CameraServerImpl::respond_take_photo(
         }
     }
 
-    // REVISIT: Should we cache all CaptureInfo in memory for single image
-    // captures so that we can respond to requests for lost CAMERA_IMAGE_CAPTURED
-    // messages without calling back to user code?
+    CapturedImage captured_image;
+    captured_image.capture_info = capture_info;
+    captured_image.time_boot_ms =
+        static_cast<uint32_t>(_server_component_impl->get_time().elapsed_s() * 1e3);
+
+    if (capture_info.index != INT32_MIN) {
+        std::lock_guard<std::mutex> lock(_capture_history_mutex);
+        _capture_history[capture_info.index] = captured_image;
+        while (_capture_history.size() > max_capture_history) {
+            _capture_history.erase(_capture_history.begin());
+        }
+    }
+
+    // TODO: this should be a broadcast message
+    auto msg = make_image_captured_message(captured_image);
+    _server_component_impl->send_message(msg);
+    LogDebug() << "sent camera image captured msg - index: " << +capture_info.index;
+
+    return CameraServer::Result::Success;
+}
+
+mavlink_message_t
+CameraServerImpl::make_image_captured_message(const CapturedImage& captured_image)
+{
+    const auto& capture_info = captured_image.capture_info;
 
     static const uint8_t camera_id = 0; // deprecated unused field
 
@@ -263,14 +294,15 @@ CameraServer::Result CameraServerImpl::respond_take_photo(
     };
 
     // There needs to be enough data to be copied mavlink internal.
-    capture_info.file_url.resize(205);
+    std::string file_url = capture_info.file_url;
+    file_url.resize(205);
 
     mavlink_message_t msg{};
     mavlink_msg_camera_image_captured_pack(
         _server_component_impl->get_own_system_id(),
         _server_component_impl->get_own_component_id(),
         &msg,
-        static_cast<uint32_t>(_server_component_impl->get_time().elapsed_s() * 1e3),
+        captured_image.time_boot_ms,
         capture_info.time_utc_us,
         camera_id,
         static_cast<int32_t>(capture_info.position.latitude_deg * 1e7),
@@ -280,13 +312,30 @@ CameraServer::Result CameraServerImpl::respond_take_photo(
         attitude_quaternion,
         capture_info.index,
         capture_info.is_success,
-        capture_info.file_url.c_str());
+        file_url.c_str());
+    return msg;
+}
 
-    // TODO: this should be a broadcast message
-    _server_component_impl->send_message(msg);
-    LogDebug() << "sent camera image captured msg - index: " << +capture_info.index;
+MAV_RESULT CameraServerImpl::process_image_captured_request(int32_t index)
+{
+    mavlink_message_t msg;
+    {
+        std::lock_guard<std::mutex> lock(_capture_history_mutex);
 
-    return CameraServer::Result::Success;
+        // -1 asks for the latest one.
+        const auto it = index == -1 ?
+                            (_capture_history.empty() ? _capture_history.end() :
+                                                        std::prev(_capture_history.end())) :
+                            _capture_history.find(index);
+        if (it == _capture_history.end()) {
+            LogDebug() << "requested image index " << index << " not captured";
+            return MAV_RESULT_FAILED;
+        }
+        msg = make_image_captured_message(it->second);
+    }
+
+    _server_component_impl->send_message(msg);
+    return MAV_RESULT_ACCEPTED;
 }
 
 /**
@@ -706,14 +755,11 @@ CameraServerImpl::process_image_stop_capture(const MavlinkCommandReceiver::Comma
 std::optional<mavlink_message_t> CameraServerImpl::process_camera_image_capture_request(
     const MavlinkCommandReceiver::CommandLong& command)
 {
-    auto seq_number = static_cast<uint32_t>(command.params.param1);
-
-    UNUSED(seq_number);
-
-    LogDebug() << "unsupported image capture request";
+    // The deprecated form of requesting CAMERA_IMAGE_CAPTURED.
+    const auto index = static_cast<int32_t>(std::round(command.params.param1));
 
     return _server_component_impl->make_command_ack_message(
-        command, MAV_RESULT::MAV_RESULT_UNSUPPORTED);
+        command, process_image_captured_request(index));
 }
 
 std::optional<mavlink_message_t>
@@ -4,6 +4,9 @@
 #include "server_plugin_impl_base.h"
 #include "callback_list.h"
 
+#include <map>
+#include <mutex>
+
 namespace mavsdk {
 
 class CameraServerImpl : public ServerPluginImplBase {
@@ -52,6 +55,20 @@ private:
 
     MavlinkCommandReceiver::CommandLong _last_take_photo_command;
 
+    // Every capture reported, by index, so that lost CAMERA_IMAGE_CAPTURED
+    // messages can be sent again without calling back to user code. The
+    // oldest ones are dropped beyond the limit.
+    struct CapturedImage {
+        CameraServer::CaptureInfo capture_info{};
+        uint32_t time_boot_ms{0};
+    };
+    static constexpr size_t max_capture_history = 10000;
+    std::mutex _capture_history_mutex{};
+    std::map<int32_t, CapturedImage> _capture_history{}; // Needs _capture_history_mutex
+
+    mavlink_message_t make_image_captured_message(const CapturedImage& captured_image);
+    MAV_RESULT process_image_captured_request(int32_t index);
+
     bool parse_version_string(const std::string& version_str);
     bool parse_version_string(const std::string& version_str, uint32_t& version);
     void start_image_capture_interval(float interval, int32_t count, int32_t index);
@@ -15,6 +15,7 @@
 
 #include "server_plugin_base.h"
 
+#include "awaitable.h"
 #include "handle.h"
 
 namespace mavsdk {
@@ -219,7 +220,7 @@ public:
      *
      * @return Result of request.
      */
-    Result set_information(Information information) const;
+    Result set_information(const Information& information) const;
 
     /**
      * @brief Sets image capture in progress status flags. This should be set to true when the
@@ -259,8 +260,8 @@ public:
      *
      * @return Result of request.
      */
-    Result
-    respond_take_photo(TakePhotoFeedback take_photo_feedback, CaptureInfo capture_info) const;
+    Result respond_take_photo(
+        TakePhotoFeedback take_photo_feedback, const CaptureInfo& capture_info) const;
 
     /**
      * @brief Copy constructor.
@@ -275,6 +276,9 @@ public:
 private:
     /** @private Underlying implementation, set at instantiation */
     std::unique_ptr<CameraServerImpl> _impl;
+
+    /** @private Hand-written additions in camera_server_ext.h, if any */
+    friend class CameraServerExt;
 };
 
 } // namespace mavsdk
\ No newline at end of file
@@ -1,15 +1,43 @@
 #include "component_information_impl.h"
-#include "fs.h"
 #include "callback_list.tpp"
+#include "fs.h"
+#include "xz_compression.h"
 
+#include <cstring>
+#include <memory>
 #include <utility>
-#include <fstream>
 #include <json/json.h>
 
 namespace mavsdk {
 
 template class CallbackList<ComponentInformation::FloatParamUpdate>;
 
+namespace {
+
+bool parse_json(const std::vector<uint8_t>& content, Json::Value& root)
+{
+    Json::CharReaderBuilder builder;
+    const std::unique_ptr<Json::CharReader> reader(builder.newCharReader());
+    JSONCPP_STRING err;
+
+    const auto begin = reinterpret_cast<const char*>(content.data());
+    if (!reader->parse(begin, begin + content.size(), &root, &err)) {
+        LogErr() << "Parse error: " << err;
+        return false;
+    }
+    return true;
+}
+
+std::optional<std::vector<uint8_t>> decompress_if_needed(std::vector<uint8_t> content)
+{
+    if (is_xz_compressed(content)) {
+        return xz_decompress(content);
+    }
+    return {std::move(content)};
+}
+
+} // namespace
+
 ComponentInformationImpl::ComponentInformationImpl(System& system) : PluginImplBase(system)
 {
     _system_impl->register_plugin(this);
@@ -26,7 +54,15 @@ ComponentInformationImpl::~ComponentInformationImpl()
     _system_impl->unregister_plugin(this);
 }
 
-void ComponentInformationImpl::init() {}
+void ComponentInformationImpl::init()
+{
+    const auto maybe_cache_dir = get_cache_directory("mavsdk/component_information");
+    if (maybe_cache_dir) {
+        _metadata_cache = std::make_unique<ComponentMetadataCache>(maybe_cache_dir.value());
+    } else {
+        LogWarn() << "No cache directory, component metadata is downloaded every time";
+    }
+}
 
 void ComponentInformationImpl::deinit() {}
 
@@ -58,13 +94,25 @@ void ComponentInformationImpl::receive_component_information(
     const auto general_metadata_uri = std::string(component_information.general_metadata_uri);
 
     download_file_async(
-        general_metadata_uri, [this](std::string path) { parse_metadata_file(path); });
+        general_metadata_uri,
+        component_information.general_metadata_file_crc,
+        [this](std::vector<uint8_t> content) { parse_metadata_file(content); });
 }
 
 void ComponentInformationImpl::download_file_async(
-    const std::string& uri, std::function<void(std::string path)> callback)
+    const std::string& uri,
+    uint32_t crc,
+    std::function<void(std::vector<uint8_t> content)> callback)
 {
-    // TODO: check CRC
+    // A CRC of 0 means that the component doesn't know it.
+    if (crc != 0 && _metadata_cache) {
+        auto maybe_content = _metadata_cache->load(crc);
+        if (maybe_content) {
+            LogDebug() << "Using cached metadata for " << uri;
+            file_received(std::move(maybe_content.value()), callback);
+            return;
+        }
+    }
 
     if (uri.empty()) {
         LogErr() << "No component information URI provided";
@@ -75,22 +123,23 @@ void ComponentInformationImpl::download_file_async(
 
         const auto path = uri.substr(strlen("mftp://"));
 
-        const auto maybe_tmp_path = create_tmp_directory("mavsdk-component-information-tmp-files");
-        const auto path_to_download = maybe_tmp_path ? maybe_tmp_path.value() : "./";
-
-        _system_impl->mavlink_ftp().download_async(
+        _system_impl->mavlink_ftp().download_to_memory_async(
             path,
-            path_to_download,
-            [path_to_download, callback, path](
-                MavlinkFtp::ClientResult download_result, MavlinkFtp::ProgressData progress_data) {
+            [this, callback, crc, path](
+                MavlinkFtp::ClientResult download_result,
+                MavlinkFtp::ProgressData progress_data,
+                std::vector<uint8_t> content) {
                 if (download_result == MavlinkFtp::ClientResult::Next) {
                     LogDebug() << "File download progress: " << progress_data.bytes_transferred
                                << '/' << progress_data.total_bytes;
                 } else {
                     LogDebug() << "File download ended with result " << download_result;
                     if (download_result == MavlinkFtp::ClientResult::Success) {
-                        LogDebug() << "Received file " << path_to_download + "/" + path;
-                        callback(path_to_download + "/" + path);
+                        LogDebug() << "Received file " << path;
+                        if (crc != 0 && _metadata_cache) {
+                            _metadata_cache->store(crc, content);
+                        }
+                        file_received(std::move(content), callback);
                     }
                 }
             });
@@ -101,16 +150,23 @@ void ComponentInformationImpl::download_file_async(
     }
 }
 
-void ComponentInformationImpl::parse_metadata_file(const std::string& path)
+void ComponentInformationImpl::file_received(
+    std::vector<uint8_t> content, const std::function<void(std::vector<uint8_t> content)>& callback)
 {
-    std::ifstream f(path);
-    if (f.bad()) {
-        LogErr() << "Could not open json metadata file.";
+    auto maybe_decompressed = decompress_if_needed(std::move(content));
+    if (!maybe_decompressed) {
         return;
     }
+    callback(std::move(maybe_decompressed.value()));
+}
 
+void ComponentInformationImpl::parse_metadata_file(const std::vector<uint8_t>& content)
+{
     Json::Value metadata;
-    f >> metadata;
+    if (!parse_json(content, metadata)) {
+        LogErr() << "Could not parse json metadata file.";
+        return;
+    }
 
     if (!metadata.isMember("version")) {
         LogErr() << "version not found";
@@ -137,76 +193,49 @@ void ComponentInformationImpl::parse_metadata_file(const std::string& path)
         }
 
         if (metadata_type["type"].asInt() == COMP_METADATA_TYPE_PARAMETER) {
+            const uint32_t crc =
+                metadata_type.isMember("fileCrc") ? metadata_type["fileCrc"].asUInt() : 0;
             download_file_async(
-                metadata_type["uri"].asString(), [this](const std::string& parameter_file_path) {
-                    LogDebug() << "Found parameter file at: " << parameter_file_path;
-                    parse_parameter_file(parameter_file_path);
+                metadata_type["uri"].asString(),
+                crc,
+                [this, crc](std::vector<uint8_t> parameter_content) {
+                    parse_parameter_file(std::move(parameter_content), crc);
                 });
         }
     }
 }
 
-void ComponentInformationImpl::parse_parameter_file(const std::string& path)
+void ComponentInformationImpl::parse_parameter_file(std::vector<uint8_t> content, uint32_t crc)
 {
-    std::ifstream f(path);
-    if (f.bad()) {
-        LogErr() << "Could not open json parameter file.";
+    // Only the index is built here, entries are decoded when accessed.
+    const auto metadata = ParameterMetadata::parse_shared(crc, std::move(content));
+    if (!metadata) {
+        LogErr() << "Could not parse json parameter file.";
         return;
     }
 
-    Json::Value parameters;
-    f >> parameters;
-
-    if (!parameters.isMember("version")) {
-        LogErr() << "version not found";
-        return;
+    const auto float_names = metadata->names("Float");
+    if (float_names.size() != metadata->size()) {
+        LogWarn() << "Ignoring " << metadata->size() - float_names.size()
+                  << " params which are not of type Float for now.";
     }
 
-    if (parameters["version"].asInt() != 1) {
-        LogWarn() << "version " << parameters["version"].asInt() << " not supported";
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _parameter_metadata = metadata;
+        _float_param_values.clear();
     }
 
-    if (!parameters.isMember("parameters")) {
-        LogErr() << "parameters not found";
-        return;
-    }
-
-    std::lock_guard<std::mutex> lock(_mutex);
-    _float_params.clear();
-
-    for (auto& param : parameters["parameters"]) {
-        if (!param.isMember("type")) {
-            LogErr() << "type not found";
-            return;
-        }
+    for (const auto& name : float_names) {
+        _system_impl->get_param_float_async(
+            name,
+            [this, name](MAVLinkParameters::Result result, float value) {
+                get_float_param_result(name, result, value);
+            },
+            this);
 
-        if (param["type"].asString() == "Float") {
-            _float_params.push_back(ComponentInformation::FloatParam{
-                param["name"].asString(),
-                param["shortDesc"].asString(),
-                param["longDesc"].asString(),
-                param["units"].asString(),
-                param["decimalPlaces"].asInt(),
-                NAN,
-                param["default"].asFloat(),
-                param["min"].asFloat(),
-                param["max"].asFloat()});
-
-            const auto name = param["name"].asString();
-
-            _system_impl->get_param_float_async(
-                name,
-                [this, name](MAVLinkParameters::Result result, float value) {
-                    get_float_param_result(name, result, value);
-                },
-                this);
-
-            _system_impl->subscribe_param_float(
-                name, [this, name](float value) { param_update(name, value); }, this);
-
-        } else {
-            LogWarn() << "Ignoring type " << param["type"].asString() << " for now.";
-        }
+        _system_impl->subscribe_param_float(
+            name, [this, name](float value) { param_update(name, value); }, this);
     }
 }
 
@@ -219,24 +248,16 @@ void ComponentInformationImpl::get_float_param_result(
     }
 
     std::lock_guard<std::mutex> lock(_mutex);
-    for (auto& param : _float_params) {
-        if (param.name == name) {
-            param.start_value = value;
-            LogDebug() << "Received value " << value << " for " << name;
-        }
-    }
+    _float_param_values[name] = value;
+    LogDebug() << "Received value " << value << " for " << name;
 }
 
 void ComponentInformationImpl::param_update(const std::string& name, float new_value)
 {
     std::lock_guard<std::mutex> lock(_mutex);
 
-    for (auto& param : _float_params) {
-        if (param.name == name) {
-            param.start_value = new_value;
-            LogDebug() << "Received value " << new_value << " for " << name;
-        }
-    }
+    _float_param_values[name] = new_value;
+    LogDebug() << "Received value " << new_value << " for " << name;
 
     const auto param_update = ComponentInformation::FloatParamUpdate{name, new_value};
 
@@ -247,7 +268,30 @@ void ComponentInformationImpl::param_update(const std::string& name, float new_v
 std::pair<ComponentInformation::Result, std::vector<ComponentInformation::FloatParam>>
 ComponentInformationImpl::access_float_params()
 {
-    return {ComponentInformation::Result::Success, _float_params};
+    std::lock_guard<std::mutex> lock(_mutex);
+    std::vector<ComponentInformation::FloatParam> float_params;
+    if (!_parameter_metadata) {
+        return {ComponentInformation::Result::Success, float_params};
+    }
+
+    for (const auto& name : _parameter_metadata->names("Float")) {
+        const auto entry = _parameter_metadata->entry(name);
+        if (!entry) {
+            continue;
+        }
+        const auto value = _float_param_values.find(name);
+        float_params.push_back(ComponentInformation::FloatParam{
+            entry->name,
+            entry->short_description,
+            entry->long_description,
+            entry->units,
+            entry->decimal_places,
+            value != _float_param_values.end() ? value->second : NAN,
+            entry->default_value,
+            entry->min_value,
+            entry->max_value});
+    }
+    return {ComponentInformation::Result::Success, float_params};
 }
 
 ComponentInformation::FloatParamHandle ComponentInformationImpl::subscribe_float_param(
@@ -3,6 +3,11 @@
 #include "plugins/component_information/component_information.h"
 #include "plugin_impl_base.h"
 #include "callback_list.h"
+#include "component_metadata_cache.h"
+#include "parameter_metadata.h"
+
+#include <map>
+#include <memory>
 
 namespace mavsdk {
 
@@ -29,18 +34,26 @@ private:
     void receive_component_information(
         MavlinkCommandSender::Result result, const mavlink_message_t& message);
 
-    void
-    download_file_async(const std::string& uri, std::function<void(std::string path)> callback);
-    void parse_metadata_file(const std::string& path);
-    void parse_parameter_file(const std::string& path);
+    void download_file_async(
+        const std::string& uri,
+        uint32_t crc,
+        std::function<void(std::vector<uint8_t> content)> callback);
+    void file_received(
+        std::vector<uint8_t> content,
+        const std::function<void(std::vector<uint8_t> content)>& callback);
+    void parse_metadata_file(const std::vector<uint8_t>& content);
+    void parse_parameter_file(std::vector<uint8_t> content, uint32_t crc);
 
     void
     get_float_param_result(const std::string& name, MAVLinkParameters::Result result, float value);
 
     void param_update(const std::string& name, float new_value);
 
+    std::unique_ptr<ComponentMetadataCache> _metadata_cache{};
+
     std::mutex _mutex{};
-    std::vector<ComponentInformation::FloatParam> _float_params{};
+    std::shared_ptr<const ParameterMetadata> _parameter_metadata{};
+    std::map<std::string, float> _float_param_values{};
 
     CallbackList<ComponentInformation::FloatParamUpdate> _float_param_update_callbacks{};
 };
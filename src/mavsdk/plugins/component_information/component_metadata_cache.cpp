@@ -0,0 +1,76 @@
+#include "component_metadata_cache.h"
+#include "crc32.h"
+#include "fs.h"
+#include "log.h"
+
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <utility>
+
+namespace mavsdk {
+
+ComponentMetadataCache::ComponentMetadataCache(std::string directory) :
+    _directory(std::move(directory))
+{}
+
+std::optional<std::vector<uint8_t>> ComponentMetadataCache::load(uint32_t crc) const
+{
+    const auto path = path_for(crc);
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return {};
+    }
+
+    std::vector<uint8_t> content(fs_file_size(path));
+    file.read(
+        reinterpret_cast<char*>(content.data()), static_cast<std::streamsize>(content.size()));
+    if (!file || crc32(content) != crc) {
+        LogWarn() << "Removing corrupt metadata cache file " << path;
+        file.close();
+        fs_remove(path);
+        return {};
+    }
+    return {std::move(content)};
+}
+
+bool ComponentMetadataCache::store(uint32_t crc, const std::vector<uint8_t>& content) const
+{
+    if (crc32(content) != crc) {
+        LogWarn() << "Not caching metadata, CRC doesn't match";
+        return false;
+    }
+
+    // Written next to it first, so that nobody loads a partial file.
+    const auto path = path_for(crc);
+    const auto tmp_path = path + ".part";
+    {
+        std::ofstream file(tmp_path, std::ios::binary | std::ios::trunc);
+        file.write(
+            reinterpret_cast<const char*>(content.data()),
+            static_cast<std::streamsize>(content.size()));
+        if (!file) {
+            LogWarn() << "Could not write metadata cache file " << tmp_path;
+            file.close();
+            fs_remove(tmp_path);
+            return false;
+        }
+    }
+    return fs_rename(tmp_path, path);
+}
+
+uint32_t ComponentMetadataCache::crc32(const std::vector<uint8_t>& content)
+{
+    Crc32 crc;
+    crc.add(content.data(), static_cast<uint32_t>(content.size()));
+    return crc.get();
+}
+
+std::string ComponentMetadataCache::path_for(uint32_t crc) const
+{
+    std::stringstream ss;
+    ss << std::hex << std::setw(8) << std::setfill('0') << crc;
+    return _directory + path_separator + ss.str();
+}
+
+} // namespace mavsdk
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace mavsdk {
+
+// Keeps downloaded component metadata files on disk, keyed by the CRC that
+// the component announces for them, so that a known vehicle doesn't need to
+// send them again. Files are checked against the CRC when loaded.
+class ComponentMetadataCache {
+public:
+    explicit ComponentMetadataCache(std::string directory);
+    ~ComponentMetadataCache() = default;
+
+    // Non-copyable
+    ComponentMetadataCache(const ComponentMetadataCache&) = delete;
+    const ComponentMetadataCache& operator=(const ComponentMetadataCache&) = delete;
+
+    std::optional<std::vector<uint8_t>> load(uint32_t crc) const;
+    bool store(uint32_t crc, const std::vector<uint8_t>& content) const;
+
+    static uint32_t crc32(const std::vector<uint8_t>& content);
+
+private:
+    std::string path_for(uint32_t crc) const;
+
+    const std::string _directory;
+};
+
+} // namespace mavsdk
@@ -0,0 +1,69 @@
+#include "component_metadata_cache.h"
+#include "fs.h"
+
+#include <fstream>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+
+using namespace mavsdk;
+
+namespace {
+
+std::vector<uint8_t> to_bytes(const std::string& str)
+{
+    return {str.begin(), str.end()};
+}
+
+std::string cache_directory()
+{
+    const auto maybe_tmp_dir = create_tmp_directory("mavsdk-component-metadata-cache-test");
+    EXPECT_TRUE(maybe_tmp_dir);
+    return maybe_tmp_dir.value_or("./");
+}
+
+} // namespace
+
+TEST(ComponentMetadataCache, StoreAndLoad)
+{
+    ComponentMetadataCache cache{cache_directory()};
+    const auto content = to_bytes("{\"version\": 1}");
+    const auto crc = ComponentMetadataCache::crc32(content);
+
+    EXPECT_FALSE(cache.load(crc));
+    EXPECT_TRUE(cache.store(crc, content));
+
+    const auto loaded = cache.load(crc);
+    ASSERT_TRUE(loaded);
+    EXPECT_EQ(loaded.value(), content);
+}
+
+TEST(ComponentMetadataCache, WrongCrcIsNotStored)
+{
+    ComponentMetadataCache cache{cache_directory()};
+    const auto content = to_bytes("{\"version\": 1}");
+    const auto crc = ComponentMetadataCache::crc32(content) + 1;
+
+    EXPECT_FALSE(cache.store(crc, content));
+    EXPECT_FALSE(cache.load(crc));
+}
+
+TEST(ComponentMetadataCache, CorruptFileIsRemoved)
+{
+    const auto directory = cache_directory();
+    ComponentMetadataCache cache{directory};
+    const auto content = to_bytes("{\"version\": 1}");
+    const auto crc = ComponentMetadataCache::crc32(content);
+    ASSERT_TRUE(cache.store(crc, content));
+
+    char name[9];
+    snprintf(name, sizeof(name), "%08x", crc);
+    const auto path = directory + path_separator + name;
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file << "{\"version\": 2}";
+    }
+
+    EXPECT_FALSE(cache.load(crc));
+    EXPECT_FALSE(fs_exists(path));
+}
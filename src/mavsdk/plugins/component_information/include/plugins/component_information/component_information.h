@@ -16,6 +16,7 @@
 
 #include "plugin_base.h"
 
+#include "awaitable.h"
 #include "handle.h"
 
 namespace mavsdk {
@@ -178,6 +179,9 @@ public:
 private:
     /** @private Underlying implementation, set at instantiation */
     std::unique_ptr<ComponentInformationImpl> _impl;
+
+    /** @private Hand-written additions in component_information_ext.h, if any */
+    friend class ComponentInformationExt;
 };
 
 } // namespace mavsdk
\ No newline at end of file
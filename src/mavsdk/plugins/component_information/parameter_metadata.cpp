@@ -0,0 +1,182 @@
+#include "parameter_metadata.h"
+#include "json_pull_reader.h"
+#include "log.h"
+
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <utility>
+
+namespace mavsdk {
+
+namespace {
+
+void read_string(JsonPullReader& reader, std::string& out)
+{
+    if (reader.peek() == JsonPullReader::Type::String) {
+        out = reader.read_string().value_or("");
+    } else {
+        reader.skip_value();
+    }
+}
+
+template<typename T> void read_number(JsonPullReader& reader, T& out)
+{
+    if (reader.peek() == JsonPullReader::Type::Number) {
+        out = static_cast<T>(reader.read_number().value_or(0.0));
+    } else {
+        reader.skip_value();
+    }
+}
+
+} // namespace
+
+ParameterMetadata::ParameterMetadata(std::vector<uint8_t> content) : _content(std::move(content))
+{}
+
+std::shared_ptr<const ParameterMetadata> ParameterMetadata::parse(std::vector<uint8_t> content)
+{
+    // The constructor is private, so make_shared can't be used.
+    std::shared_ptr<ParameterMetadata> metadata{new ParameterMetadata(std::move(content))};
+    if (!metadata->build_index()) {
+        return {};
+    }
+    return metadata;
+}
+
+std::shared_ptr<const ParameterMetadata>
+ParameterMetadata::parse_shared(uint32_t crc, std::vector<uint8_t> content)
+{
+    if (crc == 0) {
+        return parse(std::move(content));
+    }
+
+    static std::mutex mutex;
+    static std::map<uint32_t, std::weak_ptr<const ParameterMetadata>> instances;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = instances.find(crc);
+    if (it != instances.end()) {
+        if (auto existing = it->second.lock()) {
+            return existing;
+        }
+    }
+
+    auto metadata = parse(std::move(content));
+    if (metadata) {
+        instances[crc] = metadata;
+    }
+    return metadata;
+}
+
+bool ParameterMetadata::build_index()
+{
+    JsonPullReader reader(content_begin(), content_end());
+    if (!reader.enter_object()) {
+        LogErr() << "Parameter metadata is not a json object";
+        return false;
+    }
+
+    bool parameters_found = false;
+    std::string key;
+    while (reader.next_key(key)) {
+        if (key == "version") {
+            const auto version = reader.read_number();
+            if (version && version.value() != 1.0) {
+                LogWarn() << "version " << version.value() << " not supported";
+            }
+        } else if (key == "parameters" && reader.enter_array()) {
+            parameters_found = true;
+            while (reader.next_element()) {
+                const auto offset = static_cast<uint32_t>(reader.position() - content_begin());
+                IndexEntry index_entry{{}, {}, offset};
+                if (!reader.enter_object()) {
+                    break;
+                }
+                std::string entry_key;
+                while (reader.next_key(entry_key)) {
+                    if (entry_key == "name") {
+                        read_string(reader, index_entry.name);
+                    } else if (entry_key == "type") {
+                        read_string(reader, index_entry.type);
+                    } else {
+                        reader.skip_value();
+                    }
+                }
+                _index.push_back(std::move(index_entry));
+            }
+        } else {
+            reader.skip_value();
+        }
+    }
+
+    if (reader.failed()) {
+        LogErr() << "Could not parse parameter metadata";
+        return false;
+    }
+    if (!parameters_found) {
+        LogErr() << "parameters not found";
+        return false;
+    }
+
+    std::sort(_index.begin(), _index.end(), [](const IndexEntry& lhs, const IndexEntry& rhs) {
+        return lhs.name < rhs.name;
+    });
+    _index.shrink_to_fit();
+    return true;
+}
+
+std::vector<std::string> ParameterMetadata::names(const std::string& type) const
+{
+    std::vector<std::string> result;
+    for (const auto& index_entry : _index) {
+        if (type.empty() || index_entry.type == type) {
+            result.push_back(index_entry.name);
+        }
+    }
+    return result;
+}
+
+std::optional<ParameterMetadata::Entry> ParameterMetadata::entry(const std::string& name) const
+{
+    const auto it = std::lower_bound(
+        _index.begin(), _index.end(), name, [](const IndexEntry& index_entry, const auto& value) {
+            return index_entry.name < value;
+        });
+    if (it == _index.end() || it->name != name) {
+        return {};
+    }
+
+    // The whole file was checked when indexing, so this can't fail.
+    JsonPullReader reader(content_begin() + it->offset, content_end());
+    reader.enter_object();
+
+    Entry entry{};
+    std::string key;
+    while (reader.next_key(key)) {
+        if (key == "name") {
+            read_string(reader, entry.name);
+        } else if (key == "type") {
+            read_string(reader, entry.type);
+        } else if (key == "shortDesc") {
+            read_string(reader, entry.short_description);
+        } else if (key == "longDesc") {
+            read_string(reader, entry.long_description);
+        } else if (key == "units") {
+            read_string(reader, entry.units);
+        } else if (key == "decimalPlaces") {
+            read_number(reader, entry.decimal_places);
+        } else if (key == "default") {
+            read_number(reader, entry.default_value);
+        } else if (key == "min") {
+            read_number(reader, entry.min_value);
+        } else if (key == "max") {
+            read_number(reader, entry.max_value);
+        } else {
+            reader.skip_value();
+        }
+    }
+    return entry;
+}
+
+} // namespace mavsdk
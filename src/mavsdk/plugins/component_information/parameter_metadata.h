@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace mavsdk {
+
+// Parameter metadata as described by a component's parameter JSON file.
+//
+// The file can be several MB, so it is only indexed by name when parsed,
+// and entries are decoded when asked for. Systems announcing the same CRC
+// share one instance.
+class ParameterMetadata {
+public:
+    struct Entry {
+        std::string name{};
+        std::string type{};
+        std::string short_description{};
+        std::string long_description{};
+        std::string units{};
+        int decimal_places{0};
+        float default_value{0.0f};
+        float min_value{0.0f};
+        float max_value{0.0f};
+    };
+
+    // Returns nothing if the file is malformed.
+    static std::shared_ptr<const ParameterMetadata> parse(std::vector<uint8_t> content);
+
+    // Returns the instance of another system with the same CRC, if there is
+    // one. Files with a CRC of 0 are never shared.
+    static std::shared_ptr<const ParameterMetadata>
+    parse_shared(uint32_t crc, std::vector<uint8_t> content);
+
+    ~ParameterMetadata() = default;
+
+    // Non-copyable
+    ParameterMetadata(const ParameterMetadata&) = delete;
+    const ParameterMetadata& operator=(const ParameterMetadata&) = delete;
+
+    std::size_t size() const { return _index.size(); }
+
+    // Sorted by name. All parameters, if no type is given.
+    std::vector<std::string> names(const std::string& type = {}) const;
+
+    std::optional<Entry> entry(const std::string& name) const;
+
+private:
+    struct IndexEntry {
+        std::string name;
+        std::string type;
+        // Start of the entry's object in _content.
+        uint32_t offset;
+    };
+
+    explicit ParameterMetadata(std::vector<uint8_t> content);
+
+    bool build_index();
+    const char* content_begin() const { return reinterpret_cast<const char*>(_content.data()); }
+    const char* content_end() const { return content_begin() + _content.size(); }
+
+    const std::vector<uint8_t> _content;
+    std::vector<IndexEntry> _index{};
+};
+
+} // namespace mavsdk
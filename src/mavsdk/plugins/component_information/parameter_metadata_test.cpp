@@ -0,0 +1,104 @@
+#include "parameter_metadata.h"
+
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+
+using namespace mavsdk;
+
+namespace {
+
+std::vector<uint8_t> to_bytes(const std::string& str)
+{
+    return {str.begin(), str.end()};
+}
+
+const std::string parameter_json = R"({
+    "version": 1,
+    "parameters": [
+        {
+            "name": "MPC_XY_VEL_MAX",
+            "type": "Float",
+            "shortDesc": "Maximum horizontal velocity",
+            "longDesc": "Maximum horizontal velocity in \"position\" mode.",
+            "units": "m/s",
+            "decimalPlaces": 2,
+            "default": 12.0,
+            "min": 0.0,
+            "max": 20.0,
+            "volatile": false,
+            "values": [{"value": 1, "description": "ignored"}]
+        },
+        {
+            "name": "COM_RC_LOSS_T",
+            "type": "Float",
+            "default": 0.5
+        },
+        {
+            "name": "SYS_AUTOSTART",
+            "type": "Int32",
+            "default": 0
+        }
+    ]
+})";
+
+} // namespace
+
+TEST(ParameterMetadata, IndexesByName)
+{
+    const auto metadata = ParameterMetadata::parse(to_bytes(parameter_json));
+    ASSERT_TRUE(metadata);
+    EXPECT_EQ(metadata->size(), 3);
+
+    const std::vector<std::string> all{"COM_RC_LOSS_T", "MPC_XY_VEL_MAX", "SYS_AUTOSTART"};
+    EXPECT_EQ(metadata->names(), all);
+
+    const std::vector<std::string> floats{"COM_RC_LOSS_T", "MPC_XY_VEL_MAX"};
+    EXPECT_EQ(metadata->names("Float"), floats);
+}
+
+TEST(ParameterMetadata, DecodesEntries)
+{
+    const auto metadata = ParameterMetadata::parse(to_bytes(parameter_json));
+    ASSERT_TRUE(metadata);
+
+    const auto entry = metadata->entry("MPC_XY_VEL_MAX");
+    ASSERT_TRUE(entry);
+    EXPECT_EQ(entry->name, "MPC_XY_VEL_MAX");
+    EXPECT_EQ(entry->type, "Float");
+    EXPECT_EQ(entry->short_description, "Maximum horizontal velocity");
+    EXPECT_EQ(entry->long_description, "Maximum horizontal velocity in \"position\" mode.");
+    EXPECT_EQ(entry->units, "m/s");
+    EXPECT_EQ(entry->decimal_places, 2);
+    EXPECT_FLOAT_EQ(entry->default_value, 12.0f);
+    EXPECT_FLOAT_EQ(entry->min_value, 0.0f);
+    EXPECT_FLOAT_EQ(entry->max_value, 20.0f);
+
+    const auto short_entry = metadata->entry("COM_RC_LOSS_T");
+    ASSERT_TRUE(short_entry);
+    EXPECT_FLOAT_EQ(short_entry->default_value, 0.5f);
+    EXPECT_TRUE(short_entry->units.empty());
+
+    EXPECT_FALSE(metadata->entry("DOES_NOT_EXIST"));
+}
+
+TEST(ParameterMetadata, RejectsMalformedFiles)
+{
+    EXPECT_FALSE(ParameterMetadata::parse(to_bytes("")));
+    EXPECT_FALSE(ParameterMetadata::parse(to_bytes("{\"version\": 1}")));
+    EXPECT_FALSE(ParameterMetadata::parse(to_bytes("{\"parameters\": [{\"name\": \"A\"}")));
+    EXPECT_FALSE(ParameterMetadata::parse(to_bytes("{\"parameters\": [1]}")));
+}
+
+TEST(ParameterMetadata, SharedByCrc)
+{
+    const auto first = ParameterMetadata::parse_shared(42, to_bytes(parameter_json));
+    const auto second = ParameterMetadata::parse_shared(42, to_bytes(parameter_json));
+    EXPECT_EQ(first, second);
+
+    const auto other = ParameterMetadata::parse_shared(43, to_bytes(parameter_json));
+    EXPECT_NE(first, other);
+
+    const auto unknown = ParameterMetadata::parse_shared(0, to_bytes(parameter_json));
+    EXPECT_NE(unknown, ParameterMetadata::parse_shared(0, to_bytes(parameter_json)));
+}
@@ -21,8 +21,8 @@ ComponentInformationServer::ComponentInformationServer(
 
 ComponentInformationServer::~ComponentInformationServer() {}
 
-ComponentInformationServer::Result
-ComponentInformationServer::provide_float_param(FloatParam param) const
+ComponentInformationServer::Result ComponentInformationServer::provide_float_param(
+    const FloatParam& param) const
 {
     return _impl->provide_float_param(param);
 }
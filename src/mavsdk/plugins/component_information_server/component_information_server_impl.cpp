@@ -1,9 +1,12 @@
 #include "component_information_server_impl.h"
 #include "mavlink_request_message_handler.h"
+#include "metadata_compression.h"
 #include "callback_list.tpp"
 
 #include <algorithm>
 #include <string>
+#include <tuple>
+#include <vector>
 #include <json/json.h>
 
 namespace mavsdk {
@@ -25,6 +28,11 @@ ComponentInformationServerImpl::~ComponentInformationServerImpl()
 
 void ComponentInformationServerImpl::init()
 {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        update_json_files_with_lock();
+    }
+
     _server_component_impl->mavlink_request_message_handler().register_handler(
         MAVLINK_MSG_ID_COMPONENT_INFORMATION,
         [this](uint8_t, uint8_t, MavlinkRequestMessageHandler::Params) {
@@ -36,6 +44,12 @@ void ComponentInformationServerImpl::init()
 void ComponentInformationServerImpl::deinit()
 {
     _server_component_impl->mavlink_request_message_handler().unregister_all_handlers(this);
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    for (const auto& name :
+         {"general.json", "general.json.xz", "parameter.json", "parameter.json.xz"}) {
+        _server_component_impl->ftp_memory_files().remove(name);
+    }
 }
 
 ComponentInformationServer::Result
@@ -103,37 +117,53 @@ void ComponentInformationServerImpl::param_update(const std::string& name, float
 
 std::optional<MAV_RESULT> ComponentInformationServerImpl::process_component_information_requested()
 {
+    std::string general_metadata_uri;
+    uint32_t general_metadata_crc;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        general_metadata_uri = _general_metadata_uri;
+        general_metadata_crc = _general_metadata_crc;
+    }
+
     mavlink_message_t message;
     mavlink_msg_component_information_pack(
         _server_component_impl->get_own_system_id(),
         _server_component_impl->get_own_component_id(),
         &message,
         _server_component_impl->get_time().elapsed_ms(),
-        0,
-        "mftp://general.json",
+        general_metadata_crc,
+        general_metadata_uri.c_str(),
         0,
         "");
     _server_component_impl->send_message(message);
 
-    // FIXME: REMOVE again
-    update_json_files_with_lock();
-
     return MAV_RESULT_ACCEPTED;
 }
 
 void ComponentInformationServerImpl::update_json_files_with_lock()
 {
-    auto parameter_file = generate_parameter_file();
-    auto meta_file = generate_meta_file();
+    const auto [parameter_uri, parameter_crc] =
+        serve_file("parameter.json", generate_parameter_file());
+
+    std::tie(_general_metadata_uri, _general_metadata_crc) =
+        serve_file("general.json", generate_meta_file(parameter_uri, parameter_crc));
+}
 
-    // std::cout << "parameter: " << parameter_file << '\n';
-    // std::cout << "meta: " << meta_file << '\n';
+std::pair<std::string, uint32_t>
+ComponentInformationServerImpl::serve_file(const std::string& name, const std::string& json)
+{
+    auto& files = _server_component_impl->ftp_memory_files();
+
+    // The name changes with the compression, so only one of them is served.
+    if (auto maybe_compressed = xz_compress(json)) {
+        files.remove(name);
+        const auto crc = files.set(name + ".xz", std::move(maybe_compressed.value()));
+        return {"mftp://" + name + ".xz", crc};
+    }
 
-    // FIXME: needs refactoring
-    //_server_component_impl->mavlink_ftp().write_tmp_file("general.json",
-    // meta_file);
-    //_server_component_impl->mavlink_ftp().write_tmp_file("parameter.json",
-    // parameter_file);
+    files.remove(name + ".xz");
+    const auto crc = files.set(name, std::vector<uint8_t>(json.begin(), json.end()));
+    return {"mftp://" + name, crc};
 }
 
 std::string ComponentInformationServerImpl::generate_parameter_file()
@@ -159,7 +189,8 @@ std::string ComponentInformationServerImpl::generate_parameter_file()
     return root.toStyledString();
 }
 
-std::string ComponentInformationServerImpl::generate_meta_file()
+std::string ComponentInformationServerImpl::generate_meta_file(
+    const std::string& parameter_uri, uint32_t parameter_crc)
 {
     Json::Value root;
     root["version"] = 1;
@@ -170,8 +201,8 @@ std::string ComponentInformationServerImpl::generate_meta_file()
     Json::Value metadata_types = Json::arrayValue;
     Json::Value metadata_type;
     metadata_type["type"] = Json::Int{COMP_METADATA_TYPE_PARAMETER};
-    metadata_type["uri"] = "mftp://parameter.json";
-    metadata_type["fileCrc"] = 0; // TODO
+    metadata_type["uri"] = parameter_uri;
+    metadata_type["fileCrc"] = parameter_crc;
     metadata_type["uriFallback"] = ""; // TODO
     metadata_type["fileCrcFallback"] = 0;
     metadata_types.append(metadata_type);
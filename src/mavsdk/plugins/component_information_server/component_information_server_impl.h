@@ -4,6 +4,10 @@
 #include "server_plugin_impl_base.h"
 #include "callback_list.h"
 
+#include <cstdint>
+#include <string>
+#include <utility>
+
 namespace mavsdk {
 
 class ComponentInformationServerImpl : public ServerPluginImplBase {
@@ -28,13 +32,20 @@ private:
     void param_update(const std::string& name, float new_value);
 
     std::string generate_parameter_file();
-    std::string generate_meta_file();
+    std::string generate_meta_file(const std::string& parameter_uri, uint32_t parameter_crc);
+
+    // Puts it in memory for the FTP server, compressed if we can, and
+    // returns its URI and CRC.
+    std::pair<std::string, uint32_t> serve_file(const std::string& name, const std::string& json);
 
     std::optional<MAV_RESULT> process_component_information_requested();
 
     std::mutex _mutex{};
     std::vector<ComponentInformationServer::FloatParam> _float_params{};
     std::string _our_ip{};
+    // Generated whenever the params change, not for every request.
+    std::string _general_metadata_uri{};
+    uint32_t _general_metadata_crc{0};
     CallbackList<ComponentInformationServer::FloatParamUpdate> _float_param_update_callbacks{};
 };
 
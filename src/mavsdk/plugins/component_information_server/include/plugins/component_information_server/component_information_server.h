@@ -16,6 +16,7 @@
 
 #include "server_plugin_base.h"
 
+#include "awaitable.h"
 #include "handle.h"
 
 namespace mavsdk {
@@ -137,7 +138,7 @@ public:
      *
      * @return Result of request.
      */
-    Result provide_float_param(FloatParam param) const;
+    Result provide_float_param(const FloatParam& param) const;
 
     /**
      * @brief Callback type for subscribe_float_param.
@@ -172,6 +173,9 @@ public:
 private:
     /** @private Underlying implementation, set at instantiation */
     std::unique_ptr<ComponentInformationServerImpl> _impl;
+
+    /** @private Hand-written additions in component_information_server_ext.h, if any */
+    friend class ComponentInformationServerExt;
 };
 
 } // namespace mavsdk
\ No newline at end of file
@@ -0,0 +1,11 @@
+#include "metadata_compression.h"
+#include "xz_compression.h"
+
+namespace mavsdk {
+
+std::optional<std::vector<uint8_t>> xz_compress(const std::string& content)
+{
+    return xz_compress(reinterpret_cast<const uint8_t*>(content.data()), content.size());
+}
+
+} // namespace mavsdk
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace mavsdk {
+
+// Compresses metadata files with xz, as ground stations expect them for
+// files ending in .xz.
+//
+// The output only depends on the content, so the CRC of unchanged metadata
+// stays the same and clients can keep using their cached copy. Returns
+// nothing if we are built without liblzma.
+std::optional<std::vector<uint8_t>> xz_compress(const std::string& content);
+
+} // namespace mavsdk
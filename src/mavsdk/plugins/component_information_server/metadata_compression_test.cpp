@@ -0,0 +1,25 @@
+#include "metadata_compression.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+
+using namespace mavsdk;
+
+TEST(MetadataCompression, CompressesToXz)
+{
+    const std::string content{"{\"version\": 1, \"parameters\": []}"};
+
+    const auto result = xz_compress(content);
+    if (!result) {
+        GTEST_SKIP() << "Built without liblzma";
+    }
+
+    const std::vector<uint8_t> magic{0xfd, '7', 'z', 'X', 'Z', 0x00};
+    ASSERT_GE(result->size(), magic.size());
+    EXPECT_TRUE(std::equal(magic.begin(), magic.end(), result->begin()));
+
+    // The same metadata has to give the same CRC each time.
+    EXPECT_EQ(xz_compress(content), result);
+}
@@ -39,6 +39,7 @@ void FailureImpl::enable()
             } else {
                 _enabled = EnabledState::Unknown;
             }
+            _state_change.notify();
         },
         this);
 
@@ -52,6 +53,7 @@ void FailureImpl::enable()
             } else {
                 _enabled = EnabledState::Unknown;
             }
+            _state_change.notify();
         },
         this);
 }
@@ -64,9 +66,7 @@ void FailureImpl::disable()
 Failure::Result FailureImpl::inject(
     Failure::FailureUnit failure_unit, Failure::FailureType failure_type, int32_t instance)
 {
-    while (_enabled == EnabledState::Init) {
-        std::this_thread::sleep_for(std::chrono::milliseconds(10));
-    }
+    _state_change.wait([this]() { return _enabled != EnabledState::Init; });
 
     // If the param is unknown we ignore it and try anyway.
     if (_enabled == EnabledState::Disabled) {
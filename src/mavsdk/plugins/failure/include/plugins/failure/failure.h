@@ -15,6 +15,7 @@
 
 #include "plugin_base.h"
 
+#include "awaitable.h"
 #include "handle.h"
 
 namespace mavsdk {
@@ -155,6 +156,9 @@ public:
 private:
     /** @private Underlying implementation, set at instantiation */
     std::unique_ptr<FailureImpl> _impl;
+
+    /** @private Hand-written additions in failure_ext.h, if any */
+    friend class FailureExt;
 };
 
 } // namespace mavsdk
\ No newline at end of file
@@ -26,7 +26,7 @@ FollowMe::Config FollowMe::get_config() const
     return _impl->get_config();
 }
 
-FollowMe::Result FollowMe::set_config(Config config) const
+FollowMe::Result FollowMe::set_config(const Config& config) const
 {
     return _impl->set_config(config);
 }
@@ -36,7 +36,7 @@ bool FollowMe::is_active() const
     return _impl->is_active();
 }
 
-FollowMe::Result FollowMe::set_target_location(TargetLocation location) const
+FollowMe::Result FollowMe::set_target_location(const TargetLocation& location) const
 {
     return _impl->set_target_location(location);
 }
@@ -0,0 +1,13 @@
+#include "follow_me_impl.h"
+#include "plugins/follow_me/follow_me_ext.h"
+
+namespace mavsdk {
+
+FollowMeExt::FollowMeExt(FollowMe& follow_me) : _impl(*follow_me._impl) {}
+
+FollowMe::Result FollowMeExt::set_prediction_tolerance(double tolerance_m) const
+{
+    return _impl.set_prediction_tolerance(tolerance_m);
+}
+
+} // namespace mavsdk
@@ -1,5 +1,6 @@
 #include "follow_me_impl.h"
 #include "system.h"
+#include "decoded_message.h"
 #include "px4_custom_mode.h"
 #include <cmath>
 
@@ -190,8 +191,14 @@ FollowMe::Result FollowMeImpl::set_target_location(const FollowMe::TargetLocatio
         if (_mode != Mode::ACTIVE) {
             return FollowMe::Result::NotActive;
         }
-        // If set already, reschedule it.
+        // If set already, reschedule it, unless the vehicle can predict it
+        // well enough from the last one and the next regular update will do.
         if (_target_location_cookie) {
+            if (_prediction_tolerance_m > 0.0 &&
+                _prediction.prediction_error_m(location, _time.steady_time()) <=
+                    _prediction_tolerance_m) {
+                return FollowMe::Result::Success;
+            }
             _system_impl->reset_call_every(_target_location_cookie);
             // We also need to send it right now.
             schedule_now = true;
@@ -216,6 +223,18 @@ FollowMe::TargetLocation FollowMeImpl::get_last_location() const
     return _last_location;
 }
 
+FollowMe::Result FollowMeImpl::set_prediction_tolerance(double tolerance_m)
+{
+    if (!std::isfinite(tolerance_m) || tolerance_m < 0.0) {
+        LogErr() << debug_str << "Err: Prediction tolerance must not be negative";
+        return FollowMe::Result::SetConfigFailed;
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _prediction_tolerance_m = tolerance_m;
+    return FollowMe::Result::Success;
+}
+
 bool FollowMeImpl::is_active() const
 {
     std::lock_guard<std::mutex> lock(_mutex);
@@ -357,6 +376,7 @@ void FollowMeImpl::send_target_location()
         LogErr() << debug_str << "send_target_location() failed..";
     } else {
         _last_location = _target_location;
+        _prediction.set_sent(_target_location, now);
     }
 }
 
@@ -367,13 +387,13 @@ void FollowMeImpl::stop_sending_target_location()
         _system_impl->remove_call_every(_target_location_cookie);
         _target_location_cookie = nullptr;
     }
+    _prediction.reset();
     _mode = Mode::NOT_ACTIVE;
 }
 
 void FollowMeImpl::process_heartbeat(const mavlink_message_t& message)
 {
-    mavlink_heartbeat_t heartbeat;
-    mavlink_msg_heartbeat_decode(&message, &heartbeat);
+    const auto& heartbeat = DecodedMessage::get(message, mavlink_msg_heartbeat_decode);
 
     bool follow_me_active = false; // tells whether we're in FollowMe mode right now
     if (heartbeat.base_mode & MAV_MODE_FLAG_CUSTOM_MODE_ENABLED) {
@@ -5,6 +5,7 @@
 #include "plugins/follow_me/follow_me.h"
 #include "plugin_impl_base.h"
 #include "system.h"
+#include "target_prediction.h"
 #include "timeout_handler.h"
 
 namespace mavsdk {
@@ -27,6 +28,8 @@ public:
     FollowMe::Result set_target_location(const FollowMe::TargetLocation& location);
     FollowMe::TargetLocation get_last_location() const;
 
+    FollowMe::Result set_prediction_tolerance(double tolerance_m);
+
     bool is_active() const;
 
     FollowMe::Result start();
@@ -104,6 +107,11 @@ private:
     FollowMe::TargetLocation _last_location{}; // sent to vehicle
     void* _target_location_cookie = nullptr;
 
+    // Locations within the tolerance of where the vehicle already expects the
+    // target are not sent, other than at SENDER_RATE. 0 sends all of them.
+    double _prediction_tolerance_m{0.0};
+    TargetPrediction _prediction{};
+
     Time _time{};
     uint8_t _estimation_capabilities = 0; // sent to vehicle
     FollowMe::Config _config{}; // has FollowMe configuration settings
@@ -15,6 +15,7 @@
 
 #include "plugin_base.h"
 
+#include "awaitable.h"
 #include "handle.h"
 
 namespace mavsdk {
@@ -188,7 +189,7 @@ public:
      *
      * @return Result of request.
      */
-    Result set_config(Config config) const;
+    Result set_config(const Config& config) const;
 
     /**
      * @brief Check if FollowMe is active.
@@ -206,7 +207,7 @@ public:
      *
      * @return Result of request.
      */
-    Result set_target_location(TargetLocation location) const;
+    Result set_target_location(const TargetLocation& location) const;
 
     /**
      * @brief Get the last location of the target.
@@ -248,6 +249,9 @@ public:
 private:
     /** @private Underlying implementation, set at instantiation */
     std::unique_ptr<FollowMeImpl> _impl;
+
+    /** @private Hand-written additions in follow_me_ext.h, if any */
+    friend class FollowMeExt;
 };
 
 } // namespace mavsdk
\ No newline at end of file
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "plugins/follow_me/follow_me.h"
+
+namespace mavsdk {
+
+class FollowMeImpl;
+
+/**
+ * @brief Additions to FollowMe that are only available in C++.
+ *
+ * Unlike follow_me.h, this header is not generated from the proto files,
+ * so the calls here are not available through mavsdk_server.
+ *
+ * It works on the FollowMe plugin it is created with, which has to outlive it:
+ *
+ *     ```cpp
+ *     auto follow_me = FollowMe(system);
+ *     auto follow_me_ext = FollowMeExt(follow_me);
+ *     ```
+ */
+class FollowMeExt {
+public:
+    /**
+     * @brief Constructor. Uses the given FollowMe plugin.
+     *
+     * @param follow_me The plugin, which has to outlive this object.
+     */
+    explicit FollowMeExt(FollowMe& follow_me);
+
+    /**
+     * @brief Only send target locations that the vehicle can't predict.
+     *
+     * The vehicle dead reckons the target from the last location and velocity it got.
+     * With a tolerance set, target locations within that distance of the prediction are
+     * not sent, and the target is then only sent once a second, until it deviates from
+     * the prediction again. This saves link bandwidth for targets moving steadily.
+     * A tolerance of 0 sends every target location, which is the default.
+     *
+     * This function is blocking.
+     *
+     * @return Result of request.
+     */
+    FollowMe::Result set_prediction_tolerance(double tolerance_m) const;
+
+private:
+    FollowMeImpl& _impl;
+};
+
+} // namespace mavsdk
@@ -0,0 +1,60 @@
+#include "target_prediction.h"
+#include "geometry.h"
+#include <chrono>
+#include <cmath>
+
+namespace mavsdk {
+
+namespace {
+
+// Velocities are optional, an unknown one is assumed to be 0.
+double known_or_zero(float value)
+{
+    return std::isfinite(value) ? static_cast<double>(value) : 0.0;
+}
+
+} // namespace
+
+void TargetPrediction::reset()
+{
+    _sent = false;
+}
+
+void TargetPrediction::set_sent(const FollowMe::TargetLocation& location, SteadyTimePoint time)
+{
+    _sent = true;
+    _location = location;
+    _time = time;
+}
+
+double TargetPrediction::prediction_error_m(
+    const FollowMe::TargetLocation& location, SteadyTimePoint time) const
+{
+    if (!_sent) {
+        return NAN;
+    }
+
+    const double dt_s = std::chrono::duration<double>(time - _time).count();
+
+    const geometry::CoordinateTransformation transformation{
+        {_location.latitude_deg, _location.longitude_deg}};
+    const auto local =
+        transformation.local_from_global({location.latitude_deg, location.longitude_deg});
+
+    const double north_error_m = local.north_m - known_or_zero(_location.velocity_x_m_s) * dt_s;
+    const double east_error_m = local.east_m - known_or_zero(_location.velocity_y_m_s) * dt_s;
+
+    // Down velocity, so the altitude goes the other way.
+    double up_error_m = 0.0;
+    if (std::isfinite(location.absolute_altitude_m) &&
+        std::isfinite(_location.absolute_altitude_m)) {
+        up_error_m = static_cast<double>(location.absolute_altitude_m) -
+                     static_cast<double>(_location.absolute_altitude_m) +
+                     known_or_zero(_location.velocity_z_m_s) * dt_s;
+    }
+
+    return std::sqrt(
+        north_error_m * north_error_m + east_error_m * east_error_m + up_error_m * up_error_m);
+}
+
+} // namespace mavsdk
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "plugins/follow_me/follow_me.h"
+#include "mavsdk_time.h"
+
+namespace mavsdk {
+
+// Dead reckons the target from the last location sent to the vehicle, which
+// is what the vehicle does as well until it gets the next one. A new location
+// only needs to be sent if it is too far off from that prediction.
+class TargetPrediction {
+public:
+    TargetPrediction() = default;
+    ~TargetPrediction() = default;
+
+    void reset();
+    void set_sent(const FollowMe::TargetLocation& location, SteadyTimePoint time);
+
+    // Position error of the prediction in meters, horizontally and vertically
+    // combined, or NAN if nothing was sent yet.
+    [[nodiscard]] double prediction_error_m(
+        const FollowMe::TargetLocation& location, SteadyTimePoint time) const;
+
+private:
+    bool _sent{false};
+    FollowMe::TargetLocation _location{};
+    SteadyTimePoint _time{};
+};
+
+} // namespace mavsdk
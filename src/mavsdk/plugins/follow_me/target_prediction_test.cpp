@@ -0,0 +1,65 @@
+#include "target_prediction.h"
+#include "geometry.h"
+
+#include <chrono>
+#include <cmath>
+#include <gtest/gtest.h>
+
+using namespace mavsdk;
+
+namespace {
+
+FollowMe::TargetLocation location_at(double north_m, double east_m)
+{
+    const geometry::CoordinateTransformation transformation{{47.3977, 8.5456}};
+    const auto global = transformation.global_from_local({north_m, east_m});
+
+    FollowMe::TargetLocation location{};
+    location.latitude_deg = global.latitude_deg;
+    location.longitude_deg = global.longitude_deg;
+    location.absolute_altitude_m = 500.0f;
+    return location;
+}
+
+} // namespace
+
+TEST(TargetPrediction, NothingSent)
+{
+    TargetPrediction prediction{};
+    EXPECT_TRUE(std::isnan(prediction.prediction_error_m(location_at(0.0, 0.0), {})));
+}
+
+TEST(TargetPrediction, DeadReckonsWithVelocity)
+{
+    const SteadyTimePoint start{};
+    TargetPrediction prediction{};
+
+    auto sent = location_at(0.0, 0.0);
+    sent.velocity_x_m_s = 2.0f;
+    sent.velocity_y_m_s = -1.0f;
+    prediction.set_sent(sent, start);
+
+    const auto later = start + std::chrono::seconds(3);
+    EXPECT_NEAR(prediction.prediction_error_m(location_at(6.0, -3.0), later), 0.0, 0.01);
+    EXPECT_NEAR(prediction.prediction_error_m(location_at(10.0, -3.0), later), 4.0, 0.01);
+
+    // The down velocity lowers the altitude.
+    auto climbed = location_at(6.0, -3.0);
+    climbed.absolute_altitude_m = 503.0f;
+    EXPECT_NEAR(prediction.prediction_error_m(climbed, later), 3.0, 0.01);
+}
+
+TEST(TargetPrediction, UnknownVelocityMeansStandingStill)
+{
+    const SteadyTimePoint start{};
+    TargetPrediction prediction{};
+    prediction.set_sent(location_at(0.0, 0.0), start);
+
+    EXPECT_NEAR(
+        prediction.prediction_error_m(location_at(0.0, 5.0), start + std::chrono::seconds(10)),
+        5.0,
+        0.01);
+
+    prediction.reset();
+    EXPECT_TRUE(std::isnan(prediction.prediction_error_m(location_at(0.0, 0.0), start)));
+}
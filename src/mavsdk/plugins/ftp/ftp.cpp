@@ -17,89 +17,97 @@ Ftp::Ftp(std::shared_ptr<System> system) : PluginBase(), _impl{std::make_unique<
 
 Ftp::~Ftp() {}
 
-void Ftp::reset_async(const ResultCallback callback)
+void Ftp::reset_async(const ResultCallback& callback)
 {
     _impl->reset_async(callback);
 }
 
 void Ftp::download_async(
-    std::string remote_file_path, std::string local_dir, const DownloadCallback& callback)
+    const std::string& remote_file_path,
+    const std::string& local_dir,
+    const DownloadCallback& callback)
 {
     _impl->download_async(remote_file_path, local_dir, callback);
 }
 
 void Ftp::upload_async(
-    std::string local_file_path, std::string remote_dir, const UploadCallback& callback)
+    const std::string& local_file_path,
+    const std::string& remote_dir,
+    const UploadCallback& callback)
 {
     _impl->upload_async(local_file_path, remote_dir, callback);
 }
 
-void Ftp::list_directory_async(std::string remote_dir, const ListDirectoryCallback callback)
+void Ftp::list_directory_async(const std::string& remote_dir, const ListDirectoryCallback& callback)
 {
     _impl->list_directory_async(remote_dir, callback);
 }
 
-std::pair<Ftp::Result, std::vector<std::string>> Ftp::list_directory(std::string remote_dir) const
+std::pair<Ftp::Result, std::vector<std::string>> Ftp::list_directory(
+    const std::string& remote_dir) const
 {
     return _impl->list_directory(remote_dir);
 }
 
-void Ftp::create_directory_async(std::string remote_dir, const ResultCallback callback)
+void Ftp::create_directory_async(const std::string& remote_dir, const ResultCallback& callback)
 {
     _impl->create_directory_async(remote_dir, callback);
 }
 
-Ftp::Result Ftp::create_directory(std::string remote_dir) const
+Ftp::Result Ftp::create_directory(const std::string& remote_dir) const
 {
     return _impl->create_directory(remote_dir);
 }
 
-void Ftp::remove_directory_async(std::string remote_dir, const ResultCallback callback)
+void Ftp::remove_directory_async(const std::string& remote_dir, const ResultCallback& callback)
 {
     _impl->remove_directory_async(remote_dir, callback);
 }
 
-Ftp::Result Ftp::remove_directory(std::string remote_dir) const
+Ftp::Result Ftp::remove_directory(const std::string& remote_dir) const
 {
     return _impl->remove_directory(remote_dir);
 }
 
-void Ftp::remove_file_async(std::string remote_file_path, const ResultCallback callback)
+void Ftp::remove_file_async(const std::string& remote_file_path, const ResultCallback& callback)
 {
     _impl->remove_file_async(remote_file_path, callback);
 }
 
-Ftp::Result Ftp::remove_file(std::string remote_file_path) const
+Ftp::Result Ftp::remove_file(const std::string& remote_file_path) const
 {
     return _impl->remove_file(remote_file_path);
 }
 
 void Ftp::rename_async(
-    std::string remote_from_path, std::string remote_to_path, const ResultCallback callback)
+    const std::string& remote_from_path,
+    const std::string& remote_to_path,
+    const ResultCallback& callback)
 {
     _impl->rename_async(remote_from_path, remote_to_path, callback);
 }
 
-Ftp::Result Ftp::rename(std::string remote_from_path, std::string remote_to_path) const
+Ftp::Result Ftp::rename(
+    const std::string& remote_from_path, const std::string& remote_to_path) const
 {
     return _impl->rename(remote_from_path, remote_to_path);
 }
 
 void Ftp::are_files_identical_async(
-    std::string local_file_path,
-    std::string remote_file_path,
-    const AreFilesIdenticalCallback callback)
+    const std::string& local_file_path,
+    const std::string& remote_file_path,
+    const AreFilesIdenticalCallback& callback)
 {
     _impl->are_files_identical_async(local_file_path, remote_file_path, callback);
 }
 
-std::pair<Ftp::Result, bool>
-Ftp::are_files_identical(std::string local_file_path, std::string remote_file_path) const
+std::pair<Ftp::Result, bool> Ftp::are_files_identical(
+    const std::string& local_file_path, const std::string& remote_file_path) const
 {
     return _impl->are_files_identical(local_file_path, remote_file_path);
 }
 
-Ftp::Result Ftp::set_root_directory(std::string root_dir) const
+Ftp::Result Ftp::set_root_directory(const std::string& root_dir) const
 {
     return _impl->set_root_directory(root_dir);
 }
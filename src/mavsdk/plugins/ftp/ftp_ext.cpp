@@ -0,0 +1,64 @@
+#include <iomanip>
+
+#include "ftp_impl.h"
+#include "plugins/ftp/ftp_ext.h"
+
+namespace mavsdk {
+
+FtpExt::FtpExt(Ftp& ftp) : _impl(*ftp._impl) {}
+
+Ftp::Result FtpExt::set_max_sessions(uint32_t max_sessions) const
+{
+    return _impl.set_max_sessions(max_sessions);
+}
+
+void FtpExt::list_directory_entries_async(
+    const std::string& remote_dir, const ListDirectoryEntriesCallback& callback)
+{
+    _impl.list_directory_entries_async(remote_dir, callback);
+}
+
+void FtpExt::sync_directory_async(
+    const std::string& remote_dir,
+    const std::string& local_dir,
+    SyncDirection direction,
+    const SyncDirectoryCallback& callback)
+{
+    _impl.sync_directory_async(remote_dir, local_dir, direction, callback);
+}
+
+Ftp::Result FtpExt::set_compression_enabled(bool enabled) const
+{
+    return _impl.set_compression_enabled(enabled);
+}
+
+bool operator==(const FtpExt::DirectoryEntry& lhs, const FtpExt::DirectoryEntry& rhs)
+{
+    return (rhs.name == lhs.name) && (rhs.is_directory == lhs.is_directory) &&
+           (rhs.size == lhs.size);
+}
+
+std::ostream& operator<<(std::ostream& str, FtpExt::DirectoryEntry const& directory_entry)
+{
+    str << std::setprecision(15);
+    str << "directory_entry:" << '\n' << "{\n";
+    str << "    name: " << directory_entry.name << '\n';
+    str << "    is_directory: " << directory_entry.is_directory << '\n';
+    str << "    size: " << directory_entry.size << '\n';
+    str << '}';
+    return str;
+}
+
+std::ostream& operator<<(std::ostream& str, FtpExt::SyncDirection const& sync_direction)
+{
+    switch (sync_direction) {
+        case FtpExt::SyncDirection::Download:
+            return str << "Download";
+        case FtpExt::SyncDirection::Upload:
+            return str << "Upload";
+        default:
+            return str << "Unknown";
+    }
+}
+
+} // namespace mavsdk
@@ -20,6 +20,7 @@
 #include "crc32.h"
 #include "fs.h"
 #include "ftp_impl.h"
+#include "ftp_sync.h"
 #include "system.h"
 
 namespace mavsdk {
@@ -57,7 +58,7 @@ void FtpImpl::reset_async(Ftp::ResultCallback callback)
 void FtpImpl::download_async(
     const std::string& remote_path, const std::string& local_folder, Ftp::DownloadCallback callback)
 {
-    _system_impl->mavlink_ftp().download_async(
+    _system_impl->mavlink_ftp_pool().download_async(
         remote_path,
         local_folder,
         [callback, this](MavlinkFtp::ClientResult result, MavlinkFtp::ProgressData progress_data) {
@@ -72,7 +73,7 @@ void FtpImpl::upload_async(
     const std::string& remote_folder,
     Ftp::UploadCallback callback)
 {
-    _system_impl->mavlink_ftp().upload_async(
+    _system_impl->mavlink_ftp_pool().upload_async(
         local_file_path,
         remote_folder,
         [callback, this](MavlinkFtp::ClientResult result, MavlinkFtp::ProgressData progress_data) {
@@ -91,7 +92,7 @@ std::pair<Ftp::Result, std::vector<std::string>> FtpImpl::list_directory(const s
 void FtpImpl::list_directory_async(
     const std::string& path, Ftp::ListDirectoryCallback callback, uint32_t offset)
 {
-    _system_impl->mavlink_ftp().list_directory_async(
+    _system_impl->mavlink_ftp_pool().list_directory_async(
         path,
         [callback, this](MavlinkFtp::ClientResult result, auto&& dirs) {
             callback(result_from_mavlink_ftp_result(result), dirs);
@@ -99,6 +100,15 @@ void FtpImpl::list_directory_async(
         offset);
 }
 
+void FtpImpl::list_directory_entries_async(
+    const std::string& path, FtpExt::ListDirectoryEntriesCallback callback)
+{
+    _system_impl->mavlink_ftp_pool().list_directory_streaming_async(
+        path, [callback, this](MavlinkFtp::ClientResult result, std::vector<std::string> list) {
+            callback(result_from_mavlink_ftp_result(result), FtpSync::parse_listing(list));
+        });
+}
+
 Ftp::Result FtpImpl::create_directory(const std::string& path)
 {
     return result_from_mavlink_ftp_result(_system_impl->mavlink_ftp().create_directory(path));
@@ -164,12 +174,54 @@ void FtpImpl::are_files_identical_async(
     const std::string& remote_path,
     Ftp::AreFilesIdenticalCallback callback)
 {
-    _system_impl->mavlink_ftp().are_files_identical_async(
+    _system_impl->mavlink_ftp_pool().are_files_identical_async(
         local_path, remote_path, [callback, this](MavlinkFtp::ClientResult result, bool identical) {
             callback(result_from_mavlink_ftp_result(result), identical);
         });
 }
 
+void FtpImpl::sync_directory_async(
+    const std::string& remote_dir,
+    const std::string& local_dir,
+    FtpExt::SyncDirection direction,
+    const FtpExt::SyncDirectoryCallback& callback)
+{
+    // All of these go through the pool of sessions, so that they can
+    // run in parallel.
+    FtpSync::Transport transport{};
+    transport.list_directory =
+        [this](const std::string& path, FtpSync::ListCallback list_callback) {
+            list_directory_async(path, list_callback);
+        };
+    transport.create_directory =
+        [this](const std::string& path, Ftp::ResultCallback result_callback) {
+            _system_impl->mavlink_ftp_pool().create_directory_async(
+                path, [this, result_callback](MavlinkFtp::ClientResult result) {
+                    result_callback(result_from_mavlink_ftp_result(result));
+                });
+        };
+    transport.are_files_identical = [this](
+                                        const std::string& local_path,
+                                        const std::string& remote_path,
+                                        Ftp::AreFilesIdenticalCallback identical_callback) {
+        are_files_identical_async(local_path, remote_path, identical_callback);
+    };
+    transport.download = [this](
+                             const std::string& remote_path,
+                             const std::string& local_folder,
+                             Ftp::DownloadCallback download_callback) {
+        download_async(remote_path, local_folder, download_callback);
+    };
+    transport.upload = [this](
+                           const std::string& local_path,
+                           const std::string& remote_folder,
+                           Ftp::UploadCallback upload_callback) {
+        upload_async(local_path, remote_folder, upload_callback);
+    };
+
+    FtpSync::start(std::move(transport), remote_dir, local_dir, direction, callback);
+}
+
 Ftp::Result FtpImpl::set_root_directory(const std::string& root_dir)
 {
     return result_from_mavlink_ftp_result(_system_impl->mavlink_ftp().set_root_directory(root_dir));
@@ -178,14 +230,30 @@ Ftp::Result FtpImpl::set_root_directory(const std::string& root_dir)
 void FtpImpl::set_retries(uint32_t retries)
 {
     _system_impl->mavlink_ftp().set_retries(retries);
+    _system_impl->mavlink_ftp_pool().set_retries(retries);
 }
 
 Ftp::Result FtpImpl::set_target_compid(uint8_t component_id)
 {
+    _system_impl->mavlink_ftp_pool().set_target_compid(component_id);
     return result_from_mavlink_ftp_result(
         _system_impl->mavlink_ftp().set_target_compid(component_id));
 }
 
+Ftp::Result FtpImpl::set_max_sessions(uint32_t max_sessions)
+{
+    return _system_impl->mavlink_ftp_pool().set_max_sessions(max_sessions) ?
+               Ftp::Result::Success :
+               Ftp::Result::InvalidParameter;
+}
+
+Ftp::Result FtpImpl::set_compression_enabled(bool enabled)
+{
+    return _system_impl->mavlink_ftp_pool().set_compression_enabled(enabled) ?
+               Ftp::Result::Success :
+               Ftp::Result::Unsupported;
+}
+
 Ftp::Result FtpImpl::result_from_mavlink_ftp_result(MavlinkFtp::ClientResult result)
 {
     switch (result) {
@@ -215,6 +283,8 @@ Ftp::Result FtpImpl::result_from_mavlink_ftp_result(MavlinkFtp::ClientResult res
             return Ftp::Result::ProtocolError;
         case MavlinkFtp::ClientResult::NoSystem:
             return Ftp::Result::NoSystem;
+        case MavlinkFtp::ClientResult::NoSessionsAvailable:
+            return Ftp::Result::Busy;
         default:
             return Ftp::Result::Unknown;
     }
@@ -6,6 +6,7 @@
 
 #include "mavlink_include.h"
 #include "plugins/ftp/ftp.h"
+#include "plugins/ftp/ftp_ext.h"
 #include "plugin_impl_base.h"
 
 // As found in
@@ -52,6 +53,8 @@ public:
         Ftp::UploadCallback callback);
     void list_directory_async(
         const std::string& path, Ftp::ListDirectoryCallback callback, uint32_t offset = 0);
+    void list_directory_entries_async(
+        const std::string& path, FtpExt::ListDirectoryEntriesCallback callback);
     void create_directory_async(const std::string& path, Ftp::ResultCallback callback);
     void remove_directory_async(const std::string& path, Ftp::ResultCallback callback);
     void remove_file_async(const std::string& path, Ftp::ResultCallback callback);
@@ -61,11 +64,18 @@ public:
         const std::string& local_path,
         const std::string& remote_path,
         Ftp::AreFilesIdenticalCallback callback);
+    void sync_directory_async(
+        const std::string& remote_dir,
+        const std::string& local_dir,
+        FtpExt::SyncDirection direction,
+        const FtpExt::SyncDirectoryCallback& callback);
 
     void set_retries(uint32_t retries);
     Ftp::Result set_root_directory(const std::string& root_dir);
     uint8_t get_our_compid() { return _system_impl->get_own_component_id(); };
     Ftp::Result set_target_compid(uint8_t component_id);
+    Ftp::Result set_max_sessions(uint32_t max_sessions);
+    Ftp::Result set_compression_enabled(bool enabled);
 
 private:
     Ftp::Result result_from_mavlink_ftp_result(MavlinkFtp::ClientResult result);
@@ -0,0 +1,314 @@
+#include "ftp_sync.h"
+#include "filesystem_include.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace mavsdk {
+
+std::vector<FtpSync::Entry> FtpSync::parse_listing(const std::vector<std::string>& listing)
+{
+    std::vector<Entry> entries;
+    for (const auto& item : listing) {
+        if (item.size() < 2 || (item[0] != 'F' && item[0] != 'D')) {
+            continue;
+        }
+
+        Entry entry{};
+        entry.is_directory = item[0] == 'D';
+        const auto tab = item.find('\t');
+        entry.name = item.substr(1, tab == std::string::npos ? std::string::npos : tab - 1);
+        if (!entry.is_directory && tab != std::string::npos) {
+            entry.size = static_cast<uint32_t>(std::strtoul(item.c_str() + tab + 1, nullptr, 10));
+        }
+
+        // Our own server lists paths relative to its root.
+        const auto slash = entry.name.rfind('/');
+        if (slash != std::string::npos) {
+            entry.name = entry.name.substr(slash + 1);
+        }
+
+        if (entry.name.empty() || entry.name == "." || entry.name == "..") {
+            continue;
+        }
+        entries.push_back(entry);
+    }
+    return entries;
+}
+
+void FtpSync::start(
+    Transport transport,
+    const std::string& remote_dir,
+    const std::string& local_dir,
+    FtpExt::SyncDirection direction,
+    const FtpExt::SyncDirectoryCallback& callback)
+{
+    std::error_code ec;
+    if (direction == FtpExt::SyncDirection::Upload && !fs::is_directory(local_dir, ec)) {
+        callback(Ftp::Result::FileDoesNotExist, Ftp::ProgressData{});
+        return;
+    }
+
+    // Kept alive by the callbacks in flight.
+    std::shared_ptr<FtpSync> sync{new FtpSync(std::move(transport), direction, callback)};
+    sync->sync_directory(remote_dir, local_dir);
+}
+
+FtpSync::FtpSync(
+    Transport transport,
+    FtpExt::SyncDirection direction,
+    FtpExt::SyncDirectoryCallback callback) :
+    _transport(std::move(transport)),
+    _direction(direction),
+    _callback(std::move(callback))
+{}
+
+void FtpSync::sync_directory(const std::string& remote_dir, const std::string& local_dir)
+{
+    begin_steps(1);
+
+    if (_direction == FtpExt::SyncDirection::Download) {
+        std::error_code ec;
+        fs::create_directories(local_dir, ec);
+        if (ec) {
+            fail(Ftp::Result::FileIoError);
+            end_step();
+            return;
+        }
+    }
+
+    auto self = shared_from_this();
+    _transport.list_directory(
+        remote_dir,
+        [self, remote_dir, local_dir](Ftp::Result result, std::vector<std::string> listing) {
+            if (result == Ftp::Result::Success) {
+                self->compare_directory(remote_dir, local_dir, parse_listing(listing));
+
+            } else if (
+                result == Ftp::Result::FileDoesNotExist &&
+                self->_direction == FtpExt::SyncDirection::Upload) {
+                // The listing of the parent was fine, so it's just this one
+                // directory missing.
+                self->_transport.create_directory(
+                    remote_dir, [self, remote_dir, local_dir](Ftp::Result create_result) {
+                        if (create_result == Ftp::Result::Success) {
+                            self->compare_directory(remote_dir, local_dir, {});
+                        } else {
+                            self->fail(create_result);
+                        }
+                        self->end_step();
+                    });
+                return;
+
+            } else {
+                self->fail(result);
+            }
+            self->end_step();
+        });
+}
+
+void FtpSync::compare_directory(
+    const std::string& remote_dir,
+    const std::string& local_dir,
+    const std::vector<Entry>& remote_entries)
+{
+    std::vector<Entry> local_entries;
+    std::error_code ec;
+    for (const auto& dir_entry : fs::directory_iterator(local_dir, ec)) {
+        Entry entry{};
+        entry.name = dir_entry.path().filename().string();
+        if (dir_entry.is_directory(ec)) {
+            entry.is_directory = true;
+        } else if (dir_entry.is_regular_file(ec)) {
+            entry.size = static_cast<uint32_t>(dir_entry.file_size(ec));
+        } else {
+            continue;
+        }
+        local_entries.push_back(entry);
+    }
+    if (ec) {
+        fail(Ftp::Result::FileIoError);
+        return;
+    }
+
+    const bool download = _direction == FtpExt::SyncDirection::Download;
+    const auto& source_entries = download ? remote_entries : local_entries;
+    const auto& destination_entries = download ? local_entries : remote_entries;
+
+    for (const auto& entry : source_entries) {
+        const auto remote_path = remote_join(remote_dir, entry.name);
+        const auto local_path = (fs::path(local_dir) / entry.name).string();
+
+        if (entry.is_directory) {
+            sync_directory(remote_path, local_path);
+            continue;
+        }
+
+        Transfer transfer{};
+        transfer.remote_path = remote_path;
+        transfer.local_path = local_path;
+        transfer.size = entry.size;
+
+        const auto existing = std::find_if(
+            destination_entries.begin(),
+            destination_entries.end(),
+            [&](const Entry& destination) {
+                return !destination.is_directory && destination.name == entry.name;
+            });
+
+        if (existing == destination_entries.end() || existing->size != entry.size) {
+            add_transfer(transfer);
+        } else {
+            compare_file(transfer);
+        }
+    }
+}
+
+void FtpSync::compare_file(const Transfer& transfer)
+{
+    begin_steps(1);
+
+    auto self = shared_from_this();
+    _transport.are_files_identical(
+        transfer.local_path,
+        transfer.remote_path,
+        [self, transfer](Ftp::Result result, bool identical) {
+            // Not every server can calculate a CRC32, better send it again.
+            if (result != Ftp::Result::Success || !identical) {
+                self->add_transfer(transfer);
+            }
+            self->end_step();
+        });
+}
+
+void FtpSync::add_transfer(const Transfer& transfer)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _transfers.push_back(transfer);
+    _total_bytes += transfer.size;
+}
+
+void FtpSync::start_transfer(std::size_t index)
+{
+    std::string remote_path;
+    std::string local_path;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        remote_path = _transfers[index].remote_path;
+        local_path = _transfers[index].local_path;
+    }
+
+    auto self = shared_from_this();
+    const auto callback = [self, index](Ftp::Result result, Ftp::ProgressData progress) {
+        self->update_transfer(index, result, progress);
+    };
+
+    if (_direction == FtpExt::SyncDirection::Download) {
+        _transport.download(remote_path, fs::path(local_path).parent_path().string(), callback);
+    } else {
+        _transport.upload(local_path, remote_parent(remote_path), callback);
+    }
+}
+
+void FtpSync::update_transfer(std::size_t index, Ftp::Result result, Ftp::ProgressData progress)
+{
+    if (result != Ftp::Result::Next && result != Ftp::Result::Success) {
+        fail(result);
+        end_step();
+        return;
+    }
+
+    Ftp::ProgressData total{};
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto& transfer = _transfers[index];
+        // A resumed download starts with what was there already.
+        const uint32_t bytes_transferred = result == Ftp::Result::Success ?
+                                               transfer.size :
+                                               std::min(progress.bytes_transferred, transfer.size);
+        if (bytes_transferred > transfer.bytes_transferred) {
+            _bytes_transferred += bytes_transferred - transfer.bytes_transferred;
+            transfer.bytes_transferred = bytes_transferred;
+        }
+        total.bytes_transferred = _bytes_transferred;
+        total.total_bytes = _total_bytes;
+    }
+
+    if (result == Ftp::Result::Next) {
+        _callback(Ftp::Result::Next, total);
+    } else {
+        end_step();
+    }
+}
+
+void FtpSync::begin_steps(unsigned num_steps)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _pending_steps += num_steps;
+}
+
+void FtpSync::end_step()
+{
+    bool start_transfers = false;
+    std::size_t num_transfers = 0;
+    Ftp::Result result{};
+    Ftp::ProgressData total{};
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (--_pending_steps > 0) {
+            return;
+        }
+
+        if (!_transferring && _result == Ftp::Result::Success && !_transfers.empty()) {
+            start_transfers = true;
+            _transferring = true;
+            num_transfers = _transfers.size();
+            // All of them up front, so that we don't finish early.
+            _pending_steps = static_cast<unsigned>(num_transfers);
+        }
+        result = _result;
+        total.bytes_transferred = _bytes_transferred;
+        total.total_bytes = _total_bytes;
+    }
+
+    if (start_transfers) {
+        _callback(Ftp::Result::Next, total);
+        for (std::size_t i = 0; i < num_transfers; ++i) {
+            start_transfer(i);
+        }
+        return;
+    }
+
+    _callback(result, total);
+}
+
+void FtpSync::fail(Ftp::Result result)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    // The first error is the interesting one.
+    if (_result == Ftp::Result::Success) {
+        _result = result;
+    }
+}
+
+std::string FtpSync::remote_join(const std::string& dir, const std::string& name)
+{
+    if (!dir.empty() && dir.back() == '/') {
+        return dir + name;
+    }
+    return dir + "/" + name;
+}
+
+std::string FtpSync::remote_parent(const std::string& path)
+{
+    const auto slash = path.rfind('/');
+    if (slash == std::string::npos) {
+        return "";
+    }
+    if (slash == 0) {
+        return "/";
+    }
+    return path.substr(0, slash);
+}
+
+} // namespace mavsdk
@@ -0,0 +1,107 @@
+#pragma once
+
+#include "plugins/ftp/ftp.h"
+#include "plugins/ftp/ftp_ext.h"
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace mavsdk {
+
+// Mirrors a directory tree from one side to the other. Files which are
+// missing or differ on the destination are transferred, files only found on
+// the destination are left alone.
+//
+// The tree is walked with one listing per directory, files of the same size
+// are compared by CRC32, and only once all of that is done the transfers are
+// started, so that the total size is known for the progress. Everything is
+// started at once, it's up to the transport to run it on as many sessions as
+// it has.
+class FtpSync : public std::enable_shared_from_this<FtpSync> {
+public:
+    using ListCallback = std::function<void(Ftp::Result, std::vector<std::string>)>;
+
+    // The operations used, all asynchronous.
+    struct Transport {
+        std::function<void(const std::string& remote_dir, ListCallback)> list_directory{};
+        std::function<void(const std::string& remote_dir, Ftp::ResultCallback)> create_directory{};
+        std::function<void(
+            const std::string& local_path,
+            const std::string& remote_path,
+            Ftp::AreFilesIdenticalCallback)>
+            are_files_identical{};
+        std::function<void(
+            const std::string& remote_path, const std::string& local_dir, Ftp::DownloadCallback)>
+            download{};
+        std::function<void(
+            const std::string& local_path, const std::string& remote_dir, Ftp::UploadCallback)>
+            upload{};
+    };
+
+    using Entry = FtpExt::DirectoryEntry;
+
+    // Entries of a MAVLink FTP listing, like "Fname\tsize" and "Dname",
+    // without skipped entries, "." and "..".
+    static std::vector<Entry> parse_listing(const std::vector<std::string>& listing);
+
+    static void start(
+        Transport transport,
+        const std::string& remote_dir,
+        const std::string& local_dir,
+        FtpExt::SyncDirection direction,
+        const FtpExt::SyncDirectoryCallback& callback);
+
+    ~FtpSync() = default;
+
+    // Non-copyable
+    FtpSync(const FtpSync&) = delete;
+    const FtpSync& operator=(const FtpSync&) = delete;
+
+private:
+    FtpSync(
+        Transport transport,
+        FtpExt::SyncDirection direction,
+        FtpExt::SyncDirectoryCallback callback);
+
+    struct Transfer {
+        std::string remote_path{};
+        std::string local_path{};
+        uint32_t size{0};
+        uint32_t bytes_transferred{0};
+    };
+
+    void sync_directory(const std::string& remote_dir, const std::string& local_dir);
+    void compare_directory(
+        const std::string& remote_dir,
+        const std::string& local_dir,
+        const std::vector<Entry>& remote_entries);
+    void compare_file(const Transfer& transfer);
+    void add_transfer(const Transfer& transfer);
+    void start_transfer(std::size_t index);
+    void update_transfer(std::size_t index, Ftp::Result result, Ftp::ProgressData progress);
+
+    void begin_steps(unsigned num_steps);
+    void end_step();
+    void fail(Ftp::Result result);
+
+    static std::string remote_join(const std::string& dir, const std::string& name);
+    static std::string remote_parent(const std::string& path);
+
+    const Transport _transport;
+    const FtpExt::SyncDirection _direction;
+    const FtpExt::SyncDirectoryCallback _callback;
+
+    std::mutex _mutex{};
+    // Needs _mutex
+    unsigned _pending_steps{0};
+    bool _transferring{false};
+    Ftp::Result _result{Ftp::Result::Success};
+    std::vector<Transfer> _transfers{};
+    uint32_t _total_bytes{0};
+    uint32_t _bytes_transferred{0};
+};
+
+} // namespace mavsdk
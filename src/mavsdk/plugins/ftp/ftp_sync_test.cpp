@@ -0,0 +1,227 @@
+#include "ftp_sync.h"
+#include "filesystem_include.h"
+#include "fs.h"
+
+#include <fstream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <gtest/gtest.h>
+
+using namespace mavsdk;
+
+namespace {
+
+// A remote side kept in memory, answering right away.
+class FakeRemote {
+public:
+    FtpSync::Transport transport()
+    {
+        FtpSync::Transport transport{};
+        transport.list_directory = [this](const std::string& dir, FtpSync::ListCallback callback) {
+            if (dirs.count(dir) == 0) {
+                callback(Ftp::Result::FileDoesNotExist, {});
+                return;
+            }
+            std::vector<std::string> listing{"D.", "D.."};
+            for (const auto& sub_dir : dirs) {
+                if (parent(sub_dir) == dir && sub_dir != dir) {
+                    listing.push_back("D" + name(sub_dir));
+                }
+            }
+            for (const auto& file : files) {
+                if (parent(file.first) == dir) {
+                    listing.push_back(
+                        "F" + name(file.first) + "\t" + std::to_string(file.second.size()));
+                }
+            }
+            callback(Ftp::Result::Success, listing);
+        };
+        transport.create_directory = [this](const std::string& dir, Ftp::ResultCallback callback) {
+            dirs.insert(dir);
+            callback(Ftp::Result::Success);
+        };
+        transport.are_files_identical = [this](
+                                            const std::string& local_path,
+                                            const std::string& remote_path,
+                                            Ftp::AreFilesIdenticalCallback callback) {
+            ++num_compared;
+            callback(Ftp::Result::Success, read(local_path) == files[remote_path]);
+        };
+        transport.download = [this](
+                                 const std::string& remote_path,
+                                 const std::string& local_dir,
+                                 Ftp::DownloadCallback callback) {
+            const auto& content = files[remote_path];
+            if (fail_transfers) {
+                callback(Ftp::Result::Timeout, {});
+                return;
+            }
+            downloaded.push_back(remote_path);
+            std::ofstream(local_dir + path_separator + name(remote_path)) << content;
+            const auto size = static_cast<uint32_t>(content.size());
+            callback(Ftp::Result::Next, Ftp::ProgressData{size / 2, size});
+            callback(Ftp::Result::Success, Ftp::ProgressData{size, size});
+        };
+        transport.upload = [this](
+                               const std::string& local_path,
+                               const std::string& remote_dir,
+                               Ftp::UploadCallback callback) {
+            const auto remote_path = remote_dir + "/" + fs::path(local_path).filename().string();
+            uploaded.push_back(remote_path);
+            files[remote_path] = read(local_path);
+            const auto size = static_cast<uint32_t>(files[remote_path].size());
+            callback(Ftp::Result::Success, Ftp::ProgressData{size, size});
+        };
+        return transport;
+    }
+
+    static std::string read(const std::string& path)
+    {
+        std::ifstream file(path);
+        std::stringstream buffer;
+        buffer << file.rdbuf();
+        return buffer.str();
+    }
+
+    std::set<std::string> dirs{"/data"};
+    std::map<std::string, std::string> files{};
+    std::vector<std::string> downloaded{};
+    std::vector<std::string> uploaded{};
+    unsigned num_compared{0};
+    bool fail_transfers{false};
+
+private:
+    static std::string parent(const std::string& path) { return path.substr(0, path.rfind('/')); }
+    static std::string name(const std::string& path) { return path.substr(path.rfind('/') + 1); }
+};
+
+struct SyncResult {
+    std::vector<Ftp::ProgressData> progress{};
+    Ftp::Result result{Ftp::Result::Unknown};
+    unsigned num_results{0};
+};
+
+SyncResult sync(
+    FakeRemote& remote, const std::string& local_dir, FtpExt::SyncDirection direction)
+{
+    SyncResult sync_result{};
+    FtpSync::start(
+        remote.transport(),
+        "/data",
+        local_dir,
+        direction,
+        [&](Ftp::Result result, Ftp::ProgressData progress) {
+            if (result == Ftp::Result::Next) {
+                sync_result.progress.push_back(progress);
+            } else {
+                sync_result.result = result;
+                ++sync_result.num_results;
+            }
+        });
+    return sync_result;
+}
+
+} // namespace
+
+TEST(FtpSync, ParseListing)
+{
+    const auto entries =
+        FtpSync::parse_listing({"D.", "D..", "S", "Dlogs", "Fparams.txt\t42", "Fsub/file.bin\t7"});
+
+    ASSERT_EQ(entries.size(), 3);
+    EXPECT_EQ(entries[0].name, "logs");
+    EXPECT_TRUE(entries[0].is_directory);
+    EXPECT_EQ(entries[1].name, "params.txt");
+    EXPECT_FALSE(entries[1].is_directory);
+    EXPECT_EQ(entries[1].size, 42);
+    // Our own server lists the path relative to its root.
+    EXPECT_EQ(entries[2].name, "file.bin");
+    EXPECT_EQ(entries[2].size, 7);
+}
+
+TEST(FtpSync, DownloadsMissingAndChangedFiles)
+{
+    const auto local_dir = create_tmp_directory("mavsdk-ftp-sync-test");
+    ASSERT_TRUE(local_dir);
+
+    FakeRemote remote;
+    remote.dirs.insert("/data/sub");
+    remote.files["/data/same.txt"] = "same";
+    remote.files["/data/changed.txt"] = "new!";
+    remote.files["/data/sub/missing.bin"] = "missing";
+
+    std::ofstream(*local_dir + path_separator + "same.txt") << "same";
+    std::ofstream(*local_dir + path_separator + "changed.txt") << "old!";
+    std::ofstream(*local_dir + path_separator + "only_local.txt") << "kept";
+
+    const auto result = sync(remote, *local_dir, FtpExt::SyncDirection::Download);
+    EXPECT_EQ(result.result, Ftp::Result::Success);
+    EXPECT_EQ(result.num_results, 1);
+
+    // Same size files are compared, the others are known to differ.
+    EXPECT_EQ(remote.num_compared, 2);
+    EXPECT_EQ(remote.downloaded.size(), 2);
+    EXPECT_EQ(
+        FakeRemote::read(*local_dir + path_separator + "sub" + path_separator + "missing.bin"),
+        "missing");
+    EXPECT_EQ(FakeRemote::read(*local_dir + path_separator + "changed.txt"), "new!");
+    EXPECT_TRUE(fs_exists(*local_dir + path_separator + "only_local.txt"));
+
+    // Both files count towards the same progress.
+    ASSERT_FALSE(result.progress.empty());
+    uint32_t last_bytes_transferred = 0;
+    for (const auto& progress : result.progress) {
+        EXPECT_EQ(progress.total_bytes, 4 + 7);
+        EXPECT_GE(progress.bytes_transferred, last_bytes_transferred);
+        last_bytes_transferred = progress.bytes_transferred;
+    }
+    EXPECT_GT(last_bytes_transferred, 4);
+
+    fs::remove_all(*local_dir);
+}
+
+TEST(FtpSync, UploadCreatesRemoteDirectories)
+{
+    const auto local_dir = create_tmp_directory("mavsdk-ftp-sync-test");
+    ASSERT_TRUE(local_dir);
+    fs::create_directories(fs::path(*local_dir) / "a" / "b");
+    std::ofstream((fs::path(*local_dir) / "a" / "b" / "deep.txt").string()) << "deep";
+    std::ofstream((fs::path(*local_dir) / "top.txt").string()) << "top";
+
+    FakeRemote remote;
+    remote.files["/data/top.txt"] = "top";
+
+    const auto result = sync(remote, *local_dir, FtpExt::SyncDirection::Upload);
+    EXPECT_EQ(result.result, Ftp::Result::Success);
+    EXPECT_EQ(remote.dirs.count("/data/a/b"), 1);
+    ASSERT_EQ(remote.uploaded.size(), 1);
+    EXPECT_EQ(remote.files["/data/a/b/deep.txt"], "deep");
+
+    fs::remove_all(*local_dir);
+}
+
+TEST(FtpSync, ReportsFailedTransferOnce)
+{
+    const auto local_dir = create_tmp_directory("mavsdk-ftp-sync-test");
+    ASSERT_TRUE(local_dir);
+
+    FakeRemote remote;
+    remote.files["/data/one.txt"] = "one";
+    remote.files["/data/two.txt"] = "two";
+    remote.fail_transfers = true;
+
+    const auto result = sync(remote, *local_dir, FtpExt::SyncDirection::Download);
+    EXPECT_EQ(result.result, Ftp::Result::Timeout);
+    EXPECT_EQ(result.num_results, 1);
+
+    fs::remove_all(*local_dir);
+}
+
+TEST(FtpSync, UploadOfMissingDirectoryFails)
+{
+    FakeRemote remote;
+    const auto result =
+        sync(remote, "/this/directory/does/not/exist", FtpExt::SyncDirection::Upload);
+    EXPECT_EQ(result.result, Ftp::Result::FileDoesNotExist);
+}
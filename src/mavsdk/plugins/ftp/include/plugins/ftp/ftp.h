@@ -15,6 +15,7 @@
 
 #include "plugin_base.h"
 
+#include "awaitable.h"
 #include "handle.h"
 
 namespace mavsdk {
@@ -116,7 +117,24 @@ public:
      *
      * This function is non-blocking.
      */
-    void reset_async(const ResultCallback callback);
+    void reset_async(const ResultCallback& callback);
+
+#ifdef MAVSDK_HAS_COROUTINES
+    /**
+     * @brief Awaitable version of 'reset_async' for C++20 coroutines.
+     *
+     * The coroutine is resumed using the executor if one is given, otherwise on the callback
+     * thread.
+     */
+    Awaitable<ResultCallback> reset_awaitable(Executor executor = {})
+    {
+        return Awaitable<ResultCallback>(
+            [=, this](const ResultCallback& callback) {
+                reset_async(callback);
+            },
+            std::move(executor));
+    }
+#endif
 
     /**
      * @brief Callback type for download_async.
@@ -127,7 +145,9 @@ public:
      * @brief Downloads a file to local directory.
      */
     void download_async(
-        std::string remote_file_path, std::string local_dir, const DownloadCallback& callback);
+        const std::string& remote_file_path,
+        const std::string& local_dir,
+        const DownloadCallback& callback);
 
     /**
      * @brief Callback type for upload_async.
@@ -138,7 +158,9 @@ public:
      * @brief Uploads local file to remote directory.
      */
     void upload_async(
-        std::string local_file_path, std::string remote_dir, const UploadCallback& callback);
+        const std::string& local_file_path,
+        const std::string& remote_dir,
+        const UploadCallback& callback);
 
     /**
      * @brief Callback type for list_directory_async.
@@ -150,7 +172,25 @@ public:
      *
      * This function is non-blocking. See 'list_directory' for the blocking counterpart.
      */
-    void list_directory_async(std::string remote_dir, const ListDirectoryCallback callback);
+    void list_directory_async(const std::string& remote_dir, const ListDirectoryCallback& callback);
+
+#ifdef MAVSDK_HAS_COROUTINES
+    /**
+     * @brief Awaitable version of 'list_directory_async' for C++20 coroutines.
+     *
+     * The coroutine is resumed using the executor if one is given, otherwise on the callback
+     * thread.
+     */
+    Awaitable<ListDirectoryCallback> list_directory_awaitable(
+        const std::string& remote_dir, Executor executor = {})
+    {
+        return Awaitable<ListDirectoryCallback>(
+            [=, this](const ListDirectoryCallback& callback) {
+                list_directory_async(remote_dir, callback);
+            },
+            std::move(executor));
+    }
+#endif
 
     /**
      * @brief Lists items from a remote directory.
@@ -159,14 +199,32 @@ public:
      *
      * @return Result of request.
      */
-    std::pair<Result, std::vector<std::string>> list_directory(std::string remote_dir) const;
+    std::pair<Result, std::vector<std::string>> list_directory(const std::string& remote_dir) const;
 
     /**
      * @brief Creates a remote directory.
      *
      * This function is non-blocking. See 'create_directory' for the blocking counterpart.
      */
-    void create_directory_async(std::string remote_dir, const ResultCallback callback);
+    void create_directory_async(const std::string& remote_dir, const ResultCallback& callback);
+
+#ifdef MAVSDK_HAS_COROUTINES
+    /**
+     * @brief Awaitable version of 'create_directory_async' for C++20 coroutines.
+     *
+     * The coroutine is resumed using the executor if one is given, otherwise on the callback
+     * thread.
+     */
+    Awaitable<ResultCallback> create_directory_awaitable(
+        const std::string& remote_dir, Executor executor = {})
+    {
+        return Awaitable<ResultCallback>(
+            [=, this](const ResultCallback& callback) {
+                create_directory_async(remote_dir, callback);
+            },
+            std::move(executor));
+    }
+#endif
 
     /**
      * @brief Creates a remote directory.
@@ -175,14 +233,32 @@ public:
      *
      * @return Result of request.
      */
-    Result create_directory(std::string remote_dir) const;
+    Result create_directory(const std::string& remote_dir) const;
 
     /**
      * @brief Removes a remote directory.
      *
      * This function is non-blocking. See 'remove_directory' for the blocking counterpart.
      */
-    void remove_directory_async(std::string remote_dir, const ResultCallback callback);
+    void remove_directory_async(const std::string& remote_dir, const ResultCallback& callback);
+
+#ifdef MAVSDK_HAS_COROUTINES
+    /**
+     * @brief Awaitable version of 'remove_directory_async' for C++20 coroutines.
+     *
+     * The coroutine is resumed using the executor if one is given, otherwise on the callback
+     * thread.
+     */
+    Awaitable<ResultCallback> remove_directory_awaitable(
+        const std::string& remote_dir, Executor executor = {})
+    {
+        return Awaitable<ResultCallback>(
+            [=, this](const ResultCallback& callback) {
+                remove_directory_async(remote_dir, callback);
+            },
+            std::move(executor));
+    }
+#endif
 
     /**
      * @brief Removes a remote directory.
@@ -191,14 +267,32 @@ public:
      *
      * @return Result of request.
      */
-    Result remove_directory(std::string remote_dir) const;
+    Result remove_directory(const std::string& remote_dir) const;
 
     /**
      * @brief Removes a remote file.
      *
      * This function is non-blocking. See 'remove_file' for the blocking counterpart.
      */
-    void remove_file_async(std::string remote_file_path, const ResultCallback callback);
+    void remove_file_async(const std::string& remote_file_path, const ResultCallback& callback);
+
+#ifdef MAVSDK_HAS_COROUTINES
+    /**
+     * @brief Awaitable version of 'remove_file_async' for C++20 coroutines.
+     *
+     * The coroutine is resumed using the executor if one is given, otherwise on the callback
+     * thread.
+     */
+    Awaitable<ResultCallback> remove_file_awaitable(
+        const std::string& remote_file_path, Executor executor = {})
+    {
+        return Awaitable<ResultCallback>(
+            [=, this](const ResultCallback& callback) {
+                remove_file_async(remote_file_path, callback);
+            },
+            std::move(executor));
+    }
+#endif
 
     /**
      * @brief Removes a remote file.
@@ -207,7 +301,7 @@ public:
      *
      * @return Result of request.
      */
-    Result remove_file(std::string remote_file_path) const;
+    Result remove_file(const std::string& remote_file_path) const;
 
     /**
      * @brief Renames a remote file or remote directory.
@@ -215,7 +309,29 @@ public:
      * This function is non-blocking. See 'rename' for the blocking counterpart.
      */
     void rename_async(
-        std::string remote_from_path, std::string remote_to_path, const ResultCallback callback);
+        const std::string& remote_from_path,
+        const std::string& remote_to_path,
+        const ResultCallback& callback);
+
+#ifdef MAVSDK_HAS_COROUTINES
+    /**
+     * @brief Awaitable version of 'rename_async' for C++20 coroutines.
+     *
+     * The coroutine is resumed using the executor if one is given, otherwise on the callback
+     * thread.
+     */
+    Awaitable<ResultCallback> rename_awaitable(
+        const std::string& remote_from_path,
+        const std::string& remote_to_path,
+        Executor executor = {})
+    {
+        return Awaitable<ResultCallback>(
+            [=, this](const ResultCallback& callback) {
+                rename_async(remote_from_path, remote_to_path, callback);
+            },
+            std::move(executor));
+    }
+#endif
 
     /**
      * @brief Renames a remote file or remote directory.
@@ -224,7 +340,7 @@ public:
      *
      * @return Result of request.
      */
-    Result rename(std::string remote_from_path, std::string remote_to_path) const;
+    Result rename(const std::string& remote_from_path, const std::string& remote_to_path) const;
 
     /**
      * @brief Callback type for are_files_identical_async.
@@ -237,9 +353,29 @@ public:
      * This function is non-blocking. See 'are_files_identical' for the blocking counterpart.
      */
     void are_files_identical_async(
-        std::string local_file_path,
-        std::string remote_file_path,
-        const AreFilesIdenticalCallback callback);
+        const std::string& local_file_path,
+        const std::string& remote_file_path,
+        const AreFilesIdenticalCallback& callback);
+
+#ifdef MAVSDK_HAS_COROUTINES
+    /**
+     * @brief Awaitable version of 'are_files_identical_async' for C++20 coroutines.
+     *
+     * The coroutine is resumed using the executor if one is given, otherwise on the callback
+     * thread.
+     */
+    Awaitable<AreFilesIdenticalCallback> are_files_identical_awaitable(
+        const std::string& local_file_path,
+        const std::string& remote_file_path,
+        Executor executor = {})
+    {
+        return Awaitable<AreFilesIdenticalCallback>(
+            [=, this](const AreFilesIdenticalCallback& callback) {
+                are_files_identical_async(local_file_path, remote_file_path, callback);
+            },
+            std::move(executor));
+    }
+#endif
 
     /**
      * @brief Compares a local file to a remote file using a CRC32 checksum.
@@ -248,8 +384,8 @@ public:
      *
      * @return Result of request.
      */
-    std::pair<Result, bool>
-    are_files_identical(std::string local_file_path, std::string remote_file_path) const;
+    std::pair<Result, bool> are_files_identical(
+        const std::string& local_file_path, const std::string& remote_file_path) const;
 
     /**
      * @brief Set root directory for MAVLink FTP server.
@@ -258,7 +394,7 @@ public:
      *
      * @return Result of request.
      */
-    Result set_root_directory(std::string root_dir) const;
+    Result set_root_directory(const std::string& root_dir) const;
 
     /**
      * @brief Set target component ID. By default it is the autopilot.
@@ -291,6 +427,9 @@ public:
 private:
     /** @private Underlying implementation, set at instantiation */
     std::unique_ptr<FtpImpl> _impl;
+
+    /** @private Hand-written additions in ftp_ext.h, if any */
+    friend class FtpExt;
 };
 
 } // namespace mavsdk
\ No newline at end of file
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "plugins/ftp/ftp.h"
+
+namespace mavsdk {
+
+class FtpImpl;
+
+/**
+ * @brief Additions to Ftp that are only available in C++.
+ *
+ * Unlike ftp.h, this header is not generated from the proto files,
+ * so the calls here are not available through mavsdk_server.
+ *
+ * It works on the Ftp plugin it is created with, which has to outlive it:
+ *
+ *     ```cpp
+ *     auto ftp = Ftp(system);
+ *     auto ftp_ext = FtpExt(ftp);
+ *     ```
+ *
+ * An interrupted Ftp::download_async() of the same file into the same
+ * directory is resumed, using a <file>.resume file kept next to the partial
+ * download.
+ */
+class FtpExt {
+public:
+    /**
+     * @brief Constructor. Uses the given Ftp plugin.
+     *
+     * @param ftp The plugin, which has to outlive this object.
+     */
+    explicit FtpExt(Ftp& ftp);
+
+    /**
+     * @brief Set how many downloads, uploads, listings and comparisons can run in parallel.
+     *
+     * Each one uses its own session on the server. If the server runs out of sessions, the
+     * number is lowered to what it supports. Default is 4, maximum is 7.
+     *
+     * This function is blocking.
+     *
+     * @return Result of request.
+     */
+    Ftp::Result set_max_sessions(uint32_t max_sessions) const;
+
+    /**
+     * @brief Entry of a remote directory.
+     */
+    struct DirectoryEntry {
+        std::string name{}; /**< @brief Name, without the directory. */
+        bool is_directory{false}; /**< @brief Whether it is a directory, or a file. */
+        uint32_t size{0}; /**< @brief Size in bytes, for files. */
+    };
+
+    /**
+     * @brief Equal operator to compare two `FtpExt::DirectoryEntry` objects.
+     *
+     * @return `true` if items are equal.
+     */
+    friend bool operator==(const FtpExt::DirectoryEntry& lhs, const FtpExt::DirectoryEntry& rhs);
+
+    /**
+     * @brief Stream operator to print information about a `FtpExt::DirectoryEntry`.
+     *
+     * @return A reference to the stream.
+     */
+    friend std::ostream&
+    operator<<(std::ostream& str, FtpExt::DirectoryEntry const& directory_entry);
+
+    /**
+     * @brief Callback type for list_directory_entries_async.
+     */
+    using ListDirectoryEntriesCallback =
+        std::function<void(Ftp::Result, std::vector<DirectoryEntry>)>;
+
+    /**
+     * @brief Lists the files and directories of a remote directory, with their sizes.
+     *
+     * The entries are passed on as they arrive, in order and with Result::Next, which is
+     * useful for directories with many files. The result comes last, without entries.
+     * Skipped entries, "." and ".." are left out.
+     *
+     * This function is non-blocking.
+     */
+    void list_directory_entries_async(
+        const std::string& remote_dir, const ListDirectoryEntriesCallback& callback);
+
+    /**
+     * @brief Which way a directory is synced.
+     */
+    enum class SyncDirection {
+        Download, /**< @brief Make the local directory match the remote one. */
+        Upload, /**< @brief Make the remote directory match the local one. */
+    };
+
+    /**
+     * @brief Stream operator to print information about a `FtpExt::SyncDirection`.
+     *
+     * @return A reference to the stream.
+     */
+    friend std::ostream& operator<<(std::ostream& str, FtpExt::SyncDirection const& sync_direction);
+
+    /**
+     * @brief Callback type for sync_directory_async.
+     */
+    using SyncDirectoryCallback = std::function<void(Ftp::Result, Ftp::ProgressData)>;
+
+    /**
+     * @brief Syncs a directory tree between the remote and the local side.
+     *
+     * The tree is walked with concurrent listings. Files that are missing or differ on the
+     * destination are transferred, and files with the same size are compared by CRC32 first.
+     * Transfers run over several sessions, and the progress is reported for all of them
+     * together. Files that exist only on the destination are kept.
+     *
+     * This function is non-blocking.
+     */
+    void sync_directory_async(
+        const std::string& remote_dir,
+        const std::string& local_dir,
+        SyncDirection direction,
+        const SyncDirectoryCallback& callback);
+
+    /**
+     * @brief Enable or disable compressed downloads, disabled by default.
+     *
+     * If the other side runs MAVSDK as well, files are then transferred xz
+     * compressed, which is a lot faster for text, logs and JSON over a slow
+     * link. Other servers don't support it, and downloads from them fall back
+     * to the standard protocol. Progress is reported in compressed bytes.
+     *
+     * This function is blocking.
+     *
+     * @return Unsupported if MAVSDK is built without liblzma.
+     */
+    Ftp::Result set_compression_enabled(bool enabled) const;
+
+private:
+    FtpImpl& _impl;
+};
+
+} // namespace mavsdk
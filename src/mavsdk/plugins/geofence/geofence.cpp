@@ -23,17 +23,18 @@ Geofence::Geofence(std::shared_ptr<System> system) :
 
 Geofence::~Geofence() {}
 
-void Geofence::upload_geofence_async(GeofenceData geofence_data, const ResultCallback callback)
+void Geofence::upload_geofence_async(
+    const GeofenceData& geofence_data, const ResultCallback& callback)
 {
     _impl->upload_geofence_async(geofence_data, callback);
 }
 
-Geofence::Result Geofence::upload_geofence(GeofenceData geofence_data) const
+Geofence::Result Geofence::upload_geofence(const GeofenceData& geofence_data) const
 {
     return _impl->upload_geofence(geofence_data);
 }
 
-void Geofence::clear_geofence_async(const ResultCallback callback)
+void Geofence::clear_geofence_async(const ResultCallback& callback)
 {
     _impl->clear_geofence_async(callback);
 }
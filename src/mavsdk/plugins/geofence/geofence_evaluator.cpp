@@ -0,0 +1,379 @@
+#include "plugins/geofence/geofence_evaluator.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace mavsdk {
+
+namespace {
+
+// Smaller cells wouldn't save anything for fences of a few meters.
+constexpr double min_cell_size_m = 1.0;
+
+double cross(double ax, double ay, double bx, double by)
+{
+    return ax * by - ay * bx;
+}
+
+} // namespace
+
+GeofenceEvaluator::GeofenceEvaluator(const Geofence::GeofenceData& geofence_data) :
+    _transformation(reference_of(geofence_data))
+{
+    for (const auto& polygon : geofence_data.polygons) {
+        add_polygon(polygon);
+    }
+    for (const auto& circle : geofence_data.circles) {
+        add_circle(circle);
+    }
+
+    build_grid();
+}
+
+bool GeofenceEvaluator::is_allowed(const Geofence::Point& point) const
+{
+    return is_allowed_local(local(point));
+}
+
+void GeofenceEvaluator::is_allowed(
+    const std::vector<Geofence::Point>& points, std::vector<bool>& allowed) const
+{
+    geometry::CoordinateTransformation::GlobalCoordinates global;
+    global.latitude_deg.reserve(points.size());
+    global.longitude_deg.reserve(points.size());
+    for (const auto& point : points) {
+        global.latitude_deg.push_back(point.latitude_deg);
+        global.longitude_deg.push_back(point.longitude_deg);
+    }
+
+    geometry::CoordinateTransformation::LocalCoordinates local_coordinates;
+    _transformation.local_from_global(global, local_coordinates);
+
+    allowed.resize(points.size());
+    for (size_t i = 0; i < points.size(); ++i) {
+        allowed[i] =
+            is_allowed_local(Vector2{local_coordinates.east_m[i], local_coordinates.north_m[i]});
+    }
+}
+
+bool GeofenceEvaluator::is_allowed(const Geofence::Point& from, const Geofence::Point& to) const
+{
+    const auto start = local(from);
+    const auto end = local(to);
+    const Vector2 delta{end.x - start.x, end.y - start.y};
+
+    const Box segment_box{
+        {std::min(start.x, end.x), std::min(start.y, end.y)},
+        {std::max(start.x, end.x), std::max(start.y, end.y)}};
+
+    // The line only changes between allowed and not where it crosses a fence,
+    // so checking the ends, and one position between each crossing, covers
+    // all of it.
+    std::vector<double> crossings{0.0, 1.0};
+
+    for (const auto& fence : _fences) {
+        if (segment_box.max.x < fence.box.min.x || segment_box.min.x > fence.box.max.x ||
+            segment_box.max.y < fence.box.min.y || segment_box.min.y > fence.box.max.y) {
+            continue;
+        }
+
+        if (!fence.edges.empty()) {
+            for (const auto& edge : fence.edges) {
+                const double denominator = cross(delta.x, delta.y, edge.delta.x, edge.delta.y);
+                if (denominator == 0.0) {
+                    continue;
+                }
+                const double dx = edge.from.x - start.x;
+                const double dy = edge.from.y - start.y;
+                const double t = cross(dx, dy, edge.delta.x, edge.delta.y) / denominator;
+                const double u = cross(dx, dy, delta.x, delta.y) / denominator;
+                if (t > 0.0 && t < 1.0 && u >= 0.0 && u <= 1.0) {
+                    crossings.push_back(t);
+                }
+            }
+        } else {
+            // Where |start + t * delta - center| equals the radius.
+            const double fx = start.x - fence.center.x;
+            const double fy = start.y - fence.center.y;
+            const double a = delta.x * delta.x + delta.y * delta.y;
+            const double b = 2.0 * (fx * delta.x + fy * delta.y);
+            const double c = fx * fx + fy * fy - fence.radius_sq;
+            const double discriminant = b * b - 4.0 * a * c;
+            if (a == 0.0 || discriminant < 0.0) {
+                continue;
+            }
+            const double root = std::sqrt(discriminant);
+            for (const double t : {(-b - root) / (2.0 * a), (-b + root) / (2.0 * a)}) {
+                if (t > 0.0 && t < 1.0) {
+                    crossings.push_back(t);
+                }
+            }
+        }
+    }
+
+    std::sort(crossings.begin(), crossings.end());
+
+    for (size_t i = 0; i < crossings.size(); ++i) {
+        const double t = crossings[i];
+        if (!is_allowed_local(Vector2{start.x + t * delta.x, start.y + t * delta.y})) {
+            return false;
+        }
+        if (i + 1 < crossings.size()) {
+            const double mid = (t + crossings[i + 1]) / 2.0;
+            if (!is_allowed_local(Vector2{start.x + mid * delta.x, start.y + mid * delta.y})) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+GeofenceEvaluator::Vector2 GeofenceEvaluator::local(const Geofence::Point& point) const
+{
+    const auto local_coordinate =
+        _transformation.local_from_global({point.latitude_deg, point.longitude_deg});
+    return Vector2{local_coordinate.east_m, local_coordinate.north_m};
+}
+
+bool GeofenceEvaluator::is_allowed_local(const Vector2& point) const
+{
+    uint32_t column = 0;
+    uint32_t row = 0;
+    if (!cell_of(point, column, row)) {
+        // Outside of all fences.
+        return !_has_inclusion;
+    }
+
+    const auto center = cell_center(column, row);
+
+    bool included = false;
+    for (const auto& cell_fence : _cells[row * _grid_columns + column]) {
+        if (!is_inside(cell_fence, center, point)) {
+            continue;
+        }
+        if (!_fences[cell_fence.fence_index].inclusion) {
+            return false;
+        }
+        included = true;
+    }
+
+    return included || !_has_inclusion;
+}
+
+bool GeofenceEvaluator::is_inside(const Fence& fence, const Vector2& point) const
+{
+    if (fence.edges.empty()) {
+        const double dx = point.x - fence.center.x;
+        const double dy = point.y - fence.center.y;
+        return dx * dx + dy * dy <= fence.radius_sq;
+    }
+
+    // From a position outside of the fence, every edge crossed means going
+    // in or out.
+    const Vector2 outside{fence.box.min.x - 1.0, point.y};
+    bool inside = false;
+    for (const auto& edge : fence.edges) {
+        if (crosses(outside, point, edge)) {
+            inside = !inside;
+        }
+    }
+    return inside;
+}
+
+bool GeofenceEvaluator::is_inside(
+    const CellFence& cell_fence, const Vector2& cell_center, const Vector2& point) const
+{
+    const auto& fence = _fences[cell_fence.fence_index];
+    if (fence.edges.empty()) {
+        return is_inside(fence, point);
+    }
+
+    // Any edge between the center and the position crosses the cell, as the
+    // cell is convex.
+    bool inside = cell_fence.center_inside;
+    for (const auto edge_index : cell_fence.edge_indices) {
+        if (crosses(cell_center, point, fence.edges[edge_index])) {
+            inside = !inside;
+        }
+    }
+    return inside;
+}
+
+bool GeofenceEvaluator::cell_of(const Vector2& point, uint32_t& column, uint32_t& row) const
+{
+    if (_cells.empty() || point.x < _grid_box.min.x || point.y < _grid_box.min.y ||
+        point.x > _grid_box.max.x || point.y > _grid_box.max.y) {
+        return false;
+    }
+
+    column = std::min(
+        static_cast<uint32_t>((point.x - _grid_box.min.x) / _cell_size_m), _grid_columns - 1);
+    row = std::min(
+        static_cast<uint32_t>((point.y - _grid_box.min.y) / _cell_size_m), _grid_rows - 1);
+    return true;
+}
+
+GeofenceEvaluator::Vector2 GeofenceEvaluator::cell_center(uint32_t column, uint32_t row) const
+{
+    return Vector2{
+        _grid_box.min.x + (column + 0.5) * _cell_size_m,
+        _grid_box.min.y + (row + 0.5) * _cell_size_m};
+}
+
+geometry::CoordinateTransformation::GlobalCoordinate
+GeofenceEvaluator::reference_of(const Geofence::GeofenceData& geofence_data)
+{
+    // Any position of the fences will do, they are not spread far enough for
+    // the projection to matter.
+    for (const auto& polygon : geofence_data.polygons) {
+        if (!polygon.points.empty()) {
+            return {polygon.points.front().latitude_deg, polygon.points.front().longitude_deg};
+        }
+    }
+    for (const auto& circle : geofence_data.circles) {
+        return {circle.point.latitude_deg, circle.point.longitude_deg};
+    }
+    return {0.0, 0.0};
+}
+
+void GeofenceEvaluator::add_polygon(const Geofence::Polygon& polygon)
+{
+    if (polygon.points.size() < 3) {
+        return;
+    }
+
+    Fence fence;
+    fence.inclusion = polygon.fence_type == Geofence::FenceType::Inclusion;
+
+    std::vector<Vector2> vertices;
+    vertices.reserve(polygon.points.size());
+    for (const auto& point : polygon.points) {
+        vertices.push_back(local(point));
+    }
+
+    fence.box = Box{vertices.front(), vertices.front()};
+    fence.edges.reserve(vertices.size());
+    for (size_t i = 0; i < vertices.size(); ++i) {
+        const auto& from = vertices[i];
+        const auto& to = vertices[(i + 1) % vertices.size()];
+        fence.edges.push_back(Edge{from, Vector2{to.x - from.x, to.y - from.y}});
+
+        fence.box.min.x = std::min(fence.box.min.x, from.x);
+        fence.box.min.y = std::min(fence.box.min.y, from.y);
+        fence.box.max.x = std::max(fence.box.max.x, from.x);
+        fence.box.max.y = std::max(fence.box.max.y, from.y);
+    }
+
+    _has_inclusion = _has_inclusion || fence.inclusion;
+    _fences.push_back(std::move(fence));
+}
+
+void GeofenceEvaluator::add_circle(const Geofence::Circle& circle)
+{
+    if (!(circle.radius > 0.0f)) {
+        return;
+    }
+
+    Fence fence;
+    fence.inclusion = circle.fence_type == Geofence::FenceType::Inclusion;
+    fence.center = local(circle.point);
+    const double radius = static_cast<double>(circle.radius);
+    fence.radius_sq = radius * radius;
+    fence.box = Box{
+        {fence.center.x - radius, fence.center.y - radius},
+        {fence.center.x + radius, fence.center.y + radius}};
+
+    _has_inclusion = _has_inclusion || fence.inclusion;
+    _fences.push_back(std::move(fence));
+}
+
+void GeofenceEvaluator::build_grid()
+{
+    if (_fences.empty()) {
+        return;
+    }
+
+    _grid_box = _fences.front().box;
+    for (const auto& fence : _fences) {
+        _grid_box.min.x = std::min(_grid_box.min.x, fence.box.min.x);
+        _grid_box.min.y = std::min(_grid_box.min.y, fence.box.min.y);
+        _grid_box.max.x = std::max(_grid_box.max.x, fence.box.max.x);
+        _grid_box.max.y = std::max(_grid_box.max.y, fence.box.max.y);
+    }
+
+    const double width = _grid_box.max.x - _grid_box.min.x;
+    const double height = _grid_box.max.y - _grid_box.min.y;
+    _cell_size_m = std::max(std::max(width, height) / max_grid_cells_per_side, min_cell_size_m);
+    _grid_columns = std::max(static_cast<uint32_t>(std::ceil(width / _cell_size_m)), 1u);
+    _grid_rows = std::max(static_cast<uint32_t>(std::ceil(height / _cell_size_m)), 1u);
+    _cells.resize(static_cast<size_t>(_grid_columns) * _grid_rows);
+
+    for (uint32_t fence_index = 0; fence_index < _fences.size(); ++fence_index) {
+        const auto& fence = _fences[fence_index];
+
+        uint32_t first_column = 0;
+        uint32_t first_row = 0;
+        uint32_t last_column = 0;
+        uint32_t last_row = 0;
+        (void)cell_of(fence.box.min, first_column, first_row);
+        (void)cell_of(fence.box.max, last_column, last_row);
+
+        for (uint32_t row = first_row; row <= last_row; ++row) {
+            for (uint32_t column = first_column; column <= last_column; ++column) {
+                CellFence cell_fence;
+                cell_fence.fence_index = fence_index;
+
+                if (!fence.edges.empty()) {
+                    const auto center = cell_center(column, row);
+                    const double half = _cell_size_m / 2.0;
+                    const Box cell_box{
+                        {center.x - half, center.y - half}, {center.x + half, center.y + half}};
+
+                    for (uint32_t i = 0; i < fence.edges.size(); ++i) {
+                        const auto& edge = fence.edges[i];
+                        const double min_x = std::min(edge.from.x, edge.from.x + edge.delta.x);
+                        const double max_x = std::max(edge.from.x, edge.from.x + edge.delta.x);
+                        const double min_y = std::min(edge.from.y, edge.from.y + edge.delta.y);
+                        const double max_y = std::max(edge.from.y, edge.from.y + edge.delta.y);
+                        if (max_x >= cell_box.min.x && min_x <= cell_box.max.x &&
+                            max_y >= cell_box.min.y && min_y <= cell_box.max.y) {
+                            cell_fence.edge_indices.push_back(i);
+                        }
+                    }
+
+                    cell_fence.center_inside = is_inside(fence, center);
+
+                    // Entirely outside, nothing to check.
+                    if (!cell_fence.center_inside && cell_fence.edge_indices.empty()) {
+                        continue;
+                    }
+                }
+
+                _cells[row * _grid_columns + column].push_back(std::move(cell_fence));
+            }
+        }
+    }
+}
+
+bool GeofenceEvaluator::crosses(const Vector2& from, const Vector2& to, const Edge& edge)
+{
+    // Positions exactly on a line count as being on one side of it, so that
+    // passing through a vertex crosses exactly one of its two edges.
+    const Vector2 edge_to{edge.from.x + edge.delta.x, edge.from.y + edge.delta.y};
+    const double dx = to.x - from.x;
+    const double dy = to.y - from.y;
+
+    const bool edge_from_side = cross(dx, dy, edge.from.x - from.x, edge.from.y - from.y) > 0.0;
+    const bool edge_to_side = cross(dx, dy, edge_to.x - from.x, edge_to.y - from.y) > 0.0;
+    if (edge_from_side == edge_to_side) {
+        return false;
+    }
+
+    const bool from_side =
+        cross(edge.delta.x, edge.delta.y, from.x - edge.from.x, from.y - edge.from.y) > 0.0;
+    const bool to_side =
+        cross(edge.delta.x, edge.delta.y, to.x - edge.from.x, to.y - edge.from.y) > 0.0;
+    return from_side != to_side;
+}
+
+} // namespace mavsdk
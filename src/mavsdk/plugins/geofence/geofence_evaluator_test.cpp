@@ -0,0 +1,173 @@
+#include "plugins/geofence/geofence_evaluator.h"
+#include "geometry.h"
+
+#include <cmath>
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+
+using namespace mavsdk;
+
+namespace {
+
+const geometry::CoordinateTransformation transformation{{47.3977, 8.5456}};
+
+Geofence::Point point_at(double north_m, double east_m)
+{
+    const auto global = transformation.global_from_local({north_m, east_m});
+    return Geofence::Point{global.latitude_deg, global.longitude_deg};
+}
+
+Geofence::Polygon
+square(double center_north_m, double center_east_m, double half_m, Geofence::FenceType type)
+{
+    Geofence::Polygon polygon;
+    polygon.fence_type = type;
+    polygon.points = {
+        point_at(center_north_m - half_m, center_east_m - half_m),
+        point_at(center_north_m - half_m, center_east_m + half_m),
+        point_at(center_north_m + half_m, center_east_m + half_m),
+        point_at(center_north_m + half_m, center_east_m - half_m)};
+    return polygon;
+}
+
+bool is_in_triangle(double north_m, double east_m)
+{
+    // The triangle of BatchMatchesSingleChecks as east/north, clockwise.
+    const double vertices[3][2] = {{300.0, 300.0}, {350.0, 700.0}, {800.0, 400.0}};
+    for (int i = 0; i < 3; ++i) {
+        const auto& from = vertices[i];
+        const auto& to = vertices[(i + 1) % 3];
+        const double side =
+            (to[0] - from[0]) * (north_m - from[1]) - (to[1] - from[1]) * (east_m - from[0]);
+        if (side > 0.0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+TEST(GeofenceEvaluator, AllowsEverythingWithoutFences)
+{
+    const GeofenceEvaluator evaluator{Geofence::GeofenceData{}};
+    EXPECT_TRUE(evaluator.is_allowed(point_at(0.0, 0.0)));
+    EXPECT_TRUE(evaluator.is_allowed(point_at(0.0, 0.0), point_at(1000.0, 1000.0)));
+}
+
+TEST(GeofenceEvaluator, ChecksInclusionPolygon)
+{
+    Geofence::GeofenceData data;
+    data.polygons.push_back(square(0.0, 0.0, 100.0, Geofence::FenceType::Inclusion));
+    const GeofenceEvaluator evaluator{data};
+
+    EXPECT_TRUE(evaluator.is_allowed(point_at(0.0, 0.0)));
+    EXPECT_TRUE(evaluator.is_allowed(point_at(99.0, -99.0)));
+    EXPECT_FALSE(evaluator.is_allowed(point_at(101.0, 0.0)));
+    EXPECT_FALSE(evaluator.is_allowed(point_at(0.0, -5000.0)));
+}
+
+TEST(GeofenceEvaluator, ChecksExclusionInsideInclusion)
+{
+    Geofence::GeofenceData data;
+    data.polygons.push_back(square(0.0, 0.0, 1000.0, Geofence::FenceType::Inclusion));
+    data.polygons.push_back(square(200.0, 200.0, 50.0, Geofence::FenceType::Exclusion));
+
+    Geofence::Circle circle;
+    circle.point = point_at(-300.0, -300.0);
+    circle.radius = 100.0f;
+    circle.fence_type = Geofence::FenceType::Exclusion;
+    data.circles.push_back(circle);
+
+    const GeofenceEvaluator evaluator{data};
+
+    EXPECT_TRUE(evaluator.is_allowed(point_at(0.0, 0.0)));
+    EXPECT_FALSE(evaluator.is_allowed(point_at(200.0, 200.0)));
+    EXPECT_TRUE(evaluator.is_allowed(point_at(260.0, 200.0)));
+    EXPECT_FALSE(evaluator.is_allowed(point_at(-350.0, -300.0)));
+    EXPECT_TRUE(evaluator.is_allowed(point_at(-300.0, -190.0)));
+}
+
+TEST(GeofenceEvaluator, ChecksConcavePolygon)
+{
+    // A U shape, open to the north.
+    Geofence::GeofenceData data;
+    Geofence::Polygon polygon;
+    polygon.fence_type = Geofence::FenceType::Inclusion;
+    polygon.points = {
+        point_at(0.0, 0.0),
+        point_at(0.0, 300.0),
+        point_at(300.0, 300.0),
+        point_at(300.0, 200.0),
+        point_at(100.0, 200.0),
+        point_at(100.0, 100.0),
+        point_at(300.0, 100.0),
+        point_at(300.0, 0.0)};
+    data.polygons.push_back(polygon);
+    const GeofenceEvaluator evaluator{data};
+
+    EXPECT_TRUE(evaluator.is_allowed(point_at(50.0, 150.0)));
+    EXPECT_TRUE(evaluator.is_allowed(point_at(250.0, 50.0)));
+    EXPECT_TRUE(evaluator.is_allowed(point_at(250.0, 250.0)));
+    EXPECT_FALSE(evaluator.is_allowed(point_at(250.0, 150.0)));
+
+    // Both ends are inside, but the line leaves the fence in between.
+    EXPECT_FALSE(evaluator.is_allowed(point_at(250.0, 50.0), point_at(250.0, 250.0)));
+    // Going around the notch instead.
+    EXPECT_TRUE(evaluator.is_allowed(point_at(250.0, 50.0), point_at(50.0, 50.0)));
+    EXPECT_TRUE(evaluator.is_allowed(point_at(50.0, 50.0), point_at(50.0, 250.0)));
+    EXPECT_TRUE(evaluator.is_allowed(point_at(50.0, 250.0), point_at(250.0, 250.0)));
+}
+
+TEST(GeofenceEvaluator, ChecksLineThroughCircle)
+{
+    Geofence::GeofenceData data;
+    Geofence::Circle circle;
+    circle.point = point_at(0.0, 0.0);
+    circle.radius = 50.0f;
+    circle.fence_type = Geofence::FenceType::Exclusion;
+    data.circles.push_back(circle);
+    const GeofenceEvaluator evaluator{data};
+
+    EXPECT_FALSE(evaluator.is_allowed(point_at(-100.0, 10.0), point_at(100.0, 10.0)));
+    EXPECT_TRUE(evaluator.is_allowed(point_at(-100.0, 60.0), point_at(100.0, 60.0)));
+}
+
+TEST(GeofenceEvaluator, BatchMatchesSingleChecks)
+{
+    Geofence::GeofenceData data;
+    data.polygons.push_back(square(0.0, 0.0, 1000.0, Geofence::FenceType::Inclusion));
+    data.polygons.push_back(square(100.0, -300.0, 200.0, Geofence::FenceType::Exclusion));
+
+    Geofence::Polygon triangle;
+    triangle.fence_type = Geofence::FenceType::Exclusion;
+    triangle.points = {point_at(300.0, 300.0), point_at(700.0, 350.0), point_at(400.0, 800.0)};
+    data.polygons.push_back(triangle);
+
+    const GeofenceEvaluator evaluator{data};
+
+    std::mt19937 generator{42};
+    std::uniform_real_distribution<double> distribution{-1200.0, 1200.0};
+    std::vector<Geofence::Point> points;
+    std::vector<bool> expected;
+    for (int i = 0; i < 2000; ++i) {
+        const double north_m = distribution(generator);
+        const double east_m = distribution(generator);
+        points.push_back(point_at(north_m, east_m));
+
+        const bool in_inclusion = std::abs(north_m) <= 1000.0 && std::abs(east_m) <= 1000.0;
+        const bool in_square =
+            std::abs(north_m - 100.0) <= 200.0 && std::abs(east_m + 300.0) <= 200.0;
+        expected.push_back(in_inclusion && !in_square && !is_in_triangle(north_m, east_m));
+    }
+
+    std::vector<bool> allowed;
+    evaluator.is_allowed(points, allowed);
+    ASSERT_EQ(allowed.size(), points.size());
+
+    for (size_t i = 0; i < points.size(); ++i) {
+        EXPECT_EQ(allowed[i], expected[i]) << "at " << i;
+        EXPECT_EQ(allowed[i], evaluator.is_allowed(points[i])) << "at " << i;
+    }
+}
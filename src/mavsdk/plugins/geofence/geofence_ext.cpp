@@ -0,0 +1,13 @@
+#include "geofence_impl.h"
+#include "plugins/geofence/geofence_ext.h"
+
+namespace mavsdk {
+
+GeofenceExt::GeofenceExt(Geofence& geofence) : _impl(*geofence._impl) {}
+
+std::shared_ptr<const GeofenceEvaluator> GeofenceExt::geofence_evaluator() const
+{
+    return _impl.geofence_evaluator();
+}
+
+} // namespace mavsdk
@@ -40,12 +40,19 @@ Geofence::Result GeofenceImpl::upload_geofence(const Geofence::GeofenceData& geo
 void GeofenceImpl::upload_geofence_async(
     const Geofence::GeofenceData& geofence_data, const Geofence::ResultCallback& callback)
 {
-    // We can just create these items on the stack because they get copied
-    // later in the MavlinkMissionTransfer constructor.
-    const auto items = assemble_items(geofence_data);
+    // Moved along to where they are sent.
+    auto items = assemble_items(geofence_data);
+
+    // Indexed up front, so the fence can be checked as soon as it is active.
+    auto evaluator = std::make_shared<const GeofenceEvaluator>(geofence_data);
 
     _system_impl->mission_transfer().upload_items_async(
-        MAV_MISSION_TYPE_FENCE, items, [this, callback](MavlinkMissionTransfer::Result result) {
+        MAV_MISSION_TYPE_FENCE,
+        std::move(items),
+        [this, callback, evaluator](MavlinkMissionTransfer::Result result) {
+            if (result == MavlinkMissionTransfer::Result::Success) {
+                set_geofence_evaluator(evaluator);
+            }
             auto converted_result = convert_result(result);
             _system_impl->call_user_callback(
                 [callback, converted_result]() { callback(converted_result); });
@@ -65,6 +72,10 @@ void GeofenceImpl::clear_geofence_async(const Geofence::ResultCallback& callback
 {
     _system_impl->mission_transfer().clear_items_async(
         MAV_MISSION_TYPE_FENCE, [this, callback](MavlinkMissionTransfer::Result result) {
+            if (result == MavlinkMissionTransfer::Result::Success) {
+                set_geofence_evaluator(
+                    std::make_shared<const GeofenceEvaluator>(Geofence::GeofenceData{}));
+            }
             auto converted_result = convert_result(result);
             _system_impl->call_user_callback([callback, converted_result]() {
                 if (callback) {
@@ -74,6 +85,18 @@ void GeofenceImpl::clear_geofence_async(const Geofence::ResultCallback& callback
         });
 }
 
+std::shared_ptr<const GeofenceEvaluator> GeofenceImpl::geofence_evaluator() const
+{
+    std::lock_guard<std::mutex> lock(_geofence_evaluator_mutex);
+    return _geofence_evaluator;
+}
+
+void GeofenceImpl::set_geofence_evaluator(std::shared_ptr<const GeofenceEvaluator> evaluator)
+{
+    std::lock_guard<std::mutex> lock(_geofence_evaluator_mutex);
+    _geofence_evaluator = std::move(evaluator);
+}
+
 std::vector<MavlinkMissionTransfer::ItemInt>
 GeofenceImpl::assemble_items(const Geofence::GeofenceData& geofence_data)
 {
@@ -3,9 +3,11 @@
 #include <memory>
 #include <map>
 #include <atomic>
+#include <mutex>
 
 #include "mavlink_include.h"
 #include "plugins/geofence/geofence.h"
+#include "plugins/geofence/geofence_evaluator.h"
 #include "plugin_impl_base.h"
 #include "system.h"
 
@@ -32,6 +34,8 @@ public:
 
     void clear_geofence_async(const Geofence::ResultCallback& callback);
 
+    std::shared_ptr<const GeofenceEvaluator> geofence_evaluator() const;
+
     // Non-copyable
     GeofenceImpl(const GeofenceImpl&) = delete;
     const GeofenceImpl& operator=(const GeofenceImpl&) = delete;
@@ -41,6 +45,12 @@ private:
     assemble_items(const Geofence::GeofenceData& geofence_data);
 
     static Geofence::Result convert_result(MavlinkMissionTransfer::Result result);
+
+    void set_geofence_evaluator(std::shared_ptr<const GeofenceEvaluator> evaluator);
+
+    mutable std::mutex _geofence_evaluator_mutex{};
+    // Needs _geofence_evaluator_mutex, replaced once an upload succeeded.
+    std::shared_ptr<const GeofenceEvaluator> _geofence_evaluator{};
 };
 
 } // namespace mavsdk
@@ -15,6 +15,7 @@
 
 #include "plugin_base.h"
 
+#include "awaitable.h"
 #include "handle.h"
 
 namespace mavsdk {
@@ -196,7 +197,25 @@ public:
      *
      * This function is non-blocking. See 'upload_geofence' for the blocking counterpart.
      */
-    void upload_geofence_async(GeofenceData geofence_data, const ResultCallback callback);
+    void upload_geofence_async(const GeofenceData& geofence_data, const ResultCallback& callback);
+
+#ifdef MAVSDK_HAS_COROUTINES
+    /**
+     * @brief Awaitable version of 'upload_geofence_async' for C++20 coroutines.
+     *
+     * The coroutine is resumed using the executor if one is given, otherwise on the callback
+     * thread.
+     */
+    Awaitable<ResultCallback> upload_geofence_awaitable(
+        const GeofenceData& geofence_data, Executor executor = {})
+    {
+        return Awaitable<ResultCallback>(
+            [=, this](const ResultCallback& callback) {
+                upload_geofence_async(geofence_data, callback);
+            },
+            std::move(executor));
+    }
+#endif
 
     /**
      * @brief Upload geofences.
@@ -208,14 +227,31 @@ public:
      *
      * @return Result of request.
      */
-    Result upload_geofence(GeofenceData geofence_data) const;
+    Result upload_geofence(const GeofenceData& geofence_data) const;
 
     /**
      * @brief Clear all geofences saved on the vehicle.
      *
      * This function is non-blocking. See 'clear_geofence' for the blocking counterpart.
      */
-    void clear_geofence_async(const ResultCallback callback);
+    void clear_geofence_async(const ResultCallback& callback);
+
+#ifdef MAVSDK_HAS_COROUTINES
+    /**
+     * @brief Awaitable version of 'clear_geofence_async' for C++20 coroutines.
+     *
+     * The coroutine is resumed using the executor if one is given, otherwise on the callback
+     * thread.
+     */
+    Awaitable<ResultCallback> clear_geofence_awaitable(Executor executor = {})
+    {
+        return Awaitable<ResultCallback>(
+            [=, this](const ResultCallback& callback) {
+                clear_geofence_async(callback);
+            },
+            std::move(executor));
+    }
+#endif
 
     /**
      * @brief Clear all geofences saved on the vehicle.
@@ -239,6 +275,9 @@ public:
 private:
     /** @private Underlying implementation, set at instantiation */
     std::unique_ptr<GeofenceImpl> _impl;
+
+    /** @private Hand-written additions in geofence_ext.h, if any */
+    friend class GeofenceExt;
 };
 
 } // namespace mavsdk
\ No newline at end of file
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "geometry.h"
+#include "plugins/geofence/geofence.h"
+
+namespace mavsdk {
+
+/**
+ * @brief Checks positions and paths against geofences locally, e.g. for a
+ * whole fleet on every update.
+ *
+ * A position is allowed if it is inside any of the inclusion fences, or if
+ * there are none, and outside of all exclusion fences, the same way the
+ * autopilot evaluates them.
+ *
+ * The fences are indexed on a grid once, so that a check usually only looks
+ * at the few polygon edges near the position rather than at all of them.
+ * An evaluator does not change after construction, so it can be used from
+ * several threads at once.
+ */
+class GeofenceEvaluator {
+public:
+    /**
+     * @brief Constructor, indexes the fences.
+     *
+     * @param geofence_data The polygons and circles to check against.
+     */
+    explicit GeofenceEvaluator(const Geofence::GeofenceData& geofence_data);
+
+    /**
+     * @brief Destructor.
+     */
+    ~GeofenceEvaluator() = default;
+
+    /**
+     * @brief Check whether a position is allowed.
+     *
+     * @param point The position to check.
+     * @return `true` if the position is allowed.
+     */
+    [[nodiscard]] bool is_allowed(const Geofence::Point& point) const;
+
+    /**
+     * @brief Check whether many positions are allowed at once.
+     *
+     * This is faster than checking one position after the other, e.g. for
+     * all vehicles of a fleet, and the results are the same.
+     *
+     * @param points The positions to check.
+     * @param allowed Whether each position is allowed, resized as needed.
+     */
+    void is_allowed(const std::vector<Geofence::Point>& points, std::vector<bool>& allowed) const;
+
+    /**
+     * @brief Check whether all of the straight line between two positions
+     * is allowed, e.g. for a leg of a planned path.
+     *
+     * @param from The start of the line.
+     * @param to The end of the line.
+     * @return `true` if all of the line is allowed.
+     */
+    [[nodiscard]] bool is_allowed(const Geofence::Point& from, const Geofence::Point& to) const;
+
+private:
+    struct Vector2 {
+        double x{0.0};
+        double y{0.0};
+    };
+
+    struct Box {
+        Vector2 min{};
+        Vector2 max{};
+    };
+
+    struct Edge {
+        Vector2 from{};
+        // The vector from the start to the end of the edge.
+        Vector2 delta{};
+    };
+
+    struct Fence {
+        bool inclusion{false};
+        Box box{};
+        // For polygons, empty for circles
+        std::vector<Edge> edges{};
+        // For circles
+        Vector2 center{};
+        double radius_sq{0.0};
+    };
+
+    // What a grid cell knows about a fence it overlaps. Whether the center of
+    // the cell is inside is known, so a position in the cell is inside if it
+    // is reached from the center by crossing the edges an even number of
+    // times. If no edges cross the cell, that's a single lookup.
+    struct CellFence {
+        uint32_t fence_index{0};
+        bool center_inside{false};
+        std::vector<uint32_t> edge_indices{};
+    };
+
+    [[nodiscard]] Vector2 local(const Geofence::Point& point) const;
+    [[nodiscard]] bool is_allowed_local(const Vector2& point) const;
+    [[nodiscard]] bool is_inside(const Fence& fence, const Vector2& point) const;
+    [[nodiscard]] bool is_inside(
+        const CellFence& cell_fence, const Vector2& cell_center, const Vector2& point) const;
+    [[nodiscard]] bool cell_of(const Vector2& point, uint32_t& column, uint32_t& row) const;
+    [[nodiscard]] Vector2 cell_center(uint32_t column, uint32_t row) const;
+
+    static geometry::CoordinateTransformation::GlobalCoordinate
+    reference_of(const Geofence::GeofenceData& geofence_data);
+
+    void add_polygon(const Geofence::Polygon& polygon);
+    void add_circle(const Geofence::Circle& circle);
+    void build_grid();
+
+    static bool crosses(const Vector2& from, const Vector2& to, const Edge& edge);
+
+    geometry::CoordinateTransformation _transformation;
+    std::vector<Fence> _fences{};
+    bool _has_inclusion{false};
+
+    Box _grid_box{};
+    uint32_t _grid_columns{0};
+    uint32_t _grid_rows{0};
+    double _cell_size_m{0.0};
+    std::vector<std::vector<CellFence>> _cells{};
+
+    static constexpr uint32_t max_grid_cells_per_side = 64;
+};
+
+} // namespace mavsdk
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <memory>
+
+#include "plugins/geofence/geofence.h"
+
+namespace mavsdk {
+
+class GeofenceImpl;
+class GeofenceEvaluator;
+
+/**
+ * @brief Additions to Geofence that are only available in C++.
+ *
+ * Unlike geofence.h, this header is not generated from the proto files,
+ * so the calls here are not available through mavsdk_server.
+ *
+ * It works on the Geofence plugin it is created with, which has to outlive it:
+ *
+ *     ```cpp
+ *     auto geofence = Geofence(system);
+ *     auto geofence_ext = GeofenceExt(geofence);
+ *     ```
+ *
+ * Geofence::upload_geofence() and Geofence::upload_geofence_async() only
+ * write the changed vertices and circles if their number is the same as
+ * last uploaded, as long as the drone supports partial writes.
+ */
+class GeofenceExt {
+public:
+    /**
+     * @brief Constructor. Uses the given Geofence plugin.
+     *
+     * @param geofence The plugin, which has to outlive this object.
+     */
+    explicit GeofenceExt(Geofence& geofence);
+
+    /**
+     * @brief Get an evaluator of the geofence last uploaded or cleared.
+     *
+     * The evaluator is kept as it was, while later uploads create a new one.
+     *
+     * @return The evaluator, or nullptr if no geofence was uploaded yet.
+     */
+    std::shared_ptr<const GeofenceEvaluator> geofence_evaluator() const;
+
+private:
+    GeofenceImpl& _impl;
+};
+
+} // namespace mavsdk
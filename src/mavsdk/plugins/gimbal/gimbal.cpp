@@ -20,7 +20,7 @@ Gimbal::Gimbal(std::shared_ptr<System> system) :
 
 Gimbal::~Gimbal() {}
 
-void Gimbal::set_pitch_and_yaw_async(float pitch_deg, float yaw_deg, const ResultCallback callback)
+void Gimbal::set_pitch_and_yaw_async(float pitch_deg, float yaw_deg, const ResultCallback& callback)
 {
     _impl->set_pitch_and_yaw_async(pitch_deg, yaw_deg, callback);
 }
@@ -31,7 +31,7 @@ Gimbal::Result Gimbal::set_pitch_and_yaw(float pitch_deg, float yaw_deg) const
 }
 
 void Gimbal::set_pitch_rate_and_yaw_rate_async(
-    float pitch_rate_deg_s, float yaw_rate_deg_s, const ResultCallback callback)
+    float pitch_rate_deg_s, float yaw_rate_deg_s, const ResultCallback& callback)
 {
     _impl->set_pitch_rate_and_yaw_rate_async(pitch_rate_deg_s, yaw_rate_deg_s, callback);
 }
@@ -42,7 +42,7 @@ Gimbal::set_pitch_rate_and_yaw_rate(float pitch_rate_deg_s, float yaw_rate_deg_s
     return _impl->set_pitch_rate_and_yaw_rate(pitch_rate_deg_s, yaw_rate_deg_s);
 }
 
-void Gimbal::set_mode_async(GimbalMode gimbal_mode, const ResultCallback callback)
+void Gimbal::set_mode_async(GimbalMode gimbal_mode, const ResultCallback& callback)
 {
     _impl->set_mode_async(gimbal_mode, callback);
 }
@@ -53,7 +53,7 @@ Gimbal::Result Gimbal::set_mode(GimbalMode gimbal_mode) const
 }
 
 void Gimbal::set_roi_location_async(
-    double latitude_deg, double longitude_deg, float altitude_m, const ResultCallback callback)
+    double latitude_deg, double longitude_deg, float altitude_m, const ResultCallback& callback)
 {
     _impl->set_roi_location_async(latitude_deg, longitude_deg, altitude_m, callback);
 }
@@ -64,7 +64,7 @@ Gimbal::set_roi_location(double latitude_deg, double longitude_deg, float altitu
     return _impl->set_roi_location(latitude_deg, longitude_deg, altitude_m);
 }
 
-void Gimbal::take_control_async(ControlMode control_mode, const ResultCallback callback)
+void Gimbal::take_control_async(ControlMode control_mode, const ResultCallback& callback)
 {
     _impl->take_control_async(control_mode, callback);
 }
@@ -74,7 +74,7 @@ Gimbal::Result Gimbal::take_control(ControlMode control_mode) const
     return _impl->take_control(control_mode);
 }
 
-void Gimbal::release_control_async(const ResultCallback callback)
+void Gimbal::release_control_async(const ResultCallback& callback)
 {
     _impl->release_control_async(callback);
 }
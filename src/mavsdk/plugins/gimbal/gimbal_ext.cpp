@@ -0,0 +1,13 @@
+#include "gimbal_impl.h"
+#include "plugins/gimbal/gimbal_ext.h"
+
+namespace mavsdk {
+
+GimbalExt::GimbalExt(Gimbal& gimbal) : _impl(*gimbal._impl) {}
+
+Gimbal::Result GimbalExt::set_control_rate(double rate_hz) const
+{
+    return _impl.set_control_rate(rate_hz);
+}
+
+} // namespace mavsdk
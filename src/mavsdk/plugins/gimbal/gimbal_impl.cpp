@@ -2,10 +2,8 @@
 #include "gimbal_protocol_v1.h"
 #include "gimbal_protocol_v2.h"
 #include "callback_list.tpp"
-#include <chrono>
 #include <cmath>
 #include <functional>
-#include <thread>
 
 namespace mavsdk {
 
@@ -41,16 +39,15 @@ void GimbalImpl::enable()
     _system_impl->register_timeout_handler(
         [this]() { receive_protocol_timeout(); }, 1.0, &_protocol_cookie);
 
-    MavlinkCommandSender::CommandLong command{};
-    command.command = MAV_CMD_REQUEST_MESSAGE;
-    command.params.maybe_param1 = {static_cast<float>(MAVLINK_MSG_ID_GIMBAL_MANAGER_INFORMATION)};
-    command.target_component_id = 0; // any component
-    _system_impl->send_command_async(command, nullptr);
+    // A command to any component would hold up the commands to all others
+    // until it is acked, so it is just asked for while connecting.
+    _system_impl->add_connect_step("gimbal_protocol");
+    _system_impl->add_connect_request(MAVLINK_MSG_ID_GIMBAL_MANAGER_INFORMATION, 0);
 }
 
 void GimbalImpl::disable()
 {
-    _gimbal_protocol.reset(nullptr);
+    _state_change.notify([this]() { _gimbal_protocol.reset(nullptr); });
 }
 
 void GimbalImpl::receive_protocol_timeout()
@@ -58,8 +55,10 @@ void GimbalImpl::receive_protocol_timeout()
     // We did not receive a GIMBAL_MANAGER_INFORMATION in time, so we have to
     // assume Version2 is not available.
     LogDebug() << "Falling back to Gimbal Version 1";
-    _gimbal_protocol.reset(new GimbalProtocolV1(*_system_impl));
     _protocol_cookie = nullptr;
+    _state_change.notify(
+        [this]() { _gimbal_protocol.reset(new GimbalProtocolV1(*_system_impl)); });
+    _system_impl->complete_connect_step("gimbal_protocol");
 }
 
 void GimbalImpl::process_gimbal_manager_information(const mavlink_message_t& message)
@@ -74,8 +73,11 @@ void GimbalImpl::process_gimbal_manager_information(const mavlink_message_t& mes
 
         _system_impl->unregister_timeout_handler(_protocol_cookie);
         _protocol_cookie = nullptr;
-        _gimbal_protocol.reset(new GimbalProtocolV2(
-            *_system_impl, gimbal_manager_information, message.sysid, message.compid));
+        _state_change.notify([&]() {
+            _gimbal_protocol.reset(new GimbalProtocolV2(
+                *_system_impl, gimbal_manager_information, message.sysid, message.compid));
+        });
+        _system_impl->complete_connect_step("gimbal_protocol");
     }
 }
 
@@ -109,6 +111,12 @@ void GimbalImpl::set_pitch_rate_and_yaw_rate_async(
     });
 }
 
+Gimbal::Result GimbalImpl::set_control_rate(double rate_hz)
+{
+    wait_for_protocol();
+    return _gimbal_protocol->set_control_rate(rate_hz);
+}
+
 Gimbal::Result GimbalImpl::set_mode(const Gimbal::GimbalMode gimbal_mode)
 {
     wait_for_protocol();
@@ -196,9 +204,7 @@ void GimbalImpl::unsubscribe_control(Gimbal::ControlHandle handle)
 
 void GimbalImpl::wait_for_protocol()
 {
-    while (_gimbal_protocol == nullptr) {
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));
-    }
+    _state_change.wait([this]() { return _gimbal_protocol != nullptr; });
 }
 
 void GimbalImpl::wait_for_protocol_async(std::function<void()> callback)
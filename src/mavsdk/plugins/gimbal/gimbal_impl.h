@@ -28,6 +28,8 @@ public:
     void set_pitch_rate_and_yaw_rate_async(
         float pitch_rate_deg_s, float yaw_rate_deg_s, Gimbal::ResultCallback callback);
 
+    Gimbal::Result set_control_rate(double rate_hz);
+
     Gimbal::Result set_mode(const Gimbal::GimbalMode gimbal_mode);
     void set_mode_async(const Gimbal::GimbalMode gimbal_mode, Gimbal::ResultCallback callback);
 
@@ -21,6 +21,8 @@ public:
     virtual void set_pitch_rate_and_yaw_rate_async(
         float pitch_rate_deg_s, float yaw_rate_deg_s, Gimbal::ResultCallback callback) = 0;
 
+    virtual Gimbal::Result set_control_rate(double rate_hz) = 0;
+
     virtual Gimbal::Result set_mode(const Gimbal::GimbalMode gimbal_mode) = 0;
     virtual void
     set_mode_async(const Gimbal::GimbalMode gimbal_mode, Gimbal::ResultCallback callback) = 0;
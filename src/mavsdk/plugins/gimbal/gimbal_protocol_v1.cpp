@@ -69,6 +69,13 @@ void GimbalProtocolV1::set_pitch_rate_and_yaw_rate_async(
     }
 }
 
+Gimbal::Result GimbalProtocolV1::set_control_rate(double rate_hz)
+{
+    // Each target is a command which needs to be acknowledged, streaming them
+    // would only pile up commands.
+    return rate_hz == 0.0 ? Gimbal::Result::Success : Gimbal::Result::Unsupported;
+}
+
 Gimbal::Result GimbalProtocolV1::set_mode(const Gimbal::GimbalMode gimbal_mode)
 {
     MavlinkCommandSender::CommandInt command{};
@@ -23,6 +23,8 @@ public:
     void set_pitch_rate_and_yaw_rate_async(
         float pitch_rate_deg_s, float yaw_rate_deg_s, Gimbal::ResultCallback callback) override;
 
+    Gimbal::Result set_control_rate(double rate_hz) override;
+
     Gimbal::Result set_mode(const Gimbal::GimbalMode gimbal_mode) override;
     void
     set_mode_async(const Gimbal::GimbalMode gimbal_mode, Gimbal::ResultCallback callback) override;
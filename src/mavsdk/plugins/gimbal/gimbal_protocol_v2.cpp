@@ -17,6 +17,14 @@ GimbalProtocolV2::GimbalProtocolV2(
     _gimbal_manager_compid(gimbal_manager_compid)
 {}
 
+GimbalProtocolV2::~GimbalProtocolV2()
+{
+    // The streamer thread sends with our members, so it goes first.
+    std::lock_guard<std::mutex> lock(_target_streamer_mutex);
+    _target_scheduled = false;
+    _target_streamer.reset();
+}
+
 void GimbalProtocolV2::process_gimbal_manager_status(const mavlink_message_t& message)
 {
     Gimbal::ControlMode new_control_mode;
@@ -57,28 +65,13 @@ Gimbal::Result GimbalProtocolV2::set_pitch_and_yaw(float pitch_deg, float yaw_de
     const float pitch_rad = to_rad_from_deg(pitch_deg);
     const float yaw_rad = to_rad_from_deg(yaw_deg);
 
-    float quaternion[4];
-    mavlink_euler_to_quaternion(roll_rad, pitch_rad, yaw_rad, quaternion);
-
-    const uint32_t flags =
-        GIMBAL_MANAGER_FLAGS_ROLL_LOCK | GIMBAL_MANAGER_FLAGS_PITCH_LOCK |
-        ((_gimbal_mode == Gimbal::GimbalMode::YawLock) ? GIMBAL_MANAGER_FLAGS_YAW_LOCK : 0);
-
-    mavlink_message_t message;
-    mavlink_msg_gimbal_manager_set_attitude_pack(
-        _system_impl.get_own_system_id(),
-        _system_impl.get_own_component_id(),
-        &message,
-        _gimbal_manager_sysid,
-        _gimbal_manager_compid,
-        flags,
-        _gimbal_device_id,
-        quaternion,
-        NAN,
-        NAN,
-        NAN);
+    Target target;
+    target.flags = target_flags();
+    mavlink_euler_to_quaternion(roll_rad, pitch_rad, yaw_rad, target.quaternion.data());
+    target.pitch_rate_rad_s = NAN;
+    target.yaw_rate_rad_s = NAN;
 
-    return _system_impl.send_message(message) ? Gimbal::Result::Success : Gimbal::Result::Error;
+    return set_target(target);
 }
 
 void GimbalProtocolV2::set_pitch_and_yaw_async(
@@ -95,27 +88,13 @@ void GimbalProtocolV2::set_pitch_and_yaw_async(
 Gimbal::Result
 GimbalProtocolV2::set_pitch_rate_and_yaw_rate(float pitch_rate_deg_s, float yaw_rate_deg_s)
 {
-    const uint32_t flags =
-        GIMBAL_MANAGER_FLAGS_ROLL_LOCK | GIMBAL_MANAGER_FLAGS_PITCH_LOCK |
-        ((_gimbal_mode == Gimbal::GimbalMode::YawLock) ? GIMBAL_MANAGER_FLAGS_YAW_LOCK : 0);
-
-    const float quaternion[4] = {NAN, NAN, NAN, NAN};
-
-    mavlink_message_t message;
-    mavlink_msg_gimbal_manager_set_attitude_pack(
-        _system_impl.get_own_system_id(),
-        _system_impl.get_own_component_id(),
-        &message,
-        _gimbal_manager_sysid,
-        _gimbal_manager_compid,
-        flags,
-        _gimbal_device_id,
-        quaternion,
-        0.0f,
-        to_rad_from_deg(pitch_rate_deg_s),
-        to_rad_from_deg(yaw_rate_deg_s));
+    Target target;
+    target.flags = target_flags();
+    target.quaternion = {NAN, NAN, NAN, NAN};
+    target.pitch_rate_rad_s = to_rad_from_deg(pitch_rate_deg_s);
+    target.yaw_rate_rad_s = to_rad_from_deg(yaw_rate_deg_s);
 
-    return _system_impl.send_message(message) ? Gimbal::Result::Success : Gimbal::Result::Error;
+    return set_target(target);
 }
 
 void GimbalProtocolV2::set_pitch_rate_and_yaw_rate_async(
@@ -130,6 +109,82 @@ void GimbalProtocolV2::set_pitch_rate_and_yaw_rate_async(
     }
 }
 
+Gimbal::Result GimbalProtocolV2::set_control_rate(double rate_hz)
+{
+    std::lock_guard<std::mutex> lock(_target_streamer_mutex);
+
+    if (rate_hz == 0.0) {
+        _target_scheduled = false;
+        _target_streamer.reset();
+        return Gimbal::Result::Success;
+    }
+
+    if (_target_streamer == nullptr) {
+        _target_streamer = std::make_unique<SetpointStreamer>();
+    }
+    if (!_target_streamer->set_rate_hz(rate_hz)) {
+        return Gimbal::Result::Error;
+    }
+
+    if (!_target_scheduled.exchange(true)) {
+        // Nothing is sent until the next target arrives.
+        _latest_target.store(Target{});
+        _target_streamer->start([this]() { send_latest_target(); });
+    }
+    return Gimbal::Result::Success;
+}
+
+uint32_t GimbalProtocolV2::target_flags() const
+{
+    return GIMBAL_MANAGER_FLAGS_ROLL_LOCK | GIMBAL_MANAGER_FLAGS_PITCH_LOCK |
+           ((_gimbal_mode == Gimbal::GimbalMode::YawLock) ? GIMBAL_MANAGER_FLAGS_YAW_LOCK : 0);
+}
+
+Gimbal::Result GimbalProtocolV2::set_target(const Target& target)
+{
+    if (_target_scheduled) {
+        // Targets coming faster than the rate just replace the previous one.
+        Target stored = target;
+        stored.set_time = _time.steady_time();
+        _latest_target.store(stored);
+        return Gimbal::Result::Success;
+    }
+
+    return send_target(target);
+}
+
+void GimbalProtocolV2::send_latest_target()
+{
+    const auto target = _latest_target.load();
+
+    // Not set yet, or not anymore for a while.
+    if (target.set_time == SteadyTimePoint{} ||
+        _time.elapsed_since_s(target.set_time) > target_timeout_s) {
+        return;
+    }
+
+    send_target(target);
+}
+
+Gimbal::Result GimbalProtocolV2::send_target(const Target& target)
+{
+    mavlink_message_t message;
+    mavlink_msg_gimbal_manager_set_attitude_pack(
+        _system_impl.get_own_system_id(),
+        _system_impl.get_own_component_id(),
+        &message,
+        _gimbal_manager_sysid,
+        _gimbal_manager_compid,
+        target.flags,
+        _gimbal_device_id,
+        target.quaternion.data(),
+        std::isnan(target.pitch_rate_rad_s) ? NAN : 0.0f,
+        target.pitch_rate_rad_s,
+        target.yaw_rate_rad_s);
+
+    return _system_impl.send_message(message) ? Gimbal::Result::Success : Gimbal::Result::Error;
+}
+
 Gimbal::Result GimbalProtocolV2::set_mode(const Gimbal::GimbalMode gimbal_mode)
 {
     _gimbal_mode = gimbal_mode;
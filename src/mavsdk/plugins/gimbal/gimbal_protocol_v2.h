@@ -2,6 +2,14 @@
 
 #include "plugins/gimbal/gimbal.h"
 #include "gimbal_protocol_base.h"
+#include "mavsdk_time.h"
+#include "seqlock.h"
+#include "setpoint_streamer.h"
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
 
 namespace mavsdk {
 
@@ -12,7 +20,7 @@ public:
         const mavlink_gimbal_manager_information_t& information,
         uint8_t gimbal_manager_sysid,
         uint8_t gimbal_manager_compid);
-    ~GimbalProtocolV2() override = default;
+    ~GimbalProtocolV2() override;
 
     Gimbal::Result set_pitch_and_yaw(float pitch_deg, float yaw_deg) override;
     void set_pitch_and_yaw_async(
@@ -24,6 +32,8 @@ public:
     void set_pitch_rate_and_yaw_rate_async(
         float pitch_rate_deg_s, float yaw_rate_deg_s, Gimbal::ResultCallback callback) override;
 
+    Gimbal::Result set_control_rate(double rate_hz) override;
+
     Gimbal::Result set_mode(const Gimbal::GimbalMode gimbal_mode) override;
     void
     set_mode_async(const Gimbal::GimbalMode gimbal_mode, Gimbal::ResultCallback callback) override;
@@ -50,6 +60,20 @@ private:
     void set_gimbal_information(const mavlink_gimbal_manager_information_t& information);
     void process_gimbal_manager_status(const mavlink_message_t& message);
 
+    // Either the attitude or the rates are NAN.
+    struct Target {
+        uint32_t flags{0};
+        std::array<float, 4> quaternion{};
+        float pitch_rate_rad_s{0.0f};
+        float yaw_rate_rad_s{0.0f};
+        SteadyTimePoint set_time{};
+    };
+
+    uint32_t target_flags() const;
+    Gimbal::Result set_target(const Target& target);
+    Gimbal::Result send_target(const Target& target);
+    void send_latest_target();
+
     uint8_t _gimbal_device_id;
     uint8_t _gimbal_manager_sysid;
     uint8_t _gimbal_manager_compid;
@@ -60,6 +84,19 @@ private:
     Gimbal::ControlCallback _control_callback;
 
     bool _is_mavlink_manager_status_registered = false;
+
+    // If a control rate is set, the latest target is stored and sent by the
+    // streamer instead. It is repeated until no new target has arrived for a
+    // while, like a joystick that was let go.
+    static constexpr double target_timeout_s = 1.0;
+
+    Time _time{};
+    Seqlock<Target> _latest_target{};
+    std::atomic<bool> _target_scheduled{false};
+
+    std::mutex _target_streamer_mutex{};
+    // Needs _target_streamer_mutex, only allocated if a rate is set.
+    std::unique_ptr<SetpointStreamer> _target_streamer{};
 };
 
 } // namespace mavsdk
@@ -15,6 +15,7 @@
 
 #include "plugin_base.h"
 
+#include "awaitable.h"
 #include "handle.h"
 
 namespace mavsdk {
@@ -152,7 +153,25 @@ public:
      *
      * This function is non-blocking. See 'set_pitch_and_yaw' for the blocking counterpart.
      */
-    void set_pitch_and_yaw_async(float pitch_deg, float yaw_deg, const ResultCallback callback);
+    void set_pitch_and_yaw_async(float pitch_deg, float yaw_deg, const ResultCallback& callback);
+
+#ifdef MAVSDK_HAS_COROUTINES
+    /**
+     * @brief Awaitable version of 'set_pitch_and_yaw_async' for C++20 coroutines.
+     *
+     * The coroutine is resumed using the executor if one is given, otherwise on the callback
+     * thread.
+     */
+    Awaitable<ResultCallback> set_pitch_and_yaw_awaitable(
+        float pitch_deg, float yaw_deg, Executor executor = {})
+    {
+        return Awaitable<ResultCallback>(
+            [=, this](const ResultCallback& callback) {
+                set_pitch_and_yaw_async(pitch_deg, yaw_deg, callback);
+            },
+            std::move(executor));
+    }
+#endif
 
     /**
      * @brief Set gimbal pitch and yaw angles.
@@ -178,7 +197,25 @@ public:
      * counterpart.
      */
     void set_pitch_rate_and_yaw_rate_async(
-        float pitch_rate_deg_s, float yaw_rate_deg_s, const ResultCallback callback);
+        float pitch_rate_deg_s, float yaw_rate_deg_s, const ResultCallback& callback);
+
+#ifdef MAVSDK_HAS_COROUTINES
+    /**
+     * @brief Awaitable version of 'set_pitch_rate_and_yaw_rate_async' for C++20 coroutines.
+     *
+     * The coroutine is resumed using the executor if one is given, otherwise on the callback
+     * thread.
+     */
+    Awaitable<ResultCallback> set_pitch_rate_and_yaw_rate_awaitable(
+        float pitch_rate_deg_s, float yaw_rate_deg_s, Executor executor = {})
+    {
+        return Awaitable<ResultCallback>(
+            [=, this](const ResultCallback& callback) {
+                set_pitch_rate_and_yaw_rate_async(pitch_rate_deg_s, yaw_rate_deg_s, callback);
+            },
+            std::move(executor));
+    }
+#endif
 
     /**
      * @brief Set gimbal angular rates around pitch and yaw axes.
@@ -203,7 +240,24 @@ public:
      *
      * This function is non-blocking. See 'set_mode' for the blocking counterpart.
      */
-    void set_mode_async(GimbalMode gimbal_mode, const ResultCallback callback);
+    void set_mode_async(GimbalMode gimbal_mode, const ResultCallback& callback);
+
+#ifdef MAVSDK_HAS_COROUTINES
+    /**
+     * @brief Awaitable version of 'set_mode_async' for C++20 coroutines.
+     *
+     * The coroutine is resumed using the executor if one is given, otherwise on the callback
+     * thread.
+     */
+    Awaitable<ResultCallback> set_mode_awaitable(GimbalMode gimbal_mode, Executor executor = {})
+    {
+        return Awaitable<ResultCallback>(
+            [=, this](const ResultCallback& callback) {
+                set_mode_async(gimbal_mode, callback);
+            },
+            std::move(executor));
+    }
+#endif
 
     /**
      * @brief Set gimbal mode.
@@ -230,7 +284,28 @@ public:
      * This function is non-blocking. See 'set_roi_location' for the blocking counterpart.
      */
     void set_roi_location_async(
-        double latitude_deg, double longitude_deg, float altitude_m, const ResultCallback callback);
+        double latitude_deg,
+        double longitude_deg,
+        float altitude_m,
+        const ResultCallback& callback);
+
+#ifdef MAVSDK_HAS_COROUTINES
+    /**
+     * @brief Awaitable version of 'set_roi_location_async' for C++20 coroutines.
+     *
+     * The coroutine is resumed using the executor if one is given, otherwise on the callback
+     * thread.
+     */
+    Awaitable<ResultCallback> set_roi_location_awaitable(
+        double latitude_deg, double longitude_deg, float altitude_m, Executor executor = {})
+    {
+        return Awaitable<ResultCallback>(
+            [=, this](const ResultCallback& callback) {
+                set_roi_location_async(latitude_deg, longitude_deg, altitude_m, callback);
+            },
+            std::move(executor));
+    }
+#endif
 
     /**
      * @brief Set gimbal region of interest (ROI).
@@ -260,7 +335,25 @@ public:
      *
      * This function is non-blocking. See 'take_control' for the blocking counterpart.
      */
-    void take_control_async(ControlMode control_mode, const ResultCallback callback);
+    void take_control_async(ControlMode control_mode, const ResultCallback& callback);
+
+#ifdef MAVSDK_HAS_COROUTINES
+    /**
+     * @brief Awaitable version of 'take_control_async' for C++20 coroutines.
+     *
+     * The coroutine is resumed using the executor if one is given, otherwise on the callback
+     * thread.
+     */
+    Awaitable<ResultCallback> take_control_awaitable(
+        ControlMode control_mode, Executor executor = {})
+    {
+        return Awaitable<ResultCallback>(
+            [=, this](const ResultCallback& callback) {
+                take_control_async(control_mode, callback);
+            },
+            std::move(executor));
+    }
+#endif
 
     /**
      * @brief Take control.
@@ -286,7 +379,24 @@ public:
      *
      * This function is non-blocking. See 'release_control' for the blocking counterpart.
      */
-    void release_control_async(const ResultCallback callback);
+    void release_control_async(const ResultCallback& callback);
+
+#ifdef MAVSDK_HAS_COROUTINES
+    /**
+     * @brief Awaitable version of 'release_control_async' for C++20 coroutines.
+     *
+     * The coroutine is resumed using the executor if one is given, otherwise on the callback
+     * thread.
+     */
+    Awaitable<ResultCallback> release_control_awaitable(Executor executor = {})
+    {
+        return Awaitable<ResultCallback>(
+            [=, this](const ResultCallback& callback) {
+                release_control_async(callback);
+            },
+            std::move(executor));
+    }
+#endif
 
     /**
      * @brief Release control.
@@ -343,6 +453,9 @@ public:
 private:
     /** @private Underlying implementation, set at instantiation */
     std::unique_ptr<GimbalImpl> _impl;
+
+    /** @private Hand-written additions in gimbal_ext.h, if any */
+    friend class GimbalExt;
 };
 
 } // namespace mavsdk
\ No newline at end of file
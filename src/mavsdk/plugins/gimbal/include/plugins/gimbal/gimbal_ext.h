@@ -0,0 +1,53 @@
+#pragma once
+
+#include "plugins/gimbal/gimbal.h"
+
+namespace mavsdk {
+
+class GimbalImpl;
+
+/**
+ * @brief Additions to Gimbal that are only available in C++.
+ *
+ * Unlike gimbal.h, this header is not generated from the proto files,
+ * so the calls here are not available through mavsdk_server.
+ *
+ * It works on the Gimbal plugin it is created with, which has to outlive it:
+ *
+ *     ```cpp
+ *     auto gimbal = Gimbal(system);
+ *     auto gimbal_ext = GimbalExt(gimbal);
+ *     ```
+ */
+class GimbalExt {
+public:
+    /**
+     * @brief Constructor. Uses the given Gimbal plugin.
+     *
+     * @param gimbal The plugin, which has to outlive this object.
+     */
+    explicit GimbalExt(Gimbal& gimbal);
+
+    /**
+     * @brief Send pitch and yaw targets at a fixed rate.
+     *
+     * Once a rate is set, Gimbal::set_pitch_and_yaw and Gimbal::set_pitch_rate_and_yaw_rate (and
+     * their async counterparts) only store the target, and the latest one is sent
+     * at the given rate, no matter how often it is set. This suits joystick and
+     * tracking loops setting targets at a high rate. The target is repeated until
+     * no new one has been set for a second. A rate of 0 sends every target
+     * directly again, which is the default.
+     *
+     * This is only supported with gimbal protocol v2.
+     *
+     * This function is blocking.
+     *
+     * @return Result of request.
+     */
+    Gimbal::Result set_control_rate(double rate_hz) const;
+
+private:
+    GimbalImpl& _impl;
+};
+
+} // namespace mavsdk
@@ -18,7 +18,7 @@ Gripper::Gripper(std::shared_ptr<System> system) :
 
 Gripper::~Gripper() {}
 
-void Gripper::grab_async(uint32_t instance, const ResultCallback callback)
+void Gripper::grab_async(uint32_t instance, const ResultCallback& callback)
 {
     _impl->grab_async(instance, callback);
 }
@@ -28,7 +28,7 @@ Gripper::Result Gripper::grab(uint32_t instance) const
     return _impl->grab(instance);
 }
 
-void Gripper::release_async(uint32_t instance, const ResultCallback callback)
+void Gripper::release_async(uint32_t instance, const ResultCallback& callback)
 {
     _impl->release_async(instance, callback);
 }
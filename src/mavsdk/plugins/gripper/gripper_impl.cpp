@@ -35,7 +35,7 @@ void GripperImpl::grab_async(uint32_t instance, const Gripper::ResultCallback ca
 
     command.target_component_id = MAV_COMPONENT::MAV_COMP_ID_WINCH; // TODO
 
-    _system_impl->send_command_async(
+    _system_impl->send_streamed_command_async(
         command, [this, callback](MavlinkCommandSender::Result result, float) {
             command_result_callback(result, callback);
         });
@@ -61,7 +61,7 @@ void GripperImpl::release_async(uint32_t instance, const Gripper::ResultCallback
 
     command.target_component_id = MAV_COMPONENT::MAV_COMP_ID_WINCH; // TODO
 
-    _system_impl->send_command_async(
+    _system_impl->send_streamed_command_async(
         command, [this, callback](MavlinkCommandSender::Result result, float) {
             command_result_callback(result, callback);
         });
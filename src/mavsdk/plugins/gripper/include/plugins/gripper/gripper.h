@@ -15,6 +15,7 @@
 
 #include "plugin_base.h"
 
+#include "awaitable.h"
 #include "handle.h"
 
 namespace mavsdk {
@@ -107,7 +108,24 @@ public:
      *
      * This function is non-blocking. See 'grab' for the blocking counterpart.
      */
-    void grab_async(uint32_t instance, const ResultCallback callback);
+    void grab_async(uint32_t instance, const ResultCallback& callback);
+
+#ifdef MAVSDK_HAS_COROUTINES
+    /**
+     * @brief Awaitable version of 'grab_async' for C++20 coroutines.
+     *
+     * The coroutine is resumed using the executor if one is given, otherwise on the callback
+     * thread.
+     */
+    Awaitable<ResultCallback> grab_awaitable(uint32_t instance, Executor executor = {})
+    {
+        return Awaitable<ResultCallback>(
+            [=, this](const ResultCallback& callback) {
+                grab_async(instance, callback);
+            },
+            std::move(executor));
+    }
+#endif
 
     /**
      * @brief Gripper grab cargo.
@@ -123,7 +141,24 @@ public:
      *
      * This function is non-blocking. See 'release' for the blocking counterpart.
      */
-    void release_async(uint32_t instance, const ResultCallback callback);
+    void release_async(uint32_t instance, const ResultCallback& callback);
+
+#ifdef MAVSDK_HAS_COROUTINES
+    /**
+     * @brief Awaitable version of 'release_async' for C++20 coroutines.
+     *
+     * The coroutine is resumed using the executor if one is given, otherwise on the callback
+     * thread.
+     */
+    Awaitable<ResultCallback> release_awaitable(uint32_t instance, Executor executor = {})
+    {
+        return Awaitable<ResultCallback>(
+            [=, this](const ResultCallback& callback) {
+                release_async(instance, callback);
+            },
+            std::move(executor));
+    }
+#endif
 
     /**
      * @brief Gripper release cargo.
@@ -147,6 +182,9 @@ public:
 private:
     /** @private Underlying implementation, set at instantiation */
     std::unique_ptr<GripperImpl> _impl;
+
+    /** @private Hand-written additions in gripper_ext.h, if any */
+    friend class GripperExt;
 };
 
 } // namespace mavsdk
\ No newline at end of file
@@ -15,6 +15,7 @@
 
 #include "plugin_base.h"
 
+#include "awaitable.h"
 #include "handle.h"
 
 namespace mavsdk {
@@ -265,6 +266,9 @@ public:
 private:
     /** @private Underlying implementation, set at instantiation */
     std::unique_ptr<InfoImpl> _impl;
+
+    /** @private Hand-written additions in info_ext.h, if any */
+    friend class InfoExt;
 };
 
 } // namespace mavsdk
\ No newline at end of file
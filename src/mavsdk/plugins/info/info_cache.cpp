@@ -0,0 +1,106 @@
+#include "info_cache.h"
+#include "log.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+
+namespace mavsdk {
+
+namespace {
+
+constexpr const char* header = "mavsdk-info-cache 1";
+
+std::string to_hex(const uint8_t* bytes, size_t len)
+{
+    std::string str(len * 2 + 1, '0');
+    for (size_t i = 0; i < len; ++i) {
+        snprintf(&str[i * 2], str.length() - i * 2, "%02x", bytes[i]);
+    }
+    str.resize(len * 2);
+    return str;
+}
+
+bool from_hex(const std::string& str, uint8_t* bytes, size_t len)
+{
+    if (str.size() != len * 2 ||
+        str.find_first_not_of("0123456789abcdef") != std::string::npos) {
+        return false;
+    }
+    for (size_t i = 0; i < len; ++i) {
+        bytes[i] = static_cast<uint8_t>(std::stoul(str.substr(i * 2, 2), nullptr, 16));
+    }
+    return true;
+}
+
+} // namespace
+
+bool InfoCache::save(
+    const StateStoreKey& cache, const mavlink_autopilot_version_t& autopilot_version)
+{
+    if (!cache.store) {
+        return false;
+    }
+
+    std::ostringstream content;
+    content << header << '\n'
+            << "autopilot_version "
+            << to_hex(
+                   reinterpret_cast<const uint8_t*>(&autopilot_version), sizeof(autopilot_version))
+            << '\n';
+
+    if (!cache.store->put(cache.key, content.str())) {
+        LogWarn() << "Could not store info cache " << cache.key;
+        return false;
+    }
+    return true;
+}
+
+std::optional<mavlink_autopilot_version_t> InfoCache::load(const StateStoreKey& cache)
+{
+    const auto content = cache.store ? cache.store->get(cache.key) : std::nullopt;
+    if (!content) {
+        return {};
+    }
+
+    std::istringstream lines(content.value());
+
+    std::string line;
+    if (!std::getline(lines, line) || line != header) {
+        return {};
+    }
+
+    std::string key;
+    std::string bytes;
+    if (!std::getline(lines, line) || !(std::istringstream(line) >> key >> bytes) ||
+        key != "autopilot_version") {
+        LogWarn() << "Broken info cache " << cache.key;
+        return {};
+    }
+
+    mavlink_autopilot_version_t autopilot_version{};
+    if (!from_hex(
+            bytes, reinterpret_cast<uint8_t*>(&autopilot_version), sizeof(autopilot_version))) {
+        LogWarn() << "Broken info cache " << cache.key;
+        return {};
+    }
+
+    return autopilot_version;
+}
+
+bool InfoCache::same_uid(const mavlink_autopilot_version_t& a, const mavlink_autopilot_version_t& b)
+{
+    return has_uid(a) && a.uid == b.uid && memcmp(a.uid2, b.uid2, sizeof(a.uid2)) == 0;
+}
+
+bool InfoCache::has_uid(const mavlink_autopilot_version_t& autopilot_version)
+{
+    return autopilot_version.uid != 0 ||
+           std::any_of(
+               std::begin(autopilot_version.uid2),
+               std::end(autopilot_version.uid2),
+               [](uint8_t byte) { return byte != 0; });
+}
+
+} // namespace mavsdk
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "mavlink_include.h"
+#include "state_store.h"
+#include <optional>
+#include <string>
+
+namespace mavsdk {
+
+// Stores the AUTOPILOT_VERSION of a system in the state store, so that its
+// version and identification are known right away on the next connection,
+// even before the autopilot has answered again.
+//
+// The message is stored as the raw bytes of the struct together with the UID
+// it reported, so a cache for another autopilot can be told apart.
+
+class InfoCache {
+public:
+    static bool
+    save(const StateStoreKey& cache, const mavlink_autopilot_version_t& autopilot_version);
+
+    // Returns nothing if there is no cache or it is broken.
+    static std::optional<mavlink_autopilot_version_t> load(const StateStoreKey& cache);
+
+    // Whether both come from the same autopilot, which has to report a UID.
+    static bool
+    same_uid(const mavlink_autopilot_version_t& a, const mavlink_autopilot_version_t& b);
+
+    // Whether the autopilot reported a UID, either the legacy one or uid2.
+    static bool has_uid(const mavlink_autopilot_version_t& autopilot_version);
+};
+
+} // namespace mavsdk
@@ -0,0 +1,76 @@
+#include "info_cache.h"
+#include "fs.h"
+#include <gtest/gtest.h>
+#include <cstring>
+
+using namespace mavsdk;
+
+namespace {
+
+StateStoreKey tmp_cache(const std::string& name)
+{
+    auto tmp_dir = create_tmp_directory("mavsdk-info-cache-test");
+    EXPECT_TRUE(tmp_dir);
+    const auto path = tmp_dir.value_or(".") + "/" + name;
+    fs_remove(path);
+    return StateStoreKey{std::make_shared<StateStore>(path), "info/system-1"};
+}
+
+mavlink_autopilot_version_t some_autopilot_version()
+{
+    mavlink_autopilot_version_t autopilot_version{};
+    autopilot_version.flight_sw_version = 0x010e03ff;
+    autopilot_version.os_sw_version = 0x0b020000;
+    autopilot_version.vendor_id = 0x26ac;
+    autopilot_version.product_id = 0x0010;
+    for (unsigned i = 0; i < sizeof(autopilot_version.uid2); ++i) {
+        autopilot_version.uid2[i] = static_cast<uint8_t>(0xf0 + i);
+    }
+    return autopilot_version;
+}
+
+} // namespace
+
+TEST(InfoCache, RoundTrip)
+{
+    const auto cache = tmp_cache("round_trip.cache");
+    const auto autopilot_version = some_autopilot_version();
+
+    ASSERT_TRUE(InfoCache::save(cache, autopilot_version));
+    const auto loaded = InfoCache::load(cache);
+    ASSERT_TRUE(loaded);
+
+    EXPECT_EQ(memcmp(&loaded.value(), &autopilot_version, sizeof(autopilot_version)), 0);
+    EXPECT_TRUE(InfoCache::same_uid(loaded.value(), autopilot_version));
+}
+
+TEST(InfoCache, MissingOrBrokenCacheIsNotLoaded)
+{
+    const auto cache = tmp_cache("broken.cache");
+    EXPECT_FALSE(InfoCache::load(cache));
+
+    cache.store->put(cache.key, "mavsdk-info-cache 1\nautopilot_version 0a0b");
+    EXPECT_FALSE(InfoCache::load(cache));
+
+    // Without a store, nothing is cached.
+    EXPECT_FALSE(InfoCache::save(StateStoreKey{}, some_autopilot_version()));
+    EXPECT_FALSE(InfoCache::load(StateStoreKey{}));
+}
+
+TEST(InfoCache, OnlyAutopilotsWithTheSameUidAreTheSame)
+{
+    auto autopilot_version = some_autopilot_version();
+    auto other = autopilot_version;
+    other.uid2[0] = 0;
+    EXPECT_FALSE(InfoCache::same_uid(autopilot_version, other));
+
+    // Without any UID, nothing can be told apart.
+    mavlink_autopilot_version_t without_uid{};
+    EXPECT_FALSE(InfoCache::has_uid(without_uid));
+    EXPECT_FALSE(InfoCache::same_uid(without_uid, without_uid));
+
+    other = autopilot_version;
+    other.uid = 42;
+    autopilot_version.uid = 42;
+    EXPECT_TRUE(InfoCache::same_uid(autopilot_version, other));
+}
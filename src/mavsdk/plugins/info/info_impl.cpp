@@ -2,7 +2,9 @@
 #include <cstring>
 #include <numeric>
 #include "info_impl.h"
+#include "info_cache.h"
 #include "system.h"
+#include "decoded_message.h"
 
 namespace mavsdk {
 
@@ -46,10 +48,16 @@ void InfoImpl::deinit()
 
 void InfoImpl::enable()
 {
+    // Until the autopilot answers, what it sent before is served, so that
+    // nobody has to wait for it on every connection.
+    load_cached_autopilot_version();
+
     // We can't rely on System to request the autopilot_version,
-    // so we do it here, anyway.
-    _system_impl->send_autopilot_version_request();
-    _system_impl->send_flight_information_request();
+    // so we do it here, anyway. Neither waits, so that the other plugins
+    // can start their discovery at the same time.
+    _system_impl->send_autopilot_version_request_async(nullptr);
+    _system_impl->add_connect_step("flight_information");
+    _system_impl->send_flight_information_request_async(nullptr);
 
     // We're going to retry until we have the version.
     _system_impl->add_call_every([this]() { request_version_again(); }, 1.0f, &_call_every_cookie);
@@ -64,24 +72,22 @@ void InfoImpl::disable()
     _system_impl->remove_call_every(_call_every_cookie);
     _system_impl->remove_call_every(_flight_info_call_every_cookie);
 
+    // The version is kept for the next connection, it is refreshed then.
+    _information_received = false;
     {
         std::lock_guard<std::mutex> lock(_mutex);
-        _information_received = false;
         _flight_information_received = false;
     }
 }
 
 void InfoImpl::request_version_again()
 {
-    {
-        std::lock_guard<std::mutex> lock(_mutex);
-        if (_information_received) {
-            _system_impl->remove_call_every(_call_every_cookie);
-            return;
-        }
+    if (_information_received) {
+        _system_impl->remove_call_every(_call_every_cookie);
+        return;
     }
 
-    _system_impl->send_autopilot_version_request();
+    _system_impl->send_autopilot_version_request_async(nullptr);
 }
 
 void InfoImpl::request_flight_information()
@@ -90,7 +96,7 @@ void InfoImpl::request_flight_information()
     // we go from an armed to disarmed state or if we haven't received any
     // information yet
     if ((_was_armed && !_system_impl->is_armed()) || !_flight_information_received) {
-        _system_impl->send_flight_information_request();
+        _system_impl->send_flight_information_request_async(nullptr);
     }
 
     _was_armed = _system_impl->is_armed();
@@ -98,60 +104,107 @@ void InfoImpl::request_flight_information()
 
 void InfoImpl::process_autopilot_version(const mavlink_message_t& message)
 {
-    std::lock_guard<std::mutex> lock(_mutex);
-
     mavlink_autopilot_version_t autopilot_version;
     mavlink_msg_autopilot_version_decode(&message, &autopilot_version);
 
-    _version.flight_sw_major = (autopilot_version.flight_sw_version >> (8 * 3)) & 0xFF;
-    _version.flight_sw_minor = (autopilot_version.flight_sw_version >> (8 * 2)) & 0xFF;
-    _version.flight_sw_patch = (autopilot_version.flight_sw_version >> (8 * 1)) & 0xFF;
-    _version.flight_sw_version_type =
+    const auto previous = _autopilot_version.load();
+    _autopilot_version.store(AutopilotVersionSnapshot{true, autopilot_version});
+    _information_received = true;
+    _state_change.notify();
+
+    // Only written if anything changed, it is sent again on every connection.
+    const bool changed =
+        !previous.valid ||
+        memcmp(&previous.autopilot_version, &autopilot_version, sizeof(autopilot_version)) != 0;
+    if (!changed || !InfoCache::has_uid(autopilot_version)) {
+        return;
+    }
+
+    InfoCache::save(info_cache_key(), autopilot_version);
+}
+
+void InfoImpl::load_cached_autopilot_version()
+{
+    if (_autopilot_version.load().valid) {
+        return;
+    }
+
+    const auto cached = InfoCache::load(info_cache_key());
+    if (!cached) {
+        return;
+    }
+
+    // Unless the autopilot was faster.
+    _autopilot_version.update([&](AutopilotVersionSnapshot& snapshot) {
+        if (!snapshot.valid) {
+            snapshot = AutopilotVersionSnapshot{true, cached.value()};
+        }
+    });
+}
+
+StateStoreKey InfoImpl::info_cache_key() const
+{
+    // The UID is only known once the autopilot has answered, so the cache is
+    // found by system ID. An answer from another autopilot replaces it.
+    return StateStoreKey{
+        _system_impl->state_store(),
+        "info/system-" + std::to_string(static_cast<unsigned>(_system_impl->get_system_id()))};
+}
+
+Info::Version InfoImpl::version_from(const mavlink_autopilot_version_t& autopilot_version)
+{
+    Info::Version version{};
+
+    version.flight_sw_major = (autopilot_version.flight_sw_version >> (8 * 3)) & 0xFF;
+    version.flight_sw_minor = (autopilot_version.flight_sw_version >> (8 * 2)) & 0xFF;
+    version.flight_sw_patch = (autopilot_version.flight_sw_version >> (8 * 1)) & 0xFF;
+    version.flight_sw_version_type =
         get_flight_software_version_type(static_cast<FIRMWARE_VERSION_TYPE>(
             (autopilot_version.flight_sw_version >> (8 * 0)) & 0xFF));
 
     // first three bytes of flight_custom_version (little endian) describe vendor version
-    _version.flight_sw_git_hash = swap_and_translate_binary_to_str(
+    version.flight_sw_git_hash = swap_and_translate_binary_to_str(
         autopilot_version.flight_custom_version + 3,
         sizeof(autopilot_version.flight_custom_version) - 3);
 
-    _version.flight_sw_vendor_major = autopilot_version.flight_custom_version[2];
-    _version.flight_sw_vendor_minor = autopilot_version.flight_custom_version[1];
-    _version.flight_sw_vendor_patch = autopilot_version.flight_custom_version[0];
-
-    _version.os_sw_major = (autopilot_version.os_sw_version >> (8 * 3)) & 0xFF;
-    _version.os_sw_minor = (autopilot_version.os_sw_version >> (8 * 2)) & 0xFF;
-    _version.os_sw_patch = (autopilot_version.os_sw_version >> (8 * 1)) & 0xFF;
-
-    // Debug() << "flight version: "
-    //     << _version.flight_sw_major
-    //     << "."
-    //     << _version.flight_sw_minor
-    //     << "."
-    //     << _version.flight_sw_patch;
-
-    // Debug() << "os version: "
-    //     << _version.os_sw_major
-    //     << "."
-    //     << _version.os_sw_minor
-    //     << "."
-    //     << _version.os_sw_patch;
-
-    _version.os_sw_git_hash = swap_and_translate_binary_to_str(
+    version.flight_sw_vendor_major = autopilot_version.flight_custom_version[2];
+    version.flight_sw_vendor_minor = autopilot_version.flight_custom_version[1];
+    version.flight_sw_vendor_patch = autopilot_version.flight_custom_version[0];
+
+    version.os_sw_major = (autopilot_version.os_sw_version >> (8 * 3)) & 0xFF;
+    version.os_sw_minor = (autopilot_version.os_sw_version >> (8 * 2)) & 0xFF;
+    version.os_sw_patch = (autopilot_version.os_sw_version >> (8 * 1)) & 0xFF;
+
+    version.os_sw_git_hash = swap_and_translate_binary_to_str(
         autopilot_version.os_custom_version, sizeof(autopilot_version.os_custom_version));
 
-    _product.vendor_id = autopilot_version.vendor_id;
-    _product.vendor_name = vendor_id_str(autopilot_version.vendor_id);
+    return version;
+}
+
+Info::Product InfoImpl::product_from(const mavlink_autopilot_version_t& autopilot_version)
+{
+    Info::Product product{};
+
+    product.vendor_id = autopilot_version.vendor_id;
+    product.vendor_name = vendor_id_str(autopilot_version.vendor_id);
 
-    _product.product_id = autopilot_version.product_id;
-    _product.product_name = product_id_str(autopilot_version.product_id);
+    product.product_id = autopilot_version.product_id;
+    product.product_name = product_id_str(autopilot_version.product_id);
+
+    return product;
+}
 
-    _identification.hardware_uid =
+Info::Identification
+InfoImpl::identification_from(const mavlink_autopilot_version_t& autopilot_version)
+{
+    Info::Identification identification{};
+
+    identification.hardware_uid =
         translate_binary_to_str(autopilot_version.uid2, sizeof(autopilot_version.uid2));
 
-    _identification.legacy_uid = autopilot_version.uid;
+    identification.legacy_uid = autopilot_version.uid;
 
-    _information_received = true;
+    return identification;
 }
 
 Info::Version::FlightSoftwareVersionType
@@ -189,9 +242,10 @@ void InfoImpl::process_flight_information(const mavlink_message_t& message)
     _flight_info.flight_uid = flight_information.flight_uuid;
 
     _flight_information_received = true;
+    _system_impl->complete_connect_step("flight_information");
 }
 
-std::string InfoImpl::swap_and_translate_binary_to_str(uint8_t* binary, unsigned binary_len)
+std::string InfoImpl::swap_and_translate_binary_to_str(const uint8_t* binary, unsigned binary_len)
 {
     std::string str(binary_len * 2, '0');
 
@@ -204,7 +258,7 @@ std::string InfoImpl::swap_and_translate_binary_to_str(uint8_t* binary, unsigned
     return str;
 }
 
-std::string InfoImpl::translate_binary_to_str(uint8_t* binary, unsigned binary_len)
+std::string InfoImpl::translate_binary_to_str(const uint8_t* binary, unsigned binary_len)
 {
     std::string str(binary_len * 2 + 1, '0');
 
@@ -218,33 +272,29 @@ std::string InfoImpl::translate_binary_to_str(uint8_t* binary, unsigned binary_l
 
 std::pair<Info::Result, Info::Identification> InfoImpl::get_identification() const
 {
-    wait_for_information();
-
-    std::lock_guard<std::mutex> lock(_mutex);
-    return std::make_pair<>(
-        (_information_received ? Info::Result::Success : Info::Result::InformationNotReceivedYet),
-        _identification);
+    const auto snapshot = wait_for_autopilot_version();
+    if (!snapshot.valid) {
+        return std::make_pair<>(Info::Result::InformationNotReceivedYet, Info::Identification{});
+    }
+    return std::make_pair<>(Info::Result::Success, identification_from(snapshot.autopilot_version));
 }
 
 std::pair<Info::Result, Info::Version> InfoImpl::get_version() const
 {
-    wait_for_information();
-
-    std::lock_guard<std::mutex> lock(_mutex);
-
-    return std::make_pair<>(
-        (_information_received ? Info::Result::Success : Info::Result::InformationNotReceivedYet),
-        _version);
+    const auto snapshot = wait_for_autopilot_version();
+    if (!snapshot.valid) {
+        return std::make_pair<>(Info::Result::InformationNotReceivedYet, Info::Version{});
+    }
+    return std::make_pair<>(Info::Result::Success, version_from(snapshot.autopilot_version));
 }
 
 std::pair<Info::Result, Info::Product> InfoImpl::get_product() const
 {
-    wait_for_information();
-    std::lock_guard<std::mutex> lock(_mutex);
-
-    return std::make_pair<>(
-        (_information_received ? Info::Result::Success : Info::Result::InformationNotReceivedYet),
-        _product);
+    const auto snapshot = wait_for_autopilot_version();
+    if (!snapshot.valid) {
+        return std::make_pair<>(Info::Result::InformationNotReceivedYet, Info::Product{});
+    }
+    return std::make_pair<>(Info::Result::Success, product_from(snapshot.autopilot_version));
 }
 
 std::pair<Info::Result, Info::FlightInfo> InfoImpl::get_flight_information() const
@@ -283,8 +333,7 @@ void InfoImpl::process_attitude(const mavlink_message_t& message)
     // We use the attitude message to estimate the lockstep speed factor
     // because it's common to be sent, arrives at high rate, and contains
     // the timestamp field.
-    mavlink_attitude_t attitude;
-    mavlink_msg_attitude_decode(&message, &attitude);
+    const auto& attitude = DecodedMessage::get(message, mavlink_msg_attitude_decode);
 
     std::lock_guard<std::mutex> lock(_mutex);
 
@@ -320,12 +369,21 @@ std::pair<Info::Result, double> InfoImpl::get_speed_factor() const
 void InfoImpl::wait_for_information() const
 {
     // Wait 1.5 seconds max
-    for (unsigned i = 0; i < 150; ++i) {
-        if (_information_received) {
-            break;
-        }
-        std::this_thread::sleep_for(std::chrono::milliseconds(10));
-    }
+    _state_change.wait_for(
+        [this]() { return _information_received.load(); }, std::chrono::milliseconds(1500));
+}
+
+InfoImpl::AutopilotVersionSnapshot InfoImpl::wait_for_autopilot_version() const
+{
+    // Wait 1.5 seconds max, unless it was known before.
+    auto snapshot = _autopilot_version.load();
+    _state_change.wait_for(
+        [&]() {
+            snapshot = _autopilot_version.load();
+            return snapshot.valid;
+        },
+        std::chrono::milliseconds(1500));
+    return snapshot;
 }
 
 } // namespace mavsdk
@@ -6,6 +6,8 @@
 #include "plugins/info/info.h"
 #include "plugin_impl_base.h"
 #include "ringbuffer.h"
+#include "seqlock.h"
+#include "state_store.h"
 
 namespace mavsdk {
 
@@ -38,17 +40,32 @@ private:
     void process_flight_information(const mavlink_message_t& message);
     void process_attitude(const mavlink_message_t& message);
 
-    Info::Version::FlightSoftwareVersionType
+    void load_cached_autopilot_version();
+    StateStoreKey info_cache_key() const;
+
+    static Info::Version::FlightSoftwareVersionType
         get_flight_software_version_type(FIRMWARE_VERSION_TYPE);
 
+    static Info::Version version_from(const mavlink_autopilot_version_t& autopilot_version);
+    static Info::Product product_from(const mavlink_autopilot_version_t& autopilot_version);
+    static Info::Identification
+    identification_from(const mavlink_autopilot_version_t& autopilot_version);
+
+    struct AutopilotVersionSnapshot {
+        bool valid;
+        mavlink_autopilot_version_t autopilot_version;
+    };
+
     void wait_for_information() const;
+    AutopilotVersionSnapshot wait_for_autopilot_version() const;
 
     mutable std::mutex _mutex{};
 
-    Info::Version _version{};
-    Info::Product _product{};
-    Info::Identification _identification{};
+    // The latest AUTOPILOT_VERSION, or the one cached from before until the
+    // autopilot has answered again. Read without a lock, dashboards poll it.
+    Seqlock<AutopilotVersionSnapshot> _autopilot_version{};
     Info::FlightInfo _flight_info{};
+    // Whether the autopilot has answered since it connected.
     std::atomic<bool> _information_received{false};
     bool _flight_information_received{false};
     bool _was_armed{false};
@@ -76,8 +93,9 @@ private:
     static const std::string vendor_id_str(uint16_t vendor_id);
     static const std::string product_id_str(uint16_t product_id);
 
-    static std::string swap_and_translate_binary_to_str(uint8_t* binary, unsigned binary_len);
-    static std::string translate_binary_to_str(uint8_t* binary, unsigned binary_len);
+    static std::string
+    swap_and_translate_binary_to_str(const uint8_t* binary, unsigned binary_len);
+    static std::string translate_binary_to_str(const uint8_t* binary, unsigned binary_len);
 };
 
 } // namespace mavsdk
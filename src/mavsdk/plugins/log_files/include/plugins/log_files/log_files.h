@@ -15,6 +15,7 @@
 
 #include "plugin_base.h"
 
+#include "awaitable.h"
 #include "handle.h"
 
 namespace mavsdk {
@@ -140,7 +141,24 @@ public:
      *
      * This function is non-blocking. See 'get_entries' for the blocking counterpart.
      */
-    void get_entries_async(const GetEntriesCallback callback);
+    void get_entries_async(const GetEntriesCallback& callback);
+
+#ifdef MAVSDK_HAS_COROUTINES
+    /**
+     * @brief Awaitable version of 'get_entries_async' for C++20 coroutines.
+     *
+     * The coroutine is resumed using the executor if one is given, otherwise on the callback
+     * thread.
+     */
+    Awaitable<GetEntriesCallback> get_entries_awaitable(Executor executor = {})
+    {
+        return Awaitable<GetEntriesCallback>(
+            [=, this](const GetEntriesCallback& callback) {
+                get_entries_async(callback);
+            },
+            std::move(executor));
+    }
+#endif
 
     /**
      * @brief Get List of log files.
@@ -159,8 +177,8 @@ public:
     /**
      * @brief Download log file.
      */
-    void
-    download_log_file_async(Entry entry, std::string path, const DownloadLogFileCallback& callback);
+    void download_log_file_async(
+        const Entry& entry, const std::string& path, const DownloadLogFileCallback& callback);
 
     /**
      * @brief Erase all log files.
@@ -184,6 +202,9 @@ public:
 private:
     /** @private Underlying implementation, set at instantiation */
     std::unique_ptr<LogFilesImpl> _impl;
+
+    /** @private Hand-written additions in log_files_ext.h, if any */
+    friend class LogFilesExt;
 };
 
 } // namespace mavsdk
\ No newline at end of file
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <vector>
+
+#include "plugins/log_files/log_files.h"
+
+namespace mavsdk {
+
+class LogFilesImpl;
+
+/**
+ * @brief Additions to LogFiles that are only available in C++.
+ *
+ * Unlike log_files.h, this header is not generated from the proto files,
+ * so the calls here are not available through mavsdk_server.
+ *
+ * It works on the LogFiles plugin it is created with, which has to outlive it:
+ *
+ *     ```cpp
+ *     auto log_files = LogFiles(system);
+ *     auto log_files_ext = LogFilesExt(log_files);
+ *     ```
+ *
+ * An interrupted LogFiles::download_log_file_async() of the same log to the
+ * same path is resumed, using a <path>.resume file kept next to the partial
+ * download.
+ */
+class LogFilesExt {
+public:
+    /**
+     * @brief Constructor. Uses the given LogFiles plugin.
+     *
+     * @param log_files The plugin, which has to outlive this object.
+     */
+    explicit LogFilesExt(LogFiles& log_files);
+
+    /**
+     * @brief Callback type for the data of stream_log_file_async.
+     */
+    using DataCallback = std::function<void(const std::vector<uint8_t>& data)>;
+
+    /**
+     * @brief Download log file, without saving it to disk.
+     *
+     * The data is passed to the data callback in order, as soon as each part of the log
+     * is complete, before the progress of that part is reported. This always uses
+     * LOG_REQUEST_DATA, and an interrupted download can't be resumed.
+     */
+    void stream_log_file_async(
+        const LogFiles::Entry& entry,
+        const DataCallback& data_callback,
+        const LogFiles::DownloadLogFileCallback& callback);
+
+    /**
+     * @brief Download log file into a stream, without saving it to disk.
+     *
+     * Same as the other stream_log_file_async. The stream needs to stay valid until the
+     * download is done.
+     */
+    void stream_log_file_async(
+        const LogFiles::Entry& entry,
+        std::ostream& stream,
+        const LogFiles::DownloadLogFileCallback& callback);
+
+private:
+    LogFilesImpl& _impl;
+};
+
+} // namespace mavsdk
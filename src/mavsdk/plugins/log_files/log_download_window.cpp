@@ -0,0 +1,62 @@
+#include "log_download_window.h"
+
+#include <algorithm>
+
+namespace mavsdk {
+
+void LogDownloadWindow::reset()
+{
+    _part_chunks = initial_part_chunks;
+    _round_trip_s = 0.0;
+}
+
+void LogDownloadWindow::part_done(bool had_loss)
+{
+    if (had_loss) {
+        _part_chunks = std::max(_part_chunks / 2, min_part_chunks);
+    } else {
+        _part_chunks = std::min(_part_chunks * 2, max_part_chunks);
+    }
+}
+
+double LogDownloadWindow::timeout_s() const
+{
+    // Generous, as a spurious timeout means asking for data that is on its way.
+    return std::clamp(4.0 * _round_trip_s, min_timeout_s, max_timeout_s);
+}
+
+void LogDownloadWindow::add_round_trip(double round_trip_s)
+{
+    if (_round_trip_s == 0.0) {
+        _round_trip_s = round_trip_s;
+    } else {
+        // Smoothed the same way as TCP does it.
+        _round_trip_s += (round_trip_s - _round_trip_s) / 8.0;
+    }
+}
+
+std::vector<std::pair<std::size_t, std::size_t>>
+LogDownloadWindow::missing_ranges(const std::vector<bool>& chunks_received)
+{
+    std::vector<std::pair<std::size_t, std::size_t>> ranges;
+
+    auto missing = std::find(chunks_received.begin(), chunks_received.end(), false);
+    while (missing != chunks_received.end()) {
+        const auto received = std::find(missing, chunks_received.end(), true);
+
+        const auto start = static_cast<std::size_t>(missing - chunks_received.begin());
+        const auto end = static_cast<std::size_t>(received - chunks_received.begin());
+
+        if (!ranges.empty() &&
+            start - (ranges.back().first + ranges.back().second) <= max_merged_gap_chunks) {
+            ranges.back().second = end - ranges.back().first;
+        } else {
+            ranges.emplace_back(start, end - start);
+        }
+
+        missing = std::find(received, chunks_received.end(), false);
+    }
+    return ranges;
+}
+
+} // namespace mavsdk
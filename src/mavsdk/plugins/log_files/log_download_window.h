@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace mavsdk {
+
+// Decides how much log data to request at once and how long to wait for it.
+//
+// Parts grow while they arrive without loss, which saves round trips on good
+// links, and shrink again as soon as chunks go missing, so that a slow link or
+// autopilot isn't flooded. The timeout follows the round trip time measured
+// from a request to the first data coming back.
+class LogDownloadWindow {
+public:
+    static constexpr unsigned min_part_chunks = 64;
+    static constexpr unsigned initial_part_chunks = 512;
+    static constexpr unsigned max_part_chunks = 4096;
+
+    static constexpr double min_timeout_s = 0.1;
+    static constexpr double max_timeout_s = 1.0;
+
+    LogDownloadWindow() = default;
+    ~LogDownloadWindow() = default;
+
+    void reset();
+
+    [[nodiscard]] unsigned part_chunks() const { return _part_chunks; }
+    void part_done(bool had_loss);
+
+    [[nodiscard]] double timeout_s() const;
+    void add_round_trip(double round_trip_s);
+
+    // Chunk ranges, as first index and count, that are still missing. Ranges
+    // separated by only a few received chunks are merged, as getting those
+    // again is cheaper than another round trip.
+    static std::vector<std::pair<std::size_t, std::size_t>>
+    missing_ranges(const std::vector<bool>& chunks_received);
+
+private:
+    static constexpr std::size_t max_merged_gap_chunks = 4;
+
+    unsigned _part_chunks{initial_part_chunks};
+    double _round_trip_s{0.0};
+};
+
+} // namespace mavsdk
@@ -0,0 +1,73 @@
+#include "log_download_window.h"
+
+#include <gtest/gtest.h>
+
+using namespace mavsdk;
+
+TEST(LogDownloadWindow, PartsGrowAndShrink)
+{
+    LogDownloadWindow window{};
+    EXPECT_EQ(window.part_chunks(), LogDownloadWindow::initial_part_chunks);
+
+    window.part_done(false);
+    EXPECT_EQ(window.part_chunks(), 2 * LogDownloadWindow::initial_part_chunks);
+
+    for (unsigned i = 0; i < 10; ++i) {
+        window.part_done(false);
+    }
+    EXPECT_EQ(window.part_chunks(), LogDownloadWindow::max_part_chunks);
+
+    window.part_done(true);
+    EXPECT_EQ(window.part_chunks(), LogDownloadWindow::max_part_chunks / 2);
+
+    for (unsigned i = 0; i < 10; ++i) {
+        window.part_done(true);
+    }
+    EXPECT_EQ(window.part_chunks(), LogDownloadWindow::min_part_chunks);
+
+    window.reset();
+    EXPECT_EQ(window.part_chunks(), LogDownloadWindow::initial_part_chunks);
+}
+
+TEST(LogDownloadWindow, TimeoutFollowsRoundTrip)
+{
+    LogDownloadWindow window{};
+    EXPECT_DOUBLE_EQ(window.timeout_s(), LogDownloadWindow::min_timeout_s);
+
+    // A fast link doesn't go below the minimum.
+    window.add_round_trip(0.005);
+    EXPECT_DOUBLE_EQ(window.timeout_s(), LogDownloadWindow::min_timeout_s);
+
+    // A slow radio link.
+    for (unsigned i = 0; i < 100; ++i) {
+        window.add_round_trip(0.15);
+    }
+    EXPECT_NEAR(window.timeout_s(), 0.6, 0.01);
+
+    window.add_round_trip(10.0);
+    EXPECT_DOUBLE_EQ(window.timeout_s(), LogDownloadWindow::max_timeout_s);
+}
+
+TEST(LogDownloadWindow, MissingRanges)
+{
+    EXPECT_TRUE(LogDownloadWindow::missing_ranges(std::vector<bool>(10, true)).empty());
+
+    const auto all = LogDownloadWindow::missing_ranges(std::vector<bool>(10, false));
+    ASSERT_EQ(all.size(), 1);
+    EXPECT_EQ(all[0], std::make_pair(std::size_t(0), std::size_t(10)));
+
+    std::vector<bool> chunks(40, true);
+    chunks[2] = false;
+    chunks[3] = false;
+    // Close enough to be merged with the previous range.
+    chunks[6] = false;
+    // Far away.
+    chunks[20] = false;
+    chunks[39] = false;
+
+    const auto ranges = LogDownloadWindow::missing_ranges(chunks);
+    ASSERT_EQ(ranges.size(), 3);
+    EXPECT_EQ(ranges[0], std::make_pair(std::size_t(2), std::size_t(5)));
+    EXPECT_EQ(ranges[1], std::make_pair(std::size_t(20), std::size_t(1)));
+    EXPECT_EQ(ranges[2], std::make_pair(std::size_t(39), std::size_t(1)));
+}
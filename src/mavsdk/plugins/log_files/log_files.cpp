@@ -21,7 +21,7 @@ LogFiles::LogFiles(std::shared_ptr<System> system) :
 
 LogFiles::~LogFiles() {}
 
-void LogFiles::get_entries_async(const GetEntriesCallback callback)
+void LogFiles::get_entries_async(const GetEntriesCallback& callback)
 {
     _impl->get_entries_async(callback);
 }
@@ -32,7 +32,7 @@ std::pair<LogFiles::Result, std::vector<LogFiles::Entry>> LogFiles::get_entries(
 }
 
 void LogFiles::download_log_file_async(
-    Entry entry, std::string path, const DownloadLogFileCallback& callback)
+    const Entry& entry, const std::string& path, const DownloadLogFileCallback& callback)
 {
     _impl->download_log_file_async(entry, path, callback);
 }
@@ -0,0 +1,31 @@
+#include "log_files_impl.h"
+#include "plugins/log_files/log_files_ext.h"
+
+namespace mavsdk {
+
+LogFilesExt::LogFilesExt(LogFiles& log_files) : _impl(*log_files._impl) {}
+
+void LogFilesExt::stream_log_file_async(
+    const LogFiles::Entry& entry,
+    const DataCallback& data_callback,
+    const LogFiles::DownloadLogFileCallback& callback)
+{
+    _impl.stream_log_file_async(entry, data_callback, callback);
+}
+
+void LogFilesExt::stream_log_file_async(
+    const LogFiles::Entry& entry,
+    std::ostream& stream,
+    const LogFiles::DownloadLogFileCallback& callback)
+{
+    _impl.stream_log_file_async(
+        entry,
+        [&stream](const std::vector<uint8_t>& data) {
+            stream.write(
+                reinterpret_cast<const char*>(data.data()),
+                static_cast<std::streamsize>(data.size()));
+        },
+        callback);
+}
+
+} // namespace mavsdk
@@ -1,6 +1,8 @@
 #include "log_files_impl.h"
 #include "mavsdk_impl.h"
 #include "filesystem_include.h"
+#include "fs.h"
+#include "transfer_resume.h"
 #include "unused.h"
 
 #include <algorithm>
@@ -59,6 +61,21 @@ void LogFilesImpl::enable() {}
 
 void LogFilesImpl::disable() {}
 
+std::optional<MemoryUsage::Plugin> LogFilesImpl::memory_usage()
+{
+    MemoryUsage::Plugin usage;
+    usage.name = "log_files";
+    {
+        std::lock_guard<std::mutex> lock(_entries.mutex);
+        usage.bytes += _entries.entry_map.size() * sizeof(std::pair<unsigned, LogFiles::Entry>);
+    }
+    {
+        std::lock_guard<std::mutex> lock(_data.mutex);
+        usage.bytes += _data.bytes.capacity() + _data.chunks_received.capacity() / 8;
+    }
+    return usage;
+}
+
 void LogFilesImpl::request_end()
 {
     mavlink_message_t msg;
@@ -94,7 +111,7 @@ void LogFilesImpl::get_entries_async(LogFiles::GetEntriesCallback callback)
     }
 
     _system_impl->register_timeout_handler(
-        [this]() { list_timeout(); }, LIST_TIMEOUT_S, &_entries.cookie);
+        [this]() { list_timeout(); }, list_timeout_s(), &_entries.cookie);
 
     request_list_entry(-1);
 }
@@ -160,6 +177,11 @@ void LogFilesImpl::process_log_entry(const mavlink_message_t& message)
     }
 }
 
+double LogFilesImpl::list_timeout_s() const
+{
+    return _system_impl->rtt_estimator().timeout_s(LIST_TIMEOUT_S);
+}
+
 void LogFilesImpl::list_timeout()
 {
     std::lock_guard<std::mutex> lock(_entries.mutex);
@@ -197,7 +219,7 @@ void LogFilesImpl::list_timeout()
                 }
             }
             _system_impl->register_timeout_handler(
-                [this]() { list_timeout(); }, LIST_TIMEOUT_S, &_entries.cookie);
+                [this]() { list_timeout(); }, list_timeout_s(), &_entries.cookie);
             _entries.retries++;
         }
     }
@@ -223,93 +245,223 @@ LogFilesImpl::download_log_file(LogFiles::Entry entry, const std::string& file_p
 void LogFilesImpl::download_log_file_async(
     LogFiles::Entry entry, const std::string& file_path, LogFiles::DownloadLogFileCallback callback)
 {
-    unsigned bytes_to_get;
-    {
-        std::lock_guard<std::mutex> lock(_entries.mutex);
+    if (!find_entry(entry, callback)) {
+        return;
+    }
 
-        auto it = _entries.entry_map.find(entry.id);
-        if (it == _entries.entry_map.end()) {
-            LogErr() << "Log entry id " << entry.id << " not found";
-            if (callback) {
-                const auto tmp_callback = callback;
-                _system_impl->call_user_callback([tmp_callback]() {
-                    LogFiles::ProgressData progress;
-                    progress.progress = 0.0f;
-                    tmp_callback(LogFiles::Result::InvalidArgument, progress);
-                });
-            }
+    if (is_directory(file_path)) {
+        if (callback) {
+            const auto tmp_callback = callback;
+            _system_impl->call_user_callback([tmp_callback]() {
+                LogFiles::ProgressData progress;
+                progress.progress = NAN;
+                LogErr()
+                    << "Invalid path! The path must point to an unexisting file, and it points to a directory!";
+                tmp_callback(LogFiles::Result::InvalidArgument, progress);
+            });
+        }
+        return;
+    }
+
+    // Unless it is an interrupted download we can continue.
+    if (file_exists(file_path) &&
+        TransferResume::resume_offset(file_path, log_data_source(entry), entry.size_bytes) == 0) {
+        if (callback) {
+            const auto tmp_callback = callback;
+            _system_impl->call_user_callback([tmp_callback]() {
+                LogFiles::ProgressData progress;
+                progress.progress = NAN;
+                LogErr() << "Target log file already exists!";
+                tmp_callback(LogFiles::Result::InvalidArgument, progress);
+            });
+        }
+        return;
+    }
+
+    // MAVLink FTP is a lot faster than LOG_DATA, if we know where the file is.
+    if (_system_impl->autopilot() == SystemImpl::Autopilot::Px4 &&
+        _system_impl->autopilot_supports_ftp()) {
+        const auto location = px4_log_ftp_location(entry);
+        if (location) {
+            download_log_file_ftp(entry, location.value(), file_path, callback);
             return;
         }
+    }
+
+    download_log_file_log_data(entry, file_path, callback);
+}
 
-        bytes_to_get = _entries.entry_map[entry.id].size_bytes;
+void LogFilesImpl::stream_log_file_async(
+    LogFiles::Entry entry,
+    const LogFilesExt::DataCallback& data_callback,
+    const LogFiles::DownloadLogFileCallback& callback)
+{
+    if (!find_entry(entry, callback)) {
+        return;
     }
 
-    {
-        std::lock_guard<std::mutex> lock(_data.mutex);
+    std::lock_guard<std::mutex> lock(_data.mutex);
+    _data.data_callback = data_callback;
+    start_log_data_requests(entry, 0, callback);
+}
 
-        if (is_directory(file_path)) {
-            if (callback) {
-                const auto tmp_callback = callback;
-                _system_impl->call_user_callback([tmp_callback]() {
-                    LogFiles::ProgressData progress;
-                    progress.progress = NAN;
-                    LogErr()
-                        << "Invalid path! The path must point to an unexisting file, and it points to a directory!";
-                    tmp_callback(LogFiles::Result::InvalidArgument, progress);
-                });
-            }
-            return;
+bool LogFilesImpl::find_entry(
+    LogFiles::Entry& entry, const LogFiles::DownloadLogFileCallback& callback)
+{
+    std::lock_guard<std::mutex> lock(_entries.mutex);
+
+    auto it = _entries.entry_map.find(entry.id);
+    if (it == _entries.entry_map.end()) {
+        LogErr() << "Log entry id " << entry.id << " not found";
+        if (callback) {
+            const auto tmp_callback = callback;
+            _system_impl->call_user_callback([tmp_callback]() {
+                LogFiles::ProgressData progress;
+                progress.progress = 0.0f;
+                tmp_callback(LogFiles::Result::InvalidArgument, progress);
+            });
         }
+        return false;
+    }
 
-        if (file_exists(file_path)) {
-            if (callback) {
-                const auto tmp_callback = callback;
-                _system_impl->call_user_callback([tmp_callback]() {
-                    LogFiles::ProgressData progress;
-                    progress.progress = NAN;
-                    LogErr() << "Target log file already exists!";
-                    tmp_callback(LogFiles::Result::InvalidArgument, progress);
-                });
+    entry = it->second;
+    return true;
+}
+
+void LogFilesImpl::download_log_file_ftp(
+    const LogFiles::Entry& entry,
+    const LogFtpLocation& location,
+    const std::string& file_path,
+    const LogFiles::DownloadLogFileCallback& callback)
+{
+    // First make sure it's the right file and not one that is still being written.
+    _system_impl->mavlink_ftp().list_directory_async(
+        location.directory,
+        [this, entry, location, file_path, callback](
+            MavlinkFtp::ClientResult result, std::vector<std::string> listing) {
+            if (result != MavlinkFtp::ClientResult::Success ||
+                !ftp_listing_contains(listing, location.file_name, entry.size_bytes)) {
+                LogDebug() << "Log " << entry.id << " not found using FTP, using LOG_DATA";
+                download_log_file_log_data(entry, file_path, callback);
+                return;
             }
-            return;
-        }
 
-        if (!start_logfile(file_path)) {
+            // Downloaded next to the target, so that it can be renamed to it.
+            // If the folder is still there, MavlinkFtp resumes the download.
+            const auto local_folder = file_path + ".ftp";
+            if (!fs_create_directory(local_folder) && !is_directory(local_folder)) {
+                download_log_file_log_data(entry, file_path, callback);
+                return;
+            }
+            const auto local_path = local_folder + path_separator + location.file_name;
+
             if (callback) {
-                const auto tmp_callback = callback;
-                _system_impl->call_user_callback([tmp_callback]() {
+                _system_impl->call_user_callback([callback]() {
                     LogFiles::ProgressData progress;
-                    progress.progress = NAN;
-                    tmp_callback(LogFiles::Result::FileOpenFailed, progress);
+                    progress.progress = 0.0f;
+                    callback(LogFiles::Result::Next, progress);
                 });
             }
-            return;
-        }
 
-        _data.id = entry.id;
-        _data.callback = callback;
-        _data.time_started = _time.steady_time();
-        _data.bytes_to_get = bytes_to_get;
-        _data.part_start = 0;
-        const auto part_size = determine_part_end() - _data.part_start;
-        _data.bytes.resize(part_size);
-        _data.chunks_received.resize(
-            part_size / MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN +
-            ((part_size % MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN) != 0));
+            _system_impl->mavlink_ftp().download_async(
+                location.directory + "/" + location.file_name,
+                local_folder,
+                [this, entry, file_path, callback, local_folder, local_path](
+                    MavlinkFtp::ClientResult download_result,
+                    MavlinkFtp::ProgressData progress_data) {
+                    if (download_result == MavlinkFtp::ClientResult::Next) {
+                        if (progress_data.total_bytes > 0) {
+                            report_progress(
+                                callback,
+                                progress_data.bytes_transferred,
+                                progress_data.total_bytes);
+                        }
+                        return;
+                    }
+
+                    if (download_result == MavlinkFtp::ClientResult::Success &&
+                        fs_rename(local_path, file_path)) {
+                        fs_remove(local_folder);
+                        if (callback) {
+                            _system_impl->call_user_callback([callback]() {
+                                LogFiles::ProgressData progress;
+                                progress.progress = 1.0f;
+                                callback(LogFiles::Result::Success, progress);
+                            });
+                        }
+                        return;
+                    }
+
+                    LogWarn() << "FTP download of log " << entry.id
+                              << " failed: " << download_result << ", using LOG_DATA";
+                    fs_remove(local_path);
+                    fs_remove(local_folder);
+                    download_log_file_log_data(entry, file_path, callback);
+                });
+        });
+}
 
-        _system_impl->register_timeout_handler(
-            [this]() { LogFilesImpl::data_timeout(); }, DATA_TIMEOUT_S, &_data.cookie);
+void LogFilesImpl::download_log_file_log_data(
+    const LogFiles::Entry& entry,
+    const std::string& file_path,
+    const LogFiles::DownloadLogFileCallback& callback)
+{
+    std::lock_guard<std::mutex> lock(_data.mutex);
 
-        request_log_data(_data.id, _data.part_start, _data.bytes.size());
+    _data.data_callback = nullptr;
+    _data.source = log_data_source(entry);
+    const auto resume_offset =
+        TransferResume::resume_offset(file_path, _data.source, entry.size_bytes);
+    if (resume_offset > 0) {
+        LogDebug() << "Resuming download of log " << entry.id << " at " << resume_offset
+                   << " bytes";
+    }
 
-        if (_data.callback) {
-            const auto tmp_callback = _data.callback;
+    if (!start_logfile(file_path, resume_offset)) {
+        if (callback) {
+            const auto tmp_callback = callback;
             _system_impl->call_user_callback([tmp_callback]() {
                 LogFiles::ProgressData progress;
-                progress.progress = 0.0f;
-                tmp_callback(LogFiles::Result::Next, progress);
+                progress.progress = NAN;
+                tmp_callback(LogFiles::Result::FileOpenFailed, progress);
             });
         }
+        return;
+    }
+
+    start_log_data_requests(entry, resume_offset, callback);
+}
+
+void LogFilesImpl::start_log_data_requests(
+    const LogFiles::Entry& entry,
+    std::size_t offset,
+    const LogFiles::DownloadLogFileCallback& callback)
+{
+    // Assumes to have the lock for _data.mutex.
+
+    _data.id = entry.id;
+    _data.callback = callback;
+    _data.time_started = _time.steady_time();
+    _data.bytes_to_get = entry.size_bytes;
+    _data.part_start = offset;
+    _data.window.reset();
+    const auto part_size = determine_part_end() - _data.part_start;
+    _data.bytes.resize(part_size);
+    _data.chunks_received.resize(
+        part_size / MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN +
+        ((part_size % MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN) != 0));
+
+    restart_data_timeout();
+
+    request_log_data(_data.id, _data.part_start, _data.bytes.size());
+
+    if (_data.callback) {
+        const auto tmp_callback = _data.callback;
+        _system_impl->call_user_callback([tmp_callback]() {
+            LogFiles::ProgressData progress;
+            progress.progress = 0.0f;
+            tmp_callback(LogFiles::Result::Next, progress);
+        });
     }
 }
 
@@ -333,7 +485,7 @@ std::size_t LogFilesImpl::determine_part_end()
     // Assumes to have the lock for _data.mutex.
 
     return std::min(
-        _data.part_start + PART_SIZE * MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN,
+        _data.part_start + _data.window.part_chunks() * MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN,
         std::size_t(_data.bytes_to_get));
 }
 
@@ -355,6 +507,11 @@ void LogFilesImpl::process_log_data(const mavlink_message_t& message)
 
     _system_impl->refresh_timeout_handler(_data.cookie);
 
+    if (_data.waiting_for_data) {
+        _data.waiting_for_data = false;
+        _data.window.add_round_trip(_time.elapsed_since_s(_data.time_requested));
+    }
+
     if (log_data.count > MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN) {
         LogErr() << "Ignoring wrong count";
         return;
@@ -370,20 +527,22 @@ void LogFilesImpl::process_log_data(const mavlink_message_t& message)
     _data.chunks_received[(log_data.ofs - _data.part_start) / MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN] =
         true;
 
-    if (log_data.ofs + log_data.count - _data.part_start == _data.bytes.size() ||
-        _data.rerequesting) {
-        // We received last message of this part.
-        _data.rerequesting = true;
+    // Once the last message of this part, or of the range re-requested last,
+    // is in, we see what is still missing.
+    const std::size_t received_end = log_data.ofs + log_data.count - _data.part_start;
+    if (received_end == _data.bytes.size() ||
+        (_data.rerequesting && received_end >= _data.rerequest_end)) {
         check_part();
     }
 }
 
-void LogFilesImpl::report_progress(unsigned transferred, unsigned total)
+void LogFilesImpl::report_progress(
+    const LogFiles::DownloadLogFileCallback& callback, unsigned transferred, unsigned total)
 {
     float progress = float(transferred) / float(total);
 
-    if (_data.callback) {
-        const auto tmp_callback = _data.callback;
+    if (callback) {
+        const auto tmp_callback = callback;
         _system_impl->call_user_callback([tmp_callback, progress]() {
             LogFiles::ProgressData progress_data;
             progress_data.progress = progress;
@@ -397,26 +556,30 @@ void LogFilesImpl::check_part()
 {
     // Assumes to have the lock for _data.mutex.
 
-    auto first_missing =
-        std::find(_data.chunks_received.begin(), _data.chunks_received.end(), false);
-    if (first_missing != _data.chunks_received.end()) {
-        auto first_missing_index = std::distance(_data.chunks_received.begin(), first_missing);
-
-        auto first_not_missing = std::find(first_missing, _data.chunks_received.end(), true);
+    // Autopilots only serve one request at a time, so the missing ranges are
+    // requested one after the other, each once the previous one is in.
+    const auto missing_ranges = LogDownloadWindow::missing_ranges(_data.chunks_received);
+    if (!missing_ranges.empty()) {
+        const auto start = missing_ranges.front().first * MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN;
+        const auto count = std::min(
+            missing_ranges.front().second * MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN,
+            _data.bytes.size() - start);
 
-        auto first_not_missing_index =
-            std::distance(_data.chunks_received.begin(), first_not_missing);
+        _data.rerequesting = true;
+        _data.rerequest_end = start + count;
+        _data.part_had_loss = true;
 
-        request_log_data(
-            _data.id,
-            _data.part_start + first_missing_index * MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN,
-            (first_not_missing_index - first_missing_index) * MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN);
+        restart_data_timeout();
+        request_log_data(_data.id, _data.part_start + start, count);
     } else {
         _data.rerequesting = false;
+        _data.window.part_done(_data.part_had_loss);
+        _data.part_had_loss = false;
 
-        write_part_to_disk();
+        write_part();
 
-        report_progress(_data.part_start + _data.bytes.size(), _data.bytes_to_get);
+        report_progress(
+            _data.callback, _data.part_start + _data.bytes.size(), _data.bytes_to_get);
 
         const float kib_s = float(_data.part_start + _data.bytes.size()) /
                             float(_time.elapsed_since_s(_data.time_started)) / 1024.0f;
@@ -449,6 +612,7 @@ void LogFilesImpl::check_part()
                 ((part_size % MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN) != 0));
             std::fill(_data.chunks_received.begin(), _data.chunks_received.end(), false);
 
+            restart_data_timeout();
             request_log_data(_data.id, _data.part_start, _data.bytes.size());
         }
     }
@@ -456,6 +620,8 @@ void LogFilesImpl::check_part()
 
 void LogFilesImpl::request_log_data(unsigned id, unsigned start, unsigned count)
 {
+    // Assumes to have the lock for _data.mutex.
+
     // LogDebug() << "requesting: " << start << ".." << start+count << " (" << id << ")";
     mavlink_message_t msg;
     mavlink_msg_log_request_data_pack(
@@ -468,19 +634,31 @@ void LogFilesImpl::request_log_data(unsigned id, unsigned start, unsigned count)
         start,
         count);
     _system_impl->send_message(msg);
+
+    _data.waiting_for_data = true;
+    _data.time_requested = _time.steady_time();
 }
 
 void LogFilesImpl::data_timeout()
 {
     {
         std::lock_guard<std::mutex> lock(_data.mutex);
-        _system_impl->register_timeout_handler(
-            [this]() { LogFilesImpl::data_timeout(); }, DATA_TIMEOUT_S, &_data.cookie);
-        _data.rerequesting = true;
+        // Requests what is missing, which also starts the next timeout.
         check_part();
     }
 }
 
+void LogFilesImpl::restart_data_timeout()
+{
+    // Assumes to have the lock for _data.mutex.
+
+    // The timeout follows the measured round trip time, so it is registered
+    // again for every request instead of just being refreshed.
+    _system_impl->unregister_timeout_handler(_data.cookie);
+    _system_impl->register_timeout_handler(
+        [this]() { LogFilesImpl::data_timeout(); }, _data.window.timeout_s(), &_data.cookie);
+}
+
 bool LogFilesImpl::is_directory(const std::string& path) const
 {
     fs::path file_path(path);
@@ -495,28 +673,63 @@ bool LogFilesImpl::file_exists(const std::string& path) const
     return fs::exists(file_path, ignored);
 }
 
-bool LogFilesImpl::start_logfile(const std::string& path)
+bool LogFilesImpl::start_logfile(const std::string& path, std::size_t offset)
 {
     // Assumes to have the lock for _data.mutex.
     // Assumes that the path is valid and points to a file (not a directory)
 
-    _data.file.open(path, std::ios::out | std::ios::binary);
+    _data.file_path = path;
+    if (offset > 0) {
+        // Keeps what was downloaded before.
+        _data.file.open(path, std::ios::in | std::ios::out | std::ios::binary);
+        _data.file.seekp(static_cast<std::streamoff>(offset));
+    } else {
+        _data.file.open(path, std::ios::out | std::ios::binary);
+    }
 
     return ((_data.file.rdstate() & std::ofstream::failbit) == 0);
 }
 
-void LogFilesImpl::write_part_to_disk()
+void LogFilesImpl::write_part()
 {
     // Assumes to have the lock for _data.mutex.
 
+    if (_data.data_callback) {
+        // In order, as the user callbacks are called one after the other.
+        const auto tmp_callback = _data.data_callback;
+        _system_impl->call_user_callback(
+            [tmp_callback, bytes = _data.bytes]() { tmp_callback(bytes); });
+        return;
+    }
+
     _data.file.write(reinterpret_cast<char*>(_data.bytes.data()), _data.bytes.size());
+    _data.file.flush();
+
+    // So that we can continue from here if the download is interrupted.
+    TransferResume resume;
+    resume.source = _data.source;
+    resume.total_bytes = _data.bytes_to_get;
+    resume.received_bytes = _data.part_start + _data.bytes.size();
+    if (!resume.save(_data.file_path)) {
+        LogWarn() << "Could not save resume info for " << _data.file_path;
+    }
+}
+
+std::string LogFilesImpl::log_data_source(const LogFiles::Entry& entry)
+{
+    return "LOG_DATA " + std::to_string(entry.id) + " " + entry.date;
 }
 
 void LogFilesImpl::finish_logfile()
 {
     // Assumes to have the lock for _data.mutex.
 
+    if (_data.data_callback) {
+        return;
+    }
+
     _data.file.close();
+    TransferResume::remove(_data.file_path);
 }
 
 void LogFilesImpl::reset_data()
@@ -529,8 +742,12 @@ void LogFilesImpl::reset_data()
     _data.part_start = 0;
     _data.retries = 0;
     _data.rerequesting = false;
-    _data.last_ofs_rerequested = -1;
+    _data.rerequest_end = 0;
+    _data.part_had_loss = false;
+    _data.waiting_for_data = false;
     _data.callback = nullptr;
+    _data.data_callback = nullptr;
+    _data.file_path.clear();
 }
 
 } // namespace mavsdk
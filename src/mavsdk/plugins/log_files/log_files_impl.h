@@ -2,6 +2,9 @@
 
 #include "mavlink_include.h"
 #include "plugins/log_files/log_files.h"
+#include "plugins/log_files/log_files_ext.h"
+#include "log_download_window.h"
+#include "log_ftp.h"
 #include "plugin_impl_base.h"
 #include "system.h"
 #include <fstream>
@@ -20,6 +23,8 @@ public:
     void enable() override;
     void disable() override;
 
+    std::optional<MemoryUsage::Plugin> memory_usage() override;
+
     std::pair<LogFiles::Result, std::vector<LogFiles::Entry>> get_entries();
     void get_entries_async(LogFiles::GetEntriesCallback callback);
 
@@ -31,6 +36,11 @@ public:
         const std::string& file_path,
         LogFiles::DownloadLogFileCallback callback);
 
+    void stream_log_file_async(
+        LogFiles::Entry entry,
+        const LogFilesExt::DataCallback& data_callback,
+        const LogFiles::DownloadLogFileCallback& callback);
+
     LogFiles::Result erase_all_log_files();
 
 private:
@@ -39,25 +49,44 @@ private:
     void process_log_entry(const mavlink_message_t& message);
     void process_log_data(const mavlink_message_t& message);
     void list_timeout();
+    double list_timeout_s() const;
 
     void request_list_entry(int entry_id);
 
+    void download_log_file_ftp(
+        const LogFiles::Entry& entry,
+        const LogFtpLocation& location,
+        const std::string& file_path,
+        const LogFiles::DownloadLogFileCallback& callback);
+    void download_log_file_log_data(
+        const LogFiles::Entry& entry,
+        const std::string& file_path,
+        const LogFiles::DownloadLogFileCallback& callback);
+    void start_log_data_requests(
+        const LogFiles::Entry& entry,
+        std::size_t offset,
+        const LogFiles::DownloadLogFileCallback& callback);
+    bool find_entry(LogFiles::Entry& entry, const LogFiles::DownloadLogFileCallback& callback);
+
     void check_part();
     void request_log_data(unsigned id, unsigned start, unsigned count);
     void data_timeout();
+    void restart_data_timeout();
 
     bool is_directory(const std::string& path) const;
     bool file_exists(const std::string& path) const;
-    bool start_logfile(const std::string& path);
-    void write_part_to_disk();
+    bool start_logfile(const std::string& path, std::size_t offset);
+    void write_part();
     void finish_logfile();
-    void report_progress(unsigned transferred, unsigned total);
+    static std::string log_data_source(const LogFiles::Entry& entry);
+    void report_progress(
+        const LogFiles::DownloadLogFileCallback& callback, unsigned transferred, unsigned total);
 
     std::size_t determine_part_end();
     void reset_data();
 
+    // Until the round trip time is known.
     static constexpr double LIST_TIMEOUT_S = 0.2;
-    static constexpr double DATA_TIMEOUT_S = 0.1;
 
     Time _time{};
 
@@ -70,15 +99,14 @@ private:
         void* cookie{nullptr};
     } _entries{};
 
-    // We download data in parts of 512 * 90 bytes.
+    // We download data in parts of a few hundred to a few thousand chunks of
+    // 90 bytes, depending on how well it goes, see LogDownloadWindow.
     // If we request the whole file at once we get too much data at once and
     // can't keep up (at least for PX4 SITL). Also, we need to keep track of
     // way too many parts which makes the progress and re-transmission
     // calculation too expensive.
     //
     // This is very much inspired from how QGroundControl does it.
-    static constexpr unsigned PART_SIZE = 512;
-    // A part refers to the
 
     struct {
         std::mutex mutex{};
@@ -90,9 +118,19 @@ private:
         std::size_t part_start{0};
         unsigned retries{0};
         bool rerequesting{false};
-        int last_ofs_rerequested{-1};
+        // End of the range re-requested last, relative to part_start.
+        std::size_t rerequest_end{0};
+        bool part_had_loss{false};
+        bool waiting_for_data{false};
+        SteadyTimePoint time_requested{};
+        LogDownloadWindow window{};
         SteadyTimePoint time_started{};
         std::ofstream file{};
+        std::string file_path{};
+        // Used instead of the file if set.
+        LogFilesExt::DataCallback data_callback{nullptr};
+        // Identifies the log for resuming, see TransferResume.
+        std::string source{};
         LogFiles::DownloadLogFileCallback callback{nullptr};
     } _data{};
 };
@@ -0,0 +1,38 @@
+#include "log_ftp.h"
+
+#include <cstdio>
+
+namespace mavsdk {
+
+std::optional<LogFtpLocation> px4_log_ftp_location(const LogFiles::Entry& entry)
+{
+    // "yyyy-mm-ddThh:mm:ssZ"
+    if (entry.date.size() != 20 || entry.date[10] != 'T' || entry.date[19] != 'Z') {
+        return {};
+    }
+
+    // Without a valid time, PX4 uses session directories which we can't map.
+    if (entry.date.compare(0, 4, "1970") == 0) {
+        return {};
+    }
+
+    LogFtpLocation location;
+    location.directory = "/fs/microsd/log/" + entry.date.substr(0, 10);
+    location.file_name = entry.date.substr(11, 2) + "_" + entry.date.substr(14, 2) + "_" +
+                         entry.date.substr(17, 2) + ".ulg";
+    return location;
+}
+
+bool ftp_listing_contains(
+    const std::vector<std::string>& listing, const std::string& file_name, uint32_t size_bytes)
+{
+    const std::string expected = "F" + file_name + "\t" + std::to_string(size_bytes);
+    for (const auto& item : listing) {
+        if (item == expected) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace mavsdk
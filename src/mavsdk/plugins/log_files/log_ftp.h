@@ -0,0 +1,26 @@
+#pragma once
+
+#include "plugins/log_files/log_files.h"
+
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace mavsdk {
+
+// PX4 keeps its logs as /fs/microsd/log/yyyy-mm-dd/hh_mm_ss.ulg and takes the
+// time of the log entries from these names, so an entry can be found again
+// over MAVLink FTP from its date.
+struct LogFtpLocation {
+    std::string directory{};
+    std::string file_name{};
+};
+
+std::optional<LogFtpLocation> px4_log_ftp_location(const LogFiles::Entry& entry);
+
+// Whether a MAVLink FTP directory listing, with entries like "Fname\tsize",
+// has the file with exactly this size.
+bool ftp_listing_contains(
+    const std::vector<std::string>& listing, const std::string& file_name, uint32_t size_bytes);
+
+} // namespace mavsdk
@@ -0,0 +1,37 @@
+#include "log_ftp.h"
+
+#include <gtest/gtest.h>
+
+using namespace mavsdk;
+
+TEST(LogFtp, Px4Location)
+{
+    LogFiles::Entry entry{};
+    entry.date = "2018-08-31T20:50:42Z";
+
+    const auto location = px4_log_ftp_location(entry);
+    ASSERT_TRUE(location);
+    EXPECT_EQ(location->directory, "/fs/microsd/log/2018-08-31");
+    EXPECT_EQ(location->file_name, "20_50_42.ulg");
+}
+
+TEST(LogFtp, Px4LocationWithoutTime)
+{
+    LogFiles::Entry entry{};
+    entry.date = "1970-01-01T00:03:12Z";
+    EXPECT_FALSE(px4_log_ftp_location(entry));
+
+    entry.date = "";
+    EXPECT_FALSE(px4_log_ftp_location(entry));
+}
+
+TEST(LogFtp, ListingContains)
+{
+    const std::vector<std::string> listing{"D.", "F20_50_42.ulg\t123456", "F21_00_00.ulg\t42"};
+
+    EXPECT_TRUE(ftp_listing_contains(listing, "20_50_42.ulg", 123456));
+    EXPECT_TRUE(ftp_listing_contains(listing, "21_00_00.ulg", 42));
+    // Same name, still being written or a different log.
+    EXPECT_FALSE(ftp_listing_contains(listing, "20_50_42.ulg", 123));
+    EXPECT_FALSE(ftp_listing_contains(listing, "22_00_00.ulg", 42));
+}
@@ -16,6 +16,7 @@
 
 #include "plugin_base.h"
 
+#include "awaitable.h"
 #include "handle.h"
 
 namespace mavsdk {
@@ -94,7 +95,24 @@ public:
      *
      * This function is non-blocking. See 'start_position_control' for the blocking counterpart.
      */
-    void start_position_control_async(const ResultCallback callback);
+    void start_position_control_async(const ResultCallback& callback);
+
+#ifdef MAVSDK_HAS_COROUTINES
+    /**
+     * @brief Awaitable version of 'start_position_control_async' for C++20 coroutines.
+     *
+     * The coroutine is resumed using the executor if one is given, otherwise on the callback
+     * thread.
+     */
+    Awaitable<ResultCallback> start_position_control_awaitable(Executor executor = {})
+    {
+        return Awaitable<ResultCallback>(
+            [=, this](const ResultCallback& callback) {
+                start_position_control_async(callback);
+            },
+            std::move(executor));
+    }
+#endif
 
     /**
      * @brief Start position control using e.g. joystick input.
@@ -117,7 +135,24 @@ public:
      *
      * This function is non-blocking. See 'start_altitude_control' for the blocking counterpart.
      */
-    void start_altitude_control_async(const ResultCallback callback);
+    void start_altitude_control_async(const ResultCallback& callback);
+
+#ifdef MAVSDK_HAS_COROUTINES
+    /**
+     * @brief Awaitable version of 'start_altitude_control_async' for C++20 coroutines.
+     *
+     * The coroutine is resumed using the executor if one is given, otherwise on the callback
+     * thread.
+     */
+    Awaitable<ResultCallback> start_altitude_control_awaitable(Executor executor = {})
+    {
+        return Awaitable<ResultCallback>(
+            [=, this](const ResultCallback& callback) {
+                start_altitude_control_async(callback);
+            },
+            std::move(executor));
+    }
+#endif
 
     /**
      * @brief Start altitude control
@@ -157,6 +192,9 @@ public:
 private:
     /** @private Underlying implementation, set at instantiation */
     std::unique_ptr<ManualControlImpl> _impl;
+
+    /** @private Hand-written additions in manual_control_ext.h, if any */
+    friend class ManualControlExt;
 };
 
 } // namespace mavsdk
\ No newline at end of file
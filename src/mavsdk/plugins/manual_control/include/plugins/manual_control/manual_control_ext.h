@@ -0,0 +1,50 @@
+#pragma once
+
+#include "plugins/manual_control/manual_control.h"
+
+namespace mavsdk {
+
+class ManualControlImpl;
+
+/**
+ * @brief Additions to ManualControl that are only available in C++.
+ *
+ * Unlike manual_control.h, this header is not generated from the proto files,
+ * so the calls here are not available through mavsdk_server.
+ *
+ * It works on the ManualControl plugin it is created with, which has to outlive it:
+ *
+ *     ```cpp
+ *     auto manual_control = ManualControl(system);
+ *     auto manual_control_ext = ManualControlExt(manual_control);
+ *     ```
+ */
+class ManualControlExt {
+public:
+    /**
+     * @brief Constructor. Uses the given ManualControl plugin.
+     *
+     * @param manual_control The plugin, which has to outlive this object.
+     */
+    explicit ManualControlExt(ManualControl& manual_control);
+
+    /**
+     * @brief Send manual control input at a fixed rate.
+     *
+     * Once a rate is set, set_manual_control_input only stores the input, and the
+     * latest one is sent at the given rate, no matter how often it is set. The
+     * input is repeated until no new one has been set for a second, so that RC
+     * loss is still detected if the input stops. A rate of 0 sends every input
+     * directly again, which is the default.
+     *
+     * This function is blocking.
+     *
+     * @return Result of request.
+     */
+    ManualControl::Result set_input_rate(double rate_hz) const;
+
+private:
+    ManualControlImpl& _impl;
+};
+
+} // namespace mavsdk
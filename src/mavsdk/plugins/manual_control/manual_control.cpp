@@ -22,7 +22,7 @@ ManualControl::ManualControl(std::shared_ptr<System> system) :
 
 ManualControl::~ManualControl() {}
 
-void ManualControl::start_position_control_async(const ResultCallback callback)
+void ManualControl::start_position_control_async(const ResultCallback& callback)
 {
     _impl->start_position_control_async(callback);
 }
@@ -32,7 +32,7 @@ ManualControl::Result ManualControl::start_position_control() const
     return _impl->start_position_control();
 }
 
-void ManualControl::start_altitude_control_async(const ResultCallback callback)
+void ManualControl::start_altitude_control_async(const ResultCallback& callback)
 {
     _impl->start_altitude_control_async(callback);
 }
@@ -0,0 +1,13 @@
+#include "manual_control_impl.h"
+#include "plugins/manual_control/manual_control_ext.h"
+
+namespace mavsdk {
+
+ManualControlExt::ManualControlExt(ManualControl& manual_control) : _impl(*manual_control._impl) {}
+
+ManualControl::Result ManualControlExt::set_input_rate(double rate_hz) const
+{
+    return _impl.set_input_rate(rate_hz);
+}
+
+} // namespace mavsdk
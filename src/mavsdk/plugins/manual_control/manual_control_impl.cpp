@@ -21,7 +21,12 @@ ManualControlImpl::~ManualControlImpl()
 
 void ManualControlImpl::init() {}
 
-void ManualControlImpl::deinit() {}
+void ManualControlImpl::deinit()
+{
+    std::lock_guard<std::mutex> lock(_input_streamer_mutex);
+    _input_scheduled = false;
+    _input_streamer.reset();
+}
 
 void ManualControlImpl::enable() {}
 
@@ -98,6 +103,57 @@ ManualControlImpl::set_manual_control_input(float x, float y, float z, float r)
         _input = Input::Set;
     }
 
+    if (_input_scheduled) {
+        // Inputs coming faster than the rate just replace the previous one.
+        _latest_input.store(LatestInput{x, y, z, r, _time.steady_time()});
+        return ManualControl::Result::Success;
+    }
+
+    return send_manual_control_input(x, y, z, r);
+}
+
+ManualControl::Result ManualControlImpl::set_input_rate(double rate_hz)
+{
+    std::lock_guard<std::mutex> lock(_input_streamer_mutex);
+
+    if (rate_hz == 0.0) {
+        _input_scheduled = false;
+        _input_streamer.reset();
+        return ManualControl::Result::Success;
+    }
+
+    if (_input_streamer == nullptr) {
+        _input_streamer = std::make_unique<SetpointStreamer>();
+    }
+    if (!_input_streamer->set_rate_hz(rate_hz)) {
+        return ManualControl::Result::InputOutOfRange;
+    }
+
+    if (!_input_scheduled.exchange(true)) {
+        // Nothing is sent until the next input arrives.
+        _latest_input.store(LatestInput{});
+        _input_streamer->start([this]() { send_latest_input(); });
+    }
+    return ManualControl::Result::Success;
+}
+
+void ManualControlImpl::send_latest_input()
+{
+    const auto input = _latest_input.load();
+
+    // Not set yet, or the input stopped, in which case repeating the last one
+    // would hide that from the autopilot's RC loss failsafe.
+    if (input.set_time == SteadyTimePoint{} ||
+        _time.elapsed_since_s(input.set_time) > input_timeout_s) {
+        return;
+    }
+
+    send_manual_control_input(input.x, input.y, input.z, input.r);
+}
+
+ManualControl::Result
+ManualControlImpl::send_manual_control_input(float x, float y, float z, float r)
+{
     // No buttons/extensions supported yet.
     const uint16_t buttons = 0;
     const uint16_t buttons2 = 0;
@@ -1,7 +1,14 @@
 #pragma once
 
 #include "plugins/manual_control/manual_control.h"
+#include "mavsdk_time.h"
 #include "plugin_impl_base.h"
+#include "seqlock.h"
+#include "setpoint_streamer.h"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
 
 namespace mavsdk {
 
@@ -27,13 +34,38 @@ public:
 
     ManualControl::Result set_manual_control_input(float x, float y, float z, float r);
 
+    ManualControl::Result set_input_rate(double rate_hz);
+
 private:
+    ManualControl::Result send_manual_control_input(float x, float y, float z, float r);
+    void send_latest_input();
+
     ManualControl::Result
     manual_control_result_from_command_result(MavlinkCommandSender::Result result);
     void command_result_callback(
         MavlinkCommandSender::Result command_result, const ManualControl::ResultCallback& callback);
 
     enum class Input { NotSet, Set } _input{Input::NotSet};
+
+    // If an input rate is set, the latest input is stored and sent by the
+    // streamer instead. It is repeated until no new input has arrived for
+    // a while, so that the autopilot still notices if the input stops.
+    struct LatestInput {
+        float x{0.0f};
+        float y{0.0f};
+        float z{0.0f};
+        float r{0.0f};
+        SteadyTimePoint set_time{};
+    };
+    static constexpr double input_timeout_s = 1.0;
+
+    Time _time{};
+    Seqlock<LatestInput> _latest_input{};
+    std::atomic<bool> _input_scheduled{false};
+
+    std::mutex _input_streamer_mutex{};
+    // Needs _input_streamer_mutex, only allocated if a rate is set.
+    std::unique_ptr<SetpointStreamer> _input_streamer{};
 };
 
 } // namespace mavsdk
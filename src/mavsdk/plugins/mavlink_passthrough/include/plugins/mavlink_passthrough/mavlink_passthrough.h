@@ -4,6 +4,7 @@
 #include <string>
 #include <functional>
 #include <optional>
+#include <vector>
 
 // This plugin provides/includes the mavlink 2.0 header files.
 #include "mavlink_include.h"
@@ -74,6 +75,8 @@ public:
         ParamValueTooLong, /**< @brief Param value too long. */
         ParamNotFound, /**< @brief Param not found. */
         ParamValueUnsupported, /**< @brief Param value unsupported. */
+        InvalidFrame, /**< @brief Data is not only complete MAVLink frames. */
+        Unsupported, /**< @brief Frames can't be sent as they are, e.g. with signing. */
     };
 
     /**
@@ -90,6 +93,25 @@ public:
      */
     Result send_message(mavlink_message_t& message);
 
+    /**
+     * @brief Send already serialized MAVLink 1 or 2 frames as they are.
+     *
+     * This is for frames from elsewhere, e.g. from another router, which
+     * then don't need to be decoded and packed again. Only the frame
+     * headers are checked, not the checksums.
+     *
+     * The frames are routed and logged like other messages. Frames which
+     * would need to be changed can't be sent this way, so nothing is sent
+     * and Unsupported is returned while message signing is enabled, or if
+     * outgoing messages with the ID of one of the frames are intercepted.
+     *
+     * @param data One or more complete frames.
+     * @param len Length of the data in bytes.
+     *
+     * @return result of the request.
+     */
+    Result send_frames(const uint8_t* data, size_t len);
+
     /**
      * @brief Type for MAVLink command_long.
      */
@@ -196,6 +218,61 @@ public:
      */
     void unsubscribe_message(MessageHandle handle);
 
+    /**
+     * @brief Which messages a batch subscription gets.
+     */
+    struct MessageFilter {
+        std::vector<uint16_t> message_ids{}; /**< @brief The MAVLink message IDs. */
+        std::optional<uint8_t> system_id{}; /**< @brief Only from this system, if set. */
+        std::optional<uint8_t> component_id{}; /**< @brief Only from this component, if set. */
+    };
+
+    /**
+     * @brief Where the callback of a batch subscription is called.
+     */
+    enum class Delivery {
+        Queued, /**< @brief On the user callback thread, like other callbacks. */
+        Inline, /**< @brief Directly on the thread receiving, it must not block. */
+    };
+
+    /**
+     * @brief The messages of a batch, only valid during the callback.
+     */
+    using MessageBatch = std::vector<const mavlink_message_t*>;
+
+    /**
+     * @brief Callback type for batch subscriptions.
+     */
+    using MessageBatchCallback = std::function<void(const MessageBatch&)>;
+
+    /**
+     * @brief Handle type for subscribe_message_batch.
+     */
+    using MessageBatchHandle = Handle<const MessageBatch&>;
+
+    /**
+     * @brief Subscribe to the messages matching a filter, in batches.
+     *
+     * The messages received in one go, e.g. in one UDP datagram, are given
+     * to the callback at once, in the order they were received, and without
+     * copying them. This is a lot cheaper than a callback per message when
+     * many messages are received.
+     *
+     * With queued delivery, batches received while the callback was still
+     * queued are merged, so a slow callback gets fewer, bigger batches.
+     *
+     * @param filter The messages to get.
+     * @param delivery Where the callback is called.
+     * @param callback Callback to be called with each batch.
+     */
+    MessageBatchHandle subscribe_message_batch(
+        const MessageFilter& filter, Delivery delivery, const MessageBatchCallback& callback);
+
+    /**
+     * @brief Unsubscribe from subscribe_message_batch.
+     */
+    void unsubscribe_message_batch(MessageBatchHandle handle);
+
     /**
      * @brief Get our own system ID.
      *
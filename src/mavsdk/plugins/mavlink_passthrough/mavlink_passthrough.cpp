@@ -20,6 +20,11 @@ MavlinkPassthrough::Result MavlinkPassthrough::send_message(mavlink_message_t& m
     return _impl->send_message(message);
 }
 
+MavlinkPassthrough::Result MavlinkPassthrough::send_frames(const uint8_t* data, size_t len)
+{
+    return _impl->send_frames(data, len);
+}
+
 MavlinkPassthrough::Result MavlinkPassthrough::send_command_int(const CommandInt& command)
 {
     return _impl->send_command_int(command);
@@ -62,6 +67,17 @@ void MavlinkPassthrough::unsubscribe_message(MessageHandle handle)
     _impl->unsubscribe_message(handle);
 }
 
+MavlinkPassthrough::MessageBatchHandle MavlinkPassthrough::subscribe_message_batch(
+    const MessageFilter& filter, Delivery delivery, const MessageBatchCallback& callback)
+{
+    return _impl->subscribe_message_batch(filter, delivery, callback);
+}
+
+void MavlinkPassthrough::unsubscribe_message_batch(MessageBatchHandle handle)
+{
+    _impl->unsubscribe_message_batch(handle);
+}
+
 std::ostream& operator<<(std::ostream& str, MavlinkPassthrough::Result const& result)
 {
     switch (result) {
@@ -97,6 +113,10 @@ std::ostream& operator<<(std::ostream& str, MavlinkPassthrough::Result const& re
             return str << "ParamNotFound";
         case MavlinkPassthrough::Result::ParamValueUnsupported:
             return str << "ParamValueUnsupported";
+        case MavlinkPassthrough::Result::InvalidFrame:
+            return str << "InvalidFrame";
+        case MavlinkPassthrough::Result::Unsupported:
+            return str << "Unsupported";
     }
 }
 
@@ -2,10 +2,34 @@
 #include "mavlink_passthrough_impl.h"
 #include "system.h"
 #include "callback_list.tpp"
+#include "mavlink_frame.h"
+#include "mavlink_message_buffer.h"
+#include "receive_burst.h"
+
+#include <algorithm>
+#include <utility>
 
 namespace mavsdk {
 
 template class CallbackList<const mavlink_message_t&>;
+template class CallbackList<const MavlinkPassthrough::MessageBatch&>;
+
+namespace {
+
+// The buffers of the batch being handed to the batch subscriptions on this
+// thread, so that queued subscriptions can keep the messages they want
+// instead of copying them.
+thread_local std::vector<MavlinkMessageBuffer>* delivering_buffers{nullptr};
+
+bool matches(const MavlinkPassthrough::MessageFilter& filter, const mavlink_message_t& message)
+{
+    return (!filter.system_id || message.sysid == filter.system_id.value()) &&
+           (!filter.component_id || message.compid == filter.component_id.value()) &&
+           std::find(filter.message_ids.begin(), filter.message_ids.end(), message.msgid) !=
+               filter.message_ids.end();
+}
+
+} // namespace
 
 MavlinkPassthroughImpl::MavlinkPassthroughImpl(System& system) : PluginImplBase(system)
 {
@@ -29,6 +53,11 @@ void MavlinkPassthroughImpl::deinit()
 {
     _system_impl->unregister_all_mavlink_message_handlers(this);
     _message_subscriptions.clear();
+    _batch_subscriptions.clear();
+
+    std::lock_guard<std::mutex> lock(_message_ids_mutex);
+    _registered_message_ids.clear();
+    _batch_message_ids.clear();
 }
 
 void MavlinkPassthroughImpl::enable() {}
@@ -43,6 +72,24 @@ MavlinkPassthrough::Result MavlinkPassthroughImpl::send_message(mavlink_message_
     return MavlinkPassthrough::Result::Success;
 }
 
+MavlinkPassthrough::Result MavlinkPassthroughImpl::send_frames(const uint8_t* data, size_t len)
+{
+    MavlinkFrame frame;
+    for (size_t pos = 0; pos < len; pos += frame.len) {
+        if (!MavlinkFrame::parse(&data[pos], len - pos, frame)) {
+            return MavlinkPassthrough::Result::InvalidFrame;
+        }
+        if (_system_impl->changes_outgoing(frame.msgid)) {
+            return MavlinkPassthrough::Result::Unsupported;
+        }
+    }
+
+    if (!_system_impl->send_frames(data, len)) {
+        return MavlinkPassthrough::Result::ConnectionError;
+    }
+    return MavlinkPassthrough::Result::Success;
+}
+
 MavlinkPassthrough::Result
 MavlinkPassthroughImpl::send_command_long(const MavlinkPassthrough::CommandLong& command)
 {
@@ -189,12 +236,7 @@ MavlinkPassthroughImpl::to_mavlink_passthrough_result_from_mavlink_params_result
 MavlinkPassthrough::MessageHandle MavlinkPassthroughImpl::subscribe_message(
     uint16_t message_id, const MavlinkPassthrough::MessageCallback& callback)
 {
-    if (_message_subscriptions.find(message_id) == _message_subscriptions.end()) {
-        _system_impl->register_mavlink_message_handler(
-            message_id,
-            [this](const mavlink_message_t& message) { receive_mavlink_message(message); },
-            this);
-    }
+    register_message_handler(message_id);
 
     return _message_subscriptions[message_id].subscribe(callback);
 }
@@ -208,10 +250,140 @@ void MavlinkPassthroughImpl::unsubscribe_message(MavlinkPassthrough::MessageHand
     }
 }
 
+MavlinkPassthrough::MessageBatchHandle MavlinkPassthroughImpl::subscribe_message_batch(
+    const MavlinkPassthrough::MessageFilter& filter,
+    MavlinkPassthrough::Delivery delivery,
+    const MavlinkPassthrough::MessageBatchCallback& callback)
+{
+    for (const auto message_id : filter.message_ids) {
+        {
+            std::lock_guard<std::mutex> lock(_message_ids_mutex);
+            _batch_message_ids.insert(message_id);
+        }
+        register_message_handler(message_id);
+    }
+
+    if (delivery == MavlinkPassthrough::Delivery::Inline) {
+        return _batch_subscriptions.subscribe(
+            [filter, callback](const MavlinkPassthrough::MessageBatch& batch) {
+                MavlinkPassthrough::MessageBatch filtered;
+                for (const auto* message : batch) {
+                    if (matches(filter, *message)) {
+                        filtered.push_back(message);
+                    }
+                }
+                if (!filtered.empty()) {
+                    callback(filtered);
+                }
+            });
+    }
+
+    auto queued_batch = std::make_shared<QueuedBatch>();
+    return _batch_subscriptions.subscribe(
+        [system_impl = _system_impl, filter, callback, queued_batch](
+            const MavlinkPassthrough::MessageBatch& batch) {
+            bool should_queue = false;
+            {
+                std::lock_guard<std::mutex> lock(queued_batch->mutex);
+                for (size_t i = 0; i < batch.size(); ++i) {
+                    if (matches(filter, *batch[i])) {
+                        queued_batch->messages.push_back((*delivering_buffers)[i]);
+                    }
+                }
+                // While the callback is queued, it takes what arrives in the
+                // meantime as well.
+                if (!queued_batch->scheduled && !queued_batch->messages.empty()) {
+                    queued_batch->scheduled = true;
+                    should_queue = true;
+                }
+            }
+            if (should_queue) {
+                queue_batch(system_impl, queued_batch, callback);
+            }
+        });
+}
+
+void MavlinkPassthroughImpl::unsubscribe_message_batch(
+    MavlinkPassthrough::MessageBatchHandle handle)
+{
+    // The message handlers stay registered, they are cheap without
+    // subscriptions.
+    _batch_subscriptions.unsubscribe(handle);
+}
+
+void MavlinkPassthroughImpl::register_message_handler(uint16_t message_id)
+{
+    {
+        std::lock_guard<std::mutex> lock(_message_ids_mutex);
+        if (!_registered_message_ids.insert(message_id).second) {
+            return;
+        }
+    }
+
+    _system_impl->register_mavlink_message_handler(
+        message_id,
+        [this](const mavlink_message_t& message) { receive_mavlink_message(message); },
+        this);
+}
+
 void MavlinkPassthroughImpl::receive_mavlink_message(const mavlink_message_t& message)
 {
-    _message_subscriptions[message.msgid].queue(
-        message, [this](const auto& func) { _system_impl->call_user_callback(func); });
+    const auto it = _message_subscriptions.find(message.msgid);
+    if (it != _message_subscriptions.end()) {
+        // The queued callbacks share the received message instead of each
+        // getting a copy.
+        const auto buffer = MavlinkMessageBuffer::retain(message);
+        it->second.queue_calls(
+            [&buffer](const MavlinkPassthrough::MessageCallback& callback)
+                -> std::function<void()> { return [callback, buffer]() { callback(*buffer); }; },
+            [this](const auto& func) { _system_impl->call_user_callback(func); });
+    }
+
+    bool is_batched = false;
+    {
+        std::lock_guard<std::mutex> lock(_message_ids_mutex);
+        is_batched = _batch_message_ids.find(message.msgid) != _batch_message_ids.end();
+    }
+    if (is_batched && !_batch_subscriptions.empty()) {
+        ReceiveBurst::collect(this, message, [this](std::vector<MavlinkMessageBuffer>& messages) {
+            deliver_batch(messages);
+        });
+    }
+}
+
+void MavlinkPassthroughImpl::deliver_batch(std::vector<MavlinkMessageBuffer>& messages)
+{
+    MavlinkPassthrough::MessageBatch batch;
+    batch.reserve(messages.size());
+    for (const auto& message : messages) {
+        batch.push_back(&*message);
+    }
+
+    delivering_buffers = &messages;
+    _batch_subscriptions(batch);
+    delivering_buffers = nullptr;
+}
+
+void MavlinkPassthroughImpl::queue_batch(
+    const std::shared_ptr<SystemImpl>& system_impl,
+    const std::shared_ptr<QueuedBatch>& queued_batch,
+    const MavlinkPassthrough::MessageBatchCallback& callback)
+{
+    system_impl->call_user_callback([queued_batch, callback]() {
+        std::vector<MavlinkMessageBuffer> messages;
+        {
+            std::lock_guard<std::mutex> lock(queued_batch->mutex);
+            messages = std::exchange(queued_batch->messages, {});
+            queued_batch->scheduled = false;
+        }
+
+        MavlinkPassthrough::MessageBatch batch;
+        batch.reserve(messages.size());
+        for (const auto& message : messages) {
+            batch.push_back(&*message);
+        }
+        callback(batch);
+    });
 }
 
 uint8_t MavlinkPassthroughImpl::get_our_sysid() const
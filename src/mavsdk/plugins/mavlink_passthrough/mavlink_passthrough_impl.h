@@ -1,11 +1,14 @@
 #pragma once
 
 #include <mutex>
+#include <unordered_set>
+#include <vector>
 
 #include "mavlink_include.h"
 #include "plugins/mavlink_passthrough/mavlink_passthrough.h"
 #include "plugin_impl_base.h"
 #include "callback_list.h"
+#include "mavlink_message_buffer.h"
 
 namespace mavsdk {
 
@@ -22,6 +25,7 @@ public:
     void disable() override;
 
     MavlinkPassthrough::Result send_message(mavlink_message_t& message);
+    MavlinkPassthrough::Result send_frames(const uint8_t* data, size_t len);
     MavlinkPassthrough::Result send_command_long(const MavlinkPassthrough::CommandLong& command);
     MavlinkPassthrough::Result send_command_int(const MavlinkPassthrough::CommandInt& command);
     mavlink_message_t make_command_ack_message(
@@ -39,13 +43,34 @@ public:
 
     void unsubscribe_message(MavlinkPassthrough::MessageHandle handle);
 
+    MavlinkPassthrough::MessageBatchHandle subscribe_message_batch(
+        const MavlinkPassthrough::MessageFilter& filter,
+        MavlinkPassthrough::Delivery delivery,
+        const MavlinkPassthrough::MessageBatchCallback& callback);
+
+    void unsubscribe_message_batch(MavlinkPassthrough::MessageBatchHandle handle);
+
     uint8_t get_our_sysid() const;
     uint8_t get_our_compid() const;
     uint8_t get_target_sysid() const;
     uint8_t get_target_compid() const;
 
 private:
+    // The messages of a queued batch subscription waiting for the callback.
+    struct QueuedBatch {
+        std::mutex mutex{};
+        std::vector<MavlinkMessageBuffer> messages{}; // Needs mutex
+        bool scheduled{false}; // Needs mutex
+    };
+
+    void register_message_handler(uint16_t message_id);
     void receive_mavlink_message(const mavlink_message_t& message);
+    void deliver_batch(std::vector<MavlinkMessageBuffer>& messages);
+
+    static void queue_batch(
+        const std::shared_ptr<SystemImpl>& system_impl,
+        const std::shared_ptr<QueuedBatch>& queued_batch,
+        const MavlinkPassthrough::MessageBatchCallback& callback);
 
     static MavlinkPassthrough::Result
     to_mavlink_passthrough_result_from_mavlink_commands_result(MavlinkCommandSender::Result result);
@@ -54,6 +79,13 @@ private:
     to_mavlink_passthrough_result_from_mavlink_params_result(MAVLinkParameters::Result result);
 
     std::unordered_map<uint16_t, CallbackList<const mavlink_message_t&>> _message_subscriptions{};
+
+    std::mutex _message_ids_mutex{};
+    std::unordered_set<uint16_t> _registered_message_ids{}; // Needs _message_ids_mutex
+    std::unordered_set<uint16_t> _batch_message_ids{}; // Needs _message_ids_mutex
+
+    // Each callback filters the whole burst for its subscription.
+    CallbackList<const MavlinkPassthrough::MessageBatch&> _batch_subscriptions{};
 };
 
 } // namespace mavsdk
@@ -15,6 +15,7 @@
 
 #include "plugin_base.h"
 
+#include "awaitable.h"
 #include "handle.h"
 
 namespace mavsdk {
@@ -287,7 +288,25 @@ public:
      *
      * This function is non-blocking. See 'upload_mission' for the blocking counterpart.
      */
-    void upload_mission_async(MissionPlan mission_plan, const ResultCallback callback);
+    void upload_mission_async(const MissionPlan& mission_plan, const ResultCallback& callback);
+
+#ifdef MAVSDK_HAS_COROUTINES
+    /**
+     * @brief Awaitable version of 'upload_mission_async' for C++20 coroutines.
+     *
+     * The coroutine is resumed using the executor if one is given, otherwise on the callback
+     * thread.
+     */
+    Awaitable<ResultCallback> upload_mission_awaitable(
+        const MissionPlan& mission_plan, Executor executor = {})
+    {
+        return Awaitable<ResultCallback>(
+            [=, this](const ResultCallback& callback) {
+                upload_mission_async(mission_plan, callback);
+            },
+            std::move(executor));
+    }
+#endif
 
     /**
      * @brief Upload a list of mission items to the system.
@@ -299,7 +318,7 @@ public:
      *
      * @return Result of request.
      */
-    Result upload_mission(MissionPlan mission_plan) const;
+    Result upload_mission(const MissionPlan& mission_plan) const;
 
     /**
      * @brief Callback type for upload_mission_with_progress_async.
@@ -313,7 +332,7 @@ public:
      * executed even if the connection is lost.
      */
     void upload_mission_with_progress_async(
-        MissionPlan mission_plan, const UploadMissionWithProgressCallback& callback);
+        const MissionPlan& mission_plan, const UploadMissionWithProgressCallback& callback);
 
     /**
      * @brief Cancel an ongoing mission upload.
@@ -337,7 +356,24 @@ public:
      *
      * This function is non-blocking. See 'download_mission' for the blocking counterpart.
      */
-    void download_mission_async(const DownloadMissionCallback callback);
+    void download_mission_async(const DownloadMissionCallback& callback);
+
+#ifdef MAVSDK_HAS_COROUTINES
+    /**
+     * @brief Awaitable version of 'download_mission_async' for C++20 coroutines.
+     *
+     * The coroutine is resumed using the executor if one is given, otherwise on the callback
+     * thread.
+     */
+    Awaitable<DownloadMissionCallback> download_mission_awaitable(Executor executor = {})
+    {
+        return Awaitable<DownloadMissionCallback>(
+            [=, this](const DownloadMissionCallback& callback) {
+                download_mission_async(callback);
+            },
+            std::move(executor));
+    }
+#endif
 
     /**
      * @brief Download a list of mission items from the system (asynchronous).
@@ -380,7 +416,24 @@ public:
      *
      * This function is non-blocking. See 'start_mission' for the blocking counterpart.
      */
-    void start_mission_async(const ResultCallback callback);
+    void start_mission_async(const ResultCallback& callback);
+
+#ifdef MAVSDK_HAS_COROUTINES
+    /**
+     * @brief Awaitable version of 'start_mission_async' for C++20 coroutines.
+     *
+     * The coroutine is resumed using the executor if one is given, otherwise on the callback
+     * thread.
+     */
+    Awaitable<ResultCallback> start_mission_awaitable(Executor executor = {})
+    {
+        return Awaitable<ResultCallback>(
+            [=, this](const ResultCallback& callback) {
+                start_mission_async(callback);
+            },
+            std::move(executor));
+    }
+#endif
 
     /**
      * @brief Start the mission.
@@ -403,7 +456,24 @@ public:
      *
      * This function is non-blocking. See 'pause_mission' for the blocking counterpart.
      */
-    void pause_mission_async(const ResultCallback callback);
+    void pause_mission_async(const ResultCallback& callback);
+
+#ifdef MAVSDK_HAS_COROUTINES
+    /**
+     * @brief Awaitable version of 'pause_mission_async' for C++20 coroutines.
+     *
+     * The coroutine is resumed using the executor if one is given, otherwise on the callback
+     * thread.
+     */
+    Awaitable<ResultCallback> pause_mission_awaitable(Executor executor = {})
+    {
+        return Awaitable<ResultCallback>(
+            [=, this](const ResultCallback& callback) {
+                pause_mission_async(callback);
+            },
+            std::move(executor));
+    }
+#endif
 
     /**
      * @brief Pause the mission.
@@ -424,7 +494,24 @@ public:
      *
      * This function is non-blocking. See 'clear_mission' for the blocking counterpart.
      */
-    void clear_mission_async(const ResultCallback callback);
+    void clear_mission_async(const ResultCallback& callback);
+
+#ifdef MAVSDK_HAS_COROUTINES
+    /**
+     * @brief Awaitable version of 'clear_mission_async' for C++20 coroutines.
+     *
+     * The coroutine is resumed using the executor if one is given, otherwise on the callback
+     * thread.
+     */
+    Awaitable<ResultCallback> clear_mission_awaitable(Executor executor = {})
+    {
+        return Awaitable<ResultCallback>(
+            [=, this](const ResultCallback& callback) {
+                clear_mission_async(callback);
+            },
+            std::move(executor));
+    }
+#endif
 
     /**
      * @brief Clear the mission saved on the vehicle.
@@ -446,7 +533,25 @@ public:
      *
      * This function is non-blocking. See 'set_current_mission_item' for the blocking counterpart.
      */
-    void set_current_mission_item_async(int32_t index, const ResultCallback callback);
+    void set_current_mission_item_async(int32_t index, const ResultCallback& callback);
+
+#ifdef MAVSDK_HAS_COROUTINES
+    /**
+     * @brief Awaitable version of 'set_current_mission_item_async' for C++20 coroutines.
+     *
+     * The coroutine is resumed using the executor if one is given, otherwise on the callback
+     * thread.
+     */
+    Awaitable<ResultCallback> set_current_mission_item_awaitable(
+        int32_t index, Executor executor = {})
+    {
+        return Awaitable<ResultCallback>(
+            [=, this](const ResultCallback& callback) {
+                set_current_mission_item_async(index, callback);
+            },
+            std::move(executor));
+    }
+#endif
 
     /**
      * @brief Sets the mission item index to go to.
@@ -537,6 +642,9 @@ public:
 private:
     /** @private Underlying implementation, set at instantiation */
     std::unique_ptr<MissionImpl> _impl;
+
+    /** @private Hand-written additions in mission_ext.h, if any */
+    friend class MissionExt;
 };
 
 } // namespace mavsdk
\ No newline at end of file
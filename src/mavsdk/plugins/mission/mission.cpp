@@ -25,18 +25,18 @@ Mission::Mission(std::shared_ptr<System> system) :
 
 Mission::~Mission() {}
 
-void Mission::upload_mission_async(MissionPlan mission_plan, const ResultCallback callback)
+void Mission::upload_mission_async(const MissionPlan& mission_plan, const ResultCallback& callback)
 {
     _impl->upload_mission_async(mission_plan, callback);
 }
 
-Mission::Result Mission::upload_mission(MissionPlan mission_plan) const
+Mission::Result Mission::upload_mission(const MissionPlan& mission_plan) const
 {
     return _impl->upload_mission(mission_plan);
 }
 
 void Mission::upload_mission_with_progress_async(
-    MissionPlan mission_plan, const UploadMissionWithProgressCallback& callback)
+    const MissionPlan& mission_plan, const UploadMissionWithProgressCallback& callback)
 {
     _impl->upload_mission_with_progress_async(mission_plan, callback);
 }
@@ -46,7 +46,7 @@ Mission::Result Mission::cancel_mission_upload() const
     return _impl->cancel_mission_upload();
 }
 
-void Mission::download_mission_async(const DownloadMissionCallback callback)
+void Mission::download_mission_async(const DownloadMissionCallback& callback)
 {
     _impl->download_mission_async(callback);
 }
@@ -67,7 +67,7 @@ Mission::Result Mission::cancel_mission_download() const
     return _impl->cancel_mission_download();
 }
 
-void Mission::start_mission_async(const ResultCallback callback)
+void Mission::start_mission_async(const ResultCallback& callback)
 {
     _impl->start_mission_async(callback);
 }
@@ -77,7 +77,7 @@ Mission::Result Mission::start_mission() const
     return _impl->start_mission();
 }
 
-void Mission::pause_mission_async(const ResultCallback callback)
+void Mission::pause_mission_async(const ResultCallback& callback)
 {
     _impl->pause_mission_async(callback);
 }
@@ -87,7 +87,7 @@ Mission::Result Mission::pause_mission() const
     return _impl->pause_mission();
 }
 
-void Mission::clear_mission_async(const ResultCallback callback)
+void Mission::clear_mission_async(const ResultCallback& callback)
 {
     _impl->clear_mission_async(callback);
 }
@@ -97,7 +97,7 @@ Mission::Result Mission::clear_mission() const
     return _impl->clear_mission();
 }
 
-void Mission::set_current_mission_item_async(int32_t index, const ResultCallback callback)
+void Mission::set_current_mission_item_async(int32_t index, const ResultCallback& callback)
 {
     _impl->set_current_mission_item_async(index, callback);
 }
@@ -1,5 +1,6 @@
 #include "mission_impl.h"
 #include "system.h"
+#include "decoded_message.h"
 #include "unused.h"
 #include "callback_list.tpp"
 #include <algorithm>
@@ -51,11 +52,8 @@ void MissionImpl::enable()
     _system_impl->register_timeout_handler(
         [this]() { receive_protocol_timeout(); }, 1.0, &_gimbal_protocol_cookie);
 
-    MavlinkCommandSender::CommandLong command{};
-    command.command = MAV_CMD_REQUEST_MESSAGE;
-    command.params.maybe_param1 = static_cast<float>(MAVLINK_MSG_ID_GIMBAL_MANAGER_INFORMATION);
-    command.target_component_id = 0; // any component
-    _system_impl->send_command_async(command, nullptr);
+    // Shared with the gimbal plugin if both are used.
+    _system_impl->add_connect_request(MAVLINK_MSG_ID_GIMBAL_MANAGER_INFORMATION, 0);
 }
 
 void MissionImpl::disable()
@@ -82,20 +80,37 @@ void MissionImpl::reset_mission_progress()
 
 void MissionImpl::process_mission_current(const mavlink_message_t& message)
 {
-    mavlink_mission_current_t mission_current;
-    mavlink_msg_mission_current_decode(&message, &mission_current);
+    // Handlers see the messages of all systems.
+    if (message.sysid != _system_impl->get_system_id()) {
+        return;
+    }
+
+    const auto& mission_current =
+        DecodedMessage::get(message, mavlink_msg_mission_current_decode);
 
     std::lock_guard<std::mutex> lock(_mission_data.mutex);
+    // Streamed at 1 Hz or more, but mostly the same as before.
+    if (_mission_data.last_current_mavlink_mission_item == mission_current.seq &&
+        _mission_data.last_total_reported_mission_item == total_mission_items_locked()) {
+        return;
+    }
     _mission_data.last_current_mavlink_mission_item = mission_current.seq;
     report_progress_locked();
 }
 
 void MissionImpl::process_mission_item_reached(const mavlink_message_t& message)
 {
-    mavlink_mission_item_reached_t mission_item_reached;
-    mavlink_msg_mission_item_reached_decode(&message, &mission_item_reached);
+    if (message.sysid != _system_impl->get_system_id()) {
+        return;
+    }
+
+    const auto& mission_item_reached =
+        DecodedMessage::get(message, mavlink_msg_mission_item_reached_decode);
 
     std::lock_guard<std::mutex> lock(_mission_data.mutex);
+    if (_mission_data.last_reached_mavlink_mission_item == mission_item_reached.seq) {
+        return;
+    }
     _mission_data.last_reached_mavlink_mission_item = mission_item_reached.seq;
     report_progress_locked();
 }
@@ -106,15 +121,14 @@ void MissionImpl::process_gimbal_manager_information(const mavlink_message_t& me
     if (_gimbal_protocol_cookie != nullptr) {
         LogDebug() << "Using gimbal protocol v2";
         _gimbal_protocol = GimbalProtocol::V2;
+        _state_change.notify();
         _system_impl->unregister_timeout_handler(_gimbal_protocol_cookie);
     }
 }
 
 void MissionImpl::wait_for_protocol()
 {
-    while (_gimbal_protocol == GimbalProtocol::Unknown) {
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));
-    }
+    _state_change.wait([this]() { return _gimbal_protocol != GimbalProtocol::Unknown; });
 }
 
 void MissionImpl::wait_for_protocol_async(std::function<void()> callback)
@@ -128,6 +142,7 @@ void MissionImpl::receive_protocol_timeout()
     LogDebug() << "Falling back to gimbal protocol v1";
     _gimbal_protocol = GimbalProtocol::V1;
     _gimbal_protocol_cookie = nullptr;
+    _state_change.notify();
 }
 
 Mission::Result MissionImpl::upload_mission(const Mission::MissionPlan& mission_plan)
@@ -153,12 +168,11 @@ void MissionImpl::upload_mission_async(
 
     reset_mission_progress();
 
-    wait_for_protocol_async([callback, mission_plan, this]() {
-        const auto int_items = convert_to_int_items(mission_plan.mission_items);
-
+    // Called right away, so the plan is not copied.
+    wait_for_protocol_async([&callback, &mission_plan, this]() {
         _mission_data.last_upload = _system_impl->mission_transfer().upload_items_async(
             MAV_MISSION_TYPE_MISSION,
-            int_items,
+            convert_to_int_items(mission_plan.mission_items),
             [this, callback](MavlinkMissionTransfer::Result result) {
                 auto converted_result = convert_result(result);
                 _system_impl->call_user_callback([callback, converted_result]() {
@@ -185,12 +199,11 @@ void MissionImpl::upload_mission_with_progress_async(
 
     reset_mission_progress();
 
-    wait_for_protocol_async([callback, mission_plan, this]() {
-        const auto int_items = convert_to_int_items(mission_plan.mission_items);
-
+    // Called right away, so the plan is not copied.
+    wait_for_protocol_async([&callback, &mission_plan, this]() {
         _mission_data.last_upload = _system_impl->mission_transfer().upload_items_async(
             MAV_MISSION_TYPE_MISSION,
-            int_items,
+            convert_to_int_items(mission_plan.mission_items),
             [this, callback](MavlinkMissionTransfer::Result result) {
                 auto converted_result = convert_result(result);
                 _system_impl->call_user_callback([callback, converted_result]() {
@@ -251,9 +264,10 @@ void MissionImpl::download_mission_async(const Mission::DownloadMissionCallback&
             MavlinkMissionTransfer::Result result,
             std::vector<MavlinkMissionTransfer::ItemInt> items) {
             auto result_and_items = convert_to_result_and_mission_items(result, items);
-            _system_impl->call_user_callback([callback, result_and_items]() {
-                callback(result_and_items.first, result_and_items.second);
-            });
+            _system_impl->call_user_callback(
+                [callback, result_and_items = std::move(result_and_items)]() mutable {
+                    callback(result_and_items.first, std::move(result_and_items.second));
+                });
         });
 }
 
@@ -278,16 +292,18 @@ void MissionImpl::download_mission_with_progress_async(
             MavlinkMissionTransfer::Result result,
             const std::vector<MavlinkMissionTransfer::ItemInt>& items) {
             auto result_and_items = convert_to_result_and_mission_items(result, items);
-            _system_impl->call_user_callback([callback, result_and_items]() {
-                if (result_and_items.first == Mission::Result::Success) {
-                    Mission::ProgressDataOrMission progress_data_or_mission{};
-                    progress_data_or_mission.has_mission = true;
-                    progress_data_or_mission.mission_plan = result_and_items.second;
-                    callback(Mission::Result::Next, progress_data_or_mission);
-                }
+            _system_impl->call_user_callback(
+                [callback, result_and_items = std::move(result_and_items)]() mutable {
+                    if (result_and_items.first == Mission::Result::Success) {
+                        Mission::ProgressDataOrMission progress_data_or_mission{};
+                        progress_data_or_mission.has_mission = true;
+                        progress_data_or_mission.mission_plan =
+                            std::move(result_and_items.second);
+                        callback(Mission::Result::Next, std::move(progress_data_or_mission));
+                    }
 
-                callback(result_and_items.first, Mission::ProgressDataOrMission{});
-            });
+                    callback(result_and_items.first, Mission::ProgressDataOrMission{});
+                });
         },
         [this, callback](float progress) {
             _system_impl->call_user_callback([callback, progress]() {
@@ -360,11 +376,14 @@ std::vector<MavlinkMissionTransfer::ItemInt>
 MissionImpl::convert_to_int_items(const std::vector<MissionItem>& mission_items)
 {
     std::vector<MavlinkMissionTransfer::ItemInt> int_items;
+    // Most items are a single waypoint, so this mostly avoids regrowing.
+    int_items.reserve(mission_items.size());
 
     bool last_position_valid = false; // This flag is to protect us from using an invalid x/y.
 
     unsigned item_i = 0;
     _mission_data.mavlink_mission_item_to_mission_item_indices.clear();
+    _mission_data.mavlink_mission_item_to_mission_item_indices.reserve(mission_items.size());
     _mission_data.gimbal_v2_in_control = false;
 
     for (const auto& item : mission_items) {
@@ -985,13 +1004,11 @@ void MissionImpl::set_current_mission_item_async(
     {
         std::lock_guard<std::mutex> lock(_mission_data.mutex);
         // We need to find the first mavlink item which maps to the current mission item.
-        int i = 0;
-        for (auto index : _mission_data.mavlink_mission_item_to_mission_item_indices) {
-            if (index == current) {
-                mavlink_index = i;
-                break;
-            }
-            ++i;
+        // The mission items only go up along the mavlink items.
+        const auto& indices = _mission_data.mavlink_mission_item_to_mission_item_indices;
+        const auto it = std::lower_bound(indices.begin(), indices.end(), current);
+        if (it != indices.end() && *it == current) {
+            mavlink_index = static_cast<int>(it - indices.begin());
         }
     }
 
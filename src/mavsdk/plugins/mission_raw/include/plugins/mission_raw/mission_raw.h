@@ -15,6 +15,7 @@
 
 #include "plugin_base.h"
 
+#include "awaitable.h"
 #include "handle.h"
 
 namespace mavsdk {
@@ -190,8 +191,26 @@ public:
      *
      * This function is non-blocking. See 'upload_mission' for the blocking counterpart.
      */
-    void
-    upload_mission_async(std::vector<MissionItem> mission_items, const ResultCallback callback);
+    void upload_mission_async(
+        const std::vector<MissionItem>& mission_items, const ResultCallback& callback);
+
+#ifdef MAVSDK_HAS_COROUTINES
+    /**
+     * @brief Awaitable version of 'upload_mission_async' for C++20 coroutines.
+     *
+     * The coroutine is resumed using the executor if one is given, otherwise on the callback
+     * thread.
+     */
+    Awaitable<ResultCallback> upload_mission_awaitable(
+        const std::vector<MissionItem>& mission_items, Executor executor = {})
+    {
+        return Awaitable<ResultCallback>(
+            [=, this](const ResultCallback& callback) {
+                upload_mission_async(mission_items, callback);
+            },
+            std::move(executor));
+    }
+#endif
 
     /**
      * @brief Upload a list of raw mission items to the system.
@@ -203,15 +222,33 @@ public:
      *
      * @return Result of request.
      */
-    Result upload_mission(std::vector<MissionItem> mission_items) const;
+    Result upload_mission(const std::vector<MissionItem>& mission_items) const;
 
     /**
      * @brief Upload a list of geofence items to the system.
      *
      * This function is non-blocking. See 'upload_geofence' for the blocking counterpart.
      */
-    void
-    upload_geofence_async(std::vector<MissionItem> mission_items, const ResultCallback callback);
+    void upload_geofence_async(
+        const std::vector<MissionItem>& mission_items, const ResultCallback& callback);
+
+#ifdef MAVSDK_HAS_COROUTINES
+    /**
+     * @brief Awaitable version of 'upload_geofence_async' for C++20 coroutines.
+     *
+     * The coroutine is resumed using the executor if one is given, otherwise on the callback
+     * thread.
+     */
+    Awaitable<ResultCallback> upload_geofence_awaitable(
+        const std::vector<MissionItem>& mission_items, Executor executor = {})
+    {
+        return Awaitable<ResultCallback>(
+            [=, this](const ResultCallback& callback) {
+                upload_geofence_async(mission_items, callback);
+            },
+            std::move(executor));
+    }
+#endif
 
     /**
      * @brief Upload a list of geofence items to the system.
@@ -220,7 +257,7 @@ public:
      *
      * @return Result of request.
      */
-    Result upload_geofence(std::vector<MissionItem> mission_items) const;
+    Result upload_geofence(const std::vector<MissionItem>& mission_items) const;
 
     /**
      * @brief Upload a list of rally point items to the system.
@@ -228,7 +265,25 @@ public:
      * This function is non-blocking. See 'upload_rally_points' for the blocking counterpart.
      */
     void upload_rally_points_async(
-        std::vector<MissionItem> mission_items, const ResultCallback callback);
+        const std::vector<MissionItem>& mission_items, const ResultCallback& callback);
+
+#ifdef MAVSDK_HAS_COROUTINES
+    /**
+     * @brief Awaitable version of 'upload_rally_points_async' for C++20 coroutines.
+     *
+     * The coroutine is resumed using the executor if one is given, otherwise on the callback
+     * thread.
+     */
+    Awaitable<ResultCallback> upload_rally_points_awaitable(
+        const std::vector<MissionItem>& mission_items, Executor executor = {})
+    {
+        return Awaitable<ResultCallback>(
+            [=, this](const ResultCallback& callback) {
+                upload_rally_points_async(mission_items, callback);
+            },
+            std::move(executor));
+    }
+#endif
 
     /**
      * @brief Upload a list of rally point items to the system.
@@ -237,7 +292,7 @@ public:
      *
      * @return Result of request.
      */
-    Result upload_rally_points(std::vector<MissionItem> mission_items) const;
+    Result upload_rally_points(const std::vector<MissionItem>& mission_items) const;
 
     /**
      * @brief Cancel an ongoing mission upload.
@@ -258,7 +313,24 @@ public:
      *
      * This function is non-blocking. See 'download_mission' for the blocking counterpart.
      */
-    void download_mission_async(const DownloadMissionCallback callback);
+    void download_mission_async(const DownloadMissionCallback& callback);
+
+#ifdef MAVSDK_HAS_COROUTINES
+    /**
+     * @brief Awaitable version of 'download_mission_async' for C++20 coroutines.
+     *
+     * The coroutine is resumed using the executor if one is given, otherwise on the callback
+     * thread.
+     */
+    Awaitable<DownloadMissionCallback> download_mission_awaitable(Executor executor = {})
+    {
+        return Awaitable<DownloadMissionCallback>(
+            [=, this](const DownloadMissionCallback& callback) {
+                download_mission_async(callback);
+            },
+            std::move(executor));
+    }
+#endif
 
     /**
      * @brief Download a list of raw mission items from the system (asynchronous).
@@ -285,7 +357,24 @@ public:
      *
      * This function is non-blocking. See 'start_mission' for the blocking counterpart.
      */
-    void start_mission_async(const ResultCallback callback);
+    void start_mission_async(const ResultCallback& callback);
+
+#ifdef MAVSDK_HAS_COROUTINES
+    /**
+     * @brief Awaitable version of 'start_mission_async' for C++20 coroutines.
+     *
+     * The coroutine is resumed using the executor if one is given, otherwise on the callback
+     * thread.
+     */
+    Awaitable<ResultCallback> start_mission_awaitable(Executor executor = {})
+    {
+        return Awaitable<ResultCallback>(
+            [=, this](const ResultCallback& callback) {
+                start_mission_async(callback);
+            },
+            std::move(executor));
+    }
+#endif
 
     /**
      * @brief Start the mission.
@@ -308,7 +397,24 @@ public:
      *
      * This function is non-blocking. See 'pause_mission' for the blocking counterpart.
      */
-    void pause_mission_async(const ResultCallback callback);
+    void pause_mission_async(const ResultCallback& callback);
+
+#ifdef MAVSDK_HAS_COROUTINES
+    /**
+     * @brief Awaitable version of 'pause_mission_async' for C++20 coroutines.
+     *
+     * The coroutine is resumed using the executor if one is given, otherwise on the callback
+     * thread.
+     */
+    Awaitable<ResultCallback> pause_mission_awaitable(Executor executor = {})
+    {
+        return Awaitable<ResultCallback>(
+            [=, this](const ResultCallback& callback) {
+                pause_mission_async(callback);
+            },
+            std::move(executor));
+    }
+#endif
 
     /**
      * @brief Pause the mission.
@@ -329,7 +435,24 @@ public:
      *
      * This function is non-blocking. See 'clear_mission' for the blocking counterpart.
      */
-    void clear_mission_async(const ResultCallback callback);
+    void clear_mission_async(const ResultCallback& callback);
+
+#ifdef MAVSDK_HAS_COROUTINES
+    /**
+     * @brief Awaitable version of 'clear_mission_async' for C++20 coroutines.
+     *
+     * The coroutine is resumed using the executor if one is given, otherwise on the callback
+     * thread.
+     */
+    Awaitable<ResultCallback> clear_mission_awaitable(Executor executor = {})
+    {
+        return Awaitable<ResultCallback>(
+            [=, this](const ResultCallback& callback) {
+                clear_mission_async(callback);
+            },
+            std::move(executor));
+    }
+#endif
 
     /**
      * @brief Clear the mission saved on the vehicle.
@@ -348,7 +471,25 @@ public:
      *
      * This function is non-blocking. See 'set_current_mission_item' for the blocking counterpart.
      */
-    void set_current_mission_item_async(int32_t index, const ResultCallback callback);
+    void set_current_mission_item_async(int32_t index, const ResultCallback& callback);
+
+#ifdef MAVSDK_HAS_COROUTINES
+    /**
+     * @brief Awaitable version of 'set_current_mission_item_async' for C++20 coroutines.
+     *
+     * The coroutine is resumed using the executor if one is given, otherwise on the callback
+     * thread.
+     */
+    Awaitable<ResultCallback> set_current_mission_item_awaitable(
+        int32_t index, Executor executor = {})
+    {
+        return Awaitable<ResultCallback>(
+            [=, this](const ResultCallback& callback) {
+                set_current_mission_item_async(index, callback);
+            },
+            std::move(executor));
+    }
+#endif
 
     /**
      * @brief Sets the raw mission item index to go to.
@@ -429,8 +570,8 @@ public:
      *
      * @return Result of request.
      */
-    std::pair<Result, MissionRaw::MissionImportData>
-    import_qgroundcontrol_mission(std::string qgc_plan_path) const;
+    std::pair<Result, MissionRaw::MissionImportData> import_qgroundcontrol_mission(
+        const std::string& qgc_plan_path) const;
 
     /**
      * @brief Import a QGroundControl missions in JSON .plan format, from a string.
@@ -445,8 +586,8 @@ public:
      *
      * @return Result of request.
      */
-    std::pair<Result, MissionRaw::MissionImportData>
-    import_qgroundcontrol_mission_from_string(std::string qgc_plan) const;
+    std::pair<Result, MissionRaw::MissionImportData> import_qgroundcontrol_mission_from_string(
+        const std::string& qgc_plan) const;
 
     /**
      * @brief Copy constructor.
@@ -461,6 +602,9 @@ public:
 private:
     /** @private Underlying implementation, set at instantiation */
     std::unique_ptr<MissionRawImpl> _impl;
+
+    /** @private Hand-written additions in mission_raw_ext.h, if any */
+    friend class MissionRawExt;
 };
 
 } // namespace mavsdk
\ No newline at end of file
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "plugins/mission_raw/mission_raw.h"
+
+namespace mavsdk {
+
+class MissionRawImpl;
+
+/**
+ * @brief Additions to MissionRaw that are only available in C++.
+ *
+ * Unlike mission_raw.h, this header is not generated from the proto files,
+ * so the calls here are not available through mavsdk_server.
+ *
+ * It works on the MissionRaw plugin it is created with, which has to outlive it:
+ *
+ *     ```cpp
+ *     auto mission_raw = MissionRaw(system);
+ *     auto mission_raw_ext = MissionRawExt(mission_raw);
+ *     ```
+ *
+ * MissionRaw::upload_rally_points() and MissionRaw::upload_rally_points_async()
+ * only write the changed items if their number is the same as last
+ * uploaded, as long as the system supports partial writes.
+ */
+class MissionRawExt {
+public:
+    /**
+     * @brief Constructor. Uses the given MissionRaw plugin.
+     *
+     * @param mission_raw The plugin, which has to outlive this object.
+     */
+    explicit MissionRawExt(MissionRaw& mission_raw);
+
+private:
+    MissionRawImpl& _impl;
+};
+
+} // namespace mavsdk
@@ -0,0 +1,187 @@
+#include "mission_export.h"
+#include "mavlink_include.h"
+#include <cmath>
+#include <limits>
+#include <locale>
+
+namespace mavsdk {
+
+void MissionExport::write_plan(
+    std::ostream& out,
+    const MissionRaw::MissionImportData& import_data,
+    Sender::Autopilot autopilot)
+{
+    // Numbers need a dot, whatever the locale, and enough digits to be read
+    // back exactly.
+    const auto previous_locale = out.imbue(std::locale::classic());
+    const auto previous_precision = out.precision(std::numeric_limits<double>::max_digits10);
+
+    out << "{\n";
+    out << "    \"fileType\": \"Plan\",\n";
+    out << "    \"groundStation\": \"MAVSDK\",\n";
+    write_mission(out, import_data.mission_items, autopilot);
+    write_geofence(out, import_data.geofence_items);
+    write_rally_points(out, import_data.rally_items);
+    out << "    \"version\": 1\n";
+    out << "}\n";
+
+    out.precision(previous_precision);
+    out.imbue(previous_locale);
+}
+
+void MissionExport::write_mission(
+    std::ostream& out,
+    const std::vector<MissionRaw::MissionItem>& mission_items,
+    Sender::Autopilot autopilot)
+{
+    // The home position is not a mission item in a .plan.
+    const bool has_home = autopilot == Sender::Autopilot::ArduPilot && !mission_items.empty();
+    const std::size_t first = has_home ? 1 : 0;
+
+    out << "    \"mission\": {\n";
+    out << "        \"firmwareType\": "
+        << (autopilot == Sender::Autopilot::ArduPilot ? MAV_AUTOPILOT_ARDUPILOTMEGA :
+                                                        MAV_AUTOPILOT_PX4)
+        << ",\n";
+    out << "        \"items\": [";
+
+    for (std::size_t i = first; i < mission_items.size(); ++i) {
+        const auto& item = mission_items[i];
+        out << (i == first ? "\n" : ",\n");
+        out << "            {\"autoContinue\": " << (item.autocontinue ? "true" : "false")
+            << ", \"command\": " << item.command << ", \"doJumpId\": " << (i - first + 1)
+            << ", \"frame\": " << item.frame << ", \"params\": [";
+        write_number(out, item.param1);
+        out << ", ";
+        write_number(out, item.param2);
+        out << ", ";
+        write_number(out, item.param3);
+        out << ", ";
+        write_number(out, item.param4);
+        out << ", ";
+        write_degrees(out, item.x);
+        out << ", ";
+        write_degrees(out, item.y);
+        out << ", ";
+        write_number(out, item.z);
+        out << "], \"type\": \"SimpleItem\"}";
+    }
+    out << (mission_items.size() > first ? "\n        ],\n" : "],\n");
+
+    if (has_home) {
+        out << "        \"plannedHomePosition\": [";
+        write_degrees(out, mission_items[0].x);
+        out << ", ";
+        write_degrees(out, mission_items[0].y);
+        out << ", ";
+        write_number(out, mission_items[0].z);
+        out << "],\n";
+    }
+
+    out << "        \"version\": 2\n";
+    out << "    },\n";
+}
+
+void MissionExport::write_geofence(
+    std::ostream& out, const std::vector<MissionRaw::MissionItem>& geofence_items)
+{
+    out << "    \"geoFence\": {\n";
+
+    out << "        \"circles\": [";
+    bool first_circle = true;
+    for (const auto& item : geofence_items) {
+        if (item.command != MAV_CMD_NAV_FENCE_CIRCLE_INCLUSION &&
+            item.command != MAV_CMD_NAV_FENCE_CIRCLE_EXCLUSION) {
+            continue;
+        }
+        out << (first_circle ? "\n" : ",\n");
+        first_circle = false;
+        out << "            {\"circle\": {\"center\": [";
+        write_degrees(out, item.x);
+        out << ", ";
+        write_degrees(out, item.y);
+        out << "], \"radius\": ";
+        write_number(out, item.param1);
+        out << "}, \"inclusion\": "
+            << (item.command == MAV_CMD_NAV_FENCE_CIRCLE_INCLUSION ? "true" : "false")
+            << ", \"version\": 1}";
+    }
+    out << (first_circle ? "],\n" : "\n        ],\n");
+
+    // The vertices of a polygon follow each other, and each has the number
+    // of vertices in param1.
+    out << "        \"polygons\": [";
+    bool first_polygon = true;
+    for (std::size_t i = 0; i < geofence_items.size();) {
+        const auto& item = geofence_items[i];
+        if (item.command != MAV_CMD_NAV_FENCE_POLYGON_VERTEX_INCLUSION &&
+            item.command != MAV_CMD_NAV_FENCE_POLYGON_VERTEX_EXCLUSION) {
+            ++i;
+            continue;
+        }
+
+        std::size_t end = i + 1;
+        const auto num_vertices =
+            std::isfinite(item.param1) && item.param1 >= 1.0f ? std::size_t(item.param1) : 1;
+        while (end < geofence_items.size() && end - i < num_vertices &&
+               geofence_items[end].command == item.command) {
+            ++end;
+        }
+
+        out << (first_polygon ? "\n" : ",\n");
+        first_polygon = false;
+        out << "            {\"inclusion\": "
+            << (item.command == MAV_CMD_NAV_FENCE_POLYGON_VERTEX_INCLUSION ? "true" : "false")
+            << ", \"polygon\": [";
+        for (std::size_t j = i; j < end; ++j) {
+            out << (j == i ? "[" : ", [");
+            write_degrees(out, geofence_items[j].x);
+            out << ", ";
+            write_degrees(out, geofence_items[j].y);
+            out << "]";
+        }
+        out << "], \"version\": 1}";
+
+        i = end;
+    }
+    out << (first_polygon ? "],\n" : "\n        ],\n");
+
+    out << "        \"version\": 2\n";
+    out << "    },\n";
+}
+
+void MissionExport::write_rally_points(
+    std::ostream& out, const std::vector<MissionRaw::MissionItem>& rally_items)
+{
+    out << "    \"rallyPoints\": {\n";
+    out << "        \"points\": [";
+    for (std::size_t i = 0; i < rally_items.size(); ++i) {
+        out << (i == 0 ? "\n            [" : ",\n            [");
+        write_degrees(out, rally_items[i].x);
+        out << ", ";
+        write_degrees(out, rally_items[i].y);
+        out << ", ";
+        write_number(out, rally_items[i].z);
+        out << "]";
+    }
+    out << (rally_items.empty() ? "],\n" : "\n        ],\n");
+    out << "        \"version\": 2\n";
+    out << "    },\n";
+}
+
+void MissionExport::write_number(std::ostream& out, double value)
+{
+    // JSON has no NAN, unset params are null instead.
+    if (std::isfinite(value)) {
+        out << value;
+    } else {
+        out << "null";
+    }
+}
+
+void MissionExport::write_degrees(std::ostream& out, int32_t value_e7)
+{
+    out << static_cast<double>(value_e7) / 1e7;
+}
+
+} // namespace mavsdk
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "plugins/mission_raw/mission_raw.h"
+#include "sender.h"
+#include <ostream>
+#include <vector>
+
+namespace mavsdk {
+
+// Writes items as a QGroundControl .plan, which MissionImport reads back.
+//
+// The text is written while going through the items, so there is no JSON
+// document in memory, even for large missions. All mission items are
+// written as simple items, surveys can't be recovered from them.
+
+class MissionExport {
+public:
+    // For ArduPilot, the first mission item is the home position.
+    static void write_plan(
+        std::ostream& out,
+        const MissionRaw::MissionImportData& import_data,
+        Sender::Autopilot autopilot);
+
+private:
+    static void write_mission(
+        std::ostream& out,
+        const std::vector<MissionRaw::MissionItem>& mission_items,
+        Sender::Autopilot autopilot);
+    static void
+    write_geofence(std::ostream& out, const std::vector<MissionRaw::MissionItem>& geofence_items);
+    static void
+    write_rally_points(std::ostream& out, const std::vector<MissionRaw::MissionItem>& rally_items);
+    static void write_number(std::ostream& out, double value);
+    static void write_degrees(std::ostream& out, int32_t value_e7);
+};
+
+} // namespace mavsdk
@@ -0,0 +1,80 @@
+#include <cmath>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+
+#include "mission_export.h"
+#include "mission_import.h"
+
+using namespace mavsdk;
+
+static std::string path_prefix(const std::string& path)
+{
+    return std::string("src/mavsdk/plugins/mission_raw/test_plans/") + path;
+}
+
+static MissionRaw::MissionImportData read_plan(const std::string& path, Sender::Autopilot autopilot)
+{
+    std::ifstream file(path_prefix(path));
+    EXPECT_TRUE(file);
+
+    std::stringstream buf;
+    buf << file.rdbuf();
+
+    const auto result_pair = MissionImport::parse_json(buf.str(), autopilot);
+    EXPECT_EQ(result_pair.first, MissionRaw::Result::Success);
+    return result_pair.second;
+}
+
+TEST(MissionRaw, ExportedPlanIsImportedAgain)
+{
+    for (const auto autopilot : {Sender::Autopilot::Px4, Sender::Autopilot::ArduPilot}) {
+        const auto import_data = read_plan("qgroundcontrol_sample.plan", autopilot);
+        ASSERT_FALSE(import_data.mission_items.empty());
+
+        std::stringstream out;
+        MissionExport::write_plan(out, import_data, autopilot);
+
+        const auto result_pair = MissionImport::parse_json_streaming(out.str(), autopilot);
+        EXPECT_EQ(result_pair.first, MissionRaw::Result::Success);
+        EXPECT_EQ(result_pair.second, import_data);
+    }
+}
+
+TEST(MissionRaw, ExportedSurveyIsImportedAsSimpleItems)
+{
+    const auto import_data =
+        read_plan("qgroundcontrol_sample_with_survey.plan", Sender::Autopilot::Px4);
+
+    std::stringstream out;
+    MissionExport::write_plan(out, import_data, Sender::Autopilot::Px4);
+    EXPECT_EQ(out.str().find("ComplexItem"), std::string::npos);
+
+    const auto result_pair = MissionImport::parse_json_streaming(out.str(), Sender::Autopilot::Px4);
+    EXPECT_EQ(result_pair.first, MissionRaw::Result::Success);
+    EXPECT_EQ(result_pair.second, import_data);
+}
+
+TEST(MissionRaw, ExportWritesNullForUnsetParams)
+{
+    MissionRaw::MissionImportData import_data{};
+    MissionRaw::MissionItem item{};
+    item.command = 16;
+    item.frame = 3;
+    item.param4 = NAN;
+    item.x = 473977507;
+    item.y = 85456075;
+    item.z = 50.0f;
+    item.autocontinue = 1;
+    item.current = 1;
+    import_data.mission_items.push_back(item);
+
+    std::stringstream out;
+    MissionExport::write_plan(out, import_data, Sender::Autopilot::Px4);
+    EXPECT_NE(out.str().find("null"), std::string::npos);
+
+    const auto result_pair = MissionImport::parse_json_streaming(out.str(), Sender::Autopilot::Px4);
+    EXPECT_EQ(result_pair.first, MissionRaw::Result::Success);
+    EXPECT_EQ(result_pair.second, import_data);
+}
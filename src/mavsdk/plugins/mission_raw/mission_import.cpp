@@ -1,6 +1,8 @@
 #include "log.h"
 #include "mission_import.h"
+#include "json_pull_reader.h"
 #include "mavlink_include.h"
+#include <array>
 #include <cmath> // for `std::round`
 #include <sstream> // for `std::stringstream`
 
@@ -410,4 +412,662 @@ int32_t MissionImport::set_int32(const Json::Value& val)
     return static_cast<int32_t>(val.isNull() ? 0 : (std::round(val.asDouble() * 1e7)));
 }
 
+namespace {
+
+// Conversions as done by jsoncpp, for values which are only needed as numbers.
+// Null or anything but a number or bool is treated as missing.
+std::optional<double> read_number_value(JsonPullReader& reader)
+{
+    switch (reader.peek()) {
+        case JsonPullReader::Type::Number:
+            return reader.read_number();
+        case JsonPullReader::Type::Bool: {
+            const auto value = reader.read_bool();
+            return value ? std::optional<double>(value.value() ? 1.0 : 0.0) : std::nullopt;
+        }
+        default:
+            reader.skip_value();
+            return std::nullopt;
+    }
+}
+
+float float_or_nan(const std::optional<double>& value)
+{
+    return value ? static_cast<float>(value.value()) : NAN;
+}
+
+int32_t degrees_e7(const std::optional<double>& value)
+{
+    return static_cast<int32_t>(value ? std::round(value.value() * 1e7) : 0);
+}
+
+// Reads up to N values of an array, the rest is skipped.
+template<std::size_t N>
+bool read_numbers(
+    JsonPullReader& reader, std::array<std::optional<double>, N>& values, std::size_t& size)
+{
+    size = 0;
+    if (reader.peek() != JsonPullReader::Type::Array) {
+        return reader.skip_value();
+    }
+
+    reader.enter_array();
+    while (reader.next_element()) {
+        if (size < N) {
+            values[size] = read_number_value(reader);
+        } else {
+            reader.skip_value();
+        }
+        ++size;
+    }
+    return !reader.failed();
+}
+
+struct SimpleItemFields {
+    std::optional<double> command{};
+    std::optional<double> frame{};
+    std::optional<bool> auto_continue{};
+    bool has_params{false};
+    bool params_is_array{false};
+    std::array<std::optional<double>, 7> params{};
+};
+
+// Returns false if the key is not one of the fields.
+bool read_simple_item_field(
+    JsonPullReader& reader, const std::string& key, SimpleItemFields& fields)
+{
+    if (key == "command") {
+        fields.command = read_number_value(reader);
+    } else if (key == "frame") {
+        fields.frame = read_number_value(reader);
+    } else if (key == "autoContinue") {
+        const auto value = read_number_value(reader);
+        fields.auto_continue =
+            value ? std::optional<bool>(value.value() != 0.0) : std::nullopt;
+    } else if (key == "params") {
+        fields.params = {};
+        fields.params_is_array = reader.peek() == JsonPullReader::Type::Array;
+        if (fields.params_is_array) {
+            std::size_t size = 0;
+            read_numbers(reader, fields.params, size);
+            fields.has_params = size > 0;
+        } else if (reader.peek() == JsonPullReader::Type::Object) {
+            reader.enter_object();
+            std::string params_key;
+            fields.has_params = false;
+            while (reader.next_key(params_key)) {
+                fields.has_params = true;
+                reader.skip_value();
+            }
+        } else {
+            fields.has_params = reader.peek() != JsonPullReader::Type::Null;
+            reader.skip_value();
+        }
+    } else {
+        return false;
+    }
+    return true;
+}
+
+std::optional<MissionRaw::MissionItem> make_simple_item(const SimpleItemFields& fields)
+{
+    if (!fields.command || !fields.auto_continue || !fields.frame || !fields.has_params) {
+        LogErr() << "Missing mission item field.";
+        return std::nullopt;
+    }
+
+    if (!fields.params_is_array) {
+        LogErr() << "No param array found.";
+        return std::nullopt;
+    }
+
+    MissionRaw::MissionItem item{};
+    item.command = static_cast<int>(fields.command.value());
+    item.autocontinue = fields.auto_continue.value() ? 1 : 0;
+    item.frame = static_cast<int>(fields.frame.value());
+    item.mission_type = MAV_MISSION_TYPE_MISSION;
+    item.param1 = float_or_nan(fields.params[0]);
+    item.param2 = float_or_nan(fields.params[1]);
+    item.param3 = float_or_nan(fields.params[2]);
+    item.param4 = float_or_nan(fields.params[3]);
+    item.x = degrees_e7(fields.params[4]);
+    item.y = degrees_e7(fields.params[5]);
+    item.z = float_or_nan(fields.params[6]);
+    return item;
+}
+
+void mark_current_and_number(std::vector<MissionRaw::MissionItem>& items)
+{
+    if (items.size() > 0) {
+        items[0].current = 1;
+    }
+
+    unsigned sequence = 0;
+    for (auto& item : items) {
+        item.seq = sequence++;
+    }
+}
+
+std::size_t count_occurrences(const std::string& text, const std::string& pattern)
+{
+    std::size_t count = 0;
+    for (auto pos = text.find(pattern); pos != std::string::npos;
+         pos = text.find(pattern, pos + pattern.size())) {
+        ++count;
+    }
+    return count;
+}
+
+} // namespace
+
+std::pair<MissionRaw::Result, MissionRaw::MissionImportData>
+MissionImport::parse_json_streaming(const std::string& raw_json, Sender::Autopilot autopilot)
+{
+    MissionRaw::MissionImportData import_data;
+    // Every mission item has a command, and not much else does, so this saves
+    // copying the items around while the vector grows. One more is for the
+    // home position added for ArduPilot.
+    import_data.mission_items.reserve(count_occurrences(raw_json, "\"command\"") + 1);
+
+    JsonPullReader reader(raw_json.c_str(), raw_json.c_str() + raw_json.length());
+
+    std::optional<double> overall_version;
+    bool mission_ok = false;
+    bool geofence_ok = false;
+    bool rally_ok = false;
+
+    if (reader.enter_object()) {
+        std::string key;
+        while (reader.next_key(key)) {
+            if (key == "version") {
+                overall_version = read_number_value(reader);
+            } else if (key == "mission") {
+                mission_ok = stream_mission(reader, autopilot, import_data.mission_items);
+            } else if (key == "geoFence") {
+                geofence_ok = stream_geofence(reader, import_data.geofence_items);
+            } else if (key == "rallyPoints") {
+                rally_ok = stream_rally_points(reader, import_data.rally_items);
+            } else {
+                reader.skip_value();
+            }
+
+            // A broken part makes the whole plan unusable.
+            if ((key == "mission" && !mission_ok) || (key == "geoFence" && !geofence_ok) ||
+                (key == "rallyPoints" && !rally_ok)) {
+                return {MissionRaw::Result::FailedToParseQgcPlan, {}};
+            }
+        }
+    }
+
+    if (!reader.at_end()) {
+        LogErr() << "Parse error";
+        return {MissionRaw::Result::FailedToParseQgcPlan, {}};
+    }
+
+    const auto supported_overall_version = 1;
+    if (!overall_version ||
+        static_cast<int>(overall_version.value()) != supported_overall_version) {
+        LogErr() << "Overall .plan version not supported, supported: "
+                 << supported_overall_version;
+        return {MissionRaw::Result::FailedToParseQgcPlan, {}};
+    }
+
+    if (!mission_ok) {
+        LogErr() << "No mission found in .plan.";
+        return {MissionRaw::Result::FailedToParseQgcPlan, {}};
+    }
+
+    if (!geofence_ok || !rally_ok) {
+        return {MissionRaw::Result::FailedToParseQgcPlan, {}};
+    }
+
+    return {MissionRaw::Result::Success, std::move(import_data)};
+}
+
+bool MissionImport::stream_mission(
+    JsonPullReader& reader,
+    Sender::Autopilot autopilot,
+    std::vector<MissionRaw::MissionItem>& mission_items)
+{
+    if (reader.peek() != JsonPullReader::Type::Object) {
+        LogErr() << "No mission found in .plan.";
+        reader.skip_value();
+        return false;
+    }
+
+    bool empty = true;
+    std::optional<double> mission_version;
+    bool has_home = false;
+    std::array<std::optional<double>, 3> home{};
+    std::size_t home_size = 0;
+
+    reader.enter_object();
+    std::string key;
+    while (reader.next_key(key)) {
+        empty = false;
+        if (key == "version") {
+            mission_version = read_number_value(reader);
+        } else if (key == "items" && reader.peek() == JsonPullReader::Type::Array) {
+            reader.enter_array();
+            while (reader.next_element()) {
+                if (!stream_mission_item(reader, mission_items)) {
+                    return false;
+                }
+            }
+        } else if (key == "plannedHomePosition") {
+            if (reader.peek() == JsonPullReader::Type::Array) {
+                read_numbers(reader, home, home_size);
+                has_home = home_size > 0;
+            } else {
+                // Only the array format is known.
+                has_home = reader.peek() != JsonPullReader::Type::Null;
+                home_size = 0;
+                reader.skip_value();
+            }
+        } else {
+            reader.skip_value();
+        }
+    }
+
+    if (reader.failed()) {
+        return false;
+    }
+
+    if (empty) {
+        LogErr() << "No mission found in .plan.";
+        return false;
+    }
+
+    const auto supported_mission_version = 2;
+    if (!mission_version ||
+        static_cast<int>(mission_version.value()) != supported_mission_version) {
+        LogErr() << "mission version for .plan not supported, supported: "
+                 << supported_mission_version;
+        return false;
+    }
+
+    mark_current_and_number(mission_items);
+
+    // Add home position at 0 for ArduPilot
+    if (autopilot == Sender::Autopilot::ArduPilot && has_home) {
+        if (home_size != 3) {
+            LogErr() << "Unknown plannedHomePosition format";
+            return false;
+        }
+
+        mission_items.insert(
+            mission_items.begin(),
+            MissionRaw::MissionItem{
+                0,
+                MAV_FRAME_GLOBAL_INT,
+                MAV_CMD_NAV_WAYPOINT,
+                0, // current
+                1, // autocontinue
+                0.0f,
+                0.0f,
+                0.0f,
+                0.0f,
+                degrees_e7(home[0]),
+                degrees_e7(home[1]),
+                home[2] ? static_cast<float>(home[2].value()) : 0.0f,
+                MAV_MISSION_TYPE_MISSION});
+    }
+
+    return true;
+}
+
+bool MissionImport::stream_mission_item(
+    JsonPullReader& reader, std::vector<MissionRaw::MissionItem>& mission_items)
+{
+    if (!reader.enter_object()) {
+        LogErr() << "Mission item is not an object.";
+        return false;
+    }
+
+    SimpleItemFields simple_fields;
+    std::optional<std::string> type;
+    std::optional<std::string> complex_item_type;
+    bool has_complex_item_type = false;
+    std::optional<double> version;
+    bool has_transect_style = false;
+    bool has_survey_items = false;
+
+    // Keys can come in any order, so survey items are added right away, and
+    // dropped again if it turns out not to be a survey.
+    const auto num_items_before = mission_items.size();
+
+    std::string key;
+    while (reader.next_key(key)) {
+        if (read_simple_item_field(reader, key, simple_fields)) {
+            continue;
+        }
+
+        if (key == "type") {
+            type = reader.peek() == JsonPullReader::Type::String ? reader.read_string() :
+                                                                   std::nullopt;
+            if (!type) {
+                reader.skip_value();
+            }
+        } else if (key == "complexItemType") {
+            has_complex_item_type = reader.peek() != JsonPullReader::Type::Null;
+            if (reader.peek() == JsonPullReader::Type::String) {
+                complex_item_type = reader.read_string();
+            } else {
+                reader.skip_value();
+            }
+        } else if (key == "version") {
+            version = read_number_value(reader);
+        } else if (key == "TransectStyleComplexItem" &&
+                   reader.peek() == JsonPullReader::Type::Object) {
+            reader.enter_object();
+            std::string transect_key;
+            while (reader.next_key(transect_key)) {
+                has_transect_style = true;
+                if (transect_key == "Items" && reader.peek() == JsonPullReader::Type::Array) {
+                    mission_items.resize(num_items_before);
+                    has_survey_items = stream_survey_items(reader, mission_items);
+                } else {
+                    reader.skip_value();
+                }
+            }
+        } else {
+            reader.skip_value();
+        }
+    }
+
+    if (reader.failed()) {
+        return false;
+    }
+
+    if (type && type.value() == "SimpleItem") {
+        mission_items.resize(num_items_before);
+        const auto maybe_item = make_simple_item(simple_fields);
+        if (!maybe_item) {
+            return false;
+        }
+        mission_items.push_back(maybe_item.value());
+        return true;
+    }
+
+    if (!type || type.value() != "ComplexItem") {
+        LogErr() << "Type " << (type ? type.value() : "") << " not understood.";
+        return false;
+    }
+
+    if (!has_complex_item_type) {
+        LogErr() << "Could not determine complexItemType";
+        return false;
+    }
+
+    if (!complex_item_type || complex_item_type.value() != "survey") {
+        LogErr() << "complexItemType: " << complex_item_type.value_or("") << " not supported";
+        return false;
+    }
+
+    if (!version) {
+        LogErr() << "version of complexItem not found";
+        return false;
+    }
+
+    const int supported_complex_item_version = 5;
+    const int found_version = static_cast<int>(version.value());
+    if (found_version != supported_complex_item_version) {
+        LogErr() << "version of complexItem not supported, found version: " << found_version
+                 << ", supported: " << supported_complex_item_version;
+        return false;
+    }
+
+    if (!has_transect_style) {
+        LogErr() << "TransectStyleComplexItem not found";
+        return false;
+    }
+
+    if (!has_survey_items) {
+        LogErr() << "No survey items found";
+        return false;
+    }
+
+    return true;
+}
+
+bool MissionImport::stream_survey_items(
+    JsonPullReader& reader, std::vector<MissionRaw::MissionItem>& mission_items)
+{
+    bool empty = true;
+    reader.enter_array();
+    while (reader.next_element()) {
+        empty = false;
+        if (reader.peek() != JsonPullReader::Type::Object) {
+            reader.skip_value();
+            continue;
+        }
+
+        SimpleItemFields fields;
+        reader.enter_object();
+        std::string key;
+        while (reader.next_key(key)) {
+            if (!read_simple_item_field(reader, key, fields)) {
+                reader.skip_value();
+            }
+        }
+
+        // Broken survey items are left out.
+        if (!reader.failed()) {
+            if (const auto maybe_item = make_simple_item(fields)) {
+                mission_items.push_back(maybe_item.value());
+            }
+        }
+    }
+    return !empty && !reader.failed();
+}
+
+bool MissionImport::stream_geofence(
+    JsonPullReader& reader, std::vector<MissionRaw::MissionItem>& geofence_items)
+{
+    if (reader.peek() != JsonPullReader::Type::Object) {
+        reader.skip_value();
+        return false;
+    }
+
+    bool empty = true;
+    std::optional<double> geofence_version;
+    // Circles come after the polygons, regardless of the order in the file.
+    std::vector<MissionRaw::MissionItem> circular_geofences;
+
+    reader.enter_object();
+    std::string key;
+    while (reader.next_key(key)) {
+        empty = false;
+        if (key == "version") {
+            geofence_version = read_number_value(reader);
+        } else if (key == "polygons" && reader.peek() == JsonPullReader::Type::Array) {
+            reader.enter_array();
+            while (reader.next_element()) {
+                if (!stream_polygon_geofence(reader, geofence_items)) {
+                    return false;
+                }
+            }
+        } else if (key == "circles" && reader.peek() == JsonPullReader::Type::Array) {
+            reader.enter_array();
+            while (reader.next_element()) {
+                if (!stream_circular_geofence(reader, circular_geofences)) {
+                    return false;
+                }
+            }
+        } else {
+            reader.skip_value();
+        }
+    }
+
+    if (reader.failed() || empty) {
+        return false;
+    }
+
+    const auto supported_geofence_version = 2;
+    if (!geofence_version ||
+        static_cast<int>(geofence_version.value()) != supported_geofence_version) {
+        LogErr() << "geofence version for .plan not supported, supported: "
+                 << supported_geofence_version;
+        return false;
+    }
+
+    geofence_items.insert(
+        geofence_items.end(), circular_geofences.begin(), circular_geofences.end());
+
+    mark_current_and_number(geofence_items);
+    return true;
+}
+
+bool MissionImport::stream_polygon_geofence(
+    JsonPullReader& reader, std::vector<MissionRaw::MissionItem>& geofence_items)
+{
+    if (!reader.enter_object()) {
+        return false;
+    }
+
+    bool inclusion = true;
+    // The number of vertices is needed for every item, so we have to know
+    // all of them first.
+    std::vector<std::array<std::optional<double>, 2>> points;
+
+    std::string key;
+    while (reader.next_key(key)) {
+        if (key == "inclusion") {
+            const auto value = read_number_value(reader);
+            inclusion = value ? value.value() != 0.0 : true;
+        } else if (key == "polygon" && reader.peek() == JsonPullReader::Type::Array) {
+            reader.enter_array();
+            while (reader.next_element()) {
+                std::array<std::optional<double>, 2> point{};
+                std::size_t size = 0;
+                read_numbers(reader, point, size);
+                points.push_back(point);
+            }
+        } else {
+            reader.skip_value();
+        }
+    }
+
+    for (const auto& point : points) {
+        MissionRaw::MissionItem item{};
+
+        item.command = inclusion ? MAV_CMD_NAV_FENCE_POLYGON_VERTEX_INCLUSION :
+                                   MAV_CMD_NAV_FENCE_POLYGON_VERTEX_EXCLUSION;
+        item.frame = MAV_FRAME_GLOBAL;
+        item.param1 = static_cast<float>(points.size());
+        item.x = degrees_e7(point[0]);
+        item.y = degrees_e7(point[1]);
+        item.mission_type = MAV_MISSION_TYPE_FENCE;
+
+        geofence_items.push_back(item);
+    }
+
+    return !reader.failed();
+}
+
+bool MissionImport::stream_circular_geofence(
+    JsonPullReader& reader, std::vector<MissionRaw::MissionItem>& geofence_items)
+{
+    if (!reader.enter_object()) {
+        return false;
+    }
+
+    bool inclusion = false;
+    std::array<std::optional<double>, 2> center{};
+    std::optional<double> radius;
+
+    std::string key;
+    while (reader.next_key(key)) {
+        if (key == "inclusion") {
+            const auto value = read_number_value(reader);
+            inclusion = value && value.value() != 0.0;
+        } else if (key == "circle" && reader.peek() == JsonPullReader::Type::Object) {
+            reader.enter_object();
+            std::string circle_key;
+            while (reader.next_key(circle_key)) {
+                if (circle_key == "center") {
+                    std::size_t size = 0;
+                    read_numbers(reader, center, size);
+                } else if (circle_key == "radius") {
+                    radius = read_number_value(reader);
+                } else {
+                    reader.skip_value();
+                }
+            }
+        } else {
+            reader.skip_value();
+        }
+    }
+
+    MissionRaw::MissionItem item{};
+
+    item.command =
+        inclusion ? MAV_CMD_NAV_FENCE_CIRCLE_INCLUSION : MAV_CMD_NAV_FENCE_CIRCLE_EXCLUSION;
+    item.frame = MAV_FRAME_GLOBAL;
+    item.param1 = float_or_nan(radius);
+    item.x = degrees_e7(center[0]);
+    item.y = degrees_e7(center[1]);
+    item.mission_type = MAV_MISSION_TYPE_FENCE;
+
+    geofence_items.push_back(item);
+
+    return !reader.failed();
+}
+
+bool MissionImport::stream_rally_points(
+    JsonPullReader& reader, std::vector<MissionRaw::MissionItem>& rally_items)
+{
+    if (reader.peek() != JsonPullReader::Type::Object) {
+        reader.skip_value();
+        return false;
+    }
+
+    bool empty = true;
+    std::optional<double> rally_points_version;
+
+    reader.enter_object();
+    std::string key;
+    while (reader.next_key(key)) {
+        empty = false;
+        if (key == "version") {
+            rally_points_version = read_number_value(reader);
+        } else if (key == "points" && reader.peek() == JsonPullReader::Type::Array) {
+            reader.enter_array();
+            while (reader.next_element()) {
+                std::array<std::optional<double>, 3> point{};
+                std::size_t size = 0;
+                read_numbers(reader, point, size);
+
+                MissionRaw::MissionItem item{};
+
+                item.command = MAV_CMD_NAV_RALLY_POINT;
+                item.frame = MAV_FRAME_GLOBAL_RELATIVE_ALT;
+                item.mission_type = MAV_MISSION_TYPE_RALLY;
+                item.x = degrees_e7(point[0]);
+                item.y = degrees_e7(point[1]);
+                item.z = float_or_nan(point[2]);
+
+                rally_items.push_back(item);
+            }
+        } else {
+            reader.skip_value();
+        }
+    }
+
+    if (reader.failed() || empty) {
+        return false;
+    }
+
+    const auto supported_rally_points_version = 2;
+    if (!rally_points_version ||
+        static_cast<int>(rally_points_version.value()) != supported_rally_points_version) {
+        LogErr() << "rally points version for .plan not supported, supported: "
+                 << supported_rally_points_version;
+        return false;
+    }
+
+    mark_current_and_number(rally_items);
+    return true;
+}
+
 } // namespace mavsdk
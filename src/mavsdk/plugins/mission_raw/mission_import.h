@@ -9,11 +9,19 @@
 
 namespace mavsdk {
 
+class JsonPullReader;
+
 class MissionImport {
 public:
     static std::pair<MissionRaw::Result, MissionRaw::MissionImportData>
     parse_json(const std::string& raw_json, Sender::Autopilot autopilot);
 
+    // Same result as parse_json, but the items are read straight from the
+    // text without building a JSON document first, which takes much less
+    // memory and time for large plans.
+    static std::pair<MissionRaw::Result, MissionRaw::MissionImportData>
+    parse_json_streaming(const std::string& raw_json, Sender::Autopilot autopilot);
+
 private:
     static bool check_overall_version(const Json::Value& root);
     static std::optional<std::vector<MissionRaw::MissionItem>>
@@ -32,6 +40,23 @@ private:
     import_circular_geofences(const Json::Value& json_item);
     static float set_float(const Json::Value& val);
     static int32_t set_int32(const Json::Value& val);
+
+    static bool stream_mission(
+        JsonPullReader& reader,
+        Sender::Autopilot autopilot,
+        std::vector<MissionRaw::MissionItem>& mission_items);
+    static bool stream_mission_item(
+        JsonPullReader& reader, std::vector<MissionRaw::MissionItem>& mission_items);
+    static bool stream_survey_items(
+        JsonPullReader& reader, std::vector<MissionRaw::MissionItem>& mission_items);
+    static bool
+    stream_geofence(JsonPullReader& reader, std::vector<MissionRaw::MissionItem>& geofence_items);
+    static bool stream_polygon_geofence(
+        JsonPullReader& reader, std::vector<MissionRaw::MissionItem>& geofence_items);
+    static bool stream_circular_geofence(
+        JsonPullReader& reader, std::vector<MissionRaw::MissionItem>& geofence_items);
+    static bool
+    stream_rally_points(JsonPullReader& reader, std::vector<MissionRaw::MissionItem>& rally_items);
 };
 
 } // namespace mavsdk
@@ -438,3 +438,74 @@ TEST(MissionRaw, ImportSamplePlanWithArduPilot)
 
     EXPECT_EQ(reference_items, result_pair.second.mission_items);
 }
+
+class MissionImportStreamingTest
+    : public ::testing::TestWithParam<std::pair<std::string, Sender::Autopilot>> {};
+
+TEST_P(MissionImportStreamingTest, StreamingImportMatchesDocumentImport)
+{
+    std::ifstream file(path_prefix(GetParam().first));
+    ASSERT_TRUE(file);
+
+    std::stringstream buf;
+    buf << file.rdbuf();
+    file.close();
+
+    const auto expected = MissionImport::parse_json(buf.str(), GetParam().second);
+    const auto result_pair = MissionImport::parse_json_streaming(buf.str(), GetParam().second);
+    EXPECT_EQ(result_pair.first, expected.first);
+    EXPECT_EQ(result_pair.second, expected.second);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    MissionImportStreamingTests,
+    MissionImportStreamingTest,
+    ::testing::Values(
+        std::make_pair("qgroundcontrol_sample.plan", Sender::Autopilot::Px4),
+        std::make_pair("qgroundcontrol_sample.plan", Sender::Autopilot::ArduPilot),
+        std::make_pair("qgroundcontrol_sample_with_structured_scan.plan", Sender::Autopilot::Px4),
+        std::make_pair("qgroundcontrol_sample_with_survey.plan", Sender::Autopilot::Px4),
+        std::make_pair(
+            "qgroundcontrol_sample_with_survey_missing_items.plan", Sender::Autopilot::Px4),
+        std::make_pair(
+            "qgroundcontrol_sample_with_survey_wrong_version.plan", Sender::Autopilot::Px4),
+        std::make_pair("qgroundcontrol_sample_without_mission.plan", Sender::Autopilot::Px4),
+        std::make_pair("qgroundcontrol_sample_wrong_mission_version.plan", Sender::Autopilot::Px4),
+        std::make_pair(
+            "qgroundcontrol_sample_wrong_overall_version.plan", Sender::Autopilot::Px4)));
+
+TEST(MissionRaw, ImportStreamingDoesNotDependOnKeyOrder)
+{
+    const std::string plan = R"({
+        "rallyPoints": {"points": [[47.1, 8.2, 30]], "version": 2},
+        "mission": {
+            "items": [
+                {"params": [0, 0, 0, null, 47.3977507, 8.5456075, 50],
+                 "frame": 3, "command": 16, "autoContinue": true, "type": "SimpleItem"},
+                {"TransectStyleComplexItem": {"Items": [
+                    {"autoContinue": false, "command": 16, "frame": 3,
+                     "params": [1, 2, 3, 4, 47.1, 8.1, 20], "type": "SimpleItem"}]},
+                 "version": 5, "complexItemType": "survey", "type": "ComplexItem"}
+            ],
+            "version": 2
+        },
+        "geoFence": {"circles": [], "polygons": [], "version": 2},
+        "version": 1
+    })";
+
+    const auto expected = MissionImport::parse_json(plan, Sender::Autopilot::Px4);
+    ASSERT_EQ(expected.first, MissionRaw::Result::Success);
+    ASSERT_EQ(expected.second.mission_items.size(), 2);
+
+    const auto result_pair = MissionImport::parse_json_streaming(plan, Sender::Autopilot::Px4);
+    EXPECT_EQ(result_pair.first, MissionRaw::Result::Success);
+    EXPECT_EQ(result_pair.second, expected.second);
+}
+
+TEST(MissionRaw, ImportStreamingRejectsBrokenJson)
+{
+    const auto result_pair = MissionImport::parse_json_streaming(
+        R"({"version": 1, "mission": {"version": 2, "items": [}})", Sender::Autopilot::Px4);
+    EXPECT_EQ(result_pair.first, MissionRaw::Result::FailedToParseQgcPlan);
+    EXPECT_EQ(result_pair.second.mission_items.size(), 0);
+}
@@ -26,34 +26,35 @@ MissionRaw::MissionRaw(std::shared_ptr<System> system) :
 MissionRaw::~MissionRaw() {}
 
 void MissionRaw::upload_mission_async(
-    std::vector<MissionItem> mission_items, const ResultCallback callback)
+    const std::vector<MissionItem>& mission_items, const ResultCallback& callback)
 {
     _impl->upload_mission_async(mission_items, callback);
 }
 
-MissionRaw::Result MissionRaw::upload_mission(std::vector<MissionItem> mission_items) const
+MissionRaw::Result MissionRaw::upload_mission(const std::vector<MissionItem>& mission_items) const
 {
     return _impl->upload_mission(mission_items);
 }
 
 void MissionRaw::upload_geofence_async(
-    std::vector<MissionItem> mission_items, const ResultCallback callback)
+    const std::vector<MissionItem>& mission_items, const ResultCallback& callback)
 {
     _impl->upload_geofence_async(mission_items, callback);
 }
 
-MissionRaw::Result MissionRaw::upload_geofence(std::vector<MissionItem> mission_items) const
+MissionRaw::Result MissionRaw::upload_geofence(const std::vector<MissionItem>& mission_items) const
 {
     return _impl->upload_geofence(mission_items);
 }
 
 void MissionRaw::upload_rally_points_async(
-    std::vector<MissionItem> mission_items, const ResultCallback callback)
+    const std::vector<MissionItem>& mission_items, const ResultCallback& callback)
 {
     _impl->upload_rally_points_async(mission_items, callback);
 }
 
-MissionRaw::Result MissionRaw::upload_rally_points(std::vector<MissionItem> mission_items) const
+MissionRaw::Result MissionRaw::upload_rally_points(
+    const std::vector<MissionItem>& mission_items) const
 {
     return _impl->upload_rally_points(mission_items);
 }
@@ -63,7 +64,7 @@ MissionRaw::Result MissionRaw::cancel_mission_upload() const
     return _impl->cancel_mission_upload();
 }
 
-void MissionRaw::download_mission_async(const DownloadMissionCallback callback)
+void MissionRaw::download_mission_async(const DownloadMissionCallback& callback)
 {
     _impl->download_mission_async(callback);
 }
@@ -79,7 +80,7 @@ MissionRaw::Result MissionRaw::cancel_mission_download() const
     return _impl->cancel_mission_download();
 }
 
-void MissionRaw::start_mission_async(const ResultCallback callback)
+void MissionRaw::start_mission_async(const ResultCallback& callback)
 {
     _impl->start_mission_async(callback);
 }
@@ -89,7 +90,7 @@ MissionRaw::Result MissionRaw::start_mission() const
     return _impl->start_mission();
 }
 
-void MissionRaw::pause_mission_async(const ResultCallback callback)
+void MissionRaw::pause_mission_async(const ResultCallback& callback)
 {
     _impl->pause_mission_async(callback);
 }
@@ -99,7 +100,7 @@ MissionRaw::Result MissionRaw::pause_mission() const
     return _impl->pause_mission();
 }
 
-void MissionRaw::clear_mission_async(const ResultCallback callback)
+void MissionRaw::clear_mission_async(const ResultCallback& callback)
 {
     _impl->clear_mission_async(callback);
 }
@@ -109,7 +110,7 @@ MissionRaw::Result MissionRaw::clear_mission() const
     return _impl->clear_mission();
 }
 
-void MissionRaw::set_current_mission_item_async(int32_t index, const ResultCallback callback)
+void MissionRaw::set_current_mission_item_async(int32_t index, const ResultCallback& callback)
 {
     _impl->set_current_mission_item_async(index, callback);
 }
@@ -147,13 +148,13 @@ void MissionRaw::unsubscribe_mission_changed(MissionChangedHandle handle)
 }
 
 std::pair<MissionRaw::Result, MissionRaw::MissionImportData>
-MissionRaw::import_qgroundcontrol_mission(std::string qgc_plan_path) const
+MissionRaw::import_qgroundcontrol_mission(const std::string& qgc_plan_path) const
 {
     return _impl->import_qgroundcontrol_mission(qgc_plan_path);
 }
 
 std::pair<MissionRaw::Result, MissionRaw::MissionImportData>
-MissionRaw::import_qgroundcontrol_mission_from_string(std::string qgc_plan) const
+MissionRaw::import_qgroundcontrol_mission_from_string(const std::string& qgc_plan) const
 {
     return _impl->import_qgroundcontrol_mission_from_string(qgc_plan);
 }
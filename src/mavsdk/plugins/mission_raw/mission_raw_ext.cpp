@@ -0,0 +1,8 @@
+#include "mission_raw_impl.h"
+#include "plugins/mission_raw/mission_raw_ext.h"
+
+namespace mavsdk {
+
+MissionRawExt::MissionRawExt(MissionRaw& mission_raw) : _impl(*mission_raw._impl) {}
+
+} // namespace mavsdk
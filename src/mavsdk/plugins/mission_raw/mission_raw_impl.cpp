@@ -145,13 +145,12 @@ void MissionRawImpl::upload_mission_items_async(
 
     reset_mission_progress();
 
-    const auto int_items = convert_to_int_items(mission_raw);
-
     _last_upload = _system_impl->mission_transfer().upload_items_async(
-        type, int_items, [this, callback, int_items](MavlinkMissionTransfer::Result result) {
+        type,
+        convert_to_int_items(mission_raw),
+        [this, callback](MavlinkMissionTransfer::Result result) {
             auto converted_result = convert_result(result);
-            auto converted_items = convert_items(int_items);
-            _system_impl->call_user_callback([callback, converted_result, converted_items]() {
+            _system_impl->call_user_callback([callback, converted_result]() {
                 if (callback) {
                     callback(converted_result);
                 }
@@ -540,13 +539,13 @@ MissionRawImpl::import_qgroundcontrol_mission(std::string qgc_plan_path)
     buf << file.rdbuf();
     file.close();
 
-    return MissionImport::parse_json(buf.str(), _system_impl->autopilot());
+    return MissionImport::parse_json_streaming(buf.str(), _system_impl->autopilot());
 }
 
 std::pair<MissionRaw::Result, MissionRaw::MissionImportData>
 MissionRawImpl::import_qgroundcontrol_mission_from_string(const std::string& qgc_plan)
 {
-    return MissionImport::parse_json(qgc_plan, _system_impl->autopilot());
+    return MissionImport::parse_json_streaming(qgc_plan, _system_impl->autopilot());
 }
 
 MissionRaw::Result MissionRawImpl::convert_result(MavlinkMissionTransfer::Result result)
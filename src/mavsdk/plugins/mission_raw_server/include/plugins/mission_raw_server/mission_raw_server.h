@@ -16,6 +16,7 @@
 
 #include "server_plugin_base.h"
 
+#include "awaitable.h"
 #include "handle.h"
 
 namespace mavsdk {
@@ -269,6 +270,9 @@ public:
 private:
     /** @private Underlying implementation, set at instantiation */
     std::unique_ptr<MissionRawServerImpl> _impl;
+
+    /** @private Hand-written additions in mission_raw_server_ext.h, if any */
+    friend class MissionRawServerExt;
 };
 
 } // namespace mavsdk
\ No newline at end of file
@@ -128,20 +128,6 @@ void MissionRawServerImpl::init()
 {
     _server_component_impl->add_capabilities(MAV_PROTOCOL_CAPABILITY_MISSION_INT);
 
-    _thread_mission = std::thread([this] {
-        while (!_stop_work_thread) {
-            std::unique_lock<std::mutex> lock(_work_mutex);
-            if (!_work_queue.empty()) {
-                auto task = _work_queue.front();
-                _work_queue.pop();
-                lock.unlock();
-                task();
-            } else {
-                _wait_for_new_task.wait(lock);
-            }
-        }
-    });
-
     // Handle Initiate Upload
     _server_component_impl->register_mavlink_message_handler(
         MAVLINK_MSG_ID_MISSION_COUNT,
@@ -155,39 +141,43 @@ void MissionRawServerImpl::init()
             _mission_count = count.count;
 
             // We need to queue this on a different thread or it will deadlock
-            add_task([this, target_system_id = message.sysid]() {
-                // Mission Upload Inbound
-                if (_last_download.lock()) {
-                    _incoming_mission_callbacks.queue(
-                        MissionRawServer::Result::Busy,
-                        MissionRawServer::MissionPlan{},
-                        [this](const auto& func) {
-                            _server_component_impl->call_user_callback(func);
-                        });
-                    return;
-                }
-
-                _server_component_impl->set_our_current_target_system_id(target_system_id);
-
-                _last_download =
-                    _server_component_impl->mission_transfer().receive_incoming_items_async(
-                        MAV_MISSION_TYPE_MISSION,
-                        _mission_count,
-                        _target_component,
-                        [this](
-                            MavlinkMissionTransfer::Result result,
-                            std::vector<MavlinkMissionTransfer::ItemInt> items) {
-                            _current_mission = items;
-                            auto converted_result = convert_result(result);
-                            auto converted_items = convert_items(items);
-                            _incoming_mission_callbacks.queue(
-                                converted_result, {converted_items}, [this](const auto& func) {
-                                    _server_component_impl->call_user_callback(func);
-                                });
-                            _mission_completed = false;
-                            set_current_seq(0);
-                        });
-            });
+            _server_component_impl->queue_work(
+                [this, target_system_id = message.sysid]() {
+                    // Mission Upload Inbound
+                    if (_last_download.lock()) {
+                        _incoming_mission_callbacks.queue(
+                            MissionRawServer::Result::Busy,
+                            MissionRawServer::MissionPlan{},
+                            [this](const auto& func) {
+                                _server_component_impl->call_user_callback(func);
+                            });
+                        return;
+                    }
+
+                    _server_component_impl->set_our_current_target_system_id(target_system_id);
+
+                    _last_download =
+                        _server_component_impl->mission_transfer().receive_incoming_items_async(
+                            MAV_MISSION_TYPE_MISSION,
+                            _mission_count,
+                            _target_component,
+                            [this](
+                                MavlinkMissionTransfer::Result result,
+                                std::vector<MavlinkMissionTransfer::ItemInt> items) {
+                                auto converted_result = convert_result(result);
+                                auto converted_items = convert_items(items);
+                                _current_mission = std::move(items);
+                                _incoming_mission_callbacks.queue(
+                                    converted_result,
+                                    MissionRawServer::MissionPlan{std::move(converted_items)},
+                                    [this](const auto& func) {
+                                        _server_component_impl->call_user_callback(func);
+                                    });
+                                _mission_completed = false;
+                                set_current_seq(0);
+                            });
+                },
+                this);
         },
         this);
 
@@ -261,9 +251,7 @@ void MissionRawServerImpl::init()
 void MissionRawServerImpl::deinit()
 {
     _server_component_impl->unregister_all_mavlink_message_handlers(this);
-    _stop_work_thread = true;
-    _wait_for_new_task.notify_all();
-    _thread_mission.join();
+    _server_component_impl->remove_queued_work(this);
 }
 
 MissionRawServer::IncomingMissionHandle MissionRawServerImpl::subscribe_incoming_mission(
@@ -4,8 +4,7 @@
 #include "server_plugin_impl_base.h"
 #include "callback_list.h"
 
-#include <thread>
-#include <condition_variable>
+#include <atomic>
 
 namespace mavsdk {
 
@@ -41,28 +40,16 @@ private:
         _incoming_mission_callbacks{};
     CallbackList<MissionRawServer::MissionItem> _current_item_changed_callbacks{};
     CallbackList<uint32_t> _clear_all_callbacks{};
-    std::thread _thread_mission;
     std::atomic<int> _target_component;
     std::atomic<int> _mission_count;
     std::atomic<bool> _mission_completed;
 
-    std::queue<std::function<void()>> _work_queue;
-    std::condition_variable _wait_for_new_task;
-    std::mutex _work_mutex;
-    std::atomic<bool> _stop_work_thread = false;
-
     std::vector<MavlinkMissionTransfer::ItemInt> _current_mission;
     std::size_t _current_seq;
 
     std::weak_ptr<MavlinkMissionTransfer::WorkItem> _last_download{};
 
     void set_current_seq(std::size_t seq);
-
-    void add_task(std::function<void()> task)
-    {
-        _work_queue.push(task);
-        _wait_for_new_task.notify_one();
-    }
 };
 
 } // namespace mavsdk
@@ -15,6 +15,7 @@
 
 #include "plugin_base.h"
 
+#include "awaitable.h"
 #include "handle.h"
 
 namespace mavsdk {
@@ -345,7 +346,8 @@ public:
      *
      * @return Result of request.
      */
-    Result set_vision_position_estimate(VisionPositionEstimate vision_position_estimate) const;
+    Result set_vision_position_estimate(
+        const VisionPositionEstimate& vision_position_estimate) const;
 
     /**
      * @brief Send motion capture attitude and position.
@@ -354,7 +356,7 @@ public:
      *
      * @return Result of request.
      */
-    Result set_attitude_position_mocap(AttitudePositionMocap attitude_position_mocap) const;
+    Result set_attitude_position_mocap(const AttitudePositionMocap& attitude_position_mocap) const;
 
     /**
      * @brief Send odometry information with an external interface.
@@ -363,7 +365,7 @@ public:
      *
      * @return Result of request.
      */
-    Result set_odometry(Odometry odometry) const;
+    Result set_odometry(const Odometry& odometry) const;
 
     /**
      * @brief Copy constructor.
@@ -378,6 +380,9 @@ public:
 private:
     /** @private Underlying implementation, set at instantiation */
     std::unique_ptr<MocapImpl> _impl;
+
+    /** @private Hand-written additions in mocap_ext.h, if any */
+    friend class MocapExt;
 };
 
 } // namespace mavsdk
\ No newline at end of file
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "plugins/mocap/mocap.h"
+
+namespace mavsdk {
+
+class MocapImpl;
+
+/**
+ * @brief Additions to Mocap that are only available in C++.
+ *
+ * Unlike mocap.h, this header is not generated from the proto files,
+ * so the calls here are not available through mavsdk_server.
+ *
+ * It works on the Mocap plugin it is created with, which has to outlive it:
+ *
+ *     ```cpp
+ *     auto mocap = Mocap(system);
+ *     auto mocap_ext = MocapExt(mocap);
+ *     ```
+ */
+class MocapExt {
+public:
+    /**
+     * @brief Constructor. Uses the given Mocap plugin.
+     *
+     * @param mocap The plugin, which has to outlive this object.
+     */
+    explicit MocapExt(Mocap& mocap);
+
+    /**
+     * @brief Start or stop sending the set values from a separate thread.
+     *
+     * The set functions then only check and hand over the values, and return without waiting for
+     * the link. If values are set faster than they can be sent, only the latest one of each kind
+     * is sent, which keeps high rate motion capture feeds from backing up behind other traffic.
+     * Connection errors are not returned in this mode.
+     */
+    void set_streaming_enabled(bool enabled) const;
+
+private:
+    MocapImpl& _impl;
+};
+
+} // namespace mavsdk
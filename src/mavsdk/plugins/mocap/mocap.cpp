@@ -28,19 +28,19 @@ Mocap::Mocap(std::shared_ptr<System> system) :
 
 Mocap::~Mocap() {}
 
-Mocap::Result
-Mocap::set_vision_position_estimate(VisionPositionEstimate vision_position_estimate) const
+Mocap::Result Mocap::set_vision_position_estimate(
+    const VisionPositionEstimate& vision_position_estimate) const
 {
     return _impl->set_vision_position_estimate(vision_position_estimate);
 }
 
-Mocap::Result
-Mocap::set_attitude_position_mocap(AttitudePositionMocap attitude_position_mocap) const
+Mocap::Result Mocap::set_attitude_position_mocap(
+    const AttitudePositionMocap& attitude_position_mocap) const
 {
     return _impl->set_attitude_position_mocap(attitude_position_mocap);
 }
 
-Mocap::Result Mocap::set_odometry(Odometry odometry) const
+Mocap::Result Mocap::set_odometry(const Odometry& odometry) const
 {
     return _impl->set_odometry(odometry);
 }
@@ -0,0 +1,13 @@
+#include "mocap_impl.h"
+#include "plugins/mocap/mocap_ext.h"
+
+namespace mavsdk {
+
+MocapExt::MocapExt(Mocap& mocap) : _impl(*mocap._impl) {}
+
+void MocapExt::set_streaming_enabled(bool enabled) const
+{
+    _impl.set_streaming_enabled(enabled);
+}
+
+} // namespace mavsdk
@@ -8,7 +8,12 @@ namespace mavsdk {
 
 void MocapImpl::init() {}
 
-void MocapImpl::deinit() {}
+void MocapImpl::deinit()
+{
+    std::lock_guard<std::mutex> lock(_streaming_thread_mutex);
+    _streaming_enabled = false;
+    stop_streaming_thread();
+}
 
 void MocapImpl::enable() {}
 
@@ -36,7 +41,19 @@ Mocap::Result MocapImpl::set_vision_position_estimate(
         return Mocap::Result::NoSystem;
     }
 
-    return send_vision_position_estimate(vision_position_estimate);
+    PreparedVisionPositionEstimate prepared;
+    const auto result = prepare_vision_position_estimate(vision_position_estimate, prepared);
+    if (result != Mocap::Result::Success) {
+        return result;
+    }
+
+    if (_streaming_enabled) {
+        _streamed_vision_position_estimate.store(prepared);
+        notify_streaming_thread(PendingVisionPositionEstimate);
+        return Mocap::Result::Success;
+    }
+
+    return send_vision_position_estimate(prepared);
 }
 
 Mocap::Result
@@ -46,7 +63,19 @@ MocapImpl::set_attitude_position_mocap(const Mocap::AttitudePositionMocap& attit
         return Mocap::Result::NoSystem;
     }
 
-    return send_attitude_position_mocap(attitude_position_mocap);
+    PreparedAttitudePositionMocap prepared;
+    const auto result = prepare_attitude_position_mocap(attitude_position_mocap, prepared);
+    if (result != Mocap::Result::Success) {
+        return result;
+    }
+
+    if (_streaming_enabled) {
+        _streamed_attitude_position_mocap.store(prepared);
+        notify_streaming_thread(PendingAttitudePositionMocap);
+        return Mocap::Result::Success;
+    }
+
+    return send_attitude_position_mocap(prepared);
 }
 
 Mocap::Result MocapImpl::set_odometry(const Mocap::Odometry& odometry)
@@ -55,186 +84,252 @@ Mocap::Result MocapImpl::set_odometry(const Mocap::Odometry& odometry)
         return Mocap::Result::NoSystem;
     }
 
-    return send_odometry(odometry);
+    PreparedOdometry prepared;
+    const auto result = prepare_odometry(odometry, prepared);
+    if (result != Mocap::Result::Success) {
+        return result;
+    }
+
+    if (_streaming_enabled) {
+        _streamed_odometry.store(prepared);
+        notify_streaming_thread(PendingOdometry);
+        return Mocap::Result::Success;
+    }
+
+    return send_odometry(prepared);
 }
 
-Mocap::Result MocapImpl::send_vision_position_estimate(
-    const Mocap::VisionPositionEstimate& vision_position_estimate)
+void MocapImpl::set_streaming_enabled(bool enabled)
 {
-    const uint64_t autopilot_time_usec =
-        (!vision_position_estimate.time_usec) ?
-            std::chrono::duration_cast<std::chrono::microseconds>(
-                _system_impl->get_autopilot_time().now().time_since_epoch())
-                .count() :
-            std::chrono::duration_cast<std::chrono::microseconds>(
-                _system_impl->get_autopilot_time()
-                    .time_in(SystemTimePoint(
-                        std::chrono::microseconds(vision_position_estimate.time_usec)))
-                    .time_since_epoch())
-                .count();
+    std::lock_guard<std::mutex> lock(_streaming_thread_mutex);
+
+    if (enabled && _streaming_thread == nullptr) {
+        {
+            std::lock_guard<std::mutex> streaming_lock(_streaming_mutex);
+            _streaming_should_exit = false;
+        }
+        // Anything left from before is outdated.
+        _streaming_pending = 0;
+        _streaming_thread = std::make_unique<std::thread>(&MocapImpl::run_streaming_thread, this);
+    }
+
+    // Values set from now on are sent directly, the remaining streamed ones
+    // are dropped.
+    _streaming_enabled = enabled;
 
-    std::array<float, 21> covariance{};
+    if (!enabled) {
+        stop_streaming_thread();
+    }
+}
+
+void MocapImpl::stop_streaming_thread()
+{
+    if (_streaming_thread == nullptr) {
+        return;
+    }
 
+    {
+        std::lock_guard<std::mutex> lock(_streaming_mutex);
+        _streaming_should_exit = true;
+    }
+    _streaming_cv.notify_one();
+    _streaming_thread->join();
+    _streaming_thread.reset();
+    _streaming_pending = 0;
+}
+
+void MocapImpl::notify_streaming_thread(Pending pending)
+{
+    // The thread only waits when nothing is pending, so it only needs to be
+    // woken up for the first value. The lock makes sure it doesn't miss it
+    // while going to sleep.
+    if (_streaming_pending.fetch_or(pending) == 0) {
+        std::lock_guard<std::mutex> lock(_streaming_mutex);
+        _streaming_cv.notify_one();
+    }
+}
+
+void MocapImpl::run_streaming_thread()
+{
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(_streaming_mutex);
+            _streaming_cv.wait(
+                lock, [this]() { return _streaming_should_exit || _streaming_pending != 0; });
+            if (_streaming_should_exit) {
+                return;
+            }
+        }
+
+        // Whatever is set while sending is picked up in the next round, only
+        // the latest value of each.
+        const unsigned pending = _streaming_pending.exchange(0);
+
+        if (pending & PendingVisionPositionEstimate) {
+            send_vision_position_estimate(_streamed_vision_position_estimate.load());
+        }
+        if (pending & PendingAttitudePositionMocap) {
+            send_attitude_position_mocap(_streamed_attitude_position_mocap.load());
+        }
+        if (pending & PendingOdometry) {
+            send_odometry(_streamed_odometry.load());
+        }
+    }
+}
+
+uint64_t MocapImpl::autopilot_time_usec(uint64_t time_usec) const
+{
+    return (!time_usec) ?
+               std::chrono::duration_cast<std::chrono::microseconds>(
+                   _system_impl->get_autopilot_time().now().time_since_epoch())
+                   .count() :
+               std::chrono::duration_cast<std::chrono::microseconds>(
+                   _system_impl->get_autopilot_time()
+                       .time_in(SystemTimePoint(std::chrono::microseconds(time_usec)))
+                       .time_since_epoch())
+                   .count();
+}
+
+bool MocapImpl::prepare_covariance(const Mocap::Covariance& covariance, Covariance& prepared)
+{
     // The covariance matrix needs to have length 21 or 1 with the one entry set to NaN.
 
-    if (vision_position_estimate.pose_covariance.covariance_matrix.size() == 21) {
+    if (covariance.covariance_matrix.size() == 21) {
         std::copy(
-            vision_position_estimate.pose_covariance.covariance_matrix.begin(),
-            vision_position_estimate.pose_covariance.covariance_matrix.end(),
-            covariance.begin());
+            covariance.covariance_matrix.begin(),
+            covariance.covariance_matrix.end(),
+            prepared.begin());
     } else if (
-        vision_position_estimate.pose_covariance.covariance_matrix.size() == 1 &&
-        std::isnan(vision_position_estimate.pose_covariance.covariance_matrix[0])) {
-        covariance[0] = NAN;
+        covariance.covariance_matrix.size() == 1 && std::isnan(covariance.covariance_matrix[0])) {
+        prepared = {};
+        prepared[0] = NAN;
     } else {
+        return false;
+    }
+    return true;
+}
+
+Mocap::Result MocapImpl::prepare_vision_position_estimate(
+    const Mocap::VisionPositionEstimate& vision_position_estimate,
+    PreparedVisionPositionEstimate& prepared) const
+{
+    if (!prepare_covariance(vision_position_estimate.pose_covariance, prepared.pose_covariance)) {
+        return Mocap::Result::InvalidRequestData;
+    }
+
+    prepared.autopilot_time_usec = autopilot_time_usec(vision_position_estimate.time_usec);
+    prepared.position_body = vision_position_estimate.position_body;
+    prepared.angle_body = vision_position_estimate.angle_body;
+    return Mocap::Result::Success;
+}
+
+Mocap::Result MocapImpl::prepare_attitude_position_mocap(
+    const Mocap::AttitudePositionMocap& attitude_position_mocap,
+    PreparedAttitudePositionMocap& prepared) const
+{
+    if (!prepare_covariance(attitude_position_mocap.pose_covariance, prepared.pose_covariance)) {
+        return Mocap::Result::InvalidRequestData;
+    }
+
+    prepared.autopilot_time_usec = autopilot_time_usec(attitude_position_mocap.time_usec);
+    prepared.q = attitude_position_mocap.q;
+    prepared.position_body = attitude_position_mocap.position_body;
+    return Mocap::Result::Success;
+}
+
+Mocap::Result
+MocapImpl::prepare_odometry(const Mocap::Odometry& odometry, PreparedOdometry& prepared) const
+{
+    if (!prepare_covariance(odometry.pose_covariance, prepared.pose_covariance) ||
+        !prepare_covariance(odometry.velocity_covariance, prepared.velocity_covariance)) {
         return Mocap::Result::InvalidRequestData;
     }
 
+    prepared.autopilot_time_usec = autopilot_time_usec(odometry.time_usec);
+    prepared.frame_id = odometry.frame_id;
+    prepared.position_body = odometry.position_body;
+    prepared.q = odometry.q;
+    prepared.speed_body = odometry.speed_body;
+    prepared.angular_velocity_body = odometry.angular_velocity_body;
+    return Mocap::Result::Success;
+}
+
+Mocap::Result
+MocapImpl::send_vision_position_estimate(const PreparedVisionPositionEstimate& prepared)
+{
     mavlink_message_t message;
     mavlink_msg_vision_position_estimate_pack(
         _system_impl->get_own_system_id(),
         _system_impl->get_own_component_id(),
         &message,
-        autopilot_time_usec,
-        vision_position_estimate.position_body.x_m,
-        vision_position_estimate.position_body.y_m,
-        vision_position_estimate.position_body.z_m,
-        vision_position_estimate.angle_body.roll_rad,
-        vision_position_estimate.angle_body.pitch_rad,
-        vision_position_estimate.angle_body.yaw_rad,
-        covariance.data(),
+        prepared.autopilot_time_usec,
+        prepared.position_body.x_m,
+        prepared.position_body.y_m,
+        prepared.position_body.z_m,
+        prepared.angle_body.roll_rad,
+        prepared.angle_body.pitch_rad,
+        prepared.angle_body.yaw_rad,
+        prepared.pose_covariance.data(),
         0); // FIXME: reset_counter not set
 
     return _system_impl->send_message(message) ? Mocap::Result::Success :
                                                  Mocap::Result::ConnectionError;
 }
 
-Mocap::Result
-MocapImpl::send_attitude_position_mocap(const Mocap::AttitudePositionMocap& attitude_position_mocap)
-{
-    const uint64_t autopilot_time_usec =
-        (!attitude_position_mocap.time_usec) ?
-            std::chrono::duration_cast<std::chrono::microseconds>(
-                _system_impl->get_autopilot_time().now().time_since_epoch())
-                .count() :
-            std::chrono::duration_cast<std::chrono::microseconds>(
-                _system_impl->get_autopilot_time()
-                    .time_in(SystemTimePoint(
-                        std::chrono::microseconds(attitude_position_mocap.time_usec)))
-                    .time_since_epoch())
-                .count();
-
+Mocap::Result MocapImpl::send_attitude_position_mocap(const PreparedAttitudePositionMocap& prepared)
+{
     mavlink_message_t message;
 
     std::array<float, 4> q{};
-    q[0] = attitude_position_mocap.q.w;
-    q[1] = attitude_position_mocap.q.x;
-    q[2] = attitude_position_mocap.q.y;
-    q[3] = attitude_position_mocap.q.z;
-
-    std::array<float, 21> covariance{};
-
-    // The covariance matrix needs to have length 21 or 1 with the one entry set to NaN.
-
-    if (attitude_position_mocap.pose_covariance.covariance_matrix.size() == 21) {
-        std::copy(
-            attitude_position_mocap.pose_covariance.covariance_matrix.begin(),
-            attitude_position_mocap.pose_covariance.covariance_matrix.end(),
-            covariance.begin());
-    } else if (
-        attitude_position_mocap.pose_covariance.covariance_matrix.size() == 1 &&
-        std::isnan(attitude_position_mocap.pose_covariance.covariance_matrix[0])) {
-        covariance[0] = NAN;
-    } else {
-        return Mocap::Result::InvalidRequestData;
-    }
+    q[0] = prepared.q.w;
+    q[1] = prepared.q.x;
+    q[2] = prepared.q.y;
+    q[3] = prepared.q.z;
 
     mavlink_msg_att_pos_mocap_pack(
         _system_impl->get_own_system_id(),
         _system_impl->get_own_component_id(),
         &message,
-        autopilot_time_usec,
+        prepared.autopilot_time_usec,
         q.data(),
-        attitude_position_mocap.position_body.x_m,
-        attitude_position_mocap.position_body.y_m,
-        attitude_position_mocap.position_body.z_m,
-        covariance.data());
+        prepared.position_body.x_m,
+        prepared.position_body.y_m,
+        prepared.position_body.z_m,
+        prepared.pose_covariance.data());
 
     return _system_impl->send_message(message) ? Mocap::Result::Success :
                                                  Mocap::Result::ConnectionError;
 }
 
-Mocap::Result MocapImpl::send_odometry(const Mocap::Odometry& odometry)
+Mocap::Result MocapImpl::send_odometry(const PreparedOdometry& prepared)
 {
-    const uint64_t autopilot_time_usec =
-        (!odometry.time_usec) ?
-            std::chrono::duration_cast<std::chrono::microseconds>(
-                _system_impl->get_autopilot_time().now().time_since_epoch())
-                .count() :
-            std::chrono::duration_cast<std::chrono::microseconds>(
-                _system_impl->get_autopilot_time()
-                    .time_in(SystemTimePoint(std::chrono::microseconds(odometry.time_usec)))
-                    .time_since_epoch())
-                .count();
-
     mavlink_message_t message;
 
     std::array<float, 4> q{};
-    q[0] = odometry.q.w;
-    q[1] = odometry.q.x;
-    q[2] = odometry.q.y;
-    q[3] = odometry.q.z;
-
-    std::array<float, 21> pose_covariance{};
-    std::array<float, 21> velocity_covariance{};
-
-    // The covariance matrix needs to have length 21 or 1 with the one entry set to NaN.
-
-    if (odometry.pose_covariance.covariance_matrix.size() == 21) {
-        std::copy(
-            odometry.pose_covariance.covariance_matrix.begin(),
-            odometry.pose_covariance.covariance_matrix.end(),
-            pose_covariance.begin());
-    } else if (
-        odometry.pose_covariance.covariance_matrix.size() == 1 &&
-        std::isnan(odometry.pose_covariance.covariance_matrix[0])) {
-        pose_covariance[0] = NAN;
-    } else {
-        return Mocap::Result::InvalidRequestData;
-    }
-
-    if (odometry.velocity_covariance.covariance_matrix.size() == 21) {
-        std::copy(
-            odometry.velocity_covariance.covariance_matrix.begin(),
-            odometry.velocity_covariance.covariance_matrix.end(),
-            velocity_covariance.begin());
-    } else if (
-        odometry.velocity_covariance.covariance_matrix.size() == 1 &&
-        std::isnan(odometry.velocity_covariance.covariance_matrix[0])) {
-        velocity_covariance[0] = NAN;
-    } else {
-        return Mocap::Result::InvalidRequestData;
-    }
+    q[0] = prepared.q.w;
+    q[1] = prepared.q.x;
+    q[2] = prepared.q.y;
+    q[3] = prepared.q.z;
 
     mavlink_msg_odometry_pack(
         _system_impl->get_own_system_id(),
         _system_impl->get_own_component_id(),
         &message,
-        autopilot_time_usec,
-        static_cast<uint8_t>(odometry.frame_id),
+        prepared.autopilot_time_usec,
+        static_cast<uint8_t>(prepared.frame_id),
         static_cast<uint8_t>(MAV_FRAME_BODY_FRD),
-        odometry.position_body.x_m,
-        odometry.position_body.y_m,
-        odometry.position_body.z_m,
+        prepared.position_body.x_m,
+        prepared.position_body.y_m,
+        prepared.position_body.z_m,
         q.data(),
-        odometry.speed_body.x_m_s,
-        odometry.speed_body.y_m_s,
-        odometry.speed_body.z_m_s,
-        odometry.angular_velocity_body.roll_rad_s,
-        odometry.angular_velocity_body.pitch_rad_s,
-        odometry.angular_velocity_body.yaw_rad_s,
-        pose_covariance.data(),
-        velocity_covariance.data(),
+        prepared.speed_body.x_m_s,
+        prepared.speed_body.y_m_s,
+        prepared.speed_body.z_m_s,
+        prepared.angular_velocity_body.roll_rad_s,
+        prepared.angular_velocity_body.pitch_rad_s,
+        prepared.angular_velocity_body.yaw_rad_s,
+        prepared.pose_covariance.data(),
+        prepared.velocity_covariance.data(),
         0,
         MAV_ESTIMATOR_TYPE_MOCAP,
         0);
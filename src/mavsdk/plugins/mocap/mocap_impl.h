@@ -3,8 +3,16 @@
 #include "plugins/mocap/mocap.h"
 #include "mavlink_include.h"
 #include "plugin_impl_base.h"
+#include "seqlock.h"
 #include "system.h"
 
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
 namespace mavsdk {
 
 class System;
@@ -27,14 +35,86 @@ public:
     set_attitude_position_mocap(const Mocap::AttitudePositionMocap& attitude_position_mocap);
     Mocap::Result set_odometry(const Mocap::Odometry& odometry);
 
+    void set_streaming_enabled(bool enabled);
+
     MocapImpl(const MocapImpl&) = delete;
     MocapImpl& operator=(const MocapImpl&) = delete;
 
 private:
+    // The values as they are sent, checked and with the autopilot time.
+    // Unlike the public types they are trivially copyable, so that they can
+    // be handed to the streaming thread without a lock or an allocation.
+    using Covariance = std::array<float, 21>;
+
+    struct PreparedVisionPositionEstimate {
+        uint64_t autopilot_time_usec{0};
+        Mocap::PositionBody position_body{};
+        Mocap::AngleBody angle_body{};
+        Covariance pose_covariance{};
+    };
+
+    struct PreparedAttitudePositionMocap {
+        uint64_t autopilot_time_usec{0};
+        Mocap::Quaternion q{};
+        Mocap::PositionBody position_body{};
+        Covariance pose_covariance{};
+    };
+
+    struct PreparedOdometry {
+        uint64_t autopilot_time_usec{0};
+        Mocap::Odometry::MavFrame frame_id{};
+        Mocap::PositionBody position_body{};
+        Mocap::Quaternion q{};
+        Mocap::SpeedBody speed_body{};
+        Mocap::AngularVelocityBody angular_velocity_body{};
+        Covariance pose_covariance{};
+        Covariance velocity_covariance{};
+    };
+
+    uint64_t autopilot_time_usec(uint64_t time_usec) const;
+    static bool prepare_covariance(const Mocap::Covariance& covariance, Covariance& prepared);
+
+    Mocap::Result prepare_vision_position_estimate(
+        const Mocap::VisionPositionEstimate& vision_position_estimate,
+        PreparedVisionPositionEstimate& prepared) const;
+    Mocap::Result prepare_attitude_position_mocap(
+        const Mocap::AttitudePositionMocap& attitude_position_mocap,
+        PreparedAttitudePositionMocap& prepared) const;
     Mocap::Result
-    send_vision_position_estimate(const Mocap::VisionPositionEstimate& vision_position_estimate);
-    Mocap::Result
-    send_attitude_position_mocap(const Mocap::AttitudePositionMocap& attitude_position_mocap);
-    Mocap::Result send_odometry(const Mocap::Odometry& odometry);
+    prepare_odometry(const Mocap::Odometry& odometry, PreparedOdometry& prepared) const;
+
+    Mocap::Result send_vision_position_estimate(const PreparedVisionPositionEstimate& prepared);
+    Mocap::Result send_attitude_position_mocap(const PreparedAttitudePositionMocap& prepared);
+    Mocap::Result send_odometry(const PreparedOdometry& prepared);
+
+    // Streaming mode: the user's thread only prepares the values, and the
+    // streaming thread sends the latest of each. Values coming faster than
+    // they can be sent are overwritten rather than queued.
+    enum Pending : unsigned {
+        PendingVisionPositionEstimate = 1 << 0,
+        PendingAttitudePositionMocap = 1 << 1,
+        PendingOdometry = 1 << 2,
+    };
+
+    void notify_streaming_thread(Pending pending);
+    void run_streaming_thread();
+    // Needs _streaming_thread_mutex
+    void stop_streaming_thread();
+
+    std::atomic<bool> _streaming_enabled{false};
+    Seqlock<PreparedVisionPositionEstimate> _streamed_vision_position_estimate{};
+    Seqlock<PreparedAttitudePositionMocap> _streamed_attitude_position_mocap{};
+    Seqlock<PreparedOdometry> _streamed_odometry{};
+    std::atomic<unsigned> _streaming_pending{0};
+
+    std::mutex _streaming_mutex{};
+    std::condition_variable _streaming_cv{};
+    // Needs _streaming_mutex
+    bool _streaming_should_exit{false};
+
+    // Starting and stopping the thread is serialized separately, as the
+    // thread itself needs _streaming_mutex.
+    std::mutex _streaming_thread_mutex{};
+    std::unique_ptr<std::thread> _streaming_thread{};
 };
 } // namespace mavsdk
@@ -15,6 +15,7 @@
 
 #include "plugin_base.h"
 
+#include "awaitable.h"
 #include "handle.h"
 
 namespace mavsdk {
@@ -363,7 +364,24 @@ public:
      *
      * This function is non-blocking. See 'start' for the blocking counterpart.
      */
-    void start_async(const ResultCallback callback);
+    void start_async(const ResultCallback& callback);
+
+#ifdef MAVSDK_HAS_COROUTINES
+    /**
+     * @brief Awaitable version of 'start_async' for C++20 coroutines.
+     *
+     * The coroutine is resumed using the executor if one is given, otherwise on the callback
+     * thread.
+     */
+    Awaitable<ResultCallback> start_awaitable(Executor executor = {})
+    {
+        return Awaitable<ResultCallback>(
+            [=, this](const ResultCallback& callback) {
+                start_async(callback);
+            },
+            std::move(executor));
+    }
+#endif
 
     /**
      * @brief Start offboard control.
@@ -381,7 +399,24 @@ public:
      *
      * This function is non-blocking. See 'stop' for the blocking counterpart.
      */
-    void stop_async(const ResultCallback callback);
+    void stop_async(const ResultCallback& callback);
+
+#ifdef MAVSDK_HAS_COROUTINES
+    /**
+     * @brief Awaitable version of 'stop_async' for C++20 coroutines.
+     *
+     * The coroutine is resumed using the executor if one is given, otherwise on the callback
+     * thread.
+     */
+    Awaitable<ResultCallback> stop_awaitable(Executor executor = {})
+    {
+        return Awaitable<ResultCallback>(
+            [=, this](const ResultCallback& callback) {
+                stop_async(callback);
+            },
+            std::move(executor));
+    }
+#endif
 
     /**
      * @brief Stop offboard control.
@@ -413,7 +448,7 @@ public:
      *
      * @return Result of request.
      */
-    Result set_attitude(Attitude attitude) const;
+    Result set_attitude(const Attitude& attitude) const;
 
     /**
      * @brief Set direct actuator control values to groups #0 and #1.
@@ -425,7 +460,7 @@ public:
      *
      * @return Result of request.
      */
-    Result set_actuator_control(ActuatorControl actuator_control) const;
+    Result set_actuator_control(const ActuatorControl& actuator_control) const;
 
     /**
      * @brief Set the attitude rate in terms of pitch, roll and yaw angular rate along with thrust.
@@ -434,7 +469,7 @@ public:
      *
      * @return Result of request.
      */
-    Result set_attitude_rate(AttitudeRate attitude_rate) const;
+    Result set_attitude_rate(const AttitudeRate& attitude_rate) const;
 
     /**
      * @brief Set the position in NED coordinates and yaw.
@@ -443,7 +478,7 @@ public:
      *
      * @return Result of request.
      */
-    Result set_position_ned(PositionNedYaw position_ned_yaw) const;
+    Result set_position_ned(const PositionNedYaw& position_ned_yaw) const;
 
     /**
      * @brief Set the position in Global coordinates (latitude, longitude, altitude) and yaw
@@ -452,7 +487,7 @@ public:
      *
      * @return Result of request.
      */
-    Result set_position_global(PositionGlobalYaw position_global_yaw) const;
+    Result set_position_global(const PositionGlobalYaw& position_global_yaw) const;
 
     /**
      * @brief Set the velocity in body coordinates and yaw angular rate. Not available for
@@ -462,7 +497,7 @@ public:
      *
      * @return Result of request.
      */
-    Result set_velocity_body(VelocityBodyYawspeed velocity_body_yawspeed) const;
+    Result set_velocity_body(const VelocityBodyYawspeed& velocity_body_yawspeed) const;
 
     /**
      * @brief Set the velocity in NED coordinates and yaw. Not available for fixed-wing aircraft.
@@ -471,7 +506,7 @@ public:
      *
      * @return Result of request.
      */
-    Result set_velocity_ned(VelocityNedYaw velocity_ned_yaw) const;
+    Result set_velocity_ned(const VelocityNedYaw& velocity_ned_yaw) const;
 
     /**
      * @brief Set the position in NED coordinates, with the velocity to be used as feed-forward.
@@ -481,7 +516,7 @@ public:
      * @return Result of request.
      */
     Result set_position_velocity_ned(
-        PositionNedYaw position_ned_yaw, VelocityNedYaw velocity_ned_yaw) const;
+        const PositionNedYaw& position_ned_yaw, const VelocityNedYaw& velocity_ned_yaw) const;
 
     /**
      * @brief Set the acceleration in NED coordinates.
@@ -490,7 +525,7 @@ public:
      *
      * @return Result of request.
      */
-    Result set_acceleration_ned(AccelerationNed acceleration_ned) const;
+    Result set_acceleration_ned(const AccelerationNed& acceleration_ned) const;
 
     /**
      * @brief Copy constructor.
@@ -505,6 +540,9 @@ public:
 private:
     /** @private Underlying implementation, set at instantiation */
     std::unique_ptr<OffboardImpl> _impl;
+
+    /** @private Hand-written additions in offboard_ext.h, if any */
+    friend class OffboardExt;
 };
 
 } // namespace mavsdk
\ No newline at end of file
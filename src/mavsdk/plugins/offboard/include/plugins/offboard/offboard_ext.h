@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+
+#include "plugins/offboard/offboard.h"
+
+namespace mavsdk {
+
+class OffboardImpl;
+
+/**
+ * @brief Additions to Offboard that are only available in C++.
+ *
+ * Unlike offboard.h, this header is not generated from the proto files,
+ * so the calls here are not available through mavsdk_server.
+ *
+ * It works on the Offboard plugin it is created with, which has to outlive it:
+ *
+ *     ```cpp
+ *     auto offboard = Offboard(system);
+ *     auto offboard_ext = OffboardExt(offboard);
+ *     ```
+ */
+class OffboardExt {
+public:
+    /**
+     * @brief Constructor. Uses the given Offboard plugin.
+     *
+     * @param offboard The plugin, which has to outlive this object.
+     */
+    explicit OffboardExt(Offboard& offboard);
+
+    /**
+     * @brief Timing of the setpoints sent periodically while offboard is used.
+     */
+    struct SetpointTiming {
+        double rate_hz{}; /**< @brief Rate the setpoints are sent at (in Hz) */
+        uint64_t num_sent{}; /**< @brief Number of setpoints sent at this rate */
+        double mean_jitter_us{}; /**< @brief Mean delay of a setpoint after its scheduled time (in
+                                    microseconds) */
+        double max_jitter_us{}; /**< @brief Maximum delay of a setpoint after its scheduled time (in
+                                   microseconds) */
+    };
+
+    /**
+     * @brief Equal operator to compare two `OffboardExt::SetpointTiming` objects.
+     *
+     * @return `true` if items are equal.
+     */
+    friend bool
+    operator==(const OffboardExt::SetpointTiming& lhs, const OffboardExt::SetpointTiming& rhs);
+
+    /**
+     * @brief Stream operator to print information about a `OffboardExt::SetpointTiming`.
+     *
+     * @return A reference to the stream.
+     */
+    friend std::ostream&
+    operator<<(std::ostream& str, OffboardExt::SetpointTiming const& setpoint_timing);
+
+    /**
+     * @brief Set the rate at which the latest setpoint is sent (20 Hz by default).
+     *
+     * The setpoints are sent from a dedicated thread at exact times, for rates up to 1000 Hz.
+     *
+     * This function is blocking.
+     *
+     * @return Result of request.
+     */
+    Offboard::Result set_setpoint_rate(double rate_hz) const;
+
+    /**
+     * @brief Send the setpoints from a thread with real-time priority, or back to normal priority.
+     *
+     * This usually needs extra privileges, e.g. CAP_SYS_NICE on Linux, and fails without them.
+     *
+     * This function is blocking.
+     *
+     * @return Result of request.
+     */
+    Offboard::Result set_setpoint_realtime_priority(bool enabled) const;
+
+    /**
+     * @brief Poll for the timing of the setpoints sent since the rate was last set.
+     *
+     * @return The setpoint timing.
+     */
+    SetpointTiming setpoint_timing() const;
+
+private:
+    OffboardImpl& _impl;
+};
+
+} // namespace mavsdk
@@ -28,7 +28,7 @@ Offboard::Offboard(std::shared_ptr<System> system) :
 
 Offboard::~Offboard() {}
 
-void Offboard::start_async(const ResultCallback callback)
+void Offboard::start_async(const ResultCallback& callback)
 {
     _impl->start_async(callback);
 }
@@ -38,7 +38,7 @@ Offboard::Result Offboard::start() const
     return _impl->start();
 }
 
-void Offboard::stop_async(const ResultCallback callback)
+void Offboard::stop_async(const ResultCallback& callback)
 {
     _impl->stop_async(callback);
 }
@@ -53,48 +53,49 @@ bool Offboard::is_active() const
     return _impl->is_active();
 }
 
-Offboard::Result Offboard::set_attitude(Attitude attitude) const
+Offboard::Result Offboard::set_attitude(const Attitude& attitude) const
 {
     return _impl->set_attitude(attitude);
 }
 
-Offboard::Result Offboard::set_actuator_control(ActuatorControl actuator_control) const
+Offboard::Result Offboard::set_actuator_control(const ActuatorControl& actuator_control) const
 {
     return _impl->set_actuator_control(actuator_control);
 }
 
-Offboard::Result Offboard::set_attitude_rate(AttitudeRate attitude_rate) const
+Offboard::Result Offboard::set_attitude_rate(const AttitudeRate& attitude_rate) const
 {
     return _impl->set_attitude_rate(attitude_rate);
 }
 
-Offboard::Result Offboard::set_position_ned(PositionNedYaw position_ned_yaw) const
+Offboard::Result Offboard::set_position_ned(const PositionNedYaw& position_ned_yaw) const
 {
     return _impl->set_position_ned(position_ned_yaw);
 }
 
-Offboard::Result Offboard::set_position_global(PositionGlobalYaw position_global_yaw) const
+Offboard::Result Offboard::set_position_global(const PositionGlobalYaw& position_global_yaw) const
 {
     return _impl->set_position_global(position_global_yaw);
 }
 
-Offboard::Result Offboard::set_velocity_body(VelocityBodyYawspeed velocity_body_yawspeed) const
+Offboard::Result Offboard::set_velocity_body(
+    const VelocityBodyYawspeed& velocity_body_yawspeed) const
 {
     return _impl->set_velocity_body(velocity_body_yawspeed);
 }
 
-Offboard::Result Offboard::set_velocity_ned(VelocityNedYaw velocity_ned_yaw) const
+Offboard::Result Offboard::set_velocity_ned(const VelocityNedYaw& velocity_ned_yaw) const
 {
     return _impl->set_velocity_ned(velocity_ned_yaw);
 }
 
 Offboard::Result Offboard::set_position_velocity_ned(
-    PositionNedYaw position_ned_yaw, VelocityNedYaw velocity_ned_yaw) const
+    const PositionNedYaw& position_ned_yaw, const VelocityNedYaw& velocity_ned_yaw) const
 {
     return _impl->set_position_velocity_ned(position_ned_yaw, velocity_ned_yaw);
 }
 
-Offboard::Result Offboard::set_acceleration_ned(AccelerationNed acceleration_ned) const
+Offboard::Result Offboard::set_acceleration_ned(const AccelerationNed& acceleration_ned) const
 {
     return _impl->set_acceleration_ned(acceleration_ned);
 }
@@ -0,0 +1,48 @@
+#include <cmath>
+#include <iomanip>
+
+#include "offboard_impl.h"
+#include "plugins/offboard/offboard_ext.h"
+
+namespace mavsdk {
+
+OffboardExt::OffboardExt(Offboard& offboard) : _impl(*offboard._impl) {}
+
+Offboard::Result OffboardExt::set_setpoint_rate(double rate_hz) const
+{
+    return _impl.set_setpoint_rate(rate_hz);
+}
+
+Offboard::Result OffboardExt::set_setpoint_realtime_priority(bool enabled) const
+{
+    return _impl.set_setpoint_realtime_priority(enabled);
+}
+
+OffboardExt::SetpointTiming OffboardExt::setpoint_timing() const
+{
+    return _impl.setpoint_timing();
+}
+
+bool operator==(const OffboardExt::SetpointTiming& lhs, const OffboardExt::SetpointTiming& rhs)
+{
+    return ((std::isnan(rhs.rate_hz) && std::isnan(lhs.rate_hz)) || rhs.rate_hz == lhs.rate_hz) &&
+           (rhs.num_sent == lhs.num_sent) &&
+           ((std::isnan(rhs.mean_jitter_us) && std::isnan(lhs.mean_jitter_us)) ||
+            rhs.mean_jitter_us == lhs.mean_jitter_us) &&
+           ((std::isnan(rhs.max_jitter_us) && std::isnan(lhs.max_jitter_us)) ||
+            rhs.max_jitter_us == lhs.max_jitter_us);
+}
+
+std::ostream& operator<<(std::ostream& str, OffboardExt::SetpointTiming const& setpoint_timing)
+{
+    str << std::setprecision(15);
+    str << "setpoint_timing:" << '\n' << "{\n";
+    str << "    rate_hz: " << setpoint_timing.rate_hz << '\n';
+    str << "    num_sent: " << setpoint_timing.num_sent << '\n';
+    str << "    mean_jitter_us: " << setpoint_timing.mean_jitter_us << '\n';
+    str << "    max_jitter_us: " << setpoint_timing.max_jitter_us << '\n';
+    str << '}';
+    return str;
+}
+
+} // namespace mavsdk
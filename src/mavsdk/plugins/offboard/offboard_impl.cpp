@@ -3,6 +3,7 @@
 #include "mavsdk_math.h"
 #include "offboard_impl.h"
 #include "mavsdk_impl.h"
+#include "decoded_message.h"
 #include "px4_custom_mode.h"
 
 namespace mavsdk {
@@ -124,23 +125,18 @@ Offboard::Result OffboardImpl::set_position_ned(Offboard::PositionNedYaw positio
 {
     {
         std::lock_guard<std::mutex> lock(_mutex);
-        _position_ned_yaw = position_ned_yaw;
+        _position_velocity_ned_yaw.update(
+            [&](auto& setpoint) { setpoint.position_ned_yaw = position_ned_yaw; });
 
         if (_mode != Mode::PositionNed) {
-            if (_call_every_cookie) {
-                // If we're already sending other setpoints, stop that now.
-                _system_impl->remove_call_every(_call_every_cookie);
-                _call_every_cookie = nullptr;
-            }
             // We automatically send Ned setpoints from now on.
-            _system_impl->add_call_every(
-                [this]() { send_position_ned(); }, SEND_INTERVAL_S, &_call_every_cookie);
+            _setpoint_streamer.start([this]() { send_position_ned(); });
 
             _mode = Mode::PositionNed;
         } else {
             // We're already sending these kind of setpoints. Since the setpoint change, let's
             // reschedule the next call, so we don't send setpoints too often.
-            _system_impl->reset_call_every(_call_every_cookie);
+            _setpoint_streamer.restart_period();
         }
     }
 
@@ -152,23 +148,17 @@ Offboard::Result OffboardImpl::set_position_global(Offboard::PositionGlobalYaw p
 {
     {
         std::lock_guard<std::mutex> lock(_mutex);
-        _position_global_yaw = position_global_yaw;
+        _position_global_yaw.store(position_global_yaw);
 
         if (_mode != Mode::PositionGlobalAltRel) {
-            if (_call_every_cookie) {
-                // If we're already sending other setpoints, stop that now.
-                _system_impl->remove_call_every(_call_every_cookie);
-                _call_every_cookie = nullptr;
-            }
             // We automatically send Global setpoints from now on.
-            _system_impl->add_call_every(
-                [this]() { send_position_global(); }, SEND_INTERVAL_S, &_call_every_cookie);
+            _setpoint_streamer.start([this]() { send_position_global(); });
 
             _mode = Mode::PositionGlobalAltRel;
         } else {
             // We're already sending these kind of setpoints. Since the setpoint change, let's
             // reschedule the next call, so we don't send setpoints too often.
-            _system_impl->reset_call_every(_call_every_cookie);
+            _setpoint_streamer.restart_period();
         }
     }
 
@@ -180,23 +170,18 @@ Offboard::Result OffboardImpl::set_velocity_ned(Offboard::VelocityNedYaw velocit
 {
     {
         std::lock_guard<std::mutex> lock(_mutex);
-        _velocity_ned_yaw = velocity_ned_yaw;
+        _position_velocity_ned_yaw.update(
+            [&](auto& setpoint) { setpoint.velocity_ned_yaw = velocity_ned_yaw; });
 
         if (_mode != Mode::VelocityNed) {
-            if (_call_every_cookie) {
-                // If we're already sending other setpoints, stop that now.
-                _system_impl->remove_call_every(_call_every_cookie);
-                _call_every_cookie = nullptr;
-            }
             // We automatically send Ned setpoints from now on.
-            _system_impl->add_call_every(
-                [this]() { send_velocity_ned(); }, SEND_INTERVAL_S, &_call_every_cookie);
+            _setpoint_streamer.start([this]() { send_velocity_ned(); });
 
             _mode = Mode::VelocityNed;
         } else {
             // We're already sending these kind of setpoints. Since the setpoint change, let's
             // reschedule the next call, so we don't send setpoints too often.
-            _system_impl->reset_call_every(_call_every_cookie);
+            _setpoint_streamer.restart_period();
         }
     }
     // also send it right now to reduce latency
@@ -208,24 +193,17 @@ Offboard::Result OffboardImpl::set_position_velocity_ned(
 {
     {
         std::lock_guard<std::mutex> lock(_mutex);
-        _position_ned_yaw = position_ned_yaw;
-        _velocity_ned_yaw = velocity_ned_yaw;
+        _position_velocity_ned_yaw.store({position_ned_yaw, velocity_ned_yaw});
 
         if (_mode != Mode::PositionVelocityNed) {
-            if (_call_every_cookie) {
-                // If we're already sending other setpoints, stop that now.
-                _system_impl->remove_call_every(_call_every_cookie);
-                _call_every_cookie = nullptr;
-            }
             // We automatically send Ned setpoints from now on.
-            _system_impl->add_call_every(
-                [this]() { send_position_velocity_ned(); }, SEND_INTERVAL_S, &_call_every_cookie);
+            _setpoint_streamer.start([this]() { send_position_velocity_ned(); });
 
             _mode = Mode::PositionVelocityNed;
         } else {
             // We're already sending these kind of setpoints. Since the setpoint change, let's
             // reschedule the next call, so we don't send setpoints too often.
-            _system_impl->reset_call_every(_call_every_cookie);
+            _setpoint_streamer.restart_period();
         }
     }
 
@@ -237,23 +215,17 @@ Offboard::Result OffboardImpl::set_acceleration_ned(Offboard::AccelerationNed ac
 {
     {
         std::lock_guard<std::mutex> lock(_mutex);
-        _acceleration_ned = acceleration_ned;
+        _acceleration_ned.store(acceleration_ned);
 
         if (_mode != Mode::AccelerationNed) {
-            if (_call_every_cookie) {
-                // If we're already sending other setpoints, stop that now.
-                _system_impl->remove_call_every(_call_every_cookie);
-                _call_every_cookie = nullptr;
-            }
             // We automatically send Ned setpoints from now on.
-            _system_impl->add_call_every(
-                [this]() { send_acceleration_ned(); }, SEND_INTERVAL_S, &_call_every_cookie);
+            _setpoint_streamer.start([this]() { send_acceleration_ned(); });
 
             _mode = Mode::AccelerationNed;
         } else {
             // We're already sending these kind of setpoints. Since the setpoint change, let's
             // reschedule the next call, so we don't send setpoints too often.
-            _system_impl->reset_call_every(_call_every_cookie);
+            _setpoint_streamer.restart_period();
         }
     }
 
@@ -266,23 +238,17 @@ OffboardImpl::set_velocity_body(Offboard::VelocityBodyYawspeed velocity_body_yaw
 {
     {
         std::lock_guard<std::mutex> lock(_mutex);
-        _velocity_body_yawspeed = velocity_body_yawspeed;
+        _velocity_body_yawspeed.store(velocity_body_yawspeed);
 
         if (_mode != Mode::VelocityBody) {
-            if (_call_every_cookie) {
-                // If we're already sending other setpoints, stop that now.
-                _system_impl->remove_call_every(_call_every_cookie);
-                _call_every_cookie = nullptr;
-            }
             // We automatically send body setpoints from now on.
-            _system_impl->add_call_every(
-                [this]() { send_velocity_body(); }, SEND_INTERVAL_S, &_call_every_cookie);
+            _setpoint_streamer.start([this]() { send_velocity_body(); });
 
             _mode = Mode::VelocityBody;
         } else {
             // We're already sending these kind of setpoints. Since the setpoint change, let's
             // reschedule the next call, so we don't send setpoints too often.
-            _system_impl->reset_call_every(_call_every_cookie);
+            _setpoint_streamer.restart_period();
         }
     }
 
@@ -294,23 +260,17 @@ Offboard::Result OffboardImpl::set_attitude(Offboard::Attitude attitude)
 {
     {
         std::lock_guard<std::mutex> lock(_mutex);
-        _attitude = attitude;
+        _attitude.store(attitude);
 
         if (_mode != Mode::Attitude) {
-            if (_call_every_cookie) {
-                // If we're already sending other setpoints, stop that now.
-                _system_impl->remove_call_every(_call_every_cookie);
-                _call_every_cookie = nullptr;
-            }
             // We automatically send body setpoints from now on.
-            _system_impl->add_call_every(
-                [this]() { send_attitude(); }, SEND_INTERVAL_S, &_call_every_cookie);
+            _setpoint_streamer.start([this]() { send_attitude(); });
 
             _mode = Mode::Attitude;
         } else {
             // We're already sending these kind of setpoints. Since the setpoint change, let's
             // reschedule the next call, so we don't send setpoints too often.
-            _system_impl->reset_call_every(_call_every_cookie);
+            _setpoint_streamer.restart_period();
         }
     }
 
@@ -322,23 +282,17 @@ Offboard::Result OffboardImpl::set_attitude_rate(Offboard::AttitudeRate attitude
 {
     {
         std::lock_guard<std::mutex> lock(_mutex);
-        _attitude_rate = attitude_rate;
+        _attitude_rate.store(attitude_rate);
 
         if (_mode != Mode::AttitudeRate) {
-            if (_call_every_cookie) {
-                // If we're already sending other setpoints, stop that now.
-                _system_impl->remove_call_every(_call_every_cookie);
-                _call_every_cookie = nullptr;
-            }
             // We automatically send body setpoints from now on.
-            _system_impl->add_call_every(
-                [this]() { send_attitude_rate(); }, SEND_INTERVAL_S, &_call_every_cookie);
+            _setpoint_streamer.start([this]() { send_attitude_rate(); });
 
             _mode = Mode::AttitudeRate;
         } else {
             // We're already sending these kind of setpoints. Since the setpoint change, let's
             // reschedule the next call, so we don't send setpoints too often.
-            _system_impl->reset_call_every(_call_every_cookie);
+            _setpoint_streamer.restart_period();
         }
     }
 
@@ -353,25 +307,19 @@ Offboard::Result OffboardImpl::set_actuator_control(Offboard::ActuatorControl ac
         _actuator_control = actuator_control;
 
         if (_mode != Mode::ActuatorControl) {
-            if (_call_every_cookie) {
-                // If we're already sending other setpoints, stop that now.
-                _system_impl->remove_call_every(_call_every_cookie);
-                _call_every_cookie = nullptr;
-            }
             // We automatically send motor rate values from now on.
-            _system_impl->add_call_every(
-                [this]() { send_actuator_control(); }, SEND_INTERVAL_S, &_call_every_cookie);
+            _setpoint_streamer.start([this]() { send_actuator_control(); });
 
             _mode = Mode::ActuatorControl;
         } else {
             // We're already sending these kind of values. Since the value changes, let's
             // reschedule the next call, so we don't send values too often.
-            _system_impl->reset_call_every(_call_every_cookie);
+            _setpoint_streamer.restart_period();
         }
     }
 
-    // It gets sent immediately as part of add_call_every.
-    return Offboard::Result::Success;
+    // also send it right now to reduce latency
+    return send_actuator_control();
 }
 
 Offboard::Result OffboardImpl::send_position_ned()
@@ -384,10 +332,7 @@ Offboard::Result OffboardImpl::send_position_ned()
     const static uint16_t IGNORE_AZ = (1 << 8);
     const static uint16_t IGNORE_YAW_RATE = (1 << 11);
 
-    const auto position_ned_yaw = [this]() {
-        std::lock_guard<std::mutex> lock(_mutex);
-        return _position_ned_yaw;
-    }();
+    const auto position_ned_yaw = _position_velocity_ned_yaw.load().position_ned_yaw;
 
     mavlink_message_t message;
     mavlink_msg_set_position_target_local_ned_pack(
@@ -424,10 +369,7 @@ Offboard::Result OffboardImpl::send_position_global()
     const static uint16_t IGNORE_AZ = (1 << 8);
     const static uint16_t IGNORE_YAW_RATE = (1 << 11);
 
-    const auto position_global_yaw = [this]() {
-        std::lock_guard<std::mutex> lock(_mutex);
-        return _position_global_yaw;
-    }();
+    const auto position_global_yaw = _position_global_yaw.load();
 
     MAV_FRAME frame;
     switch (position_global_yaw.altitude_type) {
@@ -480,10 +422,7 @@ Offboard::Result OffboardImpl::send_velocity_ned()
     const static uint16_t IGNORE_AZ = (1 << 8);
     const static uint16_t IGNORE_YAW_RATE = (1 << 11);
 
-    const auto velocity_ned_yaw = [this]() {
-        std::lock_guard<std::mutex> lock(_mutex);
-        return _velocity_ned_yaw;
-    }();
+    const auto velocity_ned_yaw = _position_velocity_ned_yaw.load().velocity_ned_yaw;
 
     mavlink_message_t message;
     mavlink_msg_set_position_target_local_ned_pack(
@@ -517,10 +456,7 @@ Offboard::Result OffboardImpl::send_position_velocity_ned()
     const static uint16_t IGNORE_AZ = (1 << 8);
     const static uint16_t IGNORE_YAW_RATE = (1 << 11);
 
-    const auto position_and_velocity = [this]() {
-        std::lock_guard<std::mutex> lock(_mutex);
-        return std::make_pair<>(_position_ned_yaw, _velocity_ned_yaw);
-    }();
+    const auto position_velocity_ned_yaw = _position_velocity_ned_yaw.load();
 
     mavlink_message_t message;
     mavlink_msg_set_position_target_local_ned_pack(
@@ -532,16 +468,16 @@ Offboard::Result OffboardImpl::send_position_velocity_ned()
         _system_impl->get_autopilot_id(),
         MAV_FRAME_LOCAL_NED,
         IGNORE_AX | IGNORE_AY | IGNORE_AZ | IGNORE_YAW_RATE,
-        position_and_velocity.first.north_m,
-        position_and_velocity.first.east_m,
-        position_and_velocity.first.down_m,
-        position_and_velocity.second.north_m_s,
-        position_and_velocity.second.east_m_s,
-        position_and_velocity.second.down_m_s,
+        position_velocity_ned_yaw.position_ned_yaw.north_m,
+        position_velocity_ned_yaw.position_ned_yaw.east_m,
+        position_velocity_ned_yaw.position_ned_yaw.down_m,
+        position_velocity_ned_yaw.velocity_ned_yaw.north_m_s,
+        position_velocity_ned_yaw.velocity_ned_yaw.east_m_s,
+        position_velocity_ned_yaw.velocity_ned_yaw.down_m_s,
         0.0f, // afx
         0.0f, // afy
         0.0f, // afz
-        to_rad_from_deg(position_and_velocity.first.yaw_deg), // yaw
+        to_rad_from_deg(position_velocity_ned_yaw.position_ned_yaw.yaw_deg), // yaw
         0.0f); // yaw_rate
     return _system_impl->send_message(message) ? Offboard::Result::Success :
                                                  Offboard::Result::ConnectionError;
@@ -558,10 +494,7 @@ Offboard::Result OffboardImpl::send_acceleration_ned()
     const static uint16_t IGNORE_YAW = (1 << 10);
     const static uint16_t IGNORE_YAW_RATE = (1 << 11);
 
-    const auto acceleration_ned = [this]() {
-        std::lock_guard<std::mutex> lock(_mutex);
-        return _acceleration_ned;
-    }();
+    const auto acceleration_ned = _acceleration_ned.load();
 
     mavlink_message_t message;
     mavlink_msg_set_position_target_local_ned_pack(
@@ -599,10 +532,7 @@ Offboard::Result OffboardImpl::send_velocity_body()
     const static uint16_t IGNORE_AZ = (1 << 8);
     const static uint16_t IGNORE_YAW = (1 << 10);
 
-    const auto velocity_body_yawspeed = [this]() {
-        std::lock_guard<std::mutex> lock(_mutex);
-        return _velocity_body_yawspeed;
-    }();
+    const auto velocity_body_yawspeed = _velocity_body_yawspeed.load();
 
     mavlink_message_t message;
     mavlink_msg_set_position_target_local_ned_pack(
@@ -635,12 +565,9 @@ Offboard::Result OffboardImpl::send_attitude()
     const static uint8_t IGNORE_BODY_PITCH_RATE = (1 << 1);
     const static uint8_t IGNORE_BODY_YAW_RATE = (1 << 2);
 
-    const auto attitude = [this]() {
-        std::lock_guard<std::mutex> lock(_mutex);
-        return _attitude;
-    }();
+    const auto attitude = _attitude.load();
 
-    const float thrust = _attitude.thrust_value;
+    const float thrust = attitude.thrust_value;
     const float roll = to_rad_from_deg(attitude.roll_deg);
     const float pitch = to_rad_from_deg(attitude.pitch_deg);
     const float yaw = to_rad_from_deg(attitude.yaw_deg);
@@ -684,10 +611,7 @@ Offboard::Result OffboardImpl::send_attitude_rate()
 {
     const static uint8_t IGNORE_ATTITUDE = (1 << 7);
 
-    const auto attitude_rate = [this]() {
-        std::lock_guard<std::mutex> lock(_mutex);
-        return _attitude_rate;
-    }();
+    const auto attitude_rate = _attitude_rate.load();
 
     const float thrust_body[3] = {0.0f, 0.0f, 0.0f};
 
@@ -704,12 +628,36 @@ Offboard::Result OffboardImpl::send_attitude_rate()
         to_rad_from_deg(attitude_rate.roll_deg_s),
         to_rad_from_deg(attitude_rate.pitch_deg_s),
         to_rad_from_deg(attitude_rate.yaw_deg_s),
-        _attitude_rate.thrust_value,
+        attitude_rate.thrust_value,
         thrust_body);
     return _system_impl->send_message(message) ? Offboard::Result::Success :
                                                  Offboard::Result::ConnectionError;
 }
 
+Offboard::Result OffboardImpl::set_setpoint_rate(double rate_hz)
+{
+    return _setpoint_streamer.set_rate_hz(rate_hz) ? Offboard::Result::Success :
+                                                     Offboard::Result::Failed;
+}
+
+Offboard::Result OffboardImpl::set_setpoint_realtime_priority(bool enabled)
+{
+    return _setpoint_streamer.set_realtime_priority(enabled) ? Offboard::Result::Success :
+                                                               Offboard::Result::Failed;
+}
+
+OffboardExt::SetpointTiming OffboardImpl::setpoint_timing() const
+{
+    const auto statistics = _setpoint_streamer.statistics();
+
+    OffboardExt::SetpointTiming setpoint_timing;
+    setpoint_timing.rate_hz = _setpoint_streamer.rate_hz();
+    setpoint_timing.num_sent = statistics.num_calls;
+    setpoint_timing.mean_jitter_us = statistics.mean_jitter_us;
+    setpoint_timing.max_jitter_us = statistics.max_jitter_us;
+    return setpoint_timing;
+}
+
 Offboard::Result
 OffboardImpl::send_actuator_control_message(const float* controls, uint8_t group_number)
 {
@@ -756,8 +704,7 @@ void OffboardImpl::process_heartbeat(const mavlink_message_t& message)
         return;
     }
 
-    mavlink_heartbeat_t heartbeat;
-    mavlink_msg_heartbeat_decode(&message, &heartbeat);
+    const auto& heartbeat = DecodedMessage::get(message, mavlink_msg_heartbeat_decode);
 
     bool offboard_mode_active = false;
     if (heartbeat.base_mode & MAV_MODE_FLAG_CUSTOM_MODE_ENABLED) {
@@ -788,10 +735,7 @@ void OffboardImpl::stop_sending_setpoints()
 {
     // We assume that we already acquired the mutex in this function.
 
-    if (_call_every_cookie != nullptr) {
-        _system_impl->remove_call_every(_call_every_cookie);
-        _call_every_cookie = nullptr;
-    }
+    _setpoint_streamer.stop();
     _mode = Mode::NotActive;
 }
 
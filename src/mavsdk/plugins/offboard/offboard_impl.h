@@ -4,7 +4,10 @@
 
 #include "mavlink_include.h"
 #include "plugins/offboard/offboard.h"
+#include "plugins/offboard/offboard_ext.h"
 #include "plugin_impl_base.h"
+#include "seqlock.h"
+#include "setpoint_streamer.h"
 #include "system.h"
 
 namespace mavsdk {
@@ -40,6 +43,10 @@ public:
     Offboard::Result set_attitude_rate(Offboard::AttitudeRate attitude_rate);
     Offboard::Result set_actuator_control(Offboard::ActuatorControl actuator_control);
 
+    Offboard::Result set_setpoint_rate(double rate_hz);
+    Offboard::Result set_setpoint_realtime_priority(bool enabled);
+    OffboardExt::SetpointTiming setpoint_timing() const;
+
     OffboardImpl(const OffboardImpl&);
     OffboardImpl& operator=(const OffboardImpl&) = delete;
 
@@ -80,19 +87,28 @@ private:
         AttitudeRate,
         ActuatorControl
     } _mode = Mode::NotActive;
-    Offboard::PositionNedYaw _position_ned_yaw{};
-    Offboard::PositionGlobalYaw _position_global_yaw{};
-    Offboard::VelocityNedYaw _velocity_ned_yaw{};
-    Offboard::AccelerationNed _acceleration_ned{};
-    Offboard::VelocityBodyYawspeed _velocity_body_yawspeed{};
-    Offboard::Attitude _attitude{};
-    Offboard::AttitudeRate _attitude_rate{};
+
+    // Set under _mutex, but read without it, so that the setpoint thread
+    // never has to wait for the user.
+    // Position and velocity are kept together, to send them consistently.
+    struct PositionVelocityNedYaw {
+        Offboard::PositionNedYaw position_ned_yaw{};
+        Offboard::VelocityNedYaw velocity_ned_yaw{};
+    };
+    Seqlock<PositionVelocityNedYaw> _position_velocity_ned_yaw{};
+    Seqlock<Offboard::PositionGlobalYaw> _position_global_yaw{};
+    Seqlock<Offboard::AccelerationNed> _acceleration_ned{};
+    Seqlock<Offboard::VelocityBodyYawspeed> _velocity_body_yawspeed{};
+    Seqlock<Offboard::Attitude> _attitude{};
+    Seqlock<Offboard::AttitudeRate> _attitude_rate{};
+
+    // Needs _mutex
     Offboard::ActuatorControl _actuator_control{};
     SteadyTimePoint _last_started{};
 
-    void* _call_every_cookie = nullptr;
-
-    const float SEND_INTERVAL_S = 0.05f;
+    // Last, so that it is destroyed first and its thread doesn't call into
+    // anything destroyed already.
+    SetpointStreamer _setpoint_streamer{};
 };
 
 } // namespace mavsdk
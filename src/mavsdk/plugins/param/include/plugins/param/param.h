@@ -15,6 +15,7 @@
 
 #include "plugin_base.h"
 
+#include "awaitable.h"
 #include "handle.h"
 
 namespace mavsdk {
@@ -185,7 +186,7 @@ public:
      *
      * @return Result of request.
      */
-    std::pair<Result, int32_t> get_param_int(std::string name) const;
+    std::pair<Result, int32_t> get_param_int(const std::string& name) const;
 
     /**
      * @brief Set an int parameter.
@@ -196,7 +197,7 @@ public:
      *
      * @return Result of request.
      */
-    Result set_param_int(std::string name, int32_t value) const;
+    Result set_param_int(const std::string& name, int32_t value) const;
 
     /**
      * @brief Get a float parameter.
@@ -207,7 +208,7 @@ public:
      *
      * @return Result of request.
      */
-    std::pair<Result, float> get_param_float(std::string name) const;
+    std::pair<Result, float> get_param_float(const std::string& name) const;
 
     /**
      * @brief Set a float parameter.
@@ -218,7 +219,7 @@ public:
      *
      * @return Result of request.
      */
-    Result set_param_float(std::string name, float value) const;
+    Result set_param_float(const std::string& name, float value) const;
 
     /**
      * @brief Get a custom parameter.
@@ -229,7 +230,7 @@ public:
      *
      * @return Result of request.
      */
-    std::pair<Result, std::string> get_param_custom(std::string name) const;
+    std::pair<Result, std::string> get_param_custom(const std::string& name) const;
 
     /**
      * @brief Set a custom parameter.
@@ -240,7 +241,7 @@ public:
      *
      * @return Result of request.
      */
-    Result set_param_custom(std::string name, std::string value) const;
+    Result set_param_custom(const std::string& name, const std::string& value) const;
 
     /**
      * @brief Get all parameters.
@@ -264,6 +265,9 @@ public:
 private:
     /** @private Underlying implementation, set at instantiation */
     std::unique_ptr<ParamImpl> _impl;
+
+    /** @private Hand-written additions in param_ext.h, if any */
+    friend class ParamExt;
 };
 
 } // namespace mavsdk
\ No newline at end of file
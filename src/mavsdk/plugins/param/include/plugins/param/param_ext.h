@@ -0,0 +1,66 @@
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "plugins/param/param.h"
+
+namespace mavsdk {
+
+class ParamImpl;
+
+/**
+ * @brief Additions to Param that are only available in C++.
+ *
+ * Unlike param.h, this header is not generated from the proto files,
+ * so the calls here are not available through mavsdk_server.
+ *
+ * It works on the Param plugin it is created with, which has to outlive it:
+ *
+ *     ```cpp
+ *     auto param = Param(system);
+ *     auto param_ext = ParamExt(param);
+ *     ```
+ */
+class ParamExt {
+public:
+    /**
+     * @brief Constructor. Uses the given Param plugin.
+     *
+     * @param param The plugin, which has to outlive this object.
+     */
+    explicit ParamExt(Param& param);
+
+    /**
+     * @brief Set many parameters at once.
+     *
+     * The int and float parameters are sent without waiting for each one to
+     * be acknowledged, which is much faster than setting them one by one.
+     * Custom parameters are set one after the other.
+     *
+     * This function is blocking.
+     *
+     * @return Result per parameter: int params first, then float, then custom params.
+     */
+    std::vector<Param::Result> set_params(const Param::AllParams& params) const;
+
+    /**
+     * @brief Get many parameters at once.
+     *
+     * Only the names and types of the given parameters are used, the values
+     * are ignored. The int and float parameters are requested without waiting
+     * for each answer, custom parameters one after the other.
+     *
+     * This function is blocking.
+     *
+     * @return Result per parameter: int params first, then float, then custom
+     * params, and the parameters with the values received.
+     */
+    std::pair<std::vector<Param::Result>, Param::AllParams>
+    get_params(const Param::AllParams& params) const;
+
+private:
+    ParamImpl& _impl;
+};
+
+} // namespace mavsdk
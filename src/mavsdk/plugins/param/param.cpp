@@ -23,32 +23,32 @@ Param::Param(std::shared_ptr<System> system) :
 
 Param::~Param() {}
 
-std::pair<Param::Result, int32_t> Param::get_param_int(std::string name) const
+std::pair<Param::Result, int32_t> Param::get_param_int(const std::string& name) const
 {
     return _impl->get_param_int(name);
 }
 
-Param::Result Param::set_param_int(std::string name, int32_t value) const
+Param::Result Param::set_param_int(const std::string& name, int32_t value) const
 {
     return _impl->set_param_int(name, value);
 }
 
-std::pair<Param::Result, float> Param::get_param_float(std::string name) const
+std::pair<Param::Result, float> Param::get_param_float(const std::string& name) const
 {
     return _impl->get_param_float(name);
 }
 
-Param::Result Param::set_param_float(std::string name, float value) const
+Param::Result Param::set_param_float(const std::string& name, float value) const
 {
     return _impl->set_param_float(name, value);
 }
 
-std::pair<Param::Result, std::string> Param::get_param_custom(std::string name) const
+std::pair<Param::Result, std::string> Param::get_param_custom(const std::string& name) const
 {
     return _impl->get_param_custom(name);
 }
 
-Param::Result Param::set_param_custom(std::string name, std::string value) const
+Param::Result Param::set_param_custom(const std::string& name, const std::string& value) const
 {
     return _impl->set_param_custom(name, value);
 }
@@ -0,0 +1,19 @@
+#include "param_impl.h"
+#include "plugins/param/param_ext.h"
+
+namespace mavsdk {
+
+ParamExt::ParamExt(Param& param) : _impl(*param._impl) {}
+
+std::vector<Param::Result> ParamExt::set_params(const Param::AllParams& params) const
+{
+    return _impl.set_params(params);
+}
+
+std::pair<std::vector<Param::Result>, Param::AllParams>
+ParamExt::get_params(const Param::AllParams& params) const
+{
+    return _impl.get_params(params);
+}
+
+} // namespace mavsdk
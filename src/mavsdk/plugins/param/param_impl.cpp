@@ -1,4 +1,5 @@
 #include <functional>
+#include <future>
 #include "param_impl.h"
 #include "system.h"
 
@@ -95,6 +96,90 @@ Param::AllParams ParamImpl::get_all_params()
     return res;
 }
 
+std::vector<Param::Result> ParamImpl::set_params(const Param::AllParams& params)
+{
+    auto prom = std::promise<std::vector<MAVLinkParameters::Result>>();
+    auto fut = prom.get_future();
+    _system_impl->set_params_async(
+        to_param_values(params), [&prom](std::vector<MAVLinkParameters::Result> results) {
+            prom.set_value(std::move(results));
+        });
+
+    std::vector<Param::Result> results;
+    results.reserve(
+        params.int_params.size() + params.float_params.size() + params.custom_params.size());
+    for (const auto result : fut.get()) {
+        results.push_back(result_from_mavlink_parameters_result(result));
+    }
+
+    // Custom params use the extended protocol, which is not pipelined.
+    for (const auto& custom_param : params.custom_params) {
+        results.push_back(set_param_custom(custom_param.name, custom_param.value));
+    }
+
+    return results;
+}
+
+std::pair<std::vector<Param::Result>, Param::AllParams>
+ParamImpl::get_params(const Param::AllParams& params)
+{
+    using Results =
+        std::vector<std::pair<MAVLinkParameters::Result, MAVLinkParameters::ParamValue>>;
+    auto prom = std::promise<Results>();
+    auto fut = prom.get_future();
+    _system_impl->get_params_async(
+        to_param_values(params),
+        [&prom](Results results) { prom.set_value(std::move(results)); });
+    const auto received = fut.get();
+
+    std::vector<Param::Result> results;
+    results.reserve(received.size() + params.custom_params.size());
+    Param::AllParams values = params;
+
+    for (size_t i = 0; i < received.size(); ++i) {
+        const auto& [result, value] = received[i];
+        results.push_back(result_from_mavlink_parameters_result(result));
+        if (result != MAVLinkParameters::Result::Success) {
+            continue;
+        }
+        if (i < values.int_params.size()) {
+            if (const auto int_value = value.get_int()) {
+                values.int_params[i].value = static_cast<int32_t>(int_value.value());
+            }
+        } else if (value.is<float>()) {
+            values.float_params[i - values.int_params.size()].value = value.get<float>();
+        }
+    }
+
+    for (auto& custom_param : values.custom_params) {
+        const auto [result, value] = get_param_custom(custom_param.name);
+        results.push_back(result);
+        if (result == Param::Result::Success) {
+            custom_param.value = value;
+        }
+    }
+
+    return {results, values};
+}
+
+std::vector<std::pair<std::string, MAVLinkParameters::ParamValue>>
+ParamImpl::to_param_values(const Param::AllParams& params)
+{
+    std::vector<std::pair<std::string, MAVLinkParameters::ParamValue>> values;
+    values.reserve(params.int_params.size() + params.float_params.size());
+    for (const auto& int_param : params.int_params) {
+        MAVLinkParameters::ParamValue value;
+        value.set(int_param.value);
+        values.emplace_back(int_param.name, value);
+    }
+    for (const auto& float_param : params.float_params) {
+        MAVLinkParameters::ParamValue value;
+        value.set(float_param.value);
+        values.emplace_back(float_param.name, value);
+    }
+    return values;
+}
+
 Param::Result ParamImpl::result_from_mavlink_parameters_result(MAVLinkParameters::Result result)
 {
     switch (result) {
@@ -1,6 +1,9 @@
 #pragma once
 
 #include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include "mavlink_include.h"
 #include "plugins/param/param.h"
@@ -34,7 +37,15 @@ public:
 
     Param::AllParams get_all_params();
 
+    std::vector<Param::Result> set_params(const Param::AllParams& params);
+
+    std::pair<std::vector<Param::Result>, Param::AllParams>
+    get_params(const Param::AllParams& params);
+
 private:
+    static std::vector<std::pair<std::string, MAVLinkParameters::ParamValue>>
+    to_param_values(const Param::AllParams& params);
+
     static Param::Result result_from_mavlink_parameters_result(MAVLinkParameters::Result result);
 };
 
@@ -15,6 +15,7 @@
 
 #include "server_plugin_base.h"
 
+#include "awaitable.h"
 #include "handle.h"
 
 namespace mavsdk {
@@ -173,7 +174,7 @@ public:
      *
      * @return Result of request.
      */
-    std::pair<Result, int32_t> retrieve_param_int(std::string name) const;
+    std::pair<Result, int32_t> retrieve_param_int(const std::string& name) const;
 
     /**
      * @brief Provide an int parameter.
@@ -184,7 +185,7 @@ public:
      *
      * @return Result of request.
      */
-    Result provide_param_int(std::string name, int32_t value) const;
+    Result provide_param_int(const std::string& name, int32_t value) const;
 
     /**
      * @brief Retrieve a float parameter.
@@ -195,7 +196,7 @@ public:
      *
      * @return Result of request.
      */
-    std::pair<Result, float> retrieve_param_float(std::string name) const;
+    std::pair<Result, float> retrieve_param_float(const std::string& name) const;
 
     /**
      * @brief Provide a float parameter.
@@ -206,7 +207,7 @@ public:
      *
      * @return Result of request.
      */
-    Result provide_param_float(std::string name, float value) const;
+    Result provide_param_float(const std::string& name, float value) const;
 
     /**
      * @brief Retrieve a custom parameter.
@@ -217,7 +218,7 @@ public:
      *
      * @return Result of request.
      */
-    std::pair<Result, std::string> retrieve_param_custom(std::string name) const;
+    std::pair<Result, std::string> retrieve_param_custom(const std::string& name) const;
 
     /**
      * @brief Provide a custom parameter.
@@ -228,7 +229,7 @@ public:
      *
      * @return Result of request.
      */
-    Result provide_param_custom(std::string name, std::string value) const;
+    Result provide_param_custom(const std::string& name, const std::string& value) const;
 
     /**
      * @brief Retrieve all parameters.
@@ -252,6 +253,9 @@ public:
 private:
     /** @private Underlying implementation, set at instantiation */
     std::unique_ptr<ParamServerImpl> _impl;
+
+    /** @private Hand-written additions in param_server_ext.h, if any */
+    friend class ParamServerExt;
 };
 
 } // namespace mavsdk
\ No newline at end of file
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+
+#include "plugins/param_server/param_server.h"
+
+namespace mavsdk {
+
+class ParamServerImpl;
+
+/**
+ * @brief Additions to ParamServer that are only available in C++.
+ *
+ * Unlike param_server.h, this header is not generated from the proto files,
+ * so the calls here are not available through mavsdk_server.
+ *
+ * It works on the ParamServer plugin it is created with, which has to outlive it:
+ *
+ *     ```cpp
+ *     auto param_server = ParamServer(system);
+ *     auto param_server_ext = ParamServerExt(param_server);
+ *     ```
+ */
+class ParamServerExt {
+public:
+    /**
+     * @brief Constructor. Uses the given ParamServer plugin.
+     *
+     * @param param_server The plugin, which has to outlive this object.
+     */
+    explicit ParamServerExt(ParamServer& param_server);
+
+    /**
+     * @brief Set how fast the parameter list is sent when it is requested.
+     *
+     * The list is paced to this budget, so it does not flood narrow links.
+     * The default is 10000 bytes per second.
+     *
+     * @param bytes_per_s Budget in bytes per second, 0 sends the whole list at once.
+     */
+    void set_list_stream_rate(uint32_t bytes_per_s) const;
+
+    /**
+     * @brief Provide many parameters at once.
+     *
+     * This is much cheaper than providing them one by one, e.g. at startup.
+     * Each name should only be given once. If any of them is invalid, none
+     * of them are provided.
+     *
+     * This function is blocking.
+     *
+     * @return Result of request.
+     */
+    ParamServer::Result provide_params(const ParamServer::AllParams& params) const;
+
+private:
+    ParamServerImpl& _impl;
+};
+
+} // namespace mavsdk
@@ -21,33 +21,36 @@ ParamServer::ParamServer(std::shared_ptr<ServerComponent> server_component) :
 
 ParamServer::~ParamServer() {}
 
-std::pair<ParamServer::Result, int32_t> ParamServer::retrieve_param_int(std::string name) const
+std::pair<ParamServer::Result, int32_t> ParamServer::retrieve_param_int(
+    const std::string& name) const
 {
     return _impl->retrieve_param_int(name);
 }
 
-ParamServer::Result ParamServer::provide_param_int(std::string name, int32_t value) const
+ParamServer::Result ParamServer::provide_param_int(const std::string& name, int32_t value) const
 {
     return _impl->provide_param_int(name, value);
 }
 
-std::pair<ParamServer::Result, float> ParamServer::retrieve_param_float(std::string name) const
+std::pair<ParamServer::Result, float> ParamServer::retrieve_param_float(
+    const std::string& name) const
 {
     return _impl->retrieve_param_float(name);
 }
 
-ParamServer::Result ParamServer::provide_param_float(std::string name, float value) const
+ParamServer::Result ParamServer::provide_param_float(const std::string& name, float value) const
 {
     return _impl->provide_param_float(name, value);
 }
 
-std::pair<ParamServer::Result, std::string>
-ParamServer::retrieve_param_custom(std::string name) const
+std::pair<ParamServer::Result, std::string> ParamServer::retrieve_param_custom(
+    const std::string& name) const
 {
     return _impl->retrieve_param_custom(name);
 }
 
-ParamServer::Result ParamServer::provide_param_custom(std::string name, std::string value) const
+ParamServer::Result ParamServer::provide_param_custom(
+    const std::string& name, const std::string& value) const
 {
     return _impl->provide_param_custom(name, value);
 }
@@ -0,0 +1,18 @@
+#include "param_server_impl.h"
+#include "plugins/param_server/param_server_ext.h"
+
+namespace mavsdk {
+
+ParamServerExt::ParamServerExt(ParamServer& param_server) : _impl(*param_server._impl) {}
+
+void ParamServerExt::set_list_stream_rate(uint32_t bytes_per_s) const
+{
+    _impl.set_list_stream_rate(bytes_per_s);
+}
+
+ParamServer::Result ParamServerExt::provide_params(const ParamServer::AllParams& params) const
+{
+    return _impl.provide_params(params);
+}
+
+} // namespace mavsdk
@@ -18,7 +18,8 @@ void ParamServerImpl::init() {}
 
 void ParamServerImpl::deinit() {}
 
-std::pair<ParamServer::Result, int32_t> ParamServerImpl::retrieve_param_int(std::string name) const
+std::pair<ParamServer::Result, int32_t>
+ParamServerImpl::retrieve_param_int(const std::string& name) const
 {
     auto result = _server_component_impl->mavlink_parameters().retrieve_server_param_int(name);
 
@@ -29,7 +30,7 @@ std::pair<ParamServer::Result, int32_t> ParamServerImpl::retrieve_param_int(std:
     }
 }
 
-ParamServer::Result ParamServerImpl::provide_param_int(std::string name, int32_t value)
+ParamServer::Result ParamServerImpl::provide_param_int(const std::string& name, int32_t value)
 {
     if (name.size() > 16) {
         return ParamServer::Result::ParamNameTooLong;
@@ -38,7 +39,8 @@ ParamServer::Result ParamServerImpl::provide_param_int(std::string name, int32_t
     return ParamServer::Result::Success;
 }
 
-std::pair<ParamServer::Result, float> ParamServerImpl::retrieve_param_float(std::string name) const
+std::pair<ParamServer::Result, float>
+ParamServerImpl::retrieve_param_float(const std::string& name) const
 {
     const auto result =
         _server_component_impl->mavlink_parameters().retrieve_server_param_float(name);
@@ -50,7 +52,7 @@ std::pair<ParamServer::Result, float> ParamServerImpl::retrieve_param_float(std:
     }
 }
 
-ParamServer::Result ParamServerImpl::provide_param_float(std::string name, float value)
+ParamServer::Result ParamServerImpl::provide_param_float(const std::string& name, float value)
 {
     if (name.size() > 16) {
         return ParamServer::Result::ParamNameTooLong;
@@ -60,7 +62,7 @@ ParamServer::Result ParamServerImpl::provide_param_float(std::string name, float
 }
 
 std::pair<ParamServer::Result, std::string>
-ParamServerImpl::retrieve_param_custom(std::string name) const
+ParamServerImpl::retrieve_param_custom(const std::string& name) const
 {
     const auto result =
         _server_component_impl->mavlink_parameters().retrieve_server_param_custom(name);
@@ -73,7 +75,7 @@ ParamServerImpl::retrieve_param_custom(std::string name) const
 }
 
 ParamServer::Result
-ParamServerImpl::provide_param_custom(std::string name, const std::string& value)
+ParamServerImpl::provide_param_custom(const std::string& name, const std::string& value)
 {
     if (name.size() > 16) {
         return ParamServer::Result::ParamNameTooLong;
@@ -82,29 +84,56 @@ ParamServerImpl::provide_param_custom(std::string name, const std::string& value
     return ParamServer::Result::Success;
 }
 
-ParamServer::AllParams ParamServerImpl::retrieve_all_params() const
+ParamServer::Result ParamServerImpl::provide_params(const ParamServer::AllParams& params)
 {
-    auto tmp = _server_component_impl->mavlink_parameters().retrieve_all_server_params();
+    std::vector<std::pair<std::string, MAVLinkParameters::ParamValue>> param_values;
+    param_values.reserve(
+        params.int_params.size() + params.float_params.size() + params.custom_params.size());
+
+    for (const auto& int_param : params.int_params) {
+        param_values.emplace_back(int_param.name, MAVLinkParameters::ParamValue{});
+        param_values.back().second.set(int_param.value);
+    }
+    for (const auto& float_param : params.float_params) {
+        param_values.emplace_back(float_param.name, MAVLinkParameters::ParamValue{});
+        param_values.back().second.set(float_param.value);
+    }
+    for (const auto& custom_param : params.custom_params) {
+        param_values.emplace_back(custom_param.name, MAVLinkParameters::ParamValue{});
+        param_values.back().second.set(custom_param.value);
+    }
+
+    return result_from_mavlink_parameters_result(
+        _server_component_impl->mavlink_parameters().provide_server_params(param_values));
+}
 
+ParamServer::AllParams ParamServerImpl::retrieve_all_params() const
+{
     ParamServer::AllParams res{};
 
-    for (auto const& param_pair : tmp) {
-        if (param_pair.second.is<float>()) {
-            ParamServer::FloatParam tmp_param;
-            tmp_param.name = param_pair.first;
-            tmp_param.value = param_pair.second.get<float>();
-            res.float_params.push_back(tmp_param);
-        } else if (param_pair.second.is<int32_t>()) {
-            ParamServer::IntParam tmp_param;
-            tmp_param.name = param_pair.first;
-            tmp_param.value = param_pair.second.get<int32_t>();
-            res.int_params.push_back(tmp_param);
-        }
-    }
+    _server_component_impl->mavlink_parameters().for_each_server_param(
+        [&](const std::string& name, const MAVLinkParameters::ParamValue& value) {
+            if (value.is<float>()) {
+                ParamServer::FloatParam tmp_param;
+                tmp_param.name = name;
+                tmp_param.value = value.get<float>();
+                res.float_params.push_back(tmp_param);
+            } else if (value.is<int32_t>()) {
+                ParamServer::IntParam tmp_param;
+                tmp_param.name = name;
+                tmp_param.value = value.get<int32_t>();
+                res.int_params.push_back(tmp_param);
+            }
+        });
 
     return res;
 }
 
+void ParamServerImpl::set_list_stream_rate(uint32_t bytes_per_s)
+{
+    _server_component_impl->mavlink_parameters().set_list_stream_rate(bytes_per_s);
+}
+
 ParamServer::Result
 ParamServerImpl::result_from_mavlink_parameters_result(MAVLinkParameters::Result result)
 {
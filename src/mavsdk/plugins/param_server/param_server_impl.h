@@ -14,20 +14,25 @@ public:
     void init() override;
     void deinit() override;
 
-    std::pair<ParamServer::Result, int32_t> retrieve_param_int(std::string name) const;
+    std::pair<ParamServer::Result, int32_t> retrieve_param_int(const std::string& name) const;
 
-    ParamServer::Result provide_param_int(std::string name, int32_t value);
+    ParamServer::Result provide_param_int(const std::string& name, int32_t value);
 
-    std::pair<ParamServer::Result, float> retrieve_param_float(std::string name) const;
+    std::pair<ParamServer::Result, float> retrieve_param_float(const std::string& name) const;
 
-    ParamServer::Result provide_param_float(std::string name, float value);
+    ParamServer::Result provide_param_float(const std::string& name, float value);
 
-    std::pair<ParamServer::Result, std::string> retrieve_param_custom(std::string name) const;
+    std::pair<ParamServer::Result, std::string>
+    retrieve_param_custom(const std::string& name) const;
 
-    ParamServer::Result provide_param_custom(std::string name, const std::string& value);
+    ParamServer::Result provide_param_custom(const std::string& name, const std::string& value);
+
+    ParamServer::Result provide_params(const ParamServer::AllParams& params);
 
     ParamServer::AllParams retrieve_all_params() const;
 
+    void set_list_stream_rate(uint32_t bytes_per_s);
+
     static ParamServer::Result
     result_from_mavlink_parameters_result(MAVLinkParameters::Result result);
 
@@ -15,6 +15,7 @@
 
 #include "plugin_base.h"
 
+#include "awaitable.h"
 #include "handle.h"
 
 namespace mavsdk {
@@ -109,7 +110,7 @@ public:
      *
      * @return Result of request.
      */
-    Result send_rtcm_data(RtcmData rtcm_data) const;
+    Result send_rtcm_data(const RtcmData& rtcm_data) const;
 
     /**
      * @brief Copy constructor.
@@ -124,6 +125,9 @@ public:
 private:
     /** @private Underlying implementation, set at instantiation */
     std::unique_ptr<RtkImpl> _impl;
+
+    /** @private Hand-written additions in rtk_ext.h, if any */
+    friend class RtkExt;
 };
 
 } // namespace mavsdk
\ No newline at end of file
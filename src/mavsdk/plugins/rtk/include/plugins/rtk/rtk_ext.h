@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+
+#include "plugins/rtk/rtk.h"
+
+namespace mavsdk {
+
+class RtkImpl;
+
+/**
+ * @brief Additions to Rtk that are only available in C++.
+ *
+ * Unlike rtk.h, this header is not generated from the proto files,
+ * so the calls here are not available through mavsdk_server.
+ *
+ * It works on the Rtk plugin it is created with, which has to outlive it:
+ *
+ *     ```cpp
+ *     auto rtk = Rtk(system);
+ *     auto rtk_ext = RtkExt(rtk);
+ *     ```
+ *
+ * Rtk::send_rtcm_data() parses the data into RTCM3 frames, so it can be cut
+ * anywhere, e.g. as read from a base station. Bytes that are not part of a
+ * valid frame are dropped. The frames passed in one call are packed into as
+ * few messages as possible. The messages are not addressed to a system, so
+ * they reach all vehicles connected, and one Rtk instance is enough for all
+ * of them.
+ */
+class RtkExt {
+public:
+    /**
+     * @brief Constructor. Uses the given Rtk plugin.
+     *
+     * @param rtk The plugin, which has to outlive this object.
+     */
+    explicit RtkExt(Rtk& rtk);
+
+    /**
+     * @brief Limit how fast RTCM data is sent.
+     *
+     * Data beyond the limit is queued and sent later, so that corrections
+     * arriving in bursts don't crowd out other traffic on narrow links. If
+     * more than a second of data is queued, the oldest is dropped, as it
+     * would be stale by the time it arrives. By default there is no limit.
+     *
+     * @param bytes_per_s Limit in bytes per second, 0 sends all data directly.
+     */
+    void set_data_rate_limit(uint32_t bytes_per_s) const;
+
+private:
+    RtkImpl& _impl;
+};
+
+} // namespace mavsdk
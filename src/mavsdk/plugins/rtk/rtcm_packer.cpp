@@ -0,0 +1,189 @@
+#include "rtcm_packer.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace mavsdk {
+
+namespace {
+
+constexpr uint8_t preamble = 0xD3;
+// Preamble, 6 reserved bits, and the 10 bit length.
+constexpr size_t header_len = 3;
+constexpr size_t crc_len = 3;
+
+constexpr uint8_t fragmented_flag = 0x1;
+
+constexpr std::array<uint32_t, 256> make_crc24q_table()
+{
+    constexpr uint32_t polynomial = 0x1864CFB;
+
+    std::array<uint32_t, 256> table{};
+    for (uint32_t i = 0; i < 256; ++i) {
+        uint32_t crc = i << 16;
+        for (int bit = 0; bit < 8; ++bit) {
+            crc <<= 1;
+            if (crc & 0x1000000) {
+                crc ^= polynomial;
+            }
+        }
+        table[i] = crc & 0xFFFFFF;
+    }
+    return table;
+}
+
+constexpr auto crc24q_table = make_crc24q_table();
+
+uint8_t fragment_id(uint8_t flags)
+{
+    return (flags >> 1) & 0x3;
+}
+
+uint8_t sequence_id(uint8_t flags)
+{
+    return flags >> 3;
+}
+
+} // namespace
+
+void RtcmPacker::push(const uint8_t* data, size_t len)
+{
+    _buffer.insert(_buffer.end(), data, data + len);
+
+    size_t pos = 0;
+    while (pos < _buffer.size()) {
+        const auto found = std::find(_buffer.begin() + pos, _buffer.end(), preamble);
+        const auto start = static_cast<size_t>(found - _buffer.begin());
+        _statistics.num_bytes_discarded += start - pos;
+        pos = start;
+
+        if (_buffer.size() - pos < header_len) {
+            break;
+        }
+
+        // The reserved bits need to be 0, otherwise it's not a frame but
+        // just a byte that happened to look like a preamble.
+        if ((_buffer[pos + 1] & 0xFC) != 0) {
+            ++_statistics.num_bytes_discarded;
+            ++pos;
+            continue;
+        }
+
+        const size_t payload_len = ((_buffer[pos + 1] & 0x03) << 8) | _buffer[pos + 2];
+        const size_t frame_len = header_len + payload_len + crc_len;
+        if (_buffer.size() - pos < frame_len) {
+            break;
+        }
+
+        const uint8_t* frame = _buffer.data() + pos;
+        const uint8_t* crc = frame + header_len + payload_len;
+        const uint32_t expected_crc = (crc[0] << 16) | (crc[1] << 8) | crc[2];
+        if (crc24q(frame, header_len + payload_len) != expected_crc) {
+            ++_statistics.num_bytes_discarded;
+            ++pos;
+            continue;
+        }
+
+        ++_statistics.num_frames;
+        pack_frame(frame, frame_len);
+        pos += frame_len;
+    }
+    _buffer.erase(_buffer.begin(), _buffer.begin() + pos);
+
+    // What came in together, e.g. all the corrections of one epoch, goes out
+    // together, later frames are not waited for.
+    close_packet();
+}
+
+void RtcmPacker::pop_front()
+{
+    _queued_bytes -= _packets.front().len;
+    _packets.pop_front();
+}
+
+void RtcmPacker::drop_oldest_message()
+{
+    if (_packets.empty()) {
+        return;
+    }
+
+    const uint8_t flags = _packets.front().flags;
+    pop_front();
+    ++_statistics.num_packets_dropped;
+
+    if ((flags & fragmented_flag) == 0) {
+        return;
+    }
+
+    while (!_packets.empty() && (_packets.front().flags & fragmented_flag) != 0 &&
+           fragment_id(_packets.front().flags) != 0 &&
+           sequence_id(_packets.front().flags) == sequence_id(flags)) {
+        pop_front();
+        ++_statistics.num_packets_dropped;
+    }
+}
+
+uint32_t RtcmPacker::crc24q(const uint8_t* data, size_t len)
+{
+    uint32_t crc = 0;
+    for (size_t i = 0; i < len; ++i) {
+        crc = ((crc << 8) & 0xFFFFFF) ^ crc24q_table[((crc >> 16) ^ data[i]) & 0xFF];
+    }
+    return crc;
+}
+
+void RtcmPacker::pack_frame(const uint8_t* frame, size_t len)
+{
+    if (len <= max_packet_len) {
+        if (_open_packet_len + len > max_packet_len) {
+            close_packet();
+        }
+        std::memcpy(_open_packet.data() + _open_packet_len, frame, len);
+        _open_packet_len += len;
+        return;
+    }
+
+    close_packet();
+
+    // Frames can be up to 1029 bytes, more than the 4 fragments of one
+    // sequence ID, so the rest goes into the next one.
+    size_t offset = 0;
+    while (offset < len) {
+        const size_t remaining_packets = (len - offset + max_packet_len - 1) / max_packet_len;
+        const size_t num_fragments = std::min<size_t>(remaining_packets, max_fragments);
+
+        for (size_t i = 0; i < num_fragments; ++i) {
+            const size_t chunk_len = std::min(max_packet_len, len - offset);
+            const uint8_t flags = (num_fragments > 1 ? fragmented_flag : 0) |
+                                  static_cast<uint8_t>(i << 1) |
+                                  static_cast<uint8_t>((_sequence & 0x1F) << 3);
+            add_packet(flags, frame + offset, chunk_len);
+            offset += chunk_len;
+        }
+        ++_sequence;
+    }
+}
+
+void RtcmPacker::close_packet()
+{
+    if (_open_packet_len == 0) {
+        return;
+    }
+
+    const auto flags = static_cast<uint8_t>((_sequence & 0x1F) << 3);
+    add_packet(flags, _open_packet.data(), _open_packet_len);
+    ++_sequence;
+    _open_packet_len = 0;
+}
+
+void RtcmPacker::add_packet(uint8_t flags, const uint8_t* data, size_t len)
+{
+    Packet packet;
+    packet.flags = flags;
+    packet.len = static_cast<uint8_t>(len);
+    std::memcpy(packet.data.data(), data, len);
+    _packets.push_back(packet);
+    _queued_bytes += len;
+}
+
+} // namespace mavsdk
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+namespace mavsdk {
+
+// Cuts a stream of RTCM3 data into the payloads of GPS_RTCM_DATA messages.
+//
+// The stream is parsed into frames, and frames with a wrong CRC or bytes in
+// between frames are dropped, so that the GPS is not fed broken data. The
+// frames given in one push are packed into as few packets as possible,
+// without splitting frames that fit into one packet. Frames which don't fit
+// are fragmented, up to 4 fragments per sequence ID, as many as it takes.
+//
+// Not thread-safe, the caller needs to lock.
+class RtcmPacker {
+public:
+    // MAVLINK_MSG_GPS_RTCM_DATA_FIELD_DATA_LEN
+    static constexpr size_t max_packet_len = 180;
+    // Only two bits for the fragment ID.
+    static constexpr unsigned max_fragments = 4;
+
+    struct Packet {
+        uint8_t flags{0};
+        uint8_t len{0};
+        std::array<uint8_t, max_packet_len> data{};
+    };
+
+    struct Statistics {
+        uint64_t num_frames{0};
+        uint64_t num_bytes_discarded{0};
+        uint64_t num_packets_dropped{0};
+    };
+
+    RtcmPacker() = default;
+    ~RtcmPacker() = default;
+
+    // Non-copyable
+    RtcmPacker(const RtcmPacker&) = delete;
+    const RtcmPacker& operator=(const RtcmPacker&) = delete;
+
+    // Data can be cut anywhere, an incomplete frame is kept for the next push.
+    void push(const uint8_t* data, size_t len);
+
+    [[nodiscard]] bool empty() const { return _packets.empty(); }
+    [[nodiscard]] const Packet& front() const { return _packets.front(); }
+    void pop_front();
+
+    // The RTCM bytes of all packets queued.
+    [[nodiscard]] size_t queued_bytes() const { return _queued_bytes; }
+
+    // Drops the oldest message, with all its fragments, e.g. because it is
+    // stale by the time it could be sent.
+    void drop_oldest_message();
+
+    [[nodiscard]] Statistics statistics() const { return _statistics; }
+
+    static uint32_t crc24q(const uint8_t* data, size_t len);
+
+private:
+    void pack_frame(const uint8_t* frame, size_t len);
+    void close_packet();
+    void add_packet(uint8_t flags, const uint8_t* data, size_t len);
+
+    std::vector<uint8_t> _buffer{};
+
+    // Small frames are collected here until the packet is full.
+    std::array<uint8_t, max_packet_len> _open_packet{};
+    size_t _open_packet_len{0};
+
+    std::deque<Packet> _packets{};
+    size_t _queued_bytes{0};
+    uint8_t _sequence{0};
+    Statistics _statistics{};
+};
+
+} // namespace mavsdk
@@ -0,0 +1,160 @@
+#include "rtcm_packer.h"
+
+#include <gtest/gtest.h>
+#include <numeric>
+#include <vector>
+
+using namespace mavsdk;
+
+namespace {
+
+std::vector<uint8_t> make_frame(size_t payload_len, uint8_t fill = 0x42)
+{
+    std::vector<uint8_t> frame{
+        0xD3,
+        static_cast<uint8_t>((payload_len >> 8) & 0x03),
+        static_cast<uint8_t>(payload_len & 0xFF)};
+    frame.insert(frame.end(), payload_len, fill);
+
+    const uint32_t crc = RtcmPacker::crc24q(frame.data(), frame.size());
+    frame.push_back(static_cast<uint8_t>(crc >> 16));
+    frame.push_back(static_cast<uint8_t>(crc >> 8));
+    frame.push_back(static_cast<uint8_t>(crc));
+    return frame;
+}
+
+std::vector<RtcmPacker::Packet> take_all(RtcmPacker& packer)
+{
+    std::vector<RtcmPacker::Packet> packets;
+    while (!packer.empty()) {
+        packets.push_back(packer.front());
+        packer.pop_front();
+    }
+    return packets;
+}
+
+std::vector<uint8_t> bytes_of(const std::vector<RtcmPacker::Packet>& packets)
+{
+    std::vector<uint8_t> bytes;
+    for (const auto& packet : packets) {
+        bytes.insert(bytes.end(), packet.data.begin(), packet.data.begin() + packet.len);
+    }
+    return bytes;
+}
+
+void push(RtcmPacker& packer, const std::vector<uint8_t>& data)
+{
+    packer.push(data.data(), data.size());
+}
+
+} // namespace
+
+TEST(RtcmPacker, Crc24qMatchesReference)
+{
+    // RTCM 1005 frame as found in the RTCM 3.3 standard.
+    const std::vector<uint8_t> frame{0xD3, 0x00, 0x13, 0x3E, 0xD7, 0xD3, 0x02, 0x02, 0x98,
+                                     0x0E, 0xDE, 0xEF, 0x34, 0xB4, 0xBD, 0x62, 0xAC, 0x09,
+                                     0x41, 0x98, 0x6F, 0x33, 0x36, 0x0B, 0x98};
+    const uint32_t crc = (frame[22] << 16) | (frame[23] << 8) | frame[24];
+    EXPECT_EQ(RtcmPacker::crc24q(frame.data(), frame.size() - 3), crc);
+}
+
+TEST(RtcmPacker, CoalescesSmallFrames)
+{
+    RtcmPacker packer;
+    std::vector<uint8_t> data;
+    for (int i = 0; i < 5; ++i) {
+        const auto frame = make_frame(24);
+        data.insert(data.end(), frame.begin(), frame.end());
+    }
+    push(packer, data);
+
+    // 5 times 30 bytes fit into one packet.
+    const auto packets = take_all(packer);
+    ASSERT_EQ(packets.size(), 1);
+    EXPECT_EQ(packets[0].len, 150);
+    EXPECT_EQ(packets[0].flags & 0x1, 0);
+    EXPECT_EQ(bytes_of(packets), data);
+    EXPECT_EQ(packer.statistics().num_frames, 5);
+}
+
+TEST(RtcmPacker, DoesNotSplitFramesThatFit)
+{
+    RtcmPacker packer;
+    const auto first = make_frame(94);
+    const auto second = make_frame(94);
+    std::vector<uint8_t> data = first;
+    data.insert(data.end(), second.begin(), second.end());
+    push(packer, data);
+
+    const auto packets = take_all(packer);
+    ASSERT_EQ(packets.size(), 2);
+    EXPECT_EQ(packets[0].len, 100);
+    EXPECT_EQ(packets[1].len, 100);
+    EXPECT_NE(packets[0].flags >> 3, packets[1].flags >> 3);
+}
+
+TEST(RtcmPacker, FragmentsBeyondFourFragments)
+{
+    RtcmPacker packer;
+    // The maximum frame size.
+    const auto frame = make_frame(1023);
+    push(packer, frame);
+
+    const auto packets = take_all(packer);
+    ASSERT_EQ(packets.size(), 6);
+    for (size_t i = 0; i < 4; ++i) {
+        EXPECT_EQ(packets[i].flags & 0x1, 1);
+        EXPECT_EQ((packets[i].flags >> 1) & 0x3, i);
+        EXPECT_EQ(packets[i].flags >> 3, packets[0].flags >> 3);
+        EXPECT_EQ(packets[i].len, 180);
+    }
+    EXPECT_EQ(packets[4].flags >> 3, (packets[0].flags >> 3) + 1);
+    EXPECT_EQ((packets[5].flags >> 1) & 0x3, 1);
+    EXPECT_EQ(bytes_of(packets), frame);
+}
+
+TEST(RtcmPacker, KeepsIncompleteFrameForNextPush)
+{
+    RtcmPacker packer;
+    const auto frame = make_frame(50);
+    packer.push(frame.data(), 20);
+    EXPECT_TRUE(packer.empty());
+
+    packer.push(frame.data() + 20, frame.size() - 20);
+    EXPECT_EQ(bytes_of(take_all(packer)), frame);
+}
+
+TEST(RtcmPacker, DiscardsGarbageAndBrokenFrames)
+{
+    RtcmPacker packer;
+    const auto good = make_frame(10);
+    auto broken = make_frame(10);
+    broken[5] ^= 0xFF;
+
+    std::vector<uint8_t> data{0x01, 0xD3, 0xFF, 0x02};
+    data.insert(data.end(), broken.begin(), broken.end());
+    data.insert(data.end(), good.begin(), good.end());
+    push(packer, data);
+
+    EXPECT_EQ(bytes_of(take_all(packer)), good);
+    EXPECT_EQ(packer.statistics().num_frames, 1);
+    EXPECT_EQ(packer.statistics().num_bytes_discarded, 4 + broken.size());
+}
+
+TEST(RtcmPacker, DropsOldestMessageWithAllFragments)
+{
+    RtcmPacker packer;
+    push(packer, make_frame(500));
+    push(packer, make_frame(10));
+    EXPECT_EQ(packer.queued_bytes(), 506 + 16);
+
+    packer.drop_oldest_message();
+    EXPECT_EQ(packer.queued_bytes(), 16);
+    EXPECT_EQ(packer.statistics().num_packets_dropped, 3);
+
+    const auto packets = take_all(packer);
+    ASSERT_EQ(packets.size(), 1);
+    EXPECT_EQ(packets[0].len, 16);
+    EXPECT_EQ(packer.queued_bytes(), 0);
+}
@@ -17,7 +17,7 @@ Rtk::Rtk(std::shared_ptr<System> system) : PluginBase(), _impl{std::make_unique<
 
 Rtk::~Rtk() {}
 
-Rtk::Result Rtk::send_rtcm_data(RtcmData rtcm_data) const
+Rtk::Result Rtk::send_rtcm_data(const RtcmData& rtcm_data) const
 {
     return _impl->send_rtcm_data(rtcm_data);
 }
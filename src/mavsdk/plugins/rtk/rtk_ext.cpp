@@ -0,0 +1,13 @@
+#include "rtk_impl.h"
+#include "plugins/rtk/rtk_ext.h"
+
+namespace mavsdk {
+
+RtkExt::RtkExt(Rtk& rtk) : _impl(*rtk._impl) {}
+
+void RtkExt::set_data_rate_limit(uint32_t bytes_per_s) const
+{
+    _impl.set_data_rate_limit(bytes_per_s);
+}
+
+} // namespace mavsdk
@@ -18,9 +18,21 @@ RtkImpl::~RtkImpl()
     _system_impl->unregister_plugin(this);
 }
 
-void RtkImpl::init() {}
+void RtkImpl::init()
+{
+    _system_impl->add_call_every(
+        [this]() {
+            std::lock_guard<std::mutex> lock(_mutex);
+            send_queued();
+        },
+        SEND_INTERVAL_S,
+        &_send_cookie);
+}
 
-void RtkImpl::deinit() {}
+void RtkImpl::deinit()
+{
+    _system_impl->remove_call_every(_send_cookie);
+}
 
 void RtkImpl::enable() {}
 
@@ -28,47 +40,83 @@ void RtkImpl::disable() {}
 
 Rtk::Result RtkImpl::send_rtcm_data(Rtk::RtcmData rtcm_data)
 {
-    constexpr size_t field_len = MAVLINK_MSG_GPS_RTCM_DATA_FIELD_DATA_LEN;
+    std::lock_guard<std::mutex> lock(_mutex);
 
-    const size_t num_packets_required =
-        rtcm_data.data.size() / field_len + (rtcm_data.data.size() % field_len == 0 ? 0 : 1);
+    _packer.push(reinterpret_cast<const uint8_t*>(rtcm_data.data.data()), rtcm_data.data.size());
 
-    // The maximum is 4 times the 180 bytes because we only have two bits to
-    // denote the fragment ID.
-    if (num_packets_required > 4) {
-        return Rtk::Result::TooLong;
+    if (_bytes_per_s > 0) {
+        const auto max_backlog_bytes = static_cast<size_t>(_bytes_per_s * MAX_BACKLOG_S);
+        while (_packer.queued_bytes() > max_backlog_bytes) {
+            _packer.drop_oldest_message();
+        }
     }
 
-    // Copy length before we change it.
-    size_t bytes_to_send = rtcm_data.data.size();
+    return send_queued() ? Rtk::Result::Success : Rtk::Result::ConnectionError;
+}
 
-    // The mavlink helpers memcpy, so we need to make sure we're not
-    // copying from where we shouldn't.
-    rtcm_data.data.resize(num_packets_required * field_len);
+void RtkImpl::set_data_rate_limit(uint32_t bytes_per_s)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _bytes_per_s = bytes_per_s;
+    _budget_bytes = 0.0;
+    _last_send_time = std::chrono::steady_clock::now() -
+                      std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                          std::chrono::duration<double>(MAX_BURST_S));
+}
 
-    for (size_t i = 0; i < num_packets_required; ++i) {
-        const uint8_t flags =
-            (num_packets_required > 1 ? 0x1 : 0x0) | ((i & 0x3) << 1) | ((_sequence & 0x1F) << 3);
+bool RtkImpl::send_queued()
+{
+    if (_packer.empty()) {
+        return true;
+    }
+
+    const bool paced = _bytes_per_s > 0;
+    if (paced) {
+        // Signing changes it a bit, but this is close enough.
+        constexpr double max_frame_len =
+            MAVLINK_MSG_ID_GPS_RTCM_DATA_LEN + MAVLINK_NUM_NON_PAYLOAD_BYTES;
+
+        const auto now = std::chrono::steady_clock::now();
+        const auto bytes_per_s = static_cast<double>(_bytes_per_s);
+        const double elapsed_s = std::chrono::duration<double>(now - _last_send_time).count();
+        _last_send_time = now;
+        _budget_bytes = std::min(
+            _budget_bytes + bytes_per_s * elapsed_s,
+            std::max(bytes_per_s * MAX_BURST_S, max_frame_len));
+    }
+
+    while (!_packer.empty()) {
+        const auto& packet = _packer.front();
 
+        // The data field is trimmed to its length on the wire.
+        const double frame_len = 2.0 + packet.len + MAVLINK_NUM_NON_PAYLOAD_BYTES;
+        if (paced && _budget_bytes < frame_len) {
+            break;
+        }
+        _budget_bytes -= frame_len;
+
+        // The message carries no target, so it is packed once and reaches
+        // all vehicles on all links.
         mavlink_message_t message;
         mavlink_msg_gps_rtcm_data_pack(
             _system_impl->get_own_system_id(),
             _system_impl->get_own_component_id(),
             &message,
-            flags,
-            static_cast<uint8_t>(std::min(field_len, bytes_to_send)),
-            reinterpret_cast<const uint8_t*>(rtcm_data.data.c_str() + (i * field_len)));
+            packet.flags,
+            packet.len,
+            packet.data.data());
+        _outgoing.push_back(message);
 
-        if (!_system_impl->send_message(message)) {
-            ++_sequence;
-            return Rtk::Result::ConnectionError;
-        }
+        _packer.pop_front();
+    }
 
-        bytes_to_send -= field_len;
+    if (_outgoing.empty()) {
+        return true;
     }
 
-    ++_sequence;
-    return Rtk::Result::Success;
+    const bool success = _system_impl->send_messages(_outgoing);
+    _outgoing.clear();
+    return success;
 }
 
 } // namespace mavsdk
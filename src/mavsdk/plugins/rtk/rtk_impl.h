@@ -2,6 +2,11 @@
 
 #include "plugins/rtk/rtk.h"
 #include "plugin_impl_base.h"
+#include "mavsdk_time.h"
+#include "rtcm_packer.h"
+
+#include <mutex>
+#include <vector>
 
 namespace mavsdk {
 
@@ -19,8 +24,26 @@ public:
 
     Rtk::Result send_rtcm_data(Rtk::RtcmData rtcm_data);
 
+    void set_data_rate_limit(uint32_t bytes_per_s);
+
 private:
-    unsigned _sequence{0};
+    // Sends what is queued, as far as the budget of bytes allows.
+    bool send_queued(); // Needs _mutex
+
+    std::mutex _mutex{};
+    RtcmPacker _packer{}; // Needs _mutex
+    std::vector<mavlink_message_t> _outgoing{}; // Needs _mutex
+    uint32_t _bytes_per_s{0}; // Needs _mutex
+    double _budget_bytes{0.0}; // Needs _mutex
+    SteadyTimePoint _last_send_time{}; // Needs _mutex
+
+    void* _send_cookie{nullptr};
+
+    static constexpr float SEND_INTERVAL_S = 0.01f;
+    // Budget not used is kept for at most this long, to keep bursts short.
+    static constexpr double MAX_BURST_S = 0.05;
+    // Corrections queued for longer than this are stale once they arrive.
+    static constexpr double MAX_BACKLOG_S = 1.0;
 };
 
 } // namespace mavsdk
@@ -16,6 +16,7 @@
 
 #include "plugin_base.h"
 
+#include "awaitable.h"
 #include "handle.h"
 
 namespace mavsdk {
@@ -111,7 +112,7 @@ public:
      *
      * @return Result of request.
      */
-    Result send_status_text(StatusTextType type, std::string text) const;
+    Result send_status_text(StatusTextType type, const std::string& text) const;
 
     /**
      * @brief Copy constructor.
@@ -126,6 +127,9 @@ public:
 private:
     /** @private Underlying implementation, set at instantiation */
     std::unique_ptr<ServerUtilityImpl> _impl;
+
+    /** @private Hand-written additions in server_utility_ext.h, if any */
+    friend class ServerUtilityExt;
 };
 
 } // namespace mavsdk
\ No newline at end of file
@@ -22,7 +22,8 @@ ServerUtility::ServerUtility(std::shared_ptr<System> system) :
 
 ServerUtility::~ServerUtility() {}
 
-ServerUtility::Result ServerUtility::send_status_text(StatusTextType type, std::string text) const
+ServerUtility::Result ServerUtility::send_status_text(
+    StatusTextType type, const std::string& text) const
 {
     return _impl->send_status_text(type, text);
 }
@@ -15,6 +15,7 @@
 
 #include "plugin_base.h"
 
+#include "awaitable.h"
 #include "handle.h"
 
 namespace mavsdk {
@@ -90,7 +91,7 @@ public:
      *
      * @return Result of request.
      */
-    Result send(std::string command) const;
+    Result send(const std::string& command) const;
 
     /**
      * @brief Callback type for subscribe_receive.
@@ -128,6 +129,9 @@ public:
 private:
     /** @private Underlying implementation, set at instantiation */
     std::unique_ptr<ShellImpl> _impl;
+
+    /** @private Hand-written additions in shell_ext.h, if any */
+    friend class ShellExt;
 };
 
 } // namespace mavsdk
\ No newline at end of file
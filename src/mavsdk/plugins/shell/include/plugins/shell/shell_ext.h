@@ -0,0 +1,77 @@
+#pragma once
+
+#include <functional>
+#include <string>
+
+#include "plugins/shell/shell.h"
+
+namespace mavsdk {
+
+class ShellImpl;
+
+/**
+ * @brief Additions to Shell that are only available in C++.
+ *
+ * Unlike shell.h, this header is not generated from the proto files,
+ * so the calls here are not available through mavsdk_server.
+ *
+ * It works on the Shell plugin it is created with, which has to outlive it:
+ *
+ *     ```cpp
+ *     auto shell = Shell(system);
+ *     auto shell_ext = ShellExt(shell);
+ *     ```
+ */
+class ShellExt {
+public:
+    /**
+     * @brief Constructor. Uses the given Shell plugin.
+     *
+     * @param shell The plugin, which has to outlive this object.
+     */
+    explicit ShellExt(Shell& shell);
+
+    /**
+     * @brief Write to the shell as a byte stream.
+     *
+     * Unlike Shell::send(), nothing is added to the data and this does not block.
+     * The data is queued and sent in the background at a pace the link can
+     * take, e.g. to run a long script.
+     *
+     * While output is expected, it is requested from the shell, and it is
+     * given to the subscribe_output() callbacks in bigger chunks rather than
+     * per message.
+     *
+     * @return Result of request.
+     */
+    Shell::Result write(const std::string& data) const;
+
+    /**
+     * @brief Callback type for subscribe_output.
+     */
+    using OutputCallback = std::function<void(std::string)>;
+
+    /**
+     * @brief Handle type for subscribe_output.
+     */
+    using OutputHandle = Handle<std::string>;
+
+    /**
+     * @brief Receive the raw output of the shell, coalesced into bigger
+     * chunks.
+     *
+     * This subscription needs to be made before writing, otherwise, no
+     * output is requested.
+     */
+    OutputHandle subscribe_output(const OutputCallback& callback);
+
+    /**
+     * @brief Unsubscribe from subscribe_output
+     */
+    void unsubscribe_output(OutputHandle handle);
+
+private:
+    ShellImpl& _impl;
+};
+
+} // namespace mavsdk
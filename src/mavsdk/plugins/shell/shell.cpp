@@ -18,7 +18,7 @@ Shell::Shell(std::shared_ptr<System> system) :
 
 Shell::~Shell() {}
 
-Shell::Result Shell::send(std::string command) const
+Shell::Result Shell::send(const std::string& command) const
 {
     return _impl->send(command);
 }
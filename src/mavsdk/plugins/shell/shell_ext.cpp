@@ -0,0 +1,23 @@
+#include "shell_impl.h"
+#include "plugins/shell/shell_ext.h"
+
+namespace mavsdk {
+
+ShellExt::ShellExt(Shell& shell) : _impl(*shell._impl) {}
+
+Shell::Result ShellExt::write(const std::string& data) const
+{
+    return _impl.write(data);
+}
+
+ShellExt::OutputHandle ShellExt::subscribe_output(const OutputCallback& callback)
+{
+    return _impl.subscribe_output(callback);
+}
+
+void ShellExt::unsubscribe_output(OutputHandle handle)
+{
+    _impl.unsubscribe_output(handle);
+}
+
+} // namespace mavsdk
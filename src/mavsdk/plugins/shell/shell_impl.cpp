@@ -12,10 +12,14 @@ void ShellImpl::init()
         MAVLINK_MSG_ID_SERIAL_CONTROL,
         [this](const mavlink_message_t& message) { process_shell_message(message); },
         this);
+
+    _system_impl->add_call_every(
+        [this]() { process_stream(); }, stream_interval_s, &_stream_cookie);
 }
 
 void ShellImpl::deinit()
 {
+    _system_impl->remove_call_every(_stream_cookie);
     _system_impl->unregister_all_mavlink_message_handlers(this);
 }
 
@@ -68,23 +72,34 @@ void ShellImpl::unsubscribe_receive(Shell::ReceiveHandle handle)
     _receive.callbacks.unsubscribe(handle);
 }
 
+Shell::Result ShellImpl::write(const std::string& data)
+{
+    if (!_system_impl->is_connected()) {
+        return Shell::Result::NoSystem;
+    }
+
+    std::lock_guard<std::mutex> lock(_stream_mutex);
+    _stream.write(data, _time.steady_time());
+    return Shell::Result::Success;
+}
+
+ShellExt::OutputHandle ShellImpl::subscribe_output(const ShellExt::OutputCallback& callback)
+{
+    return _output_callbacks.subscribe(callback);
+}
+
+void ShellImpl::unsubscribe_output(ShellExt::OutputHandle handle)
+{
+    _output_callbacks.unsubscribe(handle);
+}
+
 bool ShellImpl::send_command_message(std::string command)
 {
     mavlink_message_t message;
 
     while (command.length() > MAVLINK_MSG_SERIAL_CONTROL_FIELD_DATA_LEN) {
-        mavlink_msg_serial_control_pack(
-            _system_impl->get_own_system_id(),
-            _system_impl->get_own_component_id(),
-            &message,
-            static_cast<uint8_t>(SERIAL_CONTROL_DEV::SERIAL_CONTROL_DEV_SHELL),
-            0,
-            timeout_ms,
-            0,
-            static_cast<uint8_t>(MAVLINK_MSG_SERIAL_CONTROL_FIELD_DATA_LEN),
-            reinterpret_cast<const uint8_t*>(command.c_str()),
-            _system_impl->get_system_id(),
-            _system_impl->get_autopilot_id());
+        message = make_serial_control_message(
+            command.c_str(), MAVLINK_MSG_SERIAL_CONTROL_FIELD_DATA_LEN, 0, timeout_ms);
         command.erase(0, MAVLINK_MSG_SERIAL_CONTROL_FIELD_DATA_LEN);
         if (!_system_impl->send_message(message)) {
             return false;
@@ -100,23 +115,33 @@ bool ShellImpl::send_command_message(std::string command)
         }
     }
 
-    uint8_t data[MAVLINK_MSG_SERIAL_CONTROL_FIELD_DATA_LEN]{};
-    memcpy(data, command.c_str(), command.length());
+    message = make_serial_control_message(command.c_str(), command.length(), flags, timeout_ms);
+    return _system_impl->send_message(message);
+}
+
+mavlink_message_t ShellImpl::make_serial_control_message(
+    const char* data, size_t len, uint8_t flags, uint16_t timeout)
+{
+    // The whole field is copied, however long the data is.
+    uint8_t buffer[MAVLINK_MSG_SERIAL_CONTROL_FIELD_DATA_LEN]{};
+    if (len > 0) {
+        memcpy(buffer, data, len);
+    }
 
+    mavlink_message_t message;
     mavlink_msg_serial_control_pack(
         _system_impl->get_own_system_id(),
         _system_impl->get_own_component_id(),
         &message,
         static_cast<uint8_t>(SERIAL_CONTROL_DEV::SERIAL_CONTROL_DEV_SHELL),
         flags,
-        timeout_ms,
+        timeout,
         0,
-        static_cast<uint8_t>(command.length()),
-        data,
+        static_cast<uint8_t>(len),
+        buffer,
         _system_impl->get_system_id(),
         _system_impl->get_autopilot_id());
-
-    return _system_impl->send_message(message);
+    return message;
 }
 
 void ShellImpl::process_shell_message(const mavlink_message_t& message)
@@ -132,6 +157,12 @@ void ShellImpl::process_shell_message(const mavlink_message_t& message)
 
     memcpy(str_copy, serial_control.data, len);
 
+    // The stream gets the output as it is.
+    if (!_output_callbacks.empty()) {
+        std::lock_guard<std::mutex> lock(_stream_mutex);
+        _stream.add_output(str_copy, len, _time.steady_time());
+    }
+
     std::string response(str_copy);
 
     // For the NuttShell (nsh>) we see these characters being sent but we're not sure
@@ -146,4 +177,44 @@ void ShellImpl::process_shell_message(const mavlink_message_t& message)
         response, [this](const auto& func) { _system_impl->call_user_callback(func); });
 }
 
+void ShellImpl::process_stream()
+{
+    std::deque<std::string> chunks;
+    bool should_poll = false;
+    std::string output;
+    bool has_output = false;
+    {
+        std::lock_guard<std::mutex> lock(_stream_mutex);
+        const auto now = _time.steady_time();
+        if (_stream.is_idle(now)) {
+            return;
+        }
+
+        chunks = _stream.take_chunks(now);
+        // A chunk asks for output as well.
+        should_poll = chunks.empty() && _stream.should_poll(now);
+        has_output = _stream.take_output(now, output);
+    }
+
+    // Without anyone interested, we don't need output.
+    const uint8_t flags = _output_callbacks.empty() ? 0 : SERIAL_CONTROL_FLAG_RESPOND;
+
+    std::vector<mavlink_message_t> messages;
+    for (const auto& chunk : chunks) {
+        messages.push_back(
+            make_serial_control_message(chunk.data(), chunk.size(), flags, stream_timeout_ms));
+    }
+    if (should_poll && flags != 0) {
+        messages.push_back(make_serial_control_message(nullptr, 0, flags, stream_timeout_ms));
+    }
+    if (!messages.empty() && !_system_impl->send_messages(messages)) {
+        LogWarn() << "Sending shell stream failed";
+    }
+
+    if (has_output) {
+        _output_callbacks.queue(
+            output, [this](const auto& func) { _system_impl->call_user_callback(func); });
+    }
+}
+
 } // namespace mavsdk
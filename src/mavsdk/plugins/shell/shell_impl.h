@@ -3,8 +3,11 @@
 #include <mutex>
 
 #include "plugins/shell/shell.h"
+#include "plugins/shell/shell_ext.h"
 #include "mavlink_include.h"
+#include "mavsdk_time.h"
 #include "plugin_impl_base.h"
+#include "shell_stream.h"
 #include "system.h"
 #include "callback_list.h"
 
@@ -28,18 +31,34 @@ public:
     Shell::ReceiveHandle subscribe_receive(const Shell::ReceiveCallback& callback);
     void unsubscribe_receive(Shell::ReceiveHandle handle);
 
+    Shell::Result write(const std::string& data);
+    ShellExt::OutputHandle subscribe_output(const ShellExt::OutputCallback& callback);
+    void unsubscribe_output(ShellExt::OutputHandle handle);
+
     ShellImpl(const ShellImpl&) = delete;
     ShellImpl& operator=(const ShellImpl&) = delete;
 
 private:
     bool send_command_message(std::string command);
+    mavlink_message_t
+    make_serial_control_message(const char* data, size_t len, uint8_t flags, uint16_t timeout);
     void process_shell_message(const mavlink_message_t& message);
+    void process_stream();
 
     static constexpr uint16_t timeout_ms = 1000;
+    // We poll instead of waiting for the reply.
+    static constexpr uint16_t stream_timeout_ms = 0;
+    static constexpr float stream_interval_s = 0.01f;
 
     struct {
         std::mutex mutex{};
         CallbackList<std::string> callbacks{};
     } _receive{};
+
+    std::mutex _stream_mutex{};
+    ShellStream _stream{}; // Needs _stream_mutex
+    CallbackList<std::string> _output_callbacks{};
+    void* _stream_cookie{nullptr};
+    Time _time{};
 };
 } // namespace mavsdk
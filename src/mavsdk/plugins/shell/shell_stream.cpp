@@ -0,0 +1,115 @@
+#include "shell_stream.h"
+
+#include <algorithm>
+
+namespace mavsdk {
+
+void ShellStream::write(const std::string& data, TimePoint now)
+{
+    size_t pos = 0;
+
+    // Small writes are merged into the chunk still waiting.
+    if (!_chunks.empty() && _chunks.back().size() < max_chunk_len) {
+        const size_t len = std::min(max_chunk_len - _chunks.back().size(), data.size());
+        _chunks.back().append(data, 0, len);
+        pos = len;
+    }
+
+    while (pos < data.size()) {
+        const size_t len = std::min(max_chunk_len, data.size() - pos);
+        _chunks.push_back(data.substr(pos, len));
+        pos += len;
+    }
+    _queued_bytes += data.size();
+
+    _active = true;
+    _last_activity = now;
+    _poll_interval_s = min_poll_interval_s;
+}
+
+std::deque<std::string> ShellStream::take_chunks(TimePoint now)
+{
+    std::deque<std::string> chunks;
+    while (!_chunks.empty() && chunks.size() < send_window) {
+        _queued_bytes -= _chunks.front().size();
+        chunks.push_back(std::move(_chunks.front()));
+        _chunks.pop_front();
+    }
+
+    if (!chunks.empty()) {
+        _last_poll = now;
+    }
+    return chunks;
+}
+
+bool ShellStream::should_poll(TimePoint now)
+{
+    if (!_active) {
+        return false;
+    }
+
+    if (now - _last_activity > to_duration(idle_timeout_s)) {
+        _active = false;
+        return false;
+    }
+
+    if (now - _last_poll < to_duration(_poll_interval_s)) {
+        return false;
+    }
+
+    // As long as there is output, we ask for more right away, otherwise we
+    // back off.
+    if (_output_since_poll) {
+        _poll_interval_s = min_poll_interval_s;
+    } else {
+        _poll_interval_s = std::min(_poll_interval_s * 2.0, max_poll_interval_s);
+    }
+    _output_since_poll = false;
+    _last_poll = now;
+    return true;
+}
+
+void ShellStream::add_output(const char* data, size_t len, TimePoint now)
+{
+    if (len == 0) {
+        return;
+    }
+
+    if (_output.empty()) {
+        _first_output = now;
+    }
+    _output.append(data, len);
+
+    _output_since_poll = true;
+    _active = true;
+    _last_activity = now;
+}
+
+bool ShellStream::take_output(TimePoint now, std::string& output)
+{
+    if (_output.empty()) {
+        return false;
+    }
+
+    if (_output.size() < max_output_len && now - _first_output < to_duration(output_coalesce_s)) {
+        return false;
+    }
+
+    output = std::move(_output);
+    _output.clear();
+    return true;
+}
+
+bool ShellStream::is_idle(TimePoint now) const
+{
+    return _chunks.empty() && _output.empty() &&
+           (!_active || now - _last_activity > to_duration(idle_timeout_s));
+}
+
+std::chrono::steady_clock::duration ShellStream::to_duration(double seconds)
+{
+    return std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(seconds));
+}
+
+} // namespace mavsdk
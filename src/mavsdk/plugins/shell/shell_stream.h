@@ -0,0 +1,78 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <string>
+
+namespace mavsdk {
+
+// Keeps track of a byte stream to and from the shell over SERIAL_CONTROL.
+//
+// Input is cut into chunks of one message each, of which only a window is
+// sent per tick, so a big script doesn't flood the link or the shell.
+//
+// Some autopilots only send output in reply to a request, so the shell is
+// polled, quickly while output keeps coming and less and less often once it
+// doesn't, until it is idle for a while and polling stops.
+//
+// Output is collected and handed on in bigger chunks rather than per
+// message, once enough is there or it has waited for long enough.
+//
+// Not thread-safe, the caller needs to lock.
+class ShellStream {
+public:
+    using TimePoint = std::chrono::steady_clock::time_point;
+
+    // MAVLINK_MSG_SERIAL_CONTROL_FIELD_DATA_LEN
+    static constexpr size_t max_chunk_len = 70;
+    static constexpr size_t send_window = 4;
+    static constexpr double min_poll_interval_s = 0.02;
+    static constexpr double max_poll_interval_s = 0.32;
+    static constexpr double idle_timeout_s = 2.0;
+    static constexpr size_t max_output_len = 4096;
+    static constexpr double output_coalesce_s = 0.05;
+
+    ShellStream() = default;
+    ~ShellStream() = default;
+
+    // Non-copyable
+    ShellStream(const ShellStream&) = delete;
+    const ShellStream& operator=(const ShellStream&) = delete;
+
+    void write(const std::string& data, TimePoint now);
+
+    // The chunks to send now, at most a window of them.
+    [[nodiscard]] std::deque<std::string> take_chunks(TimePoint now);
+    [[nodiscard]] size_t queued_bytes() const { return _queued_bytes; }
+
+    // Whether to send an empty request for output now. Sending a chunk counts
+    // as a request as well.
+    [[nodiscard]] bool should_poll(TimePoint now);
+
+    void add_output(const char* data, size_t len, TimePoint now);
+
+    // The output collected, if it is time to hand it on.
+    [[nodiscard]] bool take_output(TimePoint now, std::string& output);
+
+    // Once nothing is queued or polled for, there is no need for ticks.
+    [[nodiscard]] bool is_idle(TimePoint now) const;
+
+private:
+    static std::chrono::steady_clock::duration to_duration(double seconds);
+
+    std::deque<std::string> _chunks{};
+    size_t _queued_bytes{0};
+
+    // Polling is active until this long after the last input or output.
+    TimePoint _last_activity{};
+    bool _active{false};
+    TimePoint _last_poll{};
+    double _poll_interval_s{min_poll_interval_s};
+    bool _output_since_poll{false};
+
+    std::string _output{};
+    TimePoint _first_output{};
+};
+
+} // namespace mavsdk
@@ -0,0 +1,134 @@
+#include "shell_stream.h"
+
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+using namespace mavsdk;
+
+namespace {
+
+ShellStream::TimePoint at_ms(int ms)
+{
+    return ShellStream::TimePoint{} + std::chrono::hours(1) + std::chrono::milliseconds(ms);
+}
+
+} // namespace
+
+TEST(ShellStream, CutsInputIntoChunks)
+{
+    ShellStream stream;
+    stream.write(std::string(150, 'a'), at_ms(0));
+    EXPECT_EQ(stream.queued_bytes(), 150u);
+
+    const auto chunks = stream.take_chunks(at_ms(0));
+    ASSERT_EQ(chunks.size(), 3u);
+    EXPECT_EQ(chunks[0].size(), ShellStream::max_chunk_len);
+    EXPECT_EQ(chunks[1].size(), ShellStream::max_chunk_len);
+    EXPECT_EQ(chunks[2].size(), 10u);
+    EXPECT_EQ(stream.queued_bytes(), 0u);
+}
+
+TEST(ShellStream, MergesSmallWrites)
+{
+    ShellStream stream;
+    stream.write("ls", at_ms(0));
+    stream.write(" -l\n", at_ms(0));
+
+    const auto chunks = stream.take_chunks(at_ms(0));
+    ASSERT_EQ(chunks.size(), 1u);
+    EXPECT_EQ(chunks[0], "ls -l\n");
+}
+
+TEST(ShellStream, SendsOneWindowAtATime)
+{
+    ShellStream stream;
+    stream.write(std::string(ShellStream::max_chunk_len * 10, 'a'), at_ms(0));
+
+    EXPECT_EQ(stream.take_chunks(at_ms(0)).size(), ShellStream::send_window);
+    EXPECT_EQ(stream.take_chunks(at_ms(10)).size(), ShellStream::send_window);
+    EXPECT_EQ(stream.take_chunks(at_ms(20)).size(), 2u);
+    EXPECT_TRUE(stream.take_chunks(at_ms(30)).empty());
+}
+
+TEST(ShellStream, DoesNotPollWhenIdle)
+{
+    ShellStream stream;
+    EXPECT_FALSE(stream.should_poll(at_ms(0)));
+    EXPECT_TRUE(stream.is_idle(at_ms(0)));
+}
+
+TEST(ShellStream, PollsQuicklyWhileOutputComes)
+{
+    ShellStream stream;
+    stream.write("dmesg\n", at_ms(0));
+    (void)stream.take_chunks(at_ms(0));
+
+    // Sending the chunk was a request already.
+    EXPECT_FALSE(stream.should_poll(at_ms(10)));
+
+    int num_polls = 0;
+    for (int ms = 20; ms <= 1000; ms += 10) {
+        stream.add_output("x", 1, at_ms(ms));
+        if (stream.should_poll(at_ms(ms))) {
+            ++num_polls;
+        }
+    }
+    // Every 20 ms.
+    EXPECT_EQ(num_polls, 50);
+}
+
+TEST(ShellStream, BacksOffAndStopsWithoutOutput)
+{
+    ShellStream stream;
+    stream.write("reboot\n", at_ms(0));
+    (void)stream.take_chunks(at_ms(0));
+
+    std::vector<int> polls;
+    for (int ms = 0; ms <= 5000; ms += 10) {
+        if (stream.should_poll(at_ms(ms))) {
+            polls.push_back(ms);
+        }
+    }
+
+    ASSERT_GE(polls.size(), 5u);
+    EXPECT_EQ(polls[0], 20);
+    EXPECT_EQ(polls[1], 60);
+    EXPECT_EQ(polls[2], 140);
+    EXPECT_EQ(polls[3], 300);
+    EXPECT_EQ(polls[4], 620);
+    // Nothing after the idle timeout.
+    EXPECT_LE(polls.back(), 2000);
+    EXPECT_TRUE(stream.is_idle(at_ms(5000)));
+}
+
+TEST(ShellStream, CoalescesOutput)
+{
+    ShellStream stream;
+    std::string output;
+
+    stream.add_output("abc", 3, at_ms(0));
+    stream.add_output("def", 3, at_ms(10));
+    EXPECT_FALSE(stream.take_output(at_ms(20), output));
+
+    EXPECT_TRUE(stream.take_output(at_ms(50), output));
+    EXPECT_EQ(output, "abcdef");
+    EXPECT_FALSE(stream.take_output(at_ms(100), output));
+}
+
+TEST(ShellStream, HandsOnFullOutputRightAway)
+{
+    ShellStream stream;
+    std::string output;
+
+    const std::string data(ShellStream::max_chunk_len, 'x');
+    size_t added = 0;
+    while (added < ShellStream::max_output_len) {
+        EXPECT_FALSE(stream.take_output(at_ms(0), output));
+        stream.add_output(data.data(), data.size(), at_ms(0));
+        added += data.size();
+    }
+
+    EXPECT_TRUE(stream.take_output(at_ms(0), output));
+    EXPECT_EQ(output.size(), added);
+}
@@ -15,6 +15,7 @@
 
 #include "plugin_base.h"
 
+#include "awaitable.h"
 #include "handle.h"
 
 namespace mavsdk {
@@ -1950,7 +1951,24 @@ public:
      *
      * This function is non-blocking. See 'set_rate_position' for the blocking counterpart.
      */
-    void set_rate_position_async(double rate_hz, const ResultCallback callback);
+    void set_rate_position_async(double rate_hz, const ResultCallback& callback);
+
+#ifdef MAVSDK_HAS_COROUTINES
+    /**
+     * @brief Awaitable version of 'set_rate_position_async' for C++20 coroutines.
+     *
+     * The coroutine is resumed using the executor if one is given, otherwise on the callback
+     * thread.
+     */
+    Awaitable<ResultCallback> set_rate_position_awaitable(double rate_hz, Executor executor = {})
+    {
+        return Awaitable<ResultCallback>(
+            [=, this](const ResultCallback& callback) {
+                set_rate_position_async(rate_hz, callback);
+            },
+            std::move(executor));
+    }
+#endif
 
     /**
      * @brief Set rate to 'position' updates.
@@ -1966,7 +1984,24 @@ public:
      *
      * This function is non-blocking. See 'set_rate_home' for the blocking counterpart.
      */
-    void set_rate_home_async(double rate_hz, const ResultCallback callback);
+    void set_rate_home_async(double rate_hz, const ResultCallback& callback);
+
+#ifdef MAVSDK_HAS_COROUTINES
+    /**
+     * @brief Awaitable version of 'set_rate_home_async' for C++20 coroutines.
+     *
+     * The coroutine is resumed using the executor if one is given, otherwise on the callback
+     * thread.
+     */
+    Awaitable<ResultCallback> set_rate_home_awaitable(double rate_hz, Executor executor = {})
+    {
+        return Awaitable<ResultCallback>(
+            [=, this](const ResultCallback& callback) {
+                set_rate_home_async(rate_hz, callback);
+            },
+            std::move(executor));
+    }
+#endif
 
     /**
      * @brief Set rate to 'home position' updates.
@@ -1982,7 +2017,24 @@ public:
      *
      * This function is non-blocking. See 'set_rate_in_air' for the blocking counterpart.
      */
-    void set_rate_in_air_async(double rate_hz, const ResultCallback callback);
+    void set_rate_in_air_async(double rate_hz, const ResultCallback& callback);
+
+#ifdef MAVSDK_HAS_COROUTINES
+    /**
+     * @brief Awaitable version of 'set_rate_in_air_async' for C++20 coroutines.
+     *
+     * The coroutine is resumed using the executor if one is given, otherwise on the callback
+     * thread.
+     */
+    Awaitable<ResultCallback> set_rate_in_air_awaitable(double rate_hz, Executor executor = {})
+    {
+        return Awaitable<ResultCallback>(
+            [=, this](const ResultCallback& callback) {
+                set_rate_in_air_async(rate_hz, callback);
+            },
+            std::move(executor));
+    }
+#endif
 
     /**
      * @brief Set rate to in-air updates.
@@ -1998,7 +2050,25 @@ public:
      *
      * This function is non-blocking. See 'set_rate_landed_state' for the blocking counterpart.
      */
-    void set_rate_landed_state_async(double rate_hz, const ResultCallback callback);
+    void set_rate_landed_state_async(double rate_hz, const ResultCallback& callback);
+
+#ifdef MAVSDK_HAS_COROUTINES
+    /**
+     * @brief Awaitable version of 'set_rate_landed_state_async' for C++20 coroutines.
+     *
+     * The coroutine is resumed using the executor if one is given, otherwise on the callback
+     * thread.
+     */
+    Awaitable<ResultCallback> set_rate_landed_state_awaitable(
+        double rate_hz, Executor executor = {})
+    {
+        return Awaitable<ResultCallback>(
+            [=, this](const ResultCallback& callback) {
+                set_rate_landed_state_async(rate_hz, callback);
+            },
+            std::move(executor));
+    }
+#endif
 
     /**
      * @brief Set rate to landed state updates
@@ -2015,7 +2085,24 @@ public:
      *
      * This function is non-blocking. See 'set_rate_vtol_state' for the blocking counterpart.
      */
-    void set_rate_vtol_state_async(double rate_hz, const ResultCallback callback);
+    void set_rate_vtol_state_async(double rate_hz, const ResultCallback& callback);
+
+#ifdef MAVSDK_HAS_COROUTINES
+    /**
+     * @brief Awaitable version of 'set_rate_vtol_state_async' for C++20 coroutines.
+     *
+     * The coroutine is resumed using the executor if one is given, otherwise on the callback
+     * thread.
+     */
+    Awaitable<ResultCallback> set_rate_vtol_state_awaitable(double rate_hz, Executor executor = {})
+    {
+        return Awaitable<ResultCallback>(
+            [=, this](const ResultCallback& callback) {
+                set_rate_vtol_state_async(rate_hz, callback);
+            },
+            std::move(executor));
+    }
+#endif
 
     /**
      * @brief Set rate to VTOL state updates
@@ -2032,7 +2119,25 @@ public:
      * This function is non-blocking. See 'set_rate_attitude_quaternion' for the blocking
      * counterpart.
      */
-    void set_rate_attitude_quaternion_async(double rate_hz, const ResultCallback callback);
+    void set_rate_attitude_quaternion_async(double rate_hz, const ResultCallback& callback);
+
+#ifdef MAVSDK_HAS_COROUTINES
+    /**
+     * @brief Awaitable version of 'set_rate_attitude_quaternion_async' for C++20 coroutines.
+     *
+     * The coroutine is resumed using the executor if one is given, otherwise on the callback
+     * thread.
+     */
+    Awaitable<ResultCallback> set_rate_attitude_quaternion_awaitable(
+        double rate_hz, Executor executor = {})
+    {
+        return Awaitable<ResultCallback>(
+            [=, this](const ResultCallback& callback) {
+                set_rate_attitude_quaternion_async(rate_hz, callback);
+            },
+            std::move(executor));
+    }
+#endif
 
     /**
      * @brief Set rate to 'attitude euler angle' updates.
@@ -2049,7 +2154,25 @@ public:
      *
      * This function is non-blocking. See 'set_rate_attitude_euler' for the blocking counterpart.
      */
-    void set_rate_attitude_euler_async(double rate_hz, const ResultCallback callback);
+    void set_rate_attitude_euler_async(double rate_hz, const ResultCallback& callback);
+
+#ifdef MAVSDK_HAS_COROUTINES
+    /**
+     * @brief Awaitable version of 'set_rate_attitude_euler_async' for C++20 coroutines.
+     *
+     * The coroutine is resumed using the executor if one is given, otherwise on the callback
+     * thread.
+     */
+    Awaitable<ResultCallback> set_rate_attitude_euler_awaitable(
+        double rate_hz, Executor executor = {})
+    {
+        return Awaitable<ResultCallback>(
+            [=, this](const ResultCallback& callback) {
+                set_rate_attitude_euler_async(rate_hz, callback);
+            },
+            std::move(executor));
+    }
+#endif
 
     /**
      * @brief Set rate to 'attitude quaternion' updates.
@@ -2066,7 +2189,25 @@ public:
      *
      * This function is non-blocking. See 'set_rate_camera_attitude' for the blocking counterpart.
      */
-    void set_rate_camera_attitude_async(double rate_hz, const ResultCallback callback);
+    void set_rate_camera_attitude_async(double rate_hz, const ResultCallback& callback);
+
+#ifdef MAVSDK_HAS_COROUTINES
+    /**
+     * @brief Awaitable version of 'set_rate_camera_attitude_async' for C++20 coroutines.
+     *
+     * The coroutine is resumed using the executor if one is given, otherwise on the callback
+     * thread.
+     */
+    Awaitable<ResultCallback> set_rate_camera_attitude_awaitable(
+        double rate_hz, Executor executor = {})
+    {
+        return Awaitable<ResultCallback>(
+            [=, this](const ResultCallback& callback) {
+                set_rate_camera_attitude_async(rate_hz, callback);
+            },
+            std::move(executor));
+    }
+#endif
 
     /**
      * @brief Set rate of camera attitude updates.
@@ -2083,7 +2224,25 @@ public:
      *
      * This function is non-blocking. See 'set_rate_velocity_ned' for the blocking counterpart.
      */
-    void set_rate_velocity_ned_async(double rate_hz, const ResultCallback callback);
+    void set_rate_velocity_ned_async(double rate_hz, const ResultCallback& callback);
+
+#ifdef MAVSDK_HAS_COROUTINES
+    /**
+     * @brief Awaitable version of 'set_rate_velocity_ned_async' for C++20 coroutines.
+     *
+     * The coroutine is resumed using the executor if one is given, otherwise on the callback
+     * thread.
+     */
+    Awaitable<ResultCallback> set_rate_velocity_ned_awaitable(
+        double rate_hz, Executor executor = {})
+    {
+        return Awaitable<ResultCallback>(
+            [=, this](const ResultCallback& callback) {
+                set_rate_velocity_ned_async(rate_hz, callback);
+            },
+            std::move(executor));
+    }
+#endif
 
     /**
      * @brief Set rate to 'ground speed' updates (NED).
@@ -2100,7 +2259,24 @@ public:
      *
      * This function is non-blocking. See 'set_rate_gps_info' for the blocking counterpart.
      */
-    void set_rate_gps_info_async(double rate_hz, const ResultCallback callback);
+    void set_rate_gps_info_async(double rate_hz, const ResultCallback& callback);
+
+#ifdef MAVSDK_HAS_COROUTINES
+    /**
+     * @brief Awaitable version of 'set_rate_gps_info_async' for C++20 coroutines.
+     *
+     * The coroutine is resumed using the executor if one is given, otherwise on the callback
+     * thread.
+     */
+    Awaitable<ResultCallback> set_rate_gps_info_awaitable(double rate_hz, Executor executor = {})
+    {
+        return Awaitable<ResultCallback>(
+            [=, this](const ResultCallback& callback) {
+                set_rate_gps_info_async(rate_hz, callback);
+            },
+            std::move(executor));
+    }
+#endif
 
     /**
      * @brief Set rate to 'GPS info' updates.
@@ -2116,7 +2292,24 @@ public:
      *
      * This function is non-blocking. See 'set_rate_battery' for the blocking counterpart.
      */
-    void set_rate_battery_async(double rate_hz, const ResultCallback callback);
+    void set_rate_battery_async(double rate_hz, const ResultCallback& callback);
+
+#ifdef MAVSDK_HAS_COROUTINES
+    /**
+     * @brief Awaitable version of 'set_rate_battery_async' for C++20 coroutines.
+     *
+     * The coroutine is resumed using the executor if one is given, otherwise on the callback
+     * thread.
+     */
+    Awaitable<ResultCallback> set_rate_battery_awaitable(double rate_hz, Executor executor = {})
+    {
+        return Awaitable<ResultCallback>(
+            [=, this](const ResultCallback& callback) {
+                set_rate_battery_async(rate_hz, callback);
+            },
+            std::move(executor));
+    }
+#endif
 
     /**
      * @brief Set rate to 'battery' updates.
@@ -2132,7 +2325,24 @@ public:
      *
      * This function is non-blocking. See 'set_rate_rc_status' for the blocking counterpart.
      */
-    void set_rate_rc_status_async(double rate_hz, const ResultCallback callback);
+    void set_rate_rc_status_async(double rate_hz, const ResultCallback& callback);
+
+#ifdef MAVSDK_HAS_COROUTINES
+    /**
+     * @brief Awaitable version of 'set_rate_rc_status_async' for C++20 coroutines.
+     *
+     * The coroutine is resumed using the executor if one is given, otherwise on the callback
+     * thread.
+     */
+    Awaitable<ResultCallback> set_rate_rc_status_awaitable(double rate_hz, Executor executor = {})
+    {
+        return Awaitable<ResultCallback>(
+            [=, this](const ResultCallback& callback) {
+                set_rate_rc_status_async(rate_hz, callback);
+            },
+            std::move(executor));
+    }
+#endif
 
     /**
      * @brief Set rate to 'RC status' updates.
@@ -2149,7 +2359,25 @@ public:
      * This function is non-blocking. See 'set_rate_actuator_control_target' for the blocking
      * counterpart.
      */
-    void set_rate_actuator_control_target_async(double rate_hz, const ResultCallback callback);
+    void set_rate_actuator_control_target_async(double rate_hz, const ResultCallback& callback);
+
+#ifdef MAVSDK_HAS_COROUTINES
+    /**
+     * @brief Awaitable version of 'set_rate_actuator_control_target_async' for C++20 coroutines.
+     *
+     * The coroutine is resumed using the executor if one is given, otherwise on the callback
+     * thread.
+     */
+    Awaitable<ResultCallback> set_rate_actuator_control_target_awaitable(
+        double rate_hz, Executor executor = {})
+    {
+        return Awaitable<ResultCallback>(
+            [=, this](const ResultCallback& callback) {
+                set_rate_actuator_control_target_async(rate_hz, callback);
+            },
+            std::move(executor));
+    }
+#endif
 
     /**
      * @brief Set rate to 'actuator control target' updates.
@@ -2167,7 +2395,25 @@ public:
      * This function is non-blocking. See 'set_rate_actuator_output_status' for the blocking
      * counterpart.
      */
-    void set_rate_actuator_output_status_async(double rate_hz, const ResultCallback callback);
+    void set_rate_actuator_output_status_async(double rate_hz, const ResultCallback& callback);
+
+#ifdef MAVSDK_HAS_COROUTINES
+    /**
+     * @brief Awaitable version of 'set_rate_actuator_output_status_async' for C++20 coroutines.
+     *
+     * The coroutine is resumed using the executor if one is given, otherwise on the callback
+     * thread.
+     */
+    Awaitable<ResultCallback> set_rate_actuator_output_status_awaitable(
+        double rate_hz, Executor executor = {})
+    {
+        return Awaitable<ResultCallback>(
+            [=, this](const ResultCallback& callback) {
+                set_rate_actuator_output_status_async(rate_hz, callback);
+            },
+            std::move(executor));
+    }
+#endif
 
     /**
      * @brief Set rate to 'actuator output status' updates.
@@ -2184,7 +2430,24 @@ public:
      *
      * This function is non-blocking. See 'set_rate_odometry' for the blocking counterpart.
      */
-    void set_rate_odometry_async(double rate_hz, const ResultCallback callback);
+    void set_rate_odometry_async(double rate_hz, const ResultCallback& callback);
+
+#ifdef MAVSDK_HAS_COROUTINES
+    /**
+     * @brief Awaitable version of 'set_rate_odometry_async' for C++20 coroutines.
+     *
+     * The coroutine is resumed using the executor if one is given, otherwise on the callback
+     * thread.
+     */
+    Awaitable<ResultCallback> set_rate_odometry_awaitable(double rate_hz, Executor executor = {})
+    {
+        return Awaitable<ResultCallback>(
+            [=, this](const ResultCallback& callback) {
+                set_rate_odometry_async(rate_hz, callback);
+            },
+            std::move(executor));
+    }
+#endif
 
     /**
      * @brief Set rate to 'odometry' updates.
@@ -2201,7 +2464,25 @@ public:
      * This function is non-blocking. See 'set_rate_position_velocity_ned' for the blocking
      * counterpart.
      */
-    void set_rate_position_velocity_ned_async(double rate_hz, const ResultCallback callback);
+    void set_rate_position_velocity_ned_async(double rate_hz, const ResultCallback& callback);
+
+#ifdef MAVSDK_HAS_COROUTINES
+    /**
+     * @brief Awaitable version of 'set_rate_position_velocity_ned_async' for C++20 coroutines.
+     *
+     * The coroutine is resumed using the executor if one is given, otherwise on the callback
+     * thread.
+     */
+    Awaitable<ResultCallback> set_rate_position_velocity_ned_awaitable(
+        double rate_hz, Executor executor = {})
+    {
+        return Awaitable<ResultCallback>(
+            [=, this](const ResultCallback& callback) {
+                set_rate_position_velocity_ned_async(rate_hz, callback);
+            },
+            std::move(executor));
+    }
+#endif
 
     /**
      * @brief Set rate to 'position velocity' updates.
@@ -2218,7 +2499,25 @@ public:
      *
      * This function is non-blocking. See 'set_rate_ground_truth' for the blocking counterpart.
      */
-    void set_rate_ground_truth_async(double rate_hz, const ResultCallback callback);
+    void set_rate_ground_truth_async(double rate_hz, const ResultCallback& callback);
+
+#ifdef MAVSDK_HAS_COROUTINES
+    /**
+     * @brief Awaitable version of 'set_rate_ground_truth_async' for C++20 coroutines.
+     *
+     * The coroutine is resumed using the executor if one is given, otherwise on the callback
+     * thread.
+     */
+    Awaitable<ResultCallback> set_rate_ground_truth_awaitable(
+        double rate_hz, Executor executor = {})
+    {
+        return Awaitable<ResultCallback>(
+            [=, this](const ResultCallback& callback) {
+                set_rate_ground_truth_async(rate_hz, callback);
+            },
+            std::move(executor));
+    }
+#endif
 
     /**
      * @brief Set rate to 'ground truth' updates.
@@ -2235,7 +2534,25 @@ public:
      *
      * This function is non-blocking. See 'set_rate_fixedwing_metrics' for the blocking counterpart.
      */
-    void set_rate_fixedwing_metrics_async(double rate_hz, const ResultCallback callback);
+    void set_rate_fixedwing_metrics_async(double rate_hz, const ResultCallback& callback);
+
+#ifdef MAVSDK_HAS_COROUTINES
+    /**
+     * @brief Awaitable version of 'set_rate_fixedwing_metrics_async' for C++20 coroutines.
+     *
+     * The coroutine is resumed using the executor if one is given, otherwise on the callback
+     * thread.
+     */
+    Awaitable<ResultCallback> set_rate_fixedwing_metrics_awaitable(
+        double rate_hz, Executor executor = {})
+    {
+        return Awaitable<ResultCallback>(
+            [=, this](const ResultCallback& callback) {
+                set_rate_fixedwing_metrics_async(rate_hz, callback);
+            },
+            std::move(executor));
+    }
+#endif
 
     /**
      * @brief Set rate to 'fixedwing metrics' updates.
@@ -2252,7 +2569,24 @@ public:
      *
      * This function is non-blocking. See 'set_rate_imu' for the blocking counterpart.
      */
-    void set_rate_imu_async(double rate_hz, const ResultCallback callback);
+    void set_rate_imu_async(double rate_hz, const ResultCallback& callback);
+
+#ifdef MAVSDK_HAS_COROUTINES
+    /**
+     * @brief Awaitable version of 'set_rate_imu_async' for C++20 coroutines.
+     *
+     * The coroutine is resumed using the executor if one is given, otherwise on the callback
+     * thread.
+     */
+    Awaitable<ResultCallback> set_rate_imu_awaitable(double rate_hz, Executor executor = {})
+    {
+        return Awaitable<ResultCallback>(
+            [=, this](const ResultCallback& callback) {
+                set_rate_imu_async(rate_hz, callback);
+            },
+            std::move(executor));
+    }
+#endif
 
     /**
      * @brief Set rate to 'IMU' updates.
@@ -2268,7 +2602,24 @@ public:
      *
      * This function is non-blocking. See 'set_rate_scaled_imu' for the blocking counterpart.
      */
-    void set_rate_scaled_imu_async(double rate_hz, const ResultCallback callback);
+    void set_rate_scaled_imu_async(double rate_hz, const ResultCallback& callback);
+
+#ifdef MAVSDK_HAS_COROUTINES
+    /**
+     * @brief Awaitable version of 'set_rate_scaled_imu_async' for C++20 coroutines.
+     *
+     * The coroutine is resumed using the executor if one is given, otherwise on the callback
+     * thread.
+     */
+    Awaitable<ResultCallback> set_rate_scaled_imu_awaitable(double rate_hz, Executor executor = {})
+    {
+        return Awaitable<ResultCallback>(
+            [=, this](const ResultCallback& callback) {
+                set_rate_scaled_imu_async(rate_hz, callback);
+            },
+            std::move(executor));
+    }
+#endif
 
     /**
      * @brief Set rate to 'Scaled IMU' updates.
@@ -2284,7 +2635,24 @@ public:
      *
      * This function is non-blocking. See 'set_rate_raw_imu' for the blocking counterpart.
      */
-    void set_rate_raw_imu_async(double rate_hz, const ResultCallback callback);
+    void set_rate_raw_imu_async(double rate_hz, const ResultCallback& callback);
+
+#ifdef MAVSDK_HAS_COROUTINES
+    /**
+     * @brief Awaitable version of 'set_rate_raw_imu_async' for C++20 coroutines.
+     *
+     * The coroutine is resumed using the executor if one is given, otherwise on the callback
+     * thread.
+     */
+    Awaitable<ResultCallback> set_rate_raw_imu_awaitable(double rate_hz, Executor executor = {})
+    {
+        return Awaitable<ResultCallback>(
+            [=, this](const ResultCallback& callback) {
+                set_rate_raw_imu_async(rate_hz, callback);
+            },
+            std::move(executor));
+    }
+#endif
 
     /**
      * @brief Set rate to 'Raw IMU' updates.
@@ -2300,7 +2668,25 @@ public:
      *
      * This function is non-blocking. See 'set_rate_unix_epoch_time' for the blocking counterpart.
      */
-    void set_rate_unix_epoch_time_async(double rate_hz, const ResultCallback callback);
+    void set_rate_unix_epoch_time_async(double rate_hz, const ResultCallback& callback);
+
+#ifdef MAVSDK_HAS_COROUTINES
+    /**
+     * @brief Awaitable version of 'set_rate_unix_epoch_time_async' for C++20 coroutines.
+     *
+     * The coroutine is resumed using the executor if one is given, otherwise on the callback
+     * thread.
+     */
+    Awaitable<ResultCallback> set_rate_unix_epoch_time_awaitable(
+        double rate_hz, Executor executor = {})
+    {
+        return Awaitable<ResultCallback>(
+            [=, this](const ResultCallback& callback) {
+                set_rate_unix_epoch_time_async(rate_hz, callback);
+            },
+            std::move(executor));
+    }
+#endif
 
     /**
      * @brief Set rate to 'unix epoch time' updates.
@@ -2317,7 +2703,25 @@ public:
      *
      * This function is non-blocking. See 'set_rate_distance_sensor' for the blocking counterpart.
      */
-    void set_rate_distance_sensor_async(double rate_hz, const ResultCallback callback);
+    void set_rate_distance_sensor_async(double rate_hz, const ResultCallback& callback);
+
+#ifdef MAVSDK_HAS_COROUTINES
+    /**
+     * @brief Awaitable version of 'set_rate_distance_sensor_async' for C++20 coroutines.
+     *
+     * The coroutine is resumed using the executor if one is given, otherwise on the callback
+     * thread.
+     */
+    Awaitable<ResultCallback> set_rate_distance_sensor_awaitable(
+        double rate_hz, Executor executor = {})
+    {
+        return Awaitable<ResultCallback>(
+            [=, this](const ResultCallback& callback) {
+                set_rate_distance_sensor_async(rate_hz, callback);
+            },
+            std::move(executor));
+    }
+#endif
 
     /**
      * @brief Set rate to 'Distance Sensor' updates.
@@ -2334,7 +2738,24 @@ public:
      *
      * This function is non-blocking. See 'set_rate_altitude' for the blocking counterpart.
      */
-    void set_rate_altitude_async(double rate_hz, const ResultCallback callback);
+    void set_rate_altitude_async(double rate_hz, const ResultCallback& callback);
+
+#ifdef MAVSDK_HAS_COROUTINES
+    /**
+     * @brief Awaitable version of 'set_rate_altitude_async' for C++20 coroutines.
+     *
+     * The coroutine is resumed using the executor if one is given, otherwise on the callback
+     * thread.
+     */
+    Awaitable<ResultCallback> set_rate_altitude_awaitable(double rate_hz, Executor executor = {})
+    {
+        return Awaitable<ResultCallback>(
+            [=, this](const ResultCallback& callback) {
+                set_rate_altitude_async(rate_hz, callback);
+            },
+            std::move(executor));
+    }
+#endif
 
     /**
      * @brief Set rate to 'Altitude' updates.
@@ -2355,7 +2776,24 @@ public:
      *
      * This function is non-blocking. See 'get_gps_global_origin' for the blocking counterpart.
      */
-    void get_gps_global_origin_async(const GetGpsGlobalOriginCallback callback);
+    void get_gps_global_origin_async(const GetGpsGlobalOriginCallback& callback);
+
+#ifdef MAVSDK_HAS_COROUTINES
+    /**
+     * @brief Awaitable version of 'get_gps_global_origin_async' for C++20 coroutines.
+     *
+     * The coroutine is resumed using the executor if one is given, otherwise on the callback
+     * thread.
+     */
+    Awaitable<GetGpsGlobalOriginCallback> get_gps_global_origin_awaitable(Executor executor = {})
+    {
+        return Awaitable<GetGpsGlobalOriginCallback>(
+            [=, this](const GetGpsGlobalOriginCallback& callback) {
+                get_gps_global_origin_async(callback);
+            },
+            std::move(executor));
+    }
+#endif
 
     /**
      * @brief Get the GPS location of where the estimator has been initialized.
@@ -2380,6 +2818,9 @@ public:
 private:
     /** @private Underlying implementation, set at instantiation */
     std::unique_ptr<TelemetryImpl> _impl;
+
+    /** @private Hand-written additions in telemetry_ext.h, if any */
+    friend class TelemetryExt;
 };
 
 } // namespace mavsdk
\ No newline at end of file
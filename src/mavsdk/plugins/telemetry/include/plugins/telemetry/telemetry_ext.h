@@ -0,0 +1,401 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "plugins/telemetry/telemetry.h"
+
+namespace mavsdk {
+
+class TelemetryImpl;
+
+/**
+ * @brief Additions to Telemetry that are only available in C++.
+ *
+ * Unlike telemetry.h, this header is not generated from the proto files,
+ * so the calls here are not available through mavsdk_server.
+ *
+ * It works on the Telemetry plugin it is created with, which has to outlive it:
+ *
+ *     ```cpp
+ *     auto telemetry = Telemetry(system);
+ *     auto telemetry_ext = TelemetryExt(telemetry);
+ *     ```
+ */
+class TelemetryExt {
+public:
+    /**
+     * @brief Constructor. Uses the given Telemetry plugin.
+     *
+     * @param telemetry The plugin, which has to outlive this object.
+     */
+    explicit TelemetryExt(Telemetry& telemetry);
+
+    /**
+     * @brief Latest values of the fields most often fused together, read at once.
+     *
+     * Receive timestamps are in microseconds of the steady clock, and 0 if nothing
+     * has been received yet.
+     */
+    struct Snapshot {
+        Telemetry::Position position{}; /**< @brief Position */
+        uint64_t position_receive_timestamp_us{}; /**< @brief When the position was received */
+        Telemetry::VelocityNed velocity_ned{}; /**< @brief Velocity in NED coordinates */
+        uint64_t
+            velocity_ned_receive_timestamp_us{}; /**< @brief When the velocity was received */
+        Telemetry::Quaternion attitude_quaternion{}; /**< @brief Attitude as quaternion */
+        uint64_t attitude_quaternion_receive_timestamp_us{}; /**< @brief When the attitude was
+                                                                received */
+        Telemetry::Battery battery{}; /**< @brief Battery */
+        uint64_t battery_receive_timestamp_us{}; /**< @brief When the battery was received */
+        Telemetry::FlightMode flight_mode{}; /**< @brief Flight mode */
+        uint64_t flight_mode_receive_timestamp_us{}; /**< @brief When the flight mode was
+                                                        received */
+        Telemetry::Health health{}; /**< @brief Health */
+        uint64_t health_receive_timestamp_us{}; /**< @brief When the health was received */
+    };
+
+    /**
+     * @brief Equal operator to compare two `TelemetryExt::Snapshot` objects.
+     *
+     * @return `true` if items are equal.
+     */
+    friend bool operator==(const TelemetryExt::Snapshot& lhs, const TelemetryExt::Snapshot& rhs);
+
+    /**
+     * @brief Stream operator to print information about a `TelemetryExt::Snapshot`.
+     *
+     * @return A reference to the stream.
+     */
+    friend std::ostream& operator<<(std::ostream& str, TelemetryExt::Snapshot const& snapshot);
+
+    /**
+     * @brief Poll for position, velocity, attitude, battery, flight mode and health at once.
+     *
+     * Unlike calling the single getters one after another, all values are from
+     * the same point in time and no lock is taken.
+     *
+     * @return The latest values.
+     */
+    Snapshot snapshot() const;
+
+    /**
+     * @brief Subscribe to 'position' updates.
+     *
+     * The callback is called at most max_rate_hz times per second, with the latest update.
+     * Unsubscribe with Telemetry::unsubscribe_position.
+     */
+    Telemetry::PositionHandle
+    subscribe_position(const Telemetry::PositionCallback& callback, double max_rate_hz);
+
+    /**
+     * @brief Subscribe to 'attitude' updates (quaternion).
+     *
+     * The callback is called at most max_rate_hz times per second, with the latest update.
+     * Unsubscribe with Telemetry::unsubscribe_attitude_quaternion.
+     */
+    Telemetry::AttitudeQuaternionHandle subscribe_attitude_quaternion(
+        const Telemetry::AttitudeQuaternionCallback& callback, double max_rate_hz);
+
+    /**
+     * @brief Subscribe to 'attitude' updates (Euler).
+     *
+     * The callback is called at most max_rate_hz times per second, with the latest update.
+     * Unsubscribe with Telemetry::unsubscribe_attitude_euler.
+     */
+    Telemetry::AttitudeEulerHandle
+    subscribe_attitude_euler(const Telemetry::AttitudeEulerCallback& callback, double max_rate_hz);
+
+    /**
+     * @brief Subscribe to 'attitude' updates (angular velocity).
+     *
+     * The callback is called at most max_rate_hz times per second, with the latest update.
+     * Unsubscribe with Telemetry::unsubscribe_attitude_angular_velocity_body.
+     */
+    Telemetry::AttitudeAngularVelocityBodyHandle subscribe_attitude_angular_velocity_body(
+        const Telemetry::AttitudeAngularVelocityBodyCallback& callback, double max_rate_hz);
+
+    /**
+     * @brief Subscribe to 'ground speed' updates (NED).
+     *
+     * The callback is called at most max_rate_hz times per second, with the latest update.
+     * Unsubscribe with Telemetry::unsubscribe_velocity_ned.
+     */
+    Telemetry::VelocityNedHandle
+    subscribe_velocity_ned(const Telemetry::VelocityNedCallback& callback, double max_rate_hz);
+
+    /**
+     * @brief Subscribe to 'odometry' updates.
+     *
+     * The callback is called at most max_rate_hz times per second, with the latest update.
+     * Unsubscribe with Telemetry::unsubscribe_odometry.
+     */
+    Telemetry::OdometryHandle
+    subscribe_odometry(const Telemetry::OdometryCallback& callback, double max_rate_hz);
+
+    /**
+     * @brief Subscribe to 'position velocity' updates.
+     *
+     * The callback is called at most max_rate_hz times per second, with the latest update.
+     * Unsubscribe with Telemetry::unsubscribe_position_velocity_ned.
+     */
+    Telemetry::PositionVelocityNedHandle subscribe_position_velocity_ned(
+        const Telemetry::PositionVelocityNedCallback& callback, double max_rate_hz);
+
+    /**
+     * @brief Subscribe to 'ground truth' updates.
+     *
+     * The callback is called at most max_rate_hz times per second, with the latest update.
+     * Unsubscribe with Telemetry::unsubscribe_ground_truth.
+     */
+    Telemetry::GroundTruthHandle
+    subscribe_ground_truth(const Telemetry::GroundTruthCallback& callback, double max_rate_hz);
+
+    /**
+     * @brief Subscribe to 'fixedwing metrics' updates.
+     *
+     * The callback is called at most max_rate_hz times per second, with the latest update.
+     * Unsubscribe with Telemetry::unsubscribe_fixedwing_metrics.
+     */
+    Telemetry::FixedwingMetricsHandle subscribe_fixedwing_metrics(
+        const Telemetry::FixedwingMetricsCallback& callback, double max_rate_hz);
+
+    /**
+     * @brief Subscribe to 'IMU' updates (in SI units in NED body frame).
+     *
+     * The callback is called at most max_rate_hz times per second, with the latest update.
+     * Unsubscribe with Telemetry::unsubscribe_imu.
+     */
+    Telemetry::ImuHandle subscribe_imu(const Telemetry::ImuCallback& callback, double max_rate_hz);
+
+    /**
+     * @brief Subscribe to 'Scaled IMU' updates.
+     *
+     * The callback is called at most max_rate_hz times per second, with the latest update.
+     * Unsubscribe with Telemetry::unsubscribe_scaled_imu.
+     */
+    Telemetry::ScaledImuHandle
+    subscribe_scaled_imu(const Telemetry::ScaledImuCallback& callback, double max_rate_hz);
+
+    /**
+     * @brief Subscribe to 'Raw IMU' updates.
+     *
+     * The callback is called at most max_rate_hz times per second, with the latest update.
+     * Unsubscribe with Telemetry::unsubscribe_raw_imu.
+     */
+    Telemetry::RawImuHandle
+    subscribe_raw_imu(const Telemetry::RawImuCallback& callback, double max_rate_hz);
+
+    /**
+     * @brief Subscribe to 'Heading' updates.
+     *
+     * The callback is called at most max_rate_hz times per second, with the latest update.
+     * Unsubscribe with Telemetry::unsubscribe_heading.
+     */
+    Telemetry::HeadingHandle
+    subscribe_heading(const Telemetry::HeadingCallback& callback, double max_rate_hz);
+
+    /**
+     * @brief Subscribe to 'Altitude' updates.
+     *
+     * The callback is called at most max_rate_hz times per second, with the latest update.
+     * Unsubscribe with Telemetry::unsubscribe_altitude.
+     */
+    Telemetry::AltitudeHandle
+    subscribe_altitude(const Telemetry::AltitudeCallback& callback, double max_rate_hz);
+
+    /**
+     * @brief Position sample of the history, with the time it was received.
+     */
+    struct PositionSample {
+        Telemetry::Position position{}; /**< @brief Position */
+        uint64_t receive_timestamp_us{}; /**< @brief Receive time in microseconds of the steady
+                                            clock, as in Snapshot */
+        uint64_t autopilot_timestamp_us{}; /**< @brief Time since boot of the autopilot in
+                                              microseconds */
+    };
+
+    /**
+     * @brief Equal operator to compare two `TelemetryExt::PositionSample` objects.
+     *
+     * @return `true` if items are equal.
+     */
+    friend bool operator==(
+        const TelemetryExt::PositionSample& lhs, const TelemetryExt::PositionSample& rhs);
+
+    /**
+     * @brief Stream operator to print information about a `TelemetryExt::PositionSample`.
+     *
+     * @return A reference to the stream.
+     */
+    friend std::ostream&
+    operator<<(std::ostream& str, TelemetryExt::PositionSample const& position_sample);
+
+    /**
+     * @brief Velocity sample of the history, with the time it was received.
+     */
+    struct VelocityNedSample {
+        Telemetry::VelocityNed velocity_ned{}; /**< @brief Velocity in NED coordinates */
+        uint64_t receive_timestamp_us{}; /**< @brief Receive time in microseconds of the steady
+                                            clock, as in Snapshot */
+        uint64_t autopilot_timestamp_us{}; /**< @brief Time since boot of the autopilot in
+                                              microseconds */
+    };
+
+    /**
+     * @brief Equal operator to compare two `TelemetryExt::VelocityNedSample` objects.
+     *
+     * @return `true` if items are equal.
+     */
+    friend bool operator==(
+        const TelemetryExt::VelocityNedSample& lhs, const TelemetryExt::VelocityNedSample& rhs);
+
+    /**
+     * @brief Stream operator to print information about a `TelemetryExt::VelocityNedSample`.
+     *
+     * @return A reference to the stream.
+     */
+    friend std::ostream&
+    operator<<(std::ostream& str, TelemetryExt::VelocityNedSample const& velocity_ned_sample);
+
+    /**
+     * @brief Attitude sample of the history, with the time it was received.
+     */
+    struct AttitudeQuaternionSample {
+        Telemetry::Quaternion attitude_quaternion{}; /**< @brief Attitude as quaternion */
+        uint64_t receive_timestamp_us{}; /**< @brief Receive time in microseconds of the steady
+                                            clock, as in Snapshot */
+        uint64_t autopilot_timestamp_us{}; /**< @brief Time since boot of the autopilot in
+                                              microseconds */
+    };
+
+    /**
+     * @brief Equal operator to compare two `TelemetryExt::AttitudeQuaternionSample` objects.
+     *
+     * @return `true` if items are equal.
+     */
+    friend bool operator==(
+        const TelemetryExt::AttitudeQuaternionSample& lhs,
+        const TelemetryExt::AttitudeQuaternionSample& rhs);
+
+    /**
+     * @brief Stream operator to print information about a `TelemetryExt::AttitudeQuaternionSample`.
+     *
+     * @return A reference to the stream.
+     */
+    friend std::ostream& operator<<(
+        std::ostream& str,
+        TelemetryExt::AttitudeQuaternionSample const& attitude_quaternion_sample);
+
+    /**
+     * @brief Start or stop keeping a history of position, velocity and attitude.
+     *
+     * The history holds the last 512 samples of each, and is dropped when stopped.
+     */
+    void set_history_enabled(bool enabled) const;
+
+    /**
+     * @brief Poll for the 'position' samples received within a time window.
+     *
+     * @return The samples received from from_us to to_us, oldest first.
+     */
+    std::vector<PositionSample> position_history(uint64_t from_us, uint64_t to_us) const;
+
+    /**
+     * @brief Poll for the 'position' at a receive time, interpolated between samples.
+     *
+     * @return Nothing if the time is not within the history.
+     */
+    std::optional<Telemetry::Position> position_at(uint64_t receive_timestamp_us) const;
+
+    /**
+     * @brief Poll for the 'velocity_ned' samples received within a time window.
+     *
+     * @return The samples received from from_us to to_us, oldest first.
+     */
+    std::vector<VelocityNedSample> velocity_ned_history(uint64_t from_us, uint64_t to_us) const;
+
+    /**
+     * @brief Poll for the 'velocity_ned' at a receive time, interpolated between samples.
+     *
+     * @return Nothing if the time is not within the history.
+     */
+    std::optional<Telemetry::VelocityNed> velocity_ned_at(uint64_t receive_timestamp_us) const;
+
+    /**
+     * @brief Poll for the 'attitude_quaternion' samples received within a time window.
+     *
+     * @return The samples received from from_us to to_us, oldest first.
+     */
+    std::vector<AttitudeQuaternionSample>
+    attitude_quaternion_history(uint64_t from_us, uint64_t to_us) const;
+
+    /**
+     * @brief Poll for the 'attitude_quaternion' at a receive time, interpolated between samples.
+     *
+     * @return Nothing if the time is not within the history.
+     */
+    std::optional<Telemetry::Quaternion>
+    attitude_quaternion_at(uint64_t receive_timestamp_us) const;
+
+    /**
+     * @brief Let the subscriptions decide the rate of the high rate messages.
+     *
+     * Position, velocity, attitude, IMU, odometry, ground truth, fixedwing metrics and altitude
+     * messages are then requested at the highest rate a subscriber limited itself to, or at the
+     * default rate if no subscriber limited itself. Without any subscriber, they are only
+     * requested at 1 Hz. This overrides the rates set for these messages before, and the default
+     * rates are requested again when it is disabled.
+     */
+    void set_automatic_rates_enabled(bool enabled) const;
+
+    /**
+     * @brief Set how often unchanged states are delivered again.
+     *
+     * In-air, armed, flight mode, health, VTOL state, landed state and RC
+     * status are only delivered to subscribers when they change, and once to
+     * a new subscriber. With a keep-alive, an unchanged state is also
+     * delivered again once this interval has passed since it was last
+     * delivered.
+     *
+     * @param interval_s Keep-alive interval in seconds, 0 for changes only (default).
+     */
+    void set_state_keep_alive(double interval_s) const;
+
+    /**
+     * @brief Only decode the high rate messages while something needs them.
+     *
+     * Position, velocity, heading, attitude, IMU, odometry, ground truth, fixedwing metrics and
+     * altitude messages are then only decoded while there is a subscriber for them, or the
+     * history or shared memory publishing uses them. Once their value is polled, e.g. with
+     * Telemetry::position() or snapshot(), they are decoded for good.
+     *
+     * This changes what the polling getters in Telemetry return: the first poll of a message
+     * that was not decoded returns an old value, or the default if nothing has been decoded
+     * yet. Only later polls are up to date.
+     */
+    void set_on_demand_decoding_enabled(bool enabled) const;
+
+    /**
+     * @brief Publish the latest position, velocity and attitude to shared memory.
+     *
+     * Other processes on the same computer can then read them lock-free with
+     * TelemetrySharedMemoryReader, instead of needing a connection of their
+     * own. See TelemetrySharedMemory for the layout. The shared memory is
+     * removed again once publishing stops.
+     *
+     * This is not supported on Windows and Android.
+     *
+     * @param name Name of the shared memory, empty to stop publishing.
+     * @return Success, or Unsupported if it could not be created.
+     */
+    Telemetry::Result publish_to_shared_memory(const std::string& name) const;
+
+private:
+    TelemetryImpl& _impl;
+};
+
+} // namespace mavsdk
@@ -0,0 +1,172 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <type_traits>
+
+namespace mavsdk {
+
+/**
+ * @brief Layout of the latest telemetry published to shared memory, see
+ * TelemetryExt::publish_to_shared_memory().
+ *
+ * The region is a POSIX shared memory object of exactly this size, in the
+ * byte order and alignment of the machine. Each value is in a slot with a
+ * sequence counter which is odd while the value is written. A reader loads
+ * the counter, copies the value and loads the counter again, and retries
+ * unless both were the same even number. Slot::load() does exactly that.
+ *
+ * Receive timestamps are in microseconds of the steady clock
+ * (CLOCK_MONOTONIC on Linux), and 0 if nothing has been received yet.
+ */
+struct TelemetrySharedMemory {
+    static constexpr uint32_t MAGIC = 0x4d415653; /**< @brief "MAVS", set once initialized. */
+    static constexpr uint32_t VERSION = 1; /**< @brief Changed whenever the layout changes. */
+
+    /**
+     * @brief A value guarded by a sequence counter.
+     */
+    template<typename T> struct Slot {
+        static_assert(std::is_trivially_copyable_v<T>, "Slot needs a trivially copyable type");
+
+        /** @brief Number of 64 bit words holding the value. */
+        static constexpr std::size_t num_words =
+            (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+        std::atomic<uint64_t> sequence; /**< @brief Odd while the value is written. */
+        std::array<std::atomic<uint64_t>, num_words> words; /**< @brief The value. */
+
+        /**
+         * @brief Copy the value, lock-free. Only one process must store.
+         */
+        T load() const
+        {
+            std::array<uint64_t, num_words> copy{};
+            while (true) {
+                const auto before = sequence.load(std::memory_order_acquire);
+                if (before % 2 != 0) {
+                    std::this_thread::yield();
+                    continue;
+                }
+                for (std::size_t i = 0; i < num_words; ++i) {
+                    copy[i] = words[i].load(std::memory_order_acquire);
+                }
+                if (sequence.load(std::memory_order_relaxed) == before) {
+                    break;
+                }
+            }
+            T value;
+            std::memcpy(static_cast<void*>(&value), copy.data(), sizeof(T));
+            return value;
+        }
+
+        /**
+         * @brief Set the value, only to be called by the one writer.
+         */
+        void store(const T& value)
+        {
+            std::array<uint64_t, num_words> copy{};
+            std::memcpy(copy.data(), &value, sizeof(T));
+            const auto before = sequence.load(std::memory_order_relaxed);
+            sequence.store(before + 1, std::memory_order_relaxed);
+            for (std::size_t i = 0; i < num_words; ++i) {
+                words[i].store(copy[i], std::memory_order_release);
+            }
+            sequence.store(before + 2, std::memory_order_release);
+        }
+    };
+
+    /**
+     * @brief Global position.
+     */
+    struct Position {
+        double latitude_deg; /**< @brief Latitude in degrees */
+        double longitude_deg; /**< @brief Longitude in degrees */
+        float absolute_altitude_m; /**< @brief Altitude AMSL in metres */
+        float relative_altitude_m; /**< @brief Altitude relative to takeoff in metres */
+        uint64_t receive_timestamp_us; /**< @brief When it was received */
+    };
+
+    /**
+     * @brief Velocity in NED coordinates.
+     */
+    struct VelocityNed {
+        float north_m_s; /**< @brief Velocity along north in metres per second */
+        float east_m_s; /**< @brief Velocity along east in metres per second */
+        float down_m_s; /**< @brief Velocity along down in metres per second */
+        float reserved; /**< @brief Padding, always 0 */
+        uint64_t receive_timestamp_us; /**< @brief When it was received */
+    };
+
+    /**
+     * @brief Attitude as quaternion.
+     */
+    struct AttitudeQuaternion {
+        float w; /**< @brief Quaternion entry 0 */
+        float x; /**< @brief Quaternion entry 1 */
+        float y; /**< @brief Quaternion entry 2 */
+        float z; /**< @brief Quaternion entry 3 */
+        uint64_t timestamp_us; /**< @brief Timestamp of the autopilot in microseconds */
+        uint64_t receive_timestamp_us; /**< @brief When it was received */
+    };
+
+    /**
+     * @brief Angular velocity in the body frame.
+     */
+    struct AngularVelocityBody {
+        float roll_rad_s; /**< @brief Roll angular velocity */
+        float pitch_rad_s; /**< @brief Pitch angular velocity */
+        float yaw_rad_s; /**< @brief Yaw angular velocity */
+        float reserved; /**< @brief Padding, always 0 */
+        uint64_t receive_timestamp_us; /**< @brief When it was received */
+    };
+
+    std::atomic<uint32_t> magic; /**< @brief MAGIC once the rest is initialized. */
+    uint32_t version; /**< @brief VERSION of the writer. */
+    uint32_t size; /**< @brief sizeof(TelemetrySharedMemory) of the writer. */
+    uint32_t system_id; /**< @brief System ID of the vehicle. */
+    Slot<Position> position; /**< @brief Latest position. */
+    Slot<VelocityNed> velocity_ned; /**< @brief Latest velocity. */
+    Slot<AttitudeQuaternion> attitude_quaternion; /**< @brief Latest attitude. */
+    Slot<AngularVelocityBody> angular_velocity_body; /**< @brief Latest angular velocity. */
+};
+
+/**
+ * @brief Reads telemetry published to shared memory by another process.
+ */
+class TelemetrySharedMemoryReader {
+public:
+    /**
+     * @brief Map the shared memory published under a name.
+     *
+     * @return Nothing if it doesn't exist (yet), is not initialized or is
+     * of another layout version.
+     */
+    static std::unique_ptr<TelemetrySharedMemoryReader> open(const std::string& name);
+
+    /**
+     * @brief Destructor, unmaps the memory.
+     */
+    ~TelemetrySharedMemoryReader();
+
+    TelemetrySharedMemoryReader(const TelemetrySharedMemoryReader&) = delete;
+    TelemetrySharedMemoryReader& operator=(const TelemetrySharedMemoryReader&) = delete;
+
+    /**
+     * @brief The published telemetry, read with Slot::load().
+     */
+    const TelemetrySharedMemory& memory() const { return *_memory; }
+
+private:
+    explicit TelemetrySharedMemoryReader(const TelemetrySharedMemory* memory) : _memory(memory) {}
+
+    const TelemetrySharedMemory* _memory;
+};
+
+} // namespace mavsdk
@@ -1,5 +1,7 @@
 #include "mavsdk_math.h"
 #include "math_conversions.h"
+#include <algorithm>
+#include <array>
 #include <cmath>
 
 namespace mavsdk {
@@ -40,4 +42,40 @@ Telemetry::Quaternion to_quaternion_from_euler_angle(Telemetry::EulerAngle euler
     return quaternion;
 }
 
+std::vector<Telemetry::EulerAngle>
+to_euler_angles_from_quaternions(const std::vector<Telemetry::Quaternion>& quaternions)
+{
+    std::vector<Telemetry::EulerAngle> euler_angles(quaternions.size());
+
+    // Converted in chunks, as the samples need to be packed first.
+    constexpr std::size_t chunk_size = 64;
+    std::array<float, 4 * chunk_size> packed_quaternions;
+    std::array<float, 3 * chunk_size> packed_euler_angles;
+
+    for (std::size_t start = 0; start < quaternions.size(); start += chunk_size) {
+        const auto count = std::min(chunk_size, quaternions.size() - start);
+
+        for (std::size_t i = 0; i < count; ++i) {
+            const auto& q = quaternions[start + i];
+            packed_quaternions[4 * i] = q.w;
+            packed_quaternions[4 * i + 1] = q.x;
+            packed_quaternions[4 * i + 2] = q.y;
+            packed_quaternions[4 * i + 3] = q.z;
+        }
+
+        to_euler_angles_deg_from_quaternions(
+            packed_quaternions.data(), packed_euler_angles.data(), count);
+
+        for (std::size_t i = 0; i < count; ++i) {
+            auto& euler_angle = euler_angles[start + i];
+            euler_angle.roll_deg = packed_euler_angles[3 * i];
+            euler_angle.pitch_deg = packed_euler_angles[3 * i + 1];
+            euler_angle.yaw_deg = packed_euler_angles[3 * i + 2];
+            euler_angle.timestamp_us = quaternions[start + i].timestamp_us;
+        }
+    }
+
+    return euler_angles;
+}
+
 } // namespace mavsdk
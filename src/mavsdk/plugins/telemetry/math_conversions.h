@@ -1,10 +1,16 @@
 #pragma once
 
 #include "plugins/telemetry/telemetry.h"
+#include <vector>
 
 namespace mavsdk {
 
 Telemetry::EulerAngle to_euler_angle_from_quaternion(Telemetry::Quaternion quaternion);
 Telemetry::Quaternion to_quaternion_from_euler_angle(Telemetry::EulerAngle euler_angle);
 
+// For many samples at once, e.g. a history. Within 0.001 degrees of what
+// to_euler_angle_from_quaternion returns.
+std::vector<Telemetry::EulerAngle>
+to_euler_angles_from_quaternions(const std::vector<Telemetry::Quaternion>& quaternions);
+
 } // namespace mavsdk
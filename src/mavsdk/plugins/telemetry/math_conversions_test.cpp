@@ -111,3 +111,27 @@ TEST(MathConversions, QuaternionToEulerAndBackSomeCase)
     EXPECT_NEAR(q2.y, q2_mavlink[2], 0.01f);
     EXPECT_NEAR(q2.z, q2_mavlink[3], 0.01f);
 }
+
+TEST(MathConversions, ManyQuaternionsToEulerAngles)
+{
+    std::vector<Telemetry::Quaternion> quaternions;
+    for (unsigned i = 0; i < 150; ++i) {
+        Telemetry::EulerAngle euler_angle;
+        euler_angle.roll_deg = -170.0f + 2.0f * static_cast<float>(i % 170);
+        euler_angle.pitch_deg = -80.0f + static_cast<float>(i);
+        euler_angle.yaw_deg = 175.0f - 2.0f * static_cast<float>(i);
+        euler_angle.timestamp_us = 1000 + i;
+        quaternions.push_back(to_quaternion_from_euler_angle(euler_angle));
+    }
+
+    const auto euler_angles = to_euler_angles_from_quaternions(quaternions);
+    ASSERT_EQ(euler_angles.size(), quaternions.size());
+
+    for (std::size_t i = 0; i < quaternions.size(); ++i) {
+        const auto expected = to_euler_angle_from_quaternion(quaternions[i]);
+        EXPECT_NEAR(euler_angles[i].roll_deg, expected.roll_deg, 0.001f) << i;
+        EXPECT_NEAR(euler_angles[i].pitch_deg, expected.pitch_deg, 0.001f) << i;
+        EXPECT_NEAR(euler_angles[i].yaw_deg, expected.yaw_deg, 0.001f) << i;
+        EXPECT_EQ(euler_angles[i].timestamp_us, expected.timestamp_us);
+    }
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "mavsdk_time.h"
+#include <chrono>
+#include <mutex>
+#include <optional>
+
+namespace mavsdk {
+
+// Decides whether a state, e.g. the health or the flight mode, is worth
+// telling subscribers about: only if it changed since they were last told,
+// or, with a keep-alive, if they were last told that long ago.
+//
+// Most of these states come with every heartbeat or SYS_STATUS, but hardly
+// ever change.
+template<typename T> class StateChangeFilter {
+public:
+    StateChangeFilter() = default;
+    ~StateChangeFilter() = default;
+
+    // Non-copyable
+    StateChangeFilter(const StateChangeFilter&) = delete;
+    const StateChangeFilter& operator=(const StateChangeFilter&) = delete;
+
+    // A keep_alive_s of 0 means that only changes are due.
+    bool is_due(const T& value, SteadyTimePoint now, double keep_alive_s)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_last && *_last == value &&
+            (keep_alive_s <= 0.0 ||
+             now - _last_time < std::chrono::duration<double>(keep_alive_s))) {
+            return false;
+        }
+        _last = value;
+        _last_time = now;
+        return true;
+    }
+
+    // The next value is due, whatever it is, e.g. for a new subscriber.
+    void reset()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _last.reset();
+    }
+
+private:
+    std::mutex _mutex{};
+    std::optional<T> _last{}; // Needs _mutex
+    SteadyTimePoint _last_time{}; // Needs _mutex
+};
+
+} // namespace mavsdk
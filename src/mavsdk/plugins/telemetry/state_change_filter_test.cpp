@@ -0,0 +1,49 @@
+#include "state_change_filter.h"
+#include "plugins/telemetry/telemetry.h"
+#include <gtest/gtest.h>
+
+using namespace mavsdk;
+
+TEST(StateChangeFilter, OnlyChangesAreDue)
+{
+    StateChangeFilter<Telemetry::FlightMode> filter;
+    const SteadyTimePoint now{};
+
+    // The first one always is.
+    EXPECT_TRUE(filter.is_due(Telemetry::FlightMode::Hold, now, 0.0));
+    EXPECT_FALSE(filter.is_due(Telemetry::FlightMode::Hold, now, 0.0));
+    EXPECT_FALSE(filter.is_due(Telemetry::FlightMode::Hold, now + std::chrono::hours(1), 0.0));
+
+    EXPECT_TRUE(filter.is_due(Telemetry::FlightMode::Mission, now, 0.0));
+    EXPECT_FALSE(filter.is_due(Telemetry::FlightMode::Mission, now, 0.0));
+    EXPECT_TRUE(filter.is_due(Telemetry::FlightMode::Hold, now, 0.0));
+}
+
+TEST(StateChangeFilter, UnchangedStatesAreKeptAlive)
+{
+    StateChangeFilter<Telemetry::Health> filter;
+    Telemetry::Health health{};
+    const SteadyTimePoint now{};
+
+    EXPECT_TRUE(filter.is_due(health, now, 1.0));
+    EXPECT_FALSE(filter.is_due(health, now + std::chrono::milliseconds(999), 1.0));
+    EXPECT_TRUE(filter.is_due(health, now + std::chrono::milliseconds(1000), 1.0));
+    EXPECT_FALSE(filter.is_due(health, now + std::chrono::milliseconds(1500), 1.0));
+
+    // A change does not wait for the keep-alive.
+    health.is_armable = true;
+    EXPECT_TRUE(filter.is_due(health, now + std::chrono::milliseconds(1600), 1.0));
+}
+
+TEST(StateChangeFilter, ResetMakesTheNextOneDue)
+{
+    StateChangeFilter<bool> filter;
+    const SteadyTimePoint now{};
+
+    EXPECT_TRUE(filter.is_due(true, now, 0.0));
+    EXPECT_FALSE(filter.is_due(true, now, 0.0));
+
+    filter.reset();
+    EXPECT_TRUE(filter.is_due(true, now, 0.0));
+    EXPECT_FALSE(filter.is_due(true, now, 0.0));
+}
@@ -572,7 +572,7 @@ Telemetry::Altitude Telemetry::altitude() const
     return _impl->altitude();
 }
 
-void Telemetry::set_rate_position_async(double rate_hz, const ResultCallback callback)
+void Telemetry::set_rate_position_async(double rate_hz, const ResultCallback& callback)
 {
     _impl->set_rate_position_async(rate_hz, callback);
 }
@@ -582,7 +582,7 @@ Telemetry::Result Telemetry::set_rate_position(double rate_hz) const
     return _impl->set_rate_position(rate_hz);
 }
 
-void Telemetry::set_rate_home_async(double rate_hz, const ResultCallback callback)
+void Telemetry::set_rate_home_async(double rate_hz, const ResultCallback& callback)
 {
     _impl->set_rate_home_async(rate_hz, callback);
 }
@@ -592,7 +592,7 @@ Telemetry::Result Telemetry::set_rate_home(double rate_hz) const
     return _impl->set_rate_home(rate_hz);
 }
 
-void Telemetry::set_rate_in_air_async(double rate_hz, const ResultCallback callback)
+void Telemetry::set_rate_in_air_async(double rate_hz, const ResultCallback& callback)
 {
     _impl->set_rate_in_air_async(rate_hz, callback);
 }
@@ -602,7 +602,7 @@ Telemetry::Result Telemetry::set_rate_in_air(double rate_hz) const
     return _impl->set_rate_in_air(rate_hz);
 }
 
-void Telemetry::set_rate_landed_state_async(double rate_hz, const ResultCallback callback)
+void Telemetry::set_rate_landed_state_async(double rate_hz, const ResultCallback& callback)
 {
     _impl->set_rate_landed_state_async(rate_hz, callback);
 }
@@ -612,7 +612,7 @@ Telemetry::Result Telemetry::set_rate_landed_state(double rate_hz) const
     return _impl->set_rate_landed_state(rate_hz);
 }
 
-void Telemetry::set_rate_vtol_state_async(double rate_hz, const ResultCallback callback)
+void Telemetry::set_rate_vtol_state_async(double rate_hz, const ResultCallback& callback)
 {
     _impl->set_rate_vtol_state_async(rate_hz, callback);
 }
@@ -622,7 +622,7 @@ Telemetry::Result Telemetry::set_rate_vtol_state(double rate_hz) const
     return _impl->set_rate_vtol_state(rate_hz);
 }
 
-void Telemetry::set_rate_attitude_quaternion_async(double rate_hz, const ResultCallback callback)
+void Telemetry::set_rate_attitude_quaternion_async(double rate_hz, const ResultCallback& callback)
 {
     _impl->set_rate_attitude_quaternion_async(rate_hz, callback);
 }
@@ -632,7 +632,7 @@ Telemetry::Result Telemetry::set_rate_attitude_quaternion(double rate_hz) const
     return _impl->set_rate_attitude_quaternion(rate_hz);
 }
 
-void Telemetry::set_rate_attitude_euler_async(double rate_hz, const ResultCallback callback)
+void Telemetry::set_rate_attitude_euler_async(double rate_hz, const ResultCallback& callback)
 {
     _impl->set_rate_attitude_euler_async(rate_hz, callback);
 }
@@ -642,7 +642,7 @@ Telemetry::Result Telemetry::set_rate_attitude_euler(double rate_hz) const
     return _impl->set_rate_attitude_euler(rate_hz);
 }
 
-void Telemetry::set_rate_camera_attitude_async(double rate_hz, const ResultCallback callback)
+void Telemetry::set_rate_camera_attitude_async(double rate_hz, const ResultCallback& callback)
 {
     _impl->set_rate_camera_attitude_async(rate_hz, callback);
 }
@@ -652,7 +652,7 @@ Telemetry::Result Telemetry::set_rate_camera_attitude(double rate_hz) const
     return _impl->set_rate_camera_attitude(rate_hz);
 }
 
-void Telemetry::set_rate_velocity_ned_async(double rate_hz, const ResultCallback callback)
+void Telemetry::set_rate_velocity_ned_async(double rate_hz, const ResultCallback& callback)
 {
     _impl->set_rate_velocity_ned_async(rate_hz, callback);
 }
@@ -662,7 +662,7 @@ Telemetry::Result Telemetry::set_rate_velocity_ned(double rate_hz) const
     return _impl->set_rate_velocity_ned(rate_hz);
 }
 
-void Telemetry::set_rate_gps_info_async(double rate_hz, const ResultCallback callback)
+void Telemetry::set_rate_gps_info_async(double rate_hz, const ResultCallback& callback)
 {
     _impl->set_rate_gps_info_async(rate_hz, callback);
 }
@@ -672,7 +672,7 @@ Telemetry::Result Telemetry::set_rate_gps_info(double rate_hz) const
     return _impl->set_rate_gps_info(rate_hz);
 }
 
-void Telemetry::set_rate_battery_async(double rate_hz, const ResultCallback callback)
+void Telemetry::set_rate_battery_async(double rate_hz, const ResultCallback& callback)
 {
     _impl->set_rate_battery_async(rate_hz, callback);
 }
@@ -682,7 +682,7 @@ Telemetry::Result Telemetry::set_rate_battery(double rate_hz) const
     return _impl->set_rate_battery(rate_hz);
 }
 
-void Telemetry::set_rate_rc_status_async(double rate_hz, const ResultCallback callback)
+void Telemetry::set_rate_rc_status_async(double rate_hz, const ResultCallback& callback)
 {
     _impl->set_rate_rc_status_async(rate_hz, callback);
 }
@@ -693,7 +693,7 @@ Telemetry::Result Telemetry::set_rate_rc_status(double rate_hz) const
 }
 
 void Telemetry::set_rate_actuator_control_target_async(
-    double rate_hz, const ResultCallback callback)
+    double rate_hz, const ResultCallback& callback)
 {
     _impl->set_rate_actuator_control_target_async(rate_hz, callback);
 }
@@ -703,7 +703,8 @@ Telemetry::Result Telemetry::set_rate_actuator_control_target(double rate_hz) co
     return _impl->set_rate_actuator_control_target(rate_hz);
 }
 
-void Telemetry::set_rate_actuator_output_status_async(double rate_hz, const ResultCallback callback)
+void Telemetry::set_rate_actuator_output_status_async(
+    double rate_hz, const ResultCallback& callback)
 {
     _impl->set_rate_actuator_output_status_async(rate_hz, callback);
 }
@@ -713,7 +714,7 @@ Telemetry::Result Telemetry::set_rate_actuator_output_status(double rate_hz) con
     return _impl->set_rate_actuator_output_status(rate_hz);
 }
 
-void Telemetry::set_rate_odometry_async(double rate_hz, const ResultCallback callback)
+void Telemetry::set_rate_odometry_async(double rate_hz, const ResultCallback& callback)
 {
     _impl->set_rate_odometry_async(rate_hz, callback);
 }
@@ -723,7 +724,7 @@ Telemetry::Result Telemetry::set_rate_odometry(double rate_hz) const
     return _impl->set_rate_odometry(rate_hz);
 }
 
-void Telemetry::set_rate_position_velocity_ned_async(double rate_hz, const ResultCallback callback)
+void Telemetry::set_rate_position_velocity_ned_async(double rate_hz, const ResultCallback& callback)
 {
     _impl->set_rate_position_velocity_ned_async(rate_hz, callback);
 }
@@ -733,7 +734,7 @@ Telemetry::Result Telemetry::set_rate_position_velocity_ned(double rate_hz) cons
     return _impl->set_rate_position_velocity_ned(rate_hz);
 }
 
-void Telemetry::set_rate_ground_truth_async(double rate_hz, const ResultCallback callback)
+void Telemetry::set_rate_ground_truth_async(double rate_hz, const ResultCallback& callback)
 {
     _impl->set_rate_ground_truth_async(rate_hz, callback);
 }
@@ -743,7 +744,7 @@ Telemetry::Result Telemetry::set_rate_ground_truth(double rate_hz) const
     return _impl->set_rate_ground_truth(rate_hz);
 }
 
-void Telemetry::set_rate_fixedwing_metrics_async(double rate_hz, const ResultCallback callback)
+void Telemetry::set_rate_fixedwing_metrics_async(double rate_hz, const ResultCallback& callback)
 {
     _impl->set_rate_fixedwing_metrics_async(rate_hz, callback);
 }
@@ -753,7 +754,7 @@ Telemetry::Result Telemetry::set_rate_fixedwing_metrics(double rate_hz) const
     return _impl->set_rate_fixedwing_metrics(rate_hz);
 }
 
-void Telemetry::set_rate_imu_async(double rate_hz, const ResultCallback callback)
+void Telemetry::set_rate_imu_async(double rate_hz, const ResultCallback& callback)
 {
     _impl->set_rate_imu_async(rate_hz, callback);
 }
@@ -763,7 +764,7 @@ Telemetry::Result Telemetry::set_rate_imu(double rate_hz) const
     return _impl->set_rate_imu(rate_hz);
 }
 
-void Telemetry::set_rate_scaled_imu_async(double rate_hz, const ResultCallback callback)
+void Telemetry::set_rate_scaled_imu_async(double rate_hz, const ResultCallback& callback)
 {
     _impl->set_rate_scaled_imu_async(rate_hz, callback);
 }
@@ -773,7 +774,7 @@ Telemetry::Result Telemetry::set_rate_scaled_imu(double rate_hz) const
     return _impl->set_rate_scaled_imu(rate_hz);
 }
 
-void Telemetry::set_rate_raw_imu_async(double rate_hz, const ResultCallback callback)
+void Telemetry::set_rate_raw_imu_async(double rate_hz, const ResultCallback& callback)
 {
     _impl->set_rate_raw_imu_async(rate_hz, callback);
 }
@@ -783,7 +784,7 @@ Telemetry::Result Telemetry::set_rate_raw_imu(double rate_hz) const
     return _impl->set_rate_raw_imu(rate_hz);
 }
 
-void Telemetry::set_rate_unix_epoch_time_async(double rate_hz, const ResultCallback callback)
+void Telemetry::set_rate_unix_epoch_time_async(double rate_hz, const ResultCallback& callback)
 {
     _impl->set_rate_unix_epoch_time_async(rate_hz, callback);
 }
@@ -793,7 +794,7 @@ Telemetry::Result Telemetry::set_rate_unix_epoch_time(double rate_hz) const
     return _impl->set_rate_unix_epoch_time(rate_hz);
 }
 
-void Telemetry::set_rate_distance_sensor_async(double rate_hz, const ResultCallback callback)
+void Telemetry::set_rate_distance_sensor_async(double rate_hz, const ResultCallback& callback)
 {
     _impl->set_rate_distance_sensor_async(rate_hz, callback);
 }
@@ -803,7 +804,7 @@ Telemetry::Result Telemetry::set_rate_distance_sensor(double rate_hz) const
     return _impl->set_rate_distance_sensor(rate_hz);
 }
 
-void Telemetry::set_rate_altitude_async(double rate_hz, const ResultCallback callback)
+void Telemetry::set_rate_altitude_async(double rate_hz, const ResultCallback& callback)
 {
     _impl->set_rate_altitude_async(rate_hz, callback);
 }
@@ -813,7 +814,7 @@ Telemetry::Result Telemetry::set_rate_altitude(double rate_hz) const
     return _impl->set_rate_altitude(rate_hz);
 }
 
-void Telemetry::get_gps_global_origin_async(const GetGpsGlobalOriginCallback callback)
+void Telemetry::get_gps_global_origin_async(const GetGpsGlobalOriginCallback& callback)
 {
     _impl->get_gps_global_origin_async(callback);
 }
@@ -0,0 +1,263 @@
+#include <iomanip>
+
+#include "telemetry_impl.h"
+#include "plugins/telemetry/telemetry_ext.h"
+
+namespace mavsdk {
+
+TelemetryExt::TelemetryExt(Telemetry& telemetry) : _impl(*telemetry._impl) {}
+
+TelemetryExt::Snapshot TelemetryExt::snapshot() const
+{
+    _impl.polled(MAVLINK_MSG_ID_GLOBAL_POSITION_INT);
+    _impl.polled(MAVLINK_MSG_ID_ATTITUDE_QUATERNION);
+    return _impl.snapshot();
+}
+
+Telemetry::PositionHandle
+TelemetryExt::subscribe_position(const Telemetry::PositionCallback& callback, double max_rate_hz)
+{
+    return _impl.subscribe_position(callback, max_rate_hz);
+}
+
+Telemetry::AttitudeQuaternionHandle TelemetryExt::subscribe_attitude_quaternion(
+    const Telemetry::AttitudeQuaternionCallback& callback, double max_rate_hz)
+{
+    return _impl.subscribe_attitude_quaternion(callback, max_rate_hz);
+}
+
+Telemetry::AttitudeEulerHandle TelemetryExt::subscribe_attitude_euler(
+    const Telemetry::AttitudeEulerCallback& callback, double max_rate_hz)
+{
+    return _impl.subscribe_attitude_euler(callback, max_rate_hz);
+}
+
+Telemetry::AttitudeAngularVelocityBodyHandle TelemetryExt::subscribe_attitude_angular_velocity_body(
+    const Telemetry::AttitudeAngularVelocityBodyCallback& callback, double max_rate_hz)
+{
+    return _impl.subscribe_attitude_angular_velocity_body(callback, max_rate_hz);
+}
+
+Telemetry::VelocityNedHandle TelemetryExt::subscribe_velocity_ned(
+    const Telemetry::VelocityNedCallback& callback, double max_rate_hz)
+{
+    return _impl.subscribe_velocity_ned(callback, max_rate_hz);
+}
+
+Telemetry::OdometryHandle
+TelemetryExt::subscribe_odometry(const Telemetry::OdometryCallback& callback, double max_rate_hz)
+{
+    return _impl.subscribe_odometry(callback, max_rate_hz);
+}
+
+Telemetry::PositionVelocityNedHandle TelemetryExt::subscribe_position_velocity_ned(
+    const Telemetry::PositionVelocityNedCallback& callback, double max_rate_hz)
+{
+    return _impl.subscribe_position_velocity_ned(callback, max_rate_hz);
+}
+
+Telemetry::GroundTruthHandle TelemetryExt::subscribe_ground_truth(
+    const Telemetry::GroundTruthCallback& callback, double max_rate_hz)
+{
+    return _impl.subscribe_ground_truth(callback, max_rate_hz);
+}
+
+Telemetry::FixedwingMetricsHandle TelemetryExt::subscribe_fixedwing_metrics(
+    const Telemetry::FixedwingMetricsCallback& callback, double max_rate_hz)
+{
+    return _impl.subscribe_fixedwing_metrics(callback, max_rate_hz);
+}
+
+Telemetry::ImuHandle
+TelemetryExt::subscribe_imu(const Telemetry::ImuCallback& callback, double max_rate_hz)
+{
+    return _impl.subscribe_imu(callback, max_rate_hz);
+}
+
+Telemetry::ScaledImuHandle
+TelemetryExt::subscribe_scaled_imu(const Telemetry::ScaledImuCallback& callback, double max_rate_hz)
+{
+    return _impl.subscribe_scaled_imu(callback, max_rate_hz);
+}
+
+Telemetry::RawImuHandle
+TelemetryExt::subscribe_raw_imu(const Telemetry::RawImuCallback& callback, double max_rate_hz)
+{
+    return _impl.subscribe_raw_imu(callback, max_rate_hz);
+}
+
+Telemetry::HeadingHandle
+TelemetryExt::subscribe_heading(const Telemetry::HeadingCallback& callback, double max_rate_hz)
+{
+    return _impl.subscribe_heading(callback, max_rate_hz);
+}
+
+Telemetry::AltitudeHandle
+TelemetryExt::subscribe_altitude(const Telemetry::AltitudeCallback& callback, double max_rate_hz)
+{
+    return _impl.subscribe_altitude(callback, max_rate_hz);
+}
+
+void TelemetryExt::set_history_enabled(bool enabled) const
+{
+    _impl.set_history_enabled(enabled);
+}
+
+std::vector<TelemetryExt::PositionSample>
+TelemetryExt::position_history(uint64_t from_us, uint64_t to_us) const
+{
+    return _impl.position_history(from_us, to_us);
+}
+
+std::optional<Telemetry::Position> TelemetryExt::position_at(uint64_t receive_timestamp_us) const
+{
+    return _impl.position_at(receive_timestamp_us);
+}
+
+std::vector<TelemetryExt::VelocityNedSample>
+TelemetryExt::velocity_ned_history(uint64_t from_us, uint64_t to_us) const
+{
+    return _impl.velocity_ned_history(from_us, to_us);
+}
+
+std::optional<Telemetry::VelocityNed>
+TelemetryExt::velocity_ned_at(uint64_t receive_timestamp_us) const
+{
+    return _impl.velocity_ned_at(receive_timestamp_us);
+}
+
+std::vector<TelemetryExt::AttitudeQuaternionSample>
+TelemetryExt::attitude_quaternion_history(uint64_t from_us, uint64_t to_us) const
+{
+    return _impl.attitude_quaternion_history(from_us, to_us);
+}
+
+std::optional<Telemetry::Quaternion>
+TelemetryExt::attitude_quaternion_at(uint64_t receive_timestamp_us) const
+{
+    return _impl.attitude_quaternion_at(receive_timestamp_us);
+}
+
+void TelemetryExt::set_automatic_rates_enabled(bool enabled) const
+{
+    _impl.set_automatic_rates_enabled(enabled);
+}
+
+void TelemetryExt::set_state_keep_alive(double interval_s) const
+{
+    _impl.set_state_keep_alive(interval_s);
+}
+
+void TelemetryExt::set_on_demand_decoding_enabled(bool enabled) const
+{
+    _impl.set_on_demand_decoding_enabled(enabled);
+}
+
+Telemetry::Result TelemetryExt::publish_to_shared_memory(const std::string& name) const
+{
+    return _impl.publish_to_shared_memory(name);
+}
+
+bool operator==(const TelemetryExt::Snapshot& lhs, const TelemetryExt::Snapshot& rhs)
+{
+    return (rhs.position == lhs.position) &&
+           (rhs.position_receive_timestamp_us == lhs.position_receive_timestamp_us) &&
+           (rhs.velocity_ned == lhs.velocity_ned) &&
+           (rhs.velocity_ned_receive_timestamp_us == lhs.velocity_ned_receive_timestamp_us) &&
+           (rhs.attitude_quaternion == lhs.attitude_quaternion) &&
+           (rhs.attitude_quaternion_receive_timestamp_us ==
+            lhs.attitude_quaternion_receive_timestamp_us) &&
+           (rhs.battery == lhs.battery) &&
+           (rhs.battery_receive_timestamp_us == lhs.battery_receive_timestamp_us) &&
+           (rhs.flight_mode == lhs.flight_mode) &&
+           (rhs.flight_mode_receive_timestamp_us == lhs.flight_mode_receive_timestamp_us) &&
+           (rhs.health == lhs.health) &&
+           (rhs.health_receive_timestamp_us == lhs.health_receive_timestamp_us);
+}
+
+std::ostream& operator<<(std::ostream& str, TelemetryExt::Snapshot const& snapshot)
+{
+    str << std::setprecision(15);
+    str << "snapshot:" << '\n' << "{\n";
+    str << "    position: " << snapshot.position << '\n';
+    str << "    position_receive_timestamp_us: " << snapshot.position_receive_timestamp_us
+        << '\n';
+    str << "    velocity_ned: " << snapshot.velocity_ned << '\n';
+    str << "    velocity_ned_receive_timestamp_us: " << snapshot.velocity_ned_receive_timestamp_us
+        << '\n';
+    str << "    attitude_quaternion: " << snapshot.attitude_quaternion << '\n';
+    str << "    attitude_quaternion_receive_timestamp_us: "
+        << snapshot.attitude_quaternion_receive_timestamp_us << '\n';
+    str << "    battery: " << snapshot.battery << '\n';
+    str << "    battery_receive_timestamp_us: " << snapshot.battery_receive_timestamp_us << '\n';
+    str << "    flight_mode: " << snapshot.flight_mode << '\n';
+    str << "    flight_mode_receive_timestamp_us: " << snapshot.flight_mode_receive_timestamp_us
+        << '\n';
+    str << "    health: " << snapshot.health << '\n';
+    str << "    health_receive_timestamp_us: " << snapshot.health_receive_timestamp_us << '\n';
+    str << '}';
+    return str;
+}
+
+bool operator==(const TelemetryExt::PositionSample& lhs, const TelemetryExt::PositionSample& rhs)
+{
+    return (rhs.position == lhs.position) &&
+           (rhs.receive_timestamp_us == lhs.receive_timestamp_us) &&
+           (rhs.autopilot_timestamp_us == lhs.autopilot_timestamp_us);
+}
+
+std::ostream& operator<<(std::ostream& str, TelemetryExt::PositionSample const& position_sample)
+{
+    str << std::setprecision(15);
+    str << "position_sample:" << '\n' << "{\n";
+    str << "    position: " << position_sample.position << '\n';
+    str << "    receive_timestamp_us: " << position_sample.receive_timestamp_us << '\n';
+    str << "    autopilot_timestamp_us: " << position_sample.autopilot_timestamp_us << '\n';
+    str << '}';
+    return str;
+}
+
+bool operator==(
+    const TelemetryExt::VelocityNedSample& lhs, const TelemetryExt::VelocityNedSample& rhs)
+{
+    return (rhs.velocity_ned == lhs.velocity_ned) &&
+           (rhs.receive_timestamp_us == lhs.receive_timestamp_us) &&
+           (rhs.autopilot_timestamp_us == lhs.autopilot_timestamp_us);
+}
+
+std::ostream&
+operator<<(std::ostream& str, TelemetryExt::VelocityNedSample const& velocity_ned_sample)
+{
+    str << std::setprecision(15);
+    str << "velocity_ned_sample:" << '\n' << "{\n";
+    str << "    velocity_ned: " << velocity_ned_sample.velocity_ned << '\n';
+    str << "    receive_timestamp_us: " << velocity_ned_sample.receive_timestamp_us << '\n';
+    str << "    autopilot_timestamp_us: " << velocity_ned_sample.autopilot_timestamp_us << '\n';
+    str << '}';
+    return str;
+}
+
+bool operator==(
+    const TelemetryExt::AttitudeQuaternionSample& lhs,
+    const TelemetryExt::AttitudeQuaternionSample& rhs)
+{
+    return (rhs.attitude_quaternion == lhs.attitude_quaternion) &&
+           (rhs.receive_timestamp_us == lhs.receive_timestamp_us) &&
+           (rhs.autopilot_timestamp_us == lhs.autopilot_timestamp_us);
+}
+
+std::ostream& operator<<(
+    std::ostream& str, TelemetryExt::AttitudeQuaternionSample const& attitude_quaternion_sample)
+{
+    str << std::setprecision(15);
+    str << "attitude_quaternion_sample:" << '\n' << "{\n";
+    str << "    attitude_quaternion: " << attitude_quaternion_sample.attitude_quaternion << '\n';
+    str << "    receive_timestamp_us: " << attitude_quaternion_sample.receive_timestamp_us
+        << '\n';
+    str << "    autopilot_timestamp_us: " << attitude_quaternion_sample.autopilot_timestamp_us
+        << '\n';
+    str << '}';
+    return str;
+}
+
+} // namespace mavsdk
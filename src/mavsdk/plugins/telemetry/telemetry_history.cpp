@@ -0,0 +1,65 @@
+#include "telemetry_history.h"
+#include <cmath>
+
+namespace mavsdk {
+
+namespace {
+
+template<typename V> V lerp(V before, V after, double fraction)
+{
+    return static_cast<V>(
+        static_cast<double>(before) + (static_cast<double>(after) - static_cast<double>(before)) *
+                                          fraction);
+}
+
+} // namespace
+
+Telemetry::Position
+interpolate(const Telemetry::Position& before, const Telemetry::Position& after, double fraction)
+{
+    // Samples are close together, so a straight line is good enough.
+    Telemetry::Position position;
+    position.latitude_deg = lerp(before.latitude_deg, after.latitude_deg, fraction);
+    position.longitude_deg = lerp(before.longitude_deg, after.longitude_deg, fraction);
+    position.absolute_altitude_m =
+        lerp(before.absolute_altitude_m, after.absolute_altitude_m, fraction);
+    position.relative_altitude_m =
+        lerp(before.relative_altitude_m, after.relative_altitude_m, fraction);
+    return position;
+}
+
+Telemetry::VelocityNed interpolate(
+    const Telemetry::VelocityNed& before, const Telemetry::VelocityNed& after, double fraction)
+{
+    Telemetry::VelocityNed velocity;
+    velocity.north_m_s = lerp(before.north_m_s, after.north_m_s, fraction);
+    velocity.east_m_s = lerp(before.east_m_s, after.east_m_s, fraction);
+    velocity.down_m_s = lerp(before.down_m_s, after.down_m_s, fraction);
+    return velocity;
+}
+
+Telemetry::Quaternion interpolate(
+    const Telemetry::Quaternion& before, const Telemetry::Quaternion& after, double fraction)
+{
+    // Normalized linear interpolation, along the shorter way around. Close
+    // enough to slerp for samples this close together.
+    const double dot = static_cast<double>(
+        before.w * after.w + before.x * after.x + before.y * after.y + before.z * after.z);
+    const float sign = dot < 0.0 ? -1.0f : 1.0f;
+
+    const double w = lerp<double>(before.w, sign * after.w, fraction);
+    const double x = lerp<double>(before.x, sign * after.x, fraction);
+    const double y = lerp<double>(before.y, sign * after.y, fraction);
+    const double z = lerp<double>(before.z, sign * after.z, fraction);
+    const double norm = std::sqrt(w * w + x * x + y * y + z * z);
+
+    Telemetry::Quaternion quaternion;
+    quaternion.w = static_cast<float>(w / norm);
+    quaternion.x = static_cast<float>(x / norm);
+    quaternion.y = static_cast<float>(y / norm);
+    quaternion.z = static_cast<float>(z / norm);
+    quaternion.timestamp_us = lerp(before.timestamp_us, after.timestamp_us, fraction);
+    return quaternion;
+}
+
+} // namespace mavsdk
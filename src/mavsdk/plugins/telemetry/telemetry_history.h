@@ -0,0 +1,138 @@
+#pragma once
+
+#include "plugins/telemetry/telemetry.h"
+#include "ringbuffer.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+namespace mavsdk {
+
+Telemetry::Position
+interpolate(const Telemetry::Position& before, const Telemetry::Position& after, double fraction);
+Telemetry::VelocityNed interpolate(
+    const Telemetry::VelocityNed& before, const Telemetry::VelocityNed& after, double fraction);
+Telemetry::Quaternion interpolate(
+    const Telemetry::Quaternion& before, const Telemetry::Quaternion& after, double fraction);
+
+// Keeps the last N samples of a telemetry value, with the time they were
+// received and the time of the autopilot, so that consumers can look at a
+// time window or at the value between two samples.
+//
+// Nothing is stored, or allocated, until it is enabled. Samples need to be
+// pushed in the order they are received.
+template<typename T, std::size_t N> class TelemetryHistory {
+public:
+    struct Sample {
+        T value{};
+        uint64_t receive_timestamp_us{0};
+        uint64_t autopilot_timestamp_us{0};
+    };
+
+    TelemetryHistory() = default;
+    ~TelemetryHistory() = default;
+
+    // Non-copyable
+    TelemetryHistory(const TelemetryHistory&) = delete;
+    const TelemetryHistory& operator=(const TelemetryHistory&) = delete;
+
+    void set_enabled(bool enabled)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (enabled && _samples == nullptr) {
+            _samples = std::make_unique<Ringbuffer<Sample, N>>();
+        } else if (!enabled) {
+            _samples.reset();
+        }
+        _enabled = enabled;
+    }
+
+    void push(const T& value, uint64_t receive_timestamp_us, uint64_t autopilot_timestamp_us)
+    {
+        // Most of the time nobody is interested, don't lock for that.
+        if (!_enabled) {
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_samples != nullptr) {
+            _samples->push(Sample{value, receive_timestamp_us, autopilot_timestamp_us});
+        }
+    }
+
+    // All samples received within [from_us, to_us], oldest first.
+    std::vector<Sample> window(uint64_t from_us, uint64_t to_us) const
+    {
+        std::vector<Sample> result;
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_samples == nullptr) {
+            return result;
+        }
+
+        for (std::size_t i = first_not_before(from_us); i < _samples->size(); ++i) {
+            const auto& sample = (*_samples)[static_cast<int>(i)];
+            if (sample.receive_timestamp_us > to_us) {
+                break;
+            }
+            result.push_back(sample);
+        }
+        return result;
+    }
+
+    // The value at the given receive time, interpolated between the samples
+    // around it. Nothing is returned outside of the history.
+    std::optional<T> at(uint64_t receive_timestamp_us) const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_samples == nullptr) {
+            return {};
+        }
+
+        const auto index = first_not_before(receive_timestamp_us);
+        if (index == _samples->size()) {
+            return {};
+        }
+
+        const auto& after = (*_samples)[static_cast<int>(index)];
+        if (after.receive_timestamp_us == receive_timestamp_us) {
+            return after.value;
+        }
+        if (index == 0) {
+            return {};
+        }
+
+        const auto& before = (*_samples)[static_cast<int>(index - 1)];
+        const double fraction =
+            static_cast<double>(receive_timestamp_us - before.receive_timestamp_us) /
+            static_cast<double>(after.receive_timestamp_us - before.receive_timestamp_us);
+        return interpolate(before.value, after.value, fraction);
+    }
+
+private:
+    // Needs _mutex, binary search as the samples are sorted by receive time.
+    std::size_t first_not_before(uint64_t timestamp_us) const
+    {
+        std::size_t low = 0;
+        std::size_t high = _samples->size();
+        while (low < high) {
+            const std::size_t middle = low + (high - low) / 2;
+            if ((*_samples)[static_cast<int>(middle)].receive_timestamp_us < timestamp_us) {
+                low = middle + 1;
+            } else {
+                high = middle;
+            }
+        }
+        return low;
+    }
+
+    std::atomic<bool> _enabled{false};
+
+    mutable std::mutex _mutex{};
+    std::unique_ptr<Ringbuffer<Sample, N>> _samples{};
+};
+
+} // namespace mavsdk
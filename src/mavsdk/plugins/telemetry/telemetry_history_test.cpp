@@ -0,0 +1,95 @@
+#include "telemetry_history.h"
+#include <cmath>
+#include <gtest/gtest.h>
+
+using namespace mavsdk;
+
+namespace {
+
+Telemetry::VelocityNed velocity(float north_m_s)
+{
+    Telemetry::VelocityNed velocity_ned;
+    velocity_ned.north_m_s = north_m_s;
+    velocity_ned.east_m_s = 0.0f;
+    velocity_ned.down_m_s = 0.0f;
+    return velocity_ned;
+}
+
+} // namespace
+
+TEST(TelemetryHistory, NothingIsKeptUntilEnabled)
+{
+    TelemetryHistory<Telemetry::VelocityNed, 4> history;
+    history.push(velocity(1.0f), 100, 10);
+    EXPECT_TRUE(history.window(0, 1000).empty());
+    EXPECT_FALSE(history.at(100));
+
+    history.set_enabled(true);
+    history.push(velocity(1.0f), 100, 10);
+    EXPECT_EQ(history.window(0, 1000).size(), 1);
+
+    history.set_enabled(false);
+    EXPECT_TRUE(history.window(0, 1000).empty());
+}
+
+TEST(TelemetryHistory, Window)
+{
+    TelemetryHistory<Telemetry::VelocityNed, 4> history;
+    history.set_enabled(true);
+
+    for (unsigned i = 1; i <= 6; ++i) {
+        history.push(velocity(static_cast<float>(i)), i * 100, i * 10);
+    }
+
+    // Only the last 4 are kept.
+    const auto all = history.window(0, 1000);
+    ASSERT_EQ(all.size(), 4);
+    EXPECT_EQ(all[0].value.north_m_s, 3.0f);
+    EXPECT_EQ(all[0].receive_timestamp_us, 300);
+    EXPECT_EQ(all[0].autopilot_timestamp_us, 30);
+    EXPECT_EQ(all[3].value.north_m_s, 6.0f);
+
+    const auto some = history.window(350, 500);
+    ASSERT_EQ(some.size(), 2);
+    EXPECT_EQ(some[0].receive_timestamp_us, 400);
+    EXPECT_EQ(some[1].receive_timestamp_us, 500);
+
+    EXPECT_TRUE(history.window(700, 800).empty());
+}
+
+TEST(TelemetryHistory, InterpolateAt)
+{
+    TelemetryHistory<Telemetry::VelocityNed, 8> history;
+    history.set_enabled(true);
+    history.push(velocity(1.0f), 100, 10);
+    history.push(velocity(3.0f), 200, 20);
+
+    EXPECT_FLOAT_EQ(history.at(100)->north_m_s, 1.0f);
+    EXPECT_FLOAT_EQ(history.at(150)->north_m_s, 2.0f);
+    EXPECT_FLOAT_EQ(history.at(175)->north_m_s, 2.5f);
+    EXPECT_FLOAT_EQ(history.at(200)->north_m_s, 3.0f);
+
+    // Not extrapolated.
+    EXPECT_FALSE(history.at(99));
+    EXPECT_FALSE(history.at(201));
+}
+
+TEST(TelemetryHistory, InterpolateQuaternionTheShortWay)
+{
+    Telemetry::Quaternion identity;
+    identity.w = 1.0f;
+    identity.x = 0.0f;
+    identity.y = 0.0f;
+    identity.z = 0.0f;
+    identity.timestamp_us = 1000;
+
+    // The same rotation as the identity.
+    Telemetry::Quaternion negated = identity;
+    negated.w = -1.0f;
+    negated.timestamp_us = 2000;
+
+    const auto halfway = interpolate(identity, negated, 0.5);
+    EXPECT_FLOAT_EQ(std::fabs(halfway.w), 1.0f);
+    EXPECT_FLOAT_EQ(halfway.x, 0.0f);
+    EXPECT_EQ(halfway.timestamp_us, 1500);
+}
@@ -1,9 +1,11 @@
 #include "telemetry_impl.h"
 #include "system.h"
+#include "decoded_message.h"
 #include "math_conversions.h"
 #include "mavsdk_math.h"
 #include "callback_list.tpp"
 
+#include <algorithm>
 #include <cmath>
 #include <functional>
 #include <string>
@@ -41,6 +43,62 @@ template class CallbackList<Telemetry::ScaledPressure>;
 template class CallbackList<Telemetry::Heading>;
 template class CallbackList<Telemetry::Altitude>;
 
+namespace {
+
+template<typename PublicSample, typename Sample>
+std::vector<PublicSample> to_public_samples(const std::vector<Sample>& samples)
+{
+    std::vector<PublicSample> result;
+    result.reserve(samples.size());
+    for (const auto& sample : samples) {
+        result.push_back(
+            PublicSample{sample.value, sample.receive_timestamp_us, sample.autopilot_timestamp_us});
+    }
+    return result;
+}
+
+// The high rate messages, whose rate follows the subscriptions if automatic
+// rates are enabled.
+constexpr std::array<uint16_t, 11> automatic_rate_message_ids{
+    MAVLINK_MSG_ID_LOCAL_POSITION_NED,
+    MAVLINK_MSG_ID_GLOBAL_POSITION_INT,
+    MAVLINK_MSG_ID_ATTITUDE_QUATERNION,
+    MAVLINK_MSG_ID_ATTITUDE,
+    MAVLINK_MSG_ID_HIGHRES_IMU,
+    MAVLINK_MSG_ID_SCALED_IMU,
+    MAVLINK_MSG_ID_RAW_IMU,
+    MAVLINK_MSG_ID_VFR_HUD,
+    MAVLINK_MSG_ID_HIL_STATE_QUATERNION,
+    MAVLINK_MSG_ID_ODOMETRY,
+    MAVLINK_MSG_ID_ALTITUDE};
+
+// The high rate messages which are only decoded while needed if on demand
+// decoding is enabled. LOCAL_POSITION_NED is always needed for the health.
+constexpr std::array<uint16_t, 10> on_demand_message_ids{
+    MAVLINK_MSG_ID_GLOBAL_POSITION_INT,
+    MAVLINK_MSG_ID_ATTITUDE_QUATERNION,
+    MAVLINK_MSG_ID_ATTITUDE,
+    MAVLINK_MSG_ID_HIGHRES_IMU,
+    MAVLINK_MSG_ID_SCALED_IMU,
+    MAVLINK_MSG_ID_RAW_IMU,
+    MAVLINK_MSG_ID_VFR_HUD,
+    MAVLINK_MSG_ID_HIL_STATE_QUATERNION,
+    MAVLINK_MSG_ID_ODOMETRY,
+    MAVLINK_MSG_ID_ALTITUDE};
+
+std::optional<double> highest_rate_hz(std::initializer_list<std::optional<double>> rates_hz)
+{
+    std::optional<double> result;
+    for (const auto& rate_hz : rates_hz) {
+        if (rate_hz) {
+            result = std::max(result.value_or(0.0), rate_hz.value());
+        }
+    }
+    return result;
+}
+
+} // namespace
+
 TelemetryImpl::TelemetryImpl(System& system) : PluginImplBase(system)
 {
     _system_impl->register_plugin(this);
@@ -63,25 +121,22 @@ void TelemetryImpl::init()
         [this](const mavlink_message_t& message) { process_position_velocity_ned(message); },
         this);
 
-    _system_impl->register_mavlink_message_handler(
+    register_on_demand_handler(
         MAVLINK_MSG_ID_GLOBAL_POSITION_INT,
-        [this](const mavlink_message_t& message) { process_global_position_int(message); },
-        this);
+        [this](const mavlink_message_t& message) { process_global_position_int(message); });
 
     _system_impl->register_mavlink_message_handler(
         MAVLINK_MSG_ID_HOME_POSITION,
         [this](const mavlink_message_t& message) { process_home_position(message); },
         this);
 
-    _system_impl->register_mavlink_message_handler(
+    register_on_demand_handler(
         MAVLINK_MSG_ID_ATTITUDE,
-        [this](const mavlink_message_t& message) { process_attitude(message); },
-        this);
+        [this](const mavlink_message_t& message) { process_attitude(message); });
 
-    _system_impl->register_mavlink_message_handler(
+    register_on_demand_handler(
         MAVLINK_MSG_ID_ATTITUDE_QUATERNION,
-        [this](const mavlink_message_t& message) { process_attitude_quaternion(message); },
-        this);
+        [this](const mavlink_message_t& message) { process_attitude_quaternion(message); });
 
     _system_impl->register_mavlink_message_handler(
         MAVLINK_MSG_ID_MOUNT_ORIENTATION,
@@ -135,10 +190,9 @@ void TelemetryImpl::init()
         [this](const mavlink_message_t& message) { process_actuator_output_status(message); },
         this);
 
-    _system_impl->register_mavlink_message_handler(
+    register_on_demand_handler(
         MAVLINK_MSG_ID_ODOMETRY,
-        [this](const mavlink_message_t& message) { process_odometry(message); },
-        this);
+        [this](const mavlink_message_t& message) { process_odometry(message); });
 
     _system_impl->register_mavlink_message_handler(
         MAVLINK_MSG_ID_DISTANCE_SENSOR,
@@ -155,35 +209,29 @@ void TelemetryImpl::init()
         [this](const mavlink_message_t& message) { process_unix_epoch_time(message); },
         this);
 
-    _system_impl->register_mavlink_message_handler(
+    register_on_demand_handler(
         MAVLINK_MSG_ID_HIGHRES_IMU,
-        [this](const mavlink_message_t& message) { process_imu_reading_ned(message); },
-        this);
+        [this](const mavlink_message_t& message) { process_imu_reading_ned(message); });
 
-    _system_impl->register_mavlink_message_handler(
+    register_on_demand_handler(
         MAVLINK_MSG_ID_SCALED_IMU,
-        [this](const mavlink_message_t& message) { process_scaled_imu(message); },
-        this);
+        [this](const mavlink_message_t& message) { process_scaled_imu(message); });
 
-    _system_impl->register_mavlink_message_handler(
+    register_on_demand_handler(
         MAVLINK_MSG_ID_RAW_IMU,
-        [this](const mavlink_message_t& message) { process_raw_imu(message); },
-        this);
+        [this](const mavlink_message_t& message) { process_raw_imu(message); });
 
-    _system_impl->register_mavlink_message_handler(
+    register_on_demand_handler(
         MAVLINK_MSG_ID_VFR_HUD,
-        [this](const mavlink_message_t& message) { process_fixedwing_metrics(message); },
-        this);
+        [this](const mavlink_message_t& message) { process_fixedwing_metrics(message); });
 
-    _system_impl->register_mavlink_message_handler(
+    register_on_demand_handler(
         MAVLINK_MSG_ID_HIL_STATE_QUATERNION,
-        [this](const mavlink_message_t& message) { process_ground_truth(message); },
-        this);
+        [this](const mavlink_message_t& message) { process_ground_truth(message); });
 
-    _system_impl->register_mavlink_message_handler(
+    register_on_demand_handler(
         MAVLINK_MSG_ID_ALTITUDE,
-        [this](const mavlink_message_t& message) { process_altitude(message); },
-        this);
+        [this](const mavlink_message_t& message) { process_altitude(message); });
 
     _system_impl->register_param_changed_handler(
         [this](const std::string& name) { process_parameter_update(name); }, this);
@@ -204,6 +252,7 @@ void TelemetryImpl::deinit()
     _system_impl->unregister_timeout_handler(_unix_epoch_timeout_cookie);
     _system_impl->unregister_param_changed_handler(this);
     _system_impl->unregister_all_mavlink_message_handlers(this);
+    unregister_on_demand_handlers();
 
     _has_received_gyro_calibration = false;
     _has_received_accel_calibration = false;
@@ -215,6 +264,8 @@ void TelemetryImpl::deinit()
     }
 
     _sys_status_used_for_position = SysStatusUsed::Unknown;
+
+    std::atomic_store(&_shared_memory_writer, std::shared_ptr<TelemetrySharedMemoryWriter>{});
 }
 
 void TelemetryImpl::enable()
@@ -233,6 +284,14 @@ void TelemetryImpl::enable()
     // We're going to retry until we have the Home Position.
     _system_impl->add_call_every(
         [this]() { request_home_position_again(); }, 2.0f, &_homepos_cookie);
+
+    // The rates are unknown after a reconnect.
+    {
+        std::lock_guard<std::mutex> lock(_subscription_mutex);
+        for (const auto message_id : automatic_rate_message_ids) {
+            update_automatic_rate(message_id);
+        }
+    }
 }
 
 void TelemetryImpl::disable()
@@ -245,7 +304,7 @@ void TelemetryImpl::request_home_position_again()
 {
     {
         std::lock_guard<std::mutex> lock(_request_home_position_mutex);
-        if (_health.is_home_position_ok) {
+        if (_snapshot.load().health.is_home_position_ok) {
             _system_impl->remove_call_every(_homepos_cookie);
             return;
         }
@@ -255,8 +314,8 @@ void TelemetryImpl::request_home_position_again()
 
 Telemetry::Result TelemetryImpl::set_rate_position_velocity_ned(double rate_hz)
 {
-    return telemetry_result_from_command_result(
-        _system_impl->set_msg_rate(MAVLINK_MSG_ID_LOCAL_POSITION_NED, rate_hz));
+    return telemetry_result_from_command_result(_system_impl->set_msg_rate(
+        MAVLINK_MSG_ID_LOCAL_POSITION_NED, rate_hz, MAV_COMP_ID_AUTOPILOT1, this));
 }
 
 Telemetry::Result TelemetryImpl::set_rate_position(double rate_hz)
@@ -264,14 +323,14 @@ Telemetry::Result TelemetryImpl::set_rate_position(double rate_hz)
     _position_rate_hz = rate_hz;
     double max_rate_hz = std::max(_position_rate_hz, _velocity_ned_rate_hz);
 
-    return telemetry_result_from_command_result(
-        _system_impl->set_msg_rate(MAVLINK_MSG_ID_GLOBAL_POSITION_INT, max_rate_hz));
+    return telemetry_result_from_command_result(_system_impl->set_msg_rate(
+        MAVLINK_MSG_ID_GLOBAL_POSITION_INT, max_rate_hz, MAV_COMP_ID_AUTOPILOT1, this));
 }
 
 Telemetry::Result TelemetryImpl::set_rate_home(double rate_hz)
 {
-    return telemetry_result_from_command_result(
-        _system_impl->set_msg_rate(MAVLINK_MSG_ID_HOME_POSITION, rate_hz));
+    return telemetry_result_from_command_result(_system_impl->set_msg_rate(
+        MAVLINK_MSG_ID_HOME_POSITION, rate_hz, MAV_COMP_ID_AUTOPILOT1, this));
 }
 
 Telemetry::Result TelemetryImpl::set_rate_in_air(double rate_hz)
@@ -286,26 +345,26 @@ Telemetry::Result TelemetryImpl::set_rate_vtol_state(double rate_hz)
 
 Telemetry::Result TelemetryImpl::set_rate_landed_state(double rate_hz)
 {
-    return telemetry_result_from_command_result(
-        _system_impl->set_msg_rate(MAVLINK_MSG_ID_EXTENDED_SYS_STATE, rate_hz));
+    return telemetry_result_from_command_result(_system_impl->set_msg_rate(
+        MAVLINK_MSG_ID_EXTENDED_SYS_STATE, rate_hz, MAV_COMP_ID_AUTOPILOT1, this));
 }
 
 Telemetry::Result TelemetryImpl::set_rate_attitude_quaternion(double rate_hz)
 {
-    return telemetry_result_from_command_result(
-        _system_impl->set_msg_rate(MAVLINK_MSG_ID_ATTITUDE_QUATERNION, rate_hz));
+    return telemetry_result_from_command_result(_system_impl->set_msg_rate(
+        MAVLINK_MSG_ID_ATTITUDE_QUATERNION, rate_hz, MAV_COMP_ID_AUTOPILOT1, this));
 }
 
 Telemetry::Result TelemetryImpl::set_rate_attitude_euler(double rate_hz)
 {
     return telemetry_result_from_command_result(
-        _system_impl->set_msg_rate(MAVLINK_MSG_ID_ATTITUDE, rate_hz));
+        _system_impl->set_msg_rate(MAVLINK_MSG_ID_ATTITUDE, rate_hz, MAV_COMP_ID_AUTOPILOT1, this));
 }
 
 Telemetry::Result TelemetryImpl::set_rate_camera_attitude(double rate_hz)
 {
-    return telemetry_result_from_command_result(
-        _system_impl->set_msg_rate(MAVLINK_MSG_ID_MOUNT_ORIENTATION, rate_hz));
+    return telemetry_result_from_command_result(_system_impl->set_msg_rate(
+        MAVLINK_MSG_ID_MOUNT_ORIENTATION, rate_hz, MAV_COMP_ID_AUTOPILOT1, this));
 }
 
 Telemetry::Result TelemetryImpl::set_rate_velocity_ned(double rate_hz)
@@ -313,50 +372,50 @@ Telemetry::Result TelemetryImpl::set_rate_velocity_ned(double rate_hz)
     _velocity_ned_rate_hz = rate_hz;
     double max_rate_hz = std::max(_position_rate_hz, _velocity_ned_rate_hz);
 
-    return telemetry_result_from_command_result(
-        _system_impl->set_msg_rate(MAVLINK_MSG_ID_GLOBAL_POSITION_INT, max_rate_hz));
+    return telemetry_result_from_command_result(_system_impl->set_msg_rate(
+        MAVLINK_MSG_ID_GLOBAL_POSITION_INT, max_rate_hz, MAV_COMP_ID_AUTOPILOT1, this));
 }
 
 Telemetry::Result TelemetryImpl::set_rate_imu(double rate_hz)
 {
-    return telemetry_result_from_command_result(
-        _system_impl->set_msg_rate(MAVLINK_MSG_ID_HIGHRES_IMU, rate_hz));
+    return telemetry_result_from_command_result(_system_impl->set_msg_rate(
+        MAVLINK_MSG_ID_HIGHRES_IMU, rate_hz, MAV_COMP_ID_AUTOPILOT1, this));
 }
 
 Telemetry::Result TelemetryImpl::set_rate_scaled_imu(double rate_hz)
 {
-    return telemetry_result_from_command_result(
-        _system_impl->set_msg_rate(MAVLINK_MSG_ID_SCALED_IMU, rate_hz));
+    return telemetry_result_from_command_result(_system_impl->set_msg_rate(
+        MAVLINK_MSG_ID_SCALED_IMU, rate_hz, MAV_COMP_ID_AUTOPILOT1, this));
 }
 
 Telemetry::Result TelemetryImpl::set_rate_raw_imu(double rate_hz)
 {
     return telemetry_result_from_command_result(
-        _system_impl->set_msg_rate(MAVLINK_MSG_ID_RAW_IMU, rate_hz));
+        _system_impl->set_msg_rate(MAVLINK_MSG_ID_RAW_IMU, rate_hz, MAV_COMP_ID_AUTOPILOT1, this));
 }
 
 Telemetry::Result TelemetryImpl::set_rate_fixedwing_metrics(double rate_hz)
 {
     return telemetry_result_from_command_result(
-        _system_impl->set_msg_rate(MAVLINK_MSG_ID_VFR_HUD, rate_hz));
+        _system_impl->set_msg_rate(MAVLINK_MSG_ID_VFR_HUD, rate_hz, MAV_COMP_ID_AUTOPILOT1, this));
 }
 
 Telemetry::Result TelemetryImpl::set_rate_ground_truth(double rate_hz)
 {
-    return telemetry_result_from_command_result(
-        _system_impl->set_msg_rate(MAVLINK_MSG_ID_HIL_STATE_QUATERNION, rate_hz));
+    return telemetry_result_from_command_result(_system_impl->set_msg_rate(
+        MAVLINK_MSG_ID_HIL_STATE_QUATERNION, rate_hz, MAV_COMP_ID_AUTOPILOT1, this));
 }
 
 Telemetry::Result TelemetryImpl::set_rate_gps_info(double rate_hz)
 {
-    return telemetry_result_from_command_result(
-        _system_impl->set_msg_rate(MAVLINK_MSG_ID_GPS_RAW_INT, rate_hz));
+    return telemetry_result_from_command_result(_system_impl->set_msg_rate(
+        MAVLINK_MSG_ID_GPS_RAW_INT, rate_hz, MAV_COMP_ID_AUTOPILOT1, this));
 }
 
 Telemetry::Result TelemetryImpl::set_rate_battery(double rate_hz)
 {
-    return telemetry_result_from_command_result(
-        _system_impl->set_msg_rate(MAVLINK_MSG_ID_BATTERY_STATUS, rate_hz));
+    return telemetry_result_from_command_result(_system_impl->set_msg_rate(
+        MAVLINK_MSG_ID_BATTERY_STATUS, rate_hz, MAV_COMP_ID_AUTOPILOT1, this));
 }
 
 Telemetry::Result TelemetryImpl::set_rate_rc_status(double rate_hz)
@@ -368,44 +427,44 @@ Telemetry::Result TelemetryImpl::set_rate_rc_status(double rate_hz)
 
 Telemetry::Result TelemetryImpl::set_rate_actuator_control_target(double rate_hz)
 {
-    return telemetry_result_from_command_result(
-        _system_impl->set_msg_rate(MAVLINK_MSG_ID_ACTUATOR_CONTROL_TARGET, rate_hz));
+    return telemetry_result_from_command_result(_system_impl->set_msg_rate(
+        MAVLINK_MSG_ID_ACTUATOR_CONTROL_TARGET, rate_hz, MAV_COMP_ID_AUTOPILOT1, this));
 }
 
 Telemetry::Result TelemetryImpl::set_rate_actuator_output_status(double rate_hz)
 {
-    return telemetry_result_from_command_result(
-        _system_impl->set_msg_rate(MAVLINK_MSG_ID_ACTUATOR_OUTPUT_STATUS, rate_hz));
+    return telemetry_result_from_command_result(_system_impl->set_msg_rate(
+        MAVLINK_MSG_ID_ACTUATOR_OUTPUT_STATUS, rate_hz, MAV_COMP_ID_AUTOPILOT1, this));
 }
 
 Telemetry::Result TelemetryImpl::set_rate_odometry(double rate_hz)
 {
     return telemetry_result_from_command_result(
-        _system_impl->set_msg_rate(MAVLINK_MSG_ID_ODOMETRY, rate_hz));
+        _system_impl->set_msg_rate(MAVLINK_MSG_ID_ODOMETRY, rate_hz, MAV_COMP_ID_AUTOPILOT1, this));
 }
 
 Telemetry::Result TelemetryImpl::set_rate_distance_sensor(double rate_hz)
 {
-    return telemetry_result_from_command_result(
-        _system_impl->set_msg_rate(MAVLINK_MSG_ID_DISTANCE_SENSOR, rate_hz));
+    return telemetry_result_from_command_result(_system_impl->set_msg_rate(
+        MAVLINK_MSG_ID_DISTANCE_SENSOR, rate_hz, MAV_COMP_ID_AUTOPILOT1, this));
 }
 
 Telemetry::Result TelemetryImpl::set_rate_scaled_pressure(double rate_hz)
 {
-    return telemetry_result_from_command_result(
-        _system_impl->set_msg_rate(MAVLINK_MSG_ID_SCALED_PRESSURE, rate_hz));
+    return telemetry_result_from_command_result(_system_impl->set_msg_rate(
+        MAVLINK_MSG_ID_SCALED_PRESSURE, rate_hz, MAV_COMP_ID_AUTOPILOT1, this));
 }
 
 Telemetry::Result TelemetryImpl::set_rate_unix_epoch_time(double rate_hz)
 {
-    return telemetry_result_from_command_result(
-        _system_impl->set_msg_rate(MAVLINK_MSG_ID_UTM_GLOBAL_POSITION, rate_hz));
+    return telemetry_result_from_command_result(_system_impl->set_msg_rate(
+        MAVLINK_MSG_ID_UTM_GLOBAL_POSITION, rate_hz, MAV_COMP_ID_AUTOPILOT1, this));
 }
 
 Telemetry::Result TelemetryImpl::set_rate_altitude(double rate_hz)
 {
     return telemetry_result_from_command_result(
-        _system_impl->set_msg_rate(MAVLINK_MSG_ID_ALTITUDE, rate_hz));
+        _system_impl->set_msg_rate(MAVLINK_MSG_ID_ALTITUDE, rate_hz, MAV_COMP_ID_AUTOPILOT1, this));
 }
 
 void TelemetryImpl::set_rate_position_velocity_ned_async(
@@ -416,7 +475,9 @@ void TelemetryImpl::set_rate_position_velocity_ned_async(
         rate_hz,
         [callback](MavlinkCommandSender::Result command_result, float) {
             command_result_callback(command_result, callback);
-        });
+        },
+        MAV_COMP_ID_AUTOPILOT1,
+        this);
 }
 
 void TelemetryImpl::set_rate_position_async(double rate_hz, Telemetry::ResultCallback callback)
@@ -429,7 +490,9 @@ void TelemetryImpl::set_rate_position_async(double rate_hz, Telemetry::ResultCal
         max_rate_hz,
         [callback](MavlinkCommandSender::Result command_result, float) {
             command_result_callback(command_result, callback);
-        });
+        },
+        MAV_COMP_ID_AUTOPILOT1,
+        this);
 }
 
 void TelemetryImpl::set_rate_home_async(double rate_hz, Telemetry::ResultCallback callback)
@@ -439,7 +502,9 @@ void TelemetryImpl::set_rate_home_async(double rate_hz, Telemetry::ResultCallbac
         rate_hz,
         [callback](MavlinkCommandSender::Result command_result, float) {
             command_result_callback(command_result, callback);
-        });
+        },
+        MAV_COMP_ID_AUTOPILOT1,
+        this);
 }
 
 void TelemetryImpl::set_rate_in_air_async(double rate_hz, Telemetry::ResultCallback callback)
@@ -459,7 +524,9 @@ void TelemetryImpl::set_rate_landed_state_async(double rate_hz, Telemetry::Resul
         rate_hz,
         [callback](MavlinkCommandSender::Result command_result, float) {
             command_result_callback(command_result, callback);
-        });
+        },
+        MAV_COMP_ID_AUTOPILOT1,
+        this);
 }
 
 void TelemetryImpl::set_rate_altitude_async(double rate_hz, Telemetry::ResultCallback callback)
@@ -469,7 +536,137 @@ void TelemetryImpl::set_rate_altitude_async(double rate_hz, Telemetry::ResultCal
         rate_hz,
         [callback](MavlinkCommandSender::Result command_result, float) {
             command_result_callback(command_result, callback);
-        });
+        },
+        MAV_COMP_ID_AUTOPILOT1,
+        this);
+}
+
+void TelemetryImpl::set_automatic_rates_enabled(bool enabled)
+{
+    std::lock_guard<std::mutex> lock(_subscription_mutex);
+
+    if (enabled) {
+        _automatic_rates_enabled = true;
+        for (const auto message_id : automatic_rate_message_ids) {
+            update_automatic_rate(message_id);
+        }
+    } else if (_automatic_rates_enabled.exchange(false)) {
+        for (const auto message_id : automatic_rate_message_ids) {
+            _system_impl->set_msg_rate_async(
+                message_id, 0.0, nullptr, MAV_COMP_ID_AUTOPILOT1, this);
+        }
+    }
+}
+
+void TelemetryImpl::update_automatic_rate(uint16_t message_id)
+{
+    if (!_automatic_rates_enabled) {
+        return;
+    }
+
+    // Subscribers taking every message get the default rate, unless another
+    // one asks for a specific rate.
+    const double rate_hz = subscriber_rate_hz(message_id).value_or(automatic_idle_rate_hz);
+
+    // The rate is only sent if it changes.
+    _system_impl->set_msg_rate_async(message_id, rate_hz, nullptr, MAV_COMP_ID_AUTOPILOT1, this);
+}
+
+void TelemetryImpl::set_on_demand_decoding_enabled(bool enabled)
+{
+    std::lock_guard<std::mutex> lock(_subscription_mutex);
+    update_message_demand();
+    set_handlers_on_demand(enabled);
+}
+
+void TelemetryImpl::polled(uint16_t message_id)
+{
+    keep_handler(message_id);
+}
+
+void TelemetryImpl::subscriptions_changed(uint16_t message_id)
+{
+    update_automatic_rate(message_id);
+    update_message_demand();
+}
+
+void TelemetryImpl::update_message_demand()
+{
+    for (const auto message_id : on_demand_message_ids) {
+        set_handler_needed(message_id, message_needed(message_id));
+    }
+}
+
+bool TelemetryImpl::message_needed(uint16_t message_id)
+{
+    switch (message_id) {
+        case MAVLINK_MSG_ID_GLOBAL_POSITION_INT:
+            return !_position_subscriptions.empty() || !_velocity_ned_subscriptions.empty() ||
+                   !_heading_subscriptions.empty() || _history_enabled ||
+                   std::atomic_load(&_shared_memory_writer) != nullptr;
+        case MAVLINK_MSG_ID_ATTITUDE_QUATERNION:
+            // The Euler angles are derived from the quaternion.
+            return !_attitude_quaternion_angle_subscriptions.empty() ||
+                   !_attitude_angular_velocity_body_subscriptions.empty() ||
+                   !_attitude_euler_angle_subscriptions.empty() || _history_enabled ||
+                   std::atomic_load(&_shared_memory_writer) != nullptr;
+        case MAVLINK_MSG_ID_ATTITUDE:
+            return !_attitude_euler_angle_subscriptions.empty() ||
+                   !_attitude_angular_velocity_body_subscriptions.empty();
+        case MAVLINK_MSG_ID_HIGHRES_IMU:
+            return !_imu_reading_ned_subscriptions.empty();
+        case MAVLINK_MSG_ID_SCALED_IMU:
+            return !_scaled_imu_subscriptions.empty();
+        case MAVLINK_MSG_ID_RAW_IMU:
+            return !_raw_imu_subscriptions.empty();
+        case MAVLINK_MSG_ID_VFR_HUD:
+            return !_fixedwing_metrics_subscriptions.empty();
+        case MAVLINK_MSG_ID_HIL_STATE_QUATERNION:
+            return !_ground_truth_subscriptions.empty();
+        case MAVLINK_MSG_ID_ODOMETRY:
+            return !_odometry_subscriptions.empty();
+        case MAVLINK_MSG_ID_ALTITUDE:
+            return !_altitude_subscriptions.empty();
+        default:
+            return true;
+    }
+}
+
+std::optional<double> TelemetryImpl::subscriber_rate_hz(uint16_t message_id) const
+{
+    switch (message_id) {
+        case MAVLINK_MSG_ID_LOCAL_POSITION_NED:
+            return _position_velocity_ned_subscriptions.max_rate_hz();
+        case MAVLINK_MSG_ID_GLOBAL_POSITION_INT:
+            return highest_rate_hz(
+                {_position_subscriptions.max_rate_hz(),
+                 _velocity_ned_subscriptions.max_rate_hz(),
+                 _heading_subscriptions.max_rate_hz()});
+        case MAVLINK_MSG_ID_ATTITUDE_QUATERNION:
+            return highest_rate_hz(
+                {_attitude_quaternion_angle_subscriptions.max_rate_hz(),
+                 _attitude_angular_velocity_body_subscriptions.max_rate_hz()});
+        case MAVLINK_MSG_ID_ATTITUDE:
+            return highest_rate_hz(
+                {_attitude_euler_angle_subscriptions.max_rate_hz(),
+                 _attitude_angular_velocity_body_subscriptions.max_rate_hz()});
+        case MAVLINK_MSG_ID_HIGHRES_IMU:
+            return _imu_reading_ned_subscriptions.max_rate_hz();
+        case MAVLINK_MSG_ID_SCALED_IMU:
+            return _scaled_imu_subscriptions.max_rate_hz();
+        case MAVLINK_MSG_ID_RAW_IMU:
+            return _raw_imu_subscriptions.max_rate_hz();
+        case MAVLINK_MSG_ID_VFR_HUD:
+            return _fixedwing_metrics_subscriptions.max_rate_hz();
+        case MAVLINK_MSG_ID_HIL_STATE_QUATERNION:
+            return _ground_truth_subscriptions.max_rate_hz();
+        case MAVLINK_MSG_ID_ODOMETRY:
+            return _odometry_subscriptions.max_rate_hz();
+        case MAVLINK_MSG_ID_ALTITUDE:
+            return _altitude_subscriptions.max_rate_hz();
+        default:
+            return std::nullopt;
+    }
 }
 
 void TelemetryImpl::set_rate_attitude_quaternion_async(
@@ -480,7 +677,9 @@ void TelemetryImpl::set_rate_attitude_quaternion_async(
         rate_hz,
         [callback](MavlinkCommandSender::Result command_result, float) {
             command_result_callback(command_result, callback);
-        });
+        },
+        MAV_COMP_ID_AUTOPILOT1,
+        this);
 }
 
 void TelemetryImpl::set_rate_attitude_euler_async(
@@ -491,7 +690,9 @@ void TelemetryImpl::set_rate_attitude_euler_async(
         rate_hz,
         [callback](MavlinkCommandSender::Result command_result, float) {
             command_result_callback(command_result, callback);
-        });
+        },
+        MAV_COMP_ID_AUTOPILOT1,
+        this);
 }
 
 void TelemetryImpl::set_rate_camera_attitude_async(
@@ -502,7 +703,9 @@ void TelemetryImpl::set_rate_camera_attitude_async(
         rate_hz,
         [callback](MavlinkCommandSender::Result command_result, float) {
             command_result_callback(command_result, callback);
-        });
+        },
+        MAV_COMP_ID_AUTOPILOT1,
+        this);
 }
 
 void TelemetryImpl::set_rate_velocity_ned_async(double rate_hz, Telemetry::ResultCallback callback)
@@ -515,7 +718,9 @@ void TelemetryImpl::set_rate_velocity_ned_async(double rate_hz, Telemetry::Resul
         max_rate_hz,
         [callback](MavlinkCommandSender::Result command_result, float) {
             command_result_callback(command_result, callback);
-        });
+        },
+        MAV_COMP_ID_AUTOPILOT1,
+        this);
 }
 
 void TelemetryImpl::set_rate_imu_async(double rate_hz, Telemetry::ResultCallback callback)
@@ -525,7 +730,9 @@ void TelemetryImpl::set_rate_imu_async(double rate_hz, Telemetry::ResultCallback
         rate_hz,
         [callback](MavlinkCommandSender::Result command_result, float) {
             command_result_callback(command_result, callback);
-        });
+        },
+        MAV_COMP_ID_AUTOPILOT1,
+        this);
 }
 
 void TelemetryImpl::set_rate_scaled_imu_async(double rate_hz, Telemetry::ResultCallback callback)
@@ -535,7 +742,9 @@ void TelemetryImpl::set_rate_scaled_imu_async(double rate_hz, Telemetry::ResultC
         rate_hz,
         [callback](MavlinkCommandSender::Result command_result, float) {
             command_result_callback(command_result, callback);
-        });
+        },
+        MAV_COMP_ID_AUTOPILOT1,
+        this);
 }
 
 void TelemetryImpl::set_rate_raw_imu_async(double rate_hz, Telemetry::ResultCallback callback)
@@ -545,7 +754,9 @@ void TelemetryImpl::set_rate_raw_imu_async(double rate_hz, Telemetry::ResultCall
         rate_hz,
         [callback](MavlinkCommandSender::Result command_result, float) {
             command_result_callback(command_result, callback);
-        });
+        },
+        MAV_COMP_ID_AUTOPILOT1,
+        this);
 }
 
 void TelemetryImpl::set_rate_fixedwing_metrics_async(
@@ -556,7 +767,9 @@ void TelemetryImpl::set_rate_fixedwing_metrics_async(
         rate_hz,
         [callback](MavlinkCommandSender::Result command_result, float) {
             command_result_callback(command_result, callback);
-        });
+        },
+        MAV_COMP_ID_AUTOPILOT1,
+        this);
 }
 
 void TelemetryImpl::set_rate_ground_truth_async(double rate_hz, Telemetry::ResultCallback callback)
@@ -566,7 +779,9 @@ void TelemetryImpl::set_rate_ground_truth_async(double rate_hz, Telemetry::Resul
         rate_hz,
         [callback](MavlinkCommandSender::Result command_result, float) {
             command_result_callback(command_result, callback);
-        });
+        },
+        MAV_COMP_ID_AUTOPILOT1,
+        this);
 }
 
 void TelemetryImpl::set_rate_gps_info_async(double rate_hz, Telemetry::ResultCallback callback)
@@ -576,7 +791,9 @@ void TelemetryImpl::set_rate_gps_info_async(double rate_hz, Telemetry::ResultCal
         rate_hz,
         [callback](MavlinkCommandSender::Result command_result, float) {
             command_result_callback(command_result, callback);
-        });
+        },
+        MAV_COMP_ID_AUTOPILOT1,
+        this);
 }
 
 void TelemetryImpl::set_rate_battery_async(double rate_hz, Telemetry::ResultCallback callback)
@@ -586,7 +803,9 @@ void TelemetryImpl::set_rate_battery_async(double rate_hz, Telemetry::ResultCall
         rate_hz,
         [callback](MavlinkCommandSender::Result command_result, float) {
             command_result_callback(command_result, callback);
-        });
+        },
+        MAV_COMP_ID_AUTOPILOT1,
+        this);
 }
 
 void TelemetryImpl::set_rate_rc_status_async(double rate_hz, Telemetry::ResultCallback callback)
@@ -604,7 +823,9 @@ void TelemetryImpl::set_rate_unix_epoch_time_async(
         rate_hz,
         [callback](MavlinkCommandSender::Result command_result, float) {
             command_result_callback(command_result, callback);
-        });
+        },
+        MAV_COMP_ID_AUTOPILOT1,
+        this);
 }
 
 void TelemetryImpl::set_rate_actuator_control_target_async(
@@ -615,7 +836,9 @@ void TelemetryImpl::set_rate_actuator_control_target_async(
         rate_hz,
         [callback](MavlinkCommandSender::Result command_result, float) {
             command_result_callback(command_result, callback);
-        });
+        },
+        MAV_COMP_ID_AUTOPILOT1,
+        this);
 }
 
 void TelemetryImpl::set_rate_actuator_output_status_async(
@@ -626,7 +849,9 @@ void TelemetryImpl::set_rate_actuator_output_status_async(
         rate_hz,
         [callback](MavlinkCommandSender::Result command_result, float) {
             command_result_callback(command_result, callback);
-        });
+        },
+        MAV_COMP_ID_AUTOPILOT1,
+        this);
 }
 
 void TelemetryImpl::set_rate_odometry_async(double rate_hz, Telemetry::ResultCallback callback)
@@ -636,7 +861,9 @@ void TelemetryImpl::set_rate_odometry_async(double rate_hz, Telemetry::ResultCal
         rate_hz,
         [callback](MavlinkCommandSender::Result command_result, float) {
             command_result_callback(command_result, callback);
-        });
+        },
+        MAV_COMP_ID_AUTOPILOT1,
+        this);
 }
 
 void TelemetryImpl::set_rate_distance_sensor_async(
@@ -647,7 +874,9 @@ void TelemetryImpl::set_rate_distance_sensor_async(
         rate_hz,
         [callback](MavlinkCommandSender::Result command_result, float) {
             command_result_callback(command_result, callback);
-        });
+        },
+        MAV_COMP_ID_AUTOPILOT1,
+        this);
 }
 
 void TelemetryImpl::set_rate_scaled_pressure_async(
@@ -658,7 +887,9 @@ void TelemetryImpl::set_rate_scaled_pressure_async(
         rate_hz,
         [callback](MavlinkCommandSender::Result command_result, float) {
             command_result_callback(command_result, callback);
-        });
+        },
+        MAV_COMP_ID_AUTOPILOT1,
+        this);
 }
 
 Telemetry::Result
@@ -711,7 +942,7 @@ void TelemetryImpl::process_position_velocity_ned(const mavlink_message_t& messa
 
     std::lock_guard<std::mutex> lock(_subscription_mutex);
     _position_velocity_ned_subscriptions.queue(position_velocity_ned(), [this](const auto& func) {
-        _system_impl->call_user_callback(func);
+        _system_impl->call_user_callback(func, nullptr, CallbackLane::Telemetry);
     });
 
     set_health_local_position(true);
@@ -719,8 +950,12 @@ void TelemetryImpl::process_position_velocity_ned(const mavlink_message_t& messa
 
 void TelemetryImpl::process_global_position_int(const mavlink_message_t& message)
 {
-    mavlink_global_position_int_t global_position_int;
-    mavlink_msg_global_position_int_decode(&message, &global_position_int);
+    const auto& global_position_int =
+        DecodedMessage::get(message, mavlink_msg_global_position_int_decode);
+
+    const auto receive_timestamp_us = _system_impl->get_time().elapsed_us();
+    const auto autopilot_timestamp_us =
+        static_cast<uint64_t>(global_position_int.time_boot_ms) * 1000;
 
     {
         Telemetry::Position position;
@@ -729,6 +964,7 @@ void TelemetryImpl::process_global_position_int(const mavlink_message_t& message
         position.absolute_altitude_m = global_position_int.alt * 1e-3f;
         position.relative_altitude_m = global_position_int.relative_alt * 1e-3f;
         set_position(position);
+        _position_history.push(position, receive_timestamp_us, autopilot_timestamp_us);
     }
 
     {
@@ -737,6 +973,7 @@ void TelemetryImpl::process_global_position_int(const mavlink_message_t& message
         velocity.east_m_s = global_position_int.vy * 1e-2f;
         velocity.down_m_s = global_position_int.vz * 1e-2f;
         set_velocity_ned(velocity);
+        _velocity_ned_history.push(velocity, receive_timestamp_us, autopilot_timestamp_us);
     }
 
     {
@@ -748,14 +985,17 @@ void TelemetryImpl::process_global_position_int(const mavlink_message_t& message
     }
 
     std::lock_guard<std::mutex> lock(_subscription_mutex);
-    _position_subscriptions.queue(
-        position(), [this](const auto& func) { _system_impl->call_user_callback(func); });
+    _position_subscriptions.queue(_snapshot.load().position, [this](const auto& func) {
+        _system_impl->call_user_callback(func, nullptr, CallbackLane::Telemetry);
+    });
 
-    _velocity_ned_subscriptions.queue(
-        velocity_ned(), [this](const auto& func) { _system_impl->call_user_callback(func); });
+    _velocity_ned_subscriptions.queue(_snapshot.load().velocity_ned, [this](const auto& func) {
+        _system_impl->call_user_callback(func, nullptr, CallbackLane::Telemetry);
+    });
 
-    _heading_subscriptions.queue(
-        heading(), [this](const auto& func) { _system_impl->call_user_callback(func); });
+    _heading_subscriptions.queue(_heading.load(), [this](const auto& func) {
+        _system_impl->call_user_callback(func, nullptr, CallbackLane::Telemetry);
+    });
 }
 
 void TelemetryImpl::process_home_position(const mavlink_message_t& message)
@@ -773,20 +1013,14 @@ void TelemetryImpl::process_home_position(const mavlink_message_t& message)
     set_health_home_position(true);
 
     std::lock_guard<std::mutex> lock(_subscription_mutex);
-    _home_position_subscriptions.queue(
-        home(), [this](const auto& func) { _system_impl->call_user_callback(func); });
+    _home_position_subscriptions.queue(home(), [this](const auto& func) {
+        _system_impl->call_user_callback(func, nullptr, CallbackLane::Telemetry);
+    });
 }
 
 void TelemetryImpl::process_attitude(const mavlink_message_t& message)
 {
-    mavlink_attitude_t attitude;
-    mavlink_msg_attitude_decode(&message, &attitude);
-
-    Telemetry::EulerAngle euler_angle;
-    euler_angle.roll_deg = to_deg_from_rad(attitude.roll);
-    euler_angle.pitch_deg = to_deg_from_rad(attitude.pitch);
-    euler_angle.yaw_deg = to_deg_from_rad(attitude.yaw);
-    euler_angle.timestamp_us = static_cast<uint64_t>(attitude.time_boot_ms) * 1000;
+    const auto& attitude = DecodedMessage::get(message, mavlink_msg_attitude_decode);
 
     Telemetry::AngularVelocityBody angular_velocity_body;
     angular_velocity_body.roll_rad_s = attitude.rollspeed;
@@ -794,12 +1028,19 @@ void TelemetryImpl::process_attitude(const mavlink_message_t& message)
     angular_velocity_body.yaw_rad_s = attitude.yawspeed;
     set_attitude_angular_velocity_body(angular_velocity_body);
 
-    _attitude_euler_angle_subscriptions.queue(
-        attitude_euler(), [this](const auto& func) { _system_impl->call_user_callback(func); });
+    // The angles are derived from the quaternion, which is only worth it if
+    // anybody wants them.
+    _attitude_euler_angle_subscriptions.queue_lazily(
+        [this]() { return derived_attitude_euler(); },
+        [this](const auto& func) {
+            _system_impl->call_user_callback(func, nullptr, CallbackLane::Telemetry);
+        });
 
     _attitude_angular_velocity_body_subscriptions.queue(
-        attitude_angular_velocity_body(),
-        [this](const auto& func) { _system_impl->call_user_callback(func); });
+        angular_velocity_body,
+        [this](const auto& func) {
+            _system_impl->call_user_callback(func, nullptr, CallbackLane::Telemetry);
+        });
 }
 
 void TelemetryImpl::process_attitude_quaternion(const mavlink_message_t& message)
@@ -821,17 +1062,21 @@ void TelemetryImpl::process_attitude_quaternion(const mavlink_message_t& message
     angular_velocity_body.yaw_rad_s = mavlink_attitude_quaternion.yawspeed;
 
     set_attitude_quaternion(quaternion);
+    _attitude_quaternion_history.push(
+        quaternion, _system_impl->get_time().elapsed_us(), quaternion.timestamp_us);
 
     set_attitude_angular_velocity_body(angular_velocity_body);
 
     std::lock_guard<std::mutex> lock(_subscription_mutex);
-    _attitude_quaternion_angle_subscriptions.queue(attitude_quaternion(), [this](const auto& func) {
-        _system_impl->call_user_callback(func);
+    _attitude_quaternion_angle_subscriptions.queue(quaternion, [this](const auto& func) {
+        _system_impl->call_user_callback(func, nullptr, CallbackLane::Telemetry);
     });
 
     _attitude_angular_velocity_body_subscriptions.queue(
-        attitude_angular_velocity_body(),
-        [this](const auto& func) { _system_impl->call_user_callback(func); });
+        angular_velocity_body,
+        [this](const auto& func) {
+            _system_impl->call_user_callback(func, nullptr, CallbackLane::Telemetry);
+        });
 }
 
 void TelemetryImpl::process_altitude(const mavlink_message_t& message)
@@ -850,8 +1095,9 @@ void TelemetryImpl::process_altitude(const mavlink_message_t& message)
     set_altitude(new_altitude);
 
     std::lock_guard<std::mutex> lock(_subscription_mutex);
-    _altitude_subscriptions.queue(
-        altitude(), [this](const auto& func) { _system_impl->call_user_callback(func); });
+    _altitude_subscriptions.queue(new_altitude, [this](const auto& func) {
+        _system_impl->call_user_callback(func, nullptr, CallbackLane::Telemetry);
+    });
 }
 
 void TelemetryImpl::process_mount_orientation(const mavlink_message_t& message)
@@ -868,13 +1114,17 @@ void TelemetryImpl::process_mount_orientation(const mavlink_message_t& message)
     set_camera_attitude_euler_angle(euler_angle);
 
     std::lock_guard<std::mutex> lock(_subscription_mutex);
-    _camera_attitude_quaternion_subscriptions.queue(
-        camera_attitude_quaternion(),
-        [this](const auto& func) { _system_impl->call_user_callback(func); });
+    _camera_attitude_quaternion_subscriptions.queue_lazily(
+        [this]() { return camera_attitude_quaternion(); },
+        [this](const auto& func) {
+            _system_impl->call_user_callback(func, nullptr, CallbackLane::Telemetry);
+        });
 
-    _camera_attitude_euler_angle_subscriptions.queue(
-        camera_attitude_euler(),
-        [this](const auto& func) { _system_impl->call_user_callback(func); });
+    _camera_attitude_euler_angle_subscriptions.queue_lazily(
+        [this]() { return camera_attitude_euler(); },
+        [this](const auto& func) {
+            _system_impl->call_user_callback(func, nullptr, CallbackLane::Telemetry);
+        });
 }
 
 void TelemetryImpl::process_gimbal_device_attitude_status(const mavlink_message_t& message)
@@ -891,24 +1141,25 @@ void TelemetryImpl::process_gimbal_device_attitude_status(const mavlink_message_
     q.y = attitude_status.q[2];
     q.z = attitude_status.q[3];
 
-    Telemetry::EulerAngle euler_angle = to_euler_angle_from_quaternion(q);
-
-    set_camera_attitude_euler_angle(euler_angle);
+    set_camera_attitude_quaternion(q);
 
     std::lock_guard<std::mutex> lock(_subscription_mutex);
-    _camera_attitude_quaternion_subscriptions.queue(
-        camera_attitude_quaternion(),
-        [this](const auto& func) { _system_impl->call_user_callback(func); });
+    _camera_attitude_quaternion_subscriptions.queue_lazily(
+        [this]() { return camera_attitude_quaternion(); },
+        [this](const auto& func) {
+            _system_impl->call_user_callback(func, nullptr, CallbackLane::Telemetry);
+        });
 
-    _camera_attitude_euler_angle_subscriptions.queue(
-        camera_attitude_euler(),
-        [this](const auto& func) { _system_impl->call_user_callback(func); });
+    _camera_attitude_euler_angle_subscriptions.queue_lazily(
+        [this]() { return camera_attitude_euler(); },
+        [this](const auto& func) {
+            _system_impl->call_user_callback(func, nullptr, CallbackLane::Telemetry);
+        });
 }
 
 void TelemetryImpl::process_imu_reading_ned(const mavlink_message_t& message)
 {
-    mavlink_highres_imu_t highres_imu;
-    mavlink_msg_highres_imu_decode(&message, &highres_imu);
+    const auto& highres_imu = DecodedMessage::get(message, mavlink_msg_highres_imu_decode);
     Telemetry::Imu new_imu;
     new_imu.acceleration_frd.forward_m_s2 = highres_imu.xacc;
     new_imu.acceleration_frd.right_m_s2 = highres_imu.yacc;
@@ -925,8 +1176,9 @@ void TelemetryImpl::process_imu_reading_ned(const mavlink_message_t& message)
     set_imu_reading_ned(new_imu);
 
     std::lock_guard<std::mutex> lock(_subscription_mutex);
-    _imu_reading_ned_subscriptions.queue(
-        imu(), [this](const auto& func) { _system_impl->call_user_callback(func); });
+    _imu_reading_ned_subscriptions.queue(new_imu, [this](const auto& func) {
+        _system_impl->call_user_callback(func, nullptr, CallbackLane::Telemetry);
+    });
 }
 
 void TelemetryImpl::process_scaled_imu(const mavlink_message_t& message)
@@ -949,8 +1201,9 @@ void TelemetryImpl::process_scaled_imu(const mavlink_message_t& message)
     set_scaled_imu(new_imu);
 
     std::lock_guard<std::mutex> lock(_subscription_mutex);
-    _scaled_imu_subscriptions.queue(
-        scaled_imu(), [this](const auto& func) { _system_impl->call_user_callback(func); });
+    _scaled_imu_subscriptions.queue(new_imu, [this](const auto& func) {
+        _system_impl->call_user_callback(func, nullptr, CallbackLane::Telemetry);
+    });
 }
 
 void TelemetryImpl::process_raw_imu(const mavlink_message_t& message)
@@ -973,8 +1226,9 @@ void TelemetryImpl::process_raw_imu(const mavlink_message_t& message)
     set_raw_imu(new_imu);
 
     std::lock_guard<std::mutex> lock(_subscription_mutex);
-    _raw_imu_subscriptions.queue(
-        raw_imu(), [this](const auto& func) { _system_impl->call_user_callback(func); });
+    _raw_imu_subscriptions.queue(new_imu, [this](const auto& func) {
+        _system_impl->call_user_callback(func, nullptr, CallbackLane::Telemetry);
+    });
 }
 
 void TelemetryImpl::process_gps_raw_int(const mavlink_message_t& message)
@@ -1043,10 +1297,12 @@ void TelemetryImpl::process_gps_raw_int(const mavlink_message_t& message)
 
     {
         std::lock_guard<std::mutex> lock(_subscription_mutex);
-        _gps_info_subscriptions.queue(
-            gps_info(), [this](const auto& func) { _system_impl->call_user_callback(func); });
-        _raw_gps_subscriptions.queue(
-            raw_gps(), [this](const auto& func) { _system_impl->call_user_callback(func); });
+        _gps_info_subscriptions.queue(gps_info(), [this](const auto& func) {
+            _system_impl->call_user_callback(func, nullptr, CallbackLane::Telemetry);
+        });
+        _raw_gps_subscriptions.queue(raw_gps(), [this](const auto& func) {
+            _system_impl->call_user_callback(func, nullptr, CallbackLane::Telemetry);
+        });
     }
 
     _system_impl->refresh_timeout_handler(_gps_raw_timeout_cookie);
@@ -1065,14 +1321,15 @@ void TelemetryImpl::process_ground_truth(const mavlink_message_t& message)
     set_ground_truth(new_ground_truth);
 
     std::lock_guard<std::mutex> lock(_subscription_mutex);
-    _ground_truth_subscriptions.queue(
-        ground_truth(), [this](const auto& func) { _system_impl->call_user_callback(func); });
+    _ground_truth_subscriptions.queue(new_ground_truth, [this](const auto& func) {
+        _system_impl->call_user_callback(func, nullptr, CallbackLane::Telemetry);
+    });
 }
 
 void TelemetryImpl::process_extended_sys_state(const mavlink_message_t& message)
 {
-    mavlink_extended_sys_state_t extended_sys_state;
-    mavlink_msg_extended_sys_state_decode(&message, &extended_sys_state);
+    const auto& extended_sys_state =
+        DecodedMessage::get(message, mavlink_msg_extended_sys_state_decode);
 
     {
         Telemetry::LandedState landed_state = to_landed_state(extended_sys_state);
@@ -1083,11 +1340,11 @@ void TelemetryImpl::process_extended_sys_state(const mavlink_message_t& message)
     }
 
     std::lock_guard<std::mutex> lock(_subscription_mutex);
-    _landed_state_subscriptions.queue(
-        landed_state(), [this](const auto& func) { _system_impl->call_user_callback(func); });
+    queue_state_if_due(
+        _landed_state_subscriptions, _landed_state_filter, [this]() { return landed_state(); });
 
-    _vtol_state_subscriptions.queue(
-        vtol_state(), [this](const auto& func) { _system_impl->call_user_callback(func); });
+    queue_state_if_due(
+        _vtol_state_subscriptions, _vtol_state_filter, [this]() { return vtol_state(); });
 
     if (extended_sys_state.landed_state == MAV_LANDED_STATE_IN_AIR ||
         extended_sys_state.landed_state == MAV_LANDED_STATE_TAKEOFF ||
@@ -1098,8 +1355,7 @@ void TelemetryImpl::process_extended_sys_state(const mavlink_message_t& message)
     }
     // If landed_state is undefined, we use what we have received last.
 
-    _in_air_subscriptions.queue(
-        in_air(), [this](const auto& func) { _system_impl->call_user_callback(func); });
+    queue_state_if_due(_in_air_subscriptions, _in_air_filter, [this]() { return in_air(); });
 }
 void TelemetryImpl::process_fixedwing_metrics(const mavlink_message_t& message)
 {
@@ -1114,8 +1370,9 @@ void TelemetryImpl::process_fixedwing_metrics(const mavlink_message_t& message)
     set_fixedwing_metrics(new_fixedwing_metrics);
 
     std::lock_guard<std::mutex> lock(_subscription_mutex);
-    _fixedwing_metrics_subscriptions.queue(
-        fixedwing_metrics(), [this](const auto& func) { _system_impl->call_user_callback(func); });
+    _fixedwing_metrics_subscriptions.queue(new_fixedwing_metrics, [this](const auto& func) {
+        _system_impl->call_user_callback(func, nullptr, CallbackLane::Telemetry);
+    });
 }
 
 void TelemetryImpl::process_sys_status(const mavlink_message_t& message)
@@ -1132,8 +1389,9 @@ void TelemetryImpl::process_sys_status(const mavlink_message_t& message)
 
         {
             std::lock_guard<std::mutex> lock(_subscription_mutex);
-            _battery_subscriptions.queue(
-                battery(), [this](const auto& func) { _system_impl->call_user_callback(func); });
+            _battery_subscriptions.queue(battery(), [this](const auto& func) {
+                _system_impl->call_user_callback(func, nullptr, CallbackLane::Telemetry);
+            });
         }
     }
 
@@ -1142,25 +1400,21 @@ void TelemetryImpl::process_sys_status(const mavlink_message_t& message)
 
     set_rc_status({rc_ok}, std::nullopt);
 
-    if (sys_status.onboard_control_sensors_present & MAV_SYS_STATUS_SENSOR_3D_GYRO) {
-        set_health_gyrometer_calibration(
-            sys_status.onboard_control_sensors_health & MAV_SYS_STATUS_SENSOR_3D_GYRO);
-    } else {
-        // If the flag is not supported yet, we fall back to the param.
-    }
+    const auto present = sys_status.onboard_control_sensors_present;
+    const auto healthy = sys_status.onboard_control_sensors_health;
 
-    if (sys_status.onboard_control_sensors_present & MAV_SYS_STATUS_SENSOR_3D_ACCEL) {
-        set_health_accelerometer_calibration(
-            sys_status.onboard_control_sensors_health & MAV_SYS_STATUS_SENSOR_3D_ACCEL);
-    } else {
-        // If the flag is not supported yet, we fall back to the param.
+    // If a calibration flag is not supported yet, we fall back to the param.
+    const bool has_gyro = (present & MAV_SYS_STATUS_SENSOR_3D_GYRO) != 0;
+    const bool has_accel = (present & MAV_SYS_STATUS_SENSOR_3D_ACCEL) != 0;
+    const bool has_mag = (present & MAV_SYS_STATUS_SENSOR_3D_MAG) != 0;
+    if (has_gyro) {
+        _has_received_gyro_calibration = true;
     }
-
-    if (sys_status.onboard_control_sensors_present & MAV_SYS_STATUS_SENSOR_3D_MAG) {
-        set_health_magnetometer_calibration(
-            sys_status.onboard_control_sensors_health & MAV_SYS_STATUS_SENSOR_3D_MAG);
-    } else {
-        // If the flag is not supported yet, we fall back to the param.
+    if (has_accel) {
+        _has_received_accel_calibration = true;
+    }
+    if (has_mag) {
+        _has_received_mag_calibration = true;
     }
 
     const bool global_position_ok =
@@ -1174,8 +1428,27 @@ void TelemetryImpl::process_sys_status(const mavlink_message_t& message)
         sys_status_present_enabled_health(sys_status, MAV_SYS_STATUS_SENSOR_OPTICAL_FLOW) ||
         sys_status_present_enabled_health(sys_status, MAV_SYS_STATUS_SENSOR_VISION_POSITION);
 
-    set_health_local_position(local_position_ok);
-    set_health_global_position(global_position_ok);
+    const bool armable = (healthy & MAV_SYS_STATUS_PREARM_CHECK) != 0;
+
+    // Everything derived from the flags goes into the snapshot at once,
+    // rather than one update per flag.
+    update_health([&](Telemetry::Health& health) {
+        if (has_gyro) {
+            health.is_gyrometer_calibration_ok =
+                (healthy & MAV_SYS_STATUS_SENSOR_3D_GYRO) != 0 || _hitl_enabled;
+        }
+        if (has_accel) {
+            health.is_accelerometer_calibration_ok =
+                (healthy & MAV_SYS_STATUS_SENSOR_3D_ACCEL) != 0 || _hitl_enabled;
+        }
+        if (has_mag) {
+            health.is_magnetometer_calibration_ok =
+                (healthy & MAV_SYS_STATUS_SENSOR_3D_MAG) != 0 || _hitl_enabled;
+        }
+        health.is_local_position_ok = local_position_ok;
+        health.is_global_position_ok = global_position_ok;
+        health.is_armable = armable;
+    });
 
     // If any of these sensors were marked present, we don't have to fall back to check for
     // satellite count.
@@ -1187,16 +1460,12 @@ void TelemetryImpl::process_sys_status(const mavlink_message_t& message)
             SysStatusUsed::Yes :
             SysStatusUsed::No;
 
-    set_rc_status({rc_ok}, std::nullopt);
-
     std::lock_guard<std::mutex> lock(_subscription_mutex);
-    _rc_status_subscriptions.queue(
-        rc_status(), [this](const auto& func) { _system_impl->call_user_callback(func); });
+    queue_state_if_due(
+        _rc_status_subscriptions, _rc_status_filter, [this]() { return rc_status(); });
 
-    const bool armable = sys_status.onboard_control_sensors_health & MAV_SYS_STATUS_PREARM_CHECK;
-    set_health_armable(armable);
-    _health_all_ok_subscriptions.queue(
-        health_all_ok(), [this](const auto& func) { _system_impl->call_user_callback(func); });
+    queue_state_if_due(
+        _health_all_ok_subscriptions, _health_all_ok_filter, [this]() { return health_all_ok(); });
 }
 
 bool TelemetryImpl::sys_status_present_enabled_health(
@@ -1238,8 +1507,9 @@ void TelemetryImpl::process_battery_status(const mavlink_message_t& message)
 
     {
         std::lock_guard<std::mutex> lock(_subscription_mutex);
-        _battery_subscriptions.queue(
-            battery(), [this](const auto& func) { _system_impl->call_user_callback(func); });
+        _battery_subscriptions.queue(battery(), [this](const auto& func) {
+            _system_impl->call_user_callback(func, nullptr, CallbackLane::Telemetry);
+        });
     }
 }
 
@@ -1249,24 +1519,28 @@ void TelemetryImpl::process_heartbeat(const mavlink_message_t& message)
         return;
     }
 
-    mavlink_heartbeat_t heartbeat;
-    mavlink_msg_heartbeat_decode(&message, &heartbeat);
+    const auto& heartbeat = DecodedMessage::get(message, mavlink_msg_heartbeat_decode);
 
     set_armed(((heartbeat.base_mode & MAV_MODE_FLAG_SAFETY_ARMED) ? true : false));
 
+    // The system has already taken the flight mode from the heartbeat.
+    const auto flight_mode =
+        telemetry_flight_mode_from_flight_mode(_system_impl->get_flight_mode());
+    _snapshot.update([&](TelemetryExt::Snapshot& snapshot) {
+        snapshot.flight_mode = flight_mode;
+        snapshot.flight_mode_receive_timestamp_us = _system_impl->get_time().elapsed_us();
+    });
+
     std::lock_guard<std::mutex> lock(_subscription_mutex);
-    _armed_subscriptions.queue(
-        armed(), [this](const auto& func) { _system_impl->call_user_callback(func); });
+    queue_state_if_due(_armed_subscriptions, _armed_filter, [this]() { return armed(); });
 
-    _flight_mode_subscriptions.queue(
-        telemetry_flight_mode_from_flight_mode(_system_impl->get_flight_mode()),
-        [this](const auto& func) { _system_impl->call_user_callback(func); });
+    queue_state_if_due(
+        _flight_mode_subscriptions, _flight_mode_filter, [&]() { return flight_mode; });
 
-    _health_subscriptions.queue(
-        health(), [this](const auto& func) { _system_impl->call_user_callback(func); });
+    queue_state_if_due(_health_subscriptions, _health_filter, [this]() { return health(); });
 
-    _health_all_ok_subscriptions.queue(
-        health_all_ok(), [this](const auto& func) { _system_impl->call_user_callback(func); });
+    queue_state_if_due(
+        _health_all_ok_subscriptions, _health_all_ok_filter, [this]() { return health_all_ok(); });
 }
 
 void TelemetryImpl::receive_statustext(const MavlinkStatustextHandler::Statustext& statustext)
@@ -1304,9 +1578,9 @@ void TelemetryImpl::receive_statustext(const MavlinkStatustextHandler::Statustex
             break;
     }
 
-    new_status_text.text = statustext.text;
+    new_status_text.text = std::string(statustext.text);
 
-    set_status_text(new_status_text);
+    set_status_text(std::move(new_status_text));
 
     std::lock_guard<std::mutex> lock(_subscription_mutex);
     _status_text_subscriptions.queue(
@@ -1323,8 +1597,8 @@ void TelemetryImpl::process_rc_channels(const mavlink_message_t& message)
     }
 
     std::lock_guard<std::mutex> lock(_subscription_mutex);
-    _rc_status_subscriptions.queue(
-        rc_status(), [this](const auto& func) { _system_impl->call_user_callback(func); });
+    queue_state_if_due(
+        _rc_status_subscriptions, _rc_status_filter, [this]() { return rc_status(); });
 
     _system_impl->refresh_timeout_handler(_rc_channels_timeout_cookie);
 }
@@ -1337,8 +1611,9 @@ void TelemetryImpl::process_unix_epoch_time(const mavlink_message_t& message)
     set_unix_epoch_time_us(utm_global_position.time);
 
     std::lock_guard<std::mutex> lock(_subscription_mutex);
-    _unix_epoch_time_subscriptions.queue(
-        unix_epoch_time(), [this](const auto& func) { _system_impl->call_user_callback(func); });
+    _unix_epoch_time_subscriptions.queue(unix_epoch_time(), [this](const auto& func) {
+        _system_impl->call_user_callback(func, nullptr, CallbackLane::Telemetry);
+    });
 
     _system_impl->refresh_timeout_handler(_unix_epoch_timeout_cookie);
 }
@@ -1362,7 +1637,9 @@ void TelemetryImpl::process_actuator_control_target(const mavlink_message_t& mes
     std::lock_guard<std::mutex> lock(_subscription_mutex);
     _actuator_control_target_subscriptions.queue(
         actuator_control_target(),
-        [this](const auto& func) { _system_impl->call_user_callback(func); });
+        [this](const auto& func) {
+            _system_impl->call_user_callback(func, nullptr, CallbackLane::Telemetry);
+        });
 }
 
 void TelemetryImpl::process_actuator_output_status(const mavlink_message_t& message)
@@ -1383,14 +1660,13 @@ void TelemetryImpl::process_actuator_output_status(const mavlink_message_t& mess
 
     std::lock_guard<std::mutex> lock(_subscription_mutex);
     _actuator_output_status_subscriptions.queue(actuator_output_status(), [this](const auto& func) {
-        _system_impl->call_user_callback(func);
+        _system_impl->call_user_callback(func, nullptr, CallbackLane::Telemetry);
     });
 }
 
 void TelemetryImpl::process_odometry(const mavlink_message_t& message)
 {
-    mavlink_odometry_t odometry_msg;
-    mavlink_msg_odometry_decode(&message, &odometry_msg);
+    const auto& odometry_msg = DecodedMessage::get(message, mavlink_msg_odometry_decode);
 
     Telemetry::Odometry odometry_struct{};
 
@@ -1433,8 +1709,9 @@ void TelemetryImpl::process_odometry(const mavlink_message_t& message)
     set_odometry(odometry_struct);
 
     std::lock_guard<std::mutex> lock(_subscription_mutex);
-    _odometry_subscriptions.queue(
-        odometry(), [this](const auto& func) { _system_impl->call_user_callback(func); });
+    _odometry_subscriptions.queue(odometry_struct, [this](const auto& func) {
+        _system_impl->call_user_callback(func, nullptr, CallbackLane::Telemetry);
+    });
 }
 
 void TelemetryImpl::process_distance_sensor(const mavlink_message_t& message)
@@ -1454,8 +1731,9 @@ void TelemetryImpl::process_distance_sensor(const mavlink_message_t& message)
     set_distance_sensor(distance_sensor_struct);
 
     std::lock_guard<std::mutex> lock(_subscription_mutex);
-    _distance_sensor_subscriptions.queue(
-        distance_sensor(), [this](const auto& func) { _system_impl->call_user_callback(func); });
+    _distance_sensor_subscriptions.queue(distance_sensor(), [this](const auto& func) {
+        _system_impl->call_user_callback(func, nullptr, CallbackLane::Telemetry);
+    });
 }
 
 void TelemetryImpl::process_scaled_pressure(const mavlink_message_t& message)
@@ -1477,8 +1755,9 @@ void TelemetryImpl::process_scaled_pressure(const mavlink_message_t& message)
     set_scaled_pressure(scaled_pressure_struct);
 
     std::lock_guard<std::mutex> lock(_subscription_mutex);
-    _scaled_pressure_subscriptions.queue(
-        scaled_pressure(), [this](const auto& func) { _system_impl->call_user_callback(func); });
+    _scaled_pressure_subscriptions.queue(scaled_pressure(), [this](const auto& func) {
+        _system_impl->call_user_callback(func, nullptr, CallbackLane::Telemetry);
+    });
 }
 
 Telemetry::LandedState
@@ -1744,62 +2023,63 @@ void TelemetryImpl::receive_unix_epoch_timeout()
 
 Telemetry::PositionVelocityNed TelemetryImpl::position_velocity_ned() const
 {
-    std::lock_guard<std::mutex> lock(_position_velocity_ned_mutex);
-    return _position_velocity_ned;
+    return _position_velocity_ned.load();
 }
 
 void TelemetryImpl::set_position_velocity_ned(Telemetry::PositionVelocityNed position_velocity_ned)
 {
-    std::lock_guard<std::mutex> lock(_position_velocity_ned_mutex);
-    _position_velocity_ned = position_velocity_ned;
+    _position_velocity_ned.store(position_velocity_ned);
 }
 
-Telemetry::Position TelemetryImpl::position() const
+Telemetry::Position TelemetryImpl::position()
 {
-    std::lock_guard<std::mutex> lock(_position_mutex);
-    return _position;
+    polled(MAVLINK_MSG_ID_GLOBAL_POSITION_INT);
+    return _snapshot.load().position;
 }
 
 void TelemetryImpl::set_position(Telemetry::Position position)
 {
-    std::lock_guard<std::mutex> lock(_position_mutex);
-    _position = position;
+    const auto receive_timestamp_us = _system_impl->get_time().elapsed_us();
+    _snapshot.update([&](TelemetryExt::Snapshot& snapshot) {
+        snapshot.position = position;
+        snapshot.position_receive_timestamp_us = receive_timestamp_us;
+    });
+
+    if (auto writer = std::atomic_load(&_shared_memory_writer)) {
+        writer->store(&TelemetrySharedMemory::position, to_shared(position, receive_timestamp_us));
+    }
 }
 
-Telemetry::Heading TelemetryImpl::heading() const
+Telemetry::Heading TelemetryImpl::heading()
 {
-    std::lock_guard<std::mutex> lock(_heading_mutex);
-    return _heading;
+    polled(MAVLINK_MSG_ID_GLOBAL_POSITION_INT);
+    return _heading.load();
 }
 
 void TelemetryImpl::set_heading(Telemetry::Heading heading)
 {
-    std::lock_guard<std::mutex> lock(_heading_mutex);
-    _heading = heading;
+    _heading.store(heading);
 }
 
-Telemetry::Altitude TelemetryImpl::altitude() const
+Telemetry::Altitude TelemetryImpl::altitude()
 {
-    std::lock_guard<std::mutex> lock(_altitude_mutex);
-    return _altitude;
+    polled(MAVLINK_MSG_ID_ALTITUDE);
+    return _altitude.load();
 }
 
 void TelemetryImpl::set_altitude(Telemetry::Altitude altitude)
 {
-    std::lock_guard<std::mutex> lock(_altitude_mutex);
-    _altitude = altitude;
+    _altitude.store(altitude);
 }
 
 Telemetry::Position TelemetryImpl::home() const
 {
-    std::lock_guard<std::mutex> lock(_home_position_mutex);
-    return _home_position;
+    return _home_position.load();
 }
 
 void TelemetryImpl::set_home_position(Telemetry::Position home_position)
 {
-    std::lock_guard<std::mutex> lock(_home_position_mutex);
-    _home_position = home_position;
+    _home_position.store(home_position);
 }
 
 bool TelemetryImpl::armed() const
@@ -1820,7 +2100,7 @@ void TelemetryImpl::set_in_air(bool in_air_new)
 void TelemetryImpl::set_status_text(Telemetry::StatusText status_text)
 {
     std::lock_guard<std::mutex> lock(_status_text_mutex);
-    _status_text = status_text;
+    _status_text = std::move(status_text);
 }
 
 Telemetry::StatusText TelemetryImpl::status_text() const
@@ -1834,49 +2114,78 @@ void TelemetryImpl::set_armed(bool armed_new)
     _armed = armed_new;
 }
 
-Telemetry::Quaternion TelemetryImpl::attitude_quaternion() const
+Telemetry::Quaternion TelemetryImpl::attitude_quaternion()
 {
-    std::lock_guard<std::mutex> lock(_attitude_quaternion_mutex);
-    return _attitude_quaternion;
+    polled(MAVLINK_MSG_ID_ATTITUDE_QUATERNION);
+    return _snapshot.load().attitude_quaternion;
 }
 
-Telemetry::AngularVelocityBody TelemetryImpl::attitude_angular_velocity_body() const
+Telemetry::AngularVelocityBody TelemetryImpl::attitude_angular_velocity_body()
 {
-    std::lock_guard<std::mutex> lock(_attitude_angular_velocity_body_mutex);
-    return _attitude_angular_velocity_body;
+    polled(MAVLINK_MSG_ID_ATTITUDE_QUATERNION);
+    return _attitude_angular_velocity_body.load();
 }
 
-Telemetry::GroundTruth TelemetryImpl::ground_truth() const
+Telemetry::GroundTruth TelemetryImpl::ground_truth()
 {
+    polled(MAVLINK_MSG_ID_HIL_STATE_QUATERNION);
     std::lock_guard<std::mutex> lock(_ground_truth_mutex);
     return _ground_truth;
 }
 
-Telemetry::FixedwingMetrics TelemetryImpl::fixedwing_metrics() const
+Telemetry::FixedwingMetrics TelemetryImpl::fixedwing_metrics()
 {
+    polled(MAVLINK_MSG_ID_VFR_HUD);
     std::lock_guard<std::mutex> lock(_fixedwing_metrics_mutex);
     return _fixedwing_metrics;
 }
 
-Telemetry::EulerAngle TelemetryImpl::attitude_euler() const
+Telemetry::EulerAngle TelemetryImpl::attitude_euler()
+{
+    polled(MAVLINK_MSG_ID_ATTITUDE_QUATERNION);
+    return derived_attitude_euler();
+}
+
+Telemetry::EulerAngle TelemetryImpl::derived_attitude_euler() const
 {
-    std::lock_guard<std::mutex> lock(_attitude_quaternion_mutex);
-    Telemetry::EulerAngle euler = to_euler_angle_from_quaternion(_attitude_quaternion);
+    const auto quaternion = _snapshot.load().attitude_quaternion;
+
+    // Derived once per sample, however often it is read.
+    const auto cached = _attitude_euler_cache.load();
+    if (cached.valid && cached.quaternion == quaternion) {
+        return cached.euler_angle;
+    }
 
-    return euler;
+    const auto euler_angle = to_euler_angle_from_quaternion(quaternion);
+    _attitude_euler_cache.store({true, quaternion, euler_angle});
+    return euler_angle;
 }
 
 void TelemetryImpl::set_attitude_quaternion(Telemetry::Quaternion quaternion)
 {
-    std::lock_guard<std::mutex> lock(_attitude_quaternion_mutex);
-    _attitude_quaternion = quaternion;
+    const auto receive_timestamp_us = _system_impl->get_time().elapsed_us();
+    _snapshot.update([&](TelemetryExt::Snapshot& snapshot) {
+        snapshot.attitude_quaternion = quaternion;
+        snapshot.attitude_quaternion_receive_timestamp_us = receive_timestamp_us;
+    });
+
+    if (auto writer = std::atomic_load(&_shared_memory_writer)) {
+        writer->store(
+            &TelemetrySharedMemory::attitude_quaternion,
+            to_shared(quaternion, receive_timestamp_us));
+    }
 }
 
 void TelemetryImpl::set_attitude_angular_velocity_body(
     Telemetry::AngularVelocityBody angular_velocity_body)
 {
-    std::lock_guard<std::mutex> lock(_attitude_quaternion_mutex);
-    _attitude_angular_velocity_body = angular_velocity_body;
+    _attitude_angular_velocity_body.store(angular_velocity_body);
+
+    if (auto writer = std::atomic_load(&_shared_memory_writer)) {
+        writer->store(
+            &TelemetrySharedMemory::angular_velocity_body,
+            to_shared(angular_velocity_body, _system_impl->get_time().elapsed_us()));
+    }
 }
 
 void TelemetryImpl::set_ground_truth(Telemetry::GroundTruth ground_truth)
@@ -1893,51 +2202,72 @@ void TelemetryImpl::set_fixedwing_metrics(Telemetry::FixedwingMetrics fixedwing_
 
 Telemetry::Quaternion TelemetryImpl::camera_attitude_quaternion() const
 {
-    std::lock_guard<std::mutex> lock(_camera_attitude_euler_angle_mutex);
-    Telemetry::Quaternion quaternion = to_quaternion_from_euler_angle(_camera_attitude_euler_angle);
+    std::lock_guard<std::mutex> lock(_camera_attitude_mutex);
+    if (!_camera_attitude_quaternion) {
+        _camera_attitude_quaternion = to_quaternion_from_euler_angle(*_camera_attitude_euler_angle);
+    }
 
-    return quaternion;
+    return *_camera_attitude_quaternion;
 }
 
 Telemetry::EulerAngle TelemetryImpl::camera_attitude_euler() const
 {
-    std::lock_guard<std::mutex> lock(_camera_attitude_euler_angle_mutex);
+    std::lock_guard<std::mutex> lock(_camera_attitude_mutex);
+    if (!_camera_attitude_euler_angle) {
+        _camera_attitude_euler_angle = to_euler_angle_from_quaternion(*_camera_attitude_quaternion);
+    }
 
-    return _camera_attitude_euler_angle;
+    return *_camera_attitude_euler_angle;
 }
 
 void TelemetryImpl::set_camera_attitude_euler_angle(Telemetry::EulerAngle euler_angle)
 {
-    std::lock_guard<std::mutex> lock(_camera_attitude_euler_angle_mutex);
+    std::lock_guard<std::mutex> lock(_camera_attitude_mutex);
     _camera_attitude_euler_angle = euler_angle;
+    _camera_attitude_quaternion.reset();
+}
+
+void TelemetryImpl::set_camera_attitude_quaternion(Telemetry::Quaternion quaternion)
+{
+    std::lock_guard<std::mutex> lock(_camera_attitude_mutex);
+    _camera_attitude_quaternion = quaternion;
+    _camera_attitude_euler_angle.reset();
 }
 
-Telemetry::VelocityNed TelemetryImpl::velocity_ned() const
+Telemetry::VelocityNed TelemetryImpl::velocity_ned()
 {
-    std::lock_guard<std::mutex> lock(_velocity_ned_mutex);
-    return _velocity_ned;
+    polled(MAVLINK_MSG_ID_GLOBAL_POSITION_INT);
+    return _snapshot.load().velocity_ned;
 }
 
 void TelemetryImpl::set_velocity_ned(Telemetry::VelocityNed velocity_ned)
 {
-    std::lock_guard<std::mutex> lock(_velocity_ned_mutex);
-    _velocity_ned = velocity_ned;
+    const auto receive_timestamp_us = _system_impl->get_time().elapsed_us();
+    _snapshot.update([&](TelemetryExt::Snapshot& snapshot) {
+        snapshot.velocity_ned = velocity_ned;
+        snapshot.velocity_ned_receive_timestamp_us = receive_timestamp_us;
+    });
+
+    if (auto writer = std::atomic_load(&_shared_memory_writer)) {
+        writer->store(
+            &TelemetrySharedMemory::velocity_ned, to_shared(velocity_ned, receive_timestamp_us));
+    }
 }
 
-Telemetry::Imu TelemetryImpl::imu() const
+Telemetry::Imu TelemetryImpl::imu()
 {
-    std::lock_guard<std::mutex> lock(_imu_reading_ned_mutex);
-    return _imu_reading_ned;
+    polled(MAVLINK_MSG_ID_HIGHRES_IMU);
+    return _imu_reading_ned.load();
 }
 
 void TelemetryImpl::set_imu_reading_ned(Telemetry::Imu imu_reading_ned)
 {
-    std::lock_guard<std::mutex> lock(_imu_reading_ned_mutex);
-    _imu_reading_ned = imu_reading_ned;
+    _imu_reading_ned.store(imu_reading_ned);
 }
 
-Telemetry::Imu TelemetryImpl::scaled_imu() const
+Telemetry::Imu TelemetryImpl::scaled_imu()
 {
+    polled(MAVLINK_MSG_ID_SCALED_IMU);
     std::lock_guard<std::mutex> lock(_scaled_imu_mutex);
     return _scaled_imu;
 }
@@ -1948,8 +2278,9 @@ void TelemetryImpl::set_scaled_imu(Telemetry::Imu scaled_imu)
     _scaled_imu = scaled_imu;
 }
 
-Telemetry::Imu TelemetryImpl::raw_imu() const
+Telemetry::Imu TelemetryImpl::raw_imu()
 {
+    polled(MAVLINK_MSG_ID_RAW_IMU);
     std::lock_guard<std::mutex> lock(_raw_imu_mutex);
     return _raw_imu;
 }
@@ -1962,14 +2293,12 @@ void TelemetryImpl::set_raw_imu(Telemetry::Imu raw_imu)
 
 Telemetry::GpsInfo TelemetryImpl::gps_info() const
 {
-    std::lock_guard<std::mutex> lock(_gps_info_mutex);
-    return _gps_info;
+    return _gps_info.load();
 }
 
 void TelemetryImpl::set_gps_info(Telemetry::GpsInfo gps_info)
 {
-    std::lock_guard<std::mutex> lock(_gps_info_mutex);
-    _gps_info = gps_info;
+    _gps_info.store(gps_info);
 }
 
 Telemetry::RawGps TelemetryImpl::raw_gps() const
@@ -1986,14 +2315,15 @@ void TelemetryImpl::set_raw_gps(Telemetry::RawGps raw_gps)
 
 Telemetry::Battery TelemetryImpl::battery() const
 {
-    std::lock_guard<std::mutex> lock(_battery_mutex);
-    return _battery;
+    return _snapshot.load().battery;
 }
 
 void TelemetryImpl::set_battery(Telemetry::Battery battery)
 {
-    std::lock_guard<std::mutex> lock(_battery_mutex);
-    _battery = battery;
+    _snapshot.update([&](TelemetryExt::Snapshot& snapshot) {
+        snapshot.battery = battery;
+        snapshot.battery_receive_timestamp_us = _system_impl->get_time().elapsed_us();
+    });
 }
 
 Telemetry::FlightMode TelemetryImpl::flight_mode() const
@@ -2001,18 +2331,162 @@ Telemetry::FlightMode TelemetryImpl::flight_mode() const
     return telemetry_flight_mode_from_flight_mode(_system_impl->get_flight_mode());
 }
 
+TelemetryExt::Snapshot TelemetryImpl::snapshot() const
+{
+    return _snapshot.load();
+}
+
+void TelemetryImpl::set_history_enabled(bool enabled)
+{
+    _position_history.set_enabled(enabled);
+    _velocity_ned_history.set_enabled(enabled);
+    _attitude_quaternion_history.set_enabled(enabled);
+
+    std::lock_guard<std::mutex> lock(_subscription_mutex);
+    _history_enabled = enabled;
+    update_message_demand();
+}
+
+void TelemetryImpl::set_state_keep_alive(double interval_s)
+{
+    _state_keep_alive_s = std::max(interval_s, 0.0);
+}
+
+Telemetry::Result TelemetryImpl::publish_to_shared_memory(const std::string& name)
+{
+    const auto result = replace_shared_memory_writer(name);
+
+    // The published values need their messages.
+    std::lock_guard<std::mutex> lock(_subscription_mutex);
+    update_message_demand();
+    return result;
+}
+
+Telemetry::Result TelemetryImpl::replace_shared_memory_writer(const std::string& name)
+{
+    // The previous one goes first, it might have the same name.
+    std::atomic_store(&_shared_memory_writer, std::shared_ptr<TelemetrySharedMemoryWriter>{});
+    if (name.empty()) {
+        return Telemetry::Result::Success;
+    }
+
+    std::shared_ptr<TelemetrySharedMemoryWriter> writer =
+        TelemetrySharedMemoryWriter::create(name, _system_impl->get_system_id());
+    if (!writer) {
+        return Telemetry::Result::Unsupported;
+    }
+
+    // So readers don't need to wait for the next update.
+    const auto snapshot = _snapshot.load();
+    writer->store(
+        &TelemetrySharedMemory::position,
+        to_shared(snapshot.position, snapshot.position_receive_timestamp_us));
+    writer->store(
+        &TelemetrySharedMemory::velocity_ned,
+        to_shared(snapshot.velocity_ned, snapshot.velocity_ned_receive_timestamp_us));
+    writer->store(
+        &TelemetrySharedMemory::attitude_quaternion,
+        to_shared(
+            snapshot.attitude_quaternion, snapshot.attitude_quaternion_receive_timestamp_us));
+
+    std::atomic_store(&_shared_memory_writer, writer);
+    return Telemetry::Result::Success;
+}
+
+TelemetrySharedMemory::Position
+TelemetryImpl::to_shared(const Telemetry::Position& position, uint64_t receive_timestamp_us)
+{
+    return {
+        position.latitude_deg,
+        position.longitude_deg,
+        position.absolute_altitude_m,
+        position.relative_altitude_m,
+        receive_timestamp_us};
+}
+
+TelemetrySharedMemory::VelocityNed
+TelemetryImpl::to_shared(const Telemetry::VelocityNed& velocity_ned, uint64_t receive_timestamp_us)
+{
+    return {
+        velocity_ned.north_m_s,
+        velocity_ned.east_m_s,
+        velocity_ned.down_m_s,
+        0.0f,
+        receive_timestamp_us};
+}
+
+TelemetrySharedMemory::AttitudeQuaternion
+TelemetryImpl::to_shared(const Telemetry::Quaternion& quaternion, uint64_t receive_timestamp_us)
+{
+    return {
+        quaternion.w,
+        quaternion.x,
+        quaternion.y,
+        quaternion.z,
+        quaternion.timestamp_us,
+        receive_timestamp_us};
+}
+
+TelemetrySharedMemory::AngularVelocityBody TelemetryImpl::to_shared(
+    const Telemetry::AngularVelocityBody& angular_velocity_body, uint64_t receive_timestamp_us)
+{
+    return {
+        angular_velocity_body.roll_rad_s,
+        angular_velocity_body.pitch_rad_s,
+        angular_velocity_body.yaw_rad_s,
+        0.0f,
+        receive_timestamp_us};
+}
+
+std::vector<TelemetryExt::PositionSample>
+TelemetryImpl::position_history(uint64_t from_us, uint64_t to_us) const
+{
+    return to_public_samples<TelemetryExt::PositionSample>(
+        _position_history.window(from_us, to_us));
+}
+
+std::optional<Telemetry::Position> TelemetryImpl::position_at(uint64_t receive_timestamp_us) const
+{
+    return _position_history.at(receive_timestamp_us);
+}
+
+std::vector<TelemetryExt::VelocityNedSample>
+TelemetryImpl::velocity_ned_history(uint64_t from_us, uint64_t to_us) const
+{
+    return to_public_samples<TelemetryExt::VelocityNedSample>(
+        _velocity_ned_history.window(from_us, to_us));
+}
+
+std::optional<Telemetry::VelocityNed>
+TelemetryImpl::velocity_ned_at(uint64_t receive_timestamp_us) const
+{
+    return _velocity_ned_history.at(receive_timestamp_us);
+}
+
+std::vector<TelemetryExt::AttitudeQuaternionSample>
+TelemetryImpl::attitude_quaternion_history(uint64_t from_us, uint64_t to_us) const
+{
+    return to_public_samples<TelemetryExt::AttitudeQuaternionSample>(
+        _attitude_quaternion_history.window(from_us, to_us));
+}
+
+std::optional<Telemetry::Quaternion>
+TelemetryImpl::attitude_quaternion_at(uint64_t receive_timestamp_us) const
+{
+    return _attitude_quaternion_history.at(receive_timestamp_us);
+}
+
 Telemetry::Health TelemetryImpl::health() const
 {
-    std::lock_guard<std::mutex> lock(_health_mutex);
-    return _health;
+    return _snapshot.load().health;
 }
 
 bool TelemetryImpl::health_all_ok() const
 {
-    std::lock_guard<std::mutex> lock(_health_mutex);
-    if (_health.is_gyrometer_calibration_ok && _health.is_accelerometer_calibration_ok &&
-        _health.is_magnetometer_calibration_ok && _health.is_local_position_ok &&
-        _health.is_global_position_ok && _health.is_home_position_ok) {
+    const auto health = _snapshot.load().health;
+    if (health.is_gyrometer_calibration_ok && health.is_accelerometer_calibration_ok &&
+        health.is_magnetometer_calibration_ok && health.is_local_position_ok &&
+        health.is_global_position_ok && health.is_home_position_ok) {
         return true;
     } else {
         return false;
@@ -2043,8 +2517,9 @@ Telemetry::ActuatorOutputStatus TelemetryImpl::actuator_output_status() const
     return _actuator_output_status;
 }
 
-Telemetry::Odometry TelemetryImpl::odometry() const
+Telemetry::Odometry TelemetryImpl::odometry()
 {
+    polled(MAVLINK_MSG_ID_ODOMETRY);
     std::lock_guard<std::mutex> lock(_odometry_mutex);
     return _odometry;
 }
@@ -2061,52 +2536,73 @@ Telemetry::ScaledPressure TelemetryImpl::scaled_pressure() const
     return _scaled_pressure;
 }
 
+template<typename Function> void TelemetryImpl::update_health(Function&& function)
+{
+    _snapshot.update([&](TelemetryExt::Snapshot& snapshot) {
+        function(snapshot.health);
+        snapshot.health_receive_timestamp_us = _system_impl->get_time().elapsed_us();
+    });
+}
+
+template<typename T, typename Getter>
+void TelemetryImpl::queue_state_if_due(
+    CallbackList<T>& subscriptions, StateChangeFilter<T>& filter, Getter&& getter)
+{
+    if (subscriptions.empty()) {
+        return;
+    }
+
+    const T value = getter();
+    if (!filter.is_due(
+            value, _system_impl->get_time().coarse_steady_time(), _state_keep_alive_s)) {
+        return;
+    }
+
+    subscriptions.queue(value, [this](const auto& func) {
+        _system_impl->call_user_callback(func, nullptr, CallbackLane::Telemetry);
+    });
+}
+
 void TelemetryImpl::set_health_local_position(bool ok)
 {
-    std::lock_guard<std::mutex> lock(_health_mutex);
-    _health.is_local_position_ok = ok;
+    update_health([&](Telemetry::Health& health) { health.is_local_position_ok = ok; });
 }
 
 void TelemetryImpl::set_health_global_position(bool ok)
 {
-    std::lock_guard<std::mutex> lock(_health_mutex);
-    _health.is_global_position_ok = ok;
+    update_health([&](Telemetry::Health& health) { health.is_global_position_ok = ok; });
 }
 
 void TelemetryImpl::set_health_home_position(bool ok)
 {
-    std::lock_guard<std::mutex> lock(_health_mutex);
-    _health.is_home_position_ok = ok;
+    update_health([&](Telemetry::Health& health) { health.is_home_position_ok = ok; });
 }
 
 void TelemetryImpl::set_health_gyrometer_calibration(bool ok)
 {
     _has_received_gyro_calibration = true;
 
-    std::lock_guard<std::mutex> lock(_health_mutex);
-    _health.is_gyrometer_calibration_ok = (ok || _hitl_enabled);
+    update_health([&](Telemetry::Health& health) {
+        health.is_gyrometer_calibration_ok = (ok || _hitl_enabled);
+    });
 }
 
 void TelemetryImpl::set_health_accelerometer_calibration(bool ok)
 {
     _has_received_accel_calibration = true;
 
-    std::lock_guard<std::mutex> lock(_health_mutex);
-    _health.is_accelerometer_calibration_ok = (ok || _hitl_enabled);
+    update_health([&](Telemetry::Health& health) {
+        health.is_accelerometer_calibration_ok = (ok || _hitl_enabled);
+    });
 }
 
 void TelemetryImpl::set_health_magnetometer_calibration(bool ok)
 {
     _has_received_mag_calibration = true;
 
-    std::lock_guard<std::mutex> lock(_health_mutex);
-    _health.is_magnetometer_calibration_ok = (ok || _hitl_enabled);
-}
-
-void TelemetryImpl::set_health_armable(bool ok)
-{
-    std::lock_guard<std::mutex> lock(_health_mutex);
-    _health.is_armable = ok;
+    update_health([&](Telemetry::Health& health) {
+        health.is_magnetometer_calibration_ok = (ok || _hitl_enabled);
+    });
 }
 
 Telemetry::VtolState TelemetryImpl::vtol_state() const
@@ -2192,26 +2688,50 @@ Telemetry::PositionVelocityNedHandle TelemetryImpl::subscribe_position_velocity_
     const Telemetry::PositionVelocityNedCallback& callback)
 {
     std::lock_guard<std::mutex> lock(_subscription_mutex);
-    return _position_velocity_ned_subscriptions.subscribe(callback);
+    auto handle = _position_velocity_ned_subscriptions.subscribe(callback);
+    subscriptions_changed(MAVLINK_MSG_ID_LOCAL_POSITION_NED);
+    return handle;
+}
+
+Telemetry::PositionVelocityNedHandle TelemetryImpl::subscribe_position_velocity_ned(
+    const Telemetry::PositionVelocityNedCallback& callback, double max_rate_hz)
+{
+    std::lock_guard<std::mutex> lock(_subscription_mutex);
+    auto handle = _position_velocity_ned_subscriptions.subscribe(callback, max_rate_hz);
+    subscriptions_changed(MAVLINK_MSG_ID_LOCAL_POSITION_NED);
+    return handle;
 }
 
 void TelemetryImpl::unsubscribe_position_velocity_ned(Telemetry::PositionVelocityNedHandle handle)
 {
     std::lock_guard<std::mutex> lock(_subscription_mutex);
     _position_velocity_ned_subscriptions.unsubscribe(handle);
+    subscriptions_changed(MAVLINK_MSG_ID_LOCAL_POSITION_NED);
 }
 
 Telemetry::PositionHandle
 TelemetryImpl::subscribe_position(const Telemetry::PositionCallback& callback)
 {
     std::lock_guard<std::mutex> lock(_subscription_mutex);
-    return _position_subscriptions.subscribe(callback);
+    auto handle = _position_subscriptions.subscribe(callback);
+    subscriptions_changed(MAVLINK_MSG_ID_GLOBAL_POSITION_INT);
+    return handle;
+}
+
+Telemetry::PositionHandle
+TelemetryImpl::subscribe_position(const Telemetry::PositionCallback& callback, double max_rate_hz)
+{
+    std::lock_guard<std::mutex> lock(_subscription_mutex);
+    auto handle = _position_subscriptions.subscribe(callback, max_rate_hz);
+    subscriptions_changed(MAVLINK_MSG_ID_GLOBAL_POSITION_INT);
+    return handle;
 }
 
 void TelemetryImpl::unsubscribe_position(Telemetry::PositionHandle handle)
 {
     std::lock_guard<std::mutex> lock(_subscription_mutex);
     _position_subscriptions.unsubscribe(handle);
+    subscriptions_changed(MAVLINK_MSG_ID_GLOBAL_POSITION_INT);
 }
 
 Telemetry::HomeHandle TelemetryImpl::subscribe_home(const Telemetry::PositionCallback& callback)
@@ -2229,6 +2749,7 @@ void TelemetryImpl::unsubscribe_home(Telemetry::HomeHandle handle)
 Telemetry::InAirHandle TelemetryImpl::subscribe_in_air(const Telemetry::InAirCallback& callback)
 {
     std::lock_guard<std::mutex> lock(_subscription_mutex);
+    _in_air_filter.reset();
     return _in_air_subscriptions.subscribe(callback);
 }
 
@@ -2254,6 +2775,7 @@ void TelemetryImpl::unsubscribe_status_text(Handle<Telemetry::StatusText> handle
 Telemetry::ArmedHandle TelemetryImpl::subscribe_armed(const Telemetry::ArmedCallback& callback)
 {
     std::lock_guard<std::mutex> lock(_subscription_mutex);
+    _armed_filter.reset();
     return _armed_subscriptions.subscribe(callback);
 }
 
@@ -2267,26 +2789,50 @@ Telemetry::AttitudeQuaternionHandle
 TelemetryImpl::subscribe_attitude_quaternion(const Telemetry::AttitudeQuaternionCallback& callback)
 {
     std::lock_guard<std::mutex> lock(_subscription_mutex);
-    return _attitude_quaternion_angle_subscriptions.subscribe(callback);
+    auto handle = _attitude_quaternion_angle_subscriptions.subscribe(callback);
+    subscriptions_changed(MAVLINK_MSG_ID_ATTITUDE_QUATERNION);
+    return handle;
+}
+
+Telemetry::AttitudeQuaternionHandle TelemetryImpl::subscribe_attitude_quaternion(
+    const Telemetry::AttitudeQuaternionCallback& callback, double max_rate_hz)
+{
+    std::lock_guard<std::mutex> lock(_subscription_mutex);
+    auto handle = _attitude_quaternion_angle_subscriptions.subscribe(callback, max_rate_hz);
+    subscriptions_changed(MAVLINK_MSG_ID_ATTITUDE_QUATERNION);
+    return handle;
 }
 
 void TelemetryImpl::unsubscribe_attitude_quaternion(Telemetry::AttitudeQuaternionHandle handle)
 {
     std::lock_guard<std::mutex> lock(_subscription_mutex);
     _attitude_quaternion_angle_subscriptions.unsubscribe(handle);
+    subscriptions_changed(MAVLINK_MSG_ID_ATTITUDE_QUATERNION);
 }
 
 Telemetry::AttitudeEulerHandle
 TelemetryImpl::subscribe_attitude_euler(const Telemetry::AttitudeEulerCallback& callback)
 {
     std::lock_guard<std::mutex> lock(_subscription_mutex);
-    return _attitude_euler_angle_subscriptions.subscribe(callback);
+    auto handle = _attitude_euler_angle_subscriptions.subscribe(callback);
+    subscriptions_changed(MAVLINK_MSG_ID_ATTITUDE);
+    return handle;
+}
+
+Telemetry::AttitudeEulerHandle TelemetryImpl::subscribe_attitude_euler(
+    const Telemetry::AttitudeEulerCallback& callback, double max_rate_hz)
+{
+    std::lock_guard<std::mutex> lock(_subscription_mutex);
+    auto handle = _attitude_euler_angle_subscriptions.subscribe(callback, max_rate_hz);
+    subscriptions_changed(MAVLINK_MSG_ID_ATTITUDE);
+    return handle;
 }
 
 void TelemetryImpl::unsubscribe_attitude_euler(Telemetry::AttitudeEulerHandle handle)
 {
     std::lock_guard<std::mutex> lock(_subscription_mutex);
     _attitude_euler_angle_subscriptions.unsubscribe(handle);
+    subscriptions_changed(MAVLINK_MSG_ID_ATTITUDE);
 }
 
 Telemetry::AttitudeAngularVelocityBodyHandle
@@ -2294,7 +2840,21 @@ TelemetryImpl::subscribe_attitude_angular_velocity_body(
     const Telemetry::AttitudeAngularVelocityBodyCallback& callback)
 {
     std::lock_guard<std::mutex> lock(_subscription_mutex);
-    return _attitude_angular_velocity_body_subscriptions.subscribe(callback);
+    auto handle = _attitude_angular_velocity_body_subscriptions.subscribe(callback);
+    subscriptions_changed(MAVLINK_MSG_ID_ATTITUDE_QUATERNION);
+    subscriptions_changed(MAVLINK_MSG_ID_ATTITUDE);
+    return handle;
+}
+
+Telemetry::AttitudeAngularVelocityBodyHandle
+TelemetryImpl::subscribe_attitude_angular_velocity_body(
+    const Telemetry::AttitudeAngularVelocityBodyCallback& callback, double max_rate_hz)
+{
+    std::lock_guard<std::mutex> lock(_subscription_mutex);
+    auto handle = _attitude_angular_velocity_body_subscriptions.subscribe(callback, max_rate_hz);
+    subscriptions_changed(MAVLINK_MSG_ID_ATTITUDE_QUATERNION);
+    subscriptions_changed(MAVLINK_MSG_ID_ATTITUDE);
+    return handle;
 }
 
 void TelemetryImpl::unsubscribe_attitude_angular_velocity_body(
@@ -2302,32 +2862,58 @@ void TelemetryImpl::unsubscribe_attitude_angular_velocity_body(
 {
     std::lock_guard<std::mutex> lock(_subscription_mutex);
     _attitude_angular_velocity_body_subscriptions.unsubscribe(handle);
+    subscriptions_changed(MAVLINK_MSG_ID_ATTITUDE_QUATERNION);
+    subscriptions_changed(MAVLINK_MSG_ID_ATTITUDE);
 }
 
 Telemetry::FixedwingMetricsHandle
 TelemetryImpl::subscribe_fixedwing_metrics(const Telemetry::FixedwingMetricsCallback& callback)
 {
     std::lock_guard<std::mutex> lock(_subscription_mutex);
-    return _fixedwing_metrics_subscriptions.subscribe(callback);
+    auto handle = _fixedwing_metrics_subscriptions.subscribe(callback);
+    subscriptions_changed(MAVLINK_MSG_ID_VFR_HUD);
+    return handle;
+}
+
+Telemetry::FixedwingMetricsHandle TelemetryImpl::subscribe_fixedwing_metrics(
+    const Telemetry::FixedwingMetricsCallback& callback, double max_rate_hz)
+{
+    std::lock_guard<std::mutex> lock(_subscription_mutex);
+    auto handle = _fixedwing_metrics_subscriptions.subscribe(callback, max_rate_hz);
+    subscriptions_changed(MAVLINK_MSG_ID_VFR_HUD);
+    return handle;
 }
 
 void TelemetryImpl::unsubscribe_fixedwing_metrics(Telemetry::FixedwingMetricsHandle handle)
 {
     std::lock_guard<std::mutex> lock(_subscription_mutex);
     _fixedwing_metrics_subscriptions.unsubscribe(handle);
+    subscriptions_changed(MAVLINK_MSG_ID_VFR_HUD);
 }
 
 Telemetry::GroundTruthHandle
 TelemetryImpl::subscribe_ground_truth(const Telemetry::GroundTruthCallback& callback)
 {
     std::lock_guard<std::mutex> lock(_subscription_mutex);
-    return _ground_truth_subscriptions.subscribe(callback);
+    auto handle = _ground_truth_subscriptions.subscribe(callback);
+    subscriptions_changed(MAVLINK_MSG_ID_HIL_STATE_QUATERNION);
+    return handle;
+}
+
+Telemetry::GroundTruthHandle TelemetryImpl::subscribe_ground_truth(
+    const Telemetry::GroundTruthCallback& callback, double max_rate_hz)
+{
+    std::lock_guard<std::mutex> lock(_subscription_mutex);
+    auto handle = _ground_truth_subscriptions.subscribe(callback, max_rate_hz);
+    subscriptions_changed(MAVLINK_MSG_ID_HIL_STATE_QUATERNION);
+    return handle;
 }
 
 void TelemetryImpl::unsubscribe_ground_truth(Telemetry::GroundTruthHandle handle)
 {
     std::lock_guard<std::mutex> lock(_subscription_mutex);
     _ground_truth_subscriptions.unsubscribe(handle);
+    subscriptions_changed(MAVLINK_MSG_ID_HIL_STATE_QUATERNION);
 }
 
 Telemetry::AttitudeQuaternionHandle TelemetryImpl::subscribe_camera_attitude_quaternion(
@@ -2361,50 +2947,98 @@ Telemetry::VelocityNedHandle
 TelemetryImpl::subscribe_velocity_ned(const Telemetry::VelocityNedCallback& callback)
 {
     std::lock_guard<std::mutex> lock(_subscription_mutex);
-    return _velocity_ned_subscriptions.subscribe(callback);
+    auto handle = _velocity_ned_subscriptions.subscribe(callback);
+    subscriptions_changed(MAVLINK_MSG_ID_GLOBAL_POSITION_INT);
+    return handle;
+}
+
+Telemetry::VelocityNedHandle TelemetryImpl::subscribe_velocity_ned(
+    const Telemetry::VelocityNedCallback& callback, double max_rate_hz)
+{
+    std::lock_guard<std::mutex> lock(_subscription_mutex);
+    auto handle = _velocity_ned_subscriptions.subscribe(callback, max_rate_hz);
+    subscriptions_changed(MAVLINK_MSG_ID_GLOBAL_POSITION_INT);
+    return handle;
 }
 
 void TelemetryImpl::unsubscribe_velocity_ned(Telemetry::VelocityNedHandle handle)
 {
     std::lock_guard<std::mutex> lock(_subscription_mutex);
     _velocity_ned_subscriptions.unsubscribe(handle);
+    subscriptions_changed(MAVLINK_MSG_ID_GLOBAL_POSITION_INT);
 }
 
 Telemetry::ImuHandle TelemetryImpl::subscribe_imu(const Telemetry::ImuCallback& callback)
 {
     std::lock_guard<std::mutex> lock(_subscription_mutex);
-    return _imu_reading_ned_subscriptions.subscribe(callback);
+    auto handle = _imu_reading_ned_subscriptions.subscribe(callback);
+    subscriptions_changed(MAVLINK_MSG_ID_HIGHRES_IMU);
+    return handle;
+}
+
+Telemetry::ImuHandle
+TelemetryImpl::subscribe_imu(const Telemetry::ImuCallback& callback, double max_rate_hz)
+{
+    std::lock_guard<std::mutex> lock(_subscription_mutex);
+    auto handle = _imu_reading_ned_subscriptions.subscribe(callback, max_rate_hz);
+    subscriptions_changed(MAVLINK_MSG_ID_HIGHRES_IMU);
+    return handle;
 }
 
 void TelemetryImpl::unsubscribe_imu(Telemetry::ImuHandle handle)
 {
     std::lock_guard<std::mutex> lock(_subscription_mutex);
-    return _imu_reading_ned_subscriptions.unsubscribe(handle);
+    _imu_reading_ned_subscriptions.unsubscribe(handle);
+    subscriptions_changed(MAVLINK_MSG_ID_HIGHRES_IMU);
 }
 
 Telemetry::ScaledImuHandle
 TelemetryImpl::subscribe_scaled_imu(const Telemetry::ScaledImuCallback& callback)
 {
     std::lock_guard<std::mutex> lock(_subscription_mutex);
-    return _scaled_imu_subscriptions.subscribe(callback);
+    auto handle = _scaled_imu_subscriptions.subscribe(callback);
+    subscriptions_changed(MAVLINK_MSG_ID_SCALED_IMU);
+    return handle;
+}
+
+Telemetry::ScaledImuHandle TelemetryImpl::subscribe_scaled_imu(
+    const Telemetry::ScaledImuCallback& callback, double max_rate_hz)
+{
+    std::lock_guard<std::mutex> lock(_subscription_mutex);
+    auto handle = _scaled_imu_subscriptions.subscribe(callback, max_rate_hz);
+    subscriptions_changed(MAVLINK_MSG_ID_SCALED_IMU);
+    return handle;
 }
 
 void TelemetryImpl::unsubscribe_scaled_imu(Telemetry::ScaledImuHandle handle)
 {
     std::lock_guard<std::mutex> lock(_subscription_mutex);
     _scaled_imu_subscriptions.unsubscribe(handle);
+    subscriptions_changed(MAVLINK_MSG_ID_SCALED_IMU);
 }
 
 Telemetry::RawImuHandle TelemetryImpl::subscribe_raw_imu(const Telemetry::RawImuCallback& callback)
 {
     std::lock_guard<std::mutex> lock(_subscription_mutex);
-    return _raw_imu_subscriptions.subscribe(callback);
+    auto handle = _raw_imu_subscriptions.subscribe(callback);
+    subscriptions_changed(MAVLINK_MSG_ID_RAW_IMU);
+    return handle;
+}
+
+Telemetry::RawImuHandle
+TelemetryImpl::subscribe_raw_imu(const Telemetry::RawImuCallback& callback, double max_rate_hz)
+{
+    std::lock_guard<std::mutex> lock(_subscription_mutex);
+    auto handle = _raw_imu_subscriptions.subscribe(callback, max_rate_hz);
+    subscriptions_changed(MAVLINK_MSG_ID_RAW_IMU);
+    return handle;
 }
 
 void TelemetryImpl::unsubscribe_raw_imu(Telemetry::RawImuHandle handle)
 {
     std::lock_guard<std::mutex> lock(_subscription_mutex);
     _raw_imu_subscriptions.unsubscribe(handle);
+    subscriptions_changed(MAVLINK_MSG_ID_RAW_IMU);
 }
 
 Telemetry::GpsInfoHandle
@@ -2449,6 +3083,7 @@ Telemetry::FlightModeHandle
 TelemetryImpl::subscribe_flight_mode(const Telemetry::FlightModeCallback& callback)
 {
     std::lock_guard<std::mutex> lock(_subscription_mutex);
+    _flight_mode_filter.reset();
     return _flight_mode_subscriptions.subscribe(callback);
 }
 
@@ -2461,6 +3096,7 @@ void TelemetryImpl::unsubscribe_flight_mode(Telemetry::FlightModeHandle handle)
 Telemetry::HealthHandle TelemetryImpl::subscribe_health(const Telemetry::HealthCallback& callback)
 {
     std::lock_guard<std::mutex> lock(_subscription_mutex);
+    _health_filter.reset();
     return _health_subscriptions.subscribe(callback);
 }
 
@@ -2474,6 +3110,7 @@ Telemetry::HealthAllOkHandle
 TelemetryImpl::subscribe_health_all_ok(const Telemetry::HealthAllOkCallback& callback)
 {
     std::lock_guard<std::mutex> lock(_subscription_mutex);
+    _health_all_ok_filter.reset();
     return _health_all_ok_subscriptions.subscribe(callback);
 }
 
@@ -2487,6 +3124,7 @@ Telemetry::VtolStateHandle
 TelemetryImpl::subscribe_vtol_state(const Telemetry::VtolStateCallback& callback)
 {
     std::lock_guard<std::mutex> lock(_subscription_mutex);
+    _vtol_state_filter.reset();
     return _vtol_state_subscriptions.subscribe(callback);
 }
 
@@ -2500,6 +3138,7 @@ Telemetry::LandedStateHandle
 TelemetryImpl::subscribe_landed_state(const Telemetry::LandedStateCallback& callback)
 {
     std::lock_guard<std::mutex> lock(_subscription_mutex);
+    _landed_state_filter.reset();
     return _landed_state_subscriptions.subscribe(callback);
 }
 
@@ -2513,6 +3152,7 @@ Telemetry::RcStatusHandle
 TelemetryImpl::subscribe_rc_status(const Telemetry::RcStatusCallback& callback)
 {
     std::lock_guard<std::mutex> lock(_subscription_mutex);
+    _rc_status_filter.reset();
     return _rc_status_subscriptions.subscribe(callback);
 }
 
@@ -2566,13 +3206,25 @@ Telemetry::OdometryHandle
 TelemetryImpl::subscribe_odometry(const Telemetry::OdometryCallback& callback)
 {
     std::lock_guard<std::mutex> lock(_subscription_mutex);
-    return _odometry_subscriptions.subscribe(callback);
+    auto handle = _odometry_subscriptions.subscribe(callback);
+    subscriptions_changed(MAVLINK_MSG_ID_ODOMETRY);
+    return handle;
+}
+
+Telemetry::OdometryHandle
+TelemetryImpl::subscribe_odometry(const Telemetry::OdometryCallback& callback, double max_rate_hz)
+{
+    std::lock_guard<std::mutex> lock(_subscription_mutex);
+    auto handle = _odometry_subscriptions.subscribe(callback, max_rate_hz);
+    subscriptions_changed(MAVLINK_MSG_ID_ODOMETRY);
+    return handle;
 }
 
 void TelemetryImpl::unsubscribe_odometry(Telemetry::OdometryHandle handle)
 {
     std::lock_guard<std::mutex> lock(_subscription_mutex);
     _odometry_subscriptions.unsubscribe(handle);
+    subscriptions_changed(MAVLINK_MSG_ID_ODOMETRY);
 }
 
 Telemetry::DistanceSensorHandle
@@ -2605,26 +3257,50 @@ Telemetry::HeadingHandle
 TelemetryImpl::subscribe_heading(const Telemetry::HeadingCallback& callback)
 {
     std::lock_guard<std::mutex> lock(_subscription_mutex);
-    return _heading_subscriptions.subscribe(callback);
+    auto handle = _heading_subscriptions.subscribe(callback);
+    subscriptions_changed(MAVLINK_MSG_ID_GLOBAL_POSITION_INT);
+    return handle;
+}
+
+Telemetry::HeadingHandle
+TelemetryImpl::subscribe_heading(const Telemetry::HeadingCallback& callback, double max_rate_hz)
+{
+    std::lock_guard<std::mutex> lock(_subscription_mutex);
+    auto handle = _heading_subscriptions.subscribe(callback, max_rate_hz);
+    subscriptions_changed(MAVLINK_MSG_ID_GLOBAL_POSITION_INT);
+    return handle;
 }
 
 void TelemetryImpl::unsubscribe_heading(Telemetry::HeadingHandle handle)
 {
     std::lock_guard<std::mutex> lock(_subscription_mutex);
     _heading_subscriptions.unsubscribe(handle);
+    subscriptions_changed(MAVLINK_MSG_ID_GLOBAL_POSITION_INT);
 }
 
 Telemetry::AltitudeHandle
 TelemetryImpl::subscribe_altitude(const Telemetry::AltitudeCallback& callback)
 {
     std::lock_guard<std::mutex> lock(_subscription_mutex);
-    return _altitude_subscriptions.subscribe(callback);
+    auto handle = _altitude_subscriptions.subscribe(callback);
+    subscriptions_changed(MAVLINK_MSG_ID_ALTITUDE);
+    return handle;
+}
+
+Telemetry::AltitudeHandle
+TelemetryImpl::subscribe_altitude(const Telemetry::AltitudeCallback& callback, double max_rate_hz)
+{
+    std::lock_guard<std::mutex> lock(_subscription_mutex);
+    auto handle = _altitude_subscriptions.subscribe(callback, max_rate_hz);
+    subscriptions_changed(MAVLINK_MSG_ID_ALTITUDE);
+    return handle;
 }
 
 void TelemetryImpl::unsubscribe_altitude(Telemetry::AltitudeHandle handle)
 {
     std::lock_guard<std::mutex> lock(_subscription_mutex);
     _altitude_subscriptions.unsubscribe(handle);
+    subscriptions_changed(MAVLINK_MSG_ID_ALTITUDE);
 }
 
 void TelemetryImpl::request_home_position_async()
@@ -2677,14 +3353,11 @@ std::pair<Telemetry::Result, Telemetry::GpsGlobalOrigin> TelemetryImpl::get_gps_
 
 void TelemetryImpl::check_calibration()
 {
-    {
-        std::lock_guard<std::mutex> lock(_health_mutex);
-        if ((_has_received_gyro_calibration && _has_received_accel_calibration &&
-             _has_received_mag_calibration) ||
-            _has_received_hitl_param) {
-            _system_impl->remove_call_every(_calibration_cookie);
-            return;
-        }
+    if ((_has_received_gyro_calibration && _has_received_accel_calibration &&
+         _has_received_mag_calibration) ||
+        _has_received_hitl_param) {
+        _system_impl->remove_call_every(_calibration_cookie);
+        return;
     }
     if (_system_impl->has_autopilot()) {
         if (_system_impl->autopilot() == SystemImpl::Autopilot::ArduPilot) {
@@ -5,10 +5,15 @@
 #include <optional>
 
 #include "plugins/telemetry/telemetry.h"
+#include "plugins/telemetry/telemetry_ext.h"
 #include "mavlink_include.h"
 #include "plugin_impl_base.h"
 #include "system.h"
 #include "callback_list.h"
+#include "seqlock.h"
+#include "state_change_filter.h"
+#include "telemetry_history.h"
+#include "telemetry_shared_memory_writer.h"
 
 namespace mavsdk {
 
@@ -78,48 +83,75 @@ public:
     void set_rate_unix_epoch_time_async(double rate_hz, Telemetry::ResultCallback callback);
     void set_rate_altitude_async(double rate_hz, Telemetry::ResultCallback callback);
 
+    void set_automatic_rates_enabled(bool enabled);
+    void set_on_demand_decoding_enabled(bool enabled);
+    // The value of the message was polled by the user, so it's decoded from now on.
+    void polled(uint16_t message_id);
+
+    // The getters of the on demand messages are only meant for the user, as
+    // they call polled(). Internally, the decoded values are used instead.
+
     void get_gps_global_origin_async(const Telemetry::GetGpsGlobalOriginCallback callback);
     std::pair<Telemetry::Result, Telemetry::GpsGlobalOrigin> get_gps_global_origin();
 
     Telemetry::PositionVelocityNed position_velocity_ned() const;
-    Telemetry::Position position() const;
+    Telemetry::Position position();
     Telemetry::Position home() const;
     bool in_air() const;
     bool armed() const;
     Telemetry::VtolState vtol_state() const;
     Telemetry::LandedState landed_state() const;
     Telemetry::StatusText status_text() const;
-    Telemetry::EulerAngle attitude_euler() const;
-    Telemetry::Quaternion attitude_quaternion() const;
-    Telemetry::AngularVelocityBody attitude_angular_velocity_body() const;
-    Telemetry::GroundTruth ground_truth() const;
-    Telemetry::FixedwingMetrics fixedwing_metrics() const;
+    Telemetry::EulerAngle attitude_euler();
+    Telemetry::Quaternion attitude_quaternion();
+    Telemetry::AngularVelocityBody attitude_angular_velocity_body();
+    Telemetry::GroundTruth ground_truth();
+    Telemetry::FixedwingMetrics fixedwing_metrics();
     Telemetry::EulerAngle camera_attitude_euler() const;
     Telemetry::Quaternion camera_attitude_quaternion() const;
-    Telemetry::VelocityNed velocity_ned() const;
-    Telemetry::Imu imu() const;
-    Telemetry::Imu scaled_imu() const;
-    Telemetry::Imu raw_imu() const;
+    Telemetry::VelocityNed velocity_ned();
+    Telemetry::Imu imu();
+    Telemetry::Imu scaled_imu();
+    Telemetry::Imu raw_imu();
     Telemetry::GpsInfo gps_info() const;
     Telemetry::RawGps raw_gps() const;
     Telemetry::Battery battery() const;
     Telemetry::FlightMode flight_mode() const;
     Telemetry::Health health() const;
+    TelemetryExt::Snapshot snapshot() const;
+
+    void set_history_enabled(bool enabled);
+    void set_state_keep_alive(double interval_s);
+    Telemetry::Result publish_to_shared_memory(const std::string& name);
+    std::vector<TelemetryExt::PositionSample>
+    position_history(uint64_t from_us, uint64_t to_us) const;
+    std::optional<Telemetry::Position> position_at(uint64_t receive_timestamp_us) const;
+    std::vector<TelemetryExt::VelocityNedSample>
+    velocity_ned_history(uint64_t from_us, uint64_t to_us) const;
+    std::optional<Telemetry::VelocityNed> velocity_ned_at(uint64_t receive_timestamp_us) const;
+    std::vector<TelemetryExt::AttitudeQuaternionSample>
+    attitude_quaternion_history(uint64_t from_us, uint64_t to_us) const;
+    std::optional<Telemetry::Quaternion>
+    attitude_quaternion_at(uint64_t receive_timestamp_us) const;
     bool health_all_ok() const;
     Telemetry::RcStatus rc_status() const;
     Telemetry::ActuatorControlTarget actuator_control_target() const;
     Telemetry::ActuatorOutputStatus actuator_output_status() const;
-    Telemetry::Odometry odometry() const;
+    Telemetry::Odometry odometry();
     Telemetry::DistanceSensor distance_sensor() const;
     Telemetry::ScaledPressure scaled_pressure() const;
     uint64_t unix_epoch_time() const;
-    Telemetry::Heading heading() const;
-    Telemetry::Altitude altitude() const;
+    Telemetry::Heading heading();
+    Telemetry::Altitude altitude();
 
     Telemetry::PositionVelocityNedHandle
     subscribe_position_velocity_ned(const Telemetry::PositionVelocityNedCallback& callback);
+    Telemetry::PositionVelocityNedHandle subscribe_position_velocity_ned(
+        const Telemetry::PositionVelocityNedCallback& callback, double max_rate_hz);
     void unsubscribe_position_velocity_ned(Telemetry::PositionVelocityNedHandle handle);
     Telemetry::PositionHandle subscribe_position(const Telemetry::PositionCallback& callback);
+    Telemetry::PositionHandle
+    subscribe_position(const Telemetry::PositionCallback& callback, double max_rate_hz);
     void unsubscribe_position(Telemetry::PositionHandle handle);
     Telemetry::HomeHandle subscribe_home(const Telemetry::PositionCallback& callback);
     void unsubscribe_home(Telemetry::HomeHandle handle);
@@ -132,19 +164,29 @@ public:
     void unsubscribe_armed(Telemetry::ArmedHandle handle);
     Telemetry::AttitudeQuaternionHandle
     subscribe_attitude_quaternion(const Telemetry::AttitudeQuaternionCallback& callback);
+    Telemetry::AttitudeQuaternionHandle subscribe_attitude_quaternion(
+        const Telemetry::AttitudeQuaternionCallback& callback, double max_rate_hz);
     void unsubscribe_attitude_quaternion(Telemetry::AttitudeQuaternionHandle handle);
     Telemetry::AttitudeEulerHandle
     subscribe_attitude_euler(const Telemetry::AttitudeEulerCallback& callback);
+    Telemetry::AttitudeEulerHandle
+    subscribe_attitude_euler(const Telemetry::AttitudeEulerCallback& callback, double max_rate_hz);
     void unsubscribe_attitude_euler(Telemetry::AttitudeEulerHandle handle);
     Telemetry::AttitudeAngularVelocityBodyHandle subscribe_attitude_angular_velocity_body(
         const Telemetry::AttitudeAngularVelocityBodyCallback& callback);
+    Telemetry::AttitudeAngularVelocityBodyHandle subscribe_attitude_angular_velocity_body(
+        const Telemetry::AttitudeAngularVelocityBodyCallback& callback, double max_rate_hz);
     void
     unsubscribe_attitude_angular_velocity_body(Telemetry::AttitudeAngularVelocityBodyHandle handle);
     Telemetry::FixedwingMetricsHandle
     subscribe_fixedwing_metrics(const Telemetry::FixedwingMetricsCallback& callback);
+    Telemetry::FixedwingMetricsHandle subscribe_fixedwing_metrics(
+        const Telemetry::FixedwingMetricsCallback& callback, double max_rate_hz);
     void unsubscribe_fixedwing_metrics(Telemetry::FixedwingMetricsHandle handle);
     Telemetry::GroundTruthHandle
     subscribe_ground_truth(const Telemetry::GroundTruthCallback& callback);
+    Telemetry::GroundTruthHandle
+    subscribe_ground_truth(const Telemetry::GroundTruthCallback& callback, double max_rate_hz);
     void unsubscribe_ground_truth(Telemetry::GroundTruthHandle handle);
     Telemetry::AttitudeQuaternionHandle
     subscribe_camera_attitude_quaternion(const Telemetry::AttitudeQuaternionCallback& callback);
@@ -154,12 +196,19 @@ public:
     void unsubscribe_camera_attitude_euler(Telemetry::AttitudeEulerHandle handle);
     Telemetry::VelocityNedHandle
     subscribe_velocity_ned(const Telemetry::VelocityNedCallback& callback);
+    Telemetry::VelocityNedHandle
+    subscribe_velocity_ned(const Telemetry::VelocityNedCallback& callback, double max_rate_hz);
     void unsubscribe_velocity_ned(Telemetry::VelocityNedHandle handle);
     Telemetry::ImuHandle subscribe_imu(const Telemetry::ImuCallback& callback);
+    Telemetry::ImuHandle subscribe_imu(const Telemetry::ImuCallback& callback, double max_rate_hz);
     void unsubscribe_imu(Telemetry::ImuHandle handle);
     Telemetry::ScaledImuHandle subscribe_scaled_imu(const Telemetry::ScaledImuCallback& callback);
+    Telemetry::ScaledImuHandle
+    subscribe_scaled_imu(const Telemetry::ScaledImuCallback& callback, double max_rate_hz);
     void unsubscribe_scaled_imu(Telemetry::ScaledImuHandle handle);
     Telemetry::RawImuHandle subscribe_raw_imu(const Telemetry::RawImuCallback& callback);
+    Telemetry::RawImuHandle
+    subscribe_raw_imu(const Telemetry::RawImuCallback& callback, double max_rate_hz);
     void unsubscribe_raw_imu(Telemetry::RawImuHandle handle);
     Telemetry::GpsInfoHandle subscribe_gps_info(const Telemetry::GpsInfoCallback& callback);
     void unsubscribe_gps_info(Telemetry::GpsInfoHandle handle);
@@ -192,6 +241,8 @@ public:
     subscribe_actuator_output_status(const Telemetry::ActuatorOutputStatusCallback& callback);
     void unsubscribe_actuator_output_status(Telemetry::ActuatorOutputStatusHandle handle);
     Telemetry::OdometryHandle subscribe_odometry(const Telemetry::OdometryCallback& callback);
+    Telemetry::OdometryHandle
+    subscribe_odometry(const Telemetry::OdometryCallback& callback, double max_rate_hz);
     void unsubscribe_odometry(Telemetry::OdometryHandle handle);
     Telemetry::DistanceSensorHandle
     subscribe_distance_sensor(const Telemetry::DistanceSensorCallback& callback);
@@ -200,8 +251,12 @@ public:
     subscribe_scaled_pressure(const Telemetry::ScaledPressureCallback& callback);
     void unsubscribe_scaled_pressure(Telemetry::ScaledPressureHandle handle);
     Telemetry::HeadingHandle subscribe_heading(const Telemetry::HeadingCallback& callback);
+    Telemetry::HeadingHandle
+    subscribe_heading(const Telemetry::HeadingCallback& callback, double max_rate_hz);
     void unsubscribe_heading(Telemetry::HeadingHandle handle);
     Telemetry::AltitudeHandle subscribe_altitude(const Telemetry::AltitudeCallback& callback);
+    Telemetry::AltitudeHandle
+    subscribe_altitude(const Telemetry::AltitudeCallback& callback, double max_rate_hz);
     void unsubscribe_altitude(Telemetry::AltitudeHandle handle);
 
     TelemetryImpl(const TelemetryImpl&) = delete;
@@ -221,6 +276,7 @@ private:
     void set_fixedwing_metrics(Telemetry::FixedwingMetrics fixedwing_metrics);
     void set_ground_truth(Telemetry::GroundTruth ground_truth);
     void set_camera_attitude_euler_angle(Telemetry::EulerAngle euler_angle);
+    void set_camera_attitude_quaternion(Telemetry::Quaternion quaternion);
     void set_velocity_ned(Telemetry::VelocityNed velocity_ned);
     void set_imu_reading_ned(Telemetry::Imu imu);
     void set_scaled_imu(Telemetry::Imu imu);
@@ -234,7 +290,25 @@ private:
     void set_health_gyrometer_calibration(bool ok);
     void set_health_accelerometer_calibration(bool ok);
     void set_health_magnetometer_calibration(bool ok);
-    void set_health_armable(bool ok);
+    template<typename Function> void update_health(Function&& function);
+
+    Telemetry::EulerAngle derived_attitude_euler() const;
+
+    static TelemetrySharedMemory::Position
+    to_shared(const Telemetry::Position& position, uint64_t receive_timestamp_us);
+    static TelemetrySharedMemory::VelocityNed
+    to_shared(const Telemetry::VelocityNed& velocity_ned, uint64_t receive_timestamp_us);
+    static TelemetrySharedMemory::AttitudeQuaternion
+    to_shared(const Telemetry::Quaternion& quaternion, uint64_t receive_timestamp_us);
+    static TelemetrySharedMemory::AngularVelocityBody to_shared(
+        const Telemetry::AngularVelocityBody& angular_velocity_body,
+        uint64_t receive_timestamp_us);
+    Telemetry::Result replace_shared_memory_writer(const std::string& name);
+
+    // Needs _subscription_mutex
+    template<typename T, typename Getter>
+    void queue_state_if_due(
+        CallbackList<T>& subscriptions, StateChangeFilter<T>& filter, Getter&& getter);
     void set_rc_status(std::optional<bool> available, std::optional<float> signal_strength_percent);
     void set_unix_epoch_time_us(uint64_t time_us);
     void set_actuator_control_target(uint8_t group, const std::vector<float>& controls);
@@ -245,6 +319,14 @@ private:
     void set_heading(Telemetry::Heading heading);
     void set_altitude(Telemetry::Altitude altitude);
 
+    // Needs _subscription_mutex, so that the requests are sent in order.
+    void update_automatic_rate(uint16_t message_id);
+    std::optional<double> subscriber_rate_hz(uint16_t message_id) const;
+    // Needs _subscription_mutex as well.
+    void subscriptions_changed(uint16_t message_id);
+    void update_message_demand();
+    bool message_needed(uint16_t message_id);
+
     void process_position_velocity_ned(const mavlink_message_t& message);
     void process_global_position_int(const mavlink_message_t& message);
     void process_home_position(const mavlink_message_t& message);
@@ -312,20 +394,41 @@ private:
 
     static Telemetry::FlightMode telemetry_flight_mode_from_flight_mode(FlightMode flight_mode);
 
-    // Make all fields thread-safe using mutexs
+    // The latest values polled most often, e.g. from control loops, can be
+    // read without taking a lock.
+    // Position, velocity, attitude, battery, flight mode and health are
+    // kept together, so that they can be read consistently at once.
+    Seqlock<TelemetryExt::Snapshot> _snapshot{};
+
+    // The Euler angles of the latest attitude quaternion, only derived once
+    // they are read.
+    struct AttitudeEulerCache {
+        bool valid{false};
+        Telemetry::Quaternion quaternion{};
+        Telemetry::EulerAngle euler_angle{};
+    };
+    mutable Seqlock<AttitudeEulerCache> _attitude_euler_cache{};
+
+    // Only filled if enabled by the user.
+    static constexpr std::size_t history_size = 512;
+    TelemetryHistory<Telemetry::Position, history_size> _position_history{};
+    TelemetryHistory<Telemetry::VelocityNed, history_size> _velocity_ned_history{};
+    TelemetryHistory<Telemetry::Quaternion, history_size> _attitude_quaternion_history{};
+    // Protected by _subscription_mutex.
+    bool _history_enabled{false};
+    // Only set if publishing is enabled by the user, read with std::atomic_load.
+    std::shared_ptr<TelemetrySharedMemoryWriter> _shared_memory_writer{};
+    Seqlock<Telemetry::Heading> _heading{};
+    Seqlock<Telemetry::PositionVelocityNed> _position_velocity_ned{};
+    Seqlock<Telemetry::Position> _home_position{};
+    Seqlock<Telemetry::AngularVelocityBody> _attitude_angular_velocity_body{};
+    Seqlock<Telemetry::Imu> _imu_reading_ned{};
+    Seqlock<Telemetry::GpsInfo> _gps_info{};
+    Seqlock<Telemetry::Altitude> _altitude{};
+
+    // Make all other fields thread-safe using mutexs
     // The mutexs are mutable so that the lock can get aqcuired in
     // methods marked const.
-    mutable std::mutex _position_mutex{};
-    Telemetry::Position _position{};
-
-    mutable std::mutex _heading_mutex{};
-    Telemetry::Heading _heading{};
-
-    mutable std::mutex _position_velocity_ned_mutex{};
-    Telemetry::PositionVelocityNed _position_velocity_ned{};
-
-    mutable std::mutex _home_position_mutex{};
-    Telemetry::Position _home_position{};
 
     // If possible, just use atomic instead of a mutex.
     std::atomic_bool _in_air{false};
@@ -334,14 +437,11 @@ private:
     mutable std::mutex _status_text_mutex{};
     Telemetry::StatusText _status_text{};
 
-    mutable std::mutex _attitude_quaternion_mutex{};
-    Telemetry::Quaternion _attitude_quaternion{};
-
-    mutable std::mutex _camera_attitude_euler_angle_mutex{};
-    Telemetry::EulerAngle _camera_attitude_euler_angle{};
-
-    mutable std::mutex _attitude_angular_velocity_body_mutex{};
-    Telemetry::AngularVelocityBody _attitude_angular_velocity_body{};
+    // Kept as received, the other representation is derived once it is read.
+    mutable std::mutex _camera_attitude_mutex{};
+    mutable std::optional<Telemetry::Quaternion> _camera_attitude_quaternion{};
+    mutable std::optional<Telemetry::EulerAngle> _camera_attitude_euler_angle{
+        Telemetry::EulerAngle{}};
 
     mutable std::mutex _ground_truth_mutex{};
     Telemetry::GroundTruth _ground_truth{};
@@ -349,30 +449,15 @@ private:
     mutable std::mutex _fixedwing_metrics_mutex{};
     Telemetry::FixedwingMetrics _fixedwing_metrics{};
 
-    mutable std::mutex _velocity_ned_mutex{};
-    Telemetry::VelocityNed _velocity_ned{};
-
-    mutable std::mutex _imu_reading_ned_mutex{};
-    Telemetry::Imu _imu_reading_ned{};
-
     mutable std::mutex _scaled_imu_mutex{};
     Telemetry::Imu _scaled_imu{};
 
     mutable std::mutex _raw_imu_mutex{};
     Telemetry::Imu _raw_imu{};
 
-    mutable std::mutex _gps_info_mutex{};
-    Telemetry::GpsInfo _gps_info{};
-
     mutable std::mutex _raw_gps_mutex{};
     Telemetry::RawGps _raw_gps{};
 
-    mutable std::mutex _battery_mutex{};
-    Telemetry::Battery _battery{};
-
-    mutable std::mutex _health_mutex{};
-    Telemetry::Health _health{};
-
     mutable std::mutex _vtol_state_mutex{};
     Telemetry::VtolState _vtol_state{Telemetry::VtolState::Undefined};
 
@@ -400,9 +485,6 @@ private:
     mutable std::mutex _scaled_pressure_mutex{};
     Telemetry::ScaledPressure _scaled_pressure{};
 
-    mutable std::mutex _altitude_mutex{};
-    Telemetry::Altitude _altitude{};
-
     mutable std::mutex _request_home_position_mutex{};
 
     std::atomic<bool> _hitl_enabled{false};
@@ -434,6 +516,20 @@ private:
     CallbackList<Telemetry::VtolState> _vtol_state_subscriptions{};
     CallbackList<Telemetry::LandedState> _landed_state_subscriptions{};
     CallbackList<Telemetry::RcStatus> _rc_status_subscriptions{};
+
+    // States which rarely change are only delivered on a change, or at the
+    // keep-alive interval, see queue_state_if_due(). A new subscriber resets
+    // the filter, so that it gets the current state.
+    std::atomic<double> _state_keep_alive_s{0.0};
+    StateChangeFilter<bool> _in_air_filter{};
+    StateChangeFilter<bool> _armed_filter{};
+    StateChangeFilter<Telemetry::FlightMode> _flight_mode_filter{};
+    StateChangeFilter<Telemetry::Health> _health_filter{};
+    StateChangeFilter<bool> _health_all_ok_filter{};
+    StateChangeFilter<Telemetry::VtolState> _vtol_state_filter{};
+    StateChangeFilter<Telemetry::LandedState> _landed_state_filter{};
+    StateChangeFilter<Telemetry::RcStatus> _rc_status_filter{};
+
     CallbackList<uint64_t> _unix_epoch_time_subscriptions{};
     CallbackList<Telemetry::ActuatorControlTarget> _actuator_control_target_subscriptions{};
     CallbackList<Telemetry::ActuatorOutputStatus> _actuator_output_status_subscriptions{};
@@ -448,6 +544,11 @@ private:
     double _velocity_ned_rate_hz{0.0};
     double _position_rate_hz{-1.0};
 
+    // Without any subscriber, messages are still needed for the getters, but
+    // rarely.
+    static constexpr double automatic_idle_rate_hz = 1.0;
+    std::atomic<bool> _automatic_rates_enabled{false};
+
     void* _rc_channels_timeout_cookie{nullptr};
     void* _gps_raw_timeout_cookie{nullptr};
     void* _unix_epoch_timeout_cookie{nullptr};
@@ -0,0 +1,137 @@
+#include "telemetry_shared_memory_writer.h"
+
+#include <new>
+#include "log.h"
+
+#if !defined(WINDOWS) && !defined(__ANDROID__)
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace mavsdk {
+
+std::string TelemetrySharedMemoryWriter::shm_name(const std::string& name)
+{
+    if (!name.empty() && name[0] == '/') {
+        return name;
+    }
+    return "/" + name;
+}
+
+#if defined(WINDOWS) || defined(__ANDROID__)
+
+std::unique_ptr<TelemetrySharedMemoryWriter>
+TelemetrySharedMemoryWriter::create(const std::string& name, uint8_t system_id)
+{
+    (void)name;
+    (void)system_id;
+    LogErr() << "Publishing telemetry to shared memory is not supported on this platform";
+    return nullptr;
+}
+
+TelemetrySharedMemoryWriter::~TelemetrySharedMemoryWriter() = default;
+
+std::unique_ptr<TelemetrySharedMemoryReader>
+TelemetrySharedMemoryReader::open(const std::string& name)
+{
+    (void)name;
+    return nullptr;
+}
+
+TelemetrySharedMemoryReader::~TelemetrySharedMemoryReader() = default;
+
+#else
+
+std::unique_ptr<TelemetrySharedMemoryWriter>
+TelemetrySharedMemoryWriter::create(const std::string& name, uint8_t system_id)
+{
+    const auto path = shm_name(name);
+
+    const int fd = shm_open(path.c_str(), O_CREAT | O_RDWR, 0644);
+    if (fd < 0) {
+        LogErr() << "Could not create shared memory " << path << ": " << strerror(errno);
+        return nullptr;
+    }
+
+    if (ftruncate(fd, sizeof(TelemetrySharedMemory)) != 0) {
+        LogErr() << "Could not size shared memory " << path << ": " << strerror(errno);
+        close(fd);
+        shm_unlink(path.c_str());
+        return nullptr;
+    }
+
+    void* address = mmap(
+        nullptr, sizeof(TelemetrySharedMemory), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    // The mapping stays valid without the descriptor.
+    close(fd);
+    if (address == MAP_FAILED) {
+        LogErr() << "Could not map shared memory " << path << ": " << strerror(errno);
+        shm_unlink(path.c_str());
+        return nullptr;
+    }
+
+    // Readers ignore it until the magic is set, which comes last.
+    auto* memory = new (address) TelemetrySharedMemory{};
+    memory->version = TelemetrySharedMemory::VERSION;
+    memory->size = sizeof(TelemetrySharedMemory);
+    memory->system_id = system_id;
+    memory->magic.store(TelemetrySharedMemory::MAGIC, std::memory_order_release);
+
+    return std::unique_ptr<TelemetrySharedMemoryWriter>(
+        new TelemetrySharedMemoryWriter(path, memory));
+}
+
+TelemetrySharedMemoryWriter::~TelemetrySharedMemoryWriter()
+{
+    // Readers which still have it mapped can tell that it's gone.
+    _memory->magic.store(0, std::memory_order_release);
+    munmap(_memory, sizeof(TelemetrySharedMemory));
+    shm_unlink(_shm_name.c_str());
+}
+
+std::unique_ptr<TelemetrySharedMemoryReader>
+TelemetrySharedMemoryReader::open(const std::string& name)
+{
+    const auto path = TelemetrySharedMemoryWriter::shm_name(name);
+
+    const int fd = shm_open(path.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        return nullptr;
+    }
+
+    struct stat info {};
+    if (fstat(fd, &info) != 0 ||
+        static_cast<size_t>(info.st_size) < sizeof(TelemetrySharedMemory)) {
+        close(fd);
+        return nullptr;
+    }
+
+    void* address = mmap(nullptr, sizeof(TelemetrySharedMemory), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (address == MAP_FAILED) {
+        return nullptr;
+    }
+
+    const auto* memory = static_cast<const TelemetrySharedMemory*>(address);
+    if (memory->magic.load(std::memory_order_acquire) != TelemetrySharedMemory::MAGIC ||
+        memory->version != TelemetrySharedMemory::VERSION ||
+        memory->size != sizeof(TelemetrySharedMemory)) {
+        munmap(address, sizeof(TelemetrySharedMemory));
+        return nullptr;
+    }
+
+    return std::unique_ptr<TelemetrySharedMemoryReader>(new TelemetrySharedMemoryReader(memory));
+}
+
+TelemetrySharedMemoryReader::~TelemetrySharedMemoryReader()
+{
+    munmap(const_cast<TelemetrySharedMemory*>(_memory), sizeof(TelemetrySharedMemory));
+}
+
+#endif
+
+} // namespace mavsdk
@@ -0,0 +1,66 @@
+#include "telemetry_shared_memory_writer.h"
+
+#include <gtest/gtest.h>
+#include <string>
+
+using namespace mavsdk;
+
+#if !defined(WINDOWS) && !defined(__ANDROID__)
+
+#include <unistd.h>
+
+static std::string unique_name()
+{
+    return "mavsdk-telemetry-test-" + std::to_string(getpid());
+}
+
+TEST(TelemetrySharedMemory, ReaderSeesStoredValues)
+{
+    const auto name = unique_name();
+    auto writer = TelemetrySharedMemoryWriter::create(name, 42);
+    ASSERT_NE(writer, nullptr);
+
+    TelemetrySharedMemory::Position position{};
+    position.latitude_deg = 47.397742;
+    position.longitude_deg = 8.545594;
+    position.absolute_altitude_m = 488.0f;
+    position.relative_altitude_m = 10.5f;
+    position.receive_timestamp_us = 1234;
+    writer->store(&TelemetrySharedMemory::position, position);
+
+    auto reader = TelemetrySharedMemoryReader::open(name);
+    ASSERT_NE(reader, nullptr);
+    EXPECT_EQ(reader->memory().system_id, 42u);
+
+    const auto loaded = reader->memory().position.load();
+    EXPECT_DOUBLE_EQ(loaded.latitude_deg, position.latitude_deg);
+    EXPECT_DOUBLE_EQ(loaded.longitude_deg, position.longitude_deg);
+    EXPECT_FLOAT_EQ(loaded.absolute_altitude_m, position.absolute_altitude_m);
+    EXPECT_FLOAT_EQ(loaded.relative_altitude_m, position.relative_altitude_m);
+    EXPECT_EQ(loaded.receive_timestamp_us, 1234u);
+
+    // Nothing received yet.
+    EXPECT_EQ(reader->memory().velocity_ned.load().receive_timestamp_us, 0u);
+
+    // Later values are seen through the same mapping.
+    position.receive_timestamp_us = 5678;
+    writer->store(&TelemetrySharedMemory::position, position);
+    EXPECT_EQ(reader->memory().position.load().receive_timestamp_us, 5678u);
+}
+
+TEST(TelemetrySharedMemory, ReaderSeesWhenWriterIsGone)
+{
+    const auto name = unique_name();
+    EXPECT_EQ(TelemetrySharedMemoryReader::open(name), nullptr);
+
+    auto writer = TelemetrySharedMemoryWriter::create(name, 1);
+    ASSERT_NE(writer, nullptr);
+    auto reader = TelemetrySharedMemoryReader::open(name);
+    ASSERT_NE(reader, nullptr);
+
+    writer.reset();
+    EXPECT_EQ(reader->memory().magic.load(), 0u);
+    EXPECT_EQ(TelemetrySharedMemoryReader::open(name), nullptr);
+}
+
+#endif
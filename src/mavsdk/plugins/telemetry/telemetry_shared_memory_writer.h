@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include "plugins/telemetry/telemetry_shared_memory.h"
+
+namespace mavsdk {
+
+// Creates the shared memory of TelemetrySharedMemory under a name and
+// publishes into it, until destroyed, which removes the name again.
+//
+// Storing is serialized, so the slots keep a single writer even if the
+// telemetry of a system is handled on several threads.
+class TelemetrySharedMemoryWriter {
+public:
+    // Returns nullptr if the shared memory could not be created, which is
+    // logged, or isn't supported on this platform.
+    static std::unique_ptr<TelemetrySharedMemoryWriter>
+    create(const std::string& name, uint8_t system_id);
+
+    ~TelemetrySharedMemoryWriter();
+
+    TelemetrySharedMemoryWriter(const TelemetrySharedMemoryWriter&) = delete;
+    TelemetrySharedMemoryWriter& operator=(const TelemetrySharedMemoryWriter&) = delete;
+
+    template<typename T>
+    void store(TelemetrySharedMemory::Slot<T> TelemetrySharedMemory::*slot, const T& value)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        (_memory->*slot).store(value);
+    }
+
+    // POSIX wants the name to start with a slash, which is added if missing.
+    static std::string shm_name(const std::string& name);
+
+private:
+    TelemetrySharedMemoryWriter(std::string shm_name, TelemetrySharedMemory* memory) :
+        _shm_name(std::move(shm_name)),
+        _memory(memory)
+    {}
+
+    const std::string _shm_name;
+    std::mutex _mutex{};
+    TelemetrySharedMemory* const _memory;
+};
+
+} // namespace mavsdk
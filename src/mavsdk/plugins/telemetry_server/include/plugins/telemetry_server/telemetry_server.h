@@ -16,6 +16,7 @@
 
 #include "server_plugin_base.h"
 
+#include "awaitable.h"
 #include "handle.h"
 
 namespace mavsdk {
@@ -918,7 +919,8 @@ public:
      *
      * @return Result of request.
      */
-    Result publish_position(Position position, VelocityNed velocity_ned, Heading heading) const;
+    Result publish_position(
+        const Position& position, const VelocityNed& velocity_ned, const Heading& heading) const;
 
     /**
      * @brief Publish to 'home position' updates.
@@ -927,7 +929,7 @@ public:
      *
      * @return Result of request.
      */
-    Result publish_home(Position home) const;
+    Result publish_home(const Position& home) const;
 
     /**
      * @brief Publish 'sys status' updates.
@@ -937,7 +939,7 @@ public:
      * @return Result of request.
      */
     Result publish_sys_status(
-        Battery battery,
+        const Battery& battery,
         bool rc_receiver_status,
         bool gyro_status,
         bool accel_status,
@@ -960,7 +962,7 @@ public:
      *
      * @return Result of request.
      */
-    Result publish_raw_gps(RawGps raw_gps, GpsInfo gps_info) const;
+    Result publish_raw_gps(const RawGps& raw_gps, const GpsInfo& gps_info) const;
 
     /**
      * @brief Publish to 'battery' updates.
@@ -969,7 +971,7 @@ public:
      *
      * @return Result of request.
      */
-    Result publish_battery(Battery battery) const;
+    Result publish_battery(const Battery& battery) const;
 
     /**
      * @brief Publish to 'status text' updates.
@@ -978,7 +980,7 @@ public:
      *
      * @return Result of request.
      */
-    Result publish_status_text(StatusText status_text) const;
+    Result publish_status_text(const StatusText& status_text) const;
 
     /**
      * @brief Publish to 'odometry' updates.
@@ -987,7 +989,7 @@ public:
      *
      * @return Result of request.
      */
-    Result publish_odometry(Odometry odometry) const;
+    Result publish_odometry(const Odometry& odometry) const;
 
     /**
      * @brief Publish to 'position velocity' updates.
@@ -996,7 +998,7 @@ public:
      *
      * @return Result of request.
      */
-    Result publish_position_velocity_ned(PositionVelocityNed position_velocity_ned) const;
+    Result publish_position_velocity_ned(const PositionVelocityNed& position_velocity_ned) const;
 
     /**
      * @brief Publish to 'ground truth' updates.
@@ -1005,7 +1007,7 @@ public:
      *
      * @return Result of request.
      */
-    Result publish_ground_truth(GroundTruth ground_truth) const;
+    Result publish_ground_truth(const GroundTruth& ground_truth) const;
 
     /**
      * @brief Publish to 'IMU' updates (in SI units in NED body frame).
@@ -1014,7 +1016,7 @@ public:
      *
      * @return Result of request.
      */
-    Result publish_imu(Imu imu) const;
+    Result publish_imu(const Imu& imu) const;
 
     /**
      * @brief Publish to 'Scaled IMU' updates.
@@ -1023,7 +1025,7 @@ public:
      *
      * @return Result of request.
      */
-    Result publish_scaled_imu(Imu imu) const;
+    Result publish_scaled_imu(const Imu& imu) const;
 
     /**
      * @brief Publish to 'Raw IMU' updates.
@@ -1032,7 +1034,7 @@ public:
      *
      * @return Result of request.
      */
-    Result publish_raw_imu(Imu imu) const;
+    Result publish_raw_imu(const Imu& imu) const;
 
     /**
      * @brief Publish to 'unix epoch time' updates.
@@ -1050,7 +1052,7 @@ public:
      *
      * @return Result of request.
      */
-    Result publish_distance_sensor(DistanceSensor distance_sensor) const;
+    Result publish_distance_sensor(const DistanceSensor& distance_sensor) const;
 
     /**
      * @brief Copy constructor.
@@ -1065,6 +1067,9 @@ public:
 private:
     /** @private Underlying implementation, set at instantiation */
     std::unique_ptr<TelemetryServerImpl> _impl;
+
+    /** @private Hand-written additions in telemetry_server_ext.h, if any */
+    friend class TelemetryServerExt;
 };
 
 } // namespace mavsdk
\ No newline at end of file
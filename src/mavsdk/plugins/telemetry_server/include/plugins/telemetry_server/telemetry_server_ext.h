@@ -0,0 +1,108 @@
+#pragma once
+
+#include <optional>
+#include <vector>
+
+#include "plugins/telemetry_server/telemetry_server.h"
+
+namespace mavsdk {
+
+class TelemetryServerImpl;
+
+/**
+ * @brief Additions to TelemetryServer that are only available in C++.
+ *
+ * Unlike telemetry_server.h, this header is not generated from the proto files,
+ * so the calls here are not available through mavsdk_server.
+ *
+ * It works on the TelemetryServer plugin it is created with, which has to outlive it:
+ *
+ *     ```cpp
+ *     auto telemetry_server = TelemetryServer(system);
+ *     auto telemetry_server_ext = TelemetryServerExt(telemetry_server);
+ *     ```
+ */
+class TelemetryServerExt {
+public:
+    /**
+     * @brief Constructor. Uses the given TelemetryServer plugin.
+     *
+     * @param telemetry_server The plugin, which has to outlive this object.
+     */
+    explicit TelemetryServerExt(TelemetryServer& telemetry_server);
+
+    /**
+     * @brief Telemetry to publish together with `publish_batch`.
+     *
+     * Only what is set is published, status texts in the order given.
+     */
+    struct Batch {
+        /**
+         * @brief Arguments of `TelemetryServer::publish_position`.
+         */
+        struct PositionEntry {
+            TelemetryServer::Position position{}; /**< @brief Position */
+            TelemetryServer::VelocityNed velocity_ned{}; /**< @brief Velocity in NED coordinates */
+            TelemetryServer::Heading heading{}; /**< @brief Heading */
+        };
+
+        /**
+         * @brief Arguments of `TelemetryServer::publish_raw_gps`.
+         */
+        struct RawGpsEntry {
+            TelemetryServer::RawGps raw_gps{}; /**< @brief Raw GPS */
+            TelemetryServer::GpsInfo gps_info{}; /**< @brief GPS info */
+        };
+
+        /**
+         * @brief Arguments of `TelemetryServer::publish_sys_status`.
+         */
+        struct SysStatusEntry {
+            TelemetryServer::Battery battery{}; /**< @brief Battery */
+            bool rc_receiver_status{}; /**< @brief RC receiver is healthy */
+            bool gyro_status{}; /**< @brief Gyro is healthy */
+            bool accel_status{}; /**< @brief Accelerometer is healthy */
+            bool mag_status{}; /**< @brief Magnetometer is healthy */
+            bool gps_status{}; /**< @brief GPS is healthy */
+        };
+
+        /**
+         * @brief Arguments of `TelemetryServer::publish_extended_sys_state`.
+         */
+        struct ExtendedSysStateEntry {
+            TelemetryServer::VtolState vtol_state{}; /**< @brief VTOL state */
+            TelemetryServer::LandedState landed_state{}; /**< @brief Landed state */
+        };
+
+        std::optional<PositionEntry> position{}; /**< @brief Position, velocity and heading */
+        std::optional<TelemetryServer::Position> home{}; /**< @brief Home position */
+        std::optional<RawGpsEntry> raw_gps{}; /**< @brief Raw GPS and GPS info */
+        std::optional<TelemetryServer::Battery> battery{}; /**< @brief Battery */
+        std::optional<TelemetryServer::DistanceSensor>
+            distance_sensor{}; /**< @brief Distance sensor */
+        std::optional<TelemetryServer::PositionVelocityNed>
+            position_velocity_ned{}; /**< @brief Local position and velocity */
+        std::optional<SysStatusEntry> sys_status{}; /**< @brief Sys status */
+        std::optional<ExtendedSysStateEntry>
+            extended_sys_state{}; /**< @brief Extended sys state */
+        std::vector<TelemetryServer::StatusText> status_texts{}; /**< @brief Status texts */
+    };
+
+    /**
+     * @brief Publish several telemetry updates at once.
+     *
+     * Unlike calling the single publish functions one after another, the
+     * messages are packed in one go and handed to the connections together,
+     * e.g. in as few UDP datagrams as possible.
+     *
+     * This function is blocking.
+     *
+     * @return Result of request.
+     */
+    TelemetryServer::Result publish_batch(const Batch& batch) const;
+
+private:
+    TelemetryServerImpl& _impl;
+};
+
+} // namespace mavsdk
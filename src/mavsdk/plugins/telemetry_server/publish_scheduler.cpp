@@ -0,0 +1,64 @@
+#include "publish_scheduler.h"
+
+#include <algorithm>
+#include <numeric>
+
+namespace mavsdk {
+
+void PublishScheduler::set_interval(uint32_t msg_id, uint32_t interval_ms)
+{
+    remove(msg_id);
+
+    const auto interval = std::max<uint32_t>(interval_ms, 1);
+    const auto it = std::upper_bound(
+        _streams.begin(), _streams.end(), interval, [](uint32_t value, const Stream& stream) {
+            return value < stream.interval_ms;
+        });
+    _streams.insert(it, Stream{msg_id, interval, 0});
+
+    update_tick_interval();
+}
+
+void PublishScheduler::remove(uint32_t msg_id)
+{
+    _streams.erase(
+        std::remove_if(
+            _streams.begin(),
+            _streams.end(),
+            [msg_id](const Stream& stream) { return stream.msg_id == msg_id; }),
+        _streams.end());
+
+    update_tick_interval();
+}
+
+const std::vector<uint32_t>& PublishScheduler::tick()
+{
+    _due.clear();
+
+    for (auto& stream : _streams) {
+        if (stream.remaining_ms <= 0) {
+            _due.push_back(stream.msg_id);
+
+            // Whatever was missed in between is not worth catching up on.
+            stream.remaining_ms += stream.interval_ms;
+            if (stream.remaining_ms <= 0) {
+                stream.remaining_ms = stream.interval_ms;
+            }
+        }
+        stream.remaining_ms -= _tick_interval_ms;
+    }
+
+    return _due;
+}
+
+void PublishScheduler::update_tick_interval()
+{
+    uint32_t divisor = 0;
+    for (const auto& stream : _streams) {
+        divisor = std::gcd(divisor, stream.interval_ms);
+    }
+
+    _tick_interval_ms = _streams.empty() ? 0 : std::max(divisor, min_tick_interval_ms);
+}
+
+} // namespace mavsdk
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace mavsdk {
+
+// Decides which messages are due in each tick, for messages published at
+// requested intervals.
+//
+// All messages share one tick, the greatest common divisor of their intervals,
+// so that messages falling due at the same time go out together. Due messages
+// are ordered rate-monotonically, i.e. shortest interval first.
+//
+// Not thread-safe, the caller needs to lock.
+class PublishScheduler {
+public:
+    // Coarser than this, we rather publish a bit late than wake up more often.
+    static constexpr uint32_t min_tick_interval_ms = 10;
+
+    // Adds the message, due at the next tick, or changes its interval.
+    void set_interval(uint32_t msg_id, uint32_t interval_ms);
+    void remove(uint32_t msg_id);
+
+    // The interval to call tick() at, 0 if there is nothing to publish.
+    [[nodiscard]] uint32_t tick_interval_ms() const { return _tick_interval_ms; }
+
+    // Advances by one tick and returns the messages that are due.
+    const std::vector<uint32_t>& tick();
+
+private:
+    struct Stream {
+        uint32_t msg_id;
+        uint32_t interval_ms;
+        int64_t remaining_ms;
+    };
+
+    void update_tick_interval();
+
+    // Sorted by interval, shortest first.
+    std::vector<Stream> _streams{};
+    std::vector<uint32_t> _due{};
+    uint32_t _tick_interval_ms{0};
+};
+
+} // namespace mavsdk
@@ -0,0 +1,97 @@
+#include "publish_scheduler.h"
+#include <gtest/gtest.h>
+
+using namespace mavsdk;
+
+TEST(PublishScheduler, NothingToTickWhenEmpty)
+{
+    PublishScheduler scheduler;
+    EXPECT_EQ(scheduler.tick_interval_ms(), 0);
+    EXPECT_TRUE(scheduler.tick().empty());
+}
+
+TEST(PublishScheduler, TicksAtGreatestCommonDivisor)
+{
+    PublishScheduler scheduler;
+    scheduler.set_interval(33, 200);
+    EXPECT_EQ(scheduler.tick_interval_ms(), 200);
+
+    scheduler.set_interval(1, 1000);
+    EXPECT_EQ(scheduler.tick_interval_ms(), 200);
+
+    scheduler.set_interval(24, 300);
+    EXPECT_EQ(scheduler.tick_interval_ms(), 100);
+
+    scheduler.remove(24);
+    EXPECT_EQ(scheduler.tick_interval_ms(), 200);
+
+    scheduler.remove(33);
+    scheduler.remove(1);
+    EXPECT_EQ(scheduler.tick_interval_ms(), 0);
+}
+
+TEST(PublishScheduler, DoesNotTickFasterThanMinimum)
+{
+    PublishScheduler scheduler;
+    scheduler.set_interval(33, 15);
+    scheduler.set_interval(24, 20);
+    EXPECT_EQ(scheduler.tick_interval_ms(), PublishScheduler::min_tick_interval_ms);
+}
+
+TEST(PublishScheduler, GroupsMessagesDueTogetherFastestFirst)
+{
+    PublishScheduler scheduler;
+    scheduler.set_interval(1, 300);
+    scheduler.set_interval(33, 100);
+    scheduler.set_interval(24, 200);
+    ASSERT_EQ(scheduler.tick_interval_ms(), 100);
+
+    // All are due straightaway.
+    EXPECT_EQ(scheduler.tick(), (std::vector<uint32_t>{33, 24, 1}));
+    EXPECT_EQ(scheduler.tick(), (std::vector<uint32_t>{33}));
+    EXPECT_EQ(scheduler.tick(), (std::vector<uint32_t>{33, 24}));
+    EXPECT_EQ(scheduler.tick(), (std::vector<uint32_t>{33, 1}));
+    EXPECT_EQ(scheduler.tick(), (std::vector<uint32_t>{33, 24}));
+    EXPECT_EQ(scheduler.tick(), (std::vector<uint32_t>{33}));
+    EXPECT_EQ(scheduler.tick(), (std::vector<uint32_t>{33, 24, 1}));
+}
+
+TEST(PublishScheduler, KeepsAverageRateWhenTickIsCoarser)
+{
+    PublishScheduler scheduler;
+    scheduler.set_interval(33, 15);
+    scheduler.set_interval(24, 20);
+    ASSERT_EQ(scheduler.tick_interval_ms(), 10);
+
+    unsigned published = 0;
+    for (unsigned i = 0; i < 300; ++i) {
+        for (const auto msg_id : scheduler.tick()) {
+            if (msg_id == 33) {
+                ++published;
+            }
+        }
+    }
+    // 3 s at 15 ms
+    EXPECT_EQ(published, 200);
+}
+
+TEST(PublishScheduler, SkipsWhatCannotBeKeptUpWith)
+{
+    PublishScheduler scheduler;
+    scheduler.set_interval(33, 1);
+    ASSERT_EQ(scheduler.tick_interval_ms(), PublishScheduler::min_tick_interval_ms);
+
+    for (unsigned i = 0; i < 10; ++i) {
+        EXPECT_EQ(scheduler.tick(), (std::vector<uint32_t>{33}));
+    }
+}
+
+TEST(PublishScheduler, ChangingIntervalReplacesStream)
+{
+    PublishScheduler scheduler;
+    scheduler.set_interval(33, 100);
+    scheduler.set_interval(33, 500);
+    EXPECT_EQ(scheduler.tick_interval_ms(), 500);
+    EXPECT_EQ(scheduler.tick(), (std::vector<uint32_t>{33}));
+    EXPECT_EQ(scheduler.tick(), (std::vector<uint32_t>{33}));
+}
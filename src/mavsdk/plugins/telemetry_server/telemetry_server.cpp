@@ -46,18 +46,18 @@ TelemetryServer::TelemetryServer(std::shared_ptr<ServerComponent> server_compone
 TelemetryServer::~TelemetryServer() {}
 
 TelemetryServer::Result TelemetryServer::publish_position(
-    Position position, VelocityNed velocity_ned, Heading heading) const
+    const Position& position, const VelocityNed& velocity_ned, const Heading& heading) const
 {
     return _impl->publish_position(position, velocity_ned, heading);
 }
 
-TelemetryServer::Result TelemetryServer::publish_home(Position home) const
+TelemetryServer::Result TelemetryServer::publish_home(const Position& home) const
 {
     return _impl->publish_home(home);
 }
 
 TelemetryServer::Result TelemetryServer::publish_sys_status(
-    Battery battery,
+    const Battery& battery,
     bool rc_receiver_status,
     bool gyro_status,
     bool accel_status,
@@ -74,48 +74,49 @@ TelemetryServer::publish_extended_sys_state(VtolState vtol_state, LandedState la
     return _impl->publish_extended_sys_state(vtol_state, landed_state);
 }
 
-TelemetryServer::Result TelemetryServer::publish_raw_gps(RawGps raw_gps, GpsInfo gps_info) const
+TelemetryServer::Result TelemetryServer::publish_raw_gps(
+    const RawGps& raw_gps, const GpsInfo& gps_info) const
 {
     return _impl->publish_raw_gps(raw_gps, gps_info);
 }
 
-TelemetryServer::Result TelemetryServer::publish_battery(Battery battery) const
+TelemetryServer::Result TelemetryServer::publish_battery(const Battery& battery) const
 {
     return _impl->publish_battery(battery);
 }
 
-TelemetryServer::Result TelemetryServer::publish_status_text(StatusText status_text) const
+TelemetryServer::Result TelemetryServer::publish_status_text(const StatusText& status_text) const
 {
     return _impl->publish_status_text(status_text);
 }
 
-TelemetryServer::Result TelemetryServer::publish_odometry(Odometry odometry) const
+TelemetryServer::Result TelemetryServer::publish_odometry(const Odometry& odometry) const
 {
     return _impl->publish_odometry(odometry);
 }
 
-TelemetryServer::Result
-TelemetryServer::publish_position_velocity_ned(PositionVelocityNed position_velocity_ned) const
+TelemetryServer::Result TelemetryServer::publish_position_velocity_ned(
+    const PositionVelocityNed& position_velocity_ned) const
 {
     return _impl->publish_position_velocity_ned(position_velocity_ned);
 }
 
-TelemetryServer::Result TelemetryServer::publish_ground_truth(GroundTruth ground_truth) const
+TelemetryServer::Result TelemetryServer::publish_ground_truth(const GroundTruth& ground_truth) const
 {
     return _impl->publish_ground_truth(ground_truth);
 }
 
-TelemetryServer::Result TelemetryServer::publish_imu(Imu imu) const
+TelemetryServer::Result TelemetryServer::publish_imu(const Imu& imu) const
 {
     return _impl->publish_imu(imu);
 }
 
-TelemetryServer::Result TelemetryServer::publish_scaled_imu(Imu imu) const
+TelemetryServer::Result TelemetryServer::publish_scaled_imu(const Imu& imu) const
 {
     return _impl->publish_scaled_imu(imu);
 }
 
-TelemetryServer::Result TelemetryServer::publish_raw_imu(Imu imu) const
+TelemetryServer::Result TelemetryServer::publish_raw_imu(const Imu& imu) const
 {
     return _impl->publish_raw_imu(imu);
 }
@@ -125,8 +126,8 @@ TelemetryServer::Result TelemetryServer::publish_unix_epoch_time(uint64_t time_u
     return _impl->publish_unix_epoch_time(time_us);
 }
 
-TelemetryServer::Result
-TelemetryServer::publish_distance_sensor(DistanceSensor distance_sensor) const
+TelemetryServer::Result TelemetryServer::publish_distance_sensor(
+    const DistanceSensor& distance_sensor) const
 {
     return _impl->publish_distance_sensor(distance_sensor);
 }
@@ -0,0 +1,15 @@
+#include "telemetry_server_impl.h"
+#include "plugins/telemetry_server/telemetry_server_ext.h"
+
+namespace mavsdk {
+
+TelemetryServerExt::TelemetryServerExt(TelemetryServer& telemetry_server) :
+    _impl(*telemetry_server._impl)
+{}
+
+TelemetryServer::Result TelemetryServerExt::publish_batch(const Batch& batch) const
+{
+    return _impl.publish_batch(batch);
+}
+
+} // namespace mavsdk
@@ -15,8 +15,8 @@ TelemetryServerImpl::~TelemetryServerImpl()
 {
     _server_component_impl->unregister_plugin(this);
     std::unique_lock<std::mutex> lock(_interval_mutex);
-    for (const auto& request : _interval_requests) {
-        _server_component_impl->remove_call_every(request.cookie);
+    if (_publish_cookie != nullptr) {
+        _server_component_impl->remove_call_every(_publish_cookie);
     }
 }
 
@@ -26,45 +26,8 @@ void TelemetryServerImpl::init()
     _server_component_impl->register_mavlink_command_handler(
         MAV_CMD_SET_MESSAGE_INTERVAL,
         [this](const MavlinkCommandReceiver::CommandLong& command) {
-            std::lock_guard<std::mutex> lock(_interval_mutex);
-            uint32_t msgid = static_cast<uint32_t>(command.params.param1);
-            // Set interval to 1hz if 0 (default rate)
-            uint32_t interval_ms =
-                command.params.param2 == 0 ?
-                    1000 :
-                    static_cast<uint32_t>(static_cast<double>(command.params.param2) * 1E-3);
-            LogDebug() << "Setting interval for msg id: " << std::to_string(msgid)
-                       << " interval_ms:" << std::to_string(interval_ms);
-            auto found = std::find_if(
-                _interval_requests.begin(),
-                _interval_requests.end(),
-                [msgid](const RequestMsgInterval& item) { return item.msg_id == msgid; });
-
-            if (found == _interval_requests.end() && command.params.param2 != -1) {
-                // If not found interval already, add a new one
-                _interval_requests.push_back({msgid, interval_ms, nullptr});
-                _server_component_impl->add_call_every(
-                    [this, msgid]() {
-                        std::lock_guard<std::mutex> lock_interval(_interval_mutex);
-                        if (_msg_cache.find(msgid) != _msg_cache.end()) {
-                            // Publish if callback exists :)
-                            _server_component_impl->send_message(_msg_cache.at(msgid));
-                        }
-                    },
-                    static_cast<double>(interval_ms) * 1E-3,
-                    &_interval_requests.back().cookie);
-            } else {
-                if (command.params.param2 == -1) {
-                    // Deregister with -1 interval
-                    _server_component_impl->remove_call_every(found->cookie);
-                    _interval_requests.erase(found);
-                } else {
-                    // Update Interval
-                    found->interval = interval_ms;
-                    _server_component_impl->change_call_every(
-                        static_cast<double>(interval_ms) * 1E-3, found->cookie);
-                }
-            }
+            set_publish_interval(
+                static_cast<uint32_t>(command.params.param1), command.params.param2);
 
             return _server_component_impl->make_command_ack_message(
                 command, MAV_RESULT::MAV_RESULT_ACCEPTED);
@@ -72,35 +35,109 @@ void TelemetryServerImpl::init()
         this);
 }
 
+void TelemetryServerImpl::set_publish_interval(uint32_t msg_id, float param2)
+{
+    std::lock_guard<std::mutex> lock(_interval_mutex);
+
+    const auto previous_tick_ms = _publish_scheduler.tick_interval_ms();
+
+    if (param2 == -1) {
+        // Deregister with -1 interval
+        _publish_scheduler.remove(msg_id);
+    } else if (!msg_cache_slot(msg_id)) {
+        LogDebug() << "Not publishing msg id " << msg_id << " at an interval, not cached";
+    } else {
+        // Set interval to 1hz if 0 (default rate)
+        const uint32_t interval_ms =
+            param2 == 0 ? 1000 : static_cast<uint32_t>(static_cast<double>(param2) * 1E-3);
+        LogDebug() << "Setting interval for msg id: " << std::to_string(msg_id)
+                   << " interval_ms:" << std::to_string(interval_ms);
+        _publish_scheduler.set_interval(msg_id, interval_ms);
+    }
+
+    // All messages are published from one tick which follows the intervals.
+    const auto tick_ms = _publish_scheduler.tick_interval_ms();
+    if (tick_ms == previous_tick_ms) {
+        return;
+    }
+
+    if (tick_ms == 0) {
+        _server_component_impl->remove_call_every(_publish_cookie);
+        _publish_cookie = nullptr;
+    } else if (_publish_cookie == nullptr) {
+        _server_component_impl->add_call_every(
+            [this]() { publish_due_messages(); },
+            static_cast<float>(tick_ms) * 1E-3f,
+            &_publish_cookie);
+    } else {
+        _server_component_impl->change_call_every(
+            static_cast<float>(tick_ms) * 1E-3f, _publish_cookie);
+    }
+}
+
+void TelemetryServerImpl::publish_due_messages()
+{
+    _due_messages.clear();
+    {
+        std::lock_guard<std::mutex> lock(_interval_mutex);
+        for (const auto msg_id : _publish_scheduler.tick()) {
+            const auto& cached = _msg_cache[msg_cache_slot(msg_id).value()];
+            // Only published once there is something to publish.
+            if (cached) {
+                _due_messages.push_back(cached.value());
+            }
+        }
+    }
+
+    if (!_due_messages.empty()) {
+        _server_component_impl->send_messages(_due_messages);
+    }
+}
+
 void TelemetryServerImpl::deinit() {}
 
-TelemetryServer::Result TelemetryServerImpl::publish_position(
+mavlink_message_t TelemetryServerImpl::pack_position(
     TelemetryServer::Position position,
     TelemetryServer::VelocityNed velocity_ned,
     TelemetryServer::Heading heading)
 {
+    mavlink_global_position_int_t global_position_int{};
+    global_position_int.time_boot_ms = get_boot_time_ms();
+    global_position_int.lat = static_cast<int32_t>(position.latitude_deg * 1E7);
+    global_position_int.lon = static_cast<int32_t>(position.longitude_deg * 1E7);
+    global_position_int.alt =
+        static_cast<int32_t>(static_cast<double>(position.absolute_altitude_m) * 1E3);
+    global_position_int.relative_alt =
+        static_cast<int32_t>(static_cast<double>(position.relative_altitude_m) * 1E3);
+    global_position_int.vx =
+        static_cast<int16_t>(static_cast<double>(velocity_ned.north_m_s) * 1E2);
+    global_position_int.vy = static_cast<int16_t>(static_cast<double>(velocity_ned.east_m_s) * 1E2);
+    global_position_int.vz = static_cast<int16_t>(static_cast<double>(velocity_ned.down_m_s) * 1E2);
+    global_position_int.hdg = static_cast<uint16_t>(static_cast<double>(heading.heading_deg) * 1E2);
+
     mavlink_message_t msg;
-    mavlink_msg_global_position_int_pack(
+    _position_template.pack(
         _server_component_impl->get_own_system_id(),
         _server_component_impl->get_own_component_id(),
-        &msg,
-        get_boot_time_ms(),
-        static_cast<int32_t>(position.latitude_deg * 1E7),
-        static_cast<int32_t>(position.longitude_deg * 1E7),
-        static_cast<int32_t>(static_cast<double>(position.absolute_altitude_m) * 1E3),
-        static_cast<int32_t>(static_cast<double>(position.relative_altitude_m) * 1E3),
-        static_cast<int16_t>(static_cast<double>(velocity_ned.north_m_s) * 1E2),
-        static_cast<int16_t>(static_cast<double>(velocity_ned.east_m_s) * 1E2),
-        static_cast<int16_t>(static_cast<double>(velocity_ned.down_m_s) * 1E2),
-        static_cast<uint16_t>(static_cast<double>(heading.heading_deg) * 1E2));
+        global_position_int,
+        msg);
 
+    return msg;
+}
+
+TelemetryServer::Result TelemetryServerImpl::publish_position(
+    TelemetryServer::Position position,
+    TelemetryServer::VelocityNed velocity_ned,
+    TelemetryServer::Heading heading)
+{
+    auto msg = pack_position(position, velocity_ned, heading);
     add_msg_cache(MAVLINK_MSG_ID_GLOBAL_POSITION_INT, msg);
 
     return _server_component_impl->send_message(msg) ? TelemetryServer::Result::Success :
                                                        TelemetryServer::Result::Unsupported;
 }
 
-TelemetryServer::Result TelemetryServerImpl::publish_home(TelemetryServer::Position home)
+mavlink_message_t TelemetryServerImpl::pack_home(TelemetryServer::Position home)
 {
     mavlink_message_t msg;
     const float q[4] = {};
@@ -121,13 +158,19 @@ TelemetryServer::Result TelemetryServerImpl::publish_home(TelemetryServer::Posit
         get_boot_time_ms() // TO-DO: System boot
     );
 
+    return msg;
+}
+
+TelemetryServer::Result TelemetryServerImpl::publish_home(TelemetryServer::Position home)
+{
+    auto msg = pack_home(home);
     add_msg_cache(MAVLINK_MSG_ID_HOME_POSITION, msg);
 
     return _server_component_impl->send_message(msg) ? TelemetryServer::Result::Success :
                                                        TelemetryServer::Result::Unsupported;
 }
 
-TelemetryServer::Result TelemetryServerImpl::publish_raw_gps(
+mavlink_message_t TelemetryServerImpl::pack_raw_gps(
     TelemetryServer::RawGps raw_gps, TelemetryServer::GpsInfo gps_info)
 {
     mavlink_message_t msg;
@@ -152,13 +195,20 @@ TelemetryServer::Result TelemetryServerImpl::publish_raw_gps(
         static_cast<uint32_t>(static_cast<double>(raw_gps.heading_uncertainty_deg) * 1E5),
         static_cast<uint16_t>(static_cast<double>(raw_gps.yaw_deg) * 1E2));
 
+    return msg;
+}
+
+TelemetryServer::Result TelemetryServerImpl::publish_raw_gps(
+    TelemetryServer::RawGps raw_gps, TelemetryServer::GpsInfo gps_info)
+{
+    auto msg = pack_raw_gps(raw_gps, gps_info);
     add_msg_cache(MAVLINK_MSG_ID_GPS_RAW_INT, msg);
 
     return _server_component_impl->send_message(msg) ? TelemetryServer::Result::Success :
                                                        TelemetryServer::Result::Unsupported;
 }
 
-TelemetryServer::Result TelemetryServerImpl::publish_battery(TelemetryServer::Battery battery)
+mavlink_message_t TelemetryServerImpl::pack_battery(TelemetryServer::Battery battery)
 {
     mavlink_message_t msg;
 
@@ -185,14 +235,20 @@ TelemetryServer::Result TelemetryServerImpl::publish_battery(TelemetryServer::Ba
         MAV_BATTERY_MODE_UNKNOWN,
         0);
 
+    return msg;
+}
+
+TelemetryServer::Result TelemetryServerImpl::publish_battery(TelemetryServer::Battery battery)
+{
+    auto msg = pack_battery(battery);
     add_msg_cache(MAVLINK_MSG_ID_BATTERY_STATUS, msg);
 
     return _server_component_impl->send_message(msg) ? TelemetryServer::Result::Success :
                                                        TelemetryServer::Result::Unsupported;
 }
 
-TelemetryServer::Result
-TelemetryServerImpl::publish_distance_sensor(TelemetryServer::DistanceSensor distance_sensor)
+mavlink_message_t TelemetryServerImpl::pack_distance_sensor(
+    TelemetryServer::DistanceSensor distance_sensor)
 {
     mavlink_message_t msg;
 
@@ -215,14 +271,20 @@ TelemetryServerImpl::publish_distance_sensor(TelemetryServer::DistanceSensor dis
         q.data(),
         0);
 
+    return msg;
+}
+
+TelemetryServer::Result
+TelemetryServerImpl::publish_distance_sensor(TelemetryServer::DistanceSensor distance_sensor)
+{
+    auto msg = pack_distance_sensor(distance_sensor);
     add_msg_cache(MAVLINK_MSG_ID_DISTANCE_SENSOR, msg);
 
     return _server_component_impl->send_message(msg) ? TelemetryServer::Result::Success :
                                                        TelemetryServer::Result::Unsupported;
 }
 
-TelemetryServer::Result
-TelemetryServerImpl::publish_status_text(TelemetryServer::StatusText status_text)
+mavlink_message_t TelemetryServerImpl::pack_status_text(TelemetryServer::StatusText status_text)
 {
     mavlink_message_t msg;
 
@@ -270,6 +332,14 @@ TelemetryServerImpl::publish_status_text(TelemetryServer::StatusText status_text
         0,
         0);
 
+    return msg;
+}
+
+TelemetryServer::Result
+TelemetryServerImpl::publish_status_text(TelemetryServer::StatusText status_text)
+{
+    auto msg = pack_status_text(status_text);
+
     return _server_component_impl->send_message(msg) ? TelemetryServer::Result::Success :
                                                        TelemetryServer::Result::Unsupported;
 }
@@ -282,22 +352,32 @@ TelemetryServer::Result TelemetryServerImpl::publish_odometry(TelemetryServer::O
     return {};
 }
 
-TelemetryServer::Result TelemetryServerImpl::publish_position_velocity_ned(
+mavlink_message_t TelemetryServerImpl::pack_position_velocity_ned(
     TelemetryServer::PositionVelocityNed position_velocity_ned)
 {
+    mavlink_local_position_ned_t local_position_ned{};
+    local_position_ned.time_boot_ms = get_boot_time_ms();
+    local_position_ned.x = position_velocity_ned.position.north_m;
+    local_position_ned.y = position_velocity_ned.position.east_m;
+    local_position_ned.z = position_velocity_ned.position.down_m;
+    local_position_ned.vx = position_velocity_ned.velocity.north_m_s;
+    local_position_ned.vy = position_velocity_ned.velocity.east_m_s;
+    local_position_ned.vz = position_velocity_ned.velocity.down_m_s;
+
     mavlink_message_t msg;
-    mavlink_msg_local_position_ned_pack(
+    _position_velocity_ned_template.pack(
         _server_component_impl->get_own_system_id(),
         _server_component_impl->get_own_component_id(),
-        &msg,
-        get_boot_time_ms(),
-        position_velocity_ned.position.north_m,
-        position_velocity_ned.position.east_m,
-        position_velocity_ned.position.down_m,
-        position_velocity_ned.velocity.north_m_s,
-        position_velocity_ned.velocity.east_m_s,
-        position_velocity_ned.velocity.down_m_s);
+        local_position_ned,
+        msg);
+
+    return msg;
+}
 
+TelemetryServer::Result TelemetryServerImpl::publish_position_velocity_ned(
+    TelemetryServer::PositionVelocityNed position_velocity_ned)
+{
+    auto msg = pack_position_velocity_ned(position_velocity_ned);
     add_msg_cache(MAVLINK_MSG_ID_LOCAL_POSITION_NED, msg);
 
     return _server_component_impl->send_message(msg) ? TelemetryServer::Result::Success :
@@ -345,7 +425,7 @@ TelemetryServer::Result TelemetryServerImpl::publish_unix_epoch_time(uint64_t ti
     return {};
 }
 
-TelemetryServer::Result TelemetryServerImpl::publish_sys_status(
+mavlink_message_t TelemetryServerImpl::pack_sys_status(
     TelemetryServer::Battery battery,
     bool rc_receiver_status,
     bool gyro_status,
@@ -392,6 +472,19 @@ TelemetryServer::Result TelemetryServerImpl::publish_sys_status(
         0,
         0);
 
+    return msg;
+}
+
+TelemetryServer::Result TelemetryServerImpl::publish_sys_status(
+    TelemetryServer::Battery battery,
+    bool rc_receiver_status,
+    bool gyro_status,
+    bool accel_status,
+    bool mag_status,
+    bool gps_status)
+{
+    auto msg = pack_sys_status(
+        battery, rc_receiver_status, gyro_status, accel_status, mag_status, gps_status);
     add_msg_cache(MAVLINK_MSG_ID_SYS_STATUS, msg);
 
     return _server_component_impl->send_message(msg) ? TelemetryServer::Result::Success :
@@ -432,7 +525,7 @@ uint8_t to_mav_landed_state(TelemetryServer::LandedState landed_state)
     }
 }
 
-TelemetryServer::Result TelemetryServerImpl::publish_extended_sys_state(
+mavlink_message_t TelemetryServerImpl::pack_extended_sys_state(
     TelemetryServer::VtolState vtol_state, TelemetryServer::LandedState landed_state)
 {
     mavlink_message_t msg;
@@ -443,16 +536,89 @@ TelemetryServer::Result TelemetryServerImpl::publish_extended_sys_state(
         to_mav_vtol_state(vtol_state),
         to_mav_landed_state(landed_state));
 
+    return msg;
+}
+
+TelemetryServer::Result TelemetryServerImpl::publish_extended_sys_state(
+    TelemetryServer::VtolState vtol_state, TelemetryServer::LandedState landed_state)
+{
+    auto msg = pack_extended_sys_state(vtol_state, landed_state);
     add_msg_cache(MAVLINK_MSG_ID_EXTENDED_SYS_STATE, msg);
 
     return _server_component_impl->send_message(msg) ? TelemetryServer::Result::Success :
                                                        TelemetryServer::Result::Unsupported;
 }
 
-void TelemetryServerImpl::add_msg_cache(uint64_t id, mavlink_message_t& msg)
+TelemetryServer::Result
+TelemetryServerImpl::publish_batch(const TelemetryServerExt::Batch& batch)
+{
+    std::vector<mavlink_message_t> messages;
+    messages.reserve(8 + batch.status_texts.size());
+
+    if (batch.position) {
+        messages.push_back(pack_position(
+            batch.position->position, batch.position->velocity_ned, batch.position->heading));
+    }
+    if (batch.home) {
+        messages.push_back(pack_home(batch.home.value()));
+    }
+    if (batch.raw_gps) {
+        messages.push_back(pack_raw_gps(batch.raw_gps->raw_gps, batch.raw_gps->gps_info));
+    }
+    if (batch.battery) {
+        messages.push_back(pack_battery(batch.battery.value()));
+    }
+    if (batch.distance_sensor) {
+        messages.push_back(pack_distance_sensor(batch.distance_sensor.value()));
+    }
+    if (batch.position_velocity_ned) {
+        messages.push_back(pack_position_velocity_ned(batch.position_velocity_ned.value()));
+    }
+    if (batch.sys_status) {
+        const auto& sys_status = batch.sys_status.value();
+        messages.push_back(pack_sys_status(
+            sys_status.battery,
+            sys_status.rc_receiver_status,
+            sys_status.gyro_status,
+            sys_status.accel_status,
+            sys_status.mag_status,
+            sys_status.gps_status));
+    }
+    if (batch.extended_sys_state) {
+        messages.push_back(pack_extended_sys_state(
+            batch.extended_sys_state->vtol_state, batch.extended_sys_state->landed_state));
+    }
+    for (const auto& status_text : batch.status_texts) {
+        messages.push_back(pack_status_text(status_text));
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_interval_mutex);
+        for (const auto& message : messages) {
+            if (const auto slot = msg_cache_slot(message.msgid)) {
+                _msg_cache[slot.value()] = message;
+            }
+        }
+    }
+
+    return _server_component_impl->send_messages(messages) ? TelemetryServer::Result::Success :
+                                                             TelemetryServer::Result::Unsupported;
+}
+
+std::optional<size_t> TelemetryServerImpl::msg_cache_slot(uint32_t msg_id)
+{
+    for (size_t i = 0; i < cached_msg_ids.size(); ++i) {
+        if (cached_msg_ids[i] == msg_id) {
+            return i;
+        }
+    }
+    return std::nullopt;
+}
+
+void TelemetryServerImpl::add_msg_cache(uint32_t id, const mavlink_message_t& msg)
 {
     std::unique_lock<std::mutex> lock(_interval_mutex);
-    _msg_cache.insert_or_assign(id, msg);
+    _msg_cache[msg_cache_slot(id).value()] = msg;
 }
 
 } // namespace mavsdk
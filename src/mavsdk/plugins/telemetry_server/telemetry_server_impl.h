@@ -1,21 +1,19 @@
 #pragma once
 
+#include "mavlink_message_template.h"
 #include "plugins/telemetry_server/telemetry_server.h"
+#include "plugins/telemetry_server/telemetry_server_ext.h"
+#include "publish_scheduler.h"
 #include "server_plugin_impl_base.h"
 
-#include <unordered_map>
+#include <array>
 #include <chrono>
+#include <optional>
 
 namespace mavsdk {
 
 class TelemetryServerImpl : public ServerPluginImplBase {
 public:
-    struct RequestMsgInterval {
-        uint32_t msg_id{0};
-        uint32_t interval{0};
-        void* cookie{nullptr};
-    };
-
     explicit TelemetryServerImpl(std::shared_ptr<ServerComponent> server_component);
     ~TelemetryServerImpl() override;
 
@@ -75,14 +73,65 @@ public:
     TelemetryServer::Result publish_extended_sys_state(
         TelemetryServer::VtolState vtol_state, TelemetryServer::LandedState landed_state);
 
+    TelemetryServer::Result publish_batch(const TelemetryServerExt::Batch& batch);
+
 private:
+    mavlink_message_t pack_position(
+        TelemetryServer::Position position,
+        TelemetryServer::VelocityNed velocity_ned,
+        TelemetryServer::Heading heading);
+    mavlink_message_t pack_home(TelemetryServer::Position home);
+    mavlink_message_t
+    pack_raw_gps(TelemetryServer::RawGps raw_gps, TelemetryServer::GpsInfo gps_info);
+    mavlink_message_t pack_battery(TelemetryServer::Battery battery);
+    mavlink_message_t pack_distance_sensor(TelemetryServer::DistanceSensor distance_sensor);
+    mavlink_message_t pack_status_text(TelemetryServer::StatusText status_text);
+    mavlink_message_t
+    pack_position_velocity_ned(TelemetryServer::PositionVelocityNed position_velocity_ned);
+    mavlink_message_t pack_sys_status(
+        TelemetryServer::Battery battery,
+        bool rc_receiver_status,
+        bool gyro_status,
+        bool accel_status,
+        bool mag_status,
+        bool gps_status);
+    mavlink_message_t pack_extended_sys_state(
+        TelemetryServer::VtolState vtol_state, TelemetryServer::LandedState landed_state);
+
     std::chrono::time_point<std::chrono::steady_clock> _start_time;
 
-    std::vector<RequestMsgInterval> _interval_requests;
-    std::mutex _interval_mutex;
-    std::unordered_map<uint64_t, mavlink_message_t> _msg_cache;
+    // For the streams which are usually published at a high rate.
+    const MavlinkMessageTemplate _position_template{MAVLINK_MSG_ID_GLOBAL_POSITION_INT};
+    const MavlinkMessageTemplate _position_velocity_ned_template{
+        MAVLINK_MSG_ID_LOCAL_POSITION_NED};
+
+    // The messages that can be published at a requested interval, the index
+    // of a message in here is its slot in _msg_cache.
+    static constexpr std::array<uint32_t, 8> cached_msg_ids{
+        MAVLINK_MSG_ID_SYS_STATUS,
+        MAVLINK_MSG_ID_GPS_RAW_INT,
+        MAVLINK_MSG_ID_LOCAL_POSITION_NED,
+        MAVLINK_MSG_ID_GLOBAL_POSITION_INT,
+        MAVLINK_MSG_ID_DISTANCE_SENSOR,
+        MAVLINK_MSG_ID_BATTERY_STATUS,
+        MAVLINK_MSG_ID_HOME_POSITION,
+        MAVLINK_MSG_ID_EXTENDED_SYS_STATE};
+
+    static std::optional<size_t> msg_cache_slot(uint32_t msg_id);
 
-    void add_msg_cache(uint64_t id, mavlink_message_t& msg);
+    std::mutex _interval_mutex;
+    // Needs _interval_mutex
+    std::array<std::optional<mavlink_message_t>, cached_msg_ids.size()> _msg_cache{};
+    // Needs _interval_mutex
+    PublishScheduler _publish_scheduler{};
+    void* _publish_cookie{nullptr};
+
+    // Only used from the publish tick.
+    std::vector<mavlink_message_t> _due_messages{};
+
+    void add_msg_cache(uint32_t id, const mavlink_message_t& msg);
+    void set_publish_interval(uint32_t msg_id, float param2);
+    void publish_due_messages();
 
     uint64_t get_boot_time_ms()
     {
@@ -16,6 +16,7 @@
 
 #include "server_plugin_base.h"
 
+#include "awaitable.h"
 #include "handle.h"
 
 namespace mavsdk {
@@ -152,7 +153,7 @@ public:
      *
      * @return Result of request.
      */
-    void set_tracking_point_status(TrackPoint tracked_point) const;
+    void set_tracking_point_status(const TrackPoint& tracked_point) const;
 
     /**
      * @brief Set/update the current rectangle tracking status.
@@ -161,7 +162,7 @@ public:
      *
      * @return Result of request.
      */
-    void set_tracking_rectangle_status(TrackRectangle tracked_rectangle) const;
+    void set_tracking_rectangle_status(const TrackRectangle& tracked_rectangle) const;
 
     /**
      * @brief Set the current tracking status to off.
@@ -275,6 +276,9 @@ public:
 private:
     /** @private Underlying implementation, set at instantiation */
     std::unique_ptr<TrackingServerImpl> _impl;
+
+    /** @private Hand-written additions in tracking_server_ext.h, if any */
+    friend class TrackingServerExt;
 };
 
 } // namespace mavsdk
\ No newline at end of file
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "plugins/tracking_server/tracking_server.h"
+
+namespace mavsdk {
+
+class TrackingServerImpl;
+
+/**
+ * @brief Additions to TrackingServer that are only available in C++.
+ *
+ * Unlike tracking_server.h, this header is not generated from the proto files,
+ * so the calls here are not available through mavsdk_server.
+ *
+ * It works on the TrackingServer plugin it is created with, which has to outlive it:
+ *
+ *     ```cpp
+ *     auto tracking_server = TrackingServer(system);
+ *     auto tracking_server_ext = TrackingServerExt(tracking_server);
+ *     ```
+ */
+class TrackingServerExt {
+public:
+    /**
+     * @brief Constructor. Uses the given TrackingServer plugin.
+     *
+     * @param tracking_server The plugin, which has to outlive this object.
+     */
+    explicit TrackingServerExt(TrackingServer& tracking_server);
+
+    /**
+     * @brief Publish the tracking status at a fixed rate.
+     *
+     * Once a rate is set, the set_tracking_*_status functions only store the
+     * status, and the latest one is sent at the given rate, no matter how often
+     * it is set, so the caller never waits for the link. Each status is sent at
+     * most once, and a point or rectangle that is older than a second by the
+     * time it would be sent is dropped rather than sent late. A rate of 0 sends
+     * every status directly again, which is the default.
+     *
+     * This function is blocking.
+     *
+     * @return Success, or Unknown if the rate is out of range.
+     */
+    TrackingServer::Result set_output_rate(double rate_hz) const;
+
+private:
+    TrackingServerImpl& _impl;
+};
+
+} // namespace mavsdk
@@ -20,12 +20,12 @@ TrackingServer::TrackingServer(std::shared_ptr<ServerComponent> server_component
 
 TrackingServer::~TrackingServer() {}
 
-void TrackingServer::set_tracking_point_status(TrackPoint tracked_point) const
+void TrackingServer::set_tracking_point_status(const TrackPoint& tracked_point) const
 {
     _impl->set_tracking_point_status(tracked_point);
 }
 
-void TrackingServer::set_tracking_rectangle_status(TrackRectangle tracked_rectangle) const
+void TrackingServer::set_tracking_rectangle_status(const TrackRectangle& tracked_rectangle) const
 {
     _impl->set_tracking_rectangle_status(tracked_rectangle);
 }
@@ -0,0 +1,15 @@
+#include "tracking_server_impl.h"
+#include "plugins/tracking_server/tracking_server_ext.h"
+
+namespace mavsdk {
+
+TrackingServerExt::TrackingServerExt(TrackingServer& tracking_server) :
+    _impl(*tracking_server._impl)
+{}
+
+TrackingServer::Result TrackingServerExt::set_output_rate(double rate_hz) const
+{
+    return _impl.set_output_rate(rate_hz);
+}
+
+} // namespace mavsdk
@@ -51,66 +51,122 @@ void TrackingServerImpl::deinit()
     _server_component_impl->unregister_mavlink_command_handler(
         MAV_CMD_CAMERA_TRACK_RECTANGLE, this);
     _server_component_impl->unregister_mavlink_command_handler(MAV_CMD_CAMERA_STOP_TRACKING, this);
+
+    std::lock_guard<std::mutex> lock(_status_streamer_mutex);
+    _status_scheduled = false;
+    _status_streamer.reset();
 }
 
 void TrackingServerImpl::set_tracking_point_status(TrackingServer::TrackPoint tracked_point)
 {
-    mavlink_message_t message;
-    mavlink_msg_camera_tracking_image_status_pack(
-        _server_component_impl->get_own_system_id(),
-        _server_component_impl->get_own_component_id(),
-        &message,
-        CAMERA_TRACKING_STATUS_FLAGS_ACTIVE,
-        CAMERA_TRACKING_MODE_POINT,
-        CAMERA_TRACKING_TARGET_DATA_IN_STATUS,
-        tracked_point.point_x,
-        tracked_point.point_y,
-        tracked_point.radius,
-        0.0f,
-        0.0f,
-        0.0f,
-        0.0f);
-    _server_component_impl->send_message(message);
+    Status status{};
+    status.tracking_status = CAMERA_TRACKING_STATUS_FLAGS_ACTIVE;
+    status.tracking_mode = CAMERA_TRACKING_MODE_POINT;
+    status.target_data = CAMERA_TRACKING_TARGET_DATA_IN_STATUS;
+    status.point_x = tracked_point.point_x;
+    status.point_y = tracked_point.point_y;
+    status.radius = tracked_point.radius;
+    set_status(status);
 }
 
 void TrackingServerImpl::set_tracking_rectangle_status(
     TrackingServer::TrackRectangle tracked_rectangle)
 {
-    mavlink_message_t message;
-    mavlink_msg_camera_tracking_image_status_pack(
-        _server_component_impl->get_own_system_id(),
-        _server_component_impl->get_own_component_id(),
-        &message,
-        CAMERA_TRACKING_STATUS_FLAGS_ACTIVE,
-        CAMERA_TRACKING_MODE_RECTANGLE,
-        CAMERA_TRACKING_TARGET_DATA_IN_STATUS,
-        0.0f,
-        0.0f,
-        0.0f,
-        tracked_rectangle.top_left_corner_x,
-        tracked_rectangle.top_left_corner_y,
-        tracked_rectangle.bottom_right_corner_x,
-        tracked_rectangle.bottom_right_corner_y);
-    _server_component_impl->send_message(message);
+    Status status{};
+    status.tracking_status = CAMERA_TRACKING_STATUS_FLAGS_ACTIVE;
+    status.tracking_mode = CAMERA_TRACKING_MODE_RECTANGLE;
+    status.target_data = CAMERA_TRACKING_TARGET_DATA_IN_STATUS;
+    status.rec_top_x = tracked_rectangle.top_left_corner_x;
+    status.rec_top_y = tracked_rectangle.top_left_corner_y;
+    status.rec_bottom_x = tracked_rectangle.bottom_right_corner_x;
+    status.rec_bottom_y = tracked_rectangle.bottom_right_corner_y;
+    set_status(status);
 }
 
 void TrackingServerImpl::set_tracking_off_status()
+{
+    Status status{};
+    status.tracking_status = CAMERA_TRACKING_STATUS_FLAGS_IDLE;
+    status.tracking_mode = CAMERA_TRACKING_MODE_NONE;
+    status.target_data = CAMERA_TRACKING_TARGET_DATA_NONE;
+    set_status(status);
+}
+
+TrackingServer::Result TrackingServerImpl::set_output_rate(double rate_hz)
+{
+    std::lock_guard<std::mutex> lock(_status_streamer_mutex);
+
+    if (rate_hz == 0.0) {
+        _status_scheduled = false;
+        _status_streamer.reset();
+        return TrackingServer::Result::Success;
+    }
+
+    if (_status_streamer == nullptr) {
+        _status_streamer = std::make_unique<SetpointStreamer>();
+    }
+    if (!_status_streamer->set_rate_hz(rate_hz)) {
+        return TrackingServer::Result::Unknown;
+    }
+
+    if (!_status_scheduled.exchange(true)) {
+        // What was set so far has been sent directly already.
+        _last_sent_sequence = _latest_status.load().sequence;
+        _status_streamer->start([this]() { send_latest_status(); });
+    }
+    return TrackingServer::Result::Success;
+}
+
+void TrackingServerImpl::set_status(Status status)
+{
+    status.set_time = _server_component_impl->get_time().steady_time();
+    status.sequence = ++_status_sequence;
+
+    // Statuses coming faster than the rate just replace the previous one.
+    _latest_status.store(status);
+
+    if (!_status_scheduled) {
+        send_status(status);
+    }
+}
+
+void TrackingServerImpl::send_latest_status()
+{
+    const auto status = _latest_status.load();
+
+    // Each status is sent once, the autopilot has no use for repeats.
+    if (status.sequence == _last_sent_sequence) {
+        return;
+    }
+    _last_sent_sequence = status.sequence;
+
+    // A target position this old is no use for following it anymore, while
+    // tracking being off is still news.
+    if (status.tracking_status == CAMERA_TRACKING_STATUS_FLAGS_ACTIVE &&
+        _server_component_impl->get_time().elapsed_since_s(status.set_time) > status_timeout_s) {
+        return;
+    }
+
+    send_status(status);
+}
+
+void TrackingServerImpl::send_status(const Status& status)
 {
     mavlink_message_t message;
     mavlink_msg_camera_tracking_image_status_pack(
         _server_component_impl->get_own_system_id(),
         _server_component_impl->get_own_component_id(),
         &message,
-        CAMERA_TRACKING_STATUS_FLAGS_IDLE,
-        CAMERA_TRACKING_MODE_NONE,
-        CAMERA_TRACKING_TARGET_DATA_NONE,
-        0.0f,
-        0.0f,
-        0.0f,
-        0.0f,
-        0.0f,
-        0.0f,
-        0.0f);
+        status.tracking_status,
+        status.tracking_mode,
+        status.target_data,
+        status.point_x,
+        status.point_y,
+        status.radius,
+        status.rec_top_x,
+        status.rec_top_y,
+        status.rec_bottom_x,
+        status.rec_bottom_y);
     _server_component_impl->send_message(message);
 }
 
@@ -3,7 +3,13 @@
 #include "plugins/tracking_server/tracking_server.h"
 #include "server_plugin_impl_base.h"
 #include "callback_list.h"
+#include "mavsdk_time.h"
+#include "seqlock.h"
+#include "setpoint_streamer.h"
 
+#include <atomic>
+#include <memory>
+#include <mutex>
 #include <optional>
 
 namespace mavsdk {
@@ -22,6 +28,8 @@ public:
 
     void set_tracking_off_status();
 
+    TrackingServer::Result set_output_rate(double rate_hz);
+
     TrackingServer::TrackingPointCommandHandle
     subscribe_tracking_point_command(const TrackingServer::TrackingPointCommandCallback& callback);
     void unsubscribe_tracking_point_command(TrackingServer::TrackingPointCommandHandle handle);
@@ -45,6 +53,27 @@ public:
     respond_tracking_off_command(TrackingServer::CommandAnswer command_answer);
 
 private:
+    // The content of a CAMERA_TRACKING_IMAGE_STATUS message.
+    struct Status {
+        uint8_t tracking_status{0};
+        uint8_t tracking_mode{0};
+        uint8_t target_data{0};
+        float point_x{0.0f};
+        float point_y{0.0f};
+        float radius{0.0f};
+        float rec_top_x{0.0f};
+        float rec_top_y{0.0f};
+        float rec_bottom_x{0.0f};
+        float rec_bottom_y{0.0f};
+        SteadyTimePoint set_time{};
+        // Counts up with every status set, 0 means none was set yet.
+        uint64_t sequence{0};
+    };
+
+    void set_status(Status status);
+    void send_status(const Status& status);
+    void send_latest_status();
+
     std::optional<mavlink_message_t>
     process_track_point_command(const MavlinkCommandReceiver::CommandLong& command);
     std::optional<mavlink_message_t>
@@ -66,6 +95,20 @@ private:
     uint8_t _tracking_rectangle_command_compid{0};
     uint8_t _tracking_off_command_sysid{0};
     uint8_t _tracking_off_command_compid{0};
+
+    // If an output rate is set, the latest status is stored and sent by the
+    // streamer instead.
+    static constexpr double status_timeout_s = 1.0;
+
+    Seqlock<Status> _latest_status{};
+    std::atomic<uint64_t> _status_sequence{0};
+    std::atomic<bool> _status_scheduled{false};
+    // Only used by the streamer.
+    uint64_t _last_sent_sequence{0};
+
+    std::mutex _status_streamer_mutex{};
+    // Needs _status_streamer_mutex, only allocated if a rate is set.
+    std::unique_ptr<SetpointStreamer> _status_streamer{};
 };
 
 } // namespace mavsdk
@@ -15,6 +15,7 @@
 
 #include "plugin_base.h"
 
+#include "awaitable.h"
 #include "handle.h"
 
 namespace mavsdk {
@@ -202,7 +203,24 @@ public:
      *
      * This function is non-blocking. See 'set_rate_transponder' for the blocking counterpart.
      */
-    void set_rate_transponder_async(double rate_hz, const ResultCallback callback);
+    void set_rate_transponder_async(double rate_hz, const ResultCallback& callback);
+
+#ifdef MAVSDK_HAS_COROUTINES
+    /**
+     * @brief Awaitable version of 'set_rate_transponder_async' for C++20 coroutines.
+     *
+     * The coroutine is resumed using the executor if one is given, otherwise on the callback
+     * thread.
+     */
+    Awaitable<ResultCallback> set_rate_transponder_awaitable(double rate_hz, Executor executor = {})
+    {
+        return Awaitable<ResultCallback>(
+            [=, this](const ResultCallback& callback) {
+                set_rate_transponder_async(rate_hz, callback);
+            },
+            std::move(executor));
+    }
+#endif
 
     /**
      * @brief Set rate to 'transponder' updates.
@@ -226,6 +244,9 @@ public:
 private:
     /** @private Underlying implementation, set at instantiation */
     std::unique_ptr<TransponderImpl> _impl;
+
+    /** @private Hand-written additions in transponder_ext.h, if any */
+    friend class TransponderExt;
 };
 
 } // namespace mavsdk
\ No newline at end of file
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "plugins/transponder/transponder.h"
+
+namespace mavsdk {
+
+class TransponderImpl;
+
+/**
+ * @brief Additions to Transponder that are only available in C++.
+ *
+ * Unlike transponder.h, this header is not generated from the proto files,
+ * so the calls here are not available through mavsdk_server.
+ *
+ * It works on the Transponder plugin it is created with, which has to outlive it:
+ *
+ *     ```cpp
+ *     auto transponder = Transponder(system);
+ *     auto transponder_ext = TransponderExt(transponder);
+ *     ```
+ */
+class TransponderExt {
+public:
+    /**
+     * @brief Constructor. Uses the given Transponder plugin.
+     *
+     * @param transponder The plugin, which has to outlive this object.
+     */
+    explicit TransponderExt(Transponder& transponder);
+
+    /**
+     * @brief Traffic that changed since the last notification.
+     */
+    struct TrafficChanges {
+        std::vector<Transponder::AdsbVehicle>
+            updated{}; /**< @brief Aircraft that are new or were updated, in their latest state */
+        std::vector<uint32_t> removed_icao_addresses{}; /**< @brief ICAO addresses of aircraft
+                                                           that were not heard of for a while */
+    };
+
+    /**
+     * @brief Get all aircraft currently known.
+     *
+     * Aircraft are kept by ICAO address in their latest state, until they
+     * have not been heard of for 20 seconds.
+     *
+     * @return The known aircraft, in no particular order.
+     */
+    std::vector<Transponder::AdsbVehicle> traffic() const;
+
+    /**
+     * @brief Get the aircraft within a radius around a position, and within
+     * an altitude band.
+     *
+     * Only the aircraft around the position are looked at, so this stays
+     * cheap with a lot of traffic.
+     *
+     * @return The aircraft found, in no particular order.
+     */
+    std::vector<Transponder::AdsbVehicle> traffic_within(
+        double latitude_deg,
+        double longitude_deg,
+        double radius_m,
+        float min_absolute_altitude_m,
+        float max_absolute_altitude_m) const;
+
+    /**
+     * @brief Callback type for subscribe_traffic_changes.
+     */
+    using TrafficChangesCallback = std::function<void(TrafficChanges)>;
+
+    /**
+     * @brief Handle type for subscribe_traffic_changes.
+     */
+    using TrafficChangesHandle = Handle<TrafficChanges>;
+
+    /**
+     * @brief Subscribe to changes of the known traffic.
+     *
+     * Changes are collected until the callback is called, so an aircraft
+     * updated several times in the meantime is only reported once, in its
+     * latest state.
+     */
+    TrafficChangesHandle subscribe_traffic_changes(const TrafficChangesCallback& callback);
+
+    /**
+     * @brief Unsubscribe from subscribe_traffic_changes
+     */
+    void unsubscribe_traffic_changes(TrafficChangesHandle handle);
+
+private:
+    TransponderImpl& _impl;
+};
+
+} // namespace mavsdk
@@ -0,0 +1,177 @@
+#include "traffic_table.h"
+#include "geometry.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace mavsdk {
+
+namespace {
+
+constexpr double pi = 3.14159265358979323846;
+constexpr double meters_per_deg = 6371000.0 * pi / 180.0;
+constexpr int32_t num_lat_cells = static_cast<int32_t>(180.0 / TrafficTable::cell_size_deg + 0.5);
+constexpr int32_t num_lon_cells = static_cast<int32_t>(360.0 / TrafficTable::cell_size_deg + 0.5);
+
+} // namespace
+
+void TrafficTable::update(const Transponder::AdsbVehicle& vehicle, TimePoint now)
+{
+    const auto cell = cell_key(lat_index(vehicle.latitude_deg), lon_index(vehicle.longitude_deg));
+
+    auto it = _entries.find(vehicle.icao_address);
+    if (it == _entries.end()) {
+        _entries.emplace(vehicle.icao_address, Entry{vehicle, now, cell});
+        _cells[cell].push_back(vehicle.icao_address);
+    } else {
+        if (it->second.cell != cell) {
+            remove_from_cell(it->second.cell, vehicle.icao_address);
+            _cells[cell].push_back(vehicle.icao_address);
+        }
+        it->second = Entry{vehicle, now, cell};
+    }
+
+    _changed.insert(vehicle.icao_address);
+}
+
+void TrafficTable::remove_expired(TimePoint now)
+{
+    const auto expiry = std::chrono::duration_cast<TimePoint::duration>(
+        std::chrono::duration<double>(_expiry_s));
+
+    for (auto it = _entries.begin(); it != _entries.end();) {
+        if (now - it->second.last_update > expiry) {
+            remove_from_cell(it->second.cell, it->first);
+            _changed.insert(it->first);
+            it = _entries.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+std::vector<Transponder::AdsbVehicle> TrafficTable::all() const
+{
+    std::vector<Transponder::AdsbVehicle> vehicles;
+    vehicles.reserve(_entries.size());
+    for (const auto& entry : _entries) {
+        vehicles.push_back(entry.second.vehicle);
+    }
+    return vehicles;
+}
+
+std::vector<Transponder::AdsbVehicle> TrafficTable::query(
+    double latitude_deg,
+    double longitude_deg,
+    double radius_m,
+    float min_altitude_m,
+    float max_altitude_m) const
+{
+    std::vector<Transponder::AdsbVehicle> vehicles;
+
+    const double lat_span_deg = radius_m / meters_per_deg;
+    const int32_t lat_begin = lat_index(latitude_deg - lat_span_deg);
+    const int32_t lat_end = lat_index(latitude_deg + lat_span_deg);
+
+    // The cells are narrowest on the side closest to the pole, so that is
+    // how many we need to look at.
+    const double max_abs_lat_deg = std::min(std::abs(latitude_deg) + lat_span_deg, 90.0);
+    const double cos_lat = std::cos(max_abs_lat_deg * pi / 180.0);
+    const double lon_span_deg = cos_lat > 0.0 ? radius_m / (meters_per_deg * cos_lat) : 180.0;
+
+    int32_t lon_begin = 0;
+    int32_t num_lon = num_lon_cells;
+    if (lon_span_deg < 180.0) {
+        lon_begin = lon_index(longitude_deg - lon_span_deg);
+        const int32_t lon_end = lon_index(longitude_deg + lon_span_deg);
+        // Across the antimeridian the end wraps around to before the begin.
+        num_lon = (lon_end - lon_begin + num_lon_cells) % num_lon_cells + 1;
+    }
+
+    const geometry::CoordinateTransformation transformation({latitude_deg, longitude_deg});
+
+    for (int32_t lat = lat_begin; lat <= lat_end; ++lat) {
+        for (int32_t i = 0; i < num_lon; ++i) {
+            const auto cell_it = _cells.find(cell_key(lat, (lon_begin + i) % num_lon_cells));
+            if (cell_it == _cells.end()) {
+                continue;
+            }
+
+            for (const auto icao_address : cell_it->second) {
+                const auto& vehicle = _entries.at(icao_address).vehicle;
+
+                if (vehicle.absolute_altitude_m < min_altitude_m ||
+                    vehicle.absolute_altitude_m > max_altitude_m) {
+                    continue;
+                }
+
+                // The projection keeps the distances from the reference.
+                const auto local = transformation.local_from_global(
+                    {vehicle.latitude_deg, vehicle.longitude_deg});
+                if (std::hypot(local.north_m, local.east_m) <= radius_m) {
+                    vehicles.push_back(vehicle);
+                }
+            }
+        }
+    }
+
+    return vehicles;
+}
+
+TransponderExt::TrafficChanges TrafficTable::take_changes()
+{
+    TransponderExt::TrafficChanges changes;
+
+    for (const auto icao_address : _changed) {
+        const auto it = _entries.find(icao_address);
+        if (it != _entries.end()) {
+            changes.updated.push_back(it->second.vehicle);
+        } else {
+            changes.removed_icao_addresses.push_back(icao_address);
+        }
+    }
+    _changed.clear();
+
+    return changes;
+}
+
+int32_t TrafficTable::lat_index(double latitude_deg)
+{
+    const auto index = static_cast<int32_t>(std::floor((latitude_deg + 90.0) / cell_size_deg));
+    return std::clamp(index, 0, num_lat_cells - 1);
+}
+
+int32_t TrafficTable::lon_index(double longitude_deg)
+{
+    const auto index = static_cast<int32_t>(std::floor((longitude_deg + 180.0) / cell_size_deg));
+    // Longitudes just outside of -180 to 180 (or exactly 180) belong to the
+    // other side.
+    return (index % num_lon_cells + num_lon_cells) % num_lon_cells;
+}
+
+uint64_t TrafficTable::cell_key(int32_t lat_index, int32_t lon_index)
+{
+    return (static_cast<uint64_t>(lat_index) << 32) | static_cast<uint32_t>(lon_index);
+}
+
+void TrafficTable::remove_from_cell(uint64_t cell, uint32_t icao_address)
+{
+    auto it = _cells.find(cell);
+    if (it == _cells.end()) {
+        return;
+    }
+
+    auto& icao_addresses = it->second;
+    const auto found = std::find(icao_addresses.begin(), icao_addresses.end(), icao_address);
+    if (found != icao_addresses.end()) {
+        // The order within a cell doesn't matter.
+        *found = icao_addresses.back();
+        icao_addresses.pop_back();
+    }
+
+    if (icao_addresses.empty()) {
+        _cells.erase(it);
+    }
+}
+
+} // namespace mavsdk
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "plugins/transponder/transponder.h"
+#include "plugins/transponder/transponder_ext.h"
+
+#include <chrono>
+#include <cstdint>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace mavsdk {
+
+// Keeps the latest state of all aircraft seen, by ICAO address, and drops
+// aircraft that have not been heard of for a while.
+//
+// Aircraft are also sorted into a grid of cells by position, so that
+// looking up the traffic around a position only has to look at the cells
+// nearby rather than at everyone.
+//
+// Which aircraft changed is collected until it is taken, so that however
+// often an aircraft was updated in the meantime, it is reported once.
+//
+// Not thread-safe, the caller needs to lock.
+class TrafficTable {
+public:
+    using TimePoint = std::chrono::steady_clock::time_point;
+
+    // Roughly 11 km at the equator, which is around the range of interest for
+    // collision avoidance, so a query usually only covers a few cells.
+    static constexpr double cell_size_deg = 0.1;
+    static constexpr double default_expiry_s = 20.0;
+
+    TrafficTable() = default;
+    ~TrafficTable() = default;
+
+    // Non-copyable
+    TrafficTable(const TrafficTable&) = delete;
+    const TrafficTable& operator=(const TrafficTable&) = delete;
+
+    void set_expiry_s(double expiry_s) { _expiry_s = expiry_s; }
+
+    void update(const Transponder::AdsbVehicle& vehicle, TimePoint now);
+    // Removes whatever was last updated more than the expiry ago.
+    void remove_expired(TimePoint now);
+
+    [[nodiscard]] std::vector<Transponder::AdsbVehicle> all() const;
+
+    // Aircraft within the horizontal radius of the position, and within the
+    // (absolute) altitude band.
+    [[nodiscard]] std::vector<Transponder::AdsbVehicle> query(
+        double latitude_deg,
+        double longitude_deg,
+        double radius_m,
+        float min_altitude_m,
+        float max_altitude_m) const;
+
+    // The changes since the last call.
+    [[nodiscard]] TransponderExt::TrafficChanges take_changes();
+    [[nodiscard]] bool has_changes() const { return !_changed.empty(); }
+
+    [[nodiscard]] size_t size() const { return _entries.size(); }
+
+private:
+    struct Entry {
+        Transponder::AdsbVehicle vehicle;
+        TimePoint last_update;
+        uint64_t cell;
+    };
+
+    static int32_t lat_index(double latitude_deg);
+    static int32_t lon_index(double longitude_deg);
+    static uint64_t cell_key(int32_t lat_index, int32_t lon_index);
+
+    void remove_from_cell(uint64_t cell, uint32_t icao_address);
+
+    std::unordered_map<uint32_t, Entry> _entries{};
+    // ICAO addresses per cell.
+    std::unordered_map<uint64_t, std::vector<uint32_t>> _cells{};
+    std::unordered_set<uint32_t> _changed{};
+    double _expiry_s{default_expiry_s};
+};
+
+} // namespace mavsdk
@@ -0,0 +1,168 @@
+#include "traffic_table.h"
+#include "geometry.h"
+
+#include <algorithm>
+#include <chrono>
+#include <gtest/gtest.h>
+
+using namespace mavsdk;
+using namespace std::chrono_literals;
+
+namespace {
+
+const geometry::CoordinateTransformation::GlobalCoordinate reference{47.3977, 8.5456};
+
+Transponder::AdsbVehicle
+vehicle_at(uint32_t icao_address, double north_m, double east_m, float altitude_m = 1000.0f)
+{
+    const geometry::CoordinateTransformation transformation{reference};
+    const auto global = transformation.global_from_local({north_m, east_m});
+
+    Transponder::AdsbVehicle vehicle{};
+    vehicle.icao_address = icao_address;
+    vehicle.latitude_deg = global.latitude_deg;
+    vehicle.longitude_deg = global.longitude_deg;
+    vehicle.absolute_altitude_m = altitude_m;
+    return vehicle;
+}
+
+std::vector<uint32_t> icao_addresses(const std::vector<Transponder::AdsbVehicle>& vehicles)
+{
+    std::vector<uint32_t> result;
+    for (const auto& vehicle : vehicles) {
+        result.push_back(vehicle.icao_address);
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+std::vector<Transponder::AdsbVehicle>
+query_around_reference(const TrafficTable& table, double radius_m, float min_m, float max_m)
+{
+    return table.query(reference.latitude_deg, reference.longitude_deg, radius_m, min_m, max_m);
+}
+
+} // namespace
+
+TEST(TrafficTable, KeepsLatestStatePerAircraft)
+{
+    TrafficTable table;
+    const TrafficTable::TimePoint now{};
+
+    table.update(vehicle_at(1, 0.0, 0.0), now);
+    table.update(vehicle_at(2, 100.0, 0.0), now);
+    table.update(vehicle_at(1, 50.0, 0.0, 1200.0f), now);
+
+    ASSERT_EQ(table.size(), 2);
+    EXPECT_TRUE(query_around_reference(table, 10.0, 1100.0f, 1300.0f).empty());
+    EXPECT_EQ(
+        icao_addresses(query_around_reference(table, 60.0, 1100.0f, 1300.0f)),
+        (std::vector<uint32_t>{1}));
+}
+
+TEST(TrafficTable, QueriesRadiusAndAltitudeBand)
+{
+    TrafficTable table;
+    const TrafficTable::TimePoint now{};
+
+    table.update(vehicle_at(1, 1000.0, 0.0, 500.0f), now);
+    table.update(vehicle_at(2, 0.0, -4000.0, 500.0f), now);
+    table.update(vehicle_at(3, 0.0, 20000.0, 500.0f), now);
+    table.update(vehicle_at(4, 2000.0, 2000.0, 3000.0f), now);
+
+    EXPECT_EQ(
+        icao_addresses(query_around_reference(table, 5000.0, 0.0f, 1000.0f)),
+        (std::vector<uint32_t>{1, 2}));
+    EXPECT_EQ(
+        icao_addresses(query_around_reference(table, 30000.0, 0.0f, 1000.0f)),
+        (std::vector<uint32_t>{1, 2, 3}));
+    EXPECT_EQ(
+        icao_addresses(query_around_reference(table, 30000.0, 0.0f, 5000.0f)),
+        (std::vector<uint32_t>{1, 2, 3, 4}));
+}
+
+TEST(TrafficTable, FindsAircraftMovedToAnotherCell)
+{
+    TrafficTable table;
+    const TrafficTable::TimePoint now{};
+
+    table.update(vehicle_at(1, 0.0, 0.0), now);
+    table.update(vehicle_at(1, 50000.0, 0.0), now);
+
+    EXPECT_TRUE(query_around_reference(table, 1000.0, 0.0f, 2000.0f).empty());
+
+    const geometry::CoordinateTransformation transformation{reference};
+    const auto moved = transformation.global_from_local({50000.0, 0.0});
+    EXPECT_EQ(
+        icao_addresses(
+            table.query(moved.latitude_deg, moved.longitude_deg, 1000.0, 0.0f, 2000.0f)),
+        (std::vector<uint32_t>{1}));
+}
+
+TEST(TrafficTable, QueriesAcrossAntimeridian)
+{
+    TrafficTable table;
+    const TrafficTable::TimePoint now{};
+
+    Transponder::AdsbVehicle vehicle{};
+    vehicle.icao_address = 1;
+    vehicle.latitude_deg = 0.0;
+    vehicle.longitude_deg = -179.99;
+    table.update(vehicle, now);
+
+    EXPECT_EQ(
+        icao_addresses(table.query(0.0, 179.99, 5000.0, -100.0f, 100.0f)),
+        (std::vector<uint32_t>{1}));
+}
+
+TEST(TrafficTable, RemovesExpiredAircraft)
+{
+    TrafficTable table;
+    table.set_expiry_s(10.0);
+    const TrafficTable::TimePoint start{};
+
+    table.update(vehicle_at(1, 0.0, 0.0), start);
+    table.update(vehicle_at(2, 0.0, 0.0), start + 5s);
+
+    table.remove_expired(start + 11s);
+    EXPECT_EQ(icao_addresses(table.all()), (std::vector<uint32_t>{2}));
+    EXPECT_EQ(
+        icao_addresses(query_around_reference(table, 100.0, 0.0f, 2000.0f)),
+        (std::vector<uint32_t>{2}));
+
+    table.remove_expired(start + 16s);
+    EXPECT_EQ(table.size(), 0);
+}
+
+TEST(TrafficTable, ConflatesChanges)
+{
+    TrafficTable table;
+    table.set_expiry_s(10.0);
+    const TrafficTable::TimePoint start{};
+
+    for (int i = 0; i < 5; ++i) {
+        table.update(vehicle_at(1, 10.0 * i, 0.0), start);
+    }
+    table.update(vehicle_at(2, 0.0, 0.0), start);
+
+    auto changes = table.take_changes();
+    ASSERT_EQ(icao_addresses(changes.updated), (std::vector<uint32_t>{1, 2}));
+    EXPECT_TRUE(changes.removed_icao_addresses.empty());
+    for (const auto& vehicle : changes.updated) {
+        if (vehicle.icao_address == 1) {
+            EXPECT_EQ(vehicle.latitude_deg, vehicle_at(1, 40.0, 0.0).latitude_deg);
+        }
+    }
+
+    EXPECT_FALSE(table.has_changes());
+    changes = table.take_changes();
+    EXPECT_TRUE(changes.updated.empty());
+    EXPECT_TRUE(changes.removed_icao_addresses.empty());
+
+    table.update(vehicle_at(2, 0.0, 0.0), start + 5s);
+    table.remove_expired(start + 11s);
+
+    changes = table.take_changes();
+    EXPECT_EQ(icao_addresses(changes.updated), (std::vector<uint32_t>{2}));
+    EXPECT_EQ(changes.removed_icao_addresses, (std::vector<uint32_t>{1}));
+}
@@ -39,7 +39,7 @@ Transponder::AdsbVehicle Transponder::transponder() const
     return _impl->transponder();
 }
 
-void Transponder::set_rate_transponder_async(double rate_hz, const ResultCallback callback)
+void Transponder::set_rate_transponder_async(double rate_hz, const ResultCallback& callback)
 {
     _impl->set_rate_transponder_async(rate_hz, callback);
 }
@@ -0,0 +1,39 @@
+#include "transponder_impl.h"
+#include "plugins/transponder/transponder_ext.h"
+
+namespace mavsdk {
+
+TransponderExt::TransponderExt(Transponder& transponder) : _impl(*transponder._impl) {}
+
+std::vector<Transponder::AdsbVehicle> TransponderExt::traffic() const
+{
+    return _impl.traffic();
+}
+
+std::vector<Transponder::AdsbVehicle> TransponderExt::traffic_within(
+    double latitude_deg,
+    double longitude_deg,
+    double radius_m,
+    float min_absolute_altitude_m,
+    float max_absolute_altitude_m) const
+{
+    return _impl.traffic_within(
+        latitude_deg,
+        longitude_deg,
+        radius_m,
+        min_absolute_altitude_m,
+        max_absolute_altitude_m);
+}
+
+TransponderExt::TrafficChangesHandle
+TransponderExt::subscribe_traffic_changes(const TrafficChangesCallback& callback)
+{
+    return _impl.subscribe_traffic_changes(callback);
+}
+
+void TransponderExt::unsubscribe_traffic_changes(TrafficChangesHandle handle)
+{
+    _impl.unsubscribe_traffic_changes(handle);
+}
+
+} // namespace mavsdk
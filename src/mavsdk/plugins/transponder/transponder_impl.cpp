@@ -4,6 +4,7 @@
 namespace mavsdk {
 
 template class CallbackList<Transponder::AdsbVehicle>;
+template class CallbackList<TransponderExt::TrafficChanges>;
 
 TransponderImpl::TransponderImpl(System& system) : PluginImplBase(system)
 {
@@ -26,11 +27,17 @@ void TransponderImpl::init()
         MAVLINK_MSG_ID_ADSB_VEHICLE,
         [this](const mavlink_message_t& message) { process_transponder(message); },
         this);
+
+    _system_impl->add_call_every(
+        [this]() { remove_expired_traffic(); },
+        TRAFFIC_EXPIRY_CHECK_INTERVAL_S,
+        &_traffic_expiry_cookie);
 }
 
 void TransponderImpl::deinit()
 {
     _system_impl->unregister_all_mavlink_message_handlers(this);
+    _system_impl->remove_call_every(_traffic_expiry_cookie);
 }
 
 void TransponderImpl::enable() {}
@@ -39,8 +46,8 @@ void TransponderImpl::disable() {}
 
 Transponder::Result TransponderImpl::set_rate_transponder(double rate_hz)
 {
-    return transponder_result_from_command_result(
-        _system_impl->set_msg_rate(MAVLINK_MSG_ID_ADSB_VEHICLE, rate_hz));
+    return transponder_result_from_command_result(_system_impl->set_msg_rate(
+        MAVLINK_MSG_ID_ADSB_VEHICLE, rate_hz, MAV_COMP_ID_AUTOPILOT1, this));
 }
 
 void TransponderImpl::set_rate_transponder_async(
@@ -51,7 +58,9 @@ void TransponderImpl::set_rate_transponder_async(
         rate_hz,
         [callback](MavlinkCommandSender::Result command_result, float) {
             command_result_callback(command_result, callback);
-        });
+        },
+        MAV_COMP_ID_AUTOPILOT1,
+        this);
 }
 
 Transponder::AdsbVehicle TransponderImpl::transponder() const
@@ -73,6 +82,41 @@ void TransponderImpl::unsubscribe_transponder(Transponder::TransponderHandle han
     _transponder_subscriptions.unsubscribe(handle);
 }
 
+std::vector<Transponder::AdsbVehicle> TransponderImpl::traffic() const
+{
+    std::lock_guard<std::mutex> lock(_traffic_mutex);
+    return _traffic_table.all();
+}
+
+std::vector<Transponder::AdsbVehicle> TransponderImpl::traffic_within(
+    double latitude_deg,
+    double longitude_deg,
+    double radius_m,
+    float min_absolute_altitude_m,
+    float max_absolute_altitude_m) const
+{
+    std::lock_guard<std::mutex> lock(_traffic_mutex);
+    return _traffic_table.query(
+        latitude_deg,
+        longitude_deg,
+        radius_m,
+        min_absolute_altitude_m,
+        max_absolute_altitude_m);
+}
+
+TransponderExt::TrafficChangesHandle
+TransponderImpl::subscribe_traffic_changes(const TransponderExt::TrafficChangesCallback& callback)
+{
+    std::lock_guard<std::mutex> lock(_subscription_mutex);
+    return _traffic_changes_subscriptions.subscribe(callback);
+}
+
+void TransponderImpl::unsubscribe_traffic_changes(TransponderExt::TrafficChangesHandle handle)
+{
+    std::lock_guard<std::mutex> lock(_subscription_mutex);
+    _traffic_changes_subscriptions.unsubscribe(handle);
+}
+
 void TransponderImpl::set_transponder(Transponder::AdsbVehicle transponder)
 {
     std::lock_guard<std::mutex> lock(_transponder_mutex);
@@ -103,10 +147,58 @@ void TransponderImpl::process_transponder(const mavlink_message_t& message)
 
     set_transponder(adsbVehicle);
 
+    {
+        std::lock_guard<std::mutex> lock(_traffic_mutex);
+        _traffic_table.update(adsbVehicle, _time.steady_time());
+    }
+    notify_traffic_changes();
+
     _transponder_subscriptions.queue(
         transponder(), [this](const auto& func) { _system_impl->call_user_callback(func); });
 }
 
+void TransponderImpl::remove_expired_traffic()
+{
+    {
+        std::lock_guard<std::mutex> lock(_traffic_mutex);
+        _traffic_table.remove_expired(_time.steady_time());
+        if (!_traffic_table.has_changes()) {
+            return;
+        }
+    }
+    notify_traffic_changes();
+}
+
+void TransponderImpl::notify_traffic_changes()
+{
+    if (_traffic_changes_subscriptions.empty()) {
+        return;
+    }
+
+    // With hundreds of aircraft each updating several times a second, one
+    // notification per update would just pile up.
+    if (!_traffic_changes_pending.exchange(true)) {
+        _system_impl->call_user_callback([this]() { call_traffic_changes_subscriptions(); });
+    }
+}
+
+void TransponderImpl::call_traffic_changes_subscriptions()
+{
+    // Cleared first, so changes from now on get another notification.
+    _traffic_changes_pending = false;
+
+    TransponderExt::TrafficChanges changes;
+    {
+        std::lock_guard<std::mutex> lock(_traffic_mutex);
+        changes = _traffic_table.take_changes();
+    }
+    if (changes.updated.empty() && changes.removed_icao_addresses.empty()) {
+        return;
+    }
+
+    _traffic_changes_subscriptions(changes);
+}
+
 Transponder::Result
 TransponderImpl::transponder_result_from_command_result(MavlinkCommandSender::Result command_result)
 {
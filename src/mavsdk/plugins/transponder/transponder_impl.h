@@ -1,8 +1,14 @@
 #pragma once
 
 #include "plugins/transponder/transponder.h"
+#include "plugins/transponder/transponder_ext.h"
 #include "plugin_impl_base.h"
 #include "callback_list.h"
+#include "mavsdk_time.h"
+#include "traffic_table.h"
+
+#include <atomic>
+#include <mutex>
 
 namespace mavsdk {
 
@@ -28,11 +34,27 @@ public:
     subscribe_transponder(const Transponder::TransponderCallback& callback);
     void unsubscribe_transponder(Transponder::TransponderHandle handle);
 
+    std::vector<Transponder::AdsbVehicle> traffic() const;
+    std::vector<Transponder::AdsbVehicle> traffic_within(
+        double latitude_deg,
+        double longitude_deg,
+        double radius_m,
+        float min_absolute_altitude_m,
+        float max_absolute_altitude_m) const;
+
+    TransponderExt::TrafficChangesHandle
+    subscribe_traffic_changes(const TransponderExt::TrafficChangesCallback& callback);
+    void unsubscribe_traffic_changes(TransponderExt::TrafficChangesHandle handle);
+
 private:
     void set_transponder(Transponder::AdsbVehicle transponder);
 
     void process_transponder(const mavlink_message_t& message);
 
+    void remove_expired_traffic();
+    void notify_traffic_changes();
+    void call_traffic_changes_subscriptions();
+
     static Transponder::Result
     transponder_result_from_command_result(MavlinkCommandSender::Result command_result);
 
@@ -44,6 +66,16 @@ private:
 
     std::mutex _subscription_mutex{};
     CallbackList<Transponder::AdsbVehicle> _transponder_subscriptions{};
+    CallbackList<TransponderExt::TrafficChanges> _traffic_changes_subscriptions{};
+
+    Time _time{};
+    mutable std::mutex _traffic_mutex{};
+    TrafficTable _traffic_table{}; // Needs _traffic_mutex
+    void* _traffic_expiry_cookie{nullptr};
+    // Set while a notification is queued, the changes until it runs go along.
+    std::atomic<bool> _traffic_changes_pending{false};
+
+    static constexpr float TRAFFIC_EXPIRY_CHECK_INTERVAL_S = 1.0f;
 };
 
 } // namespace mavsdk
@@ -15,6 +15,7 @@
 
 #include "plugin_base.h"
 
+#include "awaitable.h"
 #include "handle.h"
 
 namespace mavsdk {
@@ -145,7 +146,25 @@ public:
      *
      * This function is non-blocking. See 'play_tune' for the blocking counterpart.
      */
-    void play_tune_async(TuneDescription tune_description, const ResultCallback callback);
+    void play_tune_async(const TuneDescription& tune_description, const ResultCallback& callback);
+
+#ifdef MAVSDK_HAS_COROUTINES
+    /**
+     * @brief Awaitable version of 'play_tune_async' for C++20 coroutines.
+     *
+     * The coroutine is resumed using the executor if one is given, otherwise on the callback
+     * thread.
+     */
+    Awaitable<ResultCallback> play_tune_awaitable(
+        const TuneDescription& tune_description, Executor executor = {})
+    {
+        return Awaitable<ResultCallback>(
+            [=, this](const ResultCallback& callback) {
+                play_tune_async(tune_description, callback);
+            },
+            std::move(executor));
+    }
+#endif
 
     /**
      * @brief Send a tune to be played by the system.
@@ -154,7 +173,7 @@ public:
      *
      * @return Result of request.
      */
-    Result play_tune(TuneDescription tune_description) const;
+    Result play_tune(const TuneDescription& tune_description) const;
 
     /**
      * @brief Copy constructor.
@@ -169,6 +188,9 @@ public:
 private:
     /** @private Underlying implementation, set at instantiation */
     std::unique_ptr<TuneImpl> _impl;
+
+    /** @private Hand-written additions in tune_ext.h, if any */
+    friend class TuneExt;
 };
 
 } // namespace mavsdk
\ No newline at end of file
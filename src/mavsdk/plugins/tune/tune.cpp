@@ -18,12 +18,12 @@ Tune::Tune(std::shared_ptr<System> system) : PluginBase(), _impl{std::make_uniqu
 
 Tune::~Tune() {}
 
-void Tune::play_tune_async(TuneDescription tune_description, const ResultCallback callback)
+void Tune::play_tune_async(const TuneDescription& tune_description, const ResultCallback& callback)
 {
     _impl->play_tune_async(tune_description, callback);
 }
 
-Tune::Result Tune::play_tune(TuneDescription tune_description) const
+Tune::Result Tune::play_tune(const TuneDescription& tune_description) const
 {
     return _impl->play_tune(tune_description);
 }
@@ -15,6 +15,7 @@
 
 #include "plugin_base.h"
 
+#include "awaitable.h"
 #include "handle.h"
 
 namespace mavsdk {
@@ -214,7 +215,24 @@ public:
      *
      * This function is non-blocking. See 'relax' for the blocking counterpart.
      */
-    void relax_async(uint32_t instance, const ResultCallback callback);
+    void relax_async(uint32_t instance, const ResultCallback& callback);
+
+#ifdef MAVSDK_HAS_COROUTINES
+    /**
+     * @brief Awaitable version of 'relax_async' for C++20 coroutines.
+     *
+     * The coroutine is resumed using the executor if one is given, otherwise on the callback
+     * thread.
+     */
+    Awaitable<ResultCallback> relax_awaitable(uint32_t instance, Executor executor = {})
+    {
+        return Awaitable<ResultCallback>(
+            [=, this](const ResultCallback& callback) {
+                relax_async(instance, callback);
+            },
+            std::move(executor));
+    }
+#endif
 
     /**
      * @brief Allow motor to freewheel.
@@ -231,7 +249,25 @@ public:
      * This function is non-blocking. See 'relative_length_control' for the blocking counterpart.
      */
     void relative_length_control_async(
-        uint32_t instance, float length_m, float rate_m_s, const ResultCallback callback);
+        uint32_t instance, float length_m, float rate_m_s, const ResultCallback& callback);
+
+#ifdef MAVSDK_HAS_COROUTINES
+    /**
+     * @brief Awaitable version of 'relative_length_control_async' for C++20 coroutines.
+     *
+     * The coroutine is resumed using the executor if one is given, otherwise on the callback
+     * thread.
+     */
+    Awaitable<ResultCallback> relative_length_control_awaitable(
+        uint32_t instance, float length_m, float rate_m_s, Executor executor = {})
+    {
+        return Awaitable<ResultCallback>(
+            [=, this](const ResultCallback& callback) {
+                relative_length_control_async(instance, length_m, rate_m_s, callback);
+            },
+            std::move(executor));
+    }
+#endif
 
     /**
      * @brief Wind or unwind specified length of line, optionally using specified rate.
@@ -248,7 +284,25 @@ public:
      *
      * This function is non-blocking. See 'rate_control' for the blocking counterpart.
      */
-    void rate_control_async(uint32_t instance, float rate_m_s, const ResultCallback callback);
+    void rate_control_async(uint32_t instance, float rate_m_s, const ResultCallback& callback);
+
+#ifdef MAVSDK_HAS_COROUTINES
+    /**
+     * @brief Awaitable version of 'rate_control_async' for C++20 coroutines.
+     *
+     * The coroutine is resumed using the executor if one is given, otherwise on the callback
+     * thread.
+     */
+    Awaitable<ResultCallback> rate_control_awaitable(
+        uint32_t instance, float rate_m_s, Executor executor = {})
+    {
+        return Awaitable<ResultCallback>(
+            [=, this](const ResultCallback& callback) {
+                rate_control_async(instance, rate_m_s, callback);
+            },
+            std::move(executor));
+    }
+#endif
 
     /**
      * @brief Wind or unwind line at specified rate.
@@ -264,7 +318,24 @@ public:
      *
      * This function is non-blocking. See 'lock' for the blocking counterpart.
      */
-    void lock_async(uint32_t instance, const ResultCallback callback);
+    void lock_async(uint32_t instance, const ResultCallback& callback);
+
+#ifdef MAVSDK_HAS_COROUTINES
+    /**
+     * @brief Awaitable version of 'lock_async' for C++20 coroutines.
+     *
+     * The coroutine is resumed using the executor if one is given, otherwise on the callback
+     * thread.
+     */
+    Awaitable<ResultCallback> lock_awaitable(uint32_t instance, Executor executor = {})
+    {
+        return Awaitable<ResultCallback>(
+            [=, this](const ResultCallback& callback) {
+                lock_async(instance, callback);
+            },
+            std::move(executor));
+    }
+#endif
 
     /**
      * @brief Perform the locking sequence to relieve motor while in the fully retracted position.
@@ -280,7 +351,24 @@ public:
      *
      * This function is non-blocking. See 'deliver' for the blocking counterpart.
      */
-    void deliver_async(uint32_t instance, const ResultCallback callback);
+    void deliver_async(uint32_t instance, const ResultCallback& callback);
+
+#ifdef MAVSDK_HAS_COROUTINES
+    /**
+     * @brief Awaitable version of 'deliver_async' for C++20 coroutines.
+     *
+     * The coroutine is resumed using the executor if one is given, otherwise on the callback
+     * thread.
+     */
+    Awaitable<ResultCallback> deliver_awaitable(uint32_t instance, Executor executor = {})
+    {
+        return Awaitable<ResultCallback>(
+            [=, this](const ResultCallback& callback) {
+                deliver_async(instance, callback);
+            },
+            std::move(executor));
+    }
+#endif
 
     /**
      * @brief Sequence of drop, slow down, touch down, reel up, lock.
@@ -296,7 +384,24 @@ public:
      *
      * This function is non-blocking. See 'hold' for the blocking counterpart.
      */
-    void hold_async(uint32_t instance, const ResultCallback callback);
+    void hold_async(uint32_t instance, const ResultCallback& callback);
+
+#ifdef MAVSDK_HAS_COROUTINES
+    /**
+     * @brief Awaitable version of 'hold_async' for C++20 coroutines.
+     *
+     * The coroutine is resumed using the executor if one is given, otherwise on the callback
+     * thread.
+     */
+    Awaitable<ResultCallback> hold_awaitable(uint32_t instance, Executor executor = {})
+    {
+        return Awaitable<ResultCallback>(
+            [=, this](const ResultCallback& callback) {
+                hold_async(instance, callback);
+            },
+            std::move(executor));
+    }
+#endif
 
     /**
      * @brief Engage motor and hold current position.
@@ -312,7 +417,24 @@ public:
      *
      * This function is non-blocking. See 'retract' for the blocking counterpart.
      */
-    void retract_async(uint32_t instance, const ResultCallback callback);
+    void retract_async(uint32_t instance, const ResultCallback& callback);
+
+#ifdef MAVSDK_HAS_COROUTINES
+    /**
+     * @brief Awaitable version of 'retract_async' for C++20 coroutines.
+     *
+     * The coroutine is resumed using the executor if one is given, otherwise on the callback
+     * thread.
+     */
+    Awaitable<ResultCallback> retract_awaitable(uint32_t instance, Executor executor = {})
+    {
+        return Awaitable<ResultCallback>(
+            [=, this](const ResultCallback& callback) {
+                retract_async(instance, callback);
+            },
+            std::move(executor));
+    }
+#endif
 
     /**
      * @brief Return the reel to the fully retracted position.
@@ -331,7 +453,24 @@ public:
      *
      * This function is non-blocking. See 'load_line' for the blocking counterpart.
      */
-    void load_line_async(uint32_t instance, const ResultCallback callback);
+    void load_line_async(uint32_t instance, const ResultCallback& callback);
+
+#ifdef MAVSDK_HAS_COROUTINES
+    /**
+     * @brief Awaitable version of 'load_line_async' for C++20 coroutines.
+     *
+     * The coroutine is resumed using the executor if one is given, otherwise on the callback
+     * thread.
+     */
+    Awaitable<ResultCallback> load_line_awaitable(uint32_t instance, Executor executor = {})
+    {
+        return Awaitable<ResultCallback>(
+            [=, this](const ResultCallback& callback) {
+                load_line_async(instance, callback);
+            },
+            std::move(executor));
+    }
+#endif
 
     /**
      * @brief Load the reel with line.
@@ -350,7 +489,24 @@ public:
      *
      * This function is non-blocking. See 'abandon_line' for the blocking counterpart.
      */
-    void abandon_line_async(uint32_t instance, const ResultCallback callback);
+    void abandon_line_async(uint32_t instance, const ResultCallback& callback);
+
+#ifdef MAVSDK_HAS_COROUTINES
+    /**
+     * @brief Awaitable version of 'abandon_line_async' for C++20 coroutines.
+     *
+     * The coroutine is resumed using the executor if one is given, otherwise on the callback
+     * thread.
+     */
+    Awaitable<ResultCallback> abandon_line_awaitable(uint32_t instance, Executor executor = {})
+    {
+        return Awaitable<ResultCallback>(
+            [=, this](const ResultCallback& callback) {
+                abandon_line_async(instance, callback);
+            },
+            std::move(executor));
+    }
+#endif
 
     /**
      * @brief Spool out the entire length of the line.
@@ -366,7 +522,24 @@ public:
      *
      * This function is non-blocking. See 'load_payload' for the blocking counterpart.
      */
-    void load_payload_async(uint32_t instance, const ResultCallback callback);
+    void load_payload_async(uint32_t instance, const ResultCallback& callback);
+
+#ifdef MAVSDK_HAS_COROUTINES
+    /**
+     * @brief Awaitable version of 'load_payload_async' for C++20 coroutines.
+     *
+     * The coroutine is resumed using the executor if one is given, otherwise on the callback
+     * thread.
+     */
+    Awaitable<ResultCallback> load_payload_awaitable(uint32_t instance, Executor executor = {})
+    {
+        return Awaitable<ResultCallback>(
+            [=, this](const ResultCallback& callback) {
+                load_payload_async(instance, callback);
+            },
+            std::move(executor));
+    }
+#endif
 
     /**
      * @brief Spools out just enough to present the hook to the user to load the payload.
@@ -390,6 +563,9 @@ public:
 private:
     /** @private Underlying implementation, set at instantiation */
     std::unique_ptr<WinchImpl> _impl;
+
+    /** @private Hand-written additions in winch_ext.h, if any */
+    friend class WinchExt;
 };
 
 } // namespace mavsdk
\ No newline at end of file
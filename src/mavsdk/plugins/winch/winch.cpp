@@ -36,7 +36,7 @@ Winch::Status Winch::status() const
     return _impl->status();
 }
 
-void Winch::relax_async(uint32_t instance, const ResultCallback callback)
+void Winch::relax_async(uint32_t instance, const ResultCallback& callback)
 {
     _impl->relax_async(instance, callback);
 }
@@ -47,7 +47,7 @@ Winch::Result Winch::relax(uint32_t instance) const
 }
 
 void Winch::relative_length_control_async(
-    uint32_t instance, float length_m, float rate_m_s, const ResultCallback callback)
+    uint32_t instance, float length_m, float rate_m_s, const ResultCallback& callback)
 {
     _impl->relative_length_control_async(instance, length_m, rate_m_s, callback);
 }
@@ -58,7 +58,7 @@ Winch::relative_length_control(uint32_t instance, float length_m, float rate_m_s
     return _impl->relative_length_control(instance, length_m, rate_m_s);
 }
 
-void Winch::rate_control_async(uint32_t instance, float rate_m_s, const ResultCallback callback)
+void Winch::rate_control_async(uint32_t instance, float rate_m_s, const ResultCallback& callback)
 {
     _impl->rate_control_async(instance, rate_m_s, callback);
 }
@@ -68,7 +68,7 @@ Winch::Result Winch::rate_control(uint32_t instance, float rate_m_s) const
     return _impl->rate_control(instance, rate_m_s);
 }
 
-void Winch::lock_async(uint32_t instance, const ResultCallback callback)
+void Winch::lock_async(uint32_t instance, const ResultCallback& callback)
 {
     _impl->lock_async(instance, callback);
 }
@@ -78,7 +78,7 @@ Winch::Result Winch::lock(uint32_t instance) const
     return _impl->lock(instance);
 }
 
-void Winch::deliver_async(uint32_t instance, const ResultCallback callback)
+void Winch::deliver_async(uint32_t instance, const ResultCallback& callback)
 {
     _impl->deliver_async(instance, callback);
 }
@@ -88,7 +88,7 @@ Winch::Result Winch::deliver(uint32_t instance) const
     return _impl->deliver(instance);
 }
 
-void Winch::hold_async(uint32_t instance, const ResultCallback callback)
+void Winch::hold_async(uint32_t instance, const ResultCallback& callback)
 {
     _impl->hold_async(instance, callback);
 }
@@ -98,7 +98,7 @@ Winch::Result Winch::hold(uint32_t instance) const
     return _impl->hold(instance);
 }
 
-void Winch::retract_async(uint32_t instance, const ResultCallback callback)
+void Winch::retract_async(uint32_t instance, const ResultCallback& callback)
 {
     _impl->retract_async(instance, callback);
 }
@@ -108,7 +108,7 @@ Winch::Result Winch::retract(uint32_t instance) const
     return _impl->retract(instance);
 }
 
-void Winch::load_line_async(uint32_t instance, const ResultCallback callback)
+void Winch::load_line_async(uint32_t instance, const ResultCallback& callback)
 {
     _impl->load_line_async(instance, callback);
 }
@@ -118,7 +118,7 @@ Winch::Result Winch::load_line(uint32_t instance) const
     return _impl->load_line(instance);
 }
 
-void Winch::abandon_line_async(uint32_t instance, const ResultCallback callback)
+void Winch::abandon_line_async(uint32_t instance, const ResultCallback& callback)
 {
     _impl->abandon_line_async(instance, callback);
 }
@@ -128,7 +128,7 @@ Winch::Result Winch::abandon_line(uint32_t instance) const
     return _impl->abandon_line(instance);
 }
 
-void Winch::load_payload_async(uint32_t instance, const ResultCallback callback)
+void Winch::load_payload_async(uint32_t instance, const ResultCallback& callback)
 {
     _impl->load_payload_async(instance, callback);
 }
@@ -152,7 +152,7 @@ void WinchImpl::relative_length_control_async(
 
     command.target_component_id = MAV_COMPONENT::MAV_COMP_ID_WINCH;
 
-    _system_impl->send_command_async(
+    _system_impl->send_streamed_command_async(
         command, [this, callback](MavlinkCommandSender::Result result, float) {
             command_result_callback(result, callback);
         });
@@ -181,7 +181,7 @@ void WinchImpl::rate_control_async(
 
     command.target_component_id = MAV_COMPONENT::MAV_COMP_ID_WINCH;
 
-    _system_impl->send_command_async(
+    _system_impl->send_streamed_command_async(
         command, [this, callback](MavlinkCommandSender::Result result, float) {
             command_result_callback(result, callback);
         });
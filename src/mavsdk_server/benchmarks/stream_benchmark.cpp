@@ -0,0 +1,242 @@
+#include "mavsdk.h"
+#include "mavsdk_server.h"
+#include "plugins/telemetry_server/telemetry_server.h"
+#include "telemetry/telemetry.grpc.pb.h"
+
+#include <benchmark/benchmark.h>
+#include <grpcpp/grpcpp.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <ctime>
+#include <future>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace mavsdk;
+
+namespace {
+
+constexpr int fake_system_port = 17100;
+constexpr auto run_duration = std::chrono::seconds(5);
+constexpr auto discovery_timeout = std::chrono::seconds(10);
+
+uint64_t now_us()
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+                                     std::chrono::steady_clock::now().time_since_epoch())
+                                     .count());
+}
+
+// When each sample was sent, by sequence number. The sequence number travels in
+// the sample itself, so that the clients can tell the latency of what they get.
+class SendTimes {
+public:
+    void set(uint32_t sequence, uint64_t time_us)
+    {
+        _times[sequence % _times.size()].store(time_us, std::memory_order_relaxed);
+    }
+
+    uint64_t get(uint32_t sequence) const
+    {
+        return _times[sequence % _times.size()].load(std::memory_order_relaxed);
+    }
+
+private:
+    // Long enough that a slot is not reused before a slow client gets to it.
+    std::array<std::atomic<uint64_t>, 1 << 16> _times{};
+};
+
+// An autopilot on the other end of a UDP connection, publishing local
+// position at a fixed rate.
+class FakeSystem {
+public:
+    FakeSystem()
+    {
+        _mavsdk.set_configuration(
+            Mavsdk::Configuration{Mavsdk::Configuration::UsageType::Autopilot});
+        _mavsdk.add_any_connection("udp://127.0.0.1:" + std::to_string(fake_system_port));
+        _telemetry_server = std::make_unique<TelemetryServer>(
+            _mavsdk.server_component_by_type(Mavsdk::ServerComponentType::Autopilot));
+    }
+
+    ~FakeSystem() { stop(); }
+
+    void start(double rate_hz, SendTimes& send_times)
+    {
+        _should_exit = false;
+        _thread = std::thread([this, rate_hz, &send_times]() {
+            const auto interval = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                std::chrono::duration<double>(1.0 / rate_hz));
+            auto next = std::chrono::steady_clock::now();
+            uint32_t sequence = 0;
+
+            while (!_should_exit) {
+                // Floats hold the sequence number exactly up to 2^24.
+                TelemetryServer::PositionVelocityNed position_velocity_ned{};
+                position_velocity_ned.position.north_m = static_cast<float>(sequence % (1 << 24));
+
+                send_times.set(sequence % (1 << 24), now_us());
+                _telemetry_server->publish_position_velocity_ned(position_velocity_ned);
+                ++sequence;
+
+                next += interval;
+                std::this_thread::sleep_until(next);
+            }
+        });
+    }
+
+    void stop()
+    {
+        _should_exit = true;
+        if (_thread.joinable()) {
+            _thread.join();
+        }
+    }
+
+private:
+    Mavsdk _mavsdk{};
+    std::unique_ptr<TelemetryServer> _telemetry_server{};
+    std::atomic<bool> _should_exit{false};
+    std::thread _thread{};
+};
+
+// A gRPC client following the local position stream.
+class StreamClient {
+public:
+    StreamClient(const std::shared_ptr<grpc::Channel>& channel, const SendTimes& send_times) :
+        _stub(rpc::telemetry::TelemetryService::NewStub(channel)),
+        _send_times(send_times)
+    {}
+
+    ~StreamClient() { stop(); }
+
+    void start()
+    {
+        _thread = std::thread([this]() {
+            rpc::telemetry::SubscribePositionVelocityNedRequest request;
+            auto reader = _stub->SubscribePositionVelocityNed(&_context, request);
+
+            rpc::telemetry::PositionVelocityNedResponse response;
+            while (reader->Read(&response)) {
+                const auto received_us = now_us();
+                const auto sequence =
+                    static_cast<uint32_t>(response.position_velocity_ned().position().north_m());
+                const auto sent_us = _send_times.get(sequence);
+                if (sent_us != 0 && received_us >= sent_us) {
+                    _latencies_us.push_back(received_us - sent_us);
+                }
+            }
+            reader->Finish();
+        });
+    }
+
+    void stop()
+    {
+        _context.TryCancel();
+        if (_thread.joinable()) {
+            _thread.join();
+        }
+    }
+
+    // Only once stopped.
+    const std::vector<uint64_t>& latencies_us() const { return _latencies_us; }
+
+private:
+    std::unique_ptr<rpc::telemetry::TelemetryService::Stub> _stub;
+    const SendTimes& _send_times;
+    grpc::ClientContext _context{};
+    std::vector<uint64_t> _latencies_us{};
+    std::thread _thread{};
+};
+
+double percentile_us(const std::vector<uint64_t>& sorted, double percentile)
+{
+    if (sorted.empty()) {
+        return 0.0;
+    }
+    const auto index = static_cast<size_t>(percentile / 100.0 * (sorted.size() - 1));
+    return static_cast<double>(sorted[index]);
+}
+
+} // namespace
+
+// Arguments: number of streaming clients, rate of the fake system in Hz.
+static void BM_MavsdkServerPositionStream(benchmark::State& state)
+{
+    const auto num_clients = static_cast<size_t>(state.range(0));
+    const auto rate_hz = static_cast<double>(state.range(1));
+
+    // Too big for the stack.
+    auto send_times = std::make_unique<SendTimes>();
+    FakeSystem fake_system;
+
+    MavsdkServer mavsdk_server;
+    auto connected = std::async(std::launch::async, [&mavsdk_server]() {
+        return mavsdk_server.connect("udp://:" + std::to_string(fake_system_port));
+    });
+    if (connected.wait_for(discovery_timeout) != std::future_status::ready || !connected.get()) {
+        mavsdk_server.stop();
+        state.SkipWithError("Fake system not discovered");
+        return;
+    }
+
+    const auto grpc_port = mavsdk_server.startGrpcServer(0);
+    if (grpc_port == 0) {
+        state.SkipWithError("Could not start gRPC server");
+        return;
+    }
+
+    auto channel = grpc::CreateChannel(
+        "127.0.0.1:" + std::to_string(grpc_port), grpc::InsecureChannelCredentials());
+
+    std::vector<uint64_t> latencies_us;
+    double cpu_s = 0.0;
+
+    for (auto _ : state) {
+        std::vector<std::unique_ptr<StreamClient>> clients;
+        for (size_t i = 0; i < num_clients; ++i) {
+            clients.push_back(std::make_unique<StreamClient>(channel, *send_times));
+            clients.back()->start();
+        }
+
+        const auto cpu_start = std::clock();
+        fake_system.start(rate_hz, *send_times);
+        std::this_thread::sleep_for(run_duration);
+        fake_system.stop();
+        cpu_s = static_cast<double>(std::clock() - cpu_start) / CLOCKS_PER_SEC;
+
+        for (auto& client : clients) {
+            client->stop();
+            latencies_us.insert(
+                latencies_us.end(), client->latencies_us().begin(), client->latencies_us().end());
+        }
+    }
+
+    mavsdk_server.stop();
+
+    std::sort(latencies_us.begin(), latencies_us.end());
+    const auto run_s = std::chrono::duration<double>(run_duration).count();
+
+    state.counters["messages_per_second"] = static_cast<double>(latencies_us.size()) / run_s;
+    state.counters["latency_p50_us"] = percentile_us(latencies_us, 50.0);
+    state.counters["latency_p90_us"] = percentile_us(latencies_us, 90.0);
+    state.counters["latency_p99_us"] = percentile_us(latencies_us, 99.0);
+    // Of one core, for the whole process including the fake system.
+    state.counters["cpu_percent_per_stream"] =
+        100.0 * cpu_s / run_s / static_cast<double>(num_clients);
+}
+BENCHMARK(BM_MavsdkServerPositionStream)
+    ->Args({1, 50})
+    ->Args({1, 200})
+    ->Args({10, 50})
+    ->Args({10, 200})
+    ->Args({50, 50})
+    ->Args({50, 200})
+    ->Iterations(1)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
@@ -0,0 +1,159 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+#include "mavsdk.h"
+
+namespace mavsdk {
+namespace mavsdk_server {
+
+// What CoreService streams about the performance of MAVSDK.
+struct PerformanceStats {
+    struct System {
+        uint8_t system_id{0};
+        bool is_connected{false};
+        // Rates over the interval since the previous sample.
+        double received_messages_per_s{0.0};
+        double received_bytes_per_s{0.0};
+        double sent_messages_per_s{0.0};
+        double sent_bytes_per_s{0.0};
+        RttStats rtt{};
+    };
+
+    struct CallbackQueue {
+        size_t depth{0};
+        size_t max_depth{0};
+        uint64_t dropped{0};
+        // Means over the interval since the previous sample, maxima since the start.
+        double mean_wait_s{0.0};
+        double max_wait_s{0.0};
+        double mean_run_s{0.0};
+        double max_run_s{0.0};
+    };
+
+    std::vector<LinkStats> links{};
+    std::vector<System> systems{};
+    CallbackQueue callback_queue{};
+};
+
+// Samples the statistics of links, systems and the callback queue.
+//
+// This is meant for a conflated stream: the RPC samples at the rate asked for
+// by the client, and a slow client only gets the latest sample. Every sample
+// is complete, so none has to be delivered for the next one to make sense.
+template<typename Mavsdk = Mavsdk> class PerformanceSampler {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit PerformanceSampler(Mavsdk& mavsdk) : _mavsdk(mavsdk)
+    {
+        // Link stats are pushed once per interval, we only keep the latest.
+        _link_stats_handle = _mavsdk.subscribe_link_stats([this](std::vector<LinkStats> links) {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _links = std::move(links);
+        });
+    }
+
+    ~PerformanceSampler() { _mavsdk.unsubscribe_link_stats(_link_stats_handle); }
+
+    // Non-copyable
+    PerformanceSampler(const PerformanceSampler&) = delete;
+    const PerformanceSampler& operator=(const PerformanceSampler&) = delete;
+
+    PerformanceStats sample(Clock::time_point now = Clock::now())
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        PerformanceStats stats;
+        stats.links = _links;
+
+        const double elapsed_s =
+            _last_sample ? std::chrono::duration<double>(now - *_last_sample).count() : 0.0;
+        _last_sample = now;
+
+        for (const auto& system : _mavsdk.systems()) {
+            PerformanceStats::System entry;
+            entry.system_id = system->get_system_id();
+            entry.is_connected = system->is_connected();
+            entry.rtt = system->rtt_stats();
+
+            Totals totals;
+            for (const auto& message : system->message_stats()) {
+                totals.received_count += message.received_count;
+                totals.received_bytes += message.received_bytes;
+                totals.sent_count += message.sent_count;
+                totals.sent_bytes += message.sent_bytes;
+            }
+
+            auto previous = _system_totals.find(entry.system_id);
+            if (previous != _system_totals.end() && elapsed_s > 0.0) {
+                entry.received_messages_per_s =
+                    rate(totals.received_count, previous->second.received_count, elapsed_s);
+                entry.received_bytes_per_s =
+                    rate(totals.received_bytes, previous->second.received_bytes, elapsed_s);
+                entry.sent_messages_per_s =
+                    rate(totals.sent_count, previous->second.sent_count, elapsed_s);
+                entry.sent_bytes_per_s =
+                    rate(totals.sent_bytes, previous->second.sent_bytes, elapsed_s);
+            }
+            _system_totals[entry.system_id] = totals;
+
+            stats.systems.push_back(entry);
+        }
+
+        const auto queue = _mavsdk.callback_queue_stats();
+        stats.callback_queue.depth = queue.depth;
+        stats.callback_queue.max_depth = queue.max_depth;
+        stats.callback_queue.dropped = queue.dropped;
+        stats.callback_queue.mean_wait_s = mean_s(queue.wait_time, _last_wait_time);
+        stats.callback_queue.max_wait_s = static_cast<double>(queue.wait_time.max_ns) * 1e-9;
+        stats.callback_queue.mean_run_s = mean_s(queue.run_time, _last_run_time);
+        stats.callback_queue.max_run_s = static_cast<double>(queue.run_time.max_ns) * 1e-9;
+        _last_wait_time = queue.wait_time;
+        _last_run_time = queue.run_time;
+
+        return stats;
+    }
+
+private:
+    struct Totals {
+        uint64_t received_count{0};
+        uint64_t received_bytes{0};
+        uint64_t sent_count{0};
+        uint64_t sent_bytes{0};
+    };
+
+    static double rate(uint64_t current, uint64_t previous, double elapsed_s)
+    {
+        // Counters only go back if a system was replaced, which we don't count.
+        return current >= previous ? static_cast<double>(current - previous) / elapsed_s : 0.0;
+    }
+
+    static double mean_s(const DurationHistogram& current, const DurationHistogram& previous)
+    {
+        if (current.total_count <= previous.total_count) {
+            return 0.0;
+        }
+        return static_cast<double>(current.total_ns - previous.total_ns) /
+               static_cast<double>(current.total_count - previous.total_count) * 1e-9;
+    }
+
+    Mavsdk& _mavsdk;
+    typename Mavsdk::LinkStatsHandle _link_stats_handle{};
+
+    std::mutex _mutex{};
+    // Needs _mutex
+    std::vector<LinkStats> _links{};
+    std::optional<Clock::time_point> _last_sample{};
+    std::map<uint8_t, Totals> _system_totals{};
+    DurationHistogram _last_wait_time{};
+    DurationHistogram _last_run_time{};
+};
+
+} // namespace mavsdk_server
+} // namespace mavsdk
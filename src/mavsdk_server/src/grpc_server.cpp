@@ -2,6 +2,7 @@
 // Edits need to be made to templates/grpc_server.cpp.j2
 #include "grpc_server.h"
 
+#include <algorithm>
 #include <grpc++/server_builder.h>
 #include <grpc++/security/server_credentials.h>
 
@@ -10,11 +11,166 @@
 namespace mavsdk {
 namespace mavsdk_server {
 
+namespace {
+
+void add_stream_metrics(Metrics& metrics, const std::string& service, const StreamStats& stats)
+{
+    const Metrics::Labels labels{{"service", service}};
+    metrics.add_gauge(
+        "mavsdk_server_active_streams", "Streams currently open.", labels, stats.active.load());
+    metrics.add_counter(
+        "mavsdk_server_stream_responses_written_total",
+        "Stream responses written to clients.",
+        labels,
+        stats.written.load());
+    metrics.add_counter(
+        "mavsdk_server_stream_responses_dropped_total",
+        "Stream responses replaced by newer ones or dropped for slow clients.",
+        labels,
+        stats.dropped.load());
+    metrics.add_summary(
+        "mavsdk_server_stream_write_seconds",
+        "Time gRPC took to write stream responses.",
+        labels,
+        static_cast<double>(stats.write_time_ns.load()) / 1e9,
+        stats.written.load());
+}
+
+} // namespace
+
 void GrpcServer::set_port(const int port)
 {
     _port = port;
 }
 
+void GrpcServer::set_unix_socket_path(const std::string& path)
+{
+    _unix_socket_path = path;
+}
+
+const std::vector<std::string>& GrpcServer::available_services()
+{
+    static const std::vector<std::string> services{
+#ifdef ACTION_ENABLED
+        "action",
+#endif
+#ifdef ACTION_SERVER_ENABLED
+        "action_server",
+#endif
+#ifdef CALIBRATION_ENABLED
+        "calibration",
+#endif
+#ifdef CAMERA_ENABLED
+        "camera",
+#endif
+#ifdef CAMERA_SERVER_ENABLED
+        "camera_server",
+#endif
+#ifdef COMPONENT_INFORMATION_ENABLED
+        "component_information",
+#endif
+#ifdef COMPONENT_INFORMATION_SERVER_ENABLED
+        "component_information_server",
+#endif
+#ifdef FAILURE_ENABLED
+        "failure",
+#endif
+#ifdef FOLLOW_ME_ENABLED
+        "follow_me",
+#endif
+#ifdef FTP_ENABLED
+        "ftp",
+#endif
+#ifdef GEOFENCE_ENABLED
+        "geofence",
+#endif
+#ifdef GIMBAL_ENABLED
+        "gimbal",
+#endif
+#ifdef GRIPPER_ENABLED
+        "gripper",
+#endif
+#ifdef INFO_ENABLED
+        "info",
+#endif
+#ifdef LOG_FILES_ENABLED
+        "log_files",
+#endif
+#ifdef MANUAL_CONTROL_ENABLED
+        "manual_control",
+#endif
+#ifdef MISSION_ENABLED
+        "mission",
+#endif
+#ifdef MISSION_RAW_ENABLED
+        "mission_raw",
+#endif
+#ifdef MISSION_RAW_SERVER_ENABLED
+        "mission_raw_server",
+#endif
+#ifdef MOCAP_ENABLED
+        "mocap",
+#endif
+#ifdef OFFBOARD_ENABLED
+        "offboard",
+#endif
+#ifdef PARAM_ENABLED
+        "param",
+#endif
+#ifdef PARAM_SERVER_ENABLED
+        "param_server",
+#endif
+#ifdef RTK_ENABLED
+        "rtk",
+#endif
+#ifdef SERVER_UTILITY_ENABLED
+        "server_utility",
+#endif
+#ifdef SHELL_ENABLED
+        "shell",
+#endif
+#ifdef TELEMETRY_ENABLED
+        "telemetry",
+#endif
+#ifdef TELEMETRY_SERVER_ENABLED
+        "telemetry_server",
+#endif
+#ifdef TRACKING_SERVER_ENABLED
+        "tracking_server",
+#endif
+#ifdef TRANSPONDER_ENABLED
+        "transponder",
+#endif
+#ifdef TUNE_ENABLED
+        "tune",
+#endif
+#ifdef WINCH_ENABLED
+        "winch",
+#endif
+    };
+    return services;
+}
+
+void GrpcServer::set_enabled_services(const std::vector<std::string>& services)
+{
+    const auto& available = available_services();
+
+    _all_services_enabled = false;
+    _enabled_services.clear();
+    for (const auto& service : services) {
+        if (std::find(available.begin(), available.end(), service) == available.end()) {
+            LogWarn() << "Service '" << service << "' is not available, ignoring it";
+            continue;
+        }
+        _enabled_services.insert(service);
+    }
+}
+
+bool GrpcServer::is_enabled(const std::string& service) const
+{
+    return _all_services_enabled || _enabled_services.count(service) > 0;
+}
+
 int GrpcServer::run()
 {
     grpc::ServerBuilder builder;
@@ -23,131 +179,277 @@ int GrpcServer::run()
     builder.RegisterService(&_core);
 
 #ifdef ACTION_ENABLED
-    builder.RegisterService(&_action_service);
+    if (is_enabled("action")) {
+        _action_lazy_plugin = std::make_unique<LazyPlugin<Action>>(_mavsdk);
+        _action_service = std::make_unique<ActionServiceImpl<>>(*_action_lazy_plugin);
+        builder.RegisterService(_action_service.get());
+    }
 #endif
 
 #ifdef ACTION_SERVER_ENABLED
-    builder.RegisterService(&_action_server_service);
+    if (is_enabled("action_server")) {
+        _action_server_lazy_plugin = std::make_unique<LazyServerPlugin<ActionServer>>(_mavsdk);
+        _action_server_service =
+            std::make_unique<ActionServerServiceImpl<>>(*_action_server_lazy_plugin);
+        builder.RegisterService(_action_server_service.get());
+    }
 #endif
 
 #ifdef CALIBRATION_ENABLED
-    builder.RegisterService(&_calibration_service);
+    if (is_enabled("calibration")) {
+        _calibration_lazy_plugin = std::make_unique<LazyPlugin<Calibration>>(_mavsdk);
+        _calibration_service =
+            std::make_unique<CalibrationServiceImpl<>>(*_calibration_lazy_plugin);
+        builder.RegisterService(_calibration_service.get());
+    }
 #endif
 
 #ifdef CAMERA_ENABLED
-    builder.RegisterService(&_camera_service);
+    if (is_enabled("camera")) {
+        _camera_lazy_plugin = std::make_unique<LazyPlugin<Camera>>(_mavsdk);
+        _camera_service = std::make_unique<CameraServiceImpl<>>(*_camera_lazy_plugin);
+        builder.RegisterService(_camera_service.get());
+    }
 #endif
 
 #ifdef CAMERA_SERVER_ENABLED
-    builder.RegisterService(&_camera_server_service);
+    if (is_enabled("camera_server")) {
+        _camera_server_lazy_plugin = std::make_unique<LazyServerPlugin<CameraServer>>(_mavsdk);
+        _camera_server_service =
+            std::make_unique<CameraServerServiceImpl<>>(*_camera_server_lazy_plugin);
+        builder.RegisterService(_camera_server_service.get());
+    }
 #endif
 
 #ifdef COMPONENT_INFORMATION_ENABLED
-    builder.RegisterService(&_component_information_service);
+    if (is_enabled("component_information")) {
+        _component_information_lazy_plugin =
+            std::make_unique<LazyPlugin<ComponentInformation>>(_mavsdk);
+        _component_information_service =
+            std::make_unique<ComponentInformationServiceImpl<>>(
+                *_component_information_lazy_plugin);
+        builder.RegisterService(_component_information_service.get());
+    }
 #endif
 
 #ifdef COMPONENT_INFORMATION_SERVER_ENABLED
-    builder.RegisterService(&_component_information_server_service);
+    if (is_enabled("component_information_server")) {
+        _component_information_server_lazy_plugin =
+            std::make_unique<LazyServerPlugin<ComponentInformationServer>>(_mavsdk);
+        _component_information_server_service =
+            std::make_unique<ComponentInformationServerServiceImpl<>>(
+                *_component_information_server_lazy_plugin);
+        builder.RegisterService(_component_information_server_service.get());
+    }
 #endif
 
 #ifdef FAILURE_ENABLED
-    builder.RegisterService(&_failure_service);
+    if (is_enabled("failure")) {
+        _failure_lazy_plugin = std::make_unique<LazyPlugin<Failure>>(_mavsdk);
+        _failure_service = std::make_unique<FailureServiceImpl<>>(*_failure_lazy_plugin);
+        builder.RegisterService(_failure_service.get());
+    }
 #endif
 
 #ifdef FOLLOW_ME_ENABLED
-    builder.RegisterService(&_follow_me_service);
+    if (is_enabled("follow_me")) {
+        _follow_me_lazy_plugin = std::make_unique<LazyPlugin<FollowMe>>(_mavsdk);
+        _follow_me_service = std::make_unique<FollowMeServiceImpl<>>(*_follow_me_lazy_plugin);
+        builder.RegisterService(_follow_me_service.get());
+    }
 #endif
 
 #ifdef FTP_ENABLED
-    builder.RegisterService(&_ftp_service);
+    if (is_enabled("ftp")) {
+        _ftp_lazy_plugin = std::make_unique<LazyPlugin<Ftp>>(_mavsdk);
+        _ftp_service = std::make_unique<FtpServiceImpl<>>(*_ftp_lazy_plugin);
+        builder.RegisterService(_ftp_service.get());
+    }
 #endif
 
 #ifdef GEOFENCE_ENABLED
-    builder.RegisterService(&_geofence_service);
+    if (is_enabled("geofence")) {
+        _geofence_lazy_plugin = std::make_unique<LazyPlugin<Geofence>>(_mavsdk);
+        _geofence_service = std::make_unique<GeofenceServiceImpl<>>(*_geofence_lazy_plugin);
+        builder.RegisterService(_geofence_service.get());
+    }
 #endif
 
 #ifdef GIMBAL_ENABLED
-    builder.RegisterService(&_gimbal_service);
+    if (is_enabled("gimbal")) {
+        _gimbal_lazy_plugin = std::make_unique<LazyPlugin<Gimbal>>(_mavsdk);
+        _gimbal_service = std::make_unique<GimbalServiceImpl<>>(*_gimbal_lazy_plugin);
+        builder.RegisterService(_gimbal_service.get());
+    }
 #endif
 
 #ifdef GRIPPER_ENABLED
-    builder.RegisterService(&_gripper_service);
+    if (is_enabled("gripper")) {
+        _gripper_lazy_plugin = std::make_unique<LazyPlugin<Gripper>>(_mavsdk);
+        _gripper_service = std::make_unique<GripperServiceImpl<>>(*_gripper_lazy_plugin);
+        builder.RegisterService(_gripper_service.get());
+    }
 #endif
 
 #ifdef INFO_ENABLED
-    builder.RegisterService(&_info_service);
+    if (is_enabled("info")) {
+        _info_lazy_plugin = std::make_unique<LazyPlugin<Info>>(_mavsdk);
+        _info_service = std::make_unique<InfoServiceImpl<>>(*_info_lazy_plugin);
+        builder.RegisterService(_info_service.get());
+    }
 #endif
 
 #ifdef LOG_FILES_ENABLED
-    builder.RegisterService(&_log_files_service);
+    if (is_enabled("log_files")) {
+        _log_files_lazy_plugin = std::make_unique<LazyPlugin<LogFiles>>(_mavsdk);
+        _log_files_service = std::make_unique<LogFilesServiceImpl<>>(*_log_files_lazy_plugin);
+        builder.RegisterService(_log_files_service.get());
+    }
 #endif
 
 #ifdef MANUAL_CONTROL_ENABLED
-    builder.RegisterService(&_manual_control_service);
+    if (is_enabled("manual_control")) {
+        _manual_control_lazy_plugin = std::make_unique<LazyPlugin<ManualControl>>(_mavsdk);
+        _manual_control_service =
+            std::make_unique<ManualControlServiceImpl<>>(*_manual_control_lazy_plugin);
+        builder.RegisterService(_manual_control_service.get());
+    }
 #endif
 
 #ifdef MISSION_ENABLED
-    builder.RegisterService(&_mission_service);
+    if (is_enabled("mission")) {
+        _mission_lazy_plugin = std::make_unique<LazyPlugin<Mission>>(_mavsdk);
+        _mission_service = std::make_unique<MissionServiceImpl<>>(*_mission_lazy_plugin);
+        builder.RegisterService(_mission_service.get());
+    }
 #endif
 
 #ifdef MISSION_RAW_ENABLED
-    builder.RegisterService(&_mission_raw_service);
+    if (is_enabled("mission_raw")) {
+        _mission_raw_lazy_plugin = std::make_unique<LazyPlugin<MissionRaw>>(_mavsdk);
+        _mission_raw_service = std::make_unique<MissionRawServiceImpl<>>(*_mission_raw_lazy_plugin);
+        builder.RegisterService(_mission_raw_service.get());
+    }
 #endif
 
 #ifdef MISSION_RAW_SERVER_ENABLED
-    builder.RegisterService(&_mission_raw_server_service);
+    if (is_enabled("mission_raw_server")) {
+        _mission_raw_server_lazy_plugin =
+            std::make_unique<LazyServerPlugin<MissionRawServer>>(_mavsdk);
+        _mission_raw_server_service =
+            std::make_unique<MissionRawServerServiceImpl<>>(*_mission_raw_server_lazy_plugin);
+        builder.RegisterService(_mission_raw_server_service.get());
+    }
 #endif
 
 #ifdef MOCAP_ENABLED
-    builder.RegisterService(&_mocap_service);
+    if (is_enabled("mocap")) {
+        _mocap_lazy_plugin = std::make_unique<LazyPlugin<Mocap>>(_mavsdk);
+        _mocap_service = std::make_unique<MocapServiceImpl<>>(*_mocap_lazy_plugin);
+        builder.RegisterService(_mocap_service.get());
+    }
 #endif
 
 #ifdef OFFBOARD_ENABLED
-    builder.RegisterService(&_offboard_service);
+    if (is_enabled("offboard")) {
+        _offboard_lazy_plugin = std::make_unique<LazyPlugin<Offboard>>(_mavsdk);
+        _offboard_service = std::make_unique<OffboardServiceImpl<>>(*_offboard_lazy_plugin);
+        builder.RegisterService(_offboard_service.get());
+    }
 #endif
 
 #ifdef PARAM_ENABLED
-    builder.RegisterService(&_param_service);
+    if (is_enabled("param")) {
+        _param_lazy_plugin = std::make_unique<LazyPlugin<Param>>(_mavsdk);
+        _param_service = std::make_unique<ParamServiceImpl<>>(*_param_lazy_plugin);
+        builder.RegisterService(_param_service.get());
+    }
 #endif
 
 #ifdef PARAM_SERVER_ENABLED
-    builder.RegisterService(&_param_server_service);
+    if (is_enabled("param_server")) {
+        _param_server_lazy_plugin = std::make_unique<LazyServerPlugin<ParamServer>>(_mavsdk);
+        _param_server_service =
+            std::make_unique<ParamServerServiceImpl<>>(*_param_server_lazy_plugin);
+        builder.RegisterService(_param_server_service.get());
+    }
 #endif
 
 #ifdef RTK_ENABLED
-    builder.RegisterService(&_rtk_service);
+    if (is_enabled("rtk")) {
+        _rtk_lazy_plugin = std::make_unique<LazyPlugin<Rtk>>(_mavsdk);
+        _rtk_service = std::make_unique<RtkServiceImpl<>>(*_rtk_lazy_plugin);
+        builder.RegisterService(_rtk_service.get());
+    }
 #endif
 
 #ifdef SERVER_UTILITY_ENABLED
-    builder.RegisterService(&_server_utility_service);
+    if (is_enabled("server_utility")) {
+        _server_utility_lazy_plugin = std::make_unique<LazyPlugin<ServerUtility>>(_mavsdk);
+        _server_utility_service =
+            std::make_unique<ServerUtilityServiceImpl<>>(*_server_utility_lazy_plugin);
+        builder.RegisterService(_server_utility_service.get());
+    }
 #endif
 
 #ifdef SHELL_ENABLED
-    builder.RegisterService(&_shell_service);
+    if (is_enabled("shell")) {
+        _shell_lazy_plugin = std::make_unique<LazyPlugin<Shell>>(_mavsdk);
+        _shell_service = std::make_unique<ShellServiceImpl<>>(*_shell_lazy_plugin);
+        builder.RegisterService(_shell_service.get());
+    }
 #endif
 
 #ifdef TELEMETRY_ENABLED
-    builder.RegisterService(&_telemetry_service);
+    if (is_enabled("telemetry")) {
+        _telemetry_lazy_plugin = std::make_unique<LazyPlugin<Telemetry>>(_mavsdk);
+        _telemetry_service = std::make_unique<TelemetryServiceImpl<>>(*_telemetry_lazy_plugin);
+        builder.RegisterService(_telemetry_service.get());
+    }
 #endif
 
 #ifdef TELEMETRY_SERVER_ENABLED
-    builder.RegisterService(&_telemetry_server_service);
+    if (is_enabled("telemetry_server")) {
+        _telemetry_server_lazy_plugin =
+            std::make_unique<LazyServerPlugin<TelemetryServer>>(_mavsdk);
+        _telemetry_server_service =
+            std::make_unique<TelemetryServerServiceImpl<>>(*_telemetry_server_lazy_plugin);
+        builder.RegisterService(_telemetry_server_service.get());
+    }
 #endif
 
 #ifdef TRACKING_SERVER_ENABLED
-    builder.RegisterService(&_tracking_server_service);
+    if (is_enabled("tracking_server")) {
+        _tracking_server_lazy_plugin = std::make_unique<LazyServerPlugin<TrackingServer>>(_mavsdk);
+        _tracking_server_service =
+            std::make_unique<TrackingServerServiceImpl<>>(*_tracking_server_lazy_plugin);
+        builder.RegisterService(_tracking_server_service.get());
+    }
 #endif
 
 #ifdef TRANSPONDER_ENABLED
-    builder.RegisterService(&_transponder_service);
+    if (is_enabled("transponder")) {
+        _transponder_lazy_plugin = std::make_unique<LazyPlugin<Transponder>>(_mavsdk);
+        _transponder_service =
+            std::make_unique<TransponderServiceImpl<>>(*_transponder_lazy_plugin);
+        builder.RegisterService(_transponder_service.get());
+    }
 #endif
 
 #ifdef TUNE_ENABLED
-    builder.RegisterService(&_tune_service);
+    if (is_enabled("tune")) {
+        _tune_lazy_plugin = std::make_unique<LazyPlugin<Tune>>(_mavsdk);
+        _tune_service = std::make_unique<TuneServiceImpl<>>(*_tune_lazy_plugin);
+        builder.RegisterService(_tune_service.get());
+    }
 #endif
 
 #ifdef WINCH_ENABLED
-    builder.RegisterService(&_winch_service);
+    if (is_enabled("winch")) {
+        _winch_lazy_plugin = std::make_unique<LazyPlugin<Winch>>(_mavsdk);
+        _winch_service = std::make_unique<WinchServiceImpl<>>(*_winch_lazy_plugin);
+        builder.RegisterService(_winch_service.get());
+    }
 #endif
 
 #ifdef ENABLE_PROTO_REFLECTION
@@ -160,6 +462,9 @@ int GrpcServer::run()
     if (_bound_port != 0) {
         LogInfo() << "Server started";
         LogInfo() << "Server set to listen on 0.0.0.0:" << _bound_port;
+        if (!_unix_socket_path.empty()) {
+            LogInfo() << "Server set to listen on unix:" << _unix_socket_path;
+        }
     } else {
         LogErr() << "Failed to bind server to port " << _port;
     }
@@ -167,6 +472,16 @@ int GrpcServer::run()
     return _bound_port;
 }
 
+std::shared_ptr<grpc::Channel> GrpcServer::in_process_channel()
+{
+    if (_server == nullptr) {
+        LogWarn() << "Calling 'in_process_channel()' on a non-existing server. "
+                  << "Did you call 'run()' before?";
+        return nullptr;
+    }
+    return _server->InProcessChannel(grpc::ChannelArguments());
+}
+
 void GrpcServer::wait()
 {
     if (_server != nullptr) {
@@ -182,131 +497,195 @@ void GrpcServer::stop()
         _core.stop();
 
 #ifdef ACTION_ENABLED
-        _action_service.stop();
+        if (_action_service != nullptr) {
+            _action_service->stop();
+        }
 #endif
 
 #ifdef ACTION_SERVER_ENABLED
-        _action_server_service.stop();
+        if (_action_server_service != nullptr) {
+            _action_server_service->stop();
+        }
 #endif
 
 #ifdef CALIBRATION_ENABLED
-        _calibration_service.stop();
+        if (_calibration_service != nullptr) {
+            _calibration_service->stop();
+        }
 #endif
 
 #ifdef CAMERA_ENABLED
-        _camera_service.stop();
+        if (_camera_service != nullptr) {
+            _camera_service->stop();
+        }
 #endif
 
 #ifdef CAMERA_SERVER_ENABLED
-        _camera_server_service.stop();
+        if (_camera_server_service != nullptr) {
+            _camera_server_service->stop();
+        }
 #endif
 
 #ifdef COMPONENT_INFORMATION_ENABLED
-        _component_information_service.stop();
+        if (_component_information_service != nullptr) {
+            _component_information_service->stop();
+        }
 #endif
 
 #ifdef COMPONENT_INFORMATION_SERVER_ENABLED
-        _component_information_server_service.stop();
+        if (_component_information_server_service != nullptr) {
+            _component_information_server_service->stop();
+        }
 #endif
 
 #ifdef FAILURE_ENABLED
-        _failure_service.stop();
+        if (_failure_service != nullptr) {
+            _failure_service->stop();
+        }
 #endif
 
 #ifdef FOLLOW_ME_ENABLED
-        _follow_me_service.stop();
+        if (_follow_me_service != nullptr) {
+            _follow_me_service->stop();
+        }
 #endif
 
 #ifdef FTP_ENABLED
-        _ftp_service.stop();
+        if (_ftp_service != nullptr) {
+            _ftp_service->stop();
+        }
 #endif
 
 #ifdef GEOFENCE_ENABLED
-        _geofence_service.stop();
+        if (_geofence_service != nullptr) {
+            _geofence_service->stop();
+        }
 #endif
 
 #ifdef GIMBAL_ENABLED
-        _gimbal_service.stop();
+        if (_gimbal_service != nullptr) {
+            _gimbal_service->stop();
+        }
 #endif
 
 #ifdef GRIPPER_ENABLED
-        _gripper_service.stop();
+        if (_gripper_service != nullptr) {
+            _gripper_service->stop();
+        }
 #endif
 
 #ifdef INFO_ENABLED
-        _info_service.stop();
+        if (_info_service != nullptr) {
+            _info_service->stop();
+        }
 #endif
 
 #ifdef LOG_FILES_ENABLED
-        _log_files_service.stop();
+        if (_log_files_service != nullptr) {
+            _log_files_service->stop();
+        }
 #endif
 
 #ifdef MANUAL_CONTROL_ENABLED
-        _manual_control_service.stop();
+        if (_manual_control_service != nullptr) {
+            _manual_control_service->stop();
+        }
 #endif
 
 #ifdef MISSION_ENABLED
-        _mission_service.stop();
+        if (_mission_service != nullptr) {
+            _mission_service->stop();
+        }
 #endif
 
 #ifdef MISSION_RAW_ENABLED
-        _mission_raw_service.stop();
+        if (_mission_raw_service != nullptr) {
+            _mission_raw_service->stop();
+        }
 #endif
 
 #ifdef MISSION_RAW_SERVER_ENABLED
-        _mission_raw_server_service.stop();
+        if (_mission_raw_server_service != nullptr) {
+            _mission_raw_server_service->stop();
+        }
 #endif
 
 #ifdef MOCAP_ENABLED
-        _mocap_service.stop();
+        if (_mocap_service != nullptr) {
+            _mocap_service->stop();
+        }
 #endif
 
 #ifdef OFFBOARD_ENABLED
-        _offboard_service.stop();
+        if (_offboard_service != nullptr) {
+            _offboard_service->stop();
+        }
 #endif
 
 #ifdef PARAM_ENABLED
-        _param_service.stop();
+        if (_param_service != nullptr) {
+            _param_service->stop();
+        }
 #endif
 
 #ifdef PARAM_SERVER_ENABLED
-        _param_server_service.stop();
+        if (_param_server_service != nullptr) {
+            _param_server_service->stop();
+        }
 #endif
 
 #ifdef RTK_ENABLED
-        _rtk_service.stop();
+        if (_rtk_service != nullptr) {
+            _rtk_service->stop();
+        }
 #endif
 
 #ifdef SERVER_UTILITY_ENABLED
-        _server_utility_service.stop();
+        if (_server_utility_service != nullptr) {
+            _server_utility_service->stop();
+        }
 #endif
 
 #ifdef SHELL_ENABLED
-        _shell_service.stop();
+        if (_shell_service != nullptr) {
+            _shell_service->stop();
+        }
 #endif
 
 #ifdef TELEMETRY_ENABLED
-        _telemetry_service.stop();
+        if (_telemetry_service != nullptr) {
+            _telemetry_service->stop();
+        }
 #endif
 
 #ifdef TELEMETRY_SERVER_ENABLED
-        _telemetry_server_service.stop();
+        if (_telemetry_server_service != nullptr) {
+            _telemetry_server_service->stop();
+        }
 #endif
 
 #ifdef TRACKING_SERVER_ENABLED
-        _tracking_server_service.stop();
+        if (_tracking_server_service != nullptr) {
+            _tracking_server_service->stop();
+        }
 #endif
 
 #ifdef TRANSPONDER_ENABLED
-        _transponder_service.stop();
+        if (_transponder_service != nullptr) {
+            _transponder_service->stop();
+        }
 #endif
 
 #ifdef TUNE_ENABLED
-        _tune_service.stop();
+        if (_tune_service != nullptr) {
+            _tune_service->stop();
+        }
 #endif
 
 #ifdef WINCH_ENABLED
-        _winch_service.stop();
+        if (_winch_service != nullptr) {
+            _winch_service->stop();
+        }
 #endif
 
         _server->Shutdown();
@@ -315,10 +694,215 @@ void GrpcServer::stop()
     }
 }
 
+void GrpcServer::add_metrics(Metrics& metrics) const
+{
+#ifdef ACTION_ENABLED
+    if (_action_service != nullptr) {
+        add_stream_metrics(metrics, "action", _action_service->stream_stats());
+    }
+#endif
+
+#ifdef ACTION_SERVER_ENABLED
+    if (_action_server_service != nullptr) {
+        add_stream_metrics(metrics, "action_server", _action_server_service->stream_stats());
+    }
+#endif
+
+#ifdef CALIBRATION_ENABLED
+    if (_calibration_service != nullptr) {
+        add_stream_metrics(metrics, "calibration", _calibration_service->stream_stats());
+    }
+#endif
+
+#ifdef CAMERA_ENABLED
+    if (_camera_service != nullptr) {
+        add_stream_metrics(metrics, "camera", _camera_service->stream_stats());
+    }
+#endif
+
+#ifdef CAMERA_SERVER_ENABLED
+    if (_camera_server_service != nullptr) {
+        add_stream_metrics(metrics, "camera_server", _camera_server_service->stream_stats());
+    }
+#endif
+
+#ifdef COMPONENT_INFORMATION_ENABLED
+    if (_component_information_service != nullptr) {
+        add_stream_metrics(
+            metrics, "component_information", _component_information_service->stream_stats());
+    }
+#endif
+
+#ifdef COMPONENT_INFORMATION_SERVER_ENABLED
+    if (_component_information_server_service != nullptr) {
+        add_stream_metrics(
+            metrics,
+            "component_information_server",
+            _component_information_server_service->stream_stats());
+    }
+#endif
+
+#ifdef FAILURE_ENABLED
+    if (_failure_service != nullptr) {
+        add_stream_metrics(metrics, "failure", _failure_service->stream_stats());
+    }
+#endif
+
+#ifdef FOLLOW_ME_ENABLED
+    if (_follow_me_service != nullptr) {
+        add_stream_metrics(metrics, "follow_me", _follow_me_service->stream_stats());
+    }
+#endif
+
+#ifdef FTP_ENABLED
+    if (_ftp_service != nullptr) {
+        add_stream_metrics(metrics, "ftp", _ftp_service->stream_stats());
+    }
+#endif
+
+#ifdef GEOFENCE_ENABLED
+    if (_geofence_service != nullptr) {
+        add_stream_metrics(metrics, "geofence", _geofence_service->stream_stats());
+    }
+#endif
+
+#ifdef GIMBAL_ENABLED
+    if (_gimbal_service != nullptr) {
+        add_stream_metrics(metrics, "gimbal", _gimbal_service->stream_stats());
+    }
+#endif
+
+#ifdef GRIPPER_ENABLED
+    if (_gripper_service != nullptr) {
+        add_stream_metrics(metrics, "gripper", _gripper_service->stream_stats());
+    }
+#endif
+
+#ifdef INFO_ENABLED
+    if (_info_service != nullptr) {
+        add_stream_metrics(metrics, "info", _info_service->stream_stats());
+    }
+#endif
+
+#ifdef LOG_FILES_ENABLED
+    if (_log_files_service != nullptr) {
+        add_stream_metrics(metrics, "log_files", _log_files_service->stream_stats());
+    }
+#endif
+
+#ifdef MANUAL_CONTROL_ENABLED
+    if (_manual_control_service != nullptr) {
+        add_stream_metrics(metrics, "manual_control", _manual_control_service->stream_stats());
+    }
+#endif
+
+#ifdef MISSION_ENABLED
+    if (_mission_service != nullptr) {
+        add_stream_metrics(metrics, "mission", _mission_service->stream_stats());
+    }
+#endif
+
+#ifdef MISSION_RAW_ENABLED
+    if (_mission_raw_service != nullptr) {
+        add_stream_metrics(metrics, "mission_raw", _mission_raw_service->stream_stats());
+    }
+#endif
+
+#ifdef MISSION_RAW_SERVER_ENABLED
+    if (_mission_raw_server_service != nullptr) {
+        add_stream_metrics(
+            metrics, "mission_raw_server", _mission_raw_server_service->stream_stats());
+    }
+#endif
+
+#ifdef MOCAP_ENABLED
+    if (_mocap_service != nullptr) {
+        add_stream_metrics(metrics, "mocap", _mocap_service->stream_stats());
+    }
+#endif
+
+#ifdef OFFBOARD_ENABLED
+    if (_offboard_service != nullptr) {
+        add_stream_metrics(metrics, "offboard", _offboard_service->stream_stats());
+    }
+#endif
+
+#ifdef PARAM_ENABLED
+    if (_param_service != nullptr) {
+        add_stream_metrics(metrics, "param", _param_service->stream_stats());
+    }
+#endif
+
+#ifdef PARAM_SERVER_ENABLED
+    if (_param_server_service != nullptr) {
+        add_stream_metrics(metrics, "param_server", _param_server_service->stream_stats());
+    }
+#endif
+
+#ifdef RTK_ENABLED
+    if (_rtk_service != nullptr) {
+        add_stream_metrics(metrics, "rtk", _rtk_service->stream_stats());
+    }
+#endif
+
+#ifdef SERVER_UTILITY_ENABLED
+    if (_server_utility_service != nullptr) {
+        add_stream_metrics(metrics, "server_utility", _server_utility_service->stream_stats());
+    }
+#endif
+
+#ifdef SHELL_ENABLED
+    if (_shell_service != nullptr) {
+        add_stream_metrics(metrics, "shell", _shell_service->stream_stats());
+    }
+#endif
+
+#ifdef TELEMETRY_ENABLED
+    if (_telemetry_service != nullptr) {
+        add_stream_metrics(metrics, "telemetry", _telemetry_service->stream_stats());
+    }
+#endif
+
+#ifdef TELEMETRY_SERVER_ENABLED
+    if (_telemetry_server_service != nullptr) {
+        add_stream_metrics(metrics, "telemetry_server", _telemetry_server_service->stream_stats());
+    }
+#endif
+
+#ifdef TRACKING_SERVER_ENABLED
+    if (_tracking_server_service != nullptr) {
+        add_stream_metrics(metrics, "tracking_server", _tracking_server_service->stream_stats());
+    }
+#endif
+
+#ifdef TRANSPONDER_ENABLED
+    if (_transponder_service != nullptr) {
+        add_stream_metrics(metrics, "transponder", _transponder_service->stream_stats());
+    }
+#endif
+
+#ifdef TUNE_ENABLED
+    if (_tune_service != nullptr) {
+        add_stream_metrics(metrics, "tune", _tune_service->stream_stats());
+    }
+#endif
+
+#ifdef WINCH_ENABLED
+    if (_winch_service != nullptr) {
+        add_stream_metrics(metrics, "winch", _winch_service->stream_stats());
+    }
+#endif
+}
+
 void GrpcServer::setup_port(grpc::ServerBuilder& builder)
 {
     const std::string server_address("0.0.0.0:" + std::to_string(_port));
     builder.AddListeningPort(server_address, grpc::InsecureServerCredentials(), &_bound_port);
+
+    if (!_unix_socket_path.empty()) {
+        // gRPC removes a socket left behind by a previous run before binding.
+        builder.AddListeningPort("unix:" + _unix_socket_path, grpc::InsecureServerCredentials());
+    }
 }
 
 } // namespace mavsdk_server
@@ -10,9 +10,13 @@
 #endif
 
 #include <memory>
+#include <set>
+#include <string>
+#include <vector>
 
 #include "mavsdk.h"
 #include "core/core_service_impl.h"
+#include "metrics.h"
 
 #ifdef ACTION_ENABLED
 #include "plugins/action/action.h"
@@ -179,409 +183,265 @@ namespace mavsdk_server {
 
 class GrpcServer {
 public:
-    GrpcServer(Mavsdk& mavsdk) :
-        _core(mavsdk),
+    GrpcServer(Mavsdk& mavsdk) : _mavsdk(mavsdk), _core(mavsdk) {}
 
-#ifdef ACTION_ENABLED
-        _action_lazy_plugin(mavsdk),
-        _action_service(_action_lazy_plugin),
-#endif
-
-#ifdef ACTION_SERVER_ENABLED
-        _action_server_lazy_plugin(mavsdk),
-        _action_server_service(_action_server_lazy_plugin),
-#endif
-
-#ifdef CALIBRATION_ENABLED
-        _calibration_lazy_plugin(mavsdk),
-        _calibration_service(_calibration_lazy_plugin),
-#endif
-
-#ifdef CAMERA_ENABLED
-        _camera_lazy_plugin(mavsdk),
-        _camera_service(_camera_lazy_plugin),
-#endif
-
-#ifdef CAMERA_SERVER_ENABLED
-        _camera_server_lazy_plugin(mavsdk),
-        _camera_server_service(_camera_server_lazy_plugin),
-#endif
-
-#ifdef COMPONENT_INFORMATION_ENABLED
-        _component_information_lazy_plugin(mavsdk),
-        _component_information_service(_component_information_lazy_plugin),
-#endif
-
-#ifdef COMPONENT_INFORMATION_SERVER_ENABLED
-        _component_information_server_lazy_plugin(mavsdk),
-        _component_information_server_service(_component_information_server_lazy_plugin),
-#endif
-
-#ifdef FAILURE_ENABLED
-        _failure_lazy_plugin(mavsdk),
-        _failure_service(_failure_lazy_plugin),
-#endif
-
-#ifdef FOLLOW_ME_ENABLED
-        _follow_me_lazy_plugin(mavsdk),
-        _follow_me_service(_follow_me_lazy_plugin),
-#endif
-
-#ifdef FTP_ENABLED
-        _ftp_lazy_plugin(mavsdk),
-        _ftp_service(_ftp_lazy_plugin),
-#endif
-
-#ifdef GEOFENCE_ENABLED
-        _geofence_lazy_plugin(mavsdk),
-        _geofence_service(_geofence_lazy_plugin),
-#endif
-
-#ifdef GIMBAL_ENABLED
-        _gimbal_lazy_plugin(mavsdk),
-        _gimbal_service(_gimbal_lazy_plugin),
-#endif
-
-#ifdef GRIPPER_ENABLED
-        _gripper_lazy_plugin(mavsdk),
-        _gripper_service(_gripper_lazy_plugin),
-#endif
-
-#ifdef INFO_ENABLED
-        _info_lazy_plugin(mavsdk),
-        _info_service(_info_lazy_plugin),
-#endif
-
-#ifdef LOG_FILES_ENABLED
-        _log_files_lazy_plugin(mavsdk),
-        _log_files_service(_log_files_lazy_plugin),
-#endif
-
-#ifdef MANUAL_CONTROL_ENABLED
-        _manual_control_lazy_plugin(mavsdk),
-        _manual_control_service(_manual_control_lazy_plugin),
-#endif
-
-#ifdef MISSION_ENABLED
-        _mission_lazy_plugin(mavsdk),
-        _mission_service(_mission_lazy_plugin),
-#endif
-
-#ifdef MISSION_RAW_ENABLED
-        _mission_raw_lazy_plugin(mavsdk),
-        _mission_raw_service(_mission_raw_lazy_plugin),
-#endif
-
-#ifdef MISSION_RAW_SERVER_ENABLED
-        _mission_raw_server_lazy_plugin(mavsdk),
-        _mission_raw_server_service(_mission_raw_server_lazy_plugin),
-#endif
-
-#ifdef MOCAP_ENABLED
-        _mocap_lazy_plugin(mavsdk),
-        _mocap_service(_mocap_lazy_plugin),
-#endif
-
-#ifdef OFFBOARD_ENABLED
-        _offboard_lazy_plugin(mavsdk),
-        _offboard_service(_offboard_lazy_plugin),
-#endif
-
-#ifdef PARAM_ENABLED
-        _param_lazy_plugin(mavsdk),
-        _param_service(_param_lazy_plugin),
-#endif
-
-#ifdef PARAM_SERVER_ENABLED
-        _param_server_lazy_plugin(mavsdk),
-        _param_server_service(_param_server_lazy_plugin),
-#endif
-
-#ifdef RTK_ENABLED
-        _rtk_lazy_plugin(mavsdk),
-        _rtk_service(_rtk_lazy_plugin),
-#endif
-
-#ifdef SERVER_UTILITY_ENABLED
-        _server_utility_lazy_plugin(mavsdk),
-        _server_utility_service(_server_utility_lazy_plugin),
-#endif
-
-#ifdef SHELL_ENABLED
-        _shell_lazy_plugin(mavsdk),
-        _shell_service(_shell_lazy_plugin),
-#endif
-
-#ifdef TELEMETRY_ENABLED
-        _telemetry_lazy_plugin(mavsdk),
-        _telemetry_service(_telemetry_lazy_plugin),
-#endif
-
-#ifdef TELEMETRY_SERVER_ENABLED
-        _telemetry_server_lazy_plugin(mavsdk),
-        _telemetry_server_service(_telemetry_server_lazy_plugin),
-#endif
-
-#ifdef TRACKING_SERVER_ENABLED
-        _tracking_server_lazy_plugin(mavsdk),
-        _tracking_server_service(_tracking_server_lazy_plugin),
-#endif
-
-#ifdef TRANSPONDER_ENABLED
-        _transponder_lazy_plugin(mavsdk),
-        _transponder_service(_transponder_lazy_plugin),
-#endif
-
-#ifdef TUNE_ENABLED
-        _tune_lazy_plugin(mavsdk),
-        _tune_service(_tune_lazy_plugin),
-#endif
-
-#ifdef WINCH_ENABLED
-        _winch_lazy_plugin(mavsdk),
-        _winch_service(_winch_lazy_plugin)
-#endif
-
-    {}
+    // Names of the services compiled in, e.g. "telemetry".
+    static const std::vector<std::string>& available_services();
 
     int run();
     void wait();
     void stop();
     void set_port(int port);
+    // Also listen on a Unix domain socket, for clients on the same host.
+    void set_unix_socket_path(const std::string& path);
+    // Channel to the services without a socket, call it after run().
+    std::shared_ptr<grpc::Channel> in_process_channel();
+    // Adds the counters of the streams of each service.
+    void add_metrics(Metrics& metrics) const;
+    // Only construct and register these services instead of all of them,
+    // call it before run(). Clients get UNIMPLEMENTED for the others.
+    void set_enabled_services(const std::vector<std::string>& services);
 
 private:
     void setup_port(grpc::ServerBuilder& builder);
+    bool is_enabled(const std::string& service) const;
 
+    Mavsdk& _mavsdk;
     CoreServiceImpl<> _core;
 
 #ifdef ACTION_ENABLED
 
-    LazyPlugin<Action> _action_lazy_plugin;
+    std::unique_ptr<LazyPlugin<Action>> _action_lazy_plugin{};
 
-    ActionServiceImpl<> _action_service;
+    std::unique_ptr<ActionServiceImpl<>> _action_service{};
 #endif
 
 #ifdef ACTION_SERVER_ENABLED
 
-    LazyServerPlugin<ActionServer> _action_server_lazy_plugin;
+    std::unique_ptr<LazyServerPlugin<ActionServer>> _action_server_lazy_plugin{};
 
-    ActionServerServiceImpl<> _action_server_service;
+    std::unique_ptr<ActionServerServiceImpl<>> _action_server_service{};
 #endif
 
 #ifdef CALIBRATION_ENABLED
 
-    LazyPlugin<Calibration> _calibration_lazy_plugin;
+    std::unique_ptr<LazyPlugin<Calibration>> _calibration_lazy_plugin{};
 
-    CalibrationServiceImpl<> _calibration_service;
+    std::unique_ptr<CalibrationServiceImpl<>> _calibration_service{};
 #endif
 
 #ifdef CAMERA_ENABLED
 
-    LazyPlugin<Camera> _camera_lazy_plugin;
+    std::unique_ptr<LazyPlugin<Camera>> _camera_lazy_plugin{};
 
-    CameraServiceImpl<> _camera_service;
+    std::unique_ptr<CameraServiceImpl<>> _camera_service{};
 #endif
 
 #ifdef CAMERA_SERVER_ENABLED
 
-    LazyServerPlugin<CameraServer> _camera_server_lazy_plugin;
+    std::unique_ptr<LazyServerPlugin<CameraServer>> _camera_server_lazy_plugin{};
 
-    CameraServerServiceImpl<> _camera_server_service;
+    std::unique_ptr<CameraServerServiceImpl<>> _camera_server_service{};
 #endif
 
 #ifdef COMPONENT_INFORMATION_ENABLED
 
-    LazyPlugin<ComponentInformation> _component_information_lazy_plugin;
+    std::unique_ptr<LazyPlugin<ComponentInformation>> _component_information_lazy_plugin{};
 
-    ComponentInformationServiceImpl<> _component_information_service;
+    std::unique_ptr<ComponentInformationServiceImpl<>> _component_information_service{};
 #endif
 
 #ifdef COMPONENT_INFORMATION_SERVER_ENABLED
 
-    LazyServerPlugin<ComponentInformationServer> _component_information_server_lazy_plugin;
+    std::unique_ptr<LazyServerPlugin<ComponentInformationServer>>
+        _component_information_server_lazy_plugin{};
 
-    ComponentInformationServerServiceImpl<> _component_information_server_service;
+    std::unique_ptr<ComponentInformationServerServiceImpl<>>
+        _component_information_server_service{};
 #endif
 
 #ifdef FAILURE_ENABLED
 
-    LazyPlugin<Failure> _failure_lazy_plugin;
+    std::unique_ptr<LazyPlugin<Failure>> _failure_lazy_plugin{};
 
-    FailureServiceImpl<> _failure_service;
+    std::unique_ptr<FailureServiceImpl<>> _failure_service{};
 #endif
 
 #ifdef FOLLOW_ME_ENABLED
 
-    LazyPlugin<FollowMe> _follow_me_lazy_plugin;
+    std::unique_ptr<LazyPlugin<FollowMe>> _follow_me_lazy_plugin{};
 
-    FollowMeServiceImpl<> _follow_me_service;
+    std::unique_ptr<FollowMeServiceImpl<>> _follow_me_service{};
 #endif
 
 #ifdef FTP_ENABLED
 
-    LazyPlugin<Ftp> _ftp_lazy_plugin;
+    std::unique_ptr<LazyPlugin<Ftp>> _ftp_lazy_plugin{};
 
-    FtpServiceImpl<> _ftp_service;
+    std::unique_ptr<FtpServiceImpl<>> _ftp_service{};
 #endif
 
 #ifdef GEOFENCE_ENABLED
 
-    LazyPlugin<Geofence> _geofence_lazy_plugin;
+    std::unique_ptr<LazyPlugin<Geofence>> _geofence_lazy_plugin{};
 
-    GeofenceServiceImpl<> _geofence_service;
+    std::unique_ptr<GeofenceServiceImpl<>> _geofence_service{};
 #endif
 
 #ifdef GIMBAL_ENABLED
 
-    LazyPlugin<Gimbal> _gimbal_lazy_plugin;
+    std::unique_ptr<LazyPlugin<Gimbal>> _gimbal_lazy_plugin{};
 
-    GimbalServiceImpl<> _gimbal_service;
+    std::unique_ptr<GimbalServiceImpl<>> _gimbal_service{};
 #endif
 
 #ifdef GRIPPER_ENABLED
 
-    LazyPlugin<Gripper> _gripper_lazy_plugin;
+    std::unique_ptr<LazyPlugin<Gripper>> _gripper_lazy_plugin{};
 
-    GripperServiceImpl<> _gripper_service;
+    std::unique_ptr<GripperServiceImpl<>> _gripper_service{};
 #endif
 
 #ifdef INFO_ENABLED
 
-    LazyPlugin<Info> _info_lazy_plugin;
+    std::unique_ptr<LazyPlugin<Info>> _info_lazy_plugin{};
 
-    InfoServiceImpl<> _info_service;
+    std::unique_ptr<InfoServiceImpl<>> _info_service{};
 #endif
 
 #ifdef LOG_FILES_ENABLED
 
-    LazyPlugin<LogFiles> _log_files_lazy_plugin;
+    std::unique_ptr<LazyPlugin<LogFiles>> _log_files_lazy_plugin{};
 
-    LogFilesServiceImpl<> _log_files_service;
+    std::unique_ptr<LogFilesServiceImpl<>> _log_files_service{};
 #endif
 
 #ifdef MANUAL_CONTROL_ENABLED
 
-    LazyPlugin<ManualControl> _manual_control_lazy_plugin;
+    std::unique_ptr<LazyPlugin<ManualControl>> _manual_control_lazy_plugin{};
 
-    ManualControlServiceImpl<> _manual_control_service;
+    std::unique_ptr<ManualControlServiceImpl<>> _manual_control_service{};
 #endif
 
 #ifdef MISSION_ENABLED
 
-    LazyPlugin<Mission> _mission_lazy_plugin;
+    std::unique_ptr<LazyPlugin<Mission>> _mission_lazy_plugin{};
 
-    MissionServiceImpl<> _mission_service;
+    std::unique_ptr<MissionServiceImpl<>> _mission_service{};
 #endif
 
 #ifdef MISSION_RAW_ENABLED
 
-    LazyPlugin<MissionRaw> _mission_raw_lazy_plugin;
+    std::unique_ptr<LazyPlugin<MissionRaw>> _mission_raw_lazy_plugin{};
 
-    MissionRawServiceImpl<> _mission_raw_service;
+    std::unique_ptr<MissionRawServiceImpl<>> _mission_raw_service{};
 #endif
 
 #ifdef MISSION_RAW_SERVER_ENABLED
 
-    LazyServerPlugin<MissionRawServer> _mission_raw_server_lazy_plugin;
+    std::unique_ptr<LazyServerPlugin<MissionRawServer>> _mission_raw_server_lazy_plugin{};
 
-    MissionRawServerServiceImpl<> _mission_raw_server_service;
+    std::unique_ptr<MissionRawServerServiceImpl<>> _mission_raw_server_service{};
 #endif
 
 #ifdef MOCAP_ENABLED
 
-    LazyPlugin<Mocap> _mocap_lazy_plugin;
+    std::unique_ptr<LazyPlugin<Mocap>> _mocap_lazy_plugin{};
 
-    MocapServiceImpl<> _mocap_service;
+    std::unique_ptr<MocapServiceImpl<>> _mocap_service{};
 #endif
 
 #ifdef OFFBOARD_ENABLED
 
-    LazyPlugin<Offboard> _offboard_lazy_plugin;
+    std::unique_ptr<LazyPlugin<Offboard>> _offboard_lazy_plugin{};
 
-    OffboardServiceImpl<> _offboard_service;
+    std::unique_ptr<OffboardServiceImpl<>> _offboard_service{};
 #endif
 
 #ifdef PARAM_ENABLED
 
-    LazyPlugin<Param> _param_lazy_plugin;
+    std::unique_ptr<LazyPlugin<Param>> _param_lazy_plugin{};
 
-    ParamServiceImpl<> _param_service;
+    std::unique_ptr<ParamServiceImpl<>> _param_service{};
 #endif
 
 #ifdef PARAM_SERVER_ENABLED
 
-    LazyServerPlugin<ParamServer> _param_server_lazy_plugin;
+    std::unique_ptr<LazyServerPlugin<ParamServer>> _param_server_lazy_plugin{};
 
-    ParamServerServiceImpl<> _param_server_service;
+    std::unique_ptr<ParamServerServiceImpl<>> _param_server_service{};
 #endif
 
 #ifdef RTK_ENABLED
 
-    LazyPlugin<Rtk> _rtk_lazy_plugin;
+    std::unique_ptr<LazyPlugin<Rtk>> _rtk_lazy_plugin{};
 
-    RtkServiceImpl<> _rtk_service;
+    std::unique_ptr<RtkServiceImpl<>> _rtk_service{};
 #endif
 
 #ifdef SERVER_UTILITY_ENABLED
 
-    LazyPlugin<ServerUtility> _server_utility_lazy_plugin;
+    std::unique_ptr<LazyPlugin<ServerUtility>> _server_utility_lazy_plugin{};
 
-    ServerUtilityServiceImpl<> _server_utility_service;
+    std::unique_ptr<ServerUtilityServiceImpl<>> _server_utility_service{};
 #endif
 
 #ifdef SHELL_ENABLED
 
-    LazyPlugin<Shell> _shell_lazy_plugin;
+    std::unique_ptr<LazyPlugin<Shell>> _shell_lazy_plugin{};
 
-    ShellServiceImpl<> _shell_service;
+    std::unique_ptr<ShellServiceImpl<>> _shell_service{};
 #endif
 
 #ifdef TELEMETRY_ENABLED
 
-    LazyPlugin<Telemetry> _telemetry_lazy_plugin;
+    std::unique_ptr<LazyPlugin<Telemetry>> _telemetry_lazy_plugin{};
 
-    TelemetryServiceImpl<> _telemetry_service;
+    std::unique_ptr<TelemetryServiceImpl<>> _telemetry_service{};
 #endif
 
 #ifdef TELEMETRY_SERVER_ENABLED
 
-    LazyServerPlugin<TelemetryServer> _telemetry_server_lazy_plugin;
+    std::unique_ptr<LazyServerPlugin<TelemetryServer>> _telemetry_server_lazy_plugin{};
 
-    TelemetryServerServiceImpl<> _telemetry_server_service;
+    std::unique_ptr<TelemetryServerServiceImpl<>> _telemetry_server_service{};
 #endif
 
 #ifdef TRACKING_SERVER_ENABLED
 
-    LazyServerPlugin<TrackingServer> _tracking_server_lazy_plugin;
+    std::unique_ptr<LazyServerPlugin<TrackingServer>> _tracking_server_lazy_plugin{};
 
-    TrackingServerServiceImpl<> _tracking_server_service;
+    std::unique_ptr<TrackingServerServiceImpl<>> _tracking_server_service{};
 #endif
 
 #ifdef TRANSPONDER_ENABLED
 
-    LazyPlugin<Transponder> _transponder_lazy_plugin;
+    std::unique_ptr<LazyPlugin<Transponder>> _transponder_lazy_plugin{};
 
-    TransponderServiceImpl<> _transponder_service;
+    std::unique_ptr<TransponderServiceImpl<>> _transponder_service{};
 #endif
 
 #ifdef TUNE_ENABLED
 
-    LazyPlugin<Tune> _tune_lazy_plugin;
+    std::unique_ptr<LazyPlugin<Tune>> _tune_lazy_plugin{};
 
-    TuneServiceImpl<> _tune_service;
+    std::unique_ptr<TuneServiceImpl<>> _tune_service{};
 #endif
 
 #ifdef WINCH_ENABLED
 
-    LazyPlugin<Winch> _winch_lazy_plugin;
+    std::unique_ptr<LazyPlugin<Winch>> _winch_lazy_plugin{};
 
-    WinchServiceImpl<> _winch_service;
+    std::unique_ptr<WinchServiceImpl<>> _winch_service{};
 #endif
 
     std::unique_ptr<grpc::Server> _server;
 
     int _port{0};
     int _bound_port{0};
+    std::string _unix_socket_path{};
+    bool _all_services_enabled{true};
+    std::set<std::string> _enabled_services{};
 };
 
 } // namespace mavsdk_server
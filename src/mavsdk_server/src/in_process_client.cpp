@@ -0,0 +1,142 @@
+#include "in_process_client.h"
+
+#include <future>
+#include <utility>
+
+#include <grpcpp/client_context.h>
+#include <grpcpp/support/byte_buffer.h>
+#include <grpcpp/support/client_callback.h>
+#include <grpcpp/support/slice.h>
+
+namespace mavsdk {
+namespace mavsdk_server {
+
+namespace {
+
+grpc::ByteBuffer to_byte_buffer(const uint8_t* data, size_t size)
+{
+    grpc::Slice slice(data, size);
+    return grpc::ByteBuffer(&slice, 1);
+}
+
+bool deliver(const grpc::ByteBuffer& buffer, const InProcessClient::ResponseCallback& callback)
+{
+    // In process the response usually is a single slice we can hand out as is.
+    grpc::Slice slice;
+    if (!buffer.TrySingleSlice(&slice).ok() && !buffer.DumpToSingleSlice(&slice).ok()) {
+        return false;
+    }
+
+    // An empty message must not look like the end of the call.
+    static const uint8_t empty{0};
+    callback(slice.size() > 0 ? slice.begin() : &empty, slice.size(), grpc::StatusCode::OK);
+    return true;
+}
+
+struct UnaryCall {
+    grpc::ClientContext context{};
+    grpc::ByteBuffer request{};
+    grpc::ByteBuffer response{};
+    InProcessClient::ResponseCallback callback{};
+};
+
+} // namespace
+
+class InProcessClient::Subscription::Reactor
+    : public grpc::ClientBidiReactor<grpc::ByteBuffer, grpc::ByteBuffer> {
+public:
+    Reactor(grpc::ByteBuffer request, ResponseCallback callback) :
+        _request(std::move(request)),
+        _callback(std::move(callback))
+    {}
+
+    void start(grpc::GenericStub& stub, const std::string& method)
+    {
+        stub.PrepareBidiStreamingCall(&_context, method, grpc::StubOptions(), this);
+        // A server streaming call takes exactly one request.
+        StartWriteLast(&_request, grpc::WriteOptions());
+        StartRead(&_response);
+        StartCall();
+    }
+
+    void cancel()
+    {
+        _context.TryCancel();
+        _done.get_future().wait();
+    }
+
+    void OnReadDone(bool ok) override
+    {
+        if (!ok) {
+            return;
+        }
+        deliver(_response, _callback);
+        StartRead(&_response);
+    }
+
+    void OnDone(const grpc::Status& status) override
+    {
+        _callback(nullptr, 0, status.error_code());
+        _done.set_value();
+    }
+
+private:
+    grpc::ClientContext _context{};
+    grpc::ByteBuffer _request;
+    grpc::ByteBuffer _response{};
+    const ResponseCallback _callback;
+    std::promise<void> _done{};
+};
+
+InProcessClient::Subscription::Subscription(std::unique_ptr<Reactor> reactor) :
+    _reactor(std::move(reactor))
+{}
+
+InProcessClient::Subscription::~Subscription()
+{
+    _reactor->cancel();
+}
+
+InProcessClient::InProcessClient(std::shared_ptr<grpc::Channel> channel) :
+    _stub(std::move(channel))
+{}
+
+void InProcessClient::call(
+    const std::string& method,
+    const uint8_t* request,
+    size_t request_size,
+    ResponseCallback callback)
+{
+    auto* unary_call = new UnaryCall();
+    unary_call->request = to_byte_buffer(request, request_size);
+    unary_call->callback = std::move(callback);
+
+    _stub.UnaryCall(
+        &unary_call->context,
+        method,
+        grpc::StubOptions(),
+        &unary_call->request,
+        &unary_call->response,
+        [unary_call](grpc::Status status) {
+            if (status.ok() && !deliver(unary_call->response, unary_call->callback)) {
+                status = grpc::Status(grpc::StatusCode::INTERNAL, "Invalid response");
+            }
+            unary_call->callback(nullptr, 0, status.error_code());
+            delete unary_call;
+        });
+}
+
+std::unique_ptr<InProcessClient::Subscription> InProcessClient::subscribe(
+    const std::string& method,
+    const uint8_t* request,
+    size_t request_size,
+    ResponseCallback callback)
+{
+    auto reactor = std::make_unique<Subscription::Reactor>(
+        to_byte_buffer(request, request_size), std::move(callback));
+    reactor->start(_stub, method);
+    return std::unique_ptr<Subscription>(new Subscription(std::move(reactor)));
+}
+
+} // namespace mavsdk_server
+} // namespace mavsdk
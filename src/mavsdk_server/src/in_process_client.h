@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+#include <grpcpp/channel.h>
+#include <grpcpp/generic/generic_stub.h>
+
+namespace mavsdk {
+namespace mavsdk_server {
+
+// Calls the services of the server in the same process, without a socket.
+//
+// This skips the network stack and HTTP/2 framing of loopback gRPC. Requests
+// and responses are the serialized protobuf messages, passed as they come
+// from the service implementations, so clients in other languages can
+// decode them with the code generated from the same protos.
+class InProcessClient {
+public:
+    // Gets each response, then data == nullptr with the status once the call is over.
+    // The data is only valid during the callback. It is called on a gRPC thread
+    // and should return quickly.
+    using ResponseCallback =
+        std::function<void(const uint8_t* data, size_t size, int status_code)>;
+
+    class Subscription;
+
+    explicit InProcessClient(std::shared_ptr<grpc::Channel> channel);
+
+    // Makes a unary call, e.g. "/mavsdk.rpc.action.ActionService/Arm".
+    void call(
+        const std::string& method,
+        const uint8_t* request,
+        size_t request_size,
+        ResponseCallback callback);
+
+    // Starts a server streaming call, e.g.
+    // "/mavsdk.rpc.telemetry.TelemetryService/SubscribePosition".
+    std::unique_ptr<Subscription> subscribe(
+        const std::string& method,
+        const uint8_t* request,
+        size_t request_size,
+        ResponseCallback callback);
+
+    // Non-copyable
+    InProcessClient(const InProcessClient&) = delete;
+    const InProcessClient& operator=(const InProcessClient&) = delete;
+
+private:
+    grpc::GenericStub _stub;
+};
+
+// A running server streaming call. Destroying it cancels the call and waits
+// until it is over, so don't destroy it from within its callback.
+class InProcessClient::Subscription {
+public:
+    ~Subscription();
+
+    Subscription(const Subscription&) = delete;
+    const Subscription& operator=(const Subscription&) = delete;
+
+private:
+    friend InProcessClient;
+
+    class Reactor;
+    explicit Subscription(std::unique_ptr<Reactor> reactor);
+
+    std::unique_ptr<Reactor> _reactor;
+};
+
+} // namespace mavsdk_server
+} // namespace mavsdk
@@ -1,10 +1,17 @@
 #include "mavsdk_server.h"
 
 #include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
 
 #include "connection_initiator.h"
 #include "mavsdk.h"
 #include "grpc_server.h"
+#include "in_process_client.h"
+#include "metrics.h"
+#include "metrics_server.h"
 
 using namespace mavsdk::mavsdk_server;
 
@@ -23,7 +30,19 @@ public:
     {
         _server = std::make_unique<GrpcServer>(_mavsdk);
         _server->set_port(port);
+        _server->set_unix_socket_path(_unix_socket_path);
+        if (_enabled_services) {
+            _server->set_enabled_services(_enabled_services.value());
+        }
         _grpc_port = _server->run();
+        if (_grpc_port != 0) {
+            _in_process_client = std::make_unique<InProcessClient>(_server->in_process_channel());
+        }
+
+        if (_grpc_port != 0 && _metrics_port >= 0) {
+            start_metrics_server();
+        }
+
         return _grpc_port;
     }
 
@@ -33,6 +52,11 @@ public:
     {
         _connection_initiator.cancel();
 
+        if (_metrics_server != nullptr) {
+            _metrics_server->stop();
+            _mavsdk.unsubscribe_link_stats(_link_stats_handle);
+        }
+
         if (_server != nullptr) {
             _server->stop();
         }
@@ -40,16 +64,132 @@ public:
 
     int getPort() { return _grpc_port; }
 
+    InProcessClient* inProcessClient() { return _in_process_client.get(); }
+
     void setMavlinkIds(uint8_t system_id, uint8_t component_id)
     {
         _mavsdk.set_configuration(mavsdk::Mavsdk::Configuration{system_id, component_id, false});
     }
 
+    void setUnixSocketPath(const std::string& path) { _unix_socket_path = path; }
+
+    void setMetricsPort(int port) { _metrics_port = port; }
+
+    void setEnabledServices(const std::vector<std::string>& services)
+    {
+        _enabled_services = services;
+    }
+
 private:
+    void start_metrics_server()
+    {
+        // Link stats are only published periodically, the latest are kept for the scrapes.
+        _link_stats_handle =
+            _mavsdk.subscribe_link_stats([this](std::vector<mavsdk::LinkStats> stats) {
+                std::lock_guard<std::mutex> lock(_link_stats_mutex);
+                _link_stats = std::move(stats);
+            });
+
+        _metrics_server = std::make_unique<MetricsServer>([this]() { return collect_metrics(); });
+        if (_metrics_server->start(_metrics_port) == 0) {
+            _mavsdk.unsubscribe_link_stats(_link_stats_handle);
+            _metrics_server.reset();
+        }
+    }
+
+    std::string collect_metrics()
+    {
+        Metrics metrics;
+        _server->add_metrics(metrics);
+
+        const auto queue_stats = _mavsdk.callback_queue_stats();
+        metrics.add_gauge(
+            "mavsdk_callback_queue_depth", "Callbacks queued right now.", {}, queue_stats.depth);
+        metrics.add_gauge(
+            "mavsdk_callback_queue_max_depth",
+            "Highest number of callbacks queued at once.",
+            {},
+            queue_stats.max_depth);
+        metrics.add_counter(
+            "mavsdk_callbacks_enqueued_total", "Callbacks queued.", {}, queue_stats.enqueued);
+        metrics.add_counter(
+            "mavsdk_callbacks_dropped_total",
+            "Callbacks dropped because the queue was full.",
+            {},
+            queue_stats.dropped);
+        metrics.add_counter(
+            "mavsdk_callbacks_coalesced_total",
+            "Callbacks that replaced a queued one.",
+            {},
+            queue_stats.coalesced);
+
+        {
+            std::lock_guard<std::mutex> lock(_link_stats_mutex);
+            for (const auto& link : _link_stats) {
+                const Metrics::Labels labels{
+                    {"connection", std::to_string(link.connection_index)}};
+                metrics.add_counter(
+                    "mavsdk_link_received_bytes_total",
+                    "Bytes of all messages received.",
+                    labels,
+                    link.received_bytes);
+                metrics.add_gauge(
+                    "mavsdk_link_received_bytes_per_second",
+                    "Bytes received per second in the last interval.",
+                    labels,
+                    link.received_bytes_per_s);
+                metrics.add_counter(
+                    "mavsdk_link_parse_errors_total",
+                    "Frames dropped, e.g. because of a bad checksum.",
+                    labels,
+                    link.parse_errors);
+
+                for (const auto& remote : link.remotes) {
+                    Metrics::Labels remote_labels = labels;
+                    remote_labels.emplace_back("system_id", std::to_string(remote.system_id));
+                    remote_labels.emplace_back(
+                        "component_id", std::to_string(remote.component_id));
+                    metrics.add_counter(
+                        "mavsdk_link_messages_received_total",
+                        "Messages received from a component, including duplicates.",
+                        remote_labels,
+                        remote.received_count);
+                    metrics.add_counter(
+                        "mavsdk_link_messages_lost_total",
+                        "Messages from a component missing in the sequence.",
+                        remote_labels,
+                        remote.lost_count);
+                }
+            }
+        }
+
+        for (const auto& system : _mavsdk.systems()) {
+            metrics.add_gauge(
+                "mavsdk_system_connected",
+                "Whether the system is connected.",
+                {{"system_id", std::to_string(system->get_system_id())}},
+                system->is_connected() ? 1 : 0);
+        }
+
+        return metrics.to_text();
+    }
+
     mavsdk::Mavsdk _mavsdk;
     ConnectionInitiator<mavsdk::Mavsdk> _connection_initiator;
     std::unique_ptr<GrpcServer> _server;
     int _grpc_port;
+    // Destroyed before the server.
+    std::unique_ptr<InProcessClient> _in_process_client{};
+    std::string _unix_socket_path{};
+    // All services are enabled if not set.
+    std::optional<std::vector<std::string>> _enabled_services{};
+
+    // -1 means no metrics are served.
+    int _metrics_port{-1};
+    std::unique_ptr<MetricsServer> _metrics_server{};
+    mavsdk::Mavsdk::LinkStatsHandle _link_stats_handle{};
+    std::mutex _link_stats_mutex{};
+    std::vector<mavsdk::LinkStats> _link_stats{}; // Needs _link_stats_mutex
 };
 
 MavsdkServer::MavsdkServer() : _impl(std::make_unique<Impl>()) {}
@@ -84,3 +224,23 @@ void MavsdkServer::setMavlinkIds(uint8_t system_id, uint8_t component_id)
 {
     _impl->setMavlinkIds(system_id, component_id);
 }
+
+void MavsdkServer::setUnixSocketPath(const std::string& path)
+{
+    _impl->setUnixSocketPath(path);
+}
+
+void MavsdkServer::setMetricsPort(int port)
+{
+    _impl->setMetricsPort(port);
+}
+
+void MavsdkServer::setEnabledServices(const std::vector<std::string>& services)
+{
+    _impl->setEnabledServices(services);
+}
+
+InProcessClient* MavsdkServer::inProcessClient()
+{
+    return _impl->inProcessClient();
+}
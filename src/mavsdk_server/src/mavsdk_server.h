@@ -2,6 +2,13 @@
 
 #include <memory>
 #include <string>
+#include <vector>
+
+namespace mavsdk {
+namespace mavsdk_server {
+class InProcessClient;
+} // namespace mavsdk_server
+} // namespace mavsdk
 
 // This is a struct because it is also exported to the C interface.
 struct MavsdkServer {
@@ -17,6 +24,12 @@ public:
     void stop();
     int getPort();
     void setMavlinkIds(uint8_t system_id, uint8_t component_id);
+    void setUnixSocketPath(const std::string& path);
+    void setMetricsPort(int port);
+    // Only serve these services, e.g. {"action", "telemetry"}, instead of all.
+    void setEnabledServices(const std::vector<std::string>& services);
+    // Calls the services without a socket, nullptr until the server is started.
+    mavsdk::mavsdk_server::InProcessClient* inProcessClient();
 
 private:
     class Impl;
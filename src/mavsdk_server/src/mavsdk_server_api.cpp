@@ -1,6 +1,10 @@
 #include "mavsdk_server_api.h"
 #include "mavsdk_server.h"
+#include "in_process_client.h"
+#include <memory>
+#include <sstream>
 #include <string>
+#include <vector>
 
 void mavsdk_server_init(MavsdkServer** mavsdk_server)
 {
@@ -35,11 +39,91 @@ int mavsdk_server_run_with_mavlink_ids(
     return mavsdk_server_run(mavsdk_server, system_address, mavsdk_server_port);
 }
 
+void mavsdk_server_set_unix_socket_path(MavsdkServer* mavsdk_server, const char* path)
+{
+    mavsdk_server->setUnixSocketPath(std::string(path));
+}
+
+void mavsdk_server_set_metrics_port(MavsdkServer* mavsdk_server, int port)
+{
+    mavsdk_server->setMetricsPort(port);
+}
+
+void mavsdk_server_set_enabled_services(MavsdkServer* mavsdk_server, const char* services)
+{
+    std::vector<std::string> service_list;
+    std::stringstream stream(services);
+    std::string service;
+    while (std::getline(stream, service, ',')) {
+        if (!service.empty()) {
+            service_list.push_back(service);
+        }
+    }
+
+    mavsdk_server->setEnabledServices(service_list);
+}
+
 int mavsdk_server_get_port(MavsdkServer* mavsdk_server)
 {
     return mavsdk_server->getPort();
 }
 
+namespace {
+
+mavsdk::mavsdk_server::InProcessClient::ResponseCallback
+to_response_callback(mavsdk_server_response_callback callback, void* user_data)
+{
+    return [callback, user_data](const uint8_t* data, size_t size, int status_code) {
+        callback(data, size, status_code, user_data);
+    };
+}
+
+} // namespace
+
+struct MavsdkServerSubscription {
+    std::unique_ptr<mavsdk::mavsdk_server::InProcessClient::Subscription> subscription;
+};
+
+int mavsdk_server_call(
+    MavsdkServer* mavsdk_server,
+    const char* method,
+    const uint8_t* request,
+    size_t request_size,
+    mavsdk_server_response_callback callback,
+    void* user_data)
+{
+    auto* client = mavsdk_server->inProcessClient();
+    if (client == nullptr) {
+        return false;
+    }
+
+    client->call(
+        std::string(method), request, request_size, to_response_callback(callback, user_data));
+    return true;
+}
+
+MavsdkServerSubscription* mavsdk_server_subscribe(
+    MavsdkServer* mavsdk_server,
+    const char* method,
+    const uint8_t* request,
+    size_t request_size,
+    mavsdk_server_response_callback callback,
+    void* user_data)
+{
+    auto* client = mavsdk_server->inProcessClient();
+    if (client == nullptr) {
+        return nullptr;
+    }
+
+    return new MavsdkServerSubscription{client->subscribe(
+        std::string(method), request, request_size, to_response_callback(callback, user_data))};
+}
+
+void mavsdk_server_unsubscribe(MavsdkServerSubscription* subscription)
+{
+    delete subscription;
+}
+
 void mavsdk_server_attach(MavsdkServer* mavsdk_server)
 {
     mavsdk_server->wait();
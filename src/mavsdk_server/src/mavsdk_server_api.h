@@ -5,8 +5,10 @@ extern "C" {
 #endif
 
 #ifdef __cplusplus
+#include <cstddef>
 #include <cstdint>
 #else
+#include <stddef.h>
 #include <stdint.h>
 #endif
 
@@ -30,8 +32,54 @@ DLLExport int mavsdk_server_run_with_mavlink_ids(
     const uint8_t system_id,
     const uint8_t component_id);
 
+// Also listen on a Unix domain socket at path, call it before running the server.
+DLLExport void
+mavsdk_server_set_unix_socket_path(struct MavsdkServer* mavsdk_server, const char* path);
+
+// Serve Prometheus metrics over HTTP on port, call it before running the server.
+DLLExport void mavsdk_server_set_metrics_port(struct MavsdkServer* mavsdk_server, int port);
+
+// Only serve the services in the comma separated list, e.g. "action,telemetry",
+// instead of all of them. Call it before running the server.
+DLLExport void
+mavsdk_server_set_enabled_services(struct MavsdkServer* mavsdk_server, const char* services);
+
 DLLExport int mavsdk_server_get_port(struct MavsdkServer* mavsdk_server);
 
+// In-process calls to the services, instead of gRPC over a socket, once the server runs.
+// Requests and responses are the serialized protobuf messages, and method is the full
+// name of the RPC, e.g. "/mavsdk.rpc.action.ActionService/Arm".
+//
+// The callback gets each response, then data == NULL with the gRPC status code once the
+// call is over. The data is only valid during the callback, which is called on a gRPC
+// thread and should return quickly.
+typedef void (*mavsdk_server_response_callback)(
+    const uint8_t* data, size_t size, int status_code, void* user_data);
+
+struct MavsdkServerSubscription;
+
+// Makes a unary call, returns 0 if the server doesn't run.
+DLLExport int mavsdk_server_call(
+    struct MavsdkServer* mavsdk_server,
+    const char* method,
+    const uint8_t* request,
+    size_t request_size,
+    mavsdk_server_response_callback callback,
+    void* user_data);
+
+// Starts a server streaming call, returns NULL if the server doesn't run.
+DLLExport struct MavsdkServerSubscription* mavsdk_server_subscribe(
+    struct MavsdkServer* mavsdk_server,
+    const char* method,
+    const uint8_t* request,
+    size_t request_size,
+    mavsdk_server_response_callback callback,
+    void* user_data);
+
+// Cancels the call and waits until it is over, don't call it from its callback.
+// Every subscription has to be unsubscribed, also once it is over.
+DLLExport void mavsdk_server_unsubscribe(struct MavsdkServerSubscription* subscription);
+
 DLLExport void mavsdk_server_attach(struct MavsdkServer* mavsdk_server);
 
 DLLExport void mavsdk_server_stop(struct MavsdkServer* mavsdk_server);
@@ -19,6 +19,9 @@ int main(int argc, char** argv)
     int mavsdk_server_port = default_mavsdk_server_port;
     int mavsdk_sysid = default_sysid;
     int mavsdk_compid = default_compid;
+    std::string unix_socket_path;
+    int metrics_port = -1;
+    std::string enabled_services;
 
     for (int i = 1; i < argc; i++) {
         const std::string current_arg = argv[i];
@@ -81,6 +84,42 @@ int main(int argc, char** argv)
                 usage(argv[0]);
                 return 1;
             }
+        } else if (current_arg == "--unix-socket") {
+            if (argc <= i + 1) {
+                usage(argv[0]);
+                return 1;
+            }
+
+            unix_socket_path = argv[i + 1];
+            i++;
+        } else if (current_arg == "--metrics-port") {
+            if (argc <= i + 1) {
+                usage(argv[0]);
+                return 1;
+            }
+
+            const std::string port(argv[i + 1]);
+            i++;
+
+            if (!is_integer(port)) {
+                usage(argv[0]);
+                return 1;
+            }
+
+            metrics_port = std::stoi(port);
+
+            if (metrics_port > std::numeric_limits<uint16_t>::max()) {
+                usage(argv[0]);
+                return 1;
+            }
+        } else if (current_arg == "--services") {
+            if (argc <= i + 1) {
+                usage(argv[0]);
+                return 1;
+            }
+
+            enabled_services = argv[i + 1];
+            i++;
         } else {
             connection_url = current_arg;
         }
@@ -88,6 +127,19 @@ int main(int argc, char** argv)
 
     MavsdkServer* mavsdk_server;
     mavsdk_server_init(&mavsdk_server);
+
+    if (!unix_socket_path.empty()) {
+        mavsdk_server_set_unix_socket_path(mavsdk_server, unix_socket_path.c_str());
+    }
+
+    if (!enabled_services.empty()) {
+        mavsdk_server_set_enabled_services(mavsdk_server, enabled_services.c_str());
+    }
+
+    if (metrics_port >= 0) {
+        mavsdk_server_set_metrics_port(mavsdk_server, metrics_port);
+    }
+
     const auto is_started = mavsdk_server_run_with_mavlink_ids(
         mavsdk_server,
         connection_url.c_str(),
@@ -126,7 +178,13 @@ void usage(const char* bin_name)
               << "  --sysid     : set the MAVLink system ID of the MAVSDK server itself,\n"
               << "                (default is " << default_sysid << ", range 1..255)\n"
               << "  --compid    : set the MAVLink component ID of the MAVSDK server itself,\n"
-              << "                (default is " << default_compid << ", range 1..255)\n";
+              << "                (default is " << default_compid << ", range 1..255)\n"
+              << "  --unix-socket : also run the gRPC server on a Unix domain socket at the\n"
+              << "                given path, for clients on the same host\n"
+              << "  --metrics-port : serve Prometheus metrics over HTTP on the given port\n"
+              << "                at /metrics, set to 0 to choose a free port\n"
+              << "  --services  : only serve the given comma separated services, e.g.\n"
+              << "                action,telemetry (default is all of them)\n";
 }
 
 bool is_integer(const std::string& tested_integer)
@@ -0,0 +1,116 @@
+#include "metrics.h"
+
+#include <cmath>
+#include <sstream>
+
+namespace mavsdk {
+namespace mavsdk_server {
+
+namespace {
+
+const char* type_name(Metrics::Type type)
+{
+    switch (type) {
+        case Metrics::Type::Counter:
+            return "counter";
+        case Metrics::Type::Gauge:
+            return "gauge";
+        case Metrics::Type::Summary:
+            return "summary";
+    }
+    return "untyped";
+}
+
+std::string escape(const std::string& value)
+{
+    std::string result;
+    for (const char c : value) {
+        switch (c) {
+            case '\\':
+                result += "\\\\";
+                break;
+            case '"':
+                result += "\\\"";
+                break;
+            case '\n':
+                result += "\\n";
+                break;
+            default:
+                result += c;
+        }
+    }
+    return result;
+}
+
+void write_value(std::ostream& out, double value)
+{
+    // Counts are written as integers, without an exponent.
+    if (std::floor(value) == value && std::fabs(value) < 1e15) {
+        out << static_cast<int64_t>(value);
+    } else {
+        out << value;
+    }
+}
+
+} // namespace
+
+void Metrics::add_counter(
+    const std::string& name, const std::string& help, const Labels& labels, double value)
+{
+    family(name, Type::Counter, help).samples.push_back(Sample{"", labels, value});
+}
+
+void Metrics::add_gauge(
+    const std::string& name, const std::string& help, const Labels& labels, double value)
+{
+    family(name, Type::Gauge, help).samples.push_back(Sample{"", labels, value});
+}
+
+void Metrics::add_summary(
+    const std::string& name,
+    const std::string& help,
+    const Labels& labels,
+    double sum,
+    uint64_t count)
+{
+    auto& summary = family(name, Type::Summary, help);
+    summary.samples.push_back(Sample{"_sum", labels, sum});
+    summary.samples.push_back(Sample{"_count", labels, static_cast<double>(count)});
+}
+
+Metrics::Family& Metrics::family(const std::string& name, Type type, const std::string& help)
+{
+    auto it = _families.find(name);
+    if (it == _families.end()) {
+        it = _families.emplace(name, Family{type, help, {}}).first;
+    }
+    return it->second;
+}
+
+std::string Metrics::to_text() const
+{
+    std::ostringstream out;
+    for (const auto& [name, family] : _families) {
+        out << "# HELP " << name << ' ' << family.help << '\n';
+        out << "# TYPE " << name << ' ' << type_name(family.type) << '\n';
+
+        for (const auto& sample : family.samples) {
+            out << name << sample.suffix;
+            if (!sample.labels.empty()) {
+                out << '{';
+                for (size_t i = 0; i < sample.labels.size(); ++i) {
+                    out << (i > 0 ? "," : "") << sample.labels[i].first << "=\""
+                        << escape(sample.labels[i].second) << '"';
+                }
+                out << '}';
+            }
+            out << ' ';
+            write_value(out, sample.value);
+            out << '\n';
+        }
+    }
+    return out.str();
+}
+
+} // namespace mavsdk_server
+} // namespace mavsdk
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace mavsdk {
+namespace mavsdk_server {
+
+// The samples of one scrape, written out in the Prometheus text format.
+//
+// Samples can be added in any order, they are grouped by metric when written.
+class Metrics {
+public:
+    using Labels = std::vector<std::pair<std::string, std::string>>;
+
+    enum class Type {
+        Counter,
+        Gauge,
+        Summary,
+    };
+
+    void add_counter(
+        const std::string& name, const std::string& help, const Labels& labels, double value);
+    void
+    add_gauge(const std::string& name, const std::string& help, const Labels& labels, double value);
+    // A summary without quantiles, i.e. only its sum and count.
+    void add_summary(
+        const std::string& name,
+        const std::string& help,
+        const Labels& labels,
+        double sum,
+        uint64_t count);
+
+    std::string to_text() const;
+
+private:
+    struct Sample {
+        std::string suffix;
+        Labels labels;
+        double value;
+    };
+
+    struct Family {
+        Type type;
+        std::string help;
+        std::vector<Sample> samples;
+    };
+
+    Family& family(const std::string& name, Type type, const std::string& help);
+
+    std::map<std::string, Family> _families{};
+};
+
+} // namespace mavsdk_server
+} // namespace mavsdk
@@ -0,0 +1,197 @@
+#include "metrics_server.h"
+#include "log.h"
+
+#ifdef WINDOWS
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#ifndef MINGW
+#pragma comment(lib, "Ws2_32.lib") // Without this, Ws2_32.lib is not included in static library.
+#endif
+#else
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netinet/in.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <unistd.h> // for close()
+#endif
+
+#include <cstring>
+#include <string>
+#include <utility>
+
+#ifndef WINDOWS
+#define GET_ERROR(_x) strerror(_x)
+#else
+#define GET_ERROR(_x) WSAGetLastError()
+#endif
+
+namespace mavsdk {
+namespace mavsdk_server {
+
+namespace {
+
+// How often the server thread checks whether it should exit.
+constexpr long select_timeout_us = 200000;
+
+// Requests are small, anything beyond the request line is ignored anyway.
+constexpr size_t max_request_size = 4096;
+
+} // namespace
+
+MetricsServer::MetricsServer(Collect collect) : _collect(std::move(collect)) {}
+
+MetricsServer::~MetricsServer()
+{
+    stop();
+}
+
+int MetricsServer::start(int port)
+{
+#ifdef WINDOWS
+    WSADATA wsa;
+    if (WSAStartup(MAKEWORD(2, 2), &wsa) != 0) {
+        LogErr() << "Error: Winsock failed, error: " << WSAGetLastError();
+        return 0;
+    }
+#endif
+
+    _socket_fd = static_cast<int>(socket(AF_INET, SOCK_STREAM, 0));
+    if (_socket_fd < 0) {
+        LogErr() << "Could not create metrics socket: " << GET_ERROR(errno);
+        return 0;
+    }
+
+    const int enable = 1;
+    setsockopt(
+        _socket_fd,
+        SOL_SOCKET,
+        SO_REUSEADDR,
+        reinterpret_cast<const char*>(&enable),
+        sizeof(enable));
+
+    struct sockaddr_in addr {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons(static_cast<uint16_t>(port));
+
+    if (bind(_socket_fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        listen(_socket_fd, 8) != 0) {
+        LogErr() << "Could not bind metrics server to port " << port << ": "
+                 << GET_ERROR(errno);
+        close_socket(_socket_fd);
+        _socket_fd = -1;
+        return 0;
+    }
+
+    socklen_t addr_len = sizeof(addr);
+    if (getsockname(_socket_fd, reinterpret_cast<sockaddr*>(&addr), &addr_len) != 0) {
+        LogErr() << "Could not get metrics port: " << GET_ERROR(errno);
+        close_socket(_socket_fd);
+        _socket_fd = -1;
+        return 0;
+    }
+    const int bound_port = ntohs(addr.sin_port);
+
+    _should_exit = false;
+    _thread = std::thread(&MetricsServer::serve, this);
+
+    LogInfo() << "Metrics served on 0.0.0.0:" << bound_port << "/metrics";
+    return bound_port;
+}
+
+void MetricsServer::stop()
+{
+    _should_exit = true;
+    if (_thread.joinable()) {
+        _thread.join();
+    }
+
+    if (_socket_fd >= 0) {
+        close_socket(_socket_fd);
+        _socket_fd = -1;
+    }
+}
+
+void MetricsServer::serve()
+{
+    while (!_should_exit) {
+        fd_set read_fds;
+        FD_ZERO(&read_fds);
+        FD_SET(_socket_fd, &read_fds);
+
+        struct timeval timeout {};
+        timeout.tv_sec = 0;
+        timeout.tv_usec = select_timeout_us;
+
+        if (select(_socket_fd + 1, &read_fds, nullptr, nullptr, &timeout) <= 0) {
+            continue;
+        }
+
+        const auto client_fd = static_cast<int>(accept(_socket_fd, nullptr, nullptr));
+        if (client_fd < 0) {
+            continue;
+        }
+
+        respond(client_fd);
+        close_socket(client_fd);
+    }
+}
+
+void MetricsServer::respond(int client_fd)
+{
+    // The request line is enough to tell what is asked for.
+    std::string request;
+    char buffer[512];
+    while (request.find("\r\n") == std::string::npos && request.size() < max_request_size) {
+        const auto received = recv(client_fd, buffer, sizeof(buffer), 0);
+        if (received <= 0) {
+            return;
+        }
+        request.append(buffer, static_cast<size_t>(received));
+    }
+
+    std::string status;
+    std::string body;
+    if (request.rfind("GET /metrics ", 0) == 0 || request.rfind("GET /metrics?", 0) == 0) {
+        status = "200 OK";
+        body = _collect();
+    } else {
+        status = "404 Not Found";
+        body = "Only /metrics is served\n";
+    }
+
+    const std::string response = "HTTP/1.1 " + status +
+                                 "\r\n"
+                                 "Content-Type: text/plain; version=0.0.4\r\n"
+                                 "Content-Length: " +
+                                 std::to_string(body.size()) +
+                                 "\r\n"
+                                 "Connection: close\r\n"
+                                 "\r\n" +
+                                 body;
+
+    size_t sent = 0;
+    while (sent < response.size()) {
+        const auto result = send(
+            client_fd, response.data() + sent, static_cast<int>(response.size() - sent), 0);
+        if (result <= 0) {
+            return;
+        }
+        sent += static_cast<size_t>(result);
+    }
+}
+
+void MetricsServer::close_socket(int fd)
+{
+#ifndef WINDOWS
+    shutdown(fd, SHUT_RDWR);
+    close(fd);
+#else
+    shutdown(fd, SD_BOTH);
+    closesocket(fd);
+#endif
+}
+
+} // namespace mavsdk_server
+} // namespace mavsdk
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <string>
+#include <thread>
+
+namespace mavsdk {
+namespace mavsdk_server {
+
+// Minimal HTTP server answering GET /metrics, for Prometheus to scrape.
+//
+// Requests are answered one after the other on its own thread, which is
+// plenty for the occasional scrape.
+class MetricsServer {
+public:
+    // Collects the metrics in the text format, called for every scrape.
+    using Collect = std::function<std::string()>;
+
+    explicit MetricsServer(Collect collect);
+    ~MetricsServer();
+
+    // Returns the port listened on, 0 if it failed. Port 0 picks a free one.
+    int start(int port);
+    void stop();
+
+    // Non-copyable
+    MetricsServer(const MetricsServer&) = delete;
+    const MetricsServer& operator=(const MetricsServer&) = delete;
+
+private:
+    void serve();
+    void respond(int client_fd);
+    void close_socket(int fd);
+
+    const Collect _collect;
+
+    int _socket_fd{-1};
+    std::atomic<bool> _should_exit{false};
+    std::thread _thread{};
+};
+
+} // namespace mavsdk_server
+} // namespace mavsdk
@@ -10,6 +10,8 @@
 #include "lazy_plugin.h"
 
 #include "log.h"
+#include "stream_reactor.h"
+#include "system_selection.h"
 #include <atomic>
 #include <cmath>
 #include <future>
@@ -23,7 +25,7 @@ namespace mavsdk_server {
 
 template<typename Action = Action, typename LazyPlugin = LazyPlugin<Action>>
 
-class ActionServiceImpl final : public rpc::action::ActionService::Service {
+class ActionServiceImpl final : public WithCallbackMethods<rpc::action::ActionService::Service> {
 public:
     ActionServiceImpl(LazyPlugin& lazy_plugin) : _lazy_plugin(lazy_plugin) {}
 
@@ -32,13 +34,11 @@ public:
     {
         auto rpc_result = translateToRpcResult(result);
 
-        auto* rpc_action_result = new rpc::action::ActionResult();
+        auto* rpc_action_result = response->mutable_action_result();
         rpc_action_result->set_result(rpc_result);
         std::stringstream ss;
         ss << result;
         rpc_action_result->set_result_str(ss.str());
-
-        response->set_allocated_action_result(rpc_action_result);
     }
 
     static rpc::action::OrbitYawBehavior
@@ -160,11 +160,13 @@ public:
     }
 
     grpc::Status
-    Arm(grpc::ServerContext* /* context */,
+    Arm(grpc::ServerContext* context,
         const rpc::action::ArmRequest* /* request */,
         rpc::action::ArmResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Action::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -173,7 +175,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->arm();
+        auto result = plugin->arm();
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -183,11 +185,13 @@ public:
     }
 
     grpc::Status Disarm(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::action::DisarmRequest* /* request */,
         rpc::action::DisarmResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Action::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -196,7 +200,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->disarm();
+        auto result = plugin->disarm();
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -206,11 +210,13 @@ public:
     }
 
     grpc::Status Takeoff(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::action::TakeoffRequest* /* request */,
         rpc::action::TakeoffResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Action::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -219,7 +225,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->takeoff();
+        auto result = plugin->takeoff();
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -229,11 +235,13 @@ public:
     }
 
     grpc::Status Land(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::action::LandRequest* /* request */,
         rpc::action::LandResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Action::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -242,7 +250,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->land();
+        auto result = plugin->land();
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -252,11 +260,13 @@ public:
     }
 
     grpc::Status Reboot(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::action::RebootRequest* /* request */,
         rpc::action::RebootResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Action::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -265,7 +275,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->reboot();
+        auto result = plugin->reboot();
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -275,11 +285,13 @@ public:
     }
 
     grpc::Status Shutdown(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::action::ShutdownRequest* /* request */,
         rpc::action::ShutdownResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Action::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -288,7 +300,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->shutdown();
+        auto result = plugin->shutdown();
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -298,11 +310,13 @@ public:
     }
 
     grpc::Status Terminate(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::action::TerminateRequest* /* request */,
         rpc::action::TerminateResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Action::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -311,7 +325,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->terminate();
+        auto result = plugin->terminate();
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -321,11 +335,13 @@ public:
     }
 
     grpc::Status Kill(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::action::KillRequest* /* request */,
         rpc::action::KillResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Action::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -334,7 +350,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->kill();
+        auto result = plugin->kill();
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -344,11 +360,13 @@ public:
     }
 
     grpc::Status ReturnToLaunch(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::action::ReturnToLaunchRequest* /* request */,
         rpc::action::ReturnToLaunchResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Action::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -357,7 +375,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->return_to_launch();
+        auto result = plugin->return_to_launch();
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -367,11 +385,13 @@ public:
     }
 
     grpc::Status GotoLocation(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::action::GotoLocationRequest* request,
         rpc::action::GotoLocationResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Action::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -385,7 +405,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->goto_location(
+        auto result = plugin->goto_location(
             request->latitude_deg(),
             request->longitude_deg(),
             request->absolute_altitude_m(),
@@ -399,11 +419,13 @@ public:
     }
 
     grpc::Status DoOrbit(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::action::DoOrbitRequest* request,
         rpc::action::DoOrbitResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Action::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -417,7 +439,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->do_orbit(
+        auto result = plugin->do_orbit(
             request->radius_m(),
             request->velocity_ms(),
             translateFromRpcOrbitYawBehavior(request->yaw_behavior()),
@@ -433,11 +455,13 @@ public:
     }
 
     grpc::Status Hold(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::action::HoldRequest* /* request */,
         rpc::action::HoldResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Action::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -446,7 +470,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->hold();
+        auto result = plugin->hold();
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -456,11 +480,13 @@ public:
     }
 
     grpc::Status SetActuator(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::action::SetActuatorRequest* request,
         rpc::action::SetActuatorResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Action::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -474,7 +500,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->set_actuator(request->index(), request->value());
+        auto result = plugin->set_actuator(request->index(), request->value());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -484,11 +510,13 @@ public:
     }
 
     grpc::Status TransitionToFixedwing(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::action::TransitionToFixedwingRequest* /* request */,
         rpc::action::TransitionToFixedwingResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Action::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -497,7 +525,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->transition_to_fixedwing();
+        auto result = plugin->transition_to_fixedwing();
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -507,11 +535,13 @@ public:
     }
 
     grpc::Status TransitionToMulticopter(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::action::TransitionToMulticopterRequest* /* request */,
         rpc::action::TransitionToMulticopterResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Action::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -520,7 +550,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->transition_to_multicopter();
+        auto result = plugin->transition_to_multicopter();
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -530,11 +560,13 @@ public:
     }
 
     grpc::Status GetTakeoffAltitude(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::action::GetTakeoffAltitudeRequest* /* request */,
         rpc::action::GetTakeoffAltitudeResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Action::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -543,7 +575,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->get_takeoff_altitude();
+        auto result = plugin->get_takeoff_altitude();
 
         if (response != nullptr) {
             fillResponseWithResult(response, result.first);
@@ -555,11 +587,13 @@ public:
     }
 
     grpc::Status SetTakeoffAltitude(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::action::SetTakeoffAltitudeRequest* request,
         rpc::action::SetTakeoffAltitudeResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Action::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -573,7 +607,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->set_takeoff_altitude(request->altitude());
+        auto result = plugin->set_takeoff_altitude(request->altitude());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -583,11 +617,13 @@ public:
     }
 
     grpc::Status GetMaximumSpeed(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::action::GetMaximumSpeedRequest* /* request */,
         rpc::action::GetMaximumSpeedResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Action::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -596,7 +632,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->get_maximum_speed();
+        auto result = plugin->get_maximum_speed();
 
         if (response != nullptr) {
             fillResponseWithResult(response, result.first);
@@ -608,11 +644,13 @@ public:
     }
 
     grpc::Status SetMaximumSpeed(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::action::SetMaximumSpeedRequest* request,
         rpc::action::SetMaximumSpeedResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Action::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -626,7 +664,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->set_maximum_speed(request->speed());
+        auto result = plugin->set_maximum_speed(request->speed());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -636,11 +674,13 @@ public:
     }
 
     grpc::Status GetReturnToLaunchAltitude(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::action::GetReturnToLaunchAltitudeRequest* /* request */,
         rpc::action::GetReturnToLaunchAltitudeResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Action::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -649,7 +689,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->get_return_to_launch_altitude();
+        auto result = plugin->get_return_to_launch_altitude();
 
         if (response != nullptr) {
             fillResponseWithResult(response, result.first);
@@ -661,11 +701,13 @@ public:
     }
 
     grpc::Status SetReturnToLaunchAltitude(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::action::SetReturnToLaunchAltitudeRequest* request,
         rpc::action::SetReturnToLaunchAltitudeResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Action::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -679,7 +721,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->set_return_to_launch_altitude(
+        auto result = plugin->set_return_to_launch_altitude(
             request->relative_altitude_m());
 
         if (response != nullptr) {
@@ -690,11 +732,13 @@ public:
     }
 
     grpc::Status SetCurrentSpeed(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::action::SetCurrentSpeedRequest* request,
         rpc::action::SetCurrentSpeedResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Action::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -708,7 +752,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->set_current_speed(request->speed_m_s());
+        auto result = plugin->set_current_speed(request->speed_m_s());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -717,45 +761,14 @@ public:
         return grpc::Status::OK;
     }
 
-    void stop()
-    {
-        _stopped.store(true);
-        for (auto& prom : _stream_stop_promises) {
-            if (auto handle = prom.lock()) {
-                handle->set_value();
-            }
-        }
-    }
+    void stop() { _streams.finish_all(); }
 
-private:
-    void register_stream_stop_promise(std::weak_ptr<std::promise<void>> prom)
-    {
-        // If we have already stopped, set promise immediately and don't add it to list.
-        if (_stopped.load()) {
-            if (auto handle = prom.lock()) {
-                handle->set_value();
-            }
-        } else {
-            _stream_stop_promises.push_back(prom);
-        }
-    }
-
-    void unregister_stream_stop_promise(std::shared_ptr<std::promise<void>> prom)
-    {
-        for (auto it = _stream_stop_promises.begin(); it != _stream_stop_promises.end();
-             /* ++it */) {
-            if (it->lock() == prom) {
-                it = _stream_stop_promises.erase(it);
-            } else {
-                ++it;
-            }
-        }
-    }
+    const StreamStats& stream_stats() const { return _streams.stats(); }
 
+private:
     LazyPlugin& _lazy_plugin;
 
-    std::atomic<bool> _stopped{false};
-    std::vector<std::weak_ptr<std::promise<void>>> _stream_stop_promises{};
+    StreamList _streams{};
 };
 
 } // namespace mavsdk_server
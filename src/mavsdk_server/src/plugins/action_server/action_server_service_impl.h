@@ -11,6 +11,8 @@
 #include "lazy_server_plugin.h"
 
 #include "log.h"
+#include "stream_reactor.h"
+#include "system_selection.h"
 #include <atomic>
 #include <cmath>
 #include <future>
@@ -26,7 +28,16 @@ template<
     typename ActionServer = ActionServer,
     typename LazyServerPlugin = LazyServerPlugin<ActionServer>>
 
-class ActionServerServiceImpl final : public rpc::action_server::ActionServerService::Service {
+class ActionServerServiceImpl final
+    : public WithCallbackMethods<
+          rpc::action_server::ActionServerService::Service,
+          rpc::action_server::ActionServerService::WithCallbackMethod_SubscribeArmDisarm,
+          rpc::action_server::ActionServerService::WithCallbackMethod_SubscribeFlightModeChange,
+          rpc::action_server::ActionServerService::WithCallbackMethod_SubscribeTakeoff,
+          rpc::action_server::ActionServerService::WithCallbackMethod_SubscribeLand,
+          rpc::action_server::ActionServerService::WithCallbackMethod_SubscribeReboot,
+          rpc::action_server::ActionServerService::WithCallbackMethod_SubscribeShutdown,
+          rpc::action_server::ActionServerService::WithCallbackMethod_SubscribeTerminate> {
 public:
     ActionServerServiceImpl(LazyServerPlugin& lazy_plugin) : _lazy_plugin(lazy_plugin) {}
 
@@ -35,13 +46,11 @@ public:
     {
         auto rpc_result = translateToRpcResult(result);
 
-        auto* rpc_action_server_result = new rpc::action_server::ActionServerResult();
+        auto* rpc_action_server_result = response->mutable_action_server_result();
         rpc_action_server_result->set_result(rpc_result);
         std::stringstream ss;
         ss << result;
         rpc_action_server_result->set_result_str(ss.str());
-
-        response->set_allocated_action_server_result(rpc_action_server_result);
     }
 
     static rpc::action_server::FlightMode
@@ -120,19 +129,15 @@ public:
         }
     }
 
-    static std::unique_ptr<rpc::action_server::AllowableFlightModes>
-    translateToRpcAllowableFlightModes(
-        const mavsdk::ActionServer::AllowableFlightModes& allowable_flight_modes)
+    static void translateToRpcAllowableFlightModes(
+        const mavsdk::ActionServer::AllowableFlightModes& allowable_flight_modes,
+        rpc::action_server::AllowableFlightModes* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::action_server::AllowableFlightModes>();
-
         rpc_obj->set_can_auto_mode(allowable_flight_modes.can_auto_mode);
 
         rpc_obj->set_can_guided_mode(allowable_flight_modes.can_guided_mode);
 
         rpc_obj->set_can_stabilize_mode(allowable_flight_modes.can_stabilize_mode);
-
-        return rpc_obj;
     }
 
     static mavsdk::ActionServer::AllowableFlightModes translateFromRpcAllowableFlightModes(
@@ -149,16 +154,12 @@ public:
         return obj;
     }
 
-    static std::unique_ptr<rpc::action_server::ArmDisarm>
-    translateToRpcArmDisarm(const mavsdk::ActionServer::ArmDisarm& arm_disarm)
+    static void translateToRpcArmDisarm(
+        const mavsdk::ActionServer::ArmDisarm& arm_disarm, rpc::action_server::ArmDisarm* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::action_server::ArmDisarm>();
-
         rpc_obj->set_arm(arm_disarm.arm);
 
         rpc_obj->set_force(arm_disarm.force);
-
-        return rpc_obj;
     }
 
     static mavsdk::ActionServer::ArmDisarm
@@ -251,89 +252,78 @@ public:
         }
     }
 
-    grpc::Status SubscribeArmDisarm(
-        grpc::ServerContext* /* context */,
-        const mavsdk::rpc::action_server::SubscribeArmDisarmRequest* /* request */,
-        grpc::ServerWriter<rpc::action_server::ArmDisarmResponse>* writer) override
+    grpc::ServerWriteReactor<rpc::action_server::ArmDisarmResponse>* SubscribeArmDisarm(
+        grpc::CallbackServerContext* context,
+        const mavsdk::rpc::action_server::SubscribeArmDisarmRequest* /* request */) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        auto reactor = StreamReactor<rpc::action_server::ArmDisarmResponse>::create();
+
+        if (plugin == nullptr) {
             rpc::action_server::ArmDisarmResponse rpc_response;
 
             // For server plugins, this should never happen, they should always be constructible.
             auto result = mavsdk::ActionServer::Result::Unknown;
             fillResponseWithResult(&rpc_response, result);
-            writer->Write(rpc_response);
+            reactor->write(std::move(rpc_response));
 
-            return grpc::Status::OK;
+            reactor->finish();
+            return reactor.get();
         }
 
-        auto stream_closed_promise = std::make_shared<std::promise<void>>();
-        auto stream_closed_future = stream_closed_promise->get_future();
-        register_stream_stop_promise(stream_closed_promise);
-
-        auto is_finished = std::make_shared<bool>(false);
-        auto subscribe_mutex = std::make_shared<std::mutex>();
+        _streams.add(reactor);
 
         const mavsdk::ActionServer::ArmDisarmHandle handle =
-            _lazy_plugin.maybe_plugin()->subscribe_arm_disarm(
-                [this, &writer, &stream_closed_promise, is_finished, subscribe_mutex, &handle](
+            plugin->subscribe_arm_disarm(
+                [reactor](
                     mavsdk::ActionServer::Result result,
                     const mavsdk::ActionServer::ArmDisarm arm_disarm) {
                     rpc::action_server::ArmDisarmResponse rpc_response;
 
-                    rpc_response.set_allocated_arm(translateToRpcArmDisarm(arm_disarm).release());
+                    translateToRpcArmDisarm(arm_disarm, rpc_response.mutable_arm());
 
                     auto rpc_result = translateToRpcResult(result);
-                    auto* rpc_action_server_result = new rpc::action_server::ActionServerResult();
+                    auto* rpc_action_server_result = rpc_response.mutable_action_server_result();
                     rpc_action_server_result->set_result(rpc_result);
                     std::stringstream ss;
                     ss << result;
                     rpc_action_server_result->set_result_str(ss.str());
-                    rpc_response.set_allocated_action_server_result(rpc_action_server_result);
 
-                    std::unique_lock<std::mutex> lock(*subscribe_mutex);
-                    if (!*is_finished && !writer->Write(rpc_response)) {
-                        _lazy_plugin.maybe_plugin()->unsubscribe_arm_disarm(handle);
-
-                        *is_finished = true;
-                        unregister_stream_stop_promise(stream_closed_promise);
-                        stream_closed_promise->set_value();
-                    }
+                    reactor->write(std::move(rpc_response));
                 });
 
-        stream_closed_future.wait();
-        std::unique_lock<std::mutex> lock(*subscribe_mutex);
-        *is_finished = true;
+        reactor->set_on_done([plugin, handle]() { plugin->unsubscribe_arm_disarm(handle); });
 
-        return grpc::Status::OK;
+        return reactor.get();
     }
 
-    grpc::Status SubscribeFlightModeChange(
-        grpc::ServerContext* /* context */,
-        const mavsdk::rpc::action_server::SubscribeFlightModeChangeRequest* /* request */,
-        grpc::ServerWriter<rpc::action_server::FlightModeChangeResponse>* writer) override
+    grpc::ServerWriteReactor<rpc::action_server::FlightModeChangeResponse>*
+    SubscribeFlightModeChange(
+        grpc::CallbackServerContext* context,
+        const mavsdk::rpc::action_server::SubscribeFlightModeChangeRequest* /* request */) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        auto reactor = StreamReactor<rpc::action_server::FlightModeChangeResponse>::create();
+
+        if (plugin == nullptr) {
             rpc::action_server::FlightModeChangeResponse rpc_response;
 
             // For server plugins, this should never happen, they should always be constructible.
             auto result = mavsdk::ActionServer::Result::Unknown;
             fillResponseWithResult(&rpc_response, result);
-            writer->Write(rpc_response);
+            reactor->write(std::move(rpc_response));
 
-            return grpc::Status::OK;
+            reactor->finish();
+            return reactor.get();
         }
 
-        auto stream_closed_promise = std::make_shared<std::promise<void>>();
-        auto stream_closed_future = stream_closed_promise->get_future();
-        register_stream_stop_promise(stream_closed_promise);
-
-        auto is_finished = std::make_shared<bool>(false);
-        auto subscribe_mutex = std::make_shared<std::mutex>();
+        _streams.add(reactor);
 
         const mavsdk::ActionServer::FlightModeChangeHandle handle =
-            _lazy_plugin.maybe_plugin()->subscribe_flight_mode_change(
-                [this, &writer, &stream_closed_promise, is_finished, subscribe_mutex, &handle](
+            plugin->subscribe_flight_mode_change(
+                [reactor](
                     mavsdk::ActionServer::Result result,
                     const mavsdk::ActionServer::FlightMode flight_mode_change) {
                     rpc::action_server::FlightModeChangeResponse rpc_response;
@@ -341,315 +331,248 @@ public:
                     rpc_response.set_flight_mode(translateToRpcFlightMode(flight_mode_change));
 
                     auto rpc_result = translateToRpcResult(result);
-                    auto* rpc_action_server_result = new rpc::action_server::ActionServerResult();
+                    auto* rpc_action_server_result = rpc_response.mutable_action_server_result();
                     rpc_action_server_result->set_result(rpc_result);
                     std::stringstream ss;
                     ss << result;
                     rpc_action_server_result->set_result_str(ss.str());
-                    rpc_response.set_allocated_action_server_result(rpc_action_server_result);
 
-                    std::unique_lock<std::mutex> lock(*subscribe_mutex);
-                    if (!*is_finished && !writer->Write(rpc_response)) {
-                        _lazy_plugin.maybe_plugin()->unsubscribe_flight_mode_change(handle);
-
-                        *is_finished = true;
-                        unregister_stream_stop_promise(stream_closed_promise);
-                        stream_closed_promise->set_value();
-                    }
+                    reactor->write(std::move(rpc_response));
                 });
 
-        stream_closed_future.wait();
-        std::unique_lock<std::mutex> lock(*subscribe_mutex);
-        *is_finished = true;
+        reactor->set_on_done(
+            [plugin, handle]() { plugin->unsubscribe_flight_mode_change(handle); });
 
-        return grpc::Status::OK;
+        return reactor.get();
     }
 
-    grpc::Status SubscribeTakeoff(
-        grpc::ServerContext* /* context */,
-        const mavsdk::rpc::action_server::SubscribeTakeoffRequest* /* request */,
-        grpc::ServerWriter<rpc::action_server::TakeoffResponse>* writer) override
+    grpc::ServerWriteReactor<rpc::action_server::TakeoffResponse>* SubscribeTakeoff(
+        grpc::CallbackServerContext* context,
+        const mavsdk::rpc::action_server::SubscribeTakeoffRequest* /* request */) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        auto reactor = StreamReactor<rpc::action_server::TakeoffResponse>::create();
+
+        if (plugin == nullptr) {
             rpc::action_server::TakeoffResponse rpc_response;
 
             // For server plugins, this should never happen, they should always be constructible.
             auto result = mavsdk::ActionServer::Result::Unknown;
             fillResponseWithResult(&rpc_response, result);
-            writer->Write(rpc_response);
+            reactor->write(std::move(rpc_response));
 
-            return grpc::Status::OK;
+            reactor->finish();
+            return reactor.get();
         }
 
-        auto stream_closed_promise = std::make_shared<std::promise<void>>();
-        auto stream_closed_future = stream_closed_promise->get_future();
-        register_stream_stop_promise(stream_closed_promise);
-
-        auto is_finished = std::make_shared<bool>(false);
-        auto subscribe_mutex = std::make_shared<std::mutex>();
+        _streams.add(reactor);
 
         const mavsdk::ActionServer::TakeoffHandle handle =
-            _lazy_plugin.maybe_plugin()->subscribe_takeoff(
-                [this, &writer, &stream_closed_promise, is_finished, subscribe_mutex, &handle](
-                    mavsdk::ActionServer::Result result, const bool takeoff) {
+            plugin->subscribe_takeoff(
+                [reactor](mavsdk::ActionServer::Result result, const bool takeoff) {
                     rpc::action_server::TakeoffResponse rpc_response;
 
                     rpc_response.set_takeoff(takeoff);
 
                     auto rpc_result = translateToRpcResult(result);
-                    auto* rpc_action_server_result = new rpc::action_server::ActionServerResult();
+                    auto* rpc_action_server_result = rpc_response.mutable_action_server_result();
                     rpc_action_server_result->set_result(rpc_result);
                     std::stringstream ss;
                     ss << result;
                     rpc_action_server_result->set_result_str(ss.str());
-                    rpc_response.set_allocated_action_server_result(rpc_action_server_result);
-
-                    std::unique_lock<std::mutex> lock(*subscribe_mutex);
-                    if (!*is_finished && !writer->Write(rpc_response)) {
-                        _lazy_plugin.maybe_plugin()->unsubscribe_takeoff(handle);
 
-                        *is_finished = true;
-                        unregister_stream_stop_promise(stream_closed_promise);
-                        stream_closed_promise->set_value();
-                    }
+                    reactor->write(std::move(rpc_response));
                 });
 
-        stream_closed_future.wait();
-        std::unique_lock<std::mutex> lock(*subscribe_mutex);
-        *is_finished = true;
+        reactor->set_on_done([plugin, handle]() { plugin->unsubscribe_takeoff(handle); });
 
-        return grpc::Status::OK;
+        return reactor.get();
     }
 
-    grpc::Status SubscribeLand(
-        grpc::ServerContext* /* context */,
-        const mavsdk::rpc::action_server::SubscribeLandRequest* /* request */,
-        grpc::ServerWriter<rpc::action_server::LandResponse>* writer) override
+    grpc::ServerWriteReactor<rpc::action_server::LandResponse>* SubscribeLand(
+        grpc::CallbackServerContext* context,
+        const mavsdk::rpc::action_server::SubscribeLandRequest* /* request */) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        auto reactor = StreamReactor<rpc::action_server::LandResponse>::create();
+
+        if (plugin == nullptr) {
             rpc::action_server::LandResponse rpc_response;
 
             // For server plugins, this should never happen, they should always be constructible.
             auto result = mavsdk::ActionServer::Result::Unknown;
             fillResponseWithResult(&rpc_response, result);
-            writer->Write(rpc_response);
+            reactor->write(std::move(rpc_response));
 
-            return grpc::Status::OK;
+            reactor->finish();
+            return reactor.get();
         }
 
-        auto stream_closed_promise = std::make_shared<std::promise<void>>();
-        auto stream_closed_future = stream_closed_promise->get_future();
-        register_stream_stop_promise(stream_closed_promise);
+        _streams.add(reactor);
 
-        auto is_finished = std::make_shared<bool>(false);
-        auto subscribe_mutex = std::make_shared<std::mutex>();
-
-        const mavsdk::ActionServer::LandHandle handle = _lazy_plugin.maybe_plugin()->subscribe_land(
-            [this, &writer, &stream_closed_promise, is_finished, subscribe_mutex, &handle](
-                mavsdk::ActionServer::Result result, const bool land) {
+        const mavsdk::ActionServer::LandHandle handle = plugin->subscribe_land(
+            [reactor](mavsdk::ActionServer::Result result, const bool land) {
                 rpc::action_server::LandResponse rpc_response;
 
                 rpc_response.set_land(land);
 
                 auto rpc_result = translateToRpcResult(result);
-                auto* rpc_action_server_result = new rpc::action_server::ActionServerResult();
+                auto* rpc_action_server_result = rpc_response.mutable_action_server_result();
                 rpc_action_server_result->set_result(rpc_result);
                 std::stringstream ss;
                 ss << result;
                 rpc_action_server_result->set_result_str(ss.str());
-                rpc_response.set_allocated_action_server_result(rpc_action_server_result);
-
-                std::unique_lock<std::mutex> lock(*subscribe_mutex);
-                if (!*is_finished && !writer->Write(rpc_response)) {
-                    _lazy_plugin.maybe_plugin()->unsubscribe_land(handle);
 
-                    *is_finished = true;
-                    unregister_stream_stop_promise(stream_closed_promise);
-                    stream_closed_promise->set_value();
-                }
+                reactor->write(std::move(rpc_response));
             });
 
-        stream_closed_future.wait();
-        std::unique_lock<std::mutex> lock(*subscribe_mutex);
-        *is_finished = true;
+        reactor->set_on_done([plugin, handle]() { plugin->unsubscribe_land(handle); });
 
-        return grpc::Status::OK;
+        return reactor.get();
     }
 
-    grpc::Status SubscribeReboot(
-        grpc::ServerContext* /* context */,
-        const mavsdk::rpc::action_server::SubscribeRebootRequest* /* request */,
-        grpc::ServerWriter<rpc::action_server::RebootResponse>* writer) override
+    grpc::ServerWriteReactor<rpc::action_server::RebootResponse>* SubscribeReboot(
+        grpc::CallbackServerContext* context,
+        const mavsdk::rpc::action_server::SubscribeRebootRequest* /* request */) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        auto reactor = StreamReactor<rpc::action_server::RebootResponse>::create();
+
+        if (plugin == nullptr) {
             rpc::action_server::RebootResponse rpc_response;
 
             // For server plugins, this should never happen, they should always be constructible.
             auto result = mavsdk::ActionServer::Result::Unknown;
             fillResponseWithResult(&rpc_response, result);
-            writer->Write(rpc_response);
+            reactor->write(std::move(rpc_response));
 
-            return grpc::Status::OK;
+            reactor->finish();
+            return reactor.get();
         }
 
-        auto stream_closed_promise = std::make_shared<std::promise<void>>();
-        auto stream_closed_future = stream_closed_promise->get_future();
-        register_stream_stop_promise(stream_closed_promise);
-
-        auto is_finished = std::make_shared<bool>(false);
-        auto subscribe_mutex = std::make_shared<std::mutex>();
+        _streams.add(reactor);
 
         const mavsdk::ActionServer::RebootHandle handle =
-            _lazy_plugin.maybe_plugin()->subscribe_reboot(
-                [this, &writer, &stream_closed_promise, is_finished, subscribe_mutex, &handle](
-                    mavsdk::ActionServer::Result result, const bool reboot) {
+            plugin->subscribe_reboot(
+                [reactor](mavsdk::ActionServer::Result result, const bool reboot) {
                     rpc::action_server::RebootResponse rpc_response;
 
                     rpc_response.set_reboot(reboot);
 
                     auto rpc_result = translateToRpcResult(result);
-                    auto* rpc_action_server_result = new rpc::action_server::ActionServerResult();
+                    auto* rpc_action_server_result = rpc_response.mutable_action_server_result();
                     rpc_action_server_result->set_result(rpc_result);
                     std::stringstream ss;
                     ss << result;
                     rpc_action_server_result->set_result_str(ss.str());
-                    rpc_response.set_allocated_action_server_result(rpc_action_server_result);
-
-                    std::unique_lock<std::mutex> lock(*subscribe_mutex);
-                    if (!*is_finished && !writer->Write(rpc_response)) {
-                        _lazy_plugin.maybe_plugin()->unsubscribe_reboot(handle);
 
-                        *is_finished = true;
-                        unregister_stream_stop_promise(stream_closed_promise);
-                        stream_closed_promise->set_value();
-                    }
+                    reactor->write(std::move(rpc_response));
                 });
 
-        stream_closed_future.wait();
-        std::unique_lock<std::mutex> lock(*subscribe_mutex);
-        *is_finished = true;
+        reactor->set_on_done([plugin, handle]() { plugin->unsubscribe_reboot(handle); });
 
-        return grpc::Status::OK;
+        return reactor.get();
     }
 
-    grpc::Status SubscribeShutdown(
-        grpc::ServerContext* /* context */,
-        const mavsdk::rpc::action_server::SubscribeShutdownRequest* /* request */,
-        grpc::ServerWriter<rpc::action_server::ShutdownResponse>* writer) override
+    grpc::ServerWriteReactor<rpc::action_server::ShutdownResponse>* SubscribeShutdown(
+        grpc::CallbackServerContext* context,
+        const mavsdk::rpc::action_server::SubscribeShutdownRequest* /* request */) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        auto reactor = StreamReactor<rpc::action_server::ShutdownResponse>::create();
+
+        if (plugin == nullptr) {
             rpc::action_server::ShutdownResponse rpc_response;
 
             // For server plugins, this should never happen, they should always be constructible.
             auto result = mavsdk::ActionServer::Result::Unknown;
             fillResponseWithResult(&rpc_response, result);
-            writer->Write(rpc_response);
+            reactor->write(std::move(rpc_response));
 
-            return grpc::Status::OK;
+            reactor->finish();
+            return reactor.get();
         }
 
-        auto stream_closed_promise = std::make_shared<std::promise<void>>();
-        auto stream_closed_future = stream_closed_promise->get_future();
-        register_stream_stop_promise(stream_closed_promise);
-
-        auto is_finished = std::make_shared<bool>(false);
-        auto subscribe_mutex = std::make_shared<std::mutex>();
+        _streams.add(reactor);
 
         const mavsdk::ActionServer::ShutdownHandle handle =
-            _lazy_plugin.maybe_plugin()->subscribe_shutdown(
-                [this, &writer, &stream_closed_promise, is_finished, subscribe_mutex, &handle](
-                    mavsdk::ActionServer::Result result, const bool shutdown) {
+            plugin->subscribe_shutdown(
+                [reactor](mavsdk::ActionServer::Result result, const bool shutdown) {
                     rpc::action_server::ShutdownResponse rpc_response;
 
                     rpc_response.set_shutdown(shutdown);
 
                     auto rpc_result = translateToRpcResult(result);
-                    auto* rpc_action_server_result = new rpc::action_server::ActionServerResult();
+                    auto* rpc_action_server_result = rpc_response.mutable_action_server_result();
                     rpc_action_server_result->set_result(rpc_result);
                     std::stringstream ss;
                     ss << result;
                     rpc_action_server_result->set_result_str(ss.str());
-                    rpc_response.set_allocated_action_server_result(rpc_action_server_result);
 
-                    std::unique_lock<std::mutex> lock(*subscribe_mutex);
-                    if (!*is_finished && !writer->Write(rpc_response)) {
-                        _lazy_plugin.maybe_plugin()->unsubscribe_shutdown(handle);
-
-                        *is_finished = true;
-                        unregister_stream_stop_promise(stream_closed_promise);
-                        stream_closed_promise->set_value();
-                    }
+                    reactor->write(std::move(rpc_response));
                 });
 
-        stream_closed_future.wait();
-        std::unique_lock<std::mutex> lock(*subscribe_mutex);
-        *is_finished = true;
+        reactor->set_on_done([plugin, handle]() { plugin->unsubscribe_shutdown(handle); });
 
-        return grpc::Status::OK;
+        return reactor.get();
     }
 
-    grpc::Status SubscribeTerminate(
-        grpc::ServerContext* /* context */,
-        const mavsdk::rpc::action_server::SubscribeTerminateRequest* /* request */,
-        grpc::ServerWriter<rpc::action_server::TerminateResponse>* writer) override
+    grpc::ServerWriteReactor<rpc::action_server::TerminateResponse>* SubscribeTerminate(
+        grpc::CallbackServerContext* context,
+        const mavsdk::rpc::action_server::SubscribeTerminateRequest* /* request */) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        auto reactor = StreamReactor<rpc::action_server::TerminateResponse>::create();
+
+        if (plugin == nullptr) {
             rpc::action_server::TerminateResponse rpc_response;
 
             // For server plugins, this should never happen, they should always be constructible.
             auto result = mavsdk::ActionServer::Result::Unknown;
             fillResponseWithResult(&rpc_response, result);
-            writer->Write(rpc_response);
+            reactor->write(std::move(rpc_response));
 
-            return grpc::Status::OK;
+            reactor->finish();
+            return reactor.get();
         }
 
-        auto stream_closed_promise = std::make_shared<std::promise<void>>();
-        auto stream_closed_future = stream_closed_promise->get_future();
-        register_stream_stop_promise(stream_closed_promise);
-
-        auto is_finished = std::make_shared<bool>(false);
-        auto subscribe_mutex = std::make_shared<std::mutex>();
+        _streams.add(reactor);
 
         const mavsdk::ActionServer::TerminateHandle handle =
-            _lazy_plugin.maybe_plugin()->subscribe_terminate(
-                [this, &writer, &stream_closed_promise, is_finished, subscribe_mutex, &handle](
-                    mavsdk::ActionServer::Result result, const bool terminate) {
+            plugin->subscribe_terminate(
+                [reactor](mavsdk::ActionServer::Result result, const bool terminate) {
                     rpc::action_server::TerminateResponse rpc_response;
 
                     rpc_response.set_terminate(terminate);
 
                     auto rpc_result = translateToRpcResult(result);
-                    auto* rpc_action_server_result = new rpc::action_server::ActionServerResult();
+                    auto* rpc_action_server_result = rpc_response.mutable_action_server_result();
                     rpc_action_server_result->set_result(rpc_result);
                     std::stringstream ss;
                     ss << result;
                     rpc_action_server_result->set_result_str(ss.str());
-                    rpc_response.set_allocated_action_server_result(rpc_action_server_result);
 
-                    std::unique_lock<std::mutex> lock(*subscribe_mutex);
-                    if (!*is_finished && !writer->Write(rpc_response)) {
-                        _lazy_plugin.maybe_plugin()->unsubscribe_terminate(handle);
-
-                        *is_finished = true;
-                        unregister_stream_stop_promise(stream_closed_promise);
-                        stream_closed_promise->set_value();
-                    }
+                    reactor->write(std::move(rpc_response));
                 });
 
-        stream_closed_future.wait();
-        std::unique_lock<std::mutex> lock(*subscribe_mutex);
-        *is_finished = true;
+        reactor->set_on_done([plugin, handle]() { plugin->unsubscribe_terminate(handle); });
 
-        return grpc::Status::OK;
+        return reactor.get();
     }
 
     grpc::Status SetAllowTakeoff(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::action_server::SetAllowTakeoffRequest* request,
         rpc::action_server::SetAllowTakeoffResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 // For server plugins, this should never happen, they should always be
                 // constructible.
@@ -665,7 +588,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->set_allow_takeoff(request->allow_takeoff());
+        auto result = plugin->set_allow_takeoff(request->allow_takeoff());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -675,11 +598,13 @@ public:
     }
 
     grpc::Status SetArmable(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::action_server::SetArmableRequest* request,
         rpc::action_server::SetArmableResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 // For server plugins, this should never happen, they should always be
                 // constructible.
@@ -696,7 +621,7 @@ public:
         }
 
         auto result =
-            _lazy_plugin.maybe_plugin()->set_armable(request->armable(), request->force_armable());
+            plugin->set_armable(request->armable(), request->force_armable());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -706,11 +631,13 @@ public:
     }
 
     grpc::Status SetDisarmable(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::action_server::SetDisarmableRequest* request,
         rpc::action_server::SetDisarmableResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 // For server plugins, this should never happen, they should always be
                 // constructible.
@@ -726,7 +653,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->set_disarmable(
+        auto result = plugin->set_disarmable(
             request->disarmable(), request->force_disarmable());
 
         if (response != nullptr) {
@@ -737,11 +664,13 @@ public:
     }
 
     grpc::Status SetAllowableFlightModes(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::action_server::SetAllowableFlightModesRequest* request,
         rpc::action_server::SetAllowableFlightModesResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 // For server plugins, this should never happen, they should always be
                 // constructible.
@@ -757,7 +686,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->set_allowable_flight_modes(
+        auto result = plugin->set_allowable_flight_modes(
             translateFromRpcAllowableFlightModes(request->flight_modes()));
 
         if (response != nullptr) {
@@ -768,63 +697,33 @@ public:
     }
 
     grpc::Status GetAllowableFlightModes(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::action_server::GetAllowableFlightModesRequest* /* request */,
         rpc::action_server::GetAllowableFlightModesResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->get_allowable_flight_modes();
+        auto result = plugin->get_allowable_flight_modes();
 
         if (response != nullptr) {
-            response->set_allocated_flight_modes(
-                translateToRpcAllowableFlightModes(result).release());
+            translateToRpcAllowableFlightModes(result, response->mutable_flight_modes());
         }
 
         return grpc::Status::OK;
     }
 
-    void stop()
-    {
-        _stopped.store(true);
-        for (auto& prom : _stream_stop_promises) {
-            if (auto handle = prom.lock()) {
-                handle->set_value();
-            }
-        }
-    }
-
-private:
-    void register_stream_stop_promise(std::weak_ptr<std::promise<void>> prom)
-    {
-        // If we have already stopped, set promise immediately and don't add it to list.
-        if (_stopped.load()) {
-            if (auto handle = prom.lock()) {
-                handle->set_value();
-            }
-        } else {
-            _stream_stop_promises.push_back(prom);
-        }
-    }
+    void stop() { _streams.finish_all(); }
 
-    void unregister_stream_stop_promise(std::shared_ptr<std::promise<void>> prom)
-    {
-        for (auto it = _stream_stop_promises.begin(); it != _stream_stop_promises.end();
-             /* ++it */) {
-            if (it->lock() == prom) {
-                it = _stream_stop_promises.erase(it);
-            } else {
-                ++it;
-            }
-        }
-    }
+    const StreamStats& stream_stats() const { return _streams.stats(); }
 
+private:
     LazyServerPlugin& _lazy_plugin;
 
-    std::atomic<bool> _stopped{false};
-    std::vector<std::weak_ptr<std::promise<void>>> _stream_stop_promises{};
+    StreamList _streams{};
 };
 
 } // namespace mavsdk_server
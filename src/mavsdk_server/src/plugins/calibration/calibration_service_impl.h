@@ -10,6 +10,8 @@
 #include "lazy_plugin.h"
 
 #include "log.h"
+#include "stream_reactor.h"
+#include "system_selection.h"
 #include <atomic>
 #include <cmath>
 #include <future>
@@ -23,7 +25,14 @@ namespace mavsdk_server {
 
 template<typename Calibration = Calibration, typename LazyPlugin = LazyPlugin<Calibration>>
 
-class CalibrationServiceImpl final : public rpc::calibration::CalibrationService::Service {
+class CalibrationServiceImpl final
+    : public WithCallbackMethods<
+          rpc::calibration::CalibrationService::Service,
+          rpc::calibration::CalibrationService::WithCallbackMethod_SubscribeCalibrateGyro,
+          rpc::calibration::CalibrationService::WithCallbackMethod_SubscribeCalibrateAccelerometer,
+          rpc::calibration::CalibrationService::WithCallbackMethod_SubscribeCalibrateMagnetometer,
+          rpc::calibration::CalibrationService::WithCallbackMethod_SubscribeCalibrateLevelHorizon,
+          rpc::calibration::CalibrationService::WithCallbackMethod_SubscribeCalibrateGimbalAccelerometer> {
 public:
     CalibrationServiceImpl(LazyPlugin& lazy_plugin) : _lazy_plugin(lazy_plugin) {}
 
@@ -32,13 +41,11 @@ public:
     {
         auto rpc_result = translateToRpcResult(result);
 
-        auto* rpc_calibration_result = new rpc::calibration::CalibrationResult();
+        auto* rpc_calibration_result = response->mutable_calibration_result();
         rpc_calibration_result->set_result(rpc_result);
         std::stringstream ss;
         ss << result;
         rpc_calibration_result->set_result_str(ss.str());
-
-        response->set_allocated_calibration_result(rpc_calibration_result);
     }
 
     static rpc::calibration::CalibrationResult::Result
@@ -109,11 +116,10 @@ public:
         }
     }
 
-    static std::unique_ptr<rpc::calibration::ProgressData>
-    translateToRpcProgressData(const mavsdk::Calibration::ProgressData& progress_data)
+    static void translateToRpcProgressData(
+        const mavsdk::Calibration::ProgressData& progress_data,
+        rpc::calibration::ProgressData* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::calibration::ProgressData>();
-
         rpc_obj->set_has_progress(progress_data.has_progress);
 
         rpc_obj->set_progress(progress_data.progress);
@@ -121,8 +127,6 @@ public:
         rpc_obj->set_has_status_text(progress_data.has_status_text);
 
         rpc_obj->set_status_text(progress_data.status_text);
-
-        return rpc_obj;
     }
 
     static mavsdk::Calibration::ProgressData
@@ -141,277 +145,232 @@ public:
         return obj;
     }
 
-    grpc::Status SubscribeCalibrateGyro(
-        grpc::ServerContext* /* context */,
-        const mavsdk::rpc::calibration::SubscribeCalibrateGyroRequest* /* request */,
-        grpc::ServerWriter<rpc::calibration::CalibrateGyroResponse>* writer) override
+    grpc::ServerWriteReactor<rpc::calibration::CalibrateGyroResponse>* SubscribeCalibrateGyro(
+        grpc::CallbackServerContext* context,
+        const mavsdk::rpc::calibration::SubscribeCalibrateGyroRequest* /* request */) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        auto reactor = StreamReactor<rpc::calibration::CalibrateGyroResponse>::create();
+
+        if (plugin == nullptr) {
             rpc::calibration::CalibrateGyroResponse rpc_response;
             auto result = mavsdk::Calibration::Result::NoSystem;
             fillResponseWithResult(&rpc_response, result);
-            writer->Write(rpc_response);
+            reactor->write(std::move(rpc_response));
 
-            return grpc::Status::OK;
+            reactor->finish();
+            return reactor.get();
         }
 
-        auto stream_closed_promise = std::make_shared<std::promise<void>>();
-        auto stream_closed_future = stream_closed_promise->get_future();
-        register_stream_stop_promise(stream_closed_promise);
-
-        auto is_finished = std::make_shared<bool>(false);
-        auto subscribe_mutex = std::make_shared<std::mutex>();
+        _streams.add(reactor);
 
-        _lazy_plugin.maybe_plugin()->calibrate_gyro_async(
-            [this, &writer, &stream_closed_promise, is_finished, subscribe_mutex](
+        plugin->calibrate_gyro_async(
+            [reactor](
                 mavsdk::Calibration::Result result,
                 const mavsdk::Calibration::ProgressData calibrate_gyro) {
                 rpc::calibration::CalibrateGyroResponse rpc_response;
 
-                rpc_response.set_allocated_progress_data(
-                    translateToRpcProgressData(calibrate_gyro).release());
+                translateToRpcProgressData(calibrate_gyro, rpc_response.mutable_progress_data());
 
                 auto rpc_result = translateToRpcResult(result);
-                auto* rpc_calibration_result = new rpc::calibration::CalibrationResult();
+                auto* rpc_calibration_result = rpc_response.mutable_calibration_result();
                 rpc_calibration_result->set_result(rpc_result);
                 std::stringstream ss;
                 ss << result;
                 rpc_calibration_result->set_result_str(ss.str());
-                rpc_response.set_allocated_calibration_result(rpc_calibration_result);
-
-                std::unique_lock<std::mutex> lock(*subscribe_mutex);
-                if (!*is_finished && !writer->Write(rpc_response)) {
-                    *is_finished = true;
-                    unregister_stream_stop_promise(stream_closed_promise);
-                    stream_closed_promise->set_value();
-                }
-            });
 
-        stream_closed_future.wait();
-        std::unique_lock<std::mutex> lock(*subscribe_mutex);
-        *is_finished = true;
+                reactor->write(std::move(rpc_response));
+            });
 
-        return grpc::Status::OK;
+        return reactor.get();
     }
 
-    grpc::Status SubscribeCalibrateAccelerometer(
-        grpc::ServerContext* /* context */,
-        const mavsdk::rpc::calibration::SubscribeCalibrateAccelerometerRequest* /* request */,
-        grpc::ServerWriter<rpc::calibration::CalibrateAccelerometerResponse>* writer) override
+    grpc::ServerWriteReactor<rpc::calibration::CalibrateAccelerometerResponse>*
+    SubscribeCalibrateAccelerometer(
+        grpc::CallbackServerContext* context,
+        const mavsdk::rpc::calibration::SubscribeCalibrateAccelerometerRequest* /* request */)
+        override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        auto reactor = StreamReactor<rpc::calibration::CalibrateAccelerometerResponse>::create();
+
+        if (plugin == nullptr) {
             rpc::calibration::CalibrateAccelerometerResponse rpc_response;
             auto result = mavsdk::Calibration::Result::NoSystem;
             fillResponseWithResult(&rpc_response, result);
-            writer->Write(rpc_response);
+            reactor->write(std::move(rpc_response));
 
-            return grpc::Status::OK;
+            reactor->finish();
+            return reactor.get();
         }
 
-        auto stream_closed_promise = std::make_shared<std::promise<void>>();
-        auto stream_closed_future = stream_closed_promise->get_future();
-        register_stream_stop_promise(stream_closed_promise);
-
-        auto is_finished = std::make_shared<bool>(false);
-        auto subscribe_mutex = std::make_shared<std::mutex>();
+        _streams.add(reactor);
 
-        _lazy_plugin.maybe_plugin()->calibrate_accelerometer_async(
-            [this, &writer, &stream_closed_promise, is_finished, subscribe_mutex](
+        plugin->calibrate_accelerometer_async(
+            [reactor](
                 mavsdk::Calibration::Result result,
                 const mavsdk::Calibration::ProgressData calibrate_accelerometer) {
                 rpc::calibration::CalibrateAccelerometerResponse rpc_response;
 
-                rpc_response.set_allocated_progress_data(
-                    translateToRpcProgressData(calibrate_accelerometer).release());
+                translateToRpcProgressData(
+                    calibrate_accelerometer, rpc_response.mutable_progress_data());
 
                 auto rpc_result = translateToRpcResult(result);
-                auto* rpc_calibration_result = new rpc::calibration::CalibrationResult();
+                auto* rpc_calibration_result = rpc_response.mutable_calibration_result();
                 rpc_calibration_result->set_result(rpc_result);
                 std::stringstream ss;
                 ss << result;
                 rpc_calibration_result->set_result_str(ss.str());
-                rpc_response.set_allocated_calibration_result(rpc_calibration_result);
-
-                std::unique_lock<std::mutex> lock(*subscribe_mutex);
-                if (!*is_finished && !writer->Write(rpc_response)) {
-                    *is_finished = true;
-                    unregister_stream_stop_promise(stream_closed_promise);
-                    stream_closed_promise->set_value();
-                }
-            });
 
-        stream_closed_future.wait();
-        std::unique_lock<std::mutex> lock(*subscribe_mutex);
-        *is_finished = true;
+                reactor->write(std::move(rpc_response));
+            });
 
-        return grpc::Status::OK;
+        return reactor.get();
     }
 
-    grpc::Status SubscribeCalibrateMagnetometer(
-        grpc::ServerContext* /* context */,
-        const mavsdk::rpc::calibration::SubscribeCalibrateMagnetometerRequest* /* request */,
-        grpc::ServerWriter<rpc::calibration::CalibrateMagnetometerResponse>* writer) override
+    grpc::ServerWriteReactor<rpc::calibration::CalibrateMagnetometerResponse>*
+    SubscribeCalibrateMagnetometer(
+        grpc::CallbackServerContext* context,
+        const mavsdk::rpc::calibration::SubscribeCalibrateMagnetometerRequest* /* request */)
+        override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        auto reactor = StreamReactor<rpc::calibration::CalibrateMagnetometerResponse>::create();
+
+        if (plugin == nullptr) {
             rpc::calibration::CalibrateMagnetometerResponse rpc_response;
             auto result = mavsdk::Calibration::Result::NoSystem;
             fillResponseWithResult(&rpc_response, result);
-            writer->Write(rpc_response);
+            reactor->write(std::move(rpc_response));
 
-            return grpc::Status::OK;
+            reactor->finish();
+            return reactor.get();
         }
 
-        auto stream_closed_promise = std::make_shared<std::promise<void>>();
-        auto stream_closed_future = stream_closed_promise->get_future();
-        register_stream_stop_promise(stream_closed_promise);
-
-        auto is_finished = std::make_shared<bool>(false);
-        auto subscribe_mutex = std::make_shared<std::mutex>();
+        _streams.add(reactor);
 
-        _lazy_plugin.maybe_plugin()->calibrate_magnetometer_async(
-            [this, &writer, &stream_closed_promise, is_finished, subscribe_mutex](
+        plugin->calibrate_magnetometer_async(
+            [reactor](
                 mavsdk::Calibration::Result result,
                 const mavsdk::Calibration::ProgressData calibrate_magnetometer) {
                 rpc::calibration::CalibrateMagnetometerResponse rpc_response;
 
-                rpc_response.set_allocated_progress_data(
-                    translateToRpcProgressData(calibrate_magnetometer).release());
+                translateToRpcProgressData(
+                    calibrate_magnetometer, rpc_response.mutable_progress_data());
 
                 auto rpc_result = translateToRpcResult(result);
-                auto* rpc_calibration_result = new rpc::calibration::CalibrationResult();
+                auto* rpc_calibration_result = rpc_response.mutable_calibration_result();
                 rpc_calibration_result->set_result(rpc_result);
                 std::stringstream ss;
                 ss << result;
                 rpc_calibration_result->set_result_str(ss.str());
-                rpc_response.set_allocated_calibration_result(rpc_calibration_result);
-
-                std::unique_lock<std::mutex> lock(*subscribe_mutex);
-                if (!*is_finished && !writer->Write(rpc_response)) {
-                    *is_finished = true;
-                    unregister_stream_stop_promise(stream_closed_promise);
-                    stream_closed_promise->set_value();
-                }
-            });
 
-        stream_closed_future.wait();
-        std::unique_lock<std::mutex> lock(*subscribe_mutex);
-        *is_finished = true;
+                reactor->write(std::move(rpc_response));
+            });
 
-        return grpc::Status::OK;
+        return reactor.get();
     }
 
-    grpc::Status SubscribeCalibrateLevelHorizon(
-        grpc::ServerContext* /* context */,
-        const mavsdk::rpc::calibration::SubscribeCalibrateLevelHorizonRequest* /* request */,
-        grpc::ServerWriter<rpc::calibration::CalibrateLevelHorizonResponse>* writer) override
+    grpc::ServerWriteReactor<rpc::calibration::CalibrateLevelHorizonResponse>*
+    SubscribeCalibrateLevelHorizon(
+        grpc::CallbackServerContext* context,
+        const mavsdk::rpc::calibration::SubscribeCalibrateLevelHorizonRequest* /* request */)
+        override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        auto reactor = StreamReactor<rpc::calibration::CalibrateLevelHorizonResponse>::create();
+
+        if (plugin == nullptr) {
             rpc::calibration::CalibrateLevelHorizonResponse rpc_response;
             auto result = mavsdk::Calibration::Result::NoSystem;
             fillResponseWithResult(&rpc_response, result);
-            writer->Write(rpc_response);
+            reactor->write(std::move(rpc_response));
 
-            return grpc::Status::OK;
+            reactor->finish();
+            return reactor.get();
         }
 
-        auto stream_closed_promise = std::make_shared<std::promise<void>>();
-        auto stream_closed_future = stream_closed_promise->get_future();
-        register_stream_stop_promise(stream_closed_promise);
+        _streams.add(reactor);
 
-        auto is_finished = std::make_shared<bool>(false);
-        auto subscribe_mutex = std::make_shared<std::mutex>();
-
-        _lazy_plugin.maybe_plugin()->calibrate_level_horizon_async(
-            [this, &writer, &stream_closed_promise, is_finished, subscribe_mutex](
+        plugin->calibrate_level_horizon_async(
+            [reactor](
                 mavsdk::Calibration::Result result,
                 const mavsdk::Calibration::ProgressData calibrate_level_horizon) {
                 rpc::calibration::CalibrateLevelHorizonResponse rpc_response;
 
-                rpc_response.set_allocated_progress_data(
-                    translateToRpcProgressData(calibrate_level_horizon).release());
+                translateToRpcProgressData(
+                    calibrate_level_horizon, rpc_response.mutable_progress_data());
 
                 auto rpc_result = translateToRpcResult(result);
-                auto* rpc_calibration_result = new rpc::calibration::CalibrationResult();
+                auto* rpc_calibration_result = rpc_response.mutable_calibration_result();
                 rpc_calibration_result->set_result(rpc_result);
                 std::stringstream ss;
                 ss << result;
                 rpc_calibration_result->set_result_str(ss.str());
-                rpc_response.set_allocated_calibration_result(rpc_calibration_result);
-
-                std::unique_lock<std::mutex> lock(*subscribe_mutex);
-                if (!*is_finished && !writer->Write(rpc_response)) {
-                    *is_finished = true;
-                    unregister_stream_stop_promise(stream_closed_promise);
-                    stream_closed_promise->set_value();
-                }
-            });
 
-        stream_closed_future.wait();
-        std::unique_lock<std::mutex> lock(*subscribe_mutex);
-        *is_finished = true;
+                reactor->write(std::move(rpc_response));
+            });
 
-        return grpc::Status::OK;
+        return reactor.get();
     }
 
-    grpc::Status SubscribeCalibrateGimbalAccelerometer(
-        grpc::ServerContext* /* context */,
-        const mavsdk::rpc::calibration::SubscribeCalibrateGimbalAccelerometerRequest* /* request */,
-        grpc::ServerWriter<rpc::calibration::CalibrateGimbalAccelerometerResponse>* writer) override
+    grpc::ServerWriteReactor<rpc::calibration::CalibrateGimbalAccelerometerResponse>*
+    SubscribeCalibrateGimbalAccelerometer(
+        grpc::CallbackServerContext* context,
+        const mavsdk::rpc::calibration::SubscribeCalibrateGimbalAccelerometerRequest* /* request */)
+        override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        auto reactor =
+            StreamReactor<rpc::calibration::CalibrateGimbalAccelerometerResponse>::create();
+
+        if (plugin == nullptr) {
             rpc::calibration::CalibrateGimbalAccelerometerResponse rpc_response;
             auto result = mavsdk::Calibration::Result::NoSystem;
             fillResponseWithResult(&rpc_response, result);
-            writer->Write(rpc_response);
+            reactor->write(std::move(rpc_response));
 
-            return grpc::Status::OK;
+            reactor->finish();
+            return reactor.get();
         }
 
-        auto stream_closed_promise = std::make_shared<std::promise<void>>();
-        auto stream_closed_future = stream_closed_promise->get_future();
-        register_stream_stop_promise(stream_closed_promise);
+        _streams.add(reactor);
 
-        auto is_finished = std::make_shared<bool>(false);
-        auto subscribe_mutex = std::make_shared<std::mutex>();
-
-        _lazy_plugin.maybe_plugin()->calibrate_gimbal_accelerometer_async(
-            [this, &writer, &stream_closed_promise, is_finished, subscribe_mutex](
+        plugin->calibrate_gimbal_accelerometer_async(
+            [reactor](
                 mavsdk::Calibration::Result result,
                 const mavsdk::Calibration::ProgressData calibrate_gimbal_accelerometer) {
                 rpc::calibration::CalibrateGimbalAccelerometerResponse rpc_response;
 
-                rpc_response.set_allocated_progress_data(
-                    translateToRpcProgressData(calibrate_gimbal_accelerometer).release());
+                translateToRpcProgressData(
+                    calibrate_gimbal_accelerometer, rpc_response.mutable_progress_data());
 
                 auto rpc_result = translateToRpcResult(result);
-                auto* rpc_calibration_result = new rpc::calibration::CalibrationResult();
+                auto* rpc_calibration_result = rpc_response.mutable_calibration_result();
                 rpc_calibration_result->set_result(rpc_result);
                 std::stringstream ss;
                 ss << result;
                 rpc_calibration_result->set_result_str(ss.str());
-                rpc_response.set_allocated_calibration_result(rpc_calibration_result);
-
-                std::unique_lock<std::mutex> lock(*subscribe_mutex);
-                if (!*is_finished && !writer->Write(rpc_response)) {
-                    *is_finished = true;
-                    unregister_stream_stop_promise(stream_closed_promise);
-                    stream_closed_promise->set_value();
-                }
-            });
 
-        stream_closed_future.wait();
-        std::unique_lock<std::mutex> lock(*subscribe_mutex);
-        *is_finished = true;
+                reactor->write(std::move(rpc_response));
+            });
 
-        return grpc::Status::OK;
+        return reactor.get();
     }
 
     grpc::Status Cancel(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::calibration::CancelRequest* /* request */,
         rpc::calibration::CancelResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Calibration::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -420,7 +379,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->cancel();
+        auto result = plugin->cancel();
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -429,45 +388,14 @@ public:
         return grpc::Status::OK;
     }
 
-    void stop()
-    {
-        _stopped.store(true);
-        for (auto& prom : _stream_stop_promises) {
-            if (auto handle = prom.lock()) {
-                handle->set_value();
-            }
-        }
-    }
+    void stop() { _streams.finish_all(); }
 
-private:
-    void register_stream_stop_promise(std::weak_ptr<std::promise<void>> prom)
-    {
-        // If we have already stopped, set promise immediately and don't add it to list.
-        if (_stopped.load()) {
-            if (auto handle = prom.lock()) {
-                handle->set_value();
-            }
-        } else {
-            _stream_stop_promises.push_back(prom);
-        }
-    }
-
-    void unregister_stream_stop_promise(std::shared_ptr<std::promise<void>> prom)
-    {
-        for (auto it = _stream_stop_promises.begin(); it != _stream_stop_promises.end();
-             /* ++it */) {
-            if (it->lock() == prom) {
-                it = _stream_stop_promises.erase(it);
-            } else {
-                ++it;
-            }
-        }
-    }
+    const StreamStats& stream_stats() const { return _streams.stats(); }
 
+private:
     LazyPlugin& _lazy_plugin;
 
-    std::atomic<bool> _stopped{false};
-    std::vector<std::weak_ptr<std::promise<void>>> _stream_stop_promises{};
+    StreamList _streams{};
 };
 
 } // namespace mavsdk_server
@@ -10,6 +10,8 @@
 #include "lazy_plugin.h"
 
 #include "log.h"
+#include "stream_reactor.h"
+#include "system_selection.h"
 #include <atomic>
 #include <cmath>
 #include <future>
@@ -23,7 +25,16 @@ namespace mavsdk_server {
 
 template<typename Camera = Camera, typename LazyPlugin = LazyPlugin<Camera>>
 
-class CameraServiceImpl final : public rpc::camera::CameraService::Service {
+class CameraServiceImpl final
+    : public WithCallbackMethods<
+          rpc::camera::CameraService::Service,
+          rpc::camera::CameraService::WithCallbackMethod_SubscribeMode,
+          rpc::camera::CameraService::WithCallbackMethod_SubscribeInformation,
+          rpc::camera::CameraService::WithCallbackMethod_SubscribeVideoStreamInfo,
+          rpc::camera::CameraService::WithCallbackMethod_SubscribeCaptureInfo,
+          rpc::camera::CameraService::WithCallbackMethod_SubscribeStatus,
+          rpc::camera::CameraService::WithCallbackMethod_SubscribeCurrentSettings,
+          rpc::camera::CameraService::WithCallbackMethod_SubscribePossibleSettingOptions> {
 public:
     CameraServiceImpl(LazyPlugin& lazy_plugin) : _lazy_plugin(lazy_plugin) {}
 
@@ -32,13 +43,11 @@ public:
     {
         auto rpc_result = translateToRpcResult(result);
 
-        auto* rpc_camera_result = new rpc::camera::CameraResult();
+        auto* rpc_camera_result = response->mutable_camera_result();
         rpc_camera_result->set_result(rpc_result);
         std::stringstream ss;
         ss << result;
         rpc_camera_result->set_result_str(ss.str());
-
-        response->set_allocated_camera_result(rpc_camera_result);
     }
 
     static rpc::camera::Mode translateToRpcMode(const mavsdk::Camera::Mode& mode)
@@ -159,11 +168,9 @@ public:
         }
     }
 
-    static std::unique_ptr<rpc::camera::Position>
-    translateToRpcPosition(const mavsdk::Camera::Position& position)
+    static void translateToRpcPosition(
+        const mavsdk::Camera::Position& position, rpc::camera::Position* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::camera::Position>();
-
         rpc_obj->set_latitude_deg(position.latitude_deg);
 
         rpc_obj->set_longitude_deg(position.longitude_deg);
@@ -171,8 +178,6 @@ public:
         rpc_obj->set_absolute_altitude_m(position.absolute_altitude_m);
 
         rpc_obj->set_relative_altitude_m(position.relative_altitude_m);
-
-        return rpc_obj;
     }
 
     static mavsdk::Camera::Position translateFromRpcPosition(const rpc::camera::Position& position)
@@ -190,11 +195,9 @@ public:
         return obj;
     }
 
-    static std::unique_ptr<rpc::camera::Quaternion>
-    translateToRpcQuaternion(const mavsdk::Camera::Quaternion& quaternion)
+    static void translateToRpcQuaternion(
+        const mavsdk::Camera::Quaternion& quaternion, rpc::camera::Quaternion* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::camera::Quaternion>();
-
         rpc_obj->set_w(quaternion.w);
 
         rpc_obj->set_x(quaternion.x);
@@ -202,8 +205,6 @@ public:
         rpc_obj->set_y(quaternion.y);
 
         rpc_obj->set_z(quaternion.z);
-
-        return rpc_obj;
     }
 
     static mavsdk::Camera::Quaternion
@@ -222,18 +223,14 @@ public:
         return obj;
     }
 
-    static std::unique_ptr<rpc::camera::EulerAngle>
-    translateToRpcEulerAngle(const mavsdk::Camera::EulerAngle& euler_angle)
+    static void translateToRpcEulerAngle(
+        const mavsdk::Camera::EulerAngle& euler_angle, rpc::camera::EulerAngle* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::camera::EulerAngle>();
-
         rpc_obj->set_roll_deg(euler_angle.roll_deg);
 
         rpc_obj->set_pitch_deg(euler_angle.pitch_deg);
 
         rpc_obj->set_yaw_deg(euler_angle.yaw_deg);
-
-        return rpc_obj;
     }
 
     static mavsdk::Camera::EulerAngle
@@ -250,18 +247,16 @@ public:
         return obj;
     }
 
-    static std::unique_ptr<rpc::camera::CaptureInfo>
-    translateToRpcCaptureInfo(const mavsdk::Camera::CaptureInfo& capture_info)
+    static void translateToRpcCaptureInfo(
+        const mavsdk::Camera::CaptureInfo& capture_info, rpc::camera::CaptureInfo* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::camera::CaptureInfo>();
+        translateToRpcPosition(capture_info.position, rpc_obj->mutable_position());
 
-        rpc_obj->set_allocated_position(translateToRpcPosition(capture_info.position).release());
+        translateToRpcQuaternion(
+            capture_info.attitude_quaternion, rpc_obj->mutable_attitude_quaternion());
 
-        rpc_obj->set_allocated_attitude_quaternion(
-            translateToRpcQuaternion(capture_info.attitude_quaternion).release());
-
-        rpc_obj->set_allocated_attitude_euler_angle(
-            translateToRpcEulerAngle(capture_info.attitude_euler_angle).release());
+        translateToRpcEulerAngle(
+            capture_info.attitude_euler_angle, rpc_obj->mutable_attitude_euler_angle());
 
         rpc_obj->set_time_utc_us(capture_info.time_utc_us);
 
@@ -270,8 +265,6 @@ public:
         rpc_obj->set_index(capture_info.index);
 
         rpc_obj->set_file_url(capture_info.file_url);
-
-        return rpc_obj;
     }
 
     static mavsdk::Camera::CaptureInfo
@@ -296,11 +289,10 @@ public:
         return obj;
     }
 
-    static std::unique_ptr<rpc::camera::VideoStreamSettings> translateToRpcVideoStreamSettings(
-        const mavsdk::Camera::VideoStreamSettings& video_stream_settings)
+    static void translateToRpcVideoStreamSettings(
+        const mavsdk::Camera::VideoStreamSettings& video_stream_settings,
+        rpc::camera::VideoStreamSettings* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::camera::VideoStreamSettings>();
-
         rpc_obj->set_frame_rate_hz(video_stream_settings.frame_rate_hz);
 
         rpc_obj->set_horizontal_resolution_pix(video_stream_settings.horizontal_resolution_pix);
@@ -314,8 +306,6 @@ public:
         rpc_obj->set_uri(video_stream_settings.uri);
 
         rpc_obj->set_horizontal_fov_deg(video_stream_settings.horizontal_fov_deg);
-
-        return rpc_obj;
     }
 
     static mavsdk::Camera::VideoStreamSettings translateFromRpcVideoStreamSettings(
@@ -410,19 +400,15 @@ public:
         }
     }
 
-    static std::unique_ptr<rpc::camera::VideoStreamInfo>
-    translateToRpcVideoStreamInfo(const mavsdk::Camera::VideoStreamInfo& video_stream_info)
+    static void translateToRpcVideoStreamInfo(
+        const mavsdk::Camera::VideoStreamInfo& video_stream_info,
+        rpc::camera::VideoStreamInfo* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::camera::VideoStreamInfo>();
-
-        rpc_obj->set_allocated_settings(
-            translateToRpcVideoStreamSettings(video_stream_info.settings).release());
+        translateToRpcVideoStreamSettings(video_stream_info.settings, rpc_obj->mutable_settings());
 
         rpc_obj->set_status(translateToRpcVideoStreamStatus(video_stream_info.status));
 
         rpc_obj->set_spectrum(translateToRpcVideoStreamSpectrum(video_stream_info.spectrum));
-
-        return rpc_obj;
     }
 
     static mavsdk::Camera::VideoStreamInfo
@@ -521,11 +507,9 @@ public:
         }
     }
 
-    static std::unique_ptr<rpc::camera::Status>
-    translateToRpcStatus(const mavsdk::Camera::Status& status)
+    static void translateToRpcStatus(
+        const mavsdk::Camera::Status& status, rpc::camera::Status* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::camera::Status>();
-
         rpc_obj->set_video_on(status.video_on);
 
         rpc_obj->set_photo_interval_on(status.photo_interval_on);
@@ -545,8 +529,6 @@ public:
         rpc_obj->set_storage_id(status.storage_id);
 
         rpc_obj->set_storage_type(translateToRpcStorageType(status.storage_type));
-
-        return rpc_obj;
     }
 
     static mavsdk::Camera::Status translateFromRpcStatus(const rpc::camera::Status& status)
@@ -576,16 +558,12 @@ public:
         return obj;
     }
 
-    static std::unique_ptr<rpc::camera::Option>
-    translateToRpcOption(const mavsdk::Camera::Option& option)
+    static void translateToRpcOption(
+        const mavsdk::Camera::Option& option, rpc::camera::Option* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::camera::Option>();
-
         rpc_obj->set_option_id(option.option_id);
 
         rpc_obj->set_option_description(option.option_description);
-
-        return rpc_obj;
     }
 
     static mavsdk::Camera::Option translateFromRpcOption(const rpc::camera::Option& option)
@@ -599,20 +577,16 @@ public:
         return obj;
     }
 
-    static std::unique_ptr<rpc::camera::Setting>
-    translateToRpcSetting(const mavsdk::Camera::Setting& setting)
+    static void translateToRpcSetting(
+        const mavsdk::Camera::Setting& setting, rpc::camera::Setting* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::camera::Setting>();
-
         rpc_obj->set_setting_id(setting.setting_id);
 
         rpc_obj->set_setting_description(setting.setting_description);
 
-        rpc_obj->set_allocated_option(translateToRpcOption(setting.option).release());
+        translateToRpcOption(setting.option, rpc_obj->mutable_option());
 
         rpc_obj->set_is_range(setting.is_range);
-
-        return rpc_obj;
     }
 
     static mavsdk::Camera::Setting translateFromRpcSetting(const rpc::camera::Setting& setting)
@@ -630,23 +604,18 @@ public:
         return obj;
     }
 
-    static std::unique_ptr<rpc::camera::SettingOptions>
-    translateToRpcSettingOptions(const mavsdk::Camera::SettingOptions& setting_options)
+    static void translateToRpcSettingOptions(
+        const mavsdk::Camera::SettingOptions& setting_options, rpc::camera::SettingOptions* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::camera::SettingOptions>();
-
         rpc_obj->set_setting_id(setting_options.setting_id);
 
         rpc_obj->set_setting_description(setting_options.setting_description);
 
         for (const auto& elem : setting_options.options) {
-            auto* ptr = rpc_obj->add_options();
-            ptr->CopyFrom(*translateToRpcOption(elem).release());
+            translateToRpcOption(elem, rpc_obj->add_options());
         }
 
         rpc_obj->set_is_range(setting_options.is_range);
-
-        return rpc_obj;
     }
 
     static mavsdk::Camera::SettingOptions
@@ -668,11 +637,9 @@ public:
         return obj;
     }
 
-    static std::unique_ptr<rpc::camera::Information>
-    translateToRpcInformation(const mavsdk::Camera::Information& information)
+    static void translateToRpcInformation(
+        const mavsdk::Camera::Information& information, rpc::camera::Information* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::camera::Information>();
-
         rpc_obj->set_vendor_name(information.vendor_name);
 
         rpc_obj->set_model_name(information.model_name);
@@ -686,8 +653,6 @@ public:
         rpc_obj->set_horizontal_resolution_px(information.horizontal_resolution_px);
 
         rpc_obj->set_vertical_resolution_px(information.vertical_resolution_px);
-
-        return rpc_obj;
     }
 
     static mavsdk::Camera::Information
@@ -713,11 +678,13 @@ public:
     }
 
     grpc::Status Prepare(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::camera::PrepareRequest* /* request */,
         rpc::camera::PrepareResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Camera::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -726,7 +693,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->prepare();
+        auto result = plugin->prepare();
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -736,11 +703,13 @@ public:
     }
 
     grpc::Status TakePhoto(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::camera::TakePhotoRequest* /* request */,
         rpc::camera::TakePhotoResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Camera::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -749,7 +718,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->take_photo();
+        auto result = plugin->take_photo();
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -759,11 +728,13 @@ public:
     }
 
     grpc::Status StartPhotoInterval(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::camera::StartPhotoIntervalRequest* request,
         rpc::camera::StartPhotoIntervalResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Camera::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -777,7 +748,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->start_photo_interval(request->interval_s());
+        auto result = plugin->start_photo_interval(request->interval_s());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -787,11 +758,13 @@ public:
     }
 
     grpc::Status StopPhotoInterval(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::camera::StopPhotoIntervalRequest* /* request */,
         rpc::camera::StopPhotoIntervalResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Camera::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -800,7 +773,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->stop_photo_interval();
+        auto result = plugin->stop_photo_interval();
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -810,11 +783,13 @@ public:
     }
 
     grpc::Status StartVideo(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::camera::StartVideoRequest* /* request */,
         rpc::camera::StartVideoResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Camera::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -823,7 +798,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->start_video();
+        auto result = plugin->start_video();
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -833,11 +808,13 @@ public:
     }
 
     grpc::Status StopVideo(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::camera::StopVideoRequest* /* request */,
         rpc::camera::StopVideoResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Camera::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -846,7 +823,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->stop_video();
+        auto result = plugin->stop_video();
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -856,11 +833,13 @@ public:
     }
 
     grpc::Status StartVideoStreaming(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::camera::StartVideoStreamingRequest* /* request */,
         rpc::camera::StartVideoStreamingResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Camera::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -869,7 +848,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->start_video_streaming();
+        auto result = plugin->start_video_streaming();
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -879,11 +858,13 @@ public:
     }
 
     grpc::Status StopVideoStreaming(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::camera::StopVideoStreamingRequest* /* request */,
         rpc::camera::StopVideoStreamingResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Camera::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -892,7 +873,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->stop_video_streaming();
+        auto result = plugin->stop_video_streaming();
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -902,11 +883,13 @@ public:
     }
 
     grpc::Status SetMode(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::camera::SetModeRequest* request,
         rpc::camera::SetModeResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Camera::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -920,7 +903,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->set_mode(translateFromRpcMode(request->mode()));
+        auto result = plugin->set_mode(translateFromRpcMode(request->mode()));
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -930,11 +913,13 @@ public:
     }
 
     grpc::Status ListPhotos(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::camera::ListPhotosRequest* request,
         rpc::camera::ListPhotosResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Camera::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -948,321 +933,244 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->list_photos(
+        auto result = plugin->list_photos(
             translateFromRpcPhotosRange(request->photos_range()));
 
         if (response != nullptr) {
             fillResponseWithResult(response, result.first);
 
             for (auto elem : result.second) {
-                auto* ptr = response->add_capture_infos();
-                ptr->CopyFrom(*translateToRpcCaptureInfo(elem).release());
+                translateToRpcCaptureInfo(elem, response->add_capture_infos());
             }
         }
 
         return grpc::Status::OK;
     }
 
-    grpc::Status SubscribeMode(
-        grpc::ServerContext* /* context */,
-        const mavsdk::rpc::camera::SubscribeModeRequest* /* request */,
-        grpc::ServerWriter<rpc::camera::ModeResponse>* writer) override
+    grpc::ServerWriteReactor<rpc::camera::ModeResponse>* SubscribeMode(
+        grpc::CallbackServerContext* context,
+        const mavsdk::rpc::camera::SubscribeModeRequest* /* request */) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
-            return grpc::Status::OK;
-        }
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
 
-        auto stream_closed_promise = std::make_shared<std::promise<void>>();
-        auto stream_closed_future = stream_closed_promise->get_future();
-        register_stream_stop_promise(stream_closed_promise);
+        auto reactor = StreamReactor<rpc::camera::ModeResponse>::create();
 
-        auto is_finished = std::make_shared<bool>(false);
-        auto subscribe_mutex = std::make_shared<std::mutex>();
+        if (plugin == nullptr) {
+            reactor->finish();
+            return reactor.get();
+        }
+
+        _streams.add(reactor);
 
-        const mavsdk::Camera::ModeHandle handle = _lazy_plugin.maybe_plugin()->subscribe_mode(
-            [this, &writer, &stream_closed_promise, is_finished, subscribe_mutex, &handle](
-                const mavsdk::Camera::Mode mode) {
+        const mavsdk::Camera::ModeHandle handle = plugin->subscribe_mode(
+            [reactor](const mavsdk::Camera::Mode mode) {
                 rpc::camera::ModeResponse rpc_response;
 
                 rpc_response.set_mode(translateToRpcMode(mode));
 
-                std::unique_lock<std::mutex> lock(*subscribe_mutex);
-                if (!*is_finished && !writer->Write(rpc_response)) {
-                    _lazy_plugin.maybe_plugin()->unsubscribe_mode(handle);
-
-                    *is_finished = true;
-                    unregister_stream_stop_promise(stream_closed_promise);
-                    stream_closed_promise->set_value();
-                }
+                reactor->write(std::move(rpc_response));
             });
 
-        stream_closed_future.wait();
-        std::unique_lock<std::mutex> lock(*subscribe_mutex);
-        *is_finished = true;
+        reactor->set_on_done([plugin, handle]() { plugin->unsubscribe_mode(handle); });
 
-        return grpc::Status::OK;
+        return reactor.get();
     }
 
-    grpc::Status SubscribeInformation(
-        grpc::ServerContext* /* context */,
-        const mavsdk::rpc::camera::SubscribeInformationRequest* /* request */,
-        grpc::ServerWriter<rpc::camera::InformationResponse>* writer) override
+    grpc::ServerWriteReactor<rpc::camera::InformationResponse>* SubscribeInformation(
+        grpc::CallbackServerContext* context,
+        const mavsdk::rpc::camera::SubscribeInformationRequest* /* request */) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
-            return grpc::Status::OK;
-        }
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
 
-        auto stream_closed_promise = std::make_shared<std::promise<void>>();
-        auto stream_closed_future = stream_closed_promise->get_future();
-        register_stream_stop_promise(stream_closed_promise);
+        auto reactor = StreamReactor<rpc::camera::InformationResponse>::create();
 
-        auto is_finished = std::make_shared<bool>(false);
-        auto subscribe_mutex = std::make_shared<std::mutex>();
+        if (plugin == nullptr) {
+            reactor->finish();
+            return reactor.get();
+        }
+
+        _streams.add(reactor);
 
         const mavsdk::Camera::InformationHandle handle =
-            _lazy_plugin.maybe_plugin()->subscribe_information(
-                [this, &writer, &stream_closed_promise, is_finished, subscribe_mutex, &handle](
-                    const mavsdk::Camera::Information information) {
+            plugin->subscribe_information(
+                [reactor](const mavsdk::Camera::Information information) {
                     rpc::camera::InformationResponse rpc_response;
 
-                    rpc_response.set_allocated_information(
-                        translateToRpcInformation(information).release());
-
-                    std::unique_lock<std::mutex> lock(*subscribe_mutex);
-                    if (!*is_finished && !writer->Write(rpc_response)) {
-                        _lazy_plugin.maybe_plugin()->unsubscribe_information(handle);
+                    translateToRpcInformation(information, rpc_response.mutable_information());
 
-                        *is_finished = true;
-                        unregister_stream_stop_promise(stream_closed_promise);
-                        stream_closed_promise->set_value();
-                    }
+                    reactor->write(std::move(rpc_response));
                 });
 
-        stream_closed_future.wait();
-        std::unique_lock<std::mutex> lock(*subscribe_mutex);
-        *is_finished = true;
+        reactor->set_on_done([plugin, handle]() { plugin->unsubscribe_information(handle); });
 
-        return grpc::Status::OK;
+        return reactor.get();
     }
 
-    grpc::Status SubscribeVideoStreamInfo(
-        grpc::ServerContext* /* context */,
-        const mavsdk::rpc::camera::SubscribeVideoStreamInfoRequest* /* request */,
-        grpc::ServerWriter<rpc::camera::VideoStreamInfoResponse>* writer) override
+    grpc::ServerWriteReactor<rpc::camera::VideoStreamInfoResponse>* SubscribeVideoStreamInfo(
+        grpc::CallbackServerContext* context,
+        const mavsdk::rpc::camera::SubscribeVideoStreamInfoRequest* /* request */) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
-            return grpc::Status::OK;
-        }
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        auto reactor = StreamReactor<rpc::camera::VideoStreamInfoResponse>::create();
 
-        auto stream_closed_promise = std::make_shared<std::promise<void>>();
-        auto stream_closed_future = stream_closed_promise->get_future();
-        register_stream_stop_promise(stream_closed_promise);
+        if (plugin == nullptr) {
+            reactor->finish();
+            return reactor.get();
+        }
 
-        auto is_finished = std::make_shared<bool>(false);
-        auto subscribe_mutex = std::make_shared<std::mutex>();
+        _streams.add(reactor);
 
         const mavsdk::Camera::VideoStreamInfoHandle handle =
-            _lazy_plugin.maybe_plugin()->subscribe_video_stream_info(
-                [this, &writer, &stream_closed_promise, is_finished, subscribe_mutex, &handle](
-                    const mavsdk::Camera::VideoStreamInfo video_stream_info) {
+            plugin->subscribe_video_stream_info(
+                [reactor](const mavsdk::Camera::VideoStreamInfo video_stream_info) {
                     rpc::camera::VideoStreamInfoResponse rpc_response;
 
-                    rpc_response.set_allocated_video_stream_info(
-                        translateToRpcVideoStreamInfo(video_stream_info).release());
+                    translateToRpcVideoStreamInfo(
+                        video_stream_info, rpc_response.mutable_video_stream_info());
 
-                    std::unique_lock<std::mutex> lock(*subscribe_mutex);
-                    if (!*is_finished && !writer->Write(rpc_response)) {
-                        _lazy_plugin.maybe_plugin()->unsubscribe_video_stream_info(handle);
-
-                        *is_finished = true;
-                        unregister_stream_stop_promise(stream_closed_promise);
-                        stream_closed_promise->set_value();
-                    }
+                    reactor->write(std::move(rpc_response));
                 });
 
-        stream_closed_future.wait();
-        std::unique_lock<std::mutex> lock(*subscribe_mutex);
-        *is_finished = true;
+        reactor->set_on_done([plugin, handle]() { plugin->unsubscribe_video_stream_info(handle); });
 
-        return grpc::Status::OK;
+        return reactor.get();
     }
 
-    grpc::Status SubscribeCaptureInfo(
-        grpc::ServerContext* /* context */,
-        const mavsdk::rpc::camera::SubscribeCaptureInfoRequest* /* request */,
-        grpc::ServerWriter<rpc::camera::CaptureInfoResponse>* writer) override
+    grpc::ServerWriteReactor<rpc::camera::CaptureInfoResponse>* SubscribeCaptureInfo(
+        grpc::CallbackServerContext* context,
+        const mavsdk::rpc::camera::SubscribeCaptureInfoRequest* /* request */) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
-            return grpc::Status::OK;
-        }
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        auto reactor = StreamReactor<rpc::camera::CaptureInfoResponse>::create();
 
-        auto stream_closed_promise = std::make_shared<std::promise<void>>();
-        auto stream_closed_future = stream_closed_promise->get_future();
-        register_stream_stop_promise(stream_closed_promise);
+        if (plugin == nullptr) {
+            reactor->finish();
+            return reactor.get();
+        }
 
-        auto is_finished = std::make_shared<bool>(false);
-        auto subscribe_mutex = std::make_shared<std::mutex>();
+        _streams.add(reactor);
 
         const mavsdk::Camera::CaptureInfoHandle handle =
-            _lazy_plugin.maybe_plugin()->subscribe_capture_info(
-                [this, &writer, &stream_closed_promise, is_finished, subscribe_mutex, &handle](
-                    const mavsdk::Camera::CaptureInfo capture_info) {
+            plugin->subscribe_capture_info(
+                [reactor](const mavsdk::Camera::CaptureInfo capture_info) {
                     rpc::camera::CaptureInfoResponse rpc_response;
 
-                    rpc_response.set_allocated_capture_info(
-                        translateToRpcCaptureInfo(capture_info).release());
+                    translateToRpcCaptureInfo(capture_info, rpc_response.mutable_capture_info());
 
-                    std::unique_lock<std::mutex> lock(*subscribe_mutex);
-                    if (!*is_finished && !writer->Write(rpc_response)) {
-                        _lazy_plugin.maybe_plugin()->unsubscribe_capture_info(handle);
-
-                        *is_finished = true;
-                        unregister_stream_stop_promise(stream_closed_promise);
-                        stream_closed_promise->set_value();
-                    }
+                    reactor->write(std::move(rpc_response));
                 });
 
-        stream_closed_future.wait();
-        std::unique_lock<std::mutex> lock(*subscribe_mutex);
-        *is_finished = true;
+        reactor->set_on_done([plugin, handle]() { plugin->unsubscribe_capture_info(handle); });
 
-        return grpc::Status::OK;
+        return reactor.get();
     }
 
-    grpc::Status SubscribeStatus(
-        grpc::ServerContext* /* context */,
-        const mavsdk::rpc::camera::SubscribeStatusRequest* /* request */,
-        grpc::ServerWriter<rpc::camera::StatusResponse>* writer) override
+    grpc::ServerWriteReactor<rpc::camera::StatusResponse>* SubscribeStatus(
+        grpc::CallbackServerContext* context,
+        const mavsdk::rpc::camera::SubscribeStatusRequest* /* request */) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
-            return grpc::Status::OK;
-        }
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
 
-        auto stream_closed_promise = std::make_shared<std::promise<void>>();
-        auto stream_closed_future = stream_closed_promise->get_future();
-        register_stream_stop_promise(stream_closed_promise);
+        auto reactor = StreamReactor<rpc::camera::StatusResponse>::create();
 
-        auto is_finished = std::make_shared<bool>(false);
-        auto subscribe_mutex = std::make_shared<std::mutex>();
+        if (plugin == nullptr) {
+            reactor->finish();
+            return reactor.get();
+        }
 
-        const mavsdk::Camera::StatusHandle handle = _lazy_plugin.maybe_plugin()->subscribe_status(
-            [this, &writer, &stream_closed_promise, is_finished, subscribe_mutex, &handle](
-                const mavsdk::Camera::Status status) {
-                rpc::camera::StatusResponse rpc_response;
+        _streams.add(reactor);
 
-                rpc_response.set_allocated_camera_status(translateToRpcStatus(status).release());
+        const mavsdk::Camera::StatusHandle handle = plugin->subscribe_status(
+            [reactor](const mavsdk::Camera::Status status) {
+                rpc::camera::StatusResponse rpc_response;
 
-                std::unique_lock<std::mutex> lock(*subscribe_mutex);
-                if (!*is_finished && !writer->Write(rpc_response)) {
-                    _lazy_plugin.maybe_plugin()->unsubscribe_status(handle);
+                translateToRpcStatus(status, rpc_response.mutable_camera_status());
 
-                    *is_finished = true;
-                    unregister_stream_stop_promise(stream_closed_promise);
-                    stream_closed_promise->set_value();
-                }
+                reactor->write(std::move(rpc_response));
             });
 
-        stream_closed_future.wait();
-        std::unique_lock<std::mutex> lock(*subscribe_mutex);
-        *is_finished = true;
+        reactor->set_on_done([plugin, handle]() { plugin->unsubscribe_status(handle); });
 
-        return grpc::Status::OK;
+        return reactor.get();
     }
 
-    grpc::Status SubscribeCurrentSettings(
-        grpc::ServerContext* /* context */,
-        const mavsdk::rpc::camera::SubscribeCurrentSettingsRequest* /* request */,
-        grpc::ServerWriter<rpc::camera::CurrentSettingsResponse>* writer) override
+    grpc::ServerWriteReactor<rpc::camera::CurrentSettingsResponse>* SubscribeCurrentSettings(
+        grpc::CallbackServerContext* context,
+        const mavsdk::rpc::camera::SubscribeCurrentSettingsRequest* /* request */) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
-            return grpc::Status::OK;
-        }
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        auto reactor = StreamReactor<rpc::camera::CurrentSettingsResponse>::create();
 
-        auto stream_closed_promise = std::make_shared<std::promise<void>>();
-        auto stream_closed_future = stream_closed_promise->get_future();
-        register_stream_stop_promise(stream_closed_promise);
+        if (plugin == nullptr) {
+            reactor->finish();
+            return reactor.get();
+        }
 
-        auto is_finished = std::make_shared<bool>(false);
-        auto subscribe_mutex = std::make_shared<std::mutex>();
+        _streams.add(reactor);
 
         const mavsdk::Camera::CurrentSettingsHandle handle =
-            _lazy_plugin.maybe_plugin()->subscribe_current_settings(
-                [this, &writer, &stream_closed_promise, is_finished, subscribe_mutex, &handle](
-                    const std::vector<mavsdk::Camera::Setting> current_settings) {
+            plugin->subscribe_current_settings(
+                [reactor](const std::vector<mavsdk::Camera::Setting> current_settings) {
                     rpc::camera::CurrentSettingsResponse rpc_response;
 
                     for (const auto& elem : current_settings) {
-                        auto* ptr = rpc_response.add_current_settings();
-                        ptr->CopyFrom(*translateToRpcSetting(elem).release());
+                        translateToRpcSetting(elem, rpc_response.add_current_settings());
                     }
 
-                    std::unique_lock<std::mutex> lock(*subscribe_mutex);
-                    if (!*is_finished && !writer->Write(rpc_response)) {
-                        _lazy_plugin.maybe_plugin()->unsubscribe_current_settings(handle);
-
-                        *is_finished = true;
-                        unregister_stream_stop_promise(stream_closed_promise);
-                        stream_closed_promise->set_value();
-                    }
+                    reactor->write(std::move(rpc_response));
                 });
 
-        stream_closed_future.wait();
-        std::unique_lock<std::mutex> lock(*subscribe_mutex);
-        *is_finished = true;
+        reactor->set_on_done([plugin, handle]() { plugin->unsubscribe_current_settings(handle); });
 
-        return grpc::Status::OK;
+        return reactor.get();
     }
 
-    grpc::Status SubscribePossibleSettingOptions(
-        grpc::ServerContext* /* context */,
-        const mavsdk::rpc::camera::SubscribePossibleSettingOptionsRequest* /* request */,
-        grpc::ServerWriter<rpc::camera::PossibleSettingOptionsResponse>* writer) override
+    grpc::ServerWriteReactor<rpc::camera::PossibleSettingOptionsResponse>*
+    SubscribePossibleSettingOptions(
+        grpc::CallbackServerContext* context,
+        const mavsdk::rpc::camera::SubscribePossibleSettingOptionsRequest* /* request */) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
-            return grpc::Status::OK;
-        }
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
 
-        auto stream_closed_promise = std::make_shared<std::promise<void>>();
-        auto stream_closed_future = stream_closed_promise->get_future();
-        register_stream_stop_promise(stream_closed_promise);
+        auto reactor = StreamReactor<rpc::camera::PossibleSettingOptionsResponse>::create();
 
-        auto is_finished = std::make_shared<bool>(false);
-        auto subscribe_mutex = std::make_shared<std::mutex>();
+        if (plugin == nullptr) {
+            reactor->finish();
+            return reactor.get();
+        }
+
+        _streams.add(reactor);
 
         const mavsdk::Camera::PossibleSettingOptionsHandle handle =
-            _lazy_plugin.maybe_plugin()->subscribe_possible_setting_options(
-                [this, &writer, &stream_closed_promise, is_finished, subscribe_mutex, &handle](
+            plugin->subscribe_possible_setting_options(
+                [reactor](
                     const std::vector<mavsdk::Camera::SettingOptions> possible_setting_options) {
                     rpc::camera::PossibleSettingOptionsResponse rpc_response;
 
                     for (const auto& elem : possible_setting_options) {
-                        auto* ptr = rpc_response.add_setting_options();
-                        ptr->CopyFrom(*translateToRpcSettingOptions(elem).release());
+                        translateToRpcSettingOptions(elem, rpc_response.add_setting_options());
                     }
 
-                    std::unique_lock<std::mutex> lock(*subscribe_mutex);
-                    if (!*is_finished && !writer->Write(rpc_response)) {
-                        _lazy_plugin.maybe_plugin()->unsubscribe_possible_setting_options(handle);
-
-                        *is_finished = true;
-                        unregister_stream_stop_promise(stream_closed_promise);
-                        stream_closed_promise->set_value();
-                    }
+                    reactor->write(std::move(rpc_response));
                 });
 
-        stream_closed_future.wait();
-        std::unique_lock<std::mutex> lock(*subscribe_mutex);
-        *is_finished = true;
+        reactor->set_on_done(
+            [plugin, handle]() { plugin->unsubscribe_possible_setting_options(handle); });
 
-        return grpc::Status::OK;
+        return reactor.get();
     }
 
     grpc::Status SetSetting(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::camera::SetSettingRequest* request,
         rpc::camera::SetSettingResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Camera::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -1277,7 +1185,7 @@ public:
         }
 
         auto result =
-            _lazy_plugin.maybe_plugin()->set_setting(translateFromRpcSetting(request->setting()));
+            plugin->set_setting(translateFromRpcSetting(request->setting()));
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -1287,11 +1195,13 @@ public:
     }
 
     grpc::Status GetSetting(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::camera::GetSettingRequest* request,
         rpc::camera::GetSettingResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Camera::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -1306,23 +1216,25 @@ public:
         }
 
         auto result =
-            _lazy_plugin.maybe_plugin()->get_setting(translateFromRpcSetting(request->setting()));
+            plugin->get_setting(translateFromRpcSetting(request->setting()));
 
         if (response != nullptr) {
             fillResponseWithResult(response, result.first);
 
-            response->set_allocated_setting(translateToRpcSetting(result.second).release());
+            translateToRpcSetting(result.second, response->mutable_setting());
         }
 
         return grpc::Status::OK;
     }
 
     grpc::Status FormatStorage(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::camera::FormatStorageRequest* /* request */,
         rpc::camera::FormatStorageResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Camera::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -1331,7 +1243,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->format_storage();
+        auto result = plugin->format_storage();
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -1341,11 +1253,13 @@ public:
     }
 
     grpc::Status SelectCamera(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::camera::SelectCameraRequest* request,
         rpc::camera::SelectCameraResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Camera::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -1359,7 +1273,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->select_camera(request->camera_id());
+        auto result = plugin->select_camera(request->camera_id());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -1368,45 +1282,14 @@ public:
         return grpc::Status::OK;
     }
 
-    void stop()
-    {
-        _stopped.store(true);
-        for (auto& prom : _stream_stop_promises) {
-            if (auto handle = prom.lock()) {
-                handle->set_value();
-            }
-        }
-    }
-
-private:
-    void register_stream_stop_promise(std::weak_ptr<std::promise<void>> prom)
-    {
-        // If we have already stopped, set promise immediately and don't add it to list.
-        if (_stopped.load()) {
-            if (auto handle = prom.lock()) {
-                handle->set_value();
-            }
-        } else {
-            _stream_stop_promises.push_back(prom);
-        }
-    }
+    void stop() { _streams.finish_all(); }
 
-    void unregister_stream_stop_promise(std::shared_ptr<std::promise<void>> prom)
-    {
-        for (auto it = _stream_stop_promises.begin(); it != _stream_stop_promises.end();
-             /* ++it */) {
-            if (it->lock() == prom) {
-                it = _stream_stop_promises.erase(it);
-            } else {
-                ++it;
-            }
-        }
-    }
+    const StreamStats& stream_stats() const { return _streams.stats(); }
 
+private:
     LazyPlugin& _lazy_plugin;
 
-    std::atomic<bool> _stopped{false};
-    std::vector<std::weak_ptr<std::promise<void>>> _stream_stop_promises{};
+    StreamList _streams{};
 };
 
 } // namespace mavsdk_server
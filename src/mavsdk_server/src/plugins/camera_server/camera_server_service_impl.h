@@ -11,6 +11,8 @@
 #include "lazy_server_plugin.h"
 
 #include "log.h"
+#include "stream_reactor.h"
+#include "system_selection.h"
 #include <atomic>
 #include <cmath>
 #include <future>
@@ -26,7 +28,10 @@ template<
     typename CameraServer = CameraServer,
     typename LazyServerPlugin = LazyServerPlugin<CameraServer>>
 
-class CameraServerServiceImpl final : public rpc::camera_server::CameraServerService::Service {
+class CameraServerServiceImpl final
+    : public WithCallbackMethods<
+          rpc::camera_server::CameraServerService::Service,
+          rpc::camera_server::CameraServerService::WithCallbackMethod_SubscribeTakePhoto> {
 public:
     CameraServerServiceImpl(LazyServerPlugin& lazy_plugin) : _lazy_plugin(lazy_plugin) {}
 
@@ -35,13 +40,11 @@ public:
     {
         auto rpc_result = translateToRpcResult(result);
 
-        auto* rpc_camera_server_result = new rpc::camera_server::CameraServerResult();
+        auto* rpc_camera_server_result = response->mutable_camera_server_result();
         rpc_camera_server_result->set_result(rpc_result);
         std::stringstream ss;
         ss << result;
         rpc_camera_server_result->set_result_str(ss.str());
-
-        response->set_allocated_camera_server_result(rpc_camera_server_result);
     }
 
     static rpc::camera_server::TakePhotoFeedback translateToRpcTakePhotoFeedback(
@@ -82,11 +85,10 @@ public:
         }
     }
 
-    static std::unique_ptr<rpc::camera_server::Information>
-    translateToRpcInformation(const mavsdk::CameraServer::Information& information)
+    static void translateToRpcInformation(
+        const mavsdk::CameraServer::Information& information,
+        rpc::camera_server::Information* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::camera_server::Information>();
-
         rpc_obj->set_vendor_name(information.vendor_name);
 
         rpc_obj->set_model_name(information.model_name);
@@ -108,8 +110,6 @@ public:
         rpc_obj->set_definition_file_version(information.definition_file_version);
 
         rpc_obj->set_definition_file_uri(information.definition_file_uri);
-
-        return rpc_obj;
     }
 
     static mavsdk::CameraServer::Information
@@ -142,11 +142,9 @@ public:
         return obj;
     }
 
-    static std::unique_ptr<rpc::camera_server::Position>
-    translateToRpcPosition(const mavsdk::CameraServer::Position& position)
+    static void translateToRpcPosition(
+        const mavsdk::CameraServer::Position& position, rpc::camera_server::Position* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::camera_server::Position>();
-
         rpc_obj->set_latitude_deg(position.latitude_deg);
 
         rpc_obj->set_longitude_deg(position.longitude_deg);
@@ -154,8 +152,6 @@ public:
         rpc_obj->set_absolute_altitude_m(position.absolute_altitude_m);
 
         rpc_obj->set_relative_altitude_m(position.relative_altitude_m);
-
-        return rpc_obj;
     }
 
     static mavsdk::CameraServer::Position
@@ -174,11 +170,9 @@ public:
         return obj;
     }
 
-    static std::unique_ptr<rpc::camera_server::Quaternion>
-    translateToRpcQuaternion(const mavsdk::CameraServer::Quaternion& quaternion)
+    static void translateToRpcQuaternion(
+        const mavsdk::CameraServer::Quaternion& quaternion, rpc::camera_server::Quaternion* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::camera_server::Quaternion>();
-
         rpc_obj->set_w(quaternion.w);
 
         rpc_obj->set_x(quaternion.x);
@@ -186,8 +180,6 @@ public:
         rpc_obj->set_y(quaternion.y);
 
         rpc_obj->set_z(quaternion.z);
-
-        return rpc_obj;
     }
 
     static mavsdk::CameraServer::Quaternion
@@ -206,15 +198,14 @@ public:
         return obj;
     }
 
-    static std::unique_ptr<rpc::camera_server::CaptureInfo>
-    translateToRpcCaptureInfo(const mavsdk::CameraServer::CaptureInfo& capture_info)
+    static void translateToRpcCaptureInfo(
+        const mavsdk::CameraServer::CaptureInfo& capture_info,
+        rpc::camera_server::CaptureInfo* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::camera_server::CaptureInfo>();
+        translateToRpcPosition(capture_info.position, rpc_obj->mutable_position());
 
-        rpc_obj->set_allocated_position(translateToRpcPosition(capture_info.position).release());
-
-        rpc_obj->set_allocated_attitude_quaternion(
-            translateToRpcQuaternion(capture_info.attitude_quaternion).release());
+        translateToRpcQuaternion(
+            capture_info.attitude_quaternion, rpc_obj->mutable_attitude_quaternion());
 
         rpc_obj->set_time_utc_us(capture_info.time_utc_us);
 
@@ -223,8 +214,6 @@ public:
         rpc_obj->set_index(capture_info.index);
 
         rpc_obj->set_file_url(capture_info.file_url);
-
-        return rpc_obj;
     }
 
     static mavsdk::CameraServer::CaptureInfo
@@ -304,11 +293,13 @@ public:
     }
 
     grpc::Status SetInformation(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::camera_server::SetInformationRequest* request,
         rpc::camera_server::SetInformationResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 // For server plugins, this should never happen, they should always be
                 // constructible.
@@ -324,7 +315,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->set_information(
+        auto result = plugin->set_information(
             translateFromRpcInformation(request->information()));
 
         if (response != nullptr) {
@@ -335,11 +326,13 @@ public:
     }
 
     grpc::Status SetInProgress(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::camera_server::SetInProgressRequest* request,
         rpc::camera_server::SetInProgressResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 // For server plugins, this should never happen, they should always be
                 // constructible.
@@ -355,7 +348,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->set_in_progress(request->in_progress());
+        auto result = plugin->set_in_progress(request->in_progress());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -364,53 +357,44 @@ public:
         return grpc::Status::OK;
     }
 
-    grpc::Status SubscribeTakePhoto(
-        grpc::ServerContext* /* context */,
-        const mavsdk::rpc::camera_server::SubscribeTakePhotoRequest* /* request */,
-        grpc::ServerWriter<rpc::camera_server::TakePhotoResponse>* writer) override
+    grpc::ServerWriteReactor<rpc::camera_server::TakePhotoResponse>* SubscribeTakePhoto(
+        grpc::CallbackServerContext* context,
+        const mavsdk::rpc::camera_server::SubscribeTakePhotoRequest* /* request */) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
-            return grpc::Status::OK;
-        }
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
 
-        auto stream_closed_promise = std::make_shared<std::promise<void>>();
-        auto stream_closed_future = stream_closed_promise->get_future();
-        register_stream_stop_promise(stream_closed_promise);
+        auto reactor = StreamReactor<rpc::camera_server::TakePhotoResponse>::create();
 
-        auto is_finished = std::make_shared<bool>(false);
-        auto subscribe_mutex = std::make_shared<std::mutex>();
+        if (plugin == nullptr) {
+            reactor->finish();
+            return reactor.get();
+        }
+
+        _streams.add(reactor);
 
         const mavsdk::CameraServer::TakePhotoHandle handle =
-            _lazy_plugin.maybe_plugin()->subscribe_take_photo(
-                [this, &writer, &stream_closed_promise, is_finished, subscribe_mutex, &handle](
-                    const int32_t take_photo) {
+            plugin->subscribe_take_photo(
+                [reactor](const int32_t take_photo) {
                     rpc::camera_server::TakePhotoResponse rpc_response;
 
                     rpc_response.set_index(take_photo);
 
-                    std::unique_lock<std::mutex> lock(*subscribe_mutex);
-                    if (!*is_finished && !writer->Write(rpc_response)) {
-                        _lazy_plugin.maybe_plugin()->unsubscribe_take_photo(handle);
-
-                        *is_finished = true;
-                        unregister_stream_stop_promise(stream_closed_promise);
-                        stream_closed_promise->set_value();
-                    }
+                    reactor->write(std::move(rpc_response));
                 });
 
-        stream_closed_future.wait();
-        std::unique_lock<std::mutex> lock(*subscribe_mutex);
-        *is_finished = true;
+        reactor->set_on_done([plugin, handle]() { plugin->unsubscribe_take_photo(handle); });
 
-        return grpc::Status::OK;
+        return reactor.get();
     }
 
     grpc::Status RespondTakePhoto(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::camera_server::RespondTakePhotoRequest* request,
         rpc::camera_server::RespondTakePhotoResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 // For server plugins, this should never happen, they should always be
                 // constructible.
@@ -426,7 +410,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->respond_take_photo(
+        auto result = plugin->respond_take_photo(
             translateFromRpcTakePhotoFeedback(request->take_photo_feedback()),
             translateFromRpcCaptureInfo(request->capture_info()));
 
@@ -437,45 +421,14 @@ public:
         return grpc::Status::OK;
     }
 
-    void stop()
-    {
-        _stopped.store(true);
-        for (auto& prom : _stream_stop_promises) {
-            if (auto handle = prom.lock()) {
-                handle->set_value();
-            }
-        }
-    }
-
-private:
-    void register_stream_stop_promise(std::weak_ptr<std::promise<void>> prom)
-    {
-        // If we have already stopped, set promise immediately and don't add it to list.
-        if (_stopped.load()) {
-            if (auto handle = prom.lock()) {
-                handle->set_value();
-            }
-        } else {
-            _stream_stop_promises.push_back(prom);
-        }
-    }
+    void stop() { _streams.finish_all(); }
 
-    void unregister_stream_stop_promise(std::shared_ptr<std::promise<void>> prom)
-    {
-        for (auto it = _stream_stop_promises.begin(); it != _stream_stop_promises.end();
-             /* ++it */) {
-            if (it->lock() == prom) {
-                it = _stream_stop_promises.erase(it);
-            } else {
-                ++it;
-            }
-        }
-    }
+    const StreamStats& stream_stats() const { return _streams.stats(); }
 
+private:
     LazyServerPlugin& _lazy_plugin;
 
-    std::atomic<bool> _stopped{false};
-    std::vector<std::weak_ptr<std::promise<void>>> _stream_stop_promises{};
+    StreamList _streams{};
 };
 
 } // namespace mavsdk_server
@@ -11,6 +11,8 @@
 #include "lazy_server_plugin.h"
 
 #include "log.h"
+#include "stream_reactor.h"
+#include "system_selection.h"
 #include <atomic>
 #include <cmath>
 #include <future>
@@ -27,7 +29,9 @@ template<
     typename LazyServerPlugin = LazyServerPlugin<ComponentInformationServer>>
 
 class ComponentInformationServerServiceImpl final
-    : public rpc::component_information_server::ComponentInformationServerService::Service {
+    : public WithCallbackMethods<
+          rpc::component_information_server::ComponentInformationServerService::Service,
+          rpc::component_information_server::ComponentInformationServerService::WithCallbackMethod_SubscribeFloatParam> {
 public:
     ComponentInformationServerServiceImpl(LazyServerPlugin& lazy_plugin) : _lazy_plugin(lazy_plugin)
     {}
@@ -39,21 +43,17 @@ public:
         auto rpc_result = translateToRpcResult(result);
 
         auto* rpc_component_information_server_result =
-            new rpc::component_information_server::ComponentInformationServerResult();
+            response->mutable_component_information_server_result();
         rpc_component_information_server_result->set_result(rpc_result);
         std::stringstream ss;
         ss << result;
         rpc_component_information_server_result->set_result_str(ss.str());
-
-        response->set_allocated_component_information_server_result(
-            rpc_component_information_server_result);
     }
 
-    static std::unique_ptr<rpc::component_information_server::FloatParam>
-    translateToRpcFloatParam(const mavsdk::ComponentInformationServer::FloatParam& float_param)
+    static void translateToRpcFloatParam(
+        const mavsdk::ComponentInformationServer::FloatParam& float_param,
+        rpc::component_information_server::FloatParam* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::component_information_server::FloatParam>();
-
         rpc_obj->set_name(float_param.name);
 
         rpc_obj->set_short_description(float_param.short_description);
@@ -71,8 +71,6 @@ public:
         rpc_obj->set_min_value(float_param.min_value);
 
         rpc_obj->set_max_value(float_param.max_value);
-
-        return rpc_obj;
     }
 
     static mavsdk::ComponentInformationServer::FloatParam
@@ -101,17 +99,13 @@ public:
         return obj;
     }
 
-    static std::unique_ptr<rpc::component_information_server::FloatParamUpdate>
-    translateToRpcFloatParamUpdate(
-        const mavsdk::ComponentInformationServer::FloatParamUpdate& float_param_update)
+    static void translateToRpcFloatParamUpdate(
+        const mavsdk::ComponentInformationServer::FloatParamUpdate& float_param_update,
+        rpc::component_information_server::FloatParamUpdate* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::component_information_server::FloatParamUpdate>();
-
         rpc_obj->set_name(float_param_update.name);
 
         rpc_obj->set_value(float_param_update.value);
-
-        return rpc_obj;
     }
 
     static mavsdk::ComponentInformationServer::FloatParamUpdate translateFromRpcFloatParamUpdate(
@@ -189,11 +183,13 @@ public:
     }
 
     grpc::Status ProvideFloatParam(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::component_information_server::ProvideFloatParamRequest* request,
         rpc::component_information_server::ProvideFloatParamResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 // For server plugins, this should never happen, they should always be
                 // constructible.
@@ -209,7 +205,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->provide_float_param(
+        auto result = plugin->provide_float_param(
             translateFromRpcFloatParam(request->param()));
 
         if (response != nullptr) {
@@ -219,87 +215,48 @@ public:
         return grpc::Status::OK;
     }
 
-    grpc::Status SubscribeFloatParam(
-        grpc::ServerContext* /* context */,
-        const mavsdk::rpc::component_information_server::SubscribeFloatParamRequest* /* request */,
-        grpc::ServerWriter<rpc::component_information_server::FloatParamResponse>* writer) override
+    grpc::ServerWriteReactor<rpc::component_information_server::FloatParamResponse>*
+    SubscribeFloatParam(
+        grpc::CallbackServerContext* context,
+        const mavsdk::rpc::component_information_server::SubscribeFloatParamRequest* /* request */)
+        override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
-            return grpc::Status::OK;
-        }
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        auto reactor =
+            StreamReactor<rpc::component_information_server::FloatParamResponse>::create();
 
-        auto stream_closed_promise = std::make_shared<std::promise<void>>();
-        auto stream_closed_future = stream_closed_promise->get_future();
-        register_stream_stop_promise(stream_closed_promise);
+        if (plugin == nullptr) {
+            reactor->finish();
+            return reactor.get();
+        }
 
-        auto is_finished = std::make_shared<bool>(false);
-        auto subscribe_mutex = std::make_shared<std::mutex>();
+        _streams.add(reactor);
 
         const mavsdk::ComponentInformationServer::FloatParamHandle handle =
-            _lazy_plugin.maybe_plugin()->subscribe_float_param(
-                [this, &writer, &stream_closed_promise, is_finished, subscribe_mutex, &handle](
-                    const mavsdk::ComponentInformationServer::FloatParamUpdate float_param) {
+            plugin->subscribe_float_param(
+                [reactor](const mavsdk::ComponentInformationServer::FloatParamUpdate float_param) {
                     rpc::component_information_server::FloatParamResponse rpc_response;
 
-                    rpc_response.set_allocated_param_update(
-                        translateToRpcFloatParamUpdate(float_param).release());
-
-                    std::unique_lock<std::mutex> lock(*subscribe_mutex);
-                    if (!*is_finished && !writer->Write(rpc_response)) {
-                        _lazy_plugin.maybe_plugin()->unsubscribe_float_param(handle);
+                    translateToRpcFloatParamUpdate(
+                        float_param, rpc_response.mutable_param_update());
 
-                        *is_finished = true;
-                        unregister_stream_stop_promise(stream_closed_promise);
-                        stream_closed_promise->set_value();
-                    }
+                    reactor->write(std::move(rpc_response));
                 });
 
-        stream_closed_future.wait();
-        std::unique_lock<std::mutex> lock(*subscribe_mutex);
-        *is_finished = true;
+        reactor->set_on_done([plugin, handle]() { plugin->unsubscribe_float_param(handle); });
 
-        return grpc::Status::OK;
+        return reactor.get();
     }
 
-    void stop()
-    {
-        _stopped.store(true);
-        for (auto& prom : _stream_stop_promises) {
-            if (auto handle = prom.lock()) {
-                handle->set_value();
-            }
-        }
-    }
+    void stop() { _streams.finish_all(); }
 
-private:
-    void register_stream_stop_promise(std::weak_ptr<std::promise<void>> prom)
-    {
-        // If we have already stopped, set promise immediately and don't add it to list.
-        if (_stopped.load()) {
-            if (auto handle = prom.lock()) {
-                handle->set_value();
-            }
-        } else {
-            _stream_stop_promises.push_back(prom);
-        }
-    }
-
-    void unregister_stream_stop_promise(std::shared_ptr<std::promise<void>> prom)
-    {
-        for (auto it = _stream_stop_promises.begin(); it != _stream_stop_promises.end();
-             /* ++it */) {
-            if (it->lock() == prom) {
-                it = _stream_stop_promises.erase(it);
-            } else {
-                ++it;
-            }
-        }
-    }
+    const StreamStats& stream_stats() const { return _streams.stats(); }
 
+private:
     LazyServerPlugin& _lazy_plugin;
 
-    std::atomic<bool> _stopped{false};
-    std::vector<std::weak_ptr<std::promise<void>>> _stream_stop_promises{};
+    StreamList _streams{};
 };
 
 } // namespace mavsdk_server
@@ -10,6 +10,8 @@
 #include "lazy_plugin.h"
 
 #include "log.h"
+#include "stream_reactor.h"
+#include "system_selection.h"
 #include <atomic>
 #include <cmath>
 #include <future>
@@ -23,7 +25,7 @@ namespace mavsdk_server {
 
 template<typename Failure = Failure, typename LazyPlugin = LazyPlugin<Failure>>
 
-class FailureServiceImpl final : public rpc::failure::FailureService::Service {
+class FailureServiceImpl final : public WithCallbackMethods<rpc::failure::FailureService::Service> {
 public:
     FailureServiceImpl(LazyPlugin& lazy_plugin) : _lazy_plugin(lazy_plugin) {}
 
@@ -32,13 +34,11 @@ public:
     {
         auto rpc_result = translateToRpcResult(result);
 
-        auto* rpc_failure_result = new rpc::failure::FailureResult();
+        auto* rpc_failure_result = response->mutable_failure_result();
         rpc_failure_result->set_result(rpc_result);
         std::stringstream ss;
         ss << result;
         rpc_failure_result->set_result_str(ss.str());
-
-        response->set_allocated_failure_result(rpc_failure_result);
     }
 
     static rpc::failure::FailureUnit
@@ -226,11 +226,13 @@ public:
     }
 
     grpc::Status Inject(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::failure::InjectRequest* request,
         rpc::failure::InjectResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Failure::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -244,7 +246,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->inject(
+        auto result = plugin->inject(
             translateFromRpcFailureUnit(request->failure_unit()),
             translateFromRpcFailureType(request->failure_type()),
             request->instance());
@@ -256,45 +258,14 @@ public:
         return grpc::Status::OK;
     }
 
-    void stop()
-    {
-        _stopped.store(true);
-        for (auto& prom : _stream_stop_promises) {
-            if (auto handle = prom.lock()) {
-                handle->set_value();
-            }
-        }
-    }
+    void stop() { _streams.finish_all(); }
 
-private:
-    void register_stream_stop_promise(std::weak_ptr<std::promise<void>> prom)
-    {
-        // If we have already stopped, set promise immediately and don't add it to list.
-        if (_stopped.load()) {
-            if (auto handle = prom.lock()) {
-                handle->set_value();
-            }
-        } else {
-            _stream_stop_promises.push_back(prom);
-        }
-    }
-
-    void unregister_stream_stop_promise(std::shared_ptr<std::promise<void>> prom)
-    {
-        for (auto it = _stream_stop_promises.begin(); it != _stream_stop_promises.end();
-             /* ++it */) {
-            if (it->lock() == prom) {
-                it = _stream_stop_promises.erase(it);
-            } else {
-                ++it;
-            }
-        }
-    }
+    const StreamStats& stream_stats() const { return _streams.stats(); }
 
+private:
     LazyPlugin& _lazy_plugin;
 
-    std::atomic<bool> _stopped{false};
-    std::vector<std::weak_ptr<std::promise<void>>> _stream_stop_promises{};
+    StreamList _streams{};
 };
 
 } // namespace mavsdk_server
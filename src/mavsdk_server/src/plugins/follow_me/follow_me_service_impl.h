@@ -10,6 +10,8 @@
 #include "lazy_plugin.h"
 
 #include "log.h"
+#include "stream_reactor.h"
+#include "system_selection.h"
 #include <atomic>
 #include <cmath>
 #include <future>
@@ -23,7 +25,8 @@ namespace mavsdk_server {
 
 template<typename FollowMe = FollowMe, typename LazyPlugin = LazyPlugin<FollowMe>>
 
-class FollowMeServiceImpl final : public rpc::follow_me::FollowMeService::Service {
+class FollowMeServiceImpl final
+    : public WithCallbackMethods<rpc::follow_me::FollowMeService::Service> {
 public:
     FollowMeServiceImpl(LazyPlugin& lazy_plugin) : _lazy_plugin(lazy_plugin) {}
 
@@ -32,13 +35,11 @@ public:
     {
         auto rpc_result = translateToRpcResult(result);
 
-        auto* rpc_follow_me_result = new rpc::follow_me::FollowMeResult();
+        auto* rpc_follow_me_result = response->mutable_follow_me_result();
         rpc_follow_me_result->set_result(rpc_result);
         std::stringstream ss;
         ss << result;
         rpc_follow_me_result->set_result_str(ss.str());
-
-        response->set_allocated_follow_me_result(rpc_follow_me_result);
     }
 
     static rpc::follow_me::Config::FollowAltitudeMode translateToRpcFollowAltitudeMode(
@@ -75,11 +76,9 @@ public:
         }
     }
 
-    static std::unique_ptr<rpc::follow_me::Config>
-    translateToRpcConfig(const mavsdk::FollowMe::Config& config)
+    static void translateToRpcConfig(
+        const mavsdk::FollowMe::Config& config, rpc::follow_me::Config* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::follow_me::Config>();
-
         rpc_obj->set_follow_height_m(config.follow_height_m);
 
         rpc_obj->set_follow_distance_m(config.follow_distance_m);
@@ -91,8 +90,6 @@ public:
         rpc_obj->set_max_tangential_vel_m_s(config.max_tangential_vel_m_s);
 
         rpc_obj->set_follow_angle_deg(config.follow_angle_deg);
-
-        return rpc_obj;
     }
 
     static mavsdk::FollowMe::Config translateFromRpcConfig(const rpc::follow_me::Config& config)
@@ -114,11 +111,10 @@ public:
         return obj;
     }
 
-    static std::unique_ptr<rpc::follow_me::TargetLocation>
-    translateToRpcTargetLocation(const mavsdk::FollowMe::TargetLocation& target_location)
+    static void translateToRpcTargetLocation(
+        const mavsdk::FollowMe::TargetLocation& target_location,
+        rpc::follow_me::TargetLocation* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::follow_me::TargetLocation>();
-
         rpc_obj->set_latitude_deg(target_location.latitude_deg);
 
         rpc_obj->set_longitude_deg(target_location.longitude_deg);
@@ -130,8 +126,6 @@ public:
         rpc_obj->set_velocity_y_m_s(target_location.velocity_y_m_s);
 
         rpc_obj->set_velocity_z_m_s(target_location.velocity_z_m_s);
-
-        return rpc_obj;
     }
 
     static mavsdk::FollowMe::TargetLocation
@@ -211,29 +205,33 @@ public:
     }
 
     grpc::Status GetConfig(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::follow_me::GetConfigRequest* /* request */,
         rpc::follow_me::GetConfigResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->get_config();
+        auto result = plugin->get_config();
 
         if (response != nullptr) {
-            response->set_allocated_config(translateToRpcConfig(result).release());
+            translateToRpcConfig(result, response->mutable_config());
         }
 
         return grpc::Status::OK;
     }
 
     grpc::Status SetConfig(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::follow_me::SetConfigRequest* request,
         rpc::follow_me::SetConfigResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::FollowMe::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -248,7 +246,7 @@ public:
         }
 
         auto result =
-            _lazy_plugin.maybe_plugin()->set_config(translateFromRpcConfig(request->config()));
+            plugin->set_config(translateFromRpcConfig(request->config()));
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -258,15 +256,17 @@ public:
     }
 
     grpc::Status IsActive(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::follow_me::IsActiveRequest* /* request */,
         rpc::follow_me::IsActiveResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->is_active();
+        auto result = plugin->is_active();
 
         if (response != nullptr) {
             response->set_is_active(result);
@@ -276,11 +276,13 @@ public:
     }
 
     grpc::Status SetTargetLocation(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::follow_me::SetTargetLocationRequest* request,
         rpc::follow_me::SetTargetLocationResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::FollowMe::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -294,7 +296,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->set_target_location(
+        auto result = plugin->set_target_location(
             translateFromRpcTargetLocation(request->location()));
 
         if (response != nullptr) {
@@ -305,29 +307,33 @@ public:
     }
 
     grpc::Status GetLastLocation(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::follow_me::GetLastLocationRequest* /* request */,
         rpc::follow_me::GetLastLocationResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->get_last_location();
+        auto result = plugin->get_last_location();
 
         if (response != nullptr) {
-            response->set_allocated_location(translateToRpcTargetLocation(result).release());
+            translateToRpcTargetLocation(result, response->mutable_location());
         }
 
         return grpc::Status::OK;
     }
 
     grpc::Status Start(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::follow_me::StartRequest* /* request */,
         rpc::follow_me::StartResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::FollowMe::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -336,7 +342,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->start();
+        auto result = plugin->start();
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -346,11 +352,13 @@ public:
     }
 
     grpc::Status Stop(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::follow_me::StopRequest* /* request */,
         rpc::follow_me::StopResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::FollowMe::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -359,7 +367,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->stop();
+        auto result = plugin->stop();
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -368,45 +376,14 @@ public:
         return grpc::Status::OK;
     }
 
-    void stop()
-    {
-        _stopped.store(true);
-        for (auto& prom : _stream_stop_promises) {
-            if (auto handle = prom.lock()) {
-                handle->set_value();
-            }
-        }
-    }
+    void stop() { _streams.finish_all(); }
 
-private:
-    void register_stream_stop_promise(std::weak_ptr<std::promise<void>> prom)
-    {
-        // If we have already stopped, set promise immediately and don't add it to list.
-        if (_stopped.load()) {
-            if (auto handle = prom.lock()) {
-                handle->set_value();
-            }
-        } else {
-            _stream_stop_promises.push_back(prom);
-        }
-    }
-
-    void unregister_stream_stop_promise(std::shared_ptr<std::promise<void>> prom)
-    {
-        for (auto it = _stream_stop_promises.begin(); it != _stream_stop_promises.end();
-             /* ++it */) {
-            if (it->lock() == prom) {
-                it = _stream_stop_promises.erase(it);
-            } else {
-                ++it;
-            }
-        }
-    }
+    const StreamStats& stream_stats() const { return _streams.stats(); }
 
+private:
     LazyPlugin& _lazy_plugin;
 
-    std::atomic<bool> _stopped{false};
-    std::vector<std::weak_ptr<std::promise<void>>> _stream_stop_promises{};
+    StreamList _streams{};
 };
 
 } // namespace mavsdk_server
@@ -10,6 +10,8 @@
 #include "lazy_plugin.h"
 
 #include "log.h"
+#include "stream_reactor.h"
+#include "system_selection.h"
 #include <atomic>
 #include <cmath>
 #include <future>
@@ -23,7 +25,11 @@ namespace mavsdk_server {
 
 template<typename Ftp = Ftp, typename LazyPlugin = LazyPlugin<Ftp>>
 
-class FtpServiceImpl final : public rpc::ftp::FtpService::Service {
+class FtpServiceImpl final
+    : public WithCallbackMethods<
+          rpc::ftp::FtpService::Service,
+          rpc::ftp::FtpService::WithCallbackMethod_SubscribeDownload,
+          rpc::ftp::FtpService::WithCallbackMethod_SubscribeUpload> {
 public:
     FtpServiceImpl(LazyPlugin& lazy_plugin) : _lazy_plugin(lazy_plugin) {}
 
@@ -32,25 +38,19 @@ public:
     {
         auto rpc_result = translateToRpcResult(result);
 
-        auto* rpc_ftp_result = new rpc::ftp::FtpResult();
+        auto* rpc_ftp_result = response->mutable_ftp_result();
         rpc_ftp_result->set_result(rpc_result);
         std::stringstream ss;
         ss << result;
         rpc_ftp_result->set_result_str(ss.str());
-
-        response->set_allocated_ftp_result(rpc_ftp_result);
     }
 
-    static std::unique_ptr<rpc::ftp::ProgressData>
-    translateToRpcProgressData(const mavsdk::Ftp::ProgressData& progress_data)
+    static void translateToRpcProgressData(
+        const mavsdk::Ftp::ProgressData& progress_data, rpc::ftp::ProgressData* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::ftp::ProgressData>();
-
         rpc_obj->set_bytes_transferred(progress_data.bytes_transferred);
 
         rpc_obj->set_total_bytes(progress_data.total_bytes);
-
-        return rpc_obj;
     }
 
     static mavsdk::Ftp::ProgressData
@@ -136,11 +136,13 @@ public:
     }
 
     grpc::Status Reset(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::ftp::ResetRequest* /* request */,
         rpc::ftp::ResetResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Ftp::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -152,7 +154,7 @@ public:
         std::promise<mavsdk::Ftp::Result> prom;
         std::future<mavsdk::Ftp::Result> fut = prom.get_future();
 
-        _lazy_plugin.maybe_plugin()->reset_async(
+        plugin->reset_async(
             [&prom](const mavsdk::Ftp::Result result) { prom.set_value(result); });
         auto result = fut.get();
 
@@ -163,120 +165,96 @@ public:
         return grpc::Status::OK;
     }
 
-    grpc::Status SubscribeDownload(
-        grpc::ServerContext* /* context */,
-        const mavsdk::rpc::ftp::SubscribeDownloadRequest* request,
-        grpc::ServerWriter<rpc::ftp::DownloadResponse>* writer) override
+    grpc::ServerWriteReactor<rpc::ftp::DownloadResponse>* SubscribeDownload(
+        grpc::CallbackServerContext* context,
+        const mavsdk::rpc::ftp::SubscribeDownloadRequest* request) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        auto reactor = StreamReactor<rpc::ftp::DownloadResponse>::create();
+
+        if (plugin == nullptr) {
             rpc::ftp::DownloadResponse rpc_response;
             auto result = mavsdk::Ftp::Result::NoSystem;
             fillResponseWithResult(&rpc_response, result);
-            writer->Write(rpc_response);
+            reactor->write(std::move(rpc_response));
 
-            return grpc::Status::OK;
+            reactor->finish();
+            return reactor.get();
         }
 
-        auto stream_closed_promise = std::make_shared<std::promise<void>>();
-        auto stream_closed_future = stream_closed_promise->get_future();
-        register_stream_stop_promise(stream_closed_promise);
-
-        auto is_finished = std::make_shared<bool>(false);
-        auto subscribe_mutex = std::make_shared<std::mutex>();
+        _streams.add(reactor);
 
-        _lazy_plugin.maybe_plugin()->download_async(
+        plugin->download_async(
             request->remote_file_path(),
             request->local_dir(),
-            [this, &writer, &stream_closed_promise, is_finished, subscribe_mutex](
-                mavsdk::Ftp::Result result, const mavsdk::Ftp::ProgressData download) {
+            [reactor](mavsdk::Ftp::Result result, const mavsdk::Ftp::ProgressData download) {
                 rpc::ftp::DownloadResponse rpc_response;
 
-                rpc_response.set_allocated_progress_data(
-                    translateToRpcProgressData(download).release());
+                translateToRpcProgressData(download, rpc_response.mutable_progress_data());
 
                 auto rpc_result = translateToRpcResult(result);
-                auto* rpc_ftp_result = new rpc::ftp::FtpResult();
+                auto* rpc_ftp_result = rpc_response.mutable_ftp_result();
                 rpc_ftp_result->set_result(rpc_result);
                 std::stringstream ss;
                 ss << result;
                 rpc_ftp_result->set_result_str(ss.str());
-                rpc_response.set_allocated_ftp_result(rpc_ftp_result);
-
-                std::unique_lock<std::mutex> lock(*subscribe_mutex);
-                if (!*is_finished && !writer->Write(rpc_response)) {
-                    *is_finished = true;
-                    unregister_stream_stop_promise(stream_closed_promise);
-                    stream_closed_promise->set_value();
-                }
-            });
 
-        stream_closed_future.wait();
-        std::unique_lock<std::mutex> lock(*subscribe_mutex);
-        *is_finished = true;
+                reactor->write(std::move(rpc_response));
+            });
 
-        return grpc::Status::OK;
+        return reactor.get();
     }
 
-    grpc::Status SubscribeUpload(
-        grpc::ServerContext* /* context */,
-        const mavsdk::rpc::ftp::SubscribeUploadRequest* request,
-        grpc::ServerWriter<rpc::ftp::UploadResponse>* writer) override
+    grpc::ServerWriteReactor<rpc::ftp::UploadResponse>* SubscribeUpload(
+        grpc::CallbackServerContext* context,
+        const mavsdk::rpc::ftp::SubscribeUploadRequest* request) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        auto reactor = StreamReactor<rpc::ftp::UploadResponse>::create();
+
+        if (plugin == nullptr) {
             rpc::ftp::UploadResponse rpc_response;
             auto result = mavsdk::Ftp::Result::NoSystem;
             fillResponseWithResult(&rpc_response, result);
-            writer->Write(rpc_response);
+            reactor->write(std::move(rpc_response));
 
-            return grpc::Status::OK;
+            reactor->finish();
+            return reactor.get();
         }
 
-        auto stream_closed_promise = std::make_shared<std::promise<void>>();
-        auto stream_closed_future = stream_closed_promise->get_future();
-        register_stream_stop_promise(stream_closed_promise);
+        _streams.add(reactor);
 
-        auto is_finished = std::make_shared<bool>(false);
-        auto subscribe_mutex = std::make_shared<std::mutex>();
-
-        _lazy_plugin.maybe_plugin()->upload_async(
+        plugin->upload_async(
             request->local_file_path(),
             request->remote_dir(),
-            [this, &writer, &stream_closed_promise, is_finished, subscribe_mutex](
-                mavsdk::Ftp::Result result, const mavsdk::Ftp::ProgressData upload) {
+            [reactor](mavsdk::Ftp::Result result, const mavsdk::Ftp::ProgressData upload) {
                 rpc::ftp::UploadResponse rpc_response;
 
-                rpc_response.set_allocated_progress_data(
-                    translateToRpcProgressData(upload).release());
+                translateToRpcProgressData(upload, rpc_response.mutable_progress_data());
 
                 auto rpc_result = translateToRpcResult(result);
-                auto* rpc_ftp_result = new rpc::ftp::FtpResult();
+                auto* rpc_ftp_result = rpc_response.mutable_ftp_result();
                 rpc_ftp_result->set_result(rpc_result);
                 std::stringstream ss;
                 ss << result;
                 rpc_ftp_result->set_result_str(ss.str());
-                rpc_response.set_allocated_ftp_result(rpc_ftp_result);
-
-                std::unique_lock<std::mutex> lock(*subscribe_mutex);
-                if (!*is_finished && !writer->Write(rpc_response)) {
-                    *is_finished = true;
-                    unregister_stream_stop_promise(stream_closed_promise);
-                    stream_closed_promise->set_value();
-                }
-            });
 
-        stream_closed_future.wait();
-        std::unique_lock<std::mutex> lock(*subscribe_mutex);
-        *is_finished = true;
+                reactor->write(std::move(rpc_response));
+            });
 
-        return grpc::Status::OK;
+        return reactor.get();
     }
 
     grpc::Status ListDirectory(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::ftp::ListDirectoryRequest* request,
         rpc::ftp::ListDirectoryResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Ftp::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -290,7 +268,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->list_directory(request->remote_dir());
+        auto result = plugin->list_directory(request->remote_dir());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result.first);
@@ -304,11 +282,13 @@ public:
     }
 
     grpc::Status CreateDirectory(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::ftp::CreateDirectoryRequest* request,
         rpc::ftp::CreateDirectoryResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Ftp::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -322,7 +302,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->create_directory(request->remote_dir());
+        auto result = plugin->create_directory(request->remote_dir());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -332,11 +312,13 @@ public:
     }
 
     grpc::Status RemoveDirectory(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::ftp::RemoveDirectoryRequest* request,
         rpc::ftp::RemoveDirectoryResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Ftp::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -350,7 +332,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->remove_directory(request->remote_dir());
+        auto result = plugin->remove_directory(request->remote_dir());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -360,11 +342,13 @@ public:
     }
 
     grpc::Status RemoveFile(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::ftp::RemoveFileRequest* request,
         rpc::ftp::RemoveFileResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Ftp::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -378,7 +362,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->remove_file(request->remote_file_path());
+        auto result = plugin->remove_file(request->remote_file_path());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -388,11 +372,13 @@ public:
     }
 
     grpc::Status Rename(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::ftp::RenameRequest* request,
         rpc::ftp::RenameResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Ftp::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -406,7 +392,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->rename(
+        auto result = plugin->rename(
             request->remote_from_path(), request->remote_to_path());
 
         if (response != nullptr) {
@@ -417,11 +403,13 @@ public:
     }
 
     grpc::Status AreFilesIdentical(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::ftp::AreFilesIdenticalRequest* request,
         rpc::ftp::AreFilesIdenticalResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Ftp::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -435,7 +423,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->are_files_identical(
+        auto result = plugin->are_files_identical(
             request->local_file_path(), request->remote_file_path());
 
         if (response != nullptr) {
@@ -448,11 +436,13 @@ public:
     }
 
     grpc::Status SetRootDirectory(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::ftp::SetRootDirectoryRequest* request,
         rpc::ftp::SetRootDirectoryResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Ftp::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -466,7 +456,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->set_root_directory(request->root_dir());
+        auto result = plugin->set_root_directory(request->root_dir());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -476,11 +466,13 @@ public:
     }
 
     grpc::Status SetTargetCompid(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::ftp::SetTargetCompidRequest* request,
         rpc::ftp::SetTargetCompidResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Ftp::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -494,7 +486,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->set_target_compid(request->compid());
+        auto result = plugin->set_target_compid(request->compid());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -504,15 +496,17 @@ public:
     }
 
     grpc::Status GetOurCompid(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::ftp::GetOurCompidRequest* /* request */,
         rpc::ftp::GetOurCompidResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->get_our_compid();
+        auto result = plugin->get_our_compid();
 
         if (response != nullptr) {
             response->set_compid(result);
@@ -521,45 +515,14 @@ public:
         return grpc::Status::OK;
     }
 
-    void stop()
-    {
-        _stopped.store(true);
-        for (auto& prom : _stream_stop_promises) {
-            if (auto handle = prom.lock()) {
-                handle->set_value();
-            }
-        }
-    }
+    void stop() { _streams.finish_all(); }
 
-private:
-    void register_stream_stop_promise(std::weak_ptr<std::promise<void>> prom)
-    {
-        // If we have already stopped, set promise immediately and don't add it to list.
-        if (_stopped.load()) {
-            if (auto handle = prom.lock()) {
-                handle->set_value();
-            }
-        } else {
-            _stream_stop_promises.push_back(prom);
-        }
-    }
-
-    void unregister_stream_stop_promise(std::shared_ptr<std::promise<void>> prom)
-    {
-        for (auto it = _stream_stop_promises.begin(); it != _stream_stop_promises.end();
-             /* ++it */) {
-            if (it->lock() == prom) {
-                it = _stream_stop_promises.erase(it);
-            } else {
-                ++it;
-            }
-        }
-    }
+    const StreamStats& stream_stats() const { return _streams.stats(); }
 
+private:
     LazyPlugin& _lazy_plugin;
 
-    std::atomic<bool> _stopped{false};
-    std::vector<std::weak_ptr<std::promise<void>>> _stream_stop_promises{};
+    StreamList _streams{};
 };
 
 } // namespace mavsdk_server
@@ -10,6 +10,8 @@
 #include "lazy_plugin.h"
 
 #include "log.h"
+#include "stream_reactor.h"
+#include "system_selection.h"
 #include <atomic>
 #include <cmath>
 #include <future>
@@ -23,7 +25,8 @@ namespace mavsdk_server {
 
 template<typename Geofence = Geofence, typename LazyPlugin = LazyPlugin<Geofence>>
 
-class GeofenceServiceImpl final : public rpc::geofence::GeofenceService::Service {
+class GeofenceServiceImpl final
+    : public WithCallbackMethods<rpc::geofence::GeofenceService::Service> {
 public:
     GeofenceServiceImpl(LazyPlugin& lazy_plugin) : _lazy_plugin(lazy_plugin) {}
 
@@ -32,13 +35,11 @@ public:
     {
         auto rpc_result = translateToRpcResult(result);
 
-        auto* rpc_geofence_result = new rpc::geofence::GeofenceResult();
+        auto* rpc_geofence_result = response->mutable_geofence_result();
         rpc_geofence_result->set_result(rpc_result);
         std::stringstream ss;
         ss << result;
         rpc_geofence_result->set_result_str(ss.str());
-
-        response->set_allocated_geofence_result(rpc_geofence_result);
     }
 
     static rpc::geofence::FenceType
@@ -69,16 +70,12 @@ public:
         }
     }
 
-    static std::unique_ptr<rpc::geofence::Point>
-    translateToRpcPoint(const mavsdk::Geofence::Point& point)
+    static void translateToRpcPoint(
+        const mavsdk::Geofence::Point& point, rpc::geofence::Point* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::geofence::Point>();
-
         rpc_obj->set_latitude_deg(point.latitude_deg);
 
         rpc_obj->set_longitude_deg(point.longitude_deg);
-
-        return rpc_obj;
     }
 
     static mavsdk::Geofence::Point translateFromRpcPoint(const rpc::geofence::Point& point)
@@ -92,19 +89,14 @@ public:
         return obj;
     }
 
-    static std::unique_ptr<rpc::geofence::Polygon>
-    translateToRpcPolygon(const mavsdk::Geofence::Polygon& polygon)
+    static void translateToRpcPolygon(
+        const mavsdk::Geofence::Polygon& polygon, rpc::geofence::Polygon* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::geofence::Polygon>();
-
         for (const auto& elem : polygon.points) {
-            auto* ptr = rpc_obj->add_points();
-            ptr->CopyFrom(*translateToRpcPoint(elem).release());
+            translateToRpcPoint(elem, rpc_obj->add_points());
         }
 
         rpc_obj->set_fence_type(translateToRpcFenceType(polygon.fence_type));
-
-        return rpc_obj;
     }
 
     static mavsdk::Geofence::Polygon translateFromRpcPolygon(const rpc::geofence::Polygon& polygon)
@@ -121,18 +113,14 @@ public:
         return obj;
     }
 
-    static std::unique_ptr<rpc::geofence::Circle>
-    translateToRpcCircle(const mavsdk::Geofence::Circle& circle)
+    static void translateToRpcCircle(
+        const mavsdk::Geofence::Circle& circle, rpc::geofence::Circle* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::geofence::Circle>();
-
-        rpc_obj->set_allocated_point(translateToRpcPoint(circle.point).release());
+        translateToRpcPoint(circle.point, rpc_obj->mutable_point());
 
         rpc_obj->set_radius(circle.radius);
 
         rpc_obj->set_fence_type(translateToRpcFenceType(circle.fence_type));
-
-        return rpc_obj;
     }
 
     static mavsdk::Geofence::Circle translateFromRpcCircle(const rpc::geofence::Circle& circle)
@@ -148,22 +136,16 @@ public:
         return obj;
     }
 
-    static std::unique_ptr<rpc::geofence::GeofenceData>
-    translateToRpcGeofenceData(const mavsdk::Geofence::GeofenceData& geofence_data)
+    static void translateToRpcGeofenceData(
+        const mavsdk::Geofence::GeofenceData& geofence_data, rpc::geofence::GeofenceData* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::geofence::GeofenceData>();
-
         for (const auto& elem : geofence_data.polygons) {
-            auto* ptr = rpc_obj->add_polygons();
-            ptr->CopyFrom(*translateToRpcPolygon(elem).release());
+            translateToRpcPolygon(elem, rpc_obj->add_polygons());
         }
 
         for (const auto& elem : geofence_data.circles) {
-            auto* ptr = rpc_obj->add_circles();
-            ptr->CopyFrom(*translateToRpcCircle(elem).release());
+            translateToRpcCircle(elem, rpc_obj->add_circles());
         }
-
-        return rpc_obj;
     }
 
     static mavsdk::Geofence::GeofenceData
@@ -237,11 +219,13 @@ public:
     }
 
     grpc::Status UploadGeofence(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::geofence::UploadGeofenceRequest* request,
         rpc::geofence::UploadGeofenceResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Geofence::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -255,7 +239,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->upload_geofence(
+        auto result = plugin->upload_geofence(
             translateFromRpcGeofenceData(request->geofence_data()));
 
         if (response != nullptr) {
@@ -266,11 +250,13 @@ public:
     }
 
     grpc::Status ClearGeofence(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::geofence::ClearGeofenceRequest* /* request */,
         rpc::geofence::ClearGeofenceResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Geofence::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -279,7 +265,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->clear_geofence();
+        auto result = plugin->clear_geofence();
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -288,45 +274,14 @@ public:
         return grpc::Status::OK;
     }
 
-    void stop()
-    {
-        _stopped.store(true);
-        for (auto& prom : _stream_stop_promises) {
-            if (auto handle = prom.lock()) {
-                handle->set_value();
-            }
-        }
-    }
-
-private:
-    void register_stream_stop_promise(std::weak_ptr<std::promise<void>> prom)
-    {
-        // If we have already stopped, set promise immediately and don't add it to list.
-        if (_stopped.load()) {
-            if (auto handle = prom.lock()) {
-                handle->set_value();
-            }
-        } else {
-            _stream_stop_promises.push_back(prom);
-        }
-    }
+    void stop() { _streams.finish_all(); }
 
-    void unregister_stream_stop_promise(std::shared_ptr<std::promise<void>> prom)
-    {
-        for (auto it = _stream_stop_promises.begin(); it != _stream_stop_promises.end();
-             /* ++it */) {
-            if (it->lock() == prom) {
-                it = _stream_stop_promises.erase(it);
-            } else {
-                ++it;
-            }
-        }
-    }
+    const StreamStats& stream_stats() const { return _streams.stats(); }
 
+private:
     LazyPlugin& _lazy_plugin;
 
-    std::atomic<bool> _stopped{false};
-    std::vector<std::weak_ptr<std::promise<void>>> _stream_stop_promises{};
+    StreamList _streams{};
 };
 
 } // namespace mavsdk_server
@@ -10,6 +10,8 @@
 #include "lazy_plugin.h"
 
 #include "log.h"
+#include "stream_reactor.h"
+#include "system_selection.h"
 #include <atomic>
 #include <cmath>
 #include <future>
@@ -23,7 +25,10 @@ namespace mavsdk_server {
 
 template<typename Gimbal = Gimbal, typename LazyPlugin = LazyPlugin<Gimbal>>
 
-class GimbalServiceImpl final : public rpc::gimbal::GimbalService::Service {
+class GimbalServiceImpl final
+    : public WithCallbackMethods<
+          rpc::gimbal::GimbalService::Service,
+          rpc::gimbal::GimbalService::WithCallbackMethod_SubscribeControl> {
 public:
     GimbalServiceImpl(LazyPlugin& lazy_plugin) : _lazy_plugin(lazy_plugin) {}
 
@@ -32,13 +37,11 @@ public:
     {
         auto rpc_result = translateToRpcResult(result);
 
-        auto* rpc_gimbal_result = new rpc::gimbal::GimbalResult();
+        auto* rpc_gimbal_result = response->mutable_gimbal_result();
         rpc_gimbal_result->set_result(rpc_result);
         std::stringstream ss;
         ss << result;
         rpc_gimbal_result->set_result_str(ss.str());
-
-        response->set_allocated_gimbal_result(rpc_gimbal_result);
     }
 
     static rpc::gimbal::GimbalMode
@@ -101,11 +104,9 @@ public:
         }
     }
 
-    static std::unique_ptr<rpc::gimbal::ControlStatus>
-    translateToRpcControlStatus(const mavsdk::Gimbal::ControlStatus& control_status)
+    static void translateToRpcControlStatus(
+        const mavsdk::Gimbal::ControlStatus& control_status, rpc::gimbal::ControlStatus* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::gimbal::ControlStatus>();
-
         rpc_obj->set_control_mode(translateToRpcControlMode(control_status.control_mode));
 
         rpc_obj->set_sysid_primary_control(control_status.sysid_primary_control);
@@ -115,8 +116,6 @@ public:
         rpc_obj->set_sysid_secondary_control(control_status.sysid_secondary_control);
 
         rpc_obj->set_compid_secondary_control(control_status.compid_secondary_control);
-
-        return rpc_obj;
     }
 
     static mavsdk::Gimbal::ControlStatus
@@ -182,11 +181,13 @@ public:
     }
 
     grpc::Status SetPitchAndYaw(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::gimbal::SetPitchAndYawRequest* request,
         rpc::gimbal::SetPitchAndYawResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Gimbal::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -200,7 +201,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->set_pitch_and_yaw(
+        auto result = plugin->set_pitch_and_yaw(
             request->pitch_deg(), request->yaw_deg());
 
         if (response != nullptr) {
@@ -211,11 +212,13 @@ public:
     }
 
     grpc::Status SetPitchRateAndYawRate(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::gimbal::SetPitchRateAndYawRateRequest* request,
         rpc::gimbal::SetPitchRateAndYawRateResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Gimbal::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -229,7 +232,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->set_pitch_rate_and_yaw_rate(
+        auto result = plugin->set_pitch_rate_and_yaw_rate(
             request->pitch_rate_deg_s(), request->yaw_rate_deg_s());
 
         if (response != nullptr) {
@@ -240,11 +243,13 @@ public:
     }
 
     grpc::Status SetMode(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::gimbal::SetModeRequest* request,
         rpc::gimbal::SetModeResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Gimbal::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -258,7 +263,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->set_mode(
+        auto result = plugin->set_mode(
             translateFromRpcGimbalMode(request->gimbal_mode()));
 
         if (response != nullptr) {
@@ -269,11 +274,13 @@ public:
     }
 
     grpc::Status SetRoiLocation(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::gimbal::SetRoiLocationRequest* request,
         rpc::gimbal::SetRoiLocationResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Gimbal::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -287,7 +294,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->set_roi_location(
+        auto result = plugin->set_roi_location(
             request->latitude_deg(), request->longitude_deg(), request->altitude_m());
 
         if (response != nullptr) {
@@ -298,11 +305,13 @@ public:
     }
 
     grpc::Status TakeControl(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::gimbal::TakeControlRequest* request,
         rpc::gimbal::TakeControlResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Gimbal::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -316,7 +325,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->take_control(
+        auto result = plugin->take_control(
             translateFromRpcControlMode(request->control_mode()));
 
         if (response != nullptr) {
@@ -327,11 +336,13 @@ public:
     }
 
     grpc::Status ReleaseControl(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::gimbal::ReleaseControlRequest* /* request */,
         rpc::gimbal::ReleaseControlResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Gimbal::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -340,7 +351,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->release_control();
+        auto result = plugin->release_control();
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -349,86 +360,43 @@ public:
         return grpc::Status::OK;
     }
 
-    grpc::Status SubscribeControl(
-        grpc::ServerContext* /* context */,
-        const mavsdk::rpc::gimbal::SubscribeControlRequest* /* request */,
-        grpc::ServerWriter<rpc::gimbal::ControlResponse>* writer) override
+    grpc::ServerWriteReactor<rpc::gimbal::ControlResponse>* SubscribeControl(
+        grpc::CallbackServerContext* context,
+        const mavsdk::rpc::gimbal::SubscribeControlRequest* /* request */) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
-            return grpc::Status::OK;
-        }
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
 
-        auto stream_closed_promise = std::make_shared<std::promise<void>>();
-        auto stream_closed_future = stream_closed_promise->get_future();
-        register_stream_stop_promise(stream_closed_promise);
+        auto reactor = StreamReactor<rpc::gimbal::ControlResponse>::create();
 
-        auto is_finished = std::make_shared<bool>(false);
-        auto subscribe_mutex = std::make_shared<std::mutex>();
+        if (plugin == nullptr) {
+            reactor->finish();
+            return reactor.get();
+        }
 
-        const mavsdk::Gimbal::ControlHandle handle = _lazy_plugin.maybe_plugin()->subscribe_control(
-            [this, &writer, &stream_closed_promise, is_finished, subscribe_mutex, &handle](
-                const mavsdk::Gimbal::ControlStatus control) {
-                rpc::gimbal::ControlResponse rpc_response;
+        _streams.add(reactor);
 
-                rpc_response.set_allocated_control_status(
-                    translateToRpcControlStatus(control).release());
+        const mavsdk::Gimbal::ControlHandle handle = plugin->subscribe_control(
+            [reactor](const mavsdk::Gimbal::ControlStatus control) {
+                rpc::gimbal::ControlResponse rpc_response;
 
-                std::unique_lock<std::mutex> lock(*subscribe_mutex);
-                if (!*is_finished && !writer->Write(rpc_response)) {
-                    _lazy_plugin.maybe_plugin()->unsubscribe_control(handle);
+                translateToRpcControlStatus(control, rpc_response.mutable_control_status());
 
-                    *is_finished = true;
-                    unregister_stream_stop_promise(stream_closed_promise);
-                    stream_closed_promise->set_value();
-                }
+                reactor->write(std::move(rpc_response));
             });
 
-        stream_closed_future.wait();
-        std::unique_lock<std::mutex> lock(*subscribe_mutex);
-        *is_finished = true;
-
-        return grpc::Status::OK;
-    }
+        reactor->set_on_done([plugin, handle]() { plugin->unsubscribe_control(handle); });
 
-    void stop()
-    {
-        _stopped.store(true);
-        for (auto& prom : _stream_stop_promises) {
-            if (auto handle = prom.lock()) {
-                handle->set_value();
-            }
-        }
+        return reactor.get();
     }
 
-private:
-    void register_stream_stop_promise(std::weak_ptr<std::promise<void>> prom)
-    {
-        // If we have already stopped, set promise immediately and don't add it to list.
-        if (_stopped.load()) {
-            if (auto handle = prom.lock()) {
-                handle->set_value();
-            }
-        } else {
-            _stream_stop_promises.push_back(prom);
-        }
-    }
+    void stop() { _streams.finish_all(); }
 
-    void unregister_stream_stop_promise(std::shared_ptr<std::promise<void>> prom)
-    {
-        for (auto it = _stream_stop_promises.begin(); it != _stream_stop_promises.end();
-             /* ++it */) {
-            if (it->lock() == prom) {
-                it = _stream_stop_promises.erase(it);
-            } else {
-                ++it;
-            }
-        }
-    }
+    const StreamStats& stream_stats() const { return _streams.stats(); }
 
+private:
     LazyPlugin& _lazy_plugin;
 
-    std::atomic<bool> _stopped{false};
-    std::vector<std::weak_ptr<std::promise<void>>> _stream_stop_promises{};
+    StreamList _streams{};
 };
 
 } // namespace mavsdk_server
@@ -10,6 +10,8 @@
 #include "lazy_plugin.h"
 
 #include "log.h"
+#include "stream_reactor.h"
+#include "system_selection.h"
 #include <atomic>
 #include <cmath>
 #include <future>
@@ -23,7 +25,7 @@ namespace mavsdk_server {
 
 template<typename Gripper = Gripper, typename LazyPlugin = LazyPlugin<Gripper>>
 
-class GripperServiceImpl final : public rpc::gripper::GripperService::Service {
+class GripperServiceImpl final : public WithCallbackMethods<rpc::gripper::GripperService::Service> {
 public:
     GripperServiceImpl(LazyPlugin& lazy_plugin) : _lazy_plugin(lazy_plugin) {}
 
@@ -32,13 +34,11 @@ public:
     {
         auto rpc_result = translateToRpcResult(result);
 
-        auto* rpc_gripper_result = new rpc::gripper::GripperResult();
+        auto* rpc_gripper_result = response->mutable_gripper_result();
         rpc_gripper_result->set_result(rpc_result);
         std::stringstream ss;
         ss << result;
         rpc_gripper_result->set_result_str(ss.str());
-
-        response->set_allocated_gripper_result(rpc_gripper_result);
     }
 
     static rpc::gripper::GripperAction
@@ -120,11 +120,13 @@ public:
     }
 
     grpc::Status Grab(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::gripper::GrabRequest* request,
         rpc::gripper::GrabResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Gripper::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -138,7 +140,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->grab(request->instance());
+        auto result = plugin->grab(request->instance());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -148,11 +150,13 @@ public:
     }
 
     grpc::Status Release(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::gripper::ReleaseRequest* request,
         rpc::gripper::ReleaseResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Gripper::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -166,7 +170,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->release(request->instance());
+        auto result = plugin->release(request->instance());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -175,45 +179,14 @@ public:
         return grpc::Status::OK;
     }
 
-    void stop()
-    {
-        _stopped.store(true);
-        for (auto& prom : _stream_stop_promises) {
-            if (auto handle = prom.lock()) {
-                handle->set_value();
-            }
-        }
-    }
-
-private:
-    void register_stream_stop_promise(std::weak_ptr<std::promise<void>> prom)
-    {
-        // If we have already stopped, set promise immediately and don't add it to list.
-        if (_stopped.load()) {
-            if (auto handle = prom.lock()) {
-                handle->set_value();
-            }
-        } else {
-            _stream_stop_promises.push_back(prom);
-        }
-    }
+    void stop() { _streams.finish_all(); }
 
-    void unregister_stream_stop_promise(std::shared_ptr<std::promise<void>> prom)
-    {
-        for (auto it = _stream_stop_promises.begin(); it != _stream_stop_promises.end();
-             /* ++it */) {
-            if (it->lock() == prom) {
-                it = _stream_stop_promises.erase(it);
-            } else {
-                ++it;
-            }
-        }
-    }
+    const StreamStats& stream_stats() const { return _streams.stats(); }
 
+private:
     LazyPlugin& _lazy_plugin;
 
-    std::atomic<bool> _stopped{false};
-    std::vector<std::weak_ptr<std::promise<void>>> _stream_stop_promises{};
+    StreamList _streams{};
 };
 
 } // namespace mavsdk_server
@@ -10,6 +10,8 @@
 #include "lazy_plugin.h"
 
 #include "log.h"
+#include "stream_reactor.h"
+#include "system_selection.h"
 #include <atomic>
 #include <cmath>
 #include <future>
@@ -23,7 +25,7 @@ namespace mavsdk_server {
 
 template<typename Info = Info, typename LazyPlugin = LazyPlugin<Info>>
 
-class InfoServiceImpl final : public rpc::info::InfoService::Service {
+class InfoServiceImpl final : public WithCallbackMethods<rpc::info::InfoService::Service> {
 public:
     InfoServiceImpl(LazyPlugin& lazy_plugin) : _lazy_plugin(lazy_plugin) {}
 
@@ -32,25 +34,19 @@ public:
     {
         auto rpc_result = translateToRpcResult(result);
 
-        auto* rpc_info_result = new rpc::info::InfoResult();
+        auto* rpc_info_result = response->mutable_info_result();
         rpc_info_result->set_result(rpc_result);
         std::stringstream ss;
         ss << result;
         rpc_info_result->set_result_str(ss.str());
-
-        response->set_allocated_info_result(rpc_info_result);
     }
 
-    static std::unique_ptr<rpc::info::FlightInfo>
-    translateToRpcFlightInfo(const mavsdk::Info::FlightInfo& flight_info)
+    static void translateToRpcFlightInfo(
+        const mavsdk::Info::FlightInfo& flight_info, rpc::info::FlightInfo* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::info::FlightInfo>();
-
         rpc_obj->set_time_boot_ms(flight_info.time_boot_ms);
 
         rpc_obj->set_flight_uid(flight_info.flight_uid);
-
-        return rpc_obj;
     }
 
     static mavsdk::Info::FlightInfo
@@ -65,16 +61,12 @@ public:
         return obj;
     }
 
-    static std::unique_ptr<rpc::info::Identification>
-    translateToRpcIdentification(const mavsdk::Info::Identification& identification)
+    static void translateToRpcIdentification(
+        const mavsdk::Info::Identification& identification, rpc::info::Identification* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::info::Identification>();
-
         rpc_obj->set_hardware_uid(identification.hardware_uid);
 
         rpc_obj->set_legacy_uid(identification.legacy_uid);
-
-        return rpc_obj;
     }
 
     static mavsdk::Info::Identification
@@ -89,11 +81,9 @@ public:
         return obj;
     }
 
-    static std::unique_ptr<rpc::info::Product>
-    translateToRpcProduct(const mavsdk::Info::Product& product)
+    static void translateToRpcProduct(
+        const mavsdk::Info::Product& product, rpc::info::Product* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::info::Product>();
-
         rpc_obj->set_vendor_id(product.vendor_id);
 
         rpc_obj->set_vendor_name(product.vendor_name);
@@ -101,8 +91,6 @@ public:
         rpc_obj->set_product_id(product.product_id);
 
         rpc_obj->set_product_name(product.product_name);
-
-        return rpc_obj;
     }
 
     static mavsdk::Info::Product translateFromRpcProduct(const rpc::info::Product& product)
@@ -172,11 +160,9 @@ public:
         }
     }
 
-    static std::unique_ptr<rpc::info::Version>
-    translateToRpcVersion(const mavsdk::Info::Version& version)
+    static void translateToRpcVersion(
+        const mavsdk::Info::Version& version, rpc::info::Version* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::info::Version>();
-
         rpc_obj->set_flight_sw_major(version.flight_sw_major);
 
         rpc_obj->set_flight_sw_minor(version.flight_sw_minor);
@@ -201,8 +187,6 @@ public:
 
         rpc_obj->set_flight_sw_version_type(
             translateToRpcFlightSoftwareVersionType(version.flight_sw_version_type));
-
-        return rpc_obj;
     }
 
     static mavsdk::Info::Version translateFromRpcVersion(const rpc::info::Version& version)
@@ -272,11 +256,13 @@ public:
     }
 
     grpc::Status GetFlightInformation(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::info::GetFlightInformationRequest* /* request */,
         rpc::info::GetFlightInformationResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Info::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -285,23 +271,25 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->get_flight_information();
+        auto result = plugin->get_flight_information();
 
         if (response != nullptr) {
             fillResponseWithResult(response, result.first);
 
-            response->set_allocated_flight_info(translateToRpcFlightInfo(result.second).release());
+            translateToRpcFlightInfo(result.second, response->mutable_flight_info());
         }
 
         return grpc::Status::OK;
     }
 
     grpc::Status GetIdentification(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::info::GetIdentificationRequest* /* request */,
         rpc::info::GetIdentificationResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Info::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -310,24 +298,25 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->get_identification();
+        auto result = plugin->get_identification();
 
         if (response != nullptr) {
             fillResponseWithResult(response, result.first);
 
-            response->set_allocated_identification(
-                translateToRpcIdentification(result.second).release());
+            translateToRpcIdentification(result.second, response->mutable_identification());
         }
 
         return grpc::Status::OK;
     }
 
     grpc::Status GetProduct(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::info::GetProductRequest* /* request */,
         rpc::info::GetProductResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Info::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -336,23 +325,25 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->get_product();
+        auto result = plugin->get_product();
 
         if (response != nullptr) {
             fillResponseWithResult(response, result.first);
 
-            response->set_allocated_product(translateToRpcProduct(result.second).release());
+            translateToRpcProduct(result.second, response->mutable_product());
         }
 
         return grpc::Status::OK;
     }
 
     grpc::Status GetVersion(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::info::GetVersionRequest* /* request */,
         rpc::info::GetVersionResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Info::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -361,23 +352,25 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->get_version();
+        auto result = plugin->get_version();
 
         if (response != nullptr) {
             fillResponseWithResult(response, result.first);
 
-            response->set_allocated_version(translateToRpcVersion(result.second).release());
+            translateToRpcVersion(result.second, response->mutable_version());
         }
 
         return grpc::Status::OK;
     }
 
     grpc::Status GetSpeedFactor(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::info::GetSpeedFactorRequest* /* request */,
         rpc::info::GetSpeedFactorResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Info::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -386,7 +379,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->get_speed_factor();
+        auto result = plugin->get_speed_factor();
 
         if (response != nullptr) {
             fillResponseWithResult(response, result.first);
@@ -397,45 +390,14 @@ public:
         return grpc::Status::OK;
     }
 
-    void stop()
-    {
-        _stopped.store(true);
-        for (auto& prom : _stream_stop_promises) {
-            if (auto handle = prom.lock()) {
-                handle->set_value();
-            }
-        }
-    }
-
-private:
-    void register_stream_stop_promise(std::weak_ptr<std::promise<void>> prom)
-    {
-        // If we have already stopped, set promise immediately and don't add it to list.
-        if (_stopped.load()) {
-            if (auto handle = prom.lock()) {
-                handle->set_value();
-            }
-        } else {
-            _stream_stop_promises.push_back(prom);
-        }
-    }
+    void stop() { _streams.finish_all(); }
 
-    void unregister_stream_stop_promise(std::shared_ptr<std::promise<void>> prom)
-    {
-        for (auto it = _stream_stop_promises.begin(); it != _stream_stop_promises.end();
-             /* ++it */) {
-            if (it->lock() == prom) {
-                it = _stream_stop_promises.erase(it);
-            } else {
-                ++it;
-            }
-        }
-    }
+    const StreamStats& stream_stats() const { return _streams.stats(); }
 
+private:
     LazyPlugin& _lazy_plugin;
 
-    std::atomic<bool> _stopped{false};
-    std::vector<std::weak_ptr<std::promise<void>>> _stream_stop_promises{};
+    StreamList _streams{};
 };
 
 } // namespace mavsdk_server
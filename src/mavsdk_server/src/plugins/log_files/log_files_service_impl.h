@@ -10,6 +10,8 @@
 #include "lazy_plugin.h"
 
 #include "log.h"
+#include "stream_reactor.h"
+#include "system_selection.h"
 #include <atomic>
 #include <cmath>
 #include <future>
@@ -23,7 +25,10 @@ namespace mavsdk_server {
 
 template<typename LogFiles = LogFiles, typename LazyPlugin = LazyPlugin<LogFiles>>
 
-class LogFilesServiceImpl final : public rpc::log_files::LogFilesService::Service {
+class LogFilesServiceImpl final
+    : public WithCallbackMethods<
+          rpc::log_files::LogFilesService::Service,
+          rpc::log_files::LogFilesService::WithCallbackMethod_SubscribeDownloadLogFile> {
 public:
     LogFilesServiceImpl(LazyPlugin& lazy_plugin) : _lazy_plugin(lazy_plugin) {}
 
@@ -32,23 +37,17 @@ public:
     {
         auto rpc_result = translateToRpcResult(result);
 
-        auto* rpc_log_files_result = new rpc::log_files::LogFilesResult();
+        auto* rpc_log_files_result = response->mutable_log_files_result();
         rpc_log_files_result->set_result(rpc_result);
         std::stringstream ss;
         ss << result;
         rpc_log_files_result->set_result_str(ss.str());
-
-        response->set_allocated_log_files_result(rpc_log_files_result);
     }
 
-    static std::unique_ptr<rpc::log_files::ProgressData>
-    translateToRpcProgressData(const mavsdk::LogFiles::ProgressData& progress_data)
+    static void translateToRpcProgressData(
+        const mavsdk::LogFiles::ProgressData& progress_data, rpc::log_files::ProgressData* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::log_files::ProgressData>();
-
         rpc_obj->set_progress(progress_data.progress);
-
-        return rpc_obj;
     }
 
     static mavsdk::LogFiles::ProgressData
@@ -61,18 +60,14 @@ public:
         return obj;
     }
 
-    static std::unique_ptr<rpc::log_files::Entry>
-    translateToRpcEntry(const mavsdk::LogFiles::Entry& entry)
+    static void translateToRpcEntry(
+        const mavsdk::LogFiles::Entry& entry, rpc::log_files::Entry* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::log_files::Entry>();
-
         rpc_obj->set_id(entry.id);
 
         rpc_obj->set_date(entry.date);
 
         rpc_obj->set_size_bytes(entry.size_bytes);
-
-        return rpc_obj;
     }
 
     static mavsdk::LogFiles::Entry translateFromRpcEntry(const rpc::log_files::Entry& entry)
@@ -141,11 +136,13 @@ public:
     }
 
     grpc::Status GetEntries(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::log_files::GetEntriesRequest* /* request */,
         rpc::log_files::GetEntriesResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::LogFiles::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -154,81 +151,70 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->get_entries();
+        auto result = plugin->get_entries();
 
         if (response != nullptr) {
             fillResponseWithResult(response, result.first);
 
             for (auto elem : result.second) {
-                auto* ptr = response->add_entries();
-                ptr->CopyFrom(*translateToRpcEntry(elem).release());
+                translateToRpcEntry(elem, response->add_entries());
             }
         }
 
         return grpc::Status::OK;
     }
 
-    grpc::Status SubscribeDownloadLogFile(
-        grpc::ServerContext* /* context */,
-        const mavsdk::rpc::log_files::SubscribeDownloadLogFileRequest* request,
-        grpc::ServerWriter<rpc::log_files::DownloadLogFileResponse>* writer) override
+    grpc::ServerWriteReactor<rpc::log_files::DownloadLogFileResponse>* SubscribeDownloadLogFile(
+        grpc::CallbackServerContext* context,
+        const mavsdk::rpc::log_files::SubscribeDownloadLogFileRequest* request) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        auto reactor = StreamReactor<rpc::log_files::DownloadLogFileResponse>::create();
+
+        if (plugin == nullptr) {
             rpc::log_files::DownloadLogFileResponse rpc_response;
             auto result = mavsdk::LogFiles::Result::NoSystem;
             fillResponseWithResult(&rpc_response, result);
-            writer->Write(rpc_response);
+            reactor->write(std::move(rpc_response));
 
-            return grpc::Status::OK;
+            reactor->finish();
+            return reactor.get();
         }
 
-        auto stream_closed_promise = std::make_shared<std::promise<void>>();
-        auto stream_closed_future = stream_closed_promise->get_future();
-        register_stream_stop_promise(stream_closed_promise);
-
-        auto is_finished = std::make_shared<bool>(false);
-        auto subscribe_mutex = std::make_shared<std::mutex>();
+        _streams.add(reactor);
 
-        _lazy_plugin.maybe_plugin()->download_log_file_async(
+        plugin->download_log_file_async(
             translateFromRpcEntry(request->entry()),
             request->path(),
-            [this, &writer, &stream_closed_promise, is_finished, subscribe_mutex](
+            [reactor](
                 mavsdk::LogFiles::Result result,
                 const mavsdk::LogFiles::ProgressData download_log_file) {
                 rpc::log_files::DownloadLogFileResponse rpc_response;
 
-                rpc_response.set_allocated_progress(
-                    translateToRpcProgressData(download_log_file).release());
+                translateToRpcProgressData(download_log_file, rpc_response.mutable_progress());
 
                 auto rpc_result = translateToRpcResult(result);
-                auto* rpc_log_files_result = new rpc::log_files::LogFilesResult();
+                auto* rpc_log_files_result = rpc_response.mutable_log_files_result();
                 rpc_log_files_result->set_result(rpc_result);
                 std::stringstream ss;
                 ss << result;
                 rpc_log_files_result->set_result_str(ss.str());
-                rpc_response.set_allocated_log_files_result(rpc_log_files_result);
-
-                std::unique_lock<std::mutex> lock(*subscribe_mutex);
-                if (!*is_finished && !writer->Write(rpc_response)) {
-                    *is_finished = true;
-                    unregister_stream_stop_promise(stream_closed_promise);
-                    stream_closed_promise->set_value();
-                }
-            });
 
-        stream_closed_future.wait();
-        std::unique_lock<std::mutex> lock(*subscribe_mutex);
-        *is_finished = true;
+                reactor->write(std::move(rpc_response));
+            });
 
-        return grpc::Status::OK;
+        return reactor.get();
     }
 
     grpc::Status EraseAllLogFiles(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::log_files::EraseAllLogFilesRequest* /* request */,
         rpc::log_files::EraseAllLogFilesResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::LogFiles::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -237,7 +223,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->erase_all_log_files();
+        auto result = plugin->erase_all_log_files();
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -246,45 +232,14 @@ public:
         return grpc::Status::OK;
     }
 
-    void stop()
-    {
-        _stopped.store(true);
-        for (auto& prom : _stream_stop_promises) {
-            if (auto handle = prom.lock()) {
-                handle->set_value();
-            }
-        }
-    }
-
-private:
-    void register_stream_stop_promise(std::weak_ptr<std::promise<void>> prom)
-    {
-        // If we have already stopped, set promise immediately and don't add it to list.
-        if (_stopped.load()) {
-            if (auto handle = prom.lock()) {
-                handle->set_value();
-            }
-        } else {
-            _stream_stop_promises.push_back(prom);
-        }
-    }
+    void stop() { _streams.finish_all(); }
 
-    void unregister_stream_stop_promise(std::shared_ptr<std::promise<void>> prom)
-    {
-        for (auto it = _stream_stop_promises.begin(); it != _stream_stop_promises.end();
-             /* ++it */) {
-            if (it->lock() == prom) {
-                it = _stream_stop_promises.erase(it);
-            } else {
-                ++it;
-            }
-        }
-    }
+    const StreamStats& stream_stats() const { return _streams.stats(); }
 
+private:
     LazyPlugin& _lazy_plugin;
 
-    std::atomic<bool> _stopped{false};
-    std::vector<std::weak_ptr<std::promise<void>>> _stream_stop_promises{};
+    StreamList _streams{};
 };
 
 } // namespace mavsdk_server
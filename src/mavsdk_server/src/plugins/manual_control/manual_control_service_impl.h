@@ -11,6 +11,8 @@
 #include "lazy_plugin.h"
 
 #include "log.h"
+#include "stream_reactor.h"
+#include "system_selection.h"
 #include <atomic>
 #include <cmath>
 #include <future>
@@ -24,7 +26,8 @@ namespace mavsdk_server {
 
 template<typename ManualControl = ManualControl, typename LazyPlugin = LazyPlugin<ManualControl>>
 
-class ManualControlServiceImpl final : public rpc::manual_control::ManualControlService::Service {
+class ManualControlServiceImpl final
+    : public WithCallbackMethods<rpc::manual_control::ManualControlService::Service> {
 public:
     ManualControlServiceImpl(LazyPlugin& lazy_plugin) : _lazy_plugin(lazy_plugin) {}
 
@@ -33,13 +36,11 @@ public:
     {
         auto rpc_result = translateToRpcResult(result);
 
-        auto* rpc_manual_control_result = new rpc::manual_control::ManualControlResult();
+        auto* rpc_manual_control_result = response->mutable_manual_control_result();
         rpc_manual_control_result->set_result(rpc_result);
         std::stringstream ss;
         ss << result;
         rpc_manual_control_result->set_result_str(ss.str());
-
-        response->set_allocated_manual_control_result(rpc_manual_control_result);
     }
 
     static rpc::manual_control::ManualControlResult::Result
@@ -99,11 +100,13 @@ public:
     }
 
     grpc::Status StartPositionControl(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::manual_control::StartPositionControlRequest* /* request */,
         rpc::manual_control::StartPositionControlResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::ManualControl::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -112,7 +115,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->start_position_control();
+        auto result = plugin->start_position_control();
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -122,11 +125,13 @@ public:
     }
 
     grpc::Status StartAltitudeControl(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::manual_control::StartAltitudeControlRequest* /* request */,
         rpc::manual_control::StartAltitudeControlResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::ManualControl::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -135,7 +140,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->start_altitude_control();
+        auto result = plugin->start_altitude_control();
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -145,11 +150,13 @@ public:
     }
 
     grpc::Status SetManualControlInput(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::manual_control::SetManualControlInputRequest* request,
         rpc::manual_control::SetManualControlInputResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::ManualControl::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -163,7 +170,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->set_manual_control_input(
+        auto result = plugin->set_manual_control_input(
             request->x(), request->y(), request->z(), request->r());
 
         if (response != nullptr) {
@@ -173,45 +180,14 @@ public:
         return grpc::Status::OK;
     }
 
-    void stop()
-    {
-        _stopped.store(true);
-        for (auto& prom : _stream_stop_promises) {
-            if (auto handle = prom.lock()) {
-                handle->set_value();
-            }
-        }
-    }
+    void stop() { _streams.finish_all(); }
 
-private:
-    void register_stream_stop_promise(std::weak_ptr<std::promise<void>> prom)
-    {
-        // If we have already stopped, set promise immediately and don't add it to list.
-        if (_stopped.load()) {
-            if (auto handle = prom.lock()) {
-                handle->set_value();
-            }
-        } else {
-            _stream_stop_promises.push_back(prom);
-        }
-    }
-
-    void unregister_stream_stop_promise(std::shared_ptr<std::promise<void>> prom)
-    {
-        for (auto it = _stream_stop_promises.begin(); it != _stream_stop_promises.end();
-             /* ++it */) {
-            if (it->lock() == prom) {
-                it = _stream_stop_promises.erase(it);
-            } else {
-                ++it;
-            }
-        }
-    }
+    const StreamStats& stream_stats() const { return _streams.stats(); }
 
+private:
     LazyPlugin& _lazy_plugin;
 
-    std::atomic<bool> _stopped{false};
-    std::vector<std::weak_ptr<std::promise<void>>> _stream_stop_promises{};
+    StreamList _streams{};
 };
 
 } // namespace mavsdk_server
@@ -10,6 +10,8 @@
 #include "lazy_plugin.h"
 
 #include "log.h"
+#include "stream_reactor.h"
+#include "system_selection.h"
 #include <atomic>
 #include <cmath>
 #include <future>
@@ -23,7 +25,12 @@ namespace mavsdk_server {
 
 template<typename Mission = Mission, typename LazyPlugin = LazyPlugin<Mission>>
 
-class MissionServiceImpl final : public rpc::mission::MissionService::Service {
+class MissionServiceImpl final
+    : public WithCallbackMethods<
+          rpc::mission::MissionService::Service,
+          rpc::mission::MissionService::WithCallbackMethod_SubscribeUploadMissionWithProgress,
+          rpc::mission::MissionService::WithCallbackMethod_SubscribeDownloadMissionWithProgress,
+          rpc::mission::MissionService::WithCallbackMethod_SubscribeMissionProgress> {
 public:
     MissionServiceImpl(LazyPlugin& lazy_plugin) : _lazy_plugin(lazy_plugin) {}
 
@@ -32,13 +39,11 @@ public:
     {
         auto rpc_result = translateToRpcResult(result);
 
-        auto* rpc_mission_result = new rpc::mission::MissionResult();
+        auto* rpc_mission_result = response->mutable_mission_result();
         rpc_mission_result->set_result(rpc_result);
         std::stringstream ss;
         ss << result;
         rpc_mission_result->set_result_str(ss.str());
-
-        response->set_allocated_mission_result(rpc_mission_result);
     }
 
     static rpc::mission::MissionItem::CameraAction
@@ -135,11 +140,9 @@ public:
         }
     }
 
-    static std::unique_ptr<rpc::mission::MissionItem>
-    translateToRpcMissionItem(const mavsdk::Mission::MissionItem& mission_item)
+    static void translateToRpcMissionItem(
+        const mavsdk::Mission::MissionItem& mission_item, rpc::mission::MissionItem* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::mission::MissionItem>();
-
         rpc_obj->set_latitude_deg(mission_item.latitude_deg);
 
         rpc_obj->set_longitude_deg(mission_item.longitude_deg);
@@ -167,8 +170,6 @@ public:
         rpc_obj->set_camera_photo_distance_m(mission_item.camera_photo_distance_m);
 
         rpc_obj->set_vehicle_action(translateToRpcVehicleAction(mission_item.vehicle_action));
-
-        return rpc_obj;
     }
 
     static mavsdk::Mission::MissionItem
@@ -207,17 +208,12 @@ public:
         return obj;
     }
 
-    static std::unique_ptr<rpc::mission::MissionPlan>
-    translateToRpcMissionPlan(const mavsdk::Mission::MissionPlan& mission_plan)
+    static void translateToRpcMissionPlan(
+        const mavsdk::Mission::MissionPlan& mission_plan, rpc::mission::MissionPlan* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::mission::MissionPlan>();
-
         for (const auto& elem : mission_plan.mission_items) {
-            auto* ptr = rpc_obj->add_mission_items();
-            ptr->CopyFrom(*translateToRpcMissionItem(elem).release());
+            translateToRpcMissionItem(elem, rpc_obj->add_mission_items());
         }
-
-        return rpc_obj;
     }
 
     static mavsdk::Mission::MissionPlan
@@ -233,16 +229,13 @@ public:
         return obj;
     }
 
-    static std::unique_ptr<rpc::mission::MissionProgress>
-    translateToRpcMissionProgress(const mavsdk::Mission::MissionProgress& mission_progress)
+    static void translateToRpcMissionProgress(
+        const mavsdk::Mission::MissionProgress& mission_progress,
+        rpc::mission::MissionProgress* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::mission::MissionProgress>();
-
         rpc_obj->set_current(mission_progress.current);
 
         rpc_obj->set_total(mission_progress.total);
-
-        return rpc_obj;
     }
 
     static mavsdk::Mission::MissionProgress
@@ -341,14 +334,10 @@ public:
         }
     }
 
-    static std::unique_ptr<rpc::mission::ProgressData>
-    translateToRpcProgressData(const mavsdk::Mission::ProgressData& progress_data)
+    static void translateToRpcProgressData(
+        const mavsdk::Mission::ProgressData& progress_data, rpc::mission::ProgressData* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::mission::ProgressData>();
-
         rpc_obj->set_progress(progress_data.progress);
-
-        return rpc_obj;
     }
 
     static mavsdk::Mission::ProgressData
@@ -361,21 +350,18 @@ public:
         return obj;
     }
 
-    static std::unique_ptr<rpc::mission::ProgressDataOrMission> translateToRpcProgressDataOrMission(
-        const mavsdk::Mission::ProgressDataOrMission& progress_data_or_mission)
+    static void translateToRpcProgressDataOrMission(
+        const mavsdk::Mission::ProgressDataOrMission& progress_data_or_mission,
+        rpc::mission::ProgressDataOrMission* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::mission::ProgressDataOrMission>();
-
         rpc_obj->set_has_progress(progress_data_or_mission.has_progress);
 
         rpc_obj->set_progress(progress_data_or_mission.progress);
 
         rpc_obj->set_has_mission(progress_data_or_mission.has_mission);
 
-        rpc_obj->set_allocated_mission_plan(
-            translateToRpcMissionPlan(progress_data_or_mission.mission_plan).release());
-
-        return rpc_obj;
+        translateToRpcMissionPlan(
+            progress_data_or_mission.mission_plan, rpc_obj->mutable_mission_plan());
     }
 
     static mavsdk::Mission::ProgressDataOrMission translateFromRpcProgressDataOrMission(
@@ -395,11 +381,13 @@ public:
     }
 
     grpc::Status UploadMission(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::mission::UploadMissionRequest* request,
         rpc::mission::UploadMissionResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Mission::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -413,7 +401,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->upload_mission(
+        auto result = plugin->upload_mission(
             translateFromRpcMissionPlan(request->mission_plan()));
 
         if (response != nullptr) {
@@ -423,66 +411,58 @@ public:
         return grpc::Status::OK;
     }
 
-    grpc::Status SubscribeUploadMissionWithProgress(
-        grpc::ServerContext* /* context */,
-        const mavsdk::rpc::mission::SubscribeUploadMissionWithProgressRequest* request,
-        grpc::ServerWriter<rpc::mission::UploadMissionWithProgressResponse>* writer) override
+    grpc::ServerWriteReactor<rpc::mission::UploadMissionWithProgressResponse>*
+    SubscribeUploadMissionWithProgress(
+        grpc::CallbackServerContext* context,
+        const mavsdk::rpc::mission::SubscribeUploadMissionWithProgressRequest* request) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        auto reactor = StreamReactor<rpc::mission::UploadMissionWithProgressResponse>::create();
+
+        if (plugin == nullptr) {
             rpc::mission::UploadMissionWithProgressResponse rpc_response;
             auto result = mavsdk::Mission::Result::NoSystem;
             fillResponseWithResult(&rpc_response, result);
-            writer->Write(rpc_response);
+            reactor->write(std::move(rpc_response));
 
-            return grpc::Status::OK;
+            reactor->finish();
+            return reactor.get();
         }
 
-        auto stream_closed_promise = std::make_shared<std::promise<void>>();
-        auto stream_closed_future = stream_closed_promise->get_future();
-        register_stream_stop_promise(stream_closed_promise);
+        _streams.add(reactor);
 
-        auto is_finished = std::make_shared<bool>(false);
-        auto subscribe_mutex = std::make_shared<std::mutex>();
-
-        _lazy_plugin.maybe_plugin()->upload_mission_with_progress_async(
+        plugin->upload_mission_with_progress_async(
             translateFromRpcMissionPlan(request->mission_plan()),
-            [this, &writer, &stream_closed_promise, is_finished, subscribe_mutex](
+            [reactor](
                 mavsdk::Mission::Result result,
                 const mavsdk::Mission::ProgressData upload_mission_with_progress) {
                 rpc::mission::UploadMissionWithProgressResponse rpc_response;
 
-                rpc_response.set_allocated_progress_data(
-                    translateToRpcProgressData(upload_mission_with_progress).release());
+                translateToRpcProgressData(
+                    upload_mission_with_progress, rpc_response.mutable_progress_data());
 
                 auto rpc_result = translateToRpcResult(result);
-                auto* rpc_mission_result = new rpc::mission::MissionResult();
+                auto* rpc_mission_result = rpc_response.mutable_mission_result();
                 rpc_mission_result->set_result(rpc_result);
                 std::stringstream ss;
                 ss << result;
                 rpc_mission_result->set_result_str(ss.str());
-                rpc_response.set_allocated_mission_result(rpc_mission_result);
-
-                std::unique_lock<std::mutex> lock(*subscribe_mutex);
-                if (!*is_finished && !writer->Write(rpc_response)) {
-                    *is_finished = true;
-                    unregister_stream_stop_promise(stream_closed_promise);
-                    stream_closed_promise->set_value();
-                }
-            });
 
-        stream_closed_future.wait();
-        std::unique_lock<std::mutex> lock(*subscribe_mutex);
-        *is_finished = true;
+                reactor->write(std::move(rpc_response));
+            });
 
-        return grpc::Status::OK;
+        return reactor.get();
     }
 
     grpc::Status CancelMissionUpload(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::mission::CancelMissionUploadRequest* /* request */,
         rpc::mission::CancelMissionUploadResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Mission::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -491,7 +471,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->cancel_mission_upload();
+        auto result = plugin->cancel_mission_upload();
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -501,11 +481,13 @@ public:
     }
 
     grpc::Status DownloadMission(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::mission::DownloadMissionRequest* /* request */,
         rpc::mission::DownloadMissionResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Mission::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -514,77 +496,69 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->download_mission();
+        auto result = plugin->download_mission();
 
         if (response != nullptr) {
             fillResponseWithResult(response, result.first);
 
-            response->set_allocated_mission_plan(
-                translateToRpcMissionPlan(result.second).release());
+            translateToRpcMissionPlan(result.second, response->mutable_mission_plan());
         }
 
         return grpc::Status::OK;
     }
 
-    grpc::Status SubscribeDownloadMissionWithProgress(
-        grpc::ServerContext* /* context */,
-        const mavsdk::rpc::mission::SubscribeDownloadMissionWithProgressRequest* /* request */,
-        grpc::ServerWriter<rpc::mission::DownloadMissionWithProgressResponse>* writer) override
+    grpc::ServerWriteReactor<rpc::mission::DownloadMissionWithProgressResponse>*
+    SubscribeDownloadMissionWithProgress(
+        grpc::CallbackServerContext* context,
+        const mavsdk::rpc::mission::SubscribeDownloadMissionWithProgressRequest* /* request */)
+        override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        auto reactor = StreamReactor<rpc::mission::DownloadMissionWithProgressResponse>::create();
+
+        if (plugin == nullptr) {
             rpc::mission::DownloadMissionWithProgressResponse rpc_response;
             auto result = mavsdk::Mission::Result::NoSystem;
             fillResponseWithResult(&rpc_response, result);
-            writer->Write(rpc_response);
+            reactor->write(std::move(rpc_response));
 
-            return grpc::Status::OK;
+            reactor->finish();
+            return reactor.get();
         }
 
-        auto stream_closed_promise = std::make_shared<std::promise<void>>();
-        auto stream_closed_future = stream_closed_promise->get_future();
-        register_stream_stop_promise(stream_closed_promise);
+        _streams.add(reactor);
 
-        auto is_finished = std::make_shared<bool>(false);
-        auto subscribe_mutex = std::make_shared<std::mutex>();
-
-        _lazy_plugin.maybe_plugin()->download_mission_with_progress_async(
-            [this, &writer, &stream_closed_promise, is_finished, subscribe_mutex](
+        plugin->download_mission_with_progress_async(
+            [reactor](
                 mavsdk::Mission::Result result,
                 const mavsdk::Mission::ProgressDataOrMission download_mission_with_progress) {
                 rpc::mission::DownloadMissionWithProgressResponse rpc_response;
 
-                rpc_response.set_allocated_progress_data(
-                    translateToRpcProgressDataOrMission(download_mission_with_progress).release());
+                translateToRpcProgressDataOrMission(
+                    download_mission_with_progress, rpc_response.mutable_progress_data());
 
                 auto rpc_result = translateToRpcResult(result);
-                auto* rpc_mission_result = new rpc::mission::MissionResult();
+                auto* rpc_mission_result = rpc_response.mutable_mission_result();
                 rpc_mission_result->set_result(rpc_result);
                 std::stringstream ss;
                 ss << result;
                 rpc_mission_result->set_result_str(ss.str());
-                rpc_response.set_allocated_mission_result(rpc_mission_result);
-
-                std::unique_lock<std::mutex> lock(*subscribe_mutex);
-                if (!*is_finished && !writer->Write(rpc_response)) {
-                    *is_finished = true;
-                    unregister_stream_stop_promise(stream_closed_promise);
-                    stream_closed_promise->set_value();
-                }
-            });
 
-        stream_closed_future.wait();
-        std::unique_lock<std::mutex> lock(*subscribe_mutex);
-        *is_finished = true;
+                reactor->write(std::move(rpc_response));
+            });
 
-        return grpc::Status::OK;
+        return reactor.get();
     }
 
     grpc::Status CancelMissionDownload(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::mission::CancelMissionDownloadRequest* /* request */,
         rpc::mission::CancelMissionDownloadResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Mission::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -593,7 +567,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->cancel_mission_download();
+        auto result = plugin->cancel_mission_download();
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -603,11 +577,13 @@ public:
     }
 
     grpc::Status StartMission(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::mission::StartMissionRequest* /* request */,
         rpc::mission::StartMissionResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Mission::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -616,7 +592,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->start_mission();
+        auto result = plugin->start_mission();
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -626,11 +602,13 @@ public:
     }
 
     grpc::Status PauseMission(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::mission::PauseMissionRequest* /* request */,
         rpc::mission::PauseMissionResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Mission::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -639,7 +617,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->pause_mission();
+        auto result = plugin->pause_mission();
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -649,11 +627,13 @@ public:
     }
 
     grpc::Status ClearMission(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::mission::ClearMissionRequest* /* request */,
         rpc::mission::ClearMissionResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Mission::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -662,7 +642,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->clear_mission();
+        auto result = plugin->clear_mission();
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -672,11 +652,13 @@ public:
     }
 
     grpc::Status SetCurrentMissionItem(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::mission::SetCurrentMissionItemRequest* request,
         rpc::mission::SetCurrentMissionItemResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Mission::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -690,7 +672,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->set_current_mission_item(request->index());
+        auto result = plugin->set_current_mission_item(request->index());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -700,11 +682,13 @@ public:
     }
 
     grpc::Status IsMissionFinished(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::mission::IsMissionFinishedRequest* /* request */,
         rpc::mission::IsMissionFinishedResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Mission::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -713,7 +697,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->is_mission_finished();
+        auto result = plugin->is_mission_finished();
 
         if (response != nullptr) {
             fillResponseWithResult(response, result.first);
@@ -724,54 +708,45 @@ public:
         return grpc::Status::OK;
     }
 
-    grpc::Status SubscribeMissionProgress(
-        grpc::ServerContext* /* context */,
-        const mavsdk::rpc::mission::SubscribeMissionProgressRequest* /* request */,
-        grpc::ServerWriter<rpc::mission::MissionProgressResponse>* writer) override
+    grpc::ServerWriteReactor<rpc::mission::MissionProgressResponse>* SubscribeMissionProgress(
+        grpc::CallbackServerContext* context,
+        const mavsdk::rpc::mission::SubscribeMissionProgressRequest* /* request */) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
-            return grpc::Status::OK;
-        }
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
 
-        auto stream_closed_promise = std::make_shared<std::promise<void>>();
-        auto stream_closed_future = stream_closed_promise->get_future();
-        register_stream_stop_promise(stream_closed_promise);
+        auto reactor = StreamReactor<rpc::mission::MissionProgressResponse>::create();
 
-        auto is_finished = std::make_shared<bool>(false);
-        auto subscribe_mutex = std::make_shared<std::mutex>();
+        if (plugin == nullptr) {
+            reactor->finish();
+            return reactor.get();
+        }
+
+        _streams.add(reactor);
 
         const mavsdk::Mission::MissionProgressHandle handle =
-            _lazy_plugin.maybe_plugin()->subscribe_mission_progress(
-                [this, &writer, &stream_closed_promise, is_finished, subscribe_mutex, &handle](
-                    const mavsdk::Mission::MissionProgress mission_progress) {
+            plugin->subscribe_mission_progress(
+                [reactor](const mavsdk::Mission::MissionProgress mission_progress) {
                     rpc::mission::MissionProgressResponse rpc_response;
 
-                    rpc_response.set_allocated_mission_progress(
-                        translateToRpcMissionProgress(mission_progress).release());
+                    translateToRpcMissionProgress(
+                        mission_progress, rpc_response.mutable_mission_progress());
 
-                    std::unique_lock<std::mutex> lock(*subscribe_mutex);
-                    if (!*is_finished && !writer->Write(rpc_response)) {
-                        _lazy_plugin.maybe_plugin()->unsubscribe_mission_progress(handle);
-
-                        *is_finished = true;
-                        unregister_stream_stop_promise(stream_closed_promise);
-                        stream_closed_promise->set_value();
-                    }
+                    reactor->write(std::move(rpc_response));
                 });
 
-        stream_closed_future.wait();
-        std::unique_lock<std::mutex> lock(*subscribe_mutex);
-        *is_finished = true;
+        reactor->set_on_done([plugin, handle]() { plugin->unsubscribe_mission_progress(handle); });
 
-        return grpc::Status::OK;
+        return reactor.get();
     }
 
     grpc::Status GetReturnToLaunchAfterMission(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::mission::GetReturnToLaunchAfterMissionRequest* /* request */,
         rpc::mission::GetReturnToLaunchAfterMissionResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Mission::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -780,7 +755,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->get_return_to_launch_after_mission();
+        auto result = plugin->get_return_to_launch_after_mission();
 
         if (response != nullptr) {
             fillResponseWithResult(response, result.first);
@@ -792,11 +767,13 @@ public:
     }
 
     grpc::Status SetReturnToLaunchAfterMission(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::mission::SetReturnToLaunchAfterMissionRequest* request,
         rpc::mission::SetReturnToLaunchAfterMissionResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Mission::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -811,7 +788,7 @@ public:
         }
 
         auto result =
-            _lazy_plugin.maybe_plugin()->set_return_to_launch_after_mission(request->enable());
+            plugin->set_return_to_launch_after_mission(request->enable());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -820,45 +797,14 @@ public:
         return grpc::Status::OK;
     }
 
-    void stop()
-    {
-        _stopped.store(true);
-        for (auto& prom : _stream_stop_promises) {
-            if (auto handle = prom.lock()) {
-                handle->set_value();
-            }
-        }
-    }
-
-private:
-    void register_stream_stop_promise(std::weak_ptr<std::promise<void>> prom)
-    {
-        // If we have already stopped, set promise immediately and don't add it to list.
-        if (_stopped.load()) {
-            if (auto handle = prom.lock()) {
-                handle->set_value();
-            }
-        } else {
-            _stream_stop_promises.push_back(prom);
-        }
-    }
+    void stop() { _streams.finish_all(); }
 
-    void unregister_stream_stop_promise(std::shared_ptr<std::promise<void>> prom)
-    {
-        for (auto it = _stream_stop_promises.begin(); it != _stream_stop_promises.end();
-             /* ++it */) {
-            if (it->lock() == prom) {
-                it = _stream_stop_promises.erase(it);
-            } else {
-                ++it;
-            }
-        }
-    }
+    const StreamStats& stream_stats() const { return _streams.stats(); }
 
+private:
     LazyPlugin& _lazy_plugin;
 
-    std::atomic<bool> _stopped{false};
-    std::vector<std::weak_ptr<std::promise<void>>> _stream_stop_promises{};
+    StreamList _streams{};
 };
 
 } // namespace mavsdk_server
@@ -10,6 +10,8 @@
 #include "lazy_plugin.h"
 
 #include "log.h"
+#include "stream_reactor.h"
+#include "system_selection.h"
 #include <atomic>
 #include <cmath>
 #include <future>
@@ -23,7 +25,11 @@ namespace mavsdk_server {
 
 template<typename MissionRaw = MissionRaw, typename LazyPlugin = LazyPlugin<MissionRaw>>
 
-class MissionRawServiceImpl final : public rpc::mission_raw::MissionRawService::Service {
+class MissionRawServiceImpl final
+    : public WithCallbackMethods<
+          rpc::mission_raw::MissionRawService::Service,
+          rpc::mission_raw::MissionRawService::WithCallbackMethod_SubscribeMissionProgress,
+          rpc::mission_raw::MissionRawService::WithCallbackMethod_SubscribeMissionChanged> {
 public:
     MissionRawServiceImpl(LazyPlugin& lazy_plugin) : _lazy_plugin(lazy_plugin) {}
 
@@ -32,25 +38,20 @@ public:
     {
         auto rpc_result = translateToRpcResult(result);
 
-        auto* rpc_mission_raw_result = new rpc::mission_raw::MissionRawResult();
+        auto* rpc_mission_raw_result = response->mutable_mission_raw_result();
         rpc_mission_raw_result->set_result(rpc_result);
         std::stringstream ss;
         ss << result;
         rpc_mission_raw_result->set_result_str(ss.str());
-
-        response->set_allocated_mission_raw_result(rpc_mission_raw_result);
     }
 
-    static std::unique_ptr<rpc::mission_raw::MissionProgress>
-    translateToRpcMissionProgress(const mavsdk::MissionRaw::MissionProgress& mission_progress)
+    static void translateToRpcMissionProgress(
+        const mavsdk::MissionRaw::MissionProgress& mission_progress,
+        rpc::mission_raw::MissionProgress* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::mission_raw::MissionProgress>();
-
         rpc_obj->set_current(mission_progress.current);
 
         rpc_obj->set_total(mission_progress.total);
-
-        return rpc_obj;
     }
 
     static mavsdk::MissionRaw::MissionProgress
@@ -65,11 +66,9 @@ public:
         return obj;
     }
 
-    static std::unique_ptr<rpc::mission_raw::MissionItem>
-    translateToRpcMissionItem(const mavsdk::MissionRaw::MissionItem& mission_item)
+    static void translateToRpcMissionItem(
+        const mavsdk::MissionRaw::MissionItem& mission_item, rpc::mission_raw::MissionItem* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::mission_raw::MissionItem>();
-
         rpc_obj->set_seq(mission_item.seq);
 
         rpc_obj->set_frame(mission_item.frame);
@@ -95,8 +94,6 @@ public:
         rpc_obj->set_z(mission_item.z);
 
         rpc_obj->set_mission_type(mission_item.mission_type);
-
-        return rpc_obj;
     }
 
     static mavsdk::MissionRaw::MissionItem
@@ -133,27 +130,21 @@ public:
         return obj;
     }
 
-    static std::unique_ptr<rpc::mission_raw::MissionImportData> translateToRpcMissionImportData(
-        const mavsdk::MissionRaw::MissionImportData& mission_import_data)
+    static void translateToRpcMissionImportData(
+        const mavsdk::MissionRaw::MissionImportData& mission_import_data,
+        rpc::mission_raw::MissionImportData* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::mission_raw::MissionImportData>();
-
         for (const auto& elem : mission_import_data.mission_items) {
-            auto* ptr = rpc_obj->add_mission_items();
-            ptr->CopyFrom(*translateToRpcMissionItem(elem).release());
+            translateToRpcMissionItem(elem, rpc_obj->add_mission_items());
         }
 
         for (const auto& elem : mission_import_data.geofence_items) {
-            auto* ptr = rpc_obj->add_geofence_items();
-            ptr->CopyFrom(*translateToRpcMissionItem(elem).release());
+            translateToRpcMissionItem(elem, rpc_obj->add_geofence_items());
         }
 
         for (const auto& elem : mission_import_data.rally_items) {
-            auto* ptr = rpc_obj->add_rally_items();
-            ptr->CopyFrom(*translateToRpcMissionItem(elem).release());
+            translateToRpcMissionItem(elem, rpc_obj->add_rally_items());
         }
-
-        return rpc_obj;
     }
 
     static mavsdk::MissionRaw::MissionImportData translateFromRpcMissionImportData(
@@ -276,11 +267,13 @@ public:
     }
 
     grpc::Status UploadMission(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::mission_raw::UploadMissionRequest* request,
         rpc::mission_raw::UploadMissionResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::MissionRaw::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -299,7 +292,7 @@ public:
             mission_items_vec.push_back(translateFromRpcMissionItem(elem));
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->upload_mission(mission_items_vec);
+        auto result = plugin->upload_mission(mission_items_vec);
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -309,11 +302,13 @@ public:
     }
 
     grpc::Status UploadGeofence(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::mission_raw::UploadGeofenceRequest* request,
         rpc::mission_raw::UploadGeofenceResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::MissionRaw::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -332,7 +327,7 @@ public:
             mission_items_vec.push_back(translateFromRpcMissionItem(elem));
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->upload_geofence(mission_items_vec);
+        auto result = plugin->upload_geofence(mission_items_vec);
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -342,11 +337,13 @@ public:
     }
 
     grpc::Status UploadRallyPoints(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::mission_raw::UploadRallyPointsRequest* request,
         rpc::mission_raw::UploadRallyPointsResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::MissionRaw::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -365,7 +362,7 @@ public:
             mission_items_vec.push_back(translateFromRpcMissionItem(elem));
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->upload_rally_points(mission_items_vec);
+        auto result = plugin->upload_rally_points(mission_items_vec);
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -375,11 +372,13 @@ public:
     }
 
     grpc::Status CancelMissionUpload(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::mission_raw::CancelMissionUploadRequest* /* request */,
         rpc::mission_raw::CancelMissionUploadResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::MissionRaw::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -388,7 +387,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->cancel_mission_upload();
+        auto result = plugin->cancel_mission_upload();
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -398,11 +397,13 @@ public:
     }
 
     grpc::Status DownloadMission(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::mission_raw::DownloadMissionRequest* /* request */,
         rpc::mission_raw::DownloadMissionResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::MissionRaw::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -411,14 +412,13 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->download_mission();
+        auto result = plugin->download_mission();
 
         if (response != nullptr) {
             fillResponseWithResult(response, result.first);
 
             for (auto elem : result.second) {
-                auto* ptr = response->add_mission_items();
-                ptr->CopyFrom(*translateToRpcMissionItem(elem).release());
+                translateToRpcMissionItem(elem, response->add_mission_items());
             }
         }
 
@@ -426,11 +426,13 @@ public:
     }
 
     grpc::Status CancelMissionDownload(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::mission_raw::CancelMissionDownloadRequest* /* request */,
         rpc::mission_raw::CancelMissionDownloadResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::MissionRaw::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -439,7 +441,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->cancel_mission_download();
+        auto result = plugin->cancel_mission_download();
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -449,11 +451,13 @@ public:
     }
 
     grpc::Status StartMission(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::mission_raw::StartMissionRequest* /* request */,
         rpc::mission_raw::StartMissionResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::MissionRaw::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -462,7 +466,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->start_mission();
+        auto result = plugin->start_mission();
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -472,11 +476,13 @@ public:
     }
 
     grpc::Status PauseMission(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::mission_raw::PauseMissionRequest* /* request */,
         rpc::mission_raw::PauseMissionResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::MissionRaw::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -485,7 +491,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->pause_mission();
+        auto result = plugin->pause_mission();
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -495,11 +501,13 @@ public:
     }
 
     grpc::Status ClearMission(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::mission_raw::ClearMissionRequest* /* request */,
         rpc::mission_raw::ClearMissionResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::MissionRaw::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -508,7 +516,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->clear_mission();
+        auto result = plugin->clear_mission();
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -518,11 +526,13 @@ public:
     }
 
     grpc::Status SetCurrentMissionItem(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::mission_raw::SetCurrentMissionItemRequest* request,
         rpc::mission_raw::SetCurrentMissionItemResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::MissionRaw::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -536,7 +546,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->set_current_mission_item(request->index());
+        auto result = plugin->set_current_mission_item(request->index());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -545,95 +555,75 @@ public:
         return grpc::Status::OK;
     }
 
-    grpc::Status SubscribeMissionProgress(
-        grpc::ServerContext* /* context */,
-        const mavsdk::rpc::mission_raw::SubscribeMissionProgressRequest* /* request */,
-        grpc::ServerWriter<rpc::mission_raw::MissionProgressResponse>* writer) override
+    grpc::ServerWriteReactor<rpc::mission_raw::MissionProgressResponse>* SubscribeMissionProgress(
+        grpc::CallbackServerContext* context,
+        const mavsdk::rpc::mission_raw::SubscribeMissionProgressRequest* /* request */) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
-            return grpc::Status::OK;
-        }
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        auto reactor = StreamReactor<rpc::mission_raw::MissionProgressResponse>::create();
 
-        auto stream_closed_promise = std::make_shared<std::promise<void>>();
-        auto stream_closed_future = stream_closed_promise->get_future();
-        register_stream_stop_promise(stream_closed_promise);
+        if (plugin == nullptr) {
+            reactor->finish();
+            return reactor.get();
+        }
 
-        auto is_finished = std::make_shared<bool>(false);
-        auto subscribe_mutex = std::make_shared<std::mutex>();
+        _streams.add(reactor);
 
         const mavsdk::MissionRaw::MissionProgressHandle handle =
-            _lazy_plugin.maybe_plugin()->subscribe_mission_progress(
-                [this, &writer, &stream_closed_promise, is_finished, subscribe_mutex, &handle](
-                    const mavsdk::MissionRaw::MissionProgress mission_progress) {
+            plugin->subscribe_mission_progress(
+                [reactor](const mavsdk::MissionRaw::MissionProgress mission_progress) {
                     rpc::mission_raw::MissionProgressResponse rpc_response;
 
-                    rpc_response.set_allocated_mission_progress(
-                        translateToRpcMissionProgress(mission_progress).release());
+                    translateToRpcMissionProgress(
+                        mission_progress, rpc_response.mutable_mission_progress());
 
-                    std::unique_lock<std::mutex> lock(*subscribe_mutex);
-                    if (!*is_finished && !writer->Write(rpc_response)) {
-                        _lazy_plugin.maybe_plugin()->unsubscribe_mission_progress(handle);
-
-                        *is_finished = true;
-                        unregister_stream_stop_promise(stream_closed_promise);
-                        stream_closed_promise->set_value();
-                    }
+                    reactor->write(std::move(rpc_response));
                 });
 
-        stream_closed_future.wait();
-        std::unique_lock<std::mutex> lock(*subscribe_mutex);
-        *is_finished = true;
+        reactor->set_on_done([plugin, handle]() { plugin->unsubscribe_mission_progress(handle); });
 
-        return grpc::Status::OK;
+        return reactor.get();
     }
 
-    grpc::Status SubscribeMissionChanged(
-        grpc::ServerContext* /* context */,
-        const mavsdk::rpc::mission_raw::SubscribeMissionChangedRequest* /* request */,
-        grpc::ServerWriter<rpc::mission_raw::MissionChangedResponse>* writer) override
+    grpc::ServerWriteReactor<rpc::mission_raw::MissionChangedResponse>* SubscribeMissionChanged(
+        grpc::CallbackServerContext* context,
+        const mavsdk::rpc::mission_raw::SubscribeMissionChangedRequest* /* request */) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
-            return grpc::Status::OK;
-        }
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        auto reactor = StreamReactor<rpc::mission_raw::MissionChangedResponse>::create();
 
-        auto stream_closed_promise = std::make_shared<std::promise<void>>();
-        auto stream_closed_future = stream_closed_promise->get_future();
-        register_stream_stop_promise(stream_closed_promise);
+        if (plugin == nullptr) {
+            reactor->finish();
+            return reactor.get();
+        }
 
-        auto is_finished = std::make_shared<bool>(false);
-        auto subscribe_mutex = std::make_shared<std::mutex>();
+        _streams.add(reactor);
 
         const mavsdk::MissionRaw::MissionChangedHandle handle =
-            _lazy_plugin.maybe_plugin()->subscribe_mission_changed(
-                [this, &writer, &stream_closed_promise, is_finished, subscribe_mutex, &handle](
-                    const bool mission_changed) {
+            plugin->subscribe_mission_changed(
+                [reactor](const bool mission_changed) {
                     rpc::mission_raw::MissionChangedResponse rpc_response;
 
                     rpc_response.set_mission_changed(mission_changed);
 
-                    std::unique_lock<std::mutex> lock(*subscribe_mutex);
-                    if (!*is_finished && !writer->Write(rpc_response)) {
-                        _lazy_plugin.maybe_plugin()->unsubscribe_mission_changed(handle);
-
-                        *is_finished = true;
-                        unregister_stream_stop_promise(stream_closed_promise);
-                        stream_closed_promise->set_value();
-                    }
+                    reactor->write(std::move(rpc_response));
                 });
 
-        stream_closed_future.wait();
-        std::unique_lock<std::mutex> lock(*subscribe_mutex);
-        *is_finished = true;
+        reactor->set_on_done([plugin, handle]() { plugin->unsubscribe_mission_changed(handle); });
 
-        return grpc::Status::OK;
+        return reactor.get();
     }
 
     grpc::Status ImportQgroundcontrolMission(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::mission_raw::ImportQgroundcontrolMissionRequest* request,
         rpc::mission_raw::ImportQgroundcontrolMissionResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::MissionRaw::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -648,24 +638,25 @@ public:
         }
 
         auto result =
-            _lazy_plugin.maybe_plugin()->import_qgroundcontrol_mission(request->qgc_plan_path());
+            plugin->import_qgroundcontrol_mission(request->qgc_plan_path());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result.first);
 
-            response->set_allocated_mission_import_data(
-                translateToRpcMissionImportData(result.second).release());
+            translateToRpcMissionImportData(result.second, response->mutable_mission_import_data());
         }
 
         return grpc::Status::OK;
     }
 
     grpc::Status ImportQgroundcontrolMissionFromString(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::mission_raw::ImportQgroundcontrolMissionFromStringRequest* request,
         rpc::mission_raw::ImportQgroundcontrolMissionFromStringResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::MissionRaw::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -680,58 +671,26 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->import_qgroundcontrol_mission_from_string(
+        auto result = plugin->import_qgroundcontrol_mission_from_string(
             request->qgc_plan());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result.first);
 
-            response->set_allocated_mission_import_data(
-                translateToRpcMissionImportData(result.second).release());
+            translateToRpcMissionImportData(result.second, response->mutable_mission_import_data());
         }
 
         return grpc::Status::OK;
     }
 
-    void stop()
-    {
-        _stopped.store(true);
-        for (auto& prom : _stream_stop_promises) {
-            if (auto handle = prom.lock()) {
-                handle->set_value();
-            }
-        }
-    }
+    void stop() { _streams.finish_all(); }
 
-private:
-    void register_stream_stop_promise(std::weak_ptr<std::promise<void>> prom)
-    {
-        // If we have already stopped, set promise immediately and don't add it to list.
-        if (_stopped.load()) {
-            if (auto handle = prom.lock()) {
-                handle->set_value();
-            }
-        } else {
-            _stream_stop_promises.push_back(prom);
-        }
-    }
-
-    void unregister_stream_stop_promise(std::shared_ptr<std::promise<void>> prom)
-    {
-        for (auto it = _stream_stop_promises.begin(); it != _stream_stop_promises.end();
-             /* ++it */) {
-            if (it->lock() == prom) {
-                it = _stream_stop_promises.erase(it);
-            } else {
-                ++it;
-            }
-        }
-    }
+    const StreamStats& stream_stats() const { return _streams.stats(); }
 
+private:
     LazyPlugin& _lazy_plugin;
 
-    std::atomic<bool> _stopped{false};
-    std::vector<std::weak_ptr<std::promise<void>>> _stream_stop_promises{};
+    StreamList _streams{};
 };
 
 } // namespace mavsdk_server
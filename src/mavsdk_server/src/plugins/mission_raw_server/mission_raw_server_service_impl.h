@@ -11,6 +11,8 @@
 #include "lazy_server_plugin.h"
 
 #include "log.h"
+#include "stream_reactor.h"
+#include "system_selection.h"
 #include <atomic>
 #include <cmath>
 #include <future>
@@ -27,7 +29,11 @@ template<
     typename LazyServerPlugin = LazyServerPlugin<MissionRawServer>>
 
 class MissionRawServerServiceImpl final
-    : public rpc::mission_raw_server::MissionRawServerService::Service {
+    : public WithCallbackMethods<
+          rpc::mission_raw_server::MissionRawServerService::Service,
+          rpc::mission_raw_server::MissionRawServerService::WithCallbackMethod_SubscribeIncomingMission,
+          rpc::mission_raw_server::MissionRawServerService::WithCallbackMethod_SubscribeCurrentItemChanged,
+          rpc::mission_raw_server::MissionRawServerService::WithCallbackMethod_SubscribeClearAll> {
 public:
     MissionRawServerServiceImpl(LazyServerPlugin& lazy_plugin) : _lazy_plugin(lazy_plugin) {}
 
@@ -37,20 +43,17 @@ public:
     {
         auto rpc_result = translateToRpcResult(result);
 
-        auto* rpc_mission_raw_server_result = new rpc::mission_raw_server::MissionRawServerResult();
+        auto* rpc_mission_raw_server_result = response->mutable_mission_raw_server_result();
         rpc_mission_raw_server_result->set_result(rpc_result);
         std::stringstream ss;
         ss << result;
         rpc_mission_raw_server_result->set_result_str(ss.str());
-
-        response->set_allocated_mission_raw_server_result(rpc_mission_raw_server_result);
     }
 
-    static std::unique_ptr<rpc::mission_raw_server::MissionItem>
-    translateToRpcMissionItem(const mavsdk::MissionRawServer::MissionItem& mission_item)
+    static void translateToRpcMissionItem(
+        const mavsdk::MissionRawServer::MissionItem& mission_item,
+        rpc::mission_raw_server::MissionItem* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::mission_raw_server::MissionItem>();
-
         rpc_obj->set_seq(mission_item.seq);
 
         rpc_obj->set_frame(mission_item.frame);
@@ -76,8 +79,6 @@ public:
         rpc_obj->set_z(mission_item.z);
 
         rpc_obj->set_mission_type(mission_item.mission_type);
-
-        return rpc_obj;
     }
 
     static mavsdk::MissionRawServer::MissionItem
@@ -114,17 +115,13 @@ public:
         return obj;
     }
 
-    static std::unique_ptr<rpc::mission_raw_server::MissionPlan>
-    translateToRpcMissionPlan(const mavsdk::MissionRawServer::MissionPlan& mission_plan)
+    static void translateToRpcMissionPlan(
+        const mavsdk::MissionRawServer::MissionPlan& mission_plan,
+        rpc::mission_raw_server::MissionPlan* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::mission_raw_server::MissionPlan>();
-
         for (const auto& elem : mission_plan.mission_items) {
-            auto* ptr = rpc_obj->add_mission_items();
-            ptr->CopyFrom(*translateToRpcMissionItem(elem).release());
+            translateToRpcMissionItem(elem, rpc_obj->add_mission_items());
         }
-
-        return rpc_obj;
     }
 
     static mavsdk::MissionRawServer::MissionPlan
@@ -140,16 +137,13 @@ public:
         return obj;
     }
 
-    static std::unique_ptr<rpc::mission_raw_server::MissionProgress>
-    translateToRpcMissionProgress(const mavsdk::MissionRawServer::MissionProgress& mission_progress)
+    static void translateToRpcMissionProgress(
+        const mavsdk::MissionRawServer::MissionProgress& mission_progress,
+        rpc::mission_raw_server::MissionProgress* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::mission_raw_server::MissionProgress>();
-
         rpc_obj->set_current(mission_progress.current);
 
         rpc_obj->set_total(mission_progress.total);
-
-        return rpc_obj;
     }
 
     static mavsdk::MissionRawServer::MissionProgress translateFromRpcMissionProgress(
@@ -243,202 +237,144 @@ public:
         }
     }
 
-    grpc::Status SubscribeIncomingMission(
-        grpc::ServerContext* /* context */,
-        const mavsdk::rpc::mission_raw_server::SubscribeIncomingMissionRequest* /* request */,
-        grpc::ServerWriter<rpc::mission_raw_server::IncomingMissionResponse>* writer) override
+    grpc::ServerWriteReactor<rpc::mission_raw_server::IncomingMissionResponse>*
+    SubscribeIncomingMission(
+        grpc::CallbackServerContext* context,
+        const mavsdk::rpc::mission_raw_server::SubscribeIncomingMissionRequest* /* request */)
+        override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        auto reactor = StreamReactor<rpc::mission_raw_server::IncomingMissionResponse>::create();
+
+        if (plugin == nullptr) {
             rpc::mission_raw_server::IncomingMissionResponse rpc_response;
 
             // For server plugins, this should never happen, they should always be constructible.
             auto result = mavsdk::MissionRawServer::Result::Unknown;
             fillResponseWithResult(&rpc_response, result);
-            writer->Write(rpc_response);
+            reactor->write(std::move(rpc_response));
 
-            return grpc::Status::OK;
+            reactor->finish();
+            return reactor.get();
         }
 
-        auto stream_closed_promise = std::make_shared<std::promise<void>>();
-        auto stream_closed_future = stream_closed_promise->get_future();
-        register_stream_stop_promise(stream_closed_promise);
-
-        auto is_finished = std::make_shared<bool>(false);
-        auto subscribe_mutex = std::make_shared<std::mutex>();
+        _streams.add(reactor);
 
         const mavsdk::MissionRawServer::IncomingMissionHandle handle =
-            _lazy_plugin.maybe_plugin()->subscribe_incoming_mission(
-                [this, &writer, &stream_closed_promise, is_finished, subscribe_mutex, &handle](
+            plugin->subscribe_incoming_mission(
+                [reactor](
                     mavsdk::MissionRawServer::Result result,
                     const mavsdk::MissionRawServer::MissionPlan incoming_mission) {
                     rpc::mission_raw_server::IncomingMissionResponse rpc_response;
 
-                    rpc_response.set_allocated_mission_plan(
-                        translateToRpcMissionPlan(incoming_mission).release());
+                    translateToRpcMissionPlan(
+                        incoming_mission, rpc_response.mutable_mission_plan());
 
                     auto rpc_result = translateToRpcResult(result);
                     auto* rpc_mission_raw_server_result =
-                        new rpc::mission_raw_server::MissionRawServerResult();
+                        rpc_response.mutable_mission_raw_server_result();
                     rpc_mission_raw_server_result->set_result(rpc_result);
                     std::stringstream ss;
                     ss << result;
                     rpc_mission_raw_server_result->set_result_str(ss.str());
-                    rpc_response.set_allocated_mission_raw_server_result(
-                        rpc_mission_raw_server_result);
-
-                    std::unique_lock<std::mutex> lock(*subscribe_mutex);
-                    if (!*is_finished && !writer->Write(rpc_response)) {
-                        _lazy_plugin.maybe_plugin()->unsubscribe_incoming_mission(handle);
 
-                        *is_finished = true;
-                        unregister_stream_stop_promise(stream_closed_promise);
-                        stream_closed_promise->set_value();
-                    }
+                    reactor->write(std::move(rpc_response));
                 });
 
-        stream_closed_future.wait();
-        std::unique_lock<std::mutex> lock(*subscribe_mutex);
-        *is_finished = true;
+        reactor->set_on_done([plugin, handle]() { plugin->unsubscribe_incoming_mission(handle); });
 
-        return grpc::Status::OK;
+        return reactor.get();
     }
 
-    grpc::Status SubscribeCurrentItemChanged(
-        grpc::ServerContext* /* context */,
-        const mavsdk::rpc::mission_raw_server::SubscribeCurrentItemChangedRequest* /* request */,
-        grpc::ServerWriter<rpc::mission_raw_server::CurrentItemChangedResponse>* writer) override
+    grpc::ServerWriteReactor<rpc::mission_raw_server::CurrentItemChangedResponse>*
+    SubscribeCurrentItemChanged(
+        grpc::CallbackServerContext* context,
+        const mavsdk::rpc::mission_raw_server::SubscribeCurrentItemChangedRequest* /* request */)
+        override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
-            return grpc::Status::OK;
-        }
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
 
-        auto stream_closed_promise = std::make_shared<std::promise<void>>();
-        auto stream_closed_future = stream_closed_promise->get_future();
-        register_stream_stop_promise(stream_closed_promise);
+        auto reactor = StreamReactor<rpc::mission_raw_server::CurrentItemChangedResponse>::create();
 
-        auto is_finished = std::make_shared<bool>(false);
-        auto subscribe_mutex = std::make_shared<std::mutex>();
+        if (plugin == nullptr) {
+            reactor->finish();
+            return reactor.get();
+        }
+
+        _streams.add(reactor);
 
         const mavsdk::MissionRawServer::CurrentItemChangedHandle handle =
-            _lazy_plugin.maybe_plugin()->subscribe_current_item_changed(
-                [this, &writer, &stream_closed_promise, is_finished, subscribe_mutex, &handle](
-                    const mavsdk::MissionRawServer::MissionItem current_item_changed) {
+            plugin->subscribe_current_item_changed(
+                [reactor](const mavsdk::MissionRawServer::MissionItem current_item_changed) {
                     rpc::mission_raw_server::CurrentItemChangedResponse rpc_response;
 
-                    rpc_response.set_allocated_mission_item(
-                        translateToRpcMissionItem(current_item_changed).release());
+                    translateToRpcMissionItem(
+                        current_item_changed, rpc_response.mutable_mission_item());
 
-                    std::unique_lock<std::mutex> lock(*subscribe_mutex);
-                    if (!*is_finished && !writer->Write(rpc_response)) {
-                        _lazy_plugin.maybe_plugin()->unsubscribe_current_item_changed(handle);
-
-                        *is_finished = true;
-                        unregister_stream_stop_promise(stream_closed_promise);
-                        stream_closed_promise->set_value();
-                    }
+                    reactor->write(std::move(rpc_response));
                 });
 
-        stream_closed_future.wait();
-        std::unique_lock<std::mutex> lock(*subscribe_mutex);
-        *is_finished = true;
+        reactor->set_on_done(
+            [plugin, handle]() { plugin->unsubscribe_current_item_changed(handle); });
 
-        return grpc::Status::OK;
+        return reactor.get();
     }
 
     grpc::Status SetCurrentItemComplete(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::mission_raw_server::SetCurrentItemCompleteRequest* /* request */,
         rpc::mission_raw_server::SetCurrentItemCompleteResponse* /* response */) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             return grpc::Status::OK;
         }
 
-        _lazy_plugin.maybe_plugin()->set_current_item_complete();
+        plugin->set_current_item_complete();
 
         return grpc::Status::OK;
     }
 
-    grpc::Status SubscribeClearAll(
-        grpc::ServerContext* /* context */,
-        const mavsdk::rpc::mission_raw_server::SubscribeClearAllRequest* /* request */,
-        grpc::ServerWriter<rpc::mission_raw_server::ClearAllResponse>* writer) override
+    grpc::ServerWriteReactor<rpc::mission_raw_server::ClearAllResponse>* SubscribeClearAll(
+        grpc::CallbackServerContext* context,
+        const mavsdk::rpc::mission_raw_server::SubscribeClearAllRequest* /* request */) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
-            return grpc::Status::OK;
-        }
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
 
-        auto stream_closed_promise = std::make_shared<std::promise<void>>();
-        auto stream_closed_future = stream_closed_promise->get_future();
-        register_stream_stop_promise(stream_closed_promise);
+        auto reactor = StreamReactor<rpc::mission_raw_server::ClearAllResponse>::create();
+
+        if (plugin == nullptr) {
+            reactor->finish();
+            return reactor.get();
+        }
 
-        auto is_finished = std::make_shared<bool>(false);
-        auto subscribe_mutex = std::make_shared<std::mutex>();
+        _streams.add(reactor);
 
         const mavsdk::MissionRawServer::ClearAllHandle handle =
-            _lazy_plugin.maybe_plugin()->subscribe_clear_all(
-                [this, &writer, &stream_closed_promise, is_finished, subscribe_mutex, &handle](
-                    const uint32_t clear_all) {
+            plugin->subscribe_clear_all(
+                [reactor](const uint32_t clear_all) {
                     rpc::mission_raw_server::ClearAllResponse rpc_response;
 
                     rpc_response.set_clear_type(clear_all);
 
-                    std::unique_lock<std::mutex> lock(*subscribe_mutex);
-                    if (!*is_finished && !writer->Write(rpc_response)) {
-                        _lazy_plugin.maybe_plugin()->unsubscribe_clear_all(handle);
-
-                        *is_finished = true;
-                        unregister_stream_stop_promise(stream_closed_promise);
-                        stream_closed_promise->set_value();
-                    }
+                    reactor->write(std::move(rpc_response));
                 });
 
-        stream_closed_future.wait();
-        std::unique_lock<std::mutex> lock(*subscribe_mutex);
-        *is_finished = true;
+        reactor->set_on_done([plugin, handle]() { plugin->unsubscribe_clear_all(handle); });
 
-        return grpc::Status::OK;
+        return reactor.get();
     }
 
-    void stop()
-    {
-        _stopped.store(true);
-        for (auto& prom : _stream_stop_promises) {
-            if (auto handle = prom.lock()) {
-                handle->set_value();
-            }
-        }
-    }
+    void stop() { _streams.finish_all(); }
 
-private:
-    void register_stream_stop_promise(std::weak_ptr<std::promise<void>> prom)
-    {
-        // If we have already stopped, set promise immediately and don't add it to list.
-        if (_stopped.load()) {
-            if (auto handle = prom.lock()) {
-                handle->set_value();
-            }
-        } else {
-            _stream_stop_promises.push_back(prom);
-        }
-    }
-
-    void unregister_stream_stop_promise(std::shared_ptr<std::promise<void>> prom)
-    {
-        for (auto it = _stream_stop_promises.begin(); it != _stream_stop_promises.end();
-             /* ++it */) {
-            if (it->lock() == prom) {
-                it = _stream_stop_promises.erase(it);
-            } else {
-                ++it;
-            }
-        }
-    }
+    const StreamStats& stream_stats() const { return _streams.stats(); }
 
+private:
     LazyServerPlugin& _lazy_plugin;
 
-    std::atomic<bool> _stopped{false};
-    std::vector<std::weak_ptr<std::promise<void>>> _stream_stop_promises{};
+    StreamList _streams{};
 };
 
 } // namespace mavsdk_server
@@ -10,6 +10,8 @@
 #include "lazy_plugin.h"
 
 #include "log.h"
+#include "stream_reactor.h"
+#include "system_selection.h"
 #include <atomic>
 #include <cmath>
 #include <future>
@@ -23,7 +25,7 @@ namespace mavsdk_server {
 
 template<typename Mocap = Mocap, typename LazyPlugin = LazyPlugin<Mocap>>
 
-class MocapServiceImpl final : public rpc::mocap::MocapService::Service {
+class MocapServiceImpl final : public WithCallbackMethods<rpc::mocap::MocapService::Service> {
 public:
     MocapServiceImpl(LazyPlugin& lazy_plugin) : _lazy_plugin(lazy_plugin) {}
 
@@ -32,27 +34,21 @@ public:
     {
         auto rpc_result = translateToRpcResult(result);
 
-        auto* rpc_mocap_result = new rpc::mocap::MocapResult();
+        auto* rpc_mocap_result = response->mutable_mocap_result();
         rpc_mocap_result->set_result(rpc_result);
         std::stringstream ss;
         ss << result;
         rpc_mocap_result->set_result_str(ss.str());
-
-        response->set_allocated_mocap_result(rpc_mocap_result);
     }
 
-    static std::unique_ptr<rpc::mocap::PositionBody>
-    translateToRpcPositionBody(const mavsdk::Mocap::PositionBody& position_body)
+    static void translateToRpcPositionBody(
+        const mavsdk::Mocap::PositionBody& position_body, rpc::mocap::PositionBody* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::mocap::PositionBody>();
-
         rpc_obj->set_x_m(position_body.x_m);
 
         rpc_obj->set_y_m(position_body.y_m);
 
         rpc_obj->set_z_m(position_body.z_m);
-
-        return rpc_obj;
     }
 
     static mavsdk::Mocap::PositionBody
@@ -69,18 +65,14 @@ public:
         return obj;
     }
 
-    static std::unique_ptr<rpc::mocap::AngleBody>
-    translateToRpcAngleBody(const mavsdk::Mocap::AngleBody& angle_body)
+    static void translateToRpcAngleBody(
+        const mavsdk::Mocap::AngleBody& angle_body, rpc::mocap::AngleBody* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::mocap::AngleBody>();
-
         rpc_obj->set_roll_rad(angle_body.roll_rad);
 
         rpc_obj->set_pitch_rad(angle_body.pitch_rad);
 
         rpc_obj->set_yaw_rad(angle_body.yaw_rad);
-
-        return rpc_obj;
     }
 
     static mavsdk::Mocap::AngleBody
@@ -97,18 +89,14 @@ public:
         return obj;
     }
 
-    static std::unique_ptr<rpc::mocap::SpeedBody>
-    translateToRpcSpeedBody(const mavsdk::Mocap::SpeedBody& speed_body)
+    static void translateToRpcSpeedBody(
+        const mavsdk::Mocap::SpeedBody& speed_body, rpc::mocap::SpeedBody* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::mocap::SpeedBody>();
-
         rpc_obj->set_x_m_s(speed_body.x_m_s);
 
         rpc_obj->set_y_m_s(speed_body.y_m_s);
 
         rpc_obj->set_z_m_s(speed_body.z_m_s);
-
-        return rpc_obj;
     }
 
     static mavsdk::Mocap::SpeedBody
@@ -125,18 +113,15 @@ public:
         return obj;
     }
 
-    static std::unique_ptr<rpc::mocap::AngularVelocityBody> translateToRpcAngularVelocityBody(
-        const mavsdk::Mocap::AngularVelocityBody& angular_velocity_body)
+    static void translateToRpcAngularVelocityBody(
+        const mavsdk::Mocap::AngularVelocityBody& angular_velocity_body,
+        rpc::mocap::AngularVelocityBody* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::mocap::AngularVelocityBody>();
-
         rpc_obj->set_roll_rad_s(angular_velocity_body.roll_rad_s);
 
         rpc_obj->set_pitch_rad_s(angular_velocity_body.pitch_rad_s);
 
         rpc_obj->set_yaw_rad_s(angular_velocity_body.yaw_rad_s);
-
-        return rpc_obj;
     }
 
     static mavsdk::Mocap::AngularVelocityBody translateFromRpcAngularVelocityBody(
@@ -153,16 +138,12 @@ public:
         return obj;
     }
 
-    static std::unique_ptr<rpc::mocap::Covariance>
-    translateToRpcCovariance(const mavsdk::Mocap::Covariance& covariance)
+    static void translateToRpcCovariance(
+        const mavsdk::Mocap::Covariance& covariance, rpc::mocap::Covariance* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::mocap::Covariance>();
-
         for (const auto& elem : covariance.covariance_matrix) {
             rpc_obj->add_covariance_matrix(elem);
         }
-
-        return rpc_obj;
     }
 
     static mavsdk::Mocap::Covariance
@@ -177,11 +158,9 @@ public:
         return obj;
     }
 
-    static std::unique_ptr<rpc::mocap::Quaternion>
-    translateToRpcQuaternion(const mavsdk::Mocap::Quaternion& quaternion)
+    static void translateToRpcQuaternion(
+        const mavsdk::Mocap::Quaternion& quaternion, rpc::mocap::Quaternion* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::mocap::Quaternion>();
-
         rpc_obj->set_w(quaternion.w);
 
         rpc_obj->set_x(quaternion.x);
@@ -189,8 +168,6 @@ public:
         rpc_obj->set_y(quaternion.y);
 
         rpc_obj->set_z(quaternion.z);
-
-        return rpc_obj;
     }
 
     static mavsdk::Mocap::Quaternion
@@ -209,23 +186,19 @@ public:
         return obj;
     }
 
-    static std::unique_ptr<rpc::mocap::VisionPositionEstimate> translateToRpcVisionPositionEstimate(
-        const mavsdk::Mocap::VisionPositionEstimate& vision_position_estimate)
+    static void translateToRpcVisionPositionEstimate(
+        const mavsdk::Mocap::VisionPositionEstimate& vision_position_estimate,
+        rpc::mocap::VisionPositionEstimate* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::mocap::VisionPositionEstimate>();
-
         rpc_obj->set_time_usec(vision_position_estimate.time_usec);
 
-        rpc_obj->set_allocated_position_body(
-            translateToRpcPositionBody(vision_position_estimate.position_body).release());
-
-        rpc_obj->set_allocated_angle_body(
-            translateToRpcAngleBody(vision_position_estimate.angle_body).release());
+        translateToRpcPositionBody(
+            vision_position_estimate.position_body, rpc_obj->mutable_position_body());
 
-        rpc_obj->set_allocated_pose_covariance(
-            translateToRpcCovariance(vision_position_estimate.pose_covariance).release());
+        translateToRpcAngleBody(vision_position_estimate.angle_body, rpc_obj->mutable_angle_body());
 
-        return rpc_obj;
+        translateToRpcCovariance(
+            vision_position_estimate.pose_covariance, rpc_obj->mutable_pose_covariance());
     }
 
     static mavsdk::Mocap::VisionPositionEstimate translateFromRpcVisionPositionEstimate(
@@ -245,22 +218,19 @@ public:
         return obj;
     }
 
-    static std::unique_ptr<rpc::mocap::AttitudePositionMocap> translateToRpcAttitudePositionMocap(
-        const mavsdk::Mocap::AttitudePositionMocap& attitude_position_mocap)
+    static void translateToRpcAttitudePositionMocap(
+        const mavsdk::Mocap::AttitudePositionMocap& attitude_position_mocap,
+        rpc::mocap::AttitudePositionMocap* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::mocap::AttitudePositionMocap>();
-
         rpc_obj->set_time_usec(attitude_position_mocap.time_usec);
 
-        rpc_obj->set_allocated_q(translateToRpcQuaternion(attitude_position_mocap.q).release());
-
-        rpc_obj->set_allocated_position_body(
-            translateToRpcPositionBody(attitude_position_mocap.position_body).release());
+        translateToRpcQuaternion(attitude_position_mocap.q, rpc_obj->mutable_q());
 
-        rpc_obj->set_allocated_pose_covariance(
-            translateToRpcCovariance(attitude_position_mocap.pose_covariance).release());
+        translateToRpcPositionBody(
+            attitude_position_mocap.position_body, rpc_obj->mutable_position_body());
 
-        return rpc_obj;
+        translateToRpcCovariance(
+            attitude_position_mocap.pose_covariance, rpc_obj->mutable_pose_covariance());
     }
 
     static mavsdk::Mocap::AttitudePositionMocap translateFromRpcAttitudePositionMocap(
@@ -307,32 +277,26 @@ public:
         }
     }
 
-    static std::unique_ptr<rpc::mocap::Odometry>
-    translateToRpcOdometry(const mavsdk::Mocap::Odometry& odometry)
+    static void translateToRpcOdometry(
+        const mavsdk::Mocap::Odometry& odometry, rpc::mocap::Odometry* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::mocap::Odometry>();
-
         rpc_obj->set_time_usec(odometry.time_usec);
 
         rpc_obj->set_frame_id(translateToRpcMavFrame(odometry.frame_id));
 
-        rpc_obj->set_allocated_position_body(
-            translateToRpcPositionBody(odometry.position_body).release());
-
-        rpc_obj->set_allocated_q(translateToRpcQuaternion(odometry.q).release());
+        translateToRpcPositionBody(odometry.position_body, rpc_obj->mutable_position_body());
 
-        rpc_obj->set_allocated_speed_body(translateToRpcSpeedBody(odometry.speed_body).release());
+        translateToRpcQuaternion(odometry.q, rpc_obj->mutable_q());
 
-        rpc_obj->set_allocated_angular_velocity_body(
-            translateToRpcAngularVelocityBody(odometry.angular_velocity_body).release());
+        translateToRpcSpeedBody(odometry.speed_body, rpc_obj->mutable_speed_body());
 
-        rpc_obj->set_allocated_pose_covariance(
-            translateToRpcCovariance(odometry.pose_covariance).release());
+        translateToRpcAngularVelocityBody(
+            odometry.angular_velocity_body, rpc_obj->mutable_angular_velocity_body());
 
-        rpc_obj->set_allocated_velocity_covariance(
-            translateToRpcCovariance(odometry.velocity_covariance).release());
+        translateToRpcCovariance(odometry.pose_covariance, rpc_obj->mutable_pose_covariance());
 
-        return rpc_obj;
+        translateToRpcCovariance(
+            odometry.velocity_covariance, rpc_obj->mutable_velocity_covariance());
     }
 
     static mavsdk::Mocap::Odometry translateFromRpcOdometry(const rpc::mocap::Odometry& odometry)
@@ -403,11 +367,13 @@ public:
     }
 
     grpc::Status SetVisionPositionEstimate(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::mocap::SetVisionPositionEstimateRequest* request,
         rpc::mocap::SetVisionPositionEstimateResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Mocap::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -421,7 +387,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->set_vision_position_estimate(
+        auto result = plugin->set_vision_position_estimate(
             translateFromRpcVisionPositionEstimate(request->vision_position_estimate()));
 
         if (response != nullptr) {
@@ -432,11 +398,13 @@ public:
     }
 
     grpc::Status SetAttitudePositionMocap(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::mocap::SetAttitudePositionMocapRequest* request,
         rpc::mocap::SetAttitudePositionMocapResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Mocap::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -450,7 +418,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->set_attitude_position_mocap(
+        auto result = plugin->set_attitude_position_mocap(
             translateFromRpcAttitudePositionMocap(request->attitude_position_mocap()));
 
         if (response != nullptr) {
@@ -461,11 +429,13 @@ public:
     }
 
     grpc::Status SetOdometry(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::mocap::SetOdometryRequest* request,
         rpc::mocap::SetOdometryResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Mocap::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -479,7 +449,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->set_odometry(
+        auto result = plugin->set_odometry(
             translateFromRpcOdometry(request->odometry()));
 
         if (response != nullptr) {
@@ -489,45 +459,14 @@ public:
         return grpc::Status::OK;
     }
 
-    void stop()
-    {
-        _stopped.store(true);
-        for (auto& prom : _stream_stop_promises) {
-            if (auto handle = prom.lock()) {
-                handle->set_value();
-            }
-        }
-    }
-
-private:
-    void register_stream_stop_promise(std::weak_ptr<std::promise<void>> prom)
-    {
-        // If we have already stopped, set promise immediately and don't add it to list.
-        if (_stopped.load()) {
-            if (auto handle = prom.lock()) {
-                handle->set_value();
-            }
-        } else {
-            _stream_stop_promises.push_back(prom);
-        }
-    }
+    void stop() { _streams.finish_all(); }
 
-    void unregister_stream_stop_promise(std::shared_ptr<std::promise<void>> prom)
-    {
-        for (auto it = _stream_stop_promises.begin(); it != _stream_stop_promises.end();
-             /* ++it */) {
-            if (it->lock() == prom) {
-                it = _stream_stop_promises.erase(it);
-            } else {
-                ++it;
-            }
-        }
-    }
+    const StreamStats& stream_stats() const { return _streams.stats(); }
 
+private:
     LazyPlugin& _lazy_plugin;
 
-    std::atomic<bool> _stopped{false};
-    std::vector<std::weak_ptr<std::promise<void>>> _stream_stop_promises{};
+    StreamList _streams{};
 };
 
 } // namespace mavsdk_server
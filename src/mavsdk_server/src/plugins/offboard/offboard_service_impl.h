@@ -10,6 +10,8 @@
 #include "lazy_plugin.h"
 
 #include "log.h"
+#include "stream_reactor.h"
+#include "system_selection.h"
 #include <atomic>
 #include <cmath>
 #include <future>
@@ -23,7 +25,8 @@ namespace mavsdk_server {
 
 template<typename Offboard = Offboard, typename LazyPlugin = LazyPlugin<Offboard>>
 
-class OffboardServiceImpl final : public rpc::offboard::OffboardService::Service {
+class OffboardServiceImpl final
+    : public WithCallbackMethods<rpc::offboard::OffboardService::Service> {
 public:
     OffboardServiceImpl(LazyPlugin& lazy_plugin) : _lazy_plugin(lazy_plugin) {}
 
@@ -32,20 +35,16 @@ public:
     {
         auto rpc_result = translateToRpcResult(result);
 
-        auto* rpc_offboard_result = new rpc::offboard::OffboardResult();
+        auto* rpc_offboard_result = response->mutable_offboard_result();
         rpc_offboard_result->set_result(rpc_result);
         std::stringstream ss;
         ss << result;
         rpc_offboard_result->set_result_str(ss.str());
-
-        response->set_allocated_offboard_result(rpc_offboard_result);
     }
 
-    static std::unique_ptr<rpc::offboard::Attitude>
-    translateToRpcAttitude(const mavsdk::Offboard::Attitude& attitude)
+    static void translateToRpcAttitude(
+        const mavsdk::Offboard::Attitude& attitude, rpc::offboard::Attitude* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::offboard::Attitude>();
-
         rpc_obj->set_roll_deg(attitude.roll_deg);
 
         rpc_obj->set_pitch_deg(attitude.pitch_deg);
@@ -53,8 +52,6 @@ public:
         rpc_obj->set_yaw_deg(attitude.yaw_deg);
 
         rpc_obj->set_thrust_value(attitude.thrust_value);
-
-        return rpc_obj;
     }
 
     static mavsdk::Offboard::Attitude
@@ -73,16 +70,13 @@ public:
         return obj;
     }
 
-    static std::unique_ptr<rpc::offboard::ActuatorControlGroup> translateToRpcActuatorControlGroup(
-        const mavsdk::Offboard::ActuatorControlGroup& actuator_control_group)
+    static void translateToRpcActuatorControlGroup(
+        const mavsdk::Offboard::ActuatorControlGroup& actuator_control_group,
+        rpc::offboard::ActuatorControlGroup* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::offboard::ActuatorControlGroup>();
-
         for (const auto& elem : actuator_control_group.controls) {
             rpc_obj->add_controls(elem);
         }
-
-        return rpc_obj;
     }
 
     static mavsdk::Offboard::ActuatorControlGroup translateFromRpcActuatorControlGroup(
@@ -97,17 +91,13 @@ public:
         return obj;
     }
 
-    static std::unique_ptr<rpc::offboard::ActuatorControl>
-    translateToRpcActuatorControl(const mavsdk::Offboard::ActuatorControl& actuator_control)
+    static void translateToRpcActuatorControl(
+        const mavsdk::Offboard::ActuatorControl& actuator_control,
+        rpc::offboard::ActuatorControl* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::offboard::ActuatorControl>();
-
         for (const auto& elem : actuator_control.groups) {
-            auto* ptr = rpc_obj->add_groups();
-            ptr->CopyFrom(*translateToRpcActuatorControlGroup(elem).release());
+            translateToRpcActuatorControlGroup(elem, rpc_obj->add_groups());
         }
-
-        return rpc_obj;
     }
 
     static mavsdk::Offboard::ActuatorControl
@@ -123,11 +113,9 @@ public:
         return obj;
     }
 
-    static std::unique_ptr<rpc::offboard::AttitudeRate>
-    translateToRpcAttitudeRate(const mavsdk::Offboard::AttitudeRate& attitude_rate)
+    static void translateToRpcAttitudeRate(
+        const mavsdk::Offboard::AttitudeRate& attitude_rate, rpc::offboard::AttitudeRate* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::offboard::AttitudeRate>();
-
         rpc_obj->set_roll_deg_s(attitude_rate.roll_deg_s);
 
         rpc_obj->set_pitch_deg_s(attitude_rate.pitch_deg_s);
@@ -135,8 +123,6 @@ public:
         rpc_obj->set_yaw_deg_s(attitude_rate.yaw_deg_s);
 
         rpc_obj->set_thrust_value(attitude_rate.thrust_value);
-
-        return rpc_obj;
     }
 
     static mavsdk::Offboard::AttitudeRate
@@ -155,11 +141,10 @@ public:
         return obj;
     }
 
-    static std::unique_ptr<rpc::offboard::PositionNedYaw>
-    translateToRpcPositionNedYaw(const mavsdk::Offboard::PositionNedYaw& position_ned_yaw)
+    static void translateToRpcPositionNedYaw(
+        const mavsdk::Offboard::PositionNedYaw& position_ned_yaw,
+        rpc::offboard::PositionNedYaw* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::offboard::PositionNedYaw>();
-
         rpc_obj->set_north_m(position_ned_yaw.north_m);
 
         rpc_obj->set_east_m(position_ned_yaw.east_m);
@@ -167,8 +152,6 @@ public:
         rpc_obj->set_down_m(position_ned_yaw.down_m);
 
         rpc_obj->set_yaw_deg(position_ned_yaw.yaw_deg);
-
-        return rpc_obj;
     }
 
     static mavsdk::Offboard::PositionNedYaw
@@ -219,11 +202,10 @@ public:
         }
     }
 
-    static std::unique_ptr<rpc::offboard::PositionGlobalYaw>
-    translateToRpcPositionGlobalYaw(const mavsdk::Offboard::PositionGlobalYaw& position_global_yaw)
+    static void translateToRpcPositionGlobalYaw(
+        const mavsdk::Offboard::PositionGlobalYaw& position_global_yaw,
+        rpc::offboard::PositionGlobalYaw* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::offboard::PositionGlobalYaw>();
-
         rpc_obj->set_lat_deg(position_global_yaw.lat_deg);
 
         rpc_obj->set_lon_deg(position_global_yaw.lon_deg);
@@ -233,8 +215,6 @@ public:
         rpc_obj->set_yaw_deg(position_global_yaw.yaw_deg);
 
         rpc_obj->set_altitude_type(translateToRpcAltitudeType(position_global_yaw.altitude_type));
-
-        return rpc_obj;
     }
 
     static mavsdk::Offboard::PositionGlobalYaw
@@ -255,11 +235,10 @@ public:
         return obj;
     }
 
-    static std::unique_ptr<rpc::offboard::VelocityBodyYawspeed> translateToRpcVelocityBodyYawspeed(
-        const mavsdk::Offboard::VelocityBodyYawspeed& velocity_body_yawspeed)
+    static void translateToRpcVelocityBodyYawspeed(
+        const mavsdk::Offboard::VelocityBodyYawspeed& velocity_body_yawspeed,
+        rpc::offboard::VelocityBodyYawspeed* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::offboard::VelocityBodyYawspeed>();
-
         rpc_obj->set_forward_m_s(velocity_body_yawspeed.forward_m_s);
 
         rpc_obj->set_right_m_s(velocity_body_yawspeed.right_m_s);
@@ -267,8 +246,6 @@ public:
         rpc_obj->set_down_m_s(velocity_body_yawspeed.down_m_s);
 
         rpc_obj->set_yawspeed_deg_s(velocity_body_yawspeed.yawspeed_deg_s);
-
-        return rpc_obj;
     }
 
     static mavsdk::Offboard::VelocityBodyYawspeed translateFromRpcVelocityBodyYawspeed(
@@ -287,11 +264,10 @@ public:
         return obj;
     }
 
-    static std::unique_ptr<rpc::offboard::VelocityNedYaw>
-    translateToRpcVelocityNedYaw(const mavsdk::Offboard::VelocityNedYaw& velocity_ned_yaw)
+    static void translateToRpcVelocityNedYaw(
+        const mavsdk::Offboard::VelocityNedYaw& velocity_ned_yaw,
+        rpc::offboard::VelocityNedYaw* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::offboard::VelocityNedYaw>();
-
         rpc_obj->set_north_m_s(velocity_ned_yaw.north_m_s);
 
         rpc_obj->set_east_m_s(velocity_ned_yaw.east_m_s);
@@ -299,8 +275,6 @@ public:
         rpc_obj->set_down_m_s(velocity_ned_yaw.down_m_s);
 
         rpc_obj->set_yaw_deg(velocity_ned_yaw.yaw_deg);
-
-        return rpc_obj;
     }
 
     static mavsdk::Offboard::VelocityNedYaw
@@ -319,18 +293,15 @@ public:
         return obj;
     }
 
-    static std::unique_ptr<rpc::offboard::AccelerationNed>
-    translateToRpcAccelerationNed(const mavsdk::Offboard::AccelerationNed& acceleration_ned)
+    static void translateToRpcAccelerationNed(
+        const mavsdk::Offboard::AccelerationNed& acceleration_ned,
+        rpc::offboard::AccelerationNed* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::offboard::AccelerationNed>();
-
         rpc_obj->set_north_m_s2(acceleration_ned.north_m_s2);
 
         rpc_obj->set_east_m_s2(acceleration_ned.east_m_s2);
 
         rpc_obj->set_down_m_s2(acceleration_ned.down_m_s2);
-
-        return rpc_obj;
     }
 
     static mavsdk::Offboard::AccelerationNed
@@ -404,11 +375,13 @@ public:
     }
 
     grpc::Status Start(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::offboard::StartRequest* /* request */,
         rpc::offboard::StartResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Offboard::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -417,7 +390,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->start();
+        auto result = plugin->start();
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -427,11 +400,13 @@ public:
     }
 
     grpc::Status Stop(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::offboard::StopRequest* /* request */,
         rpc::offboard::StopResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Offboard::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -440,7 +415,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->stop();
+        auto result = plugin->stop();
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -450,15 +425,17 @@ public:
     }
 
     grpc::Status IsActive(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::offboard::IsActiveRequest* /* request */,
         rpc::offboard::IsActiveResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->is_active();
+        auto result = plugin->is_active();
 
         if (response != nullptr) {
             response->set_is_active(result);
@@ -468,11 +445,13 @@ public:
     }
 
     grpc::Status SetAttitude(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::offboard::SetAttitudeRequest* request,
         rpc::offboard::SetAttitudeResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Offboard::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -486,7 +465,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->set_attitude(
+        auto result = plugin->set_attitude(
             translateFromRpcAttitude(request->attitude()));
 
         if (response != nullptr) {
@@ -497,11 +476,13 @@ public:
     }
 
     grpc::Status SetActuatorControl(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::offboard::SetActuatorControlRequest* request,
         rpc::offboard::SetActuatorControlResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Offboard::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -515,7 +496,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->set_actuator_control(
+        auto result = plugin->set_actuator_control(
             translateFromRpcActuatorControl(request->actuator_control()));
 
         if (response != nullptr) {
@@ -526,11 +507,13 @@ public:
     }
 
     grpc::Status SetAttitudeRate(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::offboard::SetAttitudeRateRequest* request,
         rpc::offboard::SetAttitudeRateResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Offboard::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -544,7 +527,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->set_attitude_rate(
+        auto result = plugin->set_attitude_rate(
             translateFromRpcAttitudeRate(request->attitude_rate()));
 
         if (response != nullptr) {
@@ -555,11 +538,13 @@ public:
     }
 
     grpc::Status SetPositionNed(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::offboard::SetPositionNedRequest* request,
         rpc::offboard::SetPositionNedResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Offboard::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -573,7 +558,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->set_position_ned(
+        auto result = plugin->set_position_ned(
             translateFromRpcPositionNedYaw(request->position_ned_yaw()));
 
         if (response != nullptr) {
@@ -584,11 +569,13 @@ public:
     }
 
     grpc::Status SetPositionGlobal(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::offboard::SetPositionGlobalRequest* request,
         rpc::offboard::SetPositionGlobalResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Offboard::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -602,7 +589,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->set_position_global(
+        auto result = plugin->set_position_global(
             translateFromRpcPositionGlobalYaw(request->position_global_yaw()));
 
         if (response != nullptr) {
@@ -613,11 +600,13 @@ public:
     }
 
     grpc::Status SetVelocityBody(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::offboard::SetVelocityBodyRequest* request,
         rpc::offboard::SetVelocityBodyResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Offboard::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -631,7 +620,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->set_velocity_body(
+        auto result = plugin->set_velocity_body(
             translateFromRpcVelocityBodyYawspeed(request->velocity_body_yawspeed()));
 
         if (response != nullptr) {
@@ -642,11 +631,13 @@ public:
     }
 
     grpc::Status SetVelocityNed(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::offboard::SetVelocityNedRequest* request,
         rpc::offboard::SetVelocityNedResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Offboard::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -660,7 +651,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->set_velocity_ned(
+        auto result = plugin->set_velocity_ned(
             translateFromRpcVelocityNedYaw(request->velocity_ned_yaw()));
 
         if (response != nullptr) {
@@ -671,11 +662,13 @@ public:
     }
 
     grpc::Status SetPositionVelocityNed(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::offboard::SetPositionVelocityNedRequest* request,
         rpc::offboard::SetPositionVelocityNedResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Offboard::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -689,7 +682,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->set_position_velocity_ned(
+        auto result = plugin->set_position_velocity_ned(
             translateFromRpcPositionNedYaw(request->position_ned_yaw()),
             translateFromRpcVelocityNedYaw(request->velocity_ned_yaw()));
 
@@ -701,11 +694,13 @@ public:
     }
 
     grpc::Status SetAccelerationNed(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::offboard::SetAccelerationNedRequest* request,
         rpc::offboard::SetAccelerationNedResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Offboard::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -719,7 +714,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->set_acceleration_ned(
+        auto result = plugin->set_acceleration_ned(
             translateFromRpcAccelerationNed(request->acceleration_ned()));
 
         if (response != nullptr) {
@@ -729,45 +724,14 @@ public:
         return grpc::Status::OK;
     }
 
-    void stop()
-    {
-        _stopped.store(true);
-        for (auto& prom : _stream_stop_promises) {
-            if (auto handle = prom.lock()) {
-                handle->set_value();
-            }
-        }
-    }
+    void stop() { _streams.finish_all(); }
 
-private:
-    void register_stream_stop_promise(std::weak_ptr<std::promise<void>> prom)
-    {
-        // If we have already stopped, set promise immediately and don't add it to list.
-        if (_stopped.load()) {
-            if (auto handle = prom.lock()) {
-                handle->set_value();
-            }
-        } else {
-            _stream_stop_promises.push_back(prom);
-        }
-    }
-
-    void unregister_stream_stop_promise(std::shared_ptr<std::promise<void>> prom)
-    {
-        for (auto it = _stream_stop_promises.begin(); it != _stream_stop_promises.end();
-             /* ++it */) {
-            if (it->lock() == prom) {
-                it = _stream_stop_promises.erase(it);
-            } else {
-                ++it;
-            }
-        }
-    }
+    const StreamStats& stream_stats() const { return _streams.stats(); }
 
+private:
     LazyPlugin& _lazy_plugin;
 
-    std::atomic<bool> _stopped{false};
-    std::vector<std::weak_ptr<std::promise<void>>> _stream_stop_promises{};
+    StreamList _streams{};
 };
 
 } // namespace mavsdk_server
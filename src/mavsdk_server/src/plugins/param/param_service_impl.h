@@ -10,6 +10,8 @@
 #include "lazy_plugin.h"
 
 #include "log.h"
+#include "stream_reactor.h"
+#include "system_selection.h"
 #include <atomic>
 #include <cmath>
 #include <future>
@@ -23,7 +25,7 @@ namespace mavsdk_server {
 
 template<typename Param = Param, typename LazyPlugin = LazyPlugin<Param>>
 
-class ParamServiceImpl final : public rpc::param::ParamService::Service {
+class ParamServiceImpl final : public WithCallbackMethods<rpc::param::ParamService::Service> {
 public:
     ParamServiceImpl(LazyPlugin& lazy_plugin) : _lazy_plugin(lazy_plugin) {}
 
@@ -32,25 +34,19 @@ public:
     {
         auto rpc_result = translateToRpcResult(result);
 
-        auto* rpc_param_result = new rpc::param::ParamResult();
+        auto* rpc_param_result = response->mutable_param_result();
         rpc_param_result->set_result(rpc_result);
         std::stringstream ss;
         ss << result;
         rpc_param_result->set_result_str(ss.str());
-
-        response->set_allocated_param_result(rpc_param_result);
     }
 
-    static std::unique_ptr<rpc::param::IntParam>
-    translateToRpcIntParam(const mavsdk::Param::IntParam& int_param)
+    static void translateToRpcIntParam(
+        const mavsdk::Param::IntParam& int_param, rpc::param::IntParam* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::param::IntParam>();
-
         rpc_obj->set_name(int_param.name);
 
         rpc_obj->set_value(int_param.value);
-
-        return rpc_obj;
     }
 
     static mavsdk::Param::IntParam translateFromRpcIntParam(const rpc::param::IntParam& int_param)
@@ -64,16 +60,12 @@ public:
         return obj;
     }
 
-    static std::unique_ptr<rpc::param::FloatParam>
-    translateToRpcFloatParam(const mavsdk::Param::FloatParam& float_param)
+    static void translateToRpcFloatParam(
+        const mavsdk::Param::FloatParam& float_param, rpc::param::FloatParam* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::param::FloatParam>();
-
         rpc_obj->set_name(float_param.name);
 
         rpc_obj->set_value(float_param.value);
-
-        return rpc_obj;
     }
 
     static mavsdk::Param::FloatParam
@@ -88,16 +80,12 @@ public:
         return obj;
     }
 
-    static std::unique_ptr<rpc::param::CustomParam>
-    translateToRpcCustomParam(const mavsdk::Param::CustomParam& custom_param)
+    static void translateToRpcCustomParam(
+        const mavsdk::Param::CustomParam& custom_param, rpc::param::CustomParam* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::param::CustomParam>();
-
         rpc_obj->set_name(custom_param.name);
 
         rpc_obj->set_value(custom_param.value);
-
-        return rpc_obj;
     }
 
     static mavsdk::Param::CustomParam
@@ -112,27 +100,20 @@ public:
         return obj;
     }
 
-    static std::unique_ptr<rpc::param::AllParams>
-    translateToRpcAllParams(const mavsdk::Param::AllParams& all_params)
+    static void translateToRpcAllParams(
+        const mavsdk::Param::AllParams& all_params, rpc::param::AllParams* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::param::AllParams>();
-
         for (const auto& elem : all_params.int_params) {
-            auto* ptr = rpc_obj->add_int_params();
-            ptr->CopyFrom(*translateToRpcIntParam(elem).release());
+            translateToRpcIntParam(elem, rpc_obj->add_int_params());
         }
 
         for (const auto& elem : all_params.float_params) {
-            auto* ptr = rpc_obj->add_float_params();
-            ptr->CopyFrom(*translateToRpcFloatParam(elem).release());
+            translateToRpcFloatParam(elem, rpc_obj->add_float_params());
         }
 
         for (const auto& elem : all_params.custom_params) {
-            auto* ptr = rpc_obj->add_custom_params();
-            ptr->CopyFrom(*translateToRpcCustomParam(elem).release());
+            translateToRpcCustomParam(elem, rpc_obj->add_custom_params());
         }
-
-        return rpc_obj;
     }
 
     static mavsdk::Param::AllParams
@@ -210,11 +191,13 @@ public:
     }
 
     grpc::Status GetParamInt(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::param::GetParamIntRequest* request,
         rpc::param::GetParamIntResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Param::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -228,7 +211,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->get_param_int(request->name());
+        auto result = plugin->get_param_int(request->name());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result.first);
@@ -240,11 +223,13 @@ public:
     }
 
     grpc::Status SetParamInt(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::param::SetParamIntRequest* request,
         rpc::param::SetParamIntResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Param::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -258,7 +243,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->set_param_int(request->name(), request->value());
+        auto result = plugin->set_param_int(request->name(), request->value());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -268,11 +253,13 @@ public:
     }
 
     grpc::Status GetParamFloat(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::param::GetParamFloatRequest* request,
         rpc::param::GetParamFloatResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Param::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -286,7 +273,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->get_param_float(request->name());
+        auto result = plugin->get_param_float(request->name());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result.first);
@@ -298,11 +285,13 @@ public:
     }
 
     grpc::Status SetParamFloat(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::param::SetParamFloatRequest* request,
         rpc::param::SetParamFloatResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Param::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -317,7 +306,7 @@ public:
         }
 
         auto result =
-            _lazy_plugin.maybe_plugin()->set_param_float(request->name(), request->value());
+            plugin->set_param_float(request->name(), request->value());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -327,11 +316,13 @@ public:
     }
 
     grpc::Status GetParamCustom(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::param::GetParamCustomRequest* request,
         rpc::param::GetParamCustomResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Param::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -345,7 +336,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->get_param_custom(request->name());
+        auto result = plugin->get_param_custom(request->name());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result.first);
@@ -357,11 +348,13 @@ public:
     }
 
     grpc::Status SetParamCustom(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::param::SetParamCustomRequest* request,
         rpc::param::SetParamCustomResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Param::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -376,7 +369,7 @@ public:
         }
 
         auto result =
-            _lazy_plugin.maybe_plugin()->set_param_custom(request->name(), request->value());
+            plugin->set_param_custom(request->name(), request->value());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -386,62 +379,33 @@ public:
     }
 
     grpc::Status GetAllParams(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::param::GetAllParamsRequest* /* request */,
         rpc::param::GetAllParamsResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->get_all_params();
+        auto result = plugin->get_all_params();
 
         if (response != nullptr) {
-            response->set_allocated_params(translateToRpcAllParams(result).release());
+            translateToRpcAllParams(result, response->mutable_params());
         }
 
         return grpc::Status::OK;
     }
 
-    void stop()
-    {
-        _stopped.store(true);
-        for (auto& prom : _stream_stop_promises) {
-            if (auto handle = prom.lock()) {
-                handle->set_value();
-            }
-        }
-    }
+    void stop() { _streams.finish_all(); }
 
-private:
-    void register_stream_stop_promise(std::weak_ptr<std::promise<void>> prom)
-    {
-        // If we have already stopped, set promise immediately and don't add it to list.
-        if (_stopped.load()) {
-            if (auto handle = prom.lock()) {
-                handle->set_value();
-            }
-        } else {
-            _stream_stop_promises.push_back(prom);
-        }
-    }
-
-    void unregister_stream_stop_promise(std::shared_ptr<std::promise<void>> prom)
-    {
-        for (auto it = _stream_stop_promises.begin(); it != _stream_stop_promises.end();
-             /* ++it */) {
-            if (it->lock() == prom) {
-                it = _stream_stop_promises.erase(it);
-            } else {
-                ++it;
-            }
-        }
-    }
+    const StreamStats& stream_stats() const { return _streams.stats(); }
 
+private:
     LazyPlugin& _lazy_plugin;
 
-    std::atomic<bool> _stopped{false};
-    std::vector<std::weak_ptr<std::promise<void>>> _stream_stop_promises{};
+    StreamList _streams{};
 };
 
 } // namespace mavsdk_server
@@ -10,6 +10,8 @@
 #include "lazy_server_plugin.h"
 
 #include "log.h"
+#include "stream_reactor.h"
+#include "system_selection.h"
 #include <atomic>
 #include <cmath>
 #include <future>
@@ -25,7 +27,8 @@ template<
     typename ParamServer = ParamServer,
     typename LazyServerPlugin = LazyServerPlugin<ParamServer>>
 
-class ParamServerServiceImpl final : public rpc::param_server::ParamServerService::Service {
+class ParamServerServiceImpl final
+    : public WithCallbackMethods<rpc::param_server::ParamServerService::Service> {
 public:
     ParamServerServiceImpl(LazyServerPlugin& lazy_plugin) : _lazy_plugin(lazy_plugin) {}
 
@@ -34,25 +37,19 @@ public:
     {
         auto rpc_result = translateToRpcResult(result);
 
-        auto* rpc_param_server_result = new rpc::param_server::ParamServerResult();
+        auto* rpc_param_server_result = response->mutable_param_server_result();
         rpc_param_server_result->set_result(rpc_result);
         std::stringstream ss;
         ss << result;
         rpc_param_server_result->set_result_str(ss.str());
-
-        response->set_allocated_param_server_result(rpc_param_server_result);
     }
 
-    static std::unique_ptr<rpc::param_server::IntParam>
-    translateToRpcIntParam(const mavsdk::ParamServer::IntParam& int_param)
+    static void translateToRpcIntParam(
+        const mavsdk::ParamServer::IntParam& int_param, rpc::param_server::IntParam* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::param_server::IntParam>();
-
         rpc_obj->set_name(int_param.name);
 
         rpc_obj->set_value(int_param.value);
-
-        return rpc_obj;
     }
 
     static mavsdk::ParamServer::IntParam
@@ -67,16 +64,12 @@ public:
         return obj;
     }
 
-    static std::unique_ptr<rpc::param_server::FloatParam>
-    translateToRpcFloatParam(const mavsdk::ParamServer::FloatParam& float_param)
+    static void translateToRpcFloatParam(
+        const mavsdk::ParamServer::FloatParam& float_param, rpc::param_server::FloatParam* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::param_server::FloatParam>();
-
         rpc_obj->set_name(float_param.name);
 
         rpc_obj->set_value(float_param.value);
-
-        return rpc_obj;
     }
 
     static mavsdk::ParamServer::FloatParam
@@ -91,16 +84,13 @@ public:
         return obj;
     }
 
-    static std::unique_ptr<rpc::param_server::CustomParam>
-    translateToRpcCustomParam(const mavsdk::ParamServer::CustomParam& custom_param)
+    static void translateToRpcCustomParam(
+        const mavsdk::ParamServer::CustomParam& custom_param,
+        rpc::param_server::CustomParam* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::param_server::CustomParam>();
-
         rpc_obj->set_name(custom_param.name);
 
         rpc_obj->set_value(custom_param.value);
-
-        return rpc_obj;
     }
 
     static mavsdk::ParamServer::CustomParam
@@ -115,27 +105,20 @@ public:
         return obj;
     }
 
-    static std::unique_ptr<rpc::param_server::AllParams>
-    translateToRpcAllParams(const mavsdk::ParamServer::AllParams& all_params)
+    static void translateToRpcAllParams(
+        const mavsdk::ParamServer::AllParams& all_params, rpc::param_server::AllParams* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::param_server::AllParams>();
-
         for (const auto& elem : all_params.int_params) {
-            auto* ptr = rpc_obj->add_int_params();
-            ptr->CopyFrom(*translateToRpcIntParam(elem).release());
+            translateToRpcIntParam(elem, rpc_obj->add_int_params());
         }
 
         for (const auto& elem : all_params.float_params) {
-            auto* ptr = rpc_obj->add_float_params();
-            ptr->CopyFrom(*translateToRpcFloatParam(elem).release());
+            translateToRpcFloatParam(elem, rpc_obj->add_float_params());
         }
 
         for (const auto& elem : all_params.custom_params) {
-            auto* ptr = rpc_obj->add_custom_params();
-            ptr->CopyFrom(*translateToRpcCustomParam(elem).release());
+            translateToRpcCustomParam(elem, rpc_obj->add_custom_params());
         }
-
-        return rpc_obj;
     }
 
     static mavsdk::ParamServer::AllParams
@@ -210,11 +193,13 @@ public:
     }
 
     grpc::Status RetrieveParamInt(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::param_server::RetrieveParamIntRequest* request,
         rpc::param_server::RetrieveParamIntResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 // For server plugins, this should never happen, they should always be
                 // constructible.
@@ -230,7 +215,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->retrieve_param_int(request->name());
+        auto result = plugin->retrieve_param_int(request->name());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result.first);
@@ -242,11 +227,13 @@ public:
     }
 
     grpc::Status ProvideParamInt(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::param_server::ProvideParamIntRequest* request,
         rpc::param_server::ProvideParamIntResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 // For server plugins, this should never happen, they should always be
                 // constructible.
@@ -263,7 +250,7 @@ public:
         }
 
         auto result =
-            _lazy_plugin.maybe_plugin()->provide_param_int(request->name(), request->value());
+            plugin->provide_param_int(request->name(), request->value());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -273,11 +260,13 @@ public:
     }
 
     grpc::Status RetrieveParamFloat(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::param_server::RetrieveParamFloatRequest* request,
         rpc::param_server::RetrieveParamFloatResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 // For server plugins, this should never happen, they should always be
                 // constructible.
@@ -293,7 +282,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->retrieve_param_float(request->name());
+        auto result = plugin->retrieve_param_float(request->name());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result.first);
@@ -305,11 +294,13 @@ public:
     }
 
     grpc::Status ProvideParamFloat(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::param_server::ProvideParamFloatRequest* request,
         rpc::param_server::ProvideParamFloatResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 // For server plugins, this should never happen, they should always be
                 // constructible.
@@ -326,7 +317,7 @@ public:
         }
 
         auto result =
-            _lazy_plugin.maybe_plugin()->provide_param_float(request->name(), request->value());
+            plugin->provide_param_float(request->name(), request->value());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -336,11 +327,13 @@ public:
     }
 
     grpc::Status RetrieveParamCustom(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::param_server::RetrieveParamCustomRequest* request,
         rpc::param_server::RetrieveParamCustomResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 // For server plugins, this should never happen, they should always be
                 // constructible.
@@ -356,7 +349,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->retrieve_param_custom(request->name());
+        auto result = plugin->retrieve_param_custom(request->name());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result.first);
@@ -368,11 +361,13 @@ public:
     }
 
     grpc::Status ProvideParamCustom(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::param_server::ProvideParamCustomRequest* request,
         rpc::param_server::ProvideParamCustomResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 // For server plugins, this should never happen, they should always be
                 // constructible.
@@ -389,7 +384,7 @@ public:
         }
 
         auto result =
-            _lazy_plugin.maybe_plugin()->provide_param_custom(request->name(), request->value());
+            plugin->provide_param_custom(request->name(), request->value());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -399,62 +394,33 @@ public:
     }
 
     grpc::Status RetrieveAllParams(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::param_server::RetrieveAllParamsRequest* /* request */,
         rpc::param_server::RetrieveAllParamsResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->retrieve_all_params();
+        auto result = plugin->retrieve_all_params();
 
         if (response != nullptr) {
-            response->set_allocated_params(translateToRpcAllParams(result).release());
+            translateToRpcAllParams(result, response->mutable_params());
         }
 
         return grpc::Status::OK;
     }
 
-    void stop()
-    {
-        _stopped.store(true);
-        for (auto& prom : _stream_stop_promises) {
-            if (auto handle = prom.lock()) {
-                handle->set_value();
-            }
-        }
-    }
+    void stop() { _streams.finish_all(); }
 
-private:
-    void register_stream_stop_promise(std::weak_ptr<std::promise<void>> prom)
-    {
-        // If we have already stopped, set promise immediately and don't add it to list.
-        if (_stopped.load()) {
-            if (auto handle = prom.lock()) {
-                handle->set_value();
-            }
-        } else {
-            _stream_stop_promises.push_back(prom);
-        }
-    }
-
-    void unregister_stream_stop_promise(std::shared_ptr<std::promise<void>> prom)
-    {
-        for (auto it = _stream_stop_promises.begin(); it != _stream_stop_promises.end();
-             /* ++it */) {
-            if (it->lock() == prom) {
-                it = _stream_stop_promises.erase(it);
-            } else {
-                ++it;
-            }
-        }
-    }
+    const StreamStats& stream_stats() const { return _streams.stats(); }
 
+private:
     LazyServerPlugin& _lazy_plugin;
 
-    std::atomic<bool> _stopped{false};
-    std::vector<std::weak_ptr<std::promise<void>>> _stream_stop_promises{};
+    StreamList _streams{};
 };
 
 } // namespace mavsdk_server
@@ -10,6 +10,8 @@
 #include "lazy_plugin.h"
 
 #include "log.h"
+#include "stream_reactor.h"
+#include "system_selection.h"
 #include <atomic>
 #include <cmath>
 #include <future>
@@ -23,7 +25,7 @@ namespace mavsdk_server {
 
 template<typename Rtk = Rtk, typename LazyPlugin = LazyPlugin<Rtk>>
 
-class RtkServiceImpl final : public rpc::rtk::RtkService::Service {
+class RtkServiceImpl final : public WithCallbackMethods<rpc::rtk::RtkService::Service> {
 public:
     RtkServiceImpl(LazyPlugin& lazy_plugin) : _lazy_plugin(lazy_plugin) {}
 
@@ -32,23 +34,17 @@ public:
     {
         auto rpc_result = translateToRpcResult(result);
 
-        auto* rpc_rtk_result = new rpc::rtk::RtkResult();
+        auto* rpc_rtk_result = response->mutable_rtk_result();
         rpc_rtk_result->set_result(rpc_result);
         std::stringstream ss;
         ss << result;
         rpc_rtk_result->set_result_str(ss.str());
-
-        response->set_allocated_rtk_result(rpc_rtk_result);
     }
 
-    static std::unique_ptr<rpc::rtk::RtcmData>
-    translateToRpcRtcmData(const mavsdk::Rtk::RtcmData& rtcm_data)
+    static void translateToRpcRtcmData(
+        const mavsdk::Rtk::RtcmData& rtcm_data, rpc::rtk::RtcmData* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::rtk::RtcmData>();
-
         rpc_obj->set_data(rtcm_data.data);
-
-        return rpc_obj;
     }
 
     static mavsdk::Rtk::RtcmData translateFromRpcRtcmData(const rpc::rtk::RtcmData& rtcm_data)
@@ -99,11 +95,13 @@ public:
     }
 
     grpc::Status SendRtcmData(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::rtk::SendRtcmDataRequest* request,
         rpc::rtk::SendRtcmDataResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Rtk::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -117,7 +115,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->send_rtcm_data(
+        auto result = plugin->send_rtcm_data(
             translateFromRpcRtcmData(request->rtcm_data()));
 
         if (response != nullptr) {
@@ -127,45 +125,14 @@ public:
         return grpc::Status::OK;
     }
 
-    void stop()
-    {
-        _stopped.store(true);
-        for (auto& prom : _stream_stop_promises) {
-            if (auto handle = prom.lock()) {
-                handle->set_value();
-            }
-        }
-    }
+    void stop() { _streams.finish_all(); }
 
-private:
-    void register_stream_stop_promise(std::weak_ptr<std::promise<void>> prom)
-    {
-        // If we have already stopped, set promise immediately and don't add it to list.
-        if (_stopped.load()) {
-            if (auto handle = prom.lock()) {
-                handle->set_value();
-            }
-        } else {
-            _stream_stop_promises.push_back(prom);
-        }
-    }
-
-    void unregister_stream_stop_promise(std::shared_ptr<std::promise<void>> prom)
-    {
-        for (auto it = _stream_stop_promises.begin(); it != _stream_stop_promises.end();
-             /* ++it */) {
-            if (it->lock() == prom) {
-                it = _stream_stop_promises.erase(it);
-            } else {
-                ++it;
-            }
-        }
-    }
+    const StreamStats& stream_stats() const { return _streams.stats(); }
 
+private:
     LazyPlugin& _lazy_plugin;
 
-    std::atomic<bool> _stopped{false};
-    std::vector<std::weak_ptr<std::promise<void>>> _stream_stop_promises{};
+    StreamList _streams{};
 };
 
 } // namespace mavsdk_server
@@ -11,6 +11,8 @@
 #include "lazy_plugin.h"
 
 #include "log.h"
+#include "stream_reactor.h"
+#include "system_selection.h"
 #include <atomic>
 #include <cmath>
 #include <future>
@@ -24,7 +26,8 @@ namespace mavsdk_server {
 
 template<typename ServerUtility = ServerUtility, typename LazyPlugin = LazyPlugin<ServerUtility>>
 
-class ServerUtilityServiceImpl final : public rpc::server_utility::ServerUtilityService::Service {
+class ServerUtilityServiceImpl final
+    : public WithCallbackMethods<rpc::server_utility::ServerUtilityService::Service> {
 public:
     ServerUtilityServiceImpl(LazyPlugin& lazy_plugin) : _lazy_plugin(lazy_plugin) {}
 
@@ -33,13 +36,11 @@ public:
     {
         auto rpc_result = translateToRpcResult(result);
 
-        auto* rpc_server_utility_result = new rpc::server_utility::ServerUtilityResult();
+        auto* rpc_server_utility_result = response->mutable_server_utility_result();
         rpc_server_utility_result->set_result(rpc_result);
         std::stringstream ss;
         ss << result;
         rpc_server_utility_result->set_result_str(ss.str());
-
-        response->set_allocated_server_utility_result(rpc_server_utility_result);
     }
 
     static rpc::server_utility::StatusTextType
@@ -137,11 +138,13 @@ public:
     }
 
     grpc::Status SendStatusText(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::server_utility::SendStatusTextRequest* request,
         rpc::server_utility::SendStatusTextResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::ServerUtility::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -155,7 +158,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->send_status_text(
+        auto result = plugin->send_status_text(
             translateFromRpcStatusTextType(request->type()), request->text());
 
         if (response != nullptr) {
@@ -165,45 +168,14 @@ public:
         return grpc::Status::OK;
     }
 
-    void stop()
-    {
-        _stopped.store(true);
-        for (auto& prom : _stream_stop_promises) {
-            if (auto handle = prom.lock()) {
-                handle->set_value();
-            }
-        }
-    }
+    void stop() { _streams.finish_all(); }
 
-private:
-    void register_stream_stop_promise(std::weak_ptr<std::promise<void>> prom)
-    {
-        // If we have already stopped, set promise immediately and don't add it to list.
-        if (_stopped.load()) {
-            if (auto handle = prom.lock()) {
-                handle->set_value();
-            }
-        } else {
-            _stream_stop_promises.push_back(prom);
-        }
-    }
-
-    void unregister_stream_stop_promise(std::shared_ptr<std::promise<void>> prom)
-    {
-        for (auto it = _stream_stop_promises.begin(); it != _stream_stop_promises.end();
-             /* ++it */) {
-            if (it->lock() == prom) {
-                it = _stream_stop_promises.erase(it);
-            } else {
-                ++it;
-            }
-        }
-    }
+    const StreamStats& stream_stats() const { return _streams.stats(); }
 
+private:
     LazyPlugin& _lazy_plugin;
 
-    std::atomic<bool> _stopped{false};
-    std::vector<std::weak_ptr<std::promise<void>>> _stream_stop_promises{};
+    StreamList _streams{};
 };
 
 } // namespace mavsdk_server
@@ -10,6 +10,8 @@
 #include "lazy_plugin.h"
 
 #include "log.h"
+#include "stream_reactor.h"
+#include "system_selection.h"
 #include <atomic>
 #include <cmath>
 #include <future>
@@ -23,7 +25,10 @@ namespace mavsdk_server {
 
 template<typename Shell = Shell, typename LazyPlugin = LazyPlugin<Shell>>
 
-class ShellServiceImpl final : public rpc::shell::ShellService::Service {
+class ShellServiceImpl final
+    : public WithCallbackMethods<
+          rpc::shell::ShellService::Service,
+          rpc::shell::ShellService::WithCallbackMethod_SubscribeReceive> {
 public:
     ShellServiceImpl(LazyPlugin& lazy_plugin) : _lazy_plugin(lazy_plugin) {}
 
@@ -32,13 +37,11 @@ public:
     {
         auto rpc_result = translateToRpcResult(result);
 
-        auto* rpc_shell_result = new rpc::shell::ShellResult();
+        auto* rpc_shell_result = response->mutable_shell_result();
         rpc_shell_result->set_result(rpc_result);
         std::stringstream ss;
         ss << result;
         rpc_shell_result->set_result_str(ss.str());
-
-        response->set_allocated_shell_result(rpc_shell_result);
     }
 
     static rpc::shell::ShellResult::Result translateToRpcResult(const mavsdk::Shell::Result& result)
@@ -85,11 +88,13 @@ public:
     }
 
     grpc::Status Send(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::shell::SendRequest* request,
         rpc::shell::SendResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Shell::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -103,7 +108,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->send(request->command());
+        auto result = plugin->send(request->command());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -112,85 +117,43 @@ public:
         return grpc::Status::OK;
     }
 
-    grpc::Status SubscribeReceive(
-        grpc::ServerContext* /* context */,
-        const mavsdk::rpc::shell::SubscribeReceiveRequest* /* request */,
-        grpc::ServerWriter<rpc::shell::ReceiveResponse>* writer) override
+    grpc::ServerWriteReactor<rpc::shell::ReceiveResponse>* SubscribeReceive(
+        grpc::CallbackServerContext* context,
+        const mavsdk::rpc::shell::SubscribeReceiveRequest* /* request */) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
-            return grpc::Status::OK;
-        }
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        auto reactor = StreamReactor<rpc::shell::ReceiveResponse>::create();
 
-        auto stream_closed_promise = std::make_shared<std::promise<void>>();
-        auto stream_closed_future = stream_closed_promise->get_future();
-        register_stream_stop_promise(stream_closed_promise);
+        if (plugin == nullptr) {
+            reactor->finish();
+            return reactor.get();
+        }
 
-        auto is_finished = std::make_shared<bool>(false);
-        auto subscribe_mutex = std::make_shared<std::mutex>();
+        _streams.add(reactor);
 
-        const mavsdk::Shell::ReceiveHandle handle = _lazy_plugin.maybe_plugin()->subscribe_receive(
-            [this, &writer, &stream_closed_promise, is_finished, subscribe_mutex, &handle](
-                const std::string receive) {
+        const mavsdk::Shell::ReceiveHandle handle = plugin->subscribe_receive(
+            [reactor](const std::string receive) {
                 rpc::shell::ReceiveResponse rpc_response;
 
                 rpc_response.set_data(receive);
 
-                std::unique_lock<std::mutex> lock(*subscribe_mutex);
-                if (!*is_finished && !writer->Write(rpc_response)) {
-                    _lazy_plugin.maybe_plugin()->unsubscribe_receive(handle);
-
-                    *is_finished = true;
-                    unregister_stream_stop_promise(stream_closed_promise);
-                    stream_closed_promise->set_value();
-                }
+                reactor->write(std::move(rpc_response));
             });
 
-        stream_closed_future.wait();
-        std::unique_lock<std::mutex> lock(*subscribe_mutex);
-        *is_finished = true;
+        reactor->set_on_done([plugin, handle]() { plugin->unsubscribe_receive(handle); });
 
-        return grpc::Status::OK;
+        return reactor.get();
     }
 
-    void stop()
-    {
-        _stopped.store(true);
-        for (auto& prom : _stream_stop_promises) {
-            if (auto handle = prom.lock()) {
-                handle->set_value();
-            }
-        }
-    }
+    void stop() { _streams.finish_all(); }
 
-private:
-    void register_stream_stop_promise(std::weak_ptr<std::promise<void>> prom)
-    {
-        // If we have already stopped, set promise immediately and don't add it to list.
-        if (_stopped.load()) {
-            if (auto handle = prom.lock()) {
-                handle->set_value();
-            }
-        } else {
-            _stream_stop_promises.push_back(prom);
-        }
-    }
-
-    void unregister_stream_stop_promise(std::shared_ptr<std::promise<void>> prom)
-    {
-        for (auto it = _stream_stop_promises.begin(); it != _stream_stop_promises.end();
-             /* ++it */) {
-            if (it->lock() == prom) {
-                it = _stream_stop_promises.erase(it);
-            } else {
-                ++it;
-            }
-        }
-    }
+    const StreamStats& stream_stats() const { return _streams.stats(); }
 
+private:
     LazyPlugin& _lazy_plugin;
 
-    std::atomic<bool> _stopped{false};
-    std::vector<std::weak_ptr<std::promise<void>>> _stream_stop_promises{};
+    StreamList _streams{};
 };
 
 } // namespace mavsdk_server
@@ -0,0 +1,208 @@
+#pragma once
+
+#include "plugins/telemetry/telemetry.h"
+
+#include <chrono>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace mavsdk {
+namespace mavsdk_server {
+
+// Combines several telemetry subscriptions into one stream of frames, so that
+// a client following a handful of fields needs a single stream instead of one
+// per field.
+//
+// Each field is taken at most at its own max rate. The fields taken are
+// collected and sent together in a frame, at most at the highest rate of the
+// selection, so that fields updated at about the same time end up in the same
+// frame. A frame only contains the fields updated since the previous one.
+//
+// Frames are sent from the thread of the telemetry callbacks, the callback
+// should not block.
+template<typename Telemetry = Telemetry> class TelemetryBundle {
+public:
+    enum class Field {
+        Position,
+        VelocityNed,
+        AttitudeQuaternion,
+        AttitudeEuler,
+        Battery,
+        Health,
+        FlightMode,
+    };
+
+    // The max rate in Hz of each field to include, 0 to take every update.
+    using Selection = std::map<Field, double>;
+
+    struct Frame {
+        std::optional<mavsdk::Telemetry::Position> position{};
+        std::optional<mavsdk::Telemetry::VelocityNed> velocity_ned{};
+        std::optional<mavsdk::Telemetry::Quaternion> attitude_quaternion{};
+        std::optional<mavsdk::Telemetry::EulerAngle> attitude_euler{};
+        std::optional<mavsdk::Telemetry::Battery> battery{};
+        std::optional<mavsdk::Telemetry::Health> health{};
+        std::optional<mavsdk::Telemetry::FlightMode> flight_mode{};
+    };
+
+    using FrameCallback = std::function<void(const Frame&)>;
+
+    TelemetryBundle(Telemetry& telemetry, const Selection& selection, FrameCallback callback) :
+        _telemetry(telemetry),
+        _callback(std::move(callback))
+    {
+        for (const auto& [field, max_rate_hz] : selection) {
+            const auto interval = interval_for(max_rate_hz);
+            _fields[field] = FieldState{interval, {}};
+            if (_fields.size() == 1 || interval < _frame_interval) {
+                _frame_interval = interval;
+            }
+        }
+
+        for (const auto& [field, max_rate_hz] : selection) {
+            subscribe(field);
+        }
+    }
+
+    ~TelemetryBundle()
+    {
+        for (auto& unsubscribe : _unsubscribes) {
+            unsubscribe();
+        }
+    }
+
+    // Non-copyable
+    TelemetryBundle(const TelemetryBundle&) = delete;
+    const TelemetryBundle& operator=(const TelemetryBundle&) = delete;
+
+private:
+    using Clock = std::chrono::steady_clock;
+    using Interval = std::chrono::duration<double>;
+
+    struct FieldState {
+        Interval interval;
+        std::optional<Clock::time_point> last_taken;
+    };
+
+    static Interval interval_for(double max_rate_hz)
+    {
+        return max_rate_hz > 0.0 ? Interval(1.0 / max_rate_hz) : Interval(0.0);
+    }
+
+    void subscribe(Field field)
+    {
+        switch (field) {
+            case Field::Position: {
+                const auto handle =
+                    _telemetry.subscribe_position([this](mavsdk::Telemetry::Position position) {
+                        update(Field::Position, &Frame::position, std::move(position));
+                    });
+                _unsubscribes.emplace_back(
+                    [this, handle]() { _telemetry.unsubscribe_position(handle); });
+                break;
+            }
+            case Field::VelocityNed: {
+                const auto handle = _telemetry.subscribe_velocity_ned(
+                    [this](mavsdk::Telemetry::VelocityNed velocity_ned) {
+                        update(Field::VelocityNed, &Frame::velocity_ned, std::move(velocity_ned));
+                    });
+                _unsubscribes.emplace_back(
+                    [this, handle]() { _telemetry.unsubscribe_velocity_ned(handle); });
+                break;
+            }
+            case Field::AttitudeQuaternion: {
+                const auto handle = _telemetry.subscribe_attitude_quaternion(
+                    [this](mavsdk::Telemetry::Quaternion quaternion) {
+                        update(
+                            Field::AttitudeQuaternion,
+                            &Frame::attitude_quaternion,
+                            std::move(quaternion));
+                    });
+                _unsubscribes.emplace_back(
+                    [this, handle]() { _telemetry.unsubscribe_attitude_quaternion(handle); });
+                break;
+            }
+            case Field::AttitudeEuler: {
+                const auto handle = _telemetry.subscribe_attitude_euler(
+                    [this](mavsdk::Telemetry::EulerAngle euler_angle) {
+                        update(
+                            Field::AttitudeEuler, &Frame::attitude_euler, std::move(euler_angle));
+                    });
+                _unsubscribes.emplace_back(
+                    [this, handle]() { _telemetry.unsubscribe_attitude_euler(handle); });
+                break;
+            }
+            case Field::Battery: {
+                const auto handle =
+                    _telemetry.subscribe_battery([this](mavsdk::Telemetry::Battery battery) {
+                        update(Field::Battery, &Frame::battery, std::move(battery));
+                    });
+                _unsubscribes.emplace_back(
+                    [this, handle]() { _telemetry.unsubscribe_battery(handle); });
+                break;
+            }
+            case Field::Health: {
+                const auto handle =
+                    _telemetry.subscribe_health([this](mavsdk::Telemetry::Health health) {
+                        update(Field::Health, &Frame::health, std::move(health));
+                    });
+                _unsubscribes.emplace_back(
+                    [this, handle]() { _telemetry.unsubscribe_health(handle); });
+                break;
+            }
+            case Field::FlightMode: {
+                const auto handle = _telemetry.subscribe_flight_mode(
+                    [this](mavsdk::Telemetry::FlightMode flight_mode) {
+                        update(Field::FlightMode, &Frame::flight_mode, flight_mode);
+                    });
+                _unsubscribes.emplace_back(
+                    [this, handle]() { _telemetry.unsubscribe_flight_mode(handle); });
+                break;
+            }
+        }
+    }
+
+    template<typename Value>
+    void update(Field field, std::optional<Value> Frame::*member, Value value)
+    {
+        Frame frame;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            const auto now = Clock::now();
+
+            auto& state = _fields[field];
+            if (state.last_taken && now - *state.last_taken < state.interval) {
+                return;
+            }
+            state.last_taken = now;
+            _pending.*member = std::move(value);
+
+            // The fields taken meanwhile go out with the next update.
+            if (_last_frame && now - *_last_frame < _frame_interval) {
+                return;
+            }
+            _last_frame = now;
+            std::swap(frame, _pending);
+        }
+        _callback(frame);
+    }
+
+    Telemetry& _telemetry;
+    const FrameCallback _callback;
+
+    std::mutex _mutex{};
+    // Needs _mutex
+    std::map<Field, FieldState> _fields{};
+    Interval _frame_interval{0.0};
+    Frame _pending{};
+    std::optional<Clock::time_point> _last_frame{};
+
+    std::vector<std::function<void()>> _unsubscribes{};
+};
+
+} // namespace mavsdk_server
+} // namespace mavsdk
@@ -10,6 +10,8 @@
 #include "lazy_plugin.h"
 
 #include "log.h"
+#include "stream_reactor.h"
+#include "system_selection.h"
 #include <atomic>
 #include <cmath>
 #include <future>
@@ -23,7 +25,43 @@ namespace mavsdk_server {
 
 template<typename Telemetry = Telemetry, typename LazyPlugin = LazyPlugin<Telemetry>>
 
-class TelemetryServiceImpl final : public rpc::telemetry::TelemetryService::Service {
+class TelemetryServiceImpl final
+    : public WithCallbackMethods<
+          rpc::telemetry::TelemetryService::Service,
+          rpc::telemetry::TelemetryService::WithCallbackMethod_SubscribePosition,
+          rpc::telemetry::TelemetryService::WithCallbackMethod_SubscribeHome,
+          rpc::telemetry::TelemetryService::WithCallbackMethod_SubscribeInAir,
+          rpc::telemetry::TelemetryService::WithCallbackMethod_SubscribeLandedState,
+          rpc::telemetry::TelemetryService::WithCallbackMethod_SubscribeArmed,
+          rpc::telemetry::TelemetryService::WithCallbackMethod_SubscribeVtolState,
+          rpc::telemetry::TelemetryService::WithCallbackMethod_SubscribeAttitudeQuaternion,
+          rpc::telemetry::TelemetryService::WithCallbackMethod_SubscribeAttitudeEuler,
+          rpc::telemetry::TelemetryService::WithCallbackMethod_SubscribeAttitudeAngularVelocityBody,
+          rpc::telemetry::TelemetryService::WithCallbackMethod_SubscribeCameraAttitudeQuaternion,
+          rpc::telemetry::TelemetryService::WithCallbackMethod_SubscribeCameraAttitudeEuler,
+          rpc::telemetry::TelemetryService::WithCallbackMethod_SubscribeVelocityNed,
+          rpc::telemetry::TelemetryService::WithCallbackMethod_SubscribeGpsInfo,
+          rpc::telemetry::TelemetryService::WithCallbackMethod_SubscribeRawGps,
+          rpc::telemetry::TelemetryService::WithCallbackMethod_SubscribeBattery,
+          rpc::telemetry::TelemetryService::WithCallbackMethod_SubscribeFlightMode,
+          rpc::telemetry::TelemetryService::WithCallbackMethod_SubscribeHealth,
+          rpc::telemetry::TelemetryService::WithCallbackMethod_SubscribeRcStatus,
+          rpc::telemetry::TelemetryService::WithCallbackMethod_SubscribeStatusText,
+          rpc::telemetry::TelemetryService::WithCallbackMethod_SubscribeActuatorControlTarget,
+          rpc::telemetry::TelemetryService::WithCallbackMethod_SubscribeActuatorOutputStatus,
+          rpc::telemetry::TelemetryService::WithCallbackMethod_SubscribeOdometry,
+          rpc::telemetry::TelemetryService::WithCallbackMethod_SubscribePositionVelocityNed,
+          rpc::telemetry::TelemetryService::WithCallbackMethod_SubscribeGroundTruth,
+          rpc::telemetry::TelemetryService::WithCallbackMethod_SubscribeFixedwingMetrics,
+          rpc::telemetry::TelemetryService::WithCallbackMethod_SubscribeImu,
+          rpc::telemetry::TelemetryService::WithCallbackMethod_SubscribeScaledImu,
+          rpc::telemetry::TelemetryService::WithCallbackMethod_SubscribeRawImu,
+          rpc::telemetry::TelemetryService::WithCallbackMethod_SubscribeHealthAllOk,
+          rpc::telemetry::TelemetryService::WithCallbackMethod_SubscribeUnixEpochTime,
+          rpc::telemetry::TelemetryService::WithCallbackMethod_SubscribeDistanceSensor,
+          rpc::telemetry::TelemetryService::WithCallbackMethod_SubscribeScaledPressure,
+          rpc::telemetry::TelemetryService::WithCallbackMethod_SubscribeHeading,
+          rpc::telemetry::TelemetryService::WithCallbackMethod_SubscribeAltitude> {
 public:
     TelemetryServiceImpl(LazyPlugin& lazy_plugin) : _lazy_plugin(lazy_plugin) {}
 
@@ -32,13 +70,11 @@ public:
     {
         auto rpc_result = translateToRpcResult(result);
 
-        auto* rpc_telemetry_result = new rpc::telemetry::TelemetryResult();
+        auto* rpc_telemetry_result = response->mutable_telemetry_result();
         rpc_telemetry_result->set_result(rpc_result);
         std::stringstream ss;
         ss << result;
         rpc_telemetry_result->set_result_str(ss.str());
-
-        response->set_allocated_telemetry_result(rpc_telemetry_result);
     }
 
     static rpc::telemetry::FixType translateToRpcFixType(const mavsdk::Telemetry::FixType& fix_type)
@@ -302,11 +338,9 @@ public:
         }
     }
 
-    static std::unique_ptr<rpc::telemetry::Position>
-    translateToRpcPosition(const mavsdk::Telemetry::Position& position)
+    static void translateToRpcPosition(
+        const mavsdk::Telemetry::Position& position, rpc::telemetry::Position* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::telemetry::Position>();
-
         rpc_obj->set_latitude_deg(position.latitude_deg);
 
         rpc_obj->set_longitude_deg(position.longitude_deg);
@@ -314,8 +348,6 @@ public:
         rpc_obj->set_absolute_altitude_m(position.absolute_altitude_m);
 
         rpc_obj->set_relative_altitude_m(position.relative_altitude_m);
-
-        return rpc_obj;
     }
 
     static mavsdk::Telemetry::Position
@@ -334,14 +366,10 @@ public:
         return obj;
     }
 
-    static std::unique_ptr<rpc::telemetry::Heading>
-    translateToRpcHeading(const mavsdk::Telemetry::Heading& heading)
+    static void translateToRpcHeading(
+        const mavsdk::Telemetry::Heading& heading, rpc::telemetry::Heading* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::telemetry::Heading>();
-
         rpc_obj->set_heading_deg(heading.heading_deg);
-
-        return rpc_obj;
     }
 
     static mavsdk::Telemetry::Heading
@@ -354,11 +382,9 @@ public:
         return obj;
     }
 
-    static std::unique_ptr<rpc::telemetry::Quaternion>
-    translateToRpcQuaternion(const mavsdk::Telemetry::Quaternion& quaternion)
+    static void translateToRpcQuaternion(
+        const mavsdk::Telemetry::Quaternion& quaternion, rpc::telemetry::Quaternion* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::telemetry::Quaternion>();
-
         rpc_obj->set_w(quaternion.w);
 
         rpc_obj->set_x(quaternion.x);
@@ -368,8 +394,6 @@ public:
         rpc_obj->set_z(quaternion.z);
 
         rpc_obj->set_timestamp_us(quaternion.timestamp_us);
-
-        return rpc_obj;
     }
 
     static mavsdk::Telemetry::Quaternion
@@ -390,11 +414,9 @@ public:
         return obj;
     }
 
-    static std::unique_ptr<rpc::telemetry::EulerAngle>
-    translateToRpcEulerAngle(const mavsdk::Telemetry::EulerAngle& euler_angle)
+    static void translateToRpcEulerAngle(
+        const mavsdk::Telemetry::EulerAngle& euler_angle, rpc::telemetry::EulerAngle* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::telemetry::EulerAngle>();
-
         rpc_obj->set_roll_deg(euler_angle.roll_deg);
 
         rpc_obj->set_pitch_deg(euler_angle.pitch_deg);
@@ -402,8 +424,6 @@ public:
         rpc_obj->set_yaw_deg(euler_angle.yaw_deg);
 
         rpc_obj->set_timestamp_us(euler_angle.timestamp_us);
-
-        return rpc_obj;
     }
 
     static mavsdk::Telemetry::EulerAngle
@@ -422,18 +442,15 @@ public:
         return obj;
     }
 
-    static std::unique_ptr<rpc::telemetry::AngularVelocityBody> translateToRpcAngularVelocityBody(
-        const mavsdk::Telemetry::AngularVelocityBody& angular_velocity_body)
+    static void translateToRpcAngularVelocityBody(
+        const mavsdk::Telemetry::AngularVelocityBody& angular_velocity_body,
+        rpc::telemetry::AngularVelocityBody* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::telemetry::AngularVelocityBody>();
-
         rpc_obj->set_roll_rad_s(angular_velocity_body.roll_rad_s);
 
         rpc_obj->set_pitch_rad_s(angular_velocity_body.pitch_rad_s);
 
         rpc_obj->set_yaw_rad_s(angular_velocity_body.yaw_rad_s);
-
-        return rpc_obj;
     }
 
     static mavsdk::Telemetry::AngularVelocityBody translateFromRpcAngularVelocityBody(
@@ -450,16 +467,12 @@ public:
         return obj;
     }
 
-    static std::unique_ptr<rpc::telemetry::GpsInfo>
-    translateToRpcGpsInfo(const mavsdk::Telemetry::GpsInfo& gps_info)
+    static void translateToRpcGpsInfo(
+        const mavsdk::Telemetry::GpsInfo& gps_info, rpc::telemetry::GpsInfo* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::telemetry::GpsInfo>();
-
         rpc_obj->set_num_satellites(gps_info.num_satellites);
 
         rpc_obj->set_fix_type(translateToRpcFixType(gps_info.fix_type));
-
-        return rpc_obj;
     }
 
     static mavsdk::Telemetry::GpsInfo
@@ -474,11 +487,9 @@ public:
         return obj;
     }
 
-    static std::unique_ptr<rpc::telemetry::RawGps>
-    translateToRpcRawGps(const mavsdk::Telemetry::RawGps& raw_gps)
+    static void translateToRpcRawGps(
+        const mavsdk::Telemetry::RawGps& raw_gps, rpc::telemetry::RawGps* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::telemetry::RawGps>();
-
         rpc_obj->set_timestamp_us(raw_gps.timestamp_us);
 
         rpc_obj->set_latitude_deg(raw_gps.latitude_deg);
@@ -506,8 +517,6 @@ public:
         rpc_obj->set_heading_uncertainty_deg(raw_gps.heading_uncertainty_deg);
 
         rpc_obj->set_yaw_deg(raw_gps.yaw_deg);
-
-        return rpc_obj;
     }
 
     static mavsdk::Telemetry::RawGps translateFromRpcRawGps(const rpc::telemetry::RawGps& raw_gps)
@@ -545,11 +554,9 @@ public:
         return obj;
     }
 
-    static std::unique_ptr<rpc::telemetry::Battery>
-    translateToRpcBattery(const mavsdk::Telemetry::Battery& battery)
+    static void translateToRpcBattery(
+        const mavsdk::Telemetry::Battery& battery, rpc::telemetry::Battery* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::telemetry::Battery>();
-
         rpc_obj->set_id(battery.id);
 
         rpc_obj->set_temperature_degc(battery.temperature_degc);
@@ -561,8 +568,6 @@ public:
         rpc_obj->set_capacity_consumed_ah(battery.capacity_consumed_ah);
 
         rpc_obj->set_remaining_percent(battery.remaining_percent);
-
-        return rpc_obj;
     }
 
     static mavsdk::Telemetry::Battery
@@ -585,11 +590,9 @@ public:
         return obj;
     }
 
-    static std::unique_ptr<rpc::telemetry::Health>
-    translateToRpcHealth(const mavsdk::Telemetry::Health& health)
+    static void translateToRpcHealth(
+        const mavsdk::Telemetry::Health& health, rpc::telemetry::Health* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::telemetry::Health>();
-
         rpc_obj->set_is_gyrometer_calibration_ok(health.is_gyrometer_calibration_ok);
 
         rpc_obj->set_is_accelerometer_calibration_ok(health.is_accelerometer_calibration_ok);
@@ -603,8 +606,6 @@ public:
         rpc_obj->set_is_home_position_ok(health.is_home_position_ok);
 
         rpc_obj->set_is_armable(health.is_armable);
-
-        return rpc_obj;
     }
 
     static mavsdk::Telemetry::Health translateFromRpcHealth(const rpc::telemetry::Health& health)
@@ -628,18 +629,14 @@ public:
         return obj;
     }
 
-    static std::unique_ptr<rpc::telemetry::RcStatus>
-    translateToRpcRcStatus(const mavsdk::Telemetry::RcStatus& rc_status)
+    static void translateToRpcRcStatus(
+        const mavsdk::Telemetry::RcStatus& rc_status, rpc::telemetry::RcStatus* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::telemetry::RcStatus>();
-
         rpc_obj->set_was_available_once(rc_status.was_available_once);
 
         rpc_obj->set_is_available(rc_status.is_available);
 
         rpc_obj->set_signal_strength_percent(rc_status.signal_strength_percent);
-
-        return rpc_obj;
     }
 
     static mavsdk::Telemetry::RcStatus
@@ -656,16 +653,12 @@ public:
         return obj;
     }
 
-    static std::unique_ptr<rpc::telemetry::StatusText>
-    translateToRpcStatusText(const mavsdk::Telemetry::StatusText& status_text)
+    static void translateToRpcStatusText(
+        const mavsdk::Telemetry::StatusText& status_text, rpc::telemetry::StatusText* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::telemetry::StatusText>();
-
         rpc_obj->set_type(translateToRpcStatusTextType(status_text.type));
 
         rpc_obj->set_text(status_text.text);
-
-        return rpc_obj;
     }
 
     static mavsdk::Telemetry::StatusText
@@ -680,19 +673,15 @@ public:
         return obj;
     }
 
-    static std::unique_ptr<rpc::telemetry::ActuatorControlTarget>
-    translateToRpcActuatorControlTarget(
-        const mavsdk::Telemetry::ActuatorControlTarget& actuator_control_target)
+    static void translateToRpcActuatorControlTarget(
+        const mavsdk::Telemetry::ActuatorControlTarget& actuator_control_target,
+        rpc::telemetry::ActuatorControlTarget* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::telemetry::ActuatorControlTarget>();
-
         rpc_obj->set_group(actuator_control_target.group);
 
         for (const auto& elem : actuator_control_target.controls) {
             rpc_obj->add_controls(elem);
         }
-
-        return rpc_obj;
     }
 
     static mavsdk::Telemetry::ActuatorControlTarget translateFromRpcActuatorControlTarget(
@@ -709,18 +698,15 @@ public:
         return obj;
     }
 
-    static std::unique_ptr<rpc::telemetry::ActuatorOutputStatus> translateToRpcActuatorOutputStatus(
-        const mavsdk::Telemetry::ActuatorOutputStatus& actuator_output_status)
+    static void translateToRpcActuatorOutputStatus(
+        const mavsdk::Telemetry::ActuatorOutputStatus& actuator_output_status,
+        rpc::telemetry::ActuatorOutputStatus* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::telemetry::ActuatorOutputStatus>();
-
         rpc_obj->set_active(actuator_output_status.active);
 
         for (const auto& elem : actuator_output_status.actuator) {
             rpc_obj->add_actuator(elem);
         }
-
-        return rpc_obj;
     }
 
     static mavsdk::Telemetry::ActuatorOutputStatus translateFromRpcActuatorOutputStatus(
@@ -737,16 +723,12 @@ public:
         return obj;
     }
 
-    static std::unique_ptr<rpc::telemetry::Covariance>
-    translateToRpcCovariance(const mavsdk::Telemetry::Covariance& covariance)
+    static void translateToRpcCovariance(
+        const mavsdk::Telemetry::Covariance& covariance, rpc::telemetry::Covariance* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::telemetry::Covariance>();
-
         for (const auto& elem : covariance.covariance_matrix) {
             rpc_obj->add_covariance_matrix(elem);
         }
-
-        return rpc_obj;
     }
 
     static mavsdk::Telemetry::Covariance
@@ -761,18 +743,14 @@ public:
         return obj;
     }
 
-    static std::unique_ptr<rpc::telemetry::VelocityBody>
-    translateToRpcVelocityBody(const mavsdk::Telemetry::VelocityBody& velocity_body)
+    static void translateToRpcVelocityBody(
+        const mavsdk::Telemetry::VelocityBody& velocity_body, rpc::telemetry::VelocityBody* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::telemetry::VelocityBody>();
-
         rpc_obj->set_x_m_s(velocity_body.x_m_s);
 
         rpc_obj->set_y_m_s(velocity_body.y_m_s);
 
         rpc_obj->set_z_m_s(velocity_body.z_m_s);
-
-        return rpc_obj;
     }
 
     static mavsdk::Telemetry::VelocityBody
@@ -789,18 +767,14 @@ public:
         return obj;
     }
 
-    static std::unique_ptr<rpc::telemetry::PositionBody>
-    translateToRpcPositionBody(const mavsdk::Telemetry::PositionBody& position_body)
+    static void translateToRpcPositionBody(
+        const mavsdk::Telemetry::PositionBody& position_body, rpc::telemetry::PositionBody* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::telemetry::PositionBody>();
-
         rpc_obj->set_x_m(position_body.x_m);
 
         rpc_obj->set_y_m(position_body.y_m);
 
         rpc_obj->set_z_m(position_body.z_m);
-
-        return rpc_obj;
     }
 
     static mavsdk::Telemetry::PositionBody
@@ -853,35 +827,28 @@ public:
         }
     }
 
-    static std::unique_ptr<rpc::telemetry::Odometry>
-    translateToRpcOdometry(const mavsdk::Telemetry::Odometry& odometry)
+    static void translateToRpcOdometry(
+        const mavsdk::Telemetry::Odometry& odometry, rpc::telemetry::Odometry* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::telemetry::Odometry>();
-
         rpc_obj->set_time_usec(odometry.time_usec);
 
         rpc_obj->set_frame_id(translateToRpcMavFrame(odometry.frame_id));
 
         rpc_obj->set_child_frame_id(translateToRpcMavFrame(odometry.child_frame_id));
 
-        rpc_obj->set_allocated_position_body(
-            translateToRpcPositionBody(odometry.position_body).release());
-
-        rpc_obj->set_allocated_q(translateToRpcQuaternion(odometry.q).release());
+        translateToRpcPositionBody(odometry.position_body, rpc_obj->mutable_position_body());
 
-        rpc_obj->set_allocated_velocity_body(
-            translateToRpcVelocityBody(odometry.velocity_body).release());
+        translateToRpcQuaternion(odometry.q, rpc_obj->mutable_q());
 
-        rpc_obj->set_allocated_angular_velocity_body(
-            translateToRpcAngularVelocityBody(odometry.angular_velocity_body).release());
+        translateToRpcVelocityBody(odometry.velocity_body, rpc_obj->mutable_velocity_body());
 
-        rpc_obj->set_allocated_pose_covariance(
-            translateToRpcCovariance(odometry.pose_covariance).release());
+        translateToRpcAngularVelocityBody(
+            odometry.angular_velocity_body, rpc_obj->mutable_angular_velocity_body());
 
-        rpc_obj->set_allocated_velocity_covariance(
-            translateToRpcCovariance(odometry.velocity_covariance).release());
+        translateToRpcCovariance(odometry.pose_covariance, rpc_obj->mutable_pose_covariance());
 
-        return rpc_obj;
+        translateToRpcCovariance(
+            odometry.velocity_covariance, rpc_obj->mutable_velocity_covariance());
     }
 
     static mavsdk::Telemetry::Odometry
@@ -911,18 +878,15 @@ public:
         return obj;
     }
 
-    static std::unique_ptr<rpc::telemetry::DistanceSensor>
-    translateToRpcDistanceSensor(const mavsdk::Telemetry::DistanceSensor& distance_sensor)
+    static void translateToRpcDistanceSensor(
+        const mavsdk::Telemetry::DistanceSensor& distance_sensor,
+        rpc::telemetry::DistanceSensor* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::telemetry::DistanceSensor>();
-
         rpc_obj->set_minimum_distance_m(distance_sensor.minimum_distance_m);
 
         rpc_obj->set_maximum_distance_m(distance_sensor.maximum_distance_m);
 
         rpc_obj->set_current_distance_m(distance_sensor.current_distance_m);
-
-        return rpc_obj;
     }
 
     static mavsdk::Telemetry::DistanceSensor
@@ -939,11 +903,10 @@ public:
         return obj;
     }
 
-    static std::unique_ptr<rpc::telemetry::ScaledPressure>
-    translateToRpcScaledPressure(const mavsdk::Telemetry::ScaledPressure& scaled_pressure)
+    static void translateToRpcScaledPressure(
+        const mavsdk::Telemetry::ScaledPressure& scaled_pressure,
+        rpc::telemetry::ScaledPressure* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::telemetry::ScaledPressure>();
-
         rpc_obj->set_timestamp_us(scaled_pressure.timestamp_us);
 
         rpc_obj->set_absolute_pressure_hpa(scaled_pressure.absolute_pressure_hpa);
@@ -954,8 +917,6 @@ public:
 
         rpc_obj->set_differential_pressure_temperature_deg(
             scaled_pressure.differential_pressure_temperature_deg);
-
-        return rpc_obj;
     }
 
     static mavsdk::Telemetry::ScaledPressure
@@ -977,18 +938,14 @@ public:
         return obj;
     }
 
-    static std::unique_ptr<rpc::telemetry::PositionNed>
-    translateToRpcPositionNed(const mavsdk::Telemetry::PositionNed& position_ned)
+    static void translateToRpcPositionNed(
+        const mavsdk::Telemetry::PositionNed& position_ned, rpc::telemetry::PositionNed* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::telemetry::PositionNed>();
-
         rpc_obj->set_north_m(position_ned.north_m);
 
         rpc_obj->set_east_m(position_ned.east_m);
 
         rpc_obj->set_down_m(position_ned.down_m);
-
-        return rpc_obj;
     }
 
     static mavsdk::Telemetry::PositionNed
@@ -1005,18 +962,14 @@ public:
         return obj;
     }
 
-    static std::unique_ptr<rpc::telemetry::VelocityNed>
-    translateToRpcVelocityNed(const mavsdk::Telemetry::VelocityNed& velocity_ned)
+    static void translateToRpcVelocityNed(
+        const mavsdk::Telemetry::VelocityNed& velocity_ned, rpc::telemetry::VelocityNed* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::telemetry::VelocityNed>();
-
         rpc_obj->set_north_m_s(velocity_ned.north_m_s);
 
         rpc_obj->set_east_m_s(velocity_ned.east_m_s);
 
         rpc_obj->set_down_m_s(velocity_ned.down_m_s);
-
-        return rpc_obj;
     }
 
     static mavsdk::Telemetry::VelocityNed
@@ -1033,18 +986,13 @@ public:
         return obj;
     }
 
-    static std::unique_ptr<rpc::telemetry::PositionVelocityNed> translateToRpcPositionVelocityNed(
-        const mavsdk::Telemetry::PositionVelocityNed& position_velocity_ned)
+    static void translateToRpcPositionVelocityNed(
+        const mavsdk::Telemetry::PositionVelocityNed& position_velocity_ned,
+        rpc::telemetry::PositionVelocityNed* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::telemetry::PositionVelocityNed>();
-
-        rpc_obj->set_allocated_position(
-            translateToRpcPositionNed(position_velocity_ned.position).release());
+        translateToRpcPositionNed(position_velocity_ned.position, rpc_obj->mutable_position());
 
-        rpc_obj->set_allocated_velocity(
-            translateToRpcVelocityNed(position_velocity_ned.velocity).release());
-
-        return rpc_obj;
+        translateToRpcVelocityNed(position_velocity_ned.velocity, rpc_obj->mutable_velocity());
     }
 
     static mavsdk::Telemetry::PositionVelocityNed translateFromRpcPositionVelocityNed(
@@ -1059,18 +1007,14 @@ public:
         return obj;
     }
 
-    static std::unique_ptr<rpc::telemetry::GroundTruth>
-    translateToRpcGroundTruth(const mavsdk::Telemetry::GroundTruth& ground_truth)
+    static void translateToRpcGroundTruth(
+        const mavsdk::Telemetry::GroundTruth& ground_truth, rpc::telemetry::GroundTruth* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::telemetry::GroundTruth>();
-
         rpc_obj->set_latitude_deg(ground_truth.latitude_deg);
 
         rpc_obj->set_longitude_deg(ground_truth.longitude_deg);
 
         rpc_obj->set_absolute_altitude_m(ground_truth.absolute_altitude_m);
-
-        return rpc_obj;
     }
 
     static mavsdk::Telemetry::GroundTruth
@@ -1087,18 +1031,15 @@ public:
         return obj;
     }
 
-    static std::unique_ptr<rpc::telemetry::FixedwingMetrics>
-    translateToRpcFixedwingMetrics(const mavsdk::Telemetry::FixedwingMetrics& fixedwing_metrics)
+    static void translateToRpcFixedwingMetrics(
+        const mavsdk::Telemetry::FixedwingMetrics& fixedwing_metrics,
+        rpc::telemetry::FixedwingMetrics* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::telemetry::FixedwingMetrics>();
-
         rpc_obj->set_airspeed_m_s(fixedwing_metrics.airspeed_m_s);
 
         rpc_obj->set_throttle_percentage(fixedwing_metrics.throttle_percentage);
 
         rpc_obj->set_climb_rate_m_s(fixedwing_metrics.climb_rate_m_s);
-
-        return rpc_obj;
     }
 
     static mavsdk::Telemetry::FixedwingMetrics
@@ -1115,18 +1056,15 @@ public:
         return obj;
     }
 
-    static std::unique_ptr<rpc::telemetry::AccelerationFrd>
-    translateToRpcAccelerationFrd(const mavsdk::Telemetry::AccelerationFrd& acceleration_frd)
+    static void translateToRpcAccelerationFrd(
+        const mavsdk::Telemetry::AccelerationFrd& acceleration_frd,
+        rpc::telemetry::AccelerationFrd* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::telemetry::AccelerationFrd>();
-
         rpc_obj->set_forward_m_s2(acceleration_frd.forward_m_s2);
 
         rpc_obj->set_right_m_s2(acceleration_frd.right_m_s2);
 
         rpc_obj->set_down_m_s2(acceleration_frd.down_m_s2);
-
-        return rpc_obj;
     }
 
     static mavsdk::Telemetry::AccelerationFrd
@@ -1143,18 +1081,15 @@ public:
         return obj;
     }
 
-    static std::unique_ptr<rpc::telemetry::AngularVelocityFrd> translateToRpcAngularVelocityFrd(
-        const mavsdk::Telemetry::AngularVelocityFrd& angular_velocity_frd)
+    static void translateToRpcAngularVelocityFrd(
+        const mavsdk::Telemetry::AngularVelocityFrd& angular_velocity_frd,
+        rpc::telemetry::AngularVelocityFrd* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::telemetry::AngularVelocityFrd>();
-
         rpc_obj->set_forward_rad_s(angular_velocity_frd.forward_rad_s);
 
         rpc_obj->set_right_rad_s(angular_velocity_frd.right_rad_s);
 
         rpc_obj->set_down_rad_s(angular_velocity_frd.down_rad_s);
-
-        return rpc_obj;
     }
 
     static mavsdk::Telemetry::AngularVelocityFrd translateFromRpcAngularVelocityFrd(
@@ -1171,18 +1106,15 @@ public:
         return obj;
     }
 
-    static std::unique_ptr<rpc::telemetry::MagneticFieldFrd>
-    translateToRpcMagneticFieldFrd(const mavsdk::Telemetry::MagneticFieldFrd& magnetic_field_frd)
+    static void translateToRpcMagneticFieldFrd(
+        const mavsdk::Telemetry::MagneticFieldFrd& magnetic_field_frd,
+        rpc::telemetry::MagneticFieldFrd* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::telemetry::MagneticFieldFrd>();
-
         rpc_obj->set_forward_gauss(magnetic_field_frd.forward_gauss);
 
         rpc_obj->set_right_gauss(magnetic_field_frd.right_gauss);
 
         rpc_obj->set_down_gauss(magnetic_field_frd.down_gauss);
-
-        return rpc_obj;
     }
 
     static mavsdk::Telemetry::MagneticFieldFrd
@@ -1199,24 +1131,19 @@ public:
         return obj;
     }
 
-    static std::unique_ptr<rpc::telemetry::Imu> translateToRpcImu(const mavsdk::Telemetry::Imu& imu)
+    static void translateToRpcImu(const mavsdk::Telemetry::Imu& imu, rpc::telemetry::Imu* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::telemetry::Imu>();
-
-        rpc_obj->set_allocated_acceleration_frd(
-            translateToRpcAccelerationFrd(imu.acceleration_frd).release());
+        translateToRpcAccelerationFrd(imu.acceleration_frd, rpc_obj->mutable_acceleration_frd());
 
-        rpc_obj->set_allocated_angular_velocity_frd(
-            translateToRpcAngularVelocityFrd(imu.angular_velocity_frd).release());
+        translateToRpcAngularVelocityFrd(
+            imu.angular_velocity_frd, rpc_obj->mutable_angular_velocity_frd());
 
-        rpc_obj->set_allocated_magnetic_field_frd(
-            translateToRpcMagneticFieldFrd(imu.magnetic_field_frd).release());
+        translateToRpcMagneticFieldFrd(
+            imu.magnetic_field_frd, rpc_obj->mutable_magnetic_field_frd());
 
         rpc_obj->set_temperature_degc(imu.temperature_degc);
 
         rpc_obj->set_timestamp_us(imu.timestamp_us);
-
-        return rpc_obj;
     }
 
     static mavsdk::Telemetry::Imu translateFromRpcImu(const rpc::telemetry::Imu& imu)
@@ -1236,18 +1163,15 @@ public:
         return obj;
     }
 
-    static std::unique_ptr<rpc::telemetry::GpsGlobalOrigin>
-    translateToRpcGpsGlobalOrigin(const mavsdk::Telemetry::GpsGlobalOrigin& gps_global_origin)
+    static void translateToRpcGpsGlobalOrigin(
+        const mavsdk::Telemetry::GpsGlobalOrigin& gps_global_origin,
+        rpc::telemetry::GpsGlobalOrigin* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::telemetry::GpsGlobalOrigin>();
-
         rpc_obj->set_latitude_deg(gps_global_origin.latitude_deg);
 
         rpc_obj->set_longitude_deg(gps_global_origin.longitude_deg);
 
         rpc_obj->set_altitude_m(gps_global_origin.altitude_m);
-
-        return rpc_obj;
     }
 
     static mavsdk::Telemetry::GpsGlobalOrigin
@@ -1264,11 +1188,9 @@ public:
         return obj;
     }
 
-    static std::unique_ptr<rpc::telemetry::Altitude>
-    translateToRpcAltitude(const mavsdk::Telemetry::Altitude& altitude)
+    static void translateToRpcAltitude(
+        const mavsdk::Telemetry::Altitude& altitude, rpc::telemetry::Altitude* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::telemetry::Altitude>();
-
         rpc_obj->set_altitude_monotonic_m(altitude.altitude_monotonic_m);
 
         rpc_obj->set_altitude_amsl_m(altitude.altitude_amsl_m);
@@ -1280,8 +1202,6 @@ public:
         rpc_obj->set_altitude_terrain_m(altitude.altitude_terrain_m);
 
         rpc_obj->set_bottom_clearance_m(altitude.bottom_clearance_m);
-
-        return rpc_obj;
     }
 
     static mavsdk::Telemetry::Altitude
@@ -1356,1420 +1276,1087 @@ public:
         }
     }
 
-    grpc::Status SubscribePosition(
-        grpc::ServerContext* /* context */,
-        const mavsdk::rpc::telemetry::SubscribePositionRequest* /* request */,
-        grpc::ServerWriter<rpc::telemetry::PositionResponse>* writer) override
+    grpc::ServerWriteReactor<rpc::telemetry::PositionResponse>* SubscribePosition(
+        grpc::CallbackServerContext* context,
+        const mavsdk::rpc::telemetry::SubscribePositionRequest* /* request */) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
-            return grpc::Status::OK;
-        }
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
 
-        auto stream_closed_promise = std::make_shared<std::promise<void>>();
-        auto stream_closed_future = stream_closed_promise->get_future();
-        register_stream_stop_promise(stream_closed_promise);
+        auto reactor =
+            StreamReactor<rpc::telemetry::PositionResponse>::create(OutboxPolicy::Conflate);
 
-        auto is_finished = std::make_shared<bool>(false);
-        auto subscribe_mutex = std::make_shared<std::mutex>();
+        if (plugin == nullptr) {
+            reactor->finish();
+            return reactor.get();
+        }
+
+        _streams.add(reactor);
 
         const mavsdk::Telemetry::PositionHandle handle =
-            _lazy_plugin.maybe_plugin()->subscribe_position(
-                [this, &writer, &stream_closed_promise, is_finished, subscribe_mutex, &handle](
-                    const mavsdk::Telemetry::Position position) {
+            plugin->subscribe_position(
+                [reactor](const mavsdk::Telemetry::Position position) {
                     rpc::telemetry::PositionResponse rpc_response;
 
-                    rpc_response.set_allocated_position(translateToRpcPosition(position).release());
-
-                    std::unique_lock<std::mutex> lock(*subscribe_mutex);
-                    if (!*is_finished && !writer->Write(rpc_response)) {
-                        _lazy_plugin.maybe_plugin()->unsubscribe_position(handle);
+                    translateToRpcPosition(position, rpc_response.mutable_position());
 
-                        *is_finished = true;
-                        unregister_stream_stop_promise(stream_closed_promise);
-                        stream_closed_promise->set_value();
-                    }
+                    reactor->write(std::move(rpc_response));
                 });
 
-        stream_closed_future.wait();
-        std::unique_lock<std::mutex> lock(*subscribe_mutex);
-        *is_finished = true;
+        reactor->set_on_done([plugin, handle]() { plugin->unsubscribe_position(handle); });
 
-        return grpc::Status::OK;
+        return reactor.get();
     }
 
-    grpc::Status SubscribeHome(
-        grpc::ServerContext* /* context */,
-        const mavsdk::rpc::telemetry::SubscribeHomeRequest* /* request */,
-        grpc::ServerWriter<rpc::telemetry::HomeResponse>* writer) override
+    grpc::ServerWriteReactor<rpc::telemetry::HomeResponse>* SubscribeHome(
+        grpc::CallbackServerContext* context,
+        const mavsdk::rpc::telemetry::SubscribeHomeRequest* /* request */) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
-            return grpc::Status::OK;
-        }
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
 
-        auto stream_closed_promise = std::make_shared<std::promise<void>>();
-        auto stream_closed_future = stream_closed_promise->get_future();
-        register_stream_stop_promise(stream_closed_promise);
+        auto reactor = StreamReactor<rpc::telemetry::HomeResponse>::create(OutboxPolicy::Conflate);
 
-        auto is_finished = std::make_shared<bool>(false);
-        auto subscribe_mutex = std::make_shared<std::mutex>();
+        if (plugin == nullptr) {
+            reactor->finish();
+            return reactor.get();
+        }
 
-        const mavsdk::Telemetry::HomeHandle handle = _lazy_plugin.maybe_plugin()->subscribe_home(
-            [this, &writer, &stream_closed_promise, is_finished, subscribe_mutex, &handle](
-                const mavsdk::Telemetry::Position home) {
-                rpc::telemetry::HomeResponse rpc_response;
+        _streams.add(reactor);
 
-                rpc_response.set_allocated_home(translateToRpcPosition(home).release());
+        const mavsdk::Telemetry::HomeHandle handle = plugin->subscribe_home(
+            [reactor](const mavsdk::Telemetry::Position home) {
+                rpc::telemetry::HomeResponse rpc_response;
 
-                std::unique_lock<std::mutex> lock(*subscribe_mutex);
-                if (!*is_finished && !writer->Write(rpc_response)) {
-                    _lazy_plugin.maybe_plugin()->unsubscribe_home(handle);
+                translateToRpcPosition(home, rpc_response.mutable_home());
 
-                    *is_finished = true;
-                    unregister_stream_stop_promise(stream_closed_promise);
-                    stream_closed_promise->set_value();
-                }
+                reactor->write(std::move(rpc_response));
             });
 
-        stream_closed_future.wait();
-        std::unique_lock<std::mutex> lock(*subscribe_mutex);
-        *is_finished = true;
+        reactor->set_on_done([plugin, handle]() { plugin->unsubscribe_home(handle); });
 
-        return grpc::Status::OK;
+        return reactor.get();
     }
 
-    grpc::Status SubscribeInAir(
-        grpc::ServerContext* /* context */,
-        const mavsdk::rpc::telemetry::SubscribeInAirRequest* /* request */,
-        grpc::ServerWriter<rpc::telemetry::InAirResponse>* writer) override
+    grpc::ServerWriteReactor<rpc::telemetry::InAirResponse>* SubscribeInAir(
+        grpc::CallbackServerContext* context,
+        const mavsdk::rpc::telemetry::SubscribeInAirRequest* /* request */) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
-            return grpc::Status::OK;
-        }
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
 
-        auto stream_closed_promise = std::make_shared<std::promise<void>>();
-        auto stream_closed_future = stream_closed_promise->get_future();
-        register_stream_stop_promise(stream_closed_promise);
+        auto reactor = StreamReactor<rpc::telemetry::InAirResponse>::create(OutboxPolicy::Conflate);
+
+        if (plugin == nullptr) {
+            reactor->finish();
+            return reactor.get();
+        }
 
-        auto is_finished = std::make_shared<bool>(false);
-        auto subscribe_mutex = std::make_shared<std::mutex>();
+        _streams.add(reactor);
 
-        const mavsdk::Telemetry::InAirHandle handle = _lazy_plugin.maybe_plugin()->subscribe_in_air(
-            [this, &writer, &stream_closed_promise, is_finished, subscribe_mutex, &handle](
-                const bool in_air) {
+        const mavsdk::Telemetry::InAirHandle handle = plugin->subscribe_in_air(
+            [reactor](const bool in_air) {
                 rpc::telemetry::InAirResponse rpc_response;
 
                 rpc_response.set_is_in_air(in_air);
 
-                std::unique_lock<std::mutex> lock(*subscribe_mutex);
-                if (!*is_finished && !writer->Write(rpc_response)) {
-                    _lazy_plugin.maybe_plugin()->unsubscribe_in_air(handle);
-
-                    *is_finished = true;
-                    unregister_stream_stop_promise(stream_closed_promise);
-                    stream_closed_promise->set_value();
-                }
+                reactor->write(std::move(rpc_response));
             });
 
-        stream_closed_future.wait();
-        std::unique_lock<std::mutex> lock(*subscribe_mutex);
-        *is_finished = true;
+        reactor->set_on_done([plugin, handle]() { plugin->unsubscribe_in_air(handle); });
 
-        return grpc::Status::OK;
+        return reactor.get();
     }
 
-    grpc::Status SubscribeLandedState(
-        grpc::ServerContext* /* context */,
-        const mavsdk::rpc::telemetry::SubscribeLandedStateRequest* /* request */,
-        grpc::ServerWriter<rpc::telemetry::LandedStateResponse>* writer) override
+    grpc::ServerWriteReactor<rpc::telemetry::LandedStateResponse>* SubscribeLandedState(
+        grpc::CallbackServerContext* context,
+        const mavsdk::rpc::telemetry::SubscribeLandedStateRequest* /* request */) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
-            return grpc::Status::OK;
-        }
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        auto reactor =
+            StreamReactor<rpc::telemetry::LandedStateResponse>::create(OutboxPolicy::Conflate);
 
-        auto stream_closed_promise = std::make_shared<std::promise<void>>();
-        auto stream_closed_future = stream_closed_promise->get_future();
-        register_stream_stop_promise(stream_closed_promise);
+        if (plugin == nullptr) {
+            reactor->finish();
+            return reactor.get();
+        }
 
-        auto is_finished = std::make_shared<bool>(false);
-        auto subscribe_mutex = std::make_shared<std::mutex>();
+        _streams.add(reactor);
 
         const mavsdk::Telemetry::LandedStateHandle handle =
-            _lazy_plugin.maybe_plugin()->subscribe_landed_state(
-                [this, &writer, &stream_closed_promise, is_finished, subscribe_mutex, &handle](
-                    const mavsdk::Telemetry::LandedState landed_state) {
+            plugin->subscribe_landed_state(
+                [reactor](const mavsdk::Telemetry::LandedState landed_state) {
                     rpc::telemetry::LandedStateResponse rpc_response;
 
                     rpc_response.set_landed_state(translateToRpcLandedState(landed_state));
 
-                    std::unique_lock<std::mutex> lock(*subscribe_mutex);
-                    if (!*is_finished && !writer->Write(rpc_response)) {
-                        _lazy_plugin.maybe_plugin()->unsubscribe_landed_state(handle);
-
-                        *is_finished = true;
-                        unregister_stream_stop_promise(stream_closed_promise);
-                        stream_closed_promise->set_value();
-                    }
+                    reactor->write(std::move(rpc_response));
                 });
 
-        stream_closed_future.wait();
-        std::unique_lock<std::mutex> lock(*subscribe_mutex);
-        *is_finished = true;
+        reactor->set_on_done([plugin, handle]() { plugin->unsubscribe_landed_state(handle); });
 
-        return grpc::Status::OK;
+        return reactor.get();
     }
 
-    grpc::Status SubscribeArmed(
-        grpc::ServerContext* /* context */,
-        const mavsdk::rpc::telemetry::SubscribeArmedRequest* /* request */,
-        grpc::ServerWriter<rpc::telemetry::ArmedResponse>* writer) override
+    grpc::ServerWriteReactor<rpc::telemetry::ArmedResponse>* SubscribeArmed(
+        grpc::CallbackServerContext* context,
+        const mavsdk::rpc::telemetry::SubscribeArmedRequest* /* request */) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
-            return grpc::Status::OK;
-        }
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
 
-        auto stream_closed_promise = std::make_shared<std::promise<void>>();
-        auto stream_closed_future = stream_closed_promise->get_future();
-        register_stream_stop_promise(stream_closed_promise);
+        auto reactor = StreamReactor<rpc::telemetry::ArmedResponse>::create(OutboxPolicy::Conflate);
 
-        auto is_finished = std::make_shared<bool>(false);
-        auto subscribe_mutex = std::make_shared<std::mutex>();
+        if (plugin == nullptr) {
+            reactor->finish();
+            return reactor.get();
+        }
+
+        _streams.add(reactor);
 
-        const mavsdk::Telemetry::ArmedHandle handle = _lazy_plugin.maybe_plugin()->subscribe_armed(
-            [this, &writer, &stream_closed_promise, is_finished, subscribe_mutex, &handle](
-                const bool armed) {
+        const mavsdk::Telemetry::ArmedHandle handle = plugin->subscribe_armed(
+            [reactor](const bool armed) {
                 rpc::telemetry::ArmedResponse rpc_response;
 
                 rpc_response.set_is_armed(armed);
 
-                std::unique_lock<std::mutex> lock(*subscribe_mutex);
-                if (!*is_finished && !writer->Write(rpc_response)) {
-                    _lazy_plugin.maybe_plugin()->unsubscribe_armed(handle);
-
-                    *is_finished = true;
-                    unregister_stream_stop_promise(stream_closed_promise);
-                    stream_closed_promise->set_value();
-                }
+                reactor->write(std::move(rpc_response));
             });
 
-        stream_closed_future.wait();
-        std::unique_lock<std::mutex> lock(*subscribe_mutex);
-        *is_finished = true;
+        reactor->set_on_done([plugin, handle]() { plugin->unsubscribe_armed(handle); });
 
-        return grpc::Status::OK;
+        return reactor.get();
     }
 
-    grpc::Status SubscribeVtolState(
-        grpc::ServerContext* /* context */,
-        const mavsdk::rpc::telemetry::SubscribeVtolStateRequest* /* request */,
-        grpc::ServerWriter<rpc::telemetry::VtolStateResponse>* writer) override
+    grpc::ServerWriteReactor<rpc::telemetry::VtolStateResponse>* SubscribeVtolState(
+        grpc::CallbackServerContext* context,
+        const mavsdk::rpc::telemetry::SubscribeVtolStateRequest* /* request */) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
-            return grpc::Status::OK;
-        }
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        auto reactor =
+            StreamReactor<rpc::telemetry::VtolStateResponse>::create(OutboxPolicy::Conflate);
 
-        auto stream_closed_promise = std::make_shared<std::promise<void>>();
-        auto stream_closed_future = stream_closed_promise->get_future();
-        register_stream_stop_promise(stream_closed_promise);
+        if (plugin == nullptr) {
+            reactor->finish();
+            return reactor.get();
+        }
 
-        auto is_finished = std::make_shared<bool>(false);
-        auto subscribe_mutex = std::make_shared<std::mutex>();
+        _streams.add(reactor);
 
         const mavsdk::Telemetry::VtolStateHandle handle =
-            _lazy_plugin.maybe_plugin()->subscribe_vtol_state(
-                [this, &writer, &stream_closed_promise, is_finished, subscribe_mutex, &handle](
-                    const mavsdk::Telemetry::VtolState vtol_state) {
+            plugin->subscribe_vtol_state(
+                [reactor](const mavsdk::Telemetry::VtolState vtol_state) {
                     rpc::telemetry::VtolStateResponse rpc_response;
 
                     rpc_response.set_vtol_state(translateToRpcVtolState(vtol_state));
 
-                    std::unique_lock<std::mutex> lock(*subscribe_mutex);
-                    if (!*is_finished && !writer->Write(rpc_response)) {
-                        _lazy_plugin.maybe_plugin()->unsubscribe_vtol_state(handle);
-
-                        *is_finished = true;
-                        unregister_stream_stop_promise(stream_closed_promise);
-                        stream_closed_promise->set_value();
-                    }
+                    reactor->write(std::move(rpc_response));
                 });
 
-        stream_closed_future.wait();
-        std::unique_lock<std::mutex> lock(*subscribe_mutex);
-        *is_finished = true;
+        reactor->set_on_done([plugin, handle]() { plugin->unsubscribe_vtol_state(handle); });
 
-        return grpc::Status::OK;
+        return reactor.get();
     }
 
-    grpc::Status SubscribeAttitudeQuaternion(
-        grpc::ServerContext* /* context */,
-        const mavsdk::rpc::telemetry::SubscribeAttitudeQuaternionRequest* /* request */,
-        grpc::ServerWriter<rpc::telemetry::AttitudeQuaternionResponse>* writer) override
+    grpc::ServerWriteReactor<rpc::telemetry::AttitudeQuaternionResponse>*
+    SubscribeAttitudeQuaternion(
+        grpc::CallbackServerContext* context,
+        const mavsdk::rpc::telemetry::SubscribeAttitudeQuaternionRequest* /* request */) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
-            return grpc::Status::OK;
-        }
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
 
-        auto stream_closed_promise = std::make_shared<std::promise<void>>();
-        auto stream_closed_future = stream_closed_promise->get_future();
-        register_stream_stop_promise(stream_closed_promise);
+        auto reactor = StreamReactor<rpc::telemetry::AttitudeQuaternionResponse>::create(
+            OutboxPolicy::Conflate);
+
+        if (plugin == nullptr) {
+            reactor->finish();
+            return reactor.get();
+        }
 
-        auto is_finished = std::make_shared<bool>(false);
-        auto subscribe_mutex = std::make_shared<std::mutex>();
+        _streams.add(reactor);
 
         const mavsdk::Telemetry::AttitudeQuaternionHandle handle =
-            _lazy_plugin.maybe_plugin()->subscribe_attitude_quaternion(
-                [this, &writer, &stream_closed_promise, is_finished, subscribe_mutex, &handle](
-                    const mavsdk::Telemetry::Quaternion attitude_quaternion) {
+            plugin->subscribe_attitude_quaternion(
+                [reactor](const mavsdk::Telemetry::Quaternion attitude_quaternion) {
                     rpc::telemetry::AttitudeQuaternionResponse rpc_response;
 
-                    rpc_response.set_allocated_attitude_quaternion(
-                        translateToRpcQuaternion(attitude_quaternion).release());
+                    translateToRpcQuaternion(
+                        attitude_quaternion, rpc_response.mutable_attitude_quaternion());
 
-                    std::unique_lock<std::mutex> lock(*subscribe_mutex);
-                    if (!*is_finished && !writer->Write(rpc_response)) {
-                        _lazy_plugin.maybe_plugin()->unsubscribe_attitude_quaternion(handle);
-
-                        *is_finished = true;
-                        unregister_stream_stop_promise(stream_closed_promise);
-                        stream_closed_promise->set_value();
-                    }
+                    reactor->write(std::move(rpc_response));
                 });
 
-        stream_closed_future.wait();
-        std::unique_lock<std::mutex> lock(*subscribe_mutex);
-        *is_finished = true;
+        reactor->set_on_done(
+            [plugin, handle]() { plugin->unsubscribe_attitude_quaternion(handle); });
 
-        return grpc::Status::OK;
+        return reactor.get();
     }
 
-    grpc::Status SubscribeAttitudeEuler(
-        grpc::ServerContext* /* context */,
-        const mavsdk::rpc::telemetry::SubscribeAttitudeEulerRequest* /* request */,
-        grpc::ServerWriter<rpc::telemetry::AttitudeEulerResponse>* writer) override
+    grpc::ServerWriteReactor<rpc::telemetry::AttitudeEulerResponse>* SubscribeAttitudeEuler(
+        grpc::CallbackServerContext* context,
+        const mavsdk::rpc::telemetry::SubscribeAttitudeEulerRequest* /* request */) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
-            return grpc::Status::OK;
-        }
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
 
-        auto stream_closed_promise = std::make_shared<std::promise<void>>();
-        auto stream_closed_future = stream_closed_promise->get_future();
-        register_stream_stop_promise(stream_closed_promise);
+        auto reactor =
+            StreamReactor<rpc::telemetry::AttitudeEulerResponse>::create(OutboxPolicy::Conflate);
 
-        auto is_finished = std::make_shared<bool>(false);
-        auto subscribe_mutex = std::make_shared<std::mutex>();
+        if (plugin == nullptr) {
+            reactor->finish();
+            return reactor.get();
+        }
+
+        _streams.add(reactor);
 
         const mavsdk::Telemetry::AttitudeEulerHandle handle =
-            _lazy_plugin.maybe_plugin()->subscribe_attitude_euler(
-                [this, &writer, &stream_closed_promise, is_finished, subscribe_mutex, &handle](
-                    const mavsdk::Telemetry::EulerAngle attitude_euler) {
+            plugin->subscribe_attitude_euler(
+                [reactor](const mavsdk::Telemetry::EulerAngle attitude_euler) {
                     rpc::telemetry::AttitudeEulerResponse rpc_response;
 
-                    rpc_response.set_allocated_attitude_euler(
-                        translateToRpcEulerAngle(attitude_euler).release());
-
-                    std::unique_lock<std::mutex> lock(*subscribe_mutex);
-                    if (!*is_finished && !writer->Write(rpc_response)) {
-                        _lazy_plugin.maybe_plugin()->unsubscribe_attitude_euler(handle);
+                    translateToRpcEulerAngle(attitude_euler, rpc_response.mutable_attitude_euler());
 
-                        *is_finished = true;
-                        unregister_stream_stop_promise(stream_closed_promise);
-                        stream_closed_promise->set_value();
-                    }
+                    reactor->write(std::move(rpc_response));
                 });
 
-        stream_closed_future.wait();
-        std::unique_lock<std::mutex> lock(*subscribe_mutex);
-        *is_finished = true;
+        reactor->set_on_done([plugin, handle]() { plugin->unsubscribe_attitude_euler(handle); });
 
-        return grpc::Status::OK;
+        return reactor.get();
     }
 
-    grpc::Status SubscribeAttitudeAngularVelocityBody(
-        grpc::ServerContext* /* context */,
-        const mavsdk::rpc::telemetry::SubscribeAttitudeAngularVelocityBodyRequest* /* request */,
-        grpc::ServerWriter<rpc::telemetry::AttitudeAngularVelocityBodyResponse>* writer) override
+    grpc::ServerWriteReactor<rpc::telemetry::AttitudeAngularVelocityBodyResponse>*
+    SubscribeAttitudeAngularVelocityBody(
+        grpc::CallbackServerContext* context,
+        const mavsdk::rpc::telemetry::SubscribeAttitudeAngularVelocityBodyRequest* /* request */)
+        override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
-            return grpc::Status::OK;
-        }
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
 
-        auto stream_closed_promise = std::make_shared<std::promise<void>>();
-        auto stream_closed_future = stream_closed_promise->get_future();
-        register_stream_stop_promise(stream_closed_promise);
+        auto reactor = StreamReactor<rpc::telemetry::AttitudeAngularVelocityBodyResponse>::create(
+            OutboxPolicy::Conflate);
 
-        auto is_finished = std::make_shared<bool>(false);
-        auto subscribe_mutex = std::make_shared<std::mutex>();
+        if (plugin == nullptr) {
+            reactor->finish();
+            return reactor.get();
+        }
+
+        _streams.add(reactor);
 
         const mavsdk::Telemetry::AttitudeAngularVelocityBodyHandle handle =
-            _lazy_plugin.maybe_plugin()->subscribe_attitude_angular_velocity_body(
-                [this, &writer, &stream_closed_promise, is_finished, subscribe_mutex, &handle](
+            plugin->subscribe_attitude_angular_velocity_body(
+                [reactor](
                     const mavsdk::Telemetry::AngularVelocityBody attitude_angular_velocity_body) {
                     rpc::telemetry::AttitudeAngularVelocityBodyResponse rpc_response;
 
-                    rpc_response.set_allocated_attitude_angular_velocity_body(
-                        translateToRpcAngularVelocityBody(attitude_angular_velocity_body)
-                            .release());
+                    translateToRpcAngularVelocityBody(
+                        attitude_angular_velocity_body,
+                        rpc_response.mutable_attitude_angular_velocity_body());
 
-                    std::unique_lock<std::mutex> lock(*subscribe_mutex);
-                    if (!*is_finished && !writer->Write(rpc_response)) {
-                        _lazy_plugin.maybe_plugin()->unsubscribe_attitude_angular_velocity_body(
-                            handle);
-
-                        *is_finished = true;
-                        unregister_stream_stop_promise(stream_closed_promise);
-                        stream_closed_promise->set_value();
-                    }
+                    reactor->write(std::move(rpc_response));
                 });
 
-        stream_closed_future.wait();
-        std::unique_lock<std::mutex> lock(*subscribe_mutex);
-        *is_finished = true;
+        reactor->set_on_done(
+            [plugin, handle]() { plugin->unsubscribe_attitude_angular_velocity_body(handle); });
 
-        return grpc::Status::OK;
+        return reactor.get();
     }
 
-    grpc::Status SubscribeCameraAttitudeQuaternion(
-        grpc::ServerContext* /* context */,
-        const mavsdk::rpc::telemetry::SubscribeCameraAttitudeQuaternionRequest* /* request */,
-        grpc::ServerWriter<rpc::telemetry::CameraAttitudeQuaternionResponse>* writer) override
+    grpc::ServerWriteReactor<rpc::telemetry::CameraAttitudeQuaternionResponse>*
+    SubscribeCameraAttitudeQuaternion(
+        grpc::CallbackServerContext* context,
+        const mavsdk::rpc::telemetry::SubscribeCameraAttitudeQuaternionRequest* /* request */)
+        override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
-            return grpc::Status::OK;
-        }
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
 
-        auto stream_closed_promise = std::make_shared<std::promise<void>>();
-        auto stream_closed_future = stream_closed_promise->get_future();
-        register_stream_stop_promise(stream_closed_promise);
+        auto reactor = StreamReactor<rpc::telemetry::CameraAttitudeQuaternionResponse>::create(
+            OutboxPolicy::Conflate);
 
-        auto is_finished = std::make_shared<bool>(false);
-        auto subscribe_mutex = std::make_shared<std::mutex>();
+        if (plugin == nullptr) {
+            reactor->finish();
+            return reactor.get();
+        }
+
+        _streams.add(reactor);
 
         const mavsdk::Telemetry::CameraAttitudeQuaternionHandle handle =
-            _lazy_plugin.maybe_plugin()->subscribe_camera_attitude_quaternion(
-                [this, &writer, &stream_closed_promise, is_finished, subscribe_mutex, &handle](
-                    const mavsdk::Telemetry::Quaternion camera_attitude_quaternion) {
+            plugin->subscribe_camera_attitude_quaternion(
+                [reactor](const mavsdk::Telemetry::Quaternion camera_attitude_quaternion) {
                     rpc::telemetry::CameraAttitudeQuaternionResponse rpc_response;
 
-                    rpc_response.set_allocated_attitude_quaternion(
-                        translateToRpcQuaternion(camera_attitude_quaternion).release());
-
-                    std::unique_lock<std::mutex> lock(*subscribe_mutex);
-                    if (!*is_finished && !writer->Write(rpc_response)) {
-                        _lazy_plugin.maybe_plugin()->unsubscribe_camera_attitude_quaternion(handle);
+                    translateToRpcQuaternion(
+                        camera_attitude_quaternion, rpc_response.mutable_attitude_quaternion());
 
-                        *is_finished = true;
-                        unregister_stream_stop_promise(stream_closed_promise);
-                        stream_closed_promise->set_value();
-                    }
+                    reactor->write(std::move(rpc_response));
                 });
 
-        stream_closed_future.wait();
-        std::unique_lock<std::mutex> lock(*subscribe_mutex);
-        *is_finished = true;
+        reactor->set_on_done(
+            [plugin, handle]() { plugin->unsubscribe_camera_attitude_quaternion(handle); });
 
-        return grpc::Status::OK;
+        return reactor.get();
     }
 
-    grpc::Status SubscribeCameraAttitudeEuler(
-        grpc::ServerContext* /* context */,
-        const mavsdk::rpc::telemetry::SubscribeCameraAttitudeEulerRequest* /* request */,
-        grpc::ServerWriter<rpc::telemetry::CameraAttitudeEulerResponse>* writer) override
+    grpc::ServerWriteReactor<rpc::telemetry::CameraAttitudeEulerResponse>*
+    SubscribeCameraAttitudeEuler(
+        grpc::CallbackServerContext* context,
+        const mavsdk::rpc::telemetry::SubscribeCameraAttitudeEulerRequest* /* request */) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
-            return grpc::Status::OK;
-        }
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
 
-        auto stream_closed_promise = std::make_shared<std::promise<void>>();
-        auto stream_closed_future = stream_closed_promise->get_future();
-        register_stream_stop_promise(stream_closed_promise);
+        auto reactor = StreamReactor<rpc::telemetry::CameraAttitudeEulerResponse>::create(
+            OutboxPolicy::Conflate);
+
+        if (plugin == nullptr) {
+            reactor->finish();
+            return reactor.get();
+        }
 
-        auto is_finished = std::make_shared<bool>(false);
-        auto subscribe_mutex = std::make_shared<std::mutex>();
+        _streams.add(reactor);
 
         const mavsdk::Telemetry::CameraAttitudeEulerHandle handle =
-            _lazy_plugin.maybe_plugin()->subscribe_camera_attitude_euler(
-                [this, &writer, &stream_closed_promise, is_finished, subscribe_mutex, &handle](
-                    const mavsdk::Telemetry::EulerAngle camera_attitude_euler) {
+            plugin->subscribe_camera_attitude_euler(
+                [reactor](const mavsdk::Telemetry::EulerAngle camera_attitude_euler) {
                     rpc::telemetry::CameraAttitudeEulerResponse rpc_response;
 
-                    rpc_response.set_allocated_attitude_euler(
-                        translateToRpcEulerAngle(camera_attitude_euler).release());
+                    translateToRpcEulerAngle(
+                        camera_attitude_euler, rpc_response.mutable_attitude_euler());
 
-                    std::unique_lock<std::mutex> lock(*subscribe_mutex);
-                    if (!*is_finished && !writer->Write(rpc_response)) {
-                        _lazy_plugin.maybe_plugin()->unsubscribe_camera_attitude_euler(handle);
-
-                        *is_finished = true;
-                        unregister_stream_stop_promise(stream_closed_promise);
-                        stream_closed_promise->set_value();
-                    }
+                    reactor->write(std::move(rpc_response));
                 });
 
-        stream_closed_future.wait();
-        std::unique_lock<std::mutex> lock(*subscribe_mutex);
-        *is_finished = true;
+        reactor->set_on_done(
+            [plugin, handle]() { plugin->unsubscribe_camera_attitude_euler(handle); });
 
-        return grpc::Status::OK;
+        return reactor.get();
     }
 
-    grpc::Status SubscribeVelocityNed(
-        grpc::ServerContext* /* context */,
-        const mavsdk::rpc::telemetry::SubscribeVelocityNedRequest* /* request */,
-        grpc::ServerWriter<rpc::telemetry::VelocityNedResponse>* writer) override
+    grpc::ServerWriteReactor<rpc::telemetry::VelocityNedResponse>* SubscribeVelocityNed(
+        grpc::CallbackServerContext* context,
+        const mavsdk::rpc::telemetry::SubscribeVelocityNedRequest* /* request */) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
-            return grpc::Status::OK;
-        }
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
 
-        auto stream_closed_promise = std::make_shared<std::promise<void>>();
-        auto stream_closed_future = stream_closed_promise->get_future();
-        register_stream_stop_promise(stream_closed_promise);
+        auto reactor =
+            StreamReactor<rpc::telemetry::VelocityNedResponse>::create(OutboxPolicy::Conflate);
 
-        auto is_finished = std::make_shared<bool>(false);
-        auto subscribe_mutex = std::make_shared<std::mutex>();
+        if (plugin == nullptr) {
+            reactor->finish();
+            return reactor.get();
+        }
+
+        _streams.add(reactor);
 
         const mavsdk::Telemetry::VelocityNedHandle handle =
-            _lazy_plugin.maybe_plugin()->subscribe_velocity_ned(
-                [this, &writer, &stream_closed_promise, is_finished, subscribe_mutex, &handle](
-                    const mavsdk::Telemetry::VelocityNed velocity_ned) {
+            plugin->subscribe_velocity_ned(
+                [reactor](const mavsdk::Telemetry::VelocityNed velocity_ned) {
                     rpc::telemetry::VelocityNedResponse rpc_response;
 
-                    rpc_response.set_allocated_velocity_ned(
-                        translateToRpcVelocityNed(velocity_ned).release());
-
-                    std::unique_lock<std::mutex> lock(*subscribe_mutex);
-                    if (!*is_finished && !writer->Write(rpc_response)) {
-                        _lazy_plugin.maybe_plugin()->unsubscribe_velocity_ned(handle);
+                    translateToRpcVelocityNed(velocity_ned, rpc_response.mutable_velocity_ned());
 
-                        *is_finished = true;
-                        unregister_stream_stop_promise(stream_closed_promise);
-                        stream_closed_promise->set_value();
-                    }
+                    reactor->write(std::move(rpc_response));
                 });
 
-        stream_closed_future.wait();
-        std::unique_lock<std::mutex> lock(*subscribe_mutex);
-        *is_finished = true;
+        reactor->set_on_done([plugin, handle]() { plugin->unsubscribe_velocity_ned(handle); });
 
-        return grpc::Status::OK;
+        return reactor.get();
     }
 
-    grpc::Status SubscribeGpsInfo(
-        grpc::ServerContext* /* context */,
-        const mavsdk::rpc::telemetry::SubscribeGpsInfoRequest* /* request */,
-        grpc::ServerWriter<rpc::telemetry::GpsInfoResponse>* writer) override
+    grpc::ServerWriteReactor<rpc::telemetry::GpsInfoResponse>* SubscribeGpsInfo(
+        grpc::CallbackServerContext* context,
+        const mavsdk::rpc::telemetry::SubscribeGpsInfoRequest* /* request */) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
-            return grpc::Status::OK;
-        }
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        auto reactor =
+            StreamReactor<rpc::telemetry::GpsInfoResponse>::create(OutboxPolicy::Conflate);
 
-        auto stream_closed_promise = std::make_shared<std::promise<void>>();
-        auto stream_closed_future = stream_closed_promise->get_future();
-        register_stream_stop_promise(stream_closed_promise);
+        if (plugin == nullptr) {
+            reactor->finish();
+            return reactor.get();
+        }
 
-        auto is_finished = std::make_shared<bool>(false);
-        auto subscribe_mutex = std::make_shared<std::mutex>();
+        _streams.add(reactor);
 
         const mavsdk::Telemetry::GpsInfoHandle handle =
-            _lazy_plugin.maybe_plugin()->subscribe_gps_info(
-                [this, &writer, &stream_closed_promise, is_finished, subscribe_mutex, &handle](
-                    const mavsdk::Telemetry::GpsInfo gps_info) {
+            plugin->subscribe_gps_info(
+                [reactor](const mavsdk::Telemetry::GpsInfo gps_info) {
                     rpc::telemetry::GpsInfoResponse rpc_response;
 
-                    rpc_response.set_allocated_gps_info(translateToRpcGpsInfo(gps_info).release());
+                    translateToRpcGpsInfo(gps_info, rpc_response.mutable_gps_info());
 
-                    std::unique_lock<std::mutex> lock(*subscribe_mutex);
-                    if (!*is_finished && !writer->Write(rpc_response)) {
-                        _lazy_plugin.maybe_plugin()->unsubscribe_gps_info(handle);
-
-                        *is_finished = true;
-                        unregister_stream_stop_promise(stream_closed_promise);
-                        stream_closed_promise->set_value();
-                    }
+                    reactor->write(std::move(rpc_response));
                 });
 
-        stream_closed_future.wait();
-        std::unique_lock<std::mutex> lock(*subscribe_mutex);
-        *is_finished = true;
+        reactor->set_on_done([plugin, handle]() { plugin->unsubscribe_gps_info(handle); });
 
-        return grpc::Status::OK;
+        return reactor.get();
     }
 
-    grpc::Status SubscribeRawGps(
-        grpc::ServerContext* /* context */,
-        const mavsdk::rpc::telemetry::SubscribeRawGpsRequest* /* request */,
-        grpc::ServerWriter<rpc::telemetry::RawGpsResponse>* writer) override
+    grpc::ServerWriteReactor<rpc::telemetry::RawGpsResponse>* SubscribeRawGps(
+        grpc::CallbackServerContext* context,
+        const mavsdk::rpc::telemetry::SubscribeRawGpsRequest* /* request */) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
-            return grpc::Status::OK;
-        }
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
 
-        auto stream_closed_promise = std::make_shared<std::promise<void>>();
-        auto stream_closed_future = stream_closed_promise->get_future();
-        register_stream_stop_promise(stream_closed_promise);
+        auto reactor =
+            StreamReactor<rpc::telemetry::RawGpsResponse>::create(OutboxPolicy::Conflate);
 
-        auto is_finished = std::make_shared<bool>(false);
-        auto subscribe_mutex = std::make_shared<std::mutex>();
+        if (plugin == nullptr) {
+            reactor->finish();
+            return reactor.get();
+        }
+
+        _streams.add(reactor);
 
         const mavsdk::Telemetry::RawGpsHandle handle =
-            _lazy_plugin.maybe_plugin()->subscribe_raw_gps(
-                [this, &writer, &stream_closed_promise, is_finished, subscribe_mutex, &handle](
-                    const mavsdk::Telemetry::RawGps raw_gps) {
+            plugin->subscribe_raw_gps(
+                [reactor](const mavsdk::Telemetry::RawGps raw_gps) {
                     rpc::telemetry::RawGpsResponse rpc_response;
 
-                    rpc_response.set_allocated_raw_gps(translateToRpcRawGps(raw_gps).release());
-
-                    std::unique_lock<std::mutex> lock(*subscribe_mutex);
-                    if (!*is_finished && !writer->Write(rpc_response)) {
-                        _lazy_plugin.maybe_plugin()->unsubscribe_raw_gps(handle);
+                    translateToRpcRawGps(raw_gps, rpc_response.mutable_raw_gps());
 
-                        *is_finished = true;
-                        unregister_stream_stop_promise(stream_closed_promise);
-                        stream_closed_promise->set_value();
-                    }
+                    reactor->write(std::move(rpc_response));
                 });
 
-        stream_closed_future.wait();
-        std::unique_lock<std::mutex> lock(*subscribe_mutex);
-        *is_finished = true;
+        reactor->set_on_done([plugin, handle]() { plugin->unsubscribe_raw_gps(handle); });
 
-        return grpc::Status::OK;
+        return reactor.get();
     }
 
-    grpc::Status SubscribeBattery(
-        grpc::ServerContext* /* context */,
-        const mavsdk::rpc::telemetry::SubscribeBatteryRequest* /* request */,
-        grpc::ServerWriter<rpc::telemetry::BatteryResponse>* writer) override
+    grpc::ServerWriteReactor<rpc::telemetry::BatteryResponse>* SubscribeBattery(
+        grpc::CallbackServerContext* context,
+        const mavsdk::rpc::telemetry::SubscribeBatteryRequest* /* request */) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
-            return grpc::Status::OK;
-        }
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
 
-        auto stream_closed_promise = std::make_shared<std::promise<void>>();
-        auto stream_closed_future = stream_closed_promise->get_future();
-        register_stream_stop_promise(stream_closed_promise);
+        auto reactor =
+            StreamReactor<rpc::telemetry::BatteryResponse>::create(OutboxPolicy::Conflate);
+
+        if (plugin == nullptr) {
+            reactor->finish();
+            return reactor.get();
+        }
 
-        auto is_finished = std::make_shared<bool>(false);
-        auto subscribe_mutex = std::make_shared<std::mutex>();
+        _streams.add(reactor);
 
         const mavsdk::Telemetry::BatteryHandle handle =
-            _lazy_plugin.maybe_plugin()->subscribe_battery(
-                [this, &writer, &stream_closed_promise, is_finished, subscribe_mutex, &handle](
-                    const mavsdk::Telemetry::Battery battery) {
+            plugin->subscribe_battery(
+                [reactor](const mavsdk::Telemetry::Battery battery) {
                     rpc::telemetry::BatteryResponse rpc_response;
 
-                    rpc_response.set_allocated_battery(translateToRpcBattery(battery).release());
+                    translateToRpcBattery(battery, rpc_response.mutable_battery());
 
-                    std::unique_lock<std::mutex> lock(*subscribe_mutex);
-                    if (!*is_finished && !writer->Write(rpc_response)) {
-                        _lazy_plugin.maybe_plugin()->unsubscribe_battery(handle);
-
-                        *is_finished = true;
-                        unregister_stream_stop_promise(stream_closed_promise);
-                        stream_closed_promise->set_value();
-                    }
+                    reactor->write(std::move(rpc_response));
                 });
 
-        stream_closed_future.wait();
-        std::unique_lock<std::mutex> lock(*subscribe_mutex);
-        *is_finished = true;
+        reactor->set_on_done([plugin, handle]() { plugin->unsubscribe_battery(handle); });
 
-        return grpc::Status::OK;
+        return reactor.get();
     }
 
-    grpc::Status SubscribeFlightMode(
-        grpc::ServerContext* /* context */,
-        const mavsdk::rpc::telemetry::SubscribeFlightModeRequest* /* request */,
-        grpc::ServerWriter<rpc::telemetry::FlightModeResponse>* writer) override
+    grpc::ServerWriteReactor<rpc::telemetry::FlightModeResponse>* SubscribeFlightMode(
+        grpc::CallbackServerContext* context,
+        const mavsdk::rpc::telemetry::SubscribeFlightModeRequest* /* request */) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
-            return grpc::Status::OK;
-        }
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
 
-        auto stream_closed_promise = std::make_shared<std::promise<void>>();
-        auto stream_closed_future = stream_closed_promise->get_future();
-        register_stream_stop_promise(stream_closed_promise);
+        auto reactor =
+            StreamReactor<rpc::telemetry::FlightModeResponse>::create(OutboxPolicy::Conflate);
 
-        auto is_finished = std::make_shared<bool>(false);
-        auto subscribe_mutex = std::make_shared<std::mutex>();
+        if (plugin == nullptr) {
+            reactor->finish();
+            return reactor.get();
+        }
+
+        _streams.add(reactor);
 
         const mavsdk::Telemetry::FlightModeHandle handle =
-            _lazy_plugin.maybe_plugin()->subscribe_flight_mode(
-                [this, &writer, &stream_closed_promise, is_finished, subscribe_mutex, &handle](
-                    const mavsdk::Telemetry::FlightMode flight_mode) {
+            plugin->subscribe_flight_mode(
+                [reactor](const mavsdk::Telemetry::FlightMode flight_mode) {
                     rpc::telemetry::FlightModeResponse rpc_response;
 
                     rpc_response.set_flight_mode(translateToRpcFlightMode(flight_mode));
 
-                    std::unique_lock<std::mutex> lock(*subscribe_mutex);
-                    if (!*is_finished && !writer->Write(rpc_response)) {
-                        _lazy_plugin.maybe_plugin()->unsubscribe_flight_mode(handle);
-
-                        *is_finished = true;
-                        unregister_stream_stop_promise(stream_closed_promise);
-                        stream_closed_promise->set_value();
-                    }
+                    reactor->write(std::move(rpc_response));
                 });
 
-        stream_closed_future.wait();
-        std::unique_lock<std::mutex> lock(*subscribe_mutex);
-        *is_finished = true;
+        reactor->set_on_done([plugin, handle]() { plugin->unsubscribe_flight_mode(handle); });
 
-        return grpc::Status::OK;
+        return reactor.get();
     }
 
-    grpc::Status SubscribeHealth(
-        grpc::ServerContext* /* context */,
-        const mavsdk::rpc::telemetry::SubscribeHealthRequest* /* request */,
-        grpc::ServerWriter<rpc::telemetry::HealthResponse>* writer) override
+    grpc::ServerWriteReactor<rpc::telemetry::HealthResponse>* SubscribeHealth(
+        grpc::CallbackServerContext* context,
+        const mavsdk::rpc::telemetry::SubscribeHealthRequest* /* request */) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
-            return grpc::Status::OK;
-        }
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        auto reactor =
+            StreamReactor<rpc::telemetry::HealthResponse>::create(OutboxPolicy::Conflate);
 
-        auto stream_closed_promise = std::make_shared<std::promise<void>>();
-        auto stream_closed_future = stream_closed_promise->get_future();
-        register_stream_stop_promise(stream_closed_promise);
+        if (plugin == nullptr) {
+            reactor->finish();
+            return reactor.get();
+        }
 
-        auto is_finished = std::make_shared<bool>(false);
-        auto subscribe_mutex = std::make_shared<std::mutex>();
+        _streams.add(reactor);
 
         const mavsdk::Telemetry::HealthHandle handle =
-            _lazy_plugin.maybe_plugin()->subscribe_health(
-                [this, &writer, &stream_closed_promise, is_finished, subscribe_mutex, &handle](
-                    const mavsdk::Telemetry::Health health) {
+            plugin->subscribe_health(
+                [reactor](const mavsdk::Telemetry::Health health) {
                     rpc::telemetry::HealthResponse rpc_response;
 
-                    rpc_response.set_allocated_health(translateToRpcHealth(health).release());
+                    translateToRpcHealth(health, rpc_response.mutable_health());
 
-                    std::unique_lock<std::mutex> lock(*subscribe_mutex);
-                    if (!*is_finished && !writer->Write(rpc_response)) {
-                        _lazy_plugin.maybe_plugin()->unsubscribe_health(handle);
-
-                        *is_finished = true;
-                        unregister_stream_stop_promise(stream_closed_promise);
-                        stream_closed_promise->set_value();
-                    }
+                    reactor->write(std::move(rpc_response));
                 });
 
-        stream_closed_future.wait();
-        std::unique_lock<std::mutex> lock(*subscribe_mutex);
-        *is_finished = true;
+        reactor->set_on_done([plugin, handle]() { plugin->unsubscribe_health(handle); });
 
-        return grpc::Status::OK;
+        return reactor.get();
     }
 
-    grpc::Status SubscribeRcStatus(
-        grpc::ServerContext* /* context */,
-        const mavsdk::rpc::telemetry::SubscribeRcStatusRequest* /* request */,
-        grpc::ServerWriter<rpc::telemetry::RcStatusResponse>* writer) override
+    grpc::ServerWriteReactor<rpc::telemetry::RcStatusResponse>* SubscribeRcStatus(
+        grpc::CallbackServerContext* context,
+        const mavsdk::rpc::telemetry::SubscribeRcStatusRequest* /* request */) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
-            return grpc::Status::OK;
-        }
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
 
-        auto stream_closed_promise = std::make_shared<std::promise<void>>();
-        auto stream_closed_future = stream_closed_promise->get_future();
-        register_stream_stop_promise(stream_closed_promise);
+        auto reactor =
+            StreamReactor<rpc::telemetry::RcStatusResponse>::create(OutboxPolicy::Conflate);
 
-        auto is_finished = std::make_shared<bool>(false);
-        auto subscribe_mutex = std::make_shared<std::mutex>();
+        if (plugin == nullptr) {
+            reactor->finish();
+            return reactor.get();
+        }
+
+        _streams.add(reactor);
 
         const mavsdk::Telemetry::RcStatusHandle handle =
-            _lazy_plugin.maybe_plugin()->subscribe_rc_status(
-                [this, &writer, &stream_closed_promise, is_finished, subscribe_mutex, &handle](
-                    const mavsdk::Telemetry::RcStatus rc_status) {
+            plugin->subscribe_rc_status(
+                [reactor](const mavsdk::Telemetry::RcStatus rc_status) {
                     rpc::telemetry::RcStatusResponse rpc_response;
 
-                    rpc_response.set_allocated_rc_status(
-                        translateToRpcRcStatus(rc_status).release());
-
-                    std::unique_lock<std::mutex> lock(*subscribe_mutex);
-                    if (!*is_finished && !writer->Write(rpc_response)) {
-                        _lazy_plugin.maybe_plugin()->unsubscribe_rc_status(handle);
+                    translateToRpcRcStatus(rc_status, rpc_response.mutable_rc_status());
 
-                        *is_finished = true;
-                        unregister_stream_stop_promise(stream_closed_promise);
-                        stream_closed_promise->set_value();
-                    }
+                    reactor->write(std::move(rpc_response));
                 });
 
-        stream_closed_future.wait();
-        std::unique_lock<std::mutex> lock(*subscribe_mutex);
-        *is_finished = true;
+        reactor->set_on_done([plugin, handle]() { plugin->unsubscribe_rc_status(handle); });
 
-        return grpc::Status::OK;
+        return reactor.get();
     }
 
-    grpc::Status SubscribeStatusText(
-        grpc::ServerContext* /* context */,
-        const mavsdk::rpc::telemetry::SubscribeStatusTextRequest* /* request */,
-        grpc::ServerWriter<rpc::telemetry::StatusTextResponse>* writer) override
+    grpc::ServerWriteReactor<rpc::telemetry::StatusTextResponse>* SubscribeStatusText(
+        grpc::CallbackServerContext* context,
+        const mavsdk::rpc::telemetry::SubscribeStatusTextRequest* /* request */) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
-            return grpc::Status::OK;
-        }
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        auto reactor = StreamReactor<rpc::telemetry::StatusTextResponse>::create();
 
-        auto stream_closed_promise = std::make_shared<std::promise<void>>();
-        auto stream_closed_future = stream_closed_promise->get_future();
-        register_stream_stop_promise(stream_closed_promise);
+        if (plugin == nullptr) {
+            reactor->finish();
+            return reactor.get();
+        }
 
-        auto is_finished = std::make_shared<bool>(false);
-        auto subscribe_mutex = std::make_shared<std::mutex>();
+        _streams.add(reactor);
 
         const mavsdk::Telemetry::StatusTextHandle handle =
-            _lazy_plugin.maybe_plugin()->subscribe_status_text(
-                [this, &writer, &stream_closed_promise, is_finished, subscribe_mutex, &handle](
-                    const mavsdk::Telemetry::StatusText status_text) {
+            plugin->subscribe_status_text(
+                [reactor](const mavsdk::Telemetry::StatusText status_text) {
                     rpc::telemetry::StatusTextResponse rpc_response;
 
-                    rpc_response.set_allocated_status_text(
-                        translateToRpcStatusText(status_text).release());
-
-                    std::unique_lock<std::mutex> lock(*subscribe_mutex);
-                    if (!*is_finished && !writer->Write(rpc_response)) {
-                        _lazy_plugin.maybe_plugin()->unsubscribe_status_text(handle);
+                    translateToRpcStatusText(status_text, rpc_response.mutable_status_text());
 
-                        *is_finished = true;
-                        unregister_stream_stop_promise(stream_closed_promise);
-                        stream_closed_promise->set_value();
-                    }
+                    reactor->write(std::move(rpc_response));
                 });
 
-        stream_closed_future.wait();
-        std::unique_lock<std::mutex> lock(*subscribe_mutex);
-        *is_finished = true;
+        reactor->set_on_done([plugin, handle]() { plugin->unsubscribe_status_text(handle); });
 
-        return grpc::Status::OK;
+        return reactor.get();
     }
 
-    grpc::Status SubscribeActuatorControlTarget(
-        grpc::ServerContext* /* context */,
-        const mavsdk::rpc::telemetry::SubscribeActuatorControlTargetRequest* /* request */,
-        grpc::ServerWriter<rpc::telemetry::ActuatorControlTargetResponse>* writer) override
+    grpc::ServerWriteReactor<rpc::telemetry::ActuatorControlTargetResponse>*
+    SubscribeActuatorControlTarget(
+        grpc::CallbackServerContext* context,
+        const mavsdk::rpc::telemetry::SubscribeActuatorControlTargetRequest* /* request */) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
-            return grpc::Status::OK;
-        }
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
 
-        auto stream_closed_promise = std::make_shared<std::promise<void>>();
-        auto stream_closed_future = stream_closed_promise->get_future();
-        register_stream_stop_promise(stream_closed_promise);
+        auto reactor = StreamReactor<rpc::telemetry::ActuatorControlTargetResponse>::create(
+            OutboxPolicy::Conflate);
 
-        auto is_finished = std::make_shared<bool>(false);
-        auto subscribe_mutex = std::make_shared<std::mutex>();
+        if (plugin == nullptr) {
+            reactor->finish();
+            return reactor.get();
+        }
+
+        _streams.add(reactor);
 
         const mavsdk::Telemetry::ActuatorControlTargetHandle handle =
-            _lazy_plugin.maybe_plugin()->subscribe_actuator_control_target(
-                [this, &writer, &stream_closed_promise, is_finished, subscribe_mutex, &handle](
-                    const mavsdk::Telemetry::ActuatorControlTarget actuator_control_target) {
+            plugin->subscribe_actuator_control_target(
+                [reactor](const mavsdk::Telemetry::ActuatorControlTarget actuator_control_target) {
                     rpc::telemetry::ActuatorControlTargetResponse rpc_response;
 
-                    rpc_response.set_allocated_actuator_control_target(
-                        translateToRpcActuatorControlTarget(actuator_control_target).release());
-
-                    std::unique_lock<std::mutex> lock(*subscribe_mutex);
-                    if (!*is_finished && !writer->Write(rpc_response)) {
-                        _lazy_plugin.maybe_plugin()->unsubscribe_actuator_control_target(handle);
+                    translateToRpcActuatorControlTarget(
+                        actuator_control_target, rpc_response.mutable_actuator_control_target());
 
-                        *is_finished = true;
-                        unregister_stream_stop_promise(stream_closed_promise);
-                        stream_closed_promise->set_value();
-                    }
+                    reactor->write(std::move(rpc_response));
                 });
 
-        stream_closed_future.wait();
-        std::unique_lock<std::mutex> lock(*subscribe_mutex);
-        *is_finished = true;
+        reactor->set_on_done(
+            [plugin, handle]() { plugin->unsubscribe_actuator_control_target(handle); });
 
-        return grpc::Status::OK;
+        return reactor.get();
     }
 
-    grpc::Status SubscribeActuatorOutputStatus(
-        grpc::ServerContext* /* context */,
-        const mavsdk::rpc::telemetry::SubscribeActuatorOutputStatusRequest* /* request */,
-        grpc::ServerWriter<rpc::telemetry::ActuatorOutputStatusResponse>* writer) override
+    grpc::ServerWriteReactor<rpc::telemetry::ActuatorOutputStatusResponse>*
+    SubscribeActuatorOutputStatus(
+        grpc::CallbackServerContext* context,
+        const mavsdk::rpc::telemetry::SubscribeActuatorOutputStatusRequest* /* request */) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
-            return grpc::Status::OK;
-        }
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        auto reactor = StreamReactor<rpc::telemetry::ActuatorOutputStatusResponse>::create(
+            OutboxPolicy::Conflate);
 
-        auto stream_closed_promise = std::make_shared<std::promise<void>>();
-        auto stream_closed_future = stream_closed_promise->get_future();
-        register_stream_stop_promise(stream_closed_promise);
+        if (plugin == nullptr) {
+            reactor->finish();
+            return reactor.get();
+        }
 
-        auto is_finished = std::make_shared<bool>(false);
-        auto subscribe_mutex = std::make_shared<std::mutex>();
+        _streams.add(reactor);
 
         const mavsdk::Telemetry::ActuatorOutputStatusHandle handle =
-            _lazy_plugin.maybe_plugin()->subscribe_actuator_output_status(
-                [this, &writer, &stream_closed_promise, is_finished, subscribe_mutex, &handle](
-                    const mavsdk::Telemetry::ActuatorOutputStatus actuator_output_status) {
+            plugin->subscribe_actuator_output_status(
+                [reactor](const mavsdk::Telemetry::ActuatorOutputStatus actuator_output_status) {
                     rpc::telemetry::ActuatorOutputStatusResponse rpc_response;
 
-                    rpc_response.set_allocated_actuator_output_status(
-                        translateToRpcActuatorOutputStatus(actuator_output_status).release());
+                    translateToRpcActuatorOutputStatus(
+                        actuator_output_status, rpc_response.mutable_actuator_output_status());
 
-                    std::unique_lock<std::mutex> lock(*subscribe_mutex);
-                    if (!*is_finished && !writer->Write(rpc_response)) {
-                        _lazy_plugin.maybe_plugin()->unsubscribe_actuator_output_status(handle);
-
-                        *is_finished = true;
-                        unregister_stream_stop_promise(stream_closed_promise);
-                        stream_closed_promise->set_value();
-                    }
+                    reactor->write(std::move(rpc_response));
                 });
 
-        stream_closed_future.wait();
-        std::unique_lock<std::mutex> lock(*subscribe_mutex);
-        *is_finished = true;
+        reactor->set_on_done(
+            [plugin, handle]() { plugin->unsubscribe_actuator_output_status(handle); });
 
-        return grpc::Status::OK;
+        return reactor.get();
     }
 
-    grpc::Status SubscribeOdometry(
-        grpc::ServerContext* /* context */,
-        const mavsdk::rpc::telemetry::SubscribeOdometryRequest* /* request */,
-        grpc::ServerWriter<rpc::telemetry::OdometryResponse>* writer) override
+    grpc::ServerWriteReactor<rpc::telemetry::OdometryResponse>* SubscribeOdometry(
+        grpc::CallbackServerContext* context,
+        const mavsdk::rpc::telemetry::SubscribeOdometryRequest* /* request */) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
-            return grpc::Status::OK;
-        }
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
 
-        auto stream_closed_promise = std::make_shared<std::promise<void>>();
-        auto stream_closed_future = stream_closed_promise->get_future();
-        register_stream_stop_promise(stream_closed_promise);
+        auto reactor =
+            StreamReactor<rpc::telemetry::OdometryResponse>::create(OutboxPolicy::Conflate);
+
+        if (plugin == nullptr) {
+            reactor->finish();
+            return reactor.get();
+        }
 
-        auto is_finished = std::make_shared<bool>(false);
-        auto subscribe_mutex = std::make_shared<std::mutex>();
+        _streams.add(reactor);
 
         const mavsdk::Telemetry::OdometryHandle handle =
-            _lazy_plugin.maybe_plugin()->subscribe_odometry(
-                [this, &writer, &stream_closed_promise, is_finished, subscribe_mutex, &handle](
-                    const mavsdk::Telemetry::Odometry odometry) {
+            plugin->subscribe_odometry(
+                [reactor](const mavsdk::Telemetry::Odometry odometry) {
                     rpc::telemetry::OdometryResponse rpc_response;
 
-                    rpc_response.set_allocated_odometry(translateToRpcOdometry(odometry).release());
+                    translateToRpcOdometry(odometry, rpc_response.mutable_odometry());
 
-                    std::unique_lock<std::mutex> lock(*subscribe_mutex);
-                    if (!*is_finished && !writer->Write(rpc_response)) {
-                        _lazy_plugin.maybe_plugin()->unsubscribe_odometry(handle);
-
-                        *is_finished = true;
-                        unregister_stream_stop_promise(stream_closed_promise);
-                        stream_closed_promise->set_value();
-                    }
+                    reactor->write(std::move(rpc_response));
                 });
 
-        stream_closed_future.wait();
-        std::unique_lock<std::mutex> lock(*subscribe_mutex);
-        *is_finished = true;
+        reactor->set_on_done([plugin, handle]() { plugin->unsubscribe_odometry(handle); });
 
-        return grpc::Status::OK;
+        return reactor.get();
     }
 
-    grpc::Status SubscribePositionVelocityNed(
-        grpc::ServerContext* /* context */,
-        const mavsdk::rpc::telemetry::SubscribePositionVelocityNedRequest* /* request */,
-        grpc::ServerWriter<rpc::telemetry::PositionVelocityNedResponse>* writer) override
+    grpc::ServerWriteReactor<rpc::telemetry::PositionVelocityNedResponse>*
+    SubscribePositionVelocityNed(
+        grpc::CallbackServerContext* context,
+        const mavsdk::rpc::telemetry::SubscribePositionVelocityNedRequest* /* request */) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
-            return grpc::Status::OK;
-        }
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        auto reactor = StreamReactor<rpc::telemetry::PositionVelocityNedResponse>::create(
+            OutboxPolicy::Conflate);
 
-        auto stream_closed_promise = std::make_shared<std::promise<void>>();
-        auto stream_closed_future = stream_closed_promise->get_future();
-        register_stream_stop_promise(stream_closed_promise);
+        if (plugin == nullptr) {
+            reactor->finish();
+            return reactor.get();
+        }
 
-        auto is_finished = std::make_shared<bool>(false);
-        auto subscribe_mutex = std::make_shared<std::mutex>();
+        _streams.add(reactor);
 
         const mavsdk::Telemetry::PositionVelocityNedHandle handle =
-            _lazy_plugin.maybe_plugin()->subscribe_position_velocity_ned(
-                [this, &writer, &stream_closed_promise, is_finished, subscribe_mutex, &handle](
-                    const mavsdk::Telemetry::PositionVelocityNed position_velocity_ned) {
+            plugin->subscribe_position_velocity_ned(
+                [reactor](const mavsdk::Telemetry::PositionVelocityNed position_velocity_ned) {
                     rpc::telemetry::PositionVelocityNedResponse rpc_response;
 
-                    rpc_response.set_allocated_position_velocity_ned(
-                        translateToRpcPositionVelocityNed(position_velocity_ned).release());
-
-                    std::unique_lock<std::mutex> lock(*subscribe_mutex);
-                    if (!*is_finished && !writer->Write(rpc_response)) {
-                        _lazy_plugin.maybe_plugin()->unsubscribe_position_velocity_ned(handle);
+                    translateToRpcPositionVelocityNed(
+                        position_velocity_ned, rpc_response.mutable_position_velocity_ned());
 
-                        *is_finished = true;
-                        unregister_stream_stop_promise(stream_closed_promise);
-                        stream_closed_promise->set_value();
-                    }
+                    reactor->write(std::move(rpc_response));
                 });
 
-        stream_closed_future.wait();
-        std::unique_lock<std::mutex> lock(*subscribe_mutex);
-        *is_finished = true;
+        reactor->set_on_done(
+            [plugin, handle]() { plugin->unsubscribe_position_velocity_ned(handle); });
 
-        return grpc::Status::OK;
+        return reactor.get();
     }
 
-    grpc::Status SubscribeGroundTruth(
-        grpc::ServerContext* /* context */,
-        const mavsdk::rpc::telemetry::SubscribeGroundTruthRequest* /* request */,
-        grpc::ServerWriter<rpc::telemetry::GroundTruthResponse>* writer) override
+    grpc::ServerWriteReactor<rpc::telemetry::GroundTruthResponse>* SubscribeGroundTruth(
+        grpc::CallbackServerContext* context,
+        const mavsdk::rpc::telemetry::SubscribeGroundTruthRequest* /* request */) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
-            return grpc::Status::OK;
-        }
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
 
-        auto stream_closed_promise = std::make_shared<std::promise<void>>();
-        auto stream_closed_future = stream_closed_promise->get_future();
-        register_stream_stop_promise(stream_closed_promise);
+        auto reactor =
+            StreamReactor<rpc::telemetry::GroundTruthResponse>::create(OutboxPolicy::Conflate);
 
-        auto is_finished = std::make_shared<bool>(false);
-        auto subscribe_mutex = std::make_shared<std::mutex>();
+        if (plugin == nullptr) {
+            reactor->finish();
+            return reactor.get();
+        }
+
+        _streams.add(reactor);
 
         const mavsdk::Telemetry::GroundTruthHandle handle =
-            _lazy_plugin.maybe_plugin()->subscribe_ground_truth(
-                [this, &writer, &stream_closed_promise, is_finished, subscribe_mutex, &handle](
-                    const mavsdk::Telemetry::GroundTruth ground_truth) {
+            plugin->subscribe_ground_truth(
+                [reactor](const mavsdk::Telemetry::GroundTruth ground_truth) {
                     rpc::telemetry::GroundTruthResponse rpc_response;
 
-                    rpc_response.set_allocated_ground_truth(
-                        translateToRpcGroundTruth(ground_truth).release());
-
-                    std::unique_lock<std::mutex> lock(*subscribe_mutex);
-                    if (!*is_finished && !writer->Write(rpc_response)) {
-                        _lazy_plugin.maybe_plugin()->unsubscribe_ground_truth(handle);
+                    translateToRpcGroundTruth(ground_truth, rpc_response.mutable_ground_truth());
 
-                        *is_finished = true;
-                        unregister_stream_stop_promise(stream_closed_promise);
-                        stream_closed_promise->set_value();
-                    }
+                    reactor->write(std::move(rpc_response));
                 });
 
-        stream_closed_future.wait();
-        std::unique_lock<std::mutex> lock(*subscribe_mutex);
-        *is_finished = true;
+        reactor->set_on_done([plugin, handle]() { plugin->unsubscribe_ground_truth(handle); });
 
-        return grpc::Status::OK;
+        return reactor.get();
     }
 
-    grpc::Status SubscribeFixedwingMetrics(
-        grpc::ServerContext* /* context */,
-        const mavsdk::rpc::telemetry::SubscribeFixedwingMetricsRequest* /* request */,
-        grpc::ServerWriter<rpc::telemetry::FixedwingMetricsResponse>* writer) override
+    grpc::ServerWriteReactor<rpc::telemetry::FixedwingMetricsResponse>* SubscribeFixedwingMetrics(
+        grpc::CallbackServerContext* context,
+        const mavsdk::rpc::telemetry::SubscribeFixedwingMetricsRequest* /* request */) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
-            return grpc::Status::OK;
-        }
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        auto reactor =
+            StreamReactor<rpc::telemetry::FixedwingMetricsResponse>::create(OutboxPolicy::Conflate);
 
-        auto stream_closed_promise = std::make_shared<std::promise<void>>();
-        auto stream_closed_future = stream_closed_promise->get_future();
-        register_stream_stop_promise(stream_closed_promise);
+        if (plugin == nullptr) {
+            reactor->finish();
+            return reactor.get();
+        }
 
-        auto is_finished = std::make_shared<bool>(false);
-        auto subscribe_mutex = std::make_shared<std::mutex>();
+        _streams.add(reactor);
 
         const mavsdk::Telemetry::FixedwingMetricsHandle handle =
-            _lazy_plugin.maybe_plugin()->subscribe_fixedwing_metrics(
-                [this, &writer, &stream_closed_promise, is_finished, subscribe_mutex, &handle](
-                    const mavsdk::Telemetry::FixedwingMetrics fixedwing_metrics) {
+            plugin->subscribe_fixedwing_metrics(
+                [reactor](const mavsdk::Telemetry::FixedwingMetrics fixedwing_metrics) {
                     rpc::telemetry::FixedwingMetricsResponse rpc_response;
 
-                    rpc_response.set_allocated_fixedwing_metrics(
-                        translateToRpcFixedwingMetrics(fixedwing_metrics).release());
-
-                    std::unique_lock<std::mutex> lock(*subscribe_mutex);
-                    if (!*is_finished && !writer->Write(rpc_response)) {
-                        _lazy_plugin.maybe_plugin()->unsubscribe_fixedwing_metrics(handle);
+                    translateToRpcFixedwingMetrics(
+                        fixedwing_metrics, rpc_response.mutable_fixedwing_metrics());
 
-                        *is_finished = true;
-                        unregister_stream_stop_promise(stream_closed_promise);
-                        stream_closed_promise->set_value();
-                    }
+                    reactor->write(std::move(rpc_response));
                 });
 
-        stream_closed_future.wait();
-        std::unique_lock<std::mutex> lock(*subscribe_mutex);
-        *is_finished = true;
+        reactor->set_on_done([plugin, handle]() { plugin->unsubscribe_fixedwing_metrics(handle); });
 
-        return grpc::Status::OK;
+        return reactor.get();
     }
 
-    grpc::Status SubscribeImu(
-        grpc::ServerContext* /* context */,
-        const mavsdk::rpc::telemetry::SubscribeImuRequest* /* request */,
-        grpc::ServerWriter<rpc::telemetry::ImuResponse>* writer) override
+    grpc::ServerWriteReactor<rpc::telemetry::ImuResponse>* SubscribeImu(
+        grpc::CallbackServerContext* context,
+        const mavsdk::rpc::telemetry::SubscribeImuRequest* /* request */) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
-            return grpc::Status::OK;
-        }
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
 
-        auto stream_closed_promise = std::make_shared<std::promise<void>>();
-        auto stream_closed_future = stream_closed_promise->get_future();
-        register_stream_stop_promise(stream_closed_promise);
+        auto reactor = StreamReactor<rpc::telemetry::ImuResponse>::create(OutboxPolicy::Conflate);
 
-        auto is_finished = std::make_shared<bool>(false);
-        auto subscribe_mutex = std::make_shared<std::mutex>();
+        if (plugin == nullptr) {
+            reactor->finish();
+            return reactor.get();
+        }
 
-        const mavsdk::Telemetry::ImuHandle handle = _lazy_plugin.maybe_plugin()->subscribe_imu(
-            [this, &writer, &stream_closed_promise, is_finished, subscribe_mutex, &handle](
-                const mavsdk::Telemetry::Imu imu) {
-                rpc::telemetry::ImuResponse rpc_response;
+        _streams.add(reactor);
 
-                rpc_response.set_allocated_imu(translateToRpcImu(imu).release());
+        const mavsdk::Telemetry::ImuHandle handle = plugin->subscribe_imu(
+            [reactor](const mavsdk::Telemetry::Imu imu) {
+                rpc::telemetry::ImuResponse rpc_response;
 
-                std::unique_lock<std::mutex> lock(*subscribe_mutex);
-                if (!*is_finished && !writer->Write(rpc_response)) {
-                    _lazy_plugin.maybe_plugin()->unsubscribe_imu(handle);
+                translateToRpcImu(imu, rpc_response.mutable_imu());
 
-                    *is_finished = true;
-                    unregister_stream_stop_promise(stream_closed_promise);
-                    stream_closed_promise->set_value();
-                }
+                reactor->write(std::move(rpc_response));
             });
 
-        stream_closed_future.wait();
-        std::unique_lock<std::mutex> lock(*subscribe_mutex);
-        *is_finished = true;
+        reactor->set_on_done([plugin, handle]() { plugin->unsubscribe_imu(handle); });
 
-        return grpc::Status::OK;
+        return reactor.get();
     }
 
-    grpc::Status SubscribeScaledImu(
-        grpc::ServerContext* /* context */,
-        const mavsdk::rpc::telemetry::SubscribeScaledImuRequest* /* request */,
-        grpc::ServerWriter<rpc::telemetry::ScaledImuResponse>* writer) override
+    grpc::ServerWriteReactor<rpc::telemetry::ScaledImuResponse>* SubscribeScaledImu(
+        grpc::CallbackServerContext* context,
+        const mavsdk::rpc::telemetry::SubscribeScaledImuRequest* /* request */) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
-            return grpc::Status::OK;
-        }
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
 
-        auto stream_closed_promise = std::make_shared<std::promise<void>>();
-        auto stream_closed_future = stream_closed_promise->get_future();
-        register_stream_stop_promise(stream_closed_promise);
+        auto reactor =
+            StreamReactor<rpc::telemetry::ScaledImuResponse>::create(OutboxPolicy::Conflate);
 
-        auto is_finished = std::make_shared<bool>(false);
-        auto subscribe_mutex = std::make_shared<std::mutex>();
+        if (plugin == nullptr) {
+            reactor->finish();
+            return reactor.get();
+        }
+
+        _streams.add(reactor);
 
         const mavsdk::Telemetry::ScaledImuHandle handle =
-            _lazy_plugin.maybe_plugin()->subscribe_scaled_imu(
-                [this, &writer, &stream_closed_promise, is_finished, subscribe_mutex, &handle](
-                    const mavsdk::Telemetry::Imu scaled_imu) {
+            plugin->subscribe_scaled_imu(
+                [reactor](const mavsdk::Telemetry::Imu scaled_imu) {
                     rpc::telemetry::ScaledImuResponse rpc_response;
 
-                    rpc_response.set_allocated_imu(translateToRpcImu(scaled_imu).release());
-
-                    std::unique_lock<std::mutex> lock(*subscribe_mutex);
-                    if (!*is_finished && !writer->Write(rpc_response)) {
-                        _lazy_plugin.maybe_plugin()->unsubscribe_scaled_imu(handle);
+                    translateToRpcImu(scaled_imu, rpc_response.mutable_imu());
 
-                        *is_finished = true;
-                        unregister_stream_stop_promise(stream_closed_promise);
-                        stream_closed_promise->set_value();
-                    }
+                    reactor->write(std::move(rpc_response));
                 });
 
-        stream_closed_future.wait();
-        std::unique_lock<std::mutex> lock(*subscribe_mutex);
-        *is_finished = true;
+        reactor->set_on_done([plugin, handle]() { plugin->unsubscribe_scaled_imu(handle); });
 
-        return grpc::Status::OK;
+        return reactor.get();
     }
 
-    grpc::Status SubscribeRawImu(
-        grpc::ServerContext* /* context */,
-        const mavsdk::rpc::telemetry::SubscribeRawImuRequest* /* request */,
-        grpc::ServerWriter<rpc::telemetry::RawImuResponse>* writer) override
+    grpc::ServerWriteReactor<rpc::telemetry::RawImuResponse>* SubscribeRawImu(
+        grpc::CallbackServerContext* context,
+        const mavsdk::rpc::telemetry::SubscribeRawImuRequest* /* request */) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
-            return grpc::Status::OK;
-        }
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
 
-        auto stream_closed_promise = std::make_shared<std::promise<void>>();
-        auto stream_closed_future = stream_closed_promise->get_future();
-        register_stream_stop_promise(stream_closed_promise);
+        auto reactor =
+            StreamReactor<rpc::telemetry::RawImuResponse>::create(OutboxPolicy::Conflate);
 
-        auto is_finished = std::make_shared<bool>(false);
-        auto subscribe_mutex = std::make_shared<std::mutex>();
+        if (plugin == nullptr) {
+            reactor->finish();
+            return reactor.get();
+        }
+
+        _streams.add(reactor);
 
         const mavsdk::Telemetry::RawImuHandle handle =
-            _lazy_plugin.maybe_plugin()->subscribe_raw_imu(
-                [this, &writer, &stream_closed_promise, is_finished, subscribe_mutex, &handle](
-                    const mavsdk::Telemetry::Imu raw_imu) {
+            plugin->subscribe_raw_imu(
+                [reactor](const mavsdk::Telemetry::Imu raw_imu) {
                     rpc::telemetry::RawImuResponse rpc_response;
 
-                    rpc_response.set_allocated_imu(translateToRpcImu(raw_imu).release());
+                    translateToRpcImu(raw_imu, rpc_response.mutable_imu());
 
-                    std::unique_lock<std::mutex> lock(*subscribe_mutex);
-                    if (!*is_finished && !writer->Write(rpc_response)) {
-                        _lazy_plugin.maybe_plugin()->unsubscribe_raw_imu(handle);
-
-                        *is_finished = true;
-                        unregister_stream_stop_promise(stream_closed_promise);
-                        stream_closed_promise->set_value();
-                    }
+                    reactor->write(std::move(rpc_response));
                 });
 
-        stream_closed_future.wait();
-        std::unique_lock<std::mutex> lock(*subscribe_mutex);
-        *is_finished = true;
+        reactor->set_on_done([plugin, handle]() { plugin->unsubscribe_raw_imu(handle); });
 
-        return grpc::Status::OK;
+        return reactor.get();
     }
 
-    grpc::Status SubscribeHealthAllOk(
-        grpc::ServerContext* /* context */,
-        const mavsdk::rpc::telemetry::SubscribeHealthAllOkRequest* /* request */,
-        grpc::ServerWriter<rpc::telemetry::HealthAllOkResponse>* writer) override
+    grpc::ServerWriteReactor<rpc::telemetry::HealthAllOkResponse>* SubscribeHealthAllOk(
+        grpc::CallbackServerContext* context,
+        const mavsdk::rpc::telemetry::SubscribeHealthAllOkRequest* /* request */) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
-            return grpc::Status::OK;
-        }
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
 
-        auto stream_closed_promise = std::make_shared<std::promise<void>>();
-        auto stream_closed_future = stream_closed_promise->get_future();
-        register_stream_stop_promise(stream_closed_promise);
+        auto reactor =
+            StreamReactor<rpc::telemetry::HealthAllOkResponse>::create(OutboxPolicy::Conflate);
 
-        auto is_finished = std::make_shared<bool>(false);
-        auto subscribe_mutex = std::make_shared<std::mutex>();
+        if (plugin == nullptr) {
+            reactor->finish();
+            return reactor.get();
+        }
+
+        _streams.add(reactor);
 
         const mavsdk::Telemetry::HealthAllOkHandle handle =
-            _lazy_plugin.maybe_plugin()->subscribe_health_all_ok(
-                [this, &writer, &stream_closed_promise, is_finished, subscribe_mutex, &handle](
-                    const bool health_all_ok) {
+            plugin->subscribe_health_all_ok(
+                [reactor](const bool health_all_ok) {
                     rpc::telemetry::HealthAllOkResponse rpc_response;
 
                     rpc_response.set_is_health_all_ok(health_all_ok);
 
-                    std::unique_lock<std::mutex> lock(*subscribe_mutex);
-                    if (!*is_finished && !writer->Write(rpc_response)) {
-                        _lazy_plugin.maybe_plugin()->unsubscribe_health_all_ok(handle);
-
-                        *is_finished = true;
-                        unregister_stream_stop_promise(stream_closed_promise);
-                        stream_closed_promise->set_value();
-                    }
+                    reactor->write(std::move(rpc_response));
                 });
 
-        stream_closed_future.wait();
-        std::unique_lock<std::mutex> lock(*subscribe_mutex);
-        *is_finished = true;
+        reactor->set_on_done([plugin, handle]() { plugin->unsubscribe_health_all_ok(handle); });
 
-        return grpc::Status::OK;
+        return reactor.get();
     }
 
-    grpc::Status SubscribeUnixEpochTime(
-        grpc::ServerContext* /* context */,
-        const mavsdk::rpc::telemetry::SubscribeUnixEpochTimeRequest* /* request */,
-        grpc::ServerWriter<rpc::telemetry::UnixEpochTimeResponse>* writer) override
+    grpc::ServerWriteReactor<rpc::telemetry::UnixEpochTimeResponse>* SubscribeUnixEpochTime(
+        grpc::CallbackServerContext* context,
+        const mavsdk::rpc::telemetry::SubscribeUnixEpochTimeRequest* /* request */) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
-            return grpc::Status::OK;
-        }
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
 
-        auto stream_closed_promise = std::make_shared<std::promise<void>>();
-        auto stream_closed_future = stream_closed_promise->get_future();
-        register_stream_stop_promise(stream_closed_promise);
+        auto reactor =
+            StreamReactor<rpc::telemetry::UnixEpochTimeResponse>::create(OutboxPolicy::Conflate);
+
+        if (plugin == nullptr) {
+            reactor->finish();
+            return reactor.get();
+        }
 
-        auto is_finished = std::make_shared<bool>(false);
-        auto subscribe_mutex = std::make_shared<std::mutex>();
+        _streams.add(reactor);
 
         const mavsdk::Telemetry::UnixEpochTimeHandle handle =
-            _lazy_plugin.maybe_plugin()->subscribe_unix_epoch_time(
-                [this, &writer, &stream_closed_promise, is_finished, subscribe_mutex, &handle](
-                    const uint64_t unix_epoch_time) {
+            plugin->subscribe_unix_epoch_time(
+                [reactor](const uint64_t unix_epoch_time) {
                     rpc::telemetry::UnixEpochTimeResponse rpc_response;
 
                     rpc_response.set_time_us(unix_epoch_time);
 
-                    std::unique_lock<std::mutex> lock(*subscribe_mutex);
-                    if (!*is_finished && !writer->Write(rpc_response)) {
-                        _lazy_plugin.maybe_plugin()->unsubscribe_unix_epoch_time(handle);
-
-                        *is_finished = true;
-                        unregister_stream_stop_promise(stream_closed_promise);
-                        stream_closed_promise->set_value();
-                    }
+                    reactor->write(std::move(rpc_response));
                 });
 
-        stream_closed_future.wait();
-        std::unique_lock<std::mutex> lock(*subscribe_mutex);
-        *is_finished = true;
+        reactor->set_on_done([plugin, handle]() { plugin->unsubscribe_unix_epoch_time(handle); });
 
-        return grpc::Status::OK;
+        return reactor.get();
     }
 
-    grpc::Status SubscribeDistanceSensor(
-        grpc::ServerContext* /* context */,
-        const mavsdk::rpc::telemetry::SubscribeDistanceSensorRequest* /* request */,
-        grpc::ServerWriter<rpc::telemetry::DistanceSensorResponse>* writer) override
+    grpc::ServerWriteReactor<rpc::telemetry::DistanceSensorResponse>* SubscribeDistanceSensor(
+        grpc::CallbackServerContext* context,
+        const mavsdk::rpc::telemetry::SubscribeDistanceSensorRequest* /* request */) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
-            return grpc::Status::OK;
-        }
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
 
-        auto stream_closed_promise = std::make_shared<std::promise<void>>();
-        auto stream_closed_future = stream_closed_promise->get_future();
-        register_stream_stop_promise(stream_closed_promise);
+        auto reactor =
+            StreamReactor<rpc::telemetry::DistanceSensorResponse>::create(OutboxPolicy::Conflate);
 
-        auto is_finished = std::make_shared<bool>(false);
-        auto subscribe_mutex = std::make_shared<std::mutex>();
+        if (plugin == nullptr) {
+            reactor->finish();
+            return reactor.get();
+        }
+
+        _streams.add(reactor);
 
         const mavsdk::Telemetry::DistanceSensorHandle handle =
-            _lazy_plugin.maybe_plugin()->subscribe_distance_sensor(
-                [this, &writer, &stream_closed_promise, is_finished, subscribe_mutex, &handle](
-                    const mavsdk::Telemetry::DistanceSensor distance_sensor) {
+            plugin->subscribe_distance_sensor(
+                [reactor](const mavsdk::Telemetry::DistanceSensor distance_sensor) {
                     rpc::telemetry::DistanceSensorResponse rpc_response;
 
-                    rpc_response.set_allocated_distance_sensor(
-                        translateToRpcDistanceSensor(distance_sensor).release());
-
-                    std::unique_lock<std::mutex> lock(*subscribe_mutex);
-                    if (!*is_finished && !writer->Write(rpc_response)) {
-                        _lazy_plugin.maybe_plugin()->unsubscribe_distance_sensor(handle);
+                    translateToRpcDistanceSensor(
+                        distance_sensor, rpc_response.mutable_distance_sensor());
 
-                        *is_finished = true;
-                        unregister_stream_stop_promise(stream_closed_promise);
-                        stream_closed_promise->set_value();
-                    }
+                    reactor->write(std::move(rpc_response));
                 });
 
-        stream_closed_future.wait();
-        std::unique_lock<std::mutex> lock(*subscribe_mutex);
-        *is_finished = true;
+        reactor->set_on_done([plugin, handle]() { plugin->unsubscribe_distance_sensor(handle); });
 
-        return grpc::Status::OK;
+        return reactor.get();
     }
 
-    grpc::Status SubscribeScaledPressure(
-        grpc::ServerContext* /* context */,
-        const mavsdk::rpc::telemetry::SubscribeScaledPressureRequest* /* request */,
-        grpc::ServerWriter<rpc::telemetry::ScaledPressureResponse>* writer) override
+    grpc::ServerWriteReactor<rpc::telemetry::ScaledPressureResponse>* SubscribeScaledPressure(
+        grpc::CallbackServerContext* context,
+        const mavsdk::rpc::telemetry::SubscribeScaledPressureRequest* /* request */) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
-            return grpc::Status::OK;
-        }
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        auto reactor =
+            StreamReactor<rpc::telemetry::ScaledPressureResponse>::create(OutboxPolicy::Conflate);
 
-        auto stream_closed_promise = std::make_shared<std::promise<void>>();
-        auto stream_closed_future = stream_closed_promise->get_future();
-        register_stream_stop_promise(stream_closed_promise);
+        if (plugin == nullptr) {
+            reactor->finish();
+            return reactor.get();
+        }
 
-        auto is_finished = std::make_shared<bool>(false);
-        auto subscribe_mutex = std::make_shared<std::mutex>();
+        _streams.add(reactor);
 
         const mavsdk::Telemetry::ScaledPressureHandle handle =
-            _lazy_plugin.maybe_plugin()->subscribe_scaled_pressure(
-                [this, &writer, &stream_closed_promise, is_finished, subscribe_mutex, &handle](
-                    const mavsdk::Telemetry::ScaledPressure scaled_pressure) {
+            plugin->subscribe_scaled_pressure(
+                [reactor](const mavsdk::Telemetry::ScaledPressure scaled_pressure) {
                     rpc::telemetry::ScaledPressureResponse rpc_response;
 
-                    rpc_response.set_allocated_scaled_pressure(
-                        translateToRpcScaledPressure(scaled_pressure).release());
+                    translateToRpcScaledPressure(
+                        scaled_pressure, rpc_response.mutable_scaled_pressure());
 
-                    std::unique_lock<std::mutex> lock(*subscribe_mutex);
-                    if (!*is_finished && !writer->Write(rpc_response)) {
-                        _lazy_plugin.maybe_plugin()->unsubscribe_scaled_pressure(handle);
-
-                        *is_finished = true;
-                        unregister_stream_stop_promise(stream_closed_promise);
-                        stream_closed_promise->set_value();
-                    }
+                    reactor->write(std::move(rpc_response));
                 });
 
-        stream_closed_future.wait();
-        std::unique_lock<std::mutex> lock(*subscribe_mutex);
-        *is_finished = true;
+        reactor->set_on_done([plugin, handle]() { plugin->unsubscribe_scaled_pressure(handle); });
 
-        return grpc::Status::OK;
+        return reactor.get();
     }
 
-    grpc::Status SubscribeHeading(
-        grpc::ServerContext* /* context */,
-        const mavsdk::rpc::telemetry::SubscribeHeadingRequest* /* request */,
-        grpc::ServerWriter<rpc::telemetry::HeadingResponse>* writer) override
+    grpc::ServerWriteReactor<rpc::telemetry::HeadingResponse>* SubscribeHeading(
+        grpc::CallbackServerContext* context,
+        const mavsdk::rpc::telemetry::SubscribeHeadingRequest* /* request */) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
-            return grpc::Status::OK;
-        }
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
 
-        auto stream_closed_promise = std::make_shared<std::promise<void>>();
-        auto stream_closed_future = stream_closed_promise->get_future();
-        register_stream_stop_promise(stream_closed_promise);
+        auto reactor =
+            StreamReactor<rpc::telemetry::HeadingResponse>::create(OutboxPolicy::Conflate);
 
-        auto is_finished = std::make_shared<bool>(false);
-        auto subscribe_mutex = std::make_shared<std::mutex>();
+        if (plugin == nullptr) {
+            reactor->finish();
+            return reactor.get();
+        }
+
+        _streams.add(reactor);
 
         const mavsdk::Telemetry::HeadingHandle handle =
-            _lazy_plugin.maybe_plugin()->subscribe_heading(
-                [this, &writer, &stream_closed_promise, is_finished, subscribe_mutex, &handle](
-                    const mavsdk::Telemetry::Heading heading) {
+            plugin->subscribe_heading(
+                [reactor](const mavsdk::Telemetry::Heading heading) {
                     rpc::telemetry::HeadingResponse rpc_response;
 
-                    rpc_response.set_allocated_heading_deg(
-                        translateToRpcHeading(heading).release());
-
-                    std::unique_lock<std::mutex> lock(*subscribe_mutex);
-                    if (!*is_finished && !writer->Write(rpc_response)) {
-                        _lazy_plugin.maybe_plugin()->unsubscribe_heading(handle);
+                    translateToRpcHeading(heading, rpc_response.mutable_heading_deg());
 
-                        *is_finished = true;
-                        unregister_stream_stop_promise(stream_closed_promise);
-                        stream_closed_promise->set_value();
-                    }
+                    reactor->write(std::move(rpc_response));
                 });
 
-        stream_closed_future.wait();
-        std::unique_lock<std::mutex> lock(*subscribe_mutex);
-        *is_finished = true;
+        reactor->set_on_done([plugin, handle]() { plugin->unsubscribe_heading(handle); });
 
-        return grpc::Status::OK;
+        return reactor.get();
     }
 
-    grpc::Status SubscribeAltitude(
-        grpc::ServerContext* /* context */,
-        const mavsdk::rpc::telemetry::SubscribeAltitudeRequest* /* request */,
-        grpc::ServerWriter<rpc::telemetry::AltitudeResponse>* writer) override
+    grpc::ServerWriteReactor<rpc::telemetry::AltitudeResponse>* SubscribeAltitude(
+        grpc::CallbackServerContext* context,
+        const mavsdk::rpc::telemetry::SubscribeAltitudeRequest* /* request */) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
-            return grpc::Status::OK;
-        }
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
 
-        auto stream_closed_promise = std::make_shared<std::promise<void>>();
-        auto stream_closed_future = stream_closed_promise->get_future();
-        register_stream_stop_promise(stream_closed_promise);
+        auto reactor =
+            StreamReactor<rpc::telemetry::AltitudeResponse>::create(OutboxPolicy::Conflate);
+
+        if (plugin == nullptr) {
+            reactor->finish();
+            return reactor.get();
+        }
 
-        auto is_finished = std::make_shared<bool>(false);
-        auto subscribe_mutex = std::make_shared<std::mutex>();
+        _streams.add(reactor);
 
         const mavsdk::Telemetry::AltitudeHandle handle =
-            _lazy_plugin.maybe_plugin()->subscribe_altitude(
-                [this, &writer, &stream_closed_promise, is_finished, subscribe_mutex, &handle](
-                    const mavsdk::Telemetry::Altitude altitude) {
+            plugin->subscribe_altitude(
+                [reactor](const mavsdk::Telemetry::Altitude altitude) {
                     rpc::telemetry::AltitudeResponse rpc_response;
 
-                    rpc_response.set_allocated_altitude(translateToRpcAltitude(altitude).release());
+                    translateToRpcAltitude(altitude, rpc_response.mutable_altitude());
 
-                    std::unique_lock<std::mutex> lock(*subscribe_mutex);
-                    if (!*is_finished && !writer->Write(rpc_response)) {
-                        _lazy_plugin.maybe_plugin()->unsubscribe_altitude(handle);
-
-                        *is_finished = true;
-                        unregister_stream_stop_promise(stream_closed_promise);
-                        stream_closed_promise->set_value();
-                    }
+                    reactor->write(std::move(rpc_response));
                 });
 
-        stream_closed_future.wait();
-        std::unique_lock<std::mutex> lock(*subscribe_mutex);
-        *is_finished = true;
+        reactor->set_on_done([plugin, handle]() { plugin->unsubscribe_altitude(handle); });
 
-        return grpc::Status::OK;
+        return reactor.get();
     }
 
     grpc::Status SetRatePosition(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::telemetry::SetRatePositionRequest* request,
         rpc::telemetry::SetRatePositionResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Telemetry::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -2783,7 +2370,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->set_rate_position(request->rate_hz());
+        auto result = plugin->set_rate_position(request->rate_hz());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -2793,11 +2380,13 @@ public:
     }
 
     grpc::Status SetRateHome(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::telemetry::SetRateHomeRequest* request,
         rpc::telemetry::SetRateHomeResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Telemetry::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -2811,7 +2400,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->set_rate_home(request->rate_hz());
+        auto result = plugin->set_rate_home(request->rate_hz());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -2821,11 +2410,13 @@ public:
     }
 
     grpc::Status SetRateInAir(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::telemetry::SetRateInAirRequest* request,
         rpc::telemetry::SetRateInAirResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Telemetry::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -2839,7 +2430,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->set_rate_in_air(request->rate_hz());
+        auto result = plugin->set_rate_in_air(request->rate_hz());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -2849,11 +2440,13 @@ public:
     }
 
     grpc::Status SetRateLandedState(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::telemetry::SetRateLandedStateRequest* request,
         rpc::telemetry::SetRateLandedStateResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Telemetry::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -2867,7 +2460,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->set_rate_landed_state(request->rate_hz());
+        auto result = plugin->set_rate_landed_state(request->rate_hz());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -2877,11 +2470,13 @@ public:
     }
 
     grpc::Status SetRateVtolState(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::telemetry::SetRateVtolStateRequest* request,
         rpc::telemetry::SetRateVtolStateResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Telemetry::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -2895,7 +2490,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->set_rate_vtol_state(request->rate_hz());
+        auto result = plugin->set_rate_vtol_state(request->rate_hz());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -2905,11 +2500,13 @@ public:
     }
 
     grpc::Status SetRateAttitudeQuaternion(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::telemetry::SetRateAttitudeQuaternionRequest* request,
         rpc::telemetry::SetRateAttitudeQuaternionResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Telemetry::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -2923,7 +2520,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->set_rate_attitude_quaternion(request->rate_hz());
+        auto result = plugin->set_rate_attitude_quaternion(request->rate_hz());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -2933,11 +2530,13 @@ public:
     }
 
     grpc::Status SetRateAttitudeEuler(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::telemetry::SetRateAttitudeEulerRequest* request,
         rpc::telemetry::SetRateAttitudeEulerResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Telemetry::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -2951,7 +2550,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->set_rate_attitude_euler(request->rate_hz());
+        auto result = plugin->set_rate_attitude_euler(request->rate_hz());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -2961,11 +2560,13 @@ public:
     }
 
     grpc::Status SetRateCameraAttitude(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::telemetry::SetRateCameraAttitudeRequest* request,
         rpc::telemetry::SetRateCameraAttitudeResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Telemetry::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -2979,7 +2580,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->set_rate_camera_attitude(request->rate_hz());
+        auto result = plugin->set_rate_camera_attitude(request->rate_hz());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -2989,11 +2590,13 @@ public:
     }
 
     grpc::Status SetRateVelocityNed(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::telemetry::SetRateVelocityNedRequest* request,
         rpc::telemetry::SetRateVelocityNedResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Telemetry::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -3007,7 +2610,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->set_rate_velocity_ned(request->rate_hz());
+        auto result = plugin->set_rate_velocity_ned(request->rate_hz());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -3017,11 +2620,13 @@ public:
     }
 
     grpc::Status SetRateGpsInfo(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::telemetry::SetRateGpsInfoRequest* request,
         rpc::telemetry::SetRateGpsInfoResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Telemetry::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -3035,7 +2640,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->set_rate_gps_info(request->rate_hz());
+        auto result = plugin->set_rate_gps_info(request->rate_hz());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -3045,11 +2650,13 @@ public:
     }
 
     grpc::Status SetRateBattery(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::telemetry::SetRateBatteryRequest* request,
         rpc::telemetry::SetRateBatteryResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Telemetry::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -3063,7 +2670,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->set_rate_battery(request->rate_hz());
+        auto result = plugin->set_rate_battery(request->rate_hz());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -3073,11 +2680,13 @@ public:
     }
 
     grpc::Status SetRateRcStatus(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::telemetry::SetRateRcStatusRequest* request,
         rpc::telemetry::SetRateRcStatusResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Telemetry::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -3091,7 +2700,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->set_rate_rc_status(request->rate_hz());
+        auto result = plugin->set_rate_rc_status(request->rate_hz());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -3101,11 +2710,13 @@ public:
     }
 
     grpc::Status SetRateActuatorControlTarget(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::telemetry::SetRateActuatorControlTargetRequest* request,
         rpc::telemetry::SetRateActuatorControlTargetResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Telemetry::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -3120,7 +2731,7 @@ public:
         }
 
         auto result =
-            _lazy_plugin.maybe_plugin()->set_rate_actuator_control_target(request->rate_hz());
+            plugin->set_rate_actuator_control_target(request->rate_hz());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -3130,11 +2741,13 @@ public:
     }
 
     grpc::Status SetRateActuatorOutputStatus(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::telemetry::SetRateActuatorOutputStatusRequest* request,
         rpc::telemetry::SetRateActuatorOutputStatusResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Telemetry::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -3149,7 +2762,7 @@ public:
         }
 
         auto result =
-            _lazy_plugin.maybe_plugin()->set_rate_actuator_output_status(request->rate_hz());
+            plugin->set_rate_actuator_output_status(request->rate_hz());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -3159,11 +2772,13 @@ public:
     }
 
     grpc::Status SetRateOdometry(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::telemetry::SetRateOdometryRequest* request,
         rpc::telemetry::SetRateOdometryResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Telemetry::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -3177,7 +2792,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->set_rate_odometry(request->rate_hz());
+        auto result = plugin->set_rate_odometry(request->rate_hz());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -3187,11 +2802,13 @@ public:
     }
 
     grpc::Status SetRatePositionVelocityNed(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::telemetry::SetRatePositionVelocityNedRequest* request,
         rpc::telemetry::SetRatePositionVelocityNedResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Telemetry::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -3206,7 +2823,7 @@ public:
         }
 
         auto result =
-            _lazy_plugin.maybe_plugin()->set_rate_position_velocity_ned(request->rate_hz());
+            plugin->set_rate_position_velocity_ned(request->rate_hz());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -3216,11 +2833,13 @@ public:
     }
 
     grpc::Status SetRateGroundTruth(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::telemetry::SetRateGroundTruthRequest* request,
         rpc::telemetry::SetRateGroundTruthResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Telemetry::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -3234,7 +2853,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->set_rate_ground_truth(request->rate_hz());
+        auto result = plugin->set_rate_ground_truth(request->rate_hz());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -3244,11 +2863,13 @@ public:
     }
 
     grpc::Status SetRateFixedwingMetrics(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::telemetry::SetRateFixedwingMetricsRequest* request,
         rpc::telemetry::SetRateFixedwingMetricsResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Telemetry::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -3262,7 +2883,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->set_rate_fixedwing_metrics(request->rate_hz());
+        auto result = plugin->set_rate_fixedwing_metrics(request->rate_hz());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -3272,11 +2893,13 @@ public:
     }
 
     grpc::Status SetRateImu(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::telemetry::SetRateImuRequest* request,
         rpc::telemetry::SetRateImuResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Telemetry::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -3290,7 +2913,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->set_rate_imu(request->rate_hz());
+        auto result = plugin->set_rate_imu(request->rate_hz());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -3300,11 +2923,13 @@ public:
     }
 
     grpc::Status SetRateScaledImu(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::telemetry::SetRateScaledImuRequest* request,
         rpc::telemetry::SetRateScaledImuResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Telemetry::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -3318,7 +2943,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->set_rate_scaled_imu(request->rate_hz());
+        auto result = plugin->set_rate_scaled_imu(request->rate_hz());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -3328,11 +2953,13 @@ public:
     }
 
     grpc::Status SetRateRawImu(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::telemetry::SetRateRawImuRequest* request,
         rpc::telemetry::SetRateRawImuResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Telemetry::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -3346,7 +2973,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->set_rate_raw_imu(request->rate_hz());
+        auto result = plugin->set_rate_raw_imu(request->rate_hz());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -3356,11 +2983,13 @@ public:
     }
 
     grpc::Status SetRateUnixEpochTime(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::telemetry::SetRateUnixEpochTimeRequest* request,
         rpc::telemetry::SetRateUnixEpochTimeResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Telemetry::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -3374,7 +3003,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->set_rate_unix_epoch_time(request->rate_hz());
+        auto result = plugin->set_rate_unix_epoch_time(request->rate_hz());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -3384,11 +3013,13 @@ public:
     }
 
     grpc::Status SetRateDistanceSensor(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::telemetry::SetRateDistanceSensorRequest* request,
         rpc::telemetry::SetRateDistanceSensorResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Telemetry::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -3402,7 +3033,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->set_rate_distance_sensor(request->rate_hz());
+        auto result = plugin->set_rate_distance_sensor(request->rate_hz());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -3412,11 +3043,13 @@ public:
     }
 
     grpc::Status SetRateAltitude(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::telemetry::SetRateAltitudeRequest* request,
         rpc::telemetry::SetRateAltitudeResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Telemetry::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -3430,7 +3063,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->set_rate_altitude(request->rate_hz());
+        auto result = plugin->set_rate_altitude(request->rate_hz());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -3440,11 +3073,13 @@ public:
     }
 
     grpc::Status GetGpsGlobalOrigin(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::telemetry::GetGpsGlobalOriginRequest* /* request */,
         rpc::telemetry::GetGpsGlobalOriginResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Telemetry::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -3453,57 +3088,25 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->get_gps_global_origin();
+        auto result = plugin->get_gps_global_origin();
 
         if (response != nullptr) {
             fillResponseWithResult(response, result.first);
 
-            response->set_allocated_gps_global_origin(
-                translateToRpcGpsGlobalOrigin(result.second).release());
+            translateToRpcGpsGlobalOrigin(result.second, response->mutable_gps_global_origin());
         }
 
         return grpc::Status::OK;
     }
 
-    void stop()
-    {
-        _stopped.store(true);
-        for (auto& prom : _stream_stop_promises) {
-            if (auto handle = prom.lock()) {
-                handle->set_value();
-            }
-        }
-    }
+    void stop() { _streams.finish_all(); }
 
-private:
-    void register_stream_stop_promise(std::weak_ptr<std::promise<void>> prom)
-    {
-        // If we have already stopped, set promise immediately and don't add it to list.
-        if (_stopped.load()) {
-            if (auto handle = prom.lock()) {
-                handle->set_value();
-            }
-        } else {
-            _stream_stop_promises.push_back(prom);
-        }
-    }
-
-    void unregister_stream_stop_promise(std::shared_ptr<std::promise<void>> prom)
-    {
-        for (auto it = _stream_stop_promises.begin(); it != _stream_stop_promises.end();
-             /* ++it */) {
-            if (it->lock() == prom) {
-                it = _stream_stop_promises.erase(it);
-            } else {
-                ++it;
-            }
-        }
-    }
+    const StreamStats& stream_stats() const { return _streams.stats(); }
 
+private:
     LazyPlugin& _lazy_plugin;
 
-    std::atomic<bool> _stopped{false};
-    std::vector<std::weak_ptr<std::promise<void>>> _stream_stop_promises{};
+    StreamList _streams{};
 };
 
 } // namespace mavsdk_server
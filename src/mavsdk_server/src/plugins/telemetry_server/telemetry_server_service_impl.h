@@ -11,6 +11,8 @@
 #include "lazy_server_plugin.h"
 
 #include "log.h"
+#include "stream_reactor.h"
+#include "system_selection.h"
 #include <atomic>
 #include <cmath>
 #include <future>
@@ -27,7 +29,7 @@ template<
     typename LazyServerPlugin = LazyServerPlugin<TelemetryServer>>
 
 class TelemetryServerServiceImpl final
-    : public rpc::telemetry_server::TelemetryServerService::Service {
+    : public WithCallbackMethods<rpc::telemetry_server::TelemetryServerService::Service> {
 public:
     TelemetryServerServiceImpl(LazyServerPlugin& lazy_plugin) : _lazy_plugin(lazy_plugin) {}
 
@@ -37,13 +39,11 @@ public:
     {
         auto rpc_result = translateToRpcResult(result);
 
-        auto* rpc_telemetry_server_result = new rpc::telemetry_server::TelemetryServerResult();
+        auto* rpc_telemetry_server_result = response->mutable_telemetry_server_result();
         rpc_telemetry_server_result->set_result(rpc_result);
         std::stringstream ss;
         ss << result;
         rpc_telemetry_server_result->set_result_str(ss.str());
-
-        response->set_allocated_telemetry_server_result(rpc_telemetry_server_result);
     }
 
     static rpc::telemetry_server::FixType
@@ -228,11 +228,9 @@ public:
         }
     }
 
-    static std::unique_ptr<rpc::telemetry_server::Position>
-    translateToRpcPosition(const mavsdk::TelemetryServer::Position& position)
+    static void translateToRpcPosition(
+        const mavsdk::TelemetryServer::Position& position, rpc::telemetry_server::Position* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::telemetry_server::Position>();
-
         rpc_obj->set_latitude_deg(position.latitude_deg);
 
         rpc_obj->set_longitude_deg(position.longitude_deg);
@@ -240,8 +238,6 @@ public:
         rpc_obj->set_absolute_altitude_m(position.absolute_altitude_m);
 
         rpc_obj->set_relative_altitude_m(position.relative_altitude_m);
-
-        return rpc_obj;
     }
 
     static mavsdk::TelemetryServer::Position
@@ -260,14 +256,10 @@ public:
         return obj;
     }
 
-    static std::unique_ptr<rpc::telemetry_server::Heading>
-    translateToRpcHeading(const mavsdk::TelemetryServer::Heading& heading)
+    static void translateToRpcHeading(
+        const mavsdk::TelemetryServer::Heading& heading, rpc::telemetry_server::Heading* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::telemetry_server::Heading>();
-
         rpc_obj->set_heading_deg(heading.heading_deg);
-
-        return rpc_obj;
     }
 
     static mavsdk::TelemetryServer::Heading
@@ -280,11 +272,10 @@ public:
         return obj;
     }
 
-    static std::unique_ptr<rpc::telemetry_server::Quaternion>
-    translateToRpcQuaternion(const mavsdk::TelemetryServer::Quaternion& quaternion)
+    static void translateToRpcQuaternion(
+        const mavsdk::TelemetryServer::Quaternion& quaternion,
+        rpc::telemetry_server::Quaternion* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::telemetry_server::Quaternion>();
-
         rpc_obj->set_w(quaternion.w);
 
         rpc_obj->set_x(quaternion.x);
@@ -294,8 +285,6 @@ public:
         rpc_obj->set_z(quaternion.z);
 
         rpc_obj->set_timestamp_us(quaternion.timestamp_us);
-
-        return rpc_obj;
     }
 
     static mavsdk::TelemetryServer::Quaternion
@@ -316,11 +305,10 @@ public:
         return obj;
     }
 
-    static std::unique_ptr<rpc::telemetry_server::EulerAngle>
-    translateToRpcEulerAngle(const mavsdk::TelemetryServer::EulerAngle& euler_angle)
+    static void translateToRpcEulerAngle(
+        const mavsdk::TelemetryServer::EulerAngle& euler_angle,
+        rpc::telemetry_server::EulerAngle* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::telemetry_server::EulerAngle>();
-
         rpc_obj->set_roll_deg(euler_angle.roll_deg);
 
         rpc_obj->set_pitch_deg(euler_angle.pitch_deg);
@@ -328,8 +316,6 @@ public:
         rpc_obj->set_yaw_deg(euler_angle.yaw_deg);
 
         rpc_obj->set_timestamp_us(euler_angle.timestamp_us);
-
-        return rpc_obj;
     }
 
     static mavsdk::TelemetryServer::EulerAngle
@@ -348,19 +334,15 @@ public:
         return obj;
     }
 
-    static std::unique_ptr<rpc::telemetry_server::AngularVelocityBody>
-    translateToRpcAngularVelocityBody(
-        const mavsdk::TelemetryServer::AngularVelocityBody& angular_velocity_body)
+    static void translateToRpcAngularVelocityBody(
+        const mavsdk::TelemetryServer::AngularVelocityBody& angular_velocity_body,
+        rpc::telemetry_server::AngularVelocityBody* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::telemetry_server::AngularVelocityBody>();
-
         rpc_obj->set_roll_rad_s(angular_velocity_body.roll_rad_s);
 
         rpc_obj->set_pitch_rad_s(angular_velocity_body.pitch_rad_s);
 
         rpc_obj->set_yaw_rad_s(angular_velocity_body.yaw_rad_s);
-
-        return rpc_obj;
     }
 
     static mavsdk::TelemetryServer::AngularVelocityBody translateFromRpcAngularVelocityBody(
@@ -377,16 +359,12 @@ public:
         return obj;
     }
 
-    static std::unique_ptr<rpc::telemetry_server::GpsInfo>
-    translateToRpcGpsInfo(const mavsdk::TelemetryServer::GpsInfo& gps_info)
+    static void translateToRpcGpsInfo(
+        const mavsdk::TelemetryServer::GpsInfo& gps_info, rpc::telemetry_server::GpsInfo* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::telemetry_server::GpsInfo>();
-
         rpc_obj->set_num_satellites(gps_info.num_satellites);
 
         rpc_obj->set_fix_type(translateToRpcFixType(gps_info.fix_type));
-
-        return rpc_obj;
     }
 
     static mavsdk::TelemetryServer::GpsInfo
@@ -401,11 +379,9 @@ public:
         return obj;
     }
 
-    static std::unique_ptr<rpc::telemetry_server::RawGps>
-    translateToRpcRawGps(const mavsdk::TelemetryServer::RawGps& raw_gps)
+    static void translateToRpcRawGps(
+        const mavsdk::TelemetryServer::RawGps& raw_gps, rpc::telemetry_server::RawGps* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::telemetry_server::RawGps>();
-
         rpc_obj->set_timestamp_us(raw_gps.timestamp_us);
 
         rpc_obj->set_latitude_deg(raw_gps.latitude_deg);
@@ -433,8 +409,6 @@ public:
         rpc_obj->set_heading_uncertainty_deg(raw_gps.heading_uncertainty_deg);
 
         rpc_obj->set_yaw_deg(raw_gps.yaw_deg);
-
-        return rpc_obj;
     }
 
     static mavsdk::TelemetryServer::RawGps
@@ -473,16 +447,12 @@ public:
         return obj;
     }
 
-    static std::unique_ptr<rpc::telemetry_server::Battery>
-    translateToRpcBattery(const mavsdk::TelemetryServer::Battery& battery)
+    static void translateToRpcBattery(
+        const mavsdk::TelemetryServer::Battery& battery, rpc::telemetry_server::Battery* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::telemetry_server::Battery>();
-
         rpc_obj->set_voltage_v(battery.voltage_v);
 
         rpc_obj->set_remaining_percent(battery.remaining_percent);
-
-        return rpc_obj;
     }
 
     static mavsdk::TelemetryServer::Battery
@@ -497,18 +467,15 @@ public:
         return obj;
     }
 
-    static std::unique_ptr<rpc::telemetry_server::RcStatus>
-    translateToRpcRcStatus(const mavsdk::TelemetryServer::RcStatus& rc_status)
+    static void translateToRpcRcStatus(
+        const mavsdk::TelemetryServer::RcStatus& rc_status,
+        rpc::telemetry_server::RcStatus* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::telemetry_server::RcStatus>();
-
         rpc_obj->set_was_available_once(rc_status.was_available_once);
 
         rpc_obj->set_is_available(rc_status.is_available);
 
         rpc_obj->set_signal_strength_percent(rc_status.signal_strength_percent);
-
-        return rpc_obj;
     }
 
     static mavsdk::TelemetryServer::RcStatus
@@ -525,16 +492,13 @@ public:
         return obj;
     }
 
-    static std::unique_ptr<rpc::telemetry_server::StatusText>
-    translateToRpcStatusText(const mavsdk::TelemetryServer::StatusText& status_text)
+    static void translateToRpcStatusText(
+        const mavsdk::TelemetryServer::StatusText& status_text,
+        rpc::telemetry_server::StatusText* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::telemetry_server::StatusText>();
-
         rpc_obj->set_type(translateToRpcStatusTextType(status_text.type));
 
         rpc_obj->set_text(status_text.text);
-
-        return rpc_obj;
     }
 
     static mavsdk::TelemetryServer::StatusText
@@ -549,19 +513,15 @@ public:
         return obj;
     }
 
-    static std::unique_ptr<rpc::telemetry_server::ActuatorControlTarget>
-    translateToRpcActuatorControlTarget(
-        const mavsdk::TelemetryServer::ActuatorControlTarget& actuator_control_target)
+    static void translateToRpcActuatorControlTarget(
+        const mavsdk::TelemetryServer::ActuatorControlTarget& actuator_control_target,
+        rpc::telemetry_server::ActuatorControlTarget* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::telemetry_server::ActuatorControlTarget>();
-
         rpc_obj->set_group(actuator_control_target.group);
 
         for (const auto& elem : actuator_control_target.controls) {
             rpc_obj->add_controls(elem);
         }
-
-        return rpc_obj;
     }
 
     static mavsdk::TelemetryServer::ActuatorControlTarget translateFromRpcActuatorControlTarget(
@@ -578,19 +538,15 @@ public:
         return obj;
     }
 
-    static std::unique_ptr<rpc::telemetry_server::ActuatorOutputStatus>
-    translateToRpcActuatorOutputStatus(
-        const mavsdk::TelemetryServer::ActuatorOutputStatus& actuator_output_status)
+    static void translateToRpcActuatorOutputStatus(
+        const mavsdk::TelemetryServer::ActuatorOutputStatus& actuator_output_status,
+        rpc::telemetry_server::ActuatorOutputStatus* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::telemetry_server::ActuatorOutputStatus>();
-
         rpc_obj->set_active(actuator_output_status.active);
 
         for (const auto& elem : actuator_output_status.actuator) {
             rpc_obj->add_actuator(elem);
         }
-
-        return rpc_obj;
     }
 
     static mavsdk::TelemetryServer::ActuatorOutputStatus translateFromRpcActuatorOutputStatus(
@@ -607,16 +563,13 @@ public:
         return obj;
     }
 
-    static std::unique_ptr<rpc::telemetry_server::Covariance>
-    translateToRpcCovariance(const mavsdk::TelemetryServer::Covariance& covariance)
+    static void translateToRpcCovariance(
+        const mavsdk::TelemetryServer::Covariance& covariance,
+        rpc::telemetry_server::Covariance* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::telemetry_server::Covariance>();
-
         for (const auto& elem : covariance.covariance_matrix) {
             rpc_obj->add_covariance_matrix(elem);
         }
-
-        return rpc_obj;
     }
 
     static mavsdk::TelemetryServer::Covariance
@@ -631,18 +584,15 @@ public:
         return obj;
     }
 
-    static std::unique_ptr<rpc::telemetry_server::VelocityBody>
-    translateToRpcVelocityBody(const mavsdk::TelemetryServer::VelocityBody& velocity_body)
+    static void translateToRpcVelocityBody(
+        const mavsdk::TelemetryServer::VelocityBody& velocity_body,
+        rpc::telemetry_server::VelocityBody* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::telemetry_server::VelocityBody>();
-
         rpc_obj->set_x_m_s(velocity_body.x_m_s);
 
         rpc_obj->set_y_m_s(velocity_body.y_m_s);
 
         rpc_obj->set_z_m_s(velocity_body.z_m_s);
-
-        return rpc_obj;
     }
 
     static mavsdk::TelemetryServer::VelocityBody
@@ -659,18 +609,15 @@ public:
         return obj;
     }
 
-    static std::unique_ptr<rpc::telemetry_server::PositionBody>
-    translateToRpcPositionBody(const mavsdk::TelemetryServer::PositionBody& position_body)
+    static void translateToRpcPositionBody(
+        const mavsdk::TelemetryServer::PositionBody& position_body,
+        rpc::telemetry_server::PositionBody* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::telemetry_server::PositionBody>();
-
         rpc_obj->set_x_m(position_body.x_m);
 
         rpc_obj->set_y_m(position_body.y_m);
 
         rpc_obj->set_z_m(position_body.z_m);
-
-        return rpc_obj;
     }
 
     static mavsdk::TelemetryServer::PositionBody
@@ -723,35 +670,28 @@ public:
         }
     }
 
-    static std::unique_ptr<rpc::telemetry_server::Odometry>
-    translateToRpcOdometry(const mavsdk::TelemetryServer::Odometry& odometry)
+    static void translateToRpcOdometry(
+        const mavsdk::TelemetryServer::Odometry& odometry, rpc::telemetry_server::Odometry* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::telemetry_server::Odometry>();
-
         rpc_obj->set_time_usec(odometry.time_usec);
 
         rpc_obj->set_frame_id(translateToRpcMavFrame(odometry.frame_id));
 
         rpc_obj->set_child_frame_id(translateToRpcMavFrame(odometry.child_frame_id));
 
-        rpc_obj->set_allocated_position_body(
-            translateToRpcPositionBody(odometry.position_body).release());
-
-        rpc_obj->set_allocated_q(translateToRpcQuaternion(odometry.q).release());
+        translateToRpcPositionBody(odometry.position_body, rpc_obj->mutable_position_body());
 
-        rpc_obj->set_allocated_velocity_body(
-            translateToRpcVelocityBody(odometry.velocity_body).release());
+        translateToRpcQuaternion(odometry.q, rpc_obj->mutable_q());
 
-        rpc_obj->set_allocated_angular_velocity_body(
-            translateToRpcAngularVelocityBody(odometry.angular_velocity_body).release());
+        translateToRpcVelocityBody(odometry.velocity_body, rpc_obj->mutable_velocity_body());
 
-        rpc_obj->set_allocated_pose_covariance(
-            translateToRpcCovariance(odometry.pose_covariance).release());
+        translateToRpcAngularVelocityBody(
+            odometry.angular_velocity_body, rpc_obj->mutable_angular_velocity_body());
 
-        rpc_obj->set_allocated_velocity_covariance(
-            translateToRpcCovariance(odometry.velocity_covariance).release());
+        translateToRpcCovariance(odometry.pose_covariance, rpc_obj->mutable_pose_covariance());
 
-        return rpc_obj;
+        translateToRpcCovariance(
+            odometry.velocity_covariance, rpc_obj->mutable_velocity_covariance());
     }
 
     static mavsdk::TelemetryServer::Odometry
@@ -781,18 +721,15 @@ public:
         return obj;
     }
 
-    static std::unique_ptr<rpc::telemetry_server::DistanceSensor>
-    translateToRpcDistanceSensor(const mavsdk::TelemetryServer::DistanceSensor& distance_sensor)
+    static void translateToRpcDistanceSensor(
+        const mavsdk::TelemetryServer::DistanceSensor& distance_sensor,
+        rpc::telemetry_server::DistanceSensor* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::telemetry_server::DistanceSensor>();
-
         rpc_obj->set_minimum_distance_m(distance_sensor.minimum_distance_m);
 
         rpc_obj->set_maximum_distance_m(distance_sensor.maximum_distance_m);
 
         rpc_obj->set_current_distance_m(distance_sensor.current_distance_m);
-
-        return rpc_obj;
     }
 
     static mavsdk::TelemetryServer::DistanceSensor
@@ -809,11 +746,10 @@ public:
         return obj;
     }
 
-    static std::unique_ptr<rpc::telemetry_server::ScaledPressure>
-    translateToRpcScaledPressure(const mavsdk::TelemetryServer::ScaledPressure& scaled_pressure)
+    static void translateToRpcScaledPressure(
+        const mavsdk::TelemetryServer::ScaledPressure& scaled_pressure,
+        rpc::telemetry_server::ScaledPressure* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::telemetry_server::ScaledPressure>();
-
         rpc_obj->set_timestamp_us(scaled_pressure.timestamp_us);
 
         rpc_obj->set_absolute_pressure_hpa(scaled_pressure.absolute_pressure_hpa);
@@ -824,8 +760,6 @@ public:
 
         rpc_obj->set_differential_pressure_temperature_deg(
             scaled_pressure.differential_pressure_temperature_deg);
-
-        return rpc_obj;
     }
 
     static mavsdk::TelemetryServer::ScaledPressure
@@ -847,18 +781,15 @@ public:
         return obj;
     }
 
-    static std::unique_ptr<rpc::telemetry_server::PositionNed>
-    translateToRpcPositionNed(const mavsdk::TelemetryServer::PositionNed& position_ned)
+    static void translateToRpcPositionNed(
+        const mavsdk::TelemetryServer::PositionNed& position_ned,
+        rpc::telemetry_server::PositionNed* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::telemetry_server::PositionNed>();
-
         rpc_obj->set_north_m(position_ned.north_m);
 
         rpc_obj->set_east_m(position_ned.east_m);
 
         rpc_obj->set_down_m(position_ned.down_m);
-
-        return rpc_obj;
     }
 
     static mavsdk::TelemetryServer::PositionNed
@@ -875,18 +806,15 @@ public:
         return obj;
     }
 
-    static std::unique_ptr<rpc::telemetry_server::VelocityNed>
-    translateToRpcVelocityNed(const mavsdk::TelemetryServer::VelocityNed& velocity_ned)
+    static void translateToRpcVelocityNed(
+        const mavsdk::TelemetryServer::VelocityNed& velocity_ned,
+        rpc::telemetry_server::VelocityNed* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::telemetry_server::VelocityNed>();
-
         rpc_obj->set_north_m_s(velocity_ned.north_m_s);
 
         rpc_obj->set_east_m_s(velocity_ned.east_m_s);
 
         rpc_obj->set_down_m_s(velocity_ned.down_m_s);
-
-        return rpc_obj;
     }
 
     static mavsdk::TelemetryServer::VelocityNed
@@ -903,19 +831,13 @@ public:
         return obj;
     }
 
-    static std::unique_ptr<rpc::telemetry_server::PositionVelocityNed>
-    translateToRpcPositionVelocityNed(
-        const mavsdk::TelemetryServer::PositionVelocityNed& position_velocity_ned)
+    static void translateToRpcPositionVelocityNed(
+        const mavsdk::TelemetryServer::PositionVelocityNed& position_velocity_ned,
+        rpc::telemetry_server::PositionVelocityNed* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::telemetry_server::PositionVelocityNed>();
-
-        rpc_obj->set_allocated_position(
-            translateToRpcPositionNed(position_velocity_ned.position).release());
-
-        rpc_obj->set_allocated_velocity(
-            translateToRpcVelocityNed(position_velocity_ned.velocity).release());
+        translateToRpcPositionNed(position_velocity_ned.position, rpc_obj->mutable_position());
 
-        return rpc_obj;
+        translateToRpcVelocityNed(position_velocity_ned.velocity, rpc_obj->mutable_velocity());
     }
 
     static mavsdk::TelemetryServer::PositionVelocityNed translateFromRpcPositionVelocityNed(
@@ -930,18 +852,15 @@ public:
         return obj;
     }
 
-    static std::unique_ptr<rpc::telemetry_server::GroundTruth>
-    translateToRpcGroundTruth(const mavsdk::TelemetryServer::GroundTruth& ground_truth)
+    static void translateToRpcGroundTruth(
+        const mavsdk::TelemetryServer::GroundTruth& ground_truth,
+        rpc::telemetry_server::GroundTruth* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::telemetry_server::GroundTruth>();
-
         rpc_obj->set_latitude_deg(ground_truth.latitude_deg);
 
         rpc_obj->set_longitude_deg(ground_truth.longitude_deg);
 
         rpc_obj->set_absolute_altitude_m(ground_truth.absolute_altitude_m);
-
-        return rpc_obj;
     }
 
     static mavsdk::TelemetryServer::GroundTruth
@@ -958,18 +877,15 @@ public:
         return obj;
     }
 
-    static std::unique_ptr<rpc::telemetry_server::FixedwingMetrics> translateToRpcFixedwingMetrics(
-        const mavsdk::TelemetryServer::FixedwingMetrics& fixedwing_metrics)
+    static void translateToRpcFixedwingMetrics(
+        const mavsdk::TelemetryServer::FixedwingMetrics& fixedwing_metrics,
+        rpc::telemetry_server::FixedwingMetrics* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::telemetry_server::FixedwingMetrics>();
-
         rpc_obj->set_airspeed_m_s(fixedwing_metrics.airspeed_m_s);
 
         rpc_obj->set_throttle_percentage(fixedwing_metrics.throttle_percentage);
 
         rpc_obj->set_climb_rate_m_s(fixedwing_metrics.climb_rate_m_s);
-
-        return rpc_obj;
     }
 
     static mavsdk::TelemetryServer::FixedwingMetrics translateFromRpcFixedwingMetrics(
@@ -986,18 +902,15 @@ public:
         return obj;
     }
 
-    static std::unique_ptr<rpc::telemetry_server::AccelerationFrd>
-    translateToRpcAccelerationFrd(const mavsdk::TelemetryServer::AccelerationFrd& acceleration_frd)
+    static void translateToRpcAccelerationFrd(
+        const mavsdk::TelemetryServer::AccelerationFrd& acceleration_frd,
+        rpc::telemetry_server::AccelerationFrd* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::telemetry_server::AccelerationFrd>();
-
         rpc_obj->set_forward_m_s2(acceleration_frd.forward_m_s2);
 
         rpc_obj->set_right_m_s2(acceleration_frd.right_m_s2);
 
         rpc_obj->set_down_m_s2(acceleration_frd.down_m_s2);
-
-        return rpc_obj;
     }
 
     static mavsdk::TelemetryServer::AccelerationFrd
@@ -1014,19 +927,15 @@ public:
         return obj;
     }
 
-    static std::unique_ptr<rpc::telemetry_server::AngularVelocityFrd>
-    translateToRpcAngularVelocityFrd(
-        const mavsdk::TelemetryServer::AngularVelocityFrd& angular_velocity_frd)
+    static void translateToRpcAngularVelocityFrd(
+        const mavsdk::TelemetryServer::AngularVelocityFrd& angular_velocity_frd,
+        rpc::telemetry_server::AngularVelocityFrd* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::telemetry_server::AngularVelocityFrd>();
-
         rpc_obj->set_forward_rad_s(angular_velocity_frd.forward_rad_s);
 
         rpc_obj->set_right_rad_s(angular_velocity_frd.right_rad_s);
 
         rpc_obj->set_down_rad_s(angular_velocity_frd.down_rad_s);
-
-        return rpc_obj;
     }
 
     static mavsdk::TelemetryServer::AngularVelocityFrd translateFromRpcAngularVelocityFrd(
@@ -1043,18 +952,15 @@ public:
         return obj;
     }
 
-    static std::unique_ptr<rpc::telemetry_server::MagneticFieldFrd> translateToRpcMagneticFieldFrd(
-        const mavsdk::TelemetryServer::MagneticFieldFrd& magnetic_field_frd)
+    static void translateToRpcMagneticFieldFrd(
+        const mavsdk::TelemetryServer::MagneticFieldFrd& magnetic_field_frd,
+        rpc::telemetry_server::MagneticFieldFrd* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::telemetry_server::MagneticFieldFrd>();
-
         rpc_obj->set_forward_gauss(magnetic_field_frd.forward_gauss);
 
         rpc_obj->set_right_gauss(magnetic_field_frd.right_gauss);
 
         rpc_obj->set_down_gauss(magnetic_field_frd.down_gauss);
-
-        return rpc_obj;
     }
 
     static mavsdk::TelemetryServer::MagneticFieldFrd translateFromRpcMagneticFieldFrd(
@@ -1071,25 +977,20 @@ public:
         return obj;
     }
 
-    static std::unique_ptr<rpc::telemetry_server::Imu>
-    translateToRpcImu(const mavsdk::TelemetryServer::Imu& imu)
+    static void translateToRpcImu(
+        const mavsdk::TelemetryServer::Imu& imu, rpc::telemetry_server::Imu* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::telemetry_server::Imu>();
-
-        rpc_obj->set_allocated_acceleration_frd(
-            translateToRpcAccelerationFrd(imu.acceleration_frd).release());
+        translateToRpcAccelerationFrd(imu.acceleration_frd, rpc_obj->mutable_acceleration_frd());
 
-        rpc_obj->set_allocated_angular_velocity_frd(
-            translateToRpcAngularVelocityFrd(imu.angular_velocity_frd).release());
+        translateToRpcAngularVelocityFrd(
+            imu.angular_velocity_frd, rpc_obj->mutable_angular_velocity_frd());
 
-        rpc_obj->set_allocated_magnetic_field_frd(
-            translateToRpcMagneticFieldFrd(imu.magnetic_field_frd).release());
+        translateToRpcMagneticFieldFrd(
+            imu.magnetic_field_frd, rpc_obj->mutable_magnetic_field_frd());
 
         rpc_obj->set_temperature_degc(imu.temperature_degc);
 
         rpc_obj->set_timestamp_us(imu.timestamp_us);
-
-        return rpc_obj;
     }
 
     static mavsdk::TelemetryServer::Imu translateFromRpcImu(const rpc::telemetry_server::Imu& imu)
@@ -1162,11 +1063,13 @@ public:
     }
 
     grpc::Status PublishPosition(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::telemetry_server::PublishPositionRequest* request,
         rpc::telemetry_server::PublishPositionResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 // For server plugins, this should never happen, they should always be
                 // constructible.
@@ -1182,7 +1085,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->publish_position(
+        auto result = plugin->publish_position(
             translateFromRpcPosition(request->position()),
             translateFromRpcVelocityNed(request->velocity_ned()),
             translateFromRpcHeading(request->heading()));
@@ -1195,11 +1098,13 @@ public:
     }
 
     grpc::Status PublishHome(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::telemetry_server::PublishHomeRequest* request,
         rpc::telemetry_server::PublishHomeResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 // For server plugins, this should never happen, they should always be
                 // constructible.
@@ -1216,7 +1121,7 @@ public:
         }
 
         auto result =
-            _lazy_plugin.maybe_plugin()->publish_home(translateFromRpcPosition(request->home()));
+            plugin->publish_home(translateFromRpcPosition(request->home()));
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -1226,11 +1131,13 @@ public:
     }
 
     grpc::Status PublishSysStatus(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::telemetry_server::PublishSysStatusRequest* request,
         rpc::telemetry_server::PublishSysStatusResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 // For server plugins, this should never happen, they should always be
                 // constructible.
@@ -1246,7 +1153,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->publish_sys_status(
+        auto result = plugin->publish_sys_status(
             translateFromRpcBattery(request->battery()),
             request->rc_receiver_status(),
             request->gyro_status(),
@@ -1262,11 +1169,13 @@ public:
     }
 
     grpc::Status PublishExtendedSysState(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::telemetry_server::PublishExtendedSysStateRequest* request,
         rpc::telemetry_server::PublishExtendedSysStateResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 // For server plugins, this should never happen, they should always be
                 // constructible.
@@ -1282,7 +1191,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->publish_extended_sys_state(
+        auto result = plugin->publish_extended_sys_state(
             translateFromRpcVtolState(request->vtol_state()),
             translateFromRpcLandedState(request->landed_state()));
 
@@ -1294,11 +1203,13 @@ public:
     }
 
     grpc::Status PublishRawGps(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::telemetry_server::PublishRawGpsRequest* request,
         rpc::telemetry_server::PublishRawGpsResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 // For server plugins, this should never happen, they should always be
                 // constructible.
@@ -1314,7 +1225,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->publish_raw_gps(
+        auto result = plugin->publish_raw_gps(
             translateFromRpcRawGps(request->raw_gps()),
             translateFromRpcGpsInfo(request->gps_info()));
 
@@ -1326,11 +1237,13 @@ public:
     }
 
     grpc::Status PublishBattery(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::telemetry_server::PublishBatteryRequest* request,
         rpc::telemetry_server::PublishBatteryResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 // For server plugins, this should never happen, they should always be
                 // constructible.
@@ -1346,7 +1259,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->publish_battery(
+        auto result = plugin->publish_battery(
             translateFromRpcBattery(request->battery()));
 
         if (response != nullptr) {
@@ -1357,11 +1270,13 @@ public:
     }
 
     grpc::Status PublishStatusText(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::telemetry_server::PublishStatusTextRequest* request,
         rpc::telemetry_server::PublishStatusTextResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 // For server plugins, this should never happen, they should always be
                 // constructible.
@@ -1377,7 +1292,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->publish_status_text(
+        auto result = plugin->publish_status_text(
             translateFromRpcStatusText(request->status_text()));
 
         if (response != nullptr) {
@@ -1388,11 +1303,13 @@ public:
     }
 
     grpc::Status PublishOdometry(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::telemetry_server::PublishOdometryRequest* request,
         rpc::telemetry_server::PublishOdometryResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 // For server plugins, this should never happen, they should always be
                 // constructible.
@@ -1408,7 +1325,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->publish_odometry(
+        auto result = plugin->publish_odometry(
             translateFromRpcOdometry(request->odometry()));
 
         if (response != nullptr) {
@@ -1419,11 +1336,13 @@ public:
     }
 
     grpc::Status PublishPositionVelocityNed(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::telemetry_server::PublishPositionVelocityNedRequest* request,
         rpc::telemetry_server::PublishPositionVelocityNedResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 // For server plugins, this should never happen, they should always be
                 // constructible.
@@ -1439,7 +1358,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->publish_position_velocity_ned(
+        auto result = plugin->publish_position_velocity_ned(
             translateFromRpcPositionVelocityNed(request->position_velocity_ned()));
 
         if (response != nullptr) {
@@ -1450,11 +1369,13 @@ public:
     }
 
     grpc::Status PublishGroundTruth(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::telemetry_server::PublishGroundTruthRequest* request,
         rpc::telemetry_server::PublishGroundTruthResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 // For server plugins, this should never happen, they should always be
                 // constructible.
@@ -1470,7 +1391,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->publish_ground_truth(
+        auto result = plugin->publish_ground_truth(
             translateFromRpcGroundTruth(request->ground_truth()));
 
         if (response != nullptr) {
@@ -1481,11 +1402,13 @@ public:
     }
 
     grpc::Status PublishImu(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::telemetry_server::PublishImuRequest* request,
         rpc::telemetry_server::PublishImuResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 // For server plugins, this should never happen, they should always be
                 // constructible.
@@ -1501,7 +1424,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->publish_imu(translateFromRpcImu(request->imu()));
+        auto result = plugin->publish_imu(translateFromRpcImu(request->imu()));
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -1511,11 +1434,13 @@ public:
     }
 
     grpc::Status PublishScaledImu(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::telemetry_server::PublishScaledImuRequest* request,
         rpc::telemetry_server::PublishScaledImuResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 // For server plugins, this should never happen, they should always be
                 // constructible.
@@ -1532,7 +1457,7 @@ public:
         }
 
         auto result =
-            _lazy_plugin.maybe_plugin()->publish_scaled_imu(translateFromRpcImu(request->imu()));
+            plugin->publish_scaled_imu(translateFromRpcImu(request->imu()));
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -1542,11 +1467,13 @@ public:
     }
 
     grpc::Status PublishRawImu(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::telemetry_server::PublishRawImuRequest* request,
         rpc::telemetry_server::PublishRawImuResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 // For server plugins, this should never happen, they should always be
                 // constructible.
@@ -1563,7 +1490,7 @@ public:
         }
 
         auto result =
-            _lazy_plugin.maybe_plugin()->publish_raw_imu(translateFromRpcImu(request->imu()));
+            plugin->publish_raw_imu(translateFromRpcImu(request->imu()));
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -1573,11 +1500,13 @@ public:
     }
 
     grpc::Status PublishUnixEpochTime(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::telemetry_server::PublishUnixEpochTimeRequest* request,
         rpc::telemetry_server::PublishUnixEpochTimeResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 // For server plugins, this should never happen, they should always be
                 // constructible.
@@ -1593,7 +1522,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->publish_unix_epoch_time(request->time_us());
+        auto result = plugin->publish_unix_epoch_time(request->time_us());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -1603,11 +1532,13 @@ public:
     }
 
     grpc::Status PublishDistanceSensor(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::telemetry_server::PublishDistanceSensorRequest* request,
         rpc::telemetry_server::PublishDistanceSensorResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 // For server plugins, this should never happen, they should always be
                 // constructible.
@@ -1623,7 +1554,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->publish_distance_sensor(
+        auto result = plugin->publish_distance_sensor(
             translateFromRpcDistanceSensor(request->distance_sensor()));
 
         if (response != nullptr) {
@@ -1633,45 +1564,14 @@ public:
         return grpc::Status::OK;
     }
 
-    void stop()
-    {
-        _stopped.store(true);
-        for (auto& prom : _stream_stop_promises) {
-            if (auto handle = prom.lock()) {
-                handle->set_value();
-            }
-        }
-    }
+    void stop() { _streams.finish_all(); }
 
-private:
-    void register_stream_stop_promise(std::weak_ptr<std::promise<void>> prom)
-    {
-        // If we have already stopped, set promise immediately and don't add it to list.
-        if (_stopped.load()) {
-            if (auto handle = prom.lock()) {
-                handle->set_value();
-            }
-        } else {
-            _stream_stop_promises.push_back(prom);
-        }
-    }
-
-    void unregister_stream_stop_promise(std::shared_ptr<std::promise<void>> prom)
-    {
-        for (auto it = _stream_stop_promises.begin(); it != _stream_stop_promises.end();
-             /* ++it */) {
-            if (it->lock() == prom) {
-                it = _stream_stop_promises.erase(it);
-            } else {
-                ++it;
-            }
-        }
-    }
+    const StreamStats& stream_stats() const { return _streams.stats(); }
 
+private:
     LazyServerPlugin& _lazy_plugin;
 
-    std::atomic<bool> _stopped{false};
-    std::vector<std::weak_ptr<std::promise<void>>> _stream_stop_promises{};
+    StreamList _streams{};
 };
 
 } // namespace mavsdk_server
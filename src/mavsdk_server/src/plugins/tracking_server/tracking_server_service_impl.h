@@ -11,6 +11,8 @@
 #include "lazy_server_plugin.h"
 
 #include "log.h"
+#include "stream_reactor.h"
+#include "system_selection.h"
 #include <atomic>
 #include <cmath>
 #include <future>
@@ -27,7 +29,11 @@ template<
     typename LazyServerPlugin = LazyServerPlugin<TrackingServer>>
 
 class TrackingServerServiceImpl final
-    : public rpc::tracking_server::TrackingServerService::Service {
+    : public WithCallbackMethods<
+          rpc::tracking_server::TrackingServerService::Service,
+          rpc::tracking_server::TrackingServerService::WithCallbackMethod_SubscribeTrackingPointCommand,
+          rpc::tracking_server::TrackingServerService::WithCallbackMethod_SubscribeTrackingRectangleCommand,
+          rpc::tracking_server::TrackingServerService::WithCallbackMethod_SubscribeTrackingOffCommand> {
 public:
     TrackingServerServiceImpl(LazyServerPlugin& lazy_plugin) : _lazy_plugin(lazy_plugin) {}
 
@@ -37,13 +43,11 @@ public:
     {
         auto rpc_result = translateToRpcResult(result);
 
-        auto* rpc_tracking_server_result = new rpc::tracking_server::TrackingServerResult();
+        auto* rpc_tracking_server_result = response->mutable_tracking_server_result();
         rpc_tracking_server_result->set_result(rpc_result);
         std::stringstream ss;
         ss << result;
         rpc_tracking_server_result->set_result_str(ss.str());
-
-        response->set_allocated_tracking_server_result(rpc_tracking_server_result);
     }
 
     static rpc::tracking_server::CommandAnswer
@@ -88,18 +92,15 @@ public:
         }
     }
 
-    static std::unique_ptr<rpc::tracking_server::TrackPoint>
-    translateToRpcTrackPoint(const mavsdk::TrackingServer::TrackPoint& track_point)
+    static void translateToRpcTrackPoint(
+        const mavsdk::TrackingServer::TrackPoint& track_point,
+        rpc::tracking_server::TrackPoint* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::tracking_server::TrackPoint>();
-
         rpc_obj->set_point_x(track_point.point_x);
 
         rpc_obj->set_point_y(track_point.point_y);
 
         rpc_obj->set_radius(track_point.radius);
-
-        return rpc_obj;
     }
 
     static mavsdk::TrackingServer::TrackPoint
@@ -116,11 +117,10 @@ public:
         return obj;
     }
 
-    static std::unique_ptr<rpc::tracking_server::TrackRectangle>
-    translateToRpcTrackRectangle(const mavsdk::TrackingServer::TrackRectangle& track_rectangle)
+    static void translateToRpcTrackRectangle(
+        const mavsdk::TrackingServer::TrackRectangle& track_rectangle,
+        rpc::tracking_server::TrackRectangle* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::tracking_server::TrackRectangle>();
-
         rpc_obj->set_top_left_corner_x(track_rectangle.top_left_corner_x);
 
         rpc_obj->set_top_left_corner_y(track_rectangle.top_left_corner_y);
@@ -128,8 +128,6 @@ public:
         rpc_obj->set_bottom_right_corner_x(track_rectangle.bottom_right_corner_x);
 
         rpc_obj->set_bottom_right_corner_y(track_rectangle.bottom_right_corner_y);
-
-        return rpc_obj;
     }
 
     static mavsdk::TrackingServer::TrackRectangle
@@ -185,11 +183,13 @@ public:
     }
 
     grpc::Status SetTrackingPointStatus(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::tracking_server::SetTrackingPointStatusRequest* request,
         rpc::tracking_server::SetTrackingPointStatusResponse* /* response */) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             return grpc::Status::OK;
         }
 
@@ -198,18 +198,20 @@ public:
             return grpc::Status::OK;
         }
 
-        _lazy_plugin.maybe_plugin()->set_tracking_point_status(
+        plugin->set_tracking_point_status(
             translateFromRpcTrackPoint(request->tracked_point()));
 
         return grpc::Status::OK;
     }
 
     grpc::Status SetTrackingRectangleStatus(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::tracking_server::SetTrackingRectangleStatusRequest* request,
         rpc::tracking_server::SetTrackingRectangleStatusResponse* /* response */) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             return grpc::Status::OK;
         }
 
@@ -218,157 +220,138 @@ public:
             return grpc::Status::OK;
         }
 
-        _lazy_plugin.maybe_plugin()->set_tracking_rectangle_status(
+        plugin->set_tracking_rectangle_status(
             translateFromRpcTrackRectangle(request->tracked_rectangle()));
 
         return grpc::Status::OK;
     }
 
     grpc::Status SetTrackingOffStatus(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::tracking_server::SetTrackingOffStatusRequest* /* request */,
         rpc::tracking_server::SetTrackingOffStatusResponse* /* response */) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             return grpc::Status::OK;
         }
 
-        _lazy_plugin.maybe_plugin()->set_tracking_off_status();
+        plugin->set_tracking_off_status();
 
         return grpc::Status::OK;
     }
 
-    grpc::Status SubscribeTrackingPointCommand(
-        grpc::ServerContext* /* context */,
-        const mavsdk::rpc::tracking_server::SubscribeTrackingPointCommandRequest* /* request */,
-        grpc::ServerWriter<rpc::tracking_server::TrackingPointCommandResponse>* writer) override
+    grpc::ServerWriteReactor<rpc::tracking_server::TrackingPointCommandResponse>*
+    SubscribeTrackingPointCommand(
+        grpc::CallbackServerContext* context,
+        const mavsdk::rpc::tracking_server::SubscribeTrackingPointCommandRequest* /* request */)
+        override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
-            return grpc::Status::OK;
-        }
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        auto reactor = StreamReactor<rpc::tracking_server::TrackingPointCommandResponse>::create();
 
-        auto stream_closed_promise = std::make_shared<std::promise<void>>();
-        auto stream_closed_future = stream_closed_promise->get_future();
-        register_stream_stop_promise(stream_closed_promise);
+        if (plugin == nullptr) {
+            reactor->finish();
+            return reactor.get();
+        }
 
-        auto is_finished = std::make_shared<bool>(false);
-        auto subscribe_mutex = std::make_shared<std::mutex>();
+        _streams.add(reactor);
 
         const mavsdk::TrackingServer::TrackingPointCommandHandle handle =
-            _lazy_plugin.maybe_plugin()->subscribe_tracking_point_command(
-                [this, &writer, &stream_closed_promise, is_finished, subscribe_mutex, &handle](
-                    const mavsdk::TrackingServer::TrackPoint tracking_point_command) {
+            plugin->subscribe_tracking_point_command(
+                [reactor](const mavsdk::TrackingServer::TrackPoint tracking_point_command) {
                     rpc::tracking_server::TrackingPointCommandResponse rpc_response;
 
-                    rpc_response.set_allocated_track_point(
-                        translateToRpcTrackPoint(tracking_point_command).release());
-
-                    std::unique_lock<std::mutex> lock(*subscribe_mutex);
-                    if (!*is_finished && !writer->Write(rpc_response)) {
-                        _lazy_plugin.maybe_plugin()->unsubscribe_tracking_point_command(handle);
+                    translateToRpcTrackPoint(
+                        tracking_point_command, rpc_response.mutable_track_point());
 
-                        *is_finished = true;
-                        unregister_stream_stop_promise(stream_closed_promise);
-                        stream_closed_promise->set_value();
-                    }
+                    reactor->write(std::move(rpc_response));
                 });
 
-        stream_closed_future.wait();
-        std::unique_lock<std::mutex> lock(*subscribe_mutex);
-        *is_finished = true;
+        reactor->set_on_done(
+            [plugin, handle]() { plugin->unsubscribe_tracking_point_command(handle); });
 
-        return grpc::Status::OK;
+        return reactor.get();
     }
 
-    grpc::Status SubscribeTrackingRectangleCommand(
-        grpc::ServerContext* /* context */,
-        const mavsdk::rpc::tracking_server::SubscribeTrackingRectangleCommandRequest* /* request */,
-        grpc::ServerWriter<rpc::tracking_server::TrackingRectangleCommandResponse>* writer) override
+    grpc::ServerWriteReactor<rpc::tracking_server::TrackingRectangleCommandResponse>*
+    SubscribeTrackingRectangleCommand(
+        grpc::CallbackServerContext* context,
+        const mavsdk::rpc::tracking_server::SubscribeTrackingRectangleCommandRequest* /* request */)
+        override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
-            return grpc::Status::OK;
-        }
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
 
-        auto stream_closed_promise = std::make_shared<std::promise<void>>();
-        auto stream_closed_future = stream_closed_promise->get_future();
-        register_stream_stop_promise(stream_closed_promise);
+        auto reactor =
+            StreamReactor<rpc::tracking_server::TrackingRectangleCommandResponse>::create();
 
-        auto is_finished = std::make_shared<bool>(false);
-        auto subscribe_mutex = std::make_shared<std::mutex>();
+        if (plugin == nullptr) {
+            reactor->finish();
+            return reactor.get();
+        }
+
+        _streams.add(reactor);
 
         const mavsdk::TrackingServer::TrackingRectangleCommandHandle handle =
-            _lazy_plugin.maybe_plugin()->subscribe_tracking_rectangle_command(
-                [this, &writer, &stream_closed_promise, is_finished, subscribe_mutex, &handle](
-                    const mavsdk::TrackingServer::TrackRectangle tracking_rectangle_command) {
+            plugin->subscribe_tracking_rectangle_command(
+                [reactor](const mavsdk::TrackingServer::TrackRectangle tracking_rectangle_command) {
                     rpc::tracking_server::TrackingRectangleCommandResponse rpc_response;
 
-                    rpc_response.set_allocated_track_rectangle(
-                        translateToRpcTrackRectangle(tracking_rectangle_command).release());
-
-                    std::unique_lock<std::mutex> lock(*subscribe_mutex);
-                    if (!*is_finished && !writer->Write(rpc_response)) {
-                        _lazy_plugin.maybe_plugin()->unsubscribe_tracking_rectangle_command(handle);
+                    translateToRpcTrackRectangle(
+                        tracking_rectangle_command, rpc_response.mutable_track_rectangle());
 
-                        *is_finished = true;
-                        unregister_stream_stop_promise(stream_closed_promise);
-                        stream_closed_promise->set_value();
-                    }
+                    reactor->write(std::move(rpc_response));
                 });
 
-        stream_closed_future.wait();
-        std::unique_lock<std::mutex> lock(*subscribe_mutex);
-        *is_finished = true;
+        reactor->set_on_done(
+            [plugin, handle]() { plugin->unsubscribe_tracking_rectangle_command(handle); });
 
-        return grpc::Status::OK;
+        return reactor.get();
     }
 
-    grpc::Status SubscribeTrackingOffCommand(
-        grpc::ServerContext* /* context */,
-        const mavsdk::rpc::tracking_server::SubscribeTrackingOffCommandRequest* /* request */,
-        grpc::ServerWriter<rpc::tracking_server::TrackingOffCommandResponse>* writer) override
+    grpc::ServerWriteReactor<rpc::tracking_server::TrackingOffCommandResponse>*
+    SubscribeTrackingOffCommand(
+        grpc::CallbackServerContext* context,
+        const mavsdk::rpc::tracking_server::SubscribeTrackingOffCommandRequest* /* request */)
+        override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
-            return grpc::Status::OK;
-        }
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
 
-        auto stream_closed_promise = std::make_shared<std::promise<void>>();
-        auto stream_closed_future = stream_closed_promise->get_future();
-        register_stream_stop_promise(stream_closed_promise);
+        auto reactor = StreamReactor<rpc::tracking_server::TrackingOffCommandResponse>::create();
 
-        auto is_finished = std::make_shared<bool>(false);
-        auto subscribe_mutex = std::make_shared<std::mutex>();
+        if (plugin == nullptr) {
+            reactor->finish();
+            return reactor.get();
+        }
+
+        _streams.add(reactor);
 
         const mavsdk::TrackingServer::TrackingOffCommandHandle handle =
-            _lazy_plugin.maybe_plugin()->subscribe_tracking_off_command(
-                [this, &writer, &stream_closed_promise, is_finished, subscribe_mutex, &handle](
-                    const int32_t tracking_off_command) {
+            plugin->subscribe_tracking_off_command(
+                [reactor](const int32_t tracking_off_command) {
                     rpc::tracking_server::TrackingOffCommandResponse rpc_response;
 
                     rpc_response.set_dummy(tracking_off_command);
 
-                    std::unique_lock<std::mutex> lock(*subscribe_mutex);
-                    if (!*is_finished && !writer->Write(rpc_response)) {
-                        _lazy_plugin.maybe_plugin()->unsubscribe_tracking_off_command(handle);
-
-                        *is_finished = true;
-                        unregister_stream_stop_promise(stream_closed_promise);
-                        stream_closed_promise->set_value();
-                    }
+                    reactor->write(std::move(rpc_response));
                 });
 
-        stream_closed_future.wait();
-        std::unique_lock<std::mutex> lock(*subscribe_mutex);
-        *is_finished = true;
+        reactor->set_on_done(
+            [plugin, handle]() { plugin->unsubscribe_tracking_off_command(handle); });
 
-        return grpc::Status::OK;
+        return reactor.get();
     }
 
     grpc::Status RespondTrackingPointCommand(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::tracking_server::RespondTrackingPointCommandRequest* request,
         rpc::tracking_server::RespondTrackingPointCommandResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 // For server plugins, this should never happen, they should always be
                 // constructible.
@@ -384,7 +367,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->respond_tracking_point_command(
+        auto result = plugin->respond_tracking_point_command(
             translateFromRpcCommandAnswer(request->command_answer()));
 
         if (response != nullptr) {
@@ -395,11 +378,13 @@ public:
     }
 
     grpc::Status RespondTrackingRectangleCommand(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::tracking_server::RespondTrackingRectangleCommandRequest* request,
         rpc::tracking_server::RespondTrackingRectangleCommandResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 // For server plugins, this should never happen, they should always be
                 // constructible.
@@ -415,7 +400,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->respond_tracking_rectangle_command(
+        auto result = plugin->respond_tracking_rectangle_command(
             translateFromRpcCommandAnswer(request->command_answer()));
 
         if (response != nullptr) {
@@ -426,11 +411,13 @@ public:
     }
 
     grpc::Status RespondTrackingOffCommand(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::tracking_server::RespondTrackingOffCommandRequest* request,
         rpc::tracking_server::RespondTrackingOffCommandResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 // For server plugins, this should never happen, they should always be
                 // constructible.
@@ -446,7 +433,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->respond_tracking_off_command(
+        auto result = plugin->respond_tracking_off_command(
             translateFromRpcCommandAnswer(request->command_answer()));
 
         if (response != nullptr) {
@@ -456,45 +443,14 @@ public:
         return grpc::Status::OK;
     }
 
-    void stop()
-    {
-        _stopped.store(true);
-        for (auto& prom : _stream_stop_promises) {
-            if (auto handle = prom.lock()) {
-                handle->set_value();
-            }
-        }
-    }
-
-private:
-    void register_stream_stop_promise(std::weak_ptr<std::promise<void>> prom)
-    {
-        // If we have already stopped, set promise immediately and don't add it to list.
-        if (_stopped.load()) {
-            if (auto handle = prom.lock()) {
-                handle->set_value();
-            }
-        } else {
-            _stream_stop_promises.push_back(prom);
-        }
-    }
+    void stop() { _streams.finish_all(); }
 
-    void unregister_stream_stop_promise(std::shared_ptr<std::promise<void>> prom)
-    {
-        for (auto it = _stream_stop_promises.begin(); it != _stream_stop_promises.end();
-             /* ++it */) {
-            if (it->lock() == prom) {
-                it = _stream_stop_promises.erase(it);
-            } else {
-                ++it;
-            }
-        }
-    }
+    const StreamStats& stream_stats() const { return _streams.stats(); }
 
+private:
     LazyServerPlugin& _lazy_plugin;
 
-    std::atomic<bool> _stopped{false};
-    std::vector<std::weak_ptr<std::promise<void>>> _stream_stop_promises{};
+    StreamList _streams{};
 };
 
 } // namespace mavsdk_server
@@ -10,6 +10,8 @@
 #include "lazy_plugin.h"
 
 #include "log.h"
+#include "stream_reactor.h"
+#include "system_selection.h"
 #include <atomic>
 #include <cmath>
 #include <future>
@@ -23,7 +25,10 @@ namespace mavsdk_server {
 
 template<typename Transponder = Transponder, typename LazyPlugin = LazyPlugin<Transponder>>
 
-class TransponderServiceImpl final : public rpc::transponder::TransponderService::Service {
+class TransponderServiceImpl final
+    : public WithCallbackMethods<
+          rpc::transponder::TransponderService::Service,
+          rpc::transponder::TransponderService::WithCallbackMethod_SubscribeTransponder> {
 public:
     TransponderServiceImpl(LazyPlugin& lazy_plugin) : _lazy_plugin(lazy_plugin) {}
 
@@ -32,13 +37,11 @@ public:
     {
         auto rpc_result = translateToRpcResult(result);
 
-        auto* rpc_transponder_result = new rpc::transponder::TransponderResult();
+        auto* rpc_transponder_result = response->mutable_transponder_result();
         rpc_transponder_result->set_result(rpc_result);
         std::stringstream ss;
         ss << result;
         rpc_transponder_result->set_result_str(ss.str());
-
-        response->set_allocated_transponder_result(rpc_transponder_result);
     }
 
     static rpc::transponder::AdsbEmitterType
@@ -173,11 +176,10 @@ public:
         }
     }
 
-    static std::unique_ptr<rpc::transponder::AdsbVehicle>
-    translateToRpcAdsbVehicle(const mavsdk::Transponder::AdsbVehicle& adsb_vehicle)
+    static void translateToRpcAdsbVehicle(
+        const mavsdk::Transponder::AdsbVehicle& adsb_vehicle,
+        rpc::transponder::AdsbVehicle* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::transponder::AdsbVehicle>();
-
         rpc_obj->set_icao_address(adsb_vehicle.icao_address);
 
         rpc_obj->set_latitude_deg(adsb_vehicle.latitude_deg);
@@ -201,8 +203,6 @@ public:
         rpc_obj->set_squawk(adsb_vehicle.squawk);
 
         rpc_obj->set_tslc_s(adsb_vehicle.tslc_s);
-
-        return rpc_obj;
     }
 
     static mavsdk::Transponder::AdsbVehicle
@@ -285,54 +285,44 @@ public:
         }
     }
 
-    grpc::Status SubscribeTransponder(
-        grpc::ServerContext* /* context */,
-        const mavsdk::rpc::transponder::SubscribeTransponderRequest* /* request */,
-        grpc::ServerWriter<rpc::transponder::TransponderResponse>* writer) override
+    grpc::ServerWriteReactor<rpc::transponder::TransponderResponse>* SubscribeTransponder(
+        grpc::CallbackServerContext* context,
+        const mavsdk::rpc::transponder::SubscribeTransponderRequest* /* request */) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
-            return grpc::Status::OK;
-        }
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        auto reactor = StreamReactor<rpc::transponder::TransponderResponse>::create();
 
-        auto stream_closed_promise = std::make_shared<std::promise<void>>();
-        auto stream_closed_future = stream_closed_promise->get_future();
-        register_stream_stop_promise(stream_closed_promise);
+        if (plugin == nullptr) {
+            reactor->finish();
+            return reactor.get();
+        }
 
-        auto is_finished = std::make_shared<bool>(false);
-        auto subscribe_mutex = std::make_shared<std::mutex>();
+        _streams.add(reactor);
 
         const mavsdk::Transponder::TransponderHandle handle =
-            _lazy_plugin.maybe_plugin()->subscribe_transponder(
-                [this, &writer, &stream_closed_promise, is_finished, subscribe_mutex, &handle](
-                    const mavsdk::Transponder::AdsbVehicle transponder) {
+            plugin->subscribe_transponder(
+                [reactor](const mavsdk::Transponder::AdsbVehicle transponder) {
                     rpc::transponder::TransponderResponse rpc_response;
 
-                    rpc_response.set_allocated_transponder(
-                        translateToRpcAdsbVehicle(transponder).release());
+                    translateToRpcAdsbVehicle(transponder, rpc_response.mutable_transponder());
 
-                    std::unique_lock<std::mutex> lock(*subscribe_mutex);
-                    if (!*is_finished && !writer->Write(rpc_response)) {
-                        _lazy_plugin.maybe_plugin()->unsubscribe_transponder(handle);
-
-                        *is_finished = true;
-                        unregister_stream_stop_promise(stream_closed_promise);
-                        stream_closed_promise->set_value();
-                    }
+                    reactor->write(std::move(rpc_response));
                 });
 
-        stream_closed_future.wait();
-        std::unique_lock<std::mutex> lock(*subscribe_mutex);
-        *is_finished = true;
+        reactor->set_on_done([plugin, handle]() { plugin->unsubscribe_transponder(handle); });
 
-        return grpc::Status::OK;
+        return reactor.get();
     }
 
     grpc::Status SetRateTransponder(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::transponder::SetRateTransponderRequest* request,
         rpc::transponder::SetRateTransponderResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Transponder::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -346,7 +336,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->set_rate_transponder(request->rate_hz());
+        auto result = plugin->set_rate_transponder(request->rate_hz());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -355,45 +345,14 @@ public:
         return grpc::Status::OK;
     }
 
-    void stop()
-    {
-        _stopped.store(true);
-        for (auto& prom : _stream_stop_promises) {
-            if (auto handle = prom.lock()) {
-                handle->set_value();
-            }
-        }
-    }
-
-private:
-    void register_stream_stop_promise(std::weak_ptr<std::promise<void>> prom)
-    {
-        // If we have already stopped, set promise immediately and don't add it to list.
-        if (_stopped.load()) {
-            if (auto handle = prom.lock()) {
-                handle->set_value();
-            }
-        } else {
-            _stream_stop_promises.push_back(prom);
-        }
-    }
+    void stop() { _streams.finish_all(); }
 
-    void unregister_stream_stop_promise(std::shared_ptr<std::promise<void>> prom)
-    {
-        for (auto it = _stream_stop_promises.begin(); it != _stream_stop_promises.end();
-             /* ++it */) {
-            if (it->lock() == prom) {
-                it = _stream_stop_promises.erase(it);
-            } else {
-                ++it;
-            }
-        }
-    }
+    const StreamStats& stream_stats() const { return _streams.stats(); }
 
+private:
     LazyPlugin& _lazy_plugin;
 
-    std::atomic<bool> _stopped{false};
-    std::vector<std::weak_ptr<std::promise<void>>> _stream_stop_promises{};
+    StreamList _streams{};
 };
 
 } // namespace mavsdk_server
@@ -10,6 +10,8 @@
 #include "lazy_plugin.h"
 
 #include "log.h"
+#include "stream_reactor.h"
+#include "system_selection.h"
 #include <atomic>
 #include <cmath>
 #include <future>
@@ -23,7 +25,7 @@ namespace mavsdk_server {
 
 template<typename Tune = Tune, typename LazyPlugin = LazyPlugin<Tune>>
 
-class TuneServiceImpl final : public rpc::tune::TuneService::Service {
+class TuneServiceImpl final : public WithCallbackMethods<rpc::tune::TuneService::Service> {
 public:
     TuneServiceImpl(LazyPlugin& lazy_plugin) : _lazy_plugin(lazy_plugin) {}
 
@@ -32,13 +34,11 @@ public:
     {
         auto rpc_result = translateToRpcResult(result);
 
-        auto* rpc_tune_result = new rpc::tune::TuneResult();
+        auto* rpc_tune_result = response->mutable_tune_result();
         rpc_tune_result->set_result(rpc_result);
         std::stringstream ss;
         ss << result;
         rpc_tune_result->set_result_str(ss.str());
-
-        response->set_allocated_tune_result(rpc_tune_result);
     }
 
     static rpc::tune::SongElement
@@ -145,18 +145,14 @@ public:
         }
     }
 
-    static std::unique_ptr<rpc::tune::TuneDescription>
-    translateToRpcTuneDescription(const mavsdk::Tune::TuneDescription& tune_description)
+    static void translateToRpcTuneDescription(
+        const mavsdk::Tune::TuneDescription& tune_description, rpc::tune::TuneDescription* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::tune::TuneDescription>();
-
         for (const auto& elem : tune_description.song_elements) {
             rpc_obj->add_song_elements(translateToRpcSongElement(elem));
         }
 
         rpc_obj->set_tempo(tune_description.tempo);
-
-        return rpc_obj;
     }
 
     static mavsdk::Tune::TuneDescription
@@ -217,11 +213,13 @@ public:
     }
 
     grpc::Status PlayTune(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::tune::PlayTuneRequest* request,
         rpc::tune::PlayTuneResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Tune::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -235,7 +233,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->play_tune(
+        auto result = plugin->play_tune(
             translateFromRpcTuneDescription(request->tune_description()));
 
         if (response != nullptr) {
@@ -245,45 +243,14 @@ public:
         return grpc::Status::OK;
     }
 
-    void stop()
-    {
-        _stopped.store(true);
-        for (auto& prom : _stream_stop_promises) {
-            if (auto handle = prom.lock()) {
-                handle->set_value();
-            }
-        }
-    }
+    void stop() { _streams.finish_all(); }
 
-private:
-    void register_stream_stop_promise(std::weak_ptr<std::promise<void>> prom)
-    {
-        // If we have already stopped, set promise immediately and don't add it to list.
-        if (_stopped.load()) {
-            if (auto handle = prom.lock()) {
-                handle->set_value();
-            }
-        } else {
-            _stream_stop_promises.push_back(prom);
-        }
-    }
-
-    void unregister_stream_stop_promise(std::shared_ptr<std::promise<void>> prom)
-    {
-        for (auto it = _stream_stop_promises.begin(); it != _stream_stop_promises.end();
-             /* ++it */) {
-            if (it->lock() == prom) {
-                it = _stream_stop_promises.erase(it);
-            } else {
-                ++it;
-            }
-        }
-    }
+    const StreamStats& stream_stats() const { return _streams.stats(); }
 
+private:
     LazyPlugin& _lazy_plugin;
 
-    std::atomic<bool> _stopped{false};
-    std::vector<std::weak_ptr<std::promise<void>>> _stream_stop_promises{};
+    StreamList _streams{};
 };
 
 } // namespace mavsdk_server
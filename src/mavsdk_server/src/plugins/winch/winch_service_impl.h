@@ -10,6 +10,8 @@
 #include "lazy_plugin.h"
 
 #include "log.h"
+#include "stream_reactor.h"
+#include "system_selection.h"
 #include <atomic>
 #include <cmath>
 #include <future>
@@ -23,7 +25,10 @@ namespace mavsdk_server {
 
 template<typename Winch = Winch, typename LazyPlugin = LazyPlugin<Winch>>
 
-class WinchServiceImpl final : public rpc::winch::WinchService::Service {
+class WinchServiceImpl final
+    : public WithCallbackMethods<
+          rpc::winch::WinchService::Service,
+          rpc::winch::WinchService::WithCallbackMethod_SubscribeStatus> {
 public:
     WinchServiceImpl(LazyPlugin& lazy_plugin) : _lazy_plugin(lazy_plugin) {}
 
@@ -32,13 +37,11 @@ public:
     {
         auto rpc_result = translateToRpcResult(result);
 
-        auto* rpc_winch_result = new rpc::winch::WinchResult();
+        auto* rpc_winch_result = response->mutable_winch_result();
         rpc_winch_result->set_result(rpc_result);
         std::stringstream ss;
         ss << result;
         rpc_winch_result->set_result_str(ss.str());
-
-        response->set_allocated_winch_result(rpc_winch_result);
     }
 
     static rpc::winch::WinchAction
@@ -101,11 +104,9 @@ public:
         }
     }
 
-    static std::unique_ptr<rpc::winch::StatusFlags>
-    translateToRpcStatusFlags(const mavsdk::Winch::StatusFlags& status_flags)
+    static void translateToRpcStatusFlags(
+        const mavsdk::Winch::StatusFlags& status_flags, rpc::winch::StatusFlags* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::winch::StatusFlags>();
-
         rpc_obj->set_healthy(status_flags.healthy);
 
         rpc_obj->set_fully_retracted(status_flags.fully_retracted);
@@ -133,8 +134,6 @@ public:
         rpc_obj->set_load_line(status_flags.load_line);
 
         rpc_obj->set_load_payload(status_flags.load_payload);
-
-        return rpc_obj;
     }
 
     static mavsdk::Winch::StatusFlags
@@ -173,11 +172,9 @@ public:
         return obj;
     }
 
-    static std::unique_ptr<rpc::winch::Status>
-    translateToRpcStatus(const mavsdk::Winch::Status& status)
+    static void translateToRpcStatus(
+        const mavsdk::Winch::Status& status, rpc::winch::Status* rpc_obj)
     {
-        auto rpc_obj = std::make_unique<rpc::winch::Status>();
-
         rpc_obj->set_time_usec(status.time_usec);
 
         rpc_obj->set_line_length_m(status.line_length_m);
@@ -192,10 +189,7 @@ public:
 
         rpc_obj->set_temperature_c(status.temperature_c);
 
-        rpc_obj->set_allocated_status_flags(
-            translateToRpcStatusFlags(status.status_flags).release());
-
-        return rpc_obj;
+        translateToRpcStatusFlags(status.status_flags, rpc_obj->mutable_status_flags());
     }
 
     static mavsdk::Winch::Status translateFromRpcStatus(const rpc::winch::Status& status)
@@ -268,52 +262,43 @@ public:
         }
     }
 
-    grpc::Status SubscribeStatus(
-        grpc::ServerContext* /* context */,
-        const mavsdk::rpc::winch::SubscribeStatusRequest* /* request */,
-        grpc::ServerWriter<rpc::winch::StatusResponse>* writer) override
+    grpc::ServerWriteReactor<rpc::winch::StatusResponse>* SubscribeStatus(
+        grpc::CallbackServerContext* context,
+        const mavsdk::rpc::winch::SubscribeStatusRequest* /* request */) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
-            return grpc::Status::OK;
-        }
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
 
-        auto stream_closed_promise = std::make_shared<std::promise<void>>();
-        auto stream_closed_future = stream_closed_promise->get_future();
-        register_stream_stop_promise(stream_closed_promise);
+        auto reactor = StreamReactor<rpc::winch::StatusResponse>::create();
 
-        auto is_finished = std::make_shared<bool>(false);
-        auto subscribe_mutex = std::make_shared<std::mutex>();
+        if (plugin == nullptr) {
+            reactor->finish();
+            return reactor.get();
+        }
 
-        const mavsdk::Winch::StatusHandle handle = _lazy_plugin.maybe_plugin()->subscribe_status(
-            [this, &writer, &stream_closed_promise, is_finished, subscribe_mutex, &handle](
-                const mavsdk::Winch::Status status) {
-                rpc::winch::StatusResponse rpc_response;
+        _streams.add(reactor);
 
-                rpc_response.set_allocated_status(translateToRpcStatus(status).release());
+        const mavsdk::Winch::StatusHandle handle = plugin->subscribe_status(
+            [reactor](const mavsdk::Winch::Status status) {
+                rpc::winch::StatusResponse rpc_response;
 
-                std::unique_lock<std::mutex> lock(*subscribe_mutex);
-                if (!*is_finished && !writer->Write(rpc_response)) {
-                    _lazy_plugin.maybe_plugin()->unsubscribe_status(handle);
+                translateToRpcStatus(status, rpc_response.mutable_status());
 
-                    *is_finished = true;
-                    unregister_stream_stop_promise(stream_closed_promise);
-                    stream_closed_promise->set_value();
-                }
+                reactor->write(std::move(rpc_response));
             });
 
-        stream_closed_future.wait();
-        std::unique_lock<std::mutex> lock(*subscribe_mutex);
-        *is_finished = true;
+        reactor->set_on_done([plugin, handle]() { plugin->unsubscribe_status(handle); });
 
-        return grpc::Status::OK;
+        return reactor.get();
     }
 
     grpc::Status Relax(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::winch::RelaxRequest* request,
         rpc::winch::RelaxResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Winch::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -327,7 +312,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->relax(request->instance());
+        auto result = plugin->relax(request->instance());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -337,11 +322,13 @@ public:
     }
 
     grpc::Status RelativeLengthControl(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::winch::RelativeLengthControlRequest* request,
         rpc::winch::RelativeLengthControlResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Winch::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -355,7 +342,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->relative_length_control(
+        auto result = plugin->relative_length_control(
             request->instance(), request->length_m(), request->rate_m_s());
 
         if (response != nullptr) {
@@ -366,11 +353,13 @@ public:
     }
 
     grpc::Status RateControl(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::winch::RateControlRequest* request,
         rpc::winch::RateControlResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Winch::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -385,7 +374,7 @@ public:
         }
 
         auto result =
-            _lazy_plugin.maybe_plugin()->rate_control(request->instance(), request->rate_m_s());
+            plugin->rate_control(request->instance(), request->rate_m_s());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -395,11 +384,13 @@ public:
     }
 
     grpc::Status Lock(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::winch::LockRequest* request,
         rpc::winch::LockResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Winch::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -413,7 +404,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->lock(request->instance());
+        auto result = plugin->lock(request->instance());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -423,11 +414,13 @@ public:
     }
 
     grpc::Status Deliver(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::winch::DeliverRequest* request,
         rpc::winch::DeliverResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Winch::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -441,7 +434,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->deliver(request->instance());
+        auto result = plugin->deliver(request->instance());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -451,11 +444,13 @@ public:
     }
 
     grpc::Status Hold(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::winch::HoldRequest* request,
         rpc::winch::HoldResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Winch::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -469,7 +464,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->hold(request->instance());
+        auto result = plugin->hold(request->instance());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -479,11 +474,13 @@ public:
     }
 
     grpc::Status Retract(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::winch::RetractRequest* request,
         rpc::winch::RetractResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Winch::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -497,7 +494,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->retract(request->instance());
+        auto result = plugin->retract(request->instance());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -507,11 +504,13 @@ public:
     }
 
     grpc::Status LoadLine(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::winch::LoadLineRequest* request,
         rpc::winch::LoadLineResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Winch::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -525,7 +524,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->load_line(request->instance());
+        auto result = plugin->load_line(request->instance());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -535,11 +534,13 @@ public:
     }
 
     grpc::Status AbandonLine(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::winch::AbandonLineRequest* request,
         rpc::winch::AbandonLineResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Winch::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -553,7 +554,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->abandon_line(request->instance());
+        auto result = plugin->abandon_line(request->instance());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -563,11 +564,13 @@ public:
     }
 
     grpc::Status LoadPayload(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::winch::LoadPayloadRequest* request,
         rpc::winch::LoadPayloadResponse* response) override
     {
-        if (_lazy_plugin.maybe_plugin() == nullptr) {
+        auto* plugin = _lazy_plugin.maybe_plugin(system_id_from_context(context));
+
+        if (plugin == nullptr) {
             if (response != nullptr) {
                 auto result = mavsdk::Winch::Result::NoSystem;
                 fillResponseWithResult(response, result);
@@ -581,7 +584,7 @@ public:
             return grpc::Status::OK;
         }
 
-        auto result = _lazy_plugin.maybe_plugin()->load_payload(request->instance());
+        auto result = plugin->load_payload(request->instance());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -590,45 +593,14 @@ public:
         return grpc::Status::OK;
     }
 
-    void stop()
-    {
-        _stopped.store(true);
-        for (auto& prom : _stream_stop_promises) {
-            if (auto handle = prom.lock()) {
-                handle->set_value();
-            }
-        }
-    }
-
-private:
-    void register_stream_stop_promise(std::weak_ptr<std::promise<void>> prom)
-    {
-        // If we have already stopped, set promise immediately and don't add it to list.
-        if (_stopped.load()) {
-            if (auto handle = prom.lock()) {
-                handle->set_value();
-            }
-        } else {
-            _stream_stop_promises.push_back(prom);
-        }
-    }
+    void stop() { _streams.finish_all(); }
 
-    void unregister_stream_stop_promise(std::shared_ptr<std::promise<void>> prom)
-    {
-        for (auto it = _stream_stop_promises.begin(); it != _stream_stop_promises.end();
-             /* ++it */) {
-            if (it->lock() == prom) {
-                it = _stream_stop_promises.erase(it);
-            } else {
-                ++it;
-            }
-        }
-    }
+    const StreamStats& stream_stats() const { return _streams.stats(); }
 
+private:
     LazyPlugin& _lazy_plugin;
 
-    std::atomic<bool> _stopped{false};
-    std::vector<std::weak_ptr<std::promise<void>>> _stream_stop_promises{};
+    StreamList _streams{};
 };
 
 } // namespace mavsdk_server
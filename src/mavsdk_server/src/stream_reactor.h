@@ -0,0 +1,318 @@
+#pragma once
+
+#include <grpcpp/grpcpp.h>
+
+#include "log.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace mavsdk {
+namespace mavsdk_server {
+
+// Applies the WithCallbackMethod_<Method> templates generated by gRPC to a
+// service, so that only the listed methods use the callback API:
+// WithCallbackMethods<Service, A, B> is A<B<Service>>.
+template<typename Service, template<typename> class... Methods> struct CallbackMethods;
+
+template<typename Service> struct CallbackMethods<Service> {
+    using type = Service;
+};
+
+template<typename Service, template<typename> class Method, template<typename> class... Methods>
+struct CallbackMethods<Service, Method, Methods...> {
+    using type = Method<typename CallbackMethods<Service, Methods...>::type>;
+};
+
+template<typename Service, template<typename> class... Methods>
+using WithCallbackMethods = typename CallbackMethods<Service, Methods...>::type;
+
+// What to do with responses while the client is still busy with earlier ones.
+enum class OutboxPolicy {
+    // Only keep the latest, e.g. for telemetry where older values are stale.
+    Conflate,
+    // Keep them all, up to a limit, e.g. for events. The oldest are dropped
+    // beyond the limit.
+    Queue,
+};
+
+// Counters of all streams of a service, for the metrics.
+struct StreamStats {
+    std::atomic<uint64_t> active{0};
+    std::atomic<uint64_t> written{0};
+    // Replaced by a newer response, or dropped because the client was too slow.
+    std::atomic<uint64_t> dropped{0};
+    // Time from handing a response to gRPC until it is written.
+    std::atomic<uint64_t> write_time_ns{0};
+};
+
+class FinishableStream {
+public:
+    virtual ~FinishableStream() = default;
+    virtual void finish() = 0;
+    virtual void set_stats(std::shared_ptr<StreamStats> stats) = 0;
+};
+
+// Server side of a streaming RPC using the gRPC callback API, so that an open
+// stream does not park a thread of the server.
+//
+// Responses are written from any thread, usually from a MAVSDK callback. They
+// are queued and handed to gRPC one after the other, so the caller never
+// waits for the client. How much is kept for a slow client depends on the
+// policy of the stream.
+//
+// The reactor owns itself until gRPC is done with the call. Callbacks should
+// hold it by shared_ptr, writes after the stream is finished are dropped.
+template<typename Response>
+class StreamReactor : public grpc::ServerWriteReactor<Response>, public FinishableStream {
+public:
+    static constexpr std::size_t MAX_QUEUED = 100;
+
+    static std::shared_ptr<StreamReactor> create(OutboxPolicy policy = OutboxPolicy::Queue)
+    {
+        auto reactor = std::shared_ptr<StreamReactor>(new StreamReactor(policy));
+        reactor->_self = reactor;
+        return reactor;
+    }
+
+    ~StreamReactor() override = default;
+
+    void write(Response response)
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (_finished) {
+                return;
+            }
+            if (_writing) {
+                queue_locked(std::move(response));
+                return;
+            }
+            _current = std::move(response);
+            _writing = true;
+            _write_started = std::chrono::steady_clock::now();
+        }
+        this->StartWrite(&_current);
+    }
+
+    // Finishes the stream once everything queued is written.
+    void finish() override
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (_finished) {
+                return;
+            }
+            _finished = true;
+            if (_writing) {
+                return;
+            }
+            _writing = true;
+        }
+        this->Finish(grpc::Status::OK);
+    }
+
+    // Set once, before anything is written.
+    void set_stats(std::shared_ptr<StreamStats> stats) override
+    {
+        stats->active++;
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stats = std::move(stats);
+    }
+
+    // Called once when the stream is done, e.g. to unsubscribe. Called right
+    // away if it is done already.
+    void set_on_done(std::function<void()> on_done)
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (!_done) {
+                _on_done = std::move(on_done);
+                return;
+            }
+        }
+        on_done();
+    }
+
+    void OnWriteDone(bool ok) override
+    {
+        bool has_next = false;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (_stats != nullptr) {
+                if (ok) {
+                    _stats->written++;
+                    _stats->write_time_ns +=
+                        static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                                  std::chrono::steady_clock::now() - _write_started)
+                                                  .count());
+                } else {
+                    _stats->dropped += 1 + _queued.size();
+                }
+            }
+            if (!ok) {
+                // The client is gone, nothing else will get through.
+                _finished = true;
+                _queued.clear();
+            }
+            if (!_queued.empty()) {
+                // gRPC is done with the current one, it can be replaced.
+                _current = std::move(_queued.front());
+                _queued.pop_front();
+                _write_started = std::chrono::steady_clock::now();
+                has_next = true;
+            } else if (!_finished) {
+                _writing = false;
+                return;
+            }
+        }
+
+        if (has_next) {
+            this->StartWrite(&_current);
+        } else {
+            this->Finish(grpc::Status::OK);
+        }
+    }
+
+    void OnCancel() override
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (_finished) {
+                return;
+            }
+            _finished = true;
+            if (_stats != nullptr) {
+                _stats->dropped += _queued.size();
+            }
+            _queued.clear();
+            if (_writing) {
+                return;
+            }
+            _writing = true;
+        }
+        this->Finish(grpc::Status::CANCELLED);
+    }
+
+    void OnDone() override
+    {
+        std::function<void()> on_done;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _done = true;
+            std::swap(on_done, _on_done);
+            if (_stats != nullptr) {
+                _stats->active--;
+            }
+        }
+        if (on_done) {
+            on_done();
+        }
+
+        // This might delete us, nothing can come after it.
+        _self.reset();
+    }
+
+    // Non-copyable
+    StreamReactor(const StreamReactor&) = delete;
+    const StreamReactor& operator=(const StreamReactor&) = delete;
+
+private:
+    explicit StreamReactor(OutboxPolicy policy) : _policy(policy) {}
+
+    // Needs _mutex, while the current response is being written.
+    void queue_locked(Response response)
+    {
+        if (_policy == OutboxPolicy::Conflate) {
+            if (_stats != nullptr) {
+                _stats->dropped += _queued.size();
+            }
+            _queued.clear();
+        } else if (_queued.size() >= MAX_QUEUED) {
+            if (!_has_dropped) {
+                LogWarn() << "Client too slow, dropping stream responses";
+                _has_dropped = true;
+            }
+            if (_stats != nullptr) {
+                _stats->dropped++;
+            }
+            _queued.pop_front();
+        }
+        _queued.push_back(std::move(response));
+    }
+
+    const OutboxPolicy _policy;
+
+    std::mutex _mutex{};
+    // Handed to gRPC, if _writing.
+    Response _current{};
+    std::deque<Response> _queued{};
+    bool _writing{false};
+    bool _finished{false};
+    bool _done{false};
+    bool _has_dropped{false};
+    std::function<void()> _on_done{};
+    std::shared_ptr<StreamStats> _stats{};
+    std::chrono::steady_clock::time_point _write_started{};
+
+    std::shared_ptr<StreamReactor> _self{};
+};
+
+// The open streams of a service, so they can be finished when the server
+// stops.
+class StreamList {
+public:
+    void add(const std::shared_ptr<FinishableStream>& stream)
+    {
+        stream->set_stats(_stats);
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (!_stopped) {
+                for (auto it = _streams.begin(); it != _streams.end();) {
+                    if (it->expired()) {
+                        it = _streams.erase(it);
+                    } else {
+                        ++it;
+                    }
+                }
+                _streams.push_back(stream);
+                return;
+            }
+        }
+        stream->finish();
+    }
+
+    void finish_all()
+    {
+        std::vector<std::weak_ptr<FinishableStream>> streams;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stopped = true;
+            std::swap(streams, _streams);
+        }
+        for (auto& stream : streams) {
+            if (auto handle = stream.lock()) {
+                handle->finish();
+            }
+        }
+    }
+
+    const StreamStats& stats() const { return *_stats; }
+
+private:
+    const std::shared_ptr<StreamStats> _stats{std::make_shared<StreamStats>()};
+
+    std::mutex _mutex{};
+    bool _stopped{false};
+    std::vector<std::weak_ptr<FinishableStream>> _streams{};
+};
+
+} // namespace mavsdk_server
+} // namespace mavsdk
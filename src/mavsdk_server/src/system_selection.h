@@ -0,0 +1,49 @@
+#pragma once
+
+#include <grpcpp/grpcpp.h>
+
+#include <cctype>
+#include <cstdint>
+#include <cstdlib>
+#include <optional>
+#include <string>
+
+namespace mavsdk {
+namespace mavsdk_server {
+
+// Clients choose the system a call is for with its system id in the call
+// metadata, so that one server can serve a whole fleet. Without it, calls go
+// to the first system, as they always did.
+static constexpr const char* SYSTEM_ID_METADATA_KEY = "mavsdk-system-id";
+
+// The system id in a metadata value, std::nullopt if it isn't one.
+inline std::optional<uint8_t> parse_system_id(const std::string& value)
+{
+    char* end = nullptr;
+    const auto system_id = std::strtoul(value.c_str(), &end, 10);
+    if (value.empty() || !std::isdigit(static_cast<unsigned char>(value[0])) || *end != '\0' ||
+        system_id == 0 || system_id > 255) {
+        return std::nullopt;
+    }
+    return static_cast<uint8_t>(system_id);
+}
+
+// 0 means no system was chosen. std::nullopt means a system id was given but
+// isn't valid, and the call must fail rather than go to some other system.
+inline std::optional<uint8_t> system_id_from_context(const grpc::ServerContextBase* context)
+{
+    if (context == nullptr) {
+        return 0;
+    }
+
+    const auto& metadata = context->client_metadata();
+    const auto it = metadata.find(SYSTEM_ID_METADATA_KEY);
+    if (it == metadata.end()) {
+        return 0;
+    }
+
+    return parse_system_id(std::string(it->second.data(), it->second.size()));
+}
+
+} // namespace mavsdk_server
+} // namespace mavsdk
@@ -0,0 +1,197 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <grpcpp/generic/async_generic_service.h>
+#include <grpcpp/server.h>
+#include <grpcpp/server_builder.h>
+
+#include "in_process_client.h"
+
+namespace {
+
+using mavsdk::mavsdk_server::InProcessClient;
+
+// Sends the request back: once for Unary, three times for Stream, and once
+// for Forever which then only ends when cancelled.
+class EchoReactor : public grpc::ServerGenericBidiReactor {
+public:
+    explicit EchoReactor(const std::string& method) : _method(method) { StartRead(&_request); }
+
+    void OnReadDone(bool ok) override
+    {
+        if (!ok) {
+            Finish(grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, "no request"));
+            return;
+        }
+        _remaining = _method == "/test.Echo/Stream" ? 3 : 1;
+        write();
+    }
+
+    void OnWriteDone(bool ok) override
+    {
+        if (ok) {
+            write();
+        }
+    }
+
+    void OnCancel() override
+    {
+        if (_method == "/test.Echo/Forever") {
+            Finish(grpc::Status::CANCELLED);
+        }
+    }
+
+    void OnDone() override { delete this; }
+
+private:
+    void write()
+    {
+        if (_remaining > 0) {
+            --_remaining;
+            StartWrite(&_request);
+        } else if (_method != "/test.Echo/Forever") {
+            Finish(grpc::Status::OK);
+        }
+    }
+
+    const std::string _method;
+    grpc::ByteBuffer _request{};
+    int _remaining{0};
+};
+
+class EchoService : public grpc::CallbackGenericService {
+    grpc::ServerGenericBidiReactor* CreateReactor(grpc::GenericCallbackServerContext* context)
+        override
+    {
+        return new EchoReactor(context->method());
+    }
+};
+
+class Responses {
+public:
+    InProcessClient::ResponseCallback callback()
+    {
+        return [this](const uint8_t* data, size_t size, int status_code) {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (data != nullptr) {
+                _messages.emplace_back(reinterpret_cast<const char*>(data), size);
+            } else {
+                _status_code = status_code;
+                _done = true;
+            }
+            _cv.notify_all();
+        };
+    }
+
+    bool wait_for_messages(size_t count)
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        return _cv.wait_for(
+            lock, std::chrono::seconds(5), [&]() { return _messages.size() >= count; });
+    }
+
+    bool wait_until_done()
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        return _cv.wait_for(lock, std::chrono::seconds(5), [&]() { return _done; });
+    }
+
+    std::vector<std::string> messages()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _messages;
+    }
+
+    int status_code()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _status_code;
+    }
+
+private:
+    std::mutex _mutex{};
+    std::condition_variable _cv{};
+    std::vector<std::string> _messages{};
+    int _status_code{-1};
+    bool _done{false};
+};
+
+class InProcessClientTest : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        grpc::ServerBuilder builder;
+        builder.RegisterCallbackGenericService(&_service);
+        _server = builder.BuildAndStart();
+        ASSERT_NE(_server, nullptr);
+        _client = std::make_unique<InProcessClient>(
+            _server->InProcessChannel(grpc::ChannelArguments()));
+    }
+
+    void TearDown() override
+    {
+        _client.reset();
+        _server->Shutdown();
+    }
+
+    static const uint8_t* bytes(const std::string& text)
+    {
+        return reinterpret_cast<const uint8_t*>(text.data());
+    }
+
+    EchoService _service{};
+    std::unique_ptr<grpc::Server> _server{};
+    std::unique_ptr<InProcessClient> _client{};
+};
+
+TEST_F(InProcessClientTest, unaryCallGetsResponse)
+{
+    const std::string request{"hello"};
+    Responses responses;
+    _client->call("/test.Echo/Unary", bytes(request), request.size(), responses.callback());
+
+    ASSERT_TRUE(responses.wait_until_done());
+    EXPECT_EQ(responses.messages(), std::vector<std::string>{"hello"});
+    EXPECT_EQ(responses.status_code(), grpc::StatusCode::OK);
+}
+
+TEST_F(InProcessClientTest, subscriptionGetsAllResponsesThenStatus)
+{
+    const std::string request{"position"};
+    Responses responses;
+    auto subscription = _client->subscribe(
+        "/test.Echo/Stream", bytes(request), request.size(), responses.callback());
+
+    ASSERT_TRUE(responses.wait_until_done());
+    EXPECT_EQ(responses.messages().size(), 3u);
+    EXPECT_EQ(responses.messages().back(), "position");
+    EXPECT_EQ(responses.status_code(), grpc::StatusCode::OK);
+}
+
+TEST_F(InProcessClientTest, emptyResponseIsNotTheEnd)
+{
+    Responses responses;
+    auto subscription = _client->subscribe("/test.Echo/Stream", nullptr, 0, responses.callback());
+
+    ASSERT_TRUE(responses.wait_until_done());
+    EXPECT_EQ(responses.messages(), std::vector<std::string>(3, ""));
+}
+
+TEST_F(InProcessClientTest, destroyingSubscriptionCancelsIt)
+{
+    const std::string request{"forever"};
+    Responses responses;
+    auto subscription = _client->subscribe(
+        "/test.Echo/Forever", bytes(request), request.size(), responses.callback());
+
+    ASSERT_TRUE(responses.wait_for_messages(1));
+    subscription.reset();
+    EXPECT_EQ(responses.status_code(), grpc::StatusCode::CANCELLED);
+}
+
+} // namespace
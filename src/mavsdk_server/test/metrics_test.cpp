@@ -0,0 +1,75 @@
+#include <gtest/gtest.h>
+#include <string>
+
+#include "metrics.h"
+
+namespace {
+
+using mavsdk::mavsdk_server::Metrics;
+
+TEST(Metrics, IsEmptyWithoutSamples)
+{
+    Metrics metrics;
+    EXPECT_EQ("", metrics.to_text());
+}
+
+TEST(Metrics, WritesHelpAndTypeOncePerMetric)
+{
+    Metrics metrics;
+    metrics.add_counter("requests_total", "Requests handled.", {{"service", "action"}}, 3);
+    metrics.add_gauge("active_streams", "Streams open.", {}, 2);
+    metrics.add_counter("requests_total", "Requests handled.", {{"service", "telemetry"}}, 5);
+
+    EXPECT_EQ(
+        "# HELP active_streams Streams open.\n"
+        "# TYPE active_streams gauge\n"
+        "active_streams 2\n"
+        "# HELP requests_total Requests handled.\n"
+        "# TYPE requests_total counter\n"
+        "requests_total{service=\"action\"} 3\n"
+        "requests_total{service=\"telemetry\"} 5\n",
+        metrics.to_text());
+}
+
+TEST(Metrics, WritesSummaryAsSumAndCount)
+{
+    Metrics metrics;
+    metrics.add_summary("write_seconds", "Write time.", {{"service", "mission"}}, 0.25, 10);
+
+    EXPECT_EQ(
+        "# HELP write_seconds Write time.\n"
+        "# TYPE write_seconds summary\n"
+        "write_seconds_sum{service=\"mission\"} 0.25\n"
+        "write_seconds_count{service=\"mission\"} 10\n",
+        metrics.to_text());
+}
+
+TEST(Metrics, WritesMultipleLabels)
+{
+    Metrics metrics;
+    metrics.add_counter(
+        "messages_total", "Messages.", {{"system_id", "1"}, {"component_id", "190"}}, 42);
+
+    EXPECT_NE(
+        std::string::npos,
+        metrics.to_text().find("messages_total{system_id=\"1\",component_id=\"190\"} 42\n"));
+}
+
+TEST(Metrics, EscapesLabelValues)
+{
+    Metrics metrics;
+    metrics.add_gauge("info", "Info.", {{"path", "C:\\dir \"a\"\nb"}}, 1);
+
+    EXPECT_NE(
+        std::string::npos, metrics.to_text().find("info{path=\"C:\\\\dir \\\"a\\\"\\nb\"} 1\n"));
+}
+
+TEST(Metrics, WritesLargeCountsWithoutExponent)
+{
+    Metrics metrics;
+    metrics.add_counter("bytes_total", "Bytes.", {}, 12345678901.0);
+
+    EXPECT_NE(std::string::npos, metrics.to_text().find("bytes_total 12345678901\n"));
+}
+
+} // namespace
@@ -206,9 +206,8 @@ std::shared_ptr<UploadMissionRequest> MissionServiceImplUploadTest::generateUplo
     auto rpc_mission_plan = request->mutable_mission_plan();
 
     for (const auto& mission_item : mission_plan.mission_items) {
-        auto* rpc_mission_item = rpc_mission_plan->add_mission_items();
-        rpc_mission_item->CopyFrom(
-            *MissionServiceImpl::translateToRpcMissionItem(mission_item).release());
+        MissionServiceImpl::translateToRpcMissionItem(
+            mission_item, rpc_mission_plan->add_mission_items());
     }
 
     return request;
@@ -0,0 +1,139 @@
+#include <gtest/gtest.h>
+#include <memory>
+#include <vector>
+
+#include "core/performance_stats.h"
+
+namespace mavsdk {
+template<typename... Args> class FakeHandle {
+public:
+    static mavsdk::Handle<Args...> create() { return mavsdk::Handle<Args...>(0); }
+};
+} // namespace mavsdk
+
+namespace {
+
+using namespace std::chrono_literals;
+
+using mavsdk::LinkStats;
+using mavsdk::MessageStats;
+
+struct FakeSystem {
+    uint8_t get_system_id() const { return system_id; }
+    bool is_connected() const { return connected; }
+    mavsdk::RttStats rtt_stats() const { return rtt; }
+    std::vector<MessageStats> message_stats() const { return messages; }
+
+    uint8_t system_id{1};
+    bool connected{true};
+    mavsdk::RttStats rtt{};
+    std::vector<MessageStats> messages{};
+};
+
+struct FakeMavsdk {
+    using LinkStatsCallback = mavsdk::Mavsdk::LinkStatsCallback;
+    using LinkStatsHandle = mavsdk::Mavsdk::LinkStatsHandle;
+
+    LinkStatsHandle subscribe_link_stats(const LinkStatsCallback& callback)
+    {
+        link_stats_callback = callback;
+        return mavsdk::FakeHandle<std::vector<LinkStats>>::create();
+    }
+
+    void unsubscribe_link_stats(LinkStatsHandle) { link_stats_callback = nullptr; }
+
+    std::vector<std::shared_ptr<FakeSystem>> systems() const { return fake_systems; }
+
+    mavsdk::Mavsdk::CallbackQueueStats callback_queue_stats() const { return queue; }
+
+    LinkStatsCallback link_stats_callback{};
+    std::vector<std::shared_ptr<FakeSystem>> fake_systems{};
+    mavsdk::Mavsdk::CallbackQueueStats queue{};
+};
+
+using PerformanceSampler = mavsdk::mavsdk_server::PerformanceSampler<FakeMavsdk>;
+
+MessageStats createMessageStats(uint64_t received_count, uint64_t received_bytes)
+{
+    MessageStats stats;
+    stats.received_count = received_count;
+    stats.received_bytes = received_bytes;
+    return stats;
+}
+
+TEST(PerformanceSampler, keepsOnlyLatestLinkStats)
+{
+    FakeMavsdk mavsdk;
+    {
+        PerformanceSampler sampler(mavsdk);
+        ASSERT_TRUE(mavsdk.link_stats_callback);
+
+        LinkStats first;
+        first.parse_errors = 1;
+        LinkStats second;
+        second.parse_errors = 2;
+        mavsdk.link_stats_callback({first});
+        mavsdk.link_stats_callback({second});
+
+        const auto stats = sampler.sample();
+        ASSERT_EQ(stats.links.size(), 1u);
+        EXPECT_EQ(stats.links[0].parse_errors, 2u);
+    }
+    EXPECT_FALSE(mavsdk.link_stats_callback);
+}
+
+TEST(PerformanceSampler, ratesAreOverTheIntervalSinceLastSample)
+{
+    FakeMavsdk mavsdk;
+    auto system = std::make_shared<FakeSystem>();
+    system->rtt.mean_s = 0.02;
+    system->messages = {createMessageStats(10, 100), createMessageStats(5, 50)};
+    mavsdk.fake_systems.push_back(system);
+
+    PerformanceSampler sampler(mavsdk);
+    const auto start = PerformanceSampler::Clock::now();
+
+    const auto first = sampler.sample(start);
+    ASSERT_EQ(first.systems.size(), 1u);
+    EXPECT_EQ(first.systems[0].system_id, 1);
+    EXPECT_TRUE(first.systems[0].is_connected);
+    EXPECT_DOUBLE_EQ(first.systems[0].rtt.mean_s, 0.02);
+    EXPECT_DOUBLE_EQ(first.systems[0].received_messages_per_s, 0.0);
+
+    system->messages = {createMessageStats(30, 300), createMessageStats(5, 50)};
+    const auto second = sampler.sample(start + 2s);
+    ASSERT_EQ(second.systems.size(), 1u);
+    EXPECT_DOUBLE_EQ(second.systems[0].received_messages_per_s, 10.0);
+    EXPECT_DOUBLE_EQ(second.systems[0].received_bytes_per_s, 100.0);
+    EXPECT_DOUBLE_EQ(second.systems[0].sent_messages_per_s, 0.0);
+}
+
+TEST(PerformanceSampler, callbackLatencyIsOverTheIntervalSinceLastSample)
+{
+    FakeMavsdk mavsdk;
+    mavsdk.queue.depth = 3;
+    mavsdk.queue.max_depth = 7;
+    mavsdk.queue.wait_time.total_count = 2;
+    mavsdk.queue.wait_time.total_ns = 2'000'000;
+    mavsdk.queue.wait_time.max_ns = 1'500'000;
+
+    PerformanceSampler sampler(mavsdk);
+
+    const auto first = sampler.sample();
+    EXPECT_EQ(first.callback_queue.depth, 3u);
+    EXPECT_EQ(first.callback_queue.max_depth, 7u);
+    EXPECT_DOUBLE_EQ(first.callback_queue.mean_wait_s, 0.001);
+    EXPECT_DOUBLE_EQ(first.callback_queue.max_wait_s, 0.0015);
+    EXPECT_DOUBLE_EQ(first.callback_queue.mean_run_s, 0.0);
+
+    mavsdk.queue.wait_time.total_count = 4;
+    mavsdk.queue.wait_time.total_ns = 10'000'000;
+    const auto second = sampler.sample();
+    EXPECT_DOUBLE_EQ(second.callback_queue.mean_wait_s, 0.004);
+
+    // Nothing waited meanwhile.
+    const auto third = sampler.sample();
+    EXPECT_DOUBLE_EQ(third.callback_queue.mean_wait_s, 0.0);
+}
+
+} // namespace
@@ -0,0 +1,36 @@
+#include <gtest/gtest.h>
+
+#include "system_selection.h"
+
+namespace {
+
+using mavsdk::mavsdk_server::parse_system_id;
+using mavsdk::mavsdk_server::system_id_from_context;
+
+TEST(SystemSelection, noContextMeansFirstSystem)
+{
+    EXPECT_EQ(system_id_from_context(nullptr), std::optional<uint8_t>{0});
+}
+
+TEST(SystemSelection, parsesValidSystemIds)
+{
+    EXPECT_EQ(parse_system_id("1"), std::optional<uint8_t>{1});
+    EXPECT_EQ(parse_system_id("42"), std::optional<uint8_t>{42});
+    EXPECT_EQ(parse_system_id("255"), std::optional<uint8_t>{255});
+}
+
+TEST(SystemSelection, rejectsInvalidSystemIds)
+{
+    // None of these must end up at the first system.
+    EXPECT_EQ(parse_system_id(""), std::nullopt);
+    EXPECT_EQ(parse_system_id("abc"), std::nullopt);
+    EXPECT_EQ(parse_system_id("1a"), std::nullopt);
+    EXPECT_EQ(parse_system_id("0"), std::nullopt);
+    EXPECT_EQ(parse_system_id("256"), std::nullopt);
+    EXPECT_EQ(parse_system_id("300"), std::nullopt);
+    EXPECT_EQ(parse_system_id("-1"), std::nullopt);
+    EXPECT_EQ(parse_system_id(" 1"), std::nullopt);
+    EXPECT_EQ(parse_system_id("99999999999999999999999"), std::nullopt);
+}
+
+} // namespace
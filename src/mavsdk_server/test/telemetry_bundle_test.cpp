@@ -0,0 +1,123 @@
+#include <gmock/gmock.h>
+#include <vector>
+
+#include "telemetry/mocks/telemetry_mock.h"
+#include "telemetry/telemetry_bundle.h"
+
+namespace mavsdk {
+template<typename... Args> class FakeHandle {
+public:
+    static mavsdk::Handle<Args...> create() { return mavsdk::Handle<Args...>(0); }
+};
+} // namespace mavsdk
+
+namespace {
+
+using testing::_;
+using testing::NiceMock;
+using testing::Return;
+using testing::SaveArg;
+
+using MockTelemetry = NiceMock<mavsdk::testing::MockTelemetry>;
+using TelemetryBundle = mavsdk::mavsdk_server::TelemetryBundle<MockTelemetry>;
+using Field = TelemetryBundle::Field;
+using Frame = TelemetryBundle::Frame;
+
+using Position = mavsdk::Telemetry::Position;
+using Battery = mavsdk::Telemetry::Battery;
+
+class TelemetryBundleTest : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        ON_CALL(_telemetry, subscribe_position(_))
+            .WillByDefault(testing::DoAll(
+                SaveArg<0>(&_position_callback),
+                Return(mavsdk::FakeHandle<Position>::create())));
+        ON_CALL(_telemetry, subscribe_battery(_))
+            .WillByDefault(testing::DoAll(
+                SaveArg<0>(&_battery_callback), Return(mavsdk::FakeHandle<Battery>::create())));
+    }
+
+    static Position createPosition(double lat)
+    {
+        Position position;
+        position.latitude_deg = lat;
+        return position;
+    }
+
+    static Battery createBattery(float remaining_percent)
+    {
+        Battery battery;
+        battery.remaining_percent = remaining_percent;
+        return battery;
+    }
+
+    MockTelemetry _telemetry{};
+    mavsdk::Telemetry::PositionCallback _position_callback{};
+    mavsdk::Telemetry::BatteryCallback _battery_callback{};
+    std::vector<Frame> _frames{};
+};
+
+TEST_F(TelemetryBundleTest, subscribesOnlyToSelectedFields)
+{
+    EXPECT_CALL(_telemetry, subscribe_position(_));
+    EXPECT_CALL(_telemetry, subscribe_health(_)).Times(0);
+    EXPECT_CALL(_telemetry, unsubscribe_position(_));
+
+    TelemetryBundle bundle(_telemetry, {{Field::Position, 0.0}}, [](const Frame&) {});
+}
+
+TEST_F(TelemetryBundleTest, sendsEveryUpdateWithoutLimit)
+{
+    TelemetryBundle bundle(
+        _telemetry,
+        {{Field::Position, 0.0}, {Field::Battery, 0.0}},
+        [this](const Frame& frame) { _frames.push_back(frame); });
+
+    _position_callback(createPosition(1.0));
+    _battery_callback(createBattery(50.0f));
+    _position_callback(createPosition(2.0));
+
+    ASSERT_EQ(_frames.size(), 3u);
+    ASSERT_TRUE(_frames[0].position);
+    EXPECT_DOUBLE_EQ(_frames[0].position->latitude_deg, 1.0);
+    EXPECT_FALSE(_frames[0].battery);
+    ASSERT_TRUE(_frames[1].battery);
+    EXPECT_FLOAT_EQ(_frames[1].battery->remaining_percent, 50.0f);
+    EXPECT_FALSE(_frames[1].position);
+    ASSERT_TRUE(_frames[2].position);
+    EXPECT_DOUBLE_EQ(_frames[2].position->latitude_deg, 2.0);
+}
+
+TEST_F(TelemetryBundleTest, dropsUpdatesAboveMaxRate)
+{
+    TelemetryBundle bundle(
+        _telemetry,
+        {{Field::Position, 1.0}},
+        [this](const Frame& frame) { _frames.push_back(frame); });
+
+    _position_callback(createPosition(1.0));
+    _position_callback(createPosition(2.0));
+
+    ASSERT_EQ(_frames.size(), 1u);
+    ASSERT_TRUE(_frames[0].position);
+    EXPECT_DOUBLE_EQ(_frames[0].position->latitude_deg, 1.0);
+}
+
+TEST_F(TelemetryBundleTest, combinesFieldsTakenWithinAFrame)
+{
+    // Battery is taken right away but has to wait for the next frame.
+    TelemetryBundle bundle(
+        _telemetry,
+        {{Field::Position, 10.0}, {Field::Battery, 1.0}},
+        [this](const Frame& frame) { _frames.push_back(frame); });
+
+    _position_callback(createPosition(1.0));
+    _battery_callback(createBattery(50.0f));
+
+    ASSERT_EQ(_frames.size(), 1u);
+    EXPECT_FALSE(_frames[0].battery);
+}
+
+} // namespace
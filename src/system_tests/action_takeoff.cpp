@@ -0,0 +1,48 @@
+#include "log.h"
+#include "mavsdk.h"
+#include "system_tests_helper.h"
+#include "plugins/action/action.h"
+#include "plugins/action_server/action_server.h"
+
+using namespace mavsdk;
+
+// Takeoff first changes the flight mode and only sends the takeoff command
+// once that has been acked, from within the ack's callback.
+TEST(SystemTest, ActionTakeoffAfterModeChange)
+{
+    Mavsdk mavsdk_groundstation;
+    mavsdk_groundstation.set_configuration(
+        Mavsdk::Configuration{Mavsdk::Configuration::UsageType::GroundStation});
+
+    Mavsdk mavsdk_autopilot;
+    mavsdk_autopilot.set_configuration(
+        Mavsdk::Configuration{Mavsdk::Configuration::UsageType::Autopilot});
+
+    ASSERT_EQ(mavsdk_groundstation.add_any_connection("udp://:17000"), ConnectionResult::Success);
+    ASSERT_EQ(
+        mavsdk_autopilot.add_any_connection("udp://127.0.0.1:17000"), ConnectionResult::Success);
+
+    auto action_server = ActionServer{
+        mavsdk_autopilot.server_component_by_type(Mavsdk::ServerComponentType::Autopilot)};
+
+    auto fut = wait_for_first_system_detected(mavsdk_groundstation);
+    ASSERT_EQ(fut.wait_for(std::chrono::seconds(10)), std::future_status::ready);
+    auto system = fut.get();
+
+    ASSERT_TRUE(system->has_autopilot());
+
+    auto action = Action{system};
+
+    EXPECT_EQ(action_server.set_allow_takeoff(true), ActionServer::Result::Success);
+
+    // The mode change is rejected, so the takeoff command is never sent.
+    EXPECT_EQ(action.takeoff(), Action::Result::CommandDenied);
+
+    ActionServer::AllowableFlightModes flight_modes{};
+    flight_modes.can_guided_mode = true;
+    EXPECT_EQ(
+        action_server.set_allowable_flight_modes(flight_modes), ActionServer::Result::Success);
+
+    // Now the takeoff command follows the mode change.
+    EXPECT_EQ(action.takeoff(), Action::Result::Success);
+}
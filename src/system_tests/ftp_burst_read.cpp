@@ -0,0 +1,427 @@
+#include "log.h"
+#include "mavsdk.h"
+#include "mavlink_receiver.h"
+#include "system_tests_helper.h"
+#include "plugins/ftp/ftp.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#if defined(LINUX) || defined(APPLE)
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+using namespace mavsdk;
+
+#if defined(LINUX) || defined(APPLE)
+
+namespace {
+
+// The parts of the MAVLink FTP protocol the fake server needs, see MavlinkFtp.
+enum Opcode : uint8_t {
+    CMD_TERMINATE_SESSION = 1,
+    CMD_RESET_SESSIONS = 2,
+    CMD_OPEN_FILE_RO = 4,
+    CMD_READ_FILE = 5,
+    CMD_BURST_READ_FILE = 15,
+    RSP_ACK = 128,
+    RSP_NAK = 129,
+};
+
+enum ServerError : uint8_t {
+    ERR_UNKOWN_COMMAND = 7,
+    ERR_FAIL_FILE_DOES_NOT_EXIST = 10,
+};
+
+constexpr uint8_t max_data_length = 239;
+
+struct __attribute__((__packed__)) Payload {
+    uint16_t seq_number;
+    uint8_t session;
+    uint8_t opcode;
+    uint8_t size;
+    uint8_t req_opcode;
+    uint8_t burst_complete;
+    uint8_t padding;
+    uint32_t offset;
+    uint8_t data[max_data_length];
+};
+
+static_assert(sizeof(Payload) == sizeof(mavlink_file_transfer_protocol_t::payload));
+
+constexpr auto remote_path = "/fs/microsd/test.bin";
+
+// A vehicle with nothing but an FTP server, which serves a single file and
+// can misbehave on burst reads.
+class FakeFtpServer {
+public:
+    enum class Burst {
+        InOrder, // Sends the whole file in one burst.
+        DropSecondChunk, // Like InOrder, but the second chunk gets lost.
+        Unsupported, // Naks burst reads as unknown command.
+        Silent, // Doesn't answer anything after the file is opened.
+    };
+
+    FakeFtpServer(int ground_station_port, std::vector<uint8_t> content, Burst burst) :
+        _content(std::move(content)),
+        _burst(burst)
+    {
+        _fd = socket(AF_INET, SOCK_DGRAM, 0);
+        struct sockaddr_in addr {};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = 0;
+        bind(_fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+
+        _ground_station.sin_family = AF_INET;
+        _ground_station.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        _ground_station.sin_port = htons(ground_station_port);
+
+        _thread = std::thread([this]() { run(); });
+    }
+
+    ~FakeFtpServer()
+    {
+        _should_exit = true;
+        _thread.join();
+        close(_fd);
+    }
+
+    // Offsets of the requests received for the given opcode, in order.
+    std::vector<uint32_t> requested_offsets(Opcode opcode)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        std::vector<uint32_t> offsets;
+        for (const auto& request : _requests) {
+            if (request.first == opcode) {
+                offsets.push_back(request.second);
+            }
+        }
+        return offsets;
+    }
+
+private:
+    void run()
+    {
+        auto last_heartbeat = std::chrono::steady_clock::time_point{};
+        while (!_should_exit) {
+            const auto now = std::chrono::steady_clock::now();
+            if (now - last_heartbeat > std::chrono::milliseconds(100)) {
+                send_heartbeat();
+                last_heartbeat = now;
+            }
+
+            struct pollfd poll_fd {};
+            poll_fd.fd = _fd;
+            poll_fd.events = POLLIN;
+            if (poll(&poll_fd, 1, 20) <= 0) {
+                continue;
+            }
+
+            char buffer[2048];
+            const auto len = recv(_fd, buffer, sizeof(buffer), 0);
+            if (len <= 0) {
+                continue;
+            }
+            _receiver.set_new_datagram(buffer, static_cast<unsigned>(len));
+            while (_receiver.parse_message()) {
+                const auto& message = _receiver.get_last_message();
+                if (message.msgid == MAVLINK_MSG_ID_FILE_TRANSFER_PROTOCOL) {
+                    handle(message);
+                }
+            }
+        }
+    }
+
+    void send_heartbeat()
+    {
+        mavlink_message_t message;
+        mavlink_msg_heartbeat_pack(
+            1,
+            MAV_COMP_ID_AUTOPILOT1,
+            &message,
+            MAV_TYPE_QUADROTOR,
+            MAV_AUTOPILOT_GENERIC,
+            0,
+            0,
+            MAV_STATE_ACTIVE);
+        send_message(message);
+    }
+
+    void handle(const mavlink_message_t& message)
+    {
+        mavlink_file_transfer_protocol_t ftp;
+        mavlink_msg_file_transfer_protocol_decode(&message, &ftp);
+        Payload request;
+        std::memcpy(&request, ftp.payload, sizeof(request));
+
+        // The path is null terminated.
+        if (request.opcode == CMD_OPEN_FILE_RO &&
+            std::strncmp(reinterpret_cast<const char*>(request.data), remote_path, request.size) !=
+                0) {
+            nak(message, request, ERR_FAIL_FILE_DOES_NOT_EXIST);
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _requests.emplace_back(static_cast<Opcode>(request.opcode), request.offset);
+        }
+
+        if (_burst == Burst::Silent && request.opcode != CMD_OPEN_FILE_RO) {
+            return;
+        }
+
+        switch (request.opcode) {
+            case CMD_OPEN_FILE_RO: {
+                Payload reply = reply_to(request);
+                const auto file_size = static_cast<uint32_t>(_content.size());
+                reply.size = sizeof(file_size);
+                std::memcpy(reply.data, &file_size, sizeof(file_size));
+                send_payload(message, reply);
+                break;
+            }
+
+            case CMD_READ_FILE:
+                send_chunk(message, reply_to(request), request.offset);
+                break;
+
+            case CMD_BURST_READ_FILE:
+                if (_burst == Burst::Unsupported) {
+                    nak(message, request, ERR_UNKOWN_COMMAND);
+                } else {
+                    send_burst(message, request);
+                }
+                break;
+
+            case CMD_TERMINATE_SESSION:
+            case CMD_RESET_SESSIONS:
+                send_payload(message, reply_to(request));
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    void send_burst(const mavlink_message_t& message, const Payload& request)
+    {
+        // Burst packets come with consecutive sequence numbers.
+        uint16_t seq_number = request.seq_number + 1;
+        for (uint32_t offset = request.offset; offset < _content.size();
+             offset += max_data_length) {
+            Payload reply = reply_to(request);
+            reply.seq_number = seq_number++;
+            reply.burst_complete = offset + max_data_length >= _content.size() ? 1 : 0;
+            if (_burst == Burst::DropSecondChunk && offset == max_data_length) {
+                continue;
+            }
+            send_chunk(message, reply, offset);
+        }
+    }
+
+    void send_chunk(const mavlink_message_t& message, Payload reply, uint32_t offset)
+    {
+        reply.offset = offset;
+        reply.size = static_cast<uint8_t>(
+            std::min(static_cast<size_t>(max_data_length), _content.size() - offset));
+        std::memcpy(reply.data, _content.data() + offset, reply.size);
+        send_payload(message, reply);
+    }
+
+    void nak(const mavlink_message_t& message, const Payload& request, ServerError error)
+    {
+        Payload reply = reply_to(request);
+        reply.opcode = RSP_NAK;
+        reply.size = 1;
+        reply.data[0] = error;
+        send_payload(message, reply);
+    }
+
+    static Payload reply_to(const Payload& request)
+    {
+        Payload reply{};
+        reply.seq_number = request.seq_number + 1;
+        reply.session = 0;
+        reply.opcode = RSP_ACK;
+        reply.req_opcode = request.opcode;
+        reply.offset = request.offset;
+        return reply;
+    }
+
+    void send_payload(const mavlink_message_t& request_message, const Payload& payload)
+    {
+        mavlink_message_t message;
+        mavlink_msg_file_transfer_protocol_pack(
+            1,
+            MAV_COMP_ID_AUTOPILOT1,
+            &message,
+            0,
+            request_message.sysid,
+            request_message.compid,
+            reinterpret_cast<const uint8_t*>(&payload));
+        send_message(message);
+    }
+
+    void send_message(const mavlink_message_t& message)
+    {
+        uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
+        const auto len = mavlink_msg_to_send_buffer(buffer, &message);
+        sendto(
+            _fd,
+            buffer,
+            len,
+            0,
+            reinterpret_cast<const sockaddr*>(&_ground_station),
+            sizeof(_ground_station));
+    }
+
+    const std::vector<uint8_t> _content;
+    const Burst _burst;
+    int _fd{-1};
+    struct sockaddr_in _ground_station {};
+    MavlinkReceiver _receiver{};
+    std::atomic<bool> _should_exit{false};
+    std::thread _thread{};
+
+    std::mutex _mutex{};
+    std::vector<std::pair<Opcode, uint32_t>> _requests{}; // Needs _mutex
+};
+
+std::vector<uint8_t> test_content()
+{
+    // Five chunks, the last one not full.
+    std::vector<uint8_t> content(4 * max_data_length + 44);
+    for (size_t i = 0; i < content.size(); ++i) {
+        content[i] = static_cast<uint8_t>(i * 7 % 251);
+    }
+    return content;
+}
+
+std::vector<uint32_t> chunk_offsets(size_t size)
+{
+    std::vector<uint32_t> offsets;
+    for (uint32_t offset = 0; offset < size; offset += max_data_length) {
+        offsets.push_back(offset);
+    }
+    return offsets;
+}
+
+class FtpBurstRead : public testing::Test {
+protected:
+    void SetUp() override
+    {
+        _local_dir = std::filesystem::temp_directory_path() / "mavsdk_ftp_burst_read_test";
+        std::filesystem::remove_all(_local_dir);
+        std::filesystem::create_directories(_local_dir);
+    }
+
+    void TearDown() override { std::filesystem::remove_all(_local_dir); }
+
+    // Connects to a fake server, which is only started now, so that the
+    // ground station is listening for it.
+    FakeFtpServer& start(int port, FakeFtpServer::Burst burst)
+    {
+        _mavsdk.set_configuration(
+            Mavsdk::Configuration{Mavsdk::Configuration::UsageType::GroundStation});
+        EXPECT_EQ(
+            _mavsdk.add_any_connection("udp://:" + std::to_string(port)),
+            ConnectionResult::Success);
+        _server = std::make_unique<FakeFtpServer>(port, _content, burst);
+        return *_server;
+    }
+
+    Ftp::Result download()
+    {
+        auto fut = wait_for_first_system_detected(_mavsdk);
+        if (fut.wait_for(std::chrono::seconds(10)) != std::future_status::ready) {
+            ADD_FAILURE() << "No system discovered";
+            return Ftp::Result::NoSystem;
+        }
+        auto ftp = Ftp{fut.get()};
+
+        auto prom = std::promise<Ftp::Result>();
+        auto result_fut = prom.get_future();
+        ftp.download_async(
+            remote_path, _local_dir.string(), [&prom](Ftp::Result result, Ftp::ProgressData) {
+                if (result != Ftp::Result::Next) {
+                    prom.set_value(result);
+                }
+            });
+        if (result_fut.wait_for(std::chrono::seconds(20)) != std::future_status::ready) {
+            ADD_FAILURE() << "Download did not finish";
+            return Ftp::Result::Unknown;
+        }
+        return result_fut.get();
+    }
+
+    std::vector<uint8_t> downloaded()
+    {
+        std::ifstream file(_local_dir / "test.bin", std::ios::binary);
+        return {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+    }
+
+    const std::vector<uint8_t> _content{test_content()};
+    std::filesystem::path _local_dir{};
+    Mavsdk _mavsdk{};
+    std::unique_ptr<FakeFtpServer> _server{};
+};
+
+} // namespace
+
+TEST_F(FtpBurstRead, InOrderBurst)
+{
+    auto& server = start(17100, FakeFtpServer::Burst::InOrder);
+    EXPECT_EQ(download(), Ftp::Result::Success);
+
+    EXPECT_EQ(downloaded(), _content);
+    EXPECT_EQ(server.requested_offsets(CMD_BURST_READ_FILE), std::vector<uint32_t>{0});
+    EXPECT_TRUE(server.requested_offsets(CMD_READ_FILE).empty());
+}
+
+TEST_F(FtpBurstRead, GapIsReadAgain)
+{
+    auto& server = start(17101, FakeFtpServer::Burst::DropSecondChunk);
+    EXPECT_EQ(download(), Ftp::Result::Success);
+
+    EXPECT_EQ(downloaded(), _content);
+    // Only the lost chunk is read again, once the burst is over.
+    EXPECT_EQ(server.requested_offsets(CMD_READ_FILE), std::vector<uint32_t>{max_data_length});
+}
+
+TEST_F(FtpBurstRead, FallsBackToSingleReadsIfUnsupported)
+{
+    auto& server = start(17102, FakeFtpServer::Burst::Unsupported);
+    EXPECT_EQ(download(), Ftp::Result::Success);
+
+    EXPECT_EQ(downloaded(), _content);
+    EXPECT_EQ(server.requested_offsets(CMD_BURST_READ_FILE).size(), 1u);
+    EXPECT_EQ(server.requested_offsets(CMD_READ_FILE), chunk_offsets(_content.size()));
+}
+
+TEST_F(FtpBurstRead, TimesOutOnceRetriesAreExhausted)
+{
+    auto& server = start(17103, FakeFtpServer::Burst::Silent);
+    EXPECT_EQ(download(), Ftp::Result::Timeout);
+
+    // The burst is asked for again, then single reads are tried, before giving up.
+    const auto bursts = server.requested_offsets(CMD_BURST_READ_FILE);
+    const auto reads = server.requested_offsets(CMD_READ_FILE);
+    EXPECT_GE(bursts.size(), 2u);
+    EXPECT_FALSE(reads.empty());
+    EXPECT_TRUE(std::all_of(bursts.begin(), bursts.end(), [](auto offset) { return offset == 0; }));
+    EXPECT_TRUE(std::all_of(reads.begin(), reads.end(), [](auto offset) { return offset == 0; }));
+}
+
+#endif
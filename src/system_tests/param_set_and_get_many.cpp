@@ -0,0 +1,72 @@
+#include "log.h"
+#include "mavsdk.h"
+#include "system_tests_helper.h"
+#include "plugins/param/param.h"
+#include "plugins/param/param_ext.h"
+#include "plugins/param_server/param_server.h"
+#include "plugins/param_server/param_server_ext.h"
+
+using namespace mavsdk;
+
+TEST(SystemTest, ParamSetAndGetMany)
+{
+    Mavsdk mavsdk_groundstation;
+    mavsdk_groundstation.set_configuration(
+        Mavsdk::Configuration{Mavsdk::Configuration::UsageType::GroundStation});
+
+    Mavsdk mavsdk_autopilot;
+    mavsdk_autopilot.set_configuration(
+        Mavsdk::Configuration{Mavsdk::Configuration::UsageType::Autopilot});
+
+    ASSERT_EQ(mavsdk_groundstation.add_any_connection("udp://:17000"), ConnectionResult::Success);
+    ASSERT_EQ(
+        mavsdk_autopilot.add_any_connection("udp://127.0.0.1:17000"), ConnectionResult::Success);
+
+    auto param_server = ParamServer{
+        mavsdk_autopilot.server_component_by_type(Mavsdk::ServerComponentType::Autopilot)};
+
+    ParamServer::AllParams provided;
+    Param::AllParams requested;
+    for (int i = 0; i < 20; ++i) {
+        const auto name = "TEST_INT_" + std::to_string(i);
+        provided.int_params.push_back(ParamServer::IntParam{name, i});
+        requested.int_params.push_back(Param::IntParam{name, 100 + i});
+    }
+    for (int i = 0; i < 20; ++i) {
+        const auto name = "TEST_FLOAT_" + std::to_string(i);
+        provided.float_params.push_back(ParamServer::FloatParam{name, 0.5f * i});
+        requested.float_params.push_back(Param::FloatParam{name, 100.0f + i});
+    }
+    auto param_server_ext = ParamServerExt{param_server};
+    ASSERT_EQ(param_server_ext.provide_params(provided), ParamServer::Result::Success);
+
+    auto fut = wait_for_first_system_detected(mavsdk_groundstation);
+    ASSERT_EQ(fut.wait_for(std::chrono::seconds(10)), std::future_status::ready);
+    auto system = fut.get();
+
+    auto param = Param{system};
+    auto param_ext = ParamExt{param};
+
+    // Only the names and types are used for getting them.
+    auto [get_results, got] = param_ext.get_params(requested);
+    ASSERT_EQ(get_results.size(), 40u);
+    for (const auto result : get_results) {
+        EXPECT_EQ(result, Param::Result::Success);
+    }
+    EXPECT_EQ(got.int_params[3].value, 3);
+    EXPECT_FLOAT_EQ(got.float_params[3].value, 1.5f);
+
+    const auto set_results = param_ext.set_params(requested);
+    ASSERT_EQ(set_results.size(), 40u);
+    for (const auto result : set_results) {
+        EXPECT_EQ(result, Param::Result::Success);
+    }
+
+    auto server_result_pair = param_server.retrieve_param_int("TEST_INT_5");
+    EXPECT_EQ(server_result_pair.first, ParamServer::Result::Success);
+    EXPECT_EQ(server_result_pair.second, 105);
+
+    auto server_float_result_pair = param_server.retrieve_param_float("TEST_FLOAT_7");
+    EXPECT_EQ(server_float_result_pair.first, ParamServer::Result::Success);
+    EXPECT_FLOAT_EQ(server_float_result_pair.second, 107.0f);
+}
@@ -0,0 +1,100 @@
+#!/usr/bin/env python3
+
+# Embeds the camera definition files into the library.
+#
+# Comments and the indentation between tags are dropped on the way, they
+# make up a good part of the files but don't change what is parsed.
+
+import argparse
+import os
+import re
+import xml.etree.ElementTree as ElementTree
+
+
+def minify(xml):
+    xml = re.sub(r'<!--.*?-->', '', xml, flags=re.DOTALL)
+    xml = re.sub(r'>\s+<', '><', xml)
+    return xml.strip() + '\n'
+
+
+def same_tree(lhs, rhs):
+    def text(value):
+        return (value or '').strip()
+
+    if lhs.tag != rhs.tag or lhs.attrib != rhs.attrib or text(lhs.text) != text(rhs.text):
+        return False
+    if len(lhs) != len(rhs):
+        return False
+    return all(same_tree(left, right) for left, right in zip(lhs, rhs))
+
+
+def var_name(filename):
+    return os.path.splitext(filename)[0] + 'xml'
+
+
+def write_header(path, names_and_sizes):
+    with open(path, 'w') as f:
+        f.write('/* Automatic generated file. DO NOT EDIT.\n')
+        f.write('   The file was generated by tools/generate_camera_definitions.py\n')
+        f.write('   This is a header file*/\n\n\n')
+        f.write('#ifndef CAMERA_DEFINITION_FILES_H\n')
+        f.write('#define CAMERA_DEFINITION_FILES_H\n')
+        for name, size in names_and_sizes:
+            f.write('  extern const char {}[];\n'.format(name))
+            f.write('  \n')
+            f.write('  const int {}_size = {}; \n\n'.format(name, size))
+        f.write('#endif /*CAMERA_DEFINITION_FILES_H */\n')
+
+
+def write_source(path, names_and_contents):
+    with open(path, 'w') as f:
+        f.write('/* Automatic generated file. DO NOT EDIT.\n')
+        f.write('   The file was generated by tools/generate_camera_definitions.py\n')
+        f.write('   This is a source file*/\n\n')
+        f.write('#include "camera_definition_files.h"\n\n')
+        for name, content in names_and_contents:
+            data = content.encode('utf-8') + b'\0'
+            f.write('  const char {}[] = \n  {{\n'.format(name))
+            lines = []
+            for i in range(0, len(data), 16):
+                lines.append('  ' + ', '.join("'\\x{:02x}'".format(b) for b in data[i:i + 16]))
+            f.write(',\n'.join(lines))
+            f.write('\n  };\n\n')
+
+
+def main():
+    script_dir = os.path.dirname(os.path.realpath(__file__))
+    default_dir = os.path.join(
+        script_dir, '..', 'src', 'mavsdk', 'plugins', 'camera', 'camera_definition_files')
+
+    parser = argparse.ArgumentParser()
+    parser.add_argument('--input-dir', default=default_dir)
+    args = parser.parse_args()
+
+    files = sorted((f for f in os.listdir(args.input_dir) if f.endswith('.xml')), key=str.lower)
+
+    names_and_contents = []
+    for filename in files:
+        print('    -> adding file {}'.format(filename))
+        with open(os.path.join(args.input_dir, filename), encoding='utf-8') as f:
+            original = f.read()
+        minified = minify(original)
+
+        if not same_tree(ElementTree.fromstring(original.encode('utf-8')),
+                         ElementTree.fromstring(minified.encode('utf-8'))):
+            raise RuntimeError('Minifying changed the content of {}'.format(filename))
+
+        names_and_contents.append((var_name(filename), minified))
+
+    generated_dir = os.path.join(args.input_dir, 'generated')
+    os.makedirs(generated_dir, exist_ok=True)
+
+    write_header(
+        os.path.join(generated_dir, 'camera_definition_files.h'),
+        [(name, len(content.encode('utf-8')) + 1) for name, content in names_and_contents])
+    write_source(
+        os.path.join(generated_dir, 'camera_definition_files.cpp'), names_and_contents)
+
+
+if __name__ == '__main__':
+    main()
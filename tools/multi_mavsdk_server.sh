@@ -3,6 +3,9 @@
 # Run multiple MAVSDK-Server instances, up to a maximum of 9. Read (http://docs.px4.io/main/en/simulation/multi_vehicle_simulation_gazebo.html) notes.
 # For more than 9 vehicles reuse the 14549 UDP vehicle port and use the MAV_SYS_ID to select each vehicle.
 #
+# A single MAVSDK-Server instance can also serve all vehicles: clients then choose the vehicle of
+# each call by setting its MAV_SYS_ID in the 'mavsdk-system-id' call metadata.
+#
 # This script supposes that the mavsdk_server executable is in the parent folder
 # By default it supposes that the mavsdk_server_manylinux2010-x64 is being used, to change it modify the MAVSDK_SERVER_EXEC constant with the corresponding exec path
 #